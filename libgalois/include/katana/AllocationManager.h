@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "katana/Manager.h"
+
+namespace katana {
+
+/// Manager for memory allocated outside of any other manager, e.g., the
+/// NUMAArrays of an analytic, as reported by an AllocationAccount.
+///
+/// The memory stays active until it is freed; there is no standby memory to
+/// reclaim. Its purpose is to let the MemorySupervisor see it, so that other
+/// managers give up standby memory when it grows.
+class KATANA_EXPORT AllocationManager : public Manager {
+public:
+  explicit AllocationManager(
+      std::string name, MemoryKind kind = MemoryKind::kScratch);
+  ~AllocationManager();
+  const std::string& Name() const override { return name_; }
+  MemoryKind Kind() const override { return kind_; }
+  count_t FreeStandbyMemory(count_t goal) override;
+
+private:
+  std::string name_;
+  MemoryKind kind_;
+};
+
+}  // namespace katana
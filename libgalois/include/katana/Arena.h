@@ -0,0 +1,140 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ARENA_H_
+#define KATANA_LIBGALOIS_KATANA_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "katana/NumaMem.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SimpleLock.h"
+#include "katana/config.h"
+
+namespace katana {
+
+template <typename T>
+class NUMAArray;
+
+/**
+ * Scratch memory for one run of an iterative algorithm, e.g., the per round
+ * buffers of Louvain's graph coarsening. Allocation bumps a pointer and
+ * there is no deallocation; Reset hands back everything at once between
+ * rounds while the arena keeps its memory, so later rounds reuse pages that
+ * are already mapped and faulted in instead of going back to the system.
+ *
+ * Allocations of up to a page come from page pool pages owned by the
+ * allocating thread, which are local to its NUMA node, and take no locks.
+ * Larger allocations each get a block of their own that is placed by first
+ * touch and reused by a later allocation that fits in it.
+ *
+ * Reset takes constant time: it starts a new epoch, and each thread rewinds
+ * its pages when it next allocates. Memory allocated before a Reset must not
+ * be used after it, and destructors of objects in the arena are never run.
+ * Reset must not run concurrently with allocations.
+ *
+ * \code
+ * katana::Arena arena;
+ * for (auto round = 0; round < num_rounds; ++round) {
+ *   auto scratch = arena.MakeArray<uint64_t>(graph.NumNodes());
+ *   katana::gstl::ArenaVector<uint32_t> ids(
+ *       katana::ArenaAllocator<uint32_t>(&arena));
+ *   ...
+ *   arena.Reset();
+ * }
+ * \endcode
+ */
+class KATANA_EXPORT Arena {
+public:
+  Arena();
+  ~Arena();
+  Arena(const Arena&) = delete;
+  Arena(Arena&&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  Arena& operator=(Arena&&) = delete;
+
+  /// Uninitialized memory for \p bytes aligned to \p align, a power of two
+  /// of at most a page. Thread safe.
+  void* Allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+  /// An uninitialized array of \p num T's in the arena. The array does not
+  /// own its memory; deallocating it does nothing.
+  template <typename T>
+  NUMAArray<T> MakeArray(size_t num) {
+    return NUMAArray<T>(Allocate(num * sizeof(T), alignof(T)), num);
+  }
+
+  /// Makes all memory of the arena available again. Not thread safe.
+  void Reset() { epoch_.fetch_add(1, std::memory_order_relaxed); }
+
+  /// Bytes the arena holds on to, whether allocated or not
+  size_t capacity() const;
+
+private:
+  struct Local {
+    std::vector<void*> pages;
+    /// Pages in use in the current epoch; the last one is being filled
+    size_t used{0};
+    size_t offset{0};
+    uint64_t epoch{0};
+  };
+
+  struct Block {
+    LAptr memory;
+    size_t bytes;
+    /// Epoch in which the block was last handed out
+    uint64_t epoch;
+  };
+
+  void* AllocateLarge(size_t bytes);
+
+  std::atomic<uint64_t> epoch_{1};
+  PerThreadStorage<Local> locals_;
+  mutable SimpleLock blocks_lock_;
+  std::vector<Block> blocks_;
+};
+
+/// STL allocator that allocates from an Arena; deallocate does nothing
+template <typename T>
+class ArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena* arena) noexcept : arena_(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t num) {
+    return static_cast<T*>(arena_->Allocate(num * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) noexcept {}
+
+  Arena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+private:
+  Arena* arena_;
+};
+
+namespace gstl {
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}  // namespace gstl
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ATOMICUNIONFIND_H_
+#define KATANA_LIBGALOIS_KATANA_ATOMICUNIONFIND_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Lock-free union-find over the integers [0, size()), e.g., the nodes of a
+ * graph, for algorithms that would otherwise have to allocate a
+ * UnionFindNode (UnionFind.h) per element.
+ *
+ * Every element points to its parent, roots to themselves, and Union links
+ * the larger of two roots below the smaller with a compare-and-swap, so
+ * parents never increase and the forest stays acyclic under concurrent
+ * updates. Find halves the path it walks, which is safe to race because it
+ * only replaces parents by ancestors. Find, Union and SameSet may be called
+ * concurrently; Reset may not.
+ */
+template <typename T = uint32_t>
+class AtomicUnionFind {
+  static_assert(std::is_unsigned_v<T>, "only unsigned elements supported");
+
+public:
+  AtomicUnionFind() = default;
+  explicit AtomicUnionFind(size_t size) { Reset(size); }
+
+  /// Makes every element of [0, size) a set of its own
+  void Reset(size_t size) {
+    if (parents_.size() != size) {
+      parents_.deallocate();
+      parents_.allocateInterleaved(size);
+    }
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) {
+          parents_[i].store(static_cast<T>(i), std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  size_t size() const { return parents_.size(); }
+
+  bool IsRoot(T x) const {
+    return parents_[x].load(std::memory_order_relaxed) == x;
+  }
+
+  /// The least element of the set of x at the time of the call
+  T Find(T x) {
+    T parent = parents_[x].load(std::memory_order_relaxed);
+    while (parent != x) {
+      T grandparent = parents_[parent].load(std::memory_order_relaxed);
+      if (grandparent != parent) {
+        parents_[x].compare_exchange_weak(
+            parent, grandparent, std::memory_order_relaxed);
+      }
+      x = grandparent;
+      parent = parents_[x].load(std::memory_order_relaxed);
+    }
+    return x;
+  }
+
+  /// Merges the sets of a and b. Returns false if they were already the
+  /// same set.
+  bool Union(T a, T b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return false;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      T expected = a;
+      if (parents_[a].compare_exchange_strong(
+              expected, b, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+  bool SameSet(T a, T b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return true;
+      }
+      // a may have been linked below another root since it was found
+      if (IsRoot(a)) {
+        return false;
+      }
+    }
+  }
+
+  /// Points every element directly to its root. Not thread safe with
+  /// concurrent Unions.
+  void Compress() {
+    katana::do_all(
+        katana::iterate(size_t{0}, parents_.size()),
+        [&](size_t i) {
+          parents_[i].store(Find(i), std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+private:
+  NUMAArray<std::atomic<T>> parents_;
+};
+
+}  // namespace katana
+
+#endif
@@ -21,10 +21,15 @@
 #define KATANA_LIBGALOIS_KATANA_BAG_H_
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/Arena.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Mem.h"
 #include "katana/PerThreadStorage.h"
@@ -37,6 +42,9 @@ namespace katana {
 /**
  * Unordered collection of elements. This data structure supports scalable
  * concurrent pushes but reading the bag can only be done serially.
+ *
+ * A bag made with an Arena takes its blocks from the arena and gives nothing
+ * back when cleared; the arena reclaims them on Reset.
  */
 template <typename T, unsigned int BlockSize = 0>
 class InsertBag {
@@ -124,6 +132,7 @@ public:
 private:
   katana::FixedSizeHeap heap;
   katana::PerThreadStorage<PerThread> heads;
+  katana::Arena* arena{nullptr};
 
   void insHeader(header* h) {
     PerThread& hpair = *heads.getLocal();
@@ -149,7 +158,10 @@ private:
   }
 
   header* newHeader() {
-    if (BlockSize) {
+    if (arena) {
+      size_t size = BlockSize ? BlockSize : katana::allocSize();
+      return newHeaderFromHeap(arena->Allocate(size), size);
+    } else if (BlockSize) {
       return newHeaderFromHeap(heap.allocate(BlockSize), BlockSize);
     } else {
       return newHeaderFromHeap(katana::pagePoolAlloc(), katana::allocSize());
@@ -164,6 +176,8 @@ private:
         uninitialized_destroy(h->dbegin, h->dend);
         header* h2 = h;
         h = h->next;
+        if (arena)
+          continue;
         if (BlockSize)
           heap.deallocate(h2);
         else
@@ -182,6 +196,8 @@ private:
             uninitialized_destroy(h->dbegin, h->dend);
             header* h2 = h;
             h = h->next;
+            if (arena)
+              continue;
             if (BlockSize)
               heap.deallocate(h2);
             else
@@ -192,20 +208,50 @@ private:
         std::make_tuple(katana::no_stats()));
   }
 
+  /// Calls fn(begin, end, offset) for every block in parallel, offset being
+  /// the number of elements before the block in iteration order. Threads
+  /// claim blocks one at a time, so large bags are split evenly however
+  /// unevenly they were filled.
+  template <typename F>
+  void for_each_block(F fn) const {
+    std::vector<std::pair<header*, size_t>> blocks;
+    size_t offset = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        blocks.emplace_back(h, offset);
+        offset += h->dend - h->dbegin;
+      }
+    }
+    std::atomic<size_t> next{0};
+    katana::on_each_gen(
+        [&](const unsigned int, const unsigned int) {
+          for (size_t i = next.fetch_add(1, std::memory_order_relaxed);
+               i < blocks.size();
+               i = next.fetch_add(1, std::memory_order_relaxed)) {
+            header* h = blocks[i].first;
+            fn(h->dbegin, h->dend, blocks[i].second);
+          }
+        },
+        std::make_tuple(katana::no_stats()));
+  }
+
 public:
   // static_assert(BlockSize == 0 || BlockSize >= (2 * sizeof(T) +
   // sizeof(header)),
   //     "BlockSize should larger than sizeof(T) + O(1)");
 
   InsertBag() : heap(BlockSize) {}
+  explicit InsertBag(katana::Arena* a) : heap(BlockSize), arena(a) {}
   InsertBag(InsertBag&& o) : heap(BlockSize) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(arena, o.arena);
   }
 
   InsertBag& operator=(InsertBag&& o) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(arena, o.arena);
     return *this;
   }
 
@@ -221,6 +267,7 @@ public:
   void swap(InsertBag& o) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(arena, o.arena);
   }
 
   typedef T value_type;
@@ -252,6 +299,45 @@ public:
     }
     return true;
   }
+  //! Number of elements; a walk over the blocks of the bag
+  size_t size() const {
+    size_t num = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        num += h->dend - h->dbegin;
+      }
+    }
+    return num;
+  }
+
+  /**
+   * Copies the bag into one array, in parallel, in iteration order, i.e.,
+   * with the elements each thread pushed next to each other. A do_all over
+   * the array gets contiguous, evenly split ranges, which a do_all over the
+   * bag does not. Not thread safe; include katana/NUMAArray.h to use it.
+   */
+  template <typename Array = NUMAArray<T>>
+  Array ToNUMAArray() const {
+    Array array;
+    array.allocateBlocked(size());
+    for_each_block([&](const T* begin, const T* end, size_t offset) {
+      std::uninitialized_copy(begin, end, array.data() + offset);
+    });
+    return array;
+  }
+
+  /**
+   * Moves the elements of the bag, in parallel and in iteration order, to
+   * dest[0, size()), e.g., the elements of a vector resized to size(). The
+   * bag keeps the moved-from elements. Not thread safe.
+   */
+  template <typename RandomAccessIterator>
+  void MoveTo(RandomAccessIterator dest) {
+    for_each_block([&](T* begin, T* end, size_t offset) {
+      std::move(begin, end, dest + offset);
+    });
+  }
+
   //! Thread safe bag insertion
   template <typename... Args>
   reference emplace(Args&&... args) {
@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_BARRIER_H_
 #define KATANA_LIBGALOIS_KATANA_BARRIER_H_
 
+#include <array>
 #include <memory>
 
 #include "katana/config.h"
@@ -45,13 +46,39 @@ public:
   virtual const char* name() const = 0;
 };
 
+/// Kinds of barriers that GetBarrier can use
+enum class BarrierKind {
+  /// Choose by number of threads and sockets with ChooseBarrierKind
+  kAuto,
+  kCounting,
+  kDissemination,
+  kMCS,
+  kTopo,
+};
+
+/// The barrier kind configured with the environment variable KATANA_BARRIER,
+/// one of auto, counting, dissemination, mcs or topo; kAuto by default
+KATANA_EXPORT BarrierKind GetBarrierKind();
+
+KATANA_EXPORT const char* BarrierKindName(BarrierKind kind);
+
+/// The barrier kind GetBarrier uses for active_threads threads spread over
+/// num_sockets sockets, given the results of the barriers benchmark: a
+/// counting barrier for a few threads, whose single counter is cheapest as
+/// long as it is not contended; the topology aware barrier when threads span
+/// sockets, so that only one thread per socket crosses the interconnect; and
+/// otherwise a dissemination barrier
+KATANA_EXPORT BarrierKind
+ChooseBarrierKind(unsigned active_threads, unsigned num_sockets);
+
 /**
  * Return a reference to system barrier.
  *
  * Have a pre-instantiated barrier available for use.
  * This is initialized to the current activeThreads. This barrier
  * is designed to be fast and should be used in the common
- * case.
+ * case. Its kind is the one configured with GetBarrierKind, chosen again
+ * whenever the number of active threads changes if that is kAuto.
  *
  * However, there is a race if the number of active threads
  * is modified after using this barrier: some threads may still
@@ -69,6 +96,8 @@ KATANA_EXPORT std::unique_ptr<Barrier> CreateMCSBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateTopoBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateCountingBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateDisseminationBarrier(unsigned);
+KATANA_EXPORT std::unique_ptr<Barrier>
+CreateBarrier(BarrierKind kind, unsigned active_threads);
 
 /**
  * Creates a new simple barrier. This barrier is not designed to be fast but
@@ -81,7 +110,24 @@ KATANA_EXPORT std::unique_ptr<Barrier> CreateSimpleBarrier(unsigned);
 
 namespace internal {
 
-void SetBarrier(Barrier* barrier);
+/// The barriers behind GetBarrier, created on first use of each kind
+class KATANA_EXPORT BarrierCache {
+public:
+  explicit BarrierCache(BarrierKind kind = GetBarrierKind()) : kind_(kind) {}
+
+  Barrier& Get(unsigned active_threads);
+
+private:
+  static constexpr size_t kNumKinds =
+      static_cast<size_t>(BarrierKind::kTopo) + 1;
+
+  BarrierKind kind_;
+  std::array<std::unique_ptr<Barrier>, kNumKinds> barriers_;
+  Barrier* current_{nullptr};
+  unsigned threads_{0};
+};
+
+void SetBarrierCache(BarrierCache* cache);
 
 }  // namespace internal
 
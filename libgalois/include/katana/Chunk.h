@@ -23,14 +23,12 @@
 #include "katana/FixedSizeRing.h"
 #include "katana/Mem.h"
 #include "katana/PaddedLock.h"
+#include "katana/Threads.h"
 #include "katana/WLCompileCheck.h"
 #include "katana/WorkListHelpers.h"
 #include "katana/config.h"
 
 namespace katana {
-
-extern unsigned activeThreads;
-
 namespace internal {
 // This overly complex specialization avoids a pointer indirection for
 // non-distributed WL when accessing PerLevel
@@ -40,7 +38,7 @@ struct squeue {
   TQ& get(int i) { return *queues.getRemote(i); }
   TQ& get() { return *queues.getLocal(); }
   int myEffectiveID() { return ThreadPool::getTID(); }
-  int size() { return activeThreads; }
+  int size() { return getActiveThreads(); }
 };
 
 template <template <typename> class PS, typename TQ>
@@ -0,0 +1,75 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CHUNKSIZETUNER_H_
+#define KATANA_LIBGALOIS_KATANA_CHUNKSIZETUNER_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Chooses the chunk size of loops run with the adaptive_chunk_size trait,
+/// remembering what it learned about each loop, by loopname, across
+/// invocations.
+///
+/// After each invocation a loop reports how many items it ran, how many
+/// chunks its threads took, how many of those they stole and how long it
+/// took. Each loop climbs towards the chunk size with the lowest time per
+/// item: the chunk size doubles, or halves, with every invocation and turns
+/// back from the best one seen so far when the time per item gets worse.
+/// Loops whose threads steal often have more work than chunks to balance it
+/// with, so their chunk size shrinks regardless. Invocations with too little
+/// work to tell chunk sizes apart, e.g., those over a nearly empty frontier,
+/// leave the chunk size as it is.
+///
+/// This is thread safe, but loops only consult it before and after running.
+class KATANA_EXPORT ChunkSizeTuner {
+public:
+  /// Fraction of chunks stolen above which the chunk size shrinks
+  static constexpr double kMaxStealRate = 0.25;
+  /// Invocations that run fewer items per thread, or fewer than two chunks
+  /// per thread, are not measured
+  static constexpr uint64_t kMinItemsPerThread = 256;
+
+  struct Outcome {
+    unsigned chunk_size{0};
+    unsigned num_threads{0};
+    uint64_t num_items{0};
+    uint64_t num_chunks{0};
+    uint64_t num_steals{0};
+    uint64_t us{0};
+  };
+
+  static ChunkSizeTuner& Get();
+
+  /// The chunk size the next invocation of loopname should use, initial
+  /// if it has not run yet
+  unsigned ChunkSize(const std::string& loopname, unsigned initial);
+
+  /// The chunk size with the lowest time per item seen for loopname, or 0
+  /// if none has been measured
+  unsigned BestChunkSize(const std::string& loopname);
+
+  void Report(const std::string& loopname, const Outcome& outcome);
+
+  /// Forget everything learned, e.g., between unrelated inputs
+  void Reset();
+
+private:
+  struct Loop {
+    unsigned chunk_size{0};
+    unsigned best_chunk_size{0};
+    double best_us_per_item{0};
+    double last_us_per_item{0};
+    bool growing{true};
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Loop> loops_;
+};
+
+}  // namespace katana
+
+#endif
@@ -37,6 +37,14 @@ compilerBarrier() {
   asm volatile("" ::: "memory");
 }
 
+/// Hint that the cache line holding addr will be read soon
+inline static void
+prefetch(const void* addr) {
+#if defined(__GNUC__)
+  __builtin_prefetch(addr, 0, 3);
+#endif
+}
+
 // xeons have 64 byte cache lines, but will prefetch 2 at a time
 constexpr int KATANA_CACHE_LINE_SIZE = 128;
 
@@ -0,0 +1,133 @@
+#ifndef KATANA_LIBGALOIS_KATANA_COMPRESSEDBITMAP_H_
+#define KATANA_LIBGALOIS_KATANA_COMPRESSEDBITMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A compressed set of uint32_t, e.g., of node ids, after Roaring bitmaps:
+/// the values are split by their high 16 bits into containers of their low
+/// 16 bits, each an array, a bitmap or a list of runs, whichever is the
+/// smallest. A set costs about two bytes per value when sparse, one bit per
+/// value of its range when dense, and little more than its runs when it is
+/// made of long runs, like the members of a community of consecutive nodes.
+///
+/// Unions, intersections and differences go container by container, in
+/// parallel when there are many of them, and those of two bitmap
+/// containers with the widest vector instructions of the machine.
+///
+/// A bitmap is not thread safe, except for calls of const members.
+class KATANA_EXPORT CompressedBitmap {
+public:
+  enum class ContainerKind : uint8_t {
+    kArray,
+    kBitmap,
+    kRun,
+  };
+
+  /// The most values of an array container; more make a bitmap container,
+  /// which always takes 8 KiB
+  static constexpr uint32_t kMaxArraySize = 4096;
+
+  CompressedBitmap();
+  CompressedBitmap(const CompressedBitmap& other);
+  CompressedBitmap(CompressedBitmap&& other) noexcept;
+  CompressedBitmap& operator=(const CompressedBitmap& other);
+  CompressedBitmap& operator=(CompressedBitmap&& other) noexcept;
+  ~CompressedBitmap();
+
+  /// The set of the size values at sorted, which must be sorted; duplicates
+  /// are fine
+  static CompressedBitmap FromSorted(const uint32_t* sorted, size_t size);
+
+  /// The set of the values of [begin, end)
+  static CompressedBitmap FromRange(uint64_t begin, uint64_t end);
+
+  bool empty() const { return keys_.empty(); }
+  uint64_t Cardinality() const;
+
+  bool Contains(uint32_t value) const;
+
+  /// Adds value; returns whether it was new
+  bool Add(uint32_t value);
+  /// Removes value; returns whether it was there
+  bool Remove(uint32_t value);
+
+  void clear();
+
+  /// Makes containers of long runs run containers, and run containers that
+  /// take more room than they would otherwise back into arrays or bitmaps.
+  /// Other operations do not make run containers by themselves.
+  void RunOptimize();
+
+  /// Calls fn(value) for every value, in increasing order
+  void ForEach(const std::function<void(uint32_t)>& fn) const;
+
+  /// Calls fn(value) for every value, in parallel over the containers; fn
+  /// must be safe to call concurrently
+  void ParallelForEach(const std::function<void(uint32_t)>& fn) const;
+
+  /// The values, in increasing order
+  std::vector<uint32_t> ToVector() const;
+
+  static CompressedBitmap Union(
+      const CompressedBitmap& a, const CompressedBitmap& b);
+  static CompressedBitmap Intersection(
+      const CompressedBitmap& a, const CompressedBitmap& b);
+  /// The values of a that are not in b
+  static CompressedBitmap Difference(
+      const CompressedBitmap& a, const CompressedBitmap& b);
+  /// The number of values of both a and b, without making their
+  /// intersection
+  static uint64_t IntersectionCardinality(
+      const CompressedBitmap& a, const CompressedBitmap& b);
+
+  /// The union of all of sets, merged in parallel as a tree
+  static CompressedBitmap UnionAll(
+      const std::vector<const CompressedBitmap*>& sets);
+
+  CompressedBitmap& operator|=(const CompressedBitmap& other) {
+    return *this = Union(*this, other);
+  }
+  CompressedBitmap& operator&=(const CompressedBitmap& other) {
+    return *this = Intersection(*this, other);
+  }
+  CompressedBitmap& operator-=(const CompressedBitmap& other) {
+    return *this = Difference(*this, other);
+  }
+
+  bool operator==(const CompressedBitmap& other) const;
+  bool operator!=(const CompressedBitmap& other) const {
+    return !(*this == other);
+  }
+
+  /// The number of containers of each kind, for tuning and tests
+  uint64_t NumContainers(ContainerKind kind) const;
+
+  /// The size of Serialize's output, about what the set takes in memory
+  uint64_t SerializedSize() const;
+
+  /// Appends to out a little endian encoding of the set, which Deserialize
+  /// reads back on any machine; for storing the set in a file of an RDG
+  /// optional datastructure
+  void Serialize(std::vector<uint8_t>* out) const;
+
+  static Result<CompressedBitmap> Deserialize(const uint8_t* data, size_t size);
+
+  struct Container;
+
+private:
+  /// The high 16 bits of the values of each container, in increasing order
+  std::vector<uint16_t> keys_;
+  std::vector<Container> containers_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+#define KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Mixes the bits of an integer key, so that consecutive keys, e.g., node
+/// ids, do not fill consecutive slots
+struct IntegerHash {
+  size_t operator()(uint64_t key) const { return Mix64(key); }
+};
+
+/**
+ * A fixed capacity, open addressing hash map from integer keys to values that
+ * threads can insert into and aggregate into concurrently without locks, e.g.,
+ * to count labels or sum weights per community in a parallel loop instead of
+ * merging per thread maps afterwards.
+ *
+ * Keys and values live side by side in one array of slots, allocated with
+ * NUMAArray and initialized in parallel, and collisions are resolved by
+ * linear probing, so a lookup usually touches one cache line. Keys are never
+ * removed; Clear empties the whole map.
+ *
+ * Values start out value initialized (zero for arithmetic types) when their
+ * key is inserted and are only changed with atomic operations, so Value must
+ * be lock-free as a std::atomic. The largest Key marks empty slots and
+ * cannot be inserted.
+ *
+ * The map holds at most max_keys keys as given to the constructor or Reset;
+ * inserting more keys fails once every slot is taken.
+ *
+ * \code
+ * katana::ConcurrentHashMap<uint64_t, uint64_t> counts(graph.size());
+ * katana::do_all(katana::iterate(graph), [&](auto n) {
+ *   counts.Add(graph.GetData<Label>(n), 1);
+ * });
+ * counts.ForEach([&](uint64_t label, uint64_t count) { ... });
+ * \endcode
+ */
+template <typename Key, typename Value, typename Hash = IntegerHash>
+class ConcurrentHashMap {
+  static_assert(std::is_integral_v<Key>, "only integral keys supported");
+  static_assert(
+      std::atomic<Value>::is_always_lock_free, "values must be lock-free");
+
+  struct Slot {
+    std::atomic<Key> key{kEmptyKey};
+    std::atomic<Value> value{Value{}};
+  };
+
+  NUMAArray<Slot> slots_;
+  size_t mask_{0};
+  Hash hash_;
+
+  size_t Home(Key key) const { return hash_(key) & mask_; }
+
+public:
+  using key_type = Key;
+  using mapped_type = Value;
+
+  /// Key of empty slots
+  static constexpr Key kEmptyKey = std::numeric_limits<Key>::max();
+
+  explicit ConcurrentHashMap(size_t max_keys = 0, const Hash& hash = Hash())
+      : hash_(hash) {
+    Reset(max_keys);
+  }
+
+  ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+  ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+  /// Empties the map and makes room for max_keys keys, at a load factor of
+  /// at most a half. Not thread safe.
+  void Reset(size_t max_keys) {
+    size_t capacity = 16;
+    while (capacity < 2 * max_keys) {
+      capacity *= 2;
+    }
+    slots_.destroy();
+    slots_.deallocate();
+    slots_.allocateInterleaved(capacity);
+    mask_ = capacity - 1;
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity),
+        [&](size_t i) { slots_.constructAt(i); }, katana::no_stats());
+  }
+
+  /// Removes all keys, keeping the capacity. Not thread safe.
+  void Clear() {
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity()),
+        [&](size_t i) {
+          slots_[i].key.store(kEmptyKey, std::memory_order_relaxed);
+          slots_[i].value.store(Value{}, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+  /// The value of key, inserting key if it is not in the map yet, or
+  /// nullptr if key is not in the map and the map is full
+  std::atomic<Value>* FindOrInsert(Key key) {
+    KATANA_LOG_DEBUG_ASSERT(key != kEmptyKey);
+    size_t i = Home(key);
+    for (size_t probes = 0; probes <= mask_; ++probes, i = (i + 1) & mask_) {
+      Slot& slot = slots_[i];
+      Key k = slot.key.load(std::memory_order_acquire);
+      if (k == kEmptyKey) {
+        if (slot.key.compare_exchange_strong(
+                k, key, std::memory_order_acq_rel)) {
+          return &slot.value;
+        }
+        // k now holds the key another thread inserted here first
+      }
+      if (k == key) {
+        return &slot.value;
+      }
+    }
+    return nullptr;
+  }
+
+  /// The value of key if it is in the map
+  std::optional<Value> Find(Key key) const {
+    size_t i = Home(key);
+    for (size_t probes = 0; probes <= mask_; ++probes, i = (i + 1) & mask_) {
+      const Slot& slot = slots_[i];
+      Key k = slot.key.load(std::memory_order_acquire);
+      if (k == key) {
+        return slot.value.load(std::memory_order_relaxed);
+      }
+      if (k == kEmptyKey) {
+        break;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Adds delta to the value of key; returns false if the map is full
+  bool Add(Key key, Value delta) {
+    std::atomic<Value>* value = FindOrInsert(key);
+    if (!value) {
+      return false;
+    }
+    value->fetch_add(delta, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Replaces the value v of key with fn(v), atomically; returns false if
+  /// the map is full
+  template <typename F>
+  bool Update(Key key, F fn) {
+    std::atomic<Value>* value = FindOrInsert(key);
+    if (!value) {
+      return false;
+    }
+    Value old = value->load(std::memory_order_relaxed);
+    while (!value->compare_exchange_weak(
+        old, fn(old), std::memory_order_relaxed)) {
+    }
+    return true;
+  }
+
+  /// Number of keys; a parallel scan of the map
+  size_t size() const {
+    katana::GAccumulator<size_t> num_keys;
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity()),
+        [&](size_t i) {
+          if (slots_[i].key.load(std::memory_order_relaxed) != kEmptyKey) {
+            num_keys += 1;
+          }
+        },
+        katana::no_stats());
+    return num_keys.reduce();
+  }
+
+  /// Calls fn(key, value) for every key in parallel; args are passed on to
+  /// do_all. Not safe to run concurrently with inserts.
+  template <typename F, typename... Args>
+  void ForEach(F fn, Args&&... args) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity()),
+        [&](size_t i) {
+          Key k = slots_[i].key.load(std::memory_order_relaxed);
+          if (k != kEmptyKey) {
+            fn(k, slots_[i].value.load(std::memory_order_relaxed));
+          }
+        },
+        std::forward<Args>(args)...);
+  }
+};
+
+}  // namespace katana
+
+#endif
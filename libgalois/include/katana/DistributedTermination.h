@@ -0,0 +1,87 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DISTRIBUTEDTERMINATION_H_
+#define KATANA_LIBGALOIS_KATANA_DISTRIBUTEDTERMINATION_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "katana/CommBackend.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Termination detection across the hosts of a CommBackend for asynchronous
+/// algorithms, e.g., asynchronous connected components or delta stepping
+/// SSSP over a partitioned graph, whose hosts run their local work to
+/// quiescence and send the updates for other hosts' nodes as messages.
+///
+/// TerminationDetection tells when the threads of one host run out of work;
+/// DistributedTermination tells when every host has and no message is still
+/// in flight, using a counting method (Mattern's four counters): each host
+/// counts the messages it sends and receives, and each check sums the counts
+/// and the number of busy hosts over all hosts with one all-reduce. Two
+/// checks in a row that find no busy host and the same, equal, numbers of
+/// messages sent and received prove termination, even if counts changed
+/// while the all-reduce was under way. There is no token to pass around and
+/// no barrier besides the all-reduce, so an algorithm only needs to count
+/// its messages and call Terminated between rounds.
+///
+/// The typical way to use it is:
+///
+///   // On each host....
+///   DistributedTermination term(comm);
+///   RunToGlobalTermination(&term, [&]() {
+///     katana::for_each(katana::iterate(local_work), ...);
+///     SendUpdates(...);         // term.CountSent(num_sent)
+///     ReceiveUpdates(...);      // term.CountReceived(num_received)
+///     return !local_work.empty();
+///   });
+///
+class KATANA_EXPORT DistributedTermination {
+public:
+  explicit DistributedTermination(CommBackend* comm) : comm_(comm) {}
+
+  /// Counts messages sent to other hosts. Thread safe.
+  void CountSent(uint64_t num = 1) {
+    sent_.fetch_add(num, std::memory_order_relaxed);
+  }
+
+  /// Counts messages received from other hosts. Thread safe.
+  void CountReceived(uint64_t num = 1) {
+    received_.fetch_add(num, std::memory_order_relaxed);
+  }
+
+  /// Returns true iff all hosts should terminate. Collective: every host
+  /// calls it once per round, passing whether it has locally run out of work.
+  bool Terminated(bool idle);
+
+  /// Prepares for another run; not collective
+  void Reset();
+
+  /// Number of calls to Terminated since construction or Reset
+  uint64_t num_checks() const { return num_checks_; }
+
+private:
+  CommBackend* comm_;
+  std::atomic<uint64_t> sent_{0};
+  std::atomic<uint64_t> received_{0};
+  /// Result of the previous check
+  bool last_quiet_{false};
+  uint64_t last_sent_{0};
+  uint64_t last_received_{0};
+  uint64_t num_checks_{0};
+};
+
+/// Calls round until no host has work left. round runs one round of local
+/// work, e.g., a for_each to quiescence, and exchanges the messages it
+/// produced, counting them with term; it returns true if this host still has
+/// work. Collective.
+template <typename F>
+void
+RunToGlobalTermination(DistributedTermination* term, F round) {
+  while (!term->Terminated(!round())) {
+  }
+}
+
+}  // namespace katana
+
+#endif
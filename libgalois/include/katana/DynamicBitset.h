@@ -28,6 +28,7 @@
 
 #include <cassert>
 #include <climits>
+#include <utility>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
@@ -277,6 +278,58 @@ public:
     return (old_val & bit_offset);
   }
 
+  /**
+   * Returns one word of the bitset, i.e., bits word_index * 64 on, without
+   * the bits past size() that, e.g., bitwise_not sets in the last word
+   *
+   * @param word_index Word to return
+   * @returns the word
+   */
+  uint64_t GetWord(size_t word_index) const {
+    KATANA_LOG_DEBUG_ASSERT(word_index < bitvec_.size());
+    uint64_t word = bitvec_[word_index].load(std::memory_order_relaxed);
+    size_t tail = num_bits_ % kNumBitsInUint64;
+    if (tail != 0 && word_index == bitvec_.size() - 1) {
+      word &= (uint64_t{1} << tail) - 1;
+    }
+    return word;
+  }
+
+  /**
+   * Set several bits of one word of the bitset with a single atomic
+   * operation, e.g., to publish the bits a thread collected for a word at
+   * once.
+   *
+   * @param word_index Word of the bitset, i.e., bits word_index * 64 on
+   * @param mask Bits of the word to set
+   * @returns the bits of mask that were set before
+   */
+  uint64_t SetWord(size_t word_index, uint64_t mask) {
+    KATANA_LOG_DEBUG_ASSERT(word_index < bitvec_.size());
+    return bitvec_[word_index].fetch_or(mask, std::memory_order_relaxed) &
+           mask;
+  }
+
+  /**
+   * Calls fn(index) for the index of every set bit in parallel. The bitset
+   * is split into ranges of words for do_all, so fn sees the bits of a word
+   * in order and empty words cost a load each; args are passed on to do_all.
+   * Bits changed concurrently may or may not be seen.
+   */
+  template <typename F, typename... Args>
+  void ForEachSetBit(F fn, Args&&... args) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, bitvec_.size()),
+        [&](size_t word_index) {
+          uint64_t word = GetWord(word_index);
+          while (word != 0) {
+            fn(word_index * kNumBitsInUint64 + __builtin_ctzll(word));
+            word &= word - 1;
+          }
+        },
+        std::forward<Args>(args)...);
+  }
+
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitset& other);
 
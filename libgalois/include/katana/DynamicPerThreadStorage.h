@@ -0,0 +1,186 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DYNAMICPERTHREADSTORAGE_H_
+#define KATANA_LIBGALOIS_KATANA_DYNAMICPERTHREADSTORAGE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Executor_OnEach.h"
+#include "katana/NumaMem.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Traits.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * An object of T for each thread, like PerThreadStorage, but each object is
+ * constructed by the thread it belongs to, so that the object and whatever
+ * it allocates are placed on that thread's NUMA node by first touch.
+ *
+ * Objects of up to kMaxInlineSize bytes live in the fixed per-thread area of
+ * PerThreadStorage, which each thread faults in itself. Larger objects get
+ * pages of their own, allocated and faulted in by their thread, so T may be
+ * larger than the fixed area.
+ *
+ * The objects of the threads active when the storage is made are
+ * constructed by an on_each, so the storage must not be made in a parallel
+ * region. A thread that becomes active later, e.g., after setActiveThreads
+ * raises the thread count, constructs its object the first time it calls
+ * getLocal: growing needs no global reallocation, and getLocal takes no lock
+ * once the object is there. getRemote of a thread that has no object yet
+ * constructs it on the calling thread, which is correct but not local; call
+ * ensureActive after raising the thread count to have the new threads
+ * construct theirs, or skip them with isMade.
+ *
+ * The constructor arguments are copied, to construct the objects of threads
+ * that become active later.
+ *
+ * \code
+ * katana::DynamicPerThreadStorage<std::vector<uint32_t>> buffers;
+ * katana::do_all(katana::iterate(graph), [&](auto n) {
+ *   buffers.getLocal()->emplace_back(n);
+ * });
+ * \endcode
+ */
+template <typename T>
+class DynamicPerThreadStorage {
+public:
+  static constexpr size_t kMaxInlineSize = 4096;
+
+  template <
+      typename... Args,
+      std::enable_if_t<
+          std::is_constructible_v<T, const std::decay_t<Args>&...>, bool> =
+          false>
+  explicit DynamicPerThreadStorage(Args&&... args)
+      : construct_([args = std::make_tuple(std::forward<Args>(args)...)](
+                       void* mem) {
+          std::apply(
+              [mem](const auto&... arg) { new (mem) T(arg...); }, args);
+        }) {
+    // In case we make one of these before initializing the thread pool, this
+    // will call initPTS for each thread if it hasn't already
+    num_slots_ = GetThreadPool().getMaxThreads();
+    slots_ = std::make_unique<Slot[]>(num_slots_);
+    if constexpr (kInline) {
+      offset_ = getPTSBackend().allocOffset(sizeof(T));
+    }
+    ensureActive();
+  }
+
+  DynamicPerThreadStorage(DynamicPerThreadStorage&& rhs) noexcept
+      : construct_(std::move(rhs.construct_)),
+        slots_(std::move(rhs.slots_)),
+        num_slots_(rhs.num_slots_),
+        offset_(rhs.offset_) {
+    rhs.num_slots_ = 0;
+  }
+
+  DynamicPerThreadStorage& operator=(DynamicPerThreadStorage&& rhs) noexcept {
+    auto tmp = std::move(rhs);
+    std::swap(construct_, tmp.construct_);
+    std::swap(slots_, tmp.slots_);
+    std::swap(num_slots_, tmp.num_slots_);
+    std::swap(offset_, tmp.offset_);
+    return *this;
+  }
+
+  DynamicPerThreadStorage(const DynamicPerThreadStorage&) = delete;
+  DynamicPerThreadStorage& operator=(const DynamicPerThreadStorage&) = delete;
+
+  ~DynamicPerThreadStorage() { destruct(); }
+
+  T* getLocal() { return getLocal(ThreadPool::getTID()); }
+
+  const T* getLocal() const { return getLocal(ThreadPool::getTID()); }
+
+  //! Like getLocal() but optimized for when you already know the thread id
+  T* getLocal(unsigned int thread) { return get(ThreadPool::getSlot(thread)); }
+
+  const T* getLocal(unsigned int thread) const {
+    return get(ThreadPool::getSlot(thread));
+  }
+
+  T* getRemote(unsigned int thread) { return get(ThreadPool::getSlot(thread)); }
+
+  const T* getRemote(unsigned int thread) const {
+    return get(ThreadPool::getSlot(thread));
+  }
+
+  //! Whether thread has constructed its object
+  bool isMade(unsigned int thread) const {
+    return slots_[ThreadPool::getSlot(thread)].obj.load(
+               std::memory_order_acquire) != nullptr;
+  }
+
+  //! Have each active thread construct its object if it has not yet. Do
+  //! NOT call in a parallel region as it uses katana::on_each.
+  void ensureActive() {
+    katana::on_each_gen(
+        [this](const unsigned int tid, const unsigned int) { getLocal(tid); },
+        std::make_tuple(katana::no_stats()));
+  }
+
+  unsigned size() const { return GetThreadPool().getGroupThreads(); }
+
+private:
+  static constexpr bool kInline = sizeof(T) <= kMaxInlineSize;
+
+  struct Slot {
+    std::atomic<T*> obj{nullptr};
+    std::once_flag made;
+    //! The pages of an object too large for the fixed area
+    LAptr pages;
+  };
+
+  T* get(unsigned slot) const {
+    T* obj = slots_[slot].obj.load(std::memory_order_acquire);
+    return obj != nullptr ? obj : make(slot);
+  }
+
+  T* make(unsigned slot) const {
+    Slot& s = slots_[slot];
+    std::call_once(s.made, [&] {
+      void* mem;
+      if constexpr (kInline) {
+        mem = getPTSBackend().getRemote(slot, offset_);
+      } else {
+        s.pages = largeMallocLocal(sizeof(T));
+        mem = s.pages.get();
+      }
+      construct_(mem);
+      s.obj.store(static_cast<T*>(mem), std::memory_order_release);
+    });
+    return s.obj.load(std::memory_order_acquire);
+  }
+
+  void destruct() {
+    for (unsigned n = 0; n < num_slots_; ++n) {
+      if (T* obj = slots_[n].obj.load(std::memory_order_acquire)) {
+        obj->~T();
+      }
+    }
+    if (kInline && num_slots_ != 0) {
+      getPTSBackend().deallocOffset(offset_, sizeof(T));
+    }
+    num_slots_ = 0;
+    // the pages of large objects are freed with their slots
+    slots_.reset();
+  }
+
+  std::function<void(void*)> construct_;
+  std::unique_ptr<Slot[]> slots_;
+  unsigned num_slots_{0};
+  unsigned offset_{~0U};
+};
+
+}  // namespace katana
+
+#endif
@@ -21,14 +21,18 @@
 #define KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 
 #include "katana/Barrier.h"
+#include "katana/ChunkSizeTuner.h"
 #include "katana/CompilerSpecific.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/LoopCounters.h"
+#include "katana/LoopStatistics.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -37,6 +41,48 @@ namespace katana {
 
 namespace internal {
 
+/// Issues the prefetches of the prefetch_distance trait, keeping an iterator
+/// that many items ahead of the one being run; does nothing without the trait
+template <
+    typename Iter, typename ArgsTuple,
+    bool = has_trait<prefetch_distance_tag, ArgsTuple>()>
+class PrefetchAhead {
+public:
+  explicit PrefetchAhead(const ArgsTuple&) {}
+  void Start(Iter, Iter) {}
+  void Step() {}
+};
+
+template <typename Iter, typename ArgsTuple>
+class PrefetchAhead<Iter, ArgsTuple, true> {
+  using Trait = trait_type_t<prefetch_distance_tag, ArgsTuple>;
+
+  decltype(Trait::accessor) accessor_;
+  Iter ahead_{};
+  Iter end_{};
+
+public:
+  explicit PrefetchAhead(const ArgsTuple& args)
+      : accessor_(get_trait_value<prefetch_distance_tag>(args).accessor) {}
+
+  /// Prefetch for the first items of [beg, end), which is about to run
+  void Start(Iter beg, Iter end) {
+    ahead_ = beg;
+    end_ = end;
+    for (unsigned i = 0; i < Trait::value; ++i) {
+      Step();
+    }
+  }
+
+  /// Prefetch for the next item ahead; call once per item run
+  void Step() {
+    if (ahead_ != end_) {
+      katana::prefetch(accessor_(*ahead_));
+      ++ahead_;
+    }
+  }
+};
+
 template <typename R, typename F, typename ArgsTuple>
 class DoAllStealingExec {
   typedef typename R::local_iterator Iter;
@@ -44,11 +90,18 @@ class DoAllStealingExec {
 
   enum StealAmt { HALF, FULL };
 
+  /// Where the victim of a steal runs relative to the thief, nearest first
+  enum StealLevel { kSameSocket, kSameNumaNode, kRemote, kNumStealLevels };
+
   constexpr static const bool NEED_STATS =
       katana::internal::NeedStats<ArgsTuple>::value;
   constexpr static const bool MORE_STATS =
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
+  constexpr static const bool ADAPTIVE =
+      has_trait<adaptive_chunk_size_tag, ArgsTuple>();
+
+  using Prefetch = PrefetchAhead<Iter, ArgsTuple>;
 
   struct ThreadContext {
     alignas(KATANA_CACHE_LINE_SIZE) SimpleLock work_mutex;
@@ -58,6 +111,10 @@ class DoAllStealingExec {
     Iter shared_end;
     Diff_ty m_size;
     size_t num_iter;
+    // for ChunkSizeTuner
+    size_t num_chunks;
+    // successful steals by StealLevel
+    size_t num_steals[kNumStealLevels];
 
     // Stats
 
@@ -67,7 +124,9 @@ class DoAllStealingExec {
           shared_beg(),
           shared_end(),
           m_size(0),
-          num_iter(0) {
+          num_iter(0),
+          num_chunks(0),
+          num_steals() {
       // TODO: fix this initialization problem,
       // see initThread
     }
@@ -78,9 +137,11 @@ class DoAllStealingExec {
           shared_beg(beg),
           shared_end(end),
           m_size(std::distance(beg, end)),
-          num_iter(0) {}
+          num_iter(0),
+          num_chunks(0),
+          num_steals() {}
 
-    bool doWork(F func, const unsigned chunk_size) {
+    bool doWork(F func, Prefetch& prefetch, const unsigned chunk_size) {
       Iter beg(shared_beg);
       Iter end(shared_end);
 
@@ -88,11 +149,16 @@ class DoAllStealingExec {
 
       while (getWork(beg, end, chunk_size)) {
         didwork = true;
+        if (ADAPTIVE) {
+          ++num_chunks;
+        }
 
+        prefetch.Start(beg, end);
         for (; beg != end; ++beg) {
-          if (NEED_STATS) {
+          if (NEED_STATS || ADAPTIVE) {
             ++num_iter;
           }
+          prefetch.Step();
           func(*beg);
         }
       }
@@ -259,97 +325,55 @@ private:
     return succ;
   }
 
-  KATANA_ATTRIBUTE_NOINLINE bool stealWithinSocket(ThreadContext& poor) {
-    bool sawWork = false;
-    bool stoleWork = false;
-
+  static StealLevel stealLevel(unsigned thief, unsigned victim) {
     auto& tp = GetThreadPool();
-
-    const unsigned maxT = katana::getActiveThreads();
-    const unsigned my_pack = ThreadPool::getSocket();
-    const unsigned per_pack = tp.getMaxThreads() / tp.getMaxSockets();
-
-    const unsigned pack_beg = my_pack * per_pack;
-    const unsigned pack_end = (my_pack + 1) * per_pack;
-
-    for (unsigned i = 1; i < pack_end; ++i) {
-      // go around the socket in circle starting from the next thread
-      unsigned t = (poor.id + i) % per_pack + pack_beg;
-      KATANA_LOG_DEBUG_ASSERT((t >= pack_beg) && (t < pack_end));
-
-      if (t < maxT) {
-        if (workers.getRemote(t)->hasWorkWeak()) {
-          sawWork = true;
-
-          stoleWork = transferWork(*workers.getRemote(t), poor, HALF);
-
-          if (stoleWork) {
-            break;
-          }
-        }
-      }
+    if (tp.getSocket(victim) == tp.getSocket(thief)) {
+      return kSameSocket;
     }
-
-    return sawWork || stoleWork;
+    if (tp.getNumaNode(victim) == tp.getNumaNode(thief)) {
+      return kSameNumaNode;
+    }
+    return kRemote;
   }
 
-  KATANA_ATTRIBUTE_NOINLINE bool stealOutsideSocket(
-      ThreadContext& poor, const StealAmt& amt) {
+  /// Try to steal from the threads at level, going around them in a circle
+  /// starting from the thread after poor
+  ///
+  /// @returns whether any of them had work
+  KATANA_ATTRIBUTE_NOINLINE bool stealAtLevel(
+      ThreadContext& poor, StealLevel level, StealAmt amt) {
     bool sawWork = false;
-    bool stoleWork = false;
-
-    auto& tp = GetThreadPool();
-    unsigned myPkg = ThreadPool::getSocket();
-    // unsigned maxT = LL::getMaxThreads ();
-    unsigned maxT = katana::getActiveThreads();
 
-    for (unsigned i = 0; i < maxT; ++i) {
-      ThreadContext& rich = *(workers.getRemote((poor.id + i) % maxT));
+    const unsigned maxT = katana::getActiveThreads();
 
-      if (tp.getSocket(rich.id) != myPkg) {
-        if (rich.hasWorkWeak()) {
-          sawWork = true;
+    for (unsigned i = 1; i < maxT; ++i) {
+      unsigned t = (poor.id + i) % maxT;
+      ThreadContext& rich = *(workers.getRemote(t));
 
-          stoleWork = transferWork(rich, poor, amt);
-          // stoleWork = transferWork (rich, poor, HALF);
+      if (rich.hasWorkWeak() && stealLevel(poor.id, t) == level) {
+        sawWork = true;
 
-          if (stoleWork) {
-            break;
-          }
+        if (transferWork(rich, poor, amt)) {
+          ++poor.num_steals[level];
+          telemetry.AddSteal();
+          return true;
         }
       }
     }
 
-    return sawWork || stoleWork;
+    return sawWork;
   }
 
+  /// Steal from the nearest threads first, so that work only crosses the
+  /// interconnect between sockets when nothing is left closer by
   KATANA_ATTRIBUTE_NOINLINE bool trySteal(ThreadContext& poor) {
-    bool ret = false;
-
-    ret = stealWithinSocket(poor);
-
-    if (ret) {
-      return true;
-    }
-
-    asmPause();
-
-    if (GetThreadPool().isLeader(poor.id)) {
-      ret = stealOutsideSocket(poor, HALF);
-
-      if (ret) {
+    for (StealLevel level : {kSameSocket, kSameNumaNode, kRemote}) {
+      if (stealAtLevel(poor, level, HALF)) {
         return true;
       }
       asmPause();
     }
-
-    ret = stealOutsideSocket(poor, HALF);
-    if (ret) {
-      return true;
-    }
-    asmPause();
-
-    return ret;
+    return false;
   }
 
 private:
@@ -357,6 +381,7 @@ private:
   F func;
   const char* loopname;
   Diff_ty chunk_size;
+  Prefetch prefetcher;
   PerThreadStorage<ThreadContext> workers;
 
   TerminationDetection& term;
@@ -367,25 +392,33 @@ private:
   PerThreadTimer<MORE_STATS> execTime;
   PerThreadTimer<MORE_STATS> stealTime;
   PerThreadTimer<MORE_STATS> termTime;
+  LoopTelemetry<NEED_STATS> telemetry;
 
 public:
   DoAllStealingExec(const R& _range, F _func, const ArgsTuple& argsTuple)
       : range(_range),
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
-        chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        chunk_size(
+            ADAPTIVE ? ChunkSizeTuner::Get().ChunkSize(
+                           loopname,
+                           get_trait_value<chunk_size_tag>(argsTuple).value)
+                     : get_trait_value<chunk_size_tag>(argsTuple).value),
+        prefetcher(argsTuple),
+        term(GetTerminationDetection(getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
         stealTime(loopname, "Steal"),
-        termTime(loopname, "Term") {
+        termTime(loopname, "Term"),
+        telemetry(loopname, MORE_STATS) {
     KATANA_LOG_DEBUG_ASSERT(chunk_size > 0);
   }
 
   // parallel call
   void initThread(void) {
     initTime.start();
+    telemetry.BeginThread();
 
     term.InitializeThread();
 
@@ -397,6 +430,29 @@ public:
     initTime.stop();
   }
 
+  /// Tell the ChunkSizeTuner how this invocation went; executed serially
+  void ReportChunkSize(uint64_t us) {
+    if (!ADAPTIVE) {
+      return;
+    }
+    ChunkSizeTuner::Outcome outcome;
+    outcome.chunk_size = chunk_size;
+    outcome.num_threads = katana::getActiveThreads();
+    outcome.us = us;
+    for (unsigned i = 0; i < outcome.num_threads; ++i) {
+      auto& ctx = *(workers.getRemote(i));
+      outcome.num_items += ctx.num_iter;
+      outcome.num_chunks += ctx.num_chunks;
+      for (size_t steals : ctx.num_steals) {
+        outcome.num_steals += steals;
+      }
+    }
+    if (NEED_STATS) {
+      katana::ReportStatSingle(loopname, "ChunkSize", chunk_size);
+    }
+    ChunkSizeTuner::Get().Report(loopname, outcome);
+  }
+
   ~DoAllStealingExec() {
 // executed serially
 #ifndef NDEBUG
@@ -411,17 +467,21 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    Prefetch prefetch(prefetcher);
     totalTime.start();
 
     while (true) {
       bool workHappened = false;
 
       execTime.start();
+      telemetry.BeginBusy();
+      size_t num_iter = ctx.num_iter;
 
-      if (ctx.doWork(func, chunk_size)) {
+      if (ctx.doWork(func, prefetch, chunk_size)) {
         workHappened = true;
       }
 
+      telemetry.EndBusy(ctx.num_iter - num_iter);
       execTime.stop();
 
       KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
@@ -452,10 +512,16 @@ public:
     }
 
     totalTime.stop();
+    telemetry.EndThread();
     KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
     if (NEED_STATS) {
       katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+      katana::ReportStatSum(
+          loopname, "StealsSameSocket", ctx.num_steals[kSameSocket]);
+      katana::ReportStatSum(
+          loopname, "StealsSameNumaNode", ctx.num_steals[kSameNumaNode]);
+      katana::ReportStatSum(loopname, "StealsRemote", ctx.num_steals[kRemote]);
     }
   }
 };
@@ -468,11 +534,15 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(getActiveThreads());
 
+    Timer timer;
+    timer.start();
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
+        getActiveThreads(), [&exec]() { exec.initThread(); },
         [&barrier]() { barrier.Wait(); }, std::ref(exec));
+    timer.stop();
+    exec.ReportChunkSize(timer.get_usec());
   }
 };
 
@@ -480,40 +550,49 @@ template <>
 struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
-    on_each_gen(
-        [&](const unsigned int, const unsigned int) {
-          static constexpr bool NEED_STATS =
-              katana::internal::NeedStats<ArgsT>::value;
-          static constexpr bool MORE_STATS =
-              NEED_STATS && has_trait<more_stats_tag, ArgsT>();
+    static constexpr bool NEED_STATS =
+        katana::internal::NeedStats<ArgsT>::value;
+    static constexpr bool MORE_STATS =
+        NEED_STATS && has_trait<more_stats_tag, ArgsT>();
 
-          const char* const loopname = katana::internal::getLoopName(argsTuple);
+    const char* const loopname = katana::internal::getLoopName(argsTuple);
 
+    LoopTelemetry<NEED_STATS> telemetry(loopname, MORE_STATS);
+
+    on_each_gen(
+        [&](const unsigned int, const unsigned int) {
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
 
           totalTime.start();
           initTime.start();
+          telemetry.BeginThread();
 
           auto begin = range.local_begin();
           const auto end = range.local_end();
+          PrefetchAhead<decltype(begin), ArgsT> prefetch(argsTuple);
+          prefetch.Start(begin, end);
 
           initTime.stop();
 
           execTime.start();
+          telemetry.BeginBusy();
 
           size_t iter = 0;
 
           while (begin != end) {
+            prefetch.Step();
             func(*begin++);
             if (NEED_STATS) {
               ++iter;
             }
           }
+          telemetry.EndBusy(iter);
           execTime.stop();
 
           totalTime.stop();
+          telemetry.EndThread();
 
           if (NEED_STATS) {
             katana::ReportStatSum(loopname, "Iterations", iter);
@@ -540,11 +619,15 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
   using ArgsT = decltype(argsT);
 
   constexpr bool TIME_IT = has_trait<loopname_tag, ArgsT>();
-  CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(argsT));
+  LoopStatTimer<TIME_IT> timer(katana::internal::getLoopName(argsT));
 
   timer.start();
 
-  constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
+  constexpr bool ADAPTIVE = has_trait<adaptive_chunk_size_tag, ArgsT>();
+  static_assert(
+      !ADAPTIVE || has_trait<loopname_tag, ArgsT>(),
+      "adaptive_chunk_size needs a loopname");
+  constexpr bool STEAL = has_trait<steal_tag, ArgsT>() || ADAPTIVE;
 
   OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
   internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
@@ -28,6 +28,7 @@
 #include "katana/Barrier.h"
 #include "katana/Chunk.h"
 #include "katana/Context.h"
+#include "katana/LoopCounters.h"
 #include "katana/LoopStatistics.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
@@ -152,6 +153,12 @@ public:
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
+  static constexpr bool needsInterleave = has_trait<interleave_tag, ArgsTy>();
+
+  static_assert(
+      !needsInterleave || (!needsAborts && !needsBreak && !needsPia),
+      "interleave requires disable_conflict_detection and supports neither "
+      "parallel_break nor per_iter_alloc");
 
 protected:
   typedef typename WorkListTy::value_type value_type;
@@ -193,6 +200,7 @@ protected:
 
   PerThreadTimer<MORE_STATS> initTime;
   PerThreadTimer<MORE_STATS> execTime;
+  LoopTelemetry<needStats> telemetry;
 
   inline void commitIteration(ThreadLocalData& tld) {
     if (needsPush) {
@@ -247,6 +255,41 @@ protected:
     return didWork;
   }
 
+  template <unsigned N>
+  bool runQueueInterleaved(ThreadLocalData& tld) {
+    // Items in flight and the step each is at; slots are refilled from the
+    // worklist as their items finish
+    std::optional<value_type> items[N];
+    unsigned steps[N];
+    unsigned live = 0;
+    bool more = true;
+    bool didWork = false;
+
+    while (live > 0 || more) {
+      for (unsigned i = 0; i < N; ++i) {
+        if (!items[i]) {
+          if (!more || !(items[i] = wl.pop())) {
+            more = false;
+            continue;
+          }
+          steps[i] = 0;
+          ++live;
+          didWork = true;
+          tld.inc_iterations();
+        }
+        if (tld.function(*items[i], steps[i], tld.facing.data())) {
+          items[i].reset();
+          --live;
+        }
+        if (needsPush && !tld.facing.getPushBuffer().empty()) {
+          more = true;
+        }
+        commitIteration(tld);
+      }
+    }
+    return didWork;
+  }
+
   template <unsigned int limit, typename WL>
   void runQueueDispatch(ThreadLocalData& tld, WL& lwl, RunQueueState<WL>& s) {
 #ifdef KATANA_USE_LONGJMP_ABORT
@@ -314,9 +357,15 @@ protected:
     while (true) {
       do {
         bool didWork = false;
+        telemetry.BeginBusy();
+        size_t iterations = tld.iterations();
 
         // Run some iterations
-        if (couldAbort || needsBreak) {
+        if constexpr (needsInterleave) {
+          bool b = runQueueInterleaved<
+              trait_type_t<interleave_tag, ArgsTy>::value>(tld);
+          didWork = b || didWork;
+        } else if (couldAbort || needsBreak) {
           constexpr int __NUM = (needsBreak || isLeader) ? 64 : 0;
           bool b = runQueue<__NUM>(tld, wl);
           didWork = b || didWork;
@@ -330,6 +379,10 @@ protected:
           didWork = b || didWork;
         }
 
+        if (didWork) {
+          telemetry.EndBusy(tld.iterations() - iterations);
+        }
+
         // Update node color and prop token
         term.SignalWorked(didWork);
         asmPause();  // Let token propagate
@@ -349,6 +402,8 @@ protected:
       barrier.Wait();
     }
 
+    telemetry.EndThread();
+
     if (couldAbort)
       setThreadContext(0);
   }
@@ -358,14 +413,15 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)),
+      : term(GetTerminationDetection(getActiveThreads())),
+        barrier(GetBarrier(getActiveThreads())),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
         broke(false),
         initTime(loopname, "Init"),
-        execTime(loopname, "Execute") {}
+        execTime(loopname, "Execute"),
+        telemetry(loopname, MORE_STATS) {}
 
   template <typename WArgsTy, size_t... Is>
   ForEachExecutor(
@@ -392,6 +448,7 @@ public:
   template <typename RangeTy>
   void initThread(const RangeTy& range) {
     initTime.start();
+    telemetry.BeginThread();
 
     wl.push_initial(range);
     term.InitializeThread();
@@ -401,7 +458,7 @@ public:
 
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && getActiveThreads() > 1;
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -450,12 +507,12 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
+  auto& barrier = GetBarrier(getActiveThreads());
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); },
+      getActiveThreads(), [&W, &range]() { W.initThread(range); },
       [&barrier] { barrier.Wait(); }, std::ref(W));
 }
 
@@ -475,7 +532,7 @@ for_each_gen(const RangeTy& r, FunctionTy&& fn, const TupleTy& tpl) {
           tpl, std::make_tuple(wl_tag{}), std::make_tuple(wl<defaultWL>())));
 
   constexpr bool TIME_IT = has_trait<loopname_tag, decltype(xtpl)>();
-  CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(xtpl));
+  LoopStatTimer<TIME_IT> timer(katana::internal::getLoopName(xtpl));
 
   timer.start();
 
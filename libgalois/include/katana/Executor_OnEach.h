@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 
+#include "katana/LoopCounters.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/ThreadPool.h"
 #include "katana/ThreadTimer.h"
@@ -45,7 +46,7 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
 
   const char* const loopname = katana::internal::getLoopName(argsTuple);
 
-  CondStatTimer<NEEDS_STATS> timer(loopname);
+  LoopStatTimer<NEEDS_STATS> timer(loopname);
 
   PerThreadTimer<MORE_STATS> execTime(loopname, "Execute");
 
@@ -26,6 +26,7 @@
 #include <ctime>
 #include <deque>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 #include "katana/Context.h"
@@ -103,12 +104,35 @@ struct UnorderedStepStats : public StepStatsBase {
   }
 };
 
+/// What one round of a loop run under ParaMeter did
+struct StepProfile {
+  size_t step{0};
+  /// Iterations tried in the round
+  size_t work{0};
+  /// Iterations committed in the round
+  size_t parallelism{0};
+  /// Iterations aborted for conflicts and retried in the next round
+  size_t conflicts{0};
+  /// Locks acquired by committed iterations
+  size_t neighborhood{0};
+};
+
 // Single ParaMeter stats file per run of an app
 // which includes all instances of for_each loops
 // run with ParaMeter Executor
 KATANA_EXPORT FILE* getStatsFile();
 KATANA_EXPORT void closeStatsFile();
 
+/// Whether katana::for_each runs loops named loopname under ParaMeter to
+/// profile their available parallelism. KATANA_PARAMETER_LOOPS picks the
+/// loops: a comma separated list of loopnames, or "*" for all named loops.
+KATANA_EXPORT bool IsProfiled(const char* loopname);
+
+/// Logs the rounds of a loop run under ParaMeter, and a summary of them, to
+/// the active span of the progress tracer
+KATANA_EXPORT void ReportProfile(
+    const char* loopname, const std::vector<StepProfile>& steps);
+
 template <typename T>
 class FIFO_WL {
   using PTcont = katana::PerThreadStorage<katana::gstl::Vector<T>>;
@@ -198,11 +222,22 @@ struct ChooseWL<T, SchedType::RAND> {
   using type = RAND_WL<T>;
 };
 
+/// The schedule of a ParaMeter worklist; loops that asked for any other
+/// worklist run rounds in FIFO order
+template <typename WL, typename Enable = void>
+struct ScheduleOf {
+  constexpr static SchedType value = SchedType::FIFO;
+};
+
+template <typename WL>
+struct ScheduleOf<WL, std::void_t<decltype(WL::SCHEDULE)>> {
+  constexpr static SchedType value = WL::SCHEDULE;
+};
+
 template <class T, class FunctionTy, class ArgsTy>
 class ParaMeterExecutor {
   using value_type = T;
   using GenericWL = typename trait_type<wl_tag, ArgsTy>::type::type;
-  using WorkListTy = typename GenericWL::template retype<T>;
   using dbg = katana::debug<1>;
 
   constexpr static bool needsStats = !has_trait<no_stats_tag, ArgsTy>();
@@ -230,13 +265,16 @@ class ParaMeterExecutor {
     }
   };
 
-  using PWL = typename ChooseWL<IterationContext*, WorkListTy::SCHEDULE>::type;
+  using PWL =
+      typename ChooseWL<IterationContext*, ScheduleOf<GenericWL>::value>::type;
 
 private:
   PWL m_wl;
   FunctionTy m_func;
   const char* loopname;
+  bool m_reportToTracer;
   FILE* m_statsFile;
+  std::vector<StepProfile> m_profile;
   FixedSizeAllocator<IterationContext> m_iterAlloc;
   katana::GReduceLogicalOr m_broken;
 
@@ -389,7 +427,15 @@ private:
       KATANA_LOG_DEBUG_VASSERT(
           stats.parallelism.reduce(), "ERROR: No Progress");
 
-      stats.dump(m_statsFile, loopname);
+      if (m_reportToTracer) {
+        size_t work = stats.wlSize.reduce();
+        size_t parallelism = stats.parallelism.reduce();
+        m_profile.push_back(StepProfile{
+            stats.step, work, parallelism, work - parallelism,
+            stats.nhSize.reduce()});
+      } else {
+        stats.dump(m_statsFile, loopname);
+      }
       stats.nextStep();
 
       if (needsBreak && m_broken.reduce()) {
@@ -398,14 +444,22 @@ private:
 
     }  // end while
 
-    closeStatsFile();
+    if (m_reportToTracer) {
+      ReportProfile(loopname, m_profile);
+    } else {
+      closeStatsFile();
+    }
   }
 
 public:
-  ParaMeterExecutor(const FunctionTy& f, const ArgsTy& args)
+  /// Writes the stats of each round to the ParaMeter stats file or, with
+  /// reportToTracer, logs them to the progress tracer
+  ParaMeterExecutor(
+      const FunctionTy& f, const ArgsTy& args, bool reportToTracer = false)
       : m_func(f),
         loopname(katana::internal::getLoopName(args)),
-        m_statsFile(getStatsFile()) {}
+        m_reportToTracer(reportToTracer),
+        m_statsFile(reportToTracer ? nullptr : getStatsFile()) {}
 
   // called serially once
   template <typename RangeTy>
@@ -454,7 +508,7 @@ struct ForEachExecutor<katana::ParaMeter<T>, FunctionTy, ArgsTy>
 template <typename R, typename F, typename ArgsTuple>
 void
 for_each_ParaMeter(const R& range, const F& func, const ArgsTuple& argsTuple) {
-  using T = typename R::values_type;
+  using T = typename std::iterator_traits<typename R::iterator>::value_type;
 
   auto tpl = katana::get_default_trait_values(
       argsTuple, std::make_tuple(wl_tag{}),
@@ -465,9 +519,46 @@ for_each_ParaMeter(const R& range, const F& func, const ArgsTuple& argsTuple) {
   using Exec = parameter::ParaMeterExecutor<T, F, Tpl_ty>;
   Exec exec(func, tpl);
 
-  exec.execute(range);
+  exec.init(range);
 }
 
+namespace internal {
+
+/// Whether katana::for_each can run a loop under ParaMeter when
+/// KATANA_PARAMETER_LOOPS asks for it: ParaMeter needs a loopname to pick
+/// loops by and cannot run interleaved operators
+template <typename FunctionTy, typename ArgsTuple>
+constexpr bool kCanProfileParallelism =
+    has_trait<loopname_tag, ArgsTuple>() &&
+    !has_trait<interleave_tag, ArgsTuple>() &&
+    !has_trait<
+        interleave_tag, typename function_traits<FunctionTy>::type>();
+
+/// Runs a for_each loop under ParaMeter, whatever worklist it asked for, and
+/// logs its parallelism profile to the progress tracer
+template <typename RangeTy, typename FunctionTy, typename ArgsTuple>
+void
+for_each_profiled(
+    const RangeTy& range, FunctionTy&& fn, const ArgsTuple& argsTuple) {
+  using T =
+      typename std::iterator_traits<typename RangeTy::iterator>::value_type;
+  using FuncRefType =
+      OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
+
+  auto tpl = std::tuple_cat(
+      argsTuple, typename function_traits<FunctionTy>::type{},
+      get_default_trait_values(
+          argsTuple, std::make_tuple(wl_tag{}),
+          std::make_tuple(wl<katana::ParaMeter<>>())));
+
+  FuncRefType fn_ref = fn;
+  parameter::ParaMeterExecutor<T, FuncRefType, decltype(tpl)> exec(
+      fn_ref, tpl, true);
+  exec.init(range);
+}
+
+}  // namespace internal
+
 }  // end namespace katana
 #endif
 
@@ -0,0 +1,179 @@
+#ifndef KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+#define KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace katana {
+
+/**
+ * The set of active nodes of one round of a bulk synchronous algorithm,
+ * e.g., the nodes a BFS visits next, kept either sparse, as an InsertBag of
+ * node ids, or dense, as a DynamicBitset over all nodes.
+ *
+ * Sparse frontiers are cheap to push to and to iterate when they hold few
+ * nodes. Dense frontiers cost a pass over num_nodes / 64 words to iterate,
+ * but can be tested for membership, never hold a node twice and pay off
+ * once a good part of the graph is active. ToDense and ToSparse convert
+ * between the two, and Adapt picks the representation by size.
+ *
+ * push may be called concurrently; everything else is not thread safe.
+ *
+ * \code
+ * auto current = std::make_unique<katana::Frontier<GNode>>(num_nodes);
+ * auto next = std::make_unique<katana::Frontier<GNode>>(num_nodes);
+ * next->push(source);
+ * while (!next->empty()) {
+ *   std::swap(current, next);
+ *   next->clear();
+ *   current->ForEach([&](GNode n) { ... next->push(dst); ... });
+ *   next->Adapt();
+ * }
+ * \endcode
+ */
+template <typename T = uint32_t>
+class Frontier {
+  static_assert(std::is_integral_v<T>, "only integral node ids supported");
+
+public:
+  /// Fraction of all nodes (one in kDenseDivisor) above which Adapt makes a
+  /// frontier dense
+  static constexpr size_t kDenseDivisor = 20;
+
+  explicit Frontier(size_t num_nodes = 0) : num_nodes_(num_nodes) {}
+
+  /// Adds node to the frontier. Thread safe.
+  void push(T node) {
+    KATANA_LOG_DEBUG_ASSERT(static_cast<size_t>(node) < num_nodes_);
+    if (dense_) {
+      if (!dense_nodes_.set(node)) {
+        num_pushed_ += 1;
+      }
+    } else {
+      sparse_nodes_.push(node);
+      num_pushed_ += 1;
+    }
+  }
+
+  /// Whether node is in the frontier; the frontier must be dense
+  bool test(T node) const {
+    KATANA_LOG_DEBUG_ASSERT(dense_);
+    return dense_nodes_.test(node);
+  }
+
+  bool empty() const {
+    return dense_ ? size() == 0 : sparse_nodes_.empty();
+  }
+
+  /// Number of nodes in the frontier, counting nodes pushed more than once
+  /// to a sparse frontier each time
+  size_t size() const { return num_pushed_.reduce(); }
+
+  size_t num_nodes() const { return num_nodes_; }
+
+  bool IsDense() const { return dense_; }
+
+  /// The nodes of a dense frontier
+  const DynamicBitset& bitset() const {
+    KATANA_LOG_DEBUG_ASSERT(dense_);
+    return dense_nodes_;
+  }
+
+  /// Whether a frontier of this size would rather be dense
+  bool PrefersDense() const { return size() > num_nodes_ / kDenseDivisor; }
+
+  /// Switches to a dense frontier, keeping the nodes
+  void ToDense() {
+    if (dense_) {
+      return;
+    }
+    if (dense_nodes_.size() != num_nodes_) {
+      dense_nodes_.resize(num_nodes_);
+    }
+    dense_ = true;
+    if (sparse_nodes_.empty()) {
+      return;
+    }
+    num_pushed_.reset();
+    katana::do_all(
+        katana::iterate(sparse_nodes_), [&](T node) { push(node); },
+        katana::no_stats());
+    sparse_nodes_.clear();
+  }
+
+  /// Switches to a sparse frontier, keeping the nodes
+  void ToSparse() {
+    if (!dense_) {
+      return;
+    }
+    dense_ = false;
+    if (size() == 0) {
+      return;
+    }
+    dense_nodes_.ForEachSetBit(
+        [&](size_t node) { sparse_nodes_.push(static_cast<T>(node)); },
+        katana::no_stats());
+    ClearBits();
+  }
+
+  /// Switches to the representation that PrefersDense picks
+  void Adapt() {
+    if (PrefersDense()) {
+      ToDense();
+    } else {
+      ToSparse();
+    }
+  }
+
+  /// Removes all nodes, keeping the representation
+  void clear() {
+    if (dense_) {
+      if (size() != 0) {
+        ClearBits();
+      }
+    } else {
+      sparse_nodes_.clear();
+    }
+    num_pushed_.reset();
+  }
+
+  /// Calls fn(node) for every node in parallel; args are passed on to do_all
+  template <typename F, typename... Args>
+  void ForEach(F fn, Args&&... args) {
+    if (dense_) {
+      dense_nodes_.ForEachSetBit(
+          [&](size_t node) { fn(static_cast<T>(node)); },
+          std::forward<Args>(args)...);
+    } else {
+      katana::do_all(
+          katana::iterate(sparse_nodes_), fn, std::forward<Args>(args)...);
+    }
+  }
+
+private:
+  void ClearBits() {
+    auto& words = dense_nodes_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t i) { words[i].store(0, std::memory_order_relaxed); },
+        katana::no_stats());
+  }
+
+  size_t num_nodes_;
+  bool dense_{false};
+  InsertBag<T> sparse_nodes_;
+  DynamicBitset dense_nodes_;
+  mutable GAccumulator<size_t> num_pushed_;
+};
+
+}  // namespace katana
+
+#endif
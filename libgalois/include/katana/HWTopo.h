@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_HWTOPO_H_
 #define KATANA_LIBGALOIS_KATANA_HWTOPO_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,7 @@ struct KATANA_EXPORT MachineTopoInfo {
   unsigned maxCores;
   unsigned maxSockets;
   unsigned maxNumaNodes;
+  size_t llcBytes;  // last level cache of a socket; 0 if unknown
 };
 
 struct KATANA_EXPORT HWTopoInfo {
@@ -49,9 +51,55 @@ struct KATANA_EXPORT HWTopoInfo {
   std::vector<ThreadTopoInfo> threadTopoInfo;
 };
 
+/**
+ * Orders in which threads are placed on hardware contexts: thread i is bound
+ * to the i-th context in the order. Since loops with fewer threads than the
+ * machine use the first threads, the order decides which cores run them.
+ *
+ * The placement is chosen with the environment variable
+ * KATANA_THREAD_PLACEMENT, which is one of the names below, and defaults to
+ * cores. Setting KATANA_CPU_LIST to a list of OS context ids, in the format
+ * of cpuset(7), implies cpu-list.
+ */
+enum class ThreadPlacement {
+  /// "cores": one thread per physical core, a socket at a time, and SMT
+  /// siblings only once every core has a thread; suits memory bound loops
+  kCores,
+  /// "compact": fill each core with its SMT siblings, and each socket, before
+  /// moving on; suits loops that share data between neighboring threads
+  kCompact,
+  /// "scatter": one thread per physical core, round robin across sockets, and
+  /// SMT siblings last; spreads few threads over all memory controllers
+  kScatter,
+  /// "cpu-list": the contexts in KATANA_CPU_LIST, in that order
+  kCPUList,
+};
+
+/// The placement requested through the environment
+KATANA_EXPORT ThreadPlacement GetThreadPlacement();
+
+KATANA_EXPORT const char* ThreadPlacementName(ThreadPlacement placement);
+
+/// A hardware context as the OS sees it, for PlaceThreads
+struct KATANA_EXPORT HWContext {
+  unsigned osContext;  // OS id
+  unsigned socket;     // physical package
+  unsigned core;       // core id within the socket
+};
+
+/**
+ * PlaceThreads orders contexts for placement. With kCPUList, only the
+ * contexts in cpuList are kept, in its order, and ids that are not in
+ * contexts are ignored.
+ */
+KATANA_EXPORT std::vector<HWContext> PlaceThreads(
+    std::vector<HWContext> contexts, ThreadPlacement placement,
+    const std::vector<int>& cpuList = {});
+
 /**
  * getHWTopo determines the machine topology from the process information
- * exposed in /proc and /dev filesystems.
+ * exposed in /proc and /dev filesystems. Threads are numbered in the order
+ * given by GetThreadPlacement.
  */
 KATANA_EXPORT HWTopoInfo getHWTopo();
 
@@ -0,0 +1,62 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPCOUNTERS_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPCOUNTERS_H_
+
+#include "katana/Timer.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// Whether the named loop loopname is measured with hardware counters.
+/// KATANA_LOOP_COUNTERS picks the loops: a comma separated list of loopnames,
+/// or "*" for all named loops. Counters are only available on Linux, through
+/// perf_event_open, and are limited by /proc/sys/kernel/perf_event_paranoid.
+KATANA_EXPORT bool IsCounted(const char* loopname);
+
+/// Start the counters of every active thread of the pool. Must be called
+/// outside of parallel loops.
+KATANA_EXPORT void StartLoopCounters();
+
+/// Stop the counters of every active thread of the pool, and report what each
+/// counted since StartLoopCounters as stats of each thread, summed over the
+/// threads, under loopname: "Cycles", "LLCMisses", "BranchMisses" and
+/// "RemoteNUMAAccesses", those the machine supports.
+KATANA_EXPORT void StopLoopCounters(const char* loopname);
+
+}  // namespace internal
+
+/// The timer of a parallel loop: a CondStatTimer that also measures the loop
+/// with hardware counters if internal::IsCounted(loopname). The counters are
+/// started before the timer and stopped after it, so that the time of the
+/// loop does not include theirs.
+template <bool Enable>
+class LoopStatTimer {
+  CondStatTimer<Enable> timer_;
+  const char* loopname_;
+  bool counted_;
+
+public:
+  LoopStatTimer(const char* loopname)
+      : timer_(loopname),
+        loopname_(loopname),
+        counted_(Enable && internal::IsCounted(loopname)) {}
+
+  void start() {
+    if (counted_) {
+      internal::StartLoopCounters();
+    }
+    timer_.start();
+  }
+
+  void stop() {
+    timer_.stop();
+    if (counted_) {
+      internal::StopLoopCounters(loopname_);
+    }
+  }
+};
+
+}  // namespace katana
+
+#endif
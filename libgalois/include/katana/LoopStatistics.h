@@ -20,6 +20,12 @@
 #ifndef KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 #define KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "katana/PerThreadStorage.h"
 #include "katana/Statistics.h"
 #include "katana/config.h"
 
@@ -70,5 +76,114 @@ public:
   inline void inc_conflicts() const {}
 };
 
+/// Per-thread telemetry of a parallel loop, to tell load imbalance apart
+/// from the cost of stealing and termination. Each thread records when its
+/// part of the loop began and ended, and how long it was busy running the
+/// operator. When destroyed, serially after the loop, the telemetry reports
+/// as stats of each thread under the loopname "BusyTime" and "IdleTime", in
+/// microseconds, where the idle time is from when the thread ran out of work
+/// until the last thread did, which the thread spends at the barrier that ends
+/// the loop. For the loop, it reports "Imbalance": the longest busy time over
+/// the mean one, 1 for a perfectly balanced loop; its largest value over the
+/// invocations of the loop.
+///
+/// Named loops with the more_stats trait collect telemetry, as do the named
+/// loops listed by KATANA_LOOP_TELEMETRY (a comma separated list of loopnames,
+/// or "*" for all). The loops listed by KATANA_LOOP_TIMELINE also add the busy
+/// intervals and steals of each thread to a timeline in the Chrome trace event
+/// format, which chrome://tracing and Perfetto open, in the file
+/// KATANA_LOOP_TIMELINE_FILE, or loop-timeline.json.
+template <bool Enabled>
+class LoopTelemetry {
+public:
+  LoopTelemetry(const char*, bool) {}
+
+  bool enabled() const { return false; }
+
+  inline void BeginThread() const {}
+  inline void BeginBusy() const {}
+  inline void EndBusy(size_t) const {}
+  inline void AddSteal() const {}
+  inline void EndThread() const {}
+};
+
+template <>
+class KATANA_EXPORT LoopTelemetry<true> {
+  struct Interval {
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    size_t items;
+  };
+
+  struct ThreadData {
+    uint64_t begin_ns = 0;
+    uint64_t end_ns = 0;
+    uint64_t busy_begin_ns = 0;
+    uint64_t busy_ns = 0;
+    // only kept for the timeline
+    std::vector<Interval> intervals;
+    std::vector<uint64_t> steals_ns;
+  };
+
+  const char* loopname_;
+  bool timeline_;
+  std::unique_ptr<PerThreadStorage<ThreadData>> threads_;
+
+  static uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void EndBusyImpl(size_t items);
+  void WriteTimeline();
+
+public:
+  /// @param more_stats whether the loop has the more_stats trait
+  LoopTelemetry(const char* loopname, bool more_stats);
+  ~LoopTelemetry();
+
+  LoopTelemetry(const LoopTelemetry&) = delete;
+  LoopTelemetry& operator=(const LoopTelemetry&) = delete;
+
+  bool enabled() const { return threads_ != nullptr; }
+
+  /// Called by each thread when it starts on its part of the loop
+  inline void BeginThread() {
+    if (enabled()) {
+      threads_->getLocal()->begin_ns = NowNs();
+    }
+  }
+
+  /// Called by each thread before running the operator
+  inline void BeginBusy() {
+    if (enabled()) {
+      threads_->getLocal()->busy_begin_ns = NowNs();
+    }
+  }
+
+  /// Called by each thread after running the operator on items items since
+  /// BeginBusy
+  inline void EndBusy(size_t items) {
+    if (enabled()) {
+      EndBusyImpl(items);
+    }
+  }
+
+  /// Called by each thread when it has stolen work
+  inline void AddSteal() {
+    if (enabled() && timeline_) {
+      threads_->getLocal()->steals_ns.emplace_back(NowNs());
+    }
+  }
+
+  /// Called by each thread when it has run out of work for good
+  inline void EndThread() {
+    if (enabled()) {
+      threads_->getLocal()->end_ns = NowNs();
+    }
+  }
+};
+
 }  // namespace katana
 #endif
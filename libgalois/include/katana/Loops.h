@@ -40,7 +40,15 @@ namespace katana {
  * Galois unordered set iterator.
  *
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
- * is a value from the iteration range and T is the type of item.
+ * is a value from the iteration range and T is the type of item, or to
+ * <code>bool fn(item, unsigned& step, UserContext<T>&)</code> with
+ * {@see interleave}.
+ *
+ * @param range an iterator range typically returned by @ref katana::iterate
+ * @param fn operator
+ * Loops with a loopname listed in the environment variable
+ * KATANA_PARAMETER_LOOPS run under ParaMeter instead and log their available
+ * parallelism to the progress tracer; see {@see parameter::IsProfiled}.
  *
  * @param range an iterator range typically returned by @ref katana::iterate
  * @param fn operator
@@ -51,6 +59,12 @@ template <typename Range, typename FunctionTy, typename... Args>
 void
 for_each(const Range& range, FunctionTy&& fn, Args&&... args) {
   auto tpl = std::make_tuple(std::forward<Args>(args)...);
+  if constexpr (internal::kCanProfileParallelism<FunctionTy, decltype(tpl)>) {
+    if (parameter::IsProfiled(internal::getLoopName(tpl))) {
+      internal::for_each_profiled(range, std::forward<FunctionTy>(fn), tpl);
+      return;
+    }
+  }
   for_each_gen(range, std::forward<FunctionTy>(fn), tpl);
 }
 
@@ -10,6 +10,17 @@ namespace katana {
 // Using a signed type to make underflow more apparent
 using count_t = int64_t;
 
+/// What memory is used for, to break memory use down for reports
+enum class MemoryKind {
+  /// The main topologies of graphs
+  kTopology,
+  /// Topologies derived from the main ones for views
+  kViews,
+  kProperties,
+  /// Working memory of analytics and everything else
+  kScratch,
+};
+
 /// Managers track the memory consumption for specific, large resources, e.g.,
 /// properties or views.  They interact with the central MemorySupervisor (MS singleton)
 /// to coordinate memory use.  They do not allocate memory, they only track it.
@@ -28,6 +39,9 @@ public:
   /// All managers must have unique names
   virtual const std::string& Name() const = 0;
 
+  /// What the memory of this manager is used for
+  virtual MemoryKind Kind() const { return MemoryKind::kScratch; }
+
   /// Free standby memory, attempting to free \p goal bytes.
   /// Returns the number of bytes freed, which can only be less than goal if the
   /// manager's standby total is less than goal.
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <unordered_map>
 
 #include "katana/Manager.h"
@@ -33,9 +35,27 @@ public:
       [[maybe_unused]] count_t active,
       [[maybe_unused]] count_t standby) const = 0;
 
+  /// Given the current memory counts and whatever OS sources the policy consults,
+  /// how much standby memory should we reclaim before allocating \p bytes of
+  /// active memory? Policies that do not look ahead return 0 and only react to
+  /// memory pressure after the allocation.
+  virtual count_t ReclaimForAllocation(
+      [[maybe_unused]] count_t active, [[maybe_unused]] count_t standby,
+      [[maybe_unused]] count_t bytes) const {
+    return 0;
+  }
+
   /// Utility function to find out our OOM score from Linux
   static uint64_t OOMScore();
 
+  /// Utility function to find the cgroup v2 directory of this process, e.g.,
+  /// /sys/fs/cgroup/kubepods/pod1234, if any
+  static std::optional<std::string> CgroupDir();
+
+  /// Utility function to find the memory limit (memory.max) of the cgroup v2
+  /// of this process, if it has one
+  static std::optional<uint64_t> CgroupMemoryLimit();
+
   struct MemInfo;
   struct Thresholds {
     double high_used_ratio_threshold;
@@ -80,4 +100,45 @@ public:
   bool KillSelfForLackOfMemory(count_t active, count_t standby) const override;
 };
 
+/// Memory policy for processes whose memory is limited by a cgroup (v2), e.g.,
+/// containers. It measures memory use against the limit of the cgroup
+/// (memory.max) with the usage of the whole cgroup (memory.current) rather
+/// than against physical memory and our own RSS, which is what the kernel
+/// enforces. It also reclaims when the kernel reports that tasks of the
+/// cgroup stall on memory (memory.pressure), and it reclaims ahead of large
+/// allocations so that the cgroup does not hit its limit before we react.
+class KATANA_EXPORT MemoryPolicyCgroup : public MemoryPolicy {
+public:
+  /// Percentage of the last 10 seconds that some task of the cgroup stalled
+  /// on memory, above which memory pressure is high
+  static constexpr double kHighPressureStallPercent = 10.0;
+
+  /// Policy for the cgroup in \p cgroup_dir or, if it is empty, the cgroup of
+  /// this process. Fails if the cgroup has no memory limit.
+  static Result<std::unique_ptr<MemoryPolicyCgroup>> Make(
+      const std::string& cgroup_dir = "");
+
+  count_t ReclaimForMemoryPressure(
+      count_t active, count_t standby) const override;
+  bool MemoryPressureHigh(count_t active, count_t standby) const override;
+  bool KillSelfForLackOfMemory(count_t active, count_t standby) const override;
+  count_t ReclaimForAllocation(
+      count_t active, count_t standby, count_t bytes) const override;
+
+  struct CgroupInfo {
+    count_t limit;
+    /// memory.current less the inactive page cache of memory.stat
+    count_t working_set;
+    /// some avg10 of memory.pressure, 0 if the kernel does not report it
+    double stall_percent;
+  };
+  CgroupInfo ReadCgroupInfo() const;
+
+private:
+  MemoryPolicyCgroup(std::string cgroup_dir, count_t limit);
+
+  std::string cgroup_dir_;
+  count_t limit_;
+};
+
 }  // namespace katana
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 
 #include "katana/Cache.h"
 #include "katana/Manager.h"
 #include "katana/MemoryPolicy.h"
+#include "katana/Metrics.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
@@ -24,6 +26,22 @@ namespace katana {
 /// bad decisions.
 
 class PropertyManager;
+class TopologyManager;
+
+/// The peak memory use the MemorySupervisor saw during a MemoryPhase, in
+/// bytes. Each peak is taken on its own, so the peaks of the kinds may be
+/// from different moments and do not add up to the peak of the total.
+struct MemoryPeaks {
+  /// Active memory, which cannot be reclaimed
+  count_t active{};
+  /// Active and standby memory
+  count_t used{};
+  /// Active and standby memory by MemoryKind
+  count_t topology{};
+  count_t views{};
+  count_t properties{};
+  count_t scratch{};
+};
 
 class KATANA_EXPORT MemorySupervisor {
 public:
@@ -38,6 +56,10 @@ public:
     return mm_;
   }
 
+  /// Inform MS that \p bytes of active memory are about to be allocated, e.g.,
+  /// for a view, so that it can reclaim standby memory to make room for them
+  /// first. The allocation must still be reported with BorrowActive.
+  void PrepareBorrowActive(count_t bytes);
   /// Inform MS of allocation of \p bytes for active memory
   /// Application cannot continue if it does not get memory
   void BorrowActive(const std::string& name, count_t bytes);
@@ -65,10 +87,21 @@ public:
   PropertyManager* GetPropertyManager();
   CacheStats GetPropertyCacheStats() const;
 
-  /// Calls sysconf
+  /// Provide access to the topology manager, which manages cached topologies
+  TopologyManager* GetTopologyManager();
+  CacheStats GetTopologyCacheStats() const;
+
+  /// Provide access to the manager named \p name, adding an AllocationManager
+  /// of \p kind by that name if there is none, e.g., for an AllocationAccount
+  Manager* GetAllocationManager(
+      const std::string& name, MemoryKind kind = MemoryKind::kScratch);
+
+  /// Calls sysconf, limited by the memory limit of our cgroup, if any
   static uint64_t GetTotalSystemMemory();
 
 private:
+  friend class MemoryPhase;
+
   MemorySupervisor();
   /// Make sure our state is sane, log if not
   void SanityCheck();
@@ -80,6 +113,9 @@ private:
     std::unique_ptr<Manager> manager_;
     count_t active{};
     count_t standby{};
+    /// The metrics of the manager, looked up on first use
+    MetricGauge* active_metric{};
+    MetricGauge* standby_metric{};
   };
   std::unordered_map<std::string, ManagerInfo> managers_;
 
@@ -97,10 +133,57 @@ private:
   void StandbyMinus(ManagerInfo& info, count_t bytes);
   void StandbyPlus(ManagerInfo& info, count_t bytes);
 
+  /// Sum of active and standby memory by MemoryKind
+  std::array<count_t, 4> used_by_kind_{};
+  void UsedPlus(ManagerInfo& info, count_t bytes);
+
+  /// Publish the memory of the manager and the totals as metrics, e.g.,
+  /// katana_memory_active_bytes{manager="property"}, so that they can be
+  /// read from other threads
+  void PublishMetrics(ManagerInfo& info);
+
+  /// The peaks of the open MemoryPhases, by id
+  std::unordered_map<uint64_t, MemoryPeaks> phases_;
+  uint64_t next_phase_{};
+  void UpdatePeaks();
+  uint64_t BeginPhase();
+  MemoryPeaks PhasePeaks(uint64_t id) const;
+  void EndPhase(uint64_t id);
+
   /// The maximum amount of physical memory the MS plans to use, which should be less
   /// than or equal to the total physical memory in the machine.  There are users of
   /// memory outside our control, like the operating system.
   count_t physical_{};
 };
 
+/// While a MemoryPhase is alive, the MemorySupervisor keeps the peak memory
+/// use it hears about from managers, e.g., properties and view topologies,
+/// and from AllocationAccounts. When the phase is destroyed it sets the peaks
+/// as tags of the active span, in GB: peak_active_gb, peak_used_gb, and by
+/// kind peak_topology_gb, peak_views_gb, peak_properties_gb and
+/// peak_scratch_gb. So that the span reports them when it finishes, make the
+/// phase after the ProgressScope of the span:
+///
+/// \code
+/// auto scope = katana::GetTracer().StartActiveSpan("pagerank");
+/// katana::MemoryPhase phase;
+/// \endcode
+///
+/// Phases nest. Like the MemorySupervisor, they belong on the main thread.
+class KATANA_EXPORT MemoryPhase {
+public:
+  MemoryPhase();
+  ~MemoryPhase();
+  MemoryPhase(const MemoryPhase&) = delete;
+  MemoryPhase(MemoryPhase&&) = delete;
+  MemoryPhase& operator=(const MemoryPhase&) = delete;
+  MemoryPhase& operator=(MemoryPhase&&) = delete;
+
+  /// The peaks since the phase began
+  MemoryPeaks Peaks() const;
+
+private:
+  uint64_t id_;
+};
+
 }  // namespace katana
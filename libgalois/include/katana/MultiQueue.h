@@ -0,0 +1,241 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Logging.h"
+#include "katana/PaddedLock.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+#include "katana/config.h"
+
+namespace katana {
+/**
+ * Relaxed priority scheduling with a MultiQueue (Rihani, Sanders and
+ * Dementiev, 2015): QueuesPerThread binary heaps per active thread, each
+ * guarded by its own spinlock, and no shared index of priorities.
+ *
+ * push adds an item to a random heap. pop looks at the cached minima of two
+ * random heaps without locking them and pops from the better one. A heap
+ * that is locked is never waited for; another one is picked instead. Items
+ * therefore come out in roughly, but not exactly, increasing order of their
+ * index, like with {@link OrderedByIntegerMetric}, but there is no master
+ * log of buckets for threads to contend on, which makes it a better fit for
+ * many threads and priorities. In exchange, each push and pop costs a heap
+ * operation.
+ *
+ * pop only returns nothing after it has found every heap empty, so no work
+ * is left behind when a loop terminates.
+ *
+ * Indexer is as for OrderedByIntegerMetric, but the index must be an
+ * integral type, and its largest value (smallest with UseDescending) marks
+ * empty heaps, so items may not have it.
+ *
+ * \code
+ * katana::for_each(
+ *     katana::iterate(items), Fn,
+ *     katana::wl<katana::MultiQueue<Indexer>>(Indexer{}));
+ * \endcode
+ *
+ * @tparam Indexer         Indexer class
+ * @tparam QueuesPerThread Heaps per active thread; more heaps mean less
+ *                         contention but a looser order
+ * @tparam UseDescending   Pop the largest index first instead
+ */
+template <
+    class Indexer = DummyIndexer<int>, typename T = int, typename Index = int,
+    unsigned QueuesPerThread = 2, bool UseDescending = false,
+    bool Concurrent = true>
+class MultiQueue : private boost::noncopyable {
+  static_assert(
+      std::is_integral<Index>::value, "only integral index types supported");
+  static_assert(QueuesPerThread > 0, "need at least one queue per thread");
+
+public:
+  template <typename _T>
+  using retype = MultiQueue<
+      Indexer, _T, typename std::result_of<Indexer(_T)>::type,
+      QueuesPerThread, UseDescending, Concurrent>;
+
+  template <bool _b>
+  using rethread =
+      MultiQueue<Indexer, T, Index, QueuesPerThread, UseDescending, _b>;
+
+  template <unsigned _queues_per_thread>
+  struct with_queues_per_thread {
+    typedef MultiQueue<
+        Indexer, T, Index, _queues_per_thread, UseDescending, Concurrent>
+        type;
+  };
+
+  template <bool _use_descending>
+  struct with_descending {
+    typedef MultiQueue<
+        Indexer, T, Index, QueuesPerThread, _use_descending, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  typedef std::pair<Index, T> Entry;
+  typedef std::conditional_t<
+      UseDescending, std::less<Index>, std::greater<Index>>
+      HeapCompare;
+
+  /// Index cached for an empty heap, later than any real one
+  static constexpr Index kEmpty = UseDescending
+                                      ? std::numeric_limits<Index>::min()
+                                      : std::numeric_limits<Index>::max();
+
+  struct alignas(KATANA_CACHE_LINE_SIZE) Queue {
+    PaddedLock<Concurrent> lock;
+    /// Index of the top of heap, read without holding lock
+    std::atomic<Index> top{kEmpty};
+    std::vector<Entry> heap;
+
+    void push(Index index, const T& val) {
+      heap.emplace_back(index, val);
+      std::push_heap(heap.begin(), heap.end(), compare);
+      top.store(heap.front().first, std::memory_order_relaxed);
+    }
+
+    T pop() {
+      std::pop_heap(heap.begin(), heap.end(), compare);
+      T val = std::move(heap.back().second);
+      heap.pop_back();
+      top.store(
+          heap.empty() ? kEmpty : heap.front().first,
+          std::memory_order_relaxed);
+      return val;
+    }
+
+    static bool compare(const Entry& a, const Entry& b) {
+      return HeapCompare()(a.first, b.first);
+    }
+  };
+
+  struct ThreadData {
+    // xorshift state, seeded on first use by the thread that owns it
+    uint64_t rng{0};
+  };
+
+  std::unique_ptr<Queue[]> queues;
+  size_t numQueues;
+  PerThreadStorage<ThreadData> data;
+  Indexer indexer;
+
+  static bool earlier(Index a, Index b) { return HeapCompare()(b, a); }
+
+  size_t randomQueue(ThreadData& p) {
+    if (p.rng == 0) {
+      p.rng = (ThreadPool::getTID() + 1) * UINT64_C(0x9E3779B97F4A7C15);
+    }
+    p.rng ^= p.rng << 13;
+    p.rng ^= p.rng >> 7;
+    p.rng ^= p.rng << 17;
+    return p.rng % numQueues;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  std::optional<value_type> slowPop(ThreadData& p) {
+    // Sweep all queues, starting from a random one, waiting for the locks
+    // this time, so that only a worklist that was empty when each queue was
+    // visited reports empty
+    size_t start = randomQueue(p);
+    for (size_t i = 0; i < numQueues; ++i) {
+      Queue& q = queues[(start + i) % numQueues];
+      if (q.top.load(std::memory_order_relaxed) == kEmpty) {
+        continue;
+      }
+      q.lock.lock();
+      if (!q.heap.empty()) {
+        T val = q.pop();
+        q.lock.unlock();
+        return val;
+      }
+      q.lock.unlock();
+    }
+    return std::nullopt;
+  }
+
+public:
+  MultiQueue(const Indexer& x = Indexer())
+      : queues(new Queue[std::max(getActiveThreads(), 1U) * QueuesPerThread]),
+        numQueues(std::max(getActiveThreads(), 1U) * QueuesPerThread),
+        indexer(x) {}
+
+  void push(const value_type& val) {
+    Index index = indexer(val);
+    KATANA_LOG_DEBUG_ASSERT(index != kEmpty);
+    ThreadData& p = *data.getLocal();
+    while (true) {
+      Queue& q = queues[randomQueue(p)];
+      if (q.lock.try_lock()) {
+        q.push(index, val);
+        q.lock.unlock();
+        return;
+      }
+    }
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& p = *data.getLocal();
+    // a few tries at the two-choice pop before falling back to a sweep
+    for (unsigned tries = 0; tries < 4; ++tries) {
+      Queue* a = &queues[randomQueue(p)];
+      Queue* b = &queues[randomQueue(p)];
+      Index a_top = a->top.load(std::memory_order_relaxed);
+      Index b_top = b->top.load(std::memory_order_relaxed);
+      if (earlier(b_top, a_top)) {
+        std::swap(a, b);
+        std::swap(a_top, b_top);
+      }
+      if (a_top == kEmpty) {
+        continue;
+      }
+      if (!a->lock.try_lock()) {
+        continue;
+      }
+      if (!a->heap.empty()) {
+        T val = a->pop();
+        a->lock.unlock();
+        return val;
+      }
+      a->lock.unlock();
+    }
+    return slowPop(p);
+  }
+};
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // end namespace katana
+
+#endif
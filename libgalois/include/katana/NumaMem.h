@@ -22,8 +22,10 @@
 
 #include <cstddef>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "katana/Manager.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -31,12 +33,46 @@ namespace katana {
 namespace internal {
 struct KATANA_EXPORT largeFreer {
   size_t bytes;
+  /// Name of the manager the allocation was reported to, if any
+  const std::string* account{nullptr};
   void operator()(void* ptr) const;
 };
 }  // namespace internal
 
 typedef std::unique_ptr<void, internal::largeFreer> LAptr;
 
+/// While an AllocationAccount is alive, the large allocations below that its
+/// thread makes, and so the NUMAArrays it allocates, are reported to the
+/// MemorySupervisor as active memory of the manager named \p name, which is
+/// added if there is none yet. The MemorySupervisor may reclaim standby
+/// memory, e.g., cached properties, to make room before each allocation. The
+/// memory is returned to the same manager when it is freed. If accounts nest,
+/// the innermost one counts. The \p kind of a new manager says what its
+/// memory is used for in the reports of a MemoryPhase.
+///
+/// Accounting is opt in, so that memory the MemorySupervisor already hears
+/// about from another manager, e.g., view topologies, is not counted twice.
+/// Like the MemorySupervisor, accounts belong on the main thread.
+///
+/// \code
+/// katana::AllocationAccount account("analytics");
+/// katana::NUMAArray<uint32_t> distances;
+/// distances.allocateInterleaved(graph.NumNodes());
+/// \endcode
+class KATANA_EXPORT AllocationAccount {
+public:
+  explicit AllocationAccount(
+      const std::string& name, MemoryKind kind = MemoryKind::kScratch);
+  ~AllocationAccount();
+  AllocationAccount(const AllocationAccount&) = delete;
+  AllocationAccount(AllocationAccount&&) = delete;
+  AllocationAccount& operator=(const AllocationAccount&) = delete;
+  AllocationAccount& operator=(AllocationAccount&&) = delete;
+
+private:
+  const std::string* prev_;
+};
+
 KATANA_EXPORT LAptr largeMallocLocal(size_t bytes);  // fault in locally
 KATANA_EXPORT LAptr
 largeMallocFloating(size_t bytes);  // leave numa mapping undefined
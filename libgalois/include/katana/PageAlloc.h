@@ -35,6 +35,36 @@ KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
 // free page range
 KATANA_EXPORT void freePages(void* ptr, unsigned num);
 
+/// Pages that back large allocations, i.e., largeMalloc* and so NUMAArrays
+enum class LargePageKind {
+  /// Explicit 2 MB huge pages (MAP_HUGETLB), else transparent huge pages
+  kHuge2M,
+  /// Regular pages that the kernel is advised to back with transparent huge
+  /// pages (MADV_HUGEPAGE)
+  kTransparent,
+  /// Explicit 1 GB huge pages for allocations of at least 1 GB, which need
+  /// 1 GB pages reserved in the hugetlb pool, else as kHuge2M
+  kHuge1G,
+  /// Regular pages
+  kNone,
+};
+
+/// The large page kind configured with the environment variable
+/// KATANA_LARGE_PAGES, one of 2m, thp, 1g or none; kHuge2M by default
+KATANA_EXPORT LargePageKind GetLargePageKind();
+
+KATANA_EXPORT const char* LargePageKindName(LargePageKind kind);
+
+/// Allocate pages for a large allocation of \p *bytes, a multiple of
+/// allocSize(), optionally faulting them in. Tries the pages of
+/// GetLargePageKind() first and falls back to smaller ones. Rounds \p *bytes
+/// up to a multiple of the page size used; free them with freePages.
+KATANA_EXPORT void* allocLargePages(size_t* bytes, bool preFault);
+
+/// Bytes of large allocations so far that got pages of \p kind; kNone counts
+/// regular pages and kTransparent those advised to become huge pages
+KATANA_EXPORT size_t numLargePageBytes(LargePageKind kind);
+
 }  // namespace katana
 
 #endif
@@ -501,8 +501,8 @@ copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate pred) {
   on_each([&](unsigned tid, unsigned total) {
     auto [begin, end] = block_range(first, last, tid, total);
     diff_type count = 0;
-    for (; first != last; ++first) {
-      if (pred(first)) {
+    for (; begin != end; ++begin) {
+      if (pred(*begin)) {
         count++;
       }
     }
@@ -519,7 +519,7 @@ copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate pred) {
     diff_type offset = tid == 0 ? 0 : prefix_sum[tid - 1];
     OutputIt actual_end = std::copy_if(begin, end, d_first + offset, pred);
 
-    KATANA_LOG_DEBUG_ASSERT(actual_end == prefix_sum[tid]);
+    KATANA_LOG_DEBUG_ASSERT(actual_end == d_first + prefix_sum[tid]);
   });
 
   return d_first + prefix_sum.back();
@@ -179,27 +179,33 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getSlot(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getSlot(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getSlot(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getSlot(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
+  //! The number of objects, one for every thread of the pool, which is the
+  //! same wherever it is called; getRemote takes any thread id below it
   unsigned size() const { return GetThreadPool().getMaxThreads(); }
 
+  //! The number of threads of the group the calling thread runs in, or of
+  //! the pool if it runs in none, whose objects loops of the caller use
+  unsigned groupSize() const { return GetThreadPool().getGroupThreads(); }
+
   iterator begin() { return iterator(*this, 0); }
 
   iterator end() { return iterator(*this, size()); }
@@ -216,9 +222,10 @@ class PerSocketStorage {
 
   void destruct() {
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
-          ->~T();
+    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
+      if (tp.isSocketLeaderSlot(n)) {
+        reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
+      }
     }
     b->deallocOffset(offset, sizeof(T));
   }
@@ -232,11 +239,14 @@ public:
     // This will call initPTS for each thread if it hasn't already
     GetThreadPool();
 
+    // the threads of a socket share the storage of its first slot, whichever
+    // group they run in
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
-          T(std::forward<Args>(args)...);
+    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
+      if (tp.isSocketLeaderSlot(n)) {
+        new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+      }
     }
   }
 
@@ -267,36 +277,36 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getSlot(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getSlot(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getSlot(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getSlot(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemoteByPkg(unsigned int pkg) {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
-    return reinterpret_cast<T*>(ditem);
+    return getRemote(GetThreadPool().getLeaderForSocket(pkg));
   }
 
   const T* getRemoteByPkg(unsigned int pkg) const {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
-    return reinterpret_cast<T*>(ditem);
+    return getRemote(GetThreadPool().getLeaderForSocket(pkg));
   }
 
   unsigned size() const { return GetThreadPool().getMaxThreads(); }
+
+  unsigned groupSize() const { return GetThreadPool().getGroupThreads(); }
 };
 
 }  // end namespace katana
@@ -0,0 +1,75 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PHASESAMPLER_H_
+#define KATANA_LIBGALOIS_KATANA_PHASESAMPLER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Phases attribute the samples of a profiler to what the program was doing,
+/// which the stacks of the threads of a parallel loop do not show. The phase
+/// stack of the process is the running StatTimers of the main thread, e.g.,
+/// "AnalyticsSession/ViewsTimer" and, inside it, the timer of a named loop,
+/// whose phase is its loopname.
+///
+/// Setting the environment variable KATANA_PROFILE_PHASES to a file turns on
+/// a sampler: SIGPROF interrupts whichever thread is running every
+/// 1/KATANA_PROFILE_PHASES_HZ (default 1000) seconds of CPU time, on any
+/// thread, and counts a sample of the current phase stack. When the
+/// GaloisRuntime is destroyed, the counts are written to the file as folded
+/// stacks, "outer;inner count" lines, which flamegraph.pl and speedscope
+/// read. Without KATANA_PROFILE_PHASES, timers do not touch the phase stack
+/// at all.
+
+/// Marks a phase for the lifetime of the object, for code without a
+/// StatTimer; only on the main thread
+class KATANA_EXPORT PhaseScope {
+public:
+  explicit PhaseScope(std::string_view name);
+  ~PhaseScope();
+
+  PhaseScope(const PhaseScope&) = delete;
+  PhaseScope& operator=(const PhaseScope&) = delete;
+  PhaseScope(PhaseScope&&) = delete;
+  PhaseScope& operator=(PhaseScope&&) = delete;
+
+private:
+  int depth_;
+};
+
+namespace internal {
+
+/// Whether phases are being sampled
+KATANA_EXPORT bool SamplingPhases();
+
+/// The id of the phase called name, 0 if phases are not sampled
+KATANA_EXPORT uint32_t InternPhase(std::string_view name);
+
+/// Push phase id on the phase stack if phases are sampled and this is the
+/// main thread. Returns what to pass to PopPhase, -1 if nothing was pushed.
+KATANA_EXPORT int PushPhase(uint32_t id);
+
+/// Pop the phase pushed by the PushPhase that returned depth, and any phases
+/// pushed after it
+KATANA_EXPORT void PopPhase(int depth);
+
+/// Start the sampler if KATANA_PROFILE_PHASES is set
+KATANA_EXPORT void StartPhaseSampler();
+
+/// Stop the sampler, if it was started, and write its samples
+KATANA_EXPORT void StopPhaseSampler();
+
+/// The samples so far, by folded phase stack, most sampled first
+KATANA_EXPORT std::vector<std::pair<std::string, uint64_t>>
+FoldedPhaseSamples();
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
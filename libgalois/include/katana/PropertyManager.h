@@ -1,7 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "katana/Cache.h"
 #include "katana/Manager.h"
@@ -17,6 +20,7 @@ public:
   ///   e.g., property for the property manager
   static const std::string name_;
   const std::string& Name() const override { return name_; }
+  MemoryKind Kind() const override { return MemoryKind::kProperties; }
   count_t FreeStandbyMemory(count_t goal) override;
 
   /// Client wants a property, see if we have it in the cache and if so return it and
@@ -34,11 +38,33 @@ public:
       const katana::Uri& property_path,
       const std::shared_ptr<arrow::Table>& property);
 
+  /// Client wants a property that another graph may still be using, e.g.,
+  /// an unchanged property of another version of the same RDG. Returns the
+  /// property loaded from property_path if any graph still holds it, sharing
+  /// its memory rather than loading the file again, and nullptr otherwise.
+  std::shared_ptr<arrow::Table> GetLoadedProperty(
+      const katana::Uri& property_path);
+
+  /// The property was loaded from property_path and may be shared with
+  /// later loads of the same file for as long as some graph holds on to it
+  void PropertyLoadedShared(
+      const katana::Uri& property_path,
+      const std::shared_ptr<arrow::Table>& property);
+
   CacheStats GetPropertyCacheStats() const { return cache_->GetStats(); }
 
 private:
+  /// A property in use that may be shared; only the column is tracked since
+  /// graphs keep the columns of what they load, not the tables
+  struct LoadedProperty {
+    std::shared_ptr<arrow::Field> field;
+    std::weak_ptr<arrow::ChunkedArray> column;
+  };
+
   void MakePropertyCache();
   std::unique_ptr<PropertyCache> cache_;
+  std::mutex loaded_mutex_;
+  std::unordered_map<katana::Uri, LoadedProperty, katana::Uri::Hash> loaded_;
 };
 
 }  // namespace katana
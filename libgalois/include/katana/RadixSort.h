@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Range.h"
+#include "katana/Threads.h"
+
+namespace katana {
+
+/// Radix sorts consume keys 8 bits at a time
+constexpr unsigned kRadixSortDigitBits = 8;
+constexpr size_t kRadixSortNumBuckets = size_t{1} << kRadixSortDigitBits;
+
+/// Number of digit passes needed to sort keys no larger than \p max_key
+inline unsigned
+RadixSortNumPasses(uint64_t max_key) noexcept {
+  unsigned passes = 0;
+  while (max_key != 0) {
+    ++passes;
+    max_key >>= kRadixSortDigitBits;
+  }
+  return passes;
+}
+
+/// Stable sequential LSD radix sort of \p keys, moving \p values along with
+/// their keys. Only as many passes as the digits of the largest key are made.
+///
+/// This is meant to be called on many short arrays from inside a parallel
+/// loop, e.g., once per adjacency list, so the caller provides scratch
+/// buffers of at least \p n elements (typically kept in PerThreadStorage).
+template <typename Key, typename Value>
+void
+RadixSortPairs(
+    Key* keys, Value* values, size_t n, Key* key_scratch,
+    Value* value_scratch) noexcept {
+  static_assert(std::is_unsigned_v<Key>);
+  static_assert(std::is_trivially_copyable_v<Value>);
+
+  if (n < 2) {
+    return;
+  }
+
+  Key max_key = *std::max_element(keys, keys + n);
+  unsigned num_passes = RadixSortNumPasses(max_key);
+
+  Key* key_src = keys;
+  Value* value_src = values;
+  Key* key_dst = key_scratch;
+  Value* value_dst = value_scratch;
+
+  for (unsigned pass = 0; pass < num_passes; ++pass) {
+    const unsigned shift = pass * kRadixSortDigitBits;
+    std::array<size_t, kRadixSortNumBuckets> offsets{};
+
+    for (size_t i = 0; i < n; ++i) {
+      ++offsets[(key_src[i] >> shift) & (kRadixSortNumBuckets - 1)];
+    }
+
+    size_t sum = 0;
+    for (auto& offset : offsets) {
+      size_t count = offset;
+      offset = sum;
+      sum += count;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      size_t pos =
+          offsets[(key_src[i] >> shift) & (kRadixSortNumBuckets - 1)]++;
+      key_dst[pos] = key_src[i];
+      value_dst[pos] = value_src[i];
+    }
+
+    std::swap(key_src, key_dst);
+    std::swap(value_src, value_dst);
+  }
+
+  if (key_src != keys) {
+    std::memcpy(keys, key_src, n * sizeof(Key));
+    std::memcpy(values, value_src, n * sizeof(Value));
+  }
+}
+
+/// Stable parallel LSD radix sort of \p data by the unsigned key returned by
+/// \p key_fn, which must not exceed \p max_key.
+///
+/// Each pass, every thread counts the digits of a contiguous block of the
+/// input into its own buckets; the buckets are then prefix summed in (digit,
+/// thread) order so that each thread scatters its block to disjoint, stable
+/// positions.
+template <typename T, typename KeyFn>
+void
+ParallelRadixSortByKey(
+    T* data, size_t n, const KeyFn& key_fn, uint64_t max_key) noexcept {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  unsigned num_passes = RadixSortNumPasses(max_key);
+  if (n < 2 || num_passes == 0) {
+    return;
+  }
+
+  using Buckets = std::array<size_t, kRadixSortNumBuckets>;
+  katana::PerThreadStorage<Buckets> buckets;
+  const unsigned num_threads = katana::getActiveThreads();
+
+  katana::NUMAArray<T> scratch;
+  scratch.allocateInterleaved(n);
+
+  T* src = data;
+  T* dst = scratch.data();
+
+  for (unsigned pass = 0; pass < num_passes; ++pass) {
+    const unsigned shift = pass * kRadixSortDigitBits;
+    auto digit = [&](const T& v) {
+      return (static_cast<uint64_t>(key_fn(v)) >> shift) &
+             (kRadixSortNumBuckets - 1);
+    };
+
+    katana::on_each([&](unsigned tid, unsigned total) {
+      Buckets& local = *buckets.getLocal();
+      local.fill(0);
+      auto [b, e] = katana::block_range(size_t{0}, n, tid, total);
+      for (size_t i = b; i < e; ++i) {
+        ++local[digit(src[i])];
+      }
+    });
+
+    size_t sum = 0;
+    for (size_t d = 0; d < kRadixSortNumBuckets; ++d) {
+      for (unsigned t = 0; t < num_threads; ++t) {
+        size_t& offset = (*buckets.getRemote(t))[d];
+        size_t count = offset;
+        offset = sum;
+        sum += count;
+      }
+    }
+
+    katana::on_each([&](unsigned tid, unsigned total) {
+      Buckets& local = *buckets.getLocal();
+      auto [b, e] = katana::block_range(size_t{0}, n, tid, total);
+      for (size_t i = b; i < e; ++i) {
+        dst[local[digit(src[i])]++] = src[i];
+      }
+    });
+
+    std::swap(src, dst);
+  }
+
+  if (src != data) {
+    katana::ParallelSTL::copy(src, src + n, data);
+  }
+}
+
+}  // namespace katana
@@ -26,6 +26,7 @@
 #include <boost/iterator/counting_iterator.hpp>
 
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/TwoLevelIterator.h"
 #include "katana/config.h"
 #include "katana/gstl.h"
@@ -206,7 +207,7 @@ public:
 private:
   std::pair<local_iterator, local_iterator> local_pair() const {
     return katana::block_range(
-        begin_, end_, ThreadPool::getTID(), katana::activeThreads);
+        begin_, end_, ThreadPool::getTID(), katana::getActiveThreads());
   }
 
   Iterator begin_;
@@ -244,7 +245,7 @@ private:
    */
   std::pair<local_iterator, local_iterator> local_pair() const {
     uint32_t my_thread_id = ThreadPool::getTID();
-    uint32_t total_threads = activeThreads;
+    uint32_t total_threads = getActiveThreads();
 
     iterator local_begin = thread_beginnings_[my_thread_id];
     iterator local_end = thread_beginnings_[my_thread_id + 1];
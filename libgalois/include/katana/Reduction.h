@@ -20,9 +20,15 @@
 #ifndef KATANA_LIBGALOIS_KATANA_REDUCTION_H_
 #define KATANA_LIBGALOIS_KATANA_REDUCTION_H_
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <limits>
+#include <tuple>
+#include <vector>
 
+#include "katana/Barrier.h"
+#include "katana/Executor_OnEach.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/config.h"
 
@@ -109,6 +115,39 @@ public:
     return lhs;
   }
 
+  /**
+   * Returns the final reduction value like reduce, but merges the per thread
+   * values in a tree across the active threads, which takes a number of
+   * merges logarithmic in the number of threads on each path instead of
+   * linear. This pays off when merges are expensive, e.g., for containers;
+   * scalars are faster to fold with reduce. MergeFunc must be safe to call
+   * from several threads at once. Only valid outside the parallel region.
+   */
+  T& reduce_parallel() {
+    Barrier& barrier = GetBarrier(getActiveThreads());
+    on_each_gen(
+        [&](unsigned tid, unsigned num) {
+          T& lhs = *data_.getRemote(tid);
+          // values of inactive threads first
+          for (unsigned i = tid + num; i < data_.size(); i += num) {
+            T& rhs = *data_.getRemote(i);
+            merge(lhs, std::move(rhs));
+            rhs = IDFunc::operator()();
+          }
+          for (unsigned step = 1; step < num; step *= 2) {
+            barrier.Wait();
+            if (tid % (2 * step) == 0 && tid + step < num) {
+              T& rhs = *data_.getRemote(tid + step);
+              merge(lhs, std::move(rhs));
+              rhs = IDFunc::operator()();
+            }
+          }
+        },
+        std::make_tuple());
+
+    return *data_.getRemote(0);
+  }
+
   void reset() {
     for (unsigned int i = 0; i < data_.size(); ++i) {
       *data_.getRemote(i) = IDFunc::operator()();
@@ -202,6 +241,114 @@ public:
   GReduceMin() : base_type(gmin<T>(), identity_value_max<T>()) {}
 };
 
+//! Element-wise sum of std::array<T, K>
+template <typename T, size_t K>
+struct garray_plus {
+  std::array<T, K>& operator()(
+      std::array<T, K>& lhs, std::array<T, K>&& rhs) const {
+    for (size_t i = 0; i < K; ++i) {
+      lhs[i] += rhs[i];
+    }
+    return lhs;
+  }
+};
+
+template <typename T, size_t K>
+struct identity_array_zero {
+  std::array<T, K> operator()() const { return std::array<T, K>{}; }
+};
+
+//! Accumulator for a fixed number of sums at once, e.g., the statistics of a
+//! pass, which are then combined with one reduction instead of K
+template <typename T, size_t K>
+class GArrayAccumulator : public Reducible<
+                              std::array<T, K>, garray_plus<T, K>,
+                              identity_array_zero<T, K>> {
+  using base_type = Reducible<
+      std::array<T, K>, garray_plus<T, K>, identity_array_zero<T, K>>;
+
+public:
+  GArrayAccumulator()
+      : base_type(garray_plus<T, K>(), identity_array_zero<T, K>()) {}
+
+  //! Adds v to the i-th sum
+  void update(size_t i, const T& v) { base_type::getLocal()[i] += v; }
+};
+
+/**
+ * Accumulator for a vector of sums whose size is only known at runtime, e.g.,
+ * a histogram. Each thread has its own vector, allocated by the thread that
+ * updates it, so it is local to that thread's NUMA node.
+ *
+ * reduce sums per thread vectors into the vector of the calling thread with
+ * all active threads, each summing a contiguous slice of the elements, so
+ * that the time it takes grows with size rather than size times the number
+ * of threads.
+ */
+template <typename T>
+class GVectorAccumulator {
+  katana::PerThreadStorage<std::vector<T>> data_;
+
+  //! Run fn(v) for the vector v of every thread in parallel
+  template <typename F>
+  void forEachVector(F fn) {
+    on_each_gen(
+        [&](unsigned tid, unsigned num) {
+          for (unsigned i = tid; i < data_.size(); i += num) {
+            fn(*data_.getRemote(i));
+          }
+        },
+        std::make_tuple());
+  }
+
+public:
+  using value_type = std::vector<T>;
+
+  explicit GVectorAccumulator(size_t size = 0) { resize(size); }
+
+  //! Resizes the vector, setting every sum to zero; not thread safe
+  void resize(size_t size) {
+    forEachVector([size](std::vector<T>& v) {
+      v.clear();
+      v.resize(size, T{0});
+    });
+  }
+
+  size_t size() const { return data_.getLocal()->size(); }
+
+  //! Adds v to the i-th sum
+  void update(size_t i, const T& v) { (*data_.getLocal())[i] += v; }
+
+  std::vector<T>& getLocal() { return *data_.getLocal(); }
+
+  /**
+   * Returns the vector of sums. Only valid outside the parallel region.
+   */
+  std::vector<T>& reduce() {
+    std::vector<T>& result = *data_.getRemote(0);
+    on_each_gen(
+        [&](unsigned tid, unsigned num) {
+          size_t size = result.size();
+          size_t begin = size * tid / num;
+          size_t end = size * (tid + 1) / num;
+          for (unsigned i = 1; i < data_.size(); ++i) {
+            std::vector<T>& v = *data_.getRemote(i);
+            for (size_t j = begin; j < end; ++j) {
+              result[j] += v[j];
+              v[j] = T{0};
+            }
+          }
+        },
+        std::make_tuple());
+    return result;
+  }
+
+  void reset() {
+    forEachVector(
+        [](std::vector<T>& v) { std::fill(v.begin(), v.end(), T{0}); });
+  }
+};
+
 //! logical AND reduction
 class GReduceLogicalAnd
     : public Reducible<
@@ -57,7 +57,7 @@ public:
       combined_error.update(                                                   \
           ::katana::internal::CheckedExpressionToError(result_name)            \
               .WithContext(__VA_ARGS__)                                        \
-              .WithContext(FMT_STRING("({}:{})"), __FILE__, __LINE__));        \
+              .WithSourceInfo(__FILE__, __LINE__));                            \
       return;                                                                  \
     }                                                                          \
     std::move(                                                                 \
@@ -72,7 +72,9 @@ public:
     combined_error, expression, format_str, ...)                               \
   KATANA_COMBINE_ERROR_IMPL(                                                   \
       combined_error, KATANA_CHECKED_NAME(_error_or_value, __COUNTER__),       \
-      expression, FMT_STRING(format_str), ##__VA_ARGS__)
+      expression,                                                              \
+      ::katana::internal::MakeLiteralFormat(FMT_STRING(format_str)),           \
+      ##__VA_ARGS__)
 
 /// KATANA_COMBINE_ERROR_CODE is similar to KATANA_CHECKED_ERROR_CODE
 /// except that instead of returning the error, it adds the error
@@ -82,7 +84,9 @@ public:
     combined_error, expression, error_code, format_str, ...)                   \
   KATANA_COMBINE_ERROR_IMPL(                                                   \
       combined_error, KATANA_CHECKED_NAME(_error_or_value, __COUNTER__),       \
-      expression, error_code, FMT_STRING(format_str), ##__VA_ARGS__)
+      expression, error_code,                                                  \
+      ::katana::internal::MakeLiteralFormat(FMT_STRING(format_str)),           \
+      ##__VA_ARGS__)
 
 /// KATANA_COMBINE_ERROR is similar to KATANA_CHECKED
 /// except that instead of returning the error, it adds the error
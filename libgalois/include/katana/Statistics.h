@@ -22,6 +22,7 @@
 
 #include <limits>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #include "katana/config.h"
@@ -128,11 +129,14 @@ struct StatTotal {
 
 namespace internal {
 
+/// Stats of one thread, or the merged stats of all threads, by region and
+/// category. Looking up a stat that exists compares strings but allocates
+/// nothing, so that recording stats in loops is cheap.
 template <typename Stat_tp>
 struct BasicStatMap {
   using Stat = Stat_tp;
   using Str = katana::gstl::Str;
-  using StrSet = katana::gstl::Set<Str>;
+  using StrSet = katana::gstl::Set<Str, std::less<>>;
   using StatMap = katana::gstl::Map<std::tuple<const Str*, const Str*>, Stat>;
   using const_iterator = typename StatMap::const_iterator;
 
@@ -140,12 +144,15 @@ protected:
   StrSet symbols;
   StatMap statMap;
 
-  const Str* getOrInsertSymbol(const Str& s) {
-    auto p = symbols.insert(s);
-    return &*(p.first);
+  const Str* getOrInsertSymbol(std::string_view s) {
+    auto i = symbols.find(s);
+    if (i == symbols.end()) {
+      i = symbols.emplace(s).first;
+    }
+    return &*i;
   }
 
-  const Str* getSymbol(const Str& s) const {
+  const Str* getSymbol(std::string_view s) const {
     auto i = symbols.find(s);
 
     if (i == symbols.cend()) {
@@ -158,18 +165,19 @@ protected:
 public:
   template <typename... Args>
   Stat& getOrInsertStat(
-      const Str& region, const Str& category, Args&&... args) {
+      std::string_view region, std::string_view category, Args&&... args) {
     const Str* ln = getOrInsertSymbol(region);
     const Str* cat = getOrInsertSymbol(category);
 
     auto tpl = std::make_tuple(ln, cat);
 
-    auto p = statMap.emplace(tpl, Stat(std::forward<Args>(args)...));
+    auto p = statMap.try_emplace(tpl, std::forward<Args>(args)...);
 
     return p.first->second;
   }
 
-  const_iterator findStat(const Str& region, const Str& category) const {
+  const_iterator findStat(
+      std::string_view region, std::string_view category) const {
     const Str* ln = getSymbol(region);
     const Str* cat = getSymbol(category);
     auto tpl = std::make_tuple(ln, cat);
@@ -179,7 +187,8 @@ public:
     return i;
   }
 
-  const Stat& getStat(const Str& region, const Str& category) const {
+  const Stat& getStat(
+      std::string_view region, std::string_view category) const {
     auto i = findStat(region, category);
     KATANA_LOG_DEBUG_ASSERT(i != statMap.end());
     return i->second;
@@ -187,7 +196,7 @@ public:
 
   template <typename T, typename... Args>
   void addToStat(
-      const Str& region, const Str& category, const T& val,
+      std::string_view region, std::string_view category, const T& val,
       Args&&... statArgs) {
     Stat& s =
         getOrInsertStat(region, category, std::forward<Args>(statArgs)...);
@@ -348,16 +357,19 @@ public:
 
   void SetStatFile(const std::string& outfile);
 
+  /// Adds a stat for this thread. Thread safe; takes no locks and, once
+  /// the thread has seen region and category, allocates nothing. The stats
+  /// of all threads are merged when they are printed.
   void AddInt(
-      const std::string& region, const std::string& category, int64_t val,
+      std::string_view region, std::string_view category, int64_t val,
       const StatTotal::Type& type);
 
   void AddFP(
-      const std::string& region, const std::string& category, double val,
+      std::string_view region, std::string_view category, double val,
       const StatTotal::Type& type);
 
   void AddParam(
-      const std::string& region, const std::string& category, const Str& val);
+      std::string_view region, std::string_view category, const Str& val);
 
   void Print();
 };
@@ -372,7 +384,7 @@ KATANA_EXPORT StatManager* sysStatManager();
 template <typename T>
 void
 ReportParam(
-    const std::string& region, const std::string& category, const T& value) {
+    std::string_view region, std::string_view category, const T& value) {
   if (internal::sysStatManager()) {
     internal::sysStatManager()->AddParam(
         region, category, gstl::makeStr(value));
@@ -386,7 +398,7 @@ ReportParam(
 template <typename T>
 void
 ReportStat(
-    const std::string& region, const std::string& category, const T& value,
+    std::string_view region, std::string_view category, const T& value,
     const StatTotal::Type& type,
     std::enable_if_t<std::is_integral_v<T>>* = nullptr) {
   if (internal::sysStatManager()) {
@@ -401,7 +413,7 @@ ReportStat(
 template <typename T>
 void
 ReportStat(
-    const std::string& region, const std::string& category, const T& value,
+    std::string_view region, std::string_view category, const T& value,
     const StatTotal::Type& type,
     std::enable_if_t<std::is_floating_point_v<T>>* = nullptr) {
   if (internal::sysStatManager()) {
@@ -416,35 +428,35 @@ ReportStat(
 template <typename T>
 void
 ReportStatSingle(
-    const std::string& region, const std::string& category, const T& value) {
+    std::string_view region, std::string_view category, const T& value) {
   ReportStat(region, category, value, StatTotal::SINGLE);
 }
 
 template <typename T>
 void
 ReportStatMin(
-    const std::string& region, const std::string& category, const T& value) {
+    std::string_view region, std::string_view category, const T& value) {
   ReportStat(region, category, value, StatTotal::TMIN);
 }
 
 template <typename T>
 void
 ReportStatMax(
-    const std::string& region, const std::string& category, const T& value) {
+    std::string_view region, std::string_view category, const T& value) {
   ReportStat(region, category, value, StatTotal::TMAX);
 }
 
 template <typename T>
 void
 ReportStatSum(
-    const std::string& region, const std::string& category, const T& value) {
+    std::string_view region, std::string_view category, const T& value) {
   ReportStat(region, category, value, StatTotal::TSUM);
 }
 
 template <typename T>
 void
 ReportStatAvg(
-    const std::string& region, const std::string& category, const T& value) {
+    std::string_view region, std::string_view category, const T& value) {
   ReportStat(region, category, value, StatTotal::TAVG);
 }
 
@@ -453,7 +465,8 @@ ReportStatAvg(
 //! @param id Identifier to prefix stat with in statistics output
 KATANA_EXPORT void reportRUsage(const std::string& id);
 
-//! Reports system memory stats for all threads
+//! Reports system memory stats for all threads, and the bytes of large
+//! allocations by the kind of pages they got
 KATANA_EXPORT void reportPageAlloc(const char* category);
 
 class [[nodiscard]] ReportPageAllocGuard {
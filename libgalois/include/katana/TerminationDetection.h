@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_TERMINATIONDETECTION_H_
 
 #include <atomic>
+#include <memory>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/PerThreadStorage.h"
@@ -110,6 +111,11 @@ public:
 
 namespace internal {
 void SetTerminationDetection(TerminationDetection* term);
+
+/// Create a termination detection for the loops of a thread group, of the
+/// kind the runtime uses
+KATANA_EXPORT std::unique_ptr<TerminationDetection>
+CreateTerminationDetection();
 }  // end namespace internal
 
 }  // end namespace katana
@@ -0,0 +1,78 @@
+#ifndef KATANA_LIBGALOIS_KATANA_THREADGROUP_H_
+#define KATANA_LIBGALOIS_KATANA_THREADGROUP_H_
+
+#include <memory>
+#include <utility>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class ThreadGroupLease;
+
+/// Lease num_threads threads of the thread pool to run parallel loops apart
+/// from its other threads, so that several requests of a service can run
+/// their analytics at the same time, each on threads of its own, instead of
+/// taking turns on the whole pool or oversubscribing it.
+///
+/// Groups are leased from the threads above those setActiveThreads gives to
+/// loops outside of groups, so a service that leases threads keeps few of
+/// them there, e.g., with setActiveThreads(1). Groups at least a socket wide
+/// start at a socket and groups smaller than one stay within one if they
+/// can, so a group does not share caches or memory controllers with another
+/// one more than it has to. Waits until enough threads are free; num_threads
+/// is clamped to the threads there are, and leasing fails if there are none.
+KATANA_EXPORT Result<ThreadGroupLease> LeaseThreadGroup(unsigned num_threads);
+
+/// Threads of the thread pool leased with LeaseThreadGroup. The threads
+/// return to the pool when the lease is destroyed.
+///
+/// A group runs the parallel loops of the function passed to Run. The thread
+/// that calls Run takes the place of the first thread of the group, and
+/// inside Run the group is the whole machine: getActiveThreads() is the size
+/// of the group, thread ids, sockets and numa nodes are numbered from zero
+/// within it, and each group has barriers and termination detection of its
+/// own. Per-thread storage is shared by the whole pool, so a container that
+/// is filled by the threads of a group is read by the same group.
+class KATANA_EXPORT ThreadGroupLease {
+public:
+  ThreadGroupLease(ThreadGroupLease&& other) noexcept;
+  ThreadGroupLease& operator=(ThreadGroupLease&& other) noexcept;
+  ThreadGroupLease(const ThreadGroupLease&) = delete;
+  ThreadGroupLease& operator=(const ThreadGroupLease&) = delete;
+  ~ThreadGroupLease();
+
+  /// The number of threads of the group, including the one that calls Run
+  unsigned size() const;
+
+  /// Call fn() on the calling thread, running the parallel loops it starts
+  /// on the threads of the group, and return what it returns. One thread at
+  /// a time may run a group, and a thread in a group cannot run another one.
+  template <typename F>
+  decltype(auto) Run(F&& fn) {
+    struct Leave {
+      ThreadGroupLease* lease;
+      ~Leave() { lease->Leave(); }
+    };
+    Enter();
+    Leave leave{this};
+    return std::forward<F>(fn)();
+  }
+
+private:
+  struct Impl;
+
+  friend Result<ThreadGroupLease> LeaseThreadGroup(unsigned num_threads);
+
+  explicit ThreadGroupLease(std::unique_ptr<Impl>&& impl);
+
+  void Enter();
+  void Leave();
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace katana
+
+#endif
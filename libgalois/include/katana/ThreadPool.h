@@ -25,6 +25,8 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -51,7 +53,39 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace katana {
 
+class TerminationDetection;
+
+namespace internal {
+class BarrierCache;
+}  // namespace internal
+
 class KATANA_EXPORT ThreadPool {
+public:
+  /// A contiguous range of threads of the pool leased to run parallel loops
+  /// apart from the rest of the pool, see leaseGroup. The thread that runs a
+  /// group takes the place of its first thread, and every thread in it sees
+  /// the group as the whole machine: thread ids, sockets and numa nodes are
+  /// numbered from zero within the group.
+  struct Group {
+    //! pool slot of the first thread of the group
+    unsigned base;
+    //! number of threads in the group
+    unsigned num;
+    //! number of threads in the pool, past which slots wrap around
+    unsigned poolThreads;
+    //! machine as seen from inside the group
+    MachineTopoInfo mi;
+    //! topology of each thread as seen from inside the group
+    std::vector<ThreadTopoInfo> topo;
+    std::function<void(void)> work;
+    bool running{false};
+    //! topology of the thread running the group before it entered it
+    ThreadTopoInfo callerTopo;
+    //! barriers and termination detection of the loops of the group
+    internal::BarrierCache* barriers{nullptr};
+    TerminationDetection* term{nullptr};
+  };
+
 private:
   friend class GaloisRuntime;
 
@@ -70,7 +104,13 @@ private:
     unsigned wbegin, wend;
     std::atomic<int> done;
     std::atomic<int> fastRelease;
+    //! topology as seen from the group the thread runs in, if any
     ThreadTopoInfo topo;
+    //! pool slot of the thread
+    unsigned slot{0};
+    //! pool slot of thread 0 of the group the thread runs in
+    unsigned base{0};
+    Group* group{nullptr};
 
     void wakeup(bool fastmode) {
       if (fastmode) {
@@ -101,6 +141,7 @@ private:
   thread_local static per_signal my_box;
 
   MachineTopoInfo mi;
+  std::vector<ThreadTopoInfo> hwThreads;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
   unsigned reserved;
@@ -108,6 +149,15 @@ private:
   bool running;
   std::function<void(void)> work;
 
+  //! guards leased and defaultThreads
+  std::mutex groupLock;
+  std::condition_variable groupFreed;
+  std::vector<bool> leased;
+  //! threads used by loops outside of groups; groups lease the ones above
+  unsigned defaultThreads;
+  //! lowest leased slot, or maxThreads if none is leased
+  std::atomic<unsigned> leaseFloor;
+
   //! destroy all threads
   void destroyCommon();
 
@@ -126,6 +176,20 @@ private:
   //! execute work on num threads
   void runInternal(unsigned num);
 
+  //! execute work on num threads of the group of the calling thread
+  void runGroupInternal(unsigned num);
+
+  //! first slot of a free range of num slots, or ~0U if there is none
+  unsigned findFreeRange(unsigned num) const;
+
+  const ThreadTopoInfo& topoOf(unsigned tid) const {
+    return my_box.group ? my_box.group->topo[tid] : hwThreads[tid];
+  }
+
+  const MachineTopoInfo& machineOf() const {
+    return my_box.group ? my_box.group->mi : mi;
+  }
+
   ThreadPool();
 
 public:
@@ -155,7 +219,7 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
+    (my_box.group ? my_box.group->work : work) = std::ref(lwork);
     // work =
     // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
     KATANA_LOG_DEBUG_ASSERT(num <= getMaxThreads());
@@ -170,34 +234,77 @@ public:
   // experimental: leave busy wait
   void beKind();
 
-  //! return the number of non-reserved threads in the pool
-  unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
+  //! return the number of non-reserved threads in the pool, or of threads in
+  //! the group the calling thread runs in
+  unsigned getMaxUsableThreads() const {
+    return my_box.group ? my_box.group->num : mi.maxThreads - reserved;
+  }
   //! return the number of threads supported by the thread pool on the current
   //! machine
   unsigned getMaxThreads() const { return mi.maxThreads; }
-  unsigned getMaxCores() const { return mi.maxCores; }
-  unsigned getMaxSockets() const { return mi.maxSockets; }
-  unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
+  unsigned getMaxCores() const { return machineOf().maxCores; }
+  unsigned getMaxSockets() const { return machineOf().maxSockets; }
+  unsigned getMaxNumaNodes() const { return machineOf().maxNumaNodes; }
+
+  //! return the number of threads in the group the calling thread runs in,
+  //! or in the pool if it runs in none
+  unsigned getGroupThreads() const {
+    return my_box.group ? my_box.group->num : mi.maxThreads;
+  }
 
   unsigned getLeaderForSocket(unsigned pid) const {
-    for (unsigned i = 0; i < getMaxThreads(); ++i)
+    for (unsigned i = 0; i < getGroupThreads(); ++i)
       if (getSocket(i) == pid && isLeader(i))
         return i;
     abort();
   }
 
-  bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+  //! whether slot is the first slot of its socket, regardless of groups
+  bool isSocketLeaderSlot(unsigned slot) const {
+    return hwThreads[slot].socketLeader == slot;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
-  unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+
+  bool isLeader(unsigned tid) const {
+    return topoOf(tid).socketLeader == tid;
   }
+  unsigned getSocket(unsigned tid) const { return topoOf(tid).socket; }
+  unsigned getLeader(unsigned tid) const { return topoOf(tid).socketLeader; }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return topoOf(tid).cumulativeMaxSocket;
   }
-  unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+  unsigned getNumaNode(unsigned tid) const { return topoOf(tid).numaNode; }
+
+  //! Lease num contiguous threads above those used by loops outside of
+  //! groups, waiting until enough are free. Groups at least a socket wide
+  //! start at a socket, smaller ones stay within one if they can. Returns
+  //! nullptr if the pool has no threads to lease. num is clamped to the
+  //! threads there are.
+  std::unique_ptr<Group> leaseGroup(unsigned num);
+
+  //! return the threads of group to the pool
+  void releaseGroup(std::unique_ptr<Group> group);
+
+  //! Make the calling thread thread 0 of group until it calls leaveGroup;
+  //! parallel loops it runs in between run on the threads of the group
+  void enterGroup(Group* group);
+  void leaveGroup();
+
+  //! Set the number of threads used by loops outside of groups, clamped to
+  //! the threads below every leased group; returns the number set
+  unsigned setDefaultThreads(unsigned num);
+
+  //! return the group the calling thread runs in, if any
+  static Group* getGroup() { return my_box.group; }
+
+  //! return the pool slot of thread tid of the group the calling thread runs
+  //! in, used to address per-thread storage. Ids past the end of the pool
+  //! wrap around to the slots below the group, so every tid below
+  //! getMaxThreads() names a slot of its own from inside any group.
+  static unsigned getSlot(unsigned tid) {
+    unsigned slot = my_box.base + tid;
+    const Group* group = my_box.group;
+    return group && slot >= group->poolThreads ? slot - group->poolThreads
+                                               : slot;
   }
 
   static unsigned getTID() { return my_box.topo.tid; }
@@ -28,12 +28,14 @@ namespace katana {
  * Sets the number of threads to use when running any Galois iterator. Returns
  * the actual value of threads used, which could be less than the requested
  * value. System behavior is undefined if this function is called during
- * parallel execution or after the first parallel execution.
+ * parallel execution or after the first parallel execution. The threads of
+ * leased thread groups are not available, see ThreadGroup.h.
  */
 KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
 
 /**
- * Returns the number of threads in use.
+ * Returns the number of threads in use, or the size of the thread group the
+ * calling thread runs in.
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_TIMER_H_
 
 #include <chrono>
+#include <cstdint>
 
 #include "katana/config.h"
 #include "katana/gstl.h"
@@ -64,6 +65,9 @@ class KATANA_EXPORT StatTimer : public TimeAccumulator {
   gstl::Str name_;
   gstl::Str region_;
   bool valid_;
+  //! phase of this timer while it runs, see PhaseSampler.h
+  uint32_t phase_{0};
+  int phase_depth_{-1};
 
 public:
   StatTimer(const char* name, const char* region);
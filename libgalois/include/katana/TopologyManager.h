@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "katana/Cache.h"
+#include "katana/Manager.h"
+
+namespace katana {
+
+/// Manager for the memory of topologies derived from a graph's main topology,
+/// e.g., the transposed and sorted copies cached by a PGViewCache.
+///
+/// A topology is active while a view may be using it. Its owner puts it on
+/// standby once no view refers to it anymore, and standby topologies are
+/// evicted in LRU order under memory pressure. Like the MemorySupervisor, this
+/// is not thread safe.
+class KATANA_EXPORT TopologyManager : public Manager {
+public:
+  using TopologyID = uint64_t;
+  /// Called when a standby topology is evicted; must release its memory
+  using Evictor = std::function<void()>;
+
+  TopologyManager() = default;
+  ~TopologyManager();
+  /// Returns the coarse category of memory use
+  static const std::string name_;
+  const std::string& Name() const override { return name_; }
+  MemoryKind Kind() const override { return MemoryKind::kViews; }
+  count_t FreeStandbyMemory(count_t goal) override;
+
+  /// A topology of \p bytes was built, account for it as active memory
+  TopologyID TopologyBuiltActive(count_t bytes);
+
+  /// The owner is reusing topology \p id, make its memory active again
+  void TopologyReused(TopologyID id);
+
+  /// The owner no longer uses topology \p id. Returns true if the topology
+  /// is now standby, in which case \p evictor may be called at any later
+  /// point to reclaim it. Otherwise the MemorySupervisor did not allow it to
+  /// be kept and the owner must drop the topology immediately.
+  bool PutTopology(TopologyID id, Evictor evictor);
+
+  /// The owner dropped topology \p id. No-op if it was already evicted.
+  void TopologyDropped(TopologyID id);
+
+  CacheStats GetTopologyCacheStats() const { return stats_; }
+
+private:
+  struct Entry {
+    count_t bytes{};
+    bool standby{false};
+    Evictor evictor;
+    // position in lru_list_, only meaningful when standby
+    std::list<TopologyID>::iterator lru_it;
+  };
+
+  std::unordered_map<TopologyID, Entry> entries_;
+  /// standby topologies, most recently used first
+  std::list<TopologyID> lru_list_;
+  TopologyID next_id_{0};
+  CacheStats stats_;
+};
+
+}  // namespace katana
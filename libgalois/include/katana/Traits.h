@@ -219,6 +219,17 @@ struct loopname : public trait_has_value<const char*>, loopname_tag {
 struct steal_tag {};
 struct steal : public trait_has_type<bool>, steal_tag {};
 
+/**
+ * Indicate that @{link do_all()} loops should tune their chunk size at
+ * runtime, starting from the chunk_size given, if any, and learning from
+ * every invocation of the loop with the same loopname; see ChunkSizeTuner.
+ * Implies steal. Optional argument to {@link do_all()} loops, which must also
+ * have a loopname.
+ */
+struct adaptive_chunk_size_tag {};
+struct adaptive_chunk_size : public trait_has_type<bool>,
+                             adaptive_chunk_size_tag {};
+
 /**
  * Indicates worklist to use. Optional argument to {@link for_each()} loops.
  */
@@ -235,6 +246,36 @@ wl(Args... args) {
   return s_wl<T, Args...>(std::move(args)...);
 }
 
+/**
+ * Indicates that {@link do_all()} loops should prefetch for the items they
+ * are about to run: before running an item, a thread prefetches
+ * accessor(item N positions ahead in its chunk), which should be the
+ * address that item would otherwise miss on, e.g., the data of its first
+ * neighbor. The accessor runs for every item and returns a pointer, or
+ * nullptr to prefetch nothing.
+ *
+ * \code
+ * katana::do_all(
+ *     katana::iterate(graph), Fn,
+ *     katana::prefetch_distance<8>([&](Node n) -> const void* { ... }));
+ * \endcode
+ */
+struct prefetch_distance_tag {};
+template <unsigned N, typename Accessor>
+struct s_prefetch_distance : public trait_has_type<bool>,
+                             prefetch_distance_tag {
+  static_assert(N > 0, "prefetch distance must be positive");
+  constexpr static unsigned value = N;
+  Accessor accessor;
+  s_prefetch_distance(Accessor a) : accessor(std::move(a)) {}
+};
+
+template <unsigned N, typename Accessor>
+s_prefetch_distance<N, Accessor>
+prefetch_distance(Accessor accessor) {
+  return s_prefetch_distance<N, Accessor>(std::move(accessor));
+}
+
 /**
  * Indicates the operator may request the parallel loop to be suspended and a
  * given function run in serial
@@ -242,6 +283,30 @@ wl(Args... args) {
 struct parallel_break_tag {};
 struct parallel_break : public trait_has_type<bool>, parallel_break_tag {};
 
+/**
+ * Indicates that each thread of a {@link for_each()} loop should interleave
+ * up to N items at a time, to overlap the cache misses of operators that
+ * chase pointers or wait on memory with the work on other items.
+ *
+ * The operator is then a resumable step function instead, called as
+ * <code>bool fn(item, step, ctx)</code> with an <code>unsigned&</code> step
+ * that is 0 for the first call on an item. An operator issues a prefetch (see
+ * katana::prefetch), advances step and returns false to be resumed with the
+ * same item, by reference, once the thread has stepped through the other
+ * items it is interleaving; it returns true when done with the item. State
+ * needed across steps lives in the item or in step. Pushes made in any step
+ * are committed right away.
+ *
+ * Requires disable_conflict_detection and does not support parallel_break or
+ * per_iter_alloc.
+ */
+struct interleave_tag {};
+template <unsigned N = 8>
+struct interleave : public trait_has_type<bool>, interleave_tag {
+  static_assert(N > 0, "need at least one item in flight");
+  constexpr static unsigned value = N;
+};
+
 /**
  * Indicates the operator does not generate new work and push it on the worklist
  */
@@ -362,7 +427,9 @@ struct chunk_size_tag {
  * Additionally, user may provide a runtime argument, e.g,
  * katana::chunk_size<16> (8)
  *
- * Currently, only do_all_coupled can take advantage of the runtime argument.
+ * Currently, only do_all_coupled can take advantage of the runtime argument,
+ * which adaptive_chunk_size tunes from one invocation to the next. The chunk
+ * size of for_each worklists is a template parameter of the worklist.
  * TODO: allow runtime provision/tuning of chunk_size in other loop executors
  *
  * chunk size is clamped to within [chunk_size_tag::MIN, chunk_size_tag::MAX]
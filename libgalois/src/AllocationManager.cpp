@@ -0,0 +1,15 @@
+#include "katana/AllocationManager.h"
+
+#include <utility>
+
+katana::AllocationManager::AllocationManager(
+    std::string name, MemoryKind kind)
+    : name_(std::move(name)), kind_(kind) {}
+
+katana::AllocationManager::~AllocationManager() = default;
+
+katana::count_t
+katana::AllocationManager::FreeStandbyMemory(
+    [[maybe_unused]] count_t goal) {
+  return 0;
+}
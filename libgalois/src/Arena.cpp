@@ -0,0 +1,82 @@
+#include "katana/Arena.h"
+
+#include <mutex>
+
+#include "katana/Logging.h"
+#include "katana/PageAlloc.h"
+#include "katana/PagePool.h"
+
+katana::Arena::Arena() = default;
+
+katana::Arena::~Arena() {
+  for (unsigned i = 0; i < locals_.size(); ++i) {
+    for (void* page : locals_.getRemote(i)->pages) {
+      pagePoolFree(page);
+    }
+  }
+}
+
+void*
+katana::Arena::Allocate(size_t bytes, size_t align) {
+  const size_t page_size = allocSize();
+  KATANA_LOG_DEBUG_ASSERT(align > 0 && (align & (align - 1)) == 0);
+  KATANA_LOG_DEBUG_ASSERT(align <= page_size);
+  if (bytes > page_size) {
+    return AllocateLarge(bytes);
+  }
+
+  Local& local = *locals_.getLocal();
+  uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+  if (local.epoch != epoch) {
+    local.epoch = epoch;
+    local.used = 0;
+    local.offset = 0;
+  }
+
+  size_t offset = (local.offset + align - 1) & ~(align - 1);
+  if (local.used == 0 || offset + bytes > page_size) {
+    if (local.used == local.pages.size()) {
+      local.pages.push_back(pagePoolAlloc());
+    }
+    ++local.used;
+    offset = 0;
+  }
+  local.offset = offset + bytes;
+  return static_cast<char*>(local.pages[local.used - 1]) + offset;
+}
+
+void*
+katana::Arena::AllocateLarge(size_t bytes) {
+  uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+  std::lock_guard<SimpleLock> lock(blocks_lock_);
+
+  // the smallest free block that fits
+  Block* best = nullptr;
+  for (Block& block : blocks_) {
+    if (block.epoch != epoch && block.bytes >= bytes &&
+        (!best || block.bytes < best->bytes)) {
+      best = &block;
+    }
+  }
+  if (!best) {
+    // floating, rather than interleaved, because interleaving would run on
+    // the thread pool, which may be busy with the caller
+    blocks_.emplace_back(Block{largeMallocFloating(bytes), bytes, epoch});
+    best = &blocks_.back();
+  }
+  best->epoch = epoch;
+  return best->memory.get();
+}
+
+size_t
+katana::Arena::capacity() const {
+  size_t total = 0;
+  for (unsigned i = 0; i < locals_.size(); ++i) {
+    total += locals_.getRemote(i)->pages.size() * allocSize();
+  }
+  std::lock_guard<SimpleLock> lock(blocks_lock_);
+  for (const Block& block : blocks_) {
+    total += block.bytes;
+  }
+  return total;
+}
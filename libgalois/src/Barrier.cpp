@@ -19,39 +19,136 @@
 
 #include "katana/Barrier.h"
 
+#include <algorithm>
+#include <string>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/ThreadPool.h"
 
+namespace {
+
+struct KindName {
+  katana::BarrierKind kind;
+  const char* name;
+};
+
+constexpr KindName kKindNames[] = {
+    {katana::BarrierKind::kAuto, "auto"},
+    {katana::BarrierKind::kCounting, "counting"},
+    {katana::BarrierKind::kDissemination, "dissemination"},
+    {katana::BarrierKind::kMCS, "mcs"},
+    {katana::BarrierKind::kTopo, "topo"},
+};
+
+/// Most threads for which a counting barrier is used
+constexpr unsigned kMaxCountingThreads = 8;
+
+katana::internal::BarrierCache* kBarrierCache = nullptr;
+
+}  // namespace
+
 // anchor vtable
 katana::Barrier::~Barrier() = default;
 
-static katana::Barrier* kBarrier = nullptr;
-static unsigned kBarrierThreads = 0;
+katana::BarrierKind
+katana::GetBarrierKind() {
+  std::string name;
+  if (!GetEnv("KATANA_BARRIER", &name)) {
+    return BarrierKind::kAuto;
+  }
+  for (const auto& k : kKindNames) {
+    if (name == k.name) {
+      return k.kind;
+    }
+  }
+  KATANA_WARN_ONCE("unknown KATANA_BARRIER {}; using auto instead", name);
+  return BarrierKind::kAuto;
+}
+
+const char*
+katana::BarrierKindName(BarrierKind kind) {
+  for (const auto& k : kKindNames) {
+    if (kind == k.kind) {
+      return k.name;
+    }
+  }
+  return "unknown";
+}
 
-void
-katana::internal::SetBarrier(katana::Barrier* barrier) {
-  KATANA_LOG_VASSERT(
-      !(barrier && kBarrier), "Double initialization of Barrier");
+katana::BarrierKind
+katana::ChooseBarrierKind(unsigned active_threads, unsigned num_sockets) {
+  if (num_sockets > 1) {
+    return BarrierKind::kTopo;
+  }
+  if (active_threads <= kMaxCountingThreads) {
+    return BarrierKind::kCounting;
+  }
+  return BarrierKind::kDissemination;
+}
+
+std::unique_ptr<katana::Barrier>
+katana::CreateBarrier(BarrierKind kind, unsigned active_threads) {
+  switch (kind) {
+  case BarrierKind::kCounting:
+    return CreateCountingBarrier(active_threads);
+  case BarrierKind::kDissemination:
+    return CreateDisseminationBarrier(active_threads);
+  case BarrierKind::kMCS:
+    return CreateMCSBarrier(active_threads);
+  case BarrierKind::kTopo:
+    return CreateTopoBarrier(active_threads);
+  case BarrierKind::kAuto: {
+    unsigned sockets =
+        GetThreadPool().getCumulativeMaxSocket(active_threads - 1) + 1;
+    return CreateBarrier(
+        ChooseBarrierKind(active_threads, sockets), active_threads);
+  }
+  }
+  KATANA_LOG_FATAL("unknown barrier kind");
+}
+
+katana::Barrier&
+katana::internal::BarrierCache::Get(unsigned active_threads) {
+  if (current_ && active_threads == threads_) {
+    return *current_;
+  }
 
-  kBarrier = barrier;
+  BarrierKind kind = kind_;
+  if (kind == BarrierKind::kAuto) {
+    unsigned sockets =
+        GetThreadPool().getCumulativeMaxSocket(active_threads - 1) + 1;
+    kind = ChooseBarrierKind(active_threads, sockets);
+  }
 
-  if (barrier) {
-    kBarrierThreads = GetThreadPool().getMaxUsableThreads();
-    kBarrier->Reinit(kBarrierThreads);
+  auto& barrier = barriers_[static_cast<size_t>(kind)];
+  if (!barrier) {
+    barrier = CreateBarrier(kind, active_threads);
+  } else {
+    barrier->Reinit(active_threads);
   }
+  current_ = barrier.get();
+  threads_ = active_threads;
+  return *current_;
+}
+
+void
+katana::internal::SetBarrierCache(BarrierCache* cache) {
+  KATANA_LOG_VASSERT(
+      !(cache && kBarrierCache), "Double initialization of Barrier");
+
+  kBarrierCache = cache;
 }
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
-  KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
+  KATANA_LOG_VASSERT(kBarrierCache, "Barrier not initialized");
   active_threads =
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
   active_threads = std::max(active_threads, 1U);
 
-  if (active_threads != kBarrierThreads) {
-    kBarrierThreads = active_threads;
-    kBarrier->Reinit(kBarrierThreads);
+  if (const auto* group = ThreadPool::getGroup()) {
+    return group->barriers->Get(active_threads);
   }
-
-  return *kBarrier;
+  return kBarrierCache->Get(active_threads);
 }
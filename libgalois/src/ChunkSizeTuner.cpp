@@ -0,0 +1,88 @@
+#include "katana/ChunkSizeTuner.h"
+
+#include <algorithm>
+
+#include "katana/Traits.h"
+
+namespace {
+
+unsigned
+Clamp(uint64_t chunk_size) {
+  return std::clamp<uint64_t>(
+      chunk_size, katana::chunk_size_tag::MIN, katana::chunk_size_tag::MAX);
+}
+
+}  // namespace
+
+katana::ChunkSizeTuner&
+katana::ChunkSizeTuner::Get() {
+  static ChunkSizeTuner tuner;
+  return tuner;
+}
+
+unsigned
+katana::ChunkSizeTuner::ChunkSize(
+    const std::string& loopname, unsigned initial) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Loop& loop = loops_[loopname];
+  if (loop.chunk_size == 0) {
+    loop.chunk_size = Clamp(initial);
+  }
+  return loop.chunk_size;
+}
+
+unsigned
+katana::ChunkSizeTuner::BestChunkSize(const std::string& loopname) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = loops_.find(loopname);
+  return it == loops_.end() ? 0 : it->second.best_chunk_size;
+}
+
+void
+katana::ChunkSizeTuner::Report(
+    const std::string& loopname, const Outcome& outcome) {
+  uint64_t num_threads = std::max(outcome.num_threads, 1U);
+  if (outcome.num_items < kMinItemsPerThread * num_threads ||
+      outcome.num_chunks < 2 * num_threads) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Loop& loop = loops_[loopname];
+  if (outcome.chunk_size != loop.chunk_size) {
+    // another invocation already moved on
+    return;
+  }
+
+  double us_per_item = static_cast<double>(outcome.us) / outcome.num_items;
+  double steal_rate =
+      static_cast<double>(outcome.num_steals) / outcome.num_chunks;
+
+  if (loop.best_chunk_size == 0 || us_per_item < loop.best_us_per_item) {
+    loop.best_chunk_size = loop.chunk_size;
+    loop.best_us_per_item = us_per_item;
+  }
+
+  unsigned from = loop.chunk_size;
+  if (steal_rate > kMaxStealRate) {
+    loop.growing = false;
+  } else if (
+      loop.last_us_per_item > 0 && us_per_item > loop.last_us_per_item) {
+    loop.growing = !loop.growing;
+    from = loop.best_chunk_size;
+  }
+  loop.last_us_per_item = us_per_item;
+
+  unsigned next = Clamp(loop.growing ? uint64_t{from} * 2 : from / 2);
+  if (next == from) {
+    // at a bound, so try the other way next time
+    loop.growing = !loop.growing;
+  }
+  loop.chunk_size = next;
+}
+
+void
+katana::ChunkSizeTuner::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  loops_.clear();
+}
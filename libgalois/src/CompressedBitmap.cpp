@@ -0,0 +1,1070 @@
+#include "katana/CompressedBitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KATANA_BITMAP_X86 1
+#include <immintrin.h>
+#endif
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+
+struct katana::CompressedBitmap::Container {
+  ContainerKind kind{ContainerKind::kArray};
+  uint32_t cardinality{0};
+  /// For an array, its values in increasing order; for runs, the first and
+  /// the last value of each run, in increasing order
+  std::vector<uint16_t> values;
+  /// For a bitmap, kBitmapWords words
+  std::vector<uint64_t> words;
+};
+
+namespace {
+
+using Container = katana::CompressedBitmap::Container;
+using ContainerKind = katana::CompressedBitmap::ContainerKind;
+
+constexpr uint32_t kMaxArraySize = katana::CompressedBitmap::kMaxArraySize;
+constexpr uint32_t kBitmapWords = (uint32_t{1} << 16) / 64;
+
+/// Sets with at least this many containers are combined in parallel
+constexpr size_t kParallelContainers = 64;
+
+/// The first bytes of every serialized set
+constexpr uint32_t kSerializedMagic = 0x314d424b;  // "KBM1"
+
+uint16_t
+High(uint32_t value) {
+  return value >> 16;
+}
+
+uint16_t
+Low(uint32_t value) {
+  return value & 0xffff;
+}
+
+//
+// Kernels over the words of two bitmap containers
+//
+
+/// Writes op(a[w], b[w]) to out[w] for every word, unless out is null, and
+/// returns the number of bits set in the results
+using WordsFn = uint32_t (*)(const uint64_t*, const uint64_t*, uint64_t*);
+
+struct WordKernels {
+  WordsFn and_fn;
+  WordsFn or_fn;
+  WordsFn and_not_fn;
+};
+
+struct AndOp {
+  static uint64_t Scalar(uint64_t a, uint64_t b) { return a & b; }
+#ifdef KATANA_BITMAP_X86
+  __attribute__((target("avx2"))) static __m256i AVX2(__m256i a, __m256i b) {
+    return _mm256_and_si256(a, b);
+  }
+  __attribute__((target("avx512f"))) static __m512i AVX512(
+      __m512i a, __m512i b) {
+    return _mm512_and_si512(a, b);
+  }
+#endif
+};
+
+struct OrOp {
+  static uint64_t Scalar(uint64_t a, uint64_t b) { return a | b; }
+#ifdef KATANA_BITMAP_X86
+  __attribute__((target("avx2"))) static __m256i AVX2(__m256i a, __m256i b) {
+    return _mm256_or_si256(a, b);
+  }
+  __attribute__((target("avx512f"))) static __m512i AVX512(
+      __m512i a, __m512i b) {
+    return _mm512_or_si512(a, b);
+  }
+#endif
+};
+
+struct AndNotOp {
+  static uint64_t Scalar(uint64_t a, uint64_t b) { return a & ~b; }
+#ifdef KATANA_BITMAP_X86
+  __attribute__((target("avx2"))) static __m256i AVX2(__m256i a, __m256i b) {
+    return _mm256_andnot_si256(b, a);
+  }
+  __attribute__((target("avx512f"))) static __m512i AVX512(
+      __m512i a, __m512i b) {
+    // Not _mm512_andnot_si512, whose gcc implementation trips
+    // -Wuninitialized
+    return _mm512_and_si512(a, _mm512_xor_si512(b, _mm512_set1_epi64(-1)));
+  }
+#endif
+};
+
+template <typename Op>
+uint32_t
+ScalarWords(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+  uint32_t count = 0;
+  for (uint32_t w = 0; w < kBitmapWords; ++w) {
+    uint64_t word = Op::Scalar(a[w], b[w]);
+    if (out != nullptr) {
+      out[w] = word;
+    }
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+#ifdef KATANA_BITMAP_X86
+
+// The vector kernels count the bits of the results with popcnt a word at a
+// time, which keeps up with the loads
+
+__attribute__((target("popcnt"))) uint32_t
+PopcountWords(const uint64_t* words) {
+  uint64_t count = 0;
+  for (uint32_t w = 0; w < kBitmapWords; ++w) {
+    count += _mm_popcnt_u64(words[w]);
+  }
+  return count;
+}
+
+template <typename Op>
+__attribute__((target("avx2,popcnt"))) uint32_t
+AVX2Words(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+  constexpr uint32_t kLanes = 4;
+  uint64_t scratch[kLanes];
+  uint64_t count = 0;
+  for (uint32_t w = 0; w < kBitmapWords; w += kLanes) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+    uint64_t* result = out != nullptr ? out + w : scratch;
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(result), Op::AVX2(va, vb));
+    for (uint32_t i = 0; i < kLanes; ++i) {
+      count += _mm_popcnt_u64(result[i]);
+    }
+  }
+  return count;
+}
+
+template <typename Op>
+__attribute__((target("avx512f,popcnt"))) uint32_t
+AVX512Words(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+  constexpr uint32_t kLanes = 8;
+  uint64_t scratch[kLanes];
+  uint64_t count = 0;
+  for (uint32_t w = 0; w < kBitmapWords; w += kLanes) {
+    __m512i va = _mm512_loadu_si512(a + w);
+    __m512i vb = _mm512_loadu_si512(b + w);
+    uint64_t* result = out != nullptr ? out + w : scratch;
+    _mm512_storeu_si512(result, Op::AVX512(va, vb));
+    for (uint32_t i = 0; i < kLanes; ++i) {
+      count += _mm_popcnt_u64(result[i]);
+    }
+  }
+  return count;
+}
+
+#endif
+
+WordKernels
+DetectWordKernels() {
+#ifdef KATANA_BITMAP_X86
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt")) {
+    return WordKernels{
+        AVX512Words<AndOp>, AVX512Words<OrOp>, AVX512Words<AndNotOp>};
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+    return WordKernels{
+        AVX2Words<AndOp>, AVX2Words<OrOp>, AVX2Words<AndNotOp>};
+  }
+#endif
+  return WordKernels{
+      ScalarWords<AndOp>, ScalarWords<OrOp>, ScalarWords<AndNotOp>};
+}
+
+const WordKernels&
+SelectedWordKernels() {
+  static const WordKernels kernels = DetectWordKernels();
+  return kernels;
+}
+
+uint32_t
+CountWords(const uint64_t* words) {
+#ifdef KATANA_BITMAP_X86
+  if (__builtin_cpu_supports("popcnt")) {
+    return PopcountWords(words);
+  }
+#endif
+  uint32_t count = 0;
+  for (uint32_t w = 0; w < kBitmapWords; ++w) {
+    count += __builtin_popcountll(words[w]);
+  }
+  return count;
+}
+
+//
+// Containers
+//
+
+bool
+TestBit(const std::vector<uint64_t>& words, uint16_t low) {
+  return (words[low / 64] >> (low % 64)) & 1;
+}
+
+void
+SetBit(std::vector<uint64_t>* words, uint16_t low) {
+  (*words)[low / 64] |= uint64_t{1} << (low % 64);
+}
+
+void
+ClearBit(std::vector<uint64_t>* words, uint16_t low) {
+  (*words)[low / 64] &= ~(uint64_t{1} << (low % 64));
+}
+
+Container
+MakeArray(std::vector<uint16_t>&& values) {
+  Container c;
+  c.kind = ContainerKind::kArray;
+  c.cardinality = values.size();
+  c.values = std::move(values);
+  return c;
+}
+
+Container
+MakeBitmap(std::vector<uint64_t>&& words, uint32_t cardinality) {
+  Container c;
+  c.kind = ContainerKind::kBitmap;
+  c.cardinality = cardinality;
+  c.words = std::move(words);
+  return c;
+}
+
+/// Calls fn(low) for every value of c, in increasing order
+template <typename F>
+void
+ForEachLow(const Container& c, const F& fn) {
+  switch (c.kind) {
+  case ContainerKind::kArray:
+    for (uint16_t low : c.values) {
+      fn(low);
+    }
+    break;
+  case ContainerKind::kBitmap:
+    for (uint32_t w = 0; w < kBitmapWords; ++w) {
+      for (uint64_t word = c.words[w]; word != 0; word &= word - 1) {
+        fn(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+      }
+    }
+    break;
+  case ContainerKind::kRun:
+    for (size_t r = 0; r < c.values.size(); r += 2) {
+      for (uint32_t low = c.values[r]; low <= c.values[r + 1]; ++low) {
+        fn(static_cast<uint16_t>(low));
+      }
+    }
+    break;
+  }
+}
+
+Container
+ToBitmap(const Container& c) {
+  if (c.kind == ContainerKind::kBitmap) {
+    return c;
+  }
+  std::vector<uint64_t> words(kBitmapWords, 0);
+  ForEachLow(c, [&](uint16_t low) { SetBit(&words, low); });
+  return MakeBitmap(std::move(words), c.cardinality);
+}
+
+Container
+ToArray(const Container& c) {
+  if (c.kind == ContainerKind::kArray) {
+    return c;
+  }
+  std::vector<uint16_t> values;
+  values.reserve(c.cardinality);
+  ForEachLow(c, [&](uint16_t low) { values.emplace_back(low); });
+  return MakeArray(std::move(values));
+}
+
+/// An array or a bitmap container for the values of c, whichever is the
+/// smaller
+Container
+ToPlain(const Container& c) {
+  return c.cardinality <= kMaxArraySize ? ToArray(c) : ToBitmap(c);
+}
+
+/// c, or its values as an array or bitmap in storage if c is a run
+/// container
+const Container&
+Plain(const Container& c, Container* storage) {
+  if (c.kind != ContainerKind::kRun) {
+    return c;
+  }
+  *storage = ToPlain(c);
+  return *storage;
+}
+
+/// Makes an array or bitmap container the smaller of the two
+void
+Normalize(Container* c) {
+  if (c->kind == ContainerKind::kArray && c->cardinality > kMaxArraySize) {
+    *c = ToBitmap(*c);
+  } else if (
+      c->kind == ContainerKind::kBitmap && c->cardinality <= kMaxArraySize) {
+    *c = ToArray(*c);
+  }
+}
+
+bool
+ContainsLow(const Container& c, uint16_t low) {
+  switch (c.kind) {
+  case ContainerKind::kArray:
+    return std::binary_search(c.values.begin(), c.values.end(), low);
+  case ContainerKind::kBitmap:
+    return TestBit(c.words, low);
+  case ContainerKind::kRun: {
+    // the last run that starts at low or before
+    size_t lo = 0;
+    size_t hi = c.values.size() / 2;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (c.values[2 * mid] <= low) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo > 0 && low <= c.values[2 * (lo - 1) + 1];
+  }
+  }
+  return false;
+}
+
+/// The number of runs of consecutive values of c
+uint32_t
+NumRuns(const Container& c) {
+  switch (c.kind) {
+  case ContainerKind::kArray: {
+    uint32_t runs = 0;
+    for (size_t i = 0; i < c.values.size(); ++i) {
+      runs += i == 0 || c.values[i] != c.values[i - 1] + 1;
+    }
+    return runs;
+  }
+  case ContainerKind::kBitmap: {
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (uint32_t w = 0; w < kBitmapWords; ++w) {
+      uint64_t word = c.words[w];
+      // the bits that start a run
+      runs += __builtin_popcountll(word & ~((word << 1) | carry));
+      carry = word >> 63;
+    }
+    return runs;
+  }
+  case ContainerKind::kRun:
+    return c.values.size() / 2;
+  }
+  return 0;
+}
+
+Container
+ToRuns(const Container& c) {
+  Container runs;
+  runs.kind = ContainerKind::kRun;
+  runs.cardinality = c.cardinality;
+  uint32_t last = 0;
+  bool first = true;
+  ForEachLow(c, [&](uint16_t low) {
+    if (first || low != last + 1) {
+      runs.values.emplace_back(low);
+      runs.values.emplace_back(low);
+    } else {
+      runs.values.back() = low;
+    }
+    last = low;
+    first = false;
+  });
+  return runs;
+}
+
+/// The bytes of c as each kind of container
+uint64_t
+ArrayBytes(const Container& c) {
+  return uint64_t{2} * c.cardinality;
+}
+uint64_t
+BitmapBytes() {
+  return uint64_t{8} * kBitmapWords;
+}
+uint64_t
+RunBytes(uint32_t num_runs) {
+  return uint64_t{4} * num_runs;
+}
+
+//
+// Operations on containers; both operands are arrays or bitmaps, and an
+// empty result means no container
+//
+
+enum class SetOp {
+  kUnion,
+  kIntersection,
+  kDifference,
+};
+
+Container
+AndContainers(const Container& a, const Container& b) {
+  if (a.kind == ContainerKind::kBitmap && b.kind == ContainerKind::kBitmap) {
+    std::vector<uint64_t> words(kBitmapWords);
+    uint32_t count = SelectedWordKernels().and_fn(
+        a.words.data(), b.words.data(), words.data());
+    Container c = MakeBitmap(std::move(words), count);
+    Normalize(&c);
+    return c;
+  }
+  std::vector<uint16_t> values;
+  if (a.kind == ContainerKind::kArray && b.kind == ContainerKind::kArray) {
+    std::set_intersection(
+        a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+        std::back_inserter(values));
+  } else {
+    const Container& array = a.kind == ContainerKind::kArray ? a : b;
+    const Container& bitmap = a.kind == ContainerKind::kArray ? b : a;
+    for (uint16_t low : array.values) {
+      if (TestBit(bitmap.words, low)) {
+        values.emplace_back(low);
+      }
+    }
+  }
+  return MakeArray(std::move(values));
+}
+
+uint32_t
+AndCardinality(const Container& a, const Container& b) {
+  if (a.kind == ContainerKind::kBitmap && b.kind == ContainerKind::kBitmap) {
+    return SelectedWordKernels().and_fn(
+        a.words.data(), b.words.data(), nullptr);
+  }
+  uint32_t count = 0;
+  if (a.kind == ContainerKind::kArray && b.kind == ContainerKind::kArray) {
+    auto i = a.values.begin();
+    auto j = b.values.begin();
+    while (i != a.values.end() && j != b.values.end()) {
+      if (*i < *j) {
+        ++i;
+      } else if (*j < *i) {
+        ++j;
+      } else {
+        ++count;
+        ++i;
+        ++j;
+      }
+    }
+    return count;
+  }
+  const Container& array = a.kind == ContainerKind::kArray ? a : b;
+  const Container& bitmap = a.kind == ContainerKind::kArray ? b : a;
+  for (uint16_t low : array.values) {
+    count += TestBit(bitmap.words, low);
+  }
+  return count;
+}
+
+Container
+OrContainers(const Container& a, const Container& b) {
+  if (a.kind == ContainerKind::kBitmap && b.kind == ContainerKind::kBitmap) {
+    std::vector<uint64_t> words(kBitmapWords);
+    uint32_t count = SelectedWordKernels().or_fn(
+        a.words.data(), b.words.data(), words.data());
+    return MakeBitmap(std::move(words), count);
+  }
+  if (a.kind == ContainerKind::kArray && b.kind == ContainerKind::kArray) {
+    std::vector<uint16_t> values;
+    std::set_union(
+        a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+        std::back_inserter(values));
+    Container c = MakeArray(std::move(values));
+    Normalize(&c);
+    return c;
+  }
+  const Container& array = a.kind == ContainerKind::kArray ? a : b;
+  Container c = a.kind == ContainerKind::kArray ? b : a;
+  for (uint16_t low : array.values) {
+    c.cardinality += !TestBit(c.words, low);
+    SetBit(&c.words, low);
+  }
+  return c;
+}
+
+Container
+AndNotContainers(const Container& a, const Container& b) {
+  if (a.kind == ContainerKind::kBitmap && b.kind == ContainerKind::kBitmap) {
+    std::vector<uint64_t> words(kBitmapWords);
+    uint32_t count = SelectedWordKernels().and_not_fn(
+        a.words.data(), b.words.data(), words.data());
+    Container c = MakeBitmap(std::move(words), count);
+    Normalize(&c);
+    return c;
+  }
+  if (a.kind == ContainerKind::kBitmap) {
+    Container c = a;
+    for (uint16_t low : b.values) {
+      c.cardinality -= TestBit(c.words, low);
+      ClearBit(&c.words, low);
+    }
+    Normalize(&c);
+    return c;
+  }
+  std::vector<uint16_t> values;
+  if (b.kind == ContainerKind::kArray) {
+    std::set_difference(
+        a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+        std::back_inserter(values));
+  } else {
+    for (uint16_t low : a.values) {
+      if (!TestBit(b.words, low)) {
+        values.emplace_back(low);
+      }
+    }
+  }
+  return MakeArray(std::move(values));
+}
+
+Container
+Combine(const Container& a, const Container& b, SetOp op) {
+  Container a_storage;
+  Container b_storage;
+  const Container& plain_a = Plain(a, &a_storage);
+  const Container& plain_b = Plain(b, &b_storage);
+  switch (op) {
+  case SetOp::kUnion:
+    return OrContainers(plain_a, plain_b);
+  case SetOp::kIntersection:
+    return AndContainers(plain_a, plain_b);
+  case SetOp::kDifference:
+    return AndNotContainers(plain_a, plain_b);
+  }
+  return Container{};
+}
+
+/// The containers of the keys of a and b that op keeps, in key order, as
+/// indices into them or kNone
+struct KeyPair {
+  uint16_t key;
+  size_t a;
+  size_t b;
+};
+constexpr size_t kNone = ~size_t{0};
+
+std::vector<KeyPair>
+PairKeys(
+    const std::vector<uint16_t>& a, const std::vector<uint16_t>& b,
+    SetOp op) {
+  std::vector<KeyPair> pairs;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.size() || j < b.size()) {
+    if (j == b.size() || (i < a.size() && a[i] < b[j])) {
+      if (op != SetOp::kIntersection) {
+        pairs.emplace_back(KeyPair{a[i], i, kNone});
+      }
+      ++i;
+    } else if (i == a.size() || b[j] < a[i]) {
+      if (op == SetOp::kUnion) {
+        pairs.emplace_back(KeyPair{b[j], kNone, j});
+      }
+      ++j;
+    } else {
+      pairs.emplace_back(KeyPair{a[i], i, j});
+      ++i;
+      ++j;
+    }
+  }
+  return pairs;
+}
+
+//
+// Serialization
+//
+
+template <typename T>
+void
+Put(std::vector<uint8_t>* out, T value) {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out->emplace_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+/// Reads a T at *pos and advances past it; false if data is too short
+template <typename T>
+bool
+Get(const uint8_t* data, size_t size, size_t* pos, T* value) {
+  if (size - *pos < sizeof(T)) {
+    return false;
+  }
+  T v = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    v |= static_cast<T>(data[*pos + i]) << (8 * i);
+  }
+  *pos += sizeof(T);
+  *value = v;
+  return true;
+}
+
+/// The bytes that precede the payload of every container: key, kind,
+/// padding, cardinality and payload length
+constexpr uint64_t kContainerHeaderBytes = 2 + 1 + 1 + 4 + 4;
+
+}  // namespace
+
+katana::CompressedBitmap::CompressedBitmap() = default;
+katana::CompressedBitmap::CompressedBitmap(const CompressedBitmap& other) =
+    default;
+katana::CompressedBitmap::CompressedBitmap(CompressedBitmap&& other) noexcept =
+    default;
+katana::CompressedBitmap& katana::CompressedBitmap::operator=(
+    const CompressedBitmap& other) = default;
+katana::CompressedBitmap& katana::CompressedBitmap::operator=(
+    CompressedBitmap&& other) noexcept = default;
+katana::CompressedBitmap::~CompressedBitmap() = default;
+
+katana::CompressedBitmap
+katana::CompressedBitmap::FromSorted(const uint32_t* sorted, size_t size) {
+  CompressedBitmap set;
+  for (size_t i = 0; i < size;) {
+    uint16_t key = High(sorted[i]);
+    std::vector<uint16_t> values;
+    for (; i < size && High(sorted[i]) == key; ++i) {
+      if (values.empty() || values.back() != Low(sorted[i])) {
+        values.emplace_back(Low(sorted[i]));
+      }
+    }
+    Container c = MakeArray(std::move(values));
+    Normalize(&c);
+    set.keys_.emplace_back(key);
+    set.containers_.emplace_back(std::move(c));
+  }
+  return set;
+}
+
+katana::CompressedBitmap
+katana::CompressedBitmap::FromRange(uint64_t begin, uint64_t end) {
+  KATANA_LOG_DEBUG_ASSERT(end <= (uint64_t{1} << 32));
+  CompressedBitmap set;
+  while (begin < end) {
+    uint64_t key = begin >> 16;
+    uint64_t last = std::min(end, (key + 1) << 16) - 1;
+    Container c;
+    c.kind = ContainerKind::kRun;
+    c.cardinality = last - begin + 1;
+    c.values = {
+        Low(static_cast<uint32_t>(begin)), Low(static_cast<uint32_t>(last))};
+    set.keys_.emplace_back(static_cast<uint16_t>(key));
+    set.containers_.emplace_back(std::move(c));
+    begin = last + 1;
+  }
+  return set;
+}
+
+uint64_t
+katana::CompressedBitmap::Cardinality() const {
+  uint64_t count = 0;
+  for (const Container& c : containers_) {
+    count += c.cardinality;
+  }
+  return count;
+}
+
+bool
+katana::CompressedBitmap::Contains(uint32_t value) const {
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), High(value));
+  if (it == keys_.end() || *it != High(value)) {
+    return false;
+  }
+  return ContainsLow(containers_[it - keys_.begin()], Low(value));
+}
+
+bool
+katana::CompressedBitmap::Add(uint32_t value) {
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), High(value));
+  size_t i = it - keys_.begin();
+  if (it == keys_.end() || *it != High(value)) {
+    keys_.insert(it, High(value));
+    containers_.insert(
+        containers_.begin() + i, MakeArray(std::vector<uint16_t>{Low(value)}));
+    return true;
+  }
+  Container& c = containers_[i];
+  if (ContainsLow(c, Low(value))) {
+    return false;
+  }
+  if (c.kind == ContainerKind::kRun) {
+    c = ToPlain(c);
+  }
+  if (c.kind == ContainerKind::kArray) {
+    c.values.insert(
+        std::lower_bound(c.values.begin(), c.values.end(), Low(value)),
+        Low(value));
+  } else {
+    SetBit(&c.words, Low(value));
+  }
+  ++c.cardinality;
+  Normalize(&c);
+  return true;
+}
+
+bool
+katana::CompressedBitmap::Remove(uint32_t value) {
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), High(value));
+  size_t i = it - keys_.begin();
+  if (it == keys_.end() || *it != High(value) ||
+      !ContainsLow(containers_[i], Low(value))) {
+    return false;
+  }
+  Container& c = containers_[i];
+  if (c.cardinality == 1) {
+    keys_.erase(it);
+    containers_.erase(containers_.begin() + i);
+    return true;
+  }
+  if (c.kind == ContainerKind::kRun) {
+    c = ToPlain(c);
+  }
+  if (c.kind == ContainerKind::kArray) {
+    c.values.erase(
+        std::lower_bound(c.values.begin(), c.values.end(), Low(value)));
+  } else {
+    ClearBit(&c.words, Low(value));
+  }
+  --c.cardinality;
+  Normalize(&c);
+  return true;
+}
+
+void
+katana::CompressedBitmap::clear() {
+  keys_.clear();
+  containers_.clear();
+}
+
+void
+katana::CompressedBitmap::RunOptimize() {
+  for (Container& c : containers_) {
+    uint64_t runs = RunBytes(NumRuns(c));
+    uint64_t plain = std::min(ArrayBytes(c), BitmapBytes());
+    if (runs < plain) {
+      if (c.kind != ContainerKind::kRun) {
+        c = ToRuns(c);
+      }
+    } else if (c.kind == ContainerKind::kRun) {
+      c = ToPlain(c);
+    }
+  }
+}
+
+void
+katana::CompressedBitmap::ForEach(
+    const std::function<void(uint32_t)>& fn) const {
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    uint32_t high = uint32_t{keys_[i]} << 16;
+    ForEachLow(containers_[i], [&](uint16_t low) { fn(high | low); });
+  }
+}
+
+void
+katana::CompressedBitmap::ParallelForEach(
+    const std::function<void(uint32_t)>& fn) const {
+  katana::do_all(
+      katana::iterate(size_t{0}, keys_.size()),
+      [&](size_t i) {
+        uint32_t high = uint32_t{keys_[i]} << 16;
+        ForEachLow(containers_[i], [&](uint16_t low) { fn(high | low); });
+      },
+      katana::steal(), katana::no_stats());
+}
+
+std::vector<uint32_t>
+katana::CompressedBitmap::ToVector() const {
+  std::vector<uint32_t> values;
+  values.reserve(Cardinality());
+  ForEach([&](uint32_t value) { values.emplace_back(value); });
+  return values;
+}
+
+namespace {
+
+/// The keys and containers of op(a, b), computed in parallel if there are
+/// many of them and parallel is set
+void
+CombineSets(
+    const std::vector<uint16_t>& a_keys, const std::vector<Container>& a,
+    const std::vector<uint16_t>& b_keys, const std::vector<Container>& b,
+    SetOp op, bool parallel, std::vector<uint16_t>* keys,
+    std::vector<Container>* containers) {
+  std::vector<KeyPair> pairs = PairKeys(a_keys, b_keys, op);
+  std::vector<Container> results(pairs.size());
+  auto combine = [&](size_t p) {
+    const KeyPair& pair = pairs[p];
+    if (pair.b == kNone) {
+      results[p] = a[pair.a];
+    } else if (pair.a == kNone) {
+      results[p] = b[pair.b];
+    } else {
+      results[p] = Combine(a[pair.a], b[pair.b], op);
+    }
+  };
+  if (parallel && pairs.size() >= kParallelContainers) {
+    katana::do_all(
+        katana::iterate(size_t{0}, pairs.size()), combine, katana::steal(),
+        katana::no_stats());
+  } else {
+    for (size_t p = 0; p < pairs.size(); ++p) {
+      combine(p);
+    }
+  }
+
+  keys->clear();
+  containers->clear();
+  for (size_t p = 0; p < pairs.size(); ++p) {
+    if (results[p].cardinality > 0) {
+      keys->emplace_back(pairs[p].key);
+      containers->emplace_back(std::move(results[p]));
+    }
+  }
+}
+
+}  // namespace
+
+katana::CompressedBitmap
+katana::CompressedBitmap::Union(
+    const CompressedBitmap& a, const CompressedBitmap& b) {
+  CompressedBitmap set;
+  CombineSets(
+      a.keys_, a.containers_, b.keys_, b.containers_, SetOp::kUnion, true,
+      &set.keys_, &set.containers_);
+  return set;
+}
+
+katana::CompressedBitmap
+katana::CompressedBitmap::Intersection(
+    const CompressedBitmap& a, const CompressedBitmap& b) {
+  CompressedBitmap set;
+  CombineSets(
+      a.keys_, a.containers_, b.keys_, b.containers_, SetOp::kIntersection,
+      true, &set.keys_, &set.containers_);
+  return set;
+}
+
+katana::CompressedBitmap
+katana::CompressedBitmap::Difference(
+    const CompressedBitmap& a, const CompressedBitmap& b) {
+  CompressedBitmap set;
+  CombineSets(
+      a.keys_, a.containers_, b.keys_, b.containers_, SetOp::kDifference,
+      true, &set.keys_, &set.containers_);
+  return set;
+}
+
+uint64_t
+katana::CompressedBitmap::IntersectionCardinality(
+    const CompressedBitmap& a, const CompressedBitmap& b) {
+  uint64_t count = 0;
+  for (const KeyPair& pair :
+       PairKeys(a.keys_, b.keys_, SetOp::kIntersection)) {
+    Container a_storage;
+    Container b_storage;
+    count += AndCardinality(
+        Plain(a.containers_[pair.a], &a_storage),
+        Plain(b.containers_[pair.b], &b_storage));
+  }
+  return count;
+}
+
+katana::CompressedBitmap
+katana::CompressedBitmap::UnionAll(
+    const std::vector<const CompressedBitmap*>& sets) {
+  if (sets.empty()) {
+    return CompressedBitmap();
+  }
+  std::vector<CompressedBitmap> level;
+  level.reserve(sets.size());
+  for (const CompressedBitmap* set : sets) {
+    level.emplace_back(*set);
+  }
+  // pairs of a level are merged in parallel, each by one thread
+  while (level.size() > 1) {
+    std::vector<CompressedBitmap> next((level.size() + 1) / 2);
+    katana::do_all(
+        katana::iterate(size_t{0}, next.size()),
+        [&](size_t i) {
+          if (2 * i + 1 == level.size()) {
+            next[i] = std::move(level[2 * i]);
+            return;
+          }
+          const CompressedBitmap& a = level[2 * i];
+          const CompressedBitmap& b = level[2 * i + 1];
+          CombineSets(
+              a.keys_, a.containers_, b.keys_, b.containers_, SetOp::kUnion,
+              false, &next[i].keys_, &next[i].containers_);
+        },
+        katana::steal(), katana::no_stats());
+    level = std::move(next);
+  }
+  return std::move(level.front());
+}
+
+bool
+katana::CompressedBitmap::operator==(const CompressedBitmap& other) const {
+  if (keys_ != other.keys_) {
+    return false;
+  }
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    const Container& a = containers_[i];
+    const Container& b = other.containers_[i];
+    if (a.cardinality != b.cardinality) {
+      return false;
+    }
+    Container a_storage;
+    Container b_storage;
+    if (AndCardinality(Plain(a, &a_storage), Plain(b, &b_storage)) !=
+        a.cardinality) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t
+katana::CompressedBitmap::NumContainers(ContainerKind kind) const {
+  return std::count_if(
+      containers_.begin(), containers_.end(),
+      [kind](const Container& c) { return c.kind == kind; });
+}
+
+uint64_t
+katana::CompressedBitmap::SerializedSize() const {
+  uint64_t size = 8;
+  for (const Container& c : containers_) {
+    size += kContainerHeaderBytes;
+    size += c.kind == ContainerKind::kBitmap ? BitmapBytes()
+                                             : uint64_t{2} * c.values.size();
+  }
+  return size;
+}
+
+void
+katana::CompressedBitmap::Serialize(std::vector<uint8_t>* out) const {
+  out->reserve(out->size() + SerializedSize());
+  Put<uint32_t>(out, kSerializedMagic);
+  Put<uint32_t>(out, keys_.size());
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    const Container& c = containers_[i];
+    Put<uint16_t>(out, keys_[i]);
+    Put<uint8_t>(out, static_cast<uint8_t>(c.kind));
+    Put<uint8_t>(out, 0);
+    Put<uint32_t>(out, c.cardinality);
+    if (c.kind == ContainerKind::kBitmap) {
+      Put<uint32_t>(out, c.words.size());
+      for (uint64_t word : c.words) {
+        Put<uint64_t>(out, word);
+      }
+    } else {
+      Put<uint32_t>(out, c.values.size());
+      for (uint16_t value : c.values) {
+        Put<uint16_t>(out, value);
+      }
+    }
+  }
+}
+
+katana::Result<katana::CompressedBitmap>
+katana::CompressedBitmap::Deserialize(const uint8_t* data, size_t size) {
+  size_t pos = 0;
+  uint32_t magic = 0;
+  uint32_t num_containers = 0;
+  if (!Get(data, size, &pos, &magic) || magic != kSerializedMagic ||
+      !Get(data, size, &pos, &num_containers)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "not a serialized bitmap");
+  }
+
+  CompressedBitmap set;
+  for (uint32_t i = 0; i < num_containers; ++i) {
+    uint16_t key = 0;
+    uint8_t kind = 0;
+    uint8_t padding = 0;
+    uint32_t cardinality = 0;
+    uint32_t length = 0;
+    if (!Get(data, size, &pos, &key) || !Get(data, size, &pos, &kind) ||
+        !Get(data, size, &pos, &padding) ||
+        !Get(data, size, &pos, &cardinality) ||
+        !Get(data, size, &pos, &length)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "bitmap container {} is cut",
+          i);
+    }
+    if (!set.keys_.empty() && key <= set.keys_.back()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "bitmap container keys are out of order");
+    }
+
+    Container c;
+    c.cardinality = cardinality;
+    bool valid = cardinality > 0 && cardinality <= (uint32_t{1} << 16);
+    switch (static_cast<ContainerKind>(kind)) {
+    case ContainerKind::kBitmap:
+      c.kind = ContainerKind::kBitmap;
+      valid = valid && length == kBitmapWords;
+      c.words.resize(valid ? length : 0);
+      for (uint64_t& word : c.words) {
+        valid = valid && Get(data, size, &pos, &word);
+      }
+      valid = valid && CountWords(c.words.data()) == cardinality;
+      break;
+    case ContainerKind::kArray:
+    case ContainerKind::kRun: {
+      c.kind = static_cast<ContainerKind>(kind);
+      const bool is_run = c.kind == ContainerKind::kRun;
+      valid = valid && (is_run ? length % 2 == 0 : length == cardinality) &&
+              uint64_t{2} * length <= size - pos;
+      c.values.resize(valid ? length : 0);
+      for (uint16_t& value : c.values) {
+        valid = valid && Get(data, size, &pos, &value);
+      }
+      // strictly increasing values, or runs that neither overlap nor touch
+      uint64_t run_cardinality = 0;
+      for (size_t v = 0; valid && v < c.values.size(); ++v) {
+        if (is_run && v % 2 == 1) {
+          valid = c.values[v - 1] <= c.values[v];
+          run_cardinality += c.values[v] - c.values[v - 1] + 1;
+        } else if (v > 0) {
+          valid = c.values[v - 1] + uint32_t{is_run} < c.values[v];
+        }
+      }
+      valid = valid && (!is_run || run_cardinality == cardinality);
+      break;
+    }
+    default:
+      valid = false;
+    }
+    if (!valid) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "bitmap container {} is corrupt",
+          i);
+    }
+    set.keys_.emplace_back(key);
+    set.containers_.emplace_back(std::move(c));
+  }
+  if (pos != size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} bytes follow the serialized bitmap", size - pos);
+  }
+  return set;
+}
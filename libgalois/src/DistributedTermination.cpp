@@ -0,0 +1,34 @@
+#include "katana/DistributedTermination.h"
+
+#include <vector>
+
+bool
+katana::DistributedTermination::Terminated(bool idle) {
+  ++num_checks_;
+  uint64_t sent = sent_.load(std::memory_order_relaxed);
+  uint64_t received = received_.load(std::memory_order_relaxed);
+  if (comm_->Num == 1) {
+    return idle && sent == received;
+  }
+
+  std::vector<uint64_t> totals =
+      comm_->AllReduceSum({idle ? uint64_t{0} : uint64_t{1}, sent, received});
+  bool quiet = totals[0] == 0 && totals[1] == totals[2];
+  bool terminated = quiet && last_quiet_ && totals[1] == last_sent_ &&
+                    totals[2] == last_received_;
+
+  last_quiet_ = quiet;
+  last_sent_ = totals[1];
+  last_received_ = totals[2];
+  return terminated;
+}
+
+void
+katana::DistributedTermination::Reset() {
+  sent_.store(0, std::memory_order_relaxed);
+  received_.store(0, std::memory_order_relaxed);
+  last_quiet_ = false;
+  last_sent_ = 0;
+  last_received_ = 0;
+  num_checks_ = 0;
+}
@@ -23,6 +23,8 @@
 
 #include "katana/DynamicBitset.h"
 
+#include <algorithm>
+
 #include "katana/Galois.h"
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
@@ -89,38 +91,70 @@ katana::DynamicBitset::bitwise_xor(
       katana::no_stats());
 }
 
+namespace {
+
+/// Words counted by one iteration of count, enough for the compiler to
+/// vectorize the popcount loop
+constexpr size_t kCountBlockWords = 1024;
+
+uint64_t
+PopCount(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_popcountll(n);
+#else
+  n = n - ((n >> 1) & 0x5555555555555555UL);
+  n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
+  return (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+}
+
+/// Set bits in a run of words, read as plain integers so that the loop can
+/// be vectorized (e.g., to vpopcntq with AVX-512); the bits must not change
+/// concurrently
+size_t
+PopCount(const katana::DynamicBitset::TItem* items, size_t num) {
+  static_assert(
+      sizeof(katana::DynamicBitset::TItem) == sizeof(uint64_t),
+      "atomic words must be laid out like plain words");
+  const uint64_t* words = reinterpret_cast<const uint64_t*>(items);
+  size_t ret = 0;
+  for (size_t i = 0; i < num; ++i) {
+    ret += PopCount(words[i]);
+  }
+  return ret;
+}
+
+}  // namespace
+
 size_t
 katana::DynamicBitset::count() const {
+  size_t num_words = bitvec_.size();
+  if (num_words == 0) {
+    return 0;
+  }
+  // all but the last word, which may have bits past size()
+  size_t full_words = num_words - 1;
   katana::GAccumulator<size_t> ret;
   katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
+      katana::iterate(
+          size_t{0}, (full_words + kCountBlockWords - 1) / kCountBlockWords),
+      [&](size_t block) {
+        size_t begin = block * kCountBlockWords;
+        size_t end = std::min(begin + kCountBlockWords, full_words);
+        ret += PopCount(bitvec_.data() + begin, end - begin);
       },
       katana::no_stats());
-  return ret.reduce();
+  return ret.reduce() + PopCount(GetWord(full_words));
 }
 
 size_t
 katana::DynamicBitset::SerialCount() const {
-  size_t ret = 0;
-  for (uint64_t n : bitvec_) {
-#ifdef __GNUC__
-    ret += __builtin_popcountll(n);
-#else
-    n = n - ((n >> 1) & 0x5555555555555555UL);
-    n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-    ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
-#endif
+  size_t num_words = bitvec_.size();
+  if (num_words == 0) {
+    return 0;
   }
-  return ret;
+  return PopCount(bitvec_.data(), num_words - 1) +
+         PopCount(GetWord(num_words - 1));
 }
 
 namespace {
@@ -131,17 +165,16 @@ ComputeOffsets(
   // TODO uint32_t is somewhat dangerous; change in the future
   uint32_t activeThreads = katana::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
+  size_t num_words = bitset.get_vec().size();
 
-  // count how many bits are set on each thread
+  // count how many bits are set on each thread, a word at a time
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
 
     Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
+    for (size_t i = start; i < end; ++i) {
+      count += PopCount(bitset.GetWord(i));
     }
 
     tPrefixBitCounts[tid] = count;
@@ -162,16 +195,20 @@ ComputeOffsets(
     offsets->resize(cur_size + bitsetCount);
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-      Integer index = cur_size;
+          katana::block_range(size_t{0}, num_words, tid, nthreads);
+      size_t index = cur_size;
       if (tid != 0) {
         index += tPrefixBitCounts[tid - 1];
       }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
+      for (size_t i = start; i < end; ++i) {
+        uint64_t word = bitset.GetWord(i);
+        while (word != 0) {
+          (*offsets)[index] =
+              i * katana::DynamicBitset::kNumBitsInUint64 +
+              __builtin_ctzll(word);
           ++index;
+          word &= word - 1;
         }
       }
     });
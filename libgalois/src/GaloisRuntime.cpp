@@ -23,6 +23,7 @@
 
 #include "katana/Barrier.h"
 #include "katana/PagePool.h"
+#include "katana/PhaseSampler.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
@@ -205,10 +206,15 @@ public:
 
 }  // namespace
 
+std::unique_ptr<katana::TerminationDetection>
+katana::internal::CreateTerminationDetection() {
+  return std::make_unique<LocalTerminationDetection>();
+}
+
 struct katana::GaloisRuntime::Impl {
   struct Dependents {
     LocalTerminationDetection term;
-    std::unique_ptr<Barrier> barrier;
+    internal::BarrierCache barriers;
     internal::PageAllocState<> page_pool;
     katana::StatManager stat_manager;
   };
@@ -223,21 +229,22 @@ katana::GaloisRuntime::GaloisRuntime() : impl_(std::make_unique<Impl>()) {
   // The thread pool must be initialized first because other substrate classes
   // may call GetThreadPool() in their constructors
   impl_->deps = std::make_unique<Impl::Dependents>();
-  impl_->deps->barrier =
-      katana::CreateTopoBarrier(impl_->thread_pool.getMaxUsableThreads());
 
-  internal::SetBarrier(impl_->deps->barrier.get());
+  internal::SetBarrierCache(&impl_->deps->barriers);
   internal::SetTerminationDetection(&impl_->deps->term);
   internal::setPagePoolState(&impl_->deps->page_pool);
   katana::internal::setSysStatManager(&impl_->deps->stat_manager);
+
+  internal::StartPhaseSampler();
 }
 
 katana::GaloisRuntime::~GaloisRuntime() {
+  internal::StopPhaseSampler();
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
   internal::setPagePoolState(nullptr);
   internal::SetTerminationDetection(nullptr);
-  internal::SetBarrier(nullptr);
+  internal::SetBarrierCache(nullptr);
 
   // Other substrate classes destructors may call GetThreadPool() so destroy
   // them first before reseting the thread pool.
@@ -1,6 +1,126 @@
 #include "katana/HWTopo.h"
 
+#include <algorithm>
+#include <map>
 #include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+
+namespace {
+
+struct PlacementName {
+  katana::ThreadPlacement placement;
+  const char* name;
+};
+
+constexpr PlacementName kPlacementNames[] = {
+    {katana::ThreadPlacement::kCores, "cores"},
+    {katana::ThreadPlacement::kCompact, "compact"},
+    {katana::ThreadPlacement::kScatter, "scatter"},
+    {katana::ThreadPlacement::kCPUList, "cpu-list"},
+};
+
+}  // namespace
+
+katana::ThreadPlacement
+katana::GetThreadPlacement() {
+  std::string name;
+  if (!GetEnv("KATANA_THREAD_PLACEMENT", &name)) {
+    return GetEnv("KATANA_CPU_LIST") ? ThreadPlacement::kCPUList
+                                     : ThreadPlacement::kCores;
+  }
+  for (const auto& p : kPlacementNames) {
+    if (name == p.name) {
+      return p.placement;
+    }
+  }
+  KATANA_WARN_ONCE(
+      "unknown KATANA_THREAD_PLACEMENT {}; using cores instead", name);
+  return ThreadPlacement::kCores;
+}
+
+const char*
+katana::ThreadPlacementName(ThreadPlacement placement) {
+  for (const auto& p : kPlacementNames) {
+    if (placement == p.placement) {
+      return p.name;
+    }
+  }
+  return "unknown";
+}
+
+std::vector<katana::HWContext>
+katana::PlaceThreads(
+    std::vector<HWContext> contexts, ThreadPlacement placement,
+    const std::vector<int>& cpuList) {
+  if (placement == ThreadPlacement::kCPUList) {
+    std::vector<HWContext> placed;
+    for (int id : cpuList) {
+      auto it = std::find_if(
+          contexts.begin(), contexts.end(),
+          [id](const HWContext& c) { return int(c.osContext) == id; });
+      if (it != contexts.end()) {
+        placed.push_back(*it);
+        contexts.erase(it);
+      }
+    }
+    return placed;
+  }
+
+  std::sort(
+      contexts.begin(), contexts.end(),
+      [](const HWContext& a, const HWContext& b) {
+        return std::tie(a.socket, a.core, a.osContext) <
+               std::tie(b.socket, b.core, b.osContext);
+      });
+
+  // rank of each context among the SMT siblings of its core, and of its core
+  // among the cores of its socket
+  struct Ranked {
+    HWContext context;
+    unsigned smt;
+    unsigned core;
+  };
+  std::vector<Ranked> ranked;
+  std::map<unsigned, unsigned> cores_seen;
+  for (size_t i = 0; i < contexts.size(); ++i) {
+    const HWContext& c = contexts[i];
+    bool sibling = i > 0 && contexts[i - 1].socket == c.socket &&
+                   contexts[i - 1].core == c.core;
+    if (!sibling) {
+      ++cores_seen[c.socket];
+    }
+    ranked.push_back(Ranked{
+        c, sibling ? ranked.back().smt + 1 : 0, cores_seen[c.socket] - 1});
+  }
+
+  auto by = [&ranked](auto key) {
+    std::stable_sort(
+        ranked.begin(), ranked.end(),
+        [&key](const Ranked& a, const Ranked& b) { return key(a) < key(b); });
+  };
+  switch (placement) {
+  case ThreadPlacement::kCompact:
+    break;
+  case ThreadPlacement::kScatter:
+    by([](const Ranked& r) {
+      return std::make_tuple(r.smt, r.core, r.context.socket);
+    });
+    break;
+  case ThreadPlacement::kCores:
+  default:
+    by([](const Ranked& r) { return r.smt; });
+    break;
+  }
+
+  for (size_t i = 0; i < ranked.size(); ++i) {
+    contexts[i] = ranked[i].context;
+  }
+  return contexts;
+}
 
 std::vector<int>
 katana::parseCPUList(const std::string& line) {
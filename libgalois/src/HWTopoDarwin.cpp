@@ -49,6 +49,19 @@ getIntValue(const char* name) {
   return value;
 }
 
+//! The sysctl value for name, or 0 if there is none
+size_t
+getSizeValue(const char* name) {
+  int64_t value;
+  size_t len = sizeof(value);
+
+  if (sysctlbyname(name, &value, &len, nullptr, 0) == -1) {
+    return 0;
+  }
+
+  return value;
+}
+
 HWTopoInfo
 makeHWTopo() {
   MachineTopoInfo mti;
@@ -56,6 +69,10 @@ makeHWTopo() {
   mti.maxThreads = getIntValue("hw.logicalcpu_max");
   mti.maxCores = getIntValue("hw.physicalcpu_max");
   mti.maxNumaNodes = mti.maxSockets;
+  mti.llcBytes = getSizeValue("hw.l3cachesize");
+  if (mti.llcBytes == 0) {
+    mti.llcBytes = getSizeValue("hw.l2cachesize");
+  }
 
   std::vector<ThreadTopoInfo> tti;
   tti.reserve(mti.maxThreads);
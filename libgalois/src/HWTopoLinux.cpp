@@ -30,7 +30,9 @@
 #include <mutex>
 #include <set>
 
+#include "katana/Env.h"
 #include "katana/HWTopo.h"
+#include "katana/Logging.h"
 #include "katana/SimpleLock.h"
 #include "katana/gIO.h"
 
@@ -53,23 +55,8 @@ struct cpuinfo {
   unsigned cpucores;
   unsigned numaNode;  // from libnuma
   bool valid;         // from cpuset
-  bool smt;           // computed
 };
 
-bool
-operator<(const cpuinfo& lhs, const cpuinfo& rhs) {
-  if (lhs.smt != rhs.smt) {
-    return lhs.smt < rhs.smt;
-  }
-  if (lhs.physid != rhs.physid) {
-    return lhs.physid < rhs.physid;
-  }
-  if (lhs.coreid != rhs.coreid) {
-    return lhs.coreid < rhs.coreid;
-  }
-  return lhs.proc < rhs.proc;
-}
-
 #ifdef KATANA_USE_NUMA
 int (*dynamic_numa_available)() = nullptr;
 int (*dynamic_numa_num_configured_nodes)() = nullptr;
@@ -163,6 +150,44 @@ parseCPUInfo() {
   return vals;
 }
 
+//! Size of the highest level data or unified cache of cpu0, from
+//! /sys/devices/system/cpu/cpu0/cache; 0 if it is not there
+size_t
+parseLLCBytes() {
+  size_t best_level = 0;
+  size_t bytes = 0;
+  for (int index = 0;; ++index) {
+    std::string dir =
+        "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index);
+    std::ifstream level_file(dir + "/level");
+    std::ifstream size_file(dir + "/size");
+    std::ifstream type_file(dir + "/type");
+    if (!level_file || !size_file) {
+      break;
+    }
+    size_t level = 0;
+    size_t size = 0;
+    std::string unit;
+    std::string type;
+    level_file >> level;
+    size_file >> size >> unit;
+    type_file >> type;
+    if (type == "Instruction" || level < best_level) {
+      continue;
+    }
+    if (unit == "K") {
+      size <<= 10;
+    } else if (unit == "M") {
+      size <<= 20;
+    } else if (unit == "G") {
+      size <<= 30;
+    }
+    best_level = level;
+    bytes = size;
+  }
+  return bytes;
+}
+
 unsigned
 countSockets(const std::vector<cpuinfo>& info) {
   std::set<unsigned> pkgs;
@@ -190,18 +215,6 @@ countNumaNodes(const std::vector<cpuinfo>& info) {
   return nodes.size();
 }
 
-void
-markSMT(std::vector<cpuinfo>& info) {
-  for (unsigned int i = 1; i < info.size(); ++i) {
-    if (info[i - 1].physid == info[i].physid &&
-        info[i - 1].coreid == info[i].coreid) {
-      info[i].smt = true;
-    } else {
-      info[i].smt = false;
-    }
-  }
-}
-
 std::vector<int>
 parseCPUSet() {
   std::vector<int> vals;
@@ -251,13 +264,41 @@ markValid(std::vector<cpuinfo>& info) {
   }
 }
 
+//! Reorder info, which has only valid contexts, as placement says
+void
+placeThreads(std::vector<cpuinfo>& info, katana::ThreadPlacement placement) {
+  std::vector<int> cpu_list;
+  if (placement == katana::ThreadPlacement::kCPUList) {
+    std::string list;
+    katana::GetEnv("KATANA_CPU_LIST", &list);
+    cpu_list = katana::parseCPUList(list);
+  }
+
+  std::vector<katana::HWContext> contexts;
+  for (const auto& c : info) {
+    contexts.push_back(katana::HWContext{c.proc, c.physid, c.coreid});
+  }
+  auto placed = katana::PlaceThreads(contexts, placement, cpu_list);
+  if (placed.empty()) {
+    KATANA_LOG_WARN(
+        "no usable contexts in KATANA_CPU_LIST; placing threads on cores");
+    placed = katana::PlaceThreads(contexts, katana::ThreadPlacement::kCores);
+  }
+
+  std::vector<cpuinfo> reordered;
+  for (const auto& p : placed) {
+    reordered.push_back(*std::find_if(
+        info.begin(), info.end(),
+        [&p](const cpuinfo& c) { return c.proc == p.osContext; }));
+  }
+  info = std::move(reordered);
+}
+
 katana::HWTopoInfo
 makeHWTopo() {
   katana::MachineTopoInfo retMTI;
 
   auto info = parseCPUInfo();
-  std::sort(info.begin(), info.end());
-  markSMT(info);
   markValid(info);
 
   info.erase(
@@ -265,12 +306,12 @@ makeHWTopo() {
           info.begin(), info.end(), [](const cpuinfo& c) { return c.valid; }),
       info.end());
 
-  std::sort(info.begin(), info.end());
-  markSMT(info);
+  placeThreads(info, katana::GetThreadPlacement());
   retMTI.maxSockets = countSockets(info);
   retMTI.maxThreads = info.size();
   retMTI.maxCores = countCores(info);
   retMTI.maxNumaNodes = countNumaNodes(info);
+  retMTI.llcBytes = parseLLCBytes();
 
   std::vector<katana::ThreadTopoInfo> retTTI;
   retTTI.reserve(retMTI.maxThreads);
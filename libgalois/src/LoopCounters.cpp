@@ -0,0 +1,195 @@
+#include "katana/LoopCounters.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct CountedLoops {
+  bool all = false;
+  std::unordered_set<std::string> names;
+
+  CountedLoops() {
+    std::string list;
+    if (!katana::GetEnv("KATANA_LOOP_COUNTERS", &list)) {
+      return;
+    }
+    size_t begin = 0;
+    while (begin <= list.size()) {
+      size_t end = std::min(list.find(',', begin), list.size());
+      std::string name = list.substr(begin, end - begin);
+      if (name == "*") {
+        all = true;
+      } else if (!name.empty()) {
+        names.emplace(std::move(name));
+      }
+      begin = end + 1;
+    }
+  }
+};
+
+#ifdef __linux__
+
+struct Event {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t
+CacheEvent(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+// the last level cache misses of PERF_COUNT_HW_CACHE_MISSES, and the reads
+// that missed the local NUMA node
+const std::array<Event, 4> kEvents{{
+    {"Cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"LLCMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"BranchMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"RemoteNUMAAccesses", PERF_TYPE_HW_CACHE,
+     CacheEvent(
+         PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ,
+         PERF_COUNT_HW_CACHE_RESULT_MISS)},
+}};
+
+/// What a counter read: its count and how long it was enabled and running,
+/// which differ when the kernel multiplexes more counters than the
+/// machine has
+struct Reading {
+  uint64_t value;
+  uint64_t time_enabled;
+  uint64_t time_running;
+};
+
+/// The counters of a thread, which count only the events of the thread
+class ThreadCounters {
+public:
+  ThreadCounters() { fds_.fill(-1); }
+
+  ~ThreadCounters() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+  void Start() {
+    if (!opened_) {
+      Open();
+    }
+    for (size_t i = 0; i < kEvents.size(); ++i) {
+      Read(i, &starts_[i]);
+    }
+  }
+
+  void Stop(const char* loopname) {
+    for (size_t i = 0; i < kEvents.size(); ++i) {
+      Reading end;
+      if (!Read(i, &end)) {
+        continue;
+      }
+      uint64_t value = end.value - starts_[i].value;
+      uint64_t enabled = end.time_enabled - starts_[i].time_enabled;
+      uint64_t running = end.time_running - starts_[i].time_running;
+      if (running > 0 && running < enabled) {
+        value = static_cast<uint64_t>(
+            static_cast<double>(value) * enabled / running);
+      }
+      katana::ReportStatSum(loopname, kEvents[i].name, value);
+    }
+  }
+
+private:
+  void Open() {
+    opened_ = true;
+    for (size_t i = 0; i < kEvents.size(); ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = kEvents[i].type;
+      attr.config = kEvents[i].config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      // this thread on any cpu
+      fds_[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    if (std::all_of(fds_.begin(), fds_.end(), [](int fd) { return fd < 0; })) {
+      KATANA_WARN_ONCE(
+          "KATANA_LOOP_COUNTERS: could not open hardware counters; check "
+          "/proc/sys/kernel/perf_event_paranoid");
+    }
+  }
+
+  bool Read(size_t i, Reading* reading) const {
+    return fds_[i] >= 0 &&
+           read(fds_[i], reading, sizeof(*reading)) == sizeof(*reading);
+  }
+
+  std::array<int, kEvents.size()> fds_;
+  std::array<Reading, kEvents.size()> starts_{};
+  bool opened_ = false;
+};
+
+ThreadCounters&
+LocalCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+#endif
+
+}  // namespace
+
+bool
+katana::internal::IsCounted(const char* loopname) {
+  static CountedLoops loops;
+  if (loopname == nullptr) {
+    return false;
+  }
+  if (loops.all) {
+    return true;
+  }
+  return !loops.names.empty() && loops.names.count(loopname) > 0;
+}
+
+void
+katana::internal::StartLoopCounters() {
+#ifdef __linux__
+  katana::GetThreadPool().run(
+      katana::getActiveThreads(), [] { LocalCounters().Start(); });
+#else
+  KATANA_WARN_ONCE("KATANA_LOOP_COUNTERS: hardware counters need Linux");
+#endif
+}
+
+void
+katana::internal::StopLoopCounters(const char* loopname) {
+#ifdef __linux__
+  katana::GetThreadPool().run(katana::getActiveThreads(), [loopname] {
+    LocalCounters().Stop(loopname);
+  });
+#else
+  (void)loopname;
+#endif
+}
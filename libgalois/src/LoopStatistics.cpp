@@ -0,0 +1,217 @@
+#include "katana/LoopStatistics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include <unistd.h>
+
+#include "katana/Env.h"
+#include "katana/Executor_OnEach.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+/// Busy intervals that begin this soon after the last one ended extend it, so
+/// that a thread that keeps finding work does not flood the timeline
+constexpr uint64_t kMergeIntervalNs = 10000;
+
+struct LoopList {
+  bool all = false;
+  std::unordered_set<std::string> names;
+
+  explicit LoopList(const char* var) {
+    std::string list;
+    if (!katana::GetEnv(var, &list)) {
+      return;
+    }
+    size_t begin = 0;
+    while (begin <= list.size()) {
+      size_t end = std::min(list.find(',', begin), list.size());
+      std::string name = list.substr(begin, end - begin);
+      if (name == "*") {
+        all = true;
+      } else if (!name.empty()) {
+        names.emplace(std::move(name));
+      }
+      begin = end + 1;
+    }
+  }
+
+  bool Contains(const char* loopname) const {
+    return loopname != nullptr &&
+           (all || (!names.empty() && names.count(loopname) > 0));
+  }
+};
+
+const LoopList&
+TelemetryLoops() {
+  static LoopList loops("KATANA_LOOP_TELEMETRY");
+  return loops;
+}
+
+const LoopList&
+TimelineLoops() {
+  static LoopList loops("KATANA_LOOP_TIMELINE");
+  return loops;
+}
+
+/// The timeline file, in the JSON array format of Chrome trace events, which
+/// tolerates the missing "]" at the end; every event is followed by a ","
+class TimelineFile {
+public:
+  TimelineFile() {
+    std::string path{"loop-timeline.json"};
+    katana::GetEnv("KATANA_LOOP_TIMELINE_FILE", &path);
+    file_.open(path, std::ios_base::trunc);
+    if (!file_.good()) {
+      KATANA_LOG_WARN("KATANA_LOOP_TIMELINE: could not open {}", path);
+      return;
+    }
+    file_ << "[\n";
+    epoch_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+  }
+
+  void Write(const std::string& events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_.good()) {
+      file_ << events << std::flush;
+    }
+  }
+
+  /// Microseconds since the file was opened, the time unit of trace events
+  double Micros(uint64_t ns) const {
+    return ns < epoch_ns_ ? 0.0 : (ns - epoch_ns_) / 1000.0;
+  }
+
+private:
+  std::mutex mutex_;
+  std::ofstream file_;
+  uint64_t epoch_ns_ = 0;
+};
+
+TimelineFile&
+GetTimelineFile() {
+  static TimelineFile file;
+  return file;
+}
+
+std::string
+Escape(const char* name) {
+  std::string escaped;
+  for (const char* c = name; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      escaped += '\\';
+    }
+    if (static_cast<unsigned char>(*c) >= ' ') {
+      escaped += *c;
+    }
+  }
+  return escaped;
+}
+
+}  // namespace
+
+katana::LoopTelemetry<true>::LoopTelemetry(
+    const char* loopname, bool more_stats)
+    : loopname_(loopname), timeline_(TimelineLoops().Contains(loopname)) {
+  if (loopname == nullptr) {
+    return;
+  }
+  if (more_stats || timeline_ || TelemetryLoops().Contains(loopname)) {
+    threads_ = std::make_unique<PerThreadStorage<ThreadData>>();
+  }
+  if (timeline_) {
+    // open the file, which starts the clock of the timeline, before the loop
+    GetTimelineFile();
+  }
+}
+
+katana::LoopTelemetry<true>::~LoopTelemetry() {
+  if (!enabled()) {
+    return;
+  }
+
+  // executed serially
+  const unsigned num_threads = katana::getActiveThreads();
+  uint64_t last_end_ns = 0;
+  uint64_t max_busy_ns = 0;
+  uint64_t total_busy_ns = 0;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    const ThreadData& thread = *threads_->getRemote(i);
+    last_end_ns = std::max(last_end_ns, thread.end_ns);
+    max_busy_ns = std::max(max_busy_ns, thread.busy_ns);
+    total_busy_ns += thread.busy_ns;
+  }
+
+  on_each_gen(
+      [&](auto, auto) {
+        const ThreadData& thread = *threads_->getLocal();
+        ReportStatSum(loopname_, "BusyTime", thread.busy_ns / 1000);
+        ReportStatSum(
+            loopname_, "IdleTime", (last_end_ns - thread.end_ns) / 1000);
+      },
+      std::make_tuple());
+
+  if (total_busy_ns > 0) {
+    double mean_busy_ns = static_cast<double>(total_busy_ns) / num_threads;
+    ReportStatMax(loopname_, "Imbalance", max_busy_ns / mean_busy_ns);
+  }
+
+  if (timeline_) {
+    WriteTimeline();
+  }
+}
+
+void
+katana::LoopTelemetry<true>::EndBusyImpl(size_t items) {
+  ThreadData& thread = *threads_->getLocal();
+  uint64_t now = NowNs();
+  thread.busy_ns += now - thread.busy_begin_ns;
+  if (!timeline_) {
+    return;
+  }
+  if (!thread.intervals.empty() &&
+      thread.busy_begin_ns - thread.intervals.back().end_ns <
+          kMergeIntervalNs) {
+    thread.intervals.back().end_ns = now;
+    thread.intervals.back().items += items;
+  } else {
+    thread.intervals.emplace_back(Interval{thread.busy_begin_ns, now, items});
+  }
+}
+
+void
+katana::LoopTelemetry<true>::WriteTimeline() {
+  TimelineFile& file = GetTimelineFile();
+  const std::string name = Escape(loopname_);
+  const int pid = getpid();
+
+  std::string events;
+  const unsigned num_threads = katana::getActiveThreads();
+  for (unsigned tid = 0; tid < num_threads; ++tid) {
+    const ThreadData& thread = *threads_->getRemote(tid);
+    for (const Interval& interval : thread.intervals) {
+      events += fmt::format(
+          R"({{"name":"{}","cat":"loop","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{},"args":{{"items":{}}}}},)"
+          "\n",
+          name, file.Micros(interval.begin_ns),
+          (interval.end_ns - interval.begin_ns) / 1000.0, pid, tid,
+          interval.items);
+    }
+    for (uint64_t steal_ns : thread.steals_ns) {
+      events += fmt::format(
+          R"({{"name":"steal","cat":"loop","ph":"i","s":"t","ts":{:.3f},"pid":{},"tid":{}}},)"
+          "\n",
+          file.Micros(steal_ns), pid, tid);
+    }
+  }
+  file.Write(events);
+}
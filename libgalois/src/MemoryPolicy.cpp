@@ -1,6 +1,10 @@
 #include "katana/MemoryPolicy.h"
 
+#include <algorithm>
 #include <fstream>
+#include <optional>
+#include <sstream>
+#include <string_view>
 
 #include "katana/MemoryPolicy.h"
 #include "katana/MemorySupervisor.h"
@@ -35,6 +39,86 @@ LogIt(const std::string& str, katana::MemoryPolicy::MemInfo* mem_info) {
                    });
 }
 
+void
+LogCgroup(
+    const std::string& str,
+    const katana::MemoryPolicyCgroup::CgroupInfo& info) {
+  auto scope = katana::GetTracer().StartActiveSpan(str);
+  scope.span().Log(
+      "cgroup_stats", {
+                          {"limit_gb", katana::ToGB(info.limit)},
+                          {"working_set_gb", katana::ToGB(info.working_set)},
+                          {"stall_percent", info.stall_percent},
+                      });
+}
+
+std::optional<std::string>
+ReadFile(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+/// The value of key in the lines of "key value" of memory.stat
+std::optional<uint64_t>
+ParseStat(const std::string& stat, const std::string& key) {
+  std::istringstream lines(stat);
+  std::string k;
+  uint64_t value{};
+  while (lines >> k >> value) {
+    if (k == key) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+/// The avg10 of the some line of memory.pressure, e.g.,
+///   some avg10=0.12 avg60=0.05 avg300=0.01 total=12345
+std::optional<double>
+ParsePressure(const std::string& pressure) {
+  std::istringstream lines(pressure);
+  std::string line;
+  while (std::getline(lines, line)) {
+    constexpr std::string_view kPrefix = "some avg10=";
+    if (line.compare(0, kPrefix.size(), kPrefix) == 0) {
+      try {
+        return std::stod(line.substr(kPrefix.size()));
+      } catch (std::exception&) {
+        return std::nullopt;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+/// The memory limit of the cgroup in dir, which is the smallest memory.max of
+/// it and its ancestors
+std::optional<uint64_t>
+CgroupLimit(std::string dir) {
+  std::optional<uint64_t> limit;
+  while (!dir.empty()) {
+    auto max = ReadFile(dir + "/memory.max");
+    if (!max) {
+      break;
+    }
+    if (max->compare(0, 3, "max") != 0) {
+      try {
+        uint64_t value = std::stoull(*max);
+        limit = limit ? std::min(*limit, value) : value;
+      } catch (std::exception& e) {
+        KATANA_LOG_WARN("problem parsing {}/memory.max: {}", dir, e.what());
+      }
+    }
+    dir = dir.substr(0, dir.find_last_of('/'));
+  }
+  return limit;
+}
+
 }  // namespace
 
 void
@@ -161,6 +245,122 @@ katana::MemoryPolicyMinimal::MemoryPolicyMinimal()
           {.high_used_ratio_threshold = 0.95,
            .kill_used_ratio_threshold = 0.95}) {}
 
+//////////////////////////////////////////////////////////////////////
+// MemoryPolicyCgroup
+
+katana::MemoryPolicyCgroup::MemoryPolicyCgroup(
+    std::string cgroup_dir, count_t limit)
+    : MemoryPolicy(
+          {.high_used_ratio_threshold = 0.85,
+           .kill_used_ratio_threshold = 0.95}),
+      cgroup_dir_(std::move(cgroup_dir)),
+      limit_(limit) {}
+
+katana::Result<std::unique_ptr<katana::MemoryPolicyCgroup>>
+katana::MemoryPolicyCgroup::Make(const std::string& cgroup_dir) {
+  std::string dir = cgroup_dir;
+  if (dir.empty()) {
+    auto own = CgroupDir();
+    if (!own) {
+      return KATANA_ERROR(ErrorCode::NotFound, "not in a cgroup v2");
+    }
+    dir = own.value();
+  }
+  auto limit = CgroupLimit(dir);
+  if (!limit) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "cgroup {} has no memory limit", dir);
+  }
+  return std::unique_ptr<MemoryPolicyCgroup>(
+      new MemoryPolicyCgroup(dir, static_cast<count_t>(limit.value())));
+}
+
+katana::MemoryPolicyCgroup::CgroupInfo
+katana::MemoryPolicyCgroup::ReadCgroupInfo() const {
+  CgroupInfo info{};
+  info.limit = limit_;
+  if (auto current = ReadFile(cgroup_dir_ + "/memory.current"); current) {
+    try {
+      info.working_set = static_cast<count_t>(std::stoull(*current));
+    } catch (std::exception& e) {
+      KATANA_LOG_WARN("problem parsing memory.current: {}", e.what());
+    }
+  }
+  // Like the kubelet, do not count page cache that the kernel can readily
+  // drop before it runs out of memory
+  if (auto stat = ReadFile(cgroup_dir_ + "/memory.stat"); stat) {
+    auto inactive_file = ParseStat(*stat, "inactive_file");
+    if (inactive_file) {
+      info.working_set = std::max<count_t>(
+          info.working_set - static_cast<count_t>(*inactive_file), 0);
+    }
+  }
+  if (auto pressure = ReadFile(cgroup_dir_ + "/memory.pressure"); pressure) {
+    info.stall_percent = ParsePressure(*pressure).value_or(0);
+  }
+  return info;
+}
+
+bool
+katana::MemoryPolicyCgroup::MemoryPressureHigh(
+    [[maybe_unused]] count_t active, [[maybe_unused]] count_t standby) const {
+  auto info = ReadCgroupInfo();
+  if (info.working_set > high_used_ratio_threshold() * info.limit ||
+      info.stall_percent > kHighPressureStallPercent) {
+    LogCgroup("memory pressure high", info);
+    return true;
+  }
+  return false;
+}
+
+count_t
+katana::MemoryPolicyCgroup::ReclaimForMemoryPressure(
+    [[maybe_unused]] count_t active, count_t standby) const {
+  auto info = ReadCgroupInfo();
+  auto high = static_cast<count_t>(high_used_ratio_threshold() * info.limit);
+
+  count_t goal = std::max<count_t>(info.working_set - high, 0);
+  if (info.stall_percent > kHighPressureStallPercent) {
+    goal = std::max(goal, standby / 2);
+  }
+  goal = std::min(goal, standby);
+  if (goal > 0) {
+    LogCgroup(
+        fmt::format("reclaim for memory pressure {} GB", katana::ToGB(goal)),
+        info);
+  }
+  return goal;
+}
+
+count_t
+katana::MemoryPolicyCgroup::ReclaimForAllocation(
+    [[maybe_unused]] count_t active, count_t standby, count_t bytes) const {
+  auto info = ReadCgroupInfo();
+  auto high = static_cast<count_t>(high_used_ratio_threshold() * info.limit);
+
+  count_t headroom = std::max<count_t>(high - info.working_set, 0);
+  count_t goal = std::min(std::max<count_t>(bytes - headroom, 0), standby);
+  if (goal > 0) {
+    LogCgroup(
+        fmt::format(
+            "reclaim for allocation of {} GB: {} GB", katana::ToGB(bytes),
+            katana::ToGB(goal)),
+        info);
+  }
+  return goal;
+}
+
+bool
+katana::MemoryPolicyCgroup::KillSelfForLackOfMemory(
+    [[maybe_unused]] count_t active, [[maybe_unused]] count_t standby) const {
+  auto info = ReadCgroupInfo();
+  if (info.working_set > kill_used_ratio_threshold() * info.limit) {
+    LogCgroup("KILL SELF", info);
+    return true;
+  }
+  return false;
+}
+
 //////////////////////////////////////////////////////////////////////
 // MemoryPolicy
 
@@ -198,8 +398,48 @@ katana::MemoryPolicy::OOMScore() {
   return value;
 }
 
+std::optional<std::string>
+katana::MemoryPolicy::CgroupDir() {
+  auto cgroups = ReadFile("/proc/self/cgroup");
+  if (!cgroups) {
+    return std::nullopt;
+  }
+  // cgroup v2 has a single hierarchy, listed as 0::<path>
+  std::istringstream lines(*cgroups);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, 3, "0::") == 0) {
+      std::string path = line.substr(3);
+      if (path == "/") {
+        path.clear();
+      }
+      return "/sys/fs/cgroup" + path;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<uint64_t>
+katana::MemoryPolicy::CgroupMemoryLimit() {
+  auto dir = CgroupDir();
+  if (!dir) {
+    return std::nullopt;
+  }
+  return CgroupLimit(*dir);
+}
+
 #else
 
+std::optional<std::string>
+katana::MemoryPolicy::CgroupDir() {
+  return std::nullopt;
+}
+
+std::optional<uint64_t>
+katana::MemoryPolicy::CgroupMemoryLimit() {
+  return std::nullopt;
+}
+
 uint64_t
 katana::MemoryPolicy::OOMScore() {
   KATANA_WARN_ONCE("Platform does not have out of memory (OOM) scoring");
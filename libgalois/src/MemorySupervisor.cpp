@@ -1,11 +1,14 @@
 #include "katana/MemorySupervisor.h"
 
+#include <algorithm>
 #include <fstream>
 
+#include "katana/AllocationManager.h"
 #include "katana/Cache.h"
 #include "katana/MemoryPolicy.h"
 #include "katana/ProgressTracer.h"
 #include "katana/PropertyManager.h"
+#include "katana/TopologyManager.h"
 #include "katana/Time.h"
 
 using katana::count_t;
@@ -25,6 +28,11 @@ LogState(const std::string& str, count_t active, count_t standby) {
            });
 }
 
+double
+ToGBNumber(count_t bytes) {
+  return std::max(bytes, count_t{0}) / 1024.0 / 1024.0 / 1024.0;
+}
+
 void
 KillCheck(katana::MemoryPolicy* policy, count_t active, count_t standby) {
   if (policy->KillSelfForLackOfMemory(active, standby)) {
@@ -69,11 +77,25 @@ katana::MemorySupervisor::SanityCheck() {
 
 katana::MemorySupervisor::MemorySupervisor() {
   physical_ = GetTotalSystemMemory();
-  policy_ = std::make_unique<katana::MemoryPolicyMinimal>();
+  // In a container, what counts is the limit of its cgroup
+  if (auto cgroup_policy = MemoryPolicyCgroup::Make(); cgroup_policy) {
+    policy_ = std::move(cgroup_policy.value());
+  } else {
+    policy_ = std::make_unique<katana::MemoryPolicyMinimal>();
+  }
   // Memory supervisor creates managers
   auto pr = std::make_unique<PropertyManager>();
   const auto& name = pr->Name();
   managers_[name].manager_ = std::move(pr);
+  auto tm = std::make_unique<TopologyManager>();
+  const auto& topology_name = tm->Name();
+  managers_[topology_name].manager_ = std::move(tm);
+
+  GetMetrics()
+      .Gauge(
+          "katana_memory_supervisor_physical_bytes",
+          "Memory the MemorySupervisor plans to use at most")
+      .Set(physical_);
 
   auto& tracer = katana::GetTracer();
   tracer.GetActiveSpan().Log(
@@ -86,21 +108,97 @@ void
 katana::MemorySupervisor::StandbyMinus(ManagerInfo& info, count_t bytes) {
   info.standby -= bytes;
   standby_ -= bytes;
+  UsedPlus(info, -bytes);
 }
 void
 katana::MemorySupervisor::StandbyPlus(ManagerInfo& info, count_t bytes) {
   info.standby += bytes;
   standby_ += bytes;
+  UsedPlus(info, bytes);
 }
 void
 katana::MemorySupervisor::ActiveMinus(ManagerInfo& info, count_t bytes) {
   info.active -= bytes;
   active_ -= bytes;
+  UsedPlus(info, -bytes);
 }
 void
 katana::MemorySupervisor::ActivePlus(ManagerInfo& info, count_t bytes) {
   info.active += bytes;
   active_ += bytes;
+  UsedPlus(info, bytes);
+}
+
+void
+katana::MemorySupervisor::UsedPlus(ManagerInfo& info, count_t bytes) {
+  used_by_kind_[static_cast<size_t>(info.manager_->Kind())] += bytes;
+  if (bytes > 0) {
+    UpdatePeaks();
+  }
+  PublishMetrics(info);
+}
+
+void
+katana::MemorySupervisor::PublishMetrics(ManagerInfo& info) {
+  MetricsRegistry& metrics = GetMetrics();
+  if (info.active_metric == nullptr) {
+    MetricLabels labels{{"manager", info.manager_->Name()}};
+    info.active_metric = &metrics.Gauge(
+        "katana_memory_active_bytes",
+        "Active memory of a MemorySupervisor manager", labels);
+    info.standby_metric = &metrics.Gauge(
+        "katana_memory_standby_bytes",
+        "Standby memory of a MemorySupervisor manager", labels);
+  }
+  info.active_metric->Set(info.active);
+  info.standby_metric->Set(info.standby);
+
+  static MetricGauge& active = metrics.Gauge(
+      "katana_memory_supervisor_active_bytes",
+      "Active memory of all MemorySupervisor managers");
+  static MetricGauge& standby = metrics.Gauge(
+      "katana_memory_supervisor_standby_bytes",
+      "Standby memory of all MemorySupervisor managers");
+  active.Set(active_);
+  standby.Set(standby_);
+}
+
+void
+katana::MemorySupervisor::UpdatePeaks() {
+  for (auto& [id, peaks] : phases_) {
+    peaks.active = std::max(peaks.active, active_);
+    peaks.used = std::max(peaks.used, Used());
+    auto kind_peak = [this](count_t* peak, MemoryKind kind) {
+      *peak = std::max(*peak, used_by_kind_[static_cast<size_t>(kind)]);
+    };
+    kind_peak(&peaks.topology, MemoryKind::kTopology);
+    kind_peak(&peaks.views, MemoryKind::kViews);
+    kind_peak(&peaks.properties, MemoryKind::kProperties);
+    kind_peak(&peaks.scratch, MemoryKind::kScratch);
+  }
+}
+
+uint64_t
+katana::MemorySupervisor::BeginPhase() {
+  uint64_t id = next_phase_++;
+  phases_[id] = MemoryPeaks{};
+  UpdatePeaks();
+  return id;
+}
+
+katana::MemoryPeaks
+katana::MemorySupervisor::PhasePeaks(uint64_t id) const {
+  auto it = phases_.find(id);
+  if (it == phases_.end()) {
+    KATANA_LOG_WARN("no memory phase with id {}", id);
+    return MemoryPeaks{};
+  }
+  return it->second;
+}
+
+void
+katana::MemorySupervisor::EndPhase(uint64_t id) {
+  phases_.erase(id);
 }
 
 void
@@ -120,6 +218,13 @@ katana::MemorySupervisor::ReclaimMemory(count_t goal) {
   }
 }
 
+void
+katana::MemorySupervisor::PrepareBorrowActive(count_t bytes) {
+  count_t try_reclaim =
+      policy_->ReclaimForAllocation(active_, standby_, bytes);
+  ReclaimMemory(try_reclaim);
+}
+
 void
 katana::MemorySupervisor::BorrowActive(const std::string& name, count_t bytes) {
   auto it = managers_.find(name);
@@ -226,8 +331,9 @@ katana::MemorySupervisor::StandbyToActive(
   }
   auto& info = it->second;
 
-  ActivePlus(info, bytes);
+  // standby first, so that the memory does not count twice for the peaks
   StandbyMinus(info, bytes);
+  ActivePlus(info, bytes);
   count_t try_reclaim = policy_->ReclaimForMemoryPressure(active_, standby_);
   ReclaimMemory(try_reclaim);
 
@@ -266,9 +372,70 @@ katana::MemorySupervisor::GetPropertyManager() {
   return pm;
 }
 
+katana::CacheStats
+katana::MemorySupervisor::GetTopologyCacheStats() const {
+  auto name = TopologyManager::name_;
+  auto it = managers_.find(name);
+  if (it == managers_.end()) {
+    KATANA_LOG_WARN("no manager with name {}\n", name);
+    return katana::CacheStats();
+  }
+  const auto& info = it->second;
+  auto* tm = dynamic_cast<TopologyManager*>(info.manager_.get());
+  return tm->GetTopologyCacheStats();
+}
+
+katana::TopologyManager*
+katana::MemorySupervisor::GetTopologyManager() {
+  auto name = TopologyManager::name_;
+  auto it = managers_.find(name);
+  if (it == managers_.end()) {
+    KATANA_LOG_WARN("no manager with name {}\n", name);
+    return nullptr;
+  }
+  const auto& info = it->second;
+  auto* tm = dynamic_cast<TopologyManager*>(info.manager_.get());
+  return tm;
+}
+
+katana::Manager*
+katana::MemorySupervisor::GetAllocationManager(
+    const std::string& name, MemoryKind kind) {
+  auto& info = managers_[name];
+  if (!info.manager_) {
+    info.manager_ = std::make_unique<AllocationManager>(name, kind);
+  }
+  return info.manager_.get();
+}
+
 uint64_t
 katana::MemorySupervisor::GetTotalSystemMemory() {
   uint64_t pages = sysconf(_SC_PHYS_PAGES);
   uint64_t page_size = sysconf(_SC_PAGE_SIZE);
-  return pages * page_size;
+  uint64_t physical = pages * page_size;
+  if (auto limit = MemoryPolicy::CgroupMemoryLimit(); limit) {
+    return std::min(physical, limit.value());
+  }
+  return physical;
+}
+
+katana::MemoryPhase::MemoryPhase()
+    : id_(MemorySupervisor::Get().BeginPhase()) {}
+
+katana::MemoryPhase::~MemoryPhase() {
+  MemoryPeaks peaks = Peaks();
+  MemorySupervisor::Get().EndPhase(id_);
+  katana::GetTracer().GetActiveSpan().SetTags({
+      {"peak_active_gb", ToGBNumber(peaks.active)},
+      {"peak_used_gb", ToGBNumber(peaks.used)},
+      {"peak_topology_gb", ToGBNumber(peaks.topology)},
+      {"peak_views_gb", ToGBNumber(peaks.views)},
+      {"peak_properties_gb", ToGBNumber(peaks.properties)},
+      {"peak_scratch_gb", ToGBNumber(peaks.scratch)},
+  });
+}
+
+katana::MemoryPeaks
+katana::MemoryPhase::Peaks() const {
+  return MemorySupervisor::Get().PhasePeaks(id_);
 }
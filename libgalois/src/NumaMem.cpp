@@ -20,13 +20,59 @@
 #include "katana/NumaMem.h"
 
 #include <cassert>
+#include <mutex>
 
+#include "katana/MemorySupervisor.h"
 #include "katana/PageAlloc.h"
 #include "katana/ThreadPool.h"
 #include "katana/gIO.h"
 
 using namespace katana;
 
+namespace {
+
+/// Name of the manager of the innermost AllocationAccount of this thread
+thread_local const std::string* current_account = nullptr;
+
+/// Serializes reports, since the MemorySupervisor is not thread safe
+std::mutex account_mutex;
+
+/// Lets the MemorySupervisor make room for an allocation of bytes and returns
+/// the account to report it to, if any
+const std::string*
+PrepareAccountedAlloc(size_t bytes) {
+  const std::string* account = current_account;
+  if (account) {
+    std::lock_guard<std::mutex> lock(account_mutex);
+    MemorySupervisor::Get().PrepareBorrowActive(bytes);
+  }
+  return account;
+}
+
+LAptr
+MakeAccountedLAptr(void* data, size_t bytes, const std::string* account) {
+  if (!data) {
+    return LAptr{data, internal::largeFreer{bytes}};
+  }
+  if (account) {
+    std::lock_guard<std::mutex> lock(account_mutex);
+    MemorySupervisor::Get().BorrowActive(*account, bytes);
+  }
+  return LAptr{data, internal::largeFreer{bytes, account}};
+}
+
+}  // namespace
+
+katana::AllocationAccount::AllocationAccount(
+    const std::string& name, MemoryKind kind)
+    : prev_(current_account) {
+  std::lock_guard<std::mutex> lock(account_mutex);
+  current_account =
+      &MemorySupervisor::Get().GetAllocationManager(name, kind)->Name();
+}
+
+katana::AllocationAccount::~AllocationAccount() { current_account = prev_; }
+
 /* Access pages on each thread so each thread has some pages already loaded
  * (preferably ones it will use) */
 static void
@@ -143,6 +189,10 @@ largeFree(void* ptr, size_t bytes) {
 void
 katana::internal::largeFreer::operator()(void* ptr) const {
   largeFree(ptr, bytes);
+  if (account) {
+    std::lock_guard<std::mutex> lock(account_mutex);
+    MemorySupervisor::Get().ReturnActive(*account, bytes);
+  }
 }
 
 // round data to a multiple of mult
@@ -166,45 +216,49 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
   // yes this is a comment in a ifdef, but if libnuma improves, this is where
   // the alloc would go
 #endif
+  const std::string* account = PrepareAccountedAlloc(bytes);
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = allocLargePages(&bytes, false);
 
   // Then page in based on thread number
   if (data)
     // true = round robin paging
     pageIn(data, bytes, allocSize(), numThreads, true);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return MakeAccountedLAptr(data, bytes, account);
 }
 
 LAptr
 katana::largeMallocLocal(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  const std::string* account = PrepareAccountedAlloc(bytes);
   // Get a prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), true), internal::largeFreer{bytes}};
+  void* data = allocLargePages(&bytes, true);
+  return MakeAccountedLAptr(data, bytes, account);
 }
 
 LAptr
 katana::largeMallocFloating(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  const std::string* account = PrepareAccountedAlloc(bytes);
   // Get a non-prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
+  void* data = allocLargePages(&bytes, false);
+  return MakeAccountedLAptr(data, bytes, account);
 }
 
 LAptr
 katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  const std::string* account = PrepareAccountedAlloc(bytes);
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = allocLargePages(&bytes, false);
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
-  return LAptr{data, internal::largeFreer{bytes}};
+  return MakeAccountedLAptr(data, bytes, account);
 }
 
 /**
@@ -228,14 +282,15 @@ katana::largeMallocSpecified(
   // ceiling to nearest page
   bytes = roundup(bytes, allocSize());
 
-  void* data = allocPages(bytes / allocSize(), false);
+  const std::string* account = PrepareAccountedAlloc(bytes);
+  void* data = allocLargePages(&bytes, false);
 
   // NUMA aware page in based on element distribution specified in threadRanges
   if (data)
     pageInSpecified(
         data, bytes, allocSize(), numThreads, threadRanges, elementSize);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return MakeAccountedLAptr(data, bytes, account);
 }
 // Explicit template declarations since the template is defined in the .h
 // file
@@ -19,8 +19,13 @@
 
 #include "katana/PageAlloc.h"
 
+#include <atomic>
+#include <cstdint>
+#include <iterator>
 #include <mutex>
+#include <string>
 
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/SimpleLock.h"
 
@@ -59,11 +64,71 @@ static const int _MAP_HUGE_POP = _MAP_POP;
 static const int _MAP_HUGE = _MAP;
 #endif
 
+const size_t gigaPageSize = 1024 * 1024 * 1024;
+
+namespace {
+
+struct LargePageKindName {
+  katana::LargePageKind kind;
+  const char* name;
+};
+
+constexpr LargePageKindName kLargePageKindNames[] = {
+    {katana::LargePageKind::kHuge2M, "2m"},
+    {katana::LargePageKind::kTransparent, "thp"},
+    {katana::LargePageKind::kHuge1G, "1g"},
+    {katana::LargePageKind::kNone, "none"},
+};
+
+std::atomic<size_t> largePageBytes[std::size(kLargePageKindNames)];
+
+void
+countLargePages(katana::LargePageKind kind, size_t bytes) {
+  largePageBytes[static_cast<size_t>(kind)].fetch_add(
+      bytes, std::memory_order_relaxed);
+}
+
+}  // namespace
+
 size_t
 katana::allocSize() {
   return hugePageSize;
 }
 
+katana::LargePageKind
+katana::GetLargePageKind() {
+  static LargePageKind kind = [] {
+    std::string name;
+    if (!GetEnv("KATANA_LARGE_PAGES", &name)) {
+      return LargePageKind::kHuge2M;
+    }
+    for (const auto& k : kLargePageKindNames) {
+      if (name == k.name) {
+        return k.kind;
+      }
+    }
+    KATANA_WARN_ONCE("unknown KATANA_LARGE_PAGES {}; using 2m instead", name);
+    return LargePageKind::kHuge2M;
+  }();
+  return kind;
+}
+
+const char*
+katana::LargePageKindName(LargePageKind kind) {
+  for (const auto& k : kLargePageKindNames) {
+    if (kind == k.kind) {
+      return k.name;
+    }
+  }
+  return "unknown";
+}
+
+size_t
+katana::numLargePageBytes(LargePageKind kind) {
+  return largePageBytes[static_cast<size_t>(kind)].load(
+      std::memory_order_relaxed);
+}
+
 #ifdef KATANA_USE_JEMALLOC
 
 void*
@@ -80,6 +145,15 @@ katana::freePages(void* ptr, [[maybe_unused]] unsigned num) {
   free(ptr);
 }
 
+void*
+katana::allocLargePages(size_t* bytes, bool preFault) {
+  if (*bytes == 0) {
+    return nullptr;
+  }
+  countLargePages(LargePageKind::kNone, *bytes);
+  return allocPages(*bytes / hugePageSize, preFault);
+}
+
 #else
 
 static void*
@@ -126,4 +200,91 @@ katana::freePages(void* ptr, unsigned num) {
     KATANA_LOG_FATAL("munmap failed: {}", errno);
   }
 }
+
+static size_t
+roundUp(size_t bytes, size_t page_size) {
+  return (bytes + page_size - 1) / page_size * page_size;
+}
+
+/// Map bytes of regular pages aligned to hugePageSize, so that the kernel
+/// can back all of them with transparent huge pages, and advise it to
+static void*
+trymmapTransparent(size_t bytes, bool preFault) {
+  char* raw = static_cast<char*>(trymmap(bytes + hugePageSize, _MAP));
+  if (!raw) {
+    return nullptr;
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+  char* ptr = reinterpret_cast<char*>(roundUp(addr, hugePageSize));
+  {
+    std::lock_guard<katana::SimpleLock> lg(allocLock);
+    if (ptr != raw) {
+      munmap(raw, ptr - raw);
+    }
+    munmap(ptr + bytes, raw + hugePageSize - ptr);
+  }
+#ifdef MADV_HUGEPAGE
+  madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif
+  if (preFault) {
+    for (size_t x = 0; x < bytes; x += 4096) {
+      ptr[x] = 0;
+    }
+  }
+  return ptr;
+}
+
+void*
+katana::allocLargePages(size_t* bytes, bool preFault) {
+  if (*bytes == 0) {
+    return nullptr;
+  }
+
+  LargePageKind kind = GetLargePageKind();
+  void* ptr = nullptr;
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+  if (kind == LargePageKind::kHuge1G && *bytes >= gigaPageSize) {
+    size_t giga_bytes = roundUp(*bytes, gigaPageSize);
+    ptr = trymmap(
+        giga_bytes, (preFault ? _MAP_HUGE_POP : _MAP_HUGE) | MAP_HUGE_1GB);
+    if (ptr) {
+      *bytes = giga_bytes;
+      countLargePages(LargePageKind::kHuge1G, *bytes);
+      return ptr;
+    }
+    KATANA_WARN_ONCE("1 GB page alloc failed, falling back to 2 MB pages");
+  }
+#endif
+
+  if (kind != LargePageKind::kTransparent && kind != LargePageKind::kNone) {
+    ptr = trymmap(*bytes, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    if (ptr) {
+      countLargePages(LargePageKind::kHuge2M, *bytes);
+      return ptr;
+    }
+    KATANA_DEBUG_WARN_ONCE(
+        "huge page alloc failed, falling back to transparent huge pages");
+  }
+
+  if (kind != LargePageKind::kNone) {
+    ptr = trymmapTransparent(*bytes, preFault);
+    if (ptr) {
+      countLargePages(LargePageKind::kTransparent, *bytes);
+      return ptr;
+    }
+  }
+
+  ptr = trymmap(*bytes, preFault ? _MAP_POP : _MAP);
+  if (!ptr) {
+    KATANA_LOG_FATAL("failed to allocate: {}", errno);
+  }
+  if (preFault && doHandMap) {
+    for (size_t x = 0; x < *bytes; x += 4096) {
+      static_cast<char*>(ptr)[x] = 0;
+    }
+  }
+  countLargePages(LargePageKind::kNone, *bytes);
+  return ptr;
+}
 #endif
@@ -17,12 +17,43 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <ctime>
+#include <string>
+#include <unordered_set>
 
 #include "katana/Env.h"
 #include "katana/Executor_ParaMeter.h"
+#include "katana/ProgressTracer.h"
 #include "katana/gIO.h"
 
+namespace {
+
+struct ProfiledLoops {
+  bool all = false;
+  std::unordered_set<std::string> names;
+
+  ProfiledLoops() {
+    std::string list;
+    if (!katana::GetEnv("KATANA_PARAMETER_LOOPS", &list)) {
+      return;
+    }
+    size_t begin = 0;
+    while (begin <= list.size()) {
+      size_t end = std::min(list.find(',', begin), list.size());
+      std::string name = list.substr(begin, end - begin);
+      if (name == "*") {
+        all = true;
+      } else if (!name.empty()) {
+        names.emplace(std::move(name));
+      }
+      begin = end + 1;
+    }
+  }
+};
+
+}  // namespace
+
 struct StatsFileManager {
   bool init = false;
   bool isOpen = false;
@@ -98,3 +129,48 @@ void
 katana::parameter::closeStatsFile(void) {
   getStatsFileManager().close();
 }
+
+bool
+katana::parameter::IsProfiled(const char* loopname) {
+  static ProfiledLoops loops;
+  if (loops.all) {
+    return true;
+  }
+  return !loops.names.empty() && loops.names.count(loopname) > 0;
+}
+
+void
+katana::parameter::ReportProfile(
+    const char* loopname, const std::vector<StepProfile>& steps) {
+  size_t work = 0;
+  size_t parallelism = 0;
+  size_t conflicts = 0;
+  size_t max_parallelism = 0;
+  auto& span = katana::GetTracer().GetActiveSpan();
+  for (const StepProfile& step : steps) {
+    span.Log(
+        "parameter round",
+        {{"loopname", loopname},
+         {"round", uint64_t{step.step}},
+         {"work", uint64_t{step.work}},
+         {"parallelism", uint64_t{step.parallelism}},
+         {"conflicts", uint64_t{step.conflicts}},
+         {"neighborhood", uint64_t{step.neighborhood}}});
+    work += step.work;
+    parallelism += step.parallelism;
+    conflicts += step.conflicts;
+    max_parallelism = std::max(max_parallelism, step.parallelism);
+  }
+
+  double average_parallelism =
+      steps.empty() ? 0.0 : static_cast<double>(parallelism) / steps.size();
+  span.Log(
+      "parameter profile",
+      {{"loopname", loopname},
+       {"rounds", uint64_t{steps.size()}},
+       {"work", uint64_t{work}},
+       {"committed", uint64_t{parallelism}},
+       {"conflicts", uint64_t{conflicts}},
+       {"max_parallelism", uint64_t{max_parallelism}},
+       {"average_parallelism", average_parallelism}});
+}
@@ -0,0 +1,222 @@
+#include "katana/PhaseSampler.h"
+
+#include <sys/time.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+constexpr uint32_t kMaxDepth = 16;
+constexpr size_t kNumSlots = 4096;
+constexpr int kDefaultHz = 1000;
+constexpr uint64_t kFnvOffset = UINT64_C(14695981039346656037);
+constexpr uint64_t kFnvPrime = UINT64_C(1099511628211);
+
+std::atomic<bool> sampling{false};
+
+/// The phase stack of the process, written by the main thread and read by
+/// the signal handler on any thread; depth may exceed kMaxDepth, in which
+/// case the innermost phases are not recorded
+std::atomic<uint32_t> stack_depth{0};
+std::array<std::atomic<uint32_t>, kMaxDepth> stack{};
+
+/// Samples by phase stack, in an open addressing table that the signal
+/// handler fills without locks. Keys are hashes of the stacks; 0 is empty.
+struct Slot {
+  std::atomic<uint64_t> key{0};
+  std::atomic<uint64_t> count{0};
+  uint32_t depth{0};
+  std::array<uint32_t, kMaxDepth> phases{};
+};
+std::array<Slot, kNumSlots> slots;
+std::atomic<uint64_t> dropped{0};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+/// Phase names by id, the id of "" being 0
+struct PhaseNames {
+  std::mutex mutex;
+  std::unordered_map<std::string, uint32_t> ids;
+  std::vector<std::string> names{""};
+};
+
+PhaseNames&
+GetPhaseNames() {
+  static PhaseNames names;
+  return names;
+}
+
+std::string output_path;
+
+void
+OnSample(int) {
+  int saved_errno = errno;
+
+  uint32_t depth =
+      std::min(stack_depth.load(std::memory_order_acquire), kMaxDepth);
+  std::array<uint32_t, kMaxDepth> phases;
+  uint64_t key = kFnvOffset;
+  for (uint32_t i = 0; i < depth; ++i) {
+    phases[i] = stack[i].load(std::memory_order_relaxed);
+    key = (key ^ phases[i]) * kFnvPrime;
+  }
+  key = std::max<uint64_t>(key, 1);
+
+  bool counted = false;
+  for (size_t n = 0; n < kNumSlots && !counted; ++n) {
+    Slot& slot = slots[(key + n) % kNumSlots];
+    uint64_t slot_key = slot.key.load(std::memory_order_acquire);
+    if (slot_key == 0) {
+      if (slot.key.compare_exchange_strong(slot_key, key)) {
+        slot.depth = depth;
+        std::copy(phases.begin(), phases.begin() + depth, slot.phases.begin());
+        slot_key = key;
+      }
+    }
+    if (slot_key == key) {
+      slot.count.fetch_add(1, std::memory_order_release);
+      counted = true;
+    }
+  }
+  if (!counted) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  errno = saved_errno;
+}
+
+bool
+SetTimer(int hz) {
+  struct itimerval timer {};
+  if (hz > 0) {
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = std::max(1000000 / hz, 1);
+    timer.it_value = timer.it_interval;
+  }
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+}  // namespace
+
+katana::PhaseScope::PhaseScope(std::string_view name)
+    : depth_(internal::PushPhase(internal::InternPhase(name))) {}
+
+katana::PhaseScope::~PhaseScope() { internal::PopPhase(depth_); }
+
+bool
+katana::internal::SamplingPhases() {
+  return sampling.load(std::memory_order_relaxed);
+}
+
+uint32_t
+katana::internal::InternPhase(std::string_view name) {
+  if (!SamplingPhases()) {
+    return 0;
+  }
+  PhaseNames& names = GetPhaseNames();
+  std::lock_guard<std::mutex> lock(names.mutex);
+  auto [it, inserted] = names.ids.emplace(name, names.names.size());
+  if (inserted) {
+    // ";" separates the phases of folded stacks
+    std::string folded(name);
+    std::replace(folded.begin(), folded.end(), ';', ',');
+    names.names.emplace_back(std::move(folded));
+  }
+  return it->second;
+}
+
+int
+katana::internal::PushPhase(uint32_t id) {
+  if (id == 0 || ThreadPool::getTID() != 0) {
+    return -1;
+  }
+  uint32_t depth = stack_depth.load(std::memory_order_relaxed);
+  if (depth < kMaxDepth) {
+    stack[depth].store(id, std::memory_order_relaxed);
+  }
+  stack_depth.store(depth + 1, std::memory_order_release);
+  return depth;
+}
+
+void
+katana::internal::PopPhase(int depth) {
+  if (depth >= 0) {
+    stack_depth.store(depth, std::memory_order_release);
+  }
+}
+
+void
+katana::internal::StartPhaseSampler() {
+  if (SamplingPhases() || !GetEnv("KATANA_PROFILE_PHASES", &output_path) ||
+      output_path.empty()) {
+    return;
+  }
+  int hz = kDefaultHz;
+  GetEnv("KATANA_PROFILE_PHASES_HZ", &hz);
+
+  struct sigaction action {};
+  action.sa_handler = OnSample;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, nullptr) != 0 || !SetTimer(hz)) {
+    KATANA_LOG_WARN("KATANA_PROFILE_PHASES: could not start the sampler");
+    return;
+  }
+  sampling.store(true, std::memory_order_relaxed);
+}
+
+void
+katana::internal::StopPhaseSampler() {
+  if (!SamplingPhases()) {
+    return;
+  }
+  SetTimer(0);
+  sampling.store(false, std::memory_order_relaxed);
+
+  std::ofstream out(output_path, std::ios_base::trunc);
+  for (const auto& [folded, count] : FoldedPhaseSamples()) {
+    out << folded << " " << count << "\n";
+  }
+  if (!out.good()) {
+    KATANA_LOG_WARN("KATANA_PROFILE_PHASES: could not write {}", output_path);
+  }
+  if (uint64_t n = dropped.load(); n > 0) {
+    KATANA_LOG_WARN(
+        "KATANA_PROFILE_PHASES: dropped {} samples of too many phase stacks",
+        n);
+  }
+}
+
+std::vector<std::pair<std::string, uint64_t>>
+katana::internal::FoldedPhaseSamples() {
+  PhaseNames& names = GetPhaseNames();
+  std::lock_guard<std::mutex> lock(names.mutex);
+
+  std::vector<std::pair<std::string, uint64_t>> samples;
+  for (const Slot& slot : slots) {
+    uint64_t count = slot.count.load(std::memory_order_acquire);
+    if (slot.key.load(std::memory_order_acquire) == 0 || count == 0) {
+      continue;
+    }
+    std::string folded;
+    for (uint32_t i = 0; i < slot.depth; ++i) {
+      folded += (i == 0 ? "" : ";") + names.names.at(slot.phases[i]);
+    }
+    samples.emplace_back(folded.empty() ? "(no phase)" : folded, count);
+  }
+  std::sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) {
+    return a.second > b.second;
+  });
+  return samples;
+}
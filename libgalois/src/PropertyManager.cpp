@@ -1,5 +1,7 @@
 #include "katana/PropertyManager.h"
 
+#include <iterator>
+
 #include "katana/ArrowInterchange.h"
 #include "katana/Logging.h"
 #include "katana/MemorySupervisor.h"
@@ -28,6 +30,7 @@ katana::PropertyManager::~PropertyManager() { cache_.reset(); }
 std::shared_ptr<arrow::Table>
 katana::PropertyManager::GetProperty(const katana::Uri& property_path) {
   auto property = cache_->GetAndEvict(property_path);
+  cache_->GetStats().Publish(Name());
   if (property.has_value()) {
     auto bytes =
         static_cast<count_t>(katana::ApproxTableMemUse(property.value()));
@@ -66,6 +69,7 @@ katana::PropertyManager::PutProperty(
   auto granted = MemorySupervisor::Get().ActiveToStandby(Name(), bytes);
   if (granted >= static_cast<count_t>(bytes)) {
     cache_->Insert(property_path, property);
+    cache_->GetStats().Publish(Name());
     katana::GetTracer().GetActiveSpan().Log(
         "property cache insert",
         {
@@ -77,6 +81,40 @@ katana::PropertyManager::PutProperty(
   }
 }
 
+std::shared_ptr<arrow::Table>
+katana::PropertyManager::GetLoadedProperty(const katana::Uri& property_path) {
+  std::lock_guard<std::mutex> lock(loaded_mutex_);
+  auto it = loaded_.find(property_path);
+  if (it == loaded_.end()) {
+    return nullptr;
+  }
+  std::shared_ptr<arrow::ChunkedArray> column = it->second.column.lock();
+  if (!column) {
+    loaded_.erase(it);
+    return nullptr;
+  }
+  katana::GetTracer().GetActiveSpan().Log(
+      "property shared", {
+                             {"storage_name", property_path.BaseName()},
+                         });
+  return arrow::Table::Make(arrow::schema({it->second.field}), {column});
+}
+
+void
+katana::PropertyManager::PropertyLoadedShared(
+    const katana::Uri& property_path,
+    const std::shared_ptr<arrow::Table>& property) {
+  KATANA_LOG_DEBUG_ASSERT(property && property->num_columns() == 1);
+  std::lock_guard<std::mutex> lock(loaded_mutex_);
+  // drop what no graph uses anymore, so that this does not grow with every
+  // file ever loaded
+  for (auto it = loaded_.begin(); it != loaded_.end();) {
+    it = it->second.column.expired() ? loaded_.erase(it) : std::next(it);
+  }
+  loaded_[property_path] =
+      LoadedProperty{property->field(0), property->column(0)};
+}
+
 katana::count_t
 katana::PropertyManager::FreeStandbyMemory(count_t goal) {
   count_t total = 0;
@@ -29,6 +29,7 @@
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Logging.h"
+#include "katana/PageAlloc.h"
 #include "katana/PerThreadStorage.h"
 
 namespace {
@@ -61,8 +62,8 @@ struct StatImpl {
   bool merged_{};
 
   void Add(
-      const katana::gstl::Str& region, const katana::gstl::Str& category,
-      const T& val, const katana::StatTotal::Type& type) {
+      std::string_view region, std::string_view category, const T& val,
+      const katana::StatTotal::Type& type) {
     perThreadManagers_.getLocal()->addToStat(region, category, val, type);
   }
 
@@ -225,25 +226,22 @@ katana::StatManager::ReadParam(
 
 void
 katana::StatManager::AddInt(
-    const std::string& region, const std::string& category, int64_t val,
+    std::string_view region, std::string_view category, int64_t val,
     const StatTotal::Type& type) {
-  impl_->int_stats_.Add(
-      gstl::makeStr(region), gstl::makeStr(category), val, type);
+  impl_->int_stats_.Add(region, category, val, type);
 }
 
 void
 katana::StatManager::AddFP(
-    const std::string& region, const std::string& category, double val,
+    std::string_view region, std::string_view category, double val,
     const StatTotal::Type& type) {
-  impl_->fp_stats_.Add(
-      gstl::makeStr(region), gstl::makeStr(category), val, type);
+  impl_->fp_stats_.Add(region, category, val, type);
 }
 
 void
 katana::StatManager::AddParam(
-    const std::string& region, const std::string& category, const Str& val) {
-  impl_->str_stats_.Add(
-      gstl::makeStr(region), gstl::makeStr(category), val, StatTotal::SINGLE);
+    std::string_view region, std::string_view category, const Str& val) {
+  impl_->str_stats_.Add(region, category, val, StatTotal::SINGLE);
 }
 
 void
@@ -300,6 +298,13 @@ katana::reportPageAlloc(const char* category) {
         ReportStatSum("PageAlloc", category, numPagePoolAllocForThread(tid));
       },
       std::make_tuple());
+  for (LargePageKind kind :
+       {LargePageKind::kHuge1G, LargePageKind::kHuge2M,
+        LargePageKind::kTransparent, LargePageKind::kNone}) {
+    ReportStatSingle(
+        "LargePageBytes", std::string(category) + "_" + LargePageKindName(kind),
+        numLargePageBytes(kind));
+  }
 }
 
 void
@@ -19,6 +19,7 @@
 
 #include "katana/Logging.h"
 #include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
 
 // vtable anchoring
 katana::TerminationDetection::~TerminationDetection() = default;
@@ -35,6 +36,10 @@ katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
-  kTerminationDetection->Init(active_threads);
-  return *kTerminationDetection;
+  TerminationDetection* term = kTerminationDetection;
+  if (const auto* group = ThreadPool::getGroup()) {
+    term = group->term;
+  }
+  term->Init(active_threads);
+  return *term;
 }
@@ -0,0 +1,82 @@
+#include "katana/ThreadGroup.h"
+
+#include "katana/Barrier.h"
+#include "katana/ErrorCode.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+struct katana::ThreadGroupLease::Impl {
+  std::unique_ptr<ThreadPool::Group> group;
+  internal::BarrierCache barriers;
+  std::unique_ptr<TerminationDetection> term;
+
+  // per-thread storage of the thread running the group from before it did
+  char* saved_pts_base{nullptr};
+  char* saved_pss_base{nullptr};
+
+  ~Impl() {
+    if (group) {
+      GetThreadPool().releaseGroup(std::move(group));
+    }
+  }
+};
+
+katana::Result<katana::ThreadGroupLease>
+katana::LeaseThreadGroup(unsigned num_threads) {
+  auto group = GetThreadPool().leaseGroup(num_threads);
+  if (!group) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "all {} threads of the pool run loops outside of thread groups",
+        getActiveThreads());
+  }
+
+  auto impl = std::make_unique<ThreadGroupLease::Impl>();
+  impl->group = std::move(group);
+  impl->term = internal::CreateTerminationDetection();
+  impl->group->barriers = &impl->barriers;
+  impl->group->term = impl->term.get();
+
+  return ThreadGroupLease(std::move(impl));
+}
+
+katana::ThreadGroupLease::ThreadGroupLease(std::unique_ptr<Impl>&& impl)
+    : impl_(std::move(impl)) {}
+
+katana::ThreadGroupLease::ThreadGroupLease(ThreadGroupLease&& other) noexcept =
+    default;
+
+katana::ThreadGroupLease&
+katana::ThreadGroupLease::operator=(ThreadGroupLease&& other) noexcept =
+    default;
+
+katana::ThreadGroupLease::~ThreadGroupLease() = default;
+
+unsigned
+katana::ThreadGroupLease::size() const {
+  return impl_->group->num;
+}
+
+void
+katana::ThreadGroupLease::Enter() {
+  ThreadPool& tp = GetThreadPool();
+  ThreadPool::Group* group = impl_->group.get();
+  tp.enterGroup(group);
+
+  // The calling thread takes the slot of the first thread of the group,
+  // whose pool thread sleeps while the group is leased, so per-thread heaps
+  // and other storage reached through the slot are not shared
+  impl_->saved_pts_base = ptsBase;
+  impl_->saved_pss_base = pssBase;
+  ptsBase = static_cast<char*>(getPTSBackend().getRemote(group->base, 0));
+  pssBase = static_cast<char*>(getPPSBackend().getRemote(group->base, 0));
+}
+
+void
+katana::ThreadGroupLease::Leave() {
+  ptsBase = impl_->saved_pts_base;
+  pssBase = impl_->saved_pss_base;
+  GetThreadPool().leaveGroup();
+}
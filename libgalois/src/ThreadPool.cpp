@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
@@ -40,10 +41,14 @@ thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
     : mi(getHWTopo().machineTopoInfo),
+      hwThreads(getHWTopo().threadTopoInfo),
       reserved(0),
       masterFastmode(0),
-      running(false) {
+      running(false),
+      defaultThreads(1),
+      leaseFloor(mi.maxThreads) {
   signals.resize(mi.maxThreads);
+  leased.resize(mi.maxThreads);
   initThread(0);
 
   for (unsigned i = 1; i < mi.maxThreads; ++i) {
@@ -68,13 +73,15 @@ ThreadPool::~ThreadPool() {
 
 void
 ThreadPool::destroyCommon() {
+  KATANA_LOG_VASSERT(
+      leaseFloor == mi.maxThreads, "thread groups outlive the thread pool");
   beKind();  // reset fastmode
   run(mi.maxThreads, []() { throw shutdown_ty(); });
 }
 
 void
 ThreadPool::burnPower(unsigned num) {
-  num = std::min(num, getMaxUsableThreads());
+  num = std::min({num, getMaxUsableThreads(), leaseFloor.load()});
 
   // changing number of threads?  just do a reset
   if (masterFastmode && masterFastmode != num) {
@@ -130,6 +137,7 @@ void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
   my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.slot = tid;
   // Initialize
   initPTS(mi.maxThreads);
 
@@ -159,9 +167,16 @@ ThreadPool::threadLoop(unsigned tid) {
   auto& me = my_box;
   do {
     me.wait(fastmode);
+    if (me.group) {
+      me.topo = me.group->topo[me.slot - me.base];
+    }
     cascade(fastmode);
     try {
-      work();
+      if (me.group) {
+        me.group->work();
+      } else {
+        work();
+      }
     } catch (const shutdown_ty&) {
       return;
     } catch (const fastmode_ty& fm) {
@@ -177,6 +192,11 @@ ThreadPool::threadLoop(unsigned tid) {
     } catch (...) {
       abort();
     }
+    if (me.group) {
+      me.topo = hwThreads[me.slot];
+      me.group = nullptr;
+      me.base = 0;
+    }
     decascade();
   } while (true);
 }
@@ -216,23 +236,34 @@ ThreadPool::cascade(bool fastmode) {
   auto* child1 = signals[me.wbegin];
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
+  child1->group = me.group;
+  child1->base = me.base;
   child1->wakeup(fastmode);
 
   if (midpoint < me.wend) {
     auto* child2 = signals[midpoint];
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
+    child2->group = me.group;
+    child2->base = me.base;
     child2->wakeup(fastmode);
   }
 }
 
 void
 ThreadPool::runInternal(unsigned num) {
+  if (my_box.group) {
+    runGroupInternal(num);
+    return;
+  }
   // sanitize num
   // seq write to starting should make work safe
   KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
   running = true;
   num = std::min(std::max(1U, num), getMaxUsableThreads());
+  KATANA_LOG_VASSERT(
+      num <= leaseFloor.load(std::memory_order_relaxed),
+      "{} threads overlap a leased thread group", num);
   // my_box is tid 0
   auto& me = my_box;
   me.wbegin = 1;
@@ -257,6 +288,158 @@ ThreadPool::runInternal(unsigned num) {
   running = false;
 }
 
+void
+ThreadPool::runGroupInternal(unsigned num) {
+  auto& me = my_box;
+  Group& group = *me.group;
+  KATANA_LOG_VASSERT(
+      !group.running, "Recursive thread pool execution not supported");
+  group.running = true;
+  num = std::min(std::max(1U, num), group.num);
+  me.wbegin = group.base + 1;
+  me.wend = group.base + num;
+
+  // groups never run in fastmode, their threads may have been woken without
+  // it by loops outside of groups
+  cascade(false);
+  try {
+    group.work();
+  } catch (const fastmode_ty&) {
+  }
+  decascade();
+  group.work = nullptr;
+  group.running = false;
+}
+
+unsigned
+ThreadPool::findFreeRange(unsigned num) const {
+  unsigned lo = std::max(defaultThreads, masterFastmode);
+  unsigned hi = mi.maxThreads - reserved;
+  unsigned fallback = ~0U;
+  for (unsigned start = lo; start + num <= hi; ++start) {
+    auto end = leased.begin() + start + num;
+    auto busy = std::find(leased.begin() + start, end, true);
+    if (busy != end) {
+      start = busy - leased.begin();
+      continue;
+    }
+    const ThreadTopoInfo& first = hwThreads[start];
+    const ThreadTopoInfo& last = hwThreads[start + num - 1];
+    if (first.socket == last.socket || first.socketLeader == start) {
+      return start;
+    }
+    if (fallback == ~0U) {
+      fallback = start;
+    }
+  }
+  return fallback;
+}
+
+std::unique_ptr<ThreadPool::Group>
+ThreadPool::leaseGroup(unsigned num) {
+  KATANA_LOG_VASSERT(!my_box.group, "thread groups cannot lease threads");
+  std::unique_lock<std::mutex> lock(groupLock);
+  unsigned lo = std::max(defaultThreads, masterFastmode);
+  unsigned hi = mi.maxThreads - reserved;
+  if (hi <= lo) {
+    return nullptr;
+  }
+  num = std::min(std::max(1U, num), hi - lo);
+
+  unsigned base = ~0U;
+  groupFreed.wait(lock, [&] {
+    base = findFreeRange(num);
+    return base != ~0U;
+  });
+  std::fill(leased.begin() + base, leased.begin() + base + num, true);
+  leaseFloor = std::min(leaseFloor.load(), base);
+  lock.unlock();
+
+  auto group = std::make_unique<Group>();
+  group->base = base;
+  group->num = num;
+  group->poolThreads = mi.maxThreads;
+  group->topo.resize(num);
+
+  // number the sockets and numa nodes of the group densely in the order of
+  // their first threads, which lead the sockets within the group
+  struct LocalSocket {
+    unsigned id;
+    unsigned leader;
+  };
+  std::map<unsigned, LocalSocket> sockets;
+  std::map<unsigned, unsigned> numa_nodes;
+  unsigned max_socket = 0;
+  for (unsigned i = 0; i < num; ++i) {
+    const ThreadTopoInfo& hw = hwThreads[base + i];
+    unsigned next_socket = sockets.size();
+    const LocalSocket& socket =
+        sockets.emplace(hw.socket, LocalSocket{next_socket, i}).first->second;
+    unsigned next_node = numa_nodes.size();
+    unsigned node = numa_nodes.emplace(hw.numaNode, next_node).first->second;
+    max_socket = std::max(max_socket, socket.id);
+
+    ThreadTopoInfo& topo = group->topo[i];
+    topo = hw;
+    topo.tid = i;
+    topo.socket = socket.id;
+    topo.socketLeader = socket.leader;
+    topo.numaNode = node;
+    topo.cumulativeMaxSocket = max_socket;
+  }
+  group->mi = mi;
+  group->mi.maxThreads = num;
+  group->mi.maxSockets = sockets.size();
+  group->mi.maxNumaNodes = numa_nodes.size();
+  // the group gets its share of the cores of the machine
+  unsigned cores = (num * mi.maxCores + mi.maxThreads - 1) / mi.maxThreads;
+  group->mi.maxCores = std::max(1U, std::min(num, cores));
+
+  return group;
+}
+
+void
+ThreadPool::releaseGroup(std::unique_ptr<Group> group) {
+  KATANA_LOG_VASSERT(!group->running, "released a running thread group");
+  std::lock_guard<std::mutex> lock(groupLock);
+  auto begin = leased.begin() + group->base;
+  std::fill(begin, begin + group->num, false);
+  auto first = std::find(leased.begin(), leased.end(), true);
+  leaseFloor = first - leased.begin();
+  groupFreed.notify_all();
+}
+
+void
+ThreadPool::enterGroup(Group* group) {
+  auto& me = my_box;
+  KATANA_LOG_VASSERT(!me.group, "thread groups cannot be nested");
+  KATANA_LOG_VASSERT(!group->running, "thread group is already running");
+  group->callerTopo = me.topo;
+  me.topo = group->topo[0];
+  me.base = group->base;
+  me.group = group;
+}
+
+void
+ThreadPool::leaveGroup() {
+  auto& me = my_box;
+  KATANA_LOG_VASSERT(me.group, "not in a thread group");
+  me.topo = me.group->callerTopo;
+  me.base = 0;
+  me.group = nullptr;
+}
+
+unsigned
+ThreadPool::setDefaultThreads(unsigned num) {
+  KATANA_LOG_VASSERT(
+      !my_box.group, "thread groups cannot change the default threads");
+  std::lock_guard<std::mutex> lock(groupLock);
+  num = std::min({num, mi.maxThreads - reserved, leaseFloor.load()});
+  defaultThreads = std::max(num, 1U);
+  groupFreed.notify_all();
+  return defaultThreads;
+}
+
 void
 ThreadPool::runDedicated(std::function<void(void)>& f) {
   // TODO(ddn): update katana::activeThreads to reflect the dedicated
@@ -267,6 +450,9 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
+  KATANA_LOG_VASSERT(
+      !leased[mi.maxThreads - reserved],
+      "Can't start dedicated thread on a leased thread group");
   work = [&f]() { throw dedicated_ty{f}; };
   auto* child = signals[mi.maxThreads - reserved];
   child->wbegin = 0;
@@ -19,8 +19,6 @@
 
 #include "katana/Threads.h"
 
-#include <algorithm>
-
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
@@ -32,13 +30,15 @@ katana::setActiveThreads(unsigned int num) noexcept {
   // different number of threads than we have after this call. That can cause
   // crashes.
   katana::GetThreadPool().beKind();
-  num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
-  num = std::max(num, 1U);
+  num = katana::GetThreadPool().setDefaultThreads(num);
   katana::activeThreads = num;
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
+  if (const auto* group = katana::ThreadPool::getGroup()) {
+    return group->num;
+  }
   return katana::activeThreads;
 }
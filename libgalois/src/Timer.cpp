@@ -19,6 +19,8 @@
 
 #include "katana/Timer.h"
 
+#include "katana/Metrics.h"
+#include "katana/PhaseSampler.h"
 #include "katana/Statistics.h"
 
 using namespace katana;
@@ -99,16 +101,48 @@ StatTimer::~StatTimer() {
     katana::ReportStatMax(
         region_.c_str(), name_.c_str(), TimeAccumulator::get());
   }
+
+  // and keep running totals, e.g., the time of each loop, for long-running
+  // processes that print their stats late or never
+  if (uint64_t usec = TimeAccumulator::get_usec(); usec > 0) {
+    MetricLabels labels{{"region", region_.c_str()}, {"timer", name_.c_str()}};
+    GetMetrics()
+        .Counter(
+            "katana_timer_microseconds_total", "Time measured by StatTimers",
+            labels)
+        .Add(usec);
+    GetMetrics()
+        .Counter("katana_timer_runs_total", "Runs of StatTimers", labels)
+        .Add(1);
+  }
 }
 
 void
 StatTimer::start() {
+  if (internal::SamplingPhases()) {
+    if (phase_ == 0) {
+      std::string_view name(name_.c_str());
+      std::string_view region(region_.c_str());
+      // the timer of a loop is named "Time" in the region of its loopname
+      if (region == "(NULL)") {
+        phase_ = internal::InternPhase(name);
+      } else if (name == "Time") {
+        phase_ = internal::InternPhase(region);
+      } else {
+        phase_ = internal::InternPhase(
+            std::string(region) + "/" + name_.c_str());
+      }
+    }
+    phase_depth_ = internal::PushPhase(phase_);
+  }
   TimeAccumulator::start();
   valid_ = true;
 }
 
 void
 StatTimer::stop() {
+  internal::PopPhase(phase_depth_);
+  phase_depth_ = -1;
   valid_ = false;
   TimeAccumulator::stop();
 }
@@ -0,0 +1,128 @@
+#include "katana/TopologyManager.h"
+
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Time.h"
+
+const std::string katana::TopologyManager::name_ = "topology";
+
+katana::TopologyManager::~TopologyManager() = default;
+
+katana::TopologyManager::TopologyID
+katana::TopologyManager::TopologyBuiltActive(count_t bytes) {
+  // every topology that has to be built is a miss of the owner's cache
+  stats_.get_count++;
+  stats_.Publish(Name());
+
+  TopologyID id = next_id_++;
+  entries_[id].bytes = bytes;
+  MemorySupervisor::Get().BorrowActive(Name(), bytes);
+  return id;
+}
+
+void
+katana::TopologyManager::TopologyReused(TopologyID id) {
+  stats_.get_count++;
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    KATANA_LOG_WARN("no topology with id {}", id);
+    return;
+  }
+  stats_.get_hit_count++;
+  stats_.Publish(Name());
+
+  auto& entry = it->second;
+  if (entry.standby) {
+    lru_list_.erase(entry.lru_it);
+    entry.standby = false;
+    entry.evictor = nullptr;
+    MemorySupervisor::Get().StandbyToActive(Name(), entry.bytes);
+  }
+}
+
+bool
+katana::TopologyManager::PutTopology(TopologyID id, Evictor evictor) {
+  stats_.insert_count++;
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    KATANA_LOG_WARN("no topology with id {}", id);
+    return false;
+  }
+  auto& entry = it->second;
+  if (entry.standby) {
+    stats_.insert_hit_count++;
+    stats_.Publish(Name());
+    return true;
+  }
+
+  stats_.Publish(Name());
+
+  auto bytes = entry.bytes;
+  auto granted = MemorySupervisor::Get().ActiveToStandby(Name(), bytes);
+  if (granted < bytes) {
+    // ActiveToStandby has already moved the bytes to standby
+    MemorySupervisor::Get().ReturnStandby(Name(), bytes);
+    entries_.erase(it);
+    return false;
+  }
+
+  // ActiveToStandby may have reclaimed memory, so look the entry up again
+  it = entries_.find(id);
+  KATANA_LOG_DEBUG_ASSERT(it != entries_.end());
+  lru_list_.push_front(id);
+  it->second.lru_it = lru_list_.begin();
+  it->second.standby = true;
+  it->second.evictor = std::move(evictor);
+
+  katana::GetTracer().GetActiveSpan().Log(
+      "topology cache insert", {
+                                   {"approx_size_gb", ToGB(bytes)},
+                               });
+  return true;
+}
+
+void
+katana::TopologyManager::TopologyDropped(TopologyID id) {
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    return;
+  }
+  auto& entry = it->second;
+  if (entry.standby) {
+    lru_list_.erase(entry.lru_it);
+    MemorySupervisor::Get().ReturnStandby(Name(), entry.bytes);
+  } else {
+    MemorySupervisor::Get().ReturnActive(Name(), entry.bytes);
+  }
+  entries_.erase(it);
+}
+
+katana::count_t
+katana::TopologyManager::FreeStandbyMemory(count_t goal) {
+  count_t total = 0;
+  auto scope = katana::GetTracer().StartActiveSpan("free standby topologies");
+
+  while (!lru_list_.empty() && total < goal) {
+    TopologyID id = lru_list_.back();
+    lru_list_.pop_back();
+
+    auto it = entries_.find(id);
+    KATANA_LOG_DEBUG_ASSERT(it != entries_.end());
+    Entry entry = std::move(it->second);
+    entries_.erase(it);
+
+    if (entry.evictor) {
+      entry.evictor();
+    }
+    MemorySupervisor::Get().ReturnStandby(Name(), entry.bytes);
+    total += entry.bytes;
+  }
+
+  scope.span().Log(
+      "after", {
+                   {"reclaimed_gb", ToGB(total)},
+                   {"standby_topologies", lru_list_.size()},
+               });
+  return total;
+}
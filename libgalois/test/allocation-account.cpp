@@ -0,0 +1,129 @@
+#include <memory>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MemoryPolicy.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/NUMAArray.h"
+#include "katana/TextTracer.h"
+
+namespace {
+
+constexpr size_t kNum = 1 << 20;
+
+/// Remembers what the MemorySupervisor last told it
+class RecordingPolicy : public katana::MemoryPolicyMinimal {
+public:
+  katana::count_t ReclaimForAllocation(
+      katana::count_t active, [[maybe_unused]] katana::count_t standby,
+      katana::count_t bytes) const override {
+    last_active = active;
+    last_bytes = bytes;
+    return 0;
+  }
+
+  bool KillSelfForLackOfMemory(
+      katana::count_t active, [[maybe_unused]] katana::count_t standby)
+      const override {
+    last_active = active;
+    return false;
+  }
+
+  mutable katana::count_t last_active{-1};
+  mutable katana::count_t last_bytes{-1};
+};
+
+void
+TestAccount(RecordingPolicy* policy) {
+  // without an account, the supervisor hears nothing
+  katana::NUMAArray<uint64_t> unaccounted;
+  unaccounted.allocateInterleaved(kNum);
+  KATANA_LOG_ASSERT(policy->last_active == -1);
+
+  katana::count_t before{};
+  {
+    katana::AllocationAccount account("test");
+    katana::NUMAArray<uint64_t> array;
+    array.allocateBlocked(kNum);
+    KATANA_LOG_ASSERT(
+        policy->last_bytes >=
+        static_cast<katana::count_t>(kNum * sizeof(uint64_t)));
+    KATANA_LOG_ASSERT(policy->last_active >= policy->last_bytes);
+    before = policy->last_active - policy->last_bytes;
+
+    array.deallocate();
+    KATANA_LOG_ASSERT(policy->last_active == before);
+
+    // allocations outlive their account and are returned to it when freed
+    array.allocateInterleaved(kNum);
+    unaccounted = std::move(array);
+  }
+  KATANA_LOG_ASSERT(policy->last_active > before);
+  unaccounted.deallocate();
+  KATANA_LOG_ASSERT(policy->last_active == before);
+
+  // accounts nest and, once gone, no longer count
+  {
+    katana::AllocationAccount outer("test");
+    { katana::AllocationAccount inner("test inner"); }
+    katana::NUMAArray<uint64_t> array;
+    array.allocateLocal(kNum);
+    KATANA_LOG_ASSERT(policy->last_active > before);
+  }
+  KATANA_LOG_ASSERT(policy->last_active == before);
+  policy->last_bytes = -1;
+  katana::NUMAArray<uint64_t> array;
+  array.allocateFloating(kNum);
+  KATANA_LOG_ASSERT(policy->last_bytes == -1);
+}
+
+void
+TestPhase() {
+  constexpr katana::count_t kBytes = kNum * sizeof(uint64_t);
+
+  auto scope = katana::GetTracer().StartActiveSpan("phase");
+  katana::MemoryPhase phase;
+  katana::count_t before = phase.Peaks().used;
+  {
+    katana::AllocationAccount account("test scratch");
+    katana::NUMAArray<uint64_t> array;
+    array.allocateInterleaved(kNum);
+  }
+  // the peaks outlive the allocation
+  katana::MemoryPeaks peaks = phase.Peaks();
+  KATANA_LOG_ASSERT(peaks.scratch >= kBytes);
+  KATANA_LOG_ASSERT(peaks.used >= before + kBytes);
+  KATANA_LOG_ASSERT(peaks.active >= kBytes);
+  KATANA_LOG_ASSERT(peaks.topology == 0);
+
+  // a phase starts from the memory in use when it begins
+  {
+    katana::MemoryPhase inner;
+    KATANA_LOG_ASSERT(inner.Peaks().scratch < kBytes);
+
+    katana::AllocationAccount account(
+        "test topology", katana::MemoryKind::kTopology);
+    katana::NUMAArray<uint64_t> array;
+    array.allocateBlocked(kNum);
+    KATANA_LOG_ASSERT(inner.Peaks().topology >= kBytes);
+  }
+  KATANA_LOG_ASSERT(phase.Peaks().topology >= kBytes);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::ProgressTracer::Set(katana::TextTracer::Make());
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  auto policy = std::make_unique<RecordingPolicy>();
+  RecordingPolicy* recording = policy.get();
+  katana::MemorySupervisor::Get().SetPolicy(std::move(policy));
+
+  TestAccount(recording);
+  TestPhase();
+
+  return 0;
+}
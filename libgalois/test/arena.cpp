@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <iterator>
+
+#include "katana/Arena.h"
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PageAlloc.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+constexpr size_t kNum = 1 << 16;
+
+void
+TestSmall(katana::Arena* arena) {
+  katana::on_each([&](unsigned, unsigned num) {
+    for (size_t i = 0; i < kNum / num; ++i) {
+      arena->Allocate(sizeof(uint64_t));
+      arena->Allocate(3, 64);
+    }
+  });
+  katana::do_all(katana::iterate(size_t{0}, kNum), [&](size_t i) {
+    auto* p = static_cast<uint64_t*>(arena->Allocate(sizeof(uint64_t)));
+    KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(p) % alignof(uint64_t) == 0);
+    *p = i;
+    auto* q = static_cast<char*>(arena->Allocate(3, 64));
+    KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(q) % 64 == 0);
+    q[2] = 1;
+    KATANA_LOG_ASSERT(*p == i);
+  });
+
+  // rounds after a Reset that allocate no more than the first reuse its memory
+  size_t capacity = arena->capacity();
+  KATANA_LOG_ASSERT(capacity > 0);
+  for (int round = 0; round < 3; ++round) {
+    arena->Reset();
+    katana::on_each([&](unsigned, unsigned num) {
+      for (size_t i = 0; i < kNum / num; ++i) {
+        arena->Allocate(sizeof(uint64_t));
+        arena->Allocate(3, 64);
+      }
+    });
+    KATANA_LOG_ASSERT(arena->capacity() == capacity);
+  }
+}
+
+void
+TestLarge(katana::Arena* arena) {
+  arena->Reset();
+  size_t bytes = 4 * katana::allocSize();
+  void* a = arena->Allocate(bytes);
+  void* b = arena->Allocate(bytes / 2);
+  KATANA_LOG_ASSERT(a != b);
+  size_t capacity = arena->capacity();
+
+  // the smaller allocation takes the smaller block
+  arena->Reset();
+  KATANA_LOG_ASSERT(arena->Allocate(bytes / 3) == b);
+  KATANA_LOG_ASSERT(arena->Allocate(bytes) == a);
+  KATANA_LOG_ASSERT(arena->capacity() == capacity);
+}
+
+void
+TestContainers(katana::Arena* arena) {
+  arena->Reset();
+
+  katana::NUMAArray<uint64_t> array = arena->MakeArray<uint64_t>(kNum);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNum), [&](size_t i) { array[i] = i; });
+
+  katana::gstl::ArenaVector<uint32_t> vec{
+      katana::ArenaAllocator<uint32_t>(arena)};
+  for (uint32_t i = 0; i < kNum; ++i) {
+    vec.push_back(i);
+  }
+
+  katana::InsertBag<uint64_t> bag(arena);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNum), [&](size_t i) { bag.push(i); });
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(katana::iterate(bag), [&](uint64_t v) { sum += v; });
+  KATANA_LOG_ASSERT(sum.reduce() == kNum * (kNum - 1) / 2);
+  for (uint32_t i = 0; i < kNum; ++i) {
+    KATANA_LOG_ASSERT(vec[i] == i);
+    KATANA_LOG_ASSERT(array[i] == i);
+  }
+
+  bag.clear();
+  bag.push(1);
+  KATANA_LOG_ASSERT(std::distance(bag.begin(), bag.end()) == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  katana::Arena arena;
+  TestSmall(&arena);
+  TestLarge(&arena);
+  TestContainers(&arena);
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/AtomicUnionFind.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+constexpr uint32_t kNumElements = 1 << 16;
+
+// merging i with i + stride for every i leaves one set per residue modulo
+// stride, each named by its least element
+void
+TestStrides() {
+  katana::AtomicUnionFind<uint32_t> sets(kNumElements);
+  for (uint32_t stride : {64u, 16u, 4u}) {
+    katana::GAccumulator<uint64_t> merged;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, kNumElements - stride), [&](uint32_t i) {
+          if (sets.Union(i, i + stride)) {
+            merged += 1;
+          }
+        });
+    katana::GAccumulator<uint64_t> roots;
+    katana::do_all(katana::iterate(uint32_t{0}, kNumElements), [&](uint32_t i) {
+      KATANA_LOG_ASSERT(sets.Find(i) == i % stride);
+      KATANA_LOG_ASSERT(sets.SameSet(i, i % stride));
+      KATANA_LOG_ASSERT(!sets.SameSet(i, (i + 1) % stride));
+      if (sets.IsRoot(i)) {
+        roots += 1;
+      }
+    });
+    KATANA_LOG_ASSERT(roots.reduce() == stride);
+    // the number of successful unions is the number of sets removed
+    KATANA_LOG_ASSERT(stride != 64 || merged.reduce() == kNumElements - 64);
+  }
+
+  sets.Compress();
+  for (uint32_t i = 0; i < kNumElements; ++i) {
+    KATANA_LOG_ASSERT(sets.Find(i) == i % 4);
+  }
+
+  sets.Reset(kNumElements);
+  KATANA_LOG_ASSERT(sets.Find(kNumElements - 1) == kNumElements - 1);
+  KATANA_LOG_ASSERT(!sets.SameSet(0, 1));
+}
+
+// racing unions of random pairs: every successful union removes one set
+void
+TestContention() {
+  katana::AtomicUnionFind<uint32_t> sets(kNumElements);
+  katana::GAccumulator<uint64_t> merged;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNumElements * 4), [&](uint32_t i) {
+        uint32_t a = (i * 2654435761u) % kNumElements;
+        uint32_t b = (a + 1 + i % 7) % kNumElements;
+        if (sets.Union(a, b)) {
+          merged += 1;
+        }
+      });
+  katana::GAccumulator<uint64_t> roots;
+  katana::do_all(katana::iterate(uint32_t{0}, kNumElements), [&](uint32_t i) {
+    if (sets.IsRoot(i)) {
+      roots += 1;
+    }
+  });
+  KATANA_LOG_ASSERT(roots.reduce() + merged.reduce() == kNumElements);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(4);
+
+  TestStrides();
+  TestContention();
+
+  return 0;
+}
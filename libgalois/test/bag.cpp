@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+
+namespace {
+
+constexpr size_t kNum = 1 << 20;
+
+void
+TestToNUMAArray() {
+  katana::InsertBag<uint64_t> bag;
+  KATANA_LOG_ASSERT(bag.size() == 0);
+  KATANA_LOG_ASSERT(bag.ToNUMAArray().size() == 0);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, kNum), [&](size_t i) { bag.push(i); });
+  KATANA_LOG_ASSERT(bag.size() == kNum);
+
+  katana::NUMAArray<uint64_t> array = bag.ToNUMAArray();
+  KATANA_LOG_ASSERT(array.size() == kNum);
+
+  // same order as iterating the bag, and every element once
+  size_t i = 0;
+  for (uint64_t v : bag) {
+    KATANA_LOG_ASSERT(array[i++] == v);
+  }
+  std::vector<bool> seen(kNum);
+  for (uint64_t v : array) {
+    KATANA_LOG_ASSERT(!seen[v]);
+    seen[v] = true;
+  }
+}
+
+void
+TestMoveTo() {
+  katana::InsertBag<std::string> bag;
+  katana::do_all(katana::iterate(size_t{0}, kNum / 16), [&](size_t i) {
+    bag.push(std::to_string(i));
+  });
+
+  std::vector<std::string> expected(bag.begin(), bag.end());
+  std::vector<std::string> moved(bag.size());
+  bag.MoveTo(moved.begin());
+  KATANA_LOG_ASSERT(moved == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  TestToNUMAArray();
+  TestMoveTo();
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include "katana/Barrier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+constexpr unsigned kWaitsPerIteration = 1024;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  for (unsigned threads = 1; threads < max_threads; threads *= 2) {
+    b->Args({threads});
+  }
+  b->Args({max_threads});
+}
+
+void
+RunWaits(katana::Barrier& barrier, unsigned threads) {
+  katana::setActiveThreads(threads);
+  katana::on_each([&](unsigned, unsigned) {
+    for (unsigned i = 0; i < kWaitsPerIteration; ++i) {
+      barrier.Wait();
+    }
+  });
+}
+
+template <katana::BarrierKind Kind>
+void
+Wait(benchmark::State& state) {
+  unsigned threads = state.range(0);
+  std::unique_ptr<katana::Barrier> barrier =
+      katana::CreateBarrier(Kind, threads);
+
+  for (auto _ : state) {
+    RunWaits(*barrier, threads);
+  }
+
+  state.SetLabel(barrier->name());
+  state.SetItemsProcessed(state.iterations() * kWaitsPerIteration);
+}
+
+/// The barrier that GetBarrier chooses
+void
+GetBarrierWait(benchmark::State& state) {
+  unsigned threads = state.range(0);
+  katana::Barrier& barrier = katana::GetBarrier(threads);
+
+  for (auto _ : state) {
+    RunWaits(barrier, threads);
+  }
+
+  state.SetLabel(barrier.name());
+  state.SetItemsProcessed(state.iterations() * kWaitsPerIteration);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::GaloisRuntime G;
+
+  KATANA_LOG_ASSERT(
+      katana::ChooseBarrierKind(1, 1) == katana::BarrierKind::kCounting);
+  KATANA_LOG_ASSERT(
+      katana::ChooseBarrierKind(64, 1) ==
+      katana::BarrierKind::kDissemination);
+  KATANA_LOG_ASSERT(
+      katana::ChooseBarrierKind(64, 2) == katana::BarrierKind::kTopo);
+
+  // thread counts depend on the machine, so register after the runtime is up
+  benchmark::RegisterBenchmark(
+      "Counting", Wait<katana::BarrierKind::kCounting>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark(
+      "Dissemination", Wait<katana::BarrierKind::kDissemination>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark("MCS", Wait<katana::BarrierKind::kMCS>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark("Topo", Wait<katana::BarrierKind::kTopo>)
+      ->Apply(MakeArguments);
+  benchmark::RegisterBenchmark("GetBarrier", GetBarrierWait)
+      ->Apply(MakeArguments);
+
+  ::benchmark::RunSpecifiedBenchmarks();
+}
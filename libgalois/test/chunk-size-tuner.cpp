@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cstdint>
+
+#include "katana/ChunkSizeTuner.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+katana::ChunkSizeTuner::Outcome
+MakeOutcome(unsigned chunk_size, uint64_t us, uint64_t num_steals = 0) {
+  katana::ChunkSizeTuner::Outcome outcome;
+  outcome.chunk_size = chunk_size;
+  outcome.num_threads = 4;
+  outcome.num_items = 1 << 20;
+  outcome.num_chunks = outcome.num_items / chunk_size;
+  outcome.num_steals = num_steals;
+  outcome.us = us;
+  return outcome;
+}
+
+void
+TestClimb() {
+  auto& tuner = katana::ChunkSizeTuner::Get();
+  tuner.Reset();
+  const std::string loop = "climb";
+
+  KATANA_LOG_ASSERT(tuner.ChunkSize(loop, 32) == 32);
+  KATANA_LOG_ASSERT(tuner.BestChunkSize(loop) == 0);
+
+  // better and better while growing
+  tuner.Report(loop, MakeOutcome(32, 1000));
+  KATANA_LOG_ASSERT(tuner.ChunkSize(loop, 32) == 64);
+  tuner.Report(loop, MakeOutcome(64, 800));
+  KATANA_LOG_ASSERT(tuner.ChunkSize(loop, 32) == 128);
+
+  // worse, so turn back from the best
+  tuner.Report(loop, MakeOutcome(128, 900));
+  KATANA_LOG_ASSERT(tuner.BestChunkSize(loop) == 64);
+  KATANA_LOG_ASSERT(tuner.ChunkSize(loop, 32) == 32);
+
+  // outcomes of an outdated chunk size, or with too little work, are ignored
+  tuner.Report(loop, MakeOutcome(128, 1));
+  katana::ChunkSizeTuner::Outcome tiny = MakeOutcome(32, 1);
+  tiny.num_items = 10;
+  tuner.Report(loop, tiny);
+  KATANA_LOG_ASSERT(tuner.ChunkSize(loop, 32) == 32);
+  KATANA_LOG_ASSERT(tuner.BestChunkSize(loop) == 64);
+
+  // loops are tuned separately
+  KATANA_LOG_ASSERT(tuner.ChunkSize("other", 16) == 16);
+}
+
+void
+TestSteals() {
+  auto& tuner = katana::ChunkSizeTuner::Get();
+  tuner.Reset();
+  const std::string loop = "steals";
+
+  // many steals shrink the chunk size even though the loop got faster
+  tuner.ChunkSize(loop, 256);
+  katana::ChunkSizeTuner::Outcome outcome = MakeOutcome(256, 1000);
+  outcome.num_steals = outcome.num_chunks / 2;
+  tuner.Report(loop, outcome);
+  KATANA_LOG_ASSERT(tuner.ChunkSize(loop, 256) == 128);
+
+  // and stop at the smallest chunk size
+  tuner.Reset();
+  tuner.ChunkSize(loop, katana::chunk_size_tag::MIN);
+  outcome = MakeOutcome(katana::chunk_size_tag::MIN, 1000);
+  outcome.num_steals = outcome.num_chunks;
+  tuner.Report(loop, outcome);
+  KATANA_LOG_ASSERT(tuner.ChunkSize(loop, 1) == katana::chunk_size_tag::MIN);
+}
+
+void
+TestDoAll() {
+  katana::ChunkSizeTuner::Get().Reset();
+  constexpr uint64_t kNum = 1 << 20;
+
+  for (int i = 0; i < 10; ++i) {
+    std::atomic<uint64_t> sum{0};
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kNum),
+        [&](uint64_t n) { sum.fetch_add(n, std::memory_order_relaxed); },
+        katana::adaptive_chunk_size(), katana::chunk_size<16>(),
+        katana::loopname("adaptive"));
+    KATANA_LOG_ASSERT(sum == kNum * (kNum - 1) / 2);
+  }
+
+  unsigned chunk_size =
+      katana::ChunkSizeTuner::Get().ChunkSize("adaptive", 16);
+  KATANA_LOG_ASSERT(
+      chunk_size >= katana::chunk_size_tag::MIN &&
+      chunk_size <= katana::chunk_size_tag::MAX);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(4);
+
+  TestClimb();
+  TestSteals();
+  TestDoAll();
+
+  return 0;
+}
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/CompressedBitmap.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Set = katana::CompressedBitmap;
+using Kind = Set::ContainerKind;
+
+/// Values of three kinds: sparse ones, a dense block and a long run, so
+/// that every kind of container is made
+std::vector<uint32_t>
+MakeValues(std::mt19937* gen, uint32_t offset) {
+  std::vector<uint32_t> values;
+  for (int i = 0; i < 3000; ++i) {
+    values.emplace_back((*gen)() % (uint32_t{1} << 24));
+  }
+  for (uint32_t v = 0; v < (uint32_t{1} << 16); ++v) {
+    if ((*gen)() % 2 == 0) {
+      values.emplace_back((uint32_t{3} << 16) + v);
+    }
+  }
+  for (uint32_t v = 0; v < 200000; ++v) {
+    values.emplace_back((uint32_t{7} << 16) + offset + v);
+  }
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+std::vector<uint32_t>
+Unique(std::vector<uint32_t> values) {
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+
+void
+TestAddRemove() {
+  Set set;
+  std::set<uint32_t> expected;
+  std::mt19937 gen{7};
+  for (int i = 0; i < 20000; ++i) {
+    // few containers, so that arrays turn into bitmaps and back
+    uint32_t value = gen() % (uint32_t{2} << 16);
+    if (gen() % 3 == 0) {
+      KATANA_LOG_ASSERT(set.Remove(value) == (expected.erase(value) == 1));
+    } else {
+      KATANA_LOG_ASSERT(set.Add(value) == expected.insert(value).second);
+    }
+  }
+  KATANA_LOG_ASSERT(set.Cardinality() == expected.size());
+  for (uint32_t v = 0; v < (uint32_t{2} << 16); v += 7) {
+    KATANA_LOG_ASSERT(set.Contains(v) == (expected.count(v) == 1));
+  }
+  KATANA_LOG_ASSERT(
+      set.ToVector() ==
+      std::vector<uint32_t>(expected.begin(), expected.end()));
+  KATANA_LOG_ASSERT(set.NumContainers(Kind::kBitmap) > 0);
+
+  for (uint32_t value : expected) {
+    KATANA_LOG_ASSERT(set.Remove(value));
+  }
+  KATANA_LOG_ASSERT(set.empty());
+}
+
+void
+TestRuns() {
+  auto set = Set::FromRange(100, (uint64_t{5} << 16) + 3);
+  KATANA_LOG_ASSERT(set.Cardinality() == (uint64_t{5} << 16) + 3 - 100);
+  KATANA_LOG_ASSERT(set.NumContainers(Kind::kRun) == 6);
+  KATANA_LOG_ASSERT(!set.Contains(99) && set.Contains(100));
+  KATANA_LOG_ASSERT(set.Contains((uint32_t{5} << 16) + 2));
+  KATANA_LOG_ASSERT(!set.Contains((uint32_t{5} << 16) + 3));
+
+  // adding to a run container makes it plain, RunOptimize makes it runs
+  KATANA_LOG_ASSERT(set.Add(5));
+  KATANA_LOG_ASSERT(set.NumContainers(Kind::kRun) == 5);
+  set.RunOptimize();
+  KATANA_LOG_ASSERT(set.NumContainers(Kind::kRun) == 6);
+
+  // every other value is no run
+  std::vector<uint32_t> evens;
+  for (uint32_t v = 0; v < 20000; v += 2) {
+    evens.emplace_back(v);
+  }
+  auto sparse = Set::FromSorted(evens.data(), evens.size());
+  sparse.RunOptimize();
+  KATANA_LOG_ASSERT(sparse.NumContainers(Kind::kRun) == 0);
+  KATANA_LOG_ASSERT(sparse.ToVector() == evens);
+}
+
+void
+TestSetOps() {
+  std::mt19937 gen{42};
+  auto a_values = MakeValues(&gen, 0);
+  auto b_values = MakeValues(&gen, 1000);
+  auto a = Set::FromSorted(a_values.data(), a_values.size());
+  auto b = Set::FromSorted(b_values.data(), b_values.size());
+  a_values = Unique(a_values);
+  b_values = Unique(b_values);
+  KATANA_LOG_ASSERT(a.ToVector() == a_values);
+  KATANA_LOG_ASSERT(a.NumContainers(Kind::kArray) > 0);
+  KATANA_LOG_ASSERT(a.NumContainers(Kind::kBitmap) > 0);
+
+  std::vector<uint32_t> expected_union;
+  std::set_union(
+      a_values.begin(), a_values.end(), b_values.begin(), b_values.end(),
+      std::back_inserter(expected_union));
+  std::vector<uint32_t> expected_intersection;
+  std::set_intersection(
+      a_values.begin(), a_values.end(), b_values.begin(), b_values.end(),
+      std::back_inserter(expected_intersection));
+  std::vector<uint32_t> expected_difference;
+  std::set_difference(
+      a_values.begin(), a_values.end(), b_values.begin(), b_values.end(),
+      std::back_inserter(expected_difference));
+
+  // with and without run containers on either side
+  for (int round = 0; round < 2; ++round) {
+    KATANA_LOG_ASSERT(Set::Union(a, b).ToVector() == expected_union);
+    KATANA_LOG_ASSERT(
+        Set::Intersection(a, b).ToVector() == expected_intersection);
+    KATANA_LOG_ASSERT(Set::Difference(a, b).ToVector() == expected_difference);
+    KATANA_LOG_ASSERT(
+        Set::IntersectionCardinality(a, b) == expected_intersection.size());
+    a.RunOptimize();
+    KATANA_LOG_ASSERT(a.NumContainers(Kind::kRun) > 0);
+  }
+
+  Set c = a;
+  c |= b;
+  KATANA_LOG_ASSERT(c.ToVector() == expected_union);
+  c -= b;
+  KATANA_LOG_ASSERT(c.ToVector() == expected_difference);
+  c &= b;
+  KATANA_LOG_ASSERT(c.empty());
+
+  // equal sets compare equal whatever their containers
+  auto plain = Set::FromSorted(a_values.data(), a_values.size());
+  KATANA_LOG_ASSERT(plain == a);
+  KATANA_LOG_ASSERT(plain != b);
+}
+
+void
+TestBulk() {
+  std::vector<Set> sets;
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 0; i < 37; ++i) {
+    std::vector<uint32_t> values;
+    for (uint32_t v = i; v < (uint32_t{1} << 22); v += 37 * (i + 1)) {
+      values.emplace_back(v);
+    }
+    expected.insert(expected.end(), values.begin(), values.end());
+    sets.emplace_back(Set::FromSorted(values.data(), values.size()));
+  }
+  std::sort(expected.begin(), expected.end());
+  expected = Unique(expected);
+
+  std::vector<const Set*> pointers;
+  for (const auto& set : sets) {
+    pointers.emplace_back(&set);
+  }
+  auto all = Set::UnionAll(pointers);
+  KATANA_LOG_ASSERT(all.ToVector() == expected);
+  KATANA_LOG_ASSERT(Set::UnionAll({}).empty());
+
+  katana::GAccumulator<uint64_t> count;
+  katana::GAccumulator<uint64_t> sum;
+  all.ParallelForEach([&](uint32_t v) {
+    count += 1;
+    sum += v;
+  });
+  uint64_t expected_sum = 0;
+  for (uint32_t v : expected) {
+    expected_sum += v;
+  }
+  KATANA_LOG_ASSERT(count.reduce() == expected.size());
+  KATANA_LOG_ASSERT(sum.reduce() == expected_sum);
+}
+
+void
+TestSerialize() {
+  std::mt19937 gen{3};
+  auto values = MakeValues(&gen, 0);
+  auto set = Set::FromSorted(values.data(), values.size());
+  set.RunOptimize();
+
+  std::vector<uint8_t> bytes;
+  set.Serialize(&bytes);
+  KATANA_LOG_ASSERT(bytes.size() == set.SerializedSize());
+  auto res = Set::Deserialize(bytes.data(), bytes.size());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(res.value() == set);
+  KATANA_LOG_ASSERT(res.value().ToVector() == set.ToVector());
+
+  // cut or corrupted input is an error rather than a wrong set
+  KATANA_LOG_ASSERT(!Set::Deserialize(bytes.data(), bytes.size() - 1));
+  KATANA_LOG_ASSERT(!Set::Deserialize(bytes.data(), 3));
+  std::vector<uint8_t> corrupt = bytes;
+  corrupt[8 + 2] ^= 1;
+  KATANA_LOG_ASSERT(!Set::Deserialize(corrupt.data(), corrupt.size()));
+
+  std::vector<uint8_t> empty_bytes;
+  Set().Serialize(&empty_bytes);
+  auto empty = Set::Deserialize(empty_bytes.data(), empty_bytes.size());
+  KATANA_LOG_ASSERT(empty && empty.value().empty());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  TestAddRemove();
+  TestRuns();
+  TestSetOps();
+  TestBulk();
+  TestSerialize();
+
+  return 0;
+}
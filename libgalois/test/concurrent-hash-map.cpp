@@ -0,0 +1,78 @@
+#include "katana/ConcurrentHashMap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+void
+TestAdd() {
+  constexpr uint64_t kNum = 100000;
+  constexpr uint64_t kKeys = 1000;
+
+  katana::ConcurrentHashMap<uint64_t, uint64_t> counts(kKeys);
+  KATANA_LOG_ASSERT(counts.capacity() >= 2 * kKeys);
+
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(katana::iterate(uint64_t{0}, kNum), [&](uint64_t i) {
+      KATANA_LOG_ASSERT(counts.Add(i % kKeys, 1));
+    });
+
+    KATANA_LOG_ASSERT(counts.size() == kKeys);
+    for (uint64_t k = 0; k < kKeys; ++k) {
+      KATANA_LOG_ASSERT(counts.Find(k) == kNum / kKeys);
+    }
+    KATANA_LOG_ASSERT(!counts.Find(kKeys));
+
+    std::atomic<uint64_t> total{0};
+    counts.ForEach([&](uint64_t, uint64_t count) { total += count; });
+    KATANA_LOG_ASSERT(total == kNum);
+
+    counts.Clear();
+    KATANA_LOG_ASSERT(counts.size() == 0);
+  }
+}
+
+void
+TestUpdate() {
+  katana::ConcurrentHashMap<uint32_t, uint32_t> maxima(10);
+
+  katana::do_all(katana::iterate(uint32_t{0}, uint32_t{1000}), [&](uint32_t i) {
+    maxima.Update(i % 10, [i](uint32_t v) { return std::max(v, i); });
+  });
+
+  for (uint32_t k = 0; k < 10; ++k) {
+    KATANA_LOG_ASSERT(maxima.Find(k) == 990 + k);
+  }
+}
+
+void
+TestFull() {
+  katana::ConcurrentHashMap<uint64_t, uint64_t> map;
+  uint64_t capacity = map.capacity();
+
+  katana::do_all(katana::iterate(uint64_t{0}, capacity), [&](uint64_t i) {
+    KATANA_LOG_ASSERT(map.FindOrInsert(i));
+  });
+  KATANA_LOG_ASSERT(map.size() == capacity);
+  KATANA_LOG_ASSERT(!map.Add(capacity, 1));
+  KATANA_LOG_ASSERT(map.Add(0, 1));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(4);
+
+  TestAdd();
+  TestUpdate();
+  TestFull();
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/DistributedTermination.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumHosts = 3;
+constexpr uint32_t kNumMessages = 1000;
+constexpr uint32_t kNumHops = 7;
+
+/// What the hosts of this process share: a barrier, a broadcast slot and
+/// a mailbox per host
+struct World {
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t waiting{0};
+  uint64_t generation{0};
+  std::string slot;
+
+  std::mutex mailbox_mutex;
+  std::vector<std::deque<uint32_t>> mailboxes{kNumHosts};
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t gen = generation;
+    if (++waiting == kNumHosts) {
+      waiting = 0;
+      ++generation;
+      cv.notify_all();
+    } else {
+      cv.wait(lock, [&]() { return generation != gen; });
+    }
+  }
+};
+
+/// Hosts as threads, with the default AllReduceSum
+class ThreadCommBackend : public katana::CommBackend {
+public:
+  ThreadCommBackend(World* world, uint32_t rank) : world_(world) {
+    Num = kNumHosts;
+    Rank = rank;
+  }
+
+  void Barrier() override { world_->Wait(); }
+
+  bool Broadcast(uint32_t root, bool val) override {
+    return Broadcast(root, std::string(1, val ? '1' : '0'), 1) == "1";
+  }
+
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override {
+    world_->Wait();
+    if (Rank == root) {
+      world_->slot = val.substr(0, max_size);
+    }
+    world_->Wait();
+    std::string ret = world_->slot;
+    world_->Wait();
+    return ret;
+  }
+
+  void NotifyFailure() override { std::abort(); }
+
+private:
+  World* world_;
+};
+
+/// Passes every message on to the next host until it has made kNumHops
+/// hops; returns the number of messages that arrived at this host
+uint64_t
+RunHost(World* world, uint32_t rank, std::atomic<uint64_t>* num_checks) {
+  ThreadCommBackend comm(world, rank);
+  katana::DistributedTermination term(&comm);
+  uint64_t arrived = 0;
+
+  if (rank == 0) {
+    std::lock_guard<std::mutex> lock(world->mailbox_mutex);
+    for (uint32_t i = 0; i < kNumMessages; ++i) {
+      world->mailboxes[1].push_back(kNumHops - 1);
+    }
+    term.CountSent(kNumMessages);
+  }
+
+  katana::RunToGlobalTermination(&term, [&]() {
+    std::deque<uint32_t> received;
+    {
+      std::lock_guard<std::mutex> lock(world->mailbox_mutex);
+      received.swap(world->mailboxes[rank]);
+    }
+    term.CountReceived(received.size());
+
+    // messages sent now may be received by the next host in this round or
+    // in a later one
+    uint32_t next = (rank + 1) % kNumHosts;
+    for (uint32_t hops : received) {
+      if (hops == 0) {
+        ++arrived;
+        continue;
+      }
+      term.CountSent();
+      std::lock_guard<std::mutex> lock(world->mailbox_mutex);
+      world->mailboxes[next].push_back(hops - 1);
+    }
+    return false;
+  });
+
+  *num_checks += term.num_checks();
+  return arrived;
+}
+
+void
+TestRing() {
+  World world;
+  std::atomic<uint64_t> num_checks{0};
+  std::vector<uint64_t> arrived(kNumHosts);
+  std::vector<std::thread> hosts;
+  for (uint32_t rank = 0; rank < kNumHosts; ++rank) {
+    hosts.emplace_back([&, rank]() {
+      arrived[rank] = RunHost(&world, rank, &num_checks);
+    });
+  }
+  for (auto& host : hosts) {
+    host.join();
+  }
+
+  uint64_t total = 0;
+  for (uint64_t a : arrived) {
+    total += a;
+  }
+  KATANA_LOG_ASSERT(total == kNumMessages);
+  for (const auto& mailbox : world.mailboxes) {
+    KATANA_LOG_ASSERT(mailbox.empty());
+  }
+  // every host checks as often as the others, and termination takes two
+  KATANA_LOG_ASSERT(num_checks % kNumHosts == 0);
+  KATANA_LOG_ASSERT(num_checks / kNumHosts >= 2);
+}
+
+void
+TestSingleHost() {
+  katana::NullCommBackend comm;
+  katana::DistributedTermination term(&comm);
+  term.CountSent(2);
+  term.CountReceived(1);
+  KATANA_LOG_ASSERT(!term.Terminated(true));
+  term.CountReceived(1);
+  KATANA_LOG_ASSERT(!term.Terminated(false));
+  KATANA_LOG_ASSERT(term.Terminated(true));
+  KATANA_LOG_ASSERT(term.num_checks() == 3);
+  term.Reset();
+  KATANA_LOG_ASSERT(term.num_checks() == 0);
+
+  KATANA_LOG_ASSERT(
+      comm.AllReduceSum({1, 2, 3}) == (std::vector<uint64_t>{1, 2, 3}));
+}
+
+}  // namespace
+
+int
+main() {
+  TestRing();
+  TestSingleHost();
+
+  return 0;
+}
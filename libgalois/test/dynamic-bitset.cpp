@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+constexpr size_t kNumBits = (1 << 20) + 37;
+
+void
+TestSetBits() {
+  katana::DynamicBitset bitset;
+  bitset.resize(kNumBits);
+
+  katana::do_all(katana::iterate(size_t{0}, kNumBits), [&](size_t i) {
+    if (i % 3 == 0) {
+      KATANA_LOG_ASSERT(!bitset.set(i));
+    }
+  });
+  size_t expected = (kNumBits + 2) / 3;
+  KATANA_LOG_ASSERT(bitset.count() == expected);
+  KATANA_LOG_ASSERT(bitset.SerialCount() == expected);
+
+  katana::GAccumulator<size_t> visited;
+  katana::GAccumulator<size_t> sum;
+  bitset.ForEachSetBit([&](size_t i) {
+    KATANA_LOG_ASSERT(i % 3 == 0);
+    visited += 1;
+    sum += i;
+  });
+  KATANA_LOG_ASSERT(visited.reduce() == expected);
+  KATANA_LOG_ASSERT(sum.reduce() == 3 * expected * (expected - 1) / 2);
+
+  std::vector<uint64_t> offsets = bitset.GetOffsets<uint64_t>();
+  KATANA_LOG_ASSERT(offsets.size() == expected);
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    KATANA_LOG_ASSERT(offsets[i] == 3 * i);
+  }
+
+  // bits past size() do not count
+  bitset.bitwise_not();
+  KATANA_LOG_ASSERT(bitset.count() == kNumBits - expected);
+  KATANA_LOG_ASSERT(bitset.SerialCount() == kNumBits - expected);
+  KATANA_LOG_ASSERT(
+      bitset.GetOffsets<uint32_t>().size() == kNumBits - expected);
+  katana::GAccumulator<size_t> not_visited;
+  bitset.ForEachSetBit([&](size_t i) {
+    KATANA_LOG_ASSERT(i < kNumBits);
+    not_visited += 1;
+  });
+  KATANA_LOG_ASSERT(not_visited.reduce() == kNumBits - expected);
+}
+
+void
+TestSetWord() {
+  katana::DynamicBitset bitset;
+  bitset.resize(128);
+  KATANA_LOG_ASSERT(bitset.SetWord(1, 0b1010) == 0);
+  KATANA_LOG_ASSERT(bitset.SetWord(1, 0b0110) == 0b0010);
+  KATANA_LOG_ASSERT(bitset.test(65) && bitset.test(66) && bitset.test(67));
+  KATANA_LOG_ASSERT(!bitset.test(64));
+  KATANA_LOG_ASSERT(bitset.GetWord(1) == 0b1110);
+  KATANA_LOG_ASSERT(bitset.count() == 3);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  TestSetBits();
+  TestSetWord();
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "katana/DynamicPerThreadStorage.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+
+namespace {
+
+std::atomic<int> num_live{0};
+
+/// Records the thread that constructed it
+struct Owned {
+  unsigned owner;
+  std::vector<int> data;
+
+  explicit Owned(int size) : owner(katana::ThreadPool::getTID()), data(size) {
+    ++num_live;
+  }
+  ~Owned() { --num_live; }
+};
+
+/// Larger than the fixed per-thread area
+struct Large {
+  unsigned owner{katana::ThreadPool::getTID()};
+  std::array<char, (UINT64_C(4) << 20)> bytes{};
+};
+
+template <typename T>
+void
+TestConstructorDoesNotConflictWithResultConstruction() {
+  auto f1 = []() -> katana::Result<T> {
+    T ret;
+
+    return ret;
+  };
+
+  auto f2 = []() -> katana::Result<T> { return katana::ErrorCode::NotFound; };
+
+  (void)f1;
+  (void)f2;
+}
+
+void
+TestOwnerConstructs() {
+  {
+    katana::DynamicPerThreadStorage<Owned> storage(10);
+    unsigned num_threads = katana::getActiveThreads();
+    KATANA_LOG_ASSERT(num_live == static_cast<int>(num_threads));
+    for (unsigned i = 0; i < num_threads; ++i) {
+      KATANA_LOG_ASSERT(storage.isMade(i));
+      KATANA_LOG_ASSERT(storage.getRemote(i)->owner == i);
+      KATANA_LOG_ASSERT(storage.getRemote(i)->data.size() == 10);
+    }
+    katana::on_each([&](unsigned tid, unsigned) {
+      KATANA_LOG_ASSERT(storage.getLocal() == storage.getRemote(tid));
+    });
+  }
+  KATANA_LOG_ASSERT(num_live == 0);
+}
+
+void
+TestLarge() {
+  using Storage = katana::DynamicPerThreadStorage<Large>;
+  static_assert(sizeof(Large) > Storage::kMaxInlineSize);
+  Storage storage;
+  katana::on_each([&](unsigned tid, unsigned) {
+    Large* local = storage.getLocal();
+    KATANA_LOG_ASSERT(local->owner == tid);
+    local->bytes.back() = static_cast<char>(tid);
+  });
+  for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+    KATANA_LOG_ASSERT(
+        storage.getRemote(i)->bytes.back() == static_cast<char>(i));
+  }
+}
+
+void
+TestGrow() {
+  unsigned max_threads = katana::setActiveThreads(4);
+  katana::setActiveThreads(1);
+  katana::DynamicPerThreadStorage<Owned> storage(1);
+  KATANA_LOG_ASSERT(num_live == 1);
+  KATANA_LOG_ASSERT(max_threads < 2 || !storage.isMade(1));
+
+  // threads made active later construct their objects on first use
+  katana::setActiveThreads(max_threads);
+  katana::on_each([&](unsigned tid, unsigned) {
+    KATANA_LOG_ASSERT(storage.getLocal()->owner == tid);
+  });
+  KATANA_LOG_ASSERT(num_live == static_cast<int>(max_threads));
+
+  katana::DynamicPerThreadStorage<Owned> moved(std::move(storage));
+  KATANA_LOG_ASSERT(num_live == static_cast<int>(max_threads));
+  KATANA_LOG_ASSERT(moved.getRemote(0)->owner == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(4);
+
+  TestConstructorDoesNotConflictWithResultConstruction<
+      katana::DynamicPerThreadStorage<int>>();
+
+  TestOwnerConstructs();
+  TestLarge();
+  TestGrow();
+  KATANA_LOG_ASSERT(num_live == 0);
+
+  return 0;
+}
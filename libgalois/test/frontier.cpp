@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 1 << 16;
+
+void
+CheckNodes(katana::Frontier<uint32_t>* frontier, uint32_t stride) {
+  katana::GAccumulator<size_t> visited;
+  frontier->ForEach([&](uint32_t n) {
+    KATANA_LOG_ASSERT(n % stride == 0);
+    visited += 1;
+  });
+  KATANA_LOG_ASSERT(visited.reduce() == kNumNodes / stride);
+  KATANA_LOG_ASSERT(frontier->size() == kNumNodes / stride);
+}
+
+void
+TestConvert() {
+  katana::Frontier<uint32_t> frontier(kNumNodes);
+  KATANA_LOG_ASSERT(frontier.empty());
+  KATANA_LOG_ASSERT(!frontier.IsDense());
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, uint32_t{kNumNodes}), [&](uint32_t n) {
+        if (n % 4 == 0) {
+          frontier.push(n);
+        }
+      });
+  CheckNodes(&frontier, 4);
+  KATANA_LOG_ASSERT(frontier.PrefersDense());
+
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(frontier.IsDense());
+  KATANA_LOG_ASSERT(frontier.test(8) && !frontier.test(9));
+  CheckNodes(&frontier, 4);
+
+  // dense frontiers hold a node once
+  frontier.push(8);
+  KATANA_LOG_ASSERT(frontier.size() == kNumNodes / 4);
+
+  frontier.ToSparse();
+  KATANA_LOG_ASSERT(!frontier.IsDense());
+  CheckNodes(&frontier, 4);
+
+  frontier.ToDense();
+  frontier.clear();
+  KATANA_LOG_ASSERT(frontier.IsDense());
+  KATANA_LOG_ASSERT(frontier.empty());
+  KATANA_LOG_ASSERT(!frontier.test(8));
+  frontier.push(kNumNodes - 1);
+  KATANA_LOG_ASSERT(!frontier.PrefersDense());
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(!frontier.IsDense());
+  KATANA_LOG_ASSERT(frontier.size() == 1);
+}
+
+// levels of a BFS of a complete binary tree, node n having children 2n + 1
+// and 2n + 2
+void
+TestRounds() {
+  auto current = std::make_unique<katana::Frontier<uint32_t>>(kNumNodes);
+  auto next = std::make_unique<katana::Frontier<uint32_t>>(kNumNodes);
+  next->push(0);
+  size_t num_rounds = 0;
+  size_t num_visited = 0;
+  bool was_dense = false;
+  while (!next->empty()) {
+    std::swap(current, next);
+    next->clear();
+    num_visited += current->size();
+    current->ForEach([&](uint32_t n) {
+      for (uint32_t child : {2 * n + 1, 2 * n + 2}) {
+        if (child < kNumNodes) {
+          next->push(child);
+        }
+      }
+    });
+    next->Adapt();
+    was_dense |= next->IsDense();
+    ++num_rounds;
+  }
+  KATANA_LOG_ASSERT(num_visited == kNumNodes);
+  KATANA_LOG_ASSERT(num_rounds == 17);
+  KATANA_LOG_ASSERT(was_dense);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  TestConvert();
+  TestRounds();
+
+  return 0;
+}
@@ -82,5 +82,34 @@ main() {
       "parse range", parseCPUList("     0-4   \n"),
       std::vector<int>{0, 1, 2, 3, 4});
 
+  // 2 sockets of 2 cores with 2 SMT contexts each, numbered like Linux does
+  std::vector<HWContext> contexts;
+  for (unsigned t = 0; t < 2; ++t) {
+    for (unsigned s = 0; s < 2; ++s) {
+      for (unsigned c = 0; c < 2; ++c) {
+        contexts.push_back(HWContext{t * 4 + s * 2 + c, s, c * 3});
+      }
+    }
+  }
+  auto placed = [&](ThreadPlacement placement, std::vector<int> cpuList = {}) {
+    std::vector<int> ids;
+    for (const auto& c : PlaceThreads(contexts, placement, cpuList)) {
+      ids.push_back(c.osContext);
+    }
+    return ids;
+  };
+  test(
+      "place cores", placed(ThreadPlacement::kCores),
+      std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7});
+  test(
+      "place compact", placed(ThreadPlacement::kCompact),
+      std::vector<int>{0, 4, 1, 5, 2, 6, 3, 7});
+  test(
+      "place scatter", placed(ThreadPlacement::kScatter),
+      std::vector<int>{0, 2, 1, 3, 4, 6, 5, 7});
+  test(
+      "place cpu list", placed(ThreadPlacement::kCPUList, {6, 1, 9, 1}),
+      std::vector<int>{6, 1});
+
   return 0;
 }
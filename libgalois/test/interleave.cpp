@@ -0,0 +1,105 @@
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+struct Node {
+  uint32_t next;
+  uint32_t value;
+};
+
+// Walks of kSteps links from each start, one link per step, with walks that
+// finish early pushing a second walk that starts where they ended
+struct Walk {
+  uint32_t at;
+  uint32_t hops_left;
+  bool pushed;
+};
+
+constexpr uint32_t kNumNodes = 1 << 16;
+constexpr uint32_t kSteps = 5;
+
+std::vector<Node>
+MakeList() {
+  std::vector<uint32_t> order(kNumNodes);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(24));
+
+  std::vector<Node> nodes(kNumNodes);
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    nodes[order[i]] = Node{order[(i + 1) % kNumNodes], order[i]};
+  }
+  return nodes;
+}
+
+uint64_t
+SerialSum(const std::vector<Node>& nodes, const std::vector<Walk>& walks) {
+  uint64_t sum = 0;
+  for (Walk w : walks) {
+    while (true) {
+      sum += nodes[w.at].value;
+      if (w.hops_left == 0) {
+        break;
+      }
+      w.at = nodes[w.at].next;
+      --w.hops_left;
+    }
+    if (!w.pushed && w.at % 2 == 0) {
+      sum += SerialSum(nodes, {Walk{w.at, kSteps, true}});
+    }
+  }
+  return sum;
+}
+
+template <unsigned N>
+void
+TestInterleave(const std::vector<Node>& nodes, const std::vector<Walk>& walks) {
+  std::atomic<uint64_t> sum{0};
+  katana::for_each(
+      katana::iterate(walks),
+      [&](Walk& w, unsigned& step, katana::UserContext<Walk>& ctx) {
+        ++step;
+        sum.fetch_add(nodes[w.at].value, std::memory_order_relaxed);
+        if (w.hops_left > 0) {
+          w.at = nodes[w.at].next;
+          --w.hops_left;
+          katana::prefetch(&nodes[w.at]);
+          return false;
+        }
+        KATANA_LOG_ASSERT(step == kSteps + 1);
+        if (!w.pushed && w.at % 2 == 0) {
+          ctx.push(Walk{w.at, kSteps, true});
+        }
+        return true;
+      },
+      katana::interleave<N>(), katana::disable_conflict_detection(),
+      katana::loopname("interleave"));
+
+  KATANA_LOG_ASSERT(sum == SerialSum(nodes, walks));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(4);
+
+  std::vector<Node> nodes = MakeList();
+  std::vector<Walk> walks;
+  for (uint32_t i = 0; i < kNumNodes; i += 7) {
+    walks.emplace_back(Walk{i, kSteps, false});
+  }
+
+  TestInterleave<1>(nodes, walks);
+  TestInterleave<8>(nodes, walks);
+  TestInterleave<64>(nodes, walks);
+
+  return 0;
+}
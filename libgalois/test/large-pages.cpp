@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PageAlloc.h"
+
+namespace {
+
+size_t
+TotalLargePageBytes() {
+  size_t total = 0;
+  for (auto kind :
+       {katana::LargePageKind::kHuge1G, katana::LargePageKind::kHuge2M,
+        katana::LargePageKind::kTransparent, katana::LargePageKind::kNone}) {
+    total += katana::numLargePageBytes(kind);
+  }
+  return total;
+}
+
+template <typename Allocate>
+void
+TestAllocate(Allocate allocate) {
+  constexpr size_t kNum = (3 << 20) + 5;
+  size_t before = TotalLargePageBytes();
+  size_t transparent_before =
+      katana::numLargePageBytes(katana::LargePageKind::kTransparent);
+
+  katana::NUMAArray<uint64_t> array;
+  allocate(&array, kNum);
+  katana::do_all(katana::iterate(size_t{0}, kNum), [&](size_t i) {
+    array[i] = i;
+  });
+  for (size_t i = 0; i < kNum; i += 4099) {
+    KATANA_LOG_ASSERT(array[i] == i);
+  }
+
+  // with thp configured, transparent huge pages always work
+  size_t after = TotalLargePageBytes();
+  KATANA_LOG_ASSERT(after - before >= kNum * sizeof(uint64_t));
+  KATANA_LOG_ASSERT(
+      katana::numLargePageBytes(katana::LargePageKind::kTransparent) -
+          transparent_before ==
+      after - before);
+}
+
+}  // namespace
+
+int
+main() {
+  setenv("KATANA_LARGE_PAGES", "thp", 1);
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  KATANA_LOG_ASSERT(
+      katana::GetLargePageKind() == katana::LargePageKind::kTransparent);
+  KATANA_LOG_ASSERT(
+      std::string(katana::LargePageKindName(katana::GetLargePageKind())) ==
+      "thp");
+
+  TestAllocate([](auto* a, size_t n) { a->allocateInterleaved(n); });
+  TestAllocate([](auto* a, size_t n) { a->allocateBlocked(n); });
+  TestAllocate([](auto* a, size_t n) { a->allocateLocal(n); });
+  TestAllocate([](auto* a, size_t n) { a->allocateFloating(n); });
+
+  return 0;
+}
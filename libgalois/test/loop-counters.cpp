@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#include "katana/Env.h"
+#include "katana/Galois.h"
+#include "katana/LoopCounters.h"
+#include "katana/Logging.h"
+
+namespace {
+
+const char* const kCounters[] = {
+    "Cycles", "LLCMisses", "BranchMisses", "RemoteNUMAAccesses"};
+
+std::string
+StatPath() {
+  return (std::filesystem::temp_directory_path() /
+          ("loop-counters-" + std::to_string(getpid()) + ".csv"))
+      .string();
+}
+
+/// Whether this process may count its own cycles, as the loops would
+bool
+CanCountCycles() {
+#ifdef __linux__
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CPU_CYCLES;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0) {
+    return false;
+  }
+  close(fd);
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// The totals of the stats printed to StatPath, by region and category
+std::map<std::pair<std::string, std::string>, int64_t>
+ReadStats() {
+  std::map<std::pair<std::string, std::string>, int64_t> stats;
+  std::ifstream file(StatPath());
+  std::string line;
+  while (std::getline(file, line)) {
+    // STAT, region, category, total type, total
+    std::string fields[5];
+    size_t begin = 0;
+    for (size_t f = 0; f < 5 && begin <= line.size(); ++f) {
+      size_t end = std::min(line.find(", ", begin), line.size());
+      fields[f] = line.substr(begin, end - begin);
+      begin = end + 2;
+    }
+    if (fields[0] == "STAT" && fields[3] == "TSUM") {
+      stats[{fields[1], fields[2]}] = std::stoll(fields[4]);
+    }
+  }
+  return stats;
+}
+
+void
+TestIsCounted() {
+  KATANA_LOG_ASSERT(katana::internal::IsCounted("counted"));
+  KATANA_LOG_ASSERT(katana::internal::IsCounted("counted_for_each"));
+  KATANA_LOG_ASSERT(!katana::internal::IsCounted("uncounted"));
+  // names are matched whole
+  KATANA_LOG_ASSERT(!katana::internal::IsCounted("count"));
+  KATANA_LOG_ASSERT(!katana::internal::IsCounted(""));
+  KATANA_LOG_ASSERT(!katana::internal::IsCounted(nullptr));
+}
+
+void
+Run() {
+  constexpr uint64_t kNum = 1 << 18;
+
+  std::atomic<uint64_t> sum{0};
+  auto work = [&](uint64_t n) {
+    sum.fetch_add(n % 7, std::memory_order_relaxed);
+  };
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), work, katana::loopname("counted"));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), work,
+      katana::loopname("uncounted"));
+  katana::for_each(
+      katana::iterate(uint64_t{0}, kNum), [&](uint64_t n, auto&) { work(n); },
+      katana::disable_conflict_detection(), katana::no_pushes(),
+      katana::loopname("counted_for_each"));
+  katana::PrintStats();
+}
+
+void
+CheckStats(bool can_count) {
+  auto stats = ReadStats();
+  for (const char* counter : kCounters) {
+    KATANA_LOG_VASSERT(
+        stats.count({"uncounted", counter}) == 0,
+        "{} counted for a loop that is not", counter);
+    // the same events are supported in every loop
+    KATANA_LOG_ASSERT(
+        stats.count({"counted", counter}) ==
+        stats.count({"counted_for_each", counter}));
+  }
+  if (can_count) {
+    auto cycles = stats.find({"counted", "Cycles"});
+    KATANA_LOG_ASSERT(cycles != stats.end());
+    KATANA_LOG_ASSERT(cycles->second > 0);
+    KATANA_LOG_ASSERT(stats[{"counted_for_each", "Cycles"}] > 0);
+  } else {
+    katana::gPrint("hardware counters are unavailable; not checking counts\n");
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SetEnv("KATANA_LOOP_COUNTERS", "counted,counted_for_each", true);
+
+  {
+    katana::GaloisRuntime Katana_runtime;
+    katana::setActiveThreads(4);
+    katana::SetStatFile(StatPath());
+
+    TestIsCounted();
+    Run();
+  }
+
+  CheckStats(CanCountCycles());
+  std::filesystem::remove(StatPath());
+  return 0;
+}
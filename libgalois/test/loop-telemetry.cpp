@@ -0,0 +1,82 @@
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "katana/Env.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+std::string
+TimelinePath() {
+  return (std::filesystem::temp_directory_path() /
+          ("loop-telemetry-" + std::to_string(getpid()) + ".json"))
+      .string();
+}
+
+size_t
+CountEvents(const std::string& name, const std::string& phase) {
+  std::ifstream file(TimelinePath());
+  std::string line;
+  std::getline(file, line);
+  KATANA_LOG_ASSERT(line == "[");
+
+  size_t count = 0;
+  while (std::getline(file, line)) {
+    if (line.find("\"name\":\"" + name + "\"") != std::string::npos &&
+        line.find("\"ph\":\"" + phase + "\"") != std::string::npos) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void
+Run() {
+  constexpr uint64_t kNum = 1 << 16;
+
+  std::atomic<uint64_t> sum{0};
+  // most of the work is at the start of the range, so threads steal
+  auto skewed = [&](uint64_t n) {
+    uint64_t spins = n < kNum / 8 ? 100 : 1;
+    for (uint64_t i = 0; i < spins; ++i) {
+      sum.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), skewed, katana::steal(),
+      katana::loopname("timeline"));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNum), skewed, katana::loopname("quiet"));
+  katana::for_each(
+      katana::iterate(uint64_t{0}, kNum),
+      [&](uint64_t n, auto&) { skewed(n); },
+      katana::disable_conflict_detection(), katana::no_pushes(),
+      katana::loopname("timeline_for_each"));
+
+  KATANA_LOG_ASSERT(CountEvents("timeline", "X") > 0);
+  KATANA_LOG_ASSERT(CountEvents("timeline_for_each", "X") > 0);
+  KATANA_LOG_ASSERT(CountEvents("quiet", "X") == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SetEnv("KATANA_LOOP_TIMELINE", "timeline,timeline_for_each", true);
+  katana::SetEnv("KATANA_LOOP_TIMELINE_FILE", TimelinePath(), true);
+
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(4);
+
+  Run();
+
+  std::filesystem::remove(TimelinePath());
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "katana/Logging.h"
+#include "katana/MemoryPolicy.h"
+#include "katana/TextTracer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr katana::count_t kMiB = 1 << 20;
+
+void
+WriteFile(const fs::path& path, const std::string& contents) {
+  std::ofstream file(path);
+  file << contents;
+  KATANA_LOG_ASSERT(file.good());
+}
+
+/// A cgroup that may use 1000 MiB, uses 900 MiB of which 100 MiB are inactive
+/// page cache, and stalls stall_percent of the time
+void
+MakeCgroup(const fs::path& dir, const std::string& stall_percent) {
+  fs::create_directories(dir);
+  WriteFile(dir / "memory.max", std::to_string(1000 * kMiB) + "\n");
+  WriteFile(dir / "memory.current", std::to_string(900 * kMiB) + "\n");
+  WriteFile(
+      dir / "memory.stat", "anon " + std::to_string(700 * kMiB) +
+                               "\ninactive_file " +
+                               std::to_string(100 * kMiB) + "\n");
+  WriteFile(
+      dir / "memory.pressure", "some avg10=" + stall_percent +
+                                   " avg60=0.00 avg300=0.00 total=0\n"
+                                   "full avg10=0.00 avg60=0.00 avg300=0.00 "
+                                   "total=0\n");
+}
+
+void
+TestNoLimit(const fs::path& dir) {
+  fs::create_directories(dir);
+  WriteFile(dir / "memory.max", "max\n");
+  KATANA_LOG_ASSERT(!katana::MemoryPolicyCgroup::Make(dir.string()));
+}
+
+void
+TestLimit(const fs::path& dir) {
+  MakeCgroup(dir, "0.00");
+  auto res = katana::MemoryPolicyCgroup::Make(dir.string());
+  KATANA_LOG_ASSERT(res);
+  auto policy = std::move(res.value());
+
+  auto info = policy->ReadCgroupInfo();
+  KATANA_LOG_ASSERT(info.limit == 1000 * kMiB);
+  KATANA_LOG_ASSERT(info.working_set == 800 * kMiB);
+
+  // 800 MiB of 1000 MiB is below the high threshold
+  KATANA_LOG_ASSERT(!policy->MemoryPressureHigh(0, 0));
+  KATANA_LOG_ASSERT(policy->ReclaimForMemoryPressure(0, 500 * kMiB) == 0);
+  KATANA_LOG_ASSERT(!policy->KillSelfForLackOfMemory(0, 0));
+
+  // allocating 150 MiB goes 100 MiB over the high threshold
+  KATANA_LOG_ASSERT(
+      policy->ReclaimForAllocation(0, 500 * kMiB, 10 * kMiB) == 0);
+  KATANA_LOG_ASSERT(
+      policy->ReclaimForAllocation(0, 500 * kMiB, 150 * kMiB) == 100 * kMiB);
+  // but we cannot reclaim more than we have on standby
+  KATANA_LOG_ASSERT(
+      policy->ReclaimForAllocation(0, 20 * kMiB, 150 * kMiB) == 20 * kMiB);
+
+  // a parent with a lower limit limits its children
+  WriteFile(dir.parent_path() / "memory.max", std::to_string(820 * kMiB));
+  auto nested = katana::MemoryPolicyCgroup::Make(dir.string());
+  KATANA_LOG_ASSERT(nested);
+  KATANA_LOG_ASSERT(nested.value()->ReadCgroupInfo().limit == 820 * kMiB);
+  KATANA_LOG_ASSERT(nested.value()->KillSelfForLackOfMemory(0, 0));
+  fs::remove(dir.parent_path() / "memory.max");
+}
+
+void
+TestPressure(const fs::path& dir) {
+  MakeCgroup(dir, "25.00");
+  auto res = katana::MemoryPolicyCgroup::Make(dir.string());
+  KATANA_LOG_ASSERT(res);
+  auto policy = std::move(res.value());
+
+  // stalls make pressure high even though there is room below the limit
+  KATANA_LOG_ASSERT(policy->MemoryPressureHigh(0, 0));
+  KATANA_LOG_ASSERT(
+      policy->ReclaimForMemoryPressure(0, 500 * kMiB) == 250 * kMiB);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::ProgressTracer::Set(katana::TextTracer::Make());
+  fs::path dir = fs::temp_directory_path() /
+                 ("memory-policy-cgroup-" + std::to_string(getpid()));
+
+  TestNoLimit(dir / "unlimited");
+  TestLimit(dir / "parent" / "limited");
+  TestPressure(dir / "pressure");
+
+  fs::remove_all(dir);
+  return 0;
+}
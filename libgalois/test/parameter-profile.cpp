@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/JSONTracer.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+// Nodes of a complete binary tree, each pushing its children, so that each
+// round of ParaMeter visits one level
+constexpr uint32_t kDepth = 10;
+constexpr uint32_t kNumNodes = (1 << kDepth) - 1;
+
+std::vector<std::string> lines;
+
+size_t
+CountLines(const std::string& needle) {
+  size_t count = 0;
+  for (const std::string& line : lines) {
+    if (line.find(needle) != std::string::npos) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+uint64_t
+VisitTree(const char* name) {
+  katana::GAccumulator<uint64_t> visited;
+  katana::for_each(
+      katana::iterate({uint32_t{0}}),
+      [&](uint32_t node, auto& ctx) {
+        visited += 1;
+        for (uint32_t child : {2 * node + 1, 2 * node + 2}) {
+          if (child < kNumNodes) {
+            ctx.push(child);
+          }
+        }
+      },
+      katana::loopname(name), katana::disable_conflict_detection());
+  return visited.reduce();
+}
+
+void
+TestSelectedLoops() {
+  // loops run the same whether profiled or not
+  KATANA_LOG_ASSERT(VisitTree("Tree") == kNumNodes);
+  KATANA_LOG_ASSERT(CountLines("parameter round") == kDepth);
+  KATANA_LOG_ASSERT(CountLines("parameter profile") == 1);
+  KATANA_LOG_ASSERT(CountLines(R"({"name":"rounds","value":10})") == 1);
+  KATANA_LOG_ASSERT(CountLines(R"({"name":"loopname","value":"Tree"})") == 11);
+
+  lines.clear();
+  KATANA_LOG_ASSERT(VisitTree("NotProfiled") == kNumNodes);
+  KATANA_LOG_ASSERT(CountLines("parameter") == 0);
+}
+
+void
+TestConflicts() {
+  // every iteration writes the same lock, so one commits per round and the
+  // rest abort and retry
+  constexpr uint32_t kNum = 8;
+  katana::Lockable lock;
+  katana::GAccumulator<uint64_t> committed;
+
+  lines.clear();
+  katana::for_each(
+      katana::iterate(uint32_t{0}, kNum),
+      [&](uint32_t, auto&) {
+        katana::acquire(&lock, katana::MethodFlag::WRITE);
+        committed += 1;
+      },
+      katana::loopname("Conflicts"));
+
+  KATANA_LOG_ASSERT(committed.reduce() == kNum);
+  KATANA_LOG_ASSERT(CountLines("parameter round") == kNum);
+  KATANA_LOG_ASSERT(
+      CountLines(R"({"name":"conflicts","value":28})") == 1);  // 7 + ... + 1
+  KATANA_LOG_ASSERT(CountLines(R"({"name":"max_parallelism","value":1})") == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  setenv("KATANA_PARAMETER_LOOPS", "Tree,Conflicts", 1);
+  katana::ProgressTracer::Set(katana::JSONTracer::Make(
+      0, 1, [](const std::string& line) { lines.emplace_back(line); }));
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  TestSelectedLoops();
+  TestConflicts();
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "katana/Env.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PhaseSampler.h"
+#include "katana/Timer.h"
+
+namespace {
+
+std::string
+SamplesPath() {
+  return (std::filesystem::temp_directory_path() /
+          ("phase-sampler-" + std::to_string(getpid()) + ".folded"))
+      .string();
+}
+
+uint64_t
+CountSamples(const std::string& folded) {
+  for (const auto& [stack, count] : katana::internal::FoldedPhaseSamples()) {
+    if (stack == folded) {
+      return count;
+    }
+  }
+  return 0;
+}
+
+void
+Run() {
+  KATANA_LOG_ASSERT(katana::internal::SamplingPhases());
+
+  std::atomic<uint64_t> sum{0};
+  auto spin = [&](uint64_t) {
+    for (int i = 0; i < 1000; ++i) {
+      sum.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  // time is sampled whichever thread runs, so a few loops are enough
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+  katana::StatTimer outer("Outer");
+  outer.start();
+  while (CountSamples("Outer;spin") == 0) {
+    KATANA_LOG_ASSERT(std::chrono::steady_clock::now() < deadline);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{1} << 16), spin,
+        katana::loopname("spin"));
+  }
+  {
+    katana::PhaseScope scope("Scoped");
+    while (CountSamples("Outer;Scoped") == 0) {
+      KATANA_LOG_ASSERT(std::chrono::steady_clock::now() < deadline);
+      spin(0);
+    }
+  }
+  outer.stop();
+
+  // samples are only counted for the phases that were running
+  KATANA_LOG_ASSERT(CountSamples("Outer;Scoped;spin") == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SetEnv("KATANA_PROFILE_PHASES", SamplesPath(), true);
+
+  {
+    katana::GaloisRuntime Katana_runtime;
+    katana::setActiveThreads(4);
+
+    Run();
+  }
+
+  KATANA_LOG_ASSERT(!katana::internal::SamplingPhases());
+  std::ifstream file(SamplesPath());
+  std::string line;
+  bool found = false;
+  while (std::getline(file, line)) {
+    found = found || line.rfind("Outer;spin ", 0) == 0;
+  }
+  KATANA_LOG_ASSERT(found);
+
+  std::filesystem::remove(SamplesPath());
+  return 0;
+}
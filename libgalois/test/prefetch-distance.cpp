@@ -0,0 +1,50 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNum = 100000;
+
+template <typename... Args>
+void
+TestPrefetchDistance(Args&&... args) {
+  std::vector<uint32_t> next(kNum);
+  for (uint32_t i = 0; i < kNum; ++i) {
+    next[i] = (i * 7919) % kNum;
+  }
+  std::vector<uint32_t> out(kNum);
+  std::atomic<uint64_t> prefetched{0};
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNum),
+      [&](uint32_t i) { out[i] = next[next[i]]; },
+      katana::prefetch_distance<4>([&](uint32_t i) {
+        prefetched.fetch_add(1, std::memory_order_relaxed);
+        return &next[next[i]];
+      }),
+      std::forward<Args>(args)...);
+
+  // every item is prefetched for once, however the range is split up
+  KATANA_LOG_ASSERT(prefetched == kNum);
+  for (uint32_t i = 0; i < kNum; ++i) {
+    KATANA_LOG_ASSERT(out[i] == next[next[i]]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(4);
+
+  TestPrefetchDistance(katana::loopname("no-steal"));
+  TestPrefetchDistance(
+      katana::steal(), katana::chunk_size<3>(), katana::loopname("steal"));
+
+  return 0;
+}
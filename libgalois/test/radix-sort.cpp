@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/RadixSort.h"
+
+namespace {
+
+void
+TestRadixSortPairs(size_t size, uint32_t max_key) {
+  std::mt19937 gen{static_cast<uint32_t>(size)};
+  std::uniform_int_distribution<uint32_t> dist{0, max_key};
+
+  std::vector<uint32_t> keys(size);
+  std::vector<uint64_t> values(size);
+  std::vector<std::pair<uint32_t, uint64_t>> expected(size);
+  for (size_t i = 0; i < size; ++i) {
+    keys[i] = dist(gen);
+    values[i] = i;
+    expected[i] = {keys[i], i};
+  }
+  std::stable_sort(
+      expected.begin(), expected.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<uint32_t> key_scratch(size);
+  std::vector<uint64_t> value_scratch(size);
+  katana::RadixSortPairs(
+      keys.data(), values.data(), size, key_scratch.data(),
+      value_scratch.data());
+
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_VASSERT(
+        keys[i] == expected[i].first && values[i] == expected[i].second,
+        "at index {}: ({}, {}) != ({}, {})", i, keys[i], values[i],
+        expected[i].first, expected[i].second);
+  }
+}
+
+void
+TestParallelRadixSortByKey(size_t size, uint64_t max_key) {
+  std::mt19937_64 gen{size};
+  std::uniform_int_distribution<uint64_t> dist{0, max_key};
+
+  // Sort indices by a key so that stability can be checked on the indices
+  std::vector<uint64_t> keys(size);
+  std::vector<uint64_t> indices(size);
+  for (size_t i = 0; i < size; ++i) {
+    keys[i] = dist(gen);
+    indices[i] = i;
+  }
+  std::vector<uint64_t> expected = indices;
+  std::stable_sort(
+      expected.begin(), expected.end(),
+      [&](uint64_t a, uint64_t b) { return keys[a] < keys[b]; });
+
+  katana::ParallelRadixSortByKey(
+      indices.data(), indices.size(), [&](uint64_t i) { return keys[i]; },
+      max_key);
+
+  KATANA_LOG_ASSERT(indices == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+
+  for (size_t size : {0, 1, 2, 255, 256, 10000}) {
+    for (uint32_t max_key : {0u, 1u, 255u, 256u, 70000u, 0xffffffffu}) {
+      TestRadixSortPairs(size, max_key);
+    }
+  }
+
+  for (unsigned num_threads : {1u, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(num_threads);
+    for (size_t size : {0, 1, 1000, 1 << 20}) {
+      for (uint64_t max_key : {uint64_t{0}, uint64_t{255}, uint64_t{1} << 40}) {
+        TestParallelRadixSortByKey(size, max_key);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <map>
 
 #include "katana/Galois.h"
 
@@ -86,6 +87,77 @@ test_accum() {
   KATANA_LOG_ASSERT(accum.reduce() == num);
 }
 
+void
+test_reduce_parallel() {
+  using Map = std::map<int, int>;
+
+  auto reduce = [](Map& a, Map&& b) -> Map& {
+    for (auto& kv : b) {
+      a[kv.first] += kv.second;
+    }
+    return a;
+  };
+
+  auto r = katana::make_reducible(reduce, []() { return Map(); });
+
+  constexpr int num = 1000;
+
+  // odd numbers of threads leave a thread without a partner in the tree
+  for (unsigned threads : {1, 3, 2}) {
+    katana::setActiveThreads(threads);
+    katana::do_all(
+        katana::iterate(0, num), [&](int i) { r.update(Map{{i % 10, 1}}); });
+
+    Map& result = r.reduce_parallel();
+    KATANA_LOG_ASSERT(result.size() == 10);
+    for (auto& kv : result) {
+      KATANA_LOG_ASSERT(kv.second == num / 10);
+    }
+    r.reset();
+  }
+}
+
+void
+test_array_accum() {
+  katana::GArrayAccumulator<uint64_t, 3> accum;
+
+  constexpr int num = 3000;
+
+  katana::do_all(katana::iterate(0, num), [&](int i) {
+    accum.update(0, 1);
+    accum.update(i % 2 + 1, i);
+  });
+
+  auto& result = accum.reduce();
+  KATANA_LOG_ASSERT(result[0] == num);
+  KATANA_LOG_ASSERT(result[1] + result[2] == uint64_t{num} * (num - 1) / 2);
+
+  accum.reset();
+  KATANA_LOG_ASSERT(accum.reduce()[0] == 0);
+}
+
+void
+test_vector_accum() {
+  constexpr int num = 10000;
+  constexpr size_t buckets = 7;
+
+  katana::GVectorAccumulator<int> histogram(buckets);
+  KATANA_LOG_ASSERT(histogram.size() == buckets);
+
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(katana::iterate(0, num), [&](int i) {
+      histogram.update(i % buckets, 1);
+    });
+
+    std::vector<int>& result = histogram.reduce();
+    for (size_t b = 0; b < buckets; ++b) {
+      int expected = num / buckets + (b < num % buckets ? 1 : 0);
+      KATANA_LOG_ASSERT(result[b] == expected);
+    }
+    histogram.reset();
+  }
+}
+
 int
 main() {
   katana::GaloisRuntime sys;
@@ -99,6 +171,9 @@ main() {
   test_move();
   test_max();
   test_accum();
+  test_reduce_parallel();
+  test_array_accum();
+  test_vector_accum();
 
   return 0;
 }
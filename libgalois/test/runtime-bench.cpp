@@ -0,0 +1,236 @@
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/HWTopo.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Threads.h"
+#include "katana/Traits.h"
+
+// Microbenchmarks of the runtime primitives that the loops of applications are
+// made of: worklists, per-thread bags, reducers and per-thread storage. Each
+// benchmark takes the number of threads as its first argument so that the
+// results show how the primitive scales. Compare runs with, e.g.,
+//
+//   runtime-bench --benchmark_filter=Obim --benchmark_format=json
+
+namespace {
+
+/// Powers of two up to the number of hardware threads, and that number itself.
+/// Benchmarks are registered before the runtime, and its thread pool, exist.
+void
+MakeThreadArguments(benchmark::internal::Benchmark* b, long size) {
+  const long max_threads = katana::getHWTopo().machineTopoInfo.maxThreads;
+  for (long threads = 1; threads < max_threads; threads *= 2) {
+    b->Args({threads, size});
+  }
+  b->Args({max_threads, size});
+}
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  MakeThreadArguments(b, 1024 * 1024);
+}
+
+void
+MakeMergeArguments(benchmark::internal::Benchmark* b) {
+  for (long size : {1024, 64 * 1024}) {
+    MakeThreadArguments(b, size);
+  }
+}
+
+void
+SetThreads(benchmark::State& state) {
+  long threads = state.range(0);
+  if (static_cast<long>(katana::setActiveThreads(threads)) != threads) {
+    state.SkipWithError("could not activate enough threads");
+  }
+}
+
+/// Runs a for_each over size items with worklist WL where every item less than
+/// size pushes one more, so that half the items processed come from pushes
+template <typename WL, typename... Args>
+void
+RunWorklist(benchmark::State& state, Args&&... wl_args) {
+  SetThreads(state);
+  const uint64_t size = state.range(1);
+
+  katana::GAccumulator<uint64_t> processed;
+  for (auto _ : state) {
+    processed.reset();
+    katana::for_each(
+        katana::iterate(uint64_t{0}, size),
+        [&](uint64_t n, auto& ctx) {
+          processed += 1;
+          if (n < size) {
+            ctx.push(n + size);
+          }
+        },
+        katana::wl<WL>(std::forward<Args>(wl_args)...),
+        katana::disable_conflict_detection(), katana::no_stats());
+  }
+
+  KATANA_LOG_ASSERT(processed.reduce() == 2 * size);
+  state.SetItemsProcessed(state.iterations() * 2 * size);
+}
+
+void
+ChunkFIFO(benchmark::State& state) {
+  RunWorklist<katana::PerThreadChunkFIFO<64>>(state);
+}
+
+void
+ChunkLIFO(benchmark::State& state) {
+  RunWorklist<katana::PerThreadChunkLIFO<64>>(state);
+}
+
+void
+Obim(benchmark::State& state) {
+  // a few hundred priorities, like a delta-stepping SSSP on a small graph
+  auto indexer = [](uint64_t n) { return n / 4096; };
+  using OBIM = katana::OrderedByIntegerMetric<
+      decltype(indexer), katana::PerSocketChunkFIFO<64>>;
+  RunWorklist<OBIM>(state, indexer);
+}
+
+void
+InsertBagPush(benchmark::State& state) {
+  SetThreads(state);
+  const uint64_t size = state.range(1);
+
+  for (auto _ : state) {
+    katana::InsertBag<uint64_t> bag;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size), [&](uint64_t n) { bag.push(n); },
+        katana::no_stats());
+    benchmark::DoNotOptimize(bag.begin());
+  }
+
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void
+InsertBagIterate(benchmark::State& state) {
+  SetThreads(state);
+  const uint64_t size = state.range(1);
+
+  katana::InsertBag<uint64_t> bag;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size), [&](uint64_t n) { bag.push(n); });
+
+  katana::GAccumulator<uint64_t> sum;
+  for (auto _ : state) {
+    sum.reset();
+    katana::do_all(
+        katana::iterate(bag), [&](uint64_t n) { sum += n; },
+        katana::no_stats());
+  }
+
+  KATANA_LOG_ASSERT(sum.reduce() == size * (size - 1) / 2);
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void
+AccumulatorUpdate(benchmark::State& state) {
+  SetThreads(state);
+  const uint64_t size = state.range(1);
+
+  katana::GAccumulator<uint64_t> sum;
+  for (auto _ : state) {
+    sum.reset();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size), [&](uint64_t n) { sum += n; },
+        katana::no_stats());
+    benchmark::DoNotOptimize(sum.reduce());
+  }
+
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+/// The cost of merging the per-thread values of a reducer of vectors, which
+/// grows with both the number of threads and the size of the vectors
+void
+AccumulatorMerge(benchmark::State& state) {
+  SetThreads(state);
+  const size_t size = state.range(1);
+
+  katana::GVectorAccumulator<uint64_t> histogram(size);
+  for (auto _ : state) {
+    state.PauseTiming();
+    katana::on_each([&](unsigned tid, unsigned) {
+      for (size_t i = 0; i < size; ++i) {
+        histogram.update(i, tid);
+      }
+    });
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(histogram.reduce().data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * size * state.range(0));
+}
+
+void
+PerThreadStorageLocal(benchmark::State& state) {
+  SetThreads(state);
+  const uint64_t size = state.range(1);
+
+  katana::PerThreadStorage<uint64_t> counters;
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, size),
+        [&](uint64_t n) { *counters.getLocal() += n; }, katana::no_stats());
+  }
+
+  uint64_t total = 0;
+  for (unsigned i = 0; i < counters.size(); ++i) {
+    total += *counters.getRemote(i);
+  }
+  benchmark::DoNotOptimize(total);
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+/// Every thread reads the values of all the other threads, as serial reducers
+/// do, which is mostly the cost of moving cache lines between cores
+void
+PerThreadStorageRemote(benchmark::State& state) {
+  SetThreads(state);
+  const uint64_t rounds = state.range(1) / katana::getActiveThreads();
+
+  katana::PerThreadStorage<uint64_t> counters;
+  for (auto _ : state) {
+    katana::on_each([&](unsigned tid, unsigned num) {
+      uint64_t total = 0;
+      for (uint64_t r = 0; r < rounds; ++r) {
+        *counters.getLocal() += 1;
+        total += *counters.getRemote((tid + r) % num);
+      }
+      benchmark::DoNotOptimize(total);
+    });
+  }
+
+  state.SetItemsProcessed(
+      state.iterations() * rounds * katana::getActiveThreads());
+}
+
+BENCHMARK(ChunkFIFO)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(ChunkLIFO)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(Obim)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(InsertBagPush)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(InsertBagIterate)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(AccumulatorUpdate)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(AccumulatorMerge)->Apply(MakeMergeArguments)->UseRealTime();
+BENCHMARK(PerThreadStorageLocal)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(PerThreadStorageRemote)->Apply(MakeArguments)->UseRealTime();
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::GaloisRuntime G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
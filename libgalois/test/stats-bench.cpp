@@ -0,0 +1,83 @@
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Galois.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+
+namespace {
+
+// Overhead of recording loop stats: do_all loops short enough that the stats
+// every thread reports at their end dominate, with and without no_stats
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long threads : {1, 4}) {
+    b->Args({threads});
+  }
+}
+
+template <typename... Args>
+void
+RunShortDoAll(std::vector<int>& output, Args&&... args) {
+  katana::do_all(
+      katana::iterate(size_t{0}, output.size()), [&](size_t i) { ++output[i]; },
+      katana::loopname("StatsBench"), std::forward<Args>(args)...);
+}
+
+void
+DoAllNoStats(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  std::vector<int> output(1024);
+
+  for (auto _ : state) {
+    RunShortDoAll(output, katana::no_stats());
+  }
+}
+
+void
+DoAllStats(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  std::vector<int> output(1024);
+
+  for (auto _ : state) {
+    RunShortDoAll(output);
+  }
+}
+
+// stealing loops also report their steals
+void
+DoAllStealStats(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  std::vector<int> output(1024);
+
+  for (auto _ : state) {
+    RunShortDoAll(output, katana::steal());
+  }
+}
+
+void
+ReportStatSum(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+
+  for (auto _ : state) {
+    katana::on_each([](unsigned, unsigned) {
+      katana::ReportStatSum("StatsBench", "ReportStatSum", 1);
+    });
+  }
+}
+
+BENCHMARK(DoAllNoStats)->Apply(MakeArguments);
+BENCHMARK(DoAllStats)->Apply(MakeArguments);
+BENCHMARK(DoAllStealStats)->Apply(MakeArguments);
+BENCHMARK(ReportStatSum)->Apply(MakeArguments);
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::GaloisRuntime G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
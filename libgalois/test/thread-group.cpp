@@ -0,0 +1,145 @@
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/ThreadGroup.h"
+
+namespace {
+
+constexpr uint64_t kItems = 1 << 16;
+
+/// Run the kinds of loops an analytic runs and check that they use the
+/// threads of the group only
+void
+RunLoops(katana::ThreadGroupLease* lease) {
+  lease->Run([&]() {
+    unsigned num = katana::getActiveThreads();
+    KATANA_LOG_ASSERT(num == lease->size());
+    KATANA_LOG_ASSERT(katana::GetThreadPool().getMaxUsableThreads() == num);
+
+    std::atomic<unsigned> seen{0};
+    katana::on_each([&](unsigned tid, unsigned total) {
+      KATANA_LOG_ASSERT(total == num && tid < num);
+      KATANA_LOG_ASSERT(katana::ThreadPool::getTID() == tid);
+      seen.fetch_or(1U << (tid % 32));
+    });
+    KATANA_LOG_ASSERT(seen == (num >= 32 ? ~0U : (1U << num) - 1));
+
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kItems), [&](uint64_t i) { sum += i; },
+        katana::steal());
+    KATANA_LOG_ASSERT(sum.reduce() == kItems * (kItems - 1) / 2);
+
+    // for_each needs the termination detection of the group
+    katana::GAccumulator<uint64_t> pushed;
+    katana::for_each(
+        katana::iterate({uint64_t{1}}),
+        [&](uint64_t i, auto& ctx) {
+          pushed += 1;
+          if (i < kItems) {
+            ctx.push(2 * i);
+            ctx.push(2 * i + 1);
+          }
+        },
+        katana::no_conflicts());
+    KATANA_LOG_ASSERT(pushed.reduce() == 2 * kItems - 1);
+
+    katana::InsertBag<uint64_t> bag;
+    katana::do_all(katana::iterate(uint64_t{0}, kItems), [&](uint64_t i) {
+      bag.push(i);
+    });
+    KATANA_LOG_ASSERT(bag.size() == kItems);
+
+    // storage has an object for every thread of the pool whichever group
+    // asks, and every id below that names an object of its own
+    unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+    katana::PerThreadStorage<uint64_t> counts(0);
+    KATANA_LOG_ASSERT(counts.size() == max_threads);
+    KATANA_LOG_ASSERT(counts.groupSize() == num);
+    std::set<uint64_t*> objects;
+    for (unsigned t = 0; t < counts.size(); ++t) {
+      objects.emplace(counts.getRemote(t));
+    }
+    KATANA_LOG_ASSERT(objects.size() == max_threads);
+    katana::on_each([&](unsigned tid, unsigned) {
+      KATANA_LOG_ASSERT(counts.getLocal() == counts.getRemote(tid));
+      *counts.getLocal() += tid + 1;
+    });
+    uint64_t total = 0;
+    for (unsigned t = 0; t < counts.size(); ++t) {
+      total += *counts.getRemote(t);
+    }
+    KATANA_LOG_ASSERT(total == uint64_t{num} * (num + 1) / 2);
+  });
+}
+
+/// Two groups run loops at the same time, next to loops outside of groups
+void
+TestConcurrent(unsigned group_size) {
+  auto first = katana::LeaseThreadGroup(group_size);
+  KATANA_LOG_VASSERT(first, "{}", first.error());
+  auto second = katana::LeaseThreadGroup(group_size);
+  KATANA_LOG_VASSERT(second, "{}", second.error());
+  KATANA_LOG_ASSERT(first.value().size() == group_size);
+  KATANA_LOG_ASSERT(second.value().size() == group_size);
+
+  std::thread other([&]() {
+    for (int round = 0; round < 10; ++round) {
+      RunLoops(&second.value());
+    }
+  });
+  for (int round = 0; round < 10; ++round) {
+    RunLoops(&first.value());
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kItems), [&](uint64_t i) { sum += i; });
+    KATANA_LOG_ASSERT(sum.reduce() == kItems * (kItems - 1) / 2);
+  }
+  other.join();
+}
+
+/// Loops outside of groups cannot take the leased threads, and the threads
+/// return to the pool with their lease
+void
+TestDefaultThreads(unsigned group_size) {
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+  {
+    auto lease = katana::LeaseThreadGroup(group_size);
+    KATANA_LOG_VASSERT(lease, "{}", lease.error());
+    KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) < max_threads);
+    katana::setActiveThreads(1);
+  }
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == max_threads);
+
+  // every thread runs loops outside of groups, so there are none to lease
+  KATANA_LOG_ASSERT(!katana::LeaseThreadGroup(1));
+  katana::setActiveThreads(1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime katana_runtime;
+
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+  if (max_threads < 3) {
+    // no threads to lease next to the default one
+    return 0;
+  }
+  katana::setActiveThreads(1);
+  unsigned group_size = (max_threads - 1) / 2;
+
+  TestConcurrent(group_size);
+  TestDefaultThreads(group_size);
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include <memory>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MemoryPolicy.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/TopologyManager.h"
+
+namespace {
+
+/// Reclaims what the test asks for before allocations, refuses standby
+/// memory while pressure_high, and remembers what the MemorySupervisor last
+/// told it
+class ControlledPolicy : public katana::MemoryPolicyMinimal {
+public:
+  katana::count_t ReclaimForMemoryPressure(
+      katana::count_t active, katana::count_t standby) const override {
+    Record(active, standby);
+    return 0;
+  }
+
+  bool MemoryPressureHigh(
+      katana::count_t active, katana::count_t standby) const override {
+    Record(active, standby);
+    return pressure_high;
+  }
+
+  bool KillSelfForLackOfMemory(
+      katana::count_t active, katana::count_t standby) const override {
+    Record(active, standby);
+    return false;
+  }
+
+  katana::count_t ReclaimForAllocation(
+      katana::count_t active, katana::count_t standby,
+      [[maybe_unused]] katana::count_t bytes) const override {
+    Record(active, standby);
+    return reclaim;
+  }
+
+  void Record(katana::count_t active, katana::count_t standby) const {
+    last_active = active;
+    last_standby = standby;
+  }
+
+  katana::count_t reclaim{0};
+  bool pressure_high{false};
+  mutable katana::count_t last_active{};
+  mutable katana::count_t last_standby{};
+};
+
+void
+TestTopologyManager(ControlledPolicy* policy) {
+  katana::MemorySupervisor& ms = katana::MemorySupervisor::Get();
+  katana::TopologyManager* tm = ms.GetTopologyManager();
+  KATANA_LOG_ASSERT(tm != nullptr);
+
+  std::vector<katana::TopologyManager::TopologyID> evicted;
+  auto evictor = [&](katana::TopologyManager::TopologyID id) {
+    return [&evicted, id]() { evicted.emplace_back(id); };
+  };
+
+  // a ReturnActive reports the totals without moving any memory
+  ms.ReturnActive(tm->Name(), 0);
+  katana::count_t active = policy->last_active;
+  katana::count_t standby = policy->last_standby;
+
+  katana::MemoryPhase phase;
+  auto a = tm->TopologyBuiltActive(100);
+  auto b = tm->TopologyBuiltActive(200);
+  auto c = tm->TopologyBuiltActive(400);
+  KATANA_LOG_ASSERT(policy->last_active == active + 700);
+  KATANA_LOG_ASSERT(phase.Peaks().views >= 700);
+
+  KATANA_LOG_ASSERT(tm->PutTopology(a, evictor(a)));
+  KATANA_LOG_ASSERT(tm->PutTopology(b, evictor(b)));
+  KATANA_LOG_ASSERT(tm->PutTopology(c, evictor(c)));
+  // putting a standby topology again is a hit
+  KATANA_LOG_ASSERT(tm->PutTopology(c, evictor(c)));
+  KATANA_LOG_ASSERT(policy->last_active == active);
+  KATANA_LOG_ASSERT(policy->last_standby == standby + 700);
+
+  // b is active again, so it is not evicted
+  tm->TopologyReused(b);
+  KATANA_LOG_ASSERT(policy->last_active == active + 200);
+  KATANA_LOG_ASSERT(policy->last_standby == standby + 500);
+
+  // the least recently used standby topology goes first, and only as many
+  // as the goal needs
+  policy->reclaim = 50;
+  ms.PrepareBorrowActive(1);
+  KATANA_LOG_ASSERT(evicted == std::vector<uint64_t>{a});
+  KATANA_LOG_ASSERT(policy->last_standby == standby + 400);
+  ms.PrepareBorrowActive(1);
+  KATANA_LOG_ASSERT((evicted == std::vector<uint64_t>{a, c}));
+  KATANA_LOG_ASSERT(policy->last_standby == standby);
+  // nothing is left to evict
+  ms.PrepareBorrowActive(1);
+  KATANA_LOG_ASSERT(evicted.size() == 2);
+  policy->reclaim = 0;
+
+  // an evicted topology is gone
+  KATANA_LOG_ASSERT(!tm->PutTopology(a, evictor(a)));
+  tm->TopologyDropped(c);
+  KATANA_LOG_ASSERT(policy->last_active == active + 200);
+
+  // a topology the supervisor refuses to keep is dropped at once
+  policy->pressure_high = true;
+  KATANA_LOG_ASSERT(!tm->PutTopology(b, evictor(b)));
+  policy->pressure_high = false;
+  KATANA_LOG_ASSERT(policy->last_active == active);
+  KATANA_LOG_ASSERT(policy->last_standby == standby);
+  KATANA_LOG_ASSERT(!tm->PutTopology(b, evictor(b)));
+
+  // dropping a standby topology returns it without evicting it
+  auto d = tm->TopologyBuiltActive(800);
+  KATANA_LOG_ASSERT(tm->PutTopology(d, evictor(d)));
+  KATANA_LOG_ASSERT(policy->last_standby == standby + 800);
+  tm->TopologyDropped(d);
+  KATANA_LOG_ASSERT(policy->last_standby == standby);
+  policy->reclaim = 1000;
+  ms.PrepareBorrowActive(1);
+  KATANA_LOG_ASSERT(evicted.size() == 2);
+
+  // four builds and a hit on reuse; one of eight puts was of a standby topology
+  katana::CacheStats stats = ms.GetTopologyCacheStats();
+  KATANA_LOG_ASSERT(stats.get_count == 5);
+  KATANA_LOG_ASSERT(stats.get_hit_count == 1);
+  KATANA_LOG_ASSERT(stats.insert_count == 8);
+  KATANA_LOG_ASSERT(stats.insert_hit_count == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(2);
+
+  auto policy = std::make_unique<ControlledPolicy>();
+  ControlledPolicy* controlled = policy.get();
+  katana::MemorySupervisor::Get().SetPolicy(std::move(policy));
+
+  TestTopologyManager(controlled);
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include <utility>
+
+#include "Kernels.h"
+
+namespace {
+
+/// Expand the frontier by one level. The first visit of a node claims it by
+/// setting its parent, so every node enters a frontier once.
+__global__ void
+BfsStep(
+    katana::gpu::DeviceCsr csr, const uint32_t* frontier,
+    uint32_t frontier_size, uint32_t unreached, uint32_t* parents,
+    uint32_t* next, uint32_t* next_size) {
+  uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i >= frontier_size) {
+    return;
+  }
+  uint32_t src = frontier[i];
+  uint64_t begin = src == 0 ? 0 : csr.adj_indices[src - 1];
+  uint64_t end = csr.adj_indices[src];
+  for (uint64_t e = begin; e < end; ++e) {
+    uint32_t dst = csr.dests[e];
+    if (parents[dst] == unreached &&
+        atomicCAS(&parents[dst], unreached, src) == unreached) {
+      next[atomicAdd(next_size, 1U)] = dst;
+    }
+  }
+}
+
+}  // namespace
+
+cudaError_t
+katana::gpu::Bfs(
+    const DeviceCsr& csr, uint32_t source, uint32_t unreached,
+    uint32_t* parents) {
+  size_t node_bytes = sizeof(uint32_t) * csr.num_nodes;
+  DeviceBuffer device_parents;
+  DeviceBuffer frontier;
+  DeviceBuffer next;
+  DeviceBuffer next_size;
+  KATANA_CUDA_CHECKED(device_parents.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(frontier.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(next.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(next_size.Allocate(sizeof(uint32_t)));
+  KATANA_CUDA_CHECKED(device_parents.CopyFromHost(parents, node_bytes));
+  KATANA_CUDA_CHECKED(frontier.CopyFromHost(&source, sizeof(source)));
+
+  uint32_t frontier_size = 1;
+  while (frontier_size > 0) {
+    KATANA_CUDA_CHECKED(
+        cudaMemset(next_size.As<void>(), 0, sizeof(uint32_t)));
+    BfsStep<<<NumBlocks(frontier_size), kBlockSize>>>(
+        csr, frontier.As<uint32_t>(), frontier_size, unreached,
+        device_parents.As<uint32_t>(), next.As<uint32_t>(),
+        next_size.As<uint32_t>());
+    KATANA_CUDA_CHECKED(cudaGetLastError());
+    KATANA_CUDA_CHECKED(
+        next_size.CopyToHost(&frontier_size, sizeof(frontier_size)));
+    std::swap(frontier, next);
+  }
+
+  return device_parents.CopyToHost(parents, node_bytes);
+}
@@ -0,0 +1,110 @@
+#include "Kernels.h"
+
+namespace {
+
+using Component = unsigned long long int;
+static_assert(sizeof(Component) == sizeof(uint64_t));
+
+__global__ void
+ComponentsInit(uint32_t num_nodes, Component* components) {
+  uint32_t n = blockIdx.x * blockDim.x + threadIdx.x;
+  if (n < num_nodes) {
+    components[n] = n;
+  }
+}
+
+/// Hook the root of the larger component of the endpoints of each edge
+/// whose endpoints differ onto the smaller one. Hooks may race and
+/// overwrite each other; the edges of a lost hook still differ afterwards
+/// and hook again in the next round.
+__global__ void
+ComponentsHook(
+    katana::gpu::DeviceCsr csr, Component* components, int* changed) {
+  uint32_t src = blockIdx.x * blockDim.x + threadIdx.x;
+  if (src >= csr.num_nodes) {
+    return;
+  }
+  uint64_t begin = src == 0 ? 0 : csr.adj_indices[src - 1];
+  uint64_t end = csr.adj_indices[src];
+  for (uint64_t e = begin; e < end; ++e) {
+    Component src_component = components[src];
+    Component dst_component = components[csr.dests[e]];
+    if (src_component == dst_component) {
+      continue;
+    }
+    Component high = max(src_component, dst_component);
+    Component low = min(src_component, dst_component);
+    atomicMin(&components[high], low);
+    *changed = 1;
+  }
+}
+
+/// Replace the component of each node by the component of its component.
+/// Components only ever get smaller, so repeating this ends at roots.
+__global__ void
+ComponentsJump(uint32_t num_nodes, Component* components, int* changed) {
+  uint32_t n = blockIdx.x * blockDim.x + threadIdx.x;
+  if (n >= num_nodes) {
+    return;
+  }
+  Component component = components[n];
+  Component next = components[component];
+  if (next != component) {
+    components[n] = next;
+    *changed = 1;
+  }
+}
+
+/// Launch a kernel that sets *changed if it changes anything, and return in
+/// host_changed whether it did
+template <typename Launch>
+cudaError_t
+LaunchChanged(int* changed, bool* host_changed, Launch launch) {
+  KATANA_CUDA_CHECKED(cudaMemset(changed, 0, sizeof(int)));
+  launch();
+  KATANA_CUDA_CHECKED(cudaGetLastError());
+  int value = 0;
+  KATANA_CUDA_CHECKED(
+      cudaMemcpy(&value, changed, sizeof(int), cudaMemcpyDeviceToHost));
+  *host_changed = value != 0;
+  return cudaSuccess;
+}
+
+}  // namespace
+
+cudaError_t
+katana::gpu::ConnectedComponents(const DeviceCsr& csr, uint64_t* components) {
+  // a launch of no blocks is an invalid configuration
+  if (csr.num_nodes == 0) {
+    return cudaSuccess;
+  }
+  size_t node_bytes = sizeof(Component) * csr.num_nodes;
+  DeviceBuffer device_components;
+  DeviceBuffer changed;
+  KATANA_CUDA_CHECKED(device_components.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(changed.Allocate(sizeof(int)));
+
+  unsigned blocks = NumBlocks(csr.num_nodes);
+  Component* comps = device_components.As<Component>();
+  ComponentsInit<<<blocks, kBlockSize>>>(csr.num_nodes, comps);
+  KATANA_CUDA_CHECKED(cudaGetLastError());
+
+  // Alternate a round of hooking with jumping to the roots until no edge
+  // joins two components
+  int* device_changed = changed.As<int>();
+  bool hooked = true;
+  while (hooked) {
+    bool jumped = true;
+    while (jumped) {
+      KATANA_CUDA_CHECKED(LaunchChanged(device_changed, &jumped, [&]() {
+        ComponentsJump<<<blocks, kBlockSize>>>(
+            csr.num_nodes, comps, device_changed);
+      }));
+    }
+    KATANA_CUDA_CHECKED(LaunchChanged(device_changed, &hooked, [&]() {
+      ComponentsHook<<<blocks, kBlockSize>>>(csr, comps, device_changed);
+    }));
+  }
+
+  return device_components.CopyToHost(components, node_bytes);
+}
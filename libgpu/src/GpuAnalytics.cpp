@@ -0,0 +1,209 @@
+#include "katana/analytics/GpuAnalytics.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include <arrow/type.h>
+#include <cuda_runtime_api.h>
+
+#include "Kernels.h"
+#include "katana/ErrorCode.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Plugin.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+
+namespace {
+
+using SortedGraphView =
+    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+
+katana::Result<void>
+CudaResult(cudaError_t error) {
+  if (error != cudaSuccess) {
+    return KATANA_ERROR(
+        katana::ErrorCode::CudaError, "{}: {}", cudaGetErrorName(error),
+        cudaGetErrorString(error));
+  }
+  return katana::ResultSuccess();
+}
+
+/// A topology uploaded to the device
+struct DeviceTopology {
+  katana::gpu::DeviceBuffer adj_indices;
+  katana::gpu::DeviceBuffer dests;
+  katana::gpu::DeviceCsr csr;
+};
+
+/// The topologies of a graph uploaded so far. They are uploaded on first use
+/// and dropped with the cache when the topology of the graph changes.
+class DeviceTopologies : public katana::DeviceTopologyCache {
+public:
+  std::shared_ptr<const DeviceTopology> default_topology;
+  /// The topology of SortedGraphView, which triangle counting needs
+  std::shared_ptr<const DeviceTopology> sorted_topology;
+};
+
+katana::Result<std::shared_ptr<const DeviceTopology>>
+Upload(
+    const katana::GraphTopology::Edge* adj_indices,
+    const katana::GraphTopology::Node* dests, uint64_t num_nodes,
+    uint64_t num_edges) {
+  static_assert(sizeof(*adj_indices) == sizeof(uint64_t));
+  static_assert(sizeof(*dests) == sizeof(uint32_t));
+  if (num_nodes > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "GPU analytics support at most 2^32 - 1 nodes, not {}", num_nodes);
+  }
+
+  auto topo = std::make_shared<DeviceTopology>();
+  size_t adj_bytes = sizeof(uint64_t) * num_nodes;
+  size_t dest_bytes = sizeof(uint32_t) * num_edges;
+  KATANA_CHECKED(CudaResult(topo->adj_indices.Allocate(adj_bytes)));
+  KATANA_CHECKED(CudaResult(topo->dests.Allocate(dest_bytes)));
+  KATANA_CHECKED(
+      CudaResult(topo->adj_indices.CopyFromHost(adj_indices, adj_bytes)));
+  KATANA_CHECKED(CudaResult(topo->dests.CopyFromHost(dests, dest_bytes)));
+  topo->csr.adj_indices = topo->adj_indices.As<const uint64_t>();
+  topo->csr.dests = topo->dests.As<const uint32_t>();
+  topo->csr.num_nodes = num_nodes;
+  topo->csr.num_edges = num_edges;
+  return std::shared_ptr<const DeviceTopology>(std::move(topo));
+}
+
+/// The cache of pg, made if it has none
+std::shared_ptr<DeviceTopologies>
+GetTopologies(katana::PropertyGraph* pg) {
+  auto topologies =
+      std::dynamic_pointer_cast<DeviceTopologies>(pg->GetDeviceTopologyCache());
+  if (!topologies) {
+    topologies = std::make_shared<DeviceTopologies>();
+    pg->SetDeviceTopologyCache(topologies);
+  }
+  return topologies;
+}
+
+katana::Result<std::shared_ptr<const DeviceTopology>>
+GetDefaultTopology(katana::PropertyGraph* pg) {
+  std::shared_ptr<DeviceTopologies> topologies = GetTopologies(pg);
+  if (!topologies->default_topology) {
+    const katana::GraphTopology& topo = pg->topology();
+    topologies->default_topology = KATANA_CHECKED(Upload(
+        topo.AdjData(), topo.DestData(), topo.NumNodes(), topo.NumEdges()));
+  }
+  return topologies->default_topology;
+}
+
+katana::Result<std::shared_ptr<const DeviceTopology>>
+GetSortedTopology(katana::PropertyGraph* pg) {
+  std::shared_ptr<DeviceTopologies> topologies = GetTopologies(pg);
+  if (!topologies->sorted_topology) {
+    SortedGraphView view = pg->BuildView<SortedGraphView>();
+    topologies->sorted_topology = KATANA_CHECKED(Upload(
+        view.AdjData(), view.DestData(), view.NumNodes(), view.NumEdges()));
+  }
+  return topologies->sorted_topology;
+}
+
+template <typename Weight>
+katana::Result<void>
+SsspWithType(
+    const katana::gpu::DeviceCsr& csr, uint32_t source, const void* weights,
+    void* distances) {
+  size_t weight_bytes = sizeof(Weight) * csr.num_edges;
+  katana::gpu::DeviceBuffer device_weights;
+  KATANA_CHECKED(CudaResult(device_weights.Allocate(weight_bytes)));
+  KATANA_CHECKED(
+      CudaResult(device_weights.CopyFromHost(weights, weight_bytes)));
+  return CudaResult(katana::gpu::Sssp<Weight>(
+      csr, device_weights.As<const Weight>(), source,
+      static_cast<Weight*>(distances)));
+}
+
+class CudaAnalytics : public katana::analytics::GpuAnalytics {
+public:
+  katana::Result<void> Bfs(
+      katana::PropertyGraph* pg, uint32_t source, uint32_t unreached,
+      uint32_t* parents) override {
+    auto topo = KATANA_CHECKED(GetDefaultTopology(pg));
+    return CudaResult(katana::gpu::Bfs(topo->csr, source, unreached, parents));
+  }
+
+  katana::Result<void> Sssp(
+      katana::PropertyGraph* pg, uint32_t source,
+      arrow::Type::type weight_type, const void* weights,
+      void* distances) override {
+    auto topo = KATANA_CHECKED(GetDefaultTopology(pg));
+    switch (weight_type) {
+    case arrow::Type::UINT32:
+      return SsspWithType<uint32_t>(topo->csr, source, weights, distances);
+    case arrow::Type::INT32:
+      return SsspWithType<int32_t>(topo->csr, source, weights, distances);
+    case arrow::Type::UINT64:
+      return SsspWithType<uint64_t>(topo->csr, source, weights, distances);
+    case arrow::Type::INT64:
+      return SsspWithType<int64_t>(topo->csr, source, weights, distances);
+    case arrow::Type::FLOAT:
+      return SsspWithType<float>(topo->csr, source, weights, distances);
+    case arrow::Type::DOUBLE:
+      return SsspWithType<double>(topo->csr, source, weights, distances);
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "unsupported weight type {}",
+          static_cast<int>(weight_type));
+    }
+  }
+
+  katana::Result<void> Pagerank(
+      katana::PropertyGraph* pg, float alpha, float tolerance,
+      uint32_t max_iterations, float* ranks) override {
+    auto topo = KATANA_CHECKED(GetDefaultTopology(pg));
+    return CudaResult(katana::gpu::Pagerank(
+        topo->csr, alpha, tolerance, max_iterations, ranks));
+  }
+
+  katana::Result<void> ConnectedComponents(
+      katana::PropertyGraph* pg, uint64_t* components) override {
+    auto topo = KATANA_CHECKED(GetDefaultTopology(pg));
+    return CudaResult(katana::gpu::ConnectedComponents(topo->csr, components));
+  }
+
+  katana::Result<uint64_t> TriangleCount(katana::PropertyGraph* pg) override {
+    auto topo = KATANA_CHECKED(GetSortedTopology(pg));
+    uint64_t count = 0;
+    KATANA_CHECKED(CudaResult(katana::gpu::TriangleCount(topo->csr, &count)));
+    return count;
+  }
+};
+
+CudaAnalytics cuda_analytics;
+
+void
+Finalize() {
+  katana::analytics::RegisterGpuAnalytics(nullptr);
+}
+
+const katana::PluginMetadata plugin_info = {
+    .name = "katana_gpu_analytics",
+    .description = "Runs the analytics of GPU plans with CUDA",
+    .version = "0.1",
+    .author = "Katana Graph",
+    .licence = "BSD",
+    .finalize = &Finalize,
+};
+
+}  // namespace
+
+KATANA_PLUGIN_INIT() {
+  int num_devices = 0;
+  if (cudaGetDeviceCount(&num_devices) != cudaSuccess || num_devices == 0) {
+    KATANA_LOG_WARN("no CUDA device: GPU plans will not be available");
+  } else {
+    katana::analytics::RegisterGpuAnalytics(&cuda_analytics);
+  }
+  return &plugin_info;
+}
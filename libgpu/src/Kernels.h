@@ -0,0 +1,128 @@
+#ifndef KATANA_LIBGPU_KERNELS_H_
+#define KATANA_LIBGPU_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <cuda_runtime_api.h>
+
+/// @file Kernels.h
+///
+/// The interface between the host side of the GPU analytics plugin and its
+/// CUDA kernels. It only uses plain types and the CUDA runtime so that nvcc
+/// never compiles katana or arrow headers: the launchers take a topology in
+/// device memory and host arrays, allocate what they need on the device and
+/// return cudaSuccess or the first CUDA error.
+
+/// Return the error of expr if it is not cudaSuccess
+#define KATANA_CUDA_CHECKED(expr)                                              \
+  do {                                                                         \
+    cudaError_t katana_cuda_error_ = (expr);                                   \
+    if (katana_cuda_error_ != cudaSuccess) {                                   \
+      return katana_cuda_error_;                                               \
+    }                                                                          \
+  } while (0)
+
+namespace katana::gpu {
+
+constexpr unsigned kBlockSize = 256;
+
+inline unsigned
+NumBlocks(uint64_t num_threads) {
+  return (num_threads + kBlockSize - 1) / kBlockSize;
+}
+
+/// A CSR in device memory, as in GraphTopology: adj_indices[n] is the end
+/// of the edges of node n in dests
+struct DeviceCsr {
+  const uint64_t* adj_indices{nullptr};
+  const uint32_t* dests{nullptr};
+  uint32_t num_nodes{0};
+  uint64_t num_edges{0};
+};
+
+/// Device memory, freed with the buffer
+class DeviceBuffer {
+public:
+  DeviceBuffer() = default;
+  DeviceBuffer(const DeviceBuffer&) = delete;
+  DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+  DeviceBuffer(DeviceBuffer&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  DeviceBuffer& operator=(DeviceBuffer&& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+  ~DeviceBuffer() { Free(); }
+
+  /// Replace the memory of the buffer with size uninitialized bytes
+  cudaError_t Allocate(size_t size) {
+    Free();
+    size_ = size;
+    // cudaMalloc of 0 bytes may return null, which reads as unallocated
+    return cudaMalloc(&data_, size == 0 ? 1 : size);
+  }
+
+  cudaError_t CopyFromHost(const void* host, size_t size) {
+    return cudaMemcpy(data_, host, size, cudaMemcpyHostToDevice);
+  }
+
+  cudaError_t CopyToHost(void* host, size_t size) const {
+    return cudaMemcpy(host, data_, size, cudaMemcpyDeviceToHost);
+  }
+
+  template <typename T>
+  T* As() const {
+    return static_cast<T*>(data_);
+  }
+
+  size_t size() const { return size_; }
+
+private:
+  void Free() {
+    if (data_ != nullptr) {
+      cudaFree(data_);
+      data_ = nullptr;
+    }
+    size_ = 0;
+  }
+
+  void* data_{nullptr};
+  size_t size_{0};
+};
+
+/// Level synchronous BFS; parents is in host memory and comes filled with
+/// unreached but for parents[source] == source
+cudaError_t Bfs(
+    const DeviceCsr& csr, uint32_t source, uint32_t unreached,
+    uint32_t* parents);
+
+/// Bellman-Ford over a frontier of the nodes whose distance dropped in the
+/// previous round. weights is in device memory, by edge; distances is in
+/// host memory and comes filled with infinity but for distances[source].
+/// Instantiated for the weight types of SSSP.
+template <typename Weight>
+cudaError_t Sssp(
+    const DeviceCsr& csr, const Weight* weights, uint32_t source,
+    Weight* distances);
+
+/// Jacobi PageRank iterations pushing along out edges until the sum of the
+/// changes of the ranks is at most tolerance; ranks is in host memory
+cudaError_t Pagerank(
+    const DeviceCsr& csr, float alpha, float tolerance,
+    uint32_t max_iterations, float* ranks);
+
+/// Weakly connected components by hooking and pointer jumping; components
+/// is in host memory and gets the smallest node id of each component
+cudaError_t ConnectedComponents(const DeviceCsr& csr, uint64_t* components);
+
+/// The triangles w < u < v of a symmetric csr whose edges are sorted by
+/// destination
+cudaError_t TriangleCount(const DeviceCsr& csr, uint64_t* count);
+
+}  // namespace katana::gpu
+
+#endif
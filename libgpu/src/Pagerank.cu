@@ -0,0 +1,120 @@
+#include "Kernels.h"
+
+namespace {
+
+/// Add the values of the threads of a warp to *total with one atomic. Every
+/// thread of the warp must call it.
+__device__ void
+WarpAtomicAdd(float* total, float value) {
+  for (int offset = warpSize / 2; offset > 0; offset /= 2) {
+    value += __shfl_down_sync(0xffffffff, value, offset);
+  }
+  if ((threadIdx.x & (warpSize - 1)) == 0) {
+    atomicAdd(total, value);
+  }
+}
+
+__global__ void
+PagerankInit(uint32_t num_nodes, float value, float* ranks) {
+  uint32_t n = blockIdx.x * blockDim.x + threadIdx.x;
+  if (n < num_nodes) {
+    ranks[n] = value;
+  }
+}
+
+/// The share of its rank a node gives each of its out neighbors, and zero
+/// sums to add the shares into
+__global__ void
+PagerankContributions(
+    katana::gpu::DeviceCsr csr, const float* ranks, float* contributions,
+    float* sums) {
+  uint32_t n = blockIdx.x * blockDim.x + threadIdx.x;
+  if (n >= csr.num_nodes) {
+    return;
+  }
+  uint64_t begin = n == 0 ? 0 : csr.adj_indices[n - 1];
+  uint64_t degree = csr.adj_indices[n] - begin;
+  contributions[n] = degree == 0 ? 0.0f : ranks[n] / degree;
+  sums[n] = 0.0f;
+}
+
+__global__ void
+PagerankPush(
+    katana::gpu::DeviceCsr csr, const float* contributions, float* sums) {
+  uint32_t src = blockIdx.x * blockDim.x + threadIdx.x;
+  if (src >= csr.num_nodes) {
+    return;
+  }
+  float contribution = contributions[src];
+  if (contribution == 0.0f) {
+    return;
+  }
+  uint64_t begin = src == 0 ? 0 : csr.adj_indices[src - 1];
+  uint64_t end = csr.adj_indices[src];
+  for (uint64_t e = begin; e < end; ++e) {
+    atomicAdd(&sums[csr.dests[e]], contribution);
+  }
+}
+
+__global__ void
+PagerankUpdate(
+    uint32_t num_nodes, float alpha, const float* sums, float* ranks,
+    float* delta) {
+  uint32_t n = blockIdx.x * blockDim.x + threadIdx.x;
+  float diff = 0.0f;
+  if (n < num_nodes) {
+    float value = sums[n] * alpha + (1.0f - alpha);
+    diff = fabsf(value - ranks[n]);
+    ranks[n] = value;
+  }
+  WarpAtomicAdd(delta, diff);
+}
+
+}  // namespace
+
+cudaError_t
+katana::gpu::Pagerank(
+    const DeviceCsr& csr, float alpha, float tolerance,
+    uint32_t max_iterations, float* ranks) {
+  // a launch of no blocks is an invalid configuration, and there are no
+  // ranks to compute anyway
+  if (csr.num_nodes == 0) {
+    return cudaSuccess;
+  }
+  size_t node_bytes = sizeof(float) * csr.num_nodes;
+  DeviceBuffer device_ranks;
+  DeviceBuffer contributions;
+  DeviceBuffer sums;
+  DeviceBuffer delta;
+  KATANA_CUDA_CHECKED(device_ranks.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(contributions.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(sums.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(delta.Allocate(sizeof(float)));
+
+  unsigned blocks = NumBlocks(csr.num_nodes);
+  PagerankInit<<<blocks, kBlockSize>>>(
+      csr.num_nodes, 1.0f / csr.num_nodes, device_ranks.As<float>());
+  KATANA_CUDA_CHECKED(cudaGetLastError());
+
+  for (uint32_t iteration = 0; iteration < max_iterations;) {
+    KATANA_CUDA_CHECKED(cudaMemset(delta.As<void>(), 0, sizeof(float)));
+    PagerankContributions<<<blocks, kBlockSize>>>(
+        csr, device_ranks.As<float>(), contributions.As<float>(),
+        sums.As<float>());
+    PagerankPush<<<blocks, kBlockSize>>>(
+        csr, contributions.As<float>(), sums.As<float>());
+    PagerankUpdate<<<blocks, kBlockSize>>>(
+        csr.num_nodes, alpha, sums.As<float>(), device_ranks.As<float>(),
+        delta.As<float>());
+    KATANA_CUDA_CHECKED(cudaGetLastError());
+
+    float host_delta = 0.0f;
+    KATANA_CUDA_CHECKED(delta.CopyToHost(&host_delta, sizeof(host_delta)));
+    ++iteration;
+    if (host_delta <= tolerance) {
+      break;
+    }
+  }
+
+  return device_ranks.CopyToHost(ranks, node_bytes);
+}
@@ -0,0 +1,114 @@
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "Kernels.h"
+
+namespace {
+
+/// Lower *address to value if it is less, for 4 and 8 byte integers and
+/// floating point numbers alike. Returns whether it was lowered.
+template <typename T>
+__device__ bool
+AtomicMin(T* address, T value) {
+  static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+  using Bits = std::conditional_t<
+      sizeof(T) == 4, unsigned int, unsigned long long int>;
+  Bits* bits = reinterpret_cast<Bits*>(address);
+  Bits old = *bits;
+  while (true) {
+    T current;
+    memcpy(&current, &old, sizeof(T));
+    if (!(value < current)) {
+      return false;
+    }
+    Bits desired;
+    memcpy(&desired, &value, sizeof(T));
+    Bits seen = atomicCAS(bits, old, desired);
+    if (seen == old) {
+      return true;
+    }
+    old = seen;
+  }
+}
+
+/// Relax the out edges of the frontier. A node whose distance drops enters
+/// the next frontier once per round, which pushed marks.
+template <typename Weight>
+__global__ void
+SsspStep(
+    katana::gpu::DeviceCsr csr, const Weight* weights,
+    const uint32_t* frontier, uint32_t frontier_size, uint32_t round,
+    Weight* distances, uint32_t* pushed, uint32_t* next,
+    uint32_t* next_size) {
+  uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i >= frontier_size) {
+    return;
+  }
+  uint32_t src = frontier[i];
+  Weight src_distance = distances[src];
+  uint64_t begin = src == 0 ? 0 : csr.adj_indices[src - 1];
+  uint64_t end = csr.adj_indices[src];
+  for (uint64_t e = begin; e < end; ++e) {
+    uint32_t dst = csr.dests[e];
+    if (AtomicMin(&distances[dst], src_distance + weights[e]) &&
+        atomicExch(&pushed[dst], round) != round) {
+      next[atomicAdd(next_size, 1U)] = dst;
+    }
+  }
+}
+
+}  // namespace
+
+template <typename Weight>
+cudaError_t
+katana::gpu::Sssp(
+    const DeviceCsr& csr, const Weight* weights, uint32_t source,
+    Weight* distances) {
+  size_t node_bytes = sizeof(uint32_t) * csr.num_nodes;
+  size_t distance_bytes = sizeof(Weight) * csr.num_nodes;
+  DeviceBuffer device_distances;
+  DeviceBuffer pushed;
+  DeviceBuffer frontier;
+  DeviceBuffer next;
+  DeviceBuffer next_size;
+  KATANA_CUDA_CHECKED(device_distances.Allocate(distance_bytes));
+  KATANA_CUDA_CHECKED(pushed.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(frontier.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(next.Allocate(node_bytes));
+  KATANA_CUDA_CHECKED(next_size.Allocate(sizeof(uint32_t)));
+  KATANA_CUDA_CHECKED(
+      device_distances.CopyFromHost(distances, distance_bytes));
+  KATANA_CUDA_CHECKED(cudaMemset(pushed.As<void>(), 0, node_bytes));
+  KATANA_CUDA_CHECKED(frontier.CopyFromHost(&source, sizeof(source)));
+
+  uint32_t frontier_size = 1;
+  // rounds start at 1 so that no node is marked pushed to begin with
+  for (uint32_t round = 1; frontier_size > 0; ++round) {
+    KATANA_CUDA_CHECKED(
+        cudaMemset(next_size.As<void>(), 0, sizeof(uint32_t)));
+    SsspStep<Weight><<<NumBlocks(frontier_size), kBlockSize>>>(
+        csr, weights, frontier.As<uint32_t>(), frontier_size, round,
+        device_distances.As<Weight>(), pushed.As<uint32_t>(),
+        next.As<uint32_t>(), next_size.As<uint32_t>());
+    KATANA_CUDA_CHECKED(cudaGetLastError());
+    KATANA_CUDA_CHECKED(
+        next_size.CopyToHost(&frontier_size, sizeof(frontier_size)));
+    std::swap(frontier, next);
+  }
+
+  return device_distances.CopyToHost(distances, distance_bytes);
+}
+
+template cudaError_t katana::gpu::Sssp<uint32_t>(
+    const DeviceCsr&, const uint32_t*, uint32_t, uint32_t*);
+template cudaError_t katana::gpu::Sssp<int32_t>(
+    const DeviceCsr&, const int32_t*, uint32_t, int32_t*);
+template cudaError_t katana::gpu::Sssp<uint64_t>(
+    const DeviceCsr&, const uint64_t*, uint32_t, uint64_t*);
+template cudaError_t katana::gpu::Sssp<int64_t>(
+    const DeviceCsr&, const int64_t*, uint32_t, int64_t*);
+template cudaError_t katana::gpu::Sssp<float>(
+    const DeviceCsr&, const float*, uint32_t, float*);
+template cudaError_t katana::gpu::Sssp<double>(
+    const DeviceCsr&, const double*, uint32_t, double*);
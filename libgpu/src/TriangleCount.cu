@@ -0,0 +1,66 @@
+#include "Kernels.h"
+
+namespace {
+
+/// Count the triangles w < u < v of each node v: for each neighbor u < v,
+/// merge the sorted neighbors of u and of v below u
+__global__ void
+TriangleCountNodes(katana::gpu::DeviceCsr csr, unsigned long long* total) {
+  uint32_t v = blockIdx.x * blockDim.x + threadIdx.x;
+  if (v >= csr.num_nodes) {
+    return;
+  }
+  uint64_t v_begin = v == 0 ? 0 : csr.adj_indices[v - 1];
+  uint64_t v_end = csr.adj_indices[v];
+  unsigned long long count = 0;
+  for (uint64_t e = v_begin; e < v_end; ++e) {
+    uint32_t u = csr.dests[e];
+    if (u >= v) {
+      break;
+    }
+    uint64_t i = v_begin;
+    uint64_t j = u == 0 ? 0 : csr.adj_indices[u - 1];
+    uint64_t u_end = csr.adj_indices[u];
+    while (i < v_end && j < u_end) {
+      uint32_t a = csr.dests[i];
+      uint32_t b = csr.dests[j];
+      if (a >= u || b >= u) {
+        break;
+      }
+      if (a == b) {
+        ++count;
+        ++i;
+        ++j;
+      } else if (a < b) {
+        ++i;
+      } else {
+        ++j;
+      }
+    }
+  }
+  if (count != 0) {
+    atomicAdd(total, count);
+  }
+}
+
+}  // namespace
+
+cudaError_t
+katana::gpu::TriangleCount(const DeviceCsr& csr, uint64_t* count) {
+  // a launch of no blocks is an invalid configuration
+  if (csr.num_nodes == 0) {
+    *count = 0;
+    return cudaSuccess;
+  }
+  DeviceBuffer total;
+  KATANA_CUDA_CHECKED(total.Allocate(sizeof(unsigned long long)));
+  KATANA_CUDA_CHECKED(
+      cudaMemset(total.As<void>(), 0, sizeof(unsigned long long)));
+  TriangleCountNodes<<<NumBlocks(csr.num_nodes), kBlockSize>>>(
+      csr, total.As<unsigned long long>());
+  KATANA_CUDA_CHECKED(cudaGetLastError());
+  unsigned long long host_total = 0;
+  KATANA_CUDA_CHECKED(total.CopyToHost(&host_total, sizeof(host_total)));
+  *count = host_total;
+  return cudaSuccess;
+}
@@ -0,0 +1,184 @@
+#include <cmath>
+#include <string>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/GpuAnalytics.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<symmetric input rdg>"), cll::Required);
+
+namespace {
+
+constexpr uint32_t kSource = 0;
+const std::string kWeight = "value";
+
+/// Both BFS find the same nodes, and the GPU parents are valid
+void
+TestBfs(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  using katana::analytics::BfsStatistics;
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(pg, kSource, "cpu-bfs", txn_ctx));
+  auto res = katana::analytics::Bfs(
+      pg, kSource, "gpu-bfs", txn_ctx, katana::analytics::BfsPlan::Gpu());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(katana::analytics::BfsAssertValid(pg, kSource, "gpu-bfs"));
+
+  auto cpu = BfsStatistics::Compute(pg, "cpu-bfs");
+  auto gpu = BfsStatistics::Compute(pg, "gpu-bfs");
+  KATANA_LOG_ASSERT(cpu && gpu);
+  KATANA_LOG_ASSERT(cpu.value().n_reached_nodes == gpu.value().n_reached_nodes);
+}
+
+void
+TestSssp(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  using katana::analytics::SsspStatistics;
+  KATANA_LOG_ASSERT(
+      katana::analytics::Sssp(pg, kSource, kWeight, "cpu-sssp", txn_ctx));
+  auto res = katana::analytics::Sssp(
+      pg, kSource, kWeight, "gpu-sssp", txn_ctx,
+      katana::analytics::SsspPlan::Gpu());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(
+      katana::analytics::SsspAssertValid(pg, kSource, kWeight, "gpu-sssp"));
+
+  auto cpu = SsspStatistics::Compute(pg, "cpu-sssp");
+  auto gpu = SsspStatistics::Compute(pg, "gpu-sssp");
+  KATANA_LOG_ASSERT(cpu && gpu);
+  KATANA_LOG_ASSERT(cpu.value().n_reached_nodes == gpu.value().n_reached_nodes);
+  KATANA_LOG_ASSERT(cpu.value().max_distance == gpu.value().max_distance);
+}
+
+/// The GPU iterates the topological algorithm, so the ranks agree with it
+/// up to the rounding of the order of the sums
+void
+TestPagerank(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  using katana::analytics::PagerankPlan;
+  constexpr float kTolerance = 1e-6;
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(
+      pg, "cpu-pagerank", txn_ctx, PagerankPlan::PullTopological(kTolerance)));
+  auto res = katana::analytics::Pagerank(
+      pg, "gpu-pagerank", txn_ctx, PagerankPlan::Gpu(kTolerance));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  auto cpu = pg->GetNodePropertyTyped<float>("cpu-pagerank");
+  auto gpu = pg->GetNodePropertyTyped<float>("gpu-pagerank");
+  KATANA_LOG_ASSERT(cpu && gpu);
+  for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+    float expected = cpu.value()->Value(n);
+    float actual = gpu.value()->Value(n);
+    KATANA_LOG_VASSERT(
+        std::fabs(expected - actual) <= 1e-3 * std::fabs(expected),
+        "node {}: cpu rank {} gpu rank {}", n, expected, actual);
+  }
+}
+
+void
+TestConnectedComponents(
+    katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  using katana::analytics::ConnectedComponentsPlan;
+  using katana::analytics::ConnectedComponentsStatistics;
+  KATANA_LOG_ASSERT(katana::analytics::ConnectedComponents(
+      pg, "cpu-cc", txn_ctx, true, ConnectedComponentsPlan()));
+  auto res = katana::analytics::ConnectedComponents(
+      pg, "gpu-cc", txn_ctx, true, ConnectedComponentsPlan::Gpu());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConnectedComponentsAssertValid(pg, "gpu-cc"));
+
+  auto cpu = ConnectedComponentsStatistics::Compute(pg, "cpu-cc");
+  auto gpu = ConnectedComponentsStatistics::Compute(pg, "gpu-cc");
+  KATANA_LOG_ASSERT(cpu && gpu);
+  KATANA_LOG_ASSERT(
+      cpu.value().total_components == gpu.value().total_components);
+  KATANA_LOG_ASSERT(
+      cpu.value().largest_component_size ==
+      gpu.value().largest_component_size);
+
+  // components are labeled by their smallest node
+  auto labels = pg->GetNodePropertyTyped<uint64_t>("gpu-cc");
+  KATANA_LOG_ASSERT(labels);
+  for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+    uint64_t label = labels.value()->Value(n);
+    KATANA_LOG_ASSERT(label <= n && labels.value()->Value(label) == label);
+  }
+}
+
+void
+TestTriangleCount(katana::PropertyGraph* pg) {
+  using katana::analytics::TriangleCountPlan;
+  auto cpu = katana::analytics::TriangleCount(pg);
+  auto gpu = katana::analytics::TriangleCount(pg, TriangleCountPlan::Gpu());
+  KATANA_LOG_VASSERT(gpu, "{}", gpu.error());
+  KATANA_LOG_ASSERT(cpu && cpu.value() == gpu.value());
+}
+
+/// The analytics that launch a block per node finish on a graph without
+/// nodes rather than launching no blocks
+void
+TestEmpty(katana::TxnContext* txn_ctx) {
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology{});
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  auto pagerank = katana::analytics::Pagerank(
+      pg, "gpu-pagerank", txn_ctx, katana::analytics::PagerankPlan::Gpu());
+  KATANA_LOG_VASSERT(pagerank, "{}", pagerank.error());
+  auto cc = katana::analytics::ConnectedComponents(
+      pg, "gpu-cc", txn_ctx, true,
+      katana::analytics::ConnectedComponentsPlan::Gpu());
+  KATANA_LOG_VASSERT(cc, "{}", cc.error());
+  auto triangles = katana::analytics::TriangleCount(
+      pg, katana::analytics::TriangleCountPlan::Gpu());
+  KATANA_LOG_VASSERT(triangles, "{}", triangles.error());
+  KATANA_LOG_ASSERT(triangles.value() == 0);
+}
+
+/// The analytics share one upload, which is dropped with the topology
+void
+TestCache(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  std::shared_ptr<katana::DeviceTopologyCache> cache =
+      pg->GetDeviceTopologyCache();
+  KATANA_LOG_ASSERT(cache);
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(
+      pg, kSource, "gpu-bfs-again", txn_ctx,
+      katana::analytics::BfsPlan::Gpu()));
+  KATANA_LOG_ASSERT(pg->GetDeviceTopologyCache() == cache);
+
+  pg->MarkTopologyModified();
+  KATANA_LOG_ASSERT(!pg->GetDeviceTopologyCache());
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  auto gpu_res = katana::analytics::GetGpuAnalytics();
+  KATANA_LOG_VASSERT(gpu_res, "{}", gpu_res.error());
+
+  katana::TxnContext txn_ctx;
+  auto pg_res = katana::PropertyGraph::Make(inputFile, &txn_ctx);
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  TestBfs(pg, &txn_ctx);
+  TestSssp(pg, &txn_ctx);
+  TestPagerank(pg, &txn_ctx);
+  TestConnectedComponents(pg, &txn_ctx);
+  TestTriangleCount(pg);
+  TestCache(pg, &txn_ctx);
+  TestEmpty(&txn_ctx);
+
+  return 0;
+}
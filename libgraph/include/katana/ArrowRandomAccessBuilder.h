@@ -1,9 +1,15 @@
+#include <climits>
+
 #include <arrow/api.h>
 
 #include "katana/ErrorCode.h"
+#include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
+#include "katana/PropertyColumn.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
 
 namespace katana {
@@ -77,6 +83,10 @@ public:
     return reinterpret_cast<ValueType*>(data_.data())[index];
   }
 
+  void SetValue(size_t index, const value_type& value) {
+    (*this)[index] = value;
+  }
+
   void UnsetValue(size_t index) {
     KATANA_LOG_DEBUG_ASSERT(index < size());
     valid_[index] = false;
@@ -125,6 +135,91 @@ private:
   std::vector<uint8_t> valid_;
 };
 
+/// ParallelNullableBuilder uses NUMAArrays for storage, with the validity of
+/// the values in an arrow bitmap
+/// Finalize() hands the values and the bitmap to arrow without a copy
+/// Supports null values, and writes from parallel loops: validity bits are
+/// set and cleared with atomic operations on their words, so threads may
+/// write distinct indices that share a word
+template <typename ValueType, typename ArrowType>
+class ParallelNullableBuilder {
+  static constexpr size_t kBitsPerWord = sizeof(uint64_t) * CHAR_BIT;
+
+public:
+  using value_type = ValueType;
+  using reference = ValueType&;
+
+  ParallelNullableBuilder(size_t length) {
+    // Both arrays are blocked the same way, so a do_all over the indices
+    // writes the values and the words of bits of its own block
+    data_.allocateBlocked(length);
+    valid_.allocateBlocked((length + kBitsPerWord - 1) / kBitsPerWord);
+    katana::ParallelSTL::fill(valid_.begin(), valid_.end(), uint64_t{0});
+  }
+
+  // NOTE this operator has side-effects. It can safely be used in two ways:
+  // 1) builder[index] = value; where it creates a non-null entry
+  // 2) value = builder[index]; ONLY IF option 1 has already used that index
+  reference operator[](size_t index) {
+    KATANA_LOG_DEBUG_VASSERT(
+        index < size(), "index: {}, size: {}", index, size());
+    __atomic_fetch_or(
+        &valid_[index / kBitsPerWord], Mask(index), __ATOMIC_RELAXED);
+    return data_[index];
+  }
+
+  void SetValue(size_t index, const value_type& value) {
+    (*this)[index] = value;
+  }
+
+  void UnsetValue(size_t index) {
+    KATANA_LOG_DEBUG_ASSERT(index < size());
+    __atomic_fetch_and(
+        &valid_[index / kBitsPerWord], ~Mask(index), __ATOMIC_RELAXED);
+  }
+
+  bool IsValid(size_t index) {
+    return (__atomic_load_n(&valid_[index / kBitsPerWord], __ATOMIC_RELAXED) &
+            Mask(index)) != 0;
+  }
+
+  size_t size() const { return data_.size(); }
+
+  /// Finalize must be called once, after the writes are done; the builder is
+  /// empty afterwards
+  katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) {
+    size_t length = data_.size();
+    katana::GAccumulator<size_t> num_valid;
+    katana::do_all(
+        katana::iterate(size_t{0}, valid_.size()),
+        [&](size_t i) { num_valid += __builtin_popcountll(valid_[i]); },
+        katana::no_stats());
+    size_t null_count = length - num_valid.reduce();
+
+    // Arrow bitmaps are in little endian bit order, which on the hosts we
+    // support is the byte order of the words. A column without nulls does not
+    // need a bitmap at all.
+    std::shared_ptr<arrow::Buffer> valid;
+    if (null_count > 0) {
+      valid = std::make_shared<NUMAArrayBuffer<uint64_t>>(std::move(valid_));
+    }
+    valid_.deallocate();
+    auto data = std::make_shared<NUMAArrayBuffer<ValueType>>(std::move(data_));
+    *array = arrow::MakeArray(arrow::ArrayData::Make(
+        arrow::TypeTraits<ArrowType>::type_singleton(), length,
+        {std::move(valid), std::move(data)}, null_count));
+    return katana::ResultSuccess();
+  }
+
+private:
+  static uint64_t Mask(size_t index) {
+    return uint64_t{1} << (index % kBitsPerWord);
+  }
+
+  NUMAArray<ValueType> data_;
+  NUMAArray<uint64_t> valid_;
+};
+
 template <typename ArrowType>
 struct ArrowTypeConfig;
 
@@ -135,27 +230,38 @@ struct ArrowTypeConfig;
         NullableBuilder<ValueType, StorageType, ArrowType>;                    \
   }
 
-NULLABLE(int8_t, int8_t, arrow::Int8Type);
-NULLABLE(uint8_t, uint8_t, arrow::UInt8Type);
-NULLABLE(int16_t, int16_t, arrow::Int16Type);
-NULLABLE(uint16_t, uint16_t, arrow::UInt16Type);
-NULLABLE(int32_t, int32_t, arrow::Int32Type);
-NULLABLE(uint32_t, uint32_t, arrow::UInt32Type);
-NULLABLE(int64_t, int64_t, arrow::Int64Type);
-NULLABLE(uint64_t, uint64_t, arrow::UInt64Type);
-NULLABLE(float, float, arrow::FloatType);
-NULLABLE(double, double, arrow::DoubleType);
+#define PARALLEL_NULLABLE(ValueType, ArrowType)                                \
+  template <>                                                                  \
+  struct ArrowTypeConfig<ArrowType> {                                          \
+    using RandomBuilderType = ParallelNullableBuilder<ValueType, ArrowType>;   \
+  }
+
+PARALLEL_NULLABLE(int8_t, arrow::Int8Type);
+PARALLEL_NULLABLE(uint8_t, arrow::UInt8Type);
+PARALLEL_NULLABLE(int16_t, arrow::Int16Type);
+PARALLEL_NULLABLE(uint16_t, arrow::UInt16Type);
+PARALLEL_NULLABLE(int32_t, arrow::Int32Type);
+PARALLEL_NULLABLE(uint32_t, arrow::UInt32Type);
+PARALLEL_NULLABLE(int64_t, arrow::Int64Type);
+PARALLEL_NULLABLE(uint64_t, arrow::UInt64Type);
+PARALLEL_NULLABLE(float, arrow::FloatType);
+PARALLEL_NULLABLE(double, arrow::DoubleType);
+// Booleans are themselves bits, and strings are not fixed width, so these
+// are packed by arrow builders
 NULLABLE(bool, uint8_t, arrow::BooleanType);
 NULLABLE(std::string, std::string, arrow::StringType);
 NULLABLE(std::string, std::string, arrow::LargeStringType);
 
+#undef PARALLEL_NULLABLE
 #undef NULLABLE
 
 }  // namespace
 
 /// ArrowRandomAccessBuilder encapsulates the concept of building
 /// an arrow::Array from <index, value> pairs arriving in unknown order
-/// Functions as a wrapper for NullableBuilder currently, TODO(danielmawhirter)
+/// Functions as a wrapper for ParallelNullableBuilder for fixed width types,
+/// which may be written from parallel loops, and for NullableBuilder
+/// otherwise, TODO(danielmawhirter)
 template <typename ArrowType>
 class ArrowRandomAccessBuilder {
 public:
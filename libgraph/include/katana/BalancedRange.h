@@ -0,0 +1,363 @@
+#ifndef KATANA_LIBGRAPH_KATANA_BALANCEDRANGE_H_
+#define KATANA_LIBGRAPH_KATANA_BALANCEDRANGE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+
+#include "katana/Bag.h"
+#include "katana/CompileTimeIntrospection.h"
+#include "katana/GraphHelpers.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Range.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace katana {
+
+/// The edges of a node that one item of a BalancedRange covers: all of
+/// them, or a slice of them if the node is a hub
+template <typename Node, typename EdgeRange>
+struct NodeEdges {
+  Node node;
+  EdgeRange edges;
+  /// Whether edges are all the edges of node. If not, other items, maybe
+  /// run by other threads, have the rest of them, so updates of the data of
+  /// node itself have to be atomic.
+  bool whole;
+};
+
+namespace internal {
+
+template <typename View>
+using has_adj_data_t =
+    decltype(std::declval<const View&>().topology_ptr()->AdjData());
+
+}  // namespace internal
+
+/// A range over the edges of every node of a view, to loop over with
+/// do_all in place of iterate(view) when degrees vary a lot, as they do in
+/// power-law graphs.
+///
+/// The part of the range each thread starts with has about as many nodes
+/// plus edges as the other parts, rather than as many nodes; it is cut with
+/// a binary search of the prefix sums of the degrees, which views over a CSR
+/// topology already have in their adjacency indices. The edges of a hub, a
+/// node with more than max_edges_per_item edges, are split into items of at
+/// most max_edges_per_item edges, so that no single item holds up a loop.
+/// Items are NodeEdges in node order; every node, even without edges, has
+/// at least one.
+///
+/// The view must outlive the range and not change while it is used.
+template <typename View>
+class BalancedRange {
+public:
+  using Node = typename View::Node;
+  using Edge = typename View::Edge;
+  using EdgeRange = decltype(Edges(std::declval<const View&>(), Node{}));
+  using value_type = NodeEdges<Node, EdgeRange>;
+
+  static constexpr uint64_t kDefaultMaxEdgesPerItem = uint64_t{1} << 14;
+
+private:
+  struct Hub {
+    Node node;
+    /// The index of the first item of the hub
+    uint64_t first_item;
+    uint64_t num_items;
+  };
+
+  struct State {
+    const View* view;
+    uint64_t max_edges_per_item;
+    uint64_t num_items;
+    /// The nodes with more than max_edges_per_item edges, by node
+    std::vector<Hub> hubs;
+    /// The first item of every thread's part, then num_items
+    std::vector<uint64_t> thread_beginnings;
+  };
+
+public:
+  class iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = BalancedRange::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    // items are made when dereferenced
+    using reference = value_type;
+
+    iterator() = default;
+    iterator(const State* state, uint64_t item) : state_(state) { Seek(item); }
+
+    value_type operator*() const {
+      EdgeRange edges = Edges(*state_->view, node_);
+      if (!InHub()) {
+        return value_type{node_, edges, true};
+      }
+      const uint64_t max_edges = state_->max_edges_per_item;
+      auto slice_begin = edges.begin();
+      std::advance(slice_begin, piece_ * max_edges);
+      auto slice_end = slice_begin;
+      std::advance(
+          slice_end, std::min<uint64_t>(
+                         max_edges, edges.size() - piece_ * max_edges));
+      return value_type{node_, EdgeRange(slice_begin, slice_end), false};
+    }
+
+    value_type operator[](difference_type n) const { return *(*this + n); }
+
+    iterator& operator++() {
+      ++item_;
+      if (InHub()) {
+        if (++piece_ < state_->hubs[hub_].num_items) {
+          return *this;
+        }
+        ++hub_;
+      }
+      ++node_;
+      piece_ = 0;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+    iterator& operator--() {
+      Seek(item_ - 1);
+      return *this;
+    }
+    iterator operator--(int) {
+      iterator old = *this;
+      --*this;
+      return old;
+    }
+
+    iterator& operator+=(difference_type n) {
+      Seek(item_ + n);
+      return *this;
+    }
+    iterator& operator-=(difference_type n) {
+      Seek(item_ - n);
+      return *this;
+    }
+    friend iterator operator+(iterator it, difference_type n) {
+      return it += n;
+    }
+    friend iterator operator+(difference_type n, iterator it) {
+      return it += n;
+    }
+    friend iterator operator-(iterator it, difference_type n) {
+      return it -= n;
+    }
+    friend difference_type operator-(const iterator& a, const iterator& b) {
+      return static_cast<difference_type>(a.item_) -
+             static_cast<difference_type>(b.item_);
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a.item_ == b.item_;
+    }
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return a.item_ != b.item_;
+    }
+    friend bool operator<(const iterator& a, const iterator& b) {
+      return a.item_ < b.item_;
+    }
+    friend bool operator>(const iterator& a, const iterator& b) {
+      return a.item_ > b.item_;
+    }
+    friend bool operator<=(const iterator& a, const iterator& b) {
+      return a.item_ <= b.item_;
+    }
+    friend bool operator>=(const iterator& a, const iterator& b) {
+      return a.item_ >= b.item_;
+    }
+
+  private:
+    bool InHub() const {
+      return hub_ < state_->hubs.size() && state_->hubs[hub_].node == node_;
+    }
+
+    void Seek(uint64_t item) {
+      item_ = item;
+      const std::vector<Hub>& hubs = state_->hubs;
+      // the first hub that has item or an item after it
+      auto it = std::upper_bound(
+          hubs.begin(), hubs.end(), item, [](uint64_t i, const Hub& hub) {
+            return i < hub.first_item + hub.num_items;
+          });
+      hub_ = it - hubs.begin();
+      if (it != hubs.end() && item >= it->first_item) {
+        node_ = it->node;
+        piece_ = item - it->first_item;
+        return;
+      }
+      // every hub before has num_items - 1 items more than other nodes
+      uint64_t extra = 0;
+      if (hub_ > 0) {
+        const Hub& prev = hubs[hub_ - 1];
+        extra = prev.first_item - prev.node + prev.num_items - 1;
+      }
+      node_ = static_cast<Node>(item - extra);
+      piece_ = 0;
+    }
+
+    const State* state_{nullptr};
+    uint64_t item_{0};
+    Node node_{0};
+    /// Which of the items of a hub this is
+    uint64_t piece_{0};
+    /// The first hub at node_ or after it
+    size_t hub_{0};
+  };
+  using local_iterator = iterator;
+
+  BalancedRange(const View& view, uint64_t max_edges_per_item);
+
+  iterator begin() const { return iterator(state_.get(), 0); }
+  iterator end() const { return iterator(state_.get(), state_->num_items); }
+
+  local_iterator local_begin() const { return LocalPair().first; }
+  local_iterator local_end() const { return LocalPair().second; }
+
+  /// The number of items, at least the number of nodes
+  uint64_t size() const { return state_->num_items; }
+  bool empty() const { return state_->num_items == 0; }
+
+private:
+  std::pair<iterator, iterator> LocalPair() const {
+    const std::vector<uint64_t>& beginnings = state_->thread_beginnings;
+    const unsigned tid = ThreadPool::getTID();
+    const unsigned num_threads = getActiveThreads();
+    if (beginnings.size() != num_threads + 1) {
+      // the number of threads changed since the parts were cut
+      auto [b, e] =
+          block_range(uint64_t{0}, state_->num_items, tid, num_threads);
+      return std::make_pair(
+          iterator(state_.get(), b), iterator(state_.get(), e));
+    }
+    return std::make_pair(
+        iterator(state_.get(), beginnings[tid]),
+        iterator(state_.get(), beginnings[tid + 1]));
+  }
+
+  std::shared_ptr<const State> state_;
+};
+
+template <typename View>
+BalancedRange<View>::BalancedRange(
+    const View& view, uint64_t max_edges_per_item) {
+  KATANA_LOG_DEBUG_ASSERT(max_edges_per_item > 0);
+  auto state = std::make_shared<State>();
+  state->view = &view;
+  state->max_edges_per_item = max_edges_per_item;
+  const uint64_t num_nodes = view.NumNodes();
+
+  // edge_sums[n] is the number of edges of the nodes up to and including n
+  const Edge* edge_sums = nullptr;
+  if constexpr (
+      is_detected_v<internal::has_adj_data_t, View> &&
+      !is_detected_v<has_undirected_t, View>) {
+    edge_sums = view.topology_ptr()->AdjData();
+  }
+  NUMAArray<Edge> computed_sums;
+  if (edge_sums == nullptr && num_nodes > 0) {
+    computed_sums.allocateInterleaved(num_nodes);
+    auto degrees = boost::make_transform_iterator(
+        boost::counting_iterator<Node>(0),
+        [&view](Node n) -> Edge { return Degree(view, n); });
+    ParallelSTL::partial_sum(
+        degrees, degrees + num_nodes, computed_sums.begin());
+    edge_sums = computed_sums.data();
+  }
+  auto degree = [&](uint64_t n) -> uint64_t {
+    return edge_sums[n] - (n > 0 ? edge_sums[n - 1] : 0);
+  };
+
+  InsertBag<Node> hub_nodes;
+  do_all(
+      iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (degree(n) > max_edges_per_item) {
+          hub_nodes.push(static_cast<Node>(n));
+        }
+      },
+      no_stats());
+  std::vector<Node> sorted_hubs(hub_nodes.begin(), hub_nodes.end());
+  std::sort(sorted_hubs.begin(), sorted_hubs.end());
+
+  uint64_t extra = 0;
+  for (Node n : sorted_hubs) {
+    uint64_t num_items =
+        (degree(n) + max_edges_per_item - 1) / max_edges_per_item;
+    state->hubs.emplace_back(Hub{n, n + extra, num_items});
+    extra += num_items - 1;
+  }
+  state->num_items = num_nodes + extra;
+
+  // the first item of node n
+  auto item_of = [&](uint64_t n) -> uint64_t {
+    auto it = std::lower_bound(
+        state->hubs.begin(), state->hubs.end(), n,
+        [](const Hub& hub, uint64_t m) { return hub.node < m; });
+    if (it == state->hubs.begin()) {
+      return n;
+    }
+    const Hub& prev = *(it - 1);
+    return n + prev.first_item - prev.node + prev.num_items - 1;
+  };
+
+  // every node weighs one plus its number of edges
+  const unsigned num_threads = getActiveThreads();
+  const uint64_t total_weight =
+      num_nodes > 0 ? edge_sums[num_nodes - 1] + num_nodes : 0;
+  state->thread_beginnings.assign(num_threads + 1, 0);
+  for (unsigned t = 1; t < num_threads; ++t) {
+    uint64_t target = total_weight / num_threads * t +
+                      total_weight % num_threads * t / num_threads;
+    // the fewest nodes that weigh at least target
+    uint64_t end_node = internal::findIndexPrefixSum(
+        1, 1, target, 0, num_nodes, edge_sums, 0, 0);
+    uint64_t item = item_of(end_node);
+    if (end_node > 0 && degree(end_node - 1) > max_edges_per_item) {
+      // cut inside the hub that reaches target
+      uint64_t hub = end_node - 1;
+      uint64_t before = (hub > 0 ? edge_sums[hub - 1] : 0) + hub;
+      uint64_t pieces =
+          (target - std::min(target, before) + max_edges_per_item - 1) /
+          max_edges_per_item;
+      item = std::min(item, item_of(hub) + pieces);
+    }
+    state->thread_beginnings[t] =
+        std::max(item, state->thread_beginnings[t - 1]);
+  }
+  state->thread_beginnings[num_threads] = state->num_items;
+
+  state_ = std::move(state);
+}
+
+/// A BalancedRange over view
+template <typename View>
+BalancedRange<View>
+iterate_balanced(
+    const View& view, uint64_t max_edges_per_item =
+                          BalancedRange<View>::kDefaultMaxEdgesPerItem) {
+  return BalancedRange<View>(view, max_edges_per_item);
+}
+
+}  // namespace katana
+
+#endif
@@ -26,7 +26,7 @@
 #ifndef KATANA_LIBGRAPH_KATANA_BUFFEREDGRAPH_H_
 #define KATANA_LIBGRAPH_KATANA_BUFFEREDGRAPH_H_
 
-#include <fstream>
+#include <string>
 
 #include <boost/iterator/counting_iterator.hpp>
 
@@ -36,6 +36,31 @@
 
 namespace katana {
 
+/**
+ * Reads a range of a file into memory with every thread at once, each
+ * reading large blocks of it, so that reads from network storage overlap.
+ * Dies if the file cannot be read.
+ *
+ * @param filename file to read
+ * @param offset first byte of the file to read
+ * @param size number of bytes to read
+ * @param buffer memory to read size bytes into
+ * @param direct if true, read with direct I/O, bypassing the page cache,
+ * where the file system supports it; blocks are read aligned and copied
+ * into buffer unless they are already aligned
+ */
+KATANA_EXPORT void ReadFileRangeParallel(
+    const std::string& filename, uint64_t offset, uint64_t size, void* buffer,
+    bool direct);
+
+//! How BufferedGraph loads a graph
+struct BufferedGraphLoadOptions {
+  //! if false, edge data is not read and edgeData may not be called
+  bool loadEdgeData = true;
+  //! read with direct I/O; see ReadFileRangeParallel
+  bool directIO = false;
+};
+
 /**
  * Class that loads a portion of a Galois graph from disk directly into
  * memory buffers for access.
@@ -86,12 +111,14 @@ private:
    * Load the out indices (i.e. where a particular node's edges begin in the
    * array of edges) from the file.
    *
-   * @param graphFile loaded file for the graph
+   * @param filename file of the graph
    * @param nodeStart the first node to load
    * @param numNodesToLoad number of nodes to load
+   * @param opts how to read the file
    */
   void loadOutIndex(
-      std::ifstream& graphFile, uint64_t nodeStart, uint64_t numNodesToLoad) {
+      const std::string& filename, uint64_t nodeStart, uint64_t numNodesToLoad,
+      const BufferedGraphLoadOptions& opts) {
     if (numNodesToLoad == 0) {
       return;
     }
@@ -104,19 +131,9 @@ private:
 
     // position to start of contiguous chunk of nodes to read
     uint64_t readPosition = (4 + nodeStart) * sizeof(uint64_t);
-    graphFile.seekg(readPosition);
-
-    uint64_t numBytesToLoad = numNodesToLoad * sizeof(uint64_t);
-    uint64_t bytesRead = 0;
-
-    while (numBytesToLoad > 0) {
-      graphFile.read(((char*)this->outIndexBuffer) + bytesRead, numBytesToLoad);
-      size_t numRead = graphFile.gcount();
-      numBytesToLoad -= numRead;
-      bytesRead += numRead;
-    }
-
-    KATANA_LOG_DEBUG_ASSERT(numBytesToLoad == 0);
+    ReadFileRangeParallel(
+        filename, readPosition, numNodesToLoad * sizeof(uint64_t),
+        outIndexBuffer, opts.directIO);
 
     nodeOffset = nodeStart;
   }
@@ -124,15 +141,16 @@ private:
   /**
    * Load the edge destination information from the file.
    *
-   * @param graphFile loaded file for the graph
+   * @param filename file of the graph
    * @param edgeStart the first edge to load
    * @param numEdgesToLoad number of edges to load
    * @param numGlobalNodes total number of nodes in the graph file; needed
    * to determine offset into the file
+   * @param opts how to read the file
    */
   void loadEdgeDest(
-      std::ifstream& graphFile, uint64_t edgeStart, uint64_t numEdgesToLoad,
-      uint64_t numGlobalNodes) {
+      const std::string& filename, uint64_t edgeStart, uint64_t numEdgesToLoad,
+      uint64_t numGlobalNodes, const BufferedGraphLoadOptions& opts) {
     if (numEdgesToLoad == 0) {
       return;
     }
@@ -147,18 +165,10 @@ private:
     // position to start of contiguous chunk of edges to read
     uint64_t readPosition = (4 + numGlobalNodes) * sizeof(uint64_t) +
                             (sizeof(uint32_t) * edgeStart);
-    graphFile.seekg(readPosition);
-
-    uint64_t numBytesToLoad = numEdgesToLoad * sizeof(uint32_t);
-    uint64_t bytesRead = 0;
-    while (numBytesToLoad > 0) {
-      graphFile.read(((char*)this->edgeDestBuffer) + bytesRead, numBytesToLoad);
-      size_t numRead = graphFile.gcount();
-      numBytesToLoad -= numRead;
-      bytesRead += numRead;
-    }
+    ReadFileRangeParallel(
+        filename, readPosition, numEdgesToLoad * sizeof(uint32_t),
+        edgeDestBuffer, opts.directIO);
 
-    KATANA_LOG_DEBUG_ASSERT(numBytesToLoad == 0);
     // save edge offset of this graph for later use
     edgeOffset = edgeStart;
   }
@@ -168,19 +178,27 @@ private:
    *
    * @tparam EdgeType must be non-void in order to call this function
    *
+   * @param filename file of the graph
    * @param edgeStart the first edge to load
    * @param numEdgesToLoad number of edges to load
    * @param numGlobalNodes total number of nodes in the graph file; needed
    * to determine offset into the file
    * @param numGlobalEdges total number of edges in the graph file; needed
    * to determine offset into the file
+   * @param opts how to read the file; nothing is loaded unless
+   * opts.loadEdgeData
    */
   template <
       typename EdgeType,
       typename std::enable_if<!std::is_void<EdgeType>::value>::type* = nullptr>
   void loadEdgeData(
-      std::ifstream& graphFile, uint64_t edgeStart, uint64_t numEdgesToLoad,
-      uint64_t numGlobalNodes, uint64_t numGlobalEdges) {
+      const std::string& filename, uint64_t edgeStart, uint64_t numEdgesToLoad,
+      uint64_t numGlobalNodes, uint64_t numGlobalEdges,
+      const BufferedGraphLoadOptions& opts) {
+    if (!opts.loadEdgeData) {
+      katana::gDebug("Skipping edge data");
+      return;
+    }
     katana::gDebug("Loading edge data");
 
     if (numEdgesToLoad == 0) {
@@ -207,18 +225,9 @@ private:
     // jump to first byte of edge data
     uint64_t readPosition =
         baseReadPosition + (sizeof(EdgeDataType) * edgeStart);
-    graphFile.seekg(readPosition);
-    uint64_t numBytesToLoad = numEdgesToLoad * sizeof(EdgeDataType);
-    uint64_t bytesRead = 0;
-
-    while (numBytesToLoad > 0) {
-      graphFile.read(((char*)this->edgeDataBuffer) + bytesRead, numBytesToLoad);
-      size_t numRead = graphFile.gcount();
-      numBytesToLoad -= numRead;
-      bytesRead += numRead;
-    }
-
-    KATANA_LOG_DEBUG_ASSERT(numBytesToLoad == 0);
+    ReadFileRangeParallel(
+        filename, readPosition, numEdgesToLoad * sizeof(EdgeDataType),
+        edgeDataBuffer, opts.directIO);
   }
 
   /**
@@ -232,7 +241,9 @@ private:
   template <
       typename EdgeType,
       typename std::enable_if<std::is_void<EdgeType>::value>::type* = nullptr>
-  void loadEdgeData(std::ifstream&, uint64_t, uint64_t, uint64_t, uint64_t) {
+  void loadEdgeData(
+      const std::string&, uint64_t, uint64_t, uint64_t, uint64_t,
+      const BufferedGraphLoadOptions&) {
     katana::gDebug("Not loading edge data");
     // do nothing (edge data is void, i.e. no edge data)
   }
@@ -311,32 +322,32 @@ public:
    *
    * @param filename name of graph to load; should be in Galois binary graph
    * format
+   * @param opts how to load the graph
    */
-  void loadGraph(const std::string& filename) {
+  void loadGraph(
+      const std::string& filename,
+      const BufferedGraphLoadOptions& opts = BufferedGraphLoadOptions()) {
     if (graphLoaded) {
       KATANA_DIE("Cannot load an buffered graph more than once.");
     }
 
-    std::ifstream graphFile(filename.c_str());
     uint64_t header[4];
-    graphFile.read(((char*)header), sizeof(uint64_t) * 4);
+    ReadFileRangeParallel(filename, 0, sizeof(header), header, false);
 
     numLocalNodes = globalSize = header[2];
     numLocalEdges = globalEdgeSize = header[3];
 
-    loadOutIndex(graphFile, 0, globalSize);
-    loadEdgeDest(graphFile, 0, globalEdgeSize, globalSize);
+    loadOutIndex(filename, 0, globalSize, opts);
+    loadEdgeDest(filename, 0, globalEdgeSize, globalSize, opts);
     // may or may not do something depending on EdgeDataType
     loadEdgeData<EdgeDataType>(
-        graphFile, 0, globalEdgeSize, globalSize, globalEdgeSize);
+        filename, 0, globalEdgeSize, globalSize, globalEdgeSize, opts);
     graphLoaded = true;
-
-    graphFile.close();
   }
 
   /**
    * Given a node/edge range to load, loads the specified portion of the graph
-   * into memory buffers using read.
+   * into memory buffers, reading with every thread at once.
    *
    * @param filename name of graph to load; should be in Galois binary graph
    * format
@@ -347,34 +358,33 @@ public:
    * @param edgeEnd Last edge to load, non-inclusive
    * @param numGlobalNodes Total number of nodes in the graph
    * @param numGlobalEdges Total number of edges in the graph
+   * @param opts how to load the graph
    */
   void loadPartialGraph(
       const std::string& filename, uint64_t nodeStart, uint64_t nodeEnd,
       uint64_t edgeStart, uint64_t edgeEnd, uint64_t numGlobalNodes,
-      uint64_t numGlobalEdges) {
+      uint64_t numGlobalEdges,
+      const BufferedGraphLoadOptions& opts = BufferedGraphLoadOptions()) {
     if (graphLoaded) {
       KATANA_DIE("Cannot load an buffered graph more than once.");
     }
 
-    std::ifstream graphFile(filename.c_str());
-
     globalSize = numGlobalNodes;
     globalEdgeSize = numGlobalEdges;
 
     KATANA_LOG_DEBUG_ASSERT(nodeEnd >= nodeStart);
     numLocalNodes = nodeEnd - nodeStart;
-    loadOutIndex(graphFile, nodeStart, numLocalNodes);
+    loadOutIndex(filename, nodeStart, numLocalNodes, opts);
 
     KATANA_LOG_DEBUG_ASSERT(edgeEnd >= edgeStart);
     numLocalEdges = edgeEnd - edgeStart;
-    loadEdgeDest(graphFile, edgeStart, numLocalEdges, numGlobalNodes);
+    loadEdgeDest(filename, edgeStart, numLocalEdges, numGlobalNodes, opts);
 
     // may or may not do something depending on EdgeDataType
     loadEdgeData<EdgeDataType>(
-        graphFile, edgeStart, numLocalEdges, numGlobalNodes, numGlobalEdges);
+        filename, edgeStart, numLocalEdges, numGlobalNodes, numGlobalEdges,
+        opts);
     graphLoaded = true;
-
-    graphFile.close();
   }
 
   /**
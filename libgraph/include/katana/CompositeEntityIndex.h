@@ -0,0 +1,164 @@
+#ifndef KATANA_LIBGRAPH_KATANA_COMPOSITEENTITYINDEX_H_
+#define KATANA_LIBGRAPH_KATANA_COMPOSITEENTITYINDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/array.h>
+
+#include "katana/EntityIndex.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+// A value to search a property of a CompositeEntityIndex for. Either
+// integer alternative matches a property of any integer type. Keys are best
+// made of the exact alternative, e.g., int64_t{42} or std::string_view("x"),
+// since literals convert to several of them.
+using EntityIndexKey =
+    std::variant<bool, int64_t, uint64_t, double, std::string_view>;
+
+namespace internal {
+
+// A property of a CompositeEntityIndex, whose values are compared through a
+// switch on their kind rather than a template, so that an index can combine
+// properties of any types.
+class KATANA_EXPORT IndexColumn {
+public:
+  static Result<IndexColumn> Make(std::shared_ptr<arrow::Array> property);
+
+  int64_t length() const { return property_->length(); }
+
+  bool IsValid(uint64_t id) const { return property_->IsValid(id); }
+
+  // Less than, equal to or greater than 0 as the value of a is less than,
+  // equal to or greater than that of b.
+  int Compare(uint64_t a, uint64_t b) const;
+
+  // Compare the value of id to key, which must be Accepted.
+  int Compare(uint64_t id, const EntityIndexKey& key) const;
+
+  // Whether key can be compared to the values of the property.
+  bool Accepts(const EntityIndexKey& key) const;
+
+private:
+  enum class Kind { kBool, kSigned, kUnsigned, kDouble, kString };
+
+  IndexColumn() = default;
+
+  int64_t SignedValue(uint64_t id) const;
+  uint64_t UnsignedValue(uint64_t id) const;
+  std::string_view StringValue(uint64_t id) const;
+
+  Kind kind_{Kind::kBool};
+  std::shared_ptr<arrow::Array> property_;
+  // The strings of the entities, or the dictionary of their codes
+  std::shared_ptr<arrow::LargeStringArray> strings_;
+  const int32_t* codes_{nullptr};
+};
+
+}  // namespace internal
+
+// CompositeEntityIndex is an ordered index, like EntityIndex, over several
+// properties, by their values lexicographically, as for a query like "nodes
+// with last_name X and city Y". It may be scoped to the entities of a set of
+// entity types (or their subtypes).
+//
+// Only the entities in the scope that have a value for every property are
+// in the index, so its memory and sort are proportional to their number
+// rather than to all entities. Any prefix of the properties can be
+// searched: with last_name and city, the nodes with last_name X are a range
+// of the index, and those with last_name X and city Y a range of that.
+template <typename node_or_edge>
+class KATANA_EXPORT CompositeEntityIndex {
+public:
+  using iterator = typename EntityIndex<node_or_edge>::iterator;
+
+  // Create an index of properties, the properties named property_names,
+  // scoped to type_ids, or unscoped if it is empty. Does not build the
+  // index.
+  static Result<std::unique_ptr<CompositeEntityIndex>> Make(
+      std::vector<std::string> property_names,
+      const std::vector<std::shared_ptr<arrow::Array>>& properties,
+      std::vector<EntityTypeID> type_ids);
+
+  CompositeEntityIndex(const CompositeEntityIndex&) = delete;
+  CompositeEntityIndex& operator=(const CompositeEntityIndex&) = delete;
+  CompositeEntityIndex(const CompositeEntityIndex&&) = delete;
+  CompositeEntityIndex& operator=(const CompositeEntityIndex&&) = delete;
+
+  // The names of the indexed properties, in the order of the index.
+  const std::vector<std::string>& property_names() const {
+    return property_names_;
+  }
+
+  // The entity types of the scope of the index; empty if it has none.
+  const std::vector<EntityTypeID>& type_ids() const { return type_ids_; }
+
+  iterator begin() const { return iterator(ids_.data()); }
+  iterator end() const { return iterator(ids_.data() + num_ids_); }
+
+  // The number of entities in the index.
+  size_t size() const { return num_ids_; }
+
+  // Build the index of candidates, the sorted ids of the entities in its
+  // scope.
+  Result<void> Build(std::vector<node_or_edge> candidates);
+
+  // Returns an iterator to the first element in the index whose first
+  // keys.size() property values are greater than or equal to keys.
+  Result<iterator> LowerBound(const std::vector<EntityIndexKey>& keys) const;
+
+  // Returns an iterator to the first element in the index whose first
+  // keys.size() property values are greater than keys.
+  Result<iterator> UpperBound(const std::vector<EntityIndexKey>& keys) const;
+
+  // The range of the elements in the index whose first keys.size() property
+  // values equal keys.
+  Result<std::pair<iterator, iterator>> EqualRange(
+      const std::vector<EntityIndexKey>& keys) const;
+
+private:
+  CompositeEntityIndex(
+      std::vector<std::string> property_names,
+      std::vector<internal::IndexColumn> columns,
+      std::vector<EntityTypeID> type_ids)
+      : property_names_(std::move(property_names)),
+        columns_(std::move(columns)),
+        type_ids_(std::move(type_ids)) {}
+
+  Result<void> CheckKeys(const std::vector<EntityIndexKey>& keys) const;
+
+  // Compare the first keys.size() property values of id to keys.
+  int ComparePrefix(
+      node_or_edge id, const std::vector<EntityIndexKey>& keys) const {
+    for (size_t c = 0; c < keys.size(); ++c) {
+      if (int order = columns_[c].Compare(id, keys[c]); order != 0) {
+        return order;
+      }
+    }
+    return 0;
+  }
+
+  std::vector<std::string> property_names_;
+  std::vector<internal::IndexColumn> columns_;
+  std::vector<EntityTypeID> type_ids_;
+
+  // The sorted ids of the entities in the index
+  NUMAArray<node_or_edge> ids_;
+  size_t num_ids_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef KATANA_LIBGRAPH_KATANA_DYNAMICTOPOLOGY_H_
+#define KATANA_LIBGRAPH_KATANA_DYNAMICTOPOLOGY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class KATANA_EXPORT DynamicTopology;
+
+/// An immutable version of a DynamicTopology. It has the interface of the
+/// other topologies, so analytics written against BasicTopologyWrapper run
+/// on it through DynamicTopologyWrapper, and it stays the same while batches
+/// are applied to the DynamicTopology it came from.
+///
+/// The nodes are split into blocks of kNodesPerBlock nodes, each a small CSR
+/// of its own that versions share until a batch changes an edge of one of
+/// its nodes. Edge ids are dense, numbered block after block, and only valid
+/// within the version that handed them out. The edges of each node are
+/// sorted by destination.
+class KATANA_EXPORT DynamicTopologySnapshot : public GraphTopologyTypes {
+public:
+  static constexpr uint64_t kNodesPerBlock = 1024;
+
+  DynamicTopologySnapshot(const DynamicTopologySnapshot&) = delete;
+  DynamicTopologySnapshot& operator=(const DynamicTopologySnapshot&) = delete;
+
+  /// The number of batches applied before this version
+  uint64_t version() const noexcept { return version_; }
+
+  uint64_t NumNodes() const noexcept { return num_nodes_; }
+
+  uint64_t NumEdges() const noexcept { return num_edges_; }
+
+  edges_range OutEdges() const noexcept {
+    return MakeStandardRange<edge_iterator>(Edge{0}, Edge{NumEdges()});
+  }
+
+  edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    const uint64_t b = node / kNodesPerBlock;
+    const uint64_t i = node % kNodesPerBlock;
+    const Block& block = *blocks_[b];
+    edge_iterator e_beg{block_begins_[b] + (i > 0 ? block.ends[i - 1] : 0)};
+    edge_iterator e_end{block_begins_[b] + block.ends[i]};
+    return MakeStandardRange(e_beg, e_end);
+  }
+
+  /// Prefer this over OutEdgeDst() when visiting all neighbors of a node,
+  /// since finding the block of an edge id takes a binary search
+  StandardRange<const Node*> OutNeighbors(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    const uint64_t i = node % kNodesPerBlock;
+    const Block& block = *blocks_[node / kNodesPerBlock];
+    const Node* first = block.dests.data() + (i > 0 ? block.ends[i - 1] : 0);
+    const Node* last = block.dests.data() + block.ends[i];
+    return MakeStandardRange(first, last);
+  }
+
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    auto [b, local] = Locate(edge_id);
+    return blocks_[b]->dests[local];
+  }
+
+  Node GetEdgeSrc(const Edge& eid) const noexcept {
+    auto [b, local] = Locate(eid);
+    const std::vector<Edge>& ends = blocks_[b]->ends;
+    auto it = std::upper_bound(ends.begin(), ends.end(), local);
+    KATANA_LOG_DEBUG_ASSERT(it != ends.end());
+    return static_cast<Node>(
+        b * kNodesPerBlock + std::distance(ends.begin(), it));
+  }
+
+  size_t OutDegree(Node node) const noexcept { return OutEdges(node).size(); }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
+
+  // Standard container concepts
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(NumNodes()); }
+
+  size_t size() const noexcept { return NumNodes(); }
+
+  bool empty() const noexcept { return NumNodes() == 0; }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& eid) const noexcept {
+    auto [b, local] = Locate(eid);
+    return blocks_[b]->prop_indices[local];
+  }
+
+  PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(nid < NumNodes());
+    return node_prop_indices_->empty() ? nid : (*node_prop_indices_)[nid];
+  }
+
+  Node GetLocalNodeID(const Node& nid) const noexcept {
+    return static_cast<Node>(GetNodePropertyIndex(nid));
+  }
+
+  Edge GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
+    return GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  /// Copy this version into a CSR topology, e.g., to write it out or to
+  /// build the views of a PropertyGraph over it
+  GraphTopology ToGraphTopology() const noexcept;
+
+  void Print() const noexcept;
+
+  /// Approximate number of bytes held by this version, counting blocks
+  /// shared with other versions in full
+  size_t ApproxMemUse() const noexcept;
+
+private:
+  friend class DynamicTopology;
+
+  /// The edges of kNodesPerBlock consecutive nodes, or fewer in the last
+  /// block. Never modified once a version refers to it.
+  struct Block {
+    /// End of the edges of each node of the block, relative to the block
+    std::vector<Edge> ends;
+    std::vector<Node> dests;
+    std::vector<PropertyIndex> prop_indices;
+  };
+
+  DynamicTopologySnapshot() = default;
+
+  /// Returns the block of an edge and its offset within the block
+  std::pair<uint64_t, Edge> Locate(Edge eid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+    // the last block starting at or before eid; empty blocks before it start
+    // at the same edge
+    auto it = std::upper_bound(block_begins_.begin(), block_begins_.end(), eid);
+    const uint64_t b = std::distance(block_begins_.begin(), it) - 1;
+    return {b, eid - block_begins_[b]};
+  }
+
+  uint64_t version_{0};
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+  std::vector<std::shared_ptr<const Block>> blocks_;
+  /// Edge id of the first edge of each block, and NumEdges() at the end
+  std::vector<Edge> block_begins_;
+  /// Empty if node ids are their property indices. Nodes are never added or
+  /// removed, so every version shares it.
+  std::shared_ptr<const std::vector<PropertyIndex>> node_prop_indices_;
+};
+
+class KATANA_EXPORT DynamicTopologyWrapper
+    : public BasicTopologyWrapper<DynamicTopologySnapshot> {
+  using Base = BasicTopologyWrapper<DynamicTopologySnapshot>;
+
+public:
+  explicit DynamicTopologyWrapper(
+      std::shared_ptr<const DynamicTopologySnapshot> t) noexcept
+      : Base(std::move(t)) {}
+
+  auto OutNeighbors(const Node& N) const noexcept {
+    return Base::topo().OutNeighbors(N);
+  }
+
+  uint64_t version() const noexcept { return Base::topo().version(); }
+};
+
+/// A topology whose edges change in batches, for graphs that are updated as
+/// a stream of edge insertions and deletions. Unlike the CSR topologies of a
+/// PropertyGraph, which PGViewCache::ApplyEdgeChanges rebuilds in full, a
+/// batch only copies the blocks of DynamicTopologySnapshot that hold the
+/// nodes it changes, in parallel, and shares the others with the previous
+/// version.
+///
+/// Readers take a Snapshot() and run on it while further batches are
+/// applied; a version is freed once no snapshot refers to it. Batches are
+/// applied one at a time. Their parallel loops run on the thread pool, so
+/// a process ingesting while analytics run gives one of them threads of its
+/// own with LeaseThreadGroup.
+class KATANA_EXPORT DynamicTopology : public GraphTopologyTypes {
+public:
+  /// A batch of edge changes. Deletions apply to the edges from before the
+  /// batch and remove every edge from src to dst; insertions are then added,
+  /// so a batch may delete an edge and insert it again with a new property
+  /// index.
+  struct EdgeBatch {
+    struct Deletion {
+      Node src;
+      Node dst;
+    };
+
+    std::vector<EdgeChangeSet::Insertion> insertions;
+    std::vector<Deletion> deletions;
+
+    bool empty() const noexcept {
+      return insertions.empty() && deletions.empty();
+    }
+  };
+
+  /// Copy the edges of \p topo, keeping their property indices
+  static std::unique_ptr<DynamicTopology> Make(
+      const GraphTopology& topo) noexcept;
+
+  DynamicTopology(const DynamicTopology&) = delete;
+  DynamicTopology& operator=(const DynamicTopology&) = delete;
+
+  /// Apply \p batch, making a new version. Fails without changing anything
+  /// if the batch refers to a node that does not exist.
+  katana::Result<void> ApplyEdgeBatch(const EdgeBatch& batch);
+
+  /// The current version. Cheap; it only copies a pointer.
+  std::shared_ptr<const DynamicTopologySnapshot> Snapshot() const;
+
+  /// Snapshot() wrapped for code written against BasicTopologyWrapper
+  DynamicTopologyWrapper View() const {
+    return DynamicTopologyWrapper(Snapshot());
+  }
+
+private:
+  explicit DynamicTopology(
+      std::shared_ptr<const DynamicTopologySnapshot> current) noexcept
+      : current_(std::move(current)) {}
+
+  /// Serializes batches
+  std::mutex apply_mutex_;
+  /// Guards current_, which Snapshot() reads while a batch is applied
+  mutable std::mutex current_mutex_;
+  std::shared_ptr<const DynamicTopologySnapshot> current_;
+};
+
+}  // namespace katana
+
+#endif
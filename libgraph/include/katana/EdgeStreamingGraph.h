@@ -0,0 +1,154 @@
+#ifndef KATANA_LIBGRAPH_KATANA_EDGESTREAMINGGRAPH_H_
+#define KATANA_LIBGRAPH_KATANA_EDGESTREAMINGGRAPH_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+struct EdgeStreamingOptions {
+  /// Bytes of edge destinations per shard; a node with more edges than fit
+  /// is a shard by itself. Two shards are in memory at once.
+  uint64_t shard_bytes{uint64_t{256} << 20};
+  /// Threads reading a shard, each a contiguous part of it, so that an SSD
+  /// sees more than one request at a time
+  uint32_t io_threads{4};
+};
+
+/// An EdgeStreamingGraph processes a .gr graph whose edges do not fit in
+/// memory edge centrically, like X-Stream: the out indexes and the state of
+/// the nodes are in memory, while the destinations of the edges stream from
+/// the file a shard at a time. A shard is a range of source nodes, so its
+/// edges are contiguous in the file and need no preprocessing, and the next
+/// shard is read while the edges of one are processed in parallel.
+class KATANA_EXPORT EdgeStreamingGraph {
+public:
+  using Node = uint32_t;
+
+  /// Open the version 1 .gr file filename and load its out indexes
+  static Result<EdgeStreamingGraph> Make(
+      const std::string& filename,
+      const EdgeStreamingOptions& opts = EdgeStreamingOptions());
+
+  EdgeStreamingGraph(EdgeStreamingGraph&& other) noexcept;
+  EdgeStreamingGraph& operator=(EdgeStreamingGraph&& other) noexcept;
+  EdgeStreamingGraph(const EdgeStreamingGraph&) = delete;
+  EdgeStreamingGraph& operator=(const EdgeStreamingGraph&) = delete;
+  ~EdgeStreamingGraph();
+
+  uint64_t NumNodes() const { return out_indexes_.size(); }
+  uint64_t NumEdges() const {
+    return out_indexes_.empty() ? 0 : out_indexes_[NumNodes() - 1];
+  }
+  uint64_t NumShards() const { return shard_bounds_.size() - 1; }
+
+  uint64_t OutDegree(Node n) const { return EdgeEnd(n) - EdgeBegin(n); }
+
+  /// Call fn(src, dst) for every edge, in parallel by source
+  template <typename Fn>
+  Result<void> ForEachEdge(const Fn& fn) {
+    return ForEachEdge([](Node) { return true; }, fn);
+  }
+
+  /// Call fn(src, dst) for every edge of a source for which active(src);
+  /// shards without an active source are not read at all
+  template <typename Active, typename Fn>
+  Result<void> ForEachEdge(const Active& active, const Fn& fn) {
+    std::vector<uint8_t> is_active(NumShards());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, NumShards()),
+        [&](uint64_t s) {
+          for (Node n = shard_bounds_[s]; n < shard_bounds_[s + 1]; ++n) {
+            if (OutDegree(n) > 0 && active(n)) {
+              is_active[s] = 1;
+              return;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    std::vector<uint64_t> shards;
+    for (uint64_t s = 0; s < NumShards(); ++s) {
+      if (is_active[s]) {
+        shards.emplace_back(s);
+      }
+    }
+
+    return StreamShards(shards, [&](uint64_t s, const uint32_t* dests) {
+      uint64_t first_edge = EdgeBegin(shard_bounds_[s]);
+      katana::do_all(
+          katana::iterate(shard_bounds_[s], shard_bounds_[s + 1]),
+          [&](Node src) {
+            if (!active(src)) {
+              return;
+            }
+            for (uint64_t e = EdgeBegin(src); e < EdgeEnd(src); ++e) {
+              fn(src, dests[e - first_edge]);
+            }
+          },
+          katana::steal(), katana::no_stats());
+    });
+  }
+
+private:
+  EdgeStreamingGraph() = default;
+
+  uint64_t EdgeBegin(Node n) const {
+    return n == 0 ? 0 : out_indexes_[n - 1];
+  }
+  uint64_t EdgeEnd(Node n) const { return out_indexes_[n]; }
+
+  /// Read the destinations of each of shards in turn, calling
+  /// process(shard, dests) on the calling thread for one while the next is
+  /// read
+  Result<void> StreamShards(
+      const std::vector<uint64_t>& shards,
+      const std::function<void(uint64_t, const uint32_t*)>& process);
+
+  /// Read the destinations of the edges [begin, end) into dests
+  Result<void> ReadDests(uint64_t begin, uint64_t end, uint32_t* dests) const;
+
+  std::string filename_;
+  int fd_{-1};
+  uint32_t io_threads_{1};
+  katana::NUMAArray<uint64_t> out_indexes_;
+  /// Shard s is the nodes [shard_bounds_[s], shard_bounds_[s + 1])
+  std::vector<Node> shard_bounds_{0};
+  uint64_t max_shard_edges_{0};
+};
+
+/// Breadth first search from source, a level per pass over the shards
+/// with an edge of that level; levels[n] is the level of n or
+/// std::numeric_limits<uint32_t>::max() if n is not reached
+KATANA_EXPORT Result<void> StreamingBFS(
+    EdgeStreamingGraph* graph, EdgeStreamingGraph::Node source,
+    katana::NUMAArray<uint32_t>* levels);
+
+/// Weakly connected components by label propagation along edges either
+/// way, with pointer jumping between passes; components[n] is the least
+/// node of the component of n
+KATANA_EXPORT Result<void> StreamingConnectedComponents(
+    EdgeStreamingGraph* graph, katana::NUMAArray<uint32_t>* components);
+
+struct StreamingPageRankOptions {
+  float alpha{0.85};
+  /// Stop when the ranks change by less than this in total
+  float tolerance{1.0e-4};
+  uint32_t max_iterations{100};
+};
+
+/// PageRank by pushing the rank of each node along its out edges, a pass
+/// per iteration; the rank of dangling nodes is spread over every node
+KATANA_EXPORT Result<void> StreamingPageRank(
+    EdgeStreamingGraph* graph, const StreamingPageRankOptions& opts,
+    katana::NUMAArray<float>* ranks);
+
+}  // namespace katana
+
+#endif
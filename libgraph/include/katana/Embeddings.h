@@ -0,0 +1,60 @@
+#ifndef KATANA_LIBGRAPH_KATANA_EMBEDDINGS_H_
+#define KATANA_LIBGRAPH_KATANA_EMBEDDINGS_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+// Similarities of dense float vectors, e.g., of node embeddings stored as an
+// EmbeddingProperty<float, D> (\ref Properties.h). The kernels use the
+// widest vector instructions the CPU supports, selected on first use.
+
+/// Sum of a[i] * b[i] over [0, dim)
+KATANA_EXPORT float EmbeddingDot(
+    const float* a, const float* b, size_t dim) noexcept;
+
+/// Cosine of the angle between a and b, or 0 if either is zero
+KATANA_EXPORT float EmbeddingCosine(
+    const float* a, const float* b, size_t dim) noexcept;
+
+/// How a nearest neighbor search measures similarity
+enum class EmbeddingSimilarity {
+  kDot,
+  kCosine,
+};
+
+struct EmbeddingNeighbor {
+  GraphTopologyTypes::Node node;
+  float similarity;
+};
+
+/// The k nodes of pg whose embeddings, the float FixedSizeList node property
+/// named property, are most similar to each of num_queries queries. The
+/// queries are rows of the width of the embeddings one after the other. Only
+/// nodes in candidates are searched if it is not null, and nodes whose
+/// embedding is null never are.
+///
+/// The search is exact and batched: every pass over the embeddings, in
+/// parallel, compares each of them to a block of queries while it is in
+/// cache, and keeps the best k of every query per thread.
+///
+/// \returns for every query, its neighbors from most to least similar; ties
+///   go to the lower node id
+KATANA_EXPORT Result<std::vector<std::vector<EmbeddingNeighbor>>>
+EmbeddingNearestNeighbors(
+    const PropertyGraph& pg, const std::string& property,
+    const float* queries, size_t num_queries, size_t k,
+    EmbeddingSimilarity similarity,
+    const DynamicBitset* candidates = nullptr);
+
+}  // namespace katana
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 #define KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 
-#include <set>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
@@ -11,36 +15,74 @@
 #include <boost/iterator/iterator_categories.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/EntityIndexPrimitive.h"
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
 namespace katana {
 
+namespace internal {
+
+// The first position in [0, n) at which less is false, given that it is true
+// at every position before that one and false at every position after. The
+// loop has no data dependent branches, only conditional moves, so that a
+// search costs the same log2(n) probes whatever the keys.
+template <typename Less>
+size_t
+BranchlessLowerBound(size_t n, const Less& less) {
+  if (n == 0) {
+    return 0;
+  }
+  size_t base = 0;
+  while (n > 1) {
+    size_t half = n / 2;
+    base = less(base + half) ? base + half : base;
+    n -= half;
+  }
+  return base + (less(base) ? 1 : 0);
+}
+
+}  // namespace internal
+
 // EntityIndex provides an interface similar to an ordered container
 // over a single property.
+//
+// The index is the ids of the entities with a value for the property, sorted
+// by their values and then by id, in one NUMAArray: a few bytes per entity
+// rather than a tree node, built by a parallel sort and searched by
+// bisection over contiguous memory. The arrays can also be those of an index
+// stored with the graph (see EntityIndexPrimitive), mapped rather than built.
+//
+// When only a few values of the property change, UpdateFromProperty merges
+// the entities whose values changed back into the sorted ids by their new
+// values, in time linear in the size of the index, rather than sorting all
+// of them again.
 template <typename node_or_edge>
 class KATANA_EXPORT EntityIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexID {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexID, bool, uint8_t, int64_t, uint64_t, double_t, std::string_view*>;
-
   // EntityIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
+  class iterator
+      : public boost::iterator_facade<
+            iterator, const node_or_edge, boost::random_access_traversal_tag> {
   public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    iterator() : base_iterator(0) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexID>(base_iterator::operator*()).id;
+    iterator() = default;
+    explicit iterator(const node_or_edge* pos) : pos_(pos) {}
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const node_or_edge& dereference() const { return *pos_; }
+    bool equal(const iterator& other) const { return pos_ == other.pos_; }
+    void increment() { ++pos_; }
+    void decrement() { --pos_; }
+    void advance(std::ptrdiff_t n) { pos_ += n; }
+    std::ptrdiff_t distance_to(const iterator& other) const {
+      return other.pos_ - pos_;
     }
+
+    const node_or_edge* pos_{nullptr};
   };
 
   EntityIndex(std::string property_name)
@@ -56,14 +98,95 @@ public:
   // The name of the indexed property.
   std::string property_name() { return property_name_; }
 
-  virtual iterator begin() = 0;
-  virtual iterator end() = 0;
+  iterator begin() { return iterator(ids_data_); }
+  iterator end() { return iterator(ids_data_ + num_ids_); }
+
+  // The number of entities in the index.
+  size_t size() const { return num_ids_; }
 
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Update a built index to property, a new version of the indexed property
+  // of the same type, e.g., after it is upserted.
+  virtual Result<void> UpdateFromProperty(
+      std::shared_ptr<arrow::Array> property) = 0;
+
+  // Use the arrays of a stored index of the property, as returned by
+  // ToPrimitive, rather than building them. It is up to the caller to check
+  // that the index is of the property as it is now.
+  Result<void> BuildFromPrimitive(EntityIndexPrimitive primitive) {
+    auto stored = std::make_shared<EntityIndexPrimitive>(std::move(primitive));
+    const auto& ids = stored->ids();
+    if (ids.size() % sizeof(node_or_edge) != 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "stored index of {} has {} bytes of ids of {} bytes", property_name_,
+          ids.size(), sizeof(node_or_edge));
+    }
+    size_t num_ids = ids.size() / sizeof(node_or_edge);
+    KATANA_CHECKED(
+        UseStoredKeys(stored->keys().data(), stored->keys().size(), num_ids));
+
+    ids_ = NUMAArray<node_or_edge>();
+    ids_data_ = reinterpret_cast<const node_or_edge*>(ids.data());
+    num_ids_ = num_ids;
+    stored_ = std::move(stored);
+    return ResultSuccess();
+  }
+
+  // The arrays of the index, to be stored with the graph. The arrays are
+  // borrowed, so the index must outlive the primitive.
+  EntityIndexPrimitive ToPrimitive() const {
+    using Bytes = EntityIndexPrimitive::Array<uint8_t>;
+    EntityIndexPrimitive primitive;
+    primitive.set_property_name(property_name_);
+    primitive.set_ids(Bytes::Borrow(
+        reinterpret_cast<const uint8_t*>(ids_data_),
+        num_ids_ * sizeof(node_or_edge)));
+    auto [keys, keys_size] = KeyBytes();
+    primitive.set_keys(Bytes::Borrow(keys, keys_size));
+    return primitive;
+  }
+
+protected:
+  iterator At(size_t pos) { return iterator(ids_data_ + pos); }
+
+  // The keys that the index searches besides its ids, if it has any, as
+  // bytes to be stored.
+  virtual std::pair<const uint8_t*, size_t> KeyBytes() const {
+    return {nullptr, 0};
+  }
+
+  // Search the stored keys at data, of size bytes, for num_ids ids.
+  virtual Result<void> UseStoredKeys(
+      const uint8_t* /*data*/, size_t size, size_t /*num_ids*/) {
+    if (size != 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "stored index of {} has unexpected keys",
+          property_name_);
+    }
+    return ResultSuccess();
+  }
+
+  // Update the index of num_entities to a new version of the property in
+  // which the values of the entities for which changed(id) is true changed.
+  // valid(id) is whether an entity has a new value and less(a, b) whether
+  // the new value of a orders before that of b.
+  template <typename Changed, typename Valid, typename Less>
+  void MergeChanged(
+      size_t num_entities, const Changed& changed, const Valid& valid,
+      const Less& less);
+
+  // The first num_ids_ at ids_data_ are the sorted ids of the entities with a
+  // value, either in ids_, which may be longer, or in the stored index.
+  NUMAArray<node_or_edge> ids_;
+  const node_or_edge* ids_data_{nullptr};
+  size_t num_ids_{0};
 
 private:
   std::string property_name_;
+  // Keeps the arrays of a stored index mapped
+  std::shared_ptr<const EntityIndexPrimitive> stored_;
 };
 
 // PrimitiveEntityIndex provides a EntityIndex for primitive types.
@@ -71,158 +194,173 @@ template <typename node_or_edge, typename c_type>
 class KATANA_EXPORT PrimitiveEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   PrimitiveEntityIndex(
       const std::string& column, size_t num_entities,
       std::shared_ptr<arrow::Array> property)
       : EntityIndex<node_or_edge>(column),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
 
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexID>(*it).id) != key) {
-      return end();
+    size_t pos = LowerBoundPos(key);
+    if (pos == this->num_ids_ || keys_data_[pos] != key) {
+      return this->end();
     }
-    return iterator(it);
+    return this->At(pos);
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(c_type key) { return this->At(LowerBoundPos(key)); }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(c_type key) {
+    return this->At(internal::BranchlessLowerBound(
+        this->num_ids_,
+        [&](size_t i) { return !std::less<c_type>{}(key, keys_data_[i]); }));
+  }
 
 private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
-    }
+  size_t LowerBoundPos(c_type key) const {
+    return internal::BranchlessLowerBound(this->num_ids_, [&](size_t i) {
+      return std::less<c_type>{}(keys_data_[i], key);
+    });
+  }
 
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        node_or_edge id = std::get<IndexID>(a).id;
-        c_type val = property_->Value(id);
-        return val;
-      }
-      return std::get<c_type>(a);
-    }
+  Result<void> BuildFromProperty() override;
 
-    std::shared_ptr<ArrowArrayType> property_;
-  };
+  Result<void> UpdateFromProperty(
+      std::shared_ptr<arrow::Array> property) override;
 
-  Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
+  // Set the keys to the values of the ids of the index.
+  void GatherKeys();
+
+  std::pair<const uint8_t*, size_t> KeyBytes() const override {
+    return {
+        reinterpret_cast<const uint8_t*>(keys_data_),
+        this->num_ids_ * sizeof(c_type)};
+  }
+
+  Result<void> UseStoredKeys(
+      const uint8_t* data, size_t size, size_t num_ids) override {
+    if (size != num_ids * sizeof(c_type)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "stored index of {} has {} bytes of keys for {} ids",
+          this->property_name(), size, num_ids);
+    }
+    keys_ = NUMAArray<c_type>();
+    keys_data_ = reinterpret_cast<const c_type*>(data);
+    return ResultSuccess();
+  }
 
   size_t num_entities_;
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  // The value of each entity of the ids, so that searches read the keys
+  // contiguously rather than through the ids into the property. They are in
+  // keys_ or in the stored index.
+  NUMAArray<c_type> keys_;
+  const c_type* keys_data_{nullptr};
 };
 
-// StringEntityIndex provides a EntityIndex for strings.
+namespace internal {
+
+// The rank of every string of strings in their sorted order, where equal
+// strings have the same rank.
+KATANA_EXPORT std::vector<int32_t> RankStrings(
+    const arrow::LargeStringArray& strings);
+
+}  // namespace internal
+
+// StringEntityIndex provides a EntityIndex for strings: large strings, or
+// dictionary encoded strings (see DictionaryEncodeStrings). Entities of a
+// dictionary encoded property are sorted by the rank of their code in the
+// sorted dictionary, so that building the index compares integers rather than
+// strings.
 template <typename node_or_edge>
 class KATANA_EXPORT StringEntityIndex : public EntityIndex<node_or_edge> {
 public:
-  using ArrowArrayType =
-      typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   StringEntityIndex(
       const std::string& property_name, size_t num_entities,
       const std::shared_ptr<arrow::Array>& property)
       : EntityIndex<node_or_edge>(property_name),
-        num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
+        num_entities_(num_entities) {
+    SetProperty(property);
+  }
 
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexID>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
+    iterator it = LowerBound(key);
+    if (it != this->end() && ValueOf(*it) != key) {
+      return this->end();
     }
-    return iterator(it);
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
   iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
+    return this->At(internal::BranchlessLowerBound(
+        this->num_ids_,
+        [&](size_t i) { return ValueOf(this->ids_data_[i]) < key; }));
   }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
   iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+    return this->At(internal::BranchlessLowerBound(
+        this->num_ids_,
+        [&](size_t i) { return !(key < ValueOf(this->ids_data_[i])); }));
+  }
+
+  // The value of the indexed property of entity id.
+  std::string_view ValueOf(node_or_edge id) const {
+    return ValueIn(*strings_, codes_, id);
   }
 
 private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  // The value of id in strings, or in the dictionary strings of codes.
+  static std::string_view ValueIn(
+      const arrow::LargeStringArray& strings, const int32_t* codes,
+      node_or_edge id) {
+    arrow::util::string_view arrow_view =
+        strings.GetView(codes != nullptr ? codes[id] : id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexID>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
-      }
-      return *std::get<std::string_view*>(a);
+  void SetProperty(const std::shared_ptr<arrow::Array>& property) {
+    property_ = property;
+    if (property->type_id() != arrow::Type::DICTIONARY) {
+      strings_ = std::static_pointer_cast<arrow::LargeStringArray>(property);
+      codes_ = nullptr;
+      return;
     }
-
-    std::shared_ptr<arrow::LargeStringArray> property_;
-  };
+    const auto& encoded = static_cast<const arrow::DictionaryArray&>(*property);
+    strings_ = std::static_pointer_cast<arrow::LargeStringArray>(
+        encoded.dictionary());
+    codes_ = encoded.indices()->data()->GetValues<int32_t>(1);
+  }
 
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
+
+  Result<void> UpdateFromProperty(
+      std::shared_ptr<arrow::Array> property) override;
 
   size_t num_entities_;
-  std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  // Keeps strings_ and codes_ alive
+  std::shared_ptr<arrow::Array> property_;
+  // The strings of the entities, or the dictionary of their codes
+  std::shared_ptr<arrow::LargeStringArray> strings_;
+  const int32_t* codes_{nullptr};
+};
 
 // Create a EntityIndex with the appropriate type for 'property'. Does not
 // build the index.
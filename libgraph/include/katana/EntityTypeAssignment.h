@@ -0,0 +1,38 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ENTITYTYPEASSIGNMENT_H_
+#define KATANA_LIBGRAPH_KATANA_ENTITYTYPEASSIGNMENT_H_
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Appends the names of the atomic types of an entity, its labels, to the
+/// vector; names may repeat and may be empty, which is no type. The views
+/// must stay valid until AssignEntityTypes returns.
+using EntityLabelsFunction =
+    std::function<void(uint64_t entity, std::vector<std::string_view>*)>;
+
+/// Assign the entities [0, num_entities) the intersection types of their
+/// labels, adding the atomic and intersection types that \p manager lacks,
+/// and return their EntityTypeIDs. The entities without labels are of
+/// kUnknownEntityType.
+///
+/// The labels are read in parallel. Every thread resolves each combination
+/// of labels it sees once, in a hash table of its own, so the manager is
+/// only asked for the distinct combinations. Those are added in an order
+/// that depends only on the labels, so the ids are the same from one run to
+/// the next whatever the number of threads.
+KATANA_EXPORT Result<PropertyGraph::EntityTypeIDArray> AssignEntityTypes(
+    uint64_t num_entities, const EntityLabelsFunction& labels_of,
+    EntityTypeManager* manager);
+
+}  // namespace katana
+
+#endif
@@ -15,11 +15,14 @@ namespace katana {
 ///     memory usage when converting large inputs
 /// \param verbose If true, print graph data to the standard out while
 ///     converting.
+/// \param chunk_budget Bytes of the graph that each thread parses at a time.
+///     The file is read and parsed in parallel, a chunk per thread, so it can
+///     be decreased to reduce memory usage
 /// \returns A collection of Arrow tables of node properties/labels, edge
 ///     properties/types, and CSR topology
 KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
     const std::string& infilename, size_t chunk_size = 25000,
-    bool verbose = false);
+    bool verbose = false, size_t chunk_budget = 64 << 20);
 
 /// ConvertGraphML converts a GraphML file into katana form
 ///
@@ -0,0 +1,53 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHSTATISTICS_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHSTATISTICS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/config.h"
+
+namespace katana {
+
+class GraphTopology;
+
+/// Statistics of the shape of a topology that plans are chosen from. The
+/// degrees are out degrees. The exact ones take a pass over the edges and
+/// the others are estimated from a fixed sample, so they are the same from
+/// one run to the next.
+struct KATANA_EXPORT GraphStatistics {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  double average_degree{0};
+  uint64_t max_degree{0};
+  /// Median degree of a sample of the nodes with edges
+  double median_degree{0};
+  /// Average over median degree of that sample; high for skewed degrees
+  double degree_skew{0};
+  /// Whether the degrees look like a power law, by the rule of
+  /// analytics::IsApproximateDegreeDistributionPowerLaw on the sample
+  bool power_law{false};
+  /// Lower bound of the diameter along out edges, by double sweeps of BFS
+  /// from a few nodes; on the graphs of interest it is usually close
+  uint32_t estimated_diameter{0};
+  /// Whether the edges of every node are sorted by destination
+  bool edges_sorted{false};
+  /// Share of a sample of the edges whose reverse edge exists
+  double symmetry{0};
+  /// Whether every sampled edge has its reverse, as in undirected graphs
+  /// stored with both directions of their edges
+  bool symmetric{false};
+
+  /// Whether the graph has a small diameter for its size, as social and web
+  /// graphs do, rather than a large one, as road networks and meshes do
+  bool small_world() const;
+
+  std::string ToString() const;
+};
+
+/// Computes the statistics of topo in parallel.
+KATANA_EXPORT GraphStatistics
+ComputeGraphStatistics(const GraphTopology& topo);
+
+}  // namespace katana
+
+#endif
@@ -1,12 +1,20 @@
 #ifndef KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
+#include "arrow/type_fwd.h"
 #include "arrow/util/bitmap.h"
 #include "katana/CompileTimeIntrospection.h"
 #include "katana/DynamicBitset.h"
@@ -15,6 +23,7 @@
 #include "katana/NUMAArray.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
+#include "katana/SortedIntersection.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -45,8 +54,30 @@ struct KATANA_EXPORT GraphTopologyTypes {
   using EntityTypeIDVec = NUMAArray<EntityTypeID>;
 };
 
+/// A batch of edge insertions and deletions to apply to the cached topologies
+/// of a graph, see PGViewCache::ApplyEdgeChanges.
+///
+/// Edges are identified by their property index: every inserted edge must
+/// refer to an edge property row (and edge type) that already exists, and
+/// deleting a property index removes every edge that refers to it.
+struct KATANA_EXPORT EdgeChangeSet : public GraphTopologyTypes {
+  struct Insertion {
+    Node src;
+    Node dst;
+    PropertyIndex prop_index;
+  };
+
+  std::vector<Insertion> insertions;
+  std::vector<PropertyIndex> deletions;
+
+  bool empty() const noexcept {
+    return insertions.empty() && deletions.empty();
+  }
+};
+
 class KATANA_EXPORT EdgeShuffleTopology;
 class KATANA_EXPORT EdgeTypeAwareTopology;
+class KATANA_EXPORT CompressedGraphTopology;
 
 /********************/
 /* Topology classes */
@@ -82,6 +113,24 @@ public:
 
   static GraphTopology Copy(const GraphTopology& that) noexcept;
 
+  /// Returns a topology over \p adj_indices and \p dests without copying
+  /// them. They must stay valid as long as \p storage, which the topology
+  /// holds on to, is alive. The topology is read only: nothing may modify it
+  /// in place. Copy() of it owns its data as usual.
+  static GraphTopology MakeInPlace(
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      size_t num_edges, std::shared_ptr<const void> storage) noexcept;
+
+  /// Whether the data of this topology belongs to storage it was made in
+  /// place over, see MakeInPlace
+  bool in_place() const noexcept { return storage_ != nullptr; }
+
+  /// Returns a copy of this topology with \p changes applied. Surviving edges
+  /// keep their relative order and insertions are appended to the edges of
+  /// their source node.
+  GraphTopology CopyWithEdgeChanges(
+      const EdgeChangeSet& changes) const noexcept;
+
   uint64_t NumNodes() const noexcept { return adj_indices_.size(); }
 
   uint64_t NumEdges() const noexcept { return dests_.size(); }
@@ -202,6 +251,10 @@ public:
 
   void Print() const noexcept;
 
+  /// Approximate number of bytes held by the arrays of this topology. Used to
+  /// account cached topologies with the MemorySupervisor.
+  virtual size_t ApproxMemUse() const noexcept;
+
 protected:
   const PropertyIndex* edge_property_index_data() const noexcept {
     return edge_prop_indices_.data();
@@ -216,12 +269,17 @@ private:
   // by moving NUMAArrays in this class.
   friend class EdgeShuffleTopology;
   friend class EdgeTypeAwareTopology;
+  friend class CompressedGraphTopology;
 
   NUMAArray<Edge>& GetAdjIndices() noexcept { return adj_indices_; }
   NUMAArray<Node>& GetDests() noexcept { return dests_; }
   PropIndexVec& GetEdgePropIndices() noexcept { return edge_prop_indices_; }
   PropIndexVec& GetNodePropIndices() noexcept { return node_prop_indices_; }
 
+  /// Keeps the data of an in place topology alive; declared before the arrays
+  /// that point into it so that it is released after them
+  std::shared_ptr<const void> storage_;
+
   NUMAArray<Edge> adj_indices_;
   NUMAArray<Node> dests_;
 
@@ -259,6 +317,13 @@ public:
 
   void invalidate() noexcept { is_valid_ = false; }
 
+  /// Free the arrays of this topology and invalidate it. Views still holding
+  /// the topology see an empty graph; caches skip invalid topologies.
+  virtual void Evict() noexcept {
+    Base::operator=(GraphTopology{});
+    invalidate();
+  }
+
   bool is_transposed() const noexcept override {
     return has_transpose_state(RDGTopology::TransposeKind::kYes);
   }
@@ -310,6 +375,21 @@ public:
 
   static std::shared_ptr<EdgeShuffleTopology> Make(RDGTopology* rdg_topo);
 
+  /// Makes a copy of the default topology of \p pg, transposed if
+  /// \p tpose_todo says so, whose edges are sorted by keys[i], where i is the
+  /// property index of the edge, then by destination. Its edge sort state is
+  /// kSortedByEdgeProperty; see TemporalView.
+  static std::shared_ptr<EdgeShuffleTopology> MakeSortedByEdgeKey(
+      const PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_todo,
+      const std::vector<int64_t>& keys) noexcept;
+
+  /// Makes a copy of \p topo with \p changes applied, preserving its
+  /// transpose and edge sort states. Insertions are merged into the already
+  /// sorted adjacency of each node, so no edge is re-sorted.
+  static std::shared_ptr<EdgeShuffleTopology> MakeWithEdgeChanges(
+      const PropertyGraph* pg, const EdgeShuffleTopology& topo,
+      const EdgeChangeSet& changes) noexcept;
+
   katana::Result<RDGTopology> ToRDGTopology() const;
 
   edge_iterator FindEdge(const Node& src, const Node& dst) const noexcept;
@@ -320,13 +400,21 @@ public:
     return FindEdge(src, dst) != OutEdges(src).end();
   }
 
+  /// Edges of \p src whose destination has the most specific type
+  /// \p dst_type. Requires edges sorted by kSortedByNodeType, which keeps them
+  /// contiguous, so this is a binary search.
+  edges_range OutEdgesWithDestType(
+      const PropertyGraph* pg, const Node& src,
+      const EntityTypeID& dst_type) const noexcept;
+
 protected:
   void SortEdgesByDestID() noexcept;
 
   void SortEdgesByTypeThenDest(const PropertyGraph* pg) noexcept;
 
-  void SortEdgesByDestType(
-      const PropertyGraph* pg, const PropIndexVec& node_prop_indices) noexcept;
+  void SortEdgesByDestType(const PropertyGraph* pg) noexcept;
+
+  void SortEdgesByKey(const std::vector<int64_t>& keys) noexcept;
 
   void sortEdges(
       const PropertyGraph* pg,
@@ -341,7 +429,7 @@ protected:
       SortEdgesByTypeThenDest(pg);
       return;
     case RDGTopology::EdgeSortKind::kSortedByNodeType:
-      KATANA_LOG_FATAL("Not implemented yet");
+      SortEdgesByDestType(pg);
       return;
     default:
       KATANA_LOG_FATAL("switch-case fell through");
@@ -404,6 +492,22 @@ public:
   static std::shared_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// Reverse Cuthill-McKee order over the out edges of \p seed_topo: a
+  /// breadth first order visiting neighbors by increasing degree, reversed,
+  /// which keeps the ids of neighboring nodes close together.
+  static std::shared_ptr<ShuffleTopology> MakeReverseCuthillMcKee(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Hub nodes, i.e., nodes with more than the average out degree, first by
+  /// decreasing degree, followed by the other nodes in their original order
+  static std::shared_ptr<ShuffleTopology> MakeHubSorted(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Hub nodes first, then the other nodes, both in their original order.
+  /// Cheaper than hub sorting and keeps any locality of the original order.
+  static std::shared_ptr<ShuffleTopology> MakeHubClustered(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
   static std::shared_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const RDGTopology::NodeSortKind& node_sort_todo,
@@ -420,6 +524,15 @@ public:
     case RDGTopology::NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case RDGTopology::NodeSortKind::kReverseCuthillMcKee:
+      ret = MakeReverseCuthillMcKee(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kHubSorted:
+      ret = MakeHubSorted(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kHubClustered:
+      ret = MakeHubClustered(pg, seed_topo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
@@ -433,6 +546,11 @@ public:
 
   katana::Result<RDGTopology> ToRDGTopology() const;
 
+  /// The node property indices, i.e., the permutation from new to original
+  /// node ids, are persisted with the topology. This builds the inverse, from
+  /// original to new node ids, for callers that remap node data themselves.
+  NUMAArray<Node> MakeOldToNewMap() const noexcept;
+
 private:
   template <typename CmpFunc>
   static std::shared_ptr<ShuffleTopology> MakeNodeSortedTopo(
@@ -449,83 +567,402 @@ private:
         new_to_old.begin(), new_to_old.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.NumNodes());
+    return MakeFromPermutation(seed_topo, new_to_old, node_sort_todo);
+  }
+
+  /// Shuffles the nodes of \p seed_topo so that new node i is old node
+  /// new_to_old[i], keeping the relative order of each node's edges
+  static std::shared_ptr<ShuffleTopology> MakeFromPermutation(
+      const EdgeShuffleTopology& seed_topo, const PropIndexVec& new_to_old,
+      const RDGTopology::NodeSortKind& node_sort_todo) noexcept;
+
+  ShuffleTopology(
+      const RDGTopology::TransposeKind& tpose_todo,
+      const RDGTopology::NodeSortKind& node_sort_todo,
+      const RDGTopology::EdgeSortKind& edge_sort_todo,
+      AdjIndexVec&& adj_indices, PropIndexVec&& node_prop_indices,
+      EdgeDestVec&& dests, PropIndexVec&& edge_prop_indices) noexcept
+      : Base(
+            tpose_todo, edge_sort_todo, std::move(adj_indices),
+            std::move(dests), std::move(edge_prop_indices),
+            std::move(node_prop_indices)),
+        node_sort_state_(node_sort_todo) {}
 
-    NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
+  RDGTopology::NodeSortKind node_sort_state_{RDGTopology::NodeSortKind::kAny};
+};
 
-    PropIndexVec node_prop_indices;
-    node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
+/// A read-only view of a GraphTopology that stores its own copy of the
+/// adjacency indices as uint32_t when the number of edges allows it, halving
+/// the offset array touched by OutEdges(node) and OutDegree(node). Graphs with
+/// 2^32 edges or more fall back to the 64-bit indices of the underlying
+/// topology. Destinations and property indices are always shared with the
+/// underlying topology, which is kept alive by this instance.
+///
+/// PropertyGraphViews::Compact uses this layout over the default topology and
+/// PropertyGraphViews::CompactEdgesSortedByDestID over the topology with edges
+/// sorted by destination. The other views keep the 64-bit indices of their
+/// topologies, so a caller opts in by building one of these two views.
+class KATANA_EXPORT CompactGraphTopology : public GraphTopologyTypes {
+public:
+  using NarrowEdge = uint32_t;
+  using NarrowAdjIndexVec = NUMAArray<NarrowEdge>;
 
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // new_to_old.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, new_to_old.size()),
-        [&](auto i) {
-          // new_to_old[i] gives old node id
-          old_to_new_map[new_to_old[i]] = i;
-          degrees[i] = seed_topo.OutDegree(new_to_old[i]);
-          node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
-        },
-        katana::no_stats());
+  CompactGraphTopology() = default;
+  CompactGraphTopology(CompactGraphTopology&&) = default;
+  CompactGraphTopology& operator=(CompactGraphTopology&&) = default;
 
-    KATANA_LOG_DEBUG_ASSERT(
-        std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
+  CompactGraphTopology(const CompactGraphTopology&) = delete;
+  CompactGraphTopology& operator=(const CompactGraphTopology&) = delete;
 
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
+  virtual ~CompactGraphTopology();
 
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
+  static std::shared_ptr<CompactGraphTopology> Make(
+      std::shared_ptr<const GraphTopology> topo) noexcept;
 
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
+  /// @returns true if \p num_edges can be indexed with NarrowEdge
+  static bool FitsNarrow(uint64_t num_edges) noexcept {
+    return num_edges <= std::numeric_limits<NarrowEdge>::max();
+  }
+
+  bool is_narrow() const noexcept { return is_narrow_; }
 
-    katana::do_all(
-        katana::iterate(seed_topo.Nodes()),
-        [&](auto old_src_id) {
-          auto new_srd_id = old_to_new_map[old_src_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+  const GraphTopology& underlying() const noexcept { return *topo_; }
 
-          for (auto e : seed_topo.OutEdges(old_src_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
-            KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
+  uint64_t NumNodes() const noexcept { return topo_->NumNodes(); }
 
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+  uint64_t NumEdges() const noexcept { return topo_->NumEdges(); }
 
-            new_dest_vec[new_edge_id] = new_edge_dest;
+  edges_range OutEdges() const noexcept { return topo_->OutEdges(); }
 
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] =
-                seed_topo.GetEdgePropertyIndexFromOutEdge(e);
-          }
-          KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
-        },
-        katana::steal(), katana::no_stats());
+  edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    edge_iterator e_beg{node > 0 ? AdjIndex(node - 1) : 0};
+    edge_iterator e_end{AdjIndex(node)};
 
-    return std::make_shared<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeStandardRange(e_beg, e_end);
   }
 
-  ShuffleTopology(
-      const RDGTopology::TransposeKind& tpose_todo,
-      const RDGTopology::NodeSortKind& node_sort_todo,
-      const RDGTopology::EdgeSortKind& edge_sort_todo,
-      AdjIndexVec&& adj_indices, PropIndexVec&& node_prop_indices,
-      EdgeDestVec&& dests, PropIndexVec&& edge_prop_indices) noexcept
-      : Base(
-            tpose_todo, edge_sort_todo, std::move(adj_indices),
-            std::move(dests), std::move(edge_prop_indices),
-            std::move(node_prop_indices)),
-        node_sort_state_(node_sort_todo) {}
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    return topo_->OutEdgeDst(edge_id);
+  }
 
-  RDGTopology::NodeSortKind node_sort_state_{RDGTopology::NodeSortKind::kAny};
+  Node GetEdgeSrc(const Edge& eid) const noexcept {
+    if (!is_narrow_) {
+      return topo_->GetEdgeSrc(eid);
+    }
+    KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+
+    auto it = std::upper_bound(
+        narrow_adj_indices_.begin(), narrow_adj_indices_.end(), eid);
+    KATANA_LOG_DEBUG_ASSERT(it != narrow_adj_indices_.end());
+
+    return static_cast<Node>(std::distance(narrow_adj_indices_.begin(), it));
+  }
+
+  size_t OutDegree(Node node) const noexcept { return OutEdges(node).size(); }
+
+  nodes_range Nodes() const noexcept { return topo_->Nodes(); }
+
+  // Standard container concepts
+
+  node_iterator begin() const noexcept { return topo_->begin(); }
+
+  node_iterator end() const noexcept { return topo_->end(); }
+
+  size_t size() const noexcept { return topo_->size(); }
+
+  bool empty() const noexcept { return topo_->empty(); }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& eid) const noexcept {
+    return topo_->GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept {
+    return topo_->GetNodePropertyIndex(nid);
+  }
+
+  Node GetLocalNodeID(const Node& nid) const noexcept {
+    return topo_->GetLocalNodeID(nid);
+  }
+
+  Edge GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
+    return topo_->GetLocalEdgeIDFromOutEdge(eid);
+  }
+
+  RDGTopology::TransposeKind transpose_state() const noexcept {
+    return topo_->transpose_state();
+  }
+
+  RDGTopology::EdgeSortKind edge_sort_state() const noexcept {
+    return topo_->edge_sort_state();
+  }
+
+  void Print() const noexcept { topo_->Print(); }
+
+private:
+  CompactGraphTopology(
+      std::shared_ptr<const GraphTopology> topo,
+      NarrowAdjIndexVec&& narrow_adj_indices, bool is_narrow) noexcept
+      : topo_(std::move(topo)),
+        narrow_adj_indices_(std::move(narrow_adj_indices)),
+        wide_adj_indices_(topo_->AdjData()),
+        is_narrow_(is_narrow) {}
+
+  Edge AdjIndex(Node node) const noexcept {
+    return is_narrow_ ? Edge{narrow_adj_indices_[node]}
+                      : wide_adj_indices_[node];
+  }
+
+  std::shared_ptr<const GraphTopology> topo_;
+  NarrowAdjIndexVec narrow_adj_indices_;
+  const Edge* wide_adj_indices_{nullptr};
+  bool is_narrow_{false};
+};
+
+/// A read-only CSR topology whose edge destinations are delta + varint
+/// encoded. Edge ids and adjacency indices are identical to the GraphTopology
+/// it was built from; only the destination array is compressed.
+///
+/// Destinations are encoded in blocks of kBlockSize consecutive edges. The
+/// first destination of a block is stored as an absolute LEB128 varint, and
+/// every following one as a zigzag varint delta from its predecessor, so blocks
+/// can be decoded independently of node boundaries and of the edge sort order.
+/// OutEdgeDst() decodes at most kBlockSize - 1 values; use OutNeighbors() to
+/// scan a node's neighbors, which decodes every varint exactly once.
+///
+/// The encoded blob has the layout:
+/// [uint64_t num_blocks][uint64_t block_offsets[num_blocks]][varint bytes]
+class KATANA_EXPORT CompressedGraphTopology : public GraphTopologyTypes {
+public:
+  static constexpr Edge kBlockSize = 64;
+
+  using EncodedDestVec = NUMAArray<uint8_t>;
+
+  /// Sequentially decodes the destinations of a range of edges
+  class neighbor_iterator
+      : public boost::iterator_facade<
+            neighbor_iterator, const Node, boost::forward_traversal_tag,
+            Node> {
+  public:
+    neighbor_iterator() = default;
+
+  private:
+    friend class boost::iterator_core_access;
+    friend class CompressedGraphTopology;
+
+    neighbor_iterator(const uint8_t* cursor, Edge edge, Node dst) noexcept
+        : cursor_(cursor), edge_(edge), dst_(dst) {}
+
+    Node dereference() const noexcept { return dst_; }
+
+    bool equal(const neighbor_iterator& that) const noexcept {
+      return edge_ == that.edge_;
+    }
+
+    void increment() noexcept {
+      ++edge_;
+      // cursor_ may point past the encoded bytes once edge_ reaches the end
+      // of the range, so only decode when a value is actually present.
+      if (edge_ < end_) {
+        uint64_t raw = DecodeVarint(&cursor_);
+        dst_ = (edge_ % kBlockSize == 0)
+                   ? static_cast<Node>(raw)
+                   : static_cast<Node>(dst_ + UnZigZag(raw));
+      }
+    }
+
+    const uint8_t* cursor_{nullptr};
+    Edge edge_{0};
+    Edge end_{0};
+    Node dst_{0};
+  };
+
+  using neighbors_range = StandardRange<neighbor_iterator>;
+
+  CompressedGraphTopology() = default;
+  CompressedGraphTopology(CompressedGraphTopology&&) = default;
+  CompressedGraphTopology& operator=(CompressedGraphTopology&&) = default;
+
+  CompressedGraphTopology(const CompressedGraphTopology&) = delete;
+  CompressedGraphTopology& operator=(const CompressedGraphTopology&) = delete;
+
+  virtual ~CompressedGraphTopology();
+
+  /// Encode the destinations of \p topo. Property index maps and the
+  /// transpose and edge sort states are carried over from \p topo.
+  static std::shared_ptr<CompressedGraphTopology> Make(
+      const GraphTopology& topo) noexcept;
+
+  static std::shared_ptr<CompressedGraphTopology> Make(RDGTopology* rdg_topo);
+
+  katana::Result<RDGTopology> ToRDGTopology() const;
+
+  uint64_t NumNodes() const noexcept { return adj_indices_.size(); }
+
+  uint64_t NumEdges() const noexcept { return num_edges_; }
+
+  const Edge* AdjData() const noexcept { return adj_indices_.data(); }
+
+  /// Size in bytes of the encoded destinations, including the block index
+  uint64_t EncodedDestSize() const noexcept { return encoded_dests_.size(); }
+
+  edges_range OutEdges() const noexcept {
+    return MakeStandardRange<edge_iterator>(Edge{0}, Edge{NumEdges()});
+  }
+
+  edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node <= adj_indices_.size());
+    edge_iterator e_beg{node > 0 ? adj_indices_[node - 1] : 0};
+    edge_iterator e_end{adj_indices_[node]};
+
+    return MakeStandardRange(e_beg, e_end);
+  }
+
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < NumEdges());
+    const uint8_t* cursor = BlockStart(edge_id);
+    return DecodeUpTo(&cursor, edge_id);
+  }
+
+  /// Destinations of the out-edges of \p node, in edge order
+  neighbors_range OutNeighbors(Node node) const noexcept {
+    auto edges = OutEdges(node);
+    return MakeNeighborsRange(*edges.begin(), *edges.end());
+  }
+
+  Node GetEdgeSrc(const Edge& eid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+
+    auto it = std::upper_bound(adj_indices_.begin(), adj_indices_.end(), eid);
+    KATANA_LOG_DEBUG_ASSERT(it != adj_indices_.end());
+
+    return static_cast<Node>(std::distance(adj_indices_.begin(), it));
+  }
+
+  size_t OutDegree(Node node) const noexcept { return OutEdges(node).size(); }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
+
+  // Standard container concepts
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(NumNodes()); }
+
+  size_t size() const noexcept { return NumNodes(); }
+
+  bool empty() const noexcept { return NumNodes() == 0; }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& eid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+    return edge_prop_indices_.empty() ? eid : edge_prop_indices_[eid];
+  }
+
+  PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(nid < NumNodes());
+    return node_prop_indices_.empty() ? nid : node_prop_indices_[nid];
+  }
+
+  Node GetLocalNodeID(const Node& nid) const noexcept {
+    return static_cast<Node>(GetNodePropertyIndex(nid));
+  }
+
+  Edge GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
+    return GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  bool has_transpose_state(
+      const RDGTopology::TransposeKind& expected) const noexcept {
+    return (expected == RDGTopology::TransposeKind::kAny) ||
+           (tpose_state_ == expected);
+  }
+
+  RDGTopology::TransposeKind transpose_state() const noexcept {
+    return tpose_state_;
+  }
+
+  RDGTopology::EdgeSortKind edge_sort_state() const noexcept {
+    return edge_sort_state_;
+  }
+
+  void Print() const noexcept;
+
+private:
+  CompressedGraphTopology(
+      const RDGTopology::TransposeKind& tpose_state,
+      const RDGTopology::EdgeSortKind& edge_sort_state, uint64_t num_edges,
+      AdjIndexVec&& adj_indices, EncodedDestVec&& encoded_dests,
+      PropIndexVec&& edge_prop_indices,
+      PropIndexVec&& node_prop_indices) noexcept
+      : adj_indices_(std::move(adj_indices)),
+        encoded_dests_(std::move(encoded_dests)),
+        edge_prop_indices_(std::move(edge_prop_indices)),
+        node_prop_indices_(std::move(node_prop_indices)),
+        num_edges_(num_edges),
+        tpose_state_(tpose_state),
+        edge_sort_state_(edge_sort_state) {}
+
+  static uint64_t DecodeVarint(const uint8_t** cursor) noexcept {
+    const uint8_t* p = *cursor;
+    uint64_t val = *p & 0x7f;
+    for (uint32_t shift = 7; *p++ & 0x80; shift += 7) {
+      val |= static_cast<uint64_t>(*p & 0x7f) << shift;
+    }
+    *cursor = p;
+    return val;
+  }
+
+  static int64_t UnZigZag(uint64_t val) noexcept {
+    return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+  }
+
+  const uint64_t* block_offsets() const noexcept {
+    return reinterpret_cast<const uint64_t*>(encoded_dests_.data()) + 1;
+  }
+
+  const uint8_t* BlockStart(Edge edge_id) const noexcept {
+    const uint64_t* offsets = block_offsets();
+    const uint64_t num_blocks = offsets[-1];
+    const uint8_t* bytes =
+        reinterpret_cast<const uint8_t*>(offsets + num_blocks);
+    return bytes + offsets[edge_id / kBlockSize];
+  }
+
+  /// Decode from the start of edge_id's block up to and including edge_id.
+  /// Leaves \p cursor just past the encoding of edge_id.
+  static Node DecodeUpTo(const uint8_t** cursor, Edge edge_id) noexcept {
+    Node dst = static_cast<Node>(DecodeVarint(cursor));
+    for (Edge e = edge_id - edge_id % kBlockSize + 1; e <= edge_id; ++e) {
+      dst = static_cast<Node>(dst + UnZigZag(DecodeVarint(cursor)));
+    }
+    return dst;
+  }
+
+  neighbors_range MakeNeighborsRange(Edge beg, Edge end) const noexcept {
+    neighbor_iterator it_end{nullptr, end, 0};
+    if (beg == end) {
+      return neighbors_range{it_end, it_end};
+    }
+    const uint8_t* cursor = BlockStart(beg);
+    Node dst = DecodeUpTo(&cursor, beg);
+    neighbor_iterator it_beg{cursor, beg, dst};
+    it_beg.end_ = end;
+    return neighbors_range{it_beg, it_end};
+  }
+
+  AdjIndexVec adj_indices_;
+  EncodedDestVec encoded_dests_;
+  PropIndexVec edge_prop_indices_;
+  PropIndexVec node_prop_indices_;
+  uint64_t num_edges_{0};
+
+  RDGTopology::TransposeKind tpose_state_{RDGTopology::TransposeKind::kNo};
+  RDGTopology::EdgeSortKind edge_sort_state_{RDGTopology::EdgeSortKind::kAny};
 };
 
 namespace internal {
@@ -832,6 +1269,15 @@ public:
 
   katana::Result<RDGTopology> ToRDGTopology() const;
 
+  size_t ApproxMemUse() const noexcept override {
+    return Base::ApproxMemUse() + per_type_adj_indices_.size() * sizeof(Edge);
+  }
+
+  void Evict() noexcept override {
+    per_type_adj_indices_ = AdjIndexVec{};
+    Base::Evict();
+  }
+
 private:
   // Must invoke SortAllEdgesByDataThenDst() before
   // calling this function
@@ -886,6 +1332,15 @@ public:
     return topo().OutEdgeDst(eid);
   }
 
+  /// End of the out-edges of each node, indexed by node id, i.e., the row
+  /// index of the CSR. Only available when Topo stores it contiguously.
+  const Edge* AdjData() const noexcept { return topo().AdjData(); }
+
+  /// Destinations of all edges, indexed by edge id. Only available when Topo
+  /// stores them contiguously, which lets callers hand adjacency lists to
+  /// kernels such as SortedIntersectionCount.
+  const Node* DestData() const noexcept { return topo().DestData(); }
+
   auto GetEdgeSrc(const Edge& eid) const noexcept {
     return topo().GetEdgeSrc(eid);
   }
@@ -924,6 +1379,11 @@ public:
   }
   void Print() const noexcept { topo_ptr_->Print(); }
 
+  /// The topology this view wraps, e.g., to find data laid out in its order
+  const std::shared_ptr<const Topo>& topology_ptr() const noexcept {
+    return topo_ptr_;
+  }
+
 protected:
   const Topo& topo() const noexcept { return *topo_ptr_.get(); }
 
@@ -1140,6 +1600,197 @@ public:
   }
 };
 
+template <typename Topo>
+class DestTypeSortedTopologyWrapper : public BasicTopologyWrapper<Topo> {
+  using Base = BasicTopologyWrapper<Topo>;
+
+public:
+  using typename Base::Node;
+
+  DestTypeSortedTopologyWrapper(
+      const PropertyGraph* pg, std::shared_ptr<const Topo> t) noexcept
+      : Base(std::move(t)), pg_(pg) {
+    KATANA_LOG_DEBUG_ASSERT(Base::topo().has_edges_sorted_by(
+        RDGTopology::EdgeSortKind::kSortedByNodeType));
+  }
+
+  /// Edges of \p src to nodes of type \p dst_type
+  auto OutEdges(const Node& src, const EntityTypeID& dst_type) const noexcept {
+    return Base::topo().OutEdgesWithDestType(pg_, src, dst_type);
+  }
+
+  using Base::OutEdges;
+
+private:
+  const PropertyGraph* pg_;
+};
+
+/// Bitmaps of the out neighbors of the hub nodes of a topology, i.e., nodes
+/// whose degree is at least the hub threshold. Intersecting the neighbors of a
+/// hub with those of another node then costs one bit test per neighbor of the
+/// other node, or a word-level AND plus popcount when both are hubs.
+///
+/// The threshold is never below NumNodes() / 32, so that a bitmap is never
+/// larger than the 32-bit adjacency list it mirrors. Bitmaps record distinct
+/// neighbors, so counts only match merge based intersection on graphs without
+/// parallel edges. Make takes a topology whose edges are sorted by
+/// destination.
+class KATANA_EXPORT HubAdjacencyBitmaps : public GraphTopologyTypes {
+public:
+  static constexpr uint32_t kNotHub = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t kDefaultMinHubDegree = 1024;
+
+  HubAdjacencyBitmaps() = default;
+  HubAdjacencyBitmaps(HubAdjacencyBitmaps&&) = default;
+  HubAdjacencyBitmaps& operator=(HubAdjacencyBitmaps&&) = default;
+
+  HubAdjacencyBitmaps(const HubAdjacencyBitmaps&) = delete;
+  HubAdjacencyBitmaps& operator=(const HubAdjacencyBitmaps&) = delete;
+
+  static std::shared_ptr<HubAdjacencyBitmaps> Make(
+      const GraphTopology& topo,
+      size_t min_hub_degree = kDefaultMinHubDegree) noexcept;
+
+  /// The min hub degree of the hub bitmap views: kDefaultMinHubDegree, or
+  /// the value of KATANA_MIN_HUB_DEGREE if it is set to a positive number,
+  /// e.g., to take the hub paths on small graphs
+  static size_t ViewMinHubDegree() noexcept;
+
+  size_t hub_threshold() const noexcept { return hub_threshold_; }
+
+  size_t num_hubs() const noexcept { return bitmaps_.size(); }
+
+  /// Whether some node has more than one edge to the same destination
+  bool has_parallel_edges() const noexcept { return has_parallel_edges_; }
+
+  bool IsHub(Node n) const noexcept {
+    return !hub_index_.empty() && hub_index_[n] != kNotHub;
+  }
+
+  /// Requires IsHub(n)
+  const DynamicBitset& Bitmap(Node n) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(IsHub(n));
+    return bitmaps_[hub_index_[n]];
+  }
+
+  /// Number of nodes in [lo, hi) in both \p a and \p b
+  static size_t CountCommon(
+      const DynamicBitset& a, const DynamicBitset& b, Node lo,
+      Node hi) noexcept;
+
+private:
+  size_t hub_threshold_{0};
+  bool has_parallel_edges_{false};
+  NUMAArray<uint32_t> hub_index_;
+  std::vector<DynamicBitset> bitmaps_;
+};
+
+/// A SortedTopologyWrapper whose hub nodes also have adjacency bitmaps; see
+/// HubAdjacencyBitmaps. All other nodes are only in CSR.
+template <typename Topo>
+class HubBitmapTopologyWrapper : public SortedTopologyWrapper<Topo> {
+  using Base = SortedTopologyWrapper<Topo>;
+
+public:
+  using typename Base::Node;
+
+  HubBitmapTopologyWrapper(
+      std::shared_ptr<const Topo> t,
+      std::shared_ptr<const HubAdjacencyBitmaps> hubs) noexcept
+      : Base(std::move(t)), hubs_(std::move(hubs)) {
+    KATANA_LOG_DEBUG_ASSERT(hubs_);
+  }
+
+  bool IsHub(const Node& n) const noexcept { return hubs_->IsHub(n); }
+
+  const HubAdjacencyBitmaps& hubs() const noexcept { return *hubs_; }
+
+  auto HasEdge(const Node& src, const Node& dst) const noexcept {
+    if (hubs_->IsHub(src)) {
+      return hubs_->Bitmap(src).test(dst);
+    }
+    return Base::HasEdge(src, dst);
+  }
+
+  /// Number of neighbors in [lo, hi) shared by \p a and \p b
+  size_t CountCommonNeighbors(
+      const Node& a, const Node& b, const Node& lo,
+      const Node& hi) const noexcept {
+    if (lo >= hi) {
+      return 0;
+    }
+    bool a_hub = hubs_->IsHub(a);
+    bool b_hub = hubs_->IsHub(b);
+    if (a_hub && b_hub) {
+      return HubAdjacencyBitmaps::CountCommon(
+          hubs_->Bitmap(a), hubs_->Bitmap(b), lo, hi);
+    }
+    if (a_hub || b_hub) {
+      const DynamicBitset& bits = hubs_->Bitmap(a_hub ? a : b);
+      auto [first, last] = OutNeighborsIn(a_hub ? b : a, lo, hi);
+      size_t count = 0;
+      for (const Node* dst = first; dst != last; ++dst) {
+        count += bits.test(*dst);
+      }
+      return count;
+    }
+
+    auto [a_first, a_last] = OutNeighborsIn(a, lo, hi);
+    auto [b_first, b_last] = OutNeighborsIn(b, lo, hi);
+    if (hubs_->has_parallel_edges()) {
+      return SortedMultisetIntersectionCount(
+          a_first, a_last - a_first, b_first, b_last - b_first);
+    }
+    return SortedIntersectionCount(
+        a_first, a_last - a_first, b_first, b_last - b_first);
+  }
+
+private:
+  /// The destinations of the out edges of \p n that are in [lo, hi)
+  std::pair<const Node*, const Node*> OutNeighborsIn(
+      const Node& n, const Node& lo, const Node& hi) const noexcept {
+    auto edges = Base::OutEdges(n);
+    const Node* first = Base::DestData() + *edges.begin();
+    const Node* last = first + edges.size();
+    first = std::lower_bound(first, last, lo);
+    last = std::lower_bound(first, last, hi);
+    return {first, last};
+  }
+
+  std::shared_ptr<const HubAdjacencyBitmaps> hubs_;
+};
+
+class KATANA_EXPORT CompressedTopologyWrapper
+    : public BasicTopologyWrapper<CompressedGraphTopology> {
+  using Base = BasicTopologyWrapper<CompressedGraphTopology>;
+
+public:
+  explicit CompressedTopologyWrapper(
+      std::shared_ptr<const CompressedGraphTopology> t) noexcept
+      : Base(std::move(t)) {}
+
+  /// Prefer this over OutEdgeDst() when visiting all neighbors of a node
+  auto OutNeighbors(const Node& N) const noexcept {
+    return Base::topo().OutNeighbors(N);
+  }
+};
+
+/// A CompactGraphTopology over a topology whose edges are sorted by
+/// destination
+class KATANA_EXPORT CompactEdgesSortedByDestTopology
+    : public BasicTopologyWrapper<CompactGraphTopology> {
+  using Base = BasicTopologyWrapper<CompactGraphTopology>;
+
+public:
+  explicit CompactEdgesSortedByDestTopology(
+      std::shared_ptr<const CompactGraphTopology> t) noexcept
+      : Base(std::move(t)) {
+    KATANA_LOG_DEBUG_ASSERT(
+        Base::topo().edge_sort_state() ==
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+  }
+};
+
 class KATANA_EXPORT EdgeTypeAwareBiDirTopology
     : public BasicBiDirTopoWrapper<
           EdgeTypeAwareTopology, EdgeTypeAwareTopology> {
@@ -1407,6 +2058,29 @@ struct PGViewBuilder<PGViewEdgesSortedByDestID> {
   }
 };
 
+// Edges sorted by destination node type view
+
+using EdgesSortedByDestTypeTopology =
+    DestTypeSortedTopologyWrapper<EdgeShuffleTopology>;
+using PGViewEdgesSortedByDestType =
+    BasicPropGraphViewWrapper<EdgesSortedByDestTypeTopology>;
+
+template <>
+struct PGViewBuilder<PGViewEdgesSortedByDestType> {
+  template <typename ViewCache>
+  static PGViewEdgesSortedByDestType BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo,
+        RDGTopology::EdgeSortKind::kSortedByNodeType);
+
+    // The default topology is not reseated: sorting by destination id is more
+    // useful to it, and it can only be reseated once.
+    return PGViewEdgesSortedByDestType{
+        pg, EdgesSortedByDestTypeTopology{pg, sorted_topo}};
+  }
+};
+
 // Nodes sorted by degree, edges sorted by destination view
 
 using NodesSortedByDegreeEdgesSortedByDestIDTopology =
@@ -1429,6 +2103,91 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   }
 };
 
+// Nodes reordered for locality, edges sorted by destination views. Node
+// properties are not moved; GetNodePropertyIndex maps a new node id to the
+// original one.
+
+template <RDGTopology::NodeSortKind kNodeSort>
+class NodeOrderedTopologyWrapper
+    : public SortedTopologyWrapper<ShuffleTopology> {
+  using Base = SortedTopologyWrapper<ShuffleTopology>;
+
+public:
+  explicit NodeOrderedTopologyWrapper(
+      std::shared_ptr<const ShuffleTopology> t) noexcept
+      : Base(std::move(t)) {
+    KATANA_LOG_DEBUG_ASSERT(Base::topo().has_nodes_sorted_by(kNodeSort));
+  }
+};
+
+template <RDGTopology::NodeSortKind kNodeSort>
+using PGViewNodesOrderedEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<NodeOrderedTopologyWrapper<kNodeSort>>;
+
+template <RDGTopology::NodeSortKind kNodeSort>
+struct PGViewBuilder<PGViewNodesOrderedEdgesSortedByDestID<kNodeSort>> {
+  template <typename ViewCache>
+  static PGViewNodesOrderedEdgesSortedByDestID<kNodeSort> BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo, kNodeSort,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+
+    return PGViewNodesOrderedEdgesSortedByDestID<kNodeSort>{
+        pg, NodeOrderedTopologyWrapper<kNodeSort>{sorted_topo}};
+  }
+};
+
+// Sorted views with bitmaps for the hub nodes
+
+using EdgesSortedByDestIDHubBitmapsTopology =
+    HubBitmapTopologyWrapper<EdgeShuffleTopology>;
+using PGViewEdgesSortedByDestIDHubBitmaps =
+    BasicPropGraphViewWrapper<EdgesSortedByDestIDHubBitmapsTopology>;
+
+template <>
+struct PGViewBuilder<PGViewEdgesSortedByDestIDHubBitmaps> {
+  template <typename ViewCache>
+  static PGViewEdgesSortedByDestIDHubBitmaps BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+
+    viewCache.ReseatDefaultTopo(sorted_topo);
+
+    auto hubs = HubAdjacencyBitmaps::Make(
+        *sorted_topo, HubAdjacencyBitmaps::ViewMinHubDegree());
+    return PGViewEdgesSortedByDestIDHubBitmaps{
+        pg,
+        EdgesSortedByDestIDHubBitmapsTopology{sorted_topo, std::move(hubs)}};
+  }
+};
+
+using NodesSortedByDegreeEdgesSortedByDestIDHubBitmapsTopology =
+    HubBitmapTopologyWrapper<ShuffleTopology>;
+using PGViewNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps =
+    BasicPropGraphViewWrapper<
+        NodesSortedByDegreeEdgesSortedByDestIDHubBitmapsTopology>;
+
+template <>
+struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps> {
+  template <typename ViewCache>
+  static PGViewNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo,
+        RDGTopology::NodeSortKind::kSortedByDegree,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+
+    auto hubs = HubAdjacencyBitmaps::Make(
+        *sorted_topo, HubAdjacencyBitmaps::ViewMinHubDegree());
+    return PGViewNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps{
+        pg, NodesSortedByDegreeEdgesSortedByDestIDHubBitmapsTopology{
+                sorted_topo, std::move(hubs)}};
+  }
+};
+
 // Bidirectional view
 
 using SimpleBiDirTopology =
@@ -1492,6 +2251,54 @@ struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
   }
 };
 
+// Compact view
+
+using CompactTopology = BasicTopologyWrapper<CompactGraphTopology>;
+using PGViewCompact = BasicPropGraphViewWrapper<CompactTopology>;
+
+template <>
+struct PGViewBuilder<PGViewCompact> {
+  template <typename ViewCache>
+  static PGViewCompact BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto compact_topo = viewCache.BuildOrGetCompactTopo(pg);
+
+    return PGViewCompact{pg, CompactTopology{compact_topo}};
+  }
+};
+
+// Compact view of the edges sorted by destination
+
+using PGViewCompactEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<CompactEdgesSortedByDestTopology>;
+
+template <>
+struct PGViewBuilder<PGViewCompactEdgesSortedByDestID> {
+  template <typename ViewCache>
+  static PGViewCompactEdgesSortedByDestID BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto compact_topo = viewCache.BuildOrGetCompactSortedTopo(pg);
+
+    return PGViewCompactEdgesSortedByDestID{
+        pg, CompactEdgesSortedByDestTopology{compact_topo}};
+  }
+};
+
+// Compressed view
+
+using PGViewCompressed = BasicPropGraphViewWrapper<CompressedTopologyWrapper>;
+
+template <>
+struct PGViewBuilder<PGViewCompressed> {
+  template <typename ViewCache>
+  static PGViewCompressed BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto compressed_topo = viewCache.BuildOrGetCompressedTopo(pg);
+
+    return PGViewCompressed{pg, CompressedTopologyWrapper{compressed_topo}};
+  }
+};
+
 }  // end namespace internal
 
 struct PropertyGraphViews {
@@ -1500,9 +2307,26 @@ struct PropertyGraphViews {
   using BiDirectional = internal::PGViewBiDirectional;
   using Undirected = internal::PGViewUnDirected;
   using EdgesSortedByDestID = internal::PGViewEdgesSortedByDestID;
+  using EdgesSortedByDestType = internal::PGViewEdgesSortedByDestType;
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
+  using Compressed = internal::PGViewCompressed;
+  using Compact = internal::PGViewCompact;
+  using CompactEdgesSortedByDestID = internal::PGViewCompactEdgesSortedByDestID;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
+  using NodesSortedByRCMEdgesSortedByDestID =
+      internal::PGViewNodesOrderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kReverseCuthillMcKee>;
+  using NodesHubSortedEdgesSortedByDestID =
+      internal::PGViewNodesOrderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kHubSorted>;
+  using NodesHubClusteredEdgesSortedByDestID =
+      internal::PGViewNodesOrderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kHubClustered>;
+  using EdgesSortedByDestIDHubBitmaps =
+      internal::PGViewEdgesSortedByDestIDHubBitmaps;
+  using NodesSortedByDegreeEdgesSortedByDestIDHubBitmaps =
+      internal::PGViewNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps;
 };
 
 class KATANA_EXPORT PGViewCache {
@@ -1512,11 +2336,78 @@ class KATANA_EXPORT PGViewCache {
   std::vector<std::shared_ptr<EdgeShuffleTopology>> edge_shuff_topos_;
   std::vector<std::shared_ptr<ShuffleTopology>> fully_shuff_topos_;
   std::vector<std::shared_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
+  std::shared_ptr<CompressedGraphTopology> compressed_topo_;
+  std::shared_ptr<CompactGraphTopology> compact_topo_;
+  std::shared_ptr<CompactGraphTopology> compact_sorted_topo_;
   std::shared_ptr<CondensedTypeIDMap> edge_type_id_map_;
   // TODO(amber): define a node_type_id_map_;
 
+  /// A copy of a property column in the order of a topology, see
+  /// BuildOrGetPropertyInTopologyOrder
+  struct PermutedProperty {
+    std::weak_ptr<const GraphTopology> topo;
+    std::weak_ptr<arrow::ChunkedArray> source;
+    bool is_edge;
+    std::shared_ptr<arrow::Array> permuted;
+  };
+  std::vector<PermutedProperty> permuted_props_;
+
+  /// How long building each cached topology took, for the ones built in this
+  /// session rather than loaded from storage or updated by ApplyEdgeChanges
+  std::unordered_map<const void*, std::chrono::steady_clock::duration>
+      build_times_;
+  /// Topologies that took less than this to build are not persisted
+  std::chrono::steady_clock::duration min_persisted_build_time_{0};
+
+  // Incremented every time the cached topologies are changed in place
+  uint64_t version_{0};
+
+  /// Tracks the memory of the cached edge shuffled, shuffled and edge type
+  /// aware topologies with the MemorySupervisor's TopologyManager. Moving
+  /// transfers the tracked topologies; destruction stops tracking them.
+  class TopologyAccounting {
+  public:
+    TopologyAccounting() = default;
+    TopologyAccounting(TopologyAccounting&& other) noexcept;
+    TopologyAccounting& operator=(TopologyAccounting&& other) noexcept;
+    ~TopologyAccounting();
+
+    TopologyAccounting(const TopologyAccounting&) = delete;
+    TopologyAccounting& operator=(const TopologyAccounting&) = delete;
+
+    /// Start tracking a newly built topology as active memory
+    void Track(const GraphTopology* topo) noexcept;
+    /// A cached topology is handed out again; makes it active if it was
+    /// standby
+    void Reused(const GraphTopology* topo) noexcept;
+    /// Stop tracking a topology that is no longer cached
+    void Untrack(const GraphTopology* topo) noexcept;
+    /// Stop tracking all topologies
+    void Clear() noexcept;
+
+    bool is_standby(const GraphTopology* topo) const noexcept;
+
+    /// Offer an unused topology to the supervisor as standby memory. The
+    /// evictor is invoked if the supervisor later reclaims it. Returns false if
+    /// the supervisor refused it, in which case it is no longer tracked and
+    /// the caller should drop it.
+    bool MakeStandby(
+        const GraphTopology* topo, std::function<void()> evictor) noexcept;
+
+  private:
+    struct Tracked {
+      uint64_t id;
+      bool standby;
+    };
+    std::unordered_map<const GraphTopology*, Tracked> tracked_;
+  };
+
+  TopologyAccounting accounting_;
+
   template <typename>
   friend struct internal::PGViewBuilder;
+  // for the cache of the statistics of the default topology
+  friend class PropertyGraph;
 
 public:
   PGViewCache() = default;
@@ -1531,9 +2422,12 @@ public:
 
   template <typename PGView>
   PGView BuildView(PropertyGraph* pg) noexcept {
+    ReleaseUnusedTopologies();
     return internal::PGViewBuilder<PGView>::BuildView(pg, *this);
   }
 
+  /// The cached topologies to store with the graph, see
+  /// set_min_persisted_build_time
   katana::Result<std::vector<RDGTopology>> ToRDGTopology();
 
   template <typename PGView>
@@ -1550,6 +2444,39 @@ public:
   // Purge cache and construct an empty topology as the default one.
   void DropAllTopologies() noexcept;
 
+  /// Hand the cached topologies that no view refers to over to the
+  /// MemorySupervisor as standby memory, so that they can be evicted under
+  /// memory pressure. Evicted topologies are purged from the cache here and
+  /// rebuilt on demand.
+  void ReleaseUnusedTopologies() noexcept;
+
+  /// Apply a batch of edge insertions and deletions to the default topology
+  /// and update the cached topologies in place rather than dropping them.
+  /// Edge shuffled and edge type aware topologies are updated by merging the
+  /// sorted batch into each node's adjacency; the remaining topologies are
+  /// dropped and rebuilt on demand. Views built before this call keep
+  /// referring to the previous version of the topologies.
+  katana::Result<void> ApplyEdgeChanges(
+      PropertyGraph* pg, const EdgeChangeSet& changes) noexcept;
+
+  /// Number of times ApplyEdgeChanges has updated this cache
+  uint64_t version() const noexcept { return version_; }
+
+  /// Only persist the cached topologies, see ToRDGTopology, that took at
+  /// least \p min_build_time to build. Cheaper ones are rebuilt after the
+  /// graph is loaded again rather than stored. Topologies loaded from storage
+  /// or updated by ApplyEdgeChanges are always persisted. Zero, the default,
+  /// persists all of them.
+  void set_min_persisted_build_time(
+      std::chrono::steady_clock::duration min_build_time) noexcept {
+    min_persisted_build_time_ = min_build_time;
+  }
+
+  std::chrono::steady_clock::duration min_persisted_build_time()
+      const noexcept {
+    return min_persisted_build_time_;
+  }
+
 private:
   std::shared_ptr<GraphTopology> GetDefaultTopology() const noexcept;
 
@@ -1559,6 +2486,13 @@ private:
   std::shared_ptr<CondensedTypeIDMap> BuildOrGetEdgeTypeIndex(
       const PropertyGraph* pg) noexcept;
 
+  // Records how long topo took to build since start, or that it was loaded
+  void RecordBuildTime(
+      const void* topo, bool loaded,
+      std::chrono::steady_clock::time_point start) noexcept;
+
+  bool ShouldPersist(const void* topo) const noexcept;
+
   // The pop flag ensures that the returned topology is not
   // in the edge_shuff_topos_ cache.
   std::shared_ptr<EdgeShuffleTopology> BuildOrGetEdgeShuffTopoImpl(
@@ -1580,6 +2514,32 @@ private:
 
   std::shared_ptr<EdgeTypeAwareTopology> BuildOrGetEdgeTypeAwareTopo(
       PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_kind) noexcept;
+
+  // Compresses the current default topology, so the compressed view shares
+  // its transpose and edge sort states.
+  std::shared_ptr<CompressedGraphTopology> BuildOrGetCompressedTopo(
+      PropertyGraph* pg) noexcept;
+
+  // Uses 32-bit adjacency indices over the current default topology whenever
+  // its number of edges allows it. Only the compact view is built from it.
+  std::shared_ptr<CompactGraphTopology> BuildOrGetCompactTopo(
+      PropertyGraph* pg) noexcept;
+
+  // Uses 32-bit adjacency indices, whenever the number of edges allows it,
+  // over the topology with edges sorted by destination, which is built or
+  // loaded first.
+  std::shared_ptr<CompactGraphTopology> BuildOrGetCompactSortedTopo(
+      PropertyGraph* pg) noexcept;
+
+  // Copies the edge (or node) property name so that value i of the copy is
+  // the value of edge (or node) i of topo, saving the lookup of the property
+  // index on each access. Copies are cached until topo is dropped or evicted
+  // or the property column is replaced. If topo does not shuffle the
+  // property, returns the column itself.
+  katana::Result<std::shared_ptr<arrow::Array>>
+  BuildOrGetPropertyInTopologyOrder(
+      const PropertyGraph* pg, const std::shared_ptr<const GraphTopology>& topo,
+      const std::string& name, bool is_edge) noexcept;
 };
 
 /// Creates a uniform-random CSR GraphTopology instance, where each node as
@@ -0,0 +1,310 @@
+#ifndef KATANA_LIBGRAPH_KATANA_HASHENTITYINDEX_H_
+#define KATANA_LIBGRAPH_KATANA_HASHENTITYINDEX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <arrow/api.h>
+#include <arrow/array.h>
+#include <arrow/type_traits.h>
+
+#include "katana/EntityIndex.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Random.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+// A hash of key whose low bits, which pick a slot, and high bits, which are
+// the fingerprint, are both well mixed.
+inline uint64_t
+HashKey(uint64_t key) {
+  return Mix64(key);
+}
+
+inline uint64_t
+HashKey(std::string_view key) {
+  return Mix64(std::hash<std::string_view>{}(key));
+}
+
+}  // namespace internal
+
+// HashEntityIndex answers equality lookups over a single property, e.g.,
+// finding a node by its external id, in expected constant time rather than
+// the log2(n) comparisons into the property of an EntityIndex. It does not
+// order the values, so it has no range searches.
+//
+// The index is an open addressing table with linear probing over the
+// distinct values of the property, at most half full. A slot is 8 bytes: a
+// 16 bit fingerprint of the hash of its value, so that probing past another
+// value almost never reads the property, and the group of the value, a
+// range of the ids of the entities that have it. The ids are stored in one
+// NUMAArray grouped by value, by id within a group. The table is built in
+// parallel, and FindBatch looks up many keys at once, prefetching the slots
+// of a block of keys before probing any of them.
+template <typename node_or_edge>
+class KATANA_EXPORT HashEntityIndex {
+public:
+  using iterator = typename EntityIndex<node_or_edge>::iterator;
+
+  // The id that FindBatch returns for a key that no entity has.
+  static constexpr node_or_edge kNotFound =
+      std::numeric_limits<node_or_edge>::max();
+
+  HashEntityIndex(std::string property_name)
+      : property_name_(std::move(property_name)) {}
+
+  HashEntityIndex(const HashEntityIndex&) = delete;
+  HashEntityIndex& operator=(const HashEntityIndex&) = delete;
+  HashEntityIndex(const HashEntityIndex&&) = delete;
+  HashEntityIndex& operator=(const HashEntityIndex&&) = delete;
+
+  virtual ~HashEntityIndex() = default;
+
+  // The name of the indexed property.
+  std::string property_name() const { return property_name_; }
+
+  // The ids of the entities in the index, grouped by value.
+  iterator begin() const { return iterator(ids_.data()); }
+  iterator end() const { return iterator(ids_.data() + num_ids_); }
+
+  // The number of entities in the index.
+  size_t size() const { return num_ids_; }
+
+  // The number of distinct values in the index.
+  size_t num_keys() const { return num_groups_; }
+
+  virtual Result<void> BuildFromProperty() = 0;
+
+protected:
+  static constexpr uint64_t kGroupBits = 48;
+  static constexpr uint64_t kGroupMask = (uint64_t{1} << kGroupBits) - 1;
+  // Keys whose slots FindBatch prefetches before probing them
+  static constexpr size_t kBatchBlock = 16;
+
+  static uint64_t Fingerprint(uint64_t hash) { return hash >> kGroupBits; }
+
+  iterator At(size_t pos) const { return iterator(ids_.data() + pos); }
+
+  // Build the index of the entities in [0, num_entities) with a value in
+  // property; hash(id) is the hash of the value of id and equal(a, b)
+  // whether a and b have the same value.
+  template <typename Hash, typename Equal>
+  Result<void> Build(
+      const arrow::Array& property, size_t num_entities, const Hash& hash,
+      const Equal& equal);
+
+  // The positions in ids_ of the group of the entities whose value has hash
+  // and for which matches(id) is true, or an empty range.
+  template <typename Matches>
+  std::pair<size_t, size_t> Probe(uint64_t hash, const Matches& matches) const {
+    if (num_groups_ == 0) {
+      return {0, 0};
+    }
+    uint64_t fingerprint = Fingerprint(hash);
+    for (uint64_t pos = hash & slot_mask_;; pos = (pos + 1) & slot_mask_) {
+      uint64_t slot = slots_[pos];
+      if (slot == 0) {
+        return {0, 0};
+      }
+      if ((slot >> kGroupBits) != fingerprint) {
+        continue;
+      }
+      uint64_t group = (slot & kGroupMask) - 1;
+      size_t begin = group_offsets_[group];
+      if (matches(ids_[begin])) {
+        return {begin, group_offsets_[group + 1]};
+      }
+    }
+  }
+
+  // Set out[i] to the least id of the entities whose value is the key i of
+  // num_keys, whose hash is hash(i) and which is the value of id if
+  // matches(i, id), or to kNotFound.
+  template <typename Hash, typename Matches>
+  void ProbeBatch(
+      size_t num_keys, const Hash& hash, const Matches& matches,
+      node_or_edge* out) const {
+    size_t num_blocks = (num_keys + kBatchBlock - 1) / kBatchBlock;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_blocks),
+        [&](size_t block) {
+          size_t begin = block * kBatchBlock;
+          size_t end = std::min(begin + kBatchBlock, num_keys);
+          uint64_t hashes[kBatchBlock];
+          for (size_t i = begin; i < end; ++i) {
+            hashes[i - begin] = hash(i);
+            __builtin_prefetch(&slots_[hashes[i - begin] & slot_mask_]);
+          }
+          for (size_t i = begin; i < end; ++i) {
+            auto [first, last] = Probe(
+                hashes[i - begin], [&](node_or_edge id) {
+                  return matches(i, id);
+                });
+            out[i] = first == last ? kNotFound : ids_[first];
+          }
+        },
+        katana::no_stats());
+  }
+
+private:
+  std::string property_name_;
+
+  // The first num_ids_ are the ids of the entities with a value, grouped by
+  // value; the array may be longer.
+  NUMAArray<node_or_edge> ids_;
+  size_t num_ids_{0};
+  // Group g is the positions group_offsets_[g] to group_offsets_[g + 1] of
+  // ids_.
+  NUMAArray<uint64_t> group_offsets_;
+  size_t num_groups_{0};
+  // The fingerprint of a slot is its high 16 bits and its group plus one the
+  // rest; empty slots are 0.
+  NUMAArray<uint64_t> slots_;
+  uint64_t slot_mask_{0};
+};
+
+// PrimitiveHashEntityIndex provides a HashEntityIndex for integer types.
+template <typename node_or_edge, typename c_type>
+class KATANA_EXPORT PrimitiveHashEntityIndex
+    : public HashEntityIndex<node_or_edge> {
+public:
+  using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
+  using iterator = typename HashEntityIndex<node_or_edge>::iterator;
+
+  static_assert(std::is_integral_v<c_type>, "keys must be integers");
+
+  PrimitiveHashEntityIndex(
+      const std::string& property_name, size_t num_entities,
+      std::shared_ptr<arrow::Array> property)
+      : HashEntityIndex<node_or_edge>(property_name),
+        num_entities_(num_entities),
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  // The range of the entities with their property value equal to `key`, by
+  // increasing id.
+  std::pair<iterator, iterator> EqualRange(c_type key) const {
+    auto [begin, end] = this->Probe(
+        internal::HashKey(static_cast<uint64_t>(key)),
+        [&](node_or_edge id) { return property_->Value(id) == key; });
+    return {this->At(begin), this->At(end)};
+  }
+
+  // Returns an iterator to the entity with the least id with its property
+  // value equal to `key`, or end().
+  iterator Find(c_type key) const {
+    auto [begin, end] = EqualRange(key);
+    return begin == end ? this->end() : begin;
+  }
+
+  // Find the entity with the least id for each of num_keys keys, in
+  // parallel, setting out[i] to it or to kNotFound.
+  void FindBatch(const c_type* keys, size_t num_keys, node_or_edge* out) const {
+    this->ProbeBatch(
+        num_keys,
+        [keys](size_t i) {
+          return internal::HashKey(static_cast<uint64_t>(keys[i]));
+        },
+        [&](size_t i, node_or_edge id) {
+          return property_->Value(id) == keys[i];
+        },
+        out);
+  }
+
+private:
+  Result<void> BuildFromProperty() override;
+
+  size_t num_entities_;
+  std::shared_ptr<ArrowArrayType> property_;
+};
+
+// StringHashEntityIndex provides a HashEntityIndex for strings: large
+// strings, or dictionary encoded strings, whose dictionary is hashed once
+// rather than every string of the entities.
+template <typename node_or_edge>
+class KATANA_EXPORT StringHashEntityIndex
+    : public HashEntityIndex<node_or_edge> {
+public:
+  using iterator = typename HashEntityIndex<node_or_edge>::iterator;
+
+  StringHashEntityIndex(
+      const std::string& property_name, size_t num_entities,
+      const std::shared_ptr<arrow::Array>& property)
+      : HashEntityIndex<node_or_edge>(property_name),
+        num_entities_(num_entities),
+        property_(property) {
+    if (property->type_id() != arrow::Type::DICTIONARY) {
+      strings_ = std::static_pointer_cast<arrow::LargeStringArray>(property);
+      return;
+    }
+    const auto& encoded = static_cast<const arrow::DictionaryArray&>(*property);
+    strings_ = std::static_pointer_cast<arrow::LargeStringArray>(
+        encoded.dictionary());
+    codes_ = encoded.indices()->data()->GetValues<int32_t>(1);
+  }
+
+  // The range of the entities with their property value equal to `key`, by
+  // increasing id.
+  std::pair<iterator, iterator> EqualRange(std::string_view key) const {
+    auto [begin, end] = this->Probe(
+        internal::HashKey(key),
+        [&](node_or_edge id) { return ValueOf(id) == key; });
+    return {this->At(begin), this->At(end)};
+  }
+
+  // Returns an iterator to the entity with the least id with its property
+  // value equal to `key`, or end().
+  iterator Find(std::string_view key) const {
+    auto [begin, end] = EqualRange(key);
+    return begin == end ? this->end() : begin;
+  }
+
+  // Find the entity with the least id for each of num_keys keys, in
+  // parallel, setting out[i] to it or to kNotFound.
+  void FindBatch(
+      const std::string_view* keys, size_t num_keys, node_or_edge* out) const {
+    this->ProbeBatch(
+        num_keys, [keys](size_t i) { return internal::HashKey(keys[i]); },
+        [&](size_t i, node_or_edge id) { return ValueOf(id) == keys[i]; },
+        out);
+  }
+
+  // The value of the indexed property of entity id.
+  std::string_view ValueOf(node_or_edge id) const {
+    arrow::util::string_view arrow_view =
+        strings_->GetView(codes_ != nullptr ? codes_[id] : id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
+
+private:
+  Result<void> BuildFromProperty() override;
+
+  size_t num_entities_;
+  // Keeps strings_ and codes_ alive
+  std::shared_ptr<arrow::Array> property_;
+  // The strings of the entities, or the dictionary of their codes
+  std::shared_ptr<arrow::LargeStringArray> strings_;
+  const int32_t* codes_{nullptr};
+};
+
+// Create a HashEntityIndex with the appropriate type for 'property'. Does not
+// build the index.
+template <typename node_or_edge>
+Result<std::unique_ptr<HashEntityIndex<node_or_edge>>> MakeTypedHashEntityIndex(
+    const std::string& property_name, size_t num_entities,
+    std::shared_ptr<arrow::Array> property);
+
+}  // namespace katana
+
+#endif
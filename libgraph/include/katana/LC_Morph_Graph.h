@@ -27,13 +27,17 @@
 #define KATANA_LIBGRAPH_KATANA_LCMORPHGRAPH_H_
 
 #include <type_traits>
+#include <vector>
 
 #include <boost/mpl/if.hpp>
 
 #include "katana/Bag.h"
 #include "katana/Details.h"
 #include "katana/FileGraph.h"
+#include "katana/Loops.h"
 #include "katana/NUMAArray.h"
+#include "katana/NumaMem.h"
+#include "katana/PagePool.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -235,6 +239,8 @@ protected:
   Nodes nodes;
   //! Memory for edges in this graph (memory held in EdgeHolders)
   katana::PerThreadStorage<EdgeHolder*> edgesL;
+  //! Memory for the edges of nodes moved by compactEdges
+  LAptr compactedEdges;
 
   /**
    * Acquire a node for the scope in which the function is called.
@@ -519,6 +525,99 @@ public:
     return it;
   }
 
+  /**
+   * Appends an edge to a node without acquiring it. Unlike addMultiEdge,
+   * which relies on mflag to keep other threads from adding edges to src at
+   * the same time, appendEdge claims the slot of the new edge by atomically
+   * bumping the end of the edges of src, so any number of threads may append
+   * to the same node at once.
+   *
+   * Appends must not run concurrently with reads, removals or other
+   * additions of the edges of src, e.g., a parallel loop that only appends
+   * edges followed by loops that read them. As with addMultiEdge, src must
+   * have been created with room for its edges, and duplicate edges are
+   * added.
+   *
+   * @param src Source node to add edge to
+   * @param dst Destination node of new edge
+   * @param args Other arguments that need to be passed in to construct
+   * a new edge
+   * @returns Iterator to newly added edge
+   */
+  template <typename... Args>
+  edge_iterator appendEdge(GraphNode src, GraphNode dst, Args&&... args) {
+    // __atomic_fetch_add does not scale pointer arithmetic by the size of
+    // the pointee
+    edge_iterator it = __atomic_fetch_add(
+        &src->edgeEnd, sizeof(EdgeInfo), __ATOMIC_RELAXED);
+    KATANA_LOG_DEBUG_ASSERT(it < src->trueEdgeEnd);
+    it->dst = dst;
+    it->construct(std::forward<Args>(args)...);
+    return it;
+  }
+
+  /**
+   * Moves the edges of all nodes into one array in the order of the nodes,
+   * so that the edges of consecutive nodes are adjacent as in a CSR graph,
+   * and frees the per-thread blocks edges were allocated from. Graphs built
+   * concurrently spread the edges of nodes over the blocks of many threads
+   * and keep the unused room of each node; compacting them before a
+   * read-heavy phase gives edge iteration the locality of CSR.
+   *
+   * After compaction, nodes have no room for more edges, so only nodes
+   * created afterwards can get new edges. Invalidates edge iterators. Not
+   * thread-safe: call it outside of parallel loops.
+   */
+  void compactEdges() {
+    std::vector<NodeInfo*> order;
+    std::vector<size_t> offsets{0};
+    for (NodeInfo& n : nodes) {
+      order.emplace_back(&n);
+      offsets.emplace_back(
+          offsets.back() + std::distance(n.edgeBegin, n.edgeEnd));
+    }
+
+    LAptr compacted;
+    EdgeInfo* edges = nullptr;
+    if (offsets.back() > 0) {
+      compacted = largeMallocInterleaved(
+          offsets.back() * sizeof(EdgeInfo), katana::getActiveThreads());
+      edges = reinterpret_cast<EdgeInfo*>(compacted.get());
+    }
+
+    katana::do_all(
+        katana::iterate(size_t{0}, order.size()),
+        [&](size_t i) {
+          NodeInfo* n = order[i];
+          EdgeInfo* out = edges + offsets[i];
+          for (EdgeInfo* e = n->edgeBegin; e != n->edgeEnd; ++e, ++out) {
+            out->dst = e->dst;
+            if constexpr (EdgeInfo::has_value) {
+              out->construct(std::move(e->get()));
+              e->destroy();
+            }
+          }
+          n->edgeBegin = edges + offsets[i];
+          n->edgeEnd = out;
+#ifndef NDEBUG
+          n->trueEdgeEnd = out;
+#endif
+        },
+        katana::steal(), katana::no_stats());
+
+    // No edge is left in the blocks of any thread or in earlier compacted
+    // edges
+    for (unsigned t = 0; t < GetThreadPool().getMaxThreads(); ++t) {
+      EdgeHolder*& holder = *edgesL.getRemote(t);
+      while (holder) {
+        EdgeHolder* next = holder->next;
+        pagePoolFree(holder);
+        holder = next;
+      }
+    }
+    compactedEdges = std::move(compacted);
+  }
+
   /**
    * Remove an edge from the graph.
    *
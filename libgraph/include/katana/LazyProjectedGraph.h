@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGRAPH_KATANA_LAZYPROJECTEDGRAPH_H_
+#define KATANA_LIBGRAPH_KATANA_LAZYPROJECTEDGRAPH_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class KATANA_EXPORT PropertyGraph;
+
+/// A projection of a property graph onto some of its node and edge types, as
+/// PropertyGraph::MakeProjectedGraph makes, that is not materialized: it is a
+/// mask of the nodes and one of the edges of the parent topology, and nodes
+/// and edges keep their ids in the parent. Making one costs a pass of bit
+/// operations over the nodes and edges instead of a new topology and id
+/// mappings, so that many small projections are cheap; one can still be
+/// materialized with PropertyGraph::MakeProjectedGraph when an analytic needs
+/// a topology of its own.
+///
+/// A projection stays valid only as long as the parent and its topology are
+/// not modified.
+class KATANA_EXPORT LazyProjectedGraph : public GraphTopologyTypes {
+public:
+  /// Projects pg onto the nodes of node_types and the edges of edge_types
+  /// between them; an empty list of types selects every node or edge, as
+  /// with MakeProjectedGraph.
+  static LazyProjectedGraph Make(
+      const PropertyGraph& pg, const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types);
+
+  /// Projects pg onto the nodes in node_mask, by node id, and the edges
+  /// between them that are in edge_mask, by edge id of the topology of pg, or
+  /// all of them if edge_mask is null; masks like these are computed by
+  /// FilterNodes and FilterEdges (\ref PropertyQuery.h).
+  static LazyProjectedGraph MakeFromMasks(
+      const PropertyGraph& pg, DynamicBitset node_mask,
+      const DynamicBitset* edge_mask = nullptr);
+
+  const PropertyGraph& parent() const { return *parent_; }
+
+  /// Number of nodes in the projection
+  uint64_t NumNodes() const { return num_nodes_; }
+
+  /// Number of edges in the projection
+  uint64_t NumEdges() const { return num_edges_; }
+
+  /// Whether node n of the parent is in the projection
+  bool HasNode(Node n) const { return nodes_.test(n); }
+
+  /// Whether edge e of the parent topology is in the projection, which
+  /// implies that both of its ends are
+  bool HasEdge(Edge e) const { return edges_.test(e); }
+
+  /// The mask of the nodes of the parent in the projection
+  const DynamicBitset& node_mask() const { return nodes_; }
+
+  /// The mask of the edges of the parent topology in the projection
+  const DynamicBitset& edge_mask() const { return edges_; }
+
+  /// Calls fn(e) for every out edge e of node n of the parent that is in the
+  /// projection
+  template <typename F>
+  void ForEachOutEdge(Node n, const F& fn) const {
+    for (Edge e : topology_->OutEdges(n)) {
+      if (edges_.test(e)) {
+        fn(e);
+      }
+    }
+  }
+
+private:
+  LazyProjectedGraph(const PropertyGraph& pg, const GraphTopology& topology)
+      : parent_(&pg), topology_(&topology) {}
+
+  /// Sets the edges of edges_ between nodes of nodes_ for which has_edge(e)
+  /// and counts the nodes and edges
+  template <typename F>
+  void ProjectEdges(const F& has_edge);
+
+  const PropertyGraph* parent_;
+  const GraphTopology* topology_;
+  DynamicBitset nodes_;
+  DynamicBitset edges_;
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+};
+
+}  // namespace katana
+
+#endif
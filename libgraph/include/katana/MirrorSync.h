@@ -0,0 +1,194 @@
+#ifndef KATANA_LIBGRAPH_KATANA_MIRRORSYNC_H_
+#define KATANA_LIBGRAPH_KATANA_MIRRORSYNC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Keeps the copies of the nodes of a partitioned graph consistent across
+/// hosts between the rounds of a bulk synchronous analytic.
+///
+/// Each node of a partition is either a master, whose value is the
+/// authoritative one, or a mirror of a master on another host. A round
+/// updates values on every host, marking the nodes it changed dirty;
+/// Sync then reduces the dirty mirrors into their masters with a reduction
+/// operator, e.g., min for connected components labels, and broadcasts the
+/// masters that changed back to their mirrors. Only dirty values are sent:
+/// for each pair of hosts, the value of every node they share, a bitset of
+/// the dirty nodes with their values, or the positions of the dirty nodes
+/// with their values, whichever is smallest, and nothing if no node is
+/// dirty. Each phase is one AllToAllBytes of the CommBackend.
+///
+/// The typical way to use it is:
+///
+///   // On each host....
+///   MirrorSync sync = KATANA_CHECKED(MirrorSync::Make(*pg, comm));
+///   do {
+///     katana::do_all(..., [&](auto node) {
+///       if (Relax(node, &labels)) {
+///         sync.MarkDirty(node);
+///       }
+///     });
+///     sync.Sync(labels.data(), [](uint32_t& master, uint32_t mirror) {
+///       if (mirror < master) {
+///         master = mirror;
+///         return true;
+///       }
+///       return false;
+///     });
+///   } while (comm->AllReduceSum({sync.updated().count()})[0] > 0);
+///
+class KATANA_EXPORT MirrorSync {
+public:
+  /// Sync the nodes of the partition of pg, using its master_nodes and
+  /// mirror_nodes; comm must have a task per partition
+  static Result<MirrorSync> Make(const PropertyGraph& pg, CommBackend* comm);
+
+  /// Sync num_nodes local nodes where master_nodes[h] are the local ids of
+  /// the masters mirrored on host h, and mirror_nodes[h] are the local ids
+  /// of the mirrors of masters on host h, in the same order as the
+  /// master_nodes of host h for this host
+  static Result<MirrorSync> Make(
+      CommBackend* comm, uint32_t num_nodes,
+      std::vector<std::vector<uint32_t>> master_nodes,
+      std::vector<std::vector<uint32_t>> mirror_nodes);
+
+  /// Marks the value of node as changed since the last sync. Thread safe.
+  void MarkDirty(uint32_t node) { dirty_.set(node); }
+
+  /// The nodes marked dirty since the last sync
+  const DynamicBitset& dirty() const { return dirty_; }
+
+  /// The nodes whose values the syncs since the last Sync, or since
+  /// ResetUpdated, changed: masters that a reduction changed and mirrors
+  /// that a broadcast wrote, e.g., the frontier of the next round
+  const DynamicBitset& updated() const { return updated_; }
+
+  void ResetUpdated() { updated_.reset(); }
+
+  /// Reduces the values of the dirty mirrors into their masters:
+  /// reduce(T& master, const T& mirror) updates the master and returns true
+  /// if it changed, which marks the master dirty. Collective.
+  template <typename T, typename ReduceFn>
+  void ReduceToMasters(T* values, ReduceFn reduce) {
+    std::vector<std::string> out(comm_->Num);
+    for (uint32_t h = 0; h < comm_->Num; ++h) {
+      out[h] = Pack(mirror_nodes_[h], values);
+    }
+    for (uint32_t h = 0; h < comm_->Num; ++h) {
+      ResetDirty(mirror_nodes_[h]);
+    }
+
+    std::vector<std::string> in = Exchange(out);
+    for (uint32_t h = 0; h < comm_->Num; ++h) {
+      Unpack<T>(in[h], master_nodes_[h], [&](uint32_t node, const T& val) {
+        if (reduce(values[node], val)) {
+          dirty_.set(node);
+          updated_.set(node);
+        }
+      });
+    }
+  }
+
+  /// Writes the values of the dirty masters to their mirrors, after which
+  /// no node is dirty. Collective.
+  template <typename T>
+  void BroadcastToMirrors(T* values) {
+    std::vector<std::string> out(comm_->Num);
+    for (uint32_t h = 0; h < comm_->Num; ++h) {
+      out[h] = Pack(master_nodes_[h], values);
+    }
+    dirty_.reset();
+
+    std::vector<std::string> in = Exchange(out);
+    for (uint32_t h = 0; h < comm_->Num; ++h) {
+      Unpack<T>(in[h], mirror_nodes_[h], [&](uint32_t node, const T& val) {
+        values[node] = val;
+        updated_.set(node);
+      });
+    }
+  }
+
+  /// ResetUpdated, ReduceToMasters and BroadcastToMirrors. Collective.
+  template <typename T, typename ReduceFn>
+  void Sync(T* values, ReduceFn reduce) {
+    ResetUpdated();
+    ReduceToMasters(values, reduce);
+    BroadcastToMirrors(values);
+  }
+
+  /// Bytes sent to other hosts so far
+  uint64_t num_bytes_sent() const { return num_bytes_sent_; }
+
+private:
+  MirrorSync(
+      CommBackend* comm, uint32_t num_nodes,
+      std::vector<std::vector<uint32_t>> master_nodes,
+      std::vector<std::vector<uint32_t>> mirror_nodes);
+
+  /// The header of a message with the dirty nodes of nodes and the
+  /// positions in nodes of the values that follow it
+  std::string Encode(
+      const std::vector<uint32_t>& nodes, size_t value_size,
+      std::vector<uint32_t>* positions) const;
+
+  /// The positions in nodes of the values of msg, which start at
+  /// *values_offset
+  static std::vector<uint32_t> Decode(
+      const std::string& msg, size_t num_nodes, size_t* values_offset);
+
+  void ResetDirty(const std::vector<uint32_t>& nodes);
+
+  std::vector<std::string> Exchange(const std::vector<std::string>& out);
+
+  template <typename T>
+  std::string Pack(const std::vector<uint32_t>& nodes, const T* values) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::vector<uint32_t> positions;
+    std::string msg = Encode(nodes, sizeof(T), &positions);
+    size_t offset = msg.size();
+    msg.resize(offset + positions.size() * sizeof(T));
+    for (size_t i = 0; i < positions.size(); ++i) {
+      std::memcpy(
+          msg.data() + offset + i * sizeof(T), &values[nodes[positions[i]]],
+          sizeof(T));
+    }
+    return msg;
+  }
+
+  template <typename T, typename F>
+  static void Unpack(
+      const std::string& msg, const std::vector<uint32_t>& nodes, F fn) {
+    size_t offset = 0;
+    std::vector<uint32_t> positions = Decode(msg, nodes.size(), &offset);
+    KATANA_LOG_ASSERT(msg.size() == offset + positions.size() * sizeof(T));
+    for (size_t i = 0; i < positions.size(); ++i) {
+      T val;
+      std::memcpy(&val, msg.data() + offset + i * sizeof(T), sizeof(T));
+      fn(nodes[positions[i]], val);
+    }
+  }
+
+  CommBackend* comm_;
+  /// By host; empty for this host
+  std::vector<std::vector<uint32_t>> master_nodes_;
+  std::vector<std::vector<uint32_t>> mirror_nodes_;
+  DynamicBitset dirty_;
+  DynamicBitset updated_;
+  uint64_t num_bytes_sent_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -2,14 +2,20 @@
 #define KATANA_LIBGRAPH_KATANA_PROPERTIES_H_
 
 #include <cassert>
+#include <cstring>
+#include <memory>
+#include <optional>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <arrow/array.h>
 #include <arrow/stl.h>
 #include <arrow/type_fwd.h>
 #include <arrow/type_traits.h>
 
+#include "katana/ArrowInterchange.h"
+#include "katana/CompileTimeIntrospection.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/PODVector.h"
@@ -112,6 +118,12 @@ GetMutableValuesWorkAround(
   return data->template GetMutableValues<T>(i, absolute_offset);
 }
 
+/// Views that read columns of several chunks in place have a Make from
+/// views of the chunks and a ChunkIndex over them, like PODPropertyView
+template <typename View>
+using has_chunked_make_t = decltype(View::Make(
+    std::declval<std::vector<View>&&>(), std::declval<ChunkIndex&&>()));
+
 template <typename>
 struct PropertyViewTuple;
 
@@ -152,23 +164,54 @@ ConstructPropertyView(arrow::Array* array) {
   return ViewType::Make(*t);
 }
 
+/// ConstructPropertyView applies a property view to an arrow::ChunkedArray.
+/// Views that read several chunks in place, like PODPropertyView, view
+/// columns of any number of chunks, so that loading a column never has to
+/// copy its chunks into one array; other views need one chunk.
+///
+/// \tparam   Prop  A property
+/// \param    array A column to apply view to
+/// \returns  The view corresponding to given column or an error if a chunk
+///   cannot be downcast to the array type for the property.
+template <typename Prop>
+Result<PropertyViewType<Prop>>
+ConstructPropertyView(arrow::ChunkedArray* array) {
+  using ViewType = PropertyViewType<Prop>;
+  if (array->num_chunks() == 1) {
+    return ConstructPropertyView<Prop>(array->chunk(0).get());
+  }
+  if constexpr (is_detected_v<internal::has_chunked_make_t, ViewType>) {
+    std::vector<ViewType> chunks;
+    chunks.reserve(array->num_chunks());
+    for (const auto& chunk : array->chunks()) {
+      chunks.emplace_back(
+          KATANA_CHECKED(ConstructPropertyView<Prop>(chunk.get())));
+    }
+    return ViewType::Make(std::move(chunks), ChunkIndex(*array));
+  } else {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "view of a property of type {} needs one chunk, not {}",
+        array->type()->ToString(), array->num_chunks());
+  }
+}
+
 /// ConstructPropertyViews applies ConstructPropertyView to a tuple of
-/// properties.
+/// properties, given as arrow::Arrays or as arrow::ChunkedArrays.
 ///
 /// \tparam   PropTuple a tuple of properties
 ///
 /// \see ConstructPropertyView
-template <typename PropTuple>
+template <typename PropTuple, typename ArrayType>
 Result<std::tuple<>>
-ConstructPropertyViews(
-    const std::vector<arrow::Array*>&, std::index_sequence<>) {
+ConstructPropertyViews(const std::vector<ArrayType*>&, std::index_sequence<>) {
   return Result<std::tuple<>>(std::tuple<>());
 }
 
-template <typename PropTuple, size_t head, size_t... tail>
+template <typename PropTuple, typename ArrayType, size_t head, size_t... tail>
 Result<TupleElements<PropertyViewTuple<PropTuple>, head, tail...>>
 ConstructPropertyViews(
-    const std::vector<arrow::Array*>& arrays,
+    const std::vector<ArrayType*>& arrays,
     std::index_sequence<head, tail...>) {
   using Prop = std::tuple_element_t<head, PropTuple>;
   using View = PropertyViewType<Prop>;
@@ -189,9 +232,9 @@ ConstructPropertyViews(
       std::tuple<View>(std::move(v.value())), std::move(rest.value()));
 }
 
-template <typename PropTuple>
+template <typename PropTuple, typename ArrayType>
 Result<PropertyViewTuple<PropTuple>>
-ConstructPropertyViews(const std::vector<arrow::Array*>& arrays) {
+ConstructPropertyViews(const std::vector<ArrayType*>& arrays) {
   return ConstructPropertyViews<PropTuple>(
       arrays, std::make_index_sequence<std::tuple_size_v<PropTuple>>());
 }
@@ -389,8 +432,37 @@ public:
         array.offset(), array.null_count());
   }
 
+  /// Make a view of a column of several chunks from views of its chunks.
+  /// The view reads the chunks in place, finding the chunk of a row with
+  /// index, rather than needing them copied into one array.
+  static Result<PODPropertyView> Make(
+      std::vector<PODPropertyView>&& chunks, ChunkIndex&& index) {
+    if (chunks.size() != static_cast<size_t>(index.num_chunks())) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "{} chunk views for {} chunks",
+          chunks.size(), index.num_chunks());
+    }
+    size_t length = index.length();
+    size_t null_count = 0;
+    for (const PODPropertyView& chunk : chunks) {
+      if (chunk.chunks_) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "chunk views must be of one chunk");
+      }
+      null_count += chunk.null_count_;
+    }
+    PODPropertyView view(nullptr, nullptr, length, 0, null_count);
+    view.chunks_ =
+        std::make_shared<Chunks>(Chunks{std::move(index), std::move(chunks)});
+    return view;
+  }
+
   bool IsValid(size_t i) const {
     KATANA_LOG_DEBUG_ASSERT(i < length_);
+    if (chunks_) {
+      auto [chunk, index] = chunks_->index.Locate(i);
+      return chunks_->views[chunk].IsValid(index);
+    }
     // if there is no null_bitmap, then we have either all nulls or no nulls
     return null_bitmap_ == nullptr
                ? null_count_ == 0
@@ -399,15 +471,31 @@ public:
 
   size_t size() const { return length_; }
 
-  reference GetValue(size_t i) { return values_[i + offset_]; }
+  reference GetValue(size_t i) {
+    if (chunks_) {
+      return GetChunkedValue(i);
+    }
+    return values_[i + offset_];
+  }
 
-  const_reference GetValue(size_t i) const { return values_[i + offset_]; }
+  const_reference GetValue(size_t i) const {
+    if (chunks_) {
+      return GetChunkedValue(i);
+    }
+    return values_[i + offset_];
+  }
 
   reference operator[](size_t i) { return GetValue(i); }
 
   const_reference operator[](size_t i) const { return GetValue(i); }
 
 private:
+  /// The chunks of a view of several chunks, shared by its copies
+  struct Chunks {
+    ChunkIndex index;
+    std::vector<PODPropertyView> views;
+  };
+
   PODPropertyView(
       T* values, const uint8_t* null_bitmap, size_t length, size_t offset,
       size_t null_count)
@@ -417,9 +505,17 @@ private:
         offset_(offset),
         null_count_(null_count) {}
 
+  reference GetChunkedValue(size_t i) const {
+    auto [chunk, index] = chunks_->index.Locate(i);
+    const PODPropertyView& view = chunks_->views[chunk];
+    return view.values_[index + view.offset_];
+  }
+
   T* values_;
   const uint8_t* null_bitmap_;
   size_t length_, offset_, null_count_;
+  /// Null unless the view is of several chunks
+  std::shared_ptr<Chunks> chunks_;
 };
 
 /// BooleanPropertyReadOnlyView provides a read-only property view over
@@ -490,6 +586,75 @@ private:
   const ArrowArrayType& array_;
 };
 
+/// DictionaryStringPropertyReadOnlyView provides a read-only property view
+/// over dictionary encoded strings, i.e., arrow::DictionaryArrays of
+/// DictionaryStringType (see DictionaryEncodeStrings). Every row holds the
+/// code of its string in the dictionary, so rows can be compared by their
+/// codes: two rows have the same string iff they have the same code, given a
+/// dictionary without duplicates like that of DictionaryEncodeStrings.
+class DictionaryStringPropertyReadOnlyView {
+public:
+  using value_type = std::string;
+  using code_type = int32_t;
+
+  static Result<DictionaryStringPropertyReadOnlyView> Make(
+      const arrow::DictionaryArray& array) {
+    if (!array.type()->Equals(DictionaryStringType())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "Incorrect dictionary type: {}",
+          array.type()->ToString());
+    }
+    return DictionaryStringPropertyReadOnlyView(array);
+  }
+
+  bool IsValid(size_t i) const { return array_.IsValid(i); }
+
+  /// \returns the position of the string of row i in the dictionary
+  code_type GetCode(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(IsValid(i));
+    return codes_[i];
+  }
+
+  std::string_view GetView(size_t i) const {
+    arrow::util::string_view view = dictionary_.GetView(GetCode(i));
+    return std::string_view(view.data(), view.length());
+  }
+
+  value_type GetValue(size_t i) const { return value_type(GetView(i)); }
+
+  value_type operator[](size_t i) const {
+    if (!IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+  /// \returns the code of value, to test rows for it with GetCode, or
+  /// nullopt if it is not in the dictionary
+  std::optional<code_type> FindCode(std::string_view value) const {
+    for (int64_t code = 0, size = dictionary_.length(); code < size; ++code) {
+      arrow::util::string_view view = dictionary_.GetView(code);
+      if (std::string_view(view.data(), view.length()) == value) {
+        return code;
+      }
+    }
+    return std::nullopt;
+  }
+
+  const arrow::LargeStringArray& dictionary() const { return dictionary_; }
+
+private:
+  DictionaryStringPropertyReadOnlyView(const arrow::DictionaryArray& array)
+      : array_(array),
+        codes_(array.indices()->data()->GetValues<code_type>(1)),
+        dictionary_(
+            static_cast<const arrow::LargeStringArray&>(*array.dictionary())) {}
+
+  const arrow::DictionaryArray& array_;
+  const code_type* codes_;
+  const arrow::LargeStringArray& dictionary_;
+};
+
 template <typename ArrowT, typename ViewT>
 struct Property {
   using ArrowType = ArrowT;
@@ -554,6 +719,32 @@ struct LargeStringReadOnlyProperty
           arrow::LargeStringType,
           StringPropertyReadOnlyView<arrow::LargeStringArray>> {};
 
+/// A string property stored once per distinct value, for properties like
+/// country codes or categories that repeat across many nodes or edges
+struct DictionaryStringReadOnlyProperty {
+  using ArrowType = arrow::DictionaryType;
+  using ViewType = DictionaryStringPropertyReadOnlyView;
+
+  static std::shared_ptr<arrow::DataType> Type() {
+    return DictionaryStringType();
+  }
+
+  /// Allocate num_rows empty strings
+  static Result<std::shared_ptr<arrow::Table>> Allocate(
+      size_t num_rows, const std::string& name) {
+    arrow::LargeStringBuilder builder;
+    KATANA_CHECKED(builder.Append(""));
+    std::shared_ptr<arrow::Array> dictionary;
+    KATANA_CHECKED(builder.Finish(&dictionary));
+    std::shared_ptr<arrow::Array> codes = KATANA_CHECKED(
+        arrow::MakeArrayFromScalar(arrow::Int32Scalar(0), num_rows));
+    std::shared_ptr<arrow::Array> array = KATANA_CHECKED(
+        arrow::DictionaryArray::FromArrays(Type(), codes, dictionary));
+    return arrow::Table::Make(
+        arrow::schema({arrow::field(name, Type())}), {array});
+  }
+};
+
 template <typename T>
 struct StructProperty
     : public Property<arrow::FixedSizeBinaryType, katana::PODPropertyView<T>> {
@@ -811,5 +1002,118 @@ struct FixedSizedBinaryPODArrayProperty
   }
 };
 
+/// EmbeddingPropertyView provides a mutable view over an
+/// arrow::FixedSizeListArray with D values of a POD type T per row, like the
+/// embeddings of nodes. The values of all rows are in a single buffer: row i
+/// starts D values after row i - 1.
+template <typename T, size_t D>
+class EmbeddingPropertyView {
+public:
+  using value_type = ArrayRef<const T>;
+  using reference = ArrayRef<T>;
+  using const_reference = ArrayRef<const T>;
+
+  static Result<EmbeddingPropertyView> Make(
+      const arrow::FixedSizeListArray& array) {
+    using ValueArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    if (array.list_type()->list_size() != static_cast<int32_t>(D)) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "bad size of embedding: {} != {}",
+          array.list_type()->list_size(), D);
+    }
+    const std::shared_ptr<arrow::ArrayData>& values = array.values()->data();
+    if (values->type->id() != ValueArrowType::type_id) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "bad type of embedding values: {}",
+          values->type->ToString());
+    }
+    if (values->buffers.size() <= 1 || !values->buffers[1]->is_mutable()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "immutable buffers not supported");
+    }
+    T* base = internal::GetMutableValuesWorkAround<T>(values, 1, 0);
+    return EmbeddingPropertyView(
+        base + array.value_offset(0),
+        array.data()->template GetValues<uint8_t>(0, 0), array.length(),
+        array.offset(), array.null_count());
+  }
+
+  bool IsValid(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < length_);
+    return null_bitmap_ == nullptr
+               ? null_count_ == 0
+               : arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
+  }
+
+  size_t size() const { return length_; }
+
+  /// The first of the D values of row i
+  T* data(size_t i) { return values_ + i * D; }
+
+  const T* data(size_t i) const { return values_ + i * D; }
+
+  reference GetValue(size_t i) { return reference(data(i), D); }
+
+  const_reference GetValue(size_t i) const {
+    return const_reference(data(i), D);
+  }
+
+  reference operator[](size_t i) { return GetValue(i); }
+
+  const_reference operator[](size_t i) const { return GetValue(i); }
+
+private:
+  EmbeddingPropertyView(
+      T* values, const uint8_t* null_bitmap, size_t length, size_t offset,
+      size_t null_count)
+      : values_(values),
+        null_bitmap_(null_bitmap),
+        length_(length),
+        offset_(offset),
+        null_count_(null_count) {}
+
+  T* values_;
+  const uint8_t* null_bitmap_;
+  size_t length_, offset_, null_count_;
+};
+
+/// An EmbeddingProperty is a dense vector of D values of a POD type T per
+/// row, e.g., a node embedding of 128 floats, stored as an
+/// arrow::FixedSizeListArray. Allocate puts the values in one buffer, which
+/// arrow aligns to 64 bytes, so rows are aligned to 64 bytes too when they
+/// are a multiple of 64 bytes long (kRowsAligned), and vector kernels over
+/// them (\ref Embeddings.h) never split a cache line.
+///
+/// \tparam T the C type of the values
+/// \tparam D the number of values per row
+template <typename T, size_t D>
+struct EmbeddingProperty {
+  using ArrowType = arrow::FixedSizeListType;
+  using ViewType = EmbeddingPropertyView<T, D>;
+  using ValueArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+
+  static constexpr bool kRowsAligned = (D * sizeof(T)) % 64 == 0;
+
+  static std::shared_ptr<arrow::DataType> Type() {
+    return arrow::fixed_size_list(
+        arrow::TypeTraits<ValueArrowType>::type_singleton(), D);
+  }
+
+  static katana::Result<std::shared_ptr<arrow::Table>> Allocate(
+      size_t num_rows, const std::string& name) {
+    size_t num_values = num_rows * D;
+    std::shared_ptr<arrow::Buffer> buffer =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_values * sizeof(T)));
+    std::memset(buffer->mutable_data(), 0, buffer->size());
+    auto values =
+        std::make_shared<typename arrow::TypeTraits<ValueArrowType>::ArrayType>(
+            num_values, std::move(buffer));
+    auto array =
+        std::make_shared<arrow::FixedSizeListArray>(Type(), num_rows, values);
+    return arrow::Table::Make(
+        arrow::schema({arrow::field(name, Type())}), {array});
+  }
+};
+
 }  // namespace katana
 #endif
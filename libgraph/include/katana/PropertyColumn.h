@@ -0,0 +1,121 @@
+#ifndef KATANA_LIBGRAPH_KATANA_PROPERTYCOLUMN_H_
+#define KATANA_LIBGRAPH_KATANA_PROPERTYCOLUMN_H_
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <arrow/api.h>
+#include <arrow/type_traits.h>
+
+#include "katana/NUMAArray.h"
+
+namespace katana {
+
+/// An arrow buffer that owns the NUMAArray it wraps, so that NUMA memory is
+/// handed to arrow without a copy. The buffer is mutable, so that property
+/// views can write into it like into buffers that arrow allocated.
+template <typename T>
+class NUMAArrayBuffer : public arrow::Buffer {
+public:
+  explicit NUMAArrayBuffer(NUMAArray<T>&& array)
+      : arrow::Buffer(nullptr, 0), array_(std::move(array)) {
+    is_mutable_ = true;
+    data_ = reinterpret_cast<const uint8_t*>(array_.data());
+    size_ = array_.size() * sizeof(T);
+    capacity_ = size_;
+  }
+
+private:
+  NUMAArray<T> array_;
+};
+
+/// A PropertyColumn is the column of a POD property that an analytic owns
+/// while it computes it: the values are in NUMA memory, are written in
+/// parallel with plain stores, and become a property of a graph without a
+/// copy (see PropertyGraph::AddNodeProperty). This avoids both allocating an
+/// arrow table up front to write results through a property view and
+/// copying the results from a scratch array into it at the end.
+///
+/// \tparam T the C type of the values; it must have an arrow::CTypeTraits
+template <typename T>
+class PropertyColumn {
+  static_assert(
+      std::is_trivial_v<T> && std::is_standard_layout_v<T>,
+      "property columns hold plain old data");
+
+public:
+  using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = typename NUMAArray<T>::iterator;
+  using const_iterator = typename NUMAArray<T>::const_iterator;
+
+  PropertyColumn() = default;
+
+  /// A column of size uninitialized values, interleaved over the NUMA nodes
+  static PropertyColumn MakeInterleaved(size_t size) {
+    PropertyColumn column;
+    column.values_.allocateInterleaved(size);
+    return column;
+  }
+
+  /// A column of size uninitialized values, in blocks of the threads that
+  /// will write them
+  static PropertyColumn MakeBlocked(size_t size) {
+    PropertyColumn column;
+    column.values_.allocateBlocked(size);
+    return column;
+  }
+
+  size_t size() const { return values_.size(); }
+
+  bool empty() const { return values_.size() == 0; }
+
+  T* data() { return values_.data(); }
+
+  const T* data() const { return values_.data(); }
+
+  reference operator[](size_t i) { return values_[i]; }
+
+  const_reference operator[](size_t i) const { return values_[i]; }
+
+  iterator begin() { return values_.begin(); }
+
+  iterator end() { return values_.end(); }
+
+  const_iterator begin() const { return values_.begin(); }
+
+  const_iterator end() const { return values_.end(); }
+
+  /// The array of the values, for code that computes into NUMAArrays
+  NUMAArray<T>& values() { return values_; }
+
+  const NUMAArray<T>& values() const { return values_; }
+
+  /// Hand the values to an arrow array without copying them; the column is
+  /// empty afterwards
+  std::shared_ptr<ArrayType> ToArrowArray() && {
+    size_t size = values_.size();
+    return std::make_shared<ArrayType>(
+        size, std::make_shared<NUMAArrayBuffer<T>>(std::move(values_)));
+  }
+
+  /// Hand the values to a table of one column named name without copying
+  /// them; the column is empty afterwards
+  std::shared_ptr<arrow::Table> ToTable(const std::string& name) && {
+    std::shared_ptr<arrow::Array> array = std::move(*this).ToArrowArray();
+    return arrow::Table::Make(
+        arrow::schema({arrow::field(name, array->type())}), {array});
+  }
+
+private:
+  NUMAArray<T> values_;
+};
+
+}  // namespace katana
+
+#endif
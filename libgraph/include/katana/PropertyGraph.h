@@ -1,8 +1,13 @@
 #ifndef KATANA_LIBGRAPH_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGRAPH_KATANA_PROPERTYGRAPH_H_
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
@@ -10,14 +15,20 @@
 
 #include "katana/ArrowInterchange.h"
 #include "katana/Details.h"
+#include "katana/DynamicBitset.h"
+#include "katana/CompositeEntityIndex.h"
 #include "katana/EntityIndex.h"
+#include "katana/HashEntityIndex.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
+#include "katana/GraphStatistics.h"
 #include "katana/GraphTopology.h"
 #include "katana/Iterators.h"
+#include "katana/LazyProjectedGraph.h"
 #include "katana/Logging.h"
 #include "katana/NUMAArray.h"
 #include "katana/Properties.h"
+#include "katana/PropertyColumn.h"
 #include "katana/RDG.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
@@ -25,6 +36,8 @@
 
 namespace katana {
 
+class DeviceTopologyCache;
+
 // TODO(amber): find a better place to put this
 template <
     typename T,
@@ -48,6 +61,49 @@ DefaultPropertyNames() {
   return names;
 }
 
+/// What differs between two property graphs, e.g., two versions of one RDG;
+/// see PropertyGraph::Diff
+struct KATANA_EXPORT PropertyGraphDiff {
+  /// The names of the properties of one kind, nodes or edges, that differ
+  struct Properties {
+    /// Only in the graph compared
+    std::vector<std::string> added;
+    /// Only in the graph compared against
+    std::vector<std::string> removed;
+    /// In both, with different values
+    std::vector<std::string> changed;
+
+    bool empty() const {
+      return added.empty() && removed.empty() && changed.empty();
+    }
+  };
+
+  bool topology_changed{false};
+  Properties node_properties;
+  Properties edge_properties;
+
+  bool empty() const {
+    return !topology_changed && node_properties.empty() &&
+           edge_properties.empty();
+  }
+};
+
+/// How PropertyGraph::MakeFromEdgeTable reads a table of edges
+struct EdgeTableOptions {
+  /// The integer columns of the source and destination node ids of the edges.
+  /// All other columns become edge properties.
+  std::string src_column{"src"};
+  std::string dst_column{"dst"};
+  /// The number of nodes, for graphs with nodes without edges; 0 for one
+  /// more than the largest node id. Unused with node_id_property.
+  uint64_t num_nodes{0};
+  /// If not empty, the node ids of the table are arbitrary integers, e.g.,
+  /// keys of a feature store, rather than 0 to num_nodes - 1. The nodes are
+  /// then numbered in increasing order of their ids, and the ids are kept in
+  /// a node property of this name.
+  std::string node_id_property;
+};
+
 /// A property graph is a graph that has properties associated with its nodes
 /// and edges. A property has a name and value. Its value may be a primitive
 /// type, a list of values or a composition of properties.
@@ -63,6 +119,7 @@ DefaultPropertyNames() {
 class KATANA_EXPORT PropertyGraph {
   friend class PGViewCache;
   friend class PropertyGraphRetractor;
+  friend class SharedGraph;
 
   // Regular methods
 public:
@@ -275,6 +332,16 @@ public:
       EntityTypeManager&& node_type_manager,
       EntityTypeManager&& edge_type_manager);
 
+  /// Make a property graph from a table with a row for each edge, e.g., an
+  /// edge list exported from pandas or a feature store. The topology is
+  /// built by a parallel counting sort of the rows by source node, which
+  /// keeps the edges of each node in the order of the table. The other
+  /// columns become edge properties: they are reordered by a single Take,
+  /// and used without a copy if the table is already sorted by source node.
+  static Result<std::unique_ptr<PropertyGraph>> MakeFromEdgeTable(
+      const Uri& rdg_dir, const std::shared_ptr<arrow::Table>& edges,
+      katana::TxnContext* txn_ctx, const EdgeTableOptions& opts = {});
+
   static Result<std::unique_ptr<katana::PropertyGraph>> Make(
       const katana::RDGManifest& rdg_manifest,
       const katana::RDGLoadOptions& opts, katana::TxnContext* txn_ctx);
@@ -285,15 +352,39 @@ public:
       const PropertyGraph& pg, const std::vector<std::string>& node_types,
       const std::vector<std::string>& edge_types);
 
-  /// \return A copy of this with the same set of properties. The copy shares no
-  ///       state with this.
+  /// Materialize a lazy projection into a projected graph with a topology of
+  /// its own, as the overload above makes from the types of the projection.
+  static std::unique_ptr<PropertyGraph> MakeProjectedGraph(
+      const LazyProjectedGraph& projection);
+
+  /// The lazy projection of this graph onto node_types and edge_types; see
+  /// LazyProjectedGraph. Projections are cached by their types until the
+  /// topology changes, so that repeating one costs a lookup.
+  std::shared_ptr<const LazyProjectedGraph> GetLazyProjectedGraph(
+      const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) const;
+
+  /// \return A copy of this with the same set of properties; see the
+  ///       overload below.
   Result<std::unique_ptr<PropertyGraph>> Copy(
       katana::TxnContext* txn_ctx) const;
 
+  /// The copy is copy on write: it shares the property columns, the default
+  /// topology and the entity types of this instead of copying them, so that
+  /// a copy costs little more than a table of pointers. Adding, upserting or
+  /// removing a property of either graph replaces that column only in the
+  /// graph changed, and changing the topology in place (e.g., with
+  /// SortAllEdgesByDest) first gives that graph a topology of its own. Values
+  /// written in place through a property view of a shared column are seen by
+  /// both graphs; upsert a new column instead.
+  ///
+  /// The copy is not bound to the storage of this: writing it stores all of
+  /// it. Copies of transformed graphs and copies of properties that are not
+  /// loaded are loaded from storage and share nothing with this.
+  ///
   /// \param node_properties The node properties to copy.
   /// \param edge_properties The edge properties to copy.
-  /// \return A copy of this with a subset of the properties. The copy shares no
-  ///        state with this.
+  /// \return A copy of this with a subset of the properties.
   Result<std::unique_ptr<PropertyGraph>> Copy(
       const std::vector<std::string>& node_properties,
       const std::vector<std::string>& edge_properties,
@@ -346,10 +437,55 @@ public:
     return rdg_->WriteRDKSubstructureIndexPrimitive(index);
   }
 
+  Result<std::optional<ReachabilityIndexPrimitive>>
+  LoadReachabilityIndexPrimitive() {
+    return rdg_->LoadReachabilityIndexPrimitive();
+  }
+
+  Result<void> WriteReachabilityIndexPrimitive(
+      ReachabilityIndexPrimitive& index) {
+    return rdg_->WriteReachabilityIndexPrimitive(index);
+  }
+
+  Result<std::optional<EntityIndexPrimitive>> LoadEntityIndexPrimitive(
+      const std::string& name) {
+    return rdg_->LoadEntityIndexPrimitive(name);
+  }
+
+  Result<void> WriteEntityIndexPrimitive(
+      const std::string& name, EntityIndexPrimitive& index) {
+    return rdg_->WriteEntityIndexPrimitive(name, index);
+  }
+
   const std::string& rdg_dir() const { return rdg_->rdg_dir().string(); }
 
   uint32_t partition_id() const { return rdg_->partition_id(); }
 
+  /// The local ids of the masters of this partition mirrored on each host,
+  /// by host
+  const std::vector<std::shared_ptr<arrow::ChunkedArray>>& master_nodes()
+      const {
+    return rdg_->master_nodes();
+  }
+
+  /// The local ids of the mirrors in this partition of the masters on each
+  /// host, by host
+  const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes()
+      const {
+    return rdg_->mirror_nodes();
+  }
+
+  /// Make this graph the partition of this host of a partitioned graph,
+  /// which Write stores with its partition arrays: local_to_global_id is
+  /// the global id of each node and host_to_owned_global_node_ids those of
+  /// the nodes this host owns
+  void SetPartition(
+      const PartitionMetadata& metadata,
+      std::vector<std::shared_ptr<arrow::ChunkedArray>>&& master_nodes,
+      std::vector<std::shared_ptr<arrow::ChunkedArray>>&& mirror_nodes,
+      std::shared_ptr<arrow::ChunkedArray>&& local_to_global_id,
+      std::shared_ptr<arrow::ChunkedArray>&& host_to_owned_global_node_ids);
+
   uint32_t partition_policy_id() const {
     return rdg_->part_metadata().policy_id_;
   }
@@ -362,17 +498,61 @@ public:
     return rdg_->CurrentVersion(*file_);
   }
 
+  /// Load another version of the RDG this graph was loaded from, e.g., the
+  /// one before CurrentVersion, read only. Files that did not change between
+  /// the versions are shared with this graph and every other graph loaded
+  /// with RDGLoadOptions::share_loaded_files instead of being read again:
+  /// the default topology, as long as neither graph changes it, and the
+  /// loaded properties, whose values written in place through a view are
+  /// seen by both graphs as for Copy. The rest of opts is as for Make; the
+  /// partition loaded defaults to the one of this graph.
+  Result<std::unique_ptr<PropertyGraph>> LoadVersion(
+      uint64_t version, katana::TxnContext* txn_ctx,
+      katana::RDGLoadOptions opts = katana::RDGLoadOptions()) const;
+
+  /// What changed from other to this, e.g., from the version before this
+  /// one. Properties and topologies loaded from the same file are the same
+  /// without looking at them, so comparing two versions costs little more
+  /// than what changed between them. Otherwise the values are compared when
+  /// both are loaded, and properties stored apart that are not are reported
+  /// changed without reading them.
+  Result<PropertyGraphDiff> Diff(const PropertyGraph& other) const;
+
   /// Create a new storage location for a graph and write everything into it.
   ///
   /// \returns io_error if, for instance, a file already exists
   Result<void> Write(
       const std::string& rdg_name, const std::string& command_line);
 
+  /// Like \ref Write(const std::string&, const std::string&) but first sets
+  /// how properties are encoded, see \ref set_write_opts
+  Result<void> Write(
+      const std::string& rdg_name, const std::string& command_line,
+      ParquetWriter::WriteOpts opts);
+
+  /// How properties are encoded when they are written by Write or Commit,
+  /// e.g., the compression codec and dictionary encoding of each property
+  const ParquetWriter::WriteOpts& write_opts() const {
+    return rdg_->write_opts();
+  }
+  void set_write_opts(ParquetWriter::WriteOpts opts) {
+    rdg_->set_write_opts(std::move(opts));
+  }
+
   /// Commit updates modified state and re-uses graph components already in storage.
   ///
   /// Like \ref Write(const std::string&, const std::string&) but can only update
-  /// parts of the original read location of the graph.
+  /// parts of the original read location of the graph. Only properties,
+  /// topologies and entity type id arrays that changed since the graph was
+  /// loaded or last written are written; the part header refers to the files
+  /// already in storage for the rest.
   Result<void> Commit(const std::string& command_line);
+
+  /// Like \ref Commit(const std::string&) unless txn_ctx is batching (see
+  /// TxnContext::BeginBatch), in which case the commit is deferred until
+  /// TxnContext::CommitBatch, which commits the changes of every operation
+  /// deferred for this graph at once. The graph must outlive the batch.
+  Result<void> Commit(const std::string& command_line, TxnContext* txn_ctx);
   Result<void> WriteView(const std::string& command_line);
 
   /// Determine if two PropertyGraphs are Equal
@@ -386,8 +566,14 @@ public:
   /// but their properties information would differ as the old software added the type information to properties while the new
   /// software did not. The two graphs would be functionally Equal, but this function would say this are not equal
   /// TODO(unknown):(emcginnis) consider breaking the function down into: topology comparison, type comparison, and property comparison. Move pitfall described above alone with the property comparison function
+  ///
+  /// The topologies, entity type ids and properties are compared by their
+  /// ContentHash, computed in parallel. The hashes of clean properties are
+  /// kept in the RDG and stored with them, so they are not computed again
+  /// for graphs loaded from storage.
   bool Equals(const PropertyGraph* other) const;
-  /// Report the differences between two graphs
+  /// Report the differences between two graphs; only the chunks whose
+  /// content hashes differ are diffed element by element
   /// THIS IS A TESTING ONLY FUNCTION, DO NOT EXPOSE THIS TO THE USER
   std::string ReportDiff(const PropertyGraph* other) const;
 
@@ -591,6 +777,28 @@ public:
         edge_entity_type_id, GetTypeOfEdgeFromPropertyIndex(edge));
   }
 
+  /// \return the nodes that have any of the entity types
+  /// @param node_entity_type_ids (need not be the most specific types), by
+  /// node id; it is computed in one parallel pass over the types of the nodes,
+  /// which tests each of them against a bitmap of the matching types
+  /// (assumes that the node entity types exist)
+  DynamicBitset NodesWithType(
+      const std::vector<EntityTypeID>& node_entity_type_ids) const;
+
+  DynamicBitset NodesWithType(EntityTypeID node_entity_type_id) const {
+    return NodesWithType(std::vector<EntityTypeID>{node_entity_type_id});
+  }
+
+  /// \return the edges that have any of the entity types
+  /// @param edge_entity_type_ids, by edge id of the topology; see
+  /// NodesWithType
+  DynamicBitset EdgesWithType(
+      const std::vector<EntityTypeID>& edge_entity_type_ids) const;
+
+  DynamicBitset EdgesWithType(EntityTypeID edge_entity_type_id) const {
+    return EdgesWithType(std::vector<EntityTypeID>{edge_entity_type_id});
+  }
+
   // Return type dictated by arrow
   /// Returns the number of node properties
   /// Does not include types managed by the EntityTypeManager
@@ -657,6 +865,10 @@ public:
   /// \tparam T The type of the property.
   /// \param name The name of the property.
   /// \return The property array or an error if the property does not exist or has a different type.
+  ///
+  /// A property loaded in several chunks is returned as a copy of them (see
+  /// ContiguousArray); writes to the copy do not reach the graph. Property
+  /// views read the chunks in place instead, see MakeNodePropertyViews.
   template <typename T>
   Result<std::shared_ptr<typename arrow::CTypeTraits<T>::ArrayType>>
   GetNodePropertyTyped(const std::string& name) {
@@ -667,10 +879,14 @@ public:
     }
     auto chunked_array = chunked_array_result.assume_value();
     KATANA_LOG_ASSERT(chunked_array);
+    auto contiguous_result = ContiguousArray(*chunked_array);
+    if (!contiguous_result) {
+      return contiguous_result.assume_error();
+    }
 
     auto array =
         std::dynamic_pointer_cast<typename arrow::CTypeTraits<T>::ArrayType>(
-            chunked_array->chunk(0));
+            contiguous_result.assume_value());
     if (!array) {
       return KATANA_ERROR(
           katana::ErrorCode::TypeError, "Incorrect arrow::Array type: {}",
@@ -684,6 +900,10 @@ public:
   /// \tparam T The type of the property.
   /// \param name The name of the property.
   /// \return The property array or an error if the property does not exist or has a different type.
+  ///
+  /// A property loaded in several chunks is returned as a copy of them (see
+  /// ContiguousArray); writes to the copy do not reach the graph. Property
+  /// views read the chunks in place instead, see MakeEdgePropertyViews.
   template <typename T>
   Result<std::shared_ptr<typename arrow::CTypeTraits<T>::ArrayType>>
   GetEdgePropertyTyped(const std::string& name) {
@@ -694,10 +914,14 @@ public:
     }
     auto chunked_array = chunked_array_result.assume_value();
     KATANA_LOG_ASSERT(chunked_array);
+    auto contiguous_result = ContiguousArray(*chunked_array);
+    if (!contiguous_result) {
+      return contiguous_result.assume_error();
+    }
 
     auto array =
         std::dynamic_pointer_cast<typename arrow::CTypeTraits<T>::ArrayType>(
-            chunked_array->chunk(0));
+            contiguous_result.assume_value());
     if (!array) {
       return KATANA_ERROR(
           katana::ErrorCode::TypeError, "Incorrect arrow::Array type: {}",
@@ -706,11 +930,84 @@ public:
     return MakeResult(std::move(array));
   }
 
+  /// Get a copy of edge property \p name in the edge order of \p view, so
+  /// that value e of the copy belongs to edge e of the view rather than to
+  /// property index e. Sorted and transposed views shuffle the edges, which
+  /// makes every access through GetEdgePropertyIndexFromOutEdge a random
+  /// one; loops over the copy read it sequentially instead.
+  ///
+  /// Copies are cached with the topologies of this graph, see PGViewCache,
+  /// and are read only: other views share them, and writes to them do not
+  /// reach the graph.
+  template <typename PGView>
+  Result<std::shared_ptr<arrow::Array>> GetEdgePropertyInViewOrder(
+      const PGView& view, const std::string& name) {
+    return pg_view_cache_.BuildOrGetPropertyInTopologyOrder(
+        this, view.topology_ptr(), name, true);
+  }
+
+  /// Like GetEdgePropertyInViewOrder, for the node order of views that
+  /// shuffle the nodes, such as the ones sorting nodes by degree
+  template <typename PGView>
+  Result<std::shared_ptr<arrow::Array>> GetNodePropertyInViewOrder(
+      const PGView& view, const std::string& name) {
+    return pg_view_cache_.BuildOrGetPropertyInTopologyOrder(
+        this, view.topology_ptr(), name, false);
+  }
+
   //TODO(yan): Add fine-grained control for dropping specific topologies.
   void DropAllTopologies() noexcept {
     return pg_view_cache_.DropAllTopologies();
   }
 
+  /// Let the MemorySupervisor evict cached topologies that no view uses;
+  /// see PGViewCache::ReleaseUnusedTopologies.
+  void ReleaseUnusedTopologies() noexcept {
+    return pg_view_cache_.ReleaseUnusedTopologies();
+  }
+
+  /// Have Write and Commit store only the views that took at least
+  /// \p min_build_time to build; see PGViewCache::set_min_persisted_build_time
+  void SetMinPersistedViewBuildTime(
+      std::chrono::steady_clock::duration min_build_time) noexcept {
+    pg_view_cache_.set_min_persisted_build_time(min_build_time);
+  }
+
+  /// Insert and delete edges, updating the cached topologies incrementally
+  /// instead of dropping them; see PGViewCache::ApplyEdgeChanges.
+  ///
+  /// Edge properties and types are looked up by property index, so the
+  /// property rows of inserted edges must already exist. Persisted topologies
+  /// no longer describe the graph and are invalidated.
+  Result<void> ApplyEdgeChanges(const EdgeChangeSet& changes);
+
+  /// Number of edge change batches applied to this graph's topologies
+  uint64_t topology_version() const noexcept {
+    return pg_view_cache_.version();
+  }
+
+  /// Record that the topology was changed in place, outside of
+  /// ApplyEdgeChanges, so that the next write stores it again
+  void MarkTopologyModified() noexcept {
+    DetachSharedTopology();
+    stored_topology_version_.reset();
+    graph_statistics_.reset();
+    lazy_projections_.clear();
+    device_topology_cache_.reset();
+  }
+
+  /// Statistics of the default topology for choosing plans. They are
+  /// computed on first use and cached until the topology changes.
+  GraphStatistics GetGraphStatistics() const;
+
+  /// The device copies of the topologies of this graph that the GPU
+  /// analytics made, or null if there are none or the topology changed since
+  /// they were made; see analytics::GpuAnalytics
+  std::shared_ptr<DeviceTopologyCache> GetDeviceTopologyCache() const;
+
+  /// Keep cache with this graph until its topology changes
+  void SetDeviceTopologyCache(std::shared_ptr<DeviceTopologyCache> cache) const;
+
   const GraphTopology& topology() const noexcept {
     return pg_view_cache_.GetDefaultTopologyRef();
   }
@@ -759,13 +1056,65 @@ public:
   /// Add Edge properties that do not exist in the current graph
   Result<void> AddEdgeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
-  /// If property name exists, replace it, otherwise insert it
+  /// If property name exists, replace it, otherwise insert it. Indexes over
+  /// the properties replaced are updated to them (see
+  /// EntityIndex::UpdateFromProperty).
   Result<void> UpsertNodeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
-  /// If property name exists, replace it, otherwise insert it
+  /// If property name exists, replace it, otherwise insert it. Indexes over
+  /// the properties replaced are updated to them (see
+  /// EntityIndex::UpdateFromProperty).
   Result<void> UpsertEdgeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
 
+  /// Add a node property named name with the values of column by node,
+  /// which become the property without a copy; see PropertyColumn. In a
+  /// transformed graph, the values are gathered into the rows of the nodes of
+  /// the parent instead, and the other rows are null.
+  template <typename T>
+  Result<void> AddNodeProperty(
+      const std::string& name, PropertyColumn<T>&& column,
+      katana::TxnContext* txn_ctx) {
+    return AddNodeProperties(
+        KATANA_CHECKED(
+            MakeNodePropertyTable(name, std::move(column).ToArrowArray())),
+        txn_ctx);
+  }
+
+  /// As AddNodeProperty, but replaces the property if it exists
+  template <typename T>
+  Result<void> UpsertNodeProperty(
+      const std::string& name, PropertyColumn<T>&& column,
+      katana::TxnContext* txn_ctx) {
+    return UpsertNodeProperties(
+        KATANA_CHECKED(
+            MakeNodePropertyTable(name, std::move(column).ToArrowArray())),
+        txn_ctx);
+  }
+
+  /// Add an edge property named name with the values of column by edge of
+  /// the topology; see AddNodeProperty
+  template <typename T>
+  Result<void> AddEdgeProperty(
+      const std::string& name, PropertyColumn<T>&& column,
+      katana::TxnContext* txn_ctx) {
+    return AddEdgeProperties(
+        KATANA_CHECKED(
+            MakeEdgePropertyTable(name, std::move(column).ToArrowArray())),
+        txn_ctx);
+  }
+
+  /// As AddEdgeProperty, but replaces the property if it exists
+  template <typename T>
+  Result<void> UpsertEdgeProperty(
+      const std::string& name, PropertyColumn<T>&& column,
+      katana::TxnContext* txn_ctx) {
+    return UpsertEdgeProperties(
+        KATANA_CHECKED(
+            MakeEdgePropertyTable(name, std::move(column).ToArrowArray())),
+        txn_ctx);
+  }
+
   Result<void> RemoveNodeProperty(int i, katana::TxnContext* txn_ctx);
   Result<void> RemoveNodeProperty(
       const std::string& prop_name, katana::TxnContext* txn_ctx);
@@ -775,11 +1124,11 @@ public:
       const std::string& prop_name, katana::TxnContext* txn_ctx);
 
   /// Write a node property column out to storage and de-allocate the memory
-  /// it was using
+  /// it was using. Pinned properties cannot be unloaded
   Result<void> UnloadNodeProperty(const std::string& prop_name);
 
   /// Write an edge property column out to storage and de-allocate the
-  /// memory it was using
+  /// memory it was using. Pinned properties cannot be unloaded
   Result<void> UnloadEdgeProperty(const std::string& prop_name);
 
   /// Load a node property by name put it in the table at index i
@@ -798,6 +1147,33 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// Load the node properties with the given names that are absent, with
+  /// their reads overlapping, and append their columns to the table; see
+  /// RDG::LoadNodeProperties
+  Result<void> EnsureNodePropertiesLoaded(
+      const std::vector<std::string>& names);
+
+  /// Load the edge properties with the given names that are absent, as
+  /// EnsureNodePropertiesLoaded does node properties
+  Result<void> EnsureEdgePropertiesLoaded(
+      const std::vector<std::string>& names);
+
+  /// Keep a loaded node property from being unloaded until it is unpinned
+  /// as many times as it was pinned
+  Result<void> PinNodeProperty(const std::string& name);
+  void UnpinNodeProperty(const std::string& name);
+  bool IsNodePropertyPinned(const std::string& name) const {
+    return pinned_node_properties_.count(name) > 0;
+  }
+
+  /// Keep a loaded edge property from being unloaded until it is unpinned
+  /// as many times as it was pinned
+  Result<void> PinEdgeProperty(const std::string& name);
+  void UnpinEdgeProperty(const std::string& name);
+  bool IsEdgePropertyPinned(const std::string& name) const {
+    return pinned_edge_properties_.count(name) > 0;
+  }
+
   std::vector<std::string> ListFullNodeProperties() const {
     return rdg_->ListFullNodeProperties();
   }
@@ -924,18 +1300,31 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
+  // Creates an index over a node property. If the graph has a stored index
+  // of the property as it is stored now (see WriteNodeIndex), its arrays are
+  // mapped rather than built.
   Result<void> MakeNodeIndex(const std::string& property_name);
 
   // Delete an existing index over a node property.
   Result<void> DeleteNodeIndex(const std::string& property_name);
 
-  // Creates an index over an edge property.
+  // Creates an index over an edge property, or maps the stored one, as
+  // MakeNodeIndex does.
   Result<void> MakeEdgeIndex(const std::string& property_name);
 
   // Delete an existing index over an edge property.
   Result<void> DeleteEdgeIndex(const std::string& property_name);
 
+  // Store the index over a node property with the graph, to be mapped by
+  // MakeNodeIndex once the graph is committed. The property must be stored,
+  // since the index is only used with the property file it was built from.
+  // Requires the UnstableRDGStorageFormat feature.
+  Result<void> WriteNodeIndex(const std::string& property_name);
+
+  // Store the index over an edge property with the graph, as WriteNodeIndex
+  // does.
+  Result<void> WriteEdgeIndex(const std::string& property_name);
+
   // Returns the list of node indexes.
   const std::vector<std::shared_ptr<EntityIndex<GraphTopology::Node>>>&
   node_indexes() const {
@@ -966,6 +1355,78 @@ public:
   katana::Result<std::shared_ptr<katana::EntityIndex<GraphTopology::Edge>>>
   GetEdgeIndex(const std::string& property_name) const;
 
+  // Creates a hash index over a node property, for equality lookups.
+  Result<void> MakeNodeHashIndex(const std::string& property_name);
+
+  // Delete an existing hash index over a node property.
+  Result<void> DeleteNodeHashIndex(const std::string& property_name);
+
+  // Creates a hash index over an edge property, for equality lookups.
+  Result<void> MakeEdgeHashIndex(const std::string& property_name);
+
+  // Delete an existing hash index over an edge property.
+  Result<void> DeleteEdgeHashIndex(const std::string& property_name);
+
+  /// Returns true if a hash index exists for the named node property
+  bool HasNodeHashIndex(const std::string& property_name) const;
+
+  /// Returns the hash index associated with the named node property.
+  ///
+  /// The graph retains ownership of the index.
+  Result<std::shared_ptr<HashEntityIndex<GraphTopology::Node>>>
+  GetNodeHashIndex(const std::string& property_name) const;
+
+  /// Returns true if a hash index exists for the named edge property
+  bool HasEdgeHashIndex(const std::string& property_name) const;
+
+  /// Returns the hash index associated with the named edge property.
+  ///
+  /// The graph retains ownership of the index.
+  Result<std::shared_ptr<HashEntityIndex<GraphTopology::Edge>>>
+  GetEdgeHashIndex(const std::string& property_name) const;
+
+  /// Creates an index over several node properties, in order, of the nodes
+  /// with any of type_ids or of a subtype of them, or of every node if
+  /// type_ids is empty. A scoped index costs memory and time in proportion
+  /// to the nodes of its types.
+  ///
+  /// The graph retains ownership of the index.
+  Result<std::shared_ptr<CompositeEntityIndex<GraphTopology::Node>>>
+  MakeNodeCompositeIndex(
+      const std::vector<std::string>& property_names,
+      const std::vector<EntityTypeID>& type_ids = {});
+
+  /// Returns the index over the node properties scoped to type_ids, in any
+  /// order, made by MakeNodeCompositeIndex.
+  Result<std::shared_ptr<CompositeEntityIndex<GraphTopology::Node>>>
+  GetNodeCompositeIndex(
+      const std::vector<std::string>& property_names,
+      const std::vector<EntityTypeID>& type_ids = {}) const;
+
+  /// Delete an existing index over node properties scoped to type_ids.
+  Result<void> DeleteNodeCompositeIndex(
+      const std::vector<std::string>& property_names,
+      const std::vector<EntityTypeID>& type_ids = {});
+
+  /// Creates an index over several edge properties, as
+  /// MakeNodeCompositeIndex does for nodes.
+  Result<std::shared_ptr<CompositeEntityIndex<GraphTopology::Edge>>>
+  MakeEdgeCompositeIndex(
+      const std::vector<std::string>& property_names,
+      const std::vector<EntityTypeID>& type_ids = {});
+
+  /// Returns the index over the edge properties scoped to type_ids, in any
+  /// order, made by MakeEdgeCompositeIndex.
+  Result<std::shared_ptr<CompositeEntityIndex<GraphTopology::Edge>>>
+  GetEdgeCompositeIndex(
+      const std::vector<std::string>& property_names,
+      const std::vector<EntityTypeID>& type_ids = {}) const;
+
+  /// Delete an existing index over edge properties scoped to type_ids.
+  Result<void> DeleteEdgeCompositeIndex(
+      const std::vector<std::string>& property_names,
+      const std::vector<EntityTypeID>& type_ids = {});
+
 protected:
   RDG& rdg() { return *rdg_; }
   const RDG& rdg() const { return *rdg_; }
@@ -1082,6 +1543,31 @@ private:
 
   Result<RDGTopology*> LoadTopology(const RDGTopology& shadow);
 
+  /// A table of one property named name with the values of by_node, by
+  /// node of the topology, in the rows of their property indices
+  Result<std::shared_ptr<arrow::Table>> MakeNodePropertyTable(
+      const std::string& name,
+      const std::shared_ptr<arrow::Array>& by_node) const;
+
+  /// A table of one property named name with the values of by_edge, by
+  /// edge of the topology, in the rows of their property indices
+  Result<std::shared_ptr<arrow::Table>> MakeEdgePropertyTable(
+      const std::string& name,
+      const std::shared_ptr<arrow::Array>& by_edge) const;
+
+  /// Give this graph a default topology of its own if it shares it with a
+  /// copy or it is in place over a mapping, so that it can be changed in
+  /// place; see Copy
+  void DetachSharedTopology() noexcept;
+
+  /// Where the default topology is stored, if it has not changed since it
+  /// was loaded or written
+  std::optional<Uri> StoredTopologyLocation() const;
+
+  /// Offer the default topology and the loaded properties that are as they
+  /// are in storage to later loads of the same files; see LoadVersion
+  void ShareLoadedFiles() const;
+
   // Data
   std::shared_ptr<katana::RDG> rdg_{std::make_shared<katana::RDG>()};
   std::shared_ptr<katana::RDGFile> file_;
@@ -1109,9 +1595,51 @@ private:
   // List of node and edge indexes on this graph.
   std::vector<std::shared_ptr<EntityIndex<Node>>> node_indexes_;
   std::vector<std::shared_ptr<EntityIndex<Edge>>> edge_indexes_;
+  std::vector<std::shared_ptr<HashEntityIndex<Node>>> node_hash_indexes_;
+  std::vector<std::shared_ptr<HashEntityIndex<Edge>>> edge_hash_indexes_;
+  std::vector<std::shared_ptr<CompositeEntityIndex<Node>>>
+      node_composite_indexes_;
+  std::vector<std::shared_ptr<CompositeEntityIndex<Edge>>>
+      edge_composite_indexes_;
 
   PGViewCache pg_view_cache_;
 
+  // The number of times each pinned property is pinned; see PinNodeProperty
+  std::map<std::string, uint32_t> pinned_node_properties_;
+  std::map<std::string, uint32_t> pinned_edge_properties_;
+
+  // The statistics of the default topology, as of the given topology
+  // version; see GetGraphStatistics
+  mutable std::optional<GraphStatistics> graph_statistics_;
+  mutable std::weak_ptr<GraphTopology> graph_statistics_topology_;
+  mutable uint64_t graph_statistics_version_{0};
+
+  // The device copies of the default topology and its views, as of the given
+  // topology version; see GetDeviceTopologyCache
+  mutable std::shared_ptr<DeviceTopologyCache> device_topology_cache_;
+  mutable std::weak_ptr<GraphTopology> device_topology_cache_topology_;
+  mutable uint64_t device_topology_cache_version_{0};
+
+  // The lazy projections of the default topology by their sorted node and
+  // edge types, as of the given topology version; see GetLazyProjectedGraph
+  mutable std::map<
+      std::pair<std::vector<std::string>, std::vector<std::string>>,
+      std::shared_ptr<const LazyProjectedGraph>>
+      lazy_projections_;
+  mutable std::weak_ptr<GraphTopology> lazy_projections_topology_;
+  mutable uint64_t lazy_projections_version_{0};
+
+  // Shared by this graph and the copies that share its default topology,
+  // and unset once it has a topology of its own; see Copy
+  mutable std::shared_ptr<int> topology_sharers_;
+
+  // What storage holds as of the last load or write, so that writes can skip
+  // the topologies and entity type id arrays that have not changed since.
+  // Unset when unknown.
+  std::optional<uint64_t> stored_topology_version_;
+  std::optional<uint64_t> stored_node_entity_type_ids_fingerprint_;
+  std::optional<uint64_t> stored_edge_entity_type_ids_fingerprint_;
+
   // Transformation related data.
   bool is_transformed{false};
 
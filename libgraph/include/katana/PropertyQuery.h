@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBGRAPH_KATANA_PROPERTYQUERY_H_
+#define KATANA_LIBGRAPH_KATANA_PROPERTYQUERY_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// How a property is compared to a value in a PropertyFilter
+enum class CompareOp {
+  kEqual,
+  kNotEqual,
+  kLess,
+  kLessEqual,
+  kGreater,
+  kGreaterEqual,
+};
+
+/// A conjunction of conditions on the nodes or on the edges of a property
+/// graph: that they have an entity type, and that their properties compare
+/// to values. A null property never satisfies a condition on it.
+///
+/// Conditions on properties are evaluated by arrow compute kernels over
+/// whole property columns, and the type condition with the mapping of
+/// property rows to nodes or edges in one parallel pass, so a filter costs
+/// about as much as a scan of the columns it reads. Conditions on dictionary
+/// encoded strings compare the dictionary and then only read the codes.
+class KATANA_EXPORT PropertyFilter {
+public:
+  struct Condition {
+    std::string property;
+    CompareOp op;
+    std::shared_ptr<arrow::Scalar> value;
+  };
+
+  /// Keep only the entities of type, or of a subtype of it
+  PropertyFilter& OfType(EntityTypeID type) {
+    type_ = type;
+    return *this;
+  }
+
+  /// Keep only the entities whose property compares to value with op. The
+  /// value is cast to the type of the property as arrow does for
+  /// comparisons.
+  PropertyFilter& Where(
+      std::string property, CompareOp op,
+      std::shared_ptr<arrow::Scalar> value) {
+    conditions_.emplace_back(
+        Condition{std::move(property), op, std::move(value)});
+    return *this;
+  }
+
+  template <typename T>
+  PropertyFilter& Where(std::string property, CompareOp op, T value) {
+    return Where(std::move(property), op, arrow::MakeScalar(std::move(value)));
+  }
+
+  const std::optional<EntityTypeID>& type() const { return type_; }
+
+  const std::vector<Condition>& conditions() const { return conditions_; }
+
+private:
+  std::optional<EntityTypeID> type_;
+  std::vector<Condition> conditions_;
+};
+
+/// How the values of a property are aggregated over a group
+enum class AggregateOp {
+  /// The number of entities, or of non-null values of a property
+  kCount,
+  kSum,
+  kMin,
+  kMax,
+  kMean,
+};
+
+/// An aggregate of a property over every group of an aggregation. Sums,
+/// minimums, maximums and means are of the non-null values of a numeric
+/// property as doubles, and are null for a group without any.
+struct Aggregate {
+  AggregateOp op;
+  /// The property to aggregate; empty to count entities
+  std::string property;
+};
+
+/// The nodes of pg that satisfy filter, by node id; the mask can be used to
+/// make a LazyProjectedGraph.
+KATANA_EXPORT Result<DynamicBitset> FilterNodes(
+    const PropertyGraph& pg, const PropertyFilter& filter);
+
+/// The edges of pg that satisfy filter, by edge id of the topology of pg
+KATANA_EXPORT Result<DynamicBitset> FilterEdges(
+    const PropertyGraph& pg, const PropertyFilter& filter);
+
+/// Group the nodes in mask by the value of their property group_by, and
+/// aggregate their properties over every group. The result has a row per
+/// group and its columns are group_by, with the values of the groups, and
+/// one column per aggregate, named like "count", "count(age)" or "sum(age)".
+/// Nodes whose group_by is null are the group with a null value. If
+/// group_by is empty, the nodes in mask are a single group.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> AggregateNodes(
+    const PropertyGraph& pg, const DynamicBitset& mask,
+    const std::string& group_by, const std::vector<Aggregate>& aggregates);
+
+/// Group the edges in mask, by edge id of the topology of pg, by the value
+/// of their property group_by, and aggregate their properties over every
+/// group, as AggregateNodes does for nodes.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> AggregateEdges(
+    const PropertyGraph& pg, const DynamicBitset& mask,
+    const std::string& group_by, const std::vector<Aggregate>& aggregates);
+
+}  // namespace katana
+
+#endif
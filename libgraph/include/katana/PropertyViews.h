@@ -6,17 +6,18 @@
 
 namespace katana::internal {
 
-/// ExtractArrays returns the array for each column of a table. It returns an
-/// error if there is more than one array for any column.
-KATANA_EXPORT Result<std::vector<arrow::Array*>> ExtractArrays(
+/// ExtractArrays returns the column for each property of a table. Columns
+/// keep their chunks; see ConstructPropertyView for the views of columns of
+/// several chunks.
+KATANA_EXPORT Result<std::vector<arrow::ChunkedArray*>> ExtractArrays(
     const arrow::Table* table, const std::vector<std::string>& properties);
-KATANA_EXPORT Result<std::vector<arrow::Array*>> ExtractArrays(
+KATANA_EXPORT Result<std::vector<arrow::ChunkedArray*>> ExtractArrays(
     const PropertyGraph::ReadOnlyPropertyView& pview,
     const std::vector<std::string>& properties);
 
-template <typename PropTuple>
+template <typename PropTuple, typename ArrayType>
 Result<katana::PropertyViewTuple<PropTuple>>
-PropertyViewsFromArrays(std::vector<arrow::Array*> arrays) {
+PropertyViewsFromArrays(std::vector<ArrayType*> arrays) {
   if (arrays.size() < std::tuple_size_v<PropTuple>) {
     return std::errc::invalid_argument;
   }
@@ -34,7 +35,8 @@ PropertyViewsFromArrays(std::vector<arrow::Array*> arrays) {
 ///
 /// It returns an error if there are fewer properties than elements of the
 /// view or if the underlying arrow::ChunkedArray has more than one
-/// arrow::Array.
+/// arrow::Array and the view cannot read several (see
+/// ConstructPropertyView).
 template <typename PropTuple>
 Result<katana::PropertyViewTuple<PropTuple>>
 MakePropertyViews(
@@ -56,7 +58,8 @@ MakePropertyViews(
 ///
 /// It returns an error if there are fewer properties than elements of the
 /// view or if the underlying arrow::ChunkedArray has more than one
-/// arrow::Array.
+/// arrow::Array and the view cannot read several (see
+/// ConstructPropertyView).
 template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
 MakeNodePropertyViews(
@@ -0,0 +1,99 @@
+#ifndef KATANA_LIBGRAPH_KATANA_RDGPARTITIONER_H_
+#define KATANA_LIBGRAPH_KATANA_RDGPARTITIONER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/CommBackend.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/PartitionMetadata.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// How PartitionRDG assigns the edges of a graph to hosts. The nodes are
+/// always split into contiguous blocks of global ids, one per host, whose
+/// master copies the host owns; an edge makes mirrors of its endpoints on
+/// the host it is assigned to if they are not masters there. The values are
+/// the policy_id_ of the partitions, which are not zero since zero means
+/// not partitioned.
+enum class PartitionPolicy : uint32_t {
+  /// Edge (u, v) goes to the owner of u: an outgoing edge cut, where only
+  /// destinations are mirrored
+  kEdgeCut = 1,
+  /// Cartesian vertex cut: the hosts form a grid of rows by columns, as
+  /// square as the number of hosts allows, and edge (u, v) goes to the host
+  /// in the row of the owner of u and the column of the owner of v, so that
+  /// a node is mirrored on at most a row and a column of hosts
+  kCartesianVertexCut = 2,
+  /// Hybrid vertex cut, as in PowerLyra: the edges of a node with at most
+  /// hybrid_degree_threshold out edges go to its owner, the edges of a
+  /// higher degree node to the owners of their destinations, which spreads
+  /// the edges of the few high degree nodes over many hosts
+  kHybridVertexCut = 3,
+};
+
+struct KATANA_EXPORT RDGPartitionOptions {
+  PartitionPolicy policy{PartitionPolicy::kEdgeCut};
+  /// The out degree above which kHybridVertexCut splits the edges of a node
+  uint64_t hybrid_degree_threshold{100};
+  /// About how many bytes of topology each host reads at a time; the edges
+  /// read are sent to their hosts before the next slice is read
+  uint64_t slice_bytes{uint64_t{1} << 28};
+  /// Load the node properties of the masters; mirrors get nulls
+  bool load_node_properties{true};
+};
+
+/// The partition of one host, as PartitionRDG makes it. Local node ids are
+/// the masters, in global id order, and then the mirrors, in global id
+/// order.
+struct KATANA_EXPORT RDGPartition {
+  PartitionMetadata metadata;
+  /// out_indexes[n] is the end of the edges of local node n in dests
+  std::vector<uint64_t> out_indexes;
+  /// The local ids of the destinations of the edges
+  std::vector<uint32_t> dests;
+  /// Both empty if the graph has no entity types outside its properties
+  std::vector<EntityTypeID> node_types;
+  std::vector<EntityTypeID> edge_types;
+  EntityTypeManager node_type_manager;
+  EntityTypeManager edge_type_manager;
+  /// The global id of each local node
+  std::vector<uint64_t> local_to_global;
+  /// As in \ref MirrorSync::Make: master_nodes[h] are the local ids of the
+  /// masters mirrored on host h, mirror_nodes[h] the local ids of the
+  /// mirrors of the masters of host h, in the order of its master_nodes for
+  /// this host
+  std::vector<std::vector<uint32_t>> master_nodes;
+  std::vector<std::vector<uint32_t>> mirror_nodes;
+  /// A row per master, or null if node properties were not loaded
+  std::shared_ptr<arrow::Table> master_properties;
+};
+
+/// Partition the unpartitioned RDG rdg_name over the hosts of comm.
+/// Collective: every host reads the topology of its block of nodes a slice
+/// at a time with RDGSlice, sends each edge to the host the policy assigns
+/// it to and returns its partition, so that no host reads or holds more
+/// than its share of the graph.
+///
+/// Edge properties are not partitioned.
+KATANA_EXPORT Result<RDGPartition> PartitionRDG(
+    const std::string& rdg_name, CommBackend* comm,
+    const RDGPartitionOptions& opts = RDGPartitionOptions());
+
+/// The property graph of a partition, with the partition arrays that
+/// \ref PropertyGraph::Write stores. Write it with katana::Comm() set to
+/// the comm it was partitioned over, and every host writes its partition
+/// of one RDG.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> MakePartitionedGraph(
+    RDGPartition&& partition, TxnContext* txn_ctx);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef KATANA_LIBGRAPH_KATANA_REACHABILITYINDEX_H_
+#define KATANA_LIBGRAPH_KATANA_REACHABILITYINDEX_H_
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/ReachabilityIndexPrimitive.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// An index of the reachability and unweighted distances between the nodes
+/// of a graph, along its out edges: a 2-hop cover built by pruned landmark
+/// labeling (Akiba et al., SIGMOD 2013). Every node is labeled with the
+/// distances to and from a few hubs, such that a shortest path between any
+/// two nodes goes through a hub in both of their labels, so that a query
+/// merges two short lists rather than searching the graph.
+///
+/// The hubs are the nodes by decreasing degree, which on graphs with hubs
+/// makes for labels of tens to hundreds of entries; on graphs without, such
+/// as road networks and meshes, the labels grow with the square root of the
+/// size of the graph or faster, and the index may not be worth building.
+///
+/// An index stays valid only as long as the topology it was built from is
+/// not modified.
+class KATANA_EXPORT ReachabilityIndex {
+public:
+  using Node = GraphTopology::Node;
+
+  /// Distance between nodes that do not reach each other
+  static constexpr uint32_t kUnreachable = std::numeric_limits<uint32_t>::max();
+
+  /// Builds the index of the bidirectional view of pg in parallel.
+  static ReachabilityIndex Build(PropertyGraph* pg);
+
+  /// Builds the index of topo in parallel. Hubs are labeled in batches, every
+  /// hub of a batch pruned only by the labels of the batches before it, so
+  /// the labels are a little larger than those of a serial build.
+  static ReachabilityIndex Build(const SimpleBiDirTopology& topo);
+
+  /// Loads the index stored with pg, with its labels mapped from their files
+  /// rather than read; returns nullopt if pg has none. The index must have
+  /// been written for the current topology of pg, which is not checked
+  /// beyond the number of nodes.
+  static Result<std::optional<ReachabilityIndex>> Load(PropertyGraph* pg);
+
+  /// Stores the index with pg, as an optional data structure of its RDG,
+  /// which is written out along with pg.
+  Result<void> Write(PropertyGraph* pg);
+
+  /// Whether there is a path from src to dst; a node reaches itself.
+  bool Reachable(Node src, Node dst) const {
+    return Distance(src, dst) != kUnreachable;
+  }
+
+  /// Number of edges of the shortest path from src to dst, or kUnreachable.
+  uint32_t Distance(Node src, Node dst) const;
+
+  uint64_t NumNodes() const { return primitive_.num_nodes(); }
+
+  /// Number of entries of the out and in labels together
+  uint64_t NumEntries() const {
+    return primitive_.out_labels().hubs.size() +
+           primitive_.in_labels().hubs.size();
+  }
+
+private:
+  explicit ReachabilityIndex(ReachabilityIndexPrimitive&& primitive)
+      : primitive_(std::move(primitive)) {}
+
+  ReachabilityIndexPrimitive primitive_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef KATANA_LIBGRAPH_KATANA_SHAREDGRAPH_H_
+#define KATANA_LIBGRAPH_KATANA_SHAREDGRAPH_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/TxnContext.h"
+#include "katana/config.h"
+
+namespace katana {
+
+struct KATANA_EXPORT SharedGraphOptions {
+  /// Back the segment with hugetlbfs pages, which needs huge pages reserved
+  /// in /proc/sys/vm/nr_hugepages; Export fails if there are not enough
+  bool use_huge_pages{false};
+};
+
+/// A property graph exported to a sealed memfd segment, so that the worker
+/// processes of a pool attach one copy of it instead of each loading its
+/// own: the segment holds the topology, the entity types and the loaded
+/// properties, and the graphs attached to it map it read only, so their
+/// pages are shared and count once towards the memory of the host.
+///
+/// A pool forks its workers before anything starts a SharedMemSys, since
+/// forking a process with running threads is not safe; the parent then
+/// loads the graph, exports it and sends the segment to each worker over a
+/// unix socket, and each worker starts its own SharedMemSys and attaches
+/// the segment it receives.
+class KATANA_EXPORT SharedGraph {
+public:
+  SharedGraph(SharedGraph&& other) noexcept;
+  SharedGraph& operator=(SharedGraph&& other) noexcept;
+  SharedGraph(const SharedGraph&) = delete;
+  SharedGraph& operator=(const SharedGraph&) = delete;
+  ~SharedGraph();
+
+  /// Copy the topology, the entity types and the loaded properties of pg to
+  /// a new segment. Projected graphs and topologies with property indexes
+  /// are not supported.
+  static Result<SharedGraph> Export(
+      const PropertyGraph& pg,
+      const SharedGraphOptions& opts = SharedGraphOptions());
+
+  /// Take ownership of fd, a segment made by Export
+  static Result<SharedGraph> FromFd(int fd);
+
+  /// Send a copy of the descriptor of the segment over the unix socket
+  /// socket_fd
+  Result<void> Send(int socket_fd) const;
+
+  /// Receive a segment that Send sent over the unix socket socket_fd
+  static Result<SharedGraph> Receive(int socket_fd);
+
+  /// Make a property graph over a read only mapping of the segment, which
+  /// the graph keeps until it is destroyed. Reading the graph and adding
+  /// properties to it work as usual, but nothing may change its topology,
+  /// entity types or the properties it started with in place.
+  Result<std::unique_ptr<PropertyGraph>> Attach(TxnContext* txn_ctx) const;
+
+  int fd() const { return fd_; }
+  size_t size() const { return size_; }
+
+private:
+  SharedGraph(int fd, size_t size) : fd_(fd), size_(size) {}
+
+  int fd_{-1};
+  size_t size_{0};
+};
+
+}  // namespace katana
+
+#endif
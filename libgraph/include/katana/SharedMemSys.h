@@ -9,6 +9,8 @@
 
 namespace katana {
 
+class CommBackend;
+
 /**
  * SharedMemSys initializes the Galois library for shared memory. Most Galois
  * library operations are only valid during the lifetime of a SharedMemSys or a
@@ -24,6 +26,11 @@ class KATANA_EXPORT SharedMemSys {
 
 public:
   SharedMemSys(std::unique_ptr<ProgressTracer> tracer = TextTracer::Make());
+  /// Storage operations are collective over the tasks of comm, e.g., the
+  /// hosts writing the partitions of one RDG; comm must outlive this
+  explicit SharedMemSys(
+      CommBackend* comm,
+      std::unique_ptr<ProgressTracer> tracer = TextTracer::Make());
   ~SharedMemSys();
 
   SharedMemSys(const SharedMemSys&) = delete;
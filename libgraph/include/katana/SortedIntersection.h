@@ -0,0 +1,159 @@
+#ifndef KATANA_LIBGRAPH_KATANA_SORTEDINTERSECTION_H_
+#define KATANA_LIBGRAPH_KATANA_SORTEDINTERSECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "katana/config.h"
+
+namespace katana {
+
+// Intersections of sorted node id ranges, e.g., of adjacency lists sorted by
+// destination.
+//
+// The vector kernels behind SortedIntersectionCount and SortedIntersection
+// require ranges without duplicates, which debug builds assert. Adjacency
+// lists of graphs with parallel edges must use ForEachSortedIntersection or
+// SortedMultisetIntersectionCount instead.
+
+/// The instruction sets an intersection kernel may be built for. The fastest
+/// one the CPU supports is selected on first use.
+enum class IntersectionKernel {
+  kScalar,
+  kSSE42,
+  kAVX2,
+  kAVX512,
+};
+
+/// When one range is this many times longer than the other, the elements of
+/// the shorter one are galloped (exponential then binary search) through the
+/// longer one instead of merging
+constexpr size_t kIntersectionGallopRatio = 32;
+
+/// The kernel used by SortedIntersectionCount and SortedIntersection
+KATANA_EXPORT IntersectionKernel SelectedIntersectionKernel() noexcept;
+
+/// Whether \p kernel was compiled in and is supported by this CPU
+KATANA_EXPORT bool IsIntersectionKernelSupported(
+    IntersectionKernel kernel) noexcept;
+
+/// Number of elements in both [a, a + a_size) and [b, b + b_size). Both ranges
+/// must be sorted and free of duplicates; with duplicates, the count would
+/// depend on the kernel.
+KATANA_EXPORT size_t SortedIntersectionCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b,
+    size_t b_size) noexcept;
+
+/// SortedIntersectionCount with an explicit kernel, which must be supported
+KATANA_EXPORT size_t SortedIntersectionCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    IntersectionKernel kernel) noexcept;
+
+/// Writes the elements in both [a, a + a_size) and [b, b + b_size) to \p out
+/// in increasing order and returns how many there are. Both ranges must be
+/// sorted and free of duplicates; \p out must have room for
+/// min(a_size, b_size) elements.
+KATANA_EXPORT size_t SortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) noexcept;
+
+/// SortedIntersection with an explicit kernel, which must be supported
+KATANA_EXPORT size_t SortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out, IntersectionKernel kernel) noexcept;
+
+/// First position in [first, first + size) whose element is not less than
+/// \p value, searching exponentially from the start of the range
+inline size_t
+GallopLowerBound(const uint32_t* first, size_t size, uint32_t value) noexcept {
+  size_t lo = 0;
+  size_t step = 1;
+  while (step <= size && first[step - 1] < value) {
+    lo = step;
+    step *= 2;
+  }
+  size_t hi = step <= size ? step - 1 : size;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (first[mid] < value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/// Calls \p fn(i, j) for each a[i] == b[j], in increasing order, until \p fn
+/// returns false. Unlike SortedIntersection, this reports positions, so that
+/// callers can look at per-edge data of the matches, and it allows duplicates
+/// (each duplicate is matched at most once, as in std::set_intersection).
+///
+/// \returns false if \p fn stopped the iteration
+template <typename Fn>
+bool
+ForEachSortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    Fn fn) {
+  size_t i = 0;
+  size_t j = 0;
+  if (a_size * kIntersectionGallopRatio < b_size) {
+    for (; i < a_size && j < b_size; ++i) {
+      j += GallopLowerBound(b + j, b_size - j, a[i]);
+      if (j < b_size && b[j] == a[i]) {
+        if (!fn(i, j)) {
+          return false;
+        }
+        ++j;
+      }
+    }
+    return true;
+  }
+  if (b_size * kIntersectionGallopRatio < a_size) {
+    for (; i < a_size && j < b_size; ++j) {
+      i += GallopLowerBound(a + i, a_size - i, b[j]);
+      if (i < a_size && a[i] == b[j]) {
+        if (!fn(i, j)) {
+          return false;
+        }
+        ++i;
+      }
+    }
+    return true;
+  }
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (!fn(i, j)) {
+        return false;
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return true;
+}
+
+/// Number of elements in both [a, a + a_size) and [b, b + b_size), counted as
+/// std::set_intersection does: a value that is m times in one range and n
+/// times in the other counts min(m, n) times. Both ranges must be sorted, but
+/// unlike SortedIntersectionCount they may have duplicates, e.g., the
+/// adjacency lists of a multigraph. It is not vectorized.
+inline size_t
+SortedMultisetIntersectionCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b,
+    size_t b_size) noexcept {
+  size_t count = 0;
+  ForEachSortedIntersection(a, a_size, b, b_size, [&](size_t, size_t) {
+    ++count;
+    return true;
+  });
+  return count;
+}
+
+}  // namespace katana
+
+#endif
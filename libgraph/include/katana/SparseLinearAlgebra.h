@@ -0,0 +1,542 @@
+#ifndef KATANA_LIBGRAPH_KATANA_SPARSELINEARALGEBRA_H_
+#define KATANA_LIBGRAPH_KATANA_SPARSELINEARALGEBRA_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/TiledTopology.h"
+
+namespace katana {
+
+// Sparse linear algebra over the adjacency matrix of a graph view, after
+// GraphBLAS: the matrix has an entry for every edge u -> v, whose value is
+// given by a functor of the property index of the edge, and vectors have an
+// entry for every node. The products are over a semiring, a struct of static
+// functions that the kernels are instantiated with, so that every semiring
+// compiles to its own loop:
+//
+//   using value_type = ...;
+//   static constexpr value_type Zero();
+//   static value_type Add(value_type a, value_type b);
+//   /// edge is the value of the matrix entry, x the one of the vector
+//   static value_type Multiply(value_type edge, value_type x);
+//   /// Add(a, b) into a, concurrently with other calls on a
+//   static void AtomicAdd(std::atomic<value_type>& a, value_type b);
+//   /// Whether Add(a, b) is a for every b, so that a sum can stop early
+//   static bool IsSaturated(value_type a);
+//
+// Zero must be the identity of Add and annihilate Multiply.
+
+/// The arithmetic semiring, e.g., for PageRank and feature propagation
+template <typename T>
+struct PlusTimesSemiring {
+  using value_type = T;
+  static constexpr T Zero() { return T{0}; }
+  static T Add(T a, T b) { return a + b; }
+  static T Multiply(T edge, T x) { return edge * x; }
+  static void AtomicAdd(std::atomic<T>& a, T b) { katana::atomicAdd(a, b); }
+  static bool IsSaturated(T) { return false; }
+};
+
+/// The tropical semiring of shortest paths, with the largest value, or
+/// infinity, as the distance to unreached nodes
+template <typename T>
+struct MinPlusSemiring {
+  using value_type = T;
+  static constexpr T Zero() {
+    return std::numeric_limits<T>::has_infinity
+               ? std::numeric_limits<T>::infinity()
+               : std::numeric_limits<T>::max();
+  }
+  static T Add(T a, T b) { return std::min(a, b); }
+  static T Multiply(T edge, T x) {
+    // saturates rather than overflow
+    return x >= Zero() - edge ? Zero() : edge + x;
+  }
+  static void AtomicAdd(std::atomic<T>& a, T b) { katana::atomicMin(a, b); }
+  static bool IsSaturated(T) { return false; }
+};
+
+/// The boolean semiring of reachability, e.g., for BFS. The edge values are
+/// 1 for every edge of the graph.
+struct OrAndSemiring {
+  using value_type = uint8_t;
+  static constexpr uint8_t Zero() { return 0; }
+  static uint8_t Add(uint8_t a, uint8_t b) { return a | b; }
+  static uint8_t Multiply(uint8_t edge, uint8_t x) { return edge & x; }
+  static void AtomicAdd(std::atomic<uint8_t>& a, uint8_t b) {
+    if (b && !a.load(std::memory_order_relaxed)) {
+      a.store(b, std::memory_order_relaxed);
+    }
+  }
+  static bool IsSaturated(uint8_t a) { return a != 0; }
+};
+
+/// The semiring of label propagation, e.g., for connected components: every
+/// node takes the smallest label of its neighbors, whatever the edge values
+template <typename T>
+struct MinSecondSemiring {
+  using value_type = T;
+  static constexpr T Zero() { return std::numeric_limits<T>::max(); }
+  static T Add(T a, T b) { return std::min(a, b); }
+  static T Multiply(T, T x) { return x; }
+  static void AtomicAdd(std::atomic<T>& a, T b) { katana::atomicMin(a, b); }
+  static bool IsSaturated(T) { return false; }
+};
+
+/// The matrix value of every edge for semirings that ignore it or graphs
+/// without weights
+template <typename T>
+struct UnitEdgeValue {
+  template <typename PropertyIndex>
+  T operator()(PropertyIndex) const {
+    return T{1};
+  }
+};
+
+/// The mask that keeps every entry of the output
+struct NoMask {
+  bool operator()(uint32_t) const { return true; }
+};
+
+/**
+ * A vector over the nodes of a graph, whose missing entries are the zero
+ * of a semiring. The values are always stored densely; a sparse vector
+ * also lists its entries, so that they can be iterated without a pass over
+ * all the nodes, in the same way as a sparse Frontier.
+ *
+ * Set and Accumulate may be called concurrently; everything else is not
+ * thread safe.
+ */
+template <typename T>
+class SemiringVector {
+public:
+  /// Fraction of all entries (one in kDenseDivisor) above which Adapt makes
+  /// a vector dense
+  static constexpr size_t kDenseDivisor = 20;
+
+  /// An empty sparse vector of size entries
+  SemiringVector(size_t size, T zero) : zero_(zero) {
+    values_.allocateBlocked(size);
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) { values_[i].store(zero_, std::memory_order_relaxed); },
+        katana::no_stats());
+    listed_.resize(size);
+  }
+
+  size_t size() const { return values_.size(); }
+
+  T zero() const { return zero_; }
+
+  bool IsSparse() const { return sparse_; }
+
+  T operator[](size_t index) const {
+    return values_[index].load(std::memory_order_relaxed);
+  }
+
+  /// Number of entries, or, for a dense vector, of entries that are not
+  /// zero
+  size_t NumEntries() const {
+    if (sparse_) {
+      return num_listed_.reduce();
+    }
+    katana::GAccumulator<size_t> count;
+    katana::do_all(
+        katana::iterate(size_t{0}, size()),
+        [&](size_t i) { count += (*this)[i] != zero_; }, katana::no_stats());
+    return count.reduce();
+  }
+
+  /// Sets an entry. An entry may not be set concurrently with itself.
+  void Set(size_t index, T value) {
+    values_[index].store(value, std::memory_order_relaxed);
+    List(index);
+  }
+
+  /// Adds value into an entry with the semiring
+  template <typename Semiring>
+  void Accumulate(size_t index, T value) {
+    Semiring::AtomicAdd(values_[index], value);
+    List(index);
+  }
+
+  /// Removes all entries, leaving the vector sparse
+  void clear() {
+    if (sparse_) {
+      katana::do_all(
+          katana::iterate(listed_indices_),
+          [&](uint32_t i) {
+            values_[i].store(zero_, std::memory_order_relaxed);
+            listed_.reset(i);
+          },
+          katana::no_stats());
+      listed_indices_.clear();
+    } else {
+      katana::do_all(
+          katana::iterate(size_t{0}, size()),
+          [&](size_t i) { values_[i].store(zero_, std::memory_order_relaxed); },
+          katana::no_stats());
+      sparse_ = true;
+    }
+    num_listed_.reset();
+  }
+
+  /// Switches to a dense vector, keeping the entries
+  void ToDense() {
+    if (!sparse_) {
+      return;
+    }
+    katana::do_all(
+        katana::iterate(listed_indices_), [&](uint32_t i) { listed_.reset(i); },
+        katana::no_stats());
+    listed_indices_.clear();
+    num_listed_.reset();
+    sparse_ = false;
+  }
+
+  /// Switches to a sparse vector listing the entries that are not zero
+  void ToSparse() {
+    if (sparse_) {
+      return;
+    }
+    sparse_ = true;
+    katana::do_all(
+        katana::iterate(size_t{0}, size()),
+        [&](size_t i) {
+          if ((*this)[i] != zero_) {
+            List(i);
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// Whether a vector of this many entries would rather be dense
+  bool PrefersDense() const {
+    return NumEntries() > size() / kDenseDivisor;
+  }
+
+  /// Switches to the representation that PrefersDense picks
+  void Adapt() {
+    if (PrefersDense()) {
+      ToDense();
+    } else {
+      ToSparse();
+    }
+  }
+
+  /// Calls fn(index, value) in parallel for every entry, or every entry
+  /// that is not zero of a dense vector; args are passed on to do_all
+  template <typename F, typename... Args>
+  void ForEach(F fn, Args&&... args) const {
+    if (sparse_) {
+      katana::do_all(
+          katana::iterate(listed_indices_),
+          [&](uint32_t i) { fn(i, (*this)[i]); }, std::forward<Args>(args)...);
+    } else {
+      katana::do_all(
+          katana::iterate(size_t{0}, size()),
+          [&](size_t i) {
+            if (T value = (*this)[i]; value != zero_) {
+              fn(i, value);
+            }
+          },
+          std::forward<Args>(args)...);
+    }
+  }
+
+private:
+  void List(size_t index) {
+    if (sparse_ && !listed_.set(index)) {
+      listed_indices_.push(index);
+      num_listed_ += 1;
+    }
+  }
+
+  T zero_;
+  bool sparse_{true};
+  katana::NUMAArray<std::atomic<T>> values_;
+  katana::DynamicBitset listed_;
+  mutable katana::InsertBag<uint32_t> listed_indices_;
+  mutable katana::GAccumulator<size_t> num_listed_;
+};
+
+/// How SpMV goes over the edges
+enum class SpMVDirection {
+  /// From every entry of the input along its out edges, with atomic updates
+  /// of the output; cheap for sparse inputs
+  kPush,
+  /// From every entry of the output along its in edges, without atomics,
+  /// skipping the masked entries and stopping at saturated ones; cheap for
+  /// dense inputs and sparse masks. Needs a view with in edges.
+  kPull,
+  /// Push if the out edges of the input are few, as in direction
+  /// optimizing BFS, and pull otherwise
+  kAuto,
+};
+
+namespace internal {
+
+template <typename Graph, typename = void>
+struct HasInEdges : std::false_type {};
+
+template <typename Graph>
+struct HasInEdges<
+    Graph, std::void_t<decltype(std::declval<const Graph&>().InEdges(0))>>
+    : std::true_type {};
+
+}  // namespace internal
+
+/// Pull instead of push once the out edges of the input are more than one
+/// in kSpMVPullDivisor of all the edges
+constexpr size_t kSpMVPullDivisor = 20;
+
+/**
+ * y = mask .* (A' x) over Semiring, where A is the adjacency matrix of
+ * graph, whose entry for an edge e is edge_value(property index of e): for
+ * every node v such that mask(v), y[v] is the sum over the edges u -> v of
+ * edge_value(u -> v) times x[u]. The other entries of y are zero.
+ *
+ * y must have as many entries as graph has nodes and comes out in the
+ * representation that Adapt picks.
+ */
+template <
+    typename Semiring, typename Graph, typename EdgeValue,
+    typename Mask = NoMask>
+void
+SpMV(
+    const Graph& graph, const EdgeValue& edge_value,
+    const SemiringVector<typename Semiring::value_type>& x,
+    SemiringVector<typename Semiring::value_type>* y, const Mask& mask = {},
+    SpMVDirection direction = SpMVDirection::kAuto) {
+  using T = typename Semiring::value_type;
+  using Node = typename Graph::Node;
+  KATANA_LOG_DEBUG_ASSERT(x.size() == graph.NumNodes());
+  KATANA_LOG_DEBUG_ASSERT(y->size() == graph.NumNodes());
+  y->clear();
+
+  if constexpr (!internal::HasInEdges<Graph>::value) {
+    KATANA_LOG_DEBUG_ASSERT(direction != SpMVDirection::kPull);
+    direction = SpMVDirection::kPush;
+  } else if (direction == SpMVDirection::kAuto) {
+    direction = SpMVDirection::kPull;
+    if (x.IsSparse()) {
+      katana::GAccumulator<size_t> work;
+      x.ForEach(
+          [&](Node u, T) { work += graph.OutDegree(u); }, katana::no_stats());
+      if (work.reduce() <= graph.NumEdges() / kSpMVPullDivisor) {
+        direction = SpMVDirection::kPush;
+      }
+    }
+  }
+
+  if (direction == SpMVDirection::kPush) {
+    x.ForEach(
+        [&](Node u, T x_u) {
+          for (auto e : graph.OutEdges(u)) {
+            Node v = graph.OutEdgeDst(e);
+            if (mask(v)) {
+              y->template Accumulate<Semiring>(
+                  v, Semiring::Multiply(
+                         edge_value(graph.GetEdgePropertyIndexFromOutEdge(e)),
+                         x_u));
+            }
+          }
+        },
+        katana::steal(), katana::loopname("SpMV-Push"));
+    y->Adapt();
+    return;
+  }
+
+  if constexpr (internal::HasInEdges<Graph>::value) {
+    y->ToDense();
+    const T zero = Semiring::Zero();
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(graph.NumNodes())),
+        [&](Node v) {
+          if (!mask(v)) {
+            return;
+          }
+          T sum = zero;
+          for (auto e : graph.InEdges(v)) {
+            T x_u = x[graph.InEdgeSrc(e)];
+            if (x_u == zero) {
+              continue;
+            }
+            sum = Semiring::Add(
+                sum, Semiring::Multiply(
+                         edge_value(graph.GetEdgePropertyIndexFromInEdge(e)),
+                         x_u));
+            if (Semiring::IsSaturated(sum)) {
+              break;
+            }
+          }
+          if (sum != zero) {
+            y->Set(v, sum);
+          }
+        },
+        katana::steal(), katana::loopname("SpMV-Pull"));
+    y->Adapt();
+  }
+}
+
+/**
+ * Y = mask .* (A' X) over Semiring for dense matrices of num_columns
+ * columns, stored by rows with a row per node: for every node v such that
+ * mask(v), row v of Y is the sum over the edges u -> v of edge_value(u -> v)
+ * times row u of X. The other rows of Y are zero.
+ *
+ * Y is sized by this function. Every row of Y is computed by one thread
+ * from the in edges of its node, so the view must have them; the inner loop
+ * over the columns is a tight loop the compiler can vectorize.
+ */
+template <
+    typename Semiring, typename Graph, typename EdgeValue,
+    typename Mask = NoMask>
+void
+SpMM(
+    const Graph& graph, const EdgeValue& edge_value,
+    const katana::NUMAArray<typename Semiring::value_type>& x,
+    size_t num_columns, katana::NUMAArray<typename Semiring::value_type>* y,
+    const Mask& mask = {}) {
+  static_assert(
+      internal::HasInEdges<Graph>::value,
+      "SpMM needs a view with in edges, e.g., PropertyGraphViews::"
+      "BiDirectional");
+  using T = typename Semiring::value_type;
+  using Node = typename Graph::Node;
+  KATANA_LOG_DEBUG_ASSERT(x.size() == graph.NumNodes() * num_columns);
+
+  if (y->size() != x.size()) {
+    y->deallocate();
+    y->allocateBlocked(x.size());
+  }
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(graph.NumNodes())),
+      [&](Node v) {
+        T* y_v = y->data() + v * num_columns;
+        std::fill(y_v, y_v + num_columns, Semiring::Zero());
+        if (!mask(v)) {
+          return;
+        }
+        for (auto e : graph.InEdges(v)) {
+          const T* x_u = x.data() + graph.InEdgeSrc(e) * num_columns;
+          T a = edge_value(graph.GetEdgePropertyIndexFromInEdge(e));
+          for (size_t c = 0; c < num_columns; ++c) {
+            y_v[c] = Semiring::Add(y_v[c], Semiring::Multiply(a, x_u[c]));
+          }
+        }
+      },
+      katana::steal(), katana::loopname("SpMM"));
+}
+
+/**
+ * y = mask .* (A' x) over Semiring, as SpMV, but over the tiles of a
+ * TiledTopology of the graph rather than over a view: every destination
+ * block is summed by one thread, tile by tile, so the parts of x and y that
+ * a tile touches stay in cache and y is updated without atomics. Rows whose
+ * sum is saturated are skipped.
+ *
+ * y must have as many entries as the topology has nodes and comes out in
+ * the representation that Adapt picks.
+ */
+template <typename Semiring, typename EdgeValue, typename Mask = NoMask>
+void
+TiledSpMV(
+    const TiledTopology& tiles, const EdgeValue& edge_value,
+    const SemiringVector<typename Semiring::value_type>& x,
+    SemiringVector<typename Semiring::value_type>* y, const Mask& mask = {}) {
+  using T = typename Semiring::value_type;
+  using Node = TiledTopology::Node;
+  KATANA_LOG_DEBUG_ASSERT(x.size() == tiles.NumNodes());
+  KATANA_LOG_DEBUG_ASSERT(y->size() == tiles.NumNodes());
+  y->clear();
+  y->ToDense();
+
+  const T zero = Semiring::Zero();
+  tiles.ForEachRow(
+      [&](Node v, const TiledTopology::RowEdges& row) {
+        if (!mask(v)) {
+          return;
+        }
+        T sum = (*y)[v];
+        if (Semiring::IsSaturated(sum)) {
+          return;
+        }
+        for (size_t j = 0; j < row.size; ++j) {
+          T x_u = x[row.srcs[j]];
+          if (x_u == zero) {
+            continue;
+          }
+          sum = Semiring::Add(
+              sum,
+              Semiring::Multiply(edge_value(row.property_indices[j]), x_u));
+          if (Semiring::IsSaturated(sum)) {
+            break;
+          }
+        }
+        if (sum != zero) {
+          y->Set(v, sum);
+        }
+      },
+      katana::loopname("TiledSpMV"));
+  y->Adapt();
+}
+
+/**
+ * Y = mask .* (A' X) over Semiring, as SpMM, but over the tiles of a
+ * TiledTopology of the graph, which needs no in edges: every destination
+ * block is summed by one thread, tile by tile, so the rows of X and Y that
+ * a tile touches stay in cache.
+ */
+template <typename Semiring, typename EdgeValue, typename Mask = NoMask>
+void
+TiledSpMM(
+    const TiledTopology& tiles, const EdgeValue& edge_value,
+    const katana::NUMAArray<typename Semiring::value_type>& x,
+    size_t num_columns, katana::NUMAArray<typename Semiring::value_type>* y,
+    const Mask& mask = {}) {
+  using T = typename Semiring::value_type;
+  using Node = TiledTopology::Node;
+  KATANA_LOG_DEBUG_ASSERT(x.size() == tiles.NumNodes() * num_columns);
+
+  if (y->size() != x.size()) {
+    y->deallocate();
+    y->allocateBlocked(x.size());
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, y->size()),
+      [&](size_t i) { (*y)[i] = Semiring::Zero(); }, katana::no_stats());
+
+  tiles.ForEachRow(
+      [&](Node v, const TiledTopology::RowEdges& row) {
+        if (!mask(v)) {
+          return;
+        }
+        T* y_v = y->data() + v * num_columns;
+        for (size_t j = 0; j < row.size; ++j) {
+          const T* x_u = x.data() + row.srcs[j] * num_columns;
+          T a = edge_value(row.property_indices[j]);
+          for (size_t c = 0; c < num_columns; ++c) {
+            y_v[c] = Semiring::Add(y_v[c], Semiring::Multiply(a, x_u[c]));
+          }
+        }
+      },
+      katana::loopname("TiledSpMM"));
+}
+
+}  // namespace katana
+
+#endif
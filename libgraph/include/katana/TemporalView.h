@@ -0,0 +1,138 @@
+#ifndef KATANA_LIBGRAPH_KATANA_TEMPORALVIEW_H_
+#define KATANA_LIBGRAPH_KATANA_TEMPORALVIEW_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class PropertyGraph;
+
+/// The edges of a PropertyGraph whose timestamp, an integer or arrow
+/// timestamp edge property, is in a window [window_begin(), window_end()).
+///
+/// Make sorts the edges of each node by timestamp once, into an
+/// EdgeShuffleTopology of kind kSortedByEdgeProperty, and copies the
+/// timestamps into that order. Window() then returns a view of other bounds
+/// sharing both, so a series of windows, e.g., one per month, costs one sort
+/// rather than a projected graph each; OutEdges() finds the edges of a node
+/// in the window with two binary searches.
+///
+/// Edge ids are those of the sorted topology, and NumEdges() counts all of
+/// its edges, so arrays indexed by edge id are sized as for any other view.
+/// Edges whose timestamp is null are in no window.
+class KATANA_EXPORT TemporalView : public GraphTopologyTypes {
+public:
+  using Timestamp = int64_t;
+
+  static constexpr Timestamp kMinTimestamp =
+      std::numeric_limits<Timestamp>::min();
+  static constexpr Timestamp kMaxTimestamp =
+      std::numeric_limits<Timestamp>::max();
+
+  /// Sort the edges of \p pg by the edge property \p timestamp_property,
+  /// which must be integer or timestamp typed. The edges are reversed if
+  /// \p tpose_todo is kYes, for algorithms that pull from in-neighbors. The
+  /// window of the result holds every edge with a timestamp.
+  static Result<TemporalView> Make(
+      PropertyGraph* pg, const std::string& timestamp_property,
+      RDGTopology::TransposeKind tpose_todo = RDGTopology::TransposeKind::kNo);
+
+  /// This view restricted to the edges with timestamps in [t0, t1). Cheap;
+  /// it shares the topology and the timestamps of this view.
+  TemporalView Window(Timestamp t0, Timestamp t1) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(t0 <= t1);
+    TemporalView ret(*this);
+    ret.t0_ = t0;
+    ret.t1_ = t1;
+    return ret;
+  }
+
+  Timestamp window_begin() const noexcept { return t0_; }
+
+  Timestamp window_end() const noexcept { return t1_; }
+
+  bool is_transposed() const noexcept { return topo_->is_transposed(); }
+
+  uint64_t NumNodes() const noexcept { return topo_->NumNodes(); }
+
+  /// The number of edges of all windows
+  uint64_t NumEdges() const noexcept { return topo_->NumEdges(); }
+
+  nodes_range Nodes() const noexcept { return topo_->Nodes(); }
+
+  /// The edges of \p node in the window, in order of timestamp
+  edges_range OutEdges(Node node) const noexcept {
+    return OutEdgesAtOrAfter(node, t0_);
+  }
+
+  /// The edges of \p node in the window whose timestamp is at least \p t,
+  /// e.g., the edges that continue a time-respecting path reaching \p node
+  /// at \p t
+  edges_range OutEdgesAtOrAfter(Node node, Timestamp t) const noexcept {
+    auto edges = topo_->OutEdges(node);
+    const Timestamp* times = times_->data();
+    auto first = std::lower_bound(
+        edges.begin(), edges.end(), std::max(t, t0_),
+        [times](Edge e, Timestamp v) { return times[e] < v; });
+    auto last = std::lower_bound(
+        first, edges.end(), t1_,
+        [times](Edge e, Timestamp v) { return times[e] < v; });
+    return MakeStandardRange(first, last);
+  }
+
+  size_t OutDegree(Node node) const noexcept { return OutEdges(node).size(); }
+
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    return topo_->OutEdgeDst(edge_id);
+  }
+
+  Timestamp GetEdgeTimestamp(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < NumEdges());
+    return (*times_)[edge_id];
+  }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& eid) const noexcept {
+    return topo_->GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept {
+    return topo_->GetNodePropertyIndex(nid);
+  }
+
+  // Standard container concepts
+
+  node_iterator begin() const noexcept { return Nodes().begin(); }
+
+  node_iterator end() const noexcept { return Nodes().end(); }
+
+  size_t size() const noexcept { return NumNodes(); }
+
+  bool empty() const noexcept { return NumNodes() == 0; }
+
+private:
+  TemporalView(
+      std::shared_ptr<const EdgeShuffleTopology> topo,
+      std::shared_ptr<const std::vector<Timestamp>> times) noexcept
+      : topo_(std::move(topo)), times_(std::move(times)) {}
+
+  std::shared_ptr<const EdgeShuffleTopology> topo_;
+  /// The timestamp of each edge of topo_, kMaxTimestamp if null
+  std::shared_ptr<const std::vector<Timestamp>> times_;
+  Timestamp t0_{kMinTimestamp};
+  Timestamp t1_{kMaxTimestamp};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef KATANA_LIBGRAPH_KATANA_TILEDTOPOLOGY_H_
+#define KATANA_LIBGRAPH_KATANA_TILEDTOPOLOGY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The edges of a GraphTopology in 2D blocks, for kernels that touch the
+/// data of both ends of every edge, like the pull loops of SpMV, PageRank
+/// and feature propagation.
+///
+/// The nodes are cut into blocks of block_size consecutive nodes, and the
+/// edges into tiles, one for every pair of a source block and a destination
+/// block with edges between them. Within a tile, edges are sorted by
+/// destination then source, in rows of the edges of one destination. While
+/// a thread goes over a tile, it reads the data of at most block_size
+/// sources and writes that of at most block_size destinations, so both stay
+/// in cache when block_size is picked for it.
+///
+/// A dense tile has a row for every destination of its block, so the row of
+/// a destination is found by its offset in the block; a sparse tile only
+/// has rows for the destinations with edges, which it lists, so that tiles
+/// of few edges cost no more than their edges.
+///
+/// The tiles are built once, in time and space linear in the number of
+/// edges, and do not follow later changes to the topology.
+class KATANA_EXPORT TiledTopology : public GraphTopologyTypes {
+public:
+  static constexpr uint32_t kDefaultBlockSize = uint32_t{1} << 16;
+
+  /// Tiles with edges to more than one in kDenseTileDivisor of the
+  /// destinations of their block are dense
+  static constexpr uint32_t kDenseTileDivisor = 8;
+
+  struct Tile {
+    uint32_t src_block;
+    uint32_t dst_block;
+    bool dense;
+    /// The number of rows, or, for a dense tile, the number of nodes of
+    /// dst_block
+    uint32_t num_rows;
+    /// The index of the first row in the row offsets, which have an entry
+    /// for every row plus one for the end of the last
+    uint64_t row_begin;
+    /// The index of the first row in the row destinations of sparse tiles
+    uint64_t sparse_row_begin;
+  };
+
+  /// The edges of one row of a tile: the sources of the edges into one
+  /// destination, and the property indices of the edges
+  struct RowEdges {
+    const Node* srcs;
+    const PropertyIndex* property_indices;
+    size_t size;
+  };
+
+  TiledTopology() = default;
+  TiledTopology(TiledTopology&&) = default;
+  TiledTopology& operator=(TiledTopology&&) = default;
+
+  TiledTopology(const TiledTopology&) = delete;
+  TiledTopology& operator=(const TiledTopology&) = delete;
+
+  static TiledTopology Make(
+      const GraphTopology& topo, uint32_t block_size = kDefaultBlockSize);
+
+  uint64_t NumNodes() const noexcept { return num_nodes_; }
+  uint64_t NumEdges() const noexcept { return srcs_.size(); }
+
+  uint32_t block_size() const noexcept { return block_size_; }
+  uint32_t NumBlocks() const noexcept {
+    return static_cast<uint32_t>(column_begins_.size() - 1);
+  }
+
+  Node BlockBegin(uint32_t block) const noexcept {
+    return static_cast<Node>(uint64_t{block} * block_size_);
+  }
+  Node BlockEnd(uint32_t block) const noexcept {
+    return static_cast<Node>(
+        std::min(uint64_t{block + 1} * block_size_, num_nodes_));
+  }
+
+  uint64_t NumTiles() const noexcept { return tiles_.size(); }
+  const Tile& GetTile(uint64_t i) const noexcept { return tiles_[i]; }
+
+  /// The tiles of destination block block are [ColumnBegin(block),
+  /// ColumnEnd(block)), by source block
+  uint64_t ColumnBegin(uint32_t block) const noexcept {
+    return column_begins_[block];
+  }
+  uint64_t ColumnEnd(uint32_t block) const noexcept {
+    return column_begins_[block + 1];
+  }
+
+  /// Calls fn(dst, row_edges) for every row of tile i, in order
+  template <typename F>
+  void ForEachRowOfTile(uint64_t i, const F& fn) const {
+    const Tile& tile = tiles_[i];
+    const Node block_begin = BlockBegin(tile.dst_block);
+    for (uint32_t r = 0; r < tile.num_rows; ++r) {
+      const uint64_t begin = row_offsets_[tile.row_begin + r];
+      const uint64_t end = row_offsets_[tile.row_begin + r + 1];
+      if (begin == end) {
+        continue;
+      }
+      const Node dst = tile.dense ? block_begin + r
+                                  : row_dsts_[tile.sparse_row_begin + r];
+      fn(dst, RowEdges{&srcs_[begin], &property_indices_[begin], end - begin});
+    }
+  }
+
+  /// Calls fn(dst, row_edges) for every row of every tile, in parallel over
+  /// the destination blocks. All the rows of a destination are visited by
+  /// the same thread, one after the other, so fn may update the data of dst
+  /// without atomics. The tiles of a destination block are visited from the
+  /// source block with the same index on, wrapping around, so that threads
+  /// on neighboring destination blocks read different sources at a time.
+  /// args are passed on to do_all.
+  template <typename F, typename... Args>
+  void ForEachRow(const F& fn, Args&&... args) const {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, NumBlocks()),
+        [&](uint32_t block) {
+          const uint64_t begin = ColumnBegin(block);
+          const uint64_t end = ColumnEnd(block);
+          // the first tile of the diagonal or after it
+          uint64_t start = begin;
+          while (start < end && tiles_[start].src_block < block) {
+            ++start;
+          }
+          for (uint64_t i = start; i < end; ++i) {
+            ForEachRowOfTile(i, fn);
+          }
+          for (uint64_t i = begin; i < start; ++i) {
+            ForEachRowOfTile(i, fn);
+          }
+        },
+        katana::steal(), std::forward<Args>(args)...);
+  }
+
+  /// Calls fn(dst, src, property_index) for every edge, in the same order
+  /// and with the same guarantees as ForEachRow
+  template <typename F, typename... Args>
+  void ForEachEdge(const F& fn, Args&&... args) const {
+    ForEachRow(
+        [&](Node dst, const RowEdges& row) {
+          for (size_t j = 0; j < row.size; ++j) {
+            fn(dst, row.srcs[j], row.property_indices[j]);
+          }
+        },
+        std::forward<Args>(args)...);
+  }
+
+private:
+  uint64_t num_nodes_{0};
+  uint32_t block_size_{kDefaultBlockSize};
+  /// The tiles by destination block, then source block
+  std::vector<Tile> tiles_;
+  std::vector<uint64_t> column_begins_{0};
+  katana::NUMAArray<uint64_t> row_offsets_;
+  katana::NUMAArray<Node> row_dsts_;
+  katana::NUMAArray<Node> srcs_;
+  katana::NUMAArray<PropertyIndex> property_indices_;
+};
+
+}  // namespace katana
+
+#endif
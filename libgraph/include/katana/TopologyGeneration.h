@@ -1,8 +1,12 @@
 #ifndef KATANA_LIBGRAPH_KATANA_TOPOLOGYGENERATION_H_
 #define KATANA_LIBGRAPH_KATANA_TOPOLOGYGENERATION_H_
 
+#include <cstdint>
+#include <vector>
+
 #include <arrow/type_traits.h>
 
+#include "katana/Loops.h"
 #include "katana/PropertyGraph.h"
 
 namespace katana {
@@ -35,6 +39,63 @@ KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeClique(
 KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeTriangle(
     size_t num_rows) noexcept;
 
+/*********************************************************/
+/* Functions for generating synthetic graphs at scale    */
+/*********************************************************/
+//
+// The generators below build their graphs in parallel. Their random numbers
+// come from streams determined by the seed and the block of nodes or edges
+// being generated, so a seed always produces the same graph whatever the
+// number of threads. The edges of each node are sorted by destination.
+
+/// The parameters of an R-MAT graph. Each edge is placed by descending
+/// scale levels of the adjacency matrix, choosing the top left, top right
+/// or bottom left quadrant with probability a, b and c and the bottom right
+/// one otherwise. The defaults are those of the Graph500 Kronecker
+/// generator.
+struct RMATParameters {
+  /// The graph has 2^scale nodes, at most 2^31
+  uint32_t scale{16};
+  /// The graph has edge_factor edges per node
+  uint64_t edge_factor{16};
+  double a{0.57};
+  double b{0.19};
+  double c{0.19};
+  /// Whether node ids are scrambled, as in Graph500, so that the ids of
+  /// high degree nodes are not the small ones
+  bool scramble_ids{true};
+  uint64_t seed{0};
+};
+
+/// Generates a directed R-MAT (Kronecker) graph. It may have self loops and
+/// parallel edges.
+KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>> MakeRMAT(
+    const RMATParameters& params);
+
+/// Generates a directed Barabasi-Albert graph of num_nodes nodes, each with
+/// edges_per_node edges to earlier nodes chosen by preferential attachment.
+/// The edges are generated independently of each other, as in the
+/// algorithm of Sanders and Schulz, so it may have self loops and parallel
+/// edges.
+KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>>
+MakeBarabasiAlbert(uint64_t num_nodes, uint64_t edges_per_node, uint64_t seed);
+
+/// The parameters of a typed, LDBC-style, property graph: an R-MAT
+/// topology whose nodes and edges have atomic entity types named
+/// node_type_<i> and edge_type_<i>. The ith most common of n types has a
+/// share proportional to 1 / i^type_skew, so 0 is a uniform mix of types
+/// and larger skews make the first types dominate.
+struct TypedGraphParameters {
+  RMATParameters topology;
+  uint32_t num_node_types{8};
+  uint32_t num_edge_types{16};
+  double type_skew{1.0};
+};
+
+/// Generates a typed property graph
+KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>> MakeTypedGraph(
+    const TypedGraphParameters& params);
+
 /***********************************************************/
 /* Functions for adding node and edge properties to graphs */
 /***********************************************************/
@@ -118,7 +179,19 @@ AddGraphProperties(
 
     // For property values
     auto builder = generator.MakeBuilder();
-    if constexpr (is_node) {
+    using ValueType = typename decltype(generator)::ValueType;
+    if constexpr (
+        std::is_arithmetic_v<ValueType> && !std::is_same_v<ValueType, bool>) {
+      // Numbers are generated in parallel, which matters for generated
+      // graphs of billions of edges
+      uint64_t num = is_node ? pg->NumNodes() : pg->NumEdges();
+      std::vector<ValueType> values(num);
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num),
+          [&](uint64_t i) { values[i] = generator(static_cast<ArgType>(i)); },
+          katana::no_stats());
+      KATANA_CHECKED(builder->AppendValues(values));
+    } else if constexpr (is_node) {
       KATANA_CHECKED(builder->Reserve(pg->NumNodes()));
       for (Node n : pg->Nodes()) {
         KATANA_CHECKED(builder->Append(generator(n)));
@@ -133,8 +206,7 @@ AddGraphProperties(
     std::shared_ptr<arrow::Array> array;
     KATANA_CHECKED(builder->Finish(&array));
 
-    // We anticipate that this API is going to be used for small synthetic graphs,
-    // so columns are made up of a single chunk.
+    // Columns are made up of a single chunk.
     columns.emplace_back(std::make_shared<arrow::ChunkedArray>(array));
 
     return katana::ResultSuccess();
@@ -168,6 +240,7 @@ class KATANA_EXPORT PropertyGenerator {
 public:
   /// \param name Property name
   /// \param value_func Value generator function, which accepts either a node or an edge id.
+  ///     It is called in parallel for properties of numbers.
   PropertyGenerator(const std::string& name, const ValueFunc& value_func)
       : name_(name), value_func_(value_func) {}
 
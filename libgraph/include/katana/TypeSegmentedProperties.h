@@ -0,0 +1,151 @@
+#ifndef KATANA_LIBGRAPH_KATANA_TYPESEGMENTEDPROPERTIES_H_
+#define KATANA_LIBGRAPH_KATANA_TYPESEGMENTEDPROPERTIES_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyViews.h"
+#include "katana/Result.h"
+#include "katana/Traits.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The node properties of a graph stored by entity type: the nodes of every
+/// most specific type are a segment, with a dense table of the properties
+/// that some node of the type has, its rows in the order of the node ids, and
+/// every node has an index local to its segment.
+///
+/// In a graph where every type has its own properties, the wide property
+/// table of the graph is mostly nulls, and a scan of the nodes of one type
+/// strides over the rows of the others; the segments hold only the values
+/// and make such scans contiguous.
+///
+/// The segments are a copy of the properties as of when they were made: they
+/// are read only, and do not see later changes to the properties of the
+/// graph.
+class KATANA_EXPORT TypeSegmentedNodeProperties : public GraphTopologyTypes {
+public:
+  struct Segment {
+    EntityTypeID type;
+    /// The nodes of the type, by local index
+    std::vector<Node> nodes;
+    /// The properties of the nodes, by local index, without the properties
+    /// that none of them has
+    std::shared_ptr<arrow::Table> properties;
+  };
+
+  /// Segments the named node properties of pg by type.
+  static Result<TypeSegmentedNodeProperties> Make(
+      const PropertyGraph& pg, const std::vector<std::string>& properties);
+
+  /// Segments all the loaded node properties of pg by type.
+  static Result<TypeSegmentedNodeProperties> Make(const PropertyGraph& pg);
+
+  /// The segment of the nodes of type, or nullptr if there are none
+  const Segment* GetSegment(EntityTypeID type) const {
+    if (type >= segment_of_type_.size() ||
+        segment_of_type_[type] == kNoSegment) {
+      return nullptr;
+    }
+    return &segments_[segment_of_type_[type]];
+  }
+
+  /// The segments in increasing order of type
+  const std::vector<Segment>& segments() const { return segments_; }
+
+  /// The row of node n in the segment of its type
+  uint32_t LocalIndex(Node n) const { return local_index_[n]; }
+
+  /// Number of bytes of the buffers of all segments
+  uint64_t SizeInBytes() const;
+
+private:
+  static constexpr uint32_t kNoSegment = std::numeric_limits<uint32_t>::max();
+
+  TypeSegmentedNodeProperties() = default;
+
+  std::vector<Segment> segments_;
+  std::vector<uint32_t> segment_of_type_;
+  NUMAArray<uint32_t> local_index_;
+};
+
+/// A typed view of the properties of one segment of
+/// TypeSegmentedNodeProperties, as TypedPropertyGraph is of the properties of
+/// a graph. Iterating it visits the nodes of the segment in increasing order
+/// of id, and their properties are contiguous.
+///
+/// \tparam NodeProps A tuple of property types (\ref Properties.h)
+template <typename NodeProps>
+class TypedPropertySegment {
+  using NodeView = PropertyViewTuple<NodeProps>;
+
+  const TypeSegmentedNodeProperties* storage_;
+  const TypeSegmentedNodeProperties::Segment* segment_;
+  NodeView node_view_;
+
+  TypedPropertySegment(
+      const TypeSegmentedNodeProperties* storage,
+      const TypeSegmentedNodeProperties::Segment* segment, NodeView node_view)
+      : storage_(storage),
+        segment_(segment),
+        node_view_(std::move(node_view)) {}
+
+public:
+  using Node = GraphTopology::Node;
+  using iterator = std::vector<Node>::const_iterator;
+
+  iterator begin() const { return segment_->nodes.begin(); }
+
+  iterator end() const { return segment_->nodes.end(); }
+
+  size_t size() const { return segment_->nodes.size(); }
+
+  bool empty() const { return segment_->nodes.empty(); }
+
+  EntityTypeID type() const { return segment_->type; }
+
+  /// The data of node, which must be of the type of the segment
+  template <typename NodeIndex>
+  PropertyConstReferenceType<NodeIndex> GetData(const Node& node) const {
+    return GetLocalData<NodeIndex>(storage_->LocalIndex(node));
+  }
+
+  /// The data of the node with local index index in the segment
+  template <typename NodeIndex>
+  PropertyConstReferenceType<NodeIndex> GetLocalData(uint32_t index) const {
+    constexpr size_t prop_col_index = find_trait<NodeIndex, NodeProps>();
+    return std::get<prop_col_index>(node_view_).GetValue(index);
+  }
+
+  /// Make a typed view of the named properties of the segment of type. It
+  /// returns an error if there is no node of type or if none of them has one
+  /// of the properties.
+  static Result<TypedPropertySegment<NodeProps>> Make(
+      const TypeSegmentedNodeProperties& storage, EntityTypeID type,
+      const std::vector<std::string>& node_properties) {
+    const TypeSegmentedNodeProperties::Segment* segment =
+        storage.GetSegment(type);
+    if (segment == nullptr) {
+      return KATANA_ERROR(
+          ErrorCode::NotFound, "no nodes of entity type {}", type);
+    }
+    auto node_view = KATANA_CHECKED(internal::MakePropertyViews<NodeProps>(
+        segment->properties.get(), node_properties));
+    return TypedPropertySegment(&storage, segment, std::move(node_view));
+  }
+};
+
+}  // namespace katana
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef KATANA_LIBGRAPH_KATANA_TYPEDPROPERTYGRAPH_H_
 #define KATANA_LIBGRAPH_KATANA_TYPEDPROPERTYGRAPH_H_
 
+#include <memory>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include <arrow/type_fwd.h>
 #include <boost/iterator/counting_iterator.hpp>
@@ -185,6 +188,12 @@ class TypedPropertyGraphView : public PGView {
   NodeView node_view_;
   EdgeView edge_view_;
 
+  /// Whether edge_view_ views copies of the edge properties in the edge
+  /// order of the view, see MakeWithEdgePropertiesInViewOrder
+  bool edges_in_view_order_{false};
+  /// Keeps the copies edge_view_ views alive
+  std::vector<std::shared_ptr<arrow::Array>> edge_arrays_;
+
   TypedPropertyGraphView(
       const PGView& pg_view, NodeView&& node_view, EdgeView&& edge_view)
       : PGView(pg_view),
@@ -236,14 +245,8 @@ public:
   template <typename EdgeIndex>
   PropertyReferenceType<EdgeIndex> GetEdgeData(const Edge& edge) {
     constexpr size_t prop_col_index = find_trait<EdgeIndex, EdgeProps>();
-
-    if constexpr (katana::is_detected_v<has_undirected_t, PGView>) {
-      return std::get<prop_col_index>(edge_view_)
-          .GetValue(PGView::GetEdgePropertyIndexFromUndirectedEdge(edge));
-    } else {
-      return std::get<prop_col_index>(edge_view_)
-          .GetValue(PGView::GetEdgePropertyIndexFromOutEdge(edge));
-    }
+    return std::get<prop_col_index>(edge_view_)
+        .GetValue(EdgePropertyIndex(edge));
   }
 
   /**
@@ -255,14 +258,8 @@ public:
   template <typename EdgeIndex>
   PropertyConstReferenceType<EdgeIndex> GetEdgeData(const Edge& edge) const {
     constexpr size_t prop_col_index = find_trait<EdgeIndex, EdgeProps>();
-
-    if constexpr (katana::is_detected_v<has_undirected_t, PGView>) {
-      return std::get<prop_col_index>(edge_view_)
-          .GetValue(PGView::GetEdgePropertyIndexFromUndirectedEdge(edge));
-    } else {
-      return std::get<prop_col_index>(edge_view_)
-          .GetValue(PGView::GetEdgePropertyIndexFromOutEdge(edge));
-    }
+    return std::get<prop_col_index>(edge_view_)
+        .GetValue(EdgePropertyIndex(edge));
   }
 
   static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> Make(
@@ -275,6 +272,28 @@ public:
       const std::vector<std::string>& edge_properties);
   static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> Make(
       const PGView& pg_view);
+
+  /// Like Make, but views copies of the edge properties laid out in the edge
+  /// order of the view, see PropertyGraph::GetEdgePropertyInViewOrder, so
+  /// that loops over the edges of sorted or transposed views read them
+  /// sequentially. For properties the analytic only reads; the copies are
+  /// shared and writes to them do not reach the graph.
+  static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>>
+  MakeWithEdgePropertiesInViewOrder(
+      PropertyGraph* pg, const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties);
+
+private:
+  /// The index of the edge properties of edge in edge_view_
+  auto EdgePropertyIndex(const Edge& edge) const {
+    if constexpr (katana::is_detected_v<has_undirected_t, PGView>) {
+      return PGView::GetEdgePropertyIndexFromUndirectedEdge(edge);
+    } else {
+      return edges_in_view_order_
+                 ? edge
+                 : PGView::GetEdgePropertyIndexFromOutEdge(edge);
+    }
+  }
 };
 
 /**
@@ -349,6 +368,46 @@ TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
       std::move(edge_view_result.value()));
 }
 
+template <typename PGView, typename NodeProps, typename EdgeProps>
+Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>>
+TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::
+    MakeWithEdgePropertiesInViewOrder(
+        PropertyGraph* pg, const std::vector<std::string>& node_properties,
+        const std::vector<std::string>& edge_properties) {
+  static_assert(
+      !katana::is_detected_v<has_undirected_t, PGView>,
+      "undirected views visit each edge in two orders");
+  auto pg_view = pg->BuildView<PGView>();
+  auto node_view_result =
+      internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
+  if (!node_view_result) {
+    return node_view_result.error();
+  }
+
+  std::vector<std::shared_ptr<arrow::Array>> edge_arrays;
+  std::vector<arrow::Array*> arrays;
+  for (const auto& name : edge_properties) {
+    auto array_result = pg->GetEdgePropertyInViewOrder(pg_view, name);
+    if (!array_result) {
+      return array_result.error();
+    }
+    arrays.emplace_back(array_result.value().get());
+    edge_arrays.emplace_back(std::move(array_result.value()));
+  }
+  auto edge_view_result =
+      internal::PropertyViewsFromArrays<EdgeProps>(std::move(arrays));
+  if (!edge_view_result) {
+    return edge_view_result.error();
+  }
+
+  TypedPropertyGraphView view(
+      pg_view, std::move(node_view_result.value()),
+      std::move(edge_view_result.value()));
+  view.edges_in_view_order_ = true;
+  view.edge_arrays_ = std::move(edge_arrays);
+  return view;
+}
+
 template <typename PGView, typename NodeProps, typename EdgeProps>
 Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>>
 TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(PropertyGraph* pg) {
@@ -0,0 +1,109 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_ASYNCANALYTICS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_ASYNCANALYTICS_H_
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A sample of the progress of a running analytic, taken at a round
+/// boundary of its main loop. What a round is depends on the analytic, e.g.,
+/// a BFS level, a PageRank iteration or a source of BetweennessCentrality;
+/// values an analytic does not track are zero.
+struct KATANA_EXPORT AnalyticsProgress {
+  /// The name of the analytic, e.g., "Bfs"
+  std::string analytic;
+  /// The rounds done so far
+  uint64_t iteration{0};
+  /// The number of nodes active in the next round
+  uint64_t frontier_size{0};
+  /// How far from converged the analytic is, e.g., the total change of the
+  /// ranks in the last PageRank iteration
+  double residual{0};
+};
+
+using AnalyticsProgressCallback =
+    std::function<void(const AnalyticsProgress& progress)>;
+
+/// Called by analytics at the round boundaries of their main loops. If the
+/// calling thread runs an analytic launched with LaunchAnalytics, records
+/// progress and passes it to the progress callback, and fails with
+/// ErrorCode::Cancelled if the analytic was cancelled, which the analytic
+/// returns as it would any other error. Otherwise does nothing.
+KATANA_EXPORT Result<void> CheckProgress(const AnalyticsProgress& progress);
+
+namespace internal {
+struct AnalyticsJobState;
+}  // namespace internal
+
+class AnalyticsHandle;
+
+/// Start analytic, a call of an analytic such as
+///
+///     [&]() { return BetweennessCentrality(pg, "bc", &txn_ctx); }
+///
+/// on a thread of its own and return at once. on_progress, if given, is
+/// called with each progress sample on the thread of the analytic, between
+/// its rounds, so it should return quickly.
+///
+/// The analytics launched run one at a time, since they share the thread
+/// pool of the process, and nothing else may run parallel loops while one
+/// runs. If num_threads is not zero, the analytic instead runs on a thread
+/// group of num_threads threads of its own, see LeaseThreadGroup, at the same
+/// time as other analytics launched that way. The graph and everything else
+/// analytic refers to must outlive the handle.
+KATANA_EXPORT AnalyticsHandle LaunchAnalytics(
+    std::function<Result<void>()> analytic,
+    AnalyticsProgressCallback on_progress = {}, unsigned num_threads = 0);
+
+/// An analytic running on a thread of its own, as LaunchAnalytics started
+/// it. Destroying a handle that was not waited for cancels the analytic and
+/// waits for it to stop.
+class KATANA_EXPORT AnalyticsHandle {
+public:
+  AnalyticsHandle(AnalyticsHandle&& other) noexcept = default;
+  AnalyticsHandle& operator=(AnalyticsHandle&& other) = delete;
+  AnalyticsHandle(const AnalyticsHandle&) = delete;
+  AnalyticsHandle& operator=(const AnalyticsHandle&) = delete;
+  ~AnalyticsHandle();
+
+  /// Ask the analytic to stop. It stops at its next call to CheckProgress,
+  /// so an analytic that never calls it runs to completion; Wait returns
+  /// ErrorCode::Cancelled if it stopped early.
+  void Cancel();
+
+  /// Whether the analytic has finished, successfully or not
+  bool IsDone() const;
+
+  /// The progress the analytic last reported, if any
+  std::optional<AnalyticsProgress> LastProgress() const;
+
+  /// Wait for the analytic to finish and return its result. Call at most
+  /// once.
+  Result<void> Wait();
+
+private:
+  friend AnalyticsHandle LaunchAnalytics(
+      std::function<Result<void>()> analytic,
+      AnalyticsProgressCallback on_progress, unsigned num_threads);
+
+  AnalyticsHandle(
+      std::shared_ptr<internal::AnalyticsJobState> state,
+      std::future<Result<void>>&& result)
+      : state_(std::move(state)), result_(std::move(result)) {}
+
+  std::shared_ptr<internal::AnalyticsJobState> state_;
+  std::future<Result<void>> result_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CHECKPOINT_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_CHECKPOINT_H_
+
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Where and how often a long running analytic checkpoints its state, so that
+/// a run that is stopped, e.g., by losing its machine, can be resumed by
+/// calling the analytic again with the same graph, plan and options.
+struct KATANA_EXPORT CheckpointOptions {
+  /// The directory to store the checkpoints in, a local path or the URI of
+  /// any storage tsuba supports; empty for no checkpoints. The checkpoints
+  /// are left in the directory when the analytic finishes, so that calling
+  /// it again resumes from the last one; delete them to start over.
+  std::string dir;
+  /// The number of rounds between two checkpoints
+  uint32_t interval{10};
+
+  bool enabled() const { return !dir.empty(); }
+};
+
+/// A contiguous part of the state of an analytic, e.g., the data of a
+/// NUMAArray
+struct CheckpointBuffer {
+  void* data;
+  uint64_t size;
+};
+
+/// Checkpointer snapshots the state of an analytic at round boundaries and
+/// restores the last snapshot.
+///
+/// Save copies the state in parallel, which is the only time the analytic
+/// pauses for, and a thread of its own then writes the copy to storage while
+/// the analytic goes on. Checkpoints alternate between two files, each with
+/// a hash of its contents, so a write that is cut short leaves the previous
+/// checkpoint to restore.
+class KATANA_EXPORT Checkpointer {
+public:
+  /// key identifies the run: only checkpoints written with an equal key are
+  /// restored, so it should name the analytic and whatever the state
+  /// depends on, e.g., the parameters of the plan and the size of the graph.
+  Checkpointer(CheckpointOptions options, const std::string& key);
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+
+  /// Waits for the write in flight
+  ~Checkpointer();
+
+  /// Fill buffers with the last checkpoint of this run and return its
+  /// round, or return nullopt if there is none. The buffers must have the
+  /// sizes they had when they were saved. Checkpoints of other runs and
+  /// damaged ones are skipped.
+  Result<std::optional<uint64_t>> Restore(
+      const std::vector<CheckpointBuffer>& buffers);
+
+  /// Checkpoint buffers as the state after round if round is a multiple of
+  /// the interval, after waiting for the previous checkpoint to be written.
+  /// Does nothing if checkpoints are not enabled.
+  Result<void> Save(
+      uint64_t round, const std::vector<CheckpointBuffer>& buffers);
+
+  /// Wait for the checkpoint being written, if any
+  Result<void> Finish();
+
+private:
+  std::string SlotPath(uint32_t slot) const;
+
+  CheckpointOptions options_;
+  uint64_t key_hash_;
+  /// The file the next checkpoint goes to
+  uint32_t next_slot_{0};
+  /// The checkpoint being written: its header and contents
+  std::vector<uint8_t> snapshot_;
+  std::future<CopyableResult<void>> write_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -20,15 +20,27 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <random>
 #include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "katana/Arena.h"
 #include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/ConcurrentHashMap.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -64,6 +76,13 @@ using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 struct CurrentSubCommunityID : public katana::PODProperty<uint64_t> {};
 struct NodeWeight : public katana::PODProperty<uint64_t> {};
 
+/// The clusters of a previous run, in a node property, and the edges changed
+/// since, from which a clustering is warm started
+struct ClusteringWarmStart {
+  const std::string& initial_property_name;
+  const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges;
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
@@ -127,38 +146,124 @@ struct ClusteringImplementationBase {
    * Enables the filtering optimization to remove the
    * node with out-degree 0 (isolated) and 1 before the clustering
    * algorithm begins.
+   *
+   * Degree one nodes are peeled a round at a time, so that the chains and
+   * trees hanging off the graph collapse into the nodes they hang from:
+   * each peeled node follows its one neighbor left, which may be peeled in
+   * a later round and follow another node in turn. Moving a degree one node
+   * to the cluster of its neighbor always gains modularity.
    */
   static uint64_t VertexFollowing(Graph* graph) {
-    // Initialize each node to its own cluster
-    katana::do_all(katana::iterate(*graph), [&](GNode n) {
-      graph->template GetData<CurrentCommunityID>(n) = n;
-    });
-
-    // Remove isolated and degree-one nodes
+    uint64_t num_nodes = graph->NumNodes();
+    // The neighbors of each node other than itself that are not peeled
+    katana::NUMAArray<std::atomic<uint64_t>> degrees;
+    // The node each node follows, or the node itself
+    katana::NUMAArray<GNode> leaders;
+    katana::DynamicBitset peeled;
+    degrees.allocateBlocked(num_nodes);
+    leaders.allocateBlocked(num_nodes);
+    peeled.resize(num_nodes);
+
+    katana::InsertBag<GNode> frontier;
     katana::GAccumulator<uint64_t> isolated_nodes;
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
-      auto& n_data_curr_comm_id =
-          graph->template GetData<CurrentCommunityID>(n);
-      uint64_t degree = Degree(*graph, n);
-      if (degree == 0) {
+      uint64_t degree = 0;
+      for (auto e : Edges(*graph, n)) {
+        degree += EdgeDst(*graph, e) != n;
+      }
+      degrees[n].store(degree, std::memory_order_relaxed);
+      leaders[n] = n;
+      if (Degree(*graph, n) == 0) {
         isolated_nodes += 1;
-        n_data_curr_comm_id = UNASSIGNED;
-      } else {
-        if (degree == 1) {
-          // Check if the destination has degree greater than one
-          auto edge = Edges(*graph, n).begin();
-          auto dst = EdgeDst(*graph, *edge);
-          uint64_t dst_degree = Degree(*graph, dst);
-          if ((dst_degree > 1 || (n > dst))) {
-            isolated_nodes += 1;
-            n_data_curr_comm_id =
-                graph->template GetData<CurrentCommunityID>(dst);
+      } else if (degree == 1) {
+        frontier.push(n);
+      }
+    });
+
+    // The nodes peeled in each round; a node follows a node peeled in a
+    // later round, or one never peeled
+    std::vector<std::vector<GNode>> rounds;
+    while (!frontier.empty()) {
+      // Pick who to follow before peeling anyone, so that degrees and
+      // peeled nodes are those of the start of the round
+      katana::InsertBag<GNode> followers;
+      katana::do_all(katana::iterate(frontier), [&](GNode n) {
+        GNode dst = n;
+        for (auto e : Edges(*graph, n)) {
+          GNode m = EdgeDst(*graph, e);
+          if (m != n && !peeled.test(m)) {
+            dst = m;
+            break;
           }
         }
-      }
+        // Every neighbor of n was peeled into it last round, so n leads
+        // the tree they formed
+        if (dst == n) {
+          return;
+        }
+        // Of two nodes left with only each other, the larger follows
+        if (degrees[dst].load(std::memory_order_relaxed) == 1 && n < dst) {
+          return;
+        }
+        leaders[n] = dst;
+        followers.push(n);
+      });
+
+      katana::InsertBag<GNode> next_frontier;
+      katana::do_all(katana::iterate(followers), [&](GNode n) {
+        peeled.set(n);
+        GNode leader = leaders[n];
+        if (degrees[leader].fetch_sub(1, std::memory_order_relaxed) == 2) {
+          next_frontier.push(leader);
+        }
+      });
+      rounds.emplace_back(followers.begin(), followers.end());
+      frontier.clear();
+      frontier.swap(next_frontier);
+    }
+
+    // Follow the leaders to the nodes left, the last rounds first
+    uint64_t num_followers = 0;
+    for (auto round = rounds.rbegin(); round != rounds.rend(); ++round) {
+      katana::do_all(katana::iterate(*round), [&](GNode n) {
+        leaders[n] = leaders[leaders[n]];
+      });
+      num_followers += round->size();
+    }
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      graph->template GetData<CurrentCommunityID>(n) =
+          Degree(*graph, n) == 0 ? UNASSIGNED : leaders[n];
     });
-    // The number of isolated nodes that can be removed
-    return isolated_nodes.reduce();
+    // The number of isolated and following nodes that can be removed
+    return isolated_nodes.reduce() + num_followers;
+  }
+
+  /**
+   * Whether moving n out of its cluster sc cannot gain modularity, by a
+   * bound that only needs the weights of its edges rather than those to
+   * each neighboring cluster: moving n to a cluster y gains
+   * 2 * constant * (eiy - eix) + 2 * degree_wt * (ax - ay) * constant^2,
+   * where eiy is at most the weight of the edges of n out of sc, and
+   * MaxModularityWithoutSwaps only considers clusters with ay at least
+   * ax + degree_wt.
+   */
+  template <typename EdgeWeightType>
+  static bool CannotGainByMoving(
+      const Graph& graph, GNode n, EdgeTy degree_wt, uint64_t sc,
+      double constant) {
+    double eix = 0;
+    double out = 0;
+    for (auto e : Edges(graph, n)) {
+      auto dst = EdgeDst(graph, e);
+      auto edge_wt = graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+      if (graph.template GetData<CurrentCommunityID>(dst) != sc) {
+        out += edge_wt;
+      } else if (dst != n) {
+        eix += edge_wt;
+      }
+    }
+    return out - eix < double(degree_wt) * double(degree_wt) * constant;
   }
 
   /**
@@ -436,37 +541,114 @@ struct ClusteringImplementationBase {
  */
   template <typename CommunityIDType>
   static uint64_t RenumberClustersContiguously(Graph* graph) {
-    std::map<uint64_t, uint64_t> cluster_local_map;
-    uint64_t num_unique_clusters = 0;
+    katana::ConcurrentHashMap<uint64_t, uint64_t> cluster_local_map(
+        graph->size());
 
-    // TODO(amber): parallelize
-    for (GNode n : graph->Nodes()) {
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
       auto& n_data_curr_comm_id = graph->template GetData<CommunityIDType>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        auto stored_already = cluster_local_map.find(n_data_curr_comm_id);
-        if (stored_already == cluster_local_map.end()) {
-          cluster_local_map[n_data_curr_comm_id] = num_unique_clusters;
-          num_unique_clusters++;
-        }
+        cluster_local_map.FindOrInsert(n_data_curr_comm_id);
       }
-    }
+    });
 
-    uint64_t new_comm_id = 0;
-    for (std::pair<uint64_t, uint64_t> old_comm_id : cluster_local_map) {
-      cluster_local_map[old_comm_id.first] = new_comm_id;
-      new_comm_id++;
-    }
+    // new ids in the order of the old ones
+    katana::InsertBag<uint64_t> old_comm_ids_bag;
+    cluster_local_map.ForEach([&](uint64_t old_comm_id, uint64_t) {
+      old_comm_ids_bag.push(old_comm_id);
+    });
+    std::vector<uint64_t> old_comm_ids(
+        old_comm_ids_bag.begin(), old_comm_ids_bag.end());
+    katana::ParallelSTL::sort(old_comm_ids.begin(), old_comm_ids.end());
+    uint64_t num_unique_clusters = old_comm_ids.size();
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters), [&](uint64_t i) {
+          cluster_local_map.FindOrInsert(old_comm_ids[i])
+              ->store(i, std::memory_order_relaxed);
+        });
 
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
       auto& n_data_curr_comm_id = graph->template GetData<CommunityIDType>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        n_data_curr_comm_id = cluster_local_map[n_data_curr_comm_id];
+        n_data_curr_comm_id = *cluster_local_map.Find(n_data_curr_comm_id);
       }
     });
 
     return num_unique_clusters;
   }
 
+  /**
+   * Seeds a warm start from the clusters of a previous run, after delta
+   * screening: the nodes at most hops hops away from an endpoint of a
+   * changed edge, and the nodes without a cluster, start on their own so
+   * that only they are re-evaluated, while the other nodes keep their
+   * clusters. Returns the number of clusters, renumbered contiguously.
+   */
+  template <typename CommunityIDType>
+  static katana::Result<uint64_t> SeedClusters(
+      Graph* graph, katana::PropertyGraph* pg,
+      const ClusteringWarmStart& warm_start, uint32_t hops) {
+    auto initial = KATANA_CHECKED(
+        pg->GetNodePropertyTyped<uint64_t>(warm_start.initial_property_name));
+    const uint64_t num_nodes = graph->NumNodes();
+    for (const auto& [src, dst] : warm_start.changed_edges) {
+      if (src >= num_nodes || dst >= num_nodes) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "changed edge ({}, {}) is not in a graph of {} nodes", src, dst,
+            num_nodes);
+      }
+    }
+
+    katana::DynamicBitset affected;
+    affected.resize(num_nodes);
+    auto frontier = std::make_unique<katana::InsertBag<GNode>>();
+    auto next = std::make_unique<katana::InsertBag<GNode>>();
+    katana::do_all(
+        katana::iterate(warm_start.changed_edges),
+        [&](const std::pair<uint32_t, uint32_t>& edge) {
+          for (GNode n : {GNode{edge.first}, GNode{edge.second}}) {
+            if (!affected.set(n)) {
+              frontier->push(n);
+            }
+          }
+        },
+        katana::no_stats());
+    for (uint32_t hop = 0; hop < hops && !frontier->empty(); ++hop) {
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](GNode n) {
+            for (auto e : Edges(*graph, n)) {
+              auto dst = EdgeDst(*graph, e);
+              if (!affected.test(dst) && !affected.set(dst)) {
+                next->push(dst);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+      frontier->clear();
+      std::swap(frontier, next);
+    }
+
+    // ids past UNASSIGNED cannot clash with the clusters of the previous run
+    katana::GAccumulator<uint64_t> num_affected;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](GNode n) {
+          uint64_t c = initial->Value(n);
+          if (affected.test(n) || c >= UNASSIGNED) {
+            num_affected += 1;
+            c = uint64_t{UNASSIGNED} + 1 + n;
+          }
+          graph->template GetData<CommunityIDType>(n) = c;
+        },
+        katana::no_stats());
+    katana::ReportStatSingle(
+        "Clustering", "WarmStartAffectedNodes", num_affected.reduce());
+
+    return RenumberClustersContiguously<CommunityIDType>(graph);
+  }
+
   template <typename EdgeWeightType>
   static void CheckModularity(
       Graph& graph, katana::NUMAArray<uint64_t>& clusters_orig) {
@@ -544,6 +726,11 @@ struct ClusteringImplementationBase {
  * the number of unique clusters in the previous level of the graph.
  * All the edges inside a cluster are merged (edge weights are summed
  * up) to form the edges within super nodes.
+ * The contracted CSR is built with parallel prefix sums: nodes are bucketed
+ * by cluster with a counting sort and the edges of each cluster merged with
+ * a per thread hash table. Its buffers are NUMAArrays from scratch, which is
+ * reset first, so that the phases of one run reuse the same memory; only
+ * the final topology and edge weights are allocated anew.
  */
   template <
       typename NodeData, typename EdgeData, typename EdgeWeightType,
@@ -553,7 +740,7 @@ struct ClusteringImplementationBase {
       uint64_t num_unique_clusters,
       const std::vector<std::string>& temp_node_property_names,
       const std::vector<std::string>& temp_edge_property_names,
-      katana::TxnContext* txn_ctx) {
+      katana::TxnContext* txn_ctx, katana::Arena* scratch) {
     using GNode = typename Graph::Node;
 
     katana::StatTimer TimerGraphBuild("Timer_Graph_build");
@@ -561,72 +748,170 @@ struct ClusteringImplementationBase {
 
     const uint64_t num_nodes_next = num_unique_clusters;
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // TODO(amber): This loop can be parallelized when using a concurrent container
-    // for cluster_bags, but something like katana::InsertBag exhausts the
-    // per-thread-storage memory
-    for (GNode n = 0; n < graph.NumNodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        cluster_bags[n_data_curr_comm_id].push_back(n);
-      }
-    }
+    scratch->Reset();
+
+    // Members of every cluster, in increasing order of node id, by a
+    // parallel counting sort into arena arrays
+    katana::NUMAArray<std::atomic<uint64_t>> member_cursors =
+        scratch->MakeArray<std::atomic<uint64_t>>(num_unique_clusters);
+    katana::NUMAArray<uint64_t> member_offsets =
+        scratch->MakeArray<uint64_t>(num_unique_clusters + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters),
+        [&](uint64_t c) {
+          member_cursors[c].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto c = graph.template GetData<CommunityIDType>(n);
+          if (c != UNASSIGNED) {
+            member_cursors[c].fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+    member_offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters),
+        [&](uint64_t c) {
+          member_offsets[c + 1] =
+              member_cursors[c].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        member_offsets.begin() + 1, member_offsets.end(),
+        member_offsets.begin() + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters),
+        [&](uint64_t c) {
+          member_cursors[c].store(
+              member_offsets[c], std::memory_order_relaxed);
+        },
+        katana::no_stats());
 
-    std::vector<katana::gstl::Vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<katana::gstl::Vector<EdgeTy>> edges_data(num_unique_clusters);
+    katana::NUMAArray<GNode> members =
+        scratch->MakeArray<GNode>(member_offsets[num_unique_clusters]);
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto c = graph.template GetData<CommunityIDType>(n);
+          if (c != UNASSIGNED) {
+            members[member_cursors[c].fetch_add(
+                1, std::memory_order_relaxed)] = n;
+          }
+        },
+        katana::no_stats());
 
-    /* First pass to find the number of edges */
+    // The edges of every cluster are merged into a region as large as the
+    // total degree of its members
+    katana::NUMAArray<uint64_t> region_offsets =
+        scratch->MakeArray<uint64_t>(num_unique_clusters + 1);
+    region_offsets[0] = 0;
     katana::do_all(
         katana::iterate(uint64_t{0}, num_unique_clusters),
         [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto node : cluster_bags[c]) {
+          GNode* first = &members[0] + member_offsets[c];
+          GNode* last = &members[0] + member_offsets[c + 1];
+          std::sort(first, last);
+          uint64_t degree = 0;
+          for (GNode* m = first; m != last; ++m) {
+            degree += Degree(graph, *m);
+          }
+          region_offsets[c + 1] = degree;
+        },
+        katana::steal(), katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        region_offsets.begin() + 1, region_offsets.end(),
+        region_offsets.begin() + 1);
+
+    katana::NUMAArray<GNode> region_dests =
+        scratch->MakeArray<GNode>(region_offsets[num_unique_clusters]);
+    katana::NUMAArray<EdgeTy> region_data =
+        scratch->MakeArray<EdgeTy>(region_offsets[num_unique_clusters]);
+
+    // per thread open addressing table from the clusters adjacent to the
+    // cluster being merged to their position in its region
+    struct ClusterTable {
+      std::vector<uint64_t> clusters;
+      std::vector<uint64_t> positions;
+      std::vector<size_t> used;
+      uint32_t bits{0};
+    };
+    constexpr uint64_t kNoCluster = std::numeric_limits<uint64_t>::max();
+    katana::PerThreadStorage<ClusterTable> tables;
+
+    katana::NUMAArray<uint64_t> prefix_edges_count;
+    prefix_edges_count.allocateInterleaved(num_unique_clusters);
+
+    /* First pass to merge the edges of every cluster */
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters),
+        [&](uint64_t c) {
+          ClusterTable& table = *tables.getLocal();
+          uint64_t region = region_offsets[c];
+          uint64_t most = std::min(
+              region_offsets[c + 1] - region, num_unique_clusters);
+          uint32_t bits = 4;
+          while ((uint64_t{1} << bits) < 2 * most) {
+            bits += 1;
+          }
+          if (bits > table.bits) {
+            table.bits = bits;
+            table.clusters.assign(uint64_t{1} << bits, kNoCluster);
+            table.positions.resize(uint64_t{1} << bits);
+          }
+          uint64_t mask = (uint64_t{1} << table.bits) - 1;
+
+          uint64_t num_edges = 0;
+          for (uint64_t m = member_offsets[c]; m < member_offsets[c + 1];
+               ++m) {
+            GNode node = members[m];
             KATANA_LOG_DEBUG_ASSERT(
                 graph.template GetData<CommunityIDType>(node) ==
-                c);  // All nodes in this bag must have same cluster id
+                c);  // All nodes in this bucket must have same cluster id
 
             for (auto e : Edges(graph, node)) {
               auto dst = EdgeDst(graph, e);
-              auto dst_data_curr_comm_id =
+              uint64_t dst_data_curr_comm_id =
                   graph.template GetData<CommunityIDType>(dst);
               KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+              auto weight =
+                  graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+              size_t slot =
+                  ((dst_data_curr_comm_id * 0x9e3779b97f4a7c15ULL) >>
+                   (64 - table.bits)) &
+                  mask;
+              while (table.clusters[slot] != dst_data_curr_comm_id &&
+                     table.clusters[slot] != kNoCluster) {
+                slot = (slot + 1) & mask;
+              }
+              if (table.clusters[slot] == kNoCluster) {
+                table.clusters[slot] = dst_data_curr_comm_id;
+                table.positions[slot] = num_edges;
+                table.used.emplace_back(slot);
+                region_dests[region + num_edges] = dst_data_curr_comm_id;
+                region_data[region + num_edges] = weight;
+                num_edges++;
               } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
-                num_unique_clusters++;
+                region_data[region + table.positions[slot]] += weight;
               }
             }  // End edge loop
           }
+          for (size_t slot : table.used) {
+            table.clusters[slot] = kNoCluster;
+          }
+          table.used.clear();
+          prefix_edges_count[c] = num_edges;
         },
         katana::steal(), katana::loopname("BuildGraph: Find edges"));
 
-    /* Serial loop to reduce all the edge counts */
-    katana::NUMAArray<uint64_t> prefix_edges_count;
-    prefix_edges_count.allocateInterleaved(num_unique_clusters);
-
-    katana::GAccumulator<uint64_t> num_edges_acc;
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
-
-    const uint64_t num_edges_next = num_edges_acc.reduce();
-
     katana::ParallelSTL::partial_sum(
         prefix_edges_count.begin(), prefix_edges_count.end(),
         prefix_edges_count.begin());
 
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
+    const uint64_t num_edges_next =
+        prefix_edges_count[num_unique_clusters - 1];
     katana::StatTimer TimerConstructFrom("Timer_Construct_From");
     TimerConstructFrom.start();
 
@@ -656,29 +941,20 @@ struct ClusteringImplementationBase {
     edge_data_next.allocateInterleaved(num_edges_next);
 
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t n) {
-          uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t n) {
           uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
+          uint64_t number_of_edges = prefix_edges_count[n] - start_index;
+          uint64_t region = region_offsets[n];
           for (uint64_t k = 0; k < number_of_edges; ++k) {
-            out_dests_next[start_index + k] = edges_id[n][k];
-            edge_data_next[start_index + k] = edges_data[n][k];
+            out_dests_next[start_index + k] = region_dests[region + k];
+            edge_data_next[start_index + k] = region_data[region + k];
           }
-        });
+        },
+        katana::steal(), katana::no_stats());
 
     TimerConstructFrom.stop();
 
-    // TODO(amber): This is a lame attempt at freeing the memory back to each
-    // thread's pool of free pages and blocks. Due to stealing, the execution of
-    // do_all above that populates these containers may be different from the
-    // do_all below that frees them.
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters), [&](uint64_t c) {
-          edges_id[c] = gstl::Vector<uint32_t>();
-          edges_data[c] = gstl::Vector<EdgeTy>();
-        });
-
     GraphTopology topo_next{
         std::move(prefix_edges_count), std::move(out_dests_next)};
     auto pfg_next_res = katana::PropertyGraph::Make(std::move(topo_next));
@@ -741,18 +1017,6 @@ struct ClusteringImplementationBase {
     });
   }
 
-  template <typename ValTy>
-  static double GenerateRandonNumber(ValTy min, ValTy max) {
-    std::random_device
-        rd;  // Will be used to obtain a seed for the random number engine
-    std::mt19937 gen(
-        rd());  // Standard mersenne_twister_engine seeded with rd()
-    std::uniform_real_distribution<> dis(
-        min,
-        max);  // distribution in range [min, max]
-    return dis(gen);
-  }
-
   template <typename EdgeWeightType>
   static uint64_t GetSubcommunity(
       const Graph& graph, GNode n, CommunityArray& subcomm_info,
@@ -995,19 +1259,21 @@ struct ClusteringImplementationBase {
   /*
  * Refine the clustering by iterating over the clusters and by
  * trying to split up each cluster into multiple clusters.
+ * The per community arrays come from scratch, which is reset first.
  */
   template <typename EdgeWeightType>
-  static void RefinePartition(Graph* graph, double resolution) {
+  static void RefinePartition(
+      Graph* graph, double resolution, katana::Arena* scratch) {
     // set singleton subcommunities
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
       graph->template GetData<CurrentSubCommunityID>(n) = n;
     });
 
+    scratch->Reset();
+
     // populate nodes into communities
     std::vector<std::vector<GNode>> cluster_bags(graph->size());
-    CommunityArray comm_info;
-
-    comm_info.allocateBlocked(graph->size());
+    CommunityArray comm_info = scratch->MakeArray<CommunityType>(graph->size());
 
     katana::do_all(katana::iterate(size_t{0}, (graph->size())), [&](size_t n) {
       comm_info[n].node_wt = 0ull;
@@ -1034,15 +1300,13 @@ struct ClusteringImplementationBase {
       total += cluster_bags[n].size();
     }
 
-    CommunityArray subcomm_info;
-
-    subcomm_info.allocateBlocked(graph->size());
+    CommunityArray subcomm_info =
+        scratch->MakeArray<CommunityType>(graph->size());
 
     SumVertexDegreeWeightCommunity<EdgeWeightType>(graph);
 
-    katana::NUMAArray<std::atomic<double>> comm_constant_term;
-
-    comm_constant_term.allocateBlocked(graph->size());
+    katana::NUMAArray<std::atomic<double>> comm_constant_term =
+        scratch->MakeArray<std::atomic<double>>(graph->size());
 
     CalConstantForSecondTerm<EdgeWeightType>(*graph, &comm_constant_term);
 
@@ -1063,12 +1327,6 @@ struct ClusteringImplementationBase {
           }
         },
         katana::steal());
-
-    subcomm_info.deallocate();
-    subcomm_info.destroy();
-
-    comm_constant_term.deallocate();
-    comm_constant_term.destroy();
   }
 
   template <typename EdgeWeightType>
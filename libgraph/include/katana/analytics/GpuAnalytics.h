@@ -0,0 +1,79 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GPUANALYTICS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GPUANALYTICS_H_
+
+#include <cstdint>
+
+#include <arrow/type_fwd.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The device copies of the topologies of a property graph that a GPU
+/// backend keeps between calls, so that running several analytics on one
+/// graph uploads it once. The graph holds it until its topology changes;
+/// see PropertyGraph::GetDeviceTopologyCache. What it holds is up to the
+/// backend.
+class KATANA_EXPORT DeviceTopologyCache {
+public:
+  virtual ~DeviceTopologyCache();
+};
+
+}  // namespace katana
+
+namespace katana::analytics {
+
+/// The analytics that plans for Architecture::kGPU run. libgraph does not
+/// depend on CUDA: the implementation is the GPU analytics plugin of libgpu,
+/// which registers itself when it is loaded, and analytics with GPU plans
+/// fail with NotImplemented if no GPU backend is registered.
+///
+/// The arrays of results have an element per node of the default topology
+/// and are in host memory. The backend uploads the topologies it needs and
+/// caches them in the DeviceTopologyCache of the graph.
+class KATANA_EXPORT GpuAnalytics {
+public:
+  virtual ~GpuAnalytics();
+
+  /// Breadth first search from source. parents comes filled with unreached
+  /// and with parents[source] == source; the parents of the nodes reached
+  /// are set to the node they were first reached from.
+  virtual Result<void> Bfs(
+      PropertyGraph* pg, uint32_t source, uint32_t unreached,
+      uint32_t* parents) = 0;
+
+  /// Single source shortest paths from source. weights are the edge
+  /// weights, of weight_type, by edge of the default topology; distances
+  /// are of the same type, and come filled with infinity but for
+  /// distances[source] == 0.
+  virtual Result<void> Sssp(
+      PropertyGraph* pg, uint32_t source, arrow::Type::type weight_type,
+      const void* weights, void* distances) = 0;
+
+  /// PageRank with the iteration of PagerankPlan::PullTopological, ranks
+  /// starting at 1 / NumNodes
+  virtual Result<void> Pagerank(
+      PropertyGraph* pg, float alpha, float tolerance,
+      uint32_t max_iterations, float* ranks) = 0;
+
+  /// The weakly connected components; each node gets the smallest node id
+  /// of its component
+  virtual Result<void> ConnectedComponents(
+      PropertyGraph* pg, uint64_t* components) = 0;
+
+  /// The number of triangles of a symmetric graph
+  virtual Result<uint64_t> TriangleCount(PropertyGraph* pg) = 0;
+};
+
+/// Make gpu the GPU backend of the analytics, as the GPU analytics plugin
+/// does when it is loaded. gpu is not owned and must outlive its use.
+KATANA_EXPORT void RegisterGpuAnalytics(GpuAnalytics* gpu);
+
+/// The registered GPU backend, or NotImplemented if there is none
+KATANA_EXPORT Result<GpuAnalytics*> GetGpuAnalytics();
+
+}  // namespace katana::analytics
+
+#endif
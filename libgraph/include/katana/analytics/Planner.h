@@ -0,0 +1,48 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PLANNER_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PLANNER_H_
+
+#include "katana/GraphStatistics.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+// Automatic plans chosen from the statistics of a graph, as returned by
+// PropertyGraph::GetGraphStatistics, which caches them so that planning for
+// several analytics of the same graph computes them once. Every choice is
+// logged, along with the statistics it was made from, at verbose level.
+//
+// As with plans made for a graph directly, a plan chosen for one graph may be
+// used with another, but is tuned for the first.
+
+namespace katana::analytics {
+
+/// Direction optimizing BFS for small world graphs, where a few levels hold
+/// most of the nodes and pulling pays off, and asynchronous BFS otherwise,
+/// tiled if some adjacency lists are longer than a tile.
+KATANA_EXPORT BfsPlan ChooseBfsPlan(const GraphStatistics& stats);
+
+/// Delta stepping with the delta chosen at run time from the edge weights.
+/// Power law graphs get the unordered buckets, tiled if some adjacency lists
+/// are longer than a tile, and the others the barrier between buckets.
+KATANA_EXPORT SsspPlan ChooseSsspPlan(const GraphStatistics& stats);
+
+/// Afforest, edge tiled for power law graphs with adjacency lists longer than
+/// a tile, with fewer neighbor samples when the average degree is low.
+KATANA_EXPORT ConnectedComponentsPlan ChooseConnectedComponentsPlan(
+    const GraphStatistics& stats);
+
+/// Ordered counting, relabeled for power law graphs and with hub bitmaps if
+/// they also have hubs, and told whether the edges are sorted already.
+KATANA_EXPORT TriangleCountPlan ChooseTriangleCountPlan(
+    const GraphStatistics& stats);
+
+/// Exact degree ordered counting for power law graphs, with hub bitmaps if
+/// they have hubs, and ordered counting by node id otherwise.
+KATANA_EXPORT LocalClusteringCoefficientPlan
+ChooseLocalClusteringCoefficientPlan(const GraphStatistics& stats);
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PRIORITYROUNDSIMPLEMENTATIONBASE_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PRIORITYROUNDSIMPLEMENTATIONBASE_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Statistics.h"
+
+namespace katana::analytics {
+
+/// A round based engine for the problems of symmetric graphs where a node is
+/// decided only after its undecided neighbors of higher priority, such as
+/// Luby's maximal independent set and Jones-Plassmann coloring.
+///
+/// Each round selects the undecided nodes whose priority is higher than that
+/// of all of their undecided neighbors, which are never adjacent, and decides
+/// them in parallel. Ties between priorities are broken by node id, so the
+/// result does not depend on the schedule. Which nodes are decided is kept in
+/// a bitset, and the frontier of undecided nodes is compacted every round, so
+/// that later rounds only visit the nodes that are left.
+template <typename Graph>
+class PriorityRoundsImplementationBase {
+public:
+  using Node = typename Graph::Node;
+
+  /// priorities holds the priority of every node of graph
+  PriorityRoundsImplementationBase(
+      const Graph& graph, katana::NUMAArray<uint64_t>&& priorities)
+      : graph_(graph), priorities_(std::move(priorities)) {
+    decided_.resize(graph_.size());
+  }
+
+  /// Runs rounds until every node is decided, and returns their number.
+  /// decide(n) is called once for every selected node, concurrently for the
+  /// nodes of a round; it may mark other nodes decided with Decide, which
+  /// drops them from the frontier of the next round.
+  template <typename DecideFn>
+  uint32_t Run(const DecideFn& decide, const char* loopname) {
+    using Bag = katana::InsertBag<Node>;
+    auto cur = std::make_unique<Bag>();
+    auto next = std::make_unique<Bag>();
+    Bag selected;
+
+    auto select = [&](const Node& n) {
+      if (decided_.test(n)) {
+        return;
+      }
+      if (IsLocalMaximum(n)) {
+        selected.push_back(n);
+      } else {
+        next->push_back(n);
+      }
+    };
+
+    uint32_t rounds = 0;
+    for (bool first = true; first || !cur->empty(); first = false) {
+      if (first) {
+        katana::do_all(
+            katana::iterate(graph_), select, katana::steal(),
+            katana::loopname(loopname));
+      } else {
+        katana::do_all(
+            katana::iterate(*cur), select, katana::steal(),
+            katana::loopname(loopname));
+      }
+
+      katana::do_all(
+          katana::iterate(selected),
+          [&](const Node& n) {
+            decide(n);
+            decided_.set(n);
+          },
+          katana::steal(), katana::no_stats());
+
+      selected.clear();
+      cur->clear();
+      std::swap(cur, next);
+      ++rounds;
+    }
+
+    katana::ReportStatSingle(loopname, "Rounds", rounds);
+    return rounds;
+  }
+
+  bool IsDecided(Node n) const { return decided_.test(n); }
+
+  /// Marks n decided, for decide to call on the neighbors of a selected node
+  void Decide(Node n) { decided_.set(n); }
+
+private:
+  /// Whether a has a higher priority than b
+  bool IsHigher(Node a, Node b) const {
+    return priorities_[a] > priorities_[b] ||
+           (priorities_[a] == priorities_[b] && a < b);
+  }
+
+  bool IsLocalMaximum(Node n) const {
+    for (auto e : graph_.OutEdges(n)) {
+      Node dest = graph_.OutEdgeDst(e);
+      if (dest != n && !decided_.test(dest) && IsHigher(dest, n)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const Graph& graph_;
+  katana::NUMAArray<uint64_t> priorities_;
+  katana::DynamicBitset decided_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PROPERTYREQUIREMENTS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PROPERTYREQUIREMENTS_H_
+
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+// Analytics that read properties of the graph declare them, next to their
+// plans, so that a job can load them all before it computes anything rather
+// than stall on each one as an analytic first asks for it, and keep them
+// loaded until it is done.
+
+namespace katana::analytics {
+
+/// The node and edge properties an analytic reads.
+struct KATANA_EXPORT PropertyRequirements {
+  std::vector<std::string> node_properties;
+  std::vector<std::string> edge_properties;
+
+  /// Require the node property name; empty names are ignored, as analytics
+  /// take them to mean the property is not used.
+  PropertyRequirements& AddNodeProperty(const std::string& name);
+
+  /// Require the edge property name; empty names are ignored.
+  PropertyRequirements& AddEdgeProperty(const std::string& name);
+
+  /// Require every property other requires as well.
+  PropertyRequirements& Merge(const PropertyRequirements& other);
+
+  bool empty() const {
+    return node_properties.empty() && edge_properties.empty();
+  }
+};
+
+/// Holds the properties of some requirements of a graph loaded: it loads
+/// those that are absent, all of their reads overlapping, and pins every one
+/// of them until it is destroyed so that none is unloaded in the meantime.
+///
+/// The graph must outlive the pins.
+class KATANA_EXPORT PinnedProperties {
+public:
+  static Result<PinnedProperties> Make(
+      PropertyGraph* pg, const PropertyRequirements& requirements);
+
+  PinnedProperties() = default;
+  PinnedProperties(const PinnedProperties&) = delete;
+  PinnedProperties& operator=(const PinnedProperties&) = delete;
+  PinnedProperties(PinnedProperties&& other) noexcept;
+  PinnedProperties& operator=(PinnedProperties&& other) noexcept;
+  ~PinnedProperties();
+
+  /// The properties pinned
+  const PropertyRequirements& pinned() const { return pinned_; }
+
+private:
+  explicit PinnedProperties(PropertyGraph* pg) : pg_(pg) {}
+
+  void Unpin() noexcept;
+
+  PropertyGraph* pg_{nullptr};
+  PropertyRequirements pinned_;
+};
+
+}  // namespace katana::analytics
+
+#endif
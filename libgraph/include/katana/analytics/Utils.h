@@ -9,7 +9,9 @@
 
 #include "arrow/util/bitmap.h"
 #include "katana/ErrorCode.h"
+#include "katana/Loops.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
 
 namespace katana::analytics {
@@ -36,6 +38,26 @@ public:
 KATANA_EXPORT bool IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph);
 
+//! Whether some node of graph, whose edges are sorted by destination, has
+//! more than one edge to the same destination. The adjacency lists of such
+//! graphs cannot go to SortedIntersectionCount, which assumes sets.
+template <typename Graph>
+bool
+HasParallelEdges(const Graph& graph) {
+  katana::GReduceLogicalOr found;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const typename Graph::Node& n) {
+        const auto* first = graph.DestData() + *graph.OutEdges(n).begin();
+        const auto* last = first + graph.OutDegree(n);
+        if (std::adjacent_find(first, last) != last) {
+          found.update(true);
+        }
+      },
+      katana::no_stats());
+  return found.reduce();
+}
+
 class KATANA_EXPORT TemporaryPropertyGuard {
   static thread_local int temporary_property_counter;
 
@@ -0,0 +1,149 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_ANALYTICSSESSION_ANALYTICSSESSION_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_ANALYTICSSESSION_ANALYTICSSESSION_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/PropertyRequirements.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+
+// API
+
+namespace katana::analytics {
+
+/// Runs a batch of analytics over one graph as a single job.
+///
+/// Each analytic on its own builds the views it needs, and the view cache
+/// may evict their topologies as soon as the analytic returns, so a job
+/// that runs several of them in turn can rebuild the same view many times.
+/// The session instead collects the analytics first and, when run:
+///
+/// - loads every property the queued analytics read, all of the reads
+///   overlapping, before any of them runs, and pins the properties until the
+///   end of the run so that none is unloaded mid-job;
+/// - builds every view the queued plans need once, up front, and holds it
+///   until the end of the run so that none of its topologies is released
+///   while another analytic still needs it;
+/// - runs the analytics grouped by the view they use;
+/// - fuses all the BFS levels queued with the same plan into one
+///   MultiSourceBfs, so that they share each scan of the adjacency lists;
+/// - writes every output through the same transaction and, if any analytic
+///   fails, removes the outputs already created so that the batch adds
+///   either all of its properties or none.
+///
+/// The views a run builds are held by the session afterwards, until
+/// ReleaseViews or a change to the topology of the graph, so a notebook that
+/// runs a session many times, e.g., over a sweep of parameters, builds them
+/// only once.
+///
+/// The graph must outlive the session.
+class KATANA_EXPORT AnalyticsSession {
+public:
+  explicit AnalyticsSession(katana::PropertyGraph* pg) : pg_(pg) {}
+
+  /// Queues Bfs from start_node into the property output_property_name.
+  AnalyticsSession& AddBfs(
+      uint32_t start_node, const std::string& output_property_name,
+      BfsPlan plan = {});
+
+  /// Queues the BFS level of every node from start_node into the uint32_t
+  /// property output_property_name, as MultiSourceBfs computes it, so the
+  /// plan must be BfsPlan::Synchronous or BfsPlan::SynchronousDirectOpt. All
+  /// the levels queued with the same plan are computed together.
+  AnalyticsSession& AddBfsLevels(
+      uint32_t start_node, const std::string& output_property_name,
+      BfsPlan plan = {});
+
+  /// Queues Sssp from start_node, with the weights in the edge property
+  /// edge_weight_property_name, into the property output_property_name.
+  AnalyticsSession& AddSssp(
+      uint32_t start_node, const std::string& edge_weight_property_name,
+      const std::string& output_property_name, SsspPlan plan = {});
+
+  /// Queues Pagerank into the property output_property_name.
+  AnalyticsSession& AddPagerank(
+      const std::string& output_property_name, PagerankPlan plan = {});
+
+  /// Queues ConnectedComponents into the property output_property_name.
+  AnalyticsSession& AddConnectedComponents(
+      const std::string& output_property_name, bool is_symmetric = false,
+      ConnectedComponentsPlan plan = {});
+
+  /// Queues LocalClusteringCoefficient into the property
+  /// output_property_name.
+  AnalyticsSession& AddLocalClusteringCoefficient(
+      const std::string& output_property_name,
+      LocalClusteringCoefficientPlan plan = {});
+
+  /// Runs every queued analytic and clears the queue, whatever the result.
+  ///
+  /// The output properties must all be distinct and none may exist before
+  /// the call; this is checked before anything runs.
+  katana::Result<void> Run(katana::TxnContext* txn_ctx);
+
+  /// Runs every queued analytic like Run, but returns the outputs as the
+  /// columns of a table, in the order they were queued, instead of leaving
+  /// them in the graph, e.g., a column per start node of a sweep of BFS
+  /// levels.
+  katana::Result<std::shared_ptr<arrow::Table>> RunToTable(
+      katana::TxnContext* txn_ctx);
+
+  /// Releases the views held since the last run, so that the view cache may
+  /// evict their topologies.
+  void ReleaseViews() { held_views_.clear(); }
+
+  /// The number of analytics queued.
+  size_t size() const { return jobs_.size() + bfs_levels_.size(); }
+
+private:
+  /// The views of the graph the analytics run over.
+  enum View {
+    kDefault,
+    kBiDirectional,
+    kTransposed,
+    kUndirected,
+    kEdgesSortedByDestID,
+    kEdgesSortedByDestIDHubBitmaps,
+    kNodesSortedByDegreeEdgesSortedByDestID,
+    kNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps,
+  };
+
+  /// An analytic, as a call that writes its outputs through a transaction,
+  /// and the properties it reads.
+  struct Job {
+    View view;
+    std::vector<std::string> output_property_names;
+    std::function<katana::Result<void>(katana::TxnContext*)> run;
+    PropertyRequirements requirements{};
+  };
+
+  struct BfsLevels {
+    uint32_t start_node;
+    std::string output_property_name;
+    BfsPlan plan;
+  };
+
+  std::shared_ptr<void> BuildView(View view);
+  void AddFusedBfsLevels(std::vector<Job>* jobs) const;
+
+  katana::PropertyGraph* pg_;
+  std::vector<Job> jobs_;
+  std::vector<BfsLevels> bfs_levels_;
+  /// The output properties of the queued analytics, in the order queued
+  std::vector<std::string> outputs_;
+  std::map<View, std::shared_ptr<void>> held_views_;
+  /// The topology version of the graph that held_views_ were built over
+  uint64_t held_views_version_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -18,43 +18,81 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
-    // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
-    // kAsynchronous,
-    // kAutomatic,
+    kAdaptive,
+    kAsynchronous,
+    kAutomatic,
   };
 
+  static constexpr float kDefaultEpsilon = 0.01;
+  static constexpr float kDefaultDelta = 0.1;
+
 private:
   Algorithm algorithm_;
+  float epsilon_;
+  float delta_;
 
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm,
+      float epsilon = kDefaultEpsilon, float delta = kDefaultDelta)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        delta_(delta) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
 
+  /// Choose an algorithm for pg when it is run; see Automatic.
   BetweennessCentralityPlan(const katana::PropertyGraph* pg [[maybe_unused]])
-      : BetweennessCentralityPlan() {
-    // TODO(gill): Reinstate automation once we reinstate async
-    // if (algo == AutoAlgo) {
-    //   katana::FileGraph degreeGraph;
-    //   degreeGraph.fromFile(inputFile);
-    //   degreeGraph.initNodeDegrees();
-    //   autoAlgoTimer.start();
-    //   if (isApproximateDegreeDistributionPowerLaw(degreeGraph)) {
-    //     algo = Asynchronous;
-    //   } else {
-    //     algo = Level;
-    //   }
-    //   autoAlgoTimer.stop();
-    // }
-  }
+      : BetweennessCentralityPlan{kCPU, kAutomatic} {}
 
   Algorithm algorithm() const { return algorithm_; }
+  /// Largest error of a normalized centrality the adaptive algorithm allows
+  float epsilon() const { return epsilon_; }
+  /// Probability with which the adaptive algorithm may exceed epsilon
+  float delta() const { return delta_; }
 
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Asynchronous algorithm
+  ///
+  /// Builds the shortest path DAG of each source from a worklist ordered by
+  /// distance, correcting edges as shorter paths are found, and propagates
+  /// dependencies back from the leaves, in both phases without the barrier
+  /// per level of the level algorithm. Suits graphs of high diameter, e.g.,
+  /// road networks.
+  ///
+  /// D. Prountzos and K. Pingali, "Betweenness centrality: algorithms and
+  /// implementations," PPoPP 2013, pp. 35-46.
+  static BetweennessCentralityPlan Asynchronous() {
+    return {kCPU, kAsynchronous};
+  }
+
+  /// Choose the asynchronous algorithm for graphs whose estimated diameter
+  /// is high and the level algorithm otherwise.
+  static BetweennessCentralityPlan Automatic() { return {kCPU, kAutomatic}; }
+
+  /// Adaptive sampling of sources with the outer algorithm
+  ///
+  /// Runs batches of uniformly sampled sources of doubling size in parallel
+  /// and stops once, with probability at least 1 - delta, the centrality of
+  /// every node divided by n(n - 2) is within epsilon of the exact
+  /// value. The bound of each batch is an empirical Bernstein bound on the
+  /// dependencies of the sources so far, so graphs whose dependencies vary
+  /// little stop long before the Hoeffding bound on the number of sources,
+  /// which caps the sampling. The output is scaled to estimate the
+  /// centrality over all sources.
+  ///
+  /// MAURER, Andreas; PONTIL, Massimiliano. Empirical Bernstein bounds and
+  /// sample variance penalization. In: Conference on Learning Theory (COLT).
+  /// 2009.
+  static BetweennessCentralityPlan Adaptive(
+      float epsilon = kDefaultEpsilon, float delta = kDefaultDelta) {
+    return {kCPU, kAdaptive, epsilon, delta};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
@@ -78,6 +116,7 @@ KATANA_EXPORT extern const BetweennessCentralitySources
 /// @param sources Only process some sources, producing an approximate
 ///          betweenness centrality. If this is a vector process those source
 ///          nodes; if this is an int process that number of source nodes.
+///          The adaptive plan picks its own sources and requires all nodes.
 /// @param plan
 KATANA_EXPORT Result<void> BetweennessCentrality(
     PropertyGraph* pg, const std::string& output_property_name,
@@ -2,7 +2,10 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_BFS_BFS_H_
 
 #include <iostream>
+#include <string>
+#include <vector>
 
+#include "katana/TemporalView.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -68,6 +71,10 @@ public:
       uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
     return {kCPU, kSynchronousDirectOpt, 0, alpha, beta};
   }
+
+  /// Level synchronous BFS on the GPU, which needs the GPU analytics plugin;
+  /// see GpuAnalytics
+  static BfsPlan Gpu() { return {kGPU, kSynchronous, 0, 0, 0}; }
 };
 
 /// Compute BFS parent of nodes in the graph pg starting from start_node. The
@@ -80,6 +87,46 @@ KATANA_EXPORT Result<void> Bfs(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     BfsPlan algo = {});
 
+/// Compute the BFS level of nodes in the graph pg from each of start_nodes at
+/// once. The level of each node from start_nodes[i] is stored in a uint32_t
+/// property named output_property_names[i], which must not exist before the
+/// call; unreachable nodes get a level of
+/// std::numeric_limits<uint32_t>::max() / 4.
+///
+/// Sources are processed in batches of up to 512 that share each scan of an
+/// adjacency list, with one bit per source on each node (MS-BFS). The plan
+/// picks between BfsPlan::SynchronousDirectOpt, which switches between
+/// pushing and pulling with its alpha and beta, and BfsPlan::Synchronous,
+/// which always pushes.
+KATANA_EXPORT Result<void> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& start_nodes,
+    const std::vector<std::string>& output_property_names,
+    katana::TxnContext* txn_ctx, BfsPlan algo = {});
+
+/// Compute the BFS distances between each pair of start_nodes, as
+/// MultiSourceBfs does, without storing the level of every node. The result
+/// is a start_nodes.size() x start_nodes.size() row major matrix whose entry
+/// (i, j) is the distance from start_nodes[i] to start_nodes[j], or
+/// std::numeric_limits<uint32_t>::max() / 4 if there is no path.
+KATANA_EXPORT Result<std::vector<uint32_t>> MultiSourceBfsDistances(
+    PropertyGraph* pg, const std::vector<uint32_t>& start_nodes,
+    BfsPlan algo = {});
+
+/// Compute the earliest time each node of the graph pg can be reached from
+/// start_node along a time-respecting path of window: one whose edges are in
+/// the window and have non-decreasing timestamps. The search leaves
+/// start_node at window.window_begin(), which is its own time. The result is
+/// stored in an int64_t property named by output_property_name, which must
+/// not exist before the call; unreachable nodes get
+/// TemporalView::kMaxTimestamp. The window must not be transposed.
+///
+/// The edges of a node in a TemporalView are sorted by timestamp, so each
+/// node reached scans only the edges that leave it no earlier than the time
+/// it was reached.
+KATANA_EXPORT Result<void> TemporalBfs(
+    PropertyGraph* pg, const TemporalView& window, uint32_t start_node,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx);
+
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does do an exhaustive check.
 /// @return a failure if the BFS results do not pass validation or if there is a
@@ -0,0 +1,103 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include <iostream>
+#include <limits>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for BipartiteMatching, specifying the algorithm and
+/// any parameters associated with it.
+class BipartiteMatchingPlan : public Plan {
+public:
+  enum Algorithm { kPothenFan };
+
+  static constexpr bool kDefaultKarpSipserInit = true;
+
+private:
+  Algorithm algorithm_;
+  bool karp_sipser_init_;
+
+  BipartiteMatchingPlan(
+      Architecture architecture, Algorithm algorithm, bool karp_sipser_init)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        karp_sipser_init_(karp_sipser_init) {}
+
+public:
+  BipartiteMatchingPlan()
+      : BipartiteMatchingPlan(kCPU, kPothenFan, kDefaultKarpSipserInit) {}
+
+  BipartiteMatchingPlan& operator=(const BipartiteMatchingPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Whether to start from a Karp-Sipser matching rather than an empty one
+  bool karp_sipser_init() const { return karp_sipser_init_; }
+
+  /// Pothen-Fan with lookahead (PF+): in every phase, each unmatched left
+  /// node searches depth first for an augmenting path in parallel with the
+  /// others. The right nodes a search visits are claimed for the phase, so
+  /// the paths found are disjoint and are augmented without locks. Before
+  /// going deeper, a search looks ahead for an unmatched neighbor, and
+  /// phases alternate the order neighbors are searched in. The phases end
+  /// when one augments no path.
+  ///
+  /// With karp_sipser_init, the search starts from the matching of a one
+  /// sided parallel Karp-Sipser heuristic: left nodes with a single
+  /// unmatched neighbor are matched to it first, and then the others
+  /// greedily, which leaves few nodes for the phases.
+  static BipartiteMatchingPlan PothenFan(
+      bool karp_sipser_init = kDefaultKarpSipserInit) {
+    return {kCPU, kPothenFan, karp_sipser_init};
+  }
+};
+
+/// The value of the output property of BipartiteMatching for the nodes
+/// without a partner
+constexpr uint32_t kUnmatchedNode = std::numeric_limits<uint32_t>::max();
+
+/// Compute a maximum cardinality matching of the bipartite graph between the
+/// nodes of type left_node_type and the nodes of type right_node_type, and
+/// return its size. Edges in either direction between a left node and a
+/// right node may be matched; other edges are ignored. No node may have
+/// both types.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call. The created property has type uint32_t:
+/// it is the partner of each matched node, and kUnmatchedNode for the other
+/// nodes.
+KATANA_EXPORT Result<uint64_t> BipartiteMatching(
+    PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BipartiteMatchingPlan plan = {});
+
+/// Check that the partners of property_name are a matching of the edges
+/// between left and right nodes and that no augmenting path is left, which
+/// makes it a maximum matching.
+KATANA_EXPORT Result<void> BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type, const std::string& property_name);
+
+struct KATANA_EXPORT BipartiteMatchingStatistics {
+  /// The number of matched pairs.
+  uint64_t cardinality;
+  /// The number of unmatched left nodes.
+  uint64_t unmatched_left;
+  /// The number of unmatched right nodes.
+  uint64_t unmatched_right;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BipartiteMatchingStatistics> Compute(
+      PropertyGraph* pg, const std::string& left_node_type,
+      const std::string& right_node_type, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -102,6 +102,16 @@ KATANA_EXPORT Result<void> Cdlp(
     size_t max_iterations, katana::TxnContext* txn_ctx,
     const bool& is_symmetric = false, CdlpPlan plan = CdlpPlan());
 
+/// Compute the Community Detection for pg like Cdlp, but with every neighbor's
+/// community counted with the weight of the edge to it, which is the edge
+/// property named edge_weight_property_name. Only the synchronous algorithm
+/// is supported.
+KATANA_EXPORT Result<void> Cdlp(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, size_t max_iterations,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
+    CdlpPlan plan = CdlpPlan());
+
 /// TODO (Yasin): This Struct (Compute function) is now being used by louvain,
 /// cc, and cdlp, basically everything which is calculating communities. Explore
 /// possiblity of moving it to some common .h file in libgalois/include/analytics
@@ -2,6 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -148,6 +151,11 @@ public:
         kCPU, kEdgeAfforest, edge_tile_size, neighbor_sample_size,
         component_sample_frequency};
   }
+
+  /// Hooking and pointer jumping over all edges on the GPU, which needs the
+  /// GPU analytics plugin; see GpuAnalytics. Components are labeled by their
+  /// smallest node id.
+  static ConnectedComponentsPlan Gpu() { return {kGPU, kSynchronous, 0, 0, 0}; }
 };
 
 /// Compute the Connected-components for pg. The pg is expected to be
@@ -162,6 +170,31 @@ KATANA_EXPORT Result<void> ConnectedComponents(
     katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
     ConnectedComponentsPlan plan = ConnectedComponentsPlan());
 
+/// Apply a batch of edge insertions to connected components kept as a
+/// union-find forest in the node property parent_property_name. The
+/// property holds the id of a parent node for every node and only changes
+/// through this function, so it can be saved with the graph and batches
+/// applied over many sessions.
+///
+/// The first call creates the property and joins the edges of pg itself,
+/// which takes time linear in the graph. Every later call only touches the
+/// nodes on the paths from the endpoints of inserted_edges to their roots,
+/// which are kept short by path halving. The edges are those of an
+/// undirected graph and are not added to pg.
+///
+/// Returns the number of components the batch merged away
+KATANA_EXPORT Result<uint64_t> ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& parent_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    katana::TxnContext* txn_ctx);
+
+/// The component ids of nodes in the forest ConnectedComponentsIncremental
+/// maintains in parent_property_name. The id of a component is its least
+/// node, so they stay the same across batches until components merge.
+KATANA_EXPORT Result<std::vector<uint64_t>> ConnectedComponentsFind(
+    PropertyGraph* pg, const std::string& parent_property_name,
+    const std::vector<uint32_t>& nodes);
+
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -0,0 +1,75 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for GraphColoring, specifying the algorithm and any
+/// parameters associated with it.
+class GraphColoringPlan : public Plan {
+public:
+  enum Algorithm { kJonesPlassmann, kLargestDegreeFirst };
+
+private:
+  Algorithm algorithm_;
+
+  GraphColoringPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  GraphColoringPlan() : GraphColoringPlan(kCPU, kLargestDegreeFirst) {}
+
+  GraphColoringPlan& operator=(const GraphColoringPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Jones-Plassmann coloring with random priorities: every round colors the
+  /// nodes whose priority is higher than that of their uncolored neighbors,
+  /// each with the smallest color none of its neighbors has.
+  static GraphColoringPlan JonesPlassmann() { return {kCPU, kJonesPlassmann}; }
+
+  /// Jones-Plassmann coloring with nodes of higher degree first, ties broken
+  /// at random, which usually takes fewer colors and more rounds.
+  static GraphColoringPlan LargestDegreeFirst() {
+    return {kCPU, kLargestDegreeFirst};
+  }
+
+  static GraphColoringPlan FromAlgorithm(Algorithm algorithm) {
+    return {kCPU, algorithm};
+  }
+};
+
+/// Color the nodes of the graph such that no two adjacent nodes have the same
+/// color, with colors 0 to the maximum degree, usually far fewer. Nodes of the
+/// same color are independent, so they can be processed together, as in the
+/// schedules of parallel updates. The graph must be symmetric.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, GraphColoringPlan plan = {});
+
+KATANA_EXPORT Result<void> GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT GraphColoringStatistics {
+  /// The number of colors used.
+  uint32_t num_colors;
+  /// The number of nodes of the most common color.
+  uint64_t largest_color_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphColoringStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -40,6 +40,10 @@ public:
 
   static IndependentSetPlan Pull() { return {kCPU, kPull}; }
 
+  /// Luby's algorithm with nodes of lower degree first, in rounds on the
+  /// engine shared with GraphColoring: the nodes whose priority is higher
+  /// than that of their undecided neighbors join the set, and their neighbors
+  /// leave it, until every node is decided.
   static IndependentSetPlan Priority() { return {kCPU, kPriority}; }
 
   static IndependentSetPlan EdgeTiledPriority() {
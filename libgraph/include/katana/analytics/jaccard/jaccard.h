@@ -2,6 +2,8 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_JACCARD_JACCARD_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -28,9 +30,14 @@ public:
 
 private:
   EdgeSorting edge_sorting_;
+  bool hub_bitmaps_;
 
-  JaccardPlan(Architecture architecture, EdgeSorting edge_sorting)
-      : Plan(architecture), edge_sorting_(edge_sorting) {}
+  JaccardPlan(
+      Architecture architecture, EdgeSorting edge_sorting,
+      bool hub_bitmaps = false)
+      : Plan(architecture),
+        edge_sorting_(edge_sorting),
+        hub_bitmaps_(hub_bitmaps) {}
 
 public:
   /// Automatically choose an algorithm.
@@ -42,11 +49,18 @@ public:
 
   EdgeSorting edge_sorting() const { return edge_sorting_; }
 
+  bool hub_bitmaps() const { return hub_bitmaps_; }
+
   /// The graph's edge lists are not sorted; use an algorithm that handles that.
   static JaccardPlan Unsorted() { return {kCPU, kUnsorted}; }
 
   /// The graph's edge lists are sorted; optimize based on this.
   static JaccardPlan Sorted() { return {kCPU, kSorted}; }
+
+  /// Sort a view of the graph's edge lists, whatever their order, and
+  /// intersect with adjacency bitmaps of the high degree nodes. Assumes the
+  /// graph has no parallel edges.
+  static JaccardPlan HubBitmaps() { return {kCPU, kSorted, true}; }
 };
 
 /// The tag for the output property of Jaccard in PropertyGraphs.
@@ -65,6 +79,26 @@ KATANA_EXPORT Result<void> Jaccard(
 KATANA_EXPORT Result<void> JaccardAssertValid(
     PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
 
+/// The similarity of two neighbor sets A and B computed by SimilarityTopK.
+enum class SetSimilarity {
+  /// |A ∩ B| / |A ∪ B|
+  kJaccard,
+  /// |A ∩ B| / sqrt(|A| |B|)
+  kCosine,
+};
+
+/// Find, for every node, the k other nodes whose sets of out neighbors are
+/// most similar to its own, ignoring pairs less similar than min_similarity.
+/// The result has a list per node of (node, similarity) pairs from most to
+/// least similar, ties broken by smaller node id; nodes which share no
+/// neighbor are never matched. Only pairs which share one of the rarest
+/// neighbors of each are compared (prefix filtering), so raising
+/// min_similarity makes the search faster.
+KATANA_EXPORT Result<std::vector<std::vector<std::pair<uint32_t, double>>>>
+SimilarityTopK(
+    PropertyGraph* pg, uint32_t k, double min_similarity = 0,
+    SetSimilarity measure = SetSimilarity::kJaccard);
+
 struct KATANA_EXPORT JaccardStatistics {
   /// The maximum similarity excluding the comparison node.
   double max_similarity;
@@ -68,5 +68,41 @@ struct KATANA_EXPORT KCoreStatistics {
       const std::string& property_name);
 };
 
+/// Compute the core number of every node of pg, the largest k such that the
+/// node is in the k-core, in a single pass. The core numbers are stored in a
+/// uint32_t property named output_property_name, which is created by this
+/// function and may not exist before the call.
+///
+/// Nodes are peeled in increasing order of core number from buckets of
+/// nodes by current degree, as in Julienne; each bucket is peeled in
+/// synchronous rounds like KCorePlan::Synchronous. Only
+/// KCorePlan::Synchronous is supported.
+KATANA_EXPORT Result<void> CoreDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
+    KCorePlan plan = KCorePlan());
+
+/// Check that the core numbers in property_name are consistent: each node
+/// with core number k has at least k neighbors with a core number of at
+/// least k, but not k + 1 neighbors with a core number of at least k + 1.
+KATANA_EXPORT Result<void> CoreDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name,
+    const bool& is_symmetric = false);
+
+struct KATANA_EXPORT CoreDecompositionStatistics {
+  /// The largest core number of any node, the degeneracy of the graph.
+  uint32_t max_core_number;
+  /// Number of nodes with the largest core number.
+  uint64_t number_of_nodes_in_max_core;
+  /// Average core number over all nodes.
+  double average_core_number;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<CoreDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
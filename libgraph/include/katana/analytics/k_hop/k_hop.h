@@ -0,0 +1,89 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_KHOP_KHOP_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_KHOP_KHOP_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/PropertyGraph.h"
+
+// API
+
+namespace katana::analytics {
+
+/// Which edges and nodes a KHopQuery walks over.
+struct KHopOptions {
+  /// The edge types to walk over; empty for all edges. An edge is walked over
+  /// if it has any of them.
+  std::vector<std::string> edge_types;
+  /// The node types of the nodes that are reached; empty for all nodes. A
+  /// node is reached, and walked on from, if it has any of them.
+  std::vector<std::string> node_types;
+  /// Whether to walk over the out edges of the nodes
+  bool out_edges = true;
+  /// Whether to walk over the in edges of the nodes, e.g., along with the out
+  /// edges for the neighborhood of a directed graph seen as undirected
+  bool in_edges = false;
+};
+
+/// The nodes at most some number of hops away from a start node, by hop.
+struct KATANA_EXPORT KHopNeighborhood {
+  /// The nodes reached, without the start node, in the order they were
+  /// reached: those of hop 1 first, then those of hop 2 and so on
+  std::vector<uint32_t> nodes;
+  /// The nodes of hop h + 1 are nodes[hop_offsets[h]] to
+  /// nodes[hop_offsets[h + 1]]; it has one more entry than there are hops
+  std::vector<uint64_t> hop_offsets;
+};
+
+/// Answers k-hop neighborhood queries, e.g., the 2-hop neighbors of a node,
+/// in time that depends on the size of the neighborhood rather than on the
+/// size of the graph, as an online service needs.
+///
+/// Each query runs breadth first on the calling thread, without the thread
+/// pool, so that many queries may run at once from threads of the caller.
+/// The nodes visited are kept in a scratch set that is reused by later
+/// queries: an open addressing hash set while few nodes are visited, which
+/// is cleared by bumping a generation, and a bitset once a query visits many.
+///
+/// The graph must outlive the query and not change while it is used.
+class KATANA_EXPORT KHopQuery {
+public:
+  /// Builds a query for pg, along with the edge type aware view it walks
+  /// over if types or in edges are asked for. Fails if a type of options
+  /// does not exist.
+  static Result<std::unique_ptr<KHopQuery>> Make(
+      PropertyGraph* pg, KHopOptions options = {});
+
+  ~KHopQuery();
+
+  /// The nodes at most hops away from start_node. Safe to call from several
+  /// threads at once.
+  Result<KHopNeighborhood> Neighbors(uint32_t start_node, uint32_t hops) const;
+
+private:
+  class Scratch;
+
+  KHopQuery(PropertyGraph* pg, KHopOptions options);
+
+  std::unique_ptr<Scratch> AcquireScratch() const;
+  void ReleaseScratch(std::unique_ptr<Scratch> scratch) const;
+
+  PropertyGraph* pg_;
+  KHopOptions options_;
+  /// The edge types walked over, as the types of the edge type aware view;
+  /// empty if every edge is
+  std::vector<EntityTypeID> edge_types_;
+  /// Whether a node of each node type is reached; empty if every node is
+  std::vector<bool> node_type_reached_;
+  std::unique_ptr<PropertyGraphViews::EdgeTypeAwareBiDir> view_;
+
+  mutable std::mutex scratch_mutex_;
+  mutable std::vector<std::unique_ptr<Scratch>> free_scratch_;
+};
+
+}  // namespace katana::analytics
+
+#endif
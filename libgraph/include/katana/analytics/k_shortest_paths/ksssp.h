@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_KSHORTESTPATHS_KSSSP_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_KSHORTESTPATHS_KSSSP_H_
 
+#include <utility>
+#include <vector>
+
 #include "katana/analytics/sssp/sssp.h"
 
 namespace katana::analytics {
@@ -16,6 +19,36 @@ KATANA_EXPORT Result<void> Ksssp(
     uint32_t start_node, uint32_t report_node, katana::TxnContext* txn_ctx,
     AlgoReachability algo_reachability, uint32_t num_paths, uint32_t step_shift,
     const bool& is_symmetric, kSsspPlan plan = {});
+
+/// A path found by KShortestSimplePaths: its nodes from source to target and
+/// the sum of the weights of its edges.
+struct KATANA_EXPORT SimplePath {
+  std::vector<uint32_t> nodes;
+  double weight;
+};
+
+/// Compute up to k shortest simple paths, without repeated nodes, from s to
+/// t for every (s, t) in queries, shortest first; fewer if there are not k.
+/// The edge weights are taken from the property named
+/// edge_weight_property_name (which must be non-negative), or every edge has
+/// length 1 if it is empty. Parallel edges count as one edge of the least
+/// weight. Which of several paths of the same weight come first is
+/// arbitrary, but the same on every run.
+///
+/// This is Yen's algorithm with Lawler's rule of deviating only from the
+/// last deviation on. A shortest path tree to t, found once per query along
+/// in edges, serves every spur search of the query: the searches are A*
+/// towards t with the tree distances as heuristic, and stop at the first
+/// node whose tree path to t avoids the root path. Queries run in
+/// parallel; when there are fewer queries than threads, the spur searches
+/// of each path do instead. Each thread keeps a few arrays over all nodes
+/// for the duration of the call.
+KATANA_EXPORT Result<std::vector<std::vector<SimplePath>>>
+KShortestSimplePaths(
+    PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries, uint32_t k,
+    const std::string& edge_weight_property_name = "");
+
 }  // namespace katana::analytics
 
 #endif
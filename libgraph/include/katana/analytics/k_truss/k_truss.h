@@ -2,6 +2,7 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_KTRUSS_KTRUSS_H_
 
 #include <iostream>
+#include <string>
 
 #include <katana/analytics/Plan.h>
 
@@ -57,6 +58,27 @@ KATANA_EXPORT Result<void> KTrussAssertValid(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& property_name);
 
+/// The tag for the output property of TrussDecomposition in PropertyGraphs.
+using EdgeTrussness = katana::PODProperty<uint32_t>;
+
+/// Compute the trussness of every edge of pg, the largest k such that the
+/// edge is in the k-truss, and so at least 2 for every edge that is not a
+/// self loop; self loops get 0. Parallel edges share one trussness. The pg
+/// is expected to be symmetric; unlike KTruss, it is not reordered.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+///
+/// @return The largest trussness in pg.
+KATANA_EXPORT Result<uint32_t> TrussDecomposition(
+    katana::TxnContext* txn_ctx, PropertyGraph* pg,
+    const std::string& output_property_name);
+
+/// Check, in parallel, that every edge of trussness t has at least t - 2
+/// triangles among edges of trussness at least t, fewer than t - 1 among
+/// edges of trussness more than t, and the trussness of its reverse edge.
+KATANA_EXPORT Result<void> TrussDecompositionAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
 struct KATANA_EXPORT KTrussStatistics {
   /// Total number of edges left in the truss.
   uint64_t number_of_edges_left;
@@ -2,9 +2,13 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_LEIDENCLUSTERING_LEIDENCLUSTERING_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/PropertyRequirements.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -25,6 +29,7 @@ public:
   static const uint32_t kDefaultMinGraphSize = 100;
   static constexpr double kDefaultResolution = 1.0;
   static constexpr double kDefaultRandomness = 0.01;
+  static const uint32_t kDefaultWarmStartHops = 1;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -37,12 +42,13 @@ private:
   uint32_t min_graph_size_;
   double resolution_;
   double randomness_;
+  uint32_t warm_start_hops_;
 
   LeidenClusteringPlan(
       Architecture architecture, Algorithm algorithm, bool enable_vf,
       double modularity_threshold_per_round, double modularity_threshold_total,
       uint32_t max_iterations, uint32_t min_graph_size, double resolution,
-      double randomness)
+      double randomness, uint32_t warm_start_hops)
       : Plan(architecture),
         algorithm_(algorithm),
         enable_vf_(enable_vf),
@@ -51,7 +57,8 @@ private:
         max_iterations_(max_iterations),
         min_graph_size_(min_graph_size),
         resolution_(resolution),
-        randomness_(randomness) {}
+        randomness_(randomness),
+        warm_start_hops_(warm_start_hops) {}
 
 public:
   LeidenClusteringPlan()
@@ -64,7 +71,8 @@ public:
             kDefaultMaxIterations,
             kDefaultMinGraphSize,
             kDefaultResolution,
-            kDefaultRandomness} {}
+            kDefaultRandomness,
+            kDefaultWarmStartHops} {}
 
   Algorithm algorithm() const { return algorithm_; }
   /// Enable vertex following optimization
@@ -88,6 +96,10 @@ public:
   /// Randomness for picking subcommunities
   double randomness() const { return randomness_; }
 
+  /// Hops from the changed edges within which the nodes of a warm start are
+  /// re-evaluated
+  uint32_t warm_start_hops() const { return warm_start_hops_; }
+
   /// Nondeterministic algorithm for louvain clustering
   /// usign katana do_all
   static LeidenClusteringPlan DoAll(
@@ -98,7 +110,8 @@ public:
       uint32_t max_iterations = kDefaultMaxIterations,
       uint32_t min_graph_size = kDefaultMinGraphSize,
       double resolution = kDefaultResolution,
-      double randomness = kDefaultRandomness) {
+      double randomness = kDefaultRandomness,
+      uint32_t warm_start_hops = kDefaultWarmStartHops) {
     return {
         kCPU,
         kDoAll,
@@ -108,7 +121,8 @@ public:
         max_iterations,
         min_graph_size,
         resolution,
-        randomness};
+        randomness,
+        warm_start_hops};
   }
 
   /// Deterministic algorithm for louvain clustering
@@ -121,7 +135,8 @@ public:
       uint32_t max_iterations = kDefaultMaxIterations,
       uint32_t min_graph_size = kDefaultMinGraphSize,
       double resolution = kDefaultResolution,
-      double randomness = kDefaultRandomness) {
+      double randomness = kDefaultRandomness,
+      uint32_t warm_start_hops = kDefaultWarmStartHops) {
     return {
         kCPU,
         kDeterministic,
@@ -131,10 +146,24 @@ public:
         max_iterations,
         min_graph_size,
         resolution,
-        randomness};
+        randomness,
+        warm_start_hops};
   }
 };
 
+/// The properties LeidenClustering reads, which it loads if they are absent
+/// and keeps loaded while it runs: the edge weights, unless
+/// edge_weight_property_name is empty, and, when warm started, the clusters
+/// of the previous run.
+inline PropertyRequirements
+LeidenClusteringPropertyRequirements(
+    const std::string& edge_weight_property_name,
+    const std::string& initial_property_name = "") {
+  return PropertyRequirements{}
+      .AddEdgeProperty(edge_weight_property_name)
+      .AddNodeProperty(initial_property_name);
+}
+
 /// Compute the Leiden Clustering for pg.
 /// The edge weights are taken from the property named
 /// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
@@ -147,6 +176,22 @@ KATANA_EXPORT Result<void> LeidenClustering(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     const bool& is_symmetric = false, LeidenClusteringPlan plan = {});
 
+/// Compute the Leiden Clustering for pg, warm started from the clusters of a
+/// previous run in the property named initial_property_name (as uint64_t),
+/// for instance the output of the previous run before the graph changed.
+/// Only the nodes within plan.warm_start_hops() hops of an endpoint of
+/// changed_edges, which should hold the edges inserted and removed since, or
+/// without a cluster are re-evaluated on their own; each other cluster of
+/// the previous run starts as a single node of the first level (after delta
+/// screening, Zarayeneh and Kalyanaraman, "Delta-Screening: A Fast and
+/// Efficient Technique to Update Communities in Dynamic Graphs", 2021).
+KATANA_EXPORT Result<void> LeidenClustering(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& initial_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric = false, LeidenClusteringPlan plan = {});
+
 KATANA_EXPORT Result<void> LeidenClusteringAssertValid(
     PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name);
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_LOCALCLUSTERINGCOEFFICIENT_LOCALCLUSTERINGCOEFFICIENT_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_LOCALCLUSTERINGCOEFFICIENT_LOCALCLUSTERINGCOEFFICIENT_H_
 
+#include <cstdint>
+#include <limits>
+
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Plan.h"
@@ -14,7 +17,11 @@ namespace katana::analytics {
 /// Clustering Coefficient of the nodes in the graph.
 class LocalClusteringCoefficientPlan : public Plan {
 public:
-  enum Algorithm { kOrderedCountAtomics, kOrderedCountPerThread };
+  enum Algorithm {
+    kOrderedCountAtomics,
+    kOrderedCountPerThread,
+    kDegreeOrdered,
+  };
 
   enum Relabeling {
     kRelabel,
@@ -24,30 +31,49 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgesSorted = false;
+  static const bool kDefaultHubBitmaps = false;
+  /// Sample min degree that no node has, so that every coefficient is exact
+  static const uint32_t kNoSampling = std::numeric_limits<uint32_t>::max();
+  static const uint32_t kDefaultSampleMinDegree = kNoSampling;
+  static constexpr double kDefaultMaxError = 0.01;
 
 private:
   Algorithm algorithm_;
   bool edges_sorted_;
   Relabeling relabeling_;
+  bool hub_bitmaps_;
+  uint32_t sample_min_degree_;
+  double max_error_;
 
   LocalClusteringCoefficientPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, bool hub_bitmaps,
+      uint32_t sample_min_degree = kDefaultSampleMinDegree,
+      double max_error = kDefaultMaxError)
       : Plan(architecture),
         algorithm_(algorithm),
         edges_sorted_(edges_sorted),
-        relabeling_(relabeling) {}
+        relabeling_(relabeling),
+        hub_bitmaps_(hub_bitmaps),
+        sample_min_degree_(sample_min_degree),
+        max_error_(max_error) {}
 
 public:
   LocalClusteringCoefficientPlan()
       : LocalClusteringCoefficientPlan{
             kCPU, kOrderedCountPerThread, kDefaultEdgesSorted,
-            kDefaultRelabeling} {}
+            kDefaultRelabeling, kDefaultHubBitmaps} {}
 
   Algorithm algorithm() const { return algorithm_; }
   // TODO(amp): These parameters should be documented.
   bool edges_sorted() const { return edges_sorted_; }
   Relabeling relabeling() const { return relabeling_; }
+  /// Test membership in the adjacency bitmaps of high degree nodes
+  bool hub_bitmaps() const { return hub_bitmaps_; }
+  /// Nodes with at least this degree have sampled coefficients
+  uint32_t sample_min_degree() const { return sample_min_degree_; }
+  /// Bound of the error of the sampled coefficients
+  double max_error() const { return max_error_; }
 
   /**
    * An ordered count algorithm that sorts the nodes by degree before
@@ -57,17 +83,51 @@ public:
    *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmaps Test membership in adjacency bitmaps of high degree
+   *   nodes.
    */
   static LocalClusteringCoefficientPlan OrderedCountAtomics(
       bool edges_sorted = kDefaultEdgesSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kOrderedCountAtomics, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      bool hub_bitmaps = kDefaultHubBitmaps) {
+    return {kCPU, kOrderedCountAtomics, edges_sorted, relabeling, hub_bitmaps};
   }
 
   static LocalClusteringCoefficientPlan OrderedCountPerThread(
       bool edges_sorted = kDefaultEdgesSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kOrderedCountPerThread, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      bool hub_bitmaps = kDefaultHubBitmaps) {
+    return {
+        kCPU, kOrderedCountPerThread, edges_sorted, relabeling, hub_bitmaps};
+  }
+
+  /**
+   * Count the triangles of every node on the view of the graph with the nodes
+   * sorted by degree, shared with triangle counting, so that each triangle is
+   * found from its node of least degree and only intersects neighbors of
+   * higher degree, as TriangleCountPlan::OrderedCount does. The cost of a
+   * hub is then spread over its neighbors.
+   *
+   * The coefficients of nodes of at least a given degree may be estimated
+   * instead, from the share of a sample of their wedges, i.e., pairs of
+   * neighbors, that are closed. The triangles between those nodes only are
+   * not counted at all. The sample is large enough for every estimate to be
+   * within max_error of the coefficient with 95% confidence (by Hoeffding's
+   * inequality), and nodes with fewer wedges than that are counted exactly.
+   *
+   * @param sample_min_degree Sample the nodes with at least this degree, or
+   *     kNoSampling for exact coefficients.
+   * @param max_error Bound of the absolute error of a sampled coefficient.
+   * @param hub_bitmaps Test membership in adjacency bitmaps of high degree
+   *   nodes.
+   */
+  static LocalClusteringCoefficientPlan DegreeOrdered(
+      uint32_t sample_min_degree = kDefaultSampleMinDegree,
+      double max_error = kDefaultMaxError,
+      bool hub_bitmaps = kDefaultHubBitmaps) {
+    return {
+        kCPU,        kDegreeOrdered,    kDefaultEdgesSorted, kRelabel,
+        hub_bitmaps, sample_min_degree, max_error};
   }
 };
 
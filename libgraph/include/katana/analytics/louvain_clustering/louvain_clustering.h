@@ -2,9 +2,13 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_LOUVAINCLUSTERING_LOUVAINCLUSTERING_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/PropertyRequirements.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -23,6 +27,7 @@ public:
   static constexpr double kDefaultModularityThresholdTotal = 0.01;
   static const uint32_t kDefaultMaxIterations = 1000;
   static const uint32_t kDefaultMinGraphSize = 100;
+  static const uint32_t kDefaultWarmStartHops = 1;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -33,18 +38,21 @@ private:
   double modularity_threshold_total_;
   uint32_t max_iterations_;
   uint32_t min_graph_size_;
+  uint32_t warm_start_hops_;
 
   LouvainClusteringPlan(
       Architecture architecture, Algorithm algorithm, bool enable_vf,
       double modularity_threshold_per_round, double modularity_threshold_total,
-      uint32_t max_iterations, uint32_t min_graph_size)
+      uint32_t max_iterations, uint32_t min_graph_size,
+      uint32_t warm_start_hops)
       : Plan(architecture),
         algorithm_(algorithm),
         enable_vf_(enable_vf),
         modularity_threshold_per_round_(modularity_threshold_per_round),
         modularity_threshold_total_(modularity_threshold_total),
         max_iterations_(max_iterations),
-        min_graph_size_(min_graph_size) {}
+        min_graph_size_(min_graph_size),
+        warm_start_hops_(warm_start_hops) {}
 
 public:
   LouvainClusteringPlan()
@@ -55,7 +63,8 @@ public:
             kDefaultModularityThresholdPerRound,
             kDefaultModularityThresholdTotal,
             kDefaultMaxIterations,
-            kDefaultMinGraphSize} {}
+            kDefaultMinGraphSize,
+            kDefaultWarmStartHops} {}
 
   Algorithm algorithm() const { return algorithm_; }
   /// Enable vertex following optimization
@@ -72,6 +81,9 @@ public:
   uint32_t max_iterations() const { return max_iterations_; }
   /// Minimum coarsened graph size
   uint32_t min_graph_size() const { return min_graph_size_; }
+  /// Hops from the changed edges within which the nodes of a warm start are
+  /// re-evaluated
+  uint32_t warm_start_hops() const { return warm_start_hops_; }
 
   /// Nondeterministic algorithm for louvain clustering
   /// usign katana do_all
@@ -81,7 +93,8 @@ public:
           kDefaultModularityThresholdPerRound,
       double modularity_threshold_total = kDefaultModularityThresholdTotal,
       uint32_t max_iterations = kDefaultMaxIterations,
-      uint32_t min_graph_size = kDefaultMinGraphSize) {
+      uint32_t min_graph_size = kDefaultMinGraphSize,
+      uint32_t warm_start_hops = kDefaultWarmStartHops) {
     return {
         kCPU,
         kDoAll,
@@ -89,7 +102,8 @@ public:
         modularity_threshold_per_round,
         modularity_threshold_total,
         max_iterations,
-        min_graph_size};
+        min_graph_size,
+        warm_start_hops};
   }
 
   /// Deterministic algorithm for louvain clustering
@@ -100,7 +114,8 @@ public:
           kDefaultModularityThresholdPerRound,
       double modularity_threshold_total = kDefaultModularityThresholdTotal,
       uint32_t max_iterations = kDefaultMaxIterations,
-      uint32_t min_graph_size = kDefaultMinGraphSize) {
+      uint32_t min_graph_size = kDefaultMinGraphSize,
+      uint32_t warm_start_hops = kDefaultWarmStartHops) {
     return {
         kCPU,
         kDeterministic,
@@ -108,10 +123,24 @@ public:
         modularity_threshold_per_round,
         modularity_threshold_total,
         max_iterations,
-        min_graph_size};
+        min_graph_size,
+        warm_start_hops};
   }
 };
 
+/// The properties LouvainClustering reads, which it loads if they are absent
+/// and keeps loaded while it runs: the edge weights, unless
+/// edge_weight_property_name is empty, and, when warm started, the clusters
+/// of the previous run.
+inline PropertyRequirements
+LouvainClusteringPropertyRequirements(
+    const std::string& edge_weight_property_name,
+    const std::string& initial_property_name = "") {
+  return PropertyRequirements{}
+      .AddEdgeProperty(edge_weight_property_name)
+      .AddNodeProperty(initial_property_name);
+}
+
 /// Compute the Louvain Clustering for pg.
 /// The edge weights are taken from the property named
 /// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
@@ -124,6 +153,22 @@ KATANA_EXPORT Result<void> LouvainClustering(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     const bool& is_symmetric, LouvainClusteringPlan plan = {});
 
+/// Compute the Louvain Clustering for pg, warm started from the clusters of a
+/// previous run in the property named initial_property_name (as uint64_t),
+/// for instance the output of the previous run before the graph changed.
+/// Only the nodes within plan.warm_start_hops() hops of an endpoint of
+/// changed_edges, which should hold the edges inserted and removed since, or
+/// without a cluster are re-evaluated on their own; each other cluster of
+/// the previous run starts as a single node of the first level (after delta
+/// screening, Zarayeneh and Kalyanaraman, "Delta-Screening: A Fast and
+/// Efficient Technique to Update Communities in Dynamic Graphs", 2021).
+KATANA_EXPORT Result<void> LouvainClustering(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& initial_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric = false, LouvainClusteringPlan plan = {});
+
 KATANA_EXPORT Result<void> LouvainClusteringAssertValid(
     PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name);
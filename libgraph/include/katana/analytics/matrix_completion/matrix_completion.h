@@ -16,6 +16,7 @@ class MatrixCompletionPlan : public Plan {
 public:
   enum Algorithm {
     kSGDByItems,
+    kALS,
   };
 
   enum Step { kBold, kBottou, kIntel, kInverse, kPurdue };
@@ -122,11 +123,37 @@ public:
         use_det_init,
         learning_rate_function};
   }
+
+  /// Alternating least squares: each round solves for the vectors of all
+  /// the items and then of all the users exactly, so it converges in far
+  /// fewer rounds than SGD and needs no learning rate. max_updates and
+  /// fixed_rounds count rounds.
+  static MatrixCompletionPlan ALS(
+      double lambda = kDefaultLambda, double tolerance = kDefaultTolerance,
+      bool use_same_latent_vector = kDefaultUseSameLatentVector,
+      uint32_t max_updates = kDefaultMaxUpdates,
+      uint32_t fixed_rounds = kDefaultFixedRounds,
+      bool use_det_init = kDefaultUseDetInit) {
+    return {
+        kCPU,
+        kALS,
+        kDefaultLearningRate,
+        kDefaultDecayRate,
+        lambda,
+        tolerance,
+        use_same_latent_vector,
+        max_updates,
+        kDefaultUpdatesPerEdge,
+        fixed_rounds,
+        kDefaultUseExactError,
+        use_det_init,
+        kDefaultLearningRateFunction};
+  }
 };
 
-/// Performs matrix completion using stochastic gradient descent (SGD) algortihm
-/// on a bipartite graph and learns latent vectors for each node that is stored in
-/// an ArrayProperty.
+/// Performs matrix completion using stochastic gradient descent (SGD) or
+/// alternating least squares (ALS) on a bipartite graph and learns latent
+/// vectors for each node that is stored in an ArrayProperty.
 /// The plan controls the algorithm and parameters used to compute the latent vectors.
 KATANA_EXPORT Result<void> MatrixCompletion(
     katana::PropertyGraph* pg, katana::TxnContext* txn_ctx,
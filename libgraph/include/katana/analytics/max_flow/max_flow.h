@@ -0,0 +1,99 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for MaxFlow, specifying the algorithm and any
+/// parameters associated with it.
+class MaxFlowPlan : public Plan {
+public:
+  enum Algorithm { kSynchronousPushRelabel };
+
+  static constexpr double kDefaultGlobalRelabelInterval = 1.0;
+
+private:
+  Algorithm algorithm_;
+  double global_relabel_interval_;
+
+  MaxFlowPlan(
+      Architecture architecture, Algorithm algorithm,
+      double global_relabel_interval)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_interval_(global_relabel_interval) {}
+
+public:
+  MaxFlowPlan()
+      : MaxFlowPlan(
+            kCPU, kSynchronousPushRelabel, kDefaultGlobalRelabelInterval) {}
+
+  MaxFlowPlan& operator=(const MaxFlowPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The work of the rounds between global relabelings, as a multiple of
+  /// the work of a global relabeling
+  double global_relabel_interval() const { return global_relabel_interval_; }
+
+  /// Push-relabel in synchronous rounds: every round, each active node (a
+  /// node with excess flow that may still reach the sink) pushes its excess
+  /// along residual edges to nodes one label lower, and then the active
+  /// nodes that have excess left and no such edges are relabeled to one more
+  /// than their lowest residual neighbor, so the labels of a round are
+  /// consistent without locks. Labels are periodically recomputed exactly
+  /// by a parallel breadth first search back from the sink, and when no
+  /// node is left with some label, the nodes above it are deactivated (the
+  /// gap heuristic).
+  static MaxFlowPlan SynchronousPushRelabel(
+      double global_relabel_interval = kDefaultGlobalRelabelInterval) {
+    return {kCPU, kSynchronousPushRelabel, global_relabel_interval};
+  }
+};
+
+/// Compute the value of a maximum flow from source to sink along the edges
+/// of the graph, with the capacities of the edge property named
+/// edge_capacity_property_name, which must be of an integer type and not
+/// negative.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call. The created property has type uint8_t: it
+/// is 1 for the nodes on the source side of a minimum cut, the nodes that
+/// the sink cannot be reached from along edges with capacity left, and 0 for
+/// the others.
+KATANA_EXPORT Result<uint64_t> MaxFlow(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MaxFlowPlan plan = {});
+
+/// Check that the nodes of property_name are the sides of a cut between
+/// source and sink and that the cut has capacity flow, which makes it a
+/// minimum cut and flow a maximum flow.
+KATANA_EXPORT Result<void> MaxFlowAssertValid(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& property_name, uint64_t flow);
+
+struct KATANA_EXPORT MaxFlowStatistics {
+  /// The total capacity of the edges from the source side to the sink side.
+  uint64_t cut_capacity;
+  /// The number of edges from the source side to the sink side.
+  uint64_t cut_edges;
+  /// The number of nodes on the source side.
+  uint64_t source_side_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MaxFlowStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_capacity_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_METAPATH_METAPATH_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_METAPATH_METAPATH_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+
+// API
+
+namespace katana::analytics {
+
+/// One hop of a metapath: an edge of edge_type, followed to a node of
+/// node_type.
+struct MetapathStep {
+  /// The name of the atomic type of the edges followed
+  std::string edge_type;
+  /// The name of an atomic type the node reached must have; any node if
+  /// empty
+  std::string node_type;
+  /// Whether the edges are followed from destination to source, e.g., the
+  /// second hop of Author -writes-> Paper <-writes- Author
+  bool reverse = false;
+};
+
+/// A sequence of node and edge types, such as APA (Author, Paper, Author)
+/// or APVPA, whose instances are the paths of the graph that match it.
+struct Metapath {
+  /// The name of an atomic type the first node must have; any node if empty
+  std::string start_node_type;
+  std::vector<MetapathStep> steps;
+};
+
+/// Finds the instances of a metapath over the edge type aware view of a
+/// graph, where the edges of a node of any one edge type are a contiguous
+/// range found without scanning the others. Only edges whose type is exactly
+/// the edge type of a step are followed.
+///
+/// The graph must outlive the traversal and not change while it is used.
+class KATANA_EXPORT MetapathTraversal {
+public:
+  /// The nodes of one instance, from the start to the end of the metapath
+  using Instance = std::vector<uint32_t>;
+
+  /// Builds a traversal of metapath over pg, along with the view it needs.
+  /// Fails if a type of the metapath does not exist or it has no steps.
+  static katana::Result<MetapathTraversal> Make(
+      katana::PropertyGraph* pg, const Metapath& metapath);
+
+  /// Count the instances starting at every node into a uint64_t node
+  /// property named output_property_name, which must not exist before the
+  /// call. Every step is one parallel loop over the nodes, from the last to
+  /// the first step, so this costs as many scans of the edges of the types
+  /// of the metapath as it has steps.
+  katana::Result<void> CountInstances(
+      const std::string& output_property_name, katana::TxnContext* txn_ctx);
+
+  /// For every source, the nodes that end an instance starting at it and
+  /// the number of such instances, by node id, e.g., the co-authors of an
+  /// author and the number of papers they share for APA. Sources without
+  /// the start node type have none.
+  ///
+  /// Each source expands its frontier step by step on its own, and the
+  /// sources are processed in parallel.
+  katana::Result<std::vector<std::vector<std::pair<uint32_t, uint64_t>>>>
+  CountEndpoints(const std::vector<uint32_t>& sources) const;
+
+  /// Draw walks_per_source instances from every source, each picking an
+  /// edge of the next step uniformly among those reaching a node of the
+  /// right type. Walks reaching a node they cannot leave are dropped. The
+  /// instances are those of the first source first; they only depend on
+  /// seed, not on the number of threads.
+  katana::Result<std::vector<Instance>> Sample(
+      const std::vector<uint32_t>& sources, uint32_t walks_per_source,
+      uint64_t seed = 0) const;
+
+  /// All the instances starting at every source, but at most
+  /// max_instances_per_source of them each, in order of source and then of
+  /// the edges followed.
+  katana::Result<std::vector<Instance>> Materialize(
+      const std::vector<uint32_t>& sources,
+      uint64_t max_instances_per_source) const;
+
+private:
+  /// A step resolved to type ids
+  struct Step {
+    bool reverse;
+    /// Whether the graph has edges of the type; a type without edges is not
+    /// in the index of the view
+    bool edge_exists;
+    katana::EntityTypeID edge_type;
+    bool any_node_type;
+    katana::EntityTypeID node_type;
+  };
+
+  MetapathTraversal(
+      katana::PropertyGraph* pg, bool any_start_type,
+      katana::EntityTypeID start_type, std::vector<Step> steps)
+      : pg_(pg),
+        view_(pg->BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>()),
+        any_start_type_(any_start_type),
+        start_type_(start_type),
+        steps_(std::move(steps)) {}
+
+  katana::Result<void> CheckSources(
+      const std::vector<uint32_t>& sources) const;
+
+  /// Whether node n may be at position pos of an instance, 0 being the start
+  bool MatchesPosition(uint32_t n, size_t pos) const noexcept;
+
+  /// Calls f with the node at the other end of every edge of step from n,
+  /// whatever its type
+  template <typename F>
+  void ForEachNeighbor(uint32_t n, const Step& step, const F& f) const;
+
+  katana::PropertyGraph* pg_;
+  katana::PropertyGraphViews::EdgeTypeAwareBiDir view_;
+  bool any_start_type_;
+  katana::EntityTypeID start_type_;
+  std::vector<Step> steps_;
+};
+
+}  // namespace katana::analytics
+
+#endif
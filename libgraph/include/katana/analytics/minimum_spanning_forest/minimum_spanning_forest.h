@@ -0,0 +1,93 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/PropertyRequirements.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for MinimumSpanningForest, specifying the
+/// algorithm and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  /// Algorithm selectors for MinimumSpanningForest
+  enum Algorithm {
+    kBoruvka,
+  };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  MinimumSpanningForestPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan{kCPU, kBoruvka} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Bulk synchronous Boruvka. Every round, each tree of the forest picks
+  /// its lightest edge to another tree, and the trees are merged along
+  /// those edges with lock-free unions. Edges found inside a tree are
+  /// filtered out, so later rounds only look at the edges still between
+  /// trees.
+  static MinimumSpanningForestPlan Boruvka() { return {kCPU, kBoruvka}; }
+};
+
+/// The properties MinimumSpanningForest reads, which it loads if they are
+/// absent and keeps loaded while it runs: the edge weights.
+inline PropertyRequirements
+MinimumSpanningForestPropertyRequirements(
+    const std::string& edge_weight_property_name) {
+  return PropertyRequirements{}.AddEdgeProperty(edge_weight_property_name);
+}
+
+/// Compute a minimum spanning forest of pg, taken as an undirected graph:
+/// every edge joins its source and destination whatever its direction, so
+/// symmetric and directed graphs both work. Ties between edges of the same
+/// weight are broken by edge id, so the forest is unique. The weights are
+/// the edge property edge_weight_property_name, of any integral or floating
+/// point type, and must not be NaN.
+///
+/// The edges of the forest are marked 1, the others 0, in a uint8_t edge
+/// property named output_property_name, which is created by this function
+/// and may not exist before the call. Each undirected edge of the forest is
+/// marked on one of its copies only.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MinimumSpanningForestPlan plan = MinimumSpanningForestPlan());
+
+/// Check that the edges marked in property_name form a spanning forest of
+/// pg, without cycles and with a tree for each connected component, whose
+/// weight is that of the forest Kruskal's algorithm finds.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The sum of the weights of the edges of the forest.
+  double total_weight;
+  /// The number of edges in the forest.
+  uint64_t number_of_edges;
+  /// The number of trees in the forest, including single nodes.
+  uint64_t number_of_trees;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+#endif
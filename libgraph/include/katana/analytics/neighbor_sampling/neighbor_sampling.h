@@ -0,0 +1,185 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for neighbor sampling, specifying the algorithm
+/// and any parameters associated with it.
+class NeighborSamplingPlan : public Plan {
+public:
+  /// Algorithm selectors for neighbor sampling
+  enum Algorithm {
+    kFanout,
+    kLayerWise,
+  };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  NeighborSamplingPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  NeighborSamplingPlan() : NeighborSamplingPlan{kCPU, kFanout} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Node-wise sampling, as in GraphSAGE: at every hop, each node of the
+  /// layer draws its own sample of at most the fanout of its edges, and the
+  /// nodes at the other end of the drawn edges make up the next layer.
+  static NeighborSamplingPlan Fanout() { return {kCPU, kFanout}; }
+
+  /// Layer-wise sampling, as in FastGCN and LADIES: at every hop, the fanout
+  /// is the number of nodes drawn for the whole next layer among the
+  /// neighbors of the current one, in proportion to the weight of their
+  /// edges into it, and all the edges between the two layers are kept. The
+  /// layers then grow linearly rather than exponentially with the hops.
+  static NeighborSamplingPlan LayerWise() { return {kCPU, kLayerWise}; }
+};
+
+/// The fanouts of the edges of one edge type.
+struct NeighborSamplingEdgeTypeFanouts {
+  /// The name of the edge type
+  std::string edge_type;
+  /// The fanout of every hop
+  std::vector<uint32_t> fanouts;
+};
+
+/// What the sampler draws and gathers for every minibatch.
+struct NeighborSamplingOptions {
+  /// The fanout of every hop; the number of hops is its size. Ignored if
+  /// edge_type_fanouts is not empty.
+  std::vector<uint32_t> fanouts;
+  /// If not empty, every listed edge type is sampled on its own with its
+  /// fanouts, and the edges of the other types are never sampled. All the
+  /// lists must have the same number of hops.
+  std::vector<NeighborSamplingEdgeTypeFanouts> edge_type_fanouts;
+  /// If not empty, the edges are drawn in proportion to this edge property,
+  /// of any integral or floating point type, whose values must be finite
+  /// and not negative. Otherwise all the edges are alike.
+  std::string edge_weight_property_name;
+  /// The node properties gathered for the input nodes of every minibatch
+  std::vector<std::string> node_feature_properties;
+  /// Whether the messages flow along the out edges, from destination to
+  /// source, rather than along the in edges as in most GNN libraries
+  bool sample_out_edges = false;
+  /// Whether an edge may be drawn more than once by the same node, with the
+  /// fanout number of draws then made whatever the degree. Only used by the
+  /// fanout plan.
+  bool with_replacement = false;
+  /// The seed of the draws; the minibatches only depend on it, on the order
+  /// they are sampled in and on their seeds, not on the number of threads
+  uint64_t seed = 0;
+};
+
+/// The edges sampled at one hop, from the src nodes of the hop to its dst
+/// nodes, as a CSR of the dst nodes.
+struct KATANA_EXPORT SampledBlock {
+  /// The nodes whose neighbors were sampled, as node ids of the graph
+  std::vector<uint32_t> dst_nodes;
+  /// The nodes sampled as their neighbors: the dst nodes first, in the same
+  /// order, and then the new ones by id
+  std::vector<uint32_t> src_nodes;
+  /// The sampled edges of dst node i are offsets[i] to offsets[i + 1]
+  std::vector<uint64_t> offsets;
+  /// The index in src_nodes of the neighbor of every sampled edge
+  std::vector<uint32_t> indices;
+  /// The property index of every sampled edge in the graph, to gather edge
+  /// features or types
+  std::vector<uint64_t> edge_ids;
+};
+
+/// A sampled minibatch: the blocks of every hop and the features of the
+/// nodes of the last one.
+struct KATANA_EXPORT SampledMiniBatch {
+  /// blocks[h] is hop h: the dst nodes of blocks[0] are the seeds and those
+  /// of blocks[h + 1] are the src nodes of blocks[h]. A GNN of as many
+  /// layers runs the blocks from the last to the first.
+  std::vector<SampledBlock> blocks;
+  /// The node features, one column per property and one row per src node
+  /// of the last block; null if no feature is gathered
+  std::shared_ptr<arrow::Table> node_features;
+
+  /// The nodes whose features are the input of the GNN
+  const std::vector<uint32_t>& input_nodes() const {
+    return blocks.back().src_nodes;
+  }
+};
+
+/// Samples the neighborhoods of minibatches of seed nodes of a graph for GNN
+/// training, over the edge type aware view of the graph so that the edges
+/// of any one edge type are found directly.
+///
+/// The graph must outlive the sampler and not change while it is used.
+class KATANA_EXPORT NeighborSampler {
+public:
+  /// Builds a sampler for pg, along with the views and weights it needs.
+  static katana::Result<NeighborSampler> Make(
+      katana::PropertyGraph* pg, NeighborSamplingOptions options,
+      NeighborSamplingPlan plan = NeighborSamplingPlan());
+
+  /// Samples the minibatch of the given seeds, which must be distinct nodes
+  /// of the graph. The seeds are sampled in parallel.
+  katana::Result<SampledMiniBatch> Sample(const std::vector<uint32_t>& seeds);
+
+  /// Samples the minibatch of every list of seeds in turn and calls train
+  /// with it, on a thread of its own, so that the next minibatch is sampled
+  /// while train runs on the current one. The runtime does not support
+  /// parallel loops from two threads at once, so train must not start any;
+  /// a training step of another library is fine.
+  ///
+  /// Stops at the first error, either of sampling or of train.
+  katana::Result<void> Pipeline(
+      const std::vector<std::vector<uint32_t>>& batches,
+      const std::function<katana::Result<void>(SampledMiniBatch&&)>& train);
+
+  /// The number of minibatches sampled so far.
+  uint64_t num_batches() const { return num_batches_; }
+
+private:
+  /// The edges of one edge type, or of all of them, and their fanouts.
+  struct Relation {
+    bool all_types;
+    /// Whether the graph has edges of the type
+    bool exists;
+    katana::EntityTypeID edge_type;
+    std::vector<uint32_t> fanouts;
+  };
+
+  NeighborSampler(
+      katana::PropertyGraph* pg, NeighborSamplingOptions options,
+      NeighborSamplingPlan plan, std::vector<Relation> relations)
+      : pg_(pg),
+        view_(pg->BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>()),
+        options_(std::move(options)),
+        plan_(plan),
+        relations_(std::move(relations)) {}
+
+  katana::PropertyGraph* pg_;
+  katana::PropertyGraphViews::EdgeTypeAwareBiDir view_;
+  NeighborSamplingOptions options_;
+  NeighborSamplingPlan plan_;
+  std::vector<Relation> relations_;
+  /// The weight of every edge by property index; empty if unweighted
+  katana::NUMAArray<double> weights_;
+  uint64_t num_batches_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
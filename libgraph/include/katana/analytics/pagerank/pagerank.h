@@ -2,9 +2,14 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/TemporalView.h"
+#include "katana/analytics/Checkpoint.h"
 #include "katana/analytics/Plan.h"
 
 namespace katana::analytics {
@@ -18,11 +23,15 @@ public:
     kPullResidual,
     kPushSynchronous,
     kPushAsynchronous,
+    kPropagationBlocking,
   };
 
   static constexpr double kDefaultTolerance = 1.0e-3;
   static const int kDefaultMaxIterations = 1000;
   static constexpr double kDefaultAlpha = 0.85;
+  /// Tolerance for personalized PageRank, where each node starts out with a
+  /// share of a single unit of initial residual rather than a unit of its own
+  static constexpr double kDefaultPersonalizedTolerance = 1.0e-6;
 
 private:
   Algorithm algorithm_;
@@ -103,15 +112,110 @@ public:
       float alpha = kDefaultAlpha) {
     return {kCPU, kPushSynchronous, tolerance, max_iterations, alpha};
   }
+
+  /// Propagation blocking algorithm
+  ///
+  /// Each iteration first scatters the contribution of every node into bins
+  /// by the block of its destination and then adds up the bins one block at
+  /// a time, so that the random writes of a pull or push iteration become
+  /// sequential streams and the sums being written fit in the last level
+  /// cache. The graph need not be transposed.
+  ///
+  /// BEAMER, Scott; ASANOVIC, Krste; PATTERSON, David. Reducing pagerank
+  /// communication via propagation blocking. In: IEEE International Parallel
+  /// and Distributed Processing Symposium (IPDPS). IEEE, 2017. p. 820-831.
+  static PagerankPlan PropagationBlocking(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kCPU, kPropagationBlocking, tolerance, max_iterations, alpha};
+  }
+
+  /// The iteration of the topological algorithm on the GPU, pushing the
+  /// contributions along out edges so the graph need not be transposed.
+  /// Needs the GPU analytics plugin; see GpuAnalytics.
+  static PagerankPlan Gpu(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kGPU, kPushSynchronous, tolerance, max_iterations, alpha};
+  }
 };
 
 /// Compute the Page Rank of each node in the graph.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
+///
+/// If checkpoint is enabled, the topological pull algorithm checkpoints the
+/// ranks every checkpoint.interval iterations and starts from the last
+/// checkpoint of a run with the same tolerance and alpha on the same graph,
+/// if there is one; max_iterations then counts the iterations before it too.
+/// The other algorithms do not support checkpoints.
 KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, PagerankPlan plan = {},
+    const CheckpointOptions& checkpoint = {});
+
+/// Compute the Page Rank of each node in the graph made of the edges of
+/// window, as the topological pull algorithm does, with out degrees counting
+/// only the edges in the window. The window must be a transposed
+/// TemporalView. Only the tolerance, maximum iterations and alpha of the plan
+/// are used. The property named output_property_name is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> WindowedPagerank(
+    PropertyGraph* pg, const TemporalView& window,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PagerankPlan plan = PagerankPlan::PullTopological());
+
+/// Update the Page Rank of each node after a batch of edge changes, starting
+/// from the ranks in the property named previous_property_name computed
+/// before the changes (by any algorithm) instead of from scratch. pg is the
+/// graph after the changes; inserted_edges and deleted_edges are the (source,
+/// destination) pairs of the edges the batch added and removed.
+///
+/// Only the out neighbors of sources of changed edges get residuals, which
+/// the asynchronous push algorithm then converges, so small batches cost a
+/// fraction of a full run. The plan supplies the tolerance and alpha, which
+/// should match those of the previous run. The property named
+/// output_property_name is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> PagerankIncremental(
+    PropertyGraph* pg, const std::string& previous_property_name,
+    const std::string& output_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges,
     katana::TxnContext* txn_ctx, PagerankPlan plan = {});
 
+/// Compute the personalized Page Rank of each node in the graph with respect
+/// to the seed nodes: the probability that a random walk, which starts at a
+/// seed picked uniformly at random and at each step jumps back to it with
+/// probability 1 - alpha, is at the node. Walks end at nodes without out
+/// edges.
+///
+/// Only the push algorithms are supported; they start from the seeds alone,
+/// so the work depends on the tolerance rather than the size of the graph.
+/// The tolerance must be well below initial_residual() / seeds.size().
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PagerankPlan plan = PagerankPlan::PushAsynchronous(
+        PagerankPlan::kDefaultPersonalizedTolerance));
+
+/// Compute, for each seed on its own, the k nodes of highest personalized
+/// Page Rank with respect to it (the seed included), as (node, rank) pairs in
+/// decreasing order of rank.
+///
+/// All seeds are processed in one parallel loop, where each seed runs a
+/// serial forward push that keeps its residuals and ranks in sparse maps. The
+/// plan supplies the tolerance and alpha and must be a push plan.
+KATANA_EXPORT Result<std::vector<std::vector<std::pair<uint32_t, float>>>>
+PersonalizedPagerankTopK(
+    PropertyGraph* pg, const std::vector<uint32_t>& seeds, size_t k,
+    PagerankPlan plan = PagerankPlan::PushAsynchronous(
+        PagerankPlan::kDefaultPersonalizedTolerance));
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
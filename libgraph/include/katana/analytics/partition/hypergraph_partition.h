@@ -0,0 +1,154 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PARTITION_HYPERGRAPHPARTITION_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PARTITION_HYPERGRAPHPARTITION_H_
+
+#include <iostream>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/analytics/Plan.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// A hypergraph of nodes [0, num_nodes): hyperedge h connects the nodes
+/// pins[offsets[h], offsets[h + 1]).
+struct KATANA_EXPORT Hypergraph {
+  uint32_t num_nodes{0};
+  std::vector<uint64_t> offsets{0};
+  std::vector<uint32_t> pins;
+  /// The weight of each hyperedge, or empty if they all weigh 1
+  std::vector<uint64_t> hedge_weights;
+  /// The weight of each node, or empty if they all weigh 1
+  std::vector<uint64_t> node_weights;
+
+  uint64_t NumHedges() const { return offsets.size() - 1; }
+
+  /// Add a hyperedge of weight 1 connecting nodes
+  void AddHedge(const std::vector<uint32_t>& nodes) {
+    pins.insert(pins.end(), nodes.begin(), nodes.end());
+    offsets.emplace_back(pins.size());
+  }
+};
+
+/// A computational plan for PartitionHypergraph, specifying the objective,
+/// the algorithm and any parameters associated with them.
+class HypergraphPartitionPlan : public Plan {
+public:
+  enum Algorithm { kMultilevelKWay };
+
+  enum Objective {
+    /// The total weight of the hyperedges with nodes in more than one
+    /// partition
+    kCut,
+    /// The total over the hyperedges of their weight times the number of
+    /// partitions that they have nodes in, less one
+    kConnectivity,
+  };
+
+  static constexpr double kDefaultImbalance = 0.03;
+  static const uint32_t kDefaultCoarseningLimit = 40;
+  static const uint32_t kDefaultRefinementRounds = 10;
+  static const uint32_t kDefaultInitialTries = 8;
+
+private:
+  Algorithm algorithm_;
+  Objective objective_;
+  double imbalance_;
+  uint32_t coarsening_limit_;
+  uint32_t refinement_rounds_;
+  uint32_t initial_tries_;
+
+  HypergraphPartitionPlan(
+      Architecture architecture, Algorithm algorithm, Objective objective,
+      double imbalance, uint32_t coarsening_limit, uint32_t refinement_rounds,
+      uint32_t initial_tries)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        objective_(objective),
+        imbalance_(imbalance),
+        coarsening_limit_(coarsening_limit),
+        refinement_rounds_(refinement_rounds),
+        initial_tries_(initial_tries) {}
+
+public:
+  HypergraphPartitionPlan()
+      : HypergraphPartitionPlan(
+            kCPU, kMultilevelKWay, kConnectivity, kDefaultImbalance,
+            kDefaultCoarseningLimit, kDefaultRefinementRounds,
+            kDefaultInitialTries) {}
+
+  HypergraphPartitionPlan& operator=(const HypergraphPartitionPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  Objective objective() const { return objective_; }
+  /// The fraction by which the weight of a partition may exceed an even
+  /// share
+  double imbalance() const { return imbalance_; }
+  /// Nodes per partition at which coarsening stops
+  uint32_t coarsening_limit() const { return coarsening_limit_; }
+  /// Rounds of refinement at each level
+  uint32_t refinement_rounds() const { return refinement_rounds_; }
+  /// Initial partitions of the coarsest hypergraph tried, of which the best
+  /// is kept
+  uint32_t initial_tries() const { return initial_tries_; }
+
+  /// Direct k-way multilevel partitioning. The hypergraph is coarsened by
+  /// matching each node with the neighbor it shares the most hyperedge
+  /// weight with, each hyperedge counting in inverse proportion to its
+  /// size, in rounds of mutual proposals; identical hyperedges of a coarse
+  /// level are merged. The coarsest hypergraph is partitioned k ways
+  /// initial_tries times in parallel, each by filling the partitions in
+  /// turn in breadth first order from a different seed and refining, and
+  /// the best is projected back a level at a time and refined for the
+  /// objective: every round, the nodes that improve it move to the
+  /// partition of most gain, those of the most gain first while there is
+  /// room, and a round that makes the objective worse is undone.
+  static HypergraphPartitionPlan MultilevelKWay(
+      Objective objective = kConnectivity,
+      double imbalance = kDefaultImbalance,
+      uint32_t coarsening_limit = kDefaultCoarseningLimit,
+      uint32_t refinement_rounds = kDefaultRefinementRounds,
+      uint32_t initial_tries = kDefaultInitialTries) {
+    return {
+        kCPU,
+        kMultilevelKWay,
+        objective,
+        imbalance,
+        coarsening_limit,
+        refinement_rounds,
+        initial_tries};
+  }
+};
+
+/// Partition the nodes of the hypergraph into num_partitions partitions of
+/// weights within imbalance of each other, minimizing the objective of the
+/// plan. (*partitions)[n] is set to the partition of node n.
+KATANA_EXPORT Result<void> PartitionHypergraph(
+    const Hypergraph& hypergraph, uint32_t num_partitions,
+    std::vector<uint32_t>* partitions, HypergraphPartitionPlan plan = {});
+
+struct KATANA_EXPORT HypergraphPartitionStatistics {
+  /// The total weight of the hyperedges with nodes in more than one
+  /// partition.
+  uint64_t cut;
+  /// The total over the hyperedges of their weight times the number of
+  /// partitions that they have nodes in, less one.
+  uint64_t connectivity;
+  /// The weight of the heaviest partition.
+  uint64_t largest_partition_weight;
+  /// The fraction by which the heaviest partition is heavier than an even
+  /// share.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<HypergraphPartitionStatistics> Compute(
+      const Hypergraph& hypergraph, uint32_t num_partitions,
+      const std::vector<uint32_t>& partitions);
+};
+
+}  // namespace katana::analytics
+
+#endif
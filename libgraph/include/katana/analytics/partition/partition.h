@@ -0,0 +1,123 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "katana/PartitionMetadata.h"
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for Partition, specifying the algorithm and any
+/// parameters associated with it.
+class PartitionPlan : public Plan {
+public:
+  enum Algorithm { kMultilevel };
+
+  static constexpr double kDefaultImbalance = 0.03;
+  static const uint32_t kDefaultCoarseningLimit = 30;
+  static const uint32_t kDefaultRefinementRounds = 10;
+
+private:
+  Algorithm algorithm_;
+  double imbalance_;
+  uint32_t coarsening_limit_;
+  uint32_t refinement_rounds_;
+
+  PartitionPlan(
+      Architecture architecture, Algorithm algorithm, double imbalance,
+      uint32_t coarsening_limit, uint32_t refinement_rounds)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        imbalance_(imbalance),
+        coarsening_limit_(coarsening_limit),
+        refinement_rounds_(refinement_rounds) {}
+
+public:
+  PartitionPlan()
+      : PartitionPlan(
+            kCPU, kMultilevel, kDefaultImbalance, kDefaultCoarseningLimit,
+            kDefaultRefinementRounds) {}
+
+  PartitionPlan& operator=(const PartitionPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The fraction by which a partition may be larger than an even share
+  double imbalance() const { return imbalance_; }
+  /// Nodes per partition at which coarsening stops
+  uint32_t coarsening_limit() const { return coarsening_limit_; }
+  /// Rounds of refinement at each level
+  uint32_t refinement_rounds() const { return refinement_rounds_; }
+
+  /// Multilevel partitioning, like METIS: the graph is coarsened by merging
+  /// the nodes of heavy edge matchings, found in rounds of mutual proposals,
+  /// until it has coarsening_limit nodes per partition. The coarsest graph
+  /// is partitioned by recursive bisection, each half grown greedily from
+  /// the best of a few seeds, and the partition is projected back a level
+  /// at a time, rebalanced and refined by label propagation: every round,
+  /// the nodes with a positive gain move to the neighboring partition they
+  /// are most connected to, in order of gain while there is room, to higher
+  /// partitions on even rounds and to lower ones on odd rounds so that no
+  /// two neighbors trade places.
+  static PartitionPlan Multilevel(
+      double imbalance = kDefaultImbalance,
+      uint32_t coarsening_limit = kDefaultCoarseningLimit,
+      uint32_t refinement_rounds = kDefaultRefinementRounds) {
+    return {
+        kCPU, kMultilevel, imbalance, coarsening_limit, refinement_rounds};
+  }
+};
+
+/// Partition the nodes of the graph into num_partitions partitions with node
+/// counts within imbalance of each other and few edges between them. The
+/// edges are taken either way, so the graph need not be symmetric.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PartitionPlan plan = {});
+
+KATANA_EXPORT Result<void> PartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name);
+
+struct KATANA_EXPORT PartitionStatistics {
+  /// The number of edges between nodes of different partitions.
+  uint64_t edge_cut;
+  /// The number of nodes of the largest partition.
+  uint64_t largest_partition_size;
+  /// The number of nodes of the smallest partition.
+  uint64_t smallest_partition_size;
+  /// The fraction by which the largest partition is larger than an even
+  /// share.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<PartitionStatistics> Compute(
+      katana::PropertyGraph* pg, uint32_t num_partitions,
+      const std::string& property_name);
+};
+
+/// Renumber the nodes of the graph so that those of each partition of the
+/// property property_name are contiguous, partition 0 first, keeping their
+/// order within a partition, which keeps the edges of a partition close
+/// together. The new graph has the properties and types of the old one.
+///
+/// If metadata is not null, (*metadata)[p] is set to describe partition p as
+/// a host of an outgoing edge cut of the new graph: its owned nodes are its
+/// partition and the other nodes that they have edges to are its mirrors.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> RenumberByPartition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name, katana::TxnContext* txn_ctx,
+    std::vector<katana::PartitionMetadata>* metadata = nullptr);
+
+}  // namespace katana::analytics
+
+#endif
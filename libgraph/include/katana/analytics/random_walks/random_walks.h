@@ -2,7 +2,11 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include <arrow/array.h>
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
@@ -113,7 +117,9 @@ public:
   }
 
   /// Edge2Vec algorithm to generate random walks on the graph.
-  /// Takes the heterogeneity of the edges into account
+  /// Takes the heterogeneity of the edges into account: the types are the
+  /// entity types of the edges, whose ids must be at most
+  /// number_of_edge_types
   static RandomWalksPlan Edge2Vec(
       uint32_t walk_length = kDefaultWalkLength,
       uint32_t number_of_walks = kDefaultNumberOfWalks,
@@ -123,7 +129,7 @@ public:
       uint32_t number_of_edge_types = kDefaultNumberOfEdgeTypes) {
     return {
         kCPU,
-        kNode2Vec,
+        kEdge2Vec,
         walk_length,
         number_of_walks,
         backward_probability,
@@ -140,6 +146,39 @@ public:
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Compute weighted random-walks for pg with the Node2Vec plan: a walk moves
+/// along an out edge with probability proportional to its weight in the
+/// property named edge_weight_property_name (which may be a 32- or 64-bit
+/// signed or unsigned int, or a float or double, and must not be negative),
+/// times the backward and forward biases of the plan. With the default
+/// biases the walks are first order. The edges are sampled from alias
+/// tables built once for the whole graph.
+KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// Compute the random-walks for pg like RandomWalks, weighted by the edge
+/// property named edge_weight_property_name unless it is empty, packed into
+/// one list array of uint32 node ids. The walks are written straight into
+/// its buffers, without an allocation per walk, and are in order of walk:
+/// the first walk of every node in order of node, then the second, and so
+/// on, unless the plan is Edge2Vec. Nodes without edges start no walk.
+KATANA_EXPORT Result<std::shared_ptr<arrow::LargeListArray>>
+RandomWalksCompact(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// Compute the Node2Vec random-walks for pg, weighted like RandomWalksCompact,
+/// and write them to the parquet file at path, as a column "walk" of lists
+/// of uint32 node ids. The walks are generated walks_per_batch at a time
+/// and each batch is written before the next, so that only one batch is in
+/// memory at once. Returns the number of walks written.
+KATANA_EXPORT Result<uint64_t> RandomWalksToParquet(
+    PropertyGraph* pg, const std::string& path,
+    const std::string& edge_weight_property_name,
+    RandomWalksPlan plan = RandomWalksPlan(),
+    uint64_t walks_per_batch = uint64_t{1} << 22);
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
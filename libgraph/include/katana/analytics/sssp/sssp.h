@@ -2,9 +2,14 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/PropertyRequirements.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -19,6 +24,7 @@ public:
     kDeltaStep,
     kDeltaStepBarrier,
     kDeltaStepFusion,
+    kDeltaStepMultiQueue,
     // TODO(gill): Do we want to expose serial implementations at all?
     kSerialDeltaTile,
     kSerialDelta,
@@ -27,10 +33,18 @@ public:
     kTopological,
     kTopologicalTile,
     kAutomatic,
+    kRadiusStep,
   };
 
   static const int kDefaultDelta = 13;
   static const int kDefaultEdgeTileSize = 512;
+  static const unsigned kDefaultRadiusNeighbors = 4;
+  /// The largest number of neighbors a radius stepping radius may cover
+  static const unsigned kMaxRadiusNeighbors = 64;
+
+  /// Passed as the delta of a delta stepping plan, has the delta chosen at
+  /// run time from a sample of the edge weights and the average degree
+  static const unsigned kAutomaticDelta = std::numeric_limits<unsigned>::max();
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -38,6 +52,7 @@ private:
   Algorithm algorithm_;
   unsigned delta_;
   ptrdiff_t edge_tile_size_;
+  unsigned radius_neighbors_;
   // TODO: should chunk_size be in the plan? Or fixed?
   //  It cannot be in the plan currently because it is a template parameter and
   //  cannot be easily changed since the value is statically passed on to
@@ -46,11 +61,12 @@ private:
 
   SsspPlan(
       Architecture architecture, Algorithm algorithm, unsigned delta,
-      ptrdiff_t edge_tile_size)
+      ptrdiff_t edge_tile_size, unsigned radius_neighbors = 0)
       : Plan(architecture),
         algorithm_(algorithm),
         delta_(delta),
-        edge_tile_size_(edge_tile_size) {}
+        edge_tile_size_(edge_tile_size),
+        radius_neighbors_(radius_neighbors) {}
 
 public:
   SsspPlan() : SsspPlan{kCPU, kAutomatic, 0, 0} {}
@@ -58,17 +74,21 @@ public:
   SsspPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
     bool isPowerLaw = IsApproximateDegreeDistributionPowerLaw(*pg);
     if (isPowerLaw) {
-      *this = DeltaStep();
+      *this = DeltaStep(kAutomaticDelta);
     } else {
-      *this = DeltaStepBarrier();
+      *this = DeltaStepBarrier(kAutomaticDelta);
     }
   }
 
   Algorithm algorithm() const { return algorithm_; }
 
   /// The exponent of the delta step size (2 based). A delta of 4 will produce a real delta step size of 16.
+  /// kAutomaticDelta if it is chosen at run time.
   unsigned delta() const { return delta_; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+  /// The number of nearest neighbors of a node its radius covers in radius
+  /// stepping
+  unsigned radius_neighbors() const { return radius_neighbors_; }
 
   static SsspPlan DeltaTile(
       unsigned delta = kDefaultDelta,
@@ -88,6 +108,12 @@ public:
     return {kCPU, kDeltaStepFusion, delta, 0};
   }
 
+  /// Delta stepping with a MultiQueue instead of OrderedByIntegerMetric as
+  /// the worklist, which scales better to many threads
+  static SsspPlan DeltaStepMultiQueue(unsigned delta = kDefaultDelta) {
+    return {kCPU, kDeltaStepMultiQueue, delta, 0};
+  }
+
   static SsspPlan SerialDeltaTile(
       unsigned delta = kDefaultDelta,
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
@@ -111,8 +137,29 @@ public:
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
     return {kCPU, kTopologicalTile, 0, edge_tile_size};
   }
+
+  /// Radius stepping (Blelloch et al., SPAA 2016): each round settles all
+  /// nodes up to the least distance plus radius of the nodes left, where the
+  /// radius of a node is the weight of its radius_neighbors-th lightest out
+  /// edge, by Bellman-Ford substeps restricted to that bound. Larger radii
+  /// mean fewer rounds but more relaxations of nodes that are not yet final.
+  static SsspPlan RadiusStep(
+      unsigned radius_neighbors = kDefaultRadiusNeighbors) {
+    return {kCPU, kRadiusStep, 0, 0, radius_neighbors};
+  }
+
+  /// Bellman-Ford over a frontier of the nodes whose distance changed, on
+  /// the GPU, which needs the GPU analytics plugin; see GpuAnalytics
+  static SsspPlan Gpu() { return {kGPU, kAutomatic, 0, 0}; }
 };
 
+/// The properties Sssp reads, which it loads if they are absent and keeps
+/// loaded while it runs: the edge weights.
+inline PropertyRequirements
+SsspPropertyRequirements(const std::string& edge_weight_property_name) {
+  return PropertyRequirements{}.AddEdgeProperty(edge_weight_property_name);
+}
+
 /// Compute the Single-Source Shortest Path for pg starting from start_node.
 /// The edge weights are taken from the property named
 /// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
@@ -127,6 +174,20 @@ KATANA_EXPORT Result<void> Sssp(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     SsspPlan plan = {});
 
+/// Compute the length of the shortest path from s to t for every (s, t) in
+/// queries; it is infinity if t cannot be reached from s. Each query runs a
+/// bidirectional search, forward from s along out edges and backward from t
+/// along in edges, which stops as soon as no shorter path can be left, and
+/// the queries run in parallel. The edge weights are taken from the property
+/// named edge_weight_property_name (which must be non-negative), or every
+/// edge has length 1 if it is empty, in which case the searches are breadth
+/// first. Each thread keeps two distance arrays over all nodes for the
+/// duration of the call.
+KATANA_EXPORT Result<std::vector<double>> SsspPointToPoint(
+    PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::string& edge_weight_property_name = "");
+
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
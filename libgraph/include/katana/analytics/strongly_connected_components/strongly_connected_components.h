@@ -0,0 +1,100 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for StronglyConnectedComponents, specifying the
+/// algorithm and any parameters associated with it.
+class StronglyConnectedComponentsPlan : public Plan {
+public:
+  /// Algorithm selectors for Strongly-connected-components
+  enum Algorithm {
+    kTrimFWBW,
+    kColoring,
+  };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  StronglyConnectedComponentsPlan(
+      Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  // kChunkSize is a fixed const int (default value: 64)
+  static const int kChunkSize;
+
+  StronglyConnectedComponentsPlan()
+      : StronglyConnectedComponentsPlan{kCPU, kColoring} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Forward-backward with trimming. The nodes without in or out edges are
+  /// their own components and are trimmed, repeatedly. Then the nodes both
+  /// reachable from and reaching a pivot of high degree form its component,
+  /// and the nodes reachable only one way or neither way are three parts
+  /// that are decomposed the same way, all parts at once.
+  /// [1] L. Fleischer, B. Hendrickson and A. Pinar, "On Identifying Strongly
+  /// Connected Components in Parallel," IPDPS Workshops, 2000.
+  static StronglyConnectedComponentsPlan TrimFWBW() {
+    return {kCPU, kTrimFWBW};
+  }
+
+  /// Multistep: trimming and one forward-backward step, which usually finds
+  /// the largest component, and then coloring for the many small
+  /// components left. Coloring propagates the largest node id forward to
+  /// every node; the nodes of a color that reach the node of that id
+  /// backward form its component.
+  /// [1] G. M. Slota, S. Rajamanickam and K. Madduri, "BFS and Coloring-Based
+  /// Parallel Algorithms for Strongly Connected Components and Related
+  /// Problems," IPDPS, 2014.
+  static StronglyConnectedComponentsPlan Coloring() {
+    return {kCPU, kColoring};
+  }
+};
+
+/// Compute the strongly connected components of the directed graph pg. The
+/// component of every node is stored as the least node id in the component,
+/// in a uint64_t property named output_property_name, which is created by
+/// this function and may not exist before the call.
+KATANA_EXPORT Result<void> StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx,
+    StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan());
+
+/// Check that the components in property_name are the strongly connected
+/// components of pg: each is identified by its least node, each is strongly
+/// connected and the edges between them form no cycle.
+KATANA_EXPORT Result<void> StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT StronglyConnectedComponentsStatistics {
+  /// Total number of unique components in the graph.
+  uint64_t total_components;
+  /// Total number of components with more than 1 node.
+  uint64_t total_non_trivial_components;
+  /// The number of nodes present in the largest component.
+  uint64_t largest_component_size;
+  /// The ratio of nodes present in the largest component.
+  double largest_component_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<StronglyConnectedComponentsStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+#endif
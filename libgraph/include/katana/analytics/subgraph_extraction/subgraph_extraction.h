@@ -1,6 +1,10 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -42,6 +46,19 @@ public:
   static SubGraphExtractionPlan NodeSet() { return {kCPU, kNodeSet}; }
 };
 
+/// What an extracted sub-graph keeps of the original graph besides the
+/// topology between its nodes and the types of its nodes and edges.
+struct SubGraphProjection {
+  /// Node properties copied into the sub-graph
+  std::vector<std::string> node_properties;
+  /// Edge properties copied into the sub-graph
+  std::vector<std::string> edge_properties;
+  /// If not empty, only the nodes with one of these types are kept
+  std::vector<std::string> node_types;
+  /// If not empty, only the edges with one of these types are kept
+  std::vector<std::string> edge_types;
+};
+
 /**
  * Construct a new sub-graph from the original graph.
  *
@@ -57,7 +74,50 @@ SubGraphExtraction(
     katana::PropertyGraph* pg,
     const std::vector<katana::PropertyGraph::Node>& node_vec,
     SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+
+/**
+ * Construct a new sub-graph from the original graph, with the properties
+ * and only the types of the projection.
+ *
+ * Node i of the sub-graph is the i-th node of node_vec that has one of the
+ * node types, once duplicates are removed. The properties are copied in
+ * parallel, one column at a time, and the topology and type arrays are
+ * built in place, so the sub-graph is independent of the original graph.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param projection The properties to copy and the types to keep
+ * @param txn_ctx The transaction the properties are added in
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    const SubGraphProjection& projection, katana::TxnContext* txn_ctx,
+    SubGraphExtractionPlan plan = {});
+
+/**
+ * Construct the sub-graph of the nodes at most hops out edges away from the
+ * seeds, for instance the ego-net of a node of a symmetric graph, walking
+ * only over the edges and to the nodes with the types of the projection.
+ *
+ * The seeds come first, in their order, and then the nodes of every hop, by
+ * id. Otherwise the sub-graph is as SubGraphExtraction builds it.
+ *
+ * @param pg The graph to process.
+ * @param seeds The node IDs to expand from
+ * @param hops The number of hops to expand
+ * @param projection The properties to copy and the types to keep
+ * @param txn_ctx The transaction the properties are added in
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtractionKHop(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& seeds, uint32_t hops,
+    const SubGraphProjection& projection, katana::TxnContext* txn_ctx,
+    SubGraphExtractionPlan plan = {});
 
 }  // namespace katana::analytics
 
@@ -0,0 +1,75 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SUBGRAPHMATCHING_SUBGRAPHMATCHING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_SUBGRAPHMATCHING_SUBGRAPHMATCHING_H_
+
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+
+// API
+
+namespace katana::analytics {
+
+/// An edge of a SubgraphPattern. Pattern edges are undirected, like the
+/// edges of the symmetric graphs patterns are matched in; a typed edge is
+/// matched by an edge of that type from the match of src to the match of dst.
+struct PatternEdge {
+  uint32_t src;
+  uint32_t dst;
+  /// The edge type of the matching edge; empty for any edge
+  std::string type;
+};
+
+/// A small connected pattern graph, e.g., a 4-cycle or a typed motif.
+struct KATANA_EXPORT SubgraphPattern {
+  static constexpr uint32_t kMaxNodes = 8;
+
+  uint32_t num_nodes{0};
+  /// The node type of the match of each pattern node, with empty strings for
+  /// any node; empty if no pattern node is typed
+  std::vector<std::string> node_types;
+  std::vector<PatternEdge> edges;
+
+  /// The complete graph on k nodes; Clique(3) is the triangle
+  static SubgraphPattern Clique(uint32_t k);
+  /// The cycle on k nodes
+  static SubgraphPattern Cycle(uint32_t k);
+  /// The path on k nodes
+  static SubgraphPattern Path(uint32_t k);
+};
+
+/**
+ * Count the subgraphs of pg that are copies of pattern, i.e., the sets of
+ * edges that the edges of pattern map to under a one to one mapping of its
+ * nodes to nodes of pg that keeps their types. Copies need not be induced:
+ * a 4-clique contains three 4-cycles. The graph must be symmetric and free
+ * of parallel edges, as for TriangleCount.
+ *
+ * Matches are found by a worst case optimal join (generic join) over the
+ * adjacency lists of the graph sorted by destination: the candidates for a
+ * pattern node are the intersection of the neighbors of the matches of its
+ * pattern neighbors. The automorphisms of the pattern are broken by ordering
+ * the ids of symmetric matches, so that each copy is found once.
+ *
+ * @param pg The graph to search.
+ * @param pattern A connected pattern of 2 to SubgraphPattern::kMaxNodes nodes.
+ */
+KATANA_EXPORT katana::Result<uint64_t> CountSubgraphMatches(
+    PropertyGraph* pg, const SubgraphPattern& pattern);
+
+/**
+ * Find the copies of pattern counted by CountSubgraphMatches. Each match is
+ * pattern.num_nodes consecutive node ids, the match of pattern node i
+ * first, in no particular order of matches.
+ *
+ * @param pg The graph to search.
+ * @param pattern A connected pattern of 2 to SubgraphPattern::kMaxNodes nodes.
+ * @param max_matches Stop after this many matches; 0 for all of them.
+ */
+KATANA_EXPORT katana::Result<std::vector<uint32_t>> FindSubgraphMatches(
+    PropertyGraph* pg, const SubgraphPattern& pattern,
+    uint64_t max_matches = 0);
+
+}  // namespace katana::analytics
+
+#endif
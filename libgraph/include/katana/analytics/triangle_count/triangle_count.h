@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 
+#include <string>
+
+#include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -15,6 +18,7 @@ public:
     kNodeIteration,
     kEdgeIteration,
     kOrderedCount,
+    kApproximate,
   };
 
   enum Relabeling {
@@ -25,28 +29,38 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgeSorted = false;
+  static const bool kDefaultHubBitmaps = false;
+  static constexpr double kDefaultRelativeError = 0.05;
 
 private:
   Algorithm algorithm_;
   Relabeling relabeling_;
   bool edges_sorted_;
+  bool hub_bitmaps_;
+  double relative_error_;
 
   TriangleCountPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, bool hub_bitmaps,
+      double relative_error = kDefaultRelativeError)
       : Plan(architecture),
         algorithm_(algorithm),
         relabeling_(relabeling),
-        edges_sorted_(edges_sorted) {}
+        edges_sorted_(edges_sorted),
+        hub_bitmaps_(hub_bitmaps),
+        relative_error_(relative_error) {}
 
 public:
   TriangleCountPlan()
       : TriangleCountPlan{
-            kCPU, kOrderedCount, kDefaultEdgeSorted, kDefaultRelabeling} {}
+            kCPU, kOrderedCount, kDefaultEdgeSorted, kDefaultRelabeling,
+            kDefaultHubBitmaps} {}
 
   Algorithm algorithm() const { return algorithm_; }
   Relabeling relabeling() const { return relabeling_; }
   bool edges_sorted() const { return edges_sorted_; }
+  bool hub_bitmaps() const { return hub_bitmaps_; }
+  double relative_error() const { return relative_error_; }
 
   /**
    * The node-iterator algorithm from the following:
@@ -55,11 +69,13 @@ public:
    *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmaps Intersect with adjacency bitmaps of high degree nodes.
    */
   static TriangleCountPlan NodeIteration(
       bool edges_sorted = kDefaultEdgeSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kNodeIteration, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      bool hub_bitmaps = kDefaultHubBitmaps) {
+    return {kCPU, kNodeIteration, edges_sorted, relabeling, hub_bitmaps};
   }
 
   /**
@@ -69,11 +85,13 @@ public:
    *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmaps Intersect with adjacency bitmaps of high degree nodes.
    */
   static TriangleCountPlan EdgeIteration(
       bool edges_sorted = kDefaultEdgeSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kEdgeIteration, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      bool hub_bitmaps = kDefaultHubBitmaps) {
+    return {kCPU, kEdgeIteration, edges_sorted, relabeling, hub_bitmaps};
   }
 
   /**
@@ -84,11 +102,46 @@ public:
    *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmaps Intersect with adjacency bitmaps of high degree nodes.
    */
   static TriangleCountPlan OrderedCount(
       bool edges_sorted = kDefaultEdgeSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kOrderedCount, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      bool hub_bitmaps = kDefaultHubBitmaps) {
+    return {kCPU, kOrderedCount, edges_sorted, relabeling, hub_bitmaps};
+  }
+
+  /**
+   * Estimate the count from the triangles whose nodes all have the same of C
+   * random colors, and so which only use the 1/C of the edges between nodes
+   * of the same color, from the following:
+   *   Rasmus Pagh and Charalampos E. Tsourakakis. Colorful Triangle Counting
+   *   and a MapReduce Implementation. Information Processing Letters 112(7).
+   *   2012.
+   *
+   * Runs on the unsorted topology of the graph and only copies the sampled
+   * edges. C starts large and is lowered until enough triangles are sampled
+   * for the estimate to have about the given relative standard error; at
+   * C = 1 the count is exact.
+   *
+   * @param relative_error Target relative standard error of the estimate, or
+   *     0 for an exact count.
+   */
+  static TriangleCountPlan Approximate(
+      double relative_error = kDefaultRelativeError) {
+    return {
+        kCPU,       kApproximate,       kDefaultEdgeSorted,
+        kNoRelabel, kDefaultHubBitmaps, relative_error};
+  }
+
+  /**
+   * The ordered count on the GPU, which intersects the sorted adjacency
+   * lists of the nodes sorted by degree. Needs the GPU analytics plugin; see
+   * GpuAnalytics.
+   */
+  static TriangleCountPlan Gpu() {
+    return {
+        kGPU, kOrderedCount, kDefaultEdgeSorted, kRelabel, kDefaultHubBitmaps};
   }
 };
 
@@ -104,6 +157,27 @@ public:
 KATANA_EXPORT katana::Result<uint64_t> TriangleCount(
     PropertyGraph* pg, TriangleCountPlan plan = {});
 
+/// The tag for the output property of TriangleCountLocal in PropertyGraphs.
+using TriangleCountLocalCount = katana::PODProperty<uint64_t>;
+
+/**
+ * Count the triangles at every node of the graph and store the counts in a
+ * property named output_property_name, which may not exist before the call.
+ * The graph must be symmetric! Only the approximate plan is supported; the
+ * relative error of the counts of nodes in few triangles is much larger than
+ * that of the total.
+ *
+ * @param pg The graph to process.
+ * @param output_property_name The node property to create.
+ * @param txn_ctx
+ * @param plan
+ * @return The (estimated) total number of triangles.
+ */
+KATANA_EXPORT katana::Result<uint64_t> TriangleCountLocal(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx,
+    TriangleCountPlan plan = TriangleCountPlan::Approximate());
+
 }  // namespace katana::analytics
 
 #endif
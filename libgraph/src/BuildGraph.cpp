@@ -707,17 +707,44 @@ AddLabelInternal(
 /* Functions for handling topology */
 /***********************************/
 
-// Used to build the out_dests component of the CSR representation
-uint64_t
-SetEdgeID(
-    TopologyState* topology_builder, std::vector<uint64_t>* offsets,
-    size_t index) {
-  uint32_t src = topology_builder->sources[index];
-  uint64_t base = src ? topology_builder->out_indices[src - 1] : 0;
-  uint64_t i = base + offsets->at(src)++;
-
-  topology_builder->out_dests[i] = topology_builder->destinations[index];
-  return i;
+// An edge whose source or destination was added by string ID before its
+// node: the index of the edge, the ID and the index of the node, or
+// kUnresolvedNode
+struct IntermediateID {
+  size_t edge;
+  const std::string* id;
+  uint32_t node;
+};
+
+constexpr uint32_t kUnresolvedNode = std::numeric_limits<uint32_t>::max();
+
+// Look up the nodes of the IDs in intermediate in parallel, ordered by edge
+// index so that the nodes created for missing IDs do not depend on the order
+// of the hash map
+std::vector<IntermediateID>
+LookUpIntermediateIDs(
+    const std::unordered_map<size_t, std::string>& intermediate,
+    const std::unordered_map<std::string, size_t>& node_indexes) {
+  std::vector<IntermediateID> ids;
+  ids.reserve(intermediate.size());
+  for (const auto& [edge, id] : intermediate) {
+    ids.emplace_back(IntermediateID{edge, &id, kUnresolvedNode});
+  }
+  katana::ParallelSTL::sort(
+      ids.begin(), ids.end(),
+      [](const IntermediateID& a, const IntermediateID& b) {
+        return a.edge < b.edge;
+      });
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) {
+        auto entry = node_indexes.find(*ids[i].id);
+        if (entry != node_indexes.end()) {
+          ids[i].node = static_cast<uint32_t>(entry->second);
+        }
+      },
+      katana::no_stats());
+  return ids;
 }
 
 /******************************************************************************/
@@ -1633,29 +1660,31 @@ void
 katana::PropertyGraphBuilder::ResolveIntermediateIDs() {
   TopologyState* topology = &topology_builder_;
 
-  for (auto [index, str_id] : topology->destinations_intermediate) {
-    auto dest_index = topology->node_indexes.find(str_id);
-    uint32_t dest;
-    // if node does not exist, create it
-    if (dest_index == topology->node_indexes.end()) {
-      dest = nodes_;
-      this->AddNode(str_id);
-    } else {
-      dest = static_cast<uint32_t>(dest_index->second);
+  // the node of an ID that was missing from the parallel lookup, which may
+  // have been created since for another edge
+  auto resolve = [&](const IntermediateID& id) {
+    if (id.node != kUnresolvedNode) {
+      return id.node;
+    }
+    auto entry = topology->node_indexes.find(*id.id);
+    if (entry != topology->node_indexes.end()) {
+      return static_cast<uint32_t>(entry->second);
     }
-    topology->destinations[index] = dest;
+    // if node does not exist, create it
+    auto node = static_cast<uint32_t>(nodes_);
+    this->AddNode(*id.id);
+    return node;
+  };
+
+  for (const auto& id : LookUpIntermediateIDs(
+           topology->destinations_intermediate, topology->node_indexes)) {
+    topology->destinations[id.edge] = resolve(id);
   }
 
-  for (auto [index, str_id] : topology->sources_intermediate) {
-    auto src_index = topology->node_indexes.find(str_id);
-    uint32_t src;
-    if (src_index == topology->node_indexes.end()) {
-      src = nodes_;
-      this->AddNode(str_id);
-    } else {
-      src = static_cast<uint32_t>(src_index->second);
-    }
-    topology->sources[index] = src;
+  for (const auto& id : LookUpIntermediateIDs(
+           topology->sources_intermediate, topology->node_indexes)) {
+    uint32_t src = resolve(id);
+    topology->sources[id.edge] = src;
     topology->out_indices[src]++;
   }
 }
@@ -1668,17 +1697,42 @@ katana::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
       topology_builder_.out_indices.end(),
       topology_builder_.out_indices.begin());
 
+  const auto& out_indices = topology_builder_.out_indices;
+  const auto& sources = topology_builder_.sources;
+  const auto& destinations = topology_builder_.destinations;
+  auto node_begin = [&](size_t n) { return n ? out_indices[n - 1] : 0; };
+
   std::vector<size_t> edge_mapping;
   edge_mapping.resize(edges_, std::numeric_limits<uint64_t>::max());
 
   std::vector<uint64_t> offsets;
   offsets.resize(nodes_, 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, nodes_),
+      [&](size_t n) { offsets[n] = node_begin(n); }, katana::no_stats());
 
-  // get edge indices
-  for (size_t i = 0; i < topology_builder_.sources.size(); i++) {
-    uint64_t edgeID = SetEdgeID(&topology_builder_, &offsets, i);
-    edge_mapping[edgeID] = i;
-  }
+  // get edge indices: a counting sort of the edges by source, in parallel,
+  // then a sort of the edges of each node so that they stay in the order
+  // they were added, as they would be by a sequential counting sort
+  katana::do_all(
+      katana::iterate(size_t{0}, sources.size()),
+      [&](size_t i) {
+        uint64_t edge_id = __sync_fetch_and_add(&offsets[sources[i]], 1);
+        edge_mapping[edge_id] = i;
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, nodes_),
+      [&](size_t n) {
+        auto begin = edge_mapping.begin() + node_begin(n);
+        auto end = edge_mapping.begin() + offsets[n];
+        std::sort(begin, end);
+        for (auto it = begin; it != end; ++it) {
+          topology_builder_.out_dests[it - edge_mapping.begin()] =
+              destinations[*it];
+        }
+      },
+      katana::steal(), katana::no_stats());
 
   auto initial_edges = BuildChunks(&edge_properties_.chunks);
   auto initial_types = BuildChunks(&edge_types_.chunks);
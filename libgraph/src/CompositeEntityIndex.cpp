@@ -0,0 +1,313 @@
+#include "katana/CompositeEntityIndex.h"
+
+#include <algorithm>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace katana {
+
+namespace {
+
+template <typename T, typename U>
+int
+ThreeWay(const T& a, const U& b) {
+  return (b < a) - (a < b);
+}
+
+}  // namespace
+
+Result<internal::IndexColumn>
+internal::IndexColumn::Make(std::shared_ptr<arrow::Array> property) {
+  IndexColumn column;
+  switch (property->type_id()) {
+  case arrow::Type::BOOL:
+    column.kind_ = Kind::kBool;
+    break;
+  case arrow::Type::INT8:
+  case arrow::Type::INT16:
+  case arrow::Type::INT32:
+  case arrow::Type::INT64:
+    column.kind_ = Kind::kSigned;
+    break;
+  case arrow::Type::UINT8:
+  case arrow::Type::UINT16:
+  case arrow::Type::UINT32:
+  case arrow::Type::UINT64:
+    column.kind_ = Kind::kUnsigned;
+    break;
+  case arrow::Type::DOUBLE:
+    column.kind_ = Kind::kDouble;
+    break;
+  case arrow::Type::LARGE_STRING:
+    column.kind_ = Kind::kString;
+    column.strings_ =
+        std::static_pointer_cast<arrow::LargeStringArray>(property);
+    break;
+  case arrow::Type::DICTIONARY: {
+    if (!property->type()->Equals(DictionaryStringType())) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Dictionary column is not of strings for indexing: {}",
+          property->type()->ToString());
+    }
+    column.kind_ = Kind::kString;
+    const auto& encoded = static_cast<const arrow::DictionaryArray&>(*property);
+    column.strings_ = std::static_pointer_cast<arrow::LargeStringArray>(
+        encoded.dictionary());
+    column.codes_ = encoded.indices()->data()->GetValues<int32_t>(1);
+    break;
+  }
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Column has type unknown for indexing: {}",
+        property->type()->ToString());
+  }
+  column.property_ = std::move(property);
+  return column;
+}
+
+int64_t
+internal::IndexColumn::SignedValue(uint64_t id) const {
+  switch (property_->type_id()) {
+  case arrow::Type::INT8:
+    return static_cast<const arrow::Int8Array&>(*property_).Value(id);
+  case arrow::Type::INT16:
+    return static_cast<const arrow::Int16Array&>(*property_).Value(id);
+  case arrow::Type::INT32:
+    return static_cast<const arrow::Int32Array&>(*property_).Value(id);
+  default:
+    return static_cast<const arrow::Int64Array&>(*property_).Value(id);
+  }
+}
+
+uint64_t
+internal::IndexColumn::UnsignedValue(uint64_t id) const {
+  switch (property_->type_id()) {
+  case arrow::Type::UINT8:
+    return static_cast<const arrow::UInt8Array&>(*property_).Value(id);
+  case arrow::Type::UINT16:
+    return static_cast<const arrow::UInt16Array&>(*property_).Value(id);
+  case arrow::Type::UINT32:
+    return static_cast<const arrow::UInt32Array&>(*property_).Value(id);
+  default:
+    return static_cast<const arrow::UInt64Array&>(*property_).Value(id);
+  }
+}
+
+std::string_view
+internal::IndexColumn::StringValue(uint64_t id) const {
+  arrow::util::string_view arrow_view =
+      strings_->GetView(codes_ != nullptr ? codes_[id] : id);
+  return std::string_view(arrow_view.data(), arrow_view.length());
+}
+
+int
+internal::IndexColumn::Compare(uint64_t a, uint64_t b) const {
+  switch (kind_) {
+  case Kind::kBool: {
+    const auto& bools = static_cast<const arrow::BooleanArray&>(*property_);
+    return ThreeWay(bools.Value(a), bools.Value(b));
+  }
+  case Kind::kSigned:
+    return ThreeWay(SignedValue(a), SignedValue(b));
+  case Kind::kUnsigned:
+    return ThreeWay(UnsignedValue(a), UnsignedValue(b));
+  case Kind::kDouble: {
+    const auto& doubles = static_cast<const arrow::DoubleArray&>(*property_);
+    return ThreeWay(doubles.Value(a), doubles.Value(b));
+  }
+  case Kind::kString:
+    if (codes_ != nullptr && codes_[a] == codes_[b]) {
+      return 0;
+    }
+    return ThreeWay(StringValue(a).compare(StringValue(b)), 0);
+  }
+  return 0;
+}
+
+int
+internal::IndexColumn::Compare(uint64_t id, const EntityIndexKey& key) const {
+  switch (kind_) {
+  case Kind::kBool:
+    return ThreeWay(
+        static_cast<const arrow::BooleanArray&>(*property_).Value(id),
+        std::get<bool>(key));
+  case Kind::kSigned: {
+    int64_t value = SignedValue(id);
+    if (const auto* k = std::get_if<int64_t>(&key); k != nullptr) {
+      return ThreeWay(value, *k);
+    }
+    if (value < 0) {
+      return -1;
+    }
+    return ThreeWay(static_cast<uint64_t>(value), std::get<uint64_t>(key));
+  }
+  case Kind::kUnsigned: {
+    uint64_t value = UnsignedValue(id);
+    if (const auto* k = std::get_if<int64_t>(&key); k != nullptr) {
+      return *k < 0 ? 1 : ThreeWay(value, static_cast<uint64_t>(*k));
+    }
+    return ThreeWay(value, std::get<uint64_t>(key));
+  }
+  case Kind::kDouble: {
+    double value = static_cast<const arrow::DoubleArray&>(*property_).Value(id);
+    return std::visit(
+        [value](const auto& k) -> int {
+          if constexpr (std::is_arithmetic_v<std::decay_t<decltype(k)>>) {
+            return ThreeWay(value, static_cast<double>(k));
+          } else {
+            return 0;
+          }
+        },
+        key);
+  }
+  case Kind::kString:
+    return ThreeWay(
+        StringValue(id).compare(std::get<std::string_view>(key)), 0);
+  }
+  return 0;
+}
+
+bool
+internal::IndexColumn::Accepts(const EntityIndexKey& key) const {
+  bool is_integer = std::holds_alternative<int64_t>(key) ||
+                    std::holds_alternative<uint64_t>(key);
+  switch (kind_) {
+  case Kind::kBool:
+    return std::holds_alternative<bool>(key);
+  case Kind::kSigned:
+  case Kind::kUnsigned:
+    return is_integer;
+  case Kind::kDouble:
+    return is_integer || std::holds_alternative<double>(key);
+  case Kind::kString:
+    return std::holds_alternative<std::string_view>(key);
+  }
+  return false;
+}
+
+template <typename node_or_edge>
+Result<std::unique_ptr<CompositeEntityIndex<node_or_edge>>>
+CompositeEntityIndex<node_or_edge>::Make(
+    std::vector<std::string> property_names,
+    const std::vector<std::shared_ptr<arrow::Array>>& properties,
+    std::vector<EntityTypeID> type_ids) {
+  if (property_names.empty() || property_names.size() != properties.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} property names for {} properties",
+        property_names.size(), properties.size());
+  }
+  std::vector<internal::IndexColumn> columns;
+  for (const auto& property : properties) {
+    columns.emplace_back(KATANA_CHECKED(internal::IndexColumn::Make(property)));
+  }
+  // The scope is a set
+  std::sort(type_ids.begin(), type_ids.end());
+  type_ids.erase(std::unique(type_ids.begin(), type_ids.end()), type_ids.end());
+  return std::unique_ptr<CompositeEntityIndex>(new CompositeEntityIndex(
+      std::move(property_names), std::move(columns), std::move(type_ids)));
+}
+
+template <typename node_or_edge>
+Result<void>
+CompositeEntityIndex<node_or_edge>::Build(
+    std::vector<node_or_edge> candidates) {
+  for (size_t c = 0; c < columns_.size(); ++c) {
+    if (!candidates.empty() &&
+        columns_[c].length() <= static_cast<int64_t>(candidates.back())) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Property {} does not contain all entities", property_names_[c]);
+    }
+  }
+  // Entities without a value for some property are not in the index
+  candidates.erase(
+      std::remove_if(
+          candidates.begin(), candidates.end(),
+          [this](node_or_edge id) {
+            return !std::all_of(
+                columns_.begin(), columns_.end(),
+                [id](const auto& column) { return column.IsValid(id); });
+          }),
+      candidates.end());
+
+  num_ids_ = candidates.size();
+  ids_.allocateInterleaved(num_ids_);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids_),
+      [&](size_t i) { ids_[i] = candidates[i]; }, katana::no_stats());
+  katana::ParallelSTL::sort(
+      ids_.begin(), ids_.begin() + num_ids_,
+      [this](node_or_edge a, node_or_edge b) {
+        for (const auto& column : columns_) {
+          if (int order = column.Compare(a, b); order != 0) {
+            return order < 0;
+          }
+        }
+        return a < b;
+      });
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+CompositeEntityIndex<node_or_edge>::CheckKeys(
+    const std::vector<EntityIndexKey>& keys) const {
+  if (keys.size() > columns_.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} keys for an index of {} properties",
+        keys.size(), columns_.size());
+  }
+  for (size_t c = 0; c < keys.size(); ++c) {
+    if (!columns_[c].Accepts(keys[c])) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "key {} is of the wrong type for property {}",
+          c, property_names_[c]);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<typename CompositeEntityIndex<node_or_edge>::iterator>
+CompositeEntityIndex<node_or_edge>::LowerBound(
+    const std::vector<EntityIndexKey>& keys) const {
+  KATANA_CHECKED(CheckKeys(keys));
+  return iterator(
+      ids_.data() + internal::BranchlessLowerBound(num_ids_, [&](size_t i) {
+        return ComparePrefix(ids_[i], keys) < 0;
+      }));
+}
+
+template <typename node_or_edge>
+Result<typename CompositeEntityIndex<node_or_edge>::iterator>
+CompositeEntityIndex<node_or_edge>::UpperBound(
+    const std::vector<EntityIndexKey>& keys) const {
+  KATANA_CHECKED(CheckKeys(keys));
+  return iterator(
+      ids_.data() + internal::BranchlessLowerBound(num_ids_, [&](size_t i) {
+        return ComparePrefix(ids_[i], keys) <= 0;
+      }));
+}
+
+template <typename node_or_edge>
+Result<std::pair<
+    typename CompositeEntityIndex<node_or_edge>::iterator,
+    typename CompositeEntityIndex<node_or_edge>::iterator>>
+CompositeEntityIndex<node_or_edge>::EqualRange(
+    const std::vector<EntityIndexKey>& keys) const {
+  iterator lower = KATANA_CHECKED(LowerBound(keys));
+  iterator upper = KATANA_CHECKED(UpperBound(keys));
+  return std::make_pair(lower, upper);
+}
+
+// Forward declare template types to allow implementation in .cpp.
+template class CompositeEntityIndex<GraphTopology::Node>;
+template class CompositeEntityIndex<GraphTopology::Edge>;
+
+}  // namespace katana
@@ -0,0 +1,303 @@
+#include "katana/DynamicTopology.h"
+
+#include <iostream>
+#include <tuple>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using Edge = katana::GraphTopologyTypes::Edge;
+using PropertyIndex = katana::GraphTopologyTypes::PropertyIndex;
+using Insertion = katana::EdgeChangeSet::Insertion;
+using Deletion = katana::DynamicTopology::EdgeBatch::Deletion;
+
+constexpr uint64_t kNodesPerBlock =
+    katana::DynamicTopologySnapshot::kNodesPerBlock;
+
+uint64_t
+NumBlocks(uint64_t num_nodes) {
+  return (num_nodes + kNodesPerBlock - 1) / kNodesPerBlock;
+}
+
+/// Returns the range of \p items, sorted by source, whose source is in
+/// [first, last)
+template <typename T>
+std::pair<
+    typename std::vector<T>::const_iterator,
+    typename std::vector<T>::const_iterator>
+SourceRange(const std::vector<T>& items, uint64_t first, uint64_t last) {
+  auto by_src = [](const T& item, uint64_t n) { return item.src < n; };
+  auto beg = std::lower_bound(items.begin(), items.end(), first, by_src);
+  auto end = std::lower_bound(beg, items.end(), last, by_src);
+  return {beg, end};
+}
+
+/// Sets the edge id of the first edge of each block and returns the number
+/// of edges
+template <typename Blocks>
+Edge
+ComputeBlockBegins(const Blocks& blocks, std::vector<Edge>* block_begins) {
+  block_begins->resize(blocks.size() + 1);
+  Edge num_edges = 0;
+  for (size_t b = 0; b < blocks.size(); ++b) {
+    (*block_begins)[b] = num_edges;
+    num_edges += blocks[b]->dests.size();
+  }
+  block_begins->back() = num_edges;
+  return num_edges;
+}
+
+}  // namespace
+
+void
+katana::DynamicTopologySnapshot::Print() const noexcept {
+  std::cout << "version: " << version_ << std::endl;
+  for (auto n : Nodes()) {
+    std::cout << n << ": [ ";
+    for (auto dst : OutNeighbors(n)) {
+      std::cout << dst << ", ";
+    }
+    std::cout << "]" << std::endl;
+  }
+}
+
+size_t
+katana::DynamicTopologySnapshot::ApproxMemUse() const noexcept {
+  size_t bytes = blocks_.size() * sizeof(blocks_[0]) +
+                 block_begins_.size() * sizeof(Edge) +
+                 node_prop_indices_->size() * sizeof(PropertyIndex);
+  for (const auto& block : blocks_) {
+    bytes += block->ends.size() * sizeof(Edge) +
+             block->dests.size() * sizeof(Node) +
+             block->prop_indices.size() * sizeof(PropertyIndex);
+  }
+  return bytes;
+}
+
+katana::GraphTopology
+katana::DynamicTopologySnapshot::ToGraphTopology() const noexcept {
+  AdjIndexVec adj_indices;
+  EdgeDestVec dests;
+  PropIndexVec edge_prop_indices;
+  PropIndexVec node_prop_indices;
+
+  adj_indices.allocateInterleaved(NumNodes());
+  dests.allocateInterleaved(NumEdges());
+  edge_prop_indices.allocateInterleaved(NumEdges());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{blocks_.size()}),
+      [&](uint64_t b) {
+        const Block& block = *blocks_[b];
+        const Edge begin = block_begins_[b];
+        const uint64_t first = b * kNodesPerBlock;
+        for (size_t i = 0; i < block.ends.size(); ++i) {
+          adj_indices[first + i] = begin + block.ends[i];
+        }
+        std::copy(
+            block.dests.begin(), block.dests.end(), dests.begin() + begin);
+        std::copy(
+            block.prop_indices.begin(), block.prop_indices.end(),
+            edge_prop_indices.begin() + begin);
+      },
+      katana::steal(), katana::no_stats());
+
+  if (!node_prop_indices_->empty()) {
+    node_prop_indices.allocateInterleaved(NumNodes());
+    katana::ParallelSTL::copy(
+        node_prop_indices_->begin(), node_prop_indices_->end(),
+        node_prop_indices.begin());
+  }
+
+  return GraphTopology{
+      std::move(adj_indices), std::move(dests), std::move(edge_prop_indices),
+      std::move(node_prop_indices)};
+}
+
+std::unique_ptr<katana::DynamicTopology>
+katana::DynamicTopology::Make(const GraphTopology& topo) noexcept {
+  using Block = DynamicTopologySnapshot::Block;
+
+  std::shared_ptr<DynamicTopologySnapshot> snapshot(
+      new DynamicTopologySnapshot());
+  snapshot->num_nodes_ = topo.NumNodes();
+
+  std::vector<std::shared_ptr<const Block>> blocks(NumBlocks(topo.NumNodes()));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{blocks.size()}),
+      [&](uint64_t b) {
+        const uint64_t first = b * kNodesPerBlock;
+        const uint64_t last =
+            std::min(first + kNodesPerBlock, topo.NumNodes());
+
+        auto block = std::make_shared<Block>();
+        block->ends.reserve(last - first);
+        std::vector<std::pair<Node, PropertyIndex>> edges;
+        for (uint64_t n = first; n < last; ++n) {
+          edges.clear();
+          for (auto e : topo.OutEdges(n)) {
+            edges.emplace_back(
+                topo.OutEdgeDst(e), topo.GetEdgePropertyIndexFromOutEdge(e));
+          }
+          std::sort(edges.begin(), edges.end());
+          for (const auto& [dst, prop] : edges) {
+            block->dests.emplace_back(dst);
+            block->prop_indices.emplace_back(prop);
+          }
+          block->ends.emplace_back(block->dests.size());
+        }
+        blocks[b] = std::move(block);
+      },
+      katana::steal(), katana::no_stats());
+
+  snapshot->num_edges_ = ComputeBlockBegins(blocks, &snapshot->block_begins_);
+  snapshot->blocks_ = std::move(blocks);
+
+  auto node_prop_indices = std::make_shared<std::vector<PropertyIndex>>();
+  bool identity = true;
+  for (auto n : topo.Nodes()) {
+    if (topo.GetNodePropertyIndex(n) != n) {
+      identity = false;
+      break;
+    }
+  }
+  if (!identity) {
+    node_prop_indices->resize(topo.NumNodes());
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node n) { (*node_prop_indices)[n] = topo.GetNodePropertyIndex(n); },
+        katana::no_stats());
+  }
+  snapshot->node_prop_indices_ = std::move(node_prop_indices);
+
+  return std::unique_ptr<DynamicTopology>(
+      new DynamicTopology(std::move(snapshot)));
+}
+
+std::shared_ptr<const katana::DynamicTopologySnapshot>
+katana::DynamicTopology::Snapshot() const {
+  std::lock_guard<std::mutex> lock(current_mutex_);
+  return current_;
+}
+
+katana::Result<void>
+katana::DynamicTopology::ApplyEdgeBatch(const EdgeBatch& batch) {
+  using Block = DynamicTopologySnapshot::Block;
+
+  std::lock_guard<std::mutex> apply_lock(apply_mutex_);
+  // only batches replace current_, so it cannot change under us
+  const DynamicTopologySnapshot& prev = *current_;
+
+  for (const auto& ins : batch.insertions) {
+    if (ins.src >= prev.NumNodes() || ins.dst >= prev.NumNodes()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "inserted edge {} -> {} refers to a node past the {} nodes of the "
+          "graph",
+          ins.src, ins.dst, prev.NumNodes());
+    }
+  }
+  for (const auto& del : batch.deletions) {
+    if (del.src >= prev.NumNodes() || del.dst >= prev.NumNodes()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "deleted edge {} -> {} refers to a node past the {} nodes of the "
+          "graph",
+          del.src, del.dst, prev.NumNodes());
+    }
+  }
+
+  std::vector<Insertion> insertions = batch.insertions;
+  katana::ParallelSTL::sort(
+      insertions.begin(), insertions.end(),
+      [](const Insertion& a, const Insertion& b) {
+        return std::tie(a.src, a.dst, a.prop_index) <
+               std::tie(b.src, b.dst, b.prop_index);
+      });
+  std::vector<Deletion> deletions = batch.deletions;
+  katana::ParallelSTL::sort(
+      deletions.begin(), deletions.end(),
+      [](const Deletion& a, const Deletion& b) {
+        return std::tie(a.src, a.dst) < std::tie(b.src, b.dst);
+      });
+
+  // the blocks the batch changes, each once
+  std::vector<uint64_t> touched;
+  touched.reserve(insertions.size() + deletions.size());
+  for (const auto& ins : insertions) {
+    touched.emplace_back(ins.src / kNodesPerBlock);
+  }
+  for (const auto& del : deletions) {
+    touched.emplace_back(del.src / kNodesPerBlock);
+  }
+  std::sort(touched.begin(), touched.end());
+  touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+  std::vector<std::shared_ptr<const Block>> blocks = prev.blocks_;
+  katana::do_all(
+      katana::iterate(touched),
+      [&](uint64_t b) {
+        const Block& old = *prev.blocks_[b];
+        const Node first = b * kNodesPerBlock;
+        auto [ins, ins_end] =
+            SourceRange(insertions, first, first + old.ends.size());
+        auto [del, del_end] =
+            SourceRange(deletions, first, first + old.ends.size());
+
+        auto block = std::make_shared<Block>();
+        block->ends.reserve(old.ends.size());
+        block->dests.reserve(old.dests.size() + std::distance(ins, ins_end));
+        block->prop_indices.reserve(block->dests.capacity());
+
+        auto emit = [&](Node dst, PropertyIndex prop) {
+          block->dests.emplace_back(dst);
+          block->prop_indices.emplace_back(prop);
+        };
+
+        Edge e = 0;
+        for (size_t i = 0; i < old.ends.size(); ++i) {
+          const Node n = first + i;
+          // both the old edges and the insertions of n are sorted by
+          // destination, so merge them
+          for (; e < old.ends[i]; ++e) {
+            const Node dst = old.dests[e];
+            for (; del != del_end && del->src == n && del->dst < dst; ++del) {
+            }
+            if (del != del_end && del->src == n && del->dst == dst) {
+              continue;
+            }
+            for (; ins != ins_end && ins->src == n &&
+                   std::tie(ins->dst, ins->prop_index) <
+                       std::tie(dst, old.prop_indices[e]);
+                 ++ins) {
+              emit(ins->dst, ins->prop_index);
+            }
+            emit(dst, old.prop_indices[e]);
+          }
+          for (; ins != ins_end && ins->src == n; ++ins) {
+            emit(ins->dst, ins->prop_index);
+          }
+          for (; del != del_end && del->src == n; ++del) {
+          }
+          block->ends.emplace_back(block->dests.size());
+        }
+        KATANA_LOG_DEBUG_ASSERT(ins == ins_end && del == del_end);
+        blocks[b] = std::move(block);
+      },
+      katana::steal(), katana::no_stats());
+
+  std::shared_ptr<DynamicTopologySnapshot> next(new DynamicTopologySnapshot());
+  next->version_ = prev.version_ + 1;
+  next->num_nodes_ = prev.num_nodes_;
+  next->num_edges_ = ComputeBlockBegins(blocks, &next->block_begins_);
+  next->blocks_ = std::move(blocks);
+  next->node_prop_indices_ = prev.node_prop_indices_;
+
+  std::lock_guard<std::mutex> lock(current_mutex_);
+  current_ = std::move(next);
+  return katana::ResultSuccess();
+}
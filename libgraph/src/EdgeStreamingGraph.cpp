@@ -0,0 +1,347 @@
+#include "katana/EdgeStreamingGraph.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <utility>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/BufferedGraph.h"
+#include "katana/CSRTopology.h"
+#include "katana/ErrorCode.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Node = katana::EdgeStreamingGraph::Node;
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// Read size bytes at offset
+katana::Result<void>
+PReadAll(int fd, char* buf, uint64_t size, uint64_t offset) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t n = pread(fd, buf + done, size - done, offset + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "reading shard");
+    }
+    if (n == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "graph file is truncated");
+    }
+    done += n;
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<katana::EdgeStreamingGraph>
+katana::EdgeStreamingGraph::Make(
+    const std::string& filename, const EdgeStreamingOptions& opts) {
+  EdgeStreamingGraph graph;
+  graph.filename_ = filename;
+  graph.io_threads_ = std::max<uint32_t>(opts.io_threads, 1);
+  graph.fd_ = open(filename.c_str(), O_RDONLY);
+  if (graph.fd_ < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", filename);
+  }
+
+  katana::CSRTopologyHeader header;
+  KATANA_CHECKED_CONTEXT(
+      PReadAll(
+          graph.fd_, reinterpret_cast<char*>(&header), sizeof(header), 0),
+      "reading header of {}", filename);
+  if (header.version != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "{} is a version {} .gr file; only version 1 is supported", filename,
+        header.version);
+  }
+  struct stat stat_buf;
+  if (fstat(graph.fd_, &stat_buf) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "stat of {}", filename);
+  }
+  uint64_t topology_size = sizeof(header) +
+                           header.num_nodes * sizeof(uint64_t) +
+                           header.num_edges * sizeof(uint32_t);
+  if (static_cast<uint64_t>(stat_buf.st_size) < topology_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} is too small for its header",
+        filename);
+  }
+
+  graph.out_indexes_.allocateInterleaved(header.num_nodes);
+  katana::ReadFileRangeParallel(
+      filename, sizeof(header), header.num_nodes * sizeof(uint64_t),
+      graph.out_indexes_.data(), false);
+
+  // cut a shard before the node that would take it past shard_edges
+  uint64_t shard_edges =
+      std::max<uint64_t>(opts.shard_bytes / sizeof(uint32_t), 1);
+  uint64_t num_nodes = header.num_nodes;
+  Node first = 0;
+  while (first < num_nodes) {
+    uint64_t first_edge = graph.EdgeBegin(first);
+    auto it = std::upper_bound(
+        graph.out_indexes_.begin() + first, graph.out_indexes_.end(),
+        first_edge + shard_edges);
+    Node end = std::max<uint64_t>(it - graph.out_indexes_.begin(), first + 1);
+    graph.max_shard_edges_ =
+        std::max(graph.max_shard_edges_, graph.EdgeEnd(end - 1) - first_edge);
+    graph.shard_bounds_.emplace_back(end);
+    first = end;
+  }
+  return graph;
+}
+
+katana::EdgeStreamingGraph::EdgeStreamingGraph(
+    EdgeStreamingGraph&& other) noexcept
+    : filename_(std::move(other.filename_)),
+      fd_(std::exchange(other.fd_, -1)),
+      io_threads_(other.io_threads_),
+      out_indexes_(std::move(other.out_indexes_)),
+      shard_bounds_(std::move(other.shard_bounds_)),
+      max_shard_edges_(other.max_shard_edges_) {}
+
+katana::EdgeStreamingGraph&
+katana::EdgeStreamingGraph::operator=(EdgeStreamingGraph&& other) noexcept {
+  std::swap(filename_, other.filename_);
+  std::swap(fd_, other.fd_);
+  std::swap(io_threads_, other.io_threads_);
+  std::swap(out_indexes_, other.out_indexes_);
+  std::swap(shard_bounds_, other.shard_bounds_);
+  std::swap(max_shard_edges_, other.max_shard_edges_);
+  return *this;
+}
+
+katana::EdgeStreamingGraph::~EdgeStreamingGraph() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+katana::Result<void>
+katana::EdgeStreamingGraph::ReadDests(
+    uint64_t begin, uint64_t end, uint32_t* dests) const {
+  uint64_t dests_offset =
+      sizeof(katana::CSRTopologyHeader) + NumNodes() * sizeof(uint64_t);
+  uint64_t num_edges = end - begin;
+  uint64_t per_thread = (num_edges + io_threads_ - 1) / io_threads_;
+
+  std::vector<std::future<katana::CopyableResult<void>>> reads;
+  for (uint64_t part = 0; part * per_thread < num_edges; ++part) {
+    uint64_t part_begin = part * per_thread;
+    uint64_t part_end = std::min(part_begin + per_thread, num_edges);
+    reads.emplace_back(std::async(
+        std::launch::async,
+        [=]() -> katana::CopyableResult<void> {
+          KATANA_CHECKED(PReadAll(
+              fd_, reinterpret_cast<char*>(dests + part_begin),
+              (part_end - part_begin) * sizeof(uint32_t),
+              dests_offset + (begin + part_begin) * sizeof(uint32_t)));
+          return katana::CopyableResultSuccess();
+        }));
+  }
+  // n.b. returning early is safe: destroying reads waits for the reads
+  // still writing to dests
+  for (auto& read : reads) {
+    KATANA_CHECKED_CONTEXT(read.get(), "reading {}", filename_);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::EdgeStreamingGraph::StreamShards(
+    const std::vector<uint64_t>& shards,
+    const std::function<void(uint64_t, const uint32_t*)>& process) {
+  if (shards.empty()) {
+    return katana::ResultSuccess();
+  }
+  std::array<katana::NUMAArray<uint32_t>, 2> buffers;
+  buffers[0].allocateInterleaved(max_shard_edges_);
+  if (shards.size() > 1) {
+    buffers[1].allocateInterleaved(max_shard_edges_);
+  }
+
+  auto read = [&](size_t i) {
+    return std::async(
+        std::launch::async,
+        [this, &shards, &buffers, i]() -> katana::CopyableResult<void> {
+          uint64_t s = shards[i];
+          KATANA_CHECKED(ReadDests(
+              EdgeBegin(shard_bounds_[s]), EdgeBegin(shard_bounds_[s + 1]),
+              buffers[i % 2].data()));
+          return katana::CopyableResultSuccess();
+        });
+  };
+
+  // the shard after the one being processed is read in the other buffer
+  std::future<katana::CopyableResult<void>> pending = read(0);
+  for (size_t i = 0; i < shards.size(); ++i) {
+    KATANA_CHECKED(pending.get());
+    if (i + 1 < shards.size()) {
+      pending = read(i + 1);
+    }
+    process(shards[i], buffers[i % 2].data());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::StreamingBFS(
+    EdgeStreamingGraph* graph, EdgeStreamingGraph::Node source,
+    katana::NUMAArray<uint32_t>* levels) {
+  uint64_t num_nodes = graph->NumNodes();
+  if (source >= num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} is not a node of a graph of {} nodes", source, num_nodes);
+  }
+  katana::NUMAArray<std::atomic<uint32_t>> level;
+  level.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        level[n].store(kUnreached, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  level[source] = 0;
+
+  for (uint32_t depth = 0;; ++depth) {
+    katana::GAccumulator<uint64_t> reached;
+    KATANA_CHECKED(graph->ForEachEdge(
+        [&](Node n) {
+          return level[n].load(std::memory_order_relaxed) == depth;
+        },
+        [&](Node, Node dst) {
+          uint32_t expected = kUnreached;
+          if (level[dst].load(std::memory_order_relaxed) == kUnreached &&
+              level[dst].compare_exchange_strong(expected, depth + 1)) {
+            reached += 1;
+          }
+        }));
+    if (reached.reduce() == 0) {
+      break;
+    }
+  }
+
+  levels->allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { (*levels)[n] = level[n]; }, katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::StreamingConnectedComponents(
+    EdgeStreamingGraph* graph, katana::NUMAArray<uint32_t>* components) {
+  uint64_t num_nodes = graph->NumNodes();
+  katana::NUMAArray<std::atomic<uint32_t>> label;
+  label.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { label[n].store(n, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  // a label is always a node of the component, no greater than the node it
+  // labels, so the label of the label is as good and can be jumped to
+  for (;;) {
+    katana::GAccumulator<uint64_t> changed;
+    KATANA_CHECKED(graph->ForEachEdge([&](Node src, Node dst) {
+      uint32_t src_label = label[src].load(std::memory_order_relaxed);
+      uint32_t dst_label = label[dst].load(std::memory_order_relaxed);
+      if (src_label < dst_label) {
+        changed += katana::atomicMin(label[dst], src_label) > src_label;
+      } else if (dst_label < src_label) {
+        changed += katana::atomicMin(label[src], dst_label) > dst_label;
+      }
+    }));
+    if (changed.reduce() == 0) {
+      break;
+    }
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint32_t l = label[n].load(std::memory_order_relaxed);
+          uint32_t next;
+          while ((next = label[l].load(std::memory_order_relaxed)) < l) {
+            l = next;
+          }
+          katana::atomicMin(label[n], l);
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  components->allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { (*components)[n] = label[n]; }, katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::StreamingPageRank(
+    EdgeStreamingGraph* graph, const StreamingPageRankOptions& opts,
+    katana::NUMAArray<float>* ranks) {
+  uint64_t num_nodes = graph->NumNodes();
+  ranks->allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return katana::ResultSuccess();
+  }
+  float initial = 1.0f / num_nodes;
+  katana::NUMAArray<float> contributions;
+  katana::NUMAArray<std::atomic<float>> sums;
+  contributions.allocateInterleaved(num_nodes);
+  sums.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { (*ranks)[n] = initial; }, katana::no_stats());
+
+  for (uint32_t iteration = 0; iteration < opts.max_iterations; ++iteration) {
+    katana::GAccumulator<double> dangling;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t degree = graph->OutDegree(n);
+          contributions[n] = degree == 0 ? 0 : (*ranks)[n] / degree;
+          if (degree == 0) {
+            dangling += (*ranks)[n];
+          }
+          sums[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+
+    KATANA_CHECKED(graph->ForEachEdge([&](Node src, Node dst) {
+      katana::atomicAdd(sums[dst], contributions[src]);
+    }));
+
+    float base = (1 - opts.alpha + opts.alpha * dangling.reduce()) / num_nodes;
+    katana::GAccumulator<double> delta;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          float rank =
+              base + opts.alpha * sums[n].load(std::memory_order_relaxed);
+          delta += std::fabs(rank - (*ranks)[n]);
+          (*ranks)[n] = rank;
+        },
+        katana::no_stats());
+    if (delta.reduce() < opts.tolerance) {
+      break;
+    }
+  }
+  return katana::ResultSuccess();
+}
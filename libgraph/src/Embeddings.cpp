@@ -0,0 +1,255 @@
+#include "katana/Embeddings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KATANA_EMBEDDINGS_X86 1
+#include <immintrin.h>
+#endif
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using katana::EmbeddingNeighbor;
+
+/// Queries compared to every embedding per pass; an embedding of 128 floats
+/// and a block of queries fit in L1 together
+constexpr size_t kQueryBlock = 8;
+
+float
+ScalarDot(const float* a, const float* b, size_t dim) {
+  // Independent partial sums, so that the compiler can vectorize and
+  // pipeline them
+  float sum[4] = {0, 0, 0, 0};
+  size_t i = 0;
+  for (; i + 4 <= dim; i += 4) {
+    sum[0] += a[i] * b[i];
+    sum[1] += a[i + 1] * b[i + 1];
+    sum[2] += a[i + 2] * b[i + 2];
+    sum[3] += a[i + 3] * b[i + 3];
+  }
+  for (; i < dim; ++i) {
+    sum[0] += a[i] * b[i];
+  }
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+#ifdef KATANA_EMBEDDINGS_X86
+
+__attribute__((target("avx2,fma"))) float
+AVX2Dot(const float* a, const float* b, size_t dim) {
+  constexpr size_t kLanes = 8;
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 2 * kLanes <= dim; i += 2 * kLanes) {
+    sum0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    sum1 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i + kLanes), _mm256_loadu_ps(b + i + kLanes),
+        sum1);
+  }
+  for (; i + kLanes <= dim; i += kLanes) {
+    sum0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+  }
+  __m256 sum = _mm256_add_ps(sum0, sum1);
+  __m128 half =
+      _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_movehdup_ps(half));
+  float result = _mm_cvtss_f32(half);
+  for (; i < dim; ++i) {
+    result += a[i] * b[i];
+  }
+  return result;
+}
+
+__attribute__((target("avx512f"))) float
+AVX512Dot(const float* a, const float* b, size_t dim) {
+  constexpr size_t kLanes = 16;
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 2 * kLanes <= dim; i += 2 * kLanes) {
+    sum0 = _mm512_fmadd_ps(
+        _mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+    sum1 = _mm512_fmadd_ps(
+        _mm512_loadu_ps(a + i + kLanes), _mm512_loadu_ps(b + i + kLanes),
+        sum1);
+  }
+  if (i < dim) {
+    // The tail is masked rather than scalar, since a row of embeddings is
+    // often a few lanes past a multiple of the width
+    for (; i + kLanes <= dim; i += kLanes) {
+      sum0 = _mm512_fmadd_ps(
+          _mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+    }
+    __mmask16 tail = (__mmask16{1} << (dim - i)) - 1;
+    sum1 = _mm512_fmadd_ps(
+        _mm512_maskz_loadu_ps(tail, a + i), _mm512_maskz_loadu_ps(tail, b + i),
+        sum1);
+  }
+  // Not _mm512_reduce_add_ps, whose gcc implementation trips
+  // -Wuninitialized
+  alignas(64) float lanes[kLanes];
+  _mm512_store_ps(lanes, _mm512_add_ps(sum0, sum1));
+  float result = 0;
+  for (float lane : lanes) {
+    result += lane;
+  }
+  return result;
+}
+
+#endif
+
+using DotFn = float (*)(const float*, const float*, size_t);
+
+DotFn
+DetectDot() {
+#ifdef KATANA_EMBEDDINGS_X86
+  if (__builtin_cpu_supports("avx512f")) {
+    return AVX512Dot;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return AVX2Dot;
+  }
+#endif
+  return ScalarDot;
+}
+
+DotFn
+SelectedDot() {
+  static const DotFn dot = DetectDot();
+  return dot;
+}
+
+float
+Cosine(float dot, float a_norm, float b_norm) {
+  if (a_norm == 0 || b_norm == 0) {
+    return 0;
+  }
+  return dot / (a_norm * b_norm);
+}
+
+/// Whether a is a better neighbor than b
+bool
+IsBetter(const EmbeddingNeighbor& a, const EmbeddingNeighbor& b) {
+  return a.similarity > b.similarity ||
+         (a.similarity == b.similarity && a.node < b.node);
+}
+
+/// Keeps the best k neighbors offered to heap, with the worst at the front
+void
+Offer(
+    std::vector<EmbeddingNeighbor>* heap, size_t k,
+    const EmbeddingNeighbor& candidate) {
+  if (heap->size() < k) {
+    heap->emplace_back(candidate);
+    std::push_heap(heap->begin(), heap->end(), IsBetter);
+  } else if (IsBetter(candidate, heap->front())) {
+    std::pop_heap(heap->begin(), heap->end(), IsBetter);
+    heap->back() = candidate;
+    std::push_heap(heap->begin(), heap->end(), IsBetter);
+  }
+}
+
+}  // namespace
+
+float
+katana::EmbeddingDot(const float* a, const float* b, size_t dim) noexcept {
+  return SelectedDot()(a, b, dim);
+}
+
+float
+katana::EmbeddingCosine(const float* a, const float* b, size_t dim) noexcept {
+  DotFn dot = SelectedDot();
+  return Cosine(
+      dot(a, b, dim), std::sqrt(dot(a, a, dim)), std::sqrt(dot(b, b, dim)));
+}
+
+katana::Result<std::vector<std::vector<katana::EmbeddingNeighbor>>>
+katana::EmbeddingNearestNeighbors(
+    const PropertyGraph& pg, const std::string& property,
+    const float* queries, size_t num_queries, size_t k,
+    EmbeddingSimilarity similarity, const DynamicBitset* candidates) {
+  auto column = KATANA_CHECKED(pg.GetNodeProperty(property));
+  auto embeddings = std::dynamic_pointer_cast<arrow::FixedSizeListArray>(
+      KATANA_CHECKED(ContiguousArray(*column)));
+  if (!embeddings || embeddings->value_type()->id() != arrow::Type::FLOAT) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "property {} is not of float embeddings: {}",
+        std::quoted(property), column->type()->ToString());
+  }
+  const GraphTopology& topology = pg.topology();
+  if (candidates != nullptr && candidates->size() != topology.NumNodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "candidates of {} bits for {} nodes",
+        candidates->size(), topology.NumNodes());
+  }
+
+  size_t dim = embeddings->list_type()->list_size();
+  const float* values =
+      embeddings->values()->data()->GetValues<float>(1) +
+      embeddings->value_offset(0);
+  DotFn dot = SelectedDot();
+  bool cosine = similarity == EmbeddingSimilarity::kCosine;
+
+  std::vector<float> query_norms(num_queries, 1);
+  if (cosine) {
+    for (size_t q = 0; q < num_queries; ++q) {
+      const float* query = queries + q * dim;
+      query_norms[q] = std::sqrt(dot(query, query, dim));
+    }
+  }
+
+  std::vector<std::vector<EmbeddingNeighbor>> neighbors(num_queries);
+  katana::PerThreadStorage<std::vector<std::vector<EmbeddingNeighbor>>> heaps;
+  for (size_t begin = 0; begin < num_queries && k > 0; begin += kQueryBlock) {
+    size_t block = std::min(kQueryBlock, num_queries - begin);
+    for (unsigned i = 0; i < heaps.size(); ++i) {
+      heaps.getRemote(i)->assign(block, {});
+    }
+
+    katana::do_all(
+        katana::iterate(topology.Nodes()),
+        [&](Node n) {
+          if (candidates != nullptr && !candidates->test(n)) {
+            return;
+          }
+          uint64_t row = pg.GetNodePropertyIndex(n);
+          if (embeddings->IsNull(row)) {
+            return;
+          }
+          const float* embedding = values + row * dim;
+          float norm = cosine ? std::sqrt(dot(embedding, embedding, dim)) : 1;
+          auto& local = *heaps.getLocal();
+          for (size_t q = 0; q < block; ++q) {
+            float s = dot(embedding, queries + (begin + q) * dim, dim);
+            if (cosine) {
+              s = Cosine(s, norm, query_norms[begin + q]);
+            }
+            Offer(&local[q], k, EmbeddingNeighbor{n, s});
+          }
+        },
+        katana::steal(), katana::loopname("EmbeddingNearestNeighbors"));
+
+    for (size_t q = 0; q < block; ++q) {
+      std::vector<EmbeddingNeighbor>& result = neighbors[begin + q];
+      for (unsigned i = 0; i < heaps.size(); ++i) {
+        for (const EmbeddingNeighbor& neighbor : (*heaps.getRemote(i))[q]) {
+          Offer(&result, k, neighbor);
+        }
+      }
+      std::sort(result.begin(), result.end(), IsBetter);
+    }
+  }
+  return neighbors;
+}
@@ -1,9 +1,158 @@
 #include "katana/EntityIndex.h"
 
+#include <algorithm>
+#include <numeric>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
 
 namespace katana {
 
+std::vector<int32_t>
+internal::RankStrings(const arrow::LargeStringArray& strings) {
+  auto view = [&](int32_t i) {
+    arrow::util::string_view arrow_view = strings.GetView(i);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  };
+  std::vector<int32_t> order(strings.length());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+    return view(a) < view(b);
+  });
+
+  std::vector<int32_t> ranks(strings.length());
+  for (size_t i = 0; i < order.size(); ++i) {
+    bool same = i > 0 && view(order[i]) == view(order[i - 1]);
+    ranks[order[i]] = same ? ranks[order[i - 1]] : static_cast<int32_t>(i);
+  }
+  return ranks;
+}
+
+namespace {
+
+// Sort the ids of the entities in [0, num_entities) into *ids in parallel:
+// those with a value in property by less, and then those without one, and
+// return how many have one.
+template <typename node_or_edge, typename Less>
+size_t
+SortIDs(
+    const arrow::Array& property, size_t num_entities,
+    NUMAArray<node_or_edge>* ids, const Less& less) {
+  ids->allocateInterleaved(num_entities);
+  katana::ParallelSTL::iota(ids->begin(), ids->end(), node_or_edge{0});
+
+  int64_t num_nulls = property.Slice(0, num_entities)->null_count();
+  if (num_nulls == 0) {
+    katana::ParallelSTL::sort(ids->begin(), ids->end(), less);
+  } else {
+    katana::ParallelSTL::sort(
+        ids->begin(), ids->end(), [&](node_or_edge a, node_or_edge b) {
+          bool valid_a = property.IsValid(a);
+          bool valid_b = property.IsValid(b);
+          if (valid_a != valid_b) {
+            return valid_a;
+          }
+          return valid_a ? less(a, b) : a < b;
+        });
+  }
+  return num_entities - num_nulls;
+}
+
+// Check that property can replace old, the indexed version of it, for
+// num_entities.
+Result<void>
+CheckUpdate(
+    const arrow::Array& old, const arrow::Array& property,
+    size_t num_entities) {
+  if (!property.type()->Equals(old.type())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "cannot update an index of {} to {}",
+        old.type()->ToString(), property.type()->ToString());
+  }
+  if (static_cast<uint64_t>(property.length()) < num_entities) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Property does not contain all entities");
+  }
+  return ResultSuccess();
+}
+
+}  // namespace
+
+// The entities that changed are found by one parallel pass over the
+// property. Those that still have a value are sorted by it and each is
+// placed by a search among the entities that did not change, which keep
+// their order, so that every entity can then be written to its place in
+// parallel.
+template <typename node_or_edge>
+template <typename Changed, typename Valid, typename Less>
+void
+EntityIndex<node_or_edge>::MergeChanged(
+    size_t num_entities, const Changed& changed, const Valid& valid,
+    const Less& less) {
+  DynamicBitset changed_set;
+  changed_set.resize(num_entities);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entities),
+      [&](size_t id) {
+        if (changed(id)) {
+          changed_set.set(id);
+        }
+      },
+      katana::no_stats());
+  std::vector<node_or_edge> moved =
+      changed_set.GetOffsets<node_or_edge>();
+  if (moved.empty()) {
+    return;
+  }
+  moved.erase(
+      std::remove_if(
+          moved.begin(), moved.end(),
+          [&](node_or_edge id) { return !valid(id); }),
+      moved.end());
+  katana::ParallelSTL::sort(moved.begin(), moved.end(), less);
+
+  NUMAArray<node_or_edge> kept;
+  kept.allocateInterleaved(num_ids_);
+  size_t num_kept =
+      katana::ParallelSTL::copy_if(
+          ids_data_, ids_data_ + num_ids_, kept.begin(),
+          [&](node_or_edge id) { return !changed_set.test(id); }) -
+      kept.begin();
+
+  // Moved entity i goes before the unchanged entities from insert_at[i] on,
+  // and so after i other moved entities
+  std::vector<size_t> insert_at(moved.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, moved.size()),
+      [&](size_t i) {
+        insert_at[i] = internal::BranchlessLowerBound(
+            num_kept, [&](size_t j) { return less(kept[j], moved[i]); });
+      },
+      katana::no_stats());
+
+  NUMAArray<node_or_edge> ids;
+  ids.allocateInterleaved(num_kept + moved.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, moved.size()),
+      [&](size_t i) { ids[insert_at[i] + i] = moved[i]; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_kept),
+      [&](size_t j) {
+        size_t num_before = internal::BranchlessLowerBound(
+            moved.size(), [&](size_t i) { return insert_at[i] <= j; });
+        ids[j + num_before] = kept[j];
+      },
+      katana::no_stats());
+
+  ids_ = std::move(ids);
+  ids_data_ = ids_.data();
+  num_ids_ = num_kept + moved.size();
+  stored_.reset();
+}
+
 // Switch statement over creation of per-type indexes.
 template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>>
@@ -37,6 +186,16 @@ MakeTypedEntityIndex(
     index = std::make_unique<StringEntityIndex<node_or_edge>>(
         property_name, num_entities, property);
     break;
+  case arrow::Type::DICTIONARY:
+    if (!property->type()->Equals(DictionaryStringType())) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Dictionary column is not of strings for indexing: {}",
+          property->type()->ToString());
+    }
+    index = std::make_unique<StringEntityIndex<node_or_edge>>(
+        property_name, num_entities, property);
+    break;
   default:
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "Column has type unknown for indexing: {}",
@@ -55,18 +214,62 @@ PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
-  }
+  const ArrowArrayType& property = *property_;
+  this->num_ids_ = SortIDs(
+      property, num_entities_, &this->ids_,
+      [&property](node_or_edge a, node_or_edge b) {
+        std::less<c_type> less;
+        c_type value_a = property.Value(a);
+        c_type value_b = property.Value(b);
+        return less(value_a, value_b) || (!less(value_b, value_a) && a < b);
+      });
+  this->ids_data_ = this->ids_.data();
+
+  GatherKeys();
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitiveEntityIndex<node_or_edge, c_type>::UpdateFromProperty(
+    std::shared_ptr<arrow::Array> property) {
+  KATANA_CHECKED(CheckUpdate(*property_, *property, num_entities_));
+
+  std::shared_ptr<ArrowArrayType> old = std::move(property_);
+  property_ = std::static_pointer_cast<ArrowArrayType>(property);
+  const ArrowArrayType& current = *property_;
+  this->MergeChanged(
+      num_entities_,
+      [&](node_or_edge id) {
+        bool valid = current.IsValid(id);
+        return valid != old->IsValid(id) ||
+               (valid && current.Value(id) != old->Value(id));
+      },
+      [&](node_or_edge id) { return current.IsValid(id); },
+      [&](node_or_edge a, node_or_edge b) {
+        std::less<c_type> less;
+        c_type value_a = current.Value(a);
+        c_type value_b = current.Value(b);
+        return less(value_a, value_b) || (!less(value_b, value_a) && a < b);
+      });
+  GatherKeys();
 
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge, typename c_type>
+void
+PrimitiveEntityIndex<node_or_edge, c_type>::GatherKeys() {
+  const ArrowArrayType& property = *property_;
+  keys_.allocateInterleaved(this->num_ids_);
+  katana::do_all(
+      katana::iterate(size_t{0}, this->num_ids_),
+      [&](size_t i) { keys_[i] = property.Value(this->ids_data_[i]); },
+      katana::no_stats());
+  keys_data_ = keys_.data();
+}
+
 template <typename node_or_edge>
 Result<void>
 StringEntityIndex<node_or_edge>::BuildFromProperty() {
@@ -75,15 +278,67 @@ StringEntityIndex<node_or_edge>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
+  if (codes_ == nullptr) {
+    this->num_ids_ = SortIDs(
+        *property_, num_entities_, &this->ids_,
+        [this](node_or_edge a, node_or_edge b) {
+          int order = ValueOf(a).compare(ValueOf(b));
+          return order < 0 || (order == 0 && a < b);
+        });
+    this->ids_data_ = this->ids_.data();
+    return katana::ResultSuccess();
   }
 
+  // Codes are ranked once, so that the sort compares integers; the ranks
+  // are only needed while building
+  std::vector<int32_t> ranks = internal::RankStrings(*strings_);
+  const int32_t* codes = codes_;
+  this->num_ids_ = SortIDs(
+      *property_, num_entities_, &this->ids_,
+      [&ranks, codes](node_or_edge a, node_or_edge b) {
+        int32_t rank_a = ranks[codes[a]];
+        int32_t rank_b = ranks[codes[b]];
+        return rank_a < rank_b || (rank_a == rank_b && a < b);
+      });
+  this->ids_data_ = this->ids_.data();
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringEntityIndex<node_or_edge>::UpdateFromProperty(
+    std::shared_ptr<arrow::Array> property) {
+  KATANA_CHECKED(CheckUpdate(*property_, *property, num_entities_));
+
+  // Keeps old_strings and old_codes alive
+  std::shared_ptr<arrow::Array> old = property_;
+  std::shared_ptr<arrow::LargeStringArray> old_strings = strings_;
+  const int32_t* old_codes = codes_;
+  SetProperty(property);
+  // With the same dictionary, entities whose codes are equal are unchanged
+  bool same_dictionary = codes_ != nullptr && strings_ == old_strings;
+  this->MergeChanged(
+      num_entities_,
+      [&](node_or_edge id) {
+        bool valid = property_->IsValid(id);
+        if (valid != old->IsValid(id)) {
+          return true;
+        }
+        if (!valid) {
+          return false;
+        }
+        if (same_dictionary) {
+          return codes_[id] != old_codes[id];
+        }
+        return ValueOf(id) != ValueIn(*old_strings, old_codes, id);
+      },
+      [&](node_or_edge id) { return property_->IsValid(id); },
+      [this](node_or_edge a, node_or_edge b) {
+        int order = ValueOf(a).compare(ValueOf(b));
+        return order < 0 || (order == 0 && a < b);
+      });
+
   return katana::ResultSuccess();
 }
 
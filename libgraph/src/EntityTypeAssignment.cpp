@@ -0,0 +1,122 @@
+#include "katana/EntityTypeAssignment.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+
+namespace {
+
+/// The labels of an entity, sorted and without repeats, as one string: the
+/// length of every label followed by the label, so that no two combinations
+/// of labels are the same string
+using LabelsKey = std::string;
+
+/// The type of a combination of labels, once it is resolved
+struct LabelsType {
+  katana::EntityTypeID type{katana::kUnknownEntityType};
+};
+
+/// The combinations of labels seen by a thread; the elements of an
+/// unordered_map stay where they are as it grows
+struct LocalLabels {
+  std::unordered_map<LabelsKey, LabelsType> types;
+
+  /// Scratch for the labels and the key of an entity
+  std::vector<std::string_view> labels;
+  LabelsKey key;
+};
+
+void
+MakeKey(std::vector<std::string_view>* labels, LabelsKey* key) {
+  labels->erase(
+      std::remove(labels->begin(), labels->end(), std::string_view()),
+      labels->end());
+  std::sort(labels->begin(), labels->end());
+  labels->erase(std::unique(labels->begin(), labels->end()), labels->end());
+  key->clear();
+  for (std::string_view label : *labels) {
+    uint32_t size = label.size();
+    key->append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key->append(label);
+  }
+}
+
+std::vector<std::string>
+KeyLabels(const LabelsKey& key) {
+  std::vector<std::string> labels;
+  for (size_t i = 0; i < key.size();) {
+    uint32_t size;
+    std::memcpy(&size, key.data() + i, sizeof(size));
+    i += sizeof(size);
+    labels.emplace_back(key, i, size);
+    i += size;
+  }
+  return labels;
+}
+
+}  // namespace
+
+katana::Result<katana::PropertyGraph::EntityTypeIDArray>
+katana::AssignEntityTypes(
+    uint64_t num_entities, const EntityLabelsFunction& labels_of,
+    EntityTypeManager* manager) {
+  PropertyGraph::EntityTypeIDArray types;
+  types.allocateBlocked(num_entities);
+  // the combination of labels of every entity, or null if it has none
+  katana::NUMAArray<LabelsType*> entity_labels;
+  entity_labels.allocateBlocked(num_entities);
+
+  katana::PerThreadStorage<LocalLabels> local_labels;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_entities),
+      [&](uint64_t i) {
+        LocalLabels& local = *local_labels.getLocal();
+        local.labels.clear();
+        labels_of(i, &local.labels);
+        MakeKey(&local.labels, &local.key);
+        entity_labels[i] =
+            local.key.empty() ? nullptr : &local.types[local.key];
+      },
+      katana::steal(), katana::loopname("AssignEntityTypes-Labels"));
+
+  // The distinct combinations of all the threads, added in sorted order
+  std::vector<const LabelsKey*> keys;
+  for (unsigned t = 0; t < local_labels.size(); ++t) {
+    for (const auto& [key, labels_type] : local_labels.getRemote(t)->types) {
+      keys.emplace_back(&key);
+    }
+  }
+  std::sort(keys.begin(), keys.end(), [](const auto* a, const auto* b) {
+    return *a < *b;
+  });
+  keys.erase(
+      std::unique(
+          keys.begin(), keys.end(),
+          [](const auto* a, const auto* b) { return *a == *b; }),
+      keys.end());
+  std::unordered_map<std::string_view, EntityTypeID> key_types;
+  for (const LabelsKey* key : keys) {
+    key_types.emplace(
+        *key, KATANA_CHECKED(manager->GetOrAddNonAtomicEntityTypeFromStrings(
+                  KeyLabels(*key))));
+  }
+  for (unsigned t = 0; t < local_labels.size(); ++t) {
+    for (auto& [key, labels_type] : local_labels.getRemote(t)->types) {
+      labels_type.type = key_types.at(key);
+    }
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_entities),
+      [&](uint64_t i) {
+        types[i] = entity_labels[i] != nullptr ? entity_labels[i]->type
+                                               : kUnknownEntityType;
+      },
+      katana::no_stats());
+  return MakeResult(std::move(types));
+}
@@ -17,13 +17,138 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
 #include <condition_variable>
+#include <cstdlib>
+#include <cstring>
 #include <mutex>
 
+#include "katana/BufferedGraph.h"
 #include "katana/FileGraph.h"
 #include "katana/HWTopo.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/ThreadPool.h"
 
+namespace {
+
+/// Bytes read at once by a thread of ReadFileRangeParallel
+constexpr uint64_t kReadBlock = uint64_t{8} << 20;
+/// The alignment of the offsets, sizes and buffers of direct reads
+constexpr uint64_t kDirectAlign = 4096;
+
+/// Read size bytes at offset, or up to the end of the file; returns the
+/// bytes read or -1 on error
+ssize_t
+PReadAll(int fd, char* buf, uint64_t size, uint64_t offset) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t n = pread(fd, buf + done, size - done, offset + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    done += n;
+  }
+  return done;
+}
+
+/// A buffer aligned for direct reads of a block
+struct DirectBuffer {
+  char* data{nullptr};
+
+  char* get() {
+    if (data == nullptr) {
+      data = static_cast<char*>(
+          std::aligned_alloc(kDirectAlign, kReadBlock + 2 * kDirectAlign));
+      if (data == nullptr) {
+        KATANA_DIE("Failed to allocate memory for direct reads.");
+      }
+    }
+    return data;
+  }
+
+  ~DirectBuffer() { std::free(data); }
+};
+
+}  // namespace
+
+void
+katana::ReadFileRangeParallel(
+    const std::string& filename, uint64_t offset, uint64_t size, void* buffer,
+    bool direct) {
+  if (size == 0) {
+    return;
+  }
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    KATANA_DIE("failed to open ", filename, ": ", std::strerror(errno));
+  }
+  // not every file system supports direct I/O, e.g., tmpfs; reads fall back
+  // to fd where it is not
+  int direct_fd = -1;
+#ifdef O_DIRECT
+  if (direct) {
+    direct_fd = open(filename.c_str(), O_RDONLY | O_DIRECT);
+  }
+#endif
+
+  katana::PerThreadStorage<DirectBuffer> direct_buffers;
+  katana::GAccumulator<uint64_t> failed_blocks;
+  uint64_t num_blocks = (size + kReadBlock - 1) / kReadBlock;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        uint64_t begin = offset + b * kReadBlock;
+        uint64_t end = std::min(begin + kReadBlock, offset + size);
+        char* dst = static_cast<char*>(buffer) + (begin - offset);
+
+        if (direct_fd >= 0) {
+          auto dst_address = reinterpret_cast<uintptr_t>(dst);
+          if ((begin | end | dst_address) % kDirectAlign == 0 &&
+              PReadAll(direct_fd, dst, end - begin, begin) ==
+                  static_cast<ssize_t>(end - begin)) {
+            return;
+          }
+          uint64_t aligned_begin = begin / kDirectAlign * kDirectAlign;
+          uint64_t aligned_end =
+              (end + kDirectAlign - 1) / kDirectAlign * kDirectAlign;
+          char* aligned = direct_buffers.getLocal()->get();
+          ssize_t n = PReadAll(
+              direct_fd, aligned, aligned_end - aligned_begin, aligned_begin);
+          // a read past the end of the file is short but still aligned
+          if (n >= 0 && aligned_begin + n >= end) {
+            std::memcpy(dst, aligned + (begin - aligned_begin), end - begin);
+            return;
+          }
+        }
+
+        if (PReadAll(fd, dst, end - begin, begin) !=
+            static_cast<ssize_t>(end - begin)) {
+          failed_blocks += 1;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (direct_fd >= 0) {
+    close(direct_fd);
+  }
+  close(fd);
+  if (failed_blocks.reduce() > 0) {
+    KATANA_DIE(
+        "failed to read ", size, " bytes at ", offset, " of ", filename);
+  }
+}
+
 namespace katana {
 
 void
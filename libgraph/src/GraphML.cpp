@@ -3,9 +3,12 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
@@ -322,13 +325,120 @@ ProcessData(xmlTextReaderPtr reader) {
   return make_pair(key, propertyData);
 }
 
+/*
+ * adds the property key of the element being built to builder, with value
+ * resolved to the type of the key
+ */
+void
+AddStringValue(
+    katana::PropertyGraphBuilder* builder, const std::string& key,
+    const std::string& value) {
+  builder->AddValue(
+      key, [&]() { return PropertyKey{key, ImportDataType::kString, false}; },
+      [&value](ImportDataType type, bool is_list) {
+        return ResolveValue(value, type, is_list);
+      });
+}
+
+/*
+ * the calls that parsing a chunk of the elements of a graph makes on its
+ * builder, recorded by a thread to be replayed on the builder of the graph
+ * in the order of the chunks, so that nodes get the indexes they would get
+ * from parsing the whole graph in order
+ */
+class RecordedElements {
+public:
+  bool StartNode(const std::string& id) {
+    events_.emplace_back(Event{Kind::kStartNode, id, {}});
+    return true;
+  }
+  bool StartEdge(const std::string& source, const std::string& target) {
+    events_.emplace_back(Event{Kind::kStartEdge, source, target});
+    return true;
+  }
+  void AddValue(const std::string& key, const std::string& value) {
+    events_.emplace_back(Event{Kind::kValue, key, value});
+  }
+  void AddLabel(const std::string& name) {
+    events_.emplace_back(Event{Kind::kLabel, name, {}});
+  }
+  bool FinishNode() {
+    events_.emplace_back(Event{Kind::kFinishNode, {}, {}});
+    return true;
+  }
+  bool FinishEdge() {
+    events_.emplace_back(Event{Kind::kFinishEdge, {}, {}});
+    return true;
+  }
+
+  // makes the recorded calls on builder; the calls for an edge that builder
+  // does not start are dropped, as they are when parsing into it
+  void Replay(katana::PropertyGraphBuilder* builder) const {
+    bool valid = true;
+    for (const Event& event : events_) {
+      switch (event.kind) {
+      case Kind::kStartNode:
+        builder->StartNode(event.first);
+        valid = true;
+        break;
+      case Kind::kStartEdge:
+        valid = builder->StartEdge(event.first, event.second);
+        break;
+      case Kind::kValue:
+        if (valid) {
+          AddStringValue(builder, event.first, event.second);
+        }
+        break;
+      case Kind::kLabel:
+        if (valid) {
+          builder->AddLabel(event.first);
+        }
+        break;
+      case Kind::kFinishNode:
+        builder->FinishNode();
+        break;
+      case Kind::kFinishEdge:
+        if (valid) {
+          builder->FinishEdge();
+        }
+        break;
+      }
+    }
+  }
+
+private:
+  enum class Kind {
+    kStartNode,
+    kStartEdge,
+    kValue,
+    kLabel,
+    kFinishNode,
+    kFinishEdge,
+  };
+  struct Event {
+    Kind kind;
+    std::string first;
+    std::string second;
+  };
+
+  std::vector<Event> events_;
+};
+
+void
+AddStringValue(
+    RecordedElements* elements, const std::string& key,
+    const std::string& value) {
+  elements->AddValue(key, value);
+}
+
 /*
  * reader should be pointing at the node element before calling
  *
  * parses the node from a GraphML file into readable form
  */
+template <typename Builder>
 void
-ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+ProcessNode(xmlTextReaderPtr reader, Builder* builder) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
@@ -402,16 +512,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
             }
           } else if (property.first != std::string("IGNORE")) {
             if (validNode) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
+              AddStringValue(builder, property.first, property.second);
             }
           }
         }
@@ -442,8 +543,9 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  *
  * parses the edge from a GraphML file into readable form
  */
+template <typename Builder>
 void
-ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+ProcessEdge(xmlTextReaderPtr reader, Builder* builder) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
@@ -510,16 +612,7 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
             }
           } else if (property.first != std::string("IGNORE")) {
             if (valid_edge) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
+              AddStringValue(builder, property.first, property.second);
             }
           }
         }
@@ -547,10 +640,9 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  *
  * parses the graph structure from a GraphML file into Galois format
  */
+template <typename Builder>
 void
-ProcessGraph(
-    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
-    bool verbose) {
+ProcessGraph(xmlTextReaderPtr reader, Builder* builder, bool verbose) {
   auto minimum_depth = xmlTextReaderDepth(reader);
   int ret = xmlTextReaderRead(reader);
 
@@ -592,35 +684,16 @@ ProcessGraph(
   }
 }
 
-}  // end of unnamed namespace
-
-katana::Result<katana::GraphComponents>
-katana::ConvertGraphML(
-    const std::string& infilename, size_t chunk_size, bool verbose) {
-  xmlTextReaderPtr reader;
-
-  reader = xmlNewTextReaderFilename(infilename.c_str());
-  if (reader == NULL) {
-    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
-  }
-  auto res = ConvertGraphML(reader, chunk_size, verbose);
-  xmlFreeTextReader(reader);
-  return res;
-}
-
-katana::Result<katana::GraphComponents>
-katana::ConvertGraphML(
-    xmlTextReaderPtr reader, size_t chunk_size, bool verbose) {
+/*
+ * read in "key" xml nodes and add them to builder until the reader reaches
+ * the first "graph" xml node
+ *
+ * returns 1 if the reader is at the graph, or the result of the last read
+ */
+int
+ProcessKeys(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
   int ret = 0;
-  bool finishedGraph = false;
-
-  katana::PropertyGraphBuilder builder{chunk_size};
-
-  // procedure:
-  // read in "key" xml nodes and add them to nodeKeys and edgeKeys
-  // once we reach the first "graph" xml node we parse it using the above keys
-  // once we have parsed the first "graph" xml node we exit
-  while ((ret = xmlTextReaderRead(reader)) == 1 && !finishedGraph) {
+  while ((ret = xmlTextReaderRead(reader)) == 1) {
     xmlChar* name = xmlTextReaderName(reader);
     if (name == NULL) {
       name = xmlStrdup(BAD_CAST "--");
@@ -633,28 +706,415 @@ katana::ConvertGraphML(
         if (!key.id.empty() && key.id != std::string("label") &&
             key.id != std::string("IGNORE")) {
           if (key.for_node) {
-            builder.AddBuilder(std::move(key));
+            builder->AddBuilder(std::move(key));
           } else if (key.for_edge) {
-            builder.AddBuilder(std::move(key));
+            builder->AddBuilder(std::move(key));
           }
         }
       } else if (xmlStrEqual(name, BAD_CAST "graph")) {
-        if (verbose) {
-          std::cout << "Finished processing property headers\n";
-        }
-        ProcessGraph(reader, &builder, false);
-        finishedGraph = true;
+        xmlFree(name);
+        return 1;
       }
     }
     xmlFree(name);
   }
+  return ret;
+}
+
+const char* const kIncorrectFormat =
+    "failed to parse: incorrect xml format\n"
+    "Please verify there are no illegal characters in the GraphML file\n"
+    "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
+    "<file>\", warning this will alter the original file";
+
+/*******************************************************/
+/* Functions for splitting GraphML files into elements */
+/*******************************************************/
+
+constexpr size_t npos = std::string_view::npos;
+
+/*
+ * the offset just past the tag that starts at pos in text, which may hold
+ * '>' in quoted attribute values, or npos if text ends before it does
+ */
+size_t
+TagEnd(std::string_view text, size_t pos) {
+  char quote = 0;
+  for (size_t i = pos + 1; i < text.size(); ++i) {
+    char c = text[i];
+    if (quote != 0) {
+      quote = c == quote ? 0 : quote;
+    } else if (c == '"' || c == '\'') {
+      quote = c;
+    } else if (c == '>') {
+      return i + 1;
+    }
+  }
+  return npos;
+}
+
+/*
+ * the name of the tag that starts at pos in text, which holds all of it
+ */
+std::string_view
+TagName(std::string_view text, size_t pos) {
+  size_t begin = pos + (text[pos + 1] == '/' ? 2 : 1);
+  size_t end = text.find_first_of(" \t\r\n/>", begin);
+  return text.substr(begin, end - begin);
+}
+
+/*
+ * the offset just past the markup that is not an element, e.g., a comment,
+ * that starts at pos in text, or npos if text ends before it does
+ */
+size_t
+OtherMarkupEnd(std::string_view text, size_t pos) {
+  auto past = [&](std::string_view end) {
+    size_t found = text.find(end, pos);
+    return found == npos ? npos : found + end.size();
+  };
+  std::string_view rest = text.substr(pos);
+  if (rest.substr(0, 4) == "<!--") {
+    return past("-->");
+  }
+  if (rest.substr(0, 9) == "<![CDATA[") {
+    return past("]]>");
+  }
+  if (rest.substr(0, 2) == "<?") {
+    return past("?>");
+  }
+  // a document type, whose internal subset may hold '>'
+  size_t bracket = text.find('[', pos);
+  size_t end = text.find('>', pos);
+  if (bracket != npos && bracket < end) {
+    size_t close = text.find(']', bracket);
+    end = close == npos ? npos : text.find('>', close);
+  }
+  return end == npos ? npos : end + 1;
+}
+
+/*
+ * whether the markup that starts at pos in text is an element
+ */
+bool
+IsElementTag(std::string_view text, size_t pos) {
+  return pos + 1 < text.size() && text[pos + 1] != '!' && text[pos + 1] != '?';
+}
+
+/*
+ * the offset just past the xml content that starts at pos in text: text up
+ * to the next markup, an element with everything in it, or other markup.
+ * Returns npos if text may end before the content does, and sets
+ * *end_of_parent and returns pos if the content is the end tag of its
+ * parent.
+ */
+size_t
+ContentEnd(std::string_view text, size_t pos, bool* end_of_parent) {
+  // the longest prefix that tells markup apart is "<![CDATA["
+  constexpr size_t kLongestPrefix = 9;
+  size_t depth = 0;
+  do {
+    if (text[pos] != '<') {
+      pos = text.find('<', pos);
+      if (pos == npos || depth == 0) {
+        return pos;
+      }
+      continue;
+    }
+    if (pos + kLongestPrefix > text.size()) {
+      return npos;
+    }
+    if (!IsElementTag(text, pos) || text.substr(pos, 4) == "<!--" ||
+        text.substr(pos, 9) == "<![CDATA[") {
+      pos = OtherMarkupEnd(text, pos);
+    } else if (text[pos + 1] == '/') {
+      if (depth == 0) {
+        *end_of_parent = true;
+        return pos;
+      }
+      pos = TagEnd(text, pos);
+      --depth;
+    } else {
+      size_t end = TagEnd(text, pos);
+      if (end != npos && text[end - 2] != '/') {
+        ++depth;
+      }
+      pos = end;
+    }
+    if (pos == npos || pos == text.size()) {
+      return depth == 0 ? pos : npos;
+    }
+  } while (depth > 0);
+  return pos;
+}
+
+/*
+ * where the graph of a GraphML file starts: the text before the content of
+ * its root element, the start tag of its graph element and the name of its
+ * root element
+ */
+struct GraphMLHeader {
+  size_t root_end{0};
+  size_t graph_begin{0};
+  size_t graph_end{0};
+  std::string root_name;
+  bool empty_graph{false};
+};
+
+/*
+ * finds the header of the GraphML file at the start of text. Returns
+ * nullopt if text may end before the start tag of the graph, and a header
+ * whose graph_begin is npos if the file has no graph.
+ */
+std::optional<GraphMLHeader>
+ScanHeader(std::string_view text) {
+  GraphMLHeader header;
+  size_t pos = 0;
+  // the prolog, up to the root element
+  while (true) {
+    pos = text.find('<', pos);
+    if (pos == npos || pos + 1 >= text.size()) {
+      return std::nullopt;
+    }
+    if (IsElementTag(text, pos)) {
+      break;
+    }
+    pos = OtherMarkupEnd(text, pos);
+    if (pos == npos) {
+      return std::nullopt;
+    }
+  }
+  header.root_end = TagEnd(text, pos);
+  if (header.root_end == npos) {
+    return std::nullopt;
+  }
+  header.root_name = std::string(TagName(text, pos));
+
+  // the keys and other content of the root, up to the graph
+  pos = header.root_end;
+  while (true) {
+    if (pos == text.size()) {
+      return std::nullopt;
+    }
+    if (text[pos] == '<' && pos + 1 < text.size() && text[pos + 1] != '/' &&
+        IsElementTag(text, pos) && TagName(text, pos) == "graph") {
+      header.graph_begin = pos;
+      header.graph_end = TagEnd(text, pos);
+      if (header.graph_end == npos) {
+        return std::nullopt;
+      }
+      header.empty_graph = text[header.graph_end - 2] == '/';
+      return header;
+    }
+    bool end_of_root = false;
+    pos = ContentEnd(text, pos, &end_of_root);
+    if (end_of_root) {
+      header.graph_begin = npos;
+      return header;
+    }
+    if (pos == npos) {
+      return std::nullopt;
+    }
+  }
+}
+
+/*
+ * a GraphML file read a window at a time, so that it can be split into
+ * chunks without holding all of it
+ */
+class FileWindow {
+public:
+  bool Open(const std::string& path) {
+    in_.open(path, std::ios::binary);
+    return in_.is_open();
+  }
+
+  // the bytes read and not consumed
+  std::string_view text() const {
+    return std::string_view(buffer_).substr(begin_);
+  }
+
+  void Consume(size_t n) { begin_ += n; }
+
+  // read up to n more bytes; returns false at the end of the file
+  bool Fill(size_t n) {
+    buffer_.erase(0, begin_);
+    begin_ = 0;
+    size_t old_size = buffer_.size();
+    buffer_.resize(old_size + n);
+    in_.read(buffer_.data() + old_size, n);
+    buffer_.resize(old_size + in_.gcount());
+    return in_.gcount() > 0;
+  }
+
+private:
+  std::ifstream in_;
+  std::string buffer_;
+  size_t begin_{0};
+};
+
+/*
+ * parses document, a chunk of the elements of a graph wrapped in the start
+ * tags of the root element and of the graph, into elements
+ *
+ * returns false if the chunk is not well formed
+ */
+bool
+ParseChunk(const std::string& document, RecordedElements* elements) {
+  xmlTextReaderPtr reader = xmlReaderForMemory(
+      document.data(), document.size(), nullptr, nullptr, 0);
+  if (reader == nullptr) {
+    return false;
+  }
+  int ret = 0;
+  while ((ret = xmlTextReaderRead(reader)) == 1) {
+    if (xmlTextReaderNodeType(reader) == 1 &&
+        xmlStrEqual(xmlTextReaderConstName(reader), BAD_CAST "graph")) {
+      ProcessGraph(reader, elements, false);
+      break;
+    }
+  }
+  // errors stick, so a chunk that failed in the graph fails here as well
+  while (ret == 1) {
+    ret = xmlTextReaderRead(reader);
+  }
+  xmlFreeTextReader(reader);
+  return ret == 0;
+}
+
+}  // end of unnamed namespace
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphML(
+    const std::string& infilename, size_t chunk_size, bool verbose,
+    size_t chunk_budget) {
+  // libxml2 must be initialized before threads parse with it
+  xmlInitParser();
+  FileWindow file;
+  if (!file.Open(infilename)) {
+    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+  chunk_budget = std::max<size_t>(chunk_budget, 1);
+  size_t num_chunks = katana::getActiveThreads();
+  size_t window_size = chunk_budget * num_chunks;
+
+  std::optional<GraphMLHeader> header;
+  bool more = true;
+  while (!(header = ScanHeader(file.text())) && more) {
+    more = file.Fill(window_size);
+  }
+  if (!header) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "{}", kIncorrectFormat);
+  }
+
+  katana::PropertyGraphBuilder builder{chunk_size};
+  std::string_view text = file.text();
+  std::string prefix;
+  std::string suffix;
+  // the keys, with the graph closed so that they are well formed on their
+  // own, or the whole file if it has no graph
+  std::string keys(text);
+  if (header->graph_begin != npos) {
+    prefix = std::string(text.substr(0, header->root_end)) +
+             std::string(text.substr(
+                 header->graph_begin, header->graph_end - header->graph_begin));
+    suffix = (header->empty_graph ? "" : "</graph>") +
+             ("</" + header->root_name + ">");
+    keys = std::string(text.substr(0, header->graph_end)) + suffix;
+  }
+  xmlTextReaderPtr reader =
+      xmlReaderForMemory(keys.data(), keys.size(), nullptr, nullptr, 0);
+  if (reader == nullptr) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "{}", kIncorrectFormat);
+  }
+  int ret = ProcessKeys(reader, &builder);
+  xmlFreeTextReader(reader);
+  if (ret < 0) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "{}", kIncorrectFormat);
+  }
+  if (verbose) {
+    std::cout << "Finished processing property headers\n";
+  }
+  file.Consume(header->graph_end);
+
+  // procedure:
+  // cut the elements in the window into chunks of about chunk_budget bytes
+  // parse the chunks in parallel, each between the start tags of the root
+  // and of the graph, then replay them on the builder in order
+  bool finished_graph = header->graph_begin == npos || header->empty_graph;
+  while (!finished_graph) {
+    text = file.text();
+    std::vector<std::string_view> chunks;
+    size_t pos = 0;
+    size_t chunk_begin = 0;
+    bool incomplete = false;
+    while (chunks.size() < num_chunks && pos < text.size()) {
+      size_t end = ContentEnd(text, pos, &finished_graph);
+      if (finished_graph) {
+        break;
+      }
+      if (end == npos) {
+        incomplete = true;
+        break;
+      }
+      pos = end;
+      if (pos - chunk_begin >= chunk_budget) {
+        chunks.emplace_back(text.substr(chunk_begin, pos - chunk_begin));
+        chunk_begin = pos;
+      }
+    }
+    if (pos > chunk_begin && chunks.size() < num_chunks) {
+      chunks.emplace_back(text.substr(chunk_begin, pos - chunk_begin));
+    }
+
+    std::vector<RecordedElements> elements(chunks.size());
+    std::vector<uint8_t> parsed(chunks.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, chunks.size()),
+        [&](size_t i) {
+          std::string document = prefix;
+          document += chunks[i];
+          document += suffix;
+          parsed[i] = ParseChunk(document, &elements[i]);
+        },
+        katana::no_stats());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      if (!parsed[i]) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "{}", kIncorrectFormat);
+      }
+      elements[i].Replay(&builder);
+    }
+    file.Consume(pos);
+
+    if ((incomplete || pos == text.size()) && !finished_graph &&
+        !file.Fill(window_size)) {
+      // the file ends inside the graph
+      return KATANA_ERROR(ErrorCode::InvalidArgument, "{}", kIncorrectFormat);
+    }
+  }
+  return builder.Finish(verbose);
+}
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphML(
+    xmlTextReaderPtr reader, size_t chunk_size, bool verbose) {
+  katana::PropertyGraphBuilder builder{chunk_size};
+
+  // procedure:
+  // read in "key" xml nodes and add them to nodeKeys and edgeKeys
+  // once we reach the first "graph" xml node we parse it using the above keys
+  // once we have parsed the first "graph" xml node we exit
+  int ret = ProcessKeys(reader, &builder);
+  if (ret == 1) {
+    if (verbose) {
+      std::cout << "Finished processing property headers\n";
+    }
+    ProcessGraph(reader, &builder, false);
+    ret = xmlTextReaderRead(reader);
+  }
   if (ret < 0) {
-    return KATANA_ERROR(
-        ErrorCode::InvalidArgument,
-        "failed to parse: incorrect xml format\n"
-        "Please verify there are no illegal characters in the GraphML file\n"
-        "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
-        "<file>\", warning this will alter the original file");
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "{}", kIncorrectFormat);
   }
   return builder.Finish(verbose);
 }
@@ -0,0 +1,241 @@
+#include "katana/GraphStatistics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Number of nodes sampled for the degree distribution, as in
+/// IsApproximateDegreeDistributionPowerLaw
+constexpr uint32_t kNumDegreeSamples = 1000;
+/// Number of edges sampled for symmetry
+constexpr uint32_t kNumEdgeSamples = 4096;
+/// Sampled edges whose destination has more edges than this and that are not
+/// sorted are skipped rather than scanned for the reverse edge
+constexpr uint64_t kMaxReverseScan = 1 << 12;
+/// Number of double sweeps for the diameter
+constexpr uint32_t kNumDiameterSweeps = 2;
+/// A graph is small world if its diameter is at most this many times the
+/// logarithm of its size
+constexpr double kSmallWorldDiameterFactor = 4;
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+/// The destinations of the edges of n
+std::pair<const Node*, const Node*>
+Dests(const katana::GraphTopology& topo, Node n) {
+  auto edges = topo.OutEdges(n);
+  return {topo.DestData() + *edges.begin(), topo.DestData() + *edges.end()};
+}
+
+/// One pass over the edges for the exact statistics
+void
+ScanEdges(const katana::GraphTopology& topo, katana::GraphStatistics* stats) {
+  katana::GReduceMax<uint64_t> max_degree;
+  katana::GReduceLogicalAnd sorted;
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(topo.NumNodes())),
+      [&](Node n) {
+        auto [first, last] = Dests(topo, n);
+        max_degree.update(last - first);
+        if (!std::is_sorted(first, last)) {
+          sorted.update(false);
+        }
+      },
+      katana::steal(), katana::loopname("GraphStatistics-ScanEdges"));
+  stats->max_degree = max_degree.reduce();
+  stats->edges_sorted = sorted.reduce();
+}
+
+/// Samples the degrees of the nodes with edges
+void
+SampleDegrees(
+    const katana::GraphTopology& topo, katana::GraphStatistics* stats) {
+  uint64_t num_nodes = topo.NumNodes();
+  std::vector<uint64_t> samples;
+  for (uint64_t i = 0; samples.size() < std::min<uint64_t>(
+                                            kNumDegreeSamples, num_nodes) &&
+                       i < 16 * kNumDegreeSamples;
+       ++i) {
+    Node n = katana::StatelessRandom(1, i) % num_nodes;
+    if (uint64_t degree = topo.OutDegree(n); degree > 0) {
+      samples.emplace_back(degree);
+    }
+  }
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sample_average = 0;
+  for (uint64_t degree : samples) {
+    sample_average += degree;
+  }
+  sample_average /= samples.size();
+  stats->median_degree = samples[samples.size() / 2];
+  stats->degree_skew = sample_average / stats->median_degree;
+  stats->power_law = num_nodes >= 10 && topo.NumEdges() / num_nodes >= 10 &&
+                     sample_average / 1.3 > stats->median_degree;
+}
+
+/// Whether the edge from src to dst has a reverse edge
+bool
+HasReverse(const katana::GraphTopology& topo, Node src, Node dst, bool sorted) {
+  auto [first, last] = Dests(topo, dst);
+  if (sorted) {
+    return std::binary_search(first, last, src);
+  }
+  return std::find(first, last, src) != last;
+}
+
+void
+SampleSymmetry(
+    const katana::GraphTopology& topo, katana::GraphStatistics* stats) {
+  uint64_t num_edges = topo.NumEdges();
+  if (num_edges == 0) {
+    stats->symmetry = 1;
+    stats->symmetric = true;
+    return;
+  }
+  katana::GAccumulator<uint64_t> checked;
+  katana::GAccumulator<uint64_t> reversed;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNumEdgeSamples),
+      [&](uint32_t i) {
+        uint64_t e = katana::StatelessRandom(2, i) % num_edges;
+        Node src = topo.GetEdgeSrc(e);
+        Node dst = topo.OutEdgeDst(e);
+        if (!stats->edges_sorted && topo.OutDegree(dst) > kMaxReverseScan) {
+          return;
+        }
+        checked += 1;
+        if (HasReverse(topo, src, dst, stats->edges_sorted)) {
+          reversed += 1;
+        }
+      },
+      katana::loopname("GraphStatistics-SampleSymmetry"));
+  uint64_t num_checked = checked.reduce();
+  uint64_t num_reversed = reversed.reduce();
+  stats->symmetry =
+      num_checked == 0 ? 0 : static_cast<double>(num_reversed) / num_checked;
+  stats->symmetric = num_checked > 0 && num_reversed == num_checked;
+}
+
+/// A parallel BFS from source; returns the least of the farthest nodes and
+/// their distance
+std::pair<Node, uint32_t>
+Sweep(
+    const katana::GraphTopology& topo, Node source,
+    katana::NUMAArray<std::atomic<uint32_t>>* level) {
+  katana::do_all(
+      katana::iterate(size_t{0}, level->size()),
+      [&](size_t n) {
+        (*level)[n].store(kUnvisited, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  (*level)[source] = 0;
+
+  std::vector<Node> frontier{source};
+  uint32_t depth = 0;
+  for (;;) {
+    katana::InsertBag<Node> next;
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](Node n) {
+          for (auto e : topo.OutEdges(n)) {
+            Node dst = topo.OutEdgeDst(e);
+            uint32_t expected = kUnvisited;
+            if ((*level)[dst].load(std::memory_order_relaxed) == kUnvisited &&
+                (*level)[dst].compare_exchange_strong(expected, depth + 1)) {
+              next.push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (next.empty()) {
+      break;
+    }
+    frontier.assign(next.begin(), next.end());
+    ++depth;
+  }
+  return {*std::min_element(frontier.begin(), frontier.end()), depth};
+}
+
+void
+EstimateDiameter(
+    const katana::GraphTopology& topo, katana::GraphStatistics* stats) {
+  uint64_t num_nodes = topo.NumNodes();
+  if (num_nodes == 0) {
+    return;
+  }
+  katana::NUMAArray<std::atomic<uint32_t>> level;
+  level.allocateBlocked(num_nodes);
+
+  // Sweep from a node with edges, then from the farthest node it found
+  uint32_t diameter = 0;
+  for (uint32_t sweep = 0; sweep < kNumDiameterSweeps; ++sweep) {
+    Node source = katana::StatelessRandom(3, sweep) % num_nodes;
+    for (uint64_t i = 0; i < num_nodes && topo.OutDegree(source) == 0; ++i) {
+      source = (source + 1) % num_nodes;
+    }
+    auto [farthest, depth] = Sweep(topo, source, &level);
+    diameter = std::max(diameter, depth);
+    diameter = std::max(diameter, Sweep(topo, farthest, &level).second);
+  }
+  stats->estimated_diameter = diameter;
+}
+
+}  // namespace
+
+bool
+katana::GraphStatistics::small_world() const {
+  return estimated_diameter <=
+         kSmallWorldDiameterFactor *
+             std::log2(std::max<double>(num_nodes, 2));
+}
+
+std::string
+katana::GraphStatistics::ToString() const {
+  return fmt::format(
+      "nodes: {}, edges: {}, average degree: {:.2f}, max degree: {}, median "
+      "degree: {}, degree skew: {:.2f}, power law: {}, estimated diameter: "
+      "{}, edges sorted: {}, symmetry: {:.3f}",
+      num_nodes, num_edges, average_degree, max_degree, median_degree,
+      degree_skew, power_law, estimated_diameter, edges_sorted, symmetry);
+}
+
+katana::GraphStatistics
+katana::ComputeGraphStatistics(const GraphTopology& topo) {
+  katana::StatTimer timer("GraphStatistics");
+  timer.start();
+
+  GraphStatistics stats;
+  stats.num_nodes = topo.NumNodes();
+  stats.num_edges = topo.NumEdges();
+  if (stats.num_nodes > 0) {
+    stats.average_degree =
+        static_cast<double>(stats.num_edges) / stats.num_nodes;
+  }
+  ScanEdges(topo, &stats);
+  SampleDegrees(topo, &stats);
+  SampleSymmetry(topo, &stats);
+  EstimateDiameter(topo, &stats);
+
+  timer.stop();
+  return stats;
+}
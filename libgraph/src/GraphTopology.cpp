@@ -2,13 +2,27 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <optional>
 
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ProgressTracer.h"
 #include "katana/PropertyGraph.h"
 #include "katana/RDGTopology.h"
+#include "katana/RadixSort.h"
 #include "katana/Random.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
+#include "katana/TopologyManager.h"
 
 katana::GraphTopology::~GraphTopology() = default;
 
@@ -26,6 +40,13 @@ katana::GraphTopology::Print() const noexcept {
   print_array(dests_, "dests_");
 }
 
+size_t
+katana::GraphTopology::ApproxMemUse() const noexcept {
+  return adj_indices_.size() * sizeof(Edge) + dests_.size() * sizeof(Node) +
+         edge_prop_indices_.size() * sizeof(PropertyIndex) +
+         node_prop_indices_.size() * sizeof(PropertyIndex);
+}
+
 katana::GraphTopology::GraphTopology(
     const Edge* adj_indices, size_t num_nodes, const Node* dests,
     size_t num_edges) noexcept {
@@ -75,6 +96,18 @@ katana::GraphTopology::GraphTopology(
       edge_prop_indices_(std::move(edge_prop_indices)),
       node_prop_indices_(std::move(node_prop_indices)) {}
 
+katana::GraphTopology
+katana::GraphTopology::MakeInPlace(
+    const Edge* adj_indices, size_t num_nodes, const Node* dests,
+    size_t num_edges, std::shared_ptr<const void> storage) noexcept {
+  // NUMAArray only wraps these, it never writes to or frees them
+  GraphTopology topo{
+      AdjIndexVec(const_cast<Edge*>(adj_indices), num_nodes),  // NOLINT
+      EdgeDestVec(const_cast<Node*>(dests), num_edges)};       // NOLINT
+  topo.storage_ = std::move(storage);
+  return topo;
+}
+
 katana::GraphTopology
 katana::GraphTopology::Copy(const GraphTopology& that) noexcept {
   return katana::GraphTopology(
@@ -261,6 +294,232 @@ katana::EdgeShuffleTopology::ToRDGTopology() const {
   return katana::RDGTopology(std::move(topo));
 }
 
+namespace {
+
+using Insertion = katana::EdgeChangeSet::Insertion;
+
+/// Returns the insertions of \p changes as seen by a topology, i.e., reversed
+/// for transposed topologies, sorted by source and then by \p less.
+template <typename Less>
+std::vector<Insertion>
+OrientInsertions(
+    const katana::EdgeChangeSet& changes, bool transposed, const Less& less) {
+  std::vector<Insertion> insertions = changes.insertions;
+  if (transposed) {
+    for (auto& ins : insertions) {
+      std::swap(ins.src, ins.dst);
+    }
+  }
+  katana::ParallelSTL::sort(
+      insertions.begin(), insertions.end(),
+      [&](const Insertion& a, const Insertion& b) {
+        if (a.src != b.src) {
+          return a.src < b.src;
+        }
+        return less(a.dst, a.prop_index, b.dst, b.prop_index);
+      });
+  return insertions;
+}
+
+std::vector<katana::GraphTopology::PropertyIndex>
+SortedDeletions(const katana::EdgeChangeSet& changes) {
+  std::vector<katana::GraphTopology::PropertyIndex> deletions =
+      changes.deletions;
+  katana::ParallelSTL::sort(deletions.begin(), deletions.end());
+  deletions.erase(
+      std::unique(deletions.begin(), deletions.end()), deletions.end());
+  return deletions;
+}
+
+/// Copies the edges of \p topo that are not deleted and merges \p insertions
+/// into them. \p less is the order of the edges of each node in \p topo;
+/// insertions are placed before the first surviving edge they compare less
+/// than, so adjacencies sorted by \p less stay sorted.
+template <typename Less>
+void
+MergeEdgeChanges(
+    const katana::GraphTopology& topo, const std::vector<Insertion>& insertions,
+    const std::vector<katana::GraphTopology::PropertyIndex>& deletions,
+    const Less& less, katana::GraphTopology::AdjIndexVec* adj_indices,
+    katana::GraphTopology::EdgeDestVec* dests,
+    katana::GraphTopology::PropIndexVec* edge_prop_indices) {
+  using Node = katana::GraphTopology::Node;
+  using Edge = katana::GraphTopology::Edge;
+
+  auto is_deleted = [&](Edge e) {
+    return !deletions.empty() &&
+           std::binary_search(
+               deletions.begin(), deletions.end(),
+               topo.GetEdgePropertyIndexFromOutEdge(e));
+  };
+
+  auto node_insertions = [&](Node n) {
+    auto beg = std::lower_bound(
+        insertions.begin(), insertions.end(), n,
+        [](const Insertion& ins, Node n) { return ins.src < n; });
+    auto end = std::upper_bound(
+        beg, insertions.end(), n,
+        [](Node n, const Insertion& ins) { return n < ins.src; });
+    return std::make_pair(beg, end);
+  };
+
+  adj_indices->allocateInterleaved(topo.NumNodes());
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        Edge degree = 0;
+        for (auto e : topo.OutEdges(n)) {
+          if (!is_deleted(e)) {
+            ++degree;
+          }
+        }
+        auto [ins_beg, ins_end] = node_insertions(n);
+        (*adj_indices)[n] = degree + std::distance(ins_beg, ins_end);
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices->begin(), adj_indices->end(), adj_indices->begin());
+
+  const Edge num_edges =
+      topo.NumNodes() > 0 ? (*adj_indices)[topo.NumNodes() - 1] : 0;
+  dests->allocateInterleaved(num_edges);
+  edge_prop_indices->allocateInterleaved(num_edges);
+
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        Edge out = n > 0 ? (*adj_indices)[n - 1] : 0;
+        auto [ins, ins_end] = node_insertions(n);
+
+        auto emit = [&](Node dst, katana::GraphTopology::PropertyIndex prop) {
+          (*dests)[out] = dst;
+          (*edge_prop_indices)[out] = prop;
+          ++out;
+        };
+
+        for (auto e : topo.OutEdges(n)) {
+          if (is_deleted(e)) {
+            continue;
+          }
+          auto dst = topo.OutEdgeDst(e);
+          auto prop = topo.GetEdgePropertyIndexFromOutEdge(e);
+          for (; ins != ins_end && less(ins->dst, ins->prop_index, dst, prop);
+               ++ins) {
+            emit(ins->dst, ins->prop_index);
+          }
+          emit(dst, prop);
+        }
+        for (; ins != ins_end; ++ins) {
+          emit(ins->dst, ins->prop_index);
+        }
+        KATANA_LOG_DEBUG_ASSERT(out == (*adj_indices)[n]);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// Calls \p func with the edge order matching \p sort_kind; \p topo maps
+/// destinations to node properties for kSortedByNodeType
+template <typename Func>
+void
+WithEdgeOrder(
+    const katana::PropertyGraph* pg, const katana::GraphTopology& topo,
+    const katana::RDGTopology::EdgeSortKind& sort_kind, Func&& func) {
+  using Node = katana::GraphTopology::Node;
+  using PropertyIndex = katana::GraphTopology::PropertyIndex;
+
+  switch (sort_kind) {
+  case katana::RDGTopology::EdgeSortKind::kSortedByDestID:
+    return func([](Node dst1, PropertyIndex, Node dst2, PropertyIndex) {
+      return dst1 < dst2;
+    });
+  case katana::RDGTopology::EdgeSortKind::kSortedByEdgeType:
+    return func(
+        [pg](Node dst1, PropertyIndex e1, Node dst2, PropertyIndex e2) {
+          katana::EntityTypeID type1 = pg->GetTypeOfEdgeFromPropertyIndex(e1);
+          katana::EntityTypeID type2 = pg->GetTypeOfEdgeFromPropertyIndex(e2);
+          if (type1 != type2) {
+            return type1 < type2;
+          }
+          return dst1 < dst2;
+        });
+  case katana::RDGTopology::EdgeSortKind::kAny:
+    // unsorted, insertions are appended
+    return func(
+        [](Node, PropertyIndex, Node, PropertyIndex) { return false; });
+  case katana::RDGTopology::EdgeSortKind::kSortedByNodeType:
+    return func(
+        [pg, &topo](Node dst1, PropertyIndex, Node dst2, PropertyIndex) {
+          katana::EntityTypeID type1 = pg->GetTypeOfNodeFromPropertyIndex(
+              topo.GetNodePropertyIndex(dst1));
+          katana::EntityTypeID type2 = pg->GetTypeOfNodeFromPropertyIndex(
+              topo.GetNodePropertyIndex(dst2));
+          if (type1 != type2) {
+            return type1 < type2;
+          }
+          return dst1 < dst2;
+        });
+  default:
+    KATANA_LOG_FATAL("switch-case fell through");
+    return;
+  }
+}
+
+}  // namespace
+
+katana::GraphTopology
+katana::GraphTopology::CopyWithEdgeChanges(
+    const katana::EdgeChangeSet& changes) const noexcept {
+  AdjIndexVec adj_indices;
+  EdgeDestVec dests;
+  PropIndexVec edge_prop_indices;
+
+  auto append = [](Node, PropertyIndex, Node, PropertyIndex) { return false; };
+  MergeEdgeChanges(
+      *this, OrientInsertions(changes, false, append), SortedDeletions(changes),
+      append, &adj_indices, &dests, &edge_prop_indices);
+
+  PropIndexVec node_prop_indices;
+  if (!node_prop_indices_.empty()) {
+    node_prop_indices.allocateInterleaved(node_prop_indices_.size());
+    katana::ParallelSTL::copy(
+        node_prop_indices_.begin(), node_prop_indices_.end(),
+        node_prop_indices.begin());
+  }
+
+  return GraphTopology{
+      std::move(adj_indices), std::move(dests), std::move(edge_prop_indices),
+      std::move(node_prop_indices)};
+}
+
+std::shared_ptr<katana::EdgeShuffleTopology>
+katana::EdgeShuffleTopology::MakeWithEdgeChanges(
+    const katana::PropertyGraph* pg, const katana::EdgeShuffleTopology& topo,
+    const katana::EdgeChangeSet& changes) noexcept {
+  AdjIndexVec adj_indices;
+  EdgeDestVec dests;
+  PropIndexVec edge_prop_indices;
+
+  WithEdgeOrder(pg, topo, topo.edge_sort_state(), [&](const auto& less) {
+    MergeEdgeChanges(
+        topo, OrientInsertions(changes, topo.is_transposed(), less),
+        SortedDeletions(changes), less, &adj_indices, &dests,
+        &edge_prop_indices);
+  });
+
+  PropIndexVec node_prop_indices;
+  if (!topo.node_prop_indices_.empty()) {
+    node_prop_indices.allocateInterleaved(topo.node_prop_indices_.size());
+    katana::ParallelSTL::copy(
+        topo.node_prop_indices_.begin(), topo.node_prop_indices_.end(),
+        node_prop_indices.begin());
+  }
+
+  return std::make_shared<EdgeShuffleTopology>(EdgeShuffleTopology{
+      topo.transpose_state(), topo.edge_sort_state(), std::move(adj_indices),
+      std::move(dests), std::move(edge_prop_indices),
+      std::move(node_prop_indices)});
+}
+
 katana::GraphTopologyTypes::edge_iterator
 katana::EdgeShuffleTopology::FindEdge(
     const katana::GraphTopologyTypes::Node& src,
@@ -321,8 +580,115 @@ katana::EdgeShuffleTopology::FindAllEdges(
   return ret_range;
 }
 
+namespace {
+
+/// Adjacency lists shorter than this are sorted with std::sort since the
+/// fixed cost of the radix passes only pays off on longer lists. In power law
+/// graphs the few lists above it hold most of the edges.
+constexpr size_t kRadixSortMinDegree = 256;
+
+/// Per thread buffers for radix sorting one adjacency list at a time
+template <typename Key>
+struct AdjacencySortScratch {
+  std::vector<Key> keys;
+  std::vector<Key> key_scratch;
+  std::vector<katana::GraphTopologyTypes::PropertyIndex> value_scratch;
+
+  void Reserve(size_t n) {
+    if (keys.size() < n) {
+      keys.resize(n);
+      key_scratch.resize(n);
+      value_scratch.resize(n);
+    }
+  }
+};
+
+/// Number of bits needed to represent every node id of a graph with
+/// \p num_nodes nodes
+uint32_t
+NodeIDBits(size_t num_nodes) {
+  return num_nodes < 2 ? 0 : 64 - __builtin_clzll(num_nodes - 1);
+}
+
+/// Sorts the edges of each node of \p topo by the type returned by
+/// type_of(dst, edge_prop_index), then by destination, rearranging \p dests
+/// and \p prop_indices
+template <typename TypeOf>
+void
+SortEdgesByTypeThenDestImpl(
+    const katana::GraphTopology& topo, katana::GraphTopology::Node* dests,
+    katana::GraphTopology::PropertyIndex* prop_indices,
+    const TypeOf& type_of) noexcept {
+  using Node = katana::GraphTopology::Node;
+  using PropertyIndex = katana::GraphTopology::PropertyIndex;
+
+  // Long lists are radix sorted on a combined key with the type above the
+  // bits of the destination id, which orders by type, then destination.
+  const uint32_t dest_bits = NodeIDBits(topo.NumNodes());
+  static_assert(sizeof(katana::EntityTypeID) * 8 + 32 <= 64);
+  katana::PerThreadStorage<AdjacencySortScratch<uint64_t>> scratch;
+
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node node) {
+        // get this node's first and last edge
+        auto e_beg = *topo.OutEdges(node).begin();
+        auto e_end = *topo.OutEdges(node).end();
+
+        if (e_end - e_beg >= kRadixSortMinDegree) {
+          auto& local = *scratch.getLocal();
+          local.Reserve(e_end - e_beg);
+          for (auto e = e_beg; e < e_end; ++e) {
+            uint64_t type = type_of(dests[e], prop_indices[e]);
+            local.keys[e - e_beg] = (type << dest_bits) | dests[e];
+          }
+          katana::RadixSortPairs(
+              local.keys.data(), prop_indices + e_beg, e_end - e_beg,
+              local.key_scratch.data(), local.value_scratch.data());
+          const uint64_t dest_mask = (uint64_t{1} << dest_bits) - 1;
+          for (auto e = e_beg; e < e_end; ++e) {
+            dests[e] = static_cast<Node>(local.keys[e - e_beg] & dest_mask);
+          }
+          return;
+        }
+
+        // get iterators to locations to sort in the vector
+        auto begin_sort_iter =
+            katana::make_zip_iterator(prop_indices + e_beg, dests + e_beg);
+        auto end_sort_iter =
+            katana::make_zip_iterator(prop_indices + e_end, dests + e_end);
+
+        std::sort(
+            begin_sort_iter, end_sort_iter,
+            [&](const auto& tup1, const auto& tup2) {
+              // get types and destinations
+              auto e1 = std::get<0>(tup1);
+              auto e2 = std::get<0>(tup2);
+              static_assert(std::is_same_v<decltype(e1), PropertyIndex>);
+              static_assert(std::is_same_v<decltype(e2), PropertyIndex>);
+
+              auto dst1 = std::get<1>(tup1);
+              auto dst2 = std::get<1>(tup2);
+              static_assert(std::is_same_v<decltype(dst1), Node>);
+              static_assert(std::is_same_v<decltype(dst2), Node>);
+
+              katana::EntityTypeID data1 = type_of(dst1, e1);
+              katana::EntityTypeID data2 = type_of(dst2, e2);
+              if (data1 != data2) {
+                return data1 < data2;
+              }
+              return dst1 < dst2;
+            });
+      },
+      katana::steal(), katana::no_stats());
+}
+
+}  // namespace
+
 void
 katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
+  katana::PerThreadStorage<AdjacencySortScratch<Node>> scratch;
+
   katana::do_all(
       katana::iterate(Nodes()),
       [&](Node node) {
@@ -330,6 +696,19 @@ katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
         auto e_beg = *OutEdges(node).begin();
         auto e_end = *OutEdges(node).end();
 
+        if (e_end - e_beg >= kRadixSortMinDegree) {
+          // The destinations are the keys themselves
+          auto& local = *scratch.getLocal();
+          local.Reserve(e_end - e_beg);
+          katana::RadixSortPairs(
+              GetDests().data() + e_beg, edge_prop_indices_.data() + e_beg,
+              e_end - e_beg, local.key_scratch.data(),
+              local.value_scratch.data());
+          KATANA_LOG_DEBUG_ASSERT(std::is_sorted(
+              GetDests().begin() + e_beg, GetDests().begin() + e_end));
+          return;
+        }
+
         // get iterators to locations to sort in the vector
         auto begin_sort_iter = katana::make_zip_iterator(
             edge_prop_indices_.begin() + e_beg, GetDests().begin() + e_beg);
@@ -363,80 +742,197 @@ katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
 void
 katana::EdgeShuffleTopology::SortEdgesByTypeThenDest(
     const PropertyGraph* pg) noexcept {
+  SortEdgesByTypeThenDestImpl(
+      *this, GetDests().data(), edge_prop_indices_.data(),
+      [pg](Node, PropertyIndex e) {
+        return pg->GetTypeOfEdgeFromPropertyIndex(e);
+      });
+
+  // remember to update sort state
+  edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByEdgeType;
+}
+
+void
+katana::EdgeShuffleTopology::SortEdgesByDestType(
+    const PropertyGraph* pg) noexcept {
+  SortEdgesByTypeThenDestImpl(
+      *this, GetDests().data(), edge_prop_indices_.data(),
+      [pg, this](Node dst, PropertyIndex) {
+        return pg->GetTypeOfNodeFromPropertyIndex(GetNodePropertyIndex(dst));
+      });
+
+  // remember to update sort state
+  edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByNodeType;
+}
+
+void
+katana::EdgeShuffleTopology::SortEdgesByKey(
+    const std::vector<int64_t>& keys) noexcept {
   katana::do_all(
       katana::iterate(Nodes()),
       [&](Node node) {
-        // get this node's first and last edge
         auto e_beg = *OutEdges(node).begin();
         auto e_end = *OutEdges(node).end();
 
-        // get iterators to locations to sort in the vector
         auto begin_sort_iter = katana::make_zip_iterator(
             edge_prop_indices_.begin() + e_beg, GetDests().begin() + e_beg);
-
         auto end_sort_iter = katana::make_zip_iterator(
             edge_prop_indices_.begin() + e_end, GetDests().begin() + e_end);
 
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
         std::sort(
             begin_sort_iter, end_sort_iter,
             [&](const auto& tup1, const auto& tup2) {
-              // get edge type and destinations
-              auto e1 = std::get<0>(tup1);
-              auto e2 = std::get<0>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(e1), GraphTopology::PropertyIndex>);
-              static_assert(
-                  std::is_same_v<decltype(e2), GraphTopology::PropertyIndex>);
-
-              katana::EntityTypeID data1 =
-                  pg->GetTypeOfEdgeFromPropertyIndex(e1);
-              katana::EntityTypeID data2 =
-                  pg->GetTypeOfEdgeFromPropertyIndex(e2);
-              if (data1 != data2) {
-                return data1 < data2;
+              int64_t key1 = keys[std::get<0>(tup1)];
+              int64_t key2 = keys[std::get<0>(tup2)];
+              if (key1 != key2) {
+                return key1 < key2;
               }
-
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
+              return std::get<1>(tup1) < std::get<1>(tup2);
             });
       },
       katana::steal(), katana::no_stats());
 
   // remember to update sort state
-  edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByEdgeType;
+  edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByEdgeProperty;
 }
 
-void
-katana::EdgeShuffleTopology::SortEdgesByDestType(
-    const PropertyGraph*,
-    const katana::GraphTopologyTypes::PropIndexVec&) noexcept {
-  KATANA_LOG_FATAL("Not implemented yet");
+std::shared_ptr<katana::EdgeShuffleTopology>
+katana::EdgeShuffleTopology::MakeSortedByEdgeKey(
+    const PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_todo,
+    const std::vector<int64_t>& keys) noexcept {
+  auto ret = (tpose_todo == RDGTopology::TransposeKind::kYes)
+                 ? MakeTransposeCopy(pg)
+                 : MakeOriginalCopy(pg);
+  ret->SortEdgesByKey(keys);
+  return ret;
+}
+
+katana::GraphTopologyTypes::edges_range
+katana::EdgeShuffleTopology::OutEdgesWithDestType(
+    const katana::PropertyGraph* pg, const Node& src,
+    const katana::EntityTypeID& dst_type) const noexcept {
+  KATANA_LOG_DEBUG_ASSERT(has_edges_sorted_by(
+      katana::RDGTopology::EdgeSortKind::kSortedByNodeType));
+
+  auto e_range = OutEdges(src);
+  auto type_of = [&](const Edge& e) {
+    return pg->GetTypeOfNodeFromPropertyIndex(
+        GetNodePropertyIndex(OutEdgeDst(e)));
+  };
+
+  auto first = std::lower_bound(
+      e_range.begin(), e_range.end(), dst_type,
+      [&](const Edge& e, const katana::EntityTypeID& t) {
+        return type_of(e) < t;
+      });
+  auto last = std::upper_bound(
+      first, e_range.end(), dst_type,
+      [&](const katana::EntityTypeID& t, const Edge& e) {
+        return t < type_of(e);
+      });
+
+  return MakeStandardRange(first, last);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeFromPermutation(
+    const katana::EdgeShuffleTopology& seed_topo,
+    const PropIndexVec& new_to_old,
+    const katana::RDGTopology::NodeSortKind& node_sort_todo) noexcept {
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.NumNodes());
+
+  NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
+
+  PropIndexVec node_prop_indices;
+  node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
+
+  // TODO(amber): given 32-bit node ids, put a check here that
+  // new_to_old.size() < 2^32
+  katana::do_all(
+      katana::iterate(size_t{0}, new_to_old.size()),
+      [&](auto i) {
+        // new_to_old[i] gives old node id
+        old_to_new_map[new_to_old[i]] = i;
+        degrees[i] = seed_topo.OutDegree(new_to_old[i]);
+        node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_DEBUG_ASSERT(
+      node_sort_todo != katana::RDGTopology::NodeSortKind::kSortedByDegree ||
+      std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.Nodes()),
+      [&](auto old_src_id) {
+        auto new_srd_id = old_to_new_map[old_src_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.OutEdges(old_src_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
+          KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] =
+              seed_topo.GetEdgePropertyIndexFromOutEdge(e);
+        }
+        KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_shared<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo,
+      seed_topo.edge_sort_state(), std::move(degrees),
+      std::move(node_prop_indices), std::move(new_dest_vec),
+      std::move(edge_prop_indices)});
 }
 
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::MakeSortedByDegree(
     const PropertyGraph*,
     const katana::EdgeShuffleTopology& seed_topo) noexcept {
-  auto cmp = [&](const auto& i1, const auto& i2) {
-    auto d1 = seed_topo.OutDegree(i1);
-    auto d2 = seed_topo.OutDegree(i2);
-    // TODO(amber): Triangle-Counting needs degrees sorted in descending order. I
-    // need to think of a way to specify in the interface whether degrees should be
-    // sorted in ascending or descending order.
-    // return d1 < d2;
-    return d1 > d2;
-  };
+  PropIndexVec new_to_old;
+  new_to_old.allocateInterleaved(seed_topo.NumNodes());
+  katana::ParallelSTL::iota(
+      new_to_old.begin(), new_to_old.end(), PropertyIndex{0});
 
-  return MakeNodeSortedTopo(
-      seed_topo, cmp, katana::RDGTopology::NodeSortKind::kSortedByDegree);
+  katana::GReduceMax<Edge> max_degree;
+  katana::do_all(
+      katana::iterate(seed_topo.Nodes()),
+      [&](Node n) { max_degree.update(seed_topo.OutDegree(n)); },
+      katana::no_stats());
+  const Edge max_deg = max_degree.reduce();
+
+  // TODO(amber): Triangle-Counting needs degrees sorted in descending order. I
+  // need to think of a way to specify in the interface whether degrees should
+  // be sorted in ascending or descending order.
+  // Degrees are small integers, so a stable radix sort on (max - degree)
+  // orders by descending degree, breaking ties by node id.
+  katana::ParallelRadixSortByKey(
+      new_to_old.data(), new_to_old.size(),
+      [&](PropertyIndex n) { return max_deg - seed_topo.OutDegree(n); },
+      max_deg);
+
+  return MakeFromPermutation(
+      seed_topo, new_to_old,
+      katana::RDGTopology::NodeSortKind::kSortedByDegree);
 }
 
 std::shared_ptr<katana::ShuffleTopology>
@@ -458,6 +954,169 @@ katana::ShuffleTopology::MakeSortedByNodeType(
       seed_topo, cmp, katana::RDGTopology::NodeSortKind::kSortedByNodeType);
 }
 
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeReverseCuthillMcKee(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  const size_t num_nodes = seed_topo.NumNodes();
+
+  PropIndexVec new_to_old;
+  new_to_old.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return MakeFromPermutation(
+        seed_topo, new_to_old,
+        katana::RDGTopology::NodeSortKind::kReverseCuthillMcKee);
+  }
+
+  // Start every breadth first search from the unvisited node of least degree
+  PropIndexVec by_degree;
+  by_degree.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::iota(
+      by_degree.begin(), by_degree.end(), PropertyIndex{0});
+  katana::GReduceMax<Edge> max_degree;
+  katana::do_all(
+      katana::iterate(seed_topo.Nodes()),
+      [&](Node n) { max_degree.update(seed_topo.OutDegree(n)); },
+      katana::no_stats());
+  katana::ParallelRadixSortByKey(
+      by_degree.data(), by_degree.size(),
+      [&](PropertyIndex n) { return seed_topo.OutDegree(n); },
+      max_degree.reduce());
+
+  // The breadth first order is inherently sequential; new_to_old doubles as
+  // the queue.
+  std::vector<bool> visited(num_nodes, false);
+  std::vector<Node> neighbors;
+  size_t tail = 0;
+  for (PropertyIndex start : by_degree) {
+    if (visited[start]) {
+      continue;
+    }
+    visited[start] = true;
+    size_t head = tail;
+    new_to_old[tail++] = start;
+
+    while (head < tail) {
+      Node node = new_to_old[head++];
+      neighbors.clear();
+      for (auto e : seed_topo.OutEdges(node)) {
+        Node dst = seed_topo.OutEdgeDst(e);
+        if (!visited[dst]) {
+          visited[dst] = true;
+          neighbors.emplace_back(dst);
+        }
+      }
+      std::stable_sort(
+          neighbors.begin(), neighbors.end(), [&](Node a, Node b) {
+            return seed_topo.OutDegree(a) < seed_topo.OutDegree(b);
+          });
+      for (Node dst : neighbors) {
+        new_to_old[tail++] = dst;
+      }
+    }
+  }
+  KATANA_LOG_DEBUG_ASSERT(tail == num_nodes);
+
+  std::reverse(new_to_old.begin(), new_to_old.end());
+
+  return MakeFromPermutation(
+      seed_topo, new_to_old,
+      katana::RDGTopology::NodeSortKind::kReverseCuthillMcKee);
+}
+
+namespace {
+
+/// Nodes with more than the average out degree of \p topo, in id order,
+/// followed by the other nodes in id order
+katana::GraphTopology::PropIndexVec
+HubsFirst(const katana::GraphTopology& topo, size_t* num_hubs) noexcept {
+  using Node = katana::GraphTopology::Node;
+  using PropertyIndex = katana::GraphTopology::PropertyIndex;
+
+  const size_t num_nodes = topo.NumNodes();
+  katana::GraphTopology::PropIndexVec new_to_old;
+  new_to_old.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    *num_hubs = 0;
+    return new_to_old;
+  }
+
+  const double avg_degree =
+      static_cast<double>(topo.NumEdges()) / static_cast<double>(num_nodes);
+  auto is_hub = [&](Node n) {
+    return static_cast<double>(topo.OutDegree(n)) > avg_degree;
+  };
+
+  // Stable partition: number hubs and non-hubs separately by prefix sums
+  katana::NUMAArray<PropertyIndex> hub_rank;
+  hub_rank.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) { hub_rank[n] = is_hub(n) ? 1 : 0; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      hub_rank.begin(), hub_rank.end(), hub_rank.begin());
+  *num_hubs = hub_rank[num_nodes - 1];
+
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        // hub_rank[n] counts the hubs up to and including n
+        size_t pos = is_hub(n) ? hub_rank[n] - 1
+                               : *num_hubs + (n - hub_rank[n]);
+        new_to_old[pos] = n;
+      },
+      katana::no_stats());
+
+  return new_to_old;
+}
+
+}  // namespace
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeHubSorted(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  size_t num_hubs = 0;
+  PropIndexVec new_to_old = HubsFirst(seed_topo, &num_hubs);
+
+  // Sort the hubs by decreasing degree, ties by id
+  katana::GReduceMax<Edge> max_degree;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_hubs),
+      [&](size_t i) { max_degree.update(seed_topo.OutDegree(new_to_old[i])); },
+      katana::no_stats());
+  const Edge max_deg = max_degree.reduce();
+  katana::ParallelRadixSortByKey(
+      new_to_old.data(), num_hubs,
+      [&](PropertyIndex n) { return max_deg - seed_topo.OutDegree(n); },
+      max_deg);
+
+  return MakeFromPermutation(
+      seed_topo, new_to_old, katana::RDGTopology::NodeSortKind::kHubSorted);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeHubClustered(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  size_t num_hubs = 0;
+  PropIndexVec new_to_old = HubsFirst(seed_topo, &num_hubs);
+
+  return MakeFromPermutation(
+      seed_topo, new_to_old, katana::RDGTopology::NodeSortKind::kHubClustered);
+}
+
+katana::NUMAArray<katana::GraphTopologyTypes::Node>
+katana::ShuffleTopology::MakeOldToNewMap() const noexcept {
+  NUMAArray<Node> old_to_new;
+  old_to_new.allocateInterleaved(NumNodes());
+  katana::do_all(
+      katana::iterate(Nodes()),
+      [&](Node n) { old_to_new[GetNodePropertyIndex(n)] = n; },
+      katana::no_stats());
+  return old_to_new;
+}
+
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::Make(katana::RDGTopology* rdg_topo) {
   KATANA_LOG_DEBUG_ASSERT(rdg_topo);
@@ -533,7 +1192,7 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
 
   // ordered map
   std::set<katana::EntityTypeID> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+  for (uint32_t i = 0; i < katana::getActiveThreads(); ++i) {
     auto& edgeTypesSet = *edgeTypes.getRemote(i);
     for (auto edgeType : edgeTypesSet) {
       mergedSet.insert(edgeType);
@@ -679,6 +1338,472 @@ katana::EdgeTypeAwareTopology::Make(
       std::move(per_type_adj_indices)});
 }
 
+namespace {
+
+uint64_t
+ZigZag(int64_t val) {
+  return (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+}
+
+size_t
+VarintSize(uint64_t val) {
+  size_t size = 1;
+  while (val >= 0x80) {
+    val >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+uint8_t*
+EncodeVarint(uint64_t val, uint8_t* out) {
+  while (val >= 0x80) {
+    *out++ = static_cast<uint8_t>(val | 0x80);
+    val >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(val);
+  return out;
+}
+
+}  // namespace
+
+katana::CompressedGraphTopology::~CompressedGraphTopology() = default;
+
+void
+katana::CompressedGraphTopology::Print() const noexcept {
+  std::cout << "adj_indices_: [ ";
+  for (const auto& i : adj_indices_) {
+    std::cout << i << ", ";
+  }
+  std::cout << "]" << std::endl;
+
+  std::cout << "dests: [ ";
+  for (auto n : Nodes()) {
+    for (auto dst : OutNeighbors(n)) {
+      std::cout << dst << ", ";
+    }
+  }
+  std::cout << "]" << std::endl;
+}
+
+std::shared_ptr<katana::CompressedGraphTopology>
+katana::CompressedGraphTopology::Make(
+    const katana::GraphTopology& topo) noexcept {
+  const uint64_t num_edges = topo.NumEdges();
+  const uint64_t num_blocks = (num_edges + kBlockSize - 1) / kBlockSize;
+  const auto* dests = topo.DestData();
+
+  // encoded size of every block, shifted by one so that an inclusive prefix
+  // sum yields the starting offset of each block
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateInterleaved(num_blocks + 1);
+  offsets[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        const Edge beg = b * kBlockSize;
+        const Edge end = std::min(beg + kBlockSize, num_edges);
+        size_t size = VarintSize(dests[beg]);
+        for (Edge e = beg + 1; e < end; ++e) {
+          size += VarintSize(ZigZag(
+              static_cast<int64_t>(dests[e]) -
+              static_cast<int64_t>(dests[e - 1])));
+        }
+        offsets[b + 1] = size;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      offsets.begin(), offsets.end(), offsets.begin());
+
+  const uint64_t header_size = (1 + num_blocks) * sizeof(uint64_t);
+  EncodedDestVec encoded_dests;
+  encoded_dests.allocateInterleaved(header_size + offsets[num_blocks]);
+
+  auto* header = reinterpret_cast<uint64_t*>(encoded_dests.data());
+  header[0] = num_blocks;
+  uint8_t* bytes = encoded_dests.data() + header_size;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        header[1 + b] = offsets[b];
+        const Edge beg = b * kBlockSize;
+        const Edge end = std::min(beg + kBlockSize, num_edges);
+        uint8_t* out = EncodeVarint(dests[beg], bytes + offsets[b]);
+        for (Edge e = beg + 1; e < end; ++e) {
+          out = EncodeVarint(
+              ZigZag(
+                  static_cast<int64_t>(dests[e]) -
+                  static_cast<int64_t>(dests[e - 1])),
+              out);
+        }
+        KATANA_LOG_DEBUG_ASSERT(out == bytes + offsets[b + 1]);
+      },
+      katana::no_stats());
+
+  AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(topo.NumNodes());
+  katana::ParallelSTL::copy(
+      topo.adj_indices_.begin(), topo.adj_indices_.end(), adj_indices.begin());
+
+  PropIndexVec edge_prop_indices;
+  if (!topo.edge_prop_indices_.empty()) {
+    edge_prop_indices.allocateInterleaved(num_edges);
+    katana::ParallelSTL::copy(
+        topo.edge_prop_indices_.begin(), topo.edge_prop_indices_.end(),
+        edge_prop_indices.begin());
+  }
+
+  PropIndexVec node_prop_indices;
+  if (!topo.node_prop_indices_.empty()) {
+    node_prop_indices.allocateInterleaved(topo.NumNodes());
+    katana::ParallelSTL::copy(
+        topo.node_prop_indices_.begin(), topo.node_prop_indices_.end(),
+        node_prop_indices.begin());
+  }
+
+  return std::make_shared<CompressedGraphTopology>(CompressedGraphTopology{
+      topo.transpose_state(), topo.edge_sort_state(), num_edges,
+      std::move(adj_indices), std::move(encoded_dests),
+      std::move(edge_prop_indices), std::move(node_prop_indices)});
+}
+
+std::shared_ptr<katana::CompressedGraphTopology>
+katana::CompressedGraphTopology::Make(katana::RDGTopology* rdg_topo) {
+  KATANA_LOG_DEBUG_ASSERT(rdg_topo);
+  KATANA_LOG_DEBUG_ASSERT(
+      rdg_topo->topology_state() ==
+      katana::RDGTopology::TopologyKind::kCompressedTopology);
+
+  AdjIndexVec adj_indices_copy;
+  adj_indices_copy.allocateInterleaved(rdg_topo->num_nodes());
+  EncodedDestVec encoded_dests_copy;
+  encoded_dests_copy.allocateInterleaved(rdg_topo->compressed_dests_size());
+  PropIndexVec edge_prop_indices;
+  PropIndexVec node_prop_indices;
+
+  if (rdg_topo->num_nodes() > 0) {
+    katana::ParallelSTL::copy(
+        &(rdg_topo->adj_indices()[0]),
+        &(rdg_topo->adj_indices()[rdg_topo->num_nodes()]),
+        adj_indices_copy.begin());
+
+    if (rdg_topo->has_node_index_to_property_index_map()) {
+      const auto* node_map = rdg_topo->node_index_to_property_index_map();
+      node_prop_indices.allocateInterleaved(rdg_topo->num_nodes());
+      katana::ParallelSTL::copy(
+          &node_map[0], &node_map[rdg_topo->num_nodes()],
+          node_prop_indices.begin());
+    }
+  }
+  if (rdg_topo->compressed_dests_size() > 0) {
+    katana::ParallelSTL::copy(
+        &(rdg_topo->compressed_dests()[0]),
+        &(rdg_topo->compressed_dests()[rdg_topo->compressed_dests_size()]),
+        encoded_dests_copy.begin());
+  }
+  if (rdg_topo->num_edges() > 0 &&
+      rdg_topo->has_edge_index_to_property_index_map()) {
+    edge_prop_indices.allocateInterleaved(rdg_topo->num_edges());
+    katana::ParallelSTL::copy(
+        &(rdg_topo->edge_index_to_property_index_map()[0]),
+        &(rdg_topo->edge_index_to_property_index_map()[rdg_topo->num_edges()]),
+        edge_prop_indices.begin());
+  }
+
+  // Since we copy the data we need out of the RDGTopology into our own arrays,
+  // unbind the RDGTopologys file store to save memory.
+  auto res = rdg_topo->unbind_file_storage();
+  KATANA_LOG_ASSERT(res);
+
+  return std::make_shared<CompressedGraphTopology>(CompressedGraphTopology{
+      rdg_topo->transpose_state(), rdg_topo->edge_sort_state(),
+      rdg_topo->num_edges(), std::move(adj_indices_copy),
+      std::move(encoded_dests_copy), std::move(edge_prop_indices),
+      std::move(node_prop_indices)});
+}
+
+katana::Result<katana::RDGTopology>
+katana::CompressedGraphTopology::ToRDGTopology() const {
+  katana::RDGTopology topo = KATANA_CHECKED(katana::RDGTopology::Make(
+      AdjData(), NumNodes(), encoded_dests_.data(), encoded_dests_.size(),
+      NumEdges(), tpose_state_, edge_sort_state_, edge_prop_indices_.data(),
+      node_prop_indices_.data()));
+  return katana::RDGTopology(std::move(topo));
+}
+
+katana::CompactGraphTopology::~CompactGraphTopology() = default;
+
+std::shared_ptr<katana::CompactGraphTopology>
+katana::CompactGraphTopology::Make(
+    std::shared_ptr<const katana::GraphTopology> topo) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(topo);
+
+  NarrowAdjIndexVec narrow_adj_indices;
+  const bool is_narrow = FitsNarrow(topo->NumEdges());
+  if (is_narrow) {
+    narrow_adj_indices.allocateInterleaved(topo->NumNodes());
+    const Edge* adj_indices = topo->AdjData();
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(topo->NumNodes())),
+        [&](Node n) {
+          narrow_adj_indices[n] = static_cast<NarrowEdge>(adj_indices[n]);
+        },
+        katana::no_stats());
+  }
+
+  return std::make_shared<CompactGraphTopology>(CompactGraphTopology{
+      std::move(topo), std::move(narrow_adj_indices), is_narrow});
+}
+
+size_t
+katana::HubAdjacencyBitmaps::ViewMinHubDegree() noexcept {
+  if (int min_degree = 0;
+      katana::GetEnv("KATANA_MIN_HUB_DEGREE", &min_degree) && min_degree > 0) {
+    return static_cast<size_t>(min_degree);
+  }
+  return kDefaultMinHubDegree;
+}
+
+std::shared_ptr<katana::HubAdjacencyBitmaps>
+katana::HubAdjacencyBitmaps::Make(
+    const GraphTopology& topo, size_t min_hub_degree) noexcept {
+  auto hubs = std::make_shared<HubAdjacencyBitmaps>();
+  const size_t num_nodes = topo.NumNodes();
+  // A bitmap of num_nodes bits is no larger than a list of num_nodes / 32
+  // 32-bit node ids
+  hubs->hub_threshold_ =
+      std::max<size_t>({min_hub_degree, num_nodes / 32, size_t{1}});
+
+  katana::GReduceLogicalOr has_parallel_edges;
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(num_nodes)),
+      [&](Node n) {
+        const Node* first = topo.DestData() + *topo.OutEdges(n).begin();
+        const Node* last = first + topo.OutDegree(n);
+        if (std::adjacent_find(first, last) != last) {
+          has_parallel_edges.update(true);
+        }
+      },
+      katana::no_stats());
+  hubs->has_parallel_edges_ = has_parallel_edges.reduce();
+
+  std::vector<Node> hub_nodes;
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (topo.OutDegree(n) >= hubs->hub_threshold_) {
+      hub_nodes.emplace_back(n);
+    }
+  }
+  if (hub_nodes.empty()) {
+    return hubs;
+  }
+
+  hubs->hub_index_.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      hubs->hub_index_.begin(), hubs->hub_index_.end(), kNotHub);
+  for (size_t i = 0; i < hub_nodes.size(); ++i) {
+    hubs->hub_index_[hub_nodes[i]] = static_cast<uint32_t>(i);
+  }
+
+  hubs->bitmaps_.resize(hub_nodes.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, hub_nodes.size()),
+      [&](size_t i) {
+        DynamicBitset& bits = hubs->bitmaps_[i];
+        bits.resize(num_nodes);
+        for (auto e : topo.OutEdges(hub_nodes[i])) {
+          bits.set(topo.OutEdgeDst(e));
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return hubs;
+}
+
+size_t
+katana::HubAdjacencyBitmaps::CountCommon(
+    const DynamicBitset& a, const DynamicBitset& b, Node lo, Node hi) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(a.size() == b.size());
+  KATANA_LOG_DEBUG_ASSERT(hi <= a.size());
+  if (lo >= hi) {
+    return 0;
+  }
+
+  constexpr size_t kBits = DynamicBitset::kNumBitsInUint64;
+  const auto& a_words = a.get_vec();
+  const auto& b_words = b.get_vec();
+  const size_t first = lo / kBits;
+  const size_t last = (hi - 1) / kBits;
+
+  size_t count = 0;
+  for (size_t w = first; w <= last; ++w) {
+    uint64_t word = a_words[w] & b_words[w];
+    if (w == first) {
+      word &= ~uint64_t{0} << (lo % kBits);
+    }
+    if (w == last && hi % kBits != 0) {
+      word &= ~(~uint64_t{0} << (hi % kBits));
+    }
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+namespace {
+
+/// Views are about as big as the default topology, so let the memory
+/// supervisor make room for one before it is loaded or built
+void
+PrepareToBuildView(const katana::GraphTopology& default_topo) {
+  katana::MemorySupervisor::Get().PrepareBorrowActive(
+      static_cast<katana::count_t>(default_topo.ApproxMemUse()));
+}
+
+}  // namespace
+
+katana::PGViewCache::TopologyAccounting::TopologyAccounting(
+    TopologyAccounting&& other) noexcept
+    : tracked_(std::move(other.tracked_)) {
+  other.tracked_.clear();
+}
+
+katana::PGViewCache::TopologyAccounting&
+katana::PGViewCache::TopologyAccounting::operator=(
+    TopologyAccounting&& other) noexcept {
+  if (this != &other) {
+    Clear();
+    tracked_ = std::move(other.tracked_);
+    other.tracked_.clear();
+  }
+  return *this;
+}
+
+katana::PGViewCache::TopologyAccounting::~TopologyAccounting() { Clear(); }
+
+void
+katana::PGViewCache::TopologyAccounting::Track(
+    const GraphTopology* topo) noexcept {
+  auto* tm = MemorySupervisor::Get().GetTopologyManager();
+  uint64_t id = tm->TopologyBuiltActive(topo->ApproxMemUse());
+  tracked_[topo] = Tracked{id, false};
+}
+
+void
+katana::PGViewCache::TopologyAccounting::Reused(
+    const GraphTopology* topo) noexcept {
+  auto it = tracked_.find(topo);
+  if (it == tracked_.end()) {
+    return;
+  }
+  MemorySupervisor::Get().GetTopologyManager()->TopologyReused(it->second.id);
+  it->second.standby = false;
+}
+
+void
+katana::PGViewCache::TopologyAccounting::Untrack(
+    const GraphTopology* topo) noexcept {
+  auto it = tracked_.find(topo);
+  if (it == tracked_.end()) {
+    return;
+  }
+  MemorySupervisor::Get().GetTopologyManager()->TopologyDropped(it->second.id);
+  tracked_.erase(it);
+}
+
+void
+katana::PGViewCache::TopologyAccounting::Clear() noexcept {
+  if (tracked_.empty()) {
+    return;
+  }
+  auto* tm = MemorySupervisor::Get().GetTopologyManager();
+  for (const auto& [topo, tracked] : tracked_) {
+    tm->TopologyDropped(tracked.id);
+  }
+  tracked_.clear();
+}
+
+bool
+katana::PGViewCache::TopologyAccounting::is_standby(
+    const GraphTopology* topo) const noexcept {
+  auto it = tracked_.find(topo);
+  return it != tracked_.end() && it->second.standby;
+}
+
+bool
+katana::PGViewCache::TopologyAccounting::MakeStandby(
+    const GraphTopology* topo, std::function<void()> evictor) noexcept {
+  auto it = tracked_.find(topo);
+  if (it == tracked_.end()) {
+    return true;
+  }
+  if (!MemorySupervisor::Get().GetTopologyManager()->PutTopology(
+          it->second.id, std::move(evictor))) {
+    tracked_.erase(it);
+    return false;
+  }
+  it->second.standby = true;
+  return true;
+}
+
+void
+katana::PGViewCache::ReleaseUnusedTopologies() noexcept {
+  auto release = [this](auto& topos) {
+    using TopoPtr = typename std::decay_t<decltype(topos)>::value_type;
+    using Topo = typename TopoPtr::element_type;
+
+    auto it = std::remove_if(topos.begin(), topos.end(), [&](TopoPtr& topo) {
+      if (!topo->is_valid()) {
+        // Evicted by the memory supervisor
+        accounting_.Untrack(topo.get());
+        return true;
+      }
+      // Only referenced by this cache, i.e., no view is using it
+      if (topo.use_count() == 1 && !accounting_.is_standby(topo.get())) {
+        std::weak_ptr<Topo> weak = topo;
+        auto evictor = [weak]() {
+          if (auto t = weak.lock()) {
+            t->Evict();
+          }
+        };
+        if (!accounting_.MakeStandby(topo.get(), std::move(evictor))) {
+          return true;
+        }
+      }
+      return false;
+    });
+    topos.erase(it, topos.end());
+  };
+
+  release(edge_shuff_topos_);
+  release(fully_shuff_topos_);
+  release(edge_type_aware_topos_);
+
+  // copies in the order of topologies that are gone or were evicted
+  auto stale = std::remove_if(
+      permuted_props_.begin(), permuted_props_.end(),
+      [](const PermutedProperty& prop) {
+        auto topo = prop.topo.lock();
+        return !topo || prop.source.expired() ||
+               static_cast<uint64_t>(prop.permuted->length()) !=
+                   (prop.is_edge ? topo->NumEdges() : topo->NumNodes());
+      });
+  permuted_props_.erase(stale, permuted_props_.end());
+
+  // build times of topologies no longer cached
+  for (auto it = build_times_.begin(); it != build_times_.end();) {
+    auto is_topo = [&](const auto& topo) { return topo.get() == it->first; };
+    bool cached =
+        std::any_of(
+            edge_shuff_topos_.begin(), edge_shuff_topos_.end(), is_topo) ||
+        std::any_of(
+            fully_shuff_topos_.begin(), fully_shuff_topos_.end(), is_topo) ||
+        std::any_of(
+            edge_type_aware_topos_.begin(), edge_type_aware_topos_.end(),
+            is_topo) ||
+        compressed_topo_.get() == it->first;
+    it = cached ? std::next(it) : build_times_.erase(it);
+  }
+}
+
 const katana::GraphTopology&
 katana::PGViewCache::GetDefaultTopologyRef() const noexcept {
   return *original_topo_;
@@ -707,10 +1832,159 @@ void
 katana::PGViewCache::DropAllTopologies() noexcept {
   original_topo_ = std::make_shared<katana::GraphTopology>();
 
+  accounting_.Clear();
   edge_shuff_topos_.clear();
   fully_shuff_topos_.clear();
   edge_type_aware_topos_.clear();
+  compressed_topo_.reset();
+  compact_topo_.reset();
+  compact_sorted_topo_.reset();
   edge_type_id_map_.reset();
+  permuted_props_.clear();
+  build_times_.clear();
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::PGViewCache::BuildOrGetPropertyInTopologyOrder(
+    const katana::PropertyGraph* pg,
+    const std::shared_ptr<const katana::GraphTopology>& topo,
+    const std::string& name, bool is_edge) noexcept {
+  using PropertyIndex = GraphTopology::PropertyIndex;
+
+  std::shared_ptr<arrow::ChunkedArray> column = KATANA_CHECKED(
+      is_edge ? pg->GetEdgeProperty(name) : pg->GetNodeProperty(name));
+  const uint64_t size = is_edge ? topo->NumEdges() : topo->NumNodes();
+
+  for (const auto& prop : permuted_props_) {
+    if (prop.is_edge == is_edge && prop.topo.lock() == topo &&
+        prop.source.lock() == column &&
+        static_cast<uint64_t>(prop.permuted->length()) == size) {
+      return prop.permuted;
+    }
+  }
+
+  auto indices_buffer = KATANA_CHECKED_CONTEXT(
+      arrow::AllocateBuffer(size * sizeof(PropertyIndex)),
+      "allocating indices of {} values", size);
+  auto* indices =
+      reinterpret_cast<PropertyIndex*>(indices_buffer->mutable_data());
+  katana::GAccumulator<uint64_t> shuffled;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size),
+      [&](uint64_t i) {
+        indices[i] = is_edge ? topo->GetEdgePropertyIndexFromOutEdge(i)
+                             : topo->GetNodePropertyIndex(i);
+        if (indices[i] != i) {
+          shuffled += 1;
+        }
+      },
+      katana::no_stats());
+
+  std::shared_ptr<arrow::Array> permuted =
+      KATANA_CHECKED(ContiguousArray(*column));
+  if (shuffled.reduce() != 0) {
+    arrow::UInt64Array indices_array(
+        static_cast<int64_t>(size),
+        std::shared_ptr<arrow::Buffer>(std::move(indices_buffer)));
+    permuted = KATANA_CHECKED_CONTEXT(
+        arrow::compute::Take(*permuted, indices_array),
+        "permuting property {}", std::quoted(name));
+  }
+
+  permuted_props_.emplace_back(
+      PermutedProperty{topo, column, is_edge, permuted});
+  return MakeResult(std::move(permuted));
+}
+
+katana::Result<void>
+katana::PGViewCache::ApplyEdgeChanges(
+    katana::PropertyGraph* pg, const katana::EdgeChangeSet& changes) noexcept {
+  const uint64_t num_nodes = original_topo_->NumNodes();
+  for (const auto& ins : changes.insertions) {
+    if (ins.src >= num_nodes || ins.dst >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "inserted edge ({}, {}) refers to a node that does not exist, num "
+          "nodes = {}",
+          ins.src, ins.dst, num_nodes);
+    }
+  }
+
+  if (changes.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  // The default topology may have been reseated to one of the cached
+  // topologies, in which case updating that one updates the default too.
+  std::shared_ptr<GraphTopology> new_default;
+
+  std::vector<std::shared_ptr<EdgeShuffleTopology>> new_edge_shuff_topos;
+  for (const auto& topo : edge_shuff_topos_) {
+    if (!topo->is_valid()) {
+      continue;
+    }
+    new_edge_shuff_topos.emplace_back(
+        EdgeShuffleTopology::MakeWithEdgeChanges(pg, *topo, changes));
+    if (topo == original_topo_) {
+      new_default = new_edge_shuff_topos.back();
+    }
+  }
+
+  // EdgeTypeAwareTopologies are sorted by edge type, so merging keeps them
+  // sorted; only their per type indices need to be recomputed below.
+  std::vector<std::shared_ptr<EdgeShuffleTopology>> type_sorted_topos;
+  std::optional<size_t> default_type_aware_index;
+  for (const auto& topo : edge_type_aware_topos_) {
+    if (!topo->is_valid()) {
+      continue;
+    }
+    if (topo == original_topo_) {
+      default_type_aware_index = type_sorted_topos.size();
+    }
+    type_sorted_topos.emplace_back(
+        EdgeShuffleTopology::MakeWithEdgeChanges(pg, *topo, changes));
+  }
+
+  if (default_type_aware_index) {
+    new_default = type_sorted_topos[*default_type_aware_index];
+  } else if (!new_default) {
+    new_default = std::make_shared<GraphTopology>(
+        original_topo_->CopyWithEdgeChanges(changes));
+  }
+
+  // Views built before this call keep the previous topologies alive, but they
+  // are no longer cached so they are no longer accounted either.
+  accounting_.Clear();
+  build_times_.clear();
+  original_topo_ = std::move(new_default);
+  edge_shuff_topos_ = std::move(new_edge_shuff_topos);
+  for (const auto& topo : edge_shuff_topos_) {
+    accounting_.Track(topo.get());
+  }
+
+  // Inserted edges may introduce new edge types, and node shuffled topologies
+  // are cheaper to rebuild from the updated edge shuffled ones than to patch.
+  edge_type_id_map_.reset();
+  fully_shuff_topos_.clear();
+  compressed_topo_.reset();
+  compact_topo_.reset();
+  compact_sorted_topo_.reset();
+
+  edge_type_aware_topos_.clear();
+  if (!type_sorted_topos.empty()) {
+    auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
+    for (size_t i = 0; i < type_sorted_topos.size(); ++i) {
+      edge_type_aware_topos_.emplace_back(EdgeTypeAwareTopology::MakeFrom(
+          pg, edge_type_index, std::move(*type_sorted_topos[i])));
+      accounting_.Track(edge_type_aware_topos_.back().get());
+      if (default_type_aware_index == i) {
+        original_topo_ = edge_type_aware_topos_.back();
+      }
+    }
+  }
+
+  ++version_;
+  return katana::ResultSuccess();
 }
 
 std::shared_ptr<katana::CondensedTypeIDMap>
@@ -764,9 +2038,11 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
     if (pop) {
       auto topo = *it;
+      accounting_.Untrack(topo.get());
       edge_shuff_topos_.erase(it);
       return topo;
     } else {
+      accounting_.Reused(it->get());
       return *it;
     }
   }
@@ -777,6 +2053,7 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
         edge_type_aware_topos_.begin(), edge_type_aware_topos_.end(), pred);
     if (it != edge_type_aware_topos_.end()) {
       KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+      accounting_.Reused(it->get());
       return *it;
     }
   }
@@ -786,14 +2063,21 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
       katana::RDGTopology::TopologyKind::kEdgeShuffleTopology, tpose_kind,
       sort_kind, katana::RDGTopology::NodeSortKind::kAny);
 
+  OperationSpan span("build view", {{"view", "edge shuffle topology"}});
+  PrepareToBuildView(GetDefaultTopologyRef());
+  auto start = std::chrono::steady_clock::now();
   auto res = pg->LoadTopology(std::move(shadow));
+  span.SetTags({{"loaded", res.has_value()}});
   auto new_topo = (!res) ? EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind)
                          : EdgeShuffleTopology::Make(res.value());
+  span.Finish();
   KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, new_topo.get()));
 
   if (pop) {
     return new_topo;
   } else {
+    RecordBuildTime(new_topo.get(), res.has_value(), start);
+    accounting_.Track(new_topo.get());
     edge_shuff_topos_.emplace_back(std::move(new_topo));
     return edge_shuff_topos_.back();
   }
@@ -817,6 +2101,7 @@ katana::PGViewCache::BuildOrGetShuffTopo(
 
   if (it != fully_shuff_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+    accounting_.Reused(it->get());
     return *it;
   } else {
     // no matching topology in cache, see if we have it in storage
@@ -824,7 +2109,11 @@ katana::PGViewCache::BuildOrGetShuffTopo(
     katana::RDGTopology shadow = katana::RDGTopology::MakeShadow(
         katana::RDGTopology::TopologyKind::kShuffleTopology, tpose_kind,
         edge_sort_todo, node_sort_todo);
+    OperationSpan span("build view", {{"view", "shuffle topology"}});
+    PrepareToBuildView(GetDefaultTopologyRef());
+    auto start = std::chrono::steady_clock::now();
     auto res = pg->LoadTopology(std::move(shadow));
+    span.SetTags({{"loaded", res.has_value()}});
 
     if (!res) {
       // no matching topology in cache or storage, generate it
@@ -846,7 +2135,10 @@ katana::PGViewCache::BuildOrGetShuffTopo(
       fully_shuff_topos_.emplace_back(katana::ShuffleTopology::Make(topo));
     }
 
+    span.Finish();
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
+    RecordBuildTime(fully_shuff_topos_.back().get(), res.has_value(), start);
+    accounting_.Track(fully_shuff_topos_.back().get());
     return fully_shuff_topos_.back();
   }
 }
@@ -864,6 +2156,7 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
 
   if (it != edge_type_aware_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+    accounting_.Reused(it->get());
     return *it;
   } else {
     // no matching topology in cache, see if we have it in storage
@@ -871,7 +2164,11 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
         katana::RDGTopology::TopologyKind::kEdgeTypeAwareTopology, tpose_kind,
         katana::RDGTopology::EdgeSortKind::kSortedByEdgeType,
         katana::RDGTopology::NodeSortKind::kAny);
+    OperationSpan span("build view", {{"view", "edge type aware topology"}});
+    PrepareToBuildView(GetDefaultTopologyRef());
+    auto start = std::chrono::steady_clock::now();
     auto res = pg->LoadTopology(std::move(shadow));
+    span.SetTags({{"loaded", res.has_value()}});
 
     // In either generation, or loading, the EdgeTypeAwareTopology depends on an EdgeShuffleTopology.
     // This call does NOT cache the resulting edge shuffled topology.
@@ -897,35 +2194,141 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
           pg, std::move(edge_type_index), std::move(*sorted_topo)));
     }
 
+    span.Finish();
     KATANA_LOG_DEBUG_ASSERT(
         CheckTopology(pg, edge_type_aware_topos_.back().get()));
+    RecordBuildTime(
+        edge_type_aware_topos_.back().get(), res.has_value(), start);
+    accounting_.Track(edge_type_aware_topos_.back().get());
 
     return edge_type_aware_topos_.back();
   }
 }
 
+std::shared_ptr<katana::CompressedGraphTopology>
+katana::PGViewCache::BuildOrGetCompressedTopo(
+    katana::PropertyGraph* pg) noexcept {
+  if (compressed_topo_) {
+    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, compressed_topo_.get()));
+    return compressed_topo_;
+  }
+
+  const auto& default_topo = GetDefaultTopologyRef();
+
+  // no compressed topology in cache, see if we have it in storage
+  katana::RDGTopology shadow = katana::RDGTopology::MakeShadow(
+      katana::RDGTopology::TopologyKind::kCompressedTopology,
+      default_topo.transpose_state(), default_topo.edge_sort_state(),
+      katana::RDGTopology::NodeSortKind::kAny);
+  OperationSpan span("build view", {{"view", "compressed topology"}});
+  auto start = std::chrono::steady_clock::now();
+  auto res = pg->LoadTopology(std::move(shadow));
+  span.SetTags({{"loaded", res.has_value()}});
+
+  compressed_topo_ = (!res) ? CompressedGraphTopology::Make(default_topo)
+                            : CompressedGraphTopology::Make(res.value());
+  span.Finish();
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, compressed_topo_.get()));
+  RecordBuildTime(compressed_topo_.get(), res.has_value(), start);
+
+  return compressed_topo_;
+}
+
+std::shared_ptr<katana::CompactGraphTopology>
+katana::PGViewCache::BuildOrGetCompactTopo(katana::PropertyGraph* pg) noexcept {
+  // The compact topology shares its arrays with the default topology, so it
+  // is only reused as long as the default topology has not been reseated.
+  if (compact_topo_ && &compact_topo_->underlying() == original_topo_.get()) {
+    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, compact_topo_.get()));
+    return compact_topo_;
+  }
+
+  compact_topo_ = CompactGraphTopology::Make(GetDefaultTopology());
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, compact_topo_.get()));
+
+  return compact_topo_;
+}
+
+std::shared_ptr<katana::CompactGraphTopology>
+katana::PGViewCache::BuildOrGetCompactSortedTopo(
+    katana::PropertyGraph* pg) noexcept {
+  auto sorted_topo = BuildOrGetEdgeShuffTopo(
+      pg, katana::RDGTopology::TransposeKind::kNo,
+      katana::RDGTopology::EdgeSortKind::kSortedByDestID);
+  // Reused only as long as the sorted topology it shares arrays with is the
+  // one cached
+  if (compact_sorted_topo_ &&
+      &compact_sorted_topo_->underlying() == sorted_topo.get()) {
+    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, compact_sorted_topo_.get()));
+    return compact_sorted_topo_;
+  }
+
+  compact_sorted_topo_ = CompactGraphTopology::Make(sorted_topo);
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, compact_sorted_topo_.get()));
+
+  return compact_sorted_topo_;
+}
+
+void
+katana::PGViewCache::RecordBuildTime(
+    const void* topo, bool loaded,
+    std::chrono::steady_clock::time_point start) noexcept {
+  if (loaded) {
+    build_times_.erase(topo);
+  } else {
+    build_times_[topo] = std::chrono::steady_clock::now() - start;
+  }
+}
+
+bool
+katana::PGViewCache::ShouldPersist(const void* topo) const noexcept {
+  if (min_persisted_build_time_ <= std::chrono::steady_clock::duration{0}) {
+    return true;
+  }
+  auto it = build_times_.find(topo);
+  return it == build_times_.end() || it->second >= min_persisted_build_time_;
+}
+
 katana::Result<std::vector<katana::RDGTopology>>
 katana::PGViewCache::ToRDGTopology() {
   std::vector<katana::RDGTopology> rdg_topos;
 
   for (size_t i = 0; i < edge_shuff_topos_.size(); i++) {
+    if (!ShouldPersist(edge_shuff_topos_[i].get())) {
+      continue;
+    }
     katana::RDGTopology topo =
         KATANA_CHECKED(edge_shuff_topos_[i]->ToRDGTopology());
     rdg_topos.emplace_back(std::move(topo));
   }
 
   for (size_t i = 0; i < fully_shuff_topos_.size(); i++) {
+    if (!ShouldPersist(fully_shuff_topos_[i].get())) {
+      continue;
+    }
     katana::RDGTopology topo =
         KATANA_CHECKED(fully_shuff_topos_[i]->ToRDGTopology());
     rdg_topos.emplace_back(std::move(topo));
   }
 
   for (size_t i = 0; i < edge_type_aware_topos_.size(); i++) {
+    if (!ShouldPersist(edge_type_aware_topos_[i].get())) {
+      continue;
+    }
     katana::RDGTopology topo =
         KATANA_CHECKED(edge_type_aware_topos_[i]->ToRDGTopology());
     rdg_topos.emplace_back(std::move(topo));
   }
 
+  if (compressed_topo_ && ShouldPersist(compressed_topo_.get())) {
+    katana::RDGTopology topo =
+        KATANA_CHECKED(compressed_topo_->ToRDGTopology());
+    rdg_topos.emplace_back(std::move(topo));
+  }
+
+  // compact_topo_ and compact_sorted_topo_ are not persisted; they are cheap
+  // to derive from the topologies they share their storage with.
+
   return std::vector<katana::RDGTopology>(std::move(rdg_topos));
 }
 
@@ -0,0 +1,260 @@
+#include "katana/HashEntityIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+
+namespace katana {
+
+namespace {
+
+size_t
+NumSlots(size_t num_groups) {
+  // At most half full, so that probes are short
+  size_t num_slots = 16;
+  while (num_slots < 2 * num_groups) {
+    num_slots *= 2;
+  }
+  return num_slots;
+}
+
+}  // namespace
+
+template <typename node_or_edge>
+template <typename Hash, typename Equal>
+Result<void>
+HashEntityIndex<node_or_edge>::Build(
+    const arrow::Array& property, size_t num_entities, const Hash& hash,
+    const Equal& equal) {
+  if (static_cast<uint64_t>(property.length()) < num_entities) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Property does not contain all entities");
+  }
+
+  NUMAArray<uint64_t> hashes;
+  hashes.allocateInterleaved(num_entities);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entities),
+      [&](size_t id) {
+        hashes[id] = property.IsValid(id) ? hash(node_or_edge(id)) : 0;
+      },
+      katana::no_stats());
+
+  // Entities with a value first, by hash and then by id, so that every
+  // value is in the run of its hash
+  ids_.allocateInterleaved(num_entities);
+  katana::ParallelSTL::iota(ids_.begin(), ids_.end(), node_or_edge{0});
+  katana::ParallelSTL::sort(
+      ids_.begin(), ids_.end(), [&](node_or_edge a, node_or_edge b) {
+        bool valid_a = property.IsValid(a);
+        bool valid_b = property.IsValid(b);
+        if (valid_a != valid_b) {
+          return valid_a;
+        }
+        if (hashes[a] != hashes[b]) {
+          return hashes[a] < hashes[b];
+        }
+        return a < b;
+      });
+  num_ids_ = num_entities - property.Slice(0, num_entities)->null_count();
+
+  // Values whose hashes collide may be interleaved in their run; group them
+  // with a stable partition, which keeps each group by id. This is rare
+  // enough to be done serially.
+  std::atomic<bool> collided{false};
+  katana::do_all(
+      katana::iterate(size_t{1}, std::max(num_ids_, size_t{1})),
+      [&](size_t i) {
+        if (hashes[ids_[i]] == hashes[ids_[i - 1]] &&
+            !equal(ids_[i], ids_[i - 1])) {
+          collided = true;
+        }
+      },
+      katana::no_stats());
+  if (collided) {
+    for (size_t begin = 0; begin < num_ids_;) {
+      size_t end = begin + 1;
+      while (end < num_ids_ && hashes[ids_[end]] == hashes[ids_[begin]]) {
+        ++end;
+      }
+      for (node_or_edge* group = &ids_[begin]; group != &ids_[0] + end;) {
+        node_or_edge first = *group;
+        group = std::stable_partition(
+            group, &ids_[0] + end,
+            [&](node_or_edge id) { return equal(id, first); });
+      }
+      begin = end;
+    }
+  }
+
+  // The group of every position, plus one
+  NUMAArray<uint64_t> groups;
+  groups.allocateInterleaved(num_ids_);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids_),
+      [&](size_t i) {
+        groups[i] = i == 0 || hashes[ids_[i]] != hashes[ids_[i - 1]] ||
+                    !equal(ids_[i], ids_[i - 1]);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      groups.begin(), groups.end(), groups.begin());
+  num_groups_ = num_ids_ == 0 ? 0 : groups[num_ids_ - 1];
+  if (num_groups_ > kGroupMask - 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "{} values are too many for a hash index",
+        num_groups_);
+  }
+
+  group_offsets_.allocateInterleaved(num_groups_ + 1);
+  group_offsets_[num_groups_] = num_ids_;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids_),
+      [&](size_t i) {
+        if (i == 0 || groups[i] != groups[i - 1]) {
+          group_offsets_[groups[i] - 1] = i;
+        }
+      },
+      katana::no_stats());
+
+  size_t num_slots = NumSlots(num_groups_);
+  slots_.allocateInterleaved(num_slots);
+  slot_mask_ = num_slots - 1;
+  katana::ParallelSTL::fill(slots_.begin(), slots_.end(), uint64_t{0});
+  katana::do_all(
+      katana::iterate(size_t{0}, num_groups_),
+      [&](size_t group) {
+        uint64_t h = hashes[ids_[group_offsets_[group]]];
+        uint64_t slot = (Fingerprint(h) << kGroupBits) | (group + 1);
+        for (uint64_t pos = h & slot_mask_;; pos = (pos + 1) & slot_mask_) {
+          if (__sync_bool_compare_and_swap(&slots_[pos], uint64_t{0}, slot)) {
+            return;
+          }
+        }
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+// Switch statement over creation of per-type indexes.
+template <typename node_or_edge>
+Result<std::unique_ptr<HashEntityIndex<node_or_edge>>>
+MakeTypedHashEntityIndex(
+    const std::string& property_name, size_t num_entities,
+    std::shared_ptr<arrow::Array> property) {
+  std::unique_ptr<HashEntityIndex<node_or_edge>> index;
+
+  switch (property->type_id()) {
+  case arrow::Type::UINT8:
+    index = std::make_unique<PrimitiveHashEntityIndex<node_or_edge, uint8_t>>(
+        property_name, num_entities, property);
+    break;
+  case arrow::Type::INT64:
+    index = std::make_unique<PrimitiveHashEntityIndex<node_or_edge, int64_t>>(
+        property_name, num_entities, property);
+    break;
+  case arrow::Type::UINT64:
+    index =
+        std::make_unique<PrimitiveHashEntityIndex<node_or_edge, uint64_t>>(
+            property_name, num_entities, property);
+    break;
+  case arrow::Type::LARGE_STRING:
+    index = std::make_unique<StringHashEntityIndex<node_or_edge>>(
+        property_name, num_entities, property);
+    break;
+  case arrow::Type::DICTIONARY:
+    if (!property->type()->Equals(DictionaryStringType())) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Dictionary column is not of strings for hash indexing: {}",
+          property->type()->ToString());
+    }
+    index = std::make_unique<StringHashEntityIndex<node_or_edge>>(
+        property_name, num_entities, property);
+    break;
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "Column has type unknown for hash indexing: {}",
+        property->type()->ToString());
+  }
+
+  // Some compilers seem to have trouble converting to Result here.
+  return Result<std::unique_ptr<HashEntityIndex<node_or_edge>>>(
+      std::move(index));
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitiveHashEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
+  const ArrowArrayType& property = *property_;
+  return this->Build(
+      property, num_entities_,
+      [&property](node_or_edge id) {
+        return internal::HashKey(static_cast<uint64_t>(property.Value(id)));
+      },
+      [&property](node_or_edge a, node_or_edge b) {
+        return property.Value(a) == property.Value(b);
+      });
+}
+
+template <typename node_or_edge>
+Result<void>
+StringHashEntityIndex<node_or_edge>::BuildFromProperty() {
+  if (codes_ == nullptr) {
+    return this->Build(
+        *property_, num_entities_,
+        [this](node_or_edge id) { return internal::HashKey(ValueOf(id)); },
+        [this](node_or_edge a, node_or_edge b) {
+          return ValueOf(a) == ValueOf(b);
+        });
+  }
+
+  // The dictionary is hashed once, so that entities hash by their code; the
+  // hashes are only needed while building
+  std::vector<uint64_t> code_hashes(strings_->length());
+  katana::do_all(
+      katana::iterate(size_t{0}, code_hashes.size()),
+      [&](size_t code) {
+        arrow::util::string_view view = strings_->GetView(code);
+        code_hashes[code] =
+            internal::HashKey(std::string_view(view.data(), view.length()));
+      },
+      katana::no_stats());
+  const int32_t* codes = codes_;
+  return this->Build(
+      *property_, num_entities_,
+      [&code_hashes, codes](node_or_edge id) { return code_hashes[codes[id]]; },
+      [this, codes](node_or_edge a, node_or_edge b) {
+        return codes[a] == codes[b] || ValueOf(a) == ValueOf(b);
+      });
+}
+
+// Forward declare template types to allow implementation in .cpp.
+template class PrimitiveHashEntityIndex<GraphTopology::Node, uint8_t>;
+template class PrimitiveHashEntityIndex<GraphTopology::Edge, uint8_t>;
+template class PrimitiveHashEntityIndex<GraphTopology::Node, int64_t>;
+template class PrimitiveHashEntityIndex<GraphTopology::Edge, int64_t>;
+template class PrimitiveHashEntityIndex<GraphTopology::Node, uint64_t>;
+template class PrimitiveHashEntityIndex<GraphTopology::Edge, uint64_t>;
+
+template class StringHashEntityIndex<GraphTopology::Node>;
+template class StringHashEntityIndex<GraphTopology::Edge>;
+
+template Result<std::unique_ptr<HashEntityIndex<GraphTopology::Node>>>
+MakeTypedHashEntityIndex(
+    const std::string& property_name, size_t num_entities,
+    std::shared_ptr<arrow::Array> property);
+template Result<std::unique_ptr<HashEntityIndex<GraphTopology::Edge>>>
+MakeTypedHashEntityIndex(
+    const std::string& property_name, size_t num_entities,
+    std::shared_ptr<arrow::Array> property);
+
+}  // namespace katana
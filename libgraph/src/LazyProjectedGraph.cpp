@@ -0,0 +1,84 @@
+#include "katana/LazyProjectedGraph.h"
+
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+katana::LazyProjectedGraph
+katana::LazyProjectedGraph::Make(
+    const PropertyGraph& pg, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) {
+  const GraphTopology& topology = pg.topology();
+  LazyProjectedGraph projection(pg, topology);
+  projection.nodes_.resize(topology.NumNodes());
+  projection.edges_.resize(topology.NumEdges());
+
+  std::vector<EntityTypeID> node_type_ids;
+  for (const auto& node_type : node_types) {
+    node_type_ids.emplace_back(pg.GetNodeEntityTypeID(node_type));
+  }
+  std::vector<EntityTypeID> edge_type_ids;
+  for (const auto& edge_type : edge_types) {
+    edge_type_ids.emplace_back(pg.GetEdgeEntityTypeID(edge_type));
+  }
+
+  DynamicBitset& nodes = projection.nodes_;
+  if (node_types.empty()) {
+    katana::do_all(
+        katana::iterate(topology.Nodes()), [&](Node n) { nodes.set(n); },
+        katana::no_stats());
+  } else {
+    nodes = pg.NodesWithType(node_type_ids);
+  }
+
+  if (edge_types.empty()) {
+    projection.ProjectEdges([](Edge) { return true; });
+  } else {
+    DynamicBitset edges_with_type = pg.EdgesWithType(edge_type_ids);
+    projection.ProjectEdges([&](Edge e) { return edges_with_type.test(e); });
+  }
+  return projection;
+}
+
+katana::LazyProjectedGraph
+katana::LazyProjectedGraph::MakeFromMasks(
+    const PropertyGraph& pg, DynamicBitset node_mask,
+    const DynamicBitset* edge_mask) {
+  const GraphTopology& topology = pg.topology();
+  KATANA_LOG_ASSERT(node_mask.size() == topology.NumNodes());
+  KATANA_LOG_ASSERT(
+      edge_mask == nullptr || edge_mask->size() == topology.NumEdges());
+  LazyProjectedGraph projection(pg, topology);
+  projection.nodes_ = std::move(node_mask);
+  projection.edges_.resize(topology.NumEdges());
+  projection.ProjectEdges(
+      [&](Edge e) { return edge_mask == nullptr || edge_mask->test(e); });
+  return projection;
+}
+
+template <typename F>
+void
+katana::LazyProjectedGraph::ProjectEdges(const F& has_edge) {
+  const GraphTopology& topology = *topology_;
+  const DynamicBitset& nodes = nodes_;
+  DynamicBitset& edges = edges_;
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](Node src) {
+        if (!nodes.test(src)) {
+          return;
+        }
+        for (Edge e : topology.OutEdges(src)) {
+          if (nodes.test(topology.OutEdgeDst(e)) && has_edge(e)) {
+            edges.set(e);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  num_nodes_ = nodes.count();
+  num_edges_ = edges.count();
+}
@@ -0,0 +1,231 @@
+#include "katana/MirrorSync.h"
+
+#include <arrow/array.h>
+#include <arrow/chunked_array.h>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+/// The first byte of a non-empty message; an empty message has no values
+enum Encoding : char {
+  /// The values of every node, in order
+  kAll = 1,
+  /// A bitset over the nodes, then the values of the set ones
+  kBitset = 2,
+  /// The number of values, their uint32_t positions, then the values
+  kPositions = 3,
+};
+
+constexpr size_t kWordBits = 64;
+
+katana::Result<std::vector<uint32_t>>
+ToLocalIDs(const arrow::ChunkedArray& array, uint32_t num_nodes) {
+  std::vector<uint32_t> ids;
+  ids.reserve(array.length());
+  for (const auto& chunk : array.chunks()) {
+    if (chunk->null_count() > 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "null node ids in partition");
+    }
+    if (chunk->type_id() == arrow::Type::UINT32) {
+      const auto& a = static_cast<const arrow::UInt32Array&>(*chunk);
+      ids.insert(ids.end(), a.raw_values(), a.raw_values() + a.length());
+    } else if (chunk->type_id() == arrow::Type::UINT64) {
+      const auto& a = static_cast<const arrow::UInt64Array&>(*chunk);
+      for (int64_t i = 0; i < a.length(); ++i) {
+        if (a.Value(i) >= num_nodes) {
+          return KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument, "node id {} out of range",
+              a.Value(i));
+        }
+        ids.emplace_back(a.Value(i));
+      }
+    } else {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError,
+          "partition node ids must be uint32 or uint64, not {}",
+          chunk->type()->ToString());
+    }
+  }
+  return ids;
+}
+
+}  // namespace
+
+katana::MirrorSync::MirrorSync(
+    CommBackend* comm, uint32_t num_nodes,
+    std::vector<std::vector<uint32_t>> master_nodes,
+    std::vector<std::vector<uint32_t>> mirror_nodes)
+    : comm_(comm),
+      master_nodes_(std::move(master_nodes)),
+      mirror_nodes_(std::move(mirror_nodes)) {
+  dirty_.resize(num_nodes);
+  updated_.resize(num_nodes);
+}
+
+katana::Result<katana::MirrorSync>
+katana::MirrorSync::Make(
+    CommBackend* comm, uint32_t num_nodes,
+    std::vector<std::vector<uint32_t>> master_nodes,
+    std::vector<std::vector<uint32_t>> mirror_nodes) {
+  for (const auto* lists : {&master_nodes, &mirror_nodes}) {
+    // A graph that is not partitioned has no masters or mirrors to sync
+    if (!lists->empty() && lists->size() != comm->Num) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "the graph has {} partitions but there are {} hosts", lists->size(),
+          comm->Num);
+    }
+  }
+  master_nodes.resize(comm->Num);
+  mirror_nodes.resize(comm->Num);
+  if (!master_nodes[comm->Rank].empty() || !mirror_nodes[comm->Rank].empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "host {} cannot mirror its own nodes",
+        comm->Rank);
+  }
+  for (const auto* lists : {&master_nodes, &mirror_nodes}) {
+    for (const std::vector<uint32_t>& nodes : *lists) {
+      for (uint32_t node : nodes) {
+        if (node >= num_nodes) {
+          return KATANA_ERROR(
+              ErrorCode::InvalidArgument, "node id {} out of range", node);
+        }
+      }
+    }
+  }
+  return MirrorSync(
+      comm, num_nodes, std::move(master_nodes), std::move(mirror_nodes));
+}
+
+katana::Result<katana::MirrorSync>
+katana::MirrorSync::Make(const PropertyGraph& pg, CommBackend* comm) {
+  uint32_t num_nodes = pg.NumNodes();
+  std::vector<std::vector<uint32_t>> master_nodes;
+  for (const auto& array : pg.master_nodes()) {
+    master_nodes.emplace_back(KATANA_CHECKED(ToLocalIDs(*array, num_nodes)));
+  }
+  std::vector<std::vector<uint32_t>> mirror_nodes;
+  for (const auto& array : pg.mirror_nodes()) {
+    mirror_nodes.emplace_back(KATANA_CHECKED(ToLocalIDs(*array, num_nodes)));
+  }
+  return Make(
+      comm, num_nodes, std::move(master_nodes), std::move(mirror_nodes));
+}
+
+std::string
+katana::MirrorSync::Encode(
+    const std::vector<uint32_t>& nodes, size_t value_size,
+    std::vector<uint32_t>* positions) const {
+  positions->clear();
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (dirty_.test(nodes[i])) {
+      positions->emplace_back(i);
+    }
+  }
+  if (positions->empty()) {
+    return std::string();
+  }
+
+  size_t num_words = (nodes.size() + kWordBits - 1) / kWordBits;
+  size_t all_size = nodes.size() * value_size;
+  size_t values_size = positions->size() * value_size;
+  size_t bitset_size = num_words * sizeof(uint64_t) + values_size;
+  size_t positions_size =
+      (1 + positions->size()) * sizeof(uint32_t) + values_size;
+
+  std::string msg;
+  if (all_size <= bitset_size && all_size <= positions_size) {
+    msg.push_back(kAll);
+    positions->resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      (*positions)[i] = i;
+    }
+  } else if (bitset_size <= positions_size) {
+    msg.push_back(kBitset);
+    std::vector<uint64_t> words(num_words);
+    for (uint32_t pos : *positions) {
+      words[pos / kWordBits] |= uint64_t{1} << (pos % kWordBits);
+    }
+    msg.append(
+        reinterpret_cast<const char*>(words.data()),
+        words.size() * sizeof(uint64_t));
+  } else {
+    msg.push_back(kPositions);
+    uint32_t num = positions->size();
+    msg.append(reinterpret_cast<const char*>(&num), sizeof(num));
+    msg.append(
+        reinterpret_cast<const char*>(positions->data()),
+        positions->size() * sizeof(uint32_t));
+  }
+  return msg;
+}
+
+std::vector<uint32_t>
+katana::MirrorSync::Decode(
+    const std::string& msg, size_t num_nodes, size_t* values_offset) {
+  std::vector<uint32_t> positions;
+  *values_offset = 0;
+  if (msg.empty()) {
+    return positions;
+  }
+
+  size_t pos = 1;
+  switch (msg[0]) {
+  case kAll:
+    positions.resize(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+      positions[i] = i;
+    }
+    break;
+  case kBitset: {
+    size_t num_words = (num_nodes + kWordBits - 1) / kWordBits;
+    KATANA_LOG_ASSERT(msg.size() >= pos + num_words * sizeof(uint64_t));
+    for (size_t w = 0; w < num_words; ++w) {
+      uint64_t word;
+      std::memcpy(&word, msg.data() + pos, sizeof(word));
+      pos += sizeof(word);
+      while (word != 0) {
+        positions.emplace_back(w * kWordBits + __builtin_ctzll(word));
+        word &= word - 1;
+      }
+    }
+    break;
+  }
+  case kPositions: {
+    uint32_t num = 0;
+    KATANA_LOG_ASSERT(msg.size() >= pos + sizeof(num));
+    std::memcpy(&num, msg.data() + pos, sizeof(num));
+    pos += sizeof(num);
+    KATANA_LOG_ASSERT(msg.size() >= pos + num * sizeof(uint32_t));
+    positions.resize(num);
+    std::memcpy(positions.data(), msg.data() + pos, num * sizeof(uint32_t));
+    pos += num * sizeof(uint32_t);
+    break;
+  }
+  default:
+    KATANA_LOG_FATAL("unknown sync message encoding {}", int{msg[0]});
+  }
+
+  for (uint32_t p : positions) {
+    KATANA_LOG_ASSERT(p < num_nodes);
+  }
+  *values_offset = pos;
+  return positions;
+}
+
+void
+katana::MirrorSync::ResetDirty(const std::vector<uint32_t>& nodes) {
+  for (uint32_t node : nodes) {
+    dirty_.reset(node);
+  }
+}
+
+std::vector<std::string>
+katana::MirrorSync::Exchange(const std::vector<std::string>& out) {
+  for (const std::string& msg : out) {
+    num_bytes_sent_ += msg.size();
+  }
+  return comm_->AllToAllBytes(out);
+}
@@ -3,59 +3,137 @@
 #include <stdio.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <arrow/array.h>
+#include <arrow/compute/api.h>
 
 #include "katana/ArrowInterchange.h"
+#include "katana/ContentHash.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileFrame.h"
 #include "katana/GraphTopology.h"
 #include "katana/Iterators.h"
+#include "katana/LazyProjectedGraph.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
+#include "katana/MemorySupervisor.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/PropertyManager.h"
 #include "katana/RDG.h"
 #include "katana/RDGManifest.h"
 #include "katana/RDGPrefix.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
 #include "katana/tsuba.h"
 
 namespace {
 
-[[maybe_unused]] bool
-CheckTopology(
-    const uint64_t* out_indices, const uint64_t num_nodes,
-    const uint32_t* out_dests, const uint64_t num_edges) {
-  bool has_bad_adj = false;
-
+/// The number of elements a task of the validation loops checks
+constexpr uint64_t kValidationChunkSize = uint64_t{1} << 16;
+
+/// FindFirstInvalid returns the smallest i in [0, size) for which
+/// is_invalid(i), or size if there is none. The range is checked in parallel
+/// in chunks, and chunks past an invalid element are skipped.
+template <typename IsInvalid>
+uint64_t
+FindFirstInvalid(uint64_t size, const IsInvalid& is_invalid) {
+  std::atomic<uint64_t> first_invalid{size};
+  uint64_t num_chunks =
+      (size + kValidationChunkSize - 1) / kValidationChunkSize;
   katana::do_all(
-      katana::iterate(uint64_t{0}, num_nodes),
-      [&](auto n) {
-        if (out_indices[n] > num_edges) {
-          has_bad_adj = true;
+      katana::iterate(uint64_t{0}, num_chunks),
+      [&](uint64_t chunk) {
+        uint64_t begin = chunk * kValidationChunkSize;
+        uint64_t end = std::min(size, begin + kValidationChunkSize);
+        if (begin >= first_invalid.load(std::memory_order_relaxed)) {
+          return;
         }
-      },
-      katana::no_stats());
-
-  bool has_bad_dest = false;
-  katana::do_all(
-      katana::iterate(uint64_t{0}, num_edges),
-      [&](auto e) {
-        if (out_dests[e] >= num_nodes) {
-          has_bad_dest = true;
+        for (uint64_t i = begin; i < end; ++i) {
+          if (!is_invalid(i)) {
+            continue;
+          }
+          uint64_t prev = first_invalid.load(std::memory_order_relaxed);
+          while (i < prev && !first_invalid.compare_exchange_weak(
+                                 prev, i, std::memory_order_relaxed)) {
+          }
+          return;
         }
       },
-      katana::no_stats());
+      katana::steal(), katana::no_stats());
+  return first_invalid.load();
+}
+
+/// ValidateTopology checks that the adjacency indices of a csr topology are
+/// non-decreasing and end at num_edges, and that every destination is a node
+katana::Result<void>
+ValidateTopology(
+    const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+    uint64_t num_edges) {
+  uint64_t last_index = num_nodes == 0 ? 0 : adj_indices[num_nodes - 1];
+  if (last_index != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the adjacency indices end at {} but there are {} edges", last_index,
+        num_edges);
+  }
 
-  return !has_bad_adj && !has_bad_dest;
+  uint64_t bad_node = FindFirstInvalid(num_nodes, [&](uint64_t n) {
+    return n > 0 && adj_indices[n] < adj_indices[n - 1];
+  });
+  if (bad_node != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the adjacency index {} of node {} is less than the one before it",
+        adj_indices[bad_node], bad_node);
+  }
+
+  uint64_t bad_edge = FindFirstInvalid(
+      num_edges, [&](uint64_t e) { return dests[e] >= num_nodes; });
+  if (bad_edge != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the destination {} of edge {} is not one of the {} nodes",
+        dests[bad_edge], bad_edge, num_nodes);
+  }
+  return katana::ResultSuccess();
+}
+
+/// ValidateEntityTypeIDs checks that every id of entity_type_ids is one of the
+/// types of manager
+katana::Result<void>
+ValidateEntityTypeIDs(
+    const katana::PropertyGraph::EntityTypeIDArray& entity_type_ids,
+    const katana::EntityTypeManager& manager, const char* entity_kind) {
+  uint64_t num_types = manager.GetNumEntityTypes();
+  uint64_t bad = FindFirstInvalid(entity_type_ids.size(), [&](uint64_t i) {
+    return entity_type_ids[i] >= num_types;
+  });
+  if (bad != entity_type_ids.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the {} type {} of {} {} is not one of the {} types", entity_kind,
+        entity_type_ids[bad], entity_kind, bad, num_types);
+  }
+  return katana::ResultSuccess();
 }
 
 /// MapEntityTypeIDsFromFile takes a file buffer of a node or edge Type set ID file
@@ -114,6 +192,234 @@ WriteEntityTypeIDsArray(
   return std::unique_ptr<katana::FileFrame>(std::move(ff));
 }
 
+/// A hash of the contents of entity_type_id_array, to tell whether the array
+/// changed since it was loaded or written
+uint64_t
+FingerprintEntityTypeIDsArray(
+    const katana::NUMAArray<katana::EntityTypeID>& entity_type_id_array) {
+  // sum of a strong mix of (index, value), so it can be computed in any order
+  katana::GAccumulator<uint64_t> accum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, entity_type_id_array.size()),
+      [&](uint64_t i) {
+        accum += katana::Mix64((i << 16) | entity_type_id_array[i]);
+      },
+      katana::no_stats());
+  return accum.reduce();
+}
+
+/// The content hashes of the adjacency indices and the destinations of topo
+std::pair<katana::ContentHash, katana::ContentHash>
+HashTopology(const katana::GraphTopology& topo) {
+  return {
+      katana::ContentHash::OfFixedWidth(
+          topo.AdjData(), sizeof(katana::GraphTopology::Edge),
+          topo.NumNodes()),
+      katana::ContentHash::OfFixedWidth(
+          topo.DestData(), sizeof(katana::GraphTopology::Node),
+          topo.NumEdges())};
+}
+
+/// The content hash of an entity type id array in terms of the names of the
+/// atomic types of every id, since the ids of the same types can differ
+/// between graphs. The arrays are modified in place without notice, so they
+/// are hashed again every time rather than stored.
+katana::ContentHash
+HashEntityTypeIDs(
+    const katana::EntityTypeManager& manager,
+    const katana::PropertyGraph::EntityTypeIDArray& entity_type_ids) {
+  // types without names only match the same id
+  constexpr uint64_t kUnnamedTypeHash = UINT64_C(0xbb67ae8584caa73b);
+  std::vector<uint64_t> name_hashes(manager.GetNumEntityTypes());
+  for (size_t id = 0; id < name_hashes.size(); ++id) {
+    auto names = manager.EntityTypeToTypeNameSet(
+        static_cast<katana::EntityTypeID>(id));
+    if (!names) {
+      name_hashes[id] = katana::ContentHash::MixElement(id, kUnnamedTypeHash);
+      continue;
+    }
+    std::string joined;
+    for (const auto& name : names.value()) {
+      joined.append(name).push_back('\0');
+    }
+    name_hashes[id] =
+        katana::ContentHash::HashBytes(joined.data(), joined.size());
+  }
+
+  return katana::ContentHash::Make(
+      entity_type_ids.size(), [&](uint64_t begin, uint64_t end) {
+        uint64_t sum = 0;
+        for (uint64_t i = begin; i < end; ++i) {
+          katana::EntityTypeID id = entity_type_ids[i];
+          sum += katana::ContentHash::MixElement(
+              i, id < name_hashes.size()
+                     ? name_hashes[id]
+                     : katana::ContentHash::MixElement(id, kUnnamedTypeHash));
+        }
+        return sum;
+      });
+}
+
+/// The content hash of the loaded property column name, as stored with the
+/// property in rdg if it was; otherwise the column is hashed and the hash is
+/// kept in rdg to be stored the next time it is
+katana::Result<katana::ContentHash>
+PropertyContentHash(
+    katana::RDG* rdg, const std::string& name,
+    const arrow::ChunkedArray& column, bool node) {
+  std::optional<katana::ContentHash> stored =
+      node ? rdg->GetNodePropertyContentHash(name)
+           : rdg->GetEdgePropertyContentHash(name);
+  if (stored &&
+      stored->chunk_size == katana::ContentHash::kDefaultChunkSize &&
+      stored->length == static_cast<uint64_t>(column.length())) {
+    return std::move(stored.value());
+  }
+
+  katana::ContentHash hash =
+      KATANA_CHECKED(katana::ContentHash::OfColumn(column));
+  // dirty properties are hashed again every time
+  if (auto res = node ? rdg->SetNodePropertyContentHash(name, hash)
+                      : rdg->SetEdgePropertyContentHash(name, hash);
+      !res) {
+    KATANA_LOG_DEBUG("not keeping the hash of {}: {}", name, res.error());
+  }
+  return hash;
+}
+
+/// Whether the property columns name of rdg and other_rdg are equal,
+/// comparing their content hashes if their type can be hashed
+bool
+PropertiesEqual(
+    katana::RDG* rdg, katana::RDG* other_rdg, const std::string& name,
+    bool node) {
+  auto col = (node ? rdg->node_properties() : rdg->edge_properties())
+                 ->GetColumnByName(name);
+  auto other_col =
+      (node ? other_rdg->node_properties() : other_rdg->edge_properties())
+          ->GetColumnByName(name);
+  if (col == nullptr || other_col == nullptr) {
+    return col == other_col;
+  }
+  if (!col->type()->Equals(other_col->type()) ||
+      col->length() != other_col->length()) {
+    return false;
+  }
+  auto hash = PropertyContentHash(rdg, name, *col, node);
+  auto other_hash = PropertyContentHash(other_rdg, name, *other_col, node);
+  if (!hash || !other_hash) {
+    return col->Equals(other_col);
+  }
+  return hash.value() == other_hash.value();
+}
+
+/// Report how the property columns name of rdg and other_rdg differ, only
+/// looking at the elements of the chunks whose content hashes differ
+void
+ReportPropertyDiff(
+    fmt::memory_buffer& buf, katana::RDG* rdg, katana::RDG* other_rdg,
+    const std::string& name, bool node) {
+  // the differing chunks reported in full
+  constexpr size_t kMaxReportedChunks = 4;
+  const char* kind = node ? "Node" : "Edge";
+  auto my_col = (node ? rdg->node_properties() : rdg->edge_properties())
+                    ->GetColumnByName(name);
+  auto other_col =
+      (node ? other_rdg->node_properties() : other_rdg->edge_properties())
+          ->GetColumnByName(name);
+  if (other_col == nullptr) {
+    fmt::format_to(
+        std::back_inserter(buf), "Only first has {} property {}\n",
+        node ? "node" : "edge", name);
+    return;
+  }
+  if (PropertiesEqual(rdg, other_rdg, name, node)) {
+    fmt::format_to(
+        std::back_inserter(buf), "{} property {:15} {:12} matches!\n", kind,
+        name, fmt::format("({})", my_col->type()->name()));
+    return;
+  }
+
+  fmt::format_to(
+      std::back_inserter(buf), "{} property {:15} {:12} differs\n", kind, name,
+      fmt::format("({})", my_col->type()->name()));
+  if (my_col->length() != other_col->length()) {
+    fmt::format_to(
+        std::back_inserter(buf), " size {}/{}\n", my_col->length(),
+        other_col->length());
+    return;
+  }
+  auto hash = PropertyContentHash(rdg, name, *my_col, node);
+  auto other_hash = PropertyContentHash(other_rdg, name, *other_col, node);
+  if (!hash || !other_hash || !my_col->type()->Equals(other_col->type())) {
+    DiffFormatTo(buf, my_col, other_col);
+    return;
+  }
+  std::vector<uint64_t> differing =
+      hash.value().DifferingChunks(other_hash.value());
+  for (size_t i = 0; i < differing.size() && i < kMaxReportedChunks; ++i) {
+    uint64_t begin = hash.value().ChunkBegin(differing[i]);
+    uint64_t length = hash.value().ChunkLength(differing[i]);
+    fmt::format_to(
+        std::back_inserter(buf), " rows [{}, {}):\n", begin, begin + length);
+    DiffFormatTo(
+        buf, my_col->Slice(begin, length), other_col->Slice(begin, length));
+  }
+  if (differing.size() > kMaxReportedChunks) {
+    fmt::format_to(
+        std::back_inserter(buf), " and {} more chunks of {} rows differ\n",
+        differing.size() - kMaxReportedChunks, hash.value().chunk_size);
+  }
+}
+
+/// Report how the entity type ids of two graphs differ, only looking at the
+/// elements of the chunks whose content hashes differ
+void
+ReportEntityTypeIDsDiff(
+    fmt::memory_buffer& buf, const char* kind,
+    const katana::EntityTypeManager& manager,
+    const katana::PropertyGraph::EntityTypeIDArray& ids,
+    const katana::EntityTypeManager& other_manager,
+    const katana::PropertyGraph::EntityTypeIDArray& other_ids) {
+  // The TypeIDs can change, but their string interpretation cannot
+  if (ids.size() != other_ids.size()) {
+    fmt::format_to(
+        std::back_inserter(buf), "{}_entity_type_ids differ. size {} vs. {}\n",
+        kind, ids.size(), other_ids.size());
+    return;
+  }
+  katana::ContentHash hash = HashEntityTypeIDs(manager, ids);
+  katana::ContentHash other_hash = HashEntityTypeIDs(other_manager, other_ids);
+  bool match = true;
+  for (uint64_t chunk : hash.DifferingChunks(other_hash)) {
+    uint64_t end = hash.ChunkBegin(chunk) + hash.ChunkLength(chunk);
+    for (uint64_t i = hash.ChunkBegin(chunk); i < end; ++i) {
+      auto tns_res = manager.EntityTypeToTypeNameSet(ids[i]);
+      auto otns_res = other_manager.EntityTypeToTypeNameSet(other_ids[i]);
+      if (!tns_res || !otns_res) {
+        fmt::format_to(
+            std::back_inserter(buf),
+            "{} error types index {} entity lhs {} entity rhs_{}\n", kind, i,
+            ids[i], other_ids[i]);
+        return;
+      }
+      auto tns = tns_res.value();
+      auto otns = otns_res.value();
+      if (tns != otns) {
+        fmt::format_to(
+            std::back_inserter(buf),
+            "{}_entity_type_ids differ. {:4} {} {} {} {}\n", kind, i, ids[i],
+            fmt::join(tns, ", "), other_ids[i], fmt::join(otns, ", "));
+        match = false;
+      }
+    }
+  }
+  if (match) {
+    fmt::format_to(
+        std::back_inserter(buf), "{}_entity_type_ids Match!\n", kind);
+  }
+}
+
 katana::PropertyGraph::EntityTypeIDArray
 MakeDefaultEntityTypeIDArray(size_t vec_sz) {
   katana::PropertyGraph::EntityTypeIDArray type_ids;
@@ -149,6 +455,405 @@ FillBitMask(
   });
 }
 
+/// The named columns of table, sharing their buffers with it, or nullptr if
+/// one of them is not in it
+std::shared_ptr<arrow::Table>
+SelectColumns(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<std::string>& names) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    int i = table->schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return nullptr;
+    }
+    fields.emplace_back(table->schema()->field(i));
+    columns.emplace_back(table->column(i));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, table->num_rows());
+}
+
+/// The values of by_id, by node or edge id of a topology, in the num_rows
+/// property rows given by property_index(id). They are by_id itself when
+/// every id is its own row, and are otherwise taken into rows of their own,
+/// where the rows of no id are null.
+template <typename IndexFn>
+katana::Result<std::shared_ptr<arrow::Array>>
+GatherToPropertyRows(
+    const std::shared_ptr<arrow::Array>& by_id, uint64_t num_rows,
+    const IndexFn& property_index) {
+  uint64_t num_ids = by_id->length();
+  katana::GReduceLogicalOr moved;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_ids),
+      [&](uint64_t id) {
+        if (property_index(id) != id) {
+          moved.update(true);
+        }
+      },
+      katana::no_stats());
+  if (num_rows == num_ids && !moved.reduce()) {
+    return by_id;
+  }
+
+  katana::NUMAArray<uint64_t> ids;
+  ids.allocateInterleaved(num_rows);
+  katana::ParallelSTL::fill(ids.begin(), ids.end(), uint64_t{0});
+  katana::DynamicBitset present;
+  present.resize(num_rows);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_ids),
+      [&](uint64_t id) {
+        uint64_t row = property_index(id);
+        ids[row] = id;
+        present.set(row);
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<uint8_t> valid;
+  valid.allocateInterleaved((num_rows + 7) / 8);
+  FillBitMask(num_rows, present, &valid);
+
+  arrow::UInt64Array indices(
+      num_rows, arrow::Buffer::Wrap(ids.data(), ids.size()),
+      arrow::Buffer::Wrap(valid.data(), valid.size()));
+  return KATANA_CHECKED(arrow::compute::Take(*by_id, indices));
+}
+
+/// The ids in [0, num_ids) whose most specific type type_of(id) has any of
+/// type_ids. The matching types are a bitmap, and every iteration computes a
+/// word of the result from it without a branch or an atomic update.
+template <typename TypeFn>
+katana::DynamicBitset
+EntitiesWithType(
+    const katana::EntityTypeManager& manager,
+    const std::vector<katana::EntityTypeID>& type_ids, uint64_t num_ids,
+    const TypeFn& type_of) {
+  std::vector<uint64_t> matching((manager.GetNumEntityTypes() + 63) / 64);
+  for (katana::EntityTypeID type_id : type_ids) {
+    const auto& words = manager.GetEntityTypesWithType(type_id).get_vec();
+    for (size_t w = 0; w < matching.size(); ++w) {
+      matching[w] |= words[w];
+    }
+  }
+
+  constexpr uint64_t kBits = katana::DynamicBitset::kNumBitsInUint64;
+  katana::DynamicBitset entities;
+  entities.resize(num_ids);
+  auto& words = entities.get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, words.size()),
+      [&](size_t w) {
+        uint64_t begin = w * kBits;
+        uint64_t end = std::min(begin + kBits, num_ids);
+        uint64_t word = 0;
+        for (uint64_t id = begin; id < end; ++id) {
+          katana::EntityTypeID type = type_of(id);
+          uint64_t bit = (matching[type / kBits] >> (type % kBits)) & 1;
+          word |= bit << (id - begin);
+        }
+        words[w] = word;
+      },
+      katana::no_stats());
+  return entities;
+}
+
+/// Map the stored index of the property of index, if there is one and it was
+/// built from the property as it is stored now, and build the index
+/// otherwise. A stored index that cannot be used is only worth a warning,
+/// since the index can always be built.
+template <typename node_or_edge>
+katana::Result<void>
+LoadOrBuildIndex(
+    katana::PropertyGraph* pg, bool is_node, const arrow::Array& property,
+    uint64_t num_entities, katana::EntityIndex<node_or_edge>* index) {
+  if (!KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat)) {
+    return index->BuildFromProperty();
+  }
+  std::string name = index->property_name();
+  auto stored = pg->LoadEntityIndexPrimitive(
+      katana::EntityIndexPrimitive::Name(is_node, name));
+  if (!stored) {
+    KATANA_LOG_WARN("loading stored index of {}: {}", name, stored.error());
+    return index->BuildFromProperty();
+  }
+  if (!stored.value()) {
+    return index->BuildFromProperty();
+  }
+
+  // Only a property as it is stored has a file to compare with
+  katana::Result<katana::Uri> location =
+      is_node ? pg->GetNodePropertyStorageLocation(name)
+              : pg->GetEdgePropertyStorageLocation(name);
+  katana::EntityIndexPrimitive& primitive = stored.value().value();
+  if (!location || primitive.property_path() != location.value().BaseName() ||
+      primitive.num_entities() != num_entities ||
+      primitive.type() != property.type()->ToString()) {
+    KATANA_LOG_VERBOSE("stored index of {} is stale", name);
+    return index->BuildFromProperty();
+  }
+  if (auto res = index->BuildFromPrimitive(std::move(primitive)); !res) {
+    KATANA_LOG_WARN("using stored index of {}: {}", name, res.error());
+    return index->BuildFromProperty();
+  }
+  return katana::ResultSuccess();
+}
+
+/// The index of indexes over the property named property_name, if any
+template <typename Index>
+std::shared_ptr<Index>
+FindIndex(
+    const std::vector<std::shared_ptr<Index>>& indexes,
+    const std::string& property_name) {
+  for (const auto& index : indexes) {
+    if (index->property_name() == property_name) {
+      return index;
+    }
+  }
+  return nullptr;
+}
+
+/// Bring the indexes among indexes over the properties of props, which were
+/// just upserted, up to date with them, as returned by get_property. An
+/// index of a property whose type changed is built again.
+template <typename node_or_edge, typename PropertyFn>
+katana::Result<void>
+UpdateIndexes(
+    std::vector<std::shared_ptr<katana::EntityIndex<node_or_edge>>>* indexes,
+    const arrow::Table& props, uint64_t num_entities,
+    const PropertyFn& get_property) {
+  for (const auto& name : props.ColumnNames()) {
+    auto it = std::find_if(
+        indexes->begin(), indexes->end(),
+        [&](const auto& index) { return index->property_name() == name; });
+    if (it == indexes->end()) {
+      continue;
+    }
+    std::shared_ptr<arrow::ChunkedArray> chunked_property =
+        KATANA_CHECKED(get_property(name));
+    std::shared_ptr<arrow::Array> property =
+        KATANA_CHECKED(katana::ContiguousArray(*chunked_property));
+    if (auto res = (*it)->UpdateFromProperty(property); !res) {
+      KATANA_LOG_VERBOSE("building index of {} again: {}", name, res.error());
+      std::shared_ptr<katana::EntityIndex<node_or_edge>> index =
+          KATANA_CHECKED(katana::MakeTypedEntityIndex<node_or_edge>(
+              name, num_entities, property));
+      KATANA_CHECKED(index->BuildFromProperty());
+      *it = std::move(index);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Build a hash index over property, with num_entities, and add it to
+/// indexes
+template <typename node_or_edge>
+katana::Result<void>
+MakeHashIndex(
+    std::vector<std::shared_ptr<katana::HashEntityIndex<node_or_edge>>>*
+        indexes,
+    const std::string& property_name,
+    const std::shared_ptr<arrow::ChunkedArray>& chunked_property,
+    size_t num_entities) {
+  if (FindIndex(*indexes, property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists,
+        "Hash index already exists for column {}", property_name);
+  }
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(katana::ContiguousArray(*chunked_property));
+
+  std::shared_ptr<katana::HashEntityIndex<node_or_edge>> index =
+      KATANA_CHECKED(katana::MakeTypedHashEntityIndex<node_or_edge>(
+          property_name, num_entities, property));
+  KATANA_CHECKED(index->BuildFromProperty());
+  indexes->push_back(std::move(index));
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+using CompositeIndexes =
+    std::vector<std::shared_ptr<katana::CompositeEntityIndex<node_or_edge>>>;
+
+/// The index among indexes over property_names scoped to type_ids, which
+/// are a set
+template <typename node_or_edge>
+typename CompositeIndexes<node_or_edge>::const_iterator
+FindCompositeIndex(
+    const CompositeIndexes<node_or_edge>& indexes,
+    const std::vector<std::string>& property_names,
+    std::vector<katana::EntityTypeID> type_ids) {
+  std::sort(type_ids.begin(), type_ids.end());
+  type_ids.erase(std::unique(type_ids.begin(), type_ids.end()), type_ids.end());
+  return std::find_if(indexes.begin(), indexes.end(), [&](const auto& index) {
+    return index->property_names() == property_names &&
+           index->type_ids() == type_ids;
+  });
+}
+
+/// Build an index over the properties named property_names, as returned by
+/// get_property, of the entities with any of type_ids by manager and
+/// type_of(id), or of all num_entities, and add it to indexes
+template <typename node_or_edge, typename PropertyFn, typename TypeFn>
+katana::Result<std::shared_ptr<katana::CompositeEntityIndex<node_or_edge>>>
+MakeCompositeIndex(
+    CompositeIndexes<node_or_edge>* indexes,
+    const std::vector<std::string>& property_names,
+    const std::vector<katana::EntityTypeID>& type_ids,
+    const PropertyFn& get_property, const katana::EntityTypeManager& manager,
+    uint64_t num_entities, const TypeFn& type_of) {
+  if (FindCompositeIndex(*indexes, property_names, type_ids) !=
+      indexes->end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists, "Index already exists for columns {}",
+        fmt::join(property_names, ", "));
+  }
+  std::vector<std::shared_ptr<arrow::Array>> properties;
+  for (const auto& name : property_names) {
+    std::shared_ptr<arrow::ChunkedArray> chunked_property =
+        KATANA_CHECKED(get_property(name));
+    properties.emplace_back(
+        KATANA_CHECKED(katana::ContiguousArray(*chunked_property)));
+  }
+  for (katana::EntityTypeID type_id : type_ids) {
+    if (!manager.HasEntityType(type_id)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "unknown entity type {}",
+          type_id);
+    }
+  }
+
+  std::shared_ptr<katana::CompositeEntityIndex<node_or_edge>> index =
+      KATANA_CHECKED(katana::CompositeEntityIndex<node_or_edge>::Make(
+          property_names, properties, type_ids));
+  std::vector<node_or_edge> candidates;
+  if (type_ids.empty()) {
+    candidates.resize(num_entities);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_entities),
+        [&](uint64_t id) { candidates[id] = id; }, katana::no_stats());
+  } else {
+    candidates = EntitiesWithType(manager, type_ids, num_entities, type_of)
+                     .template GetOffsets<node_or_edge>();
+  }
+  KATANA_CHECKED(index->Build(std::move(candidates)));
+  indexes->push_back(index);
+  return index;
+}
+
+/// The arrays of index, with what identifies the version of the property it
+/// was built from, to be stored with the graph
+template <typename node_or_edge>
+katana::EntityIndexPrimitive
+StoredIndex(
+    const katana::EntityIndex<node_or_edge>& index,
+    const katana::Uri& location, const arrow::ChunkedArray& property,
+    uint64_t num_entities) {
+  katana::EntityIndexPrimitive primitive = index.ToPrimitive();
+  primitive.set_property_path(location.BaseName());
+  primitive.set_type(property.type()->ToString());
+  primitive.set_num_entities(num_entities);
+  return primitive;
+}
+
+/// A default topology loaded to be shared with later loads of the same file;
+/// see RDGLoadOptions::share_loaded_files
+struct SharedTopology {
+  std::weak_ptr<katana::GraphTopology> topology;
+  /// Held by the graphs using the topology, so that it expires, and the
+  /// topology is no longer shared, once the last of them changes it in place
+  std::weak_ptr<int> sharers;
+};
+
+std::mutex shared_topologies_mutex;
+std::unordered_map<katana::Uri, SharedTopology, katana::Uri::Hash>
+    shared_topologies;
+
+/// The topology loaded from location that graphs still use as it is in
+/// storage, and what they share it with, if any
+std::pair<std::shared_ptr<katana::GraphTopology>, std::shared_ptr<int>>
+FindSharedTopology(const katana::Uri& location) {
+  std::lock_guard<std::mutex> lock(shared_topologies_mutex);
+  auto it = shared_topologies.find(location);
+  if (it == shared_topologies.end()) {
+    return {};
+  }
+  std::shared_ptr<katana::GraphTopology> topology = it->second.topology.lock();
+  std::shared_ptr<int> sharers = it->second.sharers.lock();
+  if (!topology || !sharers) {
+    shared_topologies.erase(it);
+    return {};
+  }
+  return {std::move(topology), std::move(sharers)};
+}
+
+void
+ShareTopology(
+    const katana::Uri& location,
+    const std::shared_ptr<katana::GraphTopology>& topology,
+    const std::shared_ptr<int>& sharers) {
+  std::lock_guard<std::mutex> lock(shared_topologies_mutex);
+  // drop what no graph uses anymore, so that this does not grow with every
+  // file ever loaded
+  for (auto it = shared_topologies.begin(); it != shared_topologies.end();) {
+    bool expired =
+        it->second.topology.expired() || it->second.sharers.expired();
+    it = expired ? shared_topologies.erase(it) : std::next(it);
+  }
+  shared_topologies[location] = SharedTopology{topology, sharers};
+}
+
+/// The node or edge properties of now that differ from those of before
+katana::PropertyGraphDiff::Properties
+DiffProperties(const katana::RDG& now, const katana::RDG& before, bool node) {
+  auto names = [node](const katana::RDG& rdg) {
+    return node ? rdg.ListFullNodeProperties() : rdg.ListFullEdgeProperties();
+  };
+  auto location = [node](const katana::RDG& rdg, const std::string& name) {
+    return node ? rdg.GetNodePropertyStorageLocation(name)
+                : rdg.GetEdgePropertyStorageLocation(name);
+  };
+  auto loaded = [node](const katana::RDG& rdg, const std::string& name) {
+    return (node ? rdg.node_properties() : rdg.edge_properties())
+        ->GetColumnByName(name);
+  };
+
+  std::vector<std::string> now_names = names(now);
+  std::vector<std::string> before_names = names(before);
+  auto has = [](const std::vector<std::string>& list,
+                const std::string& name) {
+    return std::find(list.begin(), list.end(), name) != list.end();
+  };
+
+  katana::PropertyGraphDiff::Properties diff;
+  for (const std::string& name : now_names) {
+    if (!has(before_names, name)) {
+      diff.added.emplace_back(name);
+      continue;
+    }
+    auto now_location = location(now, name);
+    auto before_location = location(before, name);
+    if (now_location && before_location &&
+        now_location.value() == before_location.value()) {
+      continue;
+    }
+    std::shared_ptr<arrow::ChunkedArray> now_values = loaded(now, name);
+    std::shared_ptr<arrow::ChunkedArray> before_values = loaded(before, name);
+    if (now_values && before_values &&
+        (now_values == before_values || now_values->Equals(*before_values))) {
+      continue;
+    }
+    diff.changed.emplace_back(name);
+  }
+  for (const std::string& name : before_names) {
+    if (!has(now_names, name)) {
+      diff.removed.emplace_back(name);
+    }
+  }
+  return diff;
+}
+
 }  // namespace
 
 katana::PropertyGraph::~PropertyGraph() = default;
@@ -157,21 +862,82 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<katana::RDGFile> rdg_file, katana::RDG&& rdg,
     katana::TxnContext* txn_ctx) {
-  // find & map the default csr topology
+  // another graph may have the topology file in memory already
   katana::RDGTopology shadow_csr = katana::RDGTopology::MakeShadowCSR();
-  katana::RDGTopology* csr = KATANA_CHECKED_CONTEXT(
-      rdg.GetTopology(shadow_csr),
-      "unable to find csr topology, must have csr topology to Make a "
-      "PropertyGraph");
+  std::optional<katana::Uri> topo_location;
+  std::shared_ptr<katana::GraphTopology> shared_topo;
+  std::shared_ptr<int> sharers;
+  if (rdg.share_loaded_files()) {
+    auto location = rdg.GetTopologyStorageLocation(shadow_csr);
+    if (location) {
+      topo_location = std::move(location.value());
+      std::tie(shared_topo, sharers) = FindSharedTopology(*topo_location);
+    }
+  }
 
-  KATANA_LOG_DEBUG_ASSERT(CheckTopology(
-      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges()));
-  katana::GraphTopology topo = katana::GraphTopology(
-      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges());
+  katana::GraphTopology topo;
+  if (shared_topo) {
+    // Only to make the graph with: it then uses the shared topology itself,
+    // as a copy does
+    topo = katana::GraphTopology::MakeInPlace(
+        shared_topo->AdjData(), shared_topo->NumNodes(),
+        shared_topo->DestData(), shared_topo->NumEdges(), shared_topo);
+  } else {
+    // find & map the default csr topology
+    katana::RDGTopology* csr = KATANA_CHECKED_CONTEXT(
+        rdg.GetTopology(shadow_csr),
+        "unable to find csr topology, must have csr topology to Make a "
+        "PropertyGraph");
 
-  // The GraphTopology constructor copies all of the required topology data.
-  // Clean up the RDGTopologies memory
-  KATANA_CHECKED(csr->unbind_file_storage());
+    if (!rdg.trusted_load()) {
+      KATANA_CHECKED_CONTEXT(
+          ValidateTopology(
+              csr->adj_indices(), csr->num_nodes(), csr->dests(),
+              csr->num_edges()),
+          "invalid csr topology");
+    } else if (
+        csr->num_nodes() != 0 &&
+        csr->adj_indices()[csr->num_nodes() - 1] != csr->num_edges()) {
+      return KATANA_ERROR(
+          ErrorCode::AssertionFailed,
+          "the adjacency indices of the csr topology do not end at the {} "
+          "edges",
+          csr->num_edges());
+    }
+    if (csr->file_storage().mapped_in_place()) {
+      // Hand the mapping over to the topology, which uses it as is, so that
+      // the RDGTopology is left unbound as it would be after copying
+      auto mapping =
+          std::make_shared<katana::FileView>(std::move(csr->file_storage()));
+      topo = katana::GraphTopology::MakeInPlace(
+          csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges(),
+          std::move(mapping));
+    } else {
+      // The GraphTopology constructor copies all of the required topology
+      // data, which the memory supervisor accounts for as long as the copy
+      // lives
+      katana::AllocationAccount account(
+          "default topology", katana::MemoryKind::kTopology);
+      topo = katana::GraphTopology(
+          csr->adj_indices(), csr->num_nodes(), csr->dests(),
+          csr->num_edges());
+    }
+
+    // Clean up the RDGTopologies memory
+    KATANA_CHECKED(csr->unbind_file_storage());
+  }
+
+  auto share_topology = [&](PropertyGraph* pg) {
+    if (shared_topo) {
+      pg->pg_view_cache_.original_topo_ = shared_topo;
+      pg->topology_sharers_ = sharers;
+    } else if (topo_location) {
+      pg->topology_sharers_ = std::make_shared<int>(0);
+      ShareTopology(
+          *topo_location, pg->pg_view_cache_.GetDefaultTopology(),
+          pg->topology_sharers_);
+    }
+  };
 
   if (rdg.IsEntityTypeIDsOutsideProperties()) {
     KATANA_LOG_DEBUG("loading EntityType data from outside properties");
@@ -192,10 +958,26 @@ katana::PropertyGraph::Make(
     EntityTypeManager edge_type_manager =
         KATANA_CHECKED(rdg.edge_entity_type_manager());
 
-    return std::make_unique<PropertyGraph>(
+    if (!rdg.trusted_load()) {
+      KATANA_CHECKED(
+          ValidateEntityTypeIDs(node_type_ids, node_type_manager, "node"));
+      KATANA_CHECKED(
+          ValidateEntityTypeIDs(edge_type_ids, edge_type_manager, "edge"));
+    }
+
+    auto pg = std::make_unique<PropertyGraph>(
         std::move(rdg_file), std::move(rdg), std::move(topo),
         std::move(node_type_ids), std::move(edge_type_ids),
         std::move(node_type_manager), std::move(edge_type_manager));
+    share_topology(pg.get());
+
+    pg->stored_topology_version_ = pg->topology_version();
+    pg->stored_node_entity_type_ids_fingerprint_ =
+        FingerprintEntityTypeIDsArray(*pg->node_entity_type_ids_);
+    pg->stored_edge_entity_type_ids_fingerprint_ =
+        FingerprintEntityTypeIDsArray(*pg->edge_entity_type_ids_);
+
+    return MakeResult(std::move(pg));
   } else {
     // we must construct id_arrays and managers from properties
 
@@ -204,8 +986,10 @@ katana::PropertyGraph::Make(
         MakeDefaultEntityTypeIDArray(topo.NumNodes()),
         MakeDefaultEntityTypeIDArray(topo.NumEdges()), EntityTypeManager{},
         EntityTypeManager{});
+    share_topology(pg.get());
 
     KATANA_CHECKED(pg->ConstructEntityTypeIDs(txn_ctx));
+    pg->stored_topology_version_ = pg->topology_version();
 
     return MakeResult(std::move(pg));
   }
@@ -227,7 +1011,12 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<RDGFile> rdg_file, katana::TxnContext* txn_ctx,
     const katana::RDGLoadOptions& opts) {
-  auto rdg = KATANA_CHECKED(RDG::Make(*rdg_file, opts));
+  // the csr topology is needed right away, so fetch it along with everything
+  // else; Make unbinds it once it is copied. When files are shared, Make
+  // only reads it if no other graph has it in memory.
+  katana::RDGLoadOptions load_opts = opts;
+  load_opts.prefetch_topology = !opts.share_loaded_files;
+  auto rdg = KATANA_CHECKED(RDG::Make(*rdg_file, load_opts));
   return katana::PropertyGraph::Make(
       std::move(rdg_file), std::move(rdg), txn_ctx);
 }
@@ -339,6 +1128,240 @@ katana::PropertyGraph::Make(
   return retval;
 }
 
+namespace {
+
+/// Calls fn(row, id) for every row of an integer column of type ArrowType,
+/// in parallel, over the values of the column in place
+template <typename ArrowType, typename Fn>
+void
+ForEachValue(const arrow::ChunkedArray& column, const Fn& fn) {
+  uint64_t offset = 0;
+  for (const auto& chunk : column.chunks()) {
+    const auto* values =
+        static_cast<const arrow::NumericArray<ArrowType>&>(*chunk)
+            .raw_values();
+    katana::do_all(
+        katana::iterate(int64_t{0}, chunk->length()),
+        [&](int64_t i) { fn(offset + i, static_cast<int64_t>(values[i])); },
+        katana::no_stats());
+    offset += chunk->length();
+  }
+}
+
+/// Reads the node ids of the column name of edges into ids
+katana::Result<void>
+ReadNodeIDs(
+    const arrow::Table& edges, const std::string& name,
+    katana::NUMAArray<int64_t>* ids) {
+  std::shared_ptr<arrow::ChunkedArray> column = edges.GetColumnByName(name);
+  if (!column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "the edge table has no column {}", name);
+  }
+  if (column->null_count() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the node ids in column {} may not be null", name);
+  }
+  ids->allocateInterleaved(edges.num_rows());
+  auto store = [ids](uint64_t row, int64_t id) { (*ids)[row] = id; };
+  switch (column->type()->id()) {
+  case arrow::Type::INT8:
+    ForEachValue<arrow::Int8Type>(*column, store);
+    break;
+  case arrow::Type::UINT8:
+    ForEachValue<arrow::UInt8Type>(*column, store);
+    break;
+  case arrow::Type::INT16:
+    ForEachValue<arrow::Int16Type>(*column, store);
+    break;
+  case arrow::Type::UINT16:
+    ForEachValue<arrow::UInt16Type>(*column, store);
+    break;
+  case arrow::Type::INT32:
+    ForEachValue<arrow::Int32Type>(*column, store);
+    break;
+  case arrow::Type::UINT32:
+    ForEachValue<arrow::UInt32Type>(*column, store);
+    break;
+  case arrow::Type::INT64:
+    ForEachValue<arrow::Int64Type>(*column, store);
+    break;
+  case arrow::Type::UINT64:
+    // ids past the int64 range become negative and are rejected
+    ForEachValue<arrow::UInt64Type>(*column, store);
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the node ids in column {} are {} rather than integers", name,
+        column->type()->ToString());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Numbers the nodes of the ids in src_ids and dst_ids in increasing order
+/// of their ids, replaces the ids by the numbers and returns the ids of the
+/// numbers
+katana::Result<std::shared_ptr<arrow::Array>>
+RenumberNodeIDs(
+    katana::NUMAArray<int64_t>* src_ids, katana::NUMAArray<int64_t>* dst_ids) {
+  uint64_t num_edges = src_ids->size();
+  katana::NUMAArray<int64_t> keys;
+  keys.allocateInterleaved(2 * num_edges);
+  katana::ParallelSTL::copy(src_ids->begin(), src_ids->end(), keys.begin());
+  katana::ParallelSTL::copy(
+      dst_ids->begin(), dst_ids->end(), keys.begin() + num_edges);
+  katana::ParallelSTL::sort(keys.begin(), keys.end());
+  uint64_t num_nodes = std::unique(keys.begin(), keys.end()) - keys.begin();
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t row) {
+        auto number = [&](int64_t id) {
+          return std::lower_bound(keys.begin(), keys.begin() + num_nodes, id) -
+                 keys.begin();
+        };
+        (*src_ids)[row] = number((*src_ids)[row]);
+        (*dst_ids)[row] = number((*dst_ids)[row]);
+      },
+      katana::no_stats());
+
+  std::shared_ptr<arrow::Buffer> buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(num_nodes * sizeof(int64_t)));
+  std::memcpy(buffer->mutable_data(), keys.data(), buffer->size());
+  return std::make_shared<arrow::Int64Array>(num_nodes, std::move(buffer));
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeFromEdgeTable(
+    const katana::Uri& rdg_dir, const std::shared_ptr<arrow::Table>& edges,
+    katana::TxnContext* txn_ctx, const EdgeTableOptions& opts) {
+  if (opts.src_column == opts.dst_column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the source and destination columns are both {}", opts.src_column);
+  }
+  uint64_t num_edges = edges->num_rows();
+  katana::NUMAArray<int64_t> src_ids;
+  katana::NUMAArray<int64_t> dst_ids;
+  KATANA_CHECKED(ReadNodeIDs(*edges, opts.src_column, &src_ids));
+  KATANA_CHECKED(ReadNodeIDs(*edges, opts.dst_column, &dst_ids));
+
+  uint64_t num_nodes = 0;
+  std::shared_ptr<arrow::Array> node_ids;
+  if (opts.node_id_property.empty()) {
+    katana::GReduceMin<int64_t> min_id;
+    katana::GReduceMax<int64_t> max_id;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t row) {
+          min_id.update(std::min(src_ids[row], dst_ids[row]));
+          max_id.update(std::max(src_ids[row], dst_ids[row]));
+        },
+        katana::no_stats());
+    if (num_edges != 0 && min_id.reduce() < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node id {} is negative; use node_id_property for arbitrary ids",
+          min_id.reduce());
+    }
+    uint64_t end_id = num_edges == 0 ? 0 : max_id.reduce() + 1;
+    num_nodes = opts.num_nodes == 0 ? end_id : opts.num_nodes;
+    if (end_id > num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node id {} is not in a graph of {} nodes", end_id - 1, num_nodes);
+    }
+  } else {
+    node_ids = KATANA_CHECKED(RenumberNodeIDs(&src_ids, &dst_ids));
+    num_nodes = node_ids->length();
+  }
+  if (num_nodes > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} nodes do not fit in 32 bit node ids", num_nodes);
+  }
+
+  // counting sort of the rows by source node
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(adj_indices.begin(), adj_indices.end(), Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t row) {
+        __sync_add_and_fetch(&adj_indices[src_ids[row]], 1);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  GraphTopology::AdjIndexVec next_edge;
+  next_edge.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { next_edge[n] = n == 0 ? 0 : adj_indices[n - 1]; },
+      katana::no_stats());
+  katana::NUMAArray<uint64_t> rows;
+  rows.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t row) {
+        rows[__sync_fetch_and_add(&next_edge[src_ids[row]], 1)] = row;
+      },
+      katana::no_stats());
+
+  // the scatter above is in the order of the threads; sorting the rows of
+  // each node keeps its edges in table order
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  katana::GReduceLogicalOr moved;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n == 0 ? 0 : adj_indices[n - 1];
+        uint64_t end = adj_indices[n];
+        std::sort(rows.begin() + begin, rows.begin() + end);
+        for (uint64_t e = begin; e < end; ++e) {
+          dests[e] = dst_ids[rows[e]];
+          if (rows[e] != e) {
+            moved.update(true);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto pg = KATANA_CHECKED(
+      Make(rdg_dir, GraphTopology(std::move(adj_indices), std::move(dests))));
+
+  std::shared_ptr<arrow::Table> props = edges;
+  for (const std::string& name : {opts.src_column, opts.dst_column}) {
+    int index = props->schema()->GetFieldIndex(name);
+    props = KATANA_CHECKED(props->RemoveColumn(index));
+  }
+  if (props->num_columns() != 0) {
+    if (moved.reduce()) {
+      auto indices = std::make_shared<arrow::UInt64Array>(
+          num_edges, arrow::Buffer::Wrap(rows.data(), rows.size()));
+      arrow::Datum taken =
+          KATANA_CHECKED(arrow::compute::Take(props, indices));
+      props = taken.table();
+    }
+    KATANA_CHECKED_CONTEXT(
+        pg->AddEdgeProperties(props, txn_ctx), "adding edge properties");
+  }
+  if (node_ids) {
+    auto node_props = arrow::Table::Make(
+        arrow::schema({arrow::field(opts.node_id_property, arrow::int64())}),
+        {node_ids});
+    KATANA_CHECKED_CONTEXT(
+        pg->AddNodeProperties(node_props, txn_ctx), "adding node ids");
+  }
+  return katana::MakeResult(std::move(pg));
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Copy(katana::TxnContext* txn_ctx) const {
   return Copy(
@@ -350,62 +1373,41 @@ std::unique_ptr<katana::PropertyGraph>
 katana::PropertyGraph::MakeProjectedGraph(
     const PropertyGraph& pg, const std::vector<std::string>& node_types,
     const std::vector<std::string>& edge_types) {
+  if (pg.topology().empty()) {
+    return std::make_unique<PropertyGraph>();
+  }
+  return MakeProjectedGraph(
+      LazyProjectedGraph::Make(pg, node_types, edge_types));
+}
+
+std::unique_ptr<katana::PropertyGraph>
+katana::PropertyGraph::MakeProjectedGraph(
+    const LazyProjectedGraph& projection) {
+  const PropertyGraph& pg = projection.parent();
   const auto& topology = pg.topology();
   if (topology.empty()) {
     return std::make_unique<PropertyGraph>();
   }
 
-  // calculate number of new nodes
-  uint32_t num_new_nodes = 0;
-  uint32_t num_new_edges = 0;
+  const katana::DynamicBitset& bitset_nodes = projection.node_mask();
+  const katana::DynamicBitset& bitset_edges = projection.edge_mask();
+  uint32_t num_new_nodes = projection.NumNodes();
+  uint32_t num_new_edges = projection.NumEdges();
 
-  katana::DynamicBitset bitset_nodes;
-  bitset_nodes.resize(topology.NumNodes());
+  if (num_new_nodes == 0) {
+    // no nodes selected;
+    // return empty graph
+    return MakeEmptyProjectedGraph(pg, bitset_nodes);
+  }
 
   NUMAArray<Node> original_to_projected_nodes_mapping;
   original_to_projected_nodes_mapping.allocateInterleaved(topology.NumNodes());
 
-  if (node_types.empty()) {
-    num_new_nodes = topology.NumNodes();
-    // set all nodes
-    katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
-      bitset_nodes.set(src);
-      original_to_projected_nodes_mapping[src] = 1;
-    });
-  } else {
-    katana::ParallelSTL::fill(
-        original_to_projected_nodes_mapping.begin(),
-        original_to_projected_nodes_mapping.end(), Node{0});
-
-    std::set<katana::EntityTypeID> node_entity_type_ids;
-
-    for (auto node_type : node_types) {
-      auto entity_type_id = pg.GetNodeEntityTypeID(node_type);
-      node_entity_type_ids.insert(entity_type_id);
-    }
-
-    katana::GAccumulator<uint32_t> accum_num_new_nodes;
-
-    katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
-      for (auto type : node_entity_type_ids) {
-        if (pg.DoesNodeHaveType(src, type)) {
-          accum_num_new_nodes += 1;
-          bitset_nodes.set(src);
-          // this sets the correspondign entry in the array to 1
-          // will perform a prefix sum on this array later on
-          original_to_projected_nodes_mapping[src] = 1;
-          return;
-        }
-      }
-    });
-    num_new_nodes = accum_num_new_nodes.reduce();
-
-    if (num_new_nodes == 0) {
-      // no nodes selected;
-      // return empty graph
-      return MakeEmptyProjectedGraph(pg, bitset_nodes);
-    }
-  }
+  // this sets the entries of the selected nodes to 1 and the others to 0;
+  // a prefix sum on this array gives the new ids
+  katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
+    original_to_projected_nodes_mapping[src] = bitset_nodes.test(src) ? 1 : 0;
+  });
 
   // fill old to new nodes mapping
   katana::ParallelSTL::partial_sum(
@@ -431,76 +1433,22 @@ katana::PropertyGraph::MakeProjectedGraph(
     }
   });
 
-  FillBitMask(topology.NumNodes(), bitset_nodes, &node_bitmask);
-
-  // calculate number of new edges
-  katana::DynamicBitset bitset_edges;
-  bitset_edges.resize(topology.NumEdges());
-
-  NUMAArray<Edge> out_indices;
-  out_indices.allocateInterleaved(num_new_nodes);
-
-  // initializes the edge-index array to all zeros
-  katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
-
-  if (edge_types.empty()) {
-    katana::GAccumulator<uint32_t> accum_num_new_edges;
-    // set all edges incident to projected nodes
-    katana::do_all(
-        katana::iterate(Node{0}, Node{num_new_nodes}),
-        [&](auto src) {
-          auto old_src = projected_to_original_nodes_mapping[src];
-          for (Edge e : topology.OutEdges(old_src)) {
-            auto dest = topology.OutEdgeDst(e);
-            if (bitset_nodes.test(dest)) {
-              bitset_edges.set(e);
-              out_indices[src] += 1;
-              accum_num_new_edges += 1;
-            }
-          }
-        },
-        katana::steal());
-
-    num_new_edges = accum_num_new_edges.reduce();
-  } else {
-    std::set<katana::EntityTypeID> edge_entity_type_ids;
-
-    for (auto edge_type : edge_types) {
-      auto entity_type_id = pg.GetEdgeEntityTypeID(edge_type);
-      edge_entity_type_ids.insert(entity_type_id);
-    }
-
-    katana::GAccumulator<uint32_t> accum_num_new_edges;
-
-    katana::do_all(
-        katana::iterate(Node{0}, Node{num_new_nodes}),
-        [&](auto src) {
-          auto old_src = projected_to_original_nodes_mapping[src];
-
-          for (Edge e : topology.OutEdges(old_src)) {
-            auto dest = topology.OutEdgeDst(e);
-            if (bitset_nodes.test(dest)) {
-              for (auto type : edge_entity_type_ids) {
-                if (pg.DoesEdgeHaveTypeFromTopoIndex(e, type)) {
-                  accum_num_new_edges += 1;
-                  bitset_edges.set(e);
-                  out_indices[src] += 1;
-                  break;
-                }
-              }
-            }
-          }
-        },
-        katana::steal());
-
-    num_new_edges = accum_num_new_edges.reduce();
+  FillBitMask(topology.NumNodes(), bitset_nodes, &node_bitmask);
 
-    if (num_new_edges == 0) {
-      // no edge selected
-      // return empty graph with only selected nodes
-      return MakeEmptyEdgeProjectedGraph(pg, num_new_nodes, bitset_nodes);
-    }
-  }
+  NUMAArray<Edge> out_indices;
+  out_indices.allocateInterleaved(num_new_nodes);
+
+  // count the selected edges of every projected node
+  katana::do_all(
+      katana::iterate(Node{0}, Node{num_new_nodes}),
+      [&](auto src) {
+        Edge num_edges = 0;
+        projection.ForEachOutEdge(
+            projected_to_original_nodes_mapping[src],
+            [&](Edge) { ++num_edges; });
+        out_indices[src] = num_edges;
+      },
+      katana::steal());
 
   // Prefix sum calculation of the edge index array
   katana::ParallelSTL::partial_sum(
@@ -574,13 +1522,138 @@ katana::PropertyGraph::Copy(
     const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties,
     katana::TxnContext* txn_ctx) const {
-  // TODO(gill): This should copy the RDG in memory without reloading from storage.
-  katana::RDGLoadOptions opts;
-  opts.partition_id_to_load = partition_id();
-  opts.node_properties = node_properties;
-  opts.edge_properties = edge_properties;
+  std::shared_ptr<arrow::Table> node_table =
+      SelectColumns(rdg_->node_properties(), node_properties);
+  std::shared_ptr<arrow::Table> edge_table =
+      SelectColumns(rdg_->edge_properties(), edge_properties);
+  if (is_transformed || !node_table || !edge_table) {
+    katana::RDGLoadOptions opts;
+    opts.partition_id_to_load = partition_id();
+    opts.node_properties = node_properties;
+    opts.edge_properties = edge_properties;
+
+    return Make(rdg_dir(), txn_ctx, opts);
+  }
+
+  auto copy = std::make_unique<PropertyGraph>();
+  copy->rdg_->set_rdg_dir(rdg_->rdg_dir());
+  copy->node_entity_type_manager_ = node_entity_type_manager_;
+  copy->edge_entity_type_manager_ = edge_entity_type_manager_;
+  copy->node_entity_type_ids_ = node_entity_type_ids_;
+  copy->node_entity_data_ = node_entity_data_;
+  copy->edge_entity_type_ids_ = edge_entity_type_ids_;
+  copy->edge_entity_data_ = edge_entity_data_;
+
+  if (!topology_sharers_) {
+    topology_sharers_ = std::make_shared<int>(0);
+  }
+  copy->topology_sharers_ = topology_sharers_;
+  copy->pg_view_cache_.original_topo_ = pg_view_cache_.GetDefaultTopology();
+
+  KATANA_CHECKED(copy->AddNodeProperties(node_table, txn_ctx));
+  KATANA_CHECKED(copy->AddEdgeProperties(edge_table, txn_ctx));
+  return copy;
+}
+
+void
+katana::PropertyGraph::DetachSharedTopology() noexcept {
+  // A topology in place over a read-only mapping cannot be changed either
+  bool shared = topology_sharers_ && topology_sharers_.use_count() > 1;
+  if (shared || topology().in_place()) {
+    // The cached topologies may be the shared one or built from it, so they
+    // are dropped along with it
+    GraphTopology topo = GraphTopology::Copy(topology());
+    pg_view_cache_.DropAllTopologies();
+    pg_view_cache_.original_topo_ =
+        std::make_shared<GraphTopology>(std::move(topo));
+  }
+  topology_sharers_.reset();
+}
+
+std::optional<katana::Uri>
+katana::PropertyGraph::StoredTopologyLocation() const {
+  if (is_transformed || stored_topology_version_ != topology_version()) {
+    return std::nullopt;
+  }
+  auto location =
+      rdg_->GetTopologyStorageLocation(katana::RDGTopology::MakeShadowCSR());
+  if (!location) {
+    return std::nullopt;
+  }
+  return location.value();
+}
+
+void
+katana::PropertyGraph::ShareLoadedFiles() const {
+  std::optional<katana::Uri> topo_location = StoredTopologyLocation();
+  std::shared_ptr<GraphTopology> topo = pg_view_cache_.GetDefaultTopology();
+  const GraphTopology& default_topo = *topo;
+  // views may replace the default topology with a sorted one, which is not
+  // what the file holds
+  if (topo_location && typeid(default_topo) == typeid(GraphTopology)) {
+    if (!topology_sharers_) {
+      topology_sharers_ = std::make_shared<int>(0);
+    }
+    ShareTopology(*topo_location, topo, topology_sharers_);
+  }
+
+  PropertyManager* pm = MemorySupervisor::Get().GetPropertyManager();
+  for (bool node : {true, false}) {
+    const std::shared_ptr<arrow::Table>& props =
+        node ? rdg_->node_properties() : rdg_->edge_properties();
+    for (int i = 0; i < props->num_columns(); ++i) {
+      const std::string& name = props->field(i)->name();
+      // properties changed since they were loaded have no location
+      auto location = node ? rdg_->GetNodePropertyStorageLocation(name)
+                           : rdg_->GetEdgePropertyStorageLocation(name);
+      if (location) {
+        pm->PropertyLoadedShared(
+            location.value(),
+            arrow::Table::Make(
+                arrow::schema({props->field(i)}), {props->column(i)}));
+      }
+    }
+  }
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::LoadVersion(
+    uint64_t version, katana::TxnContext* txn_ctx,
+    katana::RDGLoadOptions opts) const {
+  if (file_ == nullptr) {
+    return KATANA_ERROR(katana::ErrorCode::AssertionFailed, "no RDG handle");
+  }
+  katana::RDGManifest current =
+      KATANA_CHECKED(katana::RDGManifest::Make(*file_));
+  katana::RDGManifest manifest = KATANA_CHECKED_CONTEXT(
+      katana::RDGManifest::Make(
+          current.dir(), current.view_specifier(), version),
+      "version {} of {}", version, current.dir());
+  auto rdg_handle =
+      KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadOnly));
+  auto new_file = std::make_unique<katana::RDGFile>(rdg_handle);
+
+  ShareLoadedFiles();
+  if (!opts.partition_id_to_load) {
+    opts.partition_id_to_load = partition_id();
+  }
+  opts.share_loaded_files = true;
+  return Make(std::move(new_file), txn_ctx, opts);
+}
 
-  return Make(rdg_dir(), txn_ctx, opts);
+katana::Result<katana::PropertyGraphDiff>
+katana::PropertyGraph::Diff(const PropertyGraph& other) const {
+  PropertyGraphDiff diff;
+  if (&topology() != &other.topology()) {
+    std::optional<Uri> location = StoredTopologyLocation();
+    std::optional<Uri> other_location = other.StoredTopologyLocation();
+    if (!location || !other_location || *location != *other_location) {
+      diff.topology_changed = !topology().Equals(other.topology());
+    }
+  }
+  diff.node_properties = DiffProperties(*rdg_, *other.rdg_, true);
+  diff.edge_properties = DiffProperties(*rdg_, *other.rdg_, false);
+  return diff;
 }
 
 katana::Result<void>
@@ -647,6 +1720,13 @@ katana::PropertyGraph::Validate() {
         rdg_->edge_properties()->num_rows(), NumEdges());
   }
 
+  KATANA_CHECKED(ValidateTopology(
+      topology().AdjData(), NumNodes(), topology().DestData(), NumEdges()));
+  KATANA_CHECKED(ValidateEntityTypeIDs(
+      *node_entity_type_ids_, GetNodeTypeManager(), "node"));
+  KATANA_CHECKED(ValidateEntityTypeIDs(
+      *edge_entity_type_ids_, GetEdgeTypeManager(), "edge"));
+
   return katana::ResultSuccess();
 }
 
@@ -721,8 +1801,96 @@ katana::PropertyGraph::LoadTopology(const katana::RDGTopology& shadow) {
   return topo;
 }
 
+katana::Result<void>
+katana::PropertyGraph::ApplyEdgeChanges(const katana::EdgeChangeSet& changes) {
+  for (const auto& ins : changes.insertions) {
+    if (ins.prop_index >= edge_entity_type_ids_->size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "inserted edge refers to property index {}, but there are only {} "
+          "edge property rows",
+          ins.prop_index, edge_entity_type_ids_->size());
+    }
+  }
+
+  KATANA_CHECKED(pg_view_cache_.ApplyEdgeChanges(this, changes));
+
+  // transformed graphs share their RDG with the parent graph, and never load
+  // topologies from it
+  if (!is_transformed && !changes.empty()) {
+    rdg_->InvalidateAllTopologies();
+  }
+  return katana::ResultSuccess();
+}
+
+katana::GraphStatistics
+katana::PropertyGraph::GetGraphStatistics() const {
+  std::shared_ptr<GraphTopology> topo = pg_view_cache_.GetDefaultTopology();
+  if (!graph_statistics_ || graph_statistics_version_ != topology_version() ||
+      graph_statistics_topology_.lock() != topo) {
+    graph_statistics_ = ComputeGraphStatistics(*topo);
+    graph_statistics_topology_ = topo;
+    graph_statistics_version_ = topology_version();
+  }
+  return *graph_statistics_;
+}
+
+std::shared_ptr<katana::DeviceTopologyCache>
+katana::PropertyGraph::GetDeviceTopologyCache() const {
+  if (device_topology_cache_version_ != topology_version() ||
+      device_topology_cache_topology_.lock() !=
+          pg_view_cache_.GetDefaultTopology()) {
+    device_topology_cache_.reset();
+  }
+  return device_topology_cache_;
+}
+
+void
+katana::PropertyGraph::SetDeviceTopologyCache(
+    std::shared_ptr<DeviceTopologyCache> cache) const {
+  device_topology_cache_ = std::move(cache);
+  device_topology_cache_topology_ = pg_view_cache_.GetDefaultTopology();
+  device_topology_cache_version_ = topology_version();
+}
+
+std::shared_ptr<const katana::LazyProjectedGraph>
+katana::PropertyGraph::GetLazyProjectedGraph(
+    const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) const {
+  std::shared_ptr<GraphTopology> topo = pg_view_cache_.GetDefaultTopology();
+  // The cache moves along with the graph, while the projections it holds
+  // still point to where the graph was
+  bool moved = !lazy_projections_.empty() &&
+               &lazy_projections_.begin()->second->parent() != this;
+  if (moved || lazy_projections_version_ != topology_version() ||
+      lazy_projections_topology_.lock() != topo) {
+    lazy_projections_.clear();
+    lazy_projections_topology_ = topo;
+    lazy_projections_version_ = topology_version();
+  }
+
+  auto key = std::make_pair(node_types, edge_types);
+  std::sort(key.first.begin(), key.first.end());
+  std::sort(key.second.begin(), key.second.end());
+  auto it = lazy_projections_.find(key);
+  if (it == lazy_projections_.end()) {
+    it = lazy_projections_
+             .emplace(
+                 std::move(key),
+                 std::make_shared<const LazyProjectedGraph>(
+                     LazyProjectedGraph::Make(*this, node_types, edge_types)))
+             .first;
+  }
+  return it->second;
+}
+
 katana::Result<void>
 katana::PropertyGraph::DoWriteTopologies() {
+  // Topologies the RDG already has in storage are left alone as long as the
+  // graph has not changed since they were loaded or written
+  bool unchanged = !is_transformed && stored_topology_version_.has_value() &&
+                   *stored_topology_version_ == topology_version();
+
   // Since PGViewCache doesn't manage the main csr topology, see if we need to store it now
   katana::RDGTopology shadow = KATANA_CHECKED(katana::RDGTopology::Make(
       topology().AdjData(), topology().NumNodes(), topology().DestData(),
@@ -731,11 +1899,16 @@ katana::PropertyGraph::DoWriteTopologies() {
       katana::RDGTopology::EdgeSortKind::kAny,
       katana::RDGTopology::NodeSortKind::kAny));
 
-  rdg_->UpsertTopology(std::move(shadow));
+  if (!unchanged || !rdg_->HasTopology(shadow)) {
+    rdg_->UpsertTopology(std::move(shadow));
+  }
 
   std::vector<katana::RDGTopology> topologies =
       KATANA_CHECKED(pg_view_cache_.ToRDGTopology());
   for (size_t i = 0; i < topologies.size(); i++) {
+    if (unchanged && rdg_->HasTopology(topologies.at(i))) {
+      continue;
+    }
     rdg_->UpsertTopology(std::move(topologies.at(i)));
   }
   return katana::ResultSuccess();
@@ -752,21 +1925,43 @@ katana::PropertyGraph::DoWrite(
 
   KATANA_CHECKED(DoWriteTopologies());
 
-  //TODO(emcginnis): we don't actually have any lifetime tracking for the in memory
-  // entity_type_id arrays, which means we don't actually know when the array
-  // on disk is out of date and we should write. For now, just always write the file.
-  // This is correct, but wasteful.
-  std::unique_ptr<katana::FileFrame> node_entity_type_id_array_res =
-      KATANA_CHECKED(WriteEntityTypeIDsArray(*node_entity_type_ids_));
+  // The entity type id arrays can be modified through mutable accessors, so
+  // compare their contents with what was last loaded or written. A file
+  // frame is only needed if they changed, or if the file in storage is in an
+  // older format. Unchanged files are copied by the storage when writing
+  // somewhere else.
+  bool can_reuse = rdg_->IsHeaderlessEntityTypeIDArray();
+  uint64_t node_fingerprint =
+      FingerprintEntityTypeIDsArray(*node_entity_type_ids_);
+  uint64_t edge_fingerprint =
+      FingerprintEntityTypeIDsArray(*edge_entity_type_ids_);
+
+  std::unique_ptr<katana::FileFrame> node_entity_type_id_array_res;
+  if (!can_reuse ||
+      stored_node_entity_type_ids_fingerprint_ != node_fingerprint) {
+    node_entity_type_id_array_res =
+        KATANA_CHECKED(WriteEntityTypeIDsArray(*node_entity_type_ids_));
+  }
 
-  std::unique_ptr<katana::FileFrame> edge_entity_type_id_array_res =
-      KATANA_CHECKED(WriteEntityTypeIDsArray(*edge_entity_type_ids_));
+  std::unique_ptr<katana::FileFrame> edge_entity_type_id_array_res;
+  if (!can_reuse ||
+      stored_edge_entity_type_ids_fingerprint_ != edge_fingerprint) {
+    edge_entity_type_id_array_res =
+        KATANA_CHECKED(WriteEntityTypeIDsArray(*edge_entity_type_ids_));
+  }
 
-  return rdg_->Store(
+  KATANA_CHECKED(rdg_->Store(
       handle, command_line, versioning_action,
       std::move(node_entity_type_id_array_res),
       std::move(edge_entity_type_id_array_res), GetNodeTypeManager(),
-      GetEdgeTypeManager());
+      GetEdgeTypeManager()));
+
+  if (!is_transformed) {
+    stored_topology_version_ = topology_version();
+  }
+  stored_node_entity_type_ids_fingerprint_ = node_fingerprint;
+  stored_edge_entity_type_ids_fingerprint_ = edge_fingerprint;
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -814,6 +2009,24 @@ katana::PropertyGraph::Commit(const std::string& command_line) {
       *file_, command_line, katana::RDG::RDGVersioningPolicy::IncrementVersion);
 }
 
+katana::Result<void>
+katana::PropertyGraph::Commit(
+    const std::string& command_line, katana::TxnContext* txn_ctx) {
+  if (!txn_ctx->batching()) {
+    return Commit(command_line);
+  }
+  txn_ctx->DeferCommit(
+      this, rdg_->rdg_dir().string(), command_line,
+      [this](const std::vector<std::string>& command_lines) {
+        // the lineage of a group commit has every command that was batched
+        for (size_t i = 0; i + 1 < command_lines.size(); ++i) {
+          rdg_->AddLineage(command_lines[i]);
+        }
+        return Commit(command_lines.back());
+      });
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::PropertyGraph::WriteView(const std::string& command_line) {
   // WriteView occurs once, and only before any Commit/Write operation
@@ -823,7 +2036,7 @@ katana::PropertyGraph::WriteView(const std::string& command_line) {
 
 bool
 katana::PropertyGraph::Equals(const PropertyGraph* other) const {
-  if (!topology().Equals(other->topology())) {
+  if (HashTopology(topology()) != HashTopology(other->topology())) {
     return false;
   }
 
@@ -836,32 +2049,16 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
   }
 
   // The TypeIDs can change, but their string interpretation cannot
-  if (node_entity_type_ids_->size() != other->node_entity_type_ids_->size()) {
+  if (HashEntityTypeIDs(GetNodeTypeManager(), *node_entity_type_ids_) !=
+      HashEntityTypeIDs(
+          other->GetNodeTypeManager(), *other->node_entity_type_ids_)) {
     return false;
   }
-  for (size_t i = 0; i < node_entity_type_ids_->size(); ++i) {
-    auto tns =
-        GetNodeTypeManager().EntityTypeToTypeNameSet(node_entity_data_[i]);
-    auto otns = other->GetNodeTypeManager().EntityTypeToTypeNameSet(
-        other->node_entity_data_[i]);
-    if (tns != otns) {
-      return false;
-    }
-  }
-
-  // The TypeIDs can change, but their string interpretation cannot
-  if (edge_entity_type_ids_->size() != other->edge_entity_type_ids_->size()) {
+  if (HashEntityTypeIDs(GetEdgeTypeManager(), *edge_entity_type_ids_) !=
+      HashEntityTypeIDs(
+          other->GetEdgeTypeManager(), *other->edge_entity_type_ids_)) {
     return false;
   }
-  for (size_t i = 0; i < edge_entity_type_ids_->size(); ++i) {
-    auto tns =
-        GetEdgeTypeManager().EntityTypeToTypeNameSet(edge_entity_data_[i]);
-    auto otns = other->GetEdgeTypeManager().EntityTypeToTypeNameSet(
-        other->edge_entity_data_[i]);
-    if (tns != otns) {
-      return false;
-    }
-  }
 
   const auto& node_props = rdg_->node_properties();
   const auto& edge_props = rdg_->edge_properties();
@@ -874,14 +2071,12 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
     return false;
   }
   for (const auto& prop_name : node_props->ColumnNames()) {
-    if (!node_props->GetColumnByName(prop_name)->Equals(
-            other_node_props->GetColumnByName(prop_name))) {
+    if (!PropertiesEqual(rdg_.get(), other->rdg_.get(), prop_name, true)) {
       return false;
     }
   }
   for (const auto& prop_name : edge_props->ColumnNames()) {
-    if (!edge_props->GetColumnByName(prop_name)->Equals(
-            other_edge_props->GetColumnByName(prop_name))) {
+    if (!PropertiesEqual(rdg_.get(), other->rdg_.get(), prop_name, false)) {
       return false;
     }
   }
@@ -891,12 +2086,20 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
 std::string
 katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
   fmt::memory_buffer buf;
-  if (!topology().Equals(other->topology())) {
+  auto [adj_hash, dest_hash] = HashTopology(topology());
+  auto [other_adj_hash, other_dest_hash] = HashTopology(other->topology());
+  if (adj_hash != other_adj_hash || dest_hash != other_dest_hash) {
     fmt::format_to(
         std::back_inserter(buf),
         "Topologies differ nodes/edges {}/{} vs. {}/{}\n",
         topology().NumNodes(), topology().NumEdges(),
         other->topology().NumNodes(), other->topology().NumEdges());
+    fmt::format_to(
+        std::back_inserter(buf),
+        " chunks of {} differing: adj_indices {} dests {}\n",
+        ContentHash::kDefaultChunkSize,
+        fmt::join(adj_hash.DifferingChunks(other_adj_hash), ", "),
+        fmt::join(dest_hash.DifferingChunks(other_dest_hash), ", "));
   } else {
     fmt::format_to(std::back_inserter(buf), "Topologies match!\n");
   }
@@ -910,81 +2113,12 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
       std::back_inserter(buf),
       GetEdgeTypeManager().ReportDiff(other->GetEdgeTypeManager()));
 
-  // The TypeIDs can change, but their string interpretation cannot
-  bool match = true;
-  if (node_entity_type_ids_->size() != other->node_entity_type_ids_->size()) {
-    fmt::format_to(
-        std::back_inserter(buf),
-        "node_entity_type_ids differ. size {} vs. {}\n",
-        node_entity_type_ids_->size(), other->node_entity_type_ids_->size());
-    match = false;
-  } else {
-    for (size_t i = 0; i < node_entity_type_ids_->size(); ++i) {
-      auto tns_res =
-          GetNodeTypeManager().EntityTypeToTypeNameSet(node_entity_data_[i]);
-      auto otns_res = other->GetNodeTypeManager().EntityTypeToTypeNameSet(
-          other->node_entity_data_[i]);
-      if (!tns_res || !otns_res) {
-        fmt::format_to(
-            std::back_inserter(buf),
-            "node error types index {} entity lhs {} entity rhs_{}\n", i,
-            node_entity_data_[i], other->node_entity_data_[i]);
-        match = false;
-        break;
-      }
-      auto tns = tns_res.value();
-      auto otns = otns_res.value();
-      if (tns != otns) {
-        fmt::format_to(
-            std::back_inserter(buf),
-            "node_entity_type_ids differ. {:4} {} {} {} {}\n", i,
-            node_entity_data_[i], fmt::join(tns, ", "),
-            other->node_entity_data_[i], fmt::join(otns, ", "));
-        match = false;
-      }
-    }
-  }
-  if (match) {
-    fmt::format_to(std::back_inserter(buf), "node_entity_type_ids Match!\n");
-  }
-
-  // The TypeIDs can change, but their string interpretation cannot
-  match = true;
-  if (edge_entity_type_ids_->size() != other->edge_entity_type_ids_->size()) {
-    fmt::format_to(
-        std::back_inserter(buf),
-        "edge_entity_type_ids differ. size {} vs. {}\n",
-        edge_entity_type_ids_->size(), other->edge_entity_type_ids_->size());
-    match = false;
-  } else {
-    for (size_t i = 0; i < edge_entity_type_ids_->size(); ++i) {
-      auto tns_res =
-          GetEdgeTypeManager().EntityTypeToTypeNameSet(edge_entity_data_[i]);
-      auto otns_res = other->GetEdgeTypeManager().EntityTypeToTypeNameSet(
-          other->edge_entity_data_[i]);
-      if (!tns_res || !otns_res) {
-        fmt::format_to(
-            std::back_inserter(buf),
-            "edge error types index {} entity lhs {} entity rhs_{}\n", i,
-            edge_entity_data_[i], other->edge_entity_data_[i]);
-        match = false;
-        break;
-      }
-      auto tns = tns_res.value();
-      auto otns = otns_res.value();
-      if (tns != otns) {
-        fmt::format_to(
-            std::back_inserter(buf),
-            "edge_entity_type_ids differ. {:4} {} {} {} {}\n", i,
-            edge_entity_data_[i], fmt::join(tns, ", "),
-            other->edge_entity_data_[i], fmt::join(otns, ", "));
-        match = false;
-      }
-    }
-  }
-  if (match) {
-    fmt::format_to(std::back_inserter(buf), "edge_entity_type_ids Match!\n");
-  }
+  ReportEntityTypeIDsDiff(
+      buf, "node", GetNodeTypeManager(), *node_entity_type_ids_,
+      other->GetNodeTypeManager(), *other->node_entity_type_ids_);
+  ReportEntityTypeIDsDiff(
+      buf, "edge", GetEdgeTypeManager(), *edge_entity_type_ids_,
+      other->GetEdgeTypeManager(), *other->edge_entity_type_ids_);
 
   const auto& node_props = rdg_->node_properties();
   const auto& edge_props = rdg_->edge_properties();
@@ -1001,53 +2135,10 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
         edge_props->num_columns(), other_edge_props->num_columns());
   }
   for (const auto& prop_name : node_props->ColumnNames()) {
-    auto other_col = other_node_props->GetColumnByName(prop_name);
-    auto my_col = node_props->GetColumnByName(prop_name);
-    if (other_col == nullptr) {
-      fmt::format_to(
-          std::back_inserter(buf), "Only first has node property {}\n",
-          prop_name);
-    } else if (!my_col->Equals(other_col)) {
-      fmt::format_to(
-          std::back_inserter(buf), "Node property {:15} {:12} differs\n",
-          prop_name, fmt::format("({})", my_col->type()->name()));
-      if (my_col->length() != other_col->length()) {
-        fmt::format_to(
-            std::back_inserter(buf), " size {}/{}\n", my_col->length(),
-            other_col->length());
-      } else {
-        DiffFormatTo(buf, my_col, other_col);
-      }
-    } else {
-      fmt::format_to(
-          std::back_inserter(buf), "Node property {:15} {:12} matches!\n",
-          prop_name, fmt::format("({})", my_col->type()->name()));
-    }
+    ReportPropertyDiff(buf, rdg_.get(), other->rdg_.get(), prop_name, true);
   }
   for (const auto& prop_name : edge_props->ColumnNames()) {
-    auto other_col = other_edge_props->GetColumnByName(prop_name);
-    auto my_col = edge_props->GetColumnByName(prop_name);
-    if (other_col == nullptr) {
-      fmt::format_to(
-          std::back_inserter(buf), "Only first has edge property {}\n",
-          prop_name);
-    } else if (!edge_props->GetColumnByName(prop_name)->Equals(
-                   other_edge_props->GetColumnByName(prop_name))) {
-      fmt::format_to(
-          std::back_inserter(buf), "Edge property {:15} {:12} differs\n",
-          prop_name, fmt::format("({})", my_col->type()->name()));
-      if (my_col->length() != other_col->length()) {
-        fmt::format_to(
-            std::back_inserter(buf), " size {}/{}\n", my_col->length(),
-            other_col->length());
-      } else {
-        DiffFormatTo(buf, my_col, other_col);
-      }
-    } else {
-      fmt::format_to(
-          std::back_inserter(buf), "Edge property {:15} {:12} matches!\n",
-          prop_name, fmt::format("({})", my_col->type()->name()));
-    }
+    ReportPropertyDiff(buf, rdg_.get(), other->rdg_.get(), prop_name, false);
   }
   return std::string(buf.begin(), buf.end());
 }
@@ -1084,6 +2175,21 @@ katana::PropertyGraph::GetEdgePropertyStorageLocation(
   return rdg_->GetEdgePropertyStorageLocation(name);
 }
 
+void
+katana::PropertyGraph::SetPartition(
+    const PartitionMetadata& metadata,
+    std::vector<std::shared_ptr<arrow::ChunkedArray>>&& master_nodes,
+    std::vector<std::shared_ptr<arrow::ChunkedArray>>&& mirror_nodes,
+    std::shared_ptr<arrow::ChunkedArray>&& local_to_global_id,
+    std::shared_ptr<arrow::ChunkedArray>&& host_to_owned_global_node_ids) {
+  rdg_->set_part_metadata(metadata);
+  rdg_->set_master_nodes(std::move(master_nodes));
+  rdg_->set_mirror_nodes(std::move(mirror_nodes));
+  rdg_->set_local_to_global_id(std::move(local_to_global_id));
+  rdg_->set_host_to_owned_global_node_ids(
+      std::move(host_to_owned_global_node_ids));
+}
+
 katana::Result<void>
 katana::PropertyGraph::Write(
     const std::string& rdg_name, const std::string& command_line) {
@@ -1093,6 +2199,14 @@ katana::PropertyGraph::Write(
   return WriteGraph(rdg_name, command_line);
 }
 
+katana::Result<void>
+katana::PropertyGraph::Write(
+    const std::string& rdg_name, const std::string& command_line,
+    ParquetWriter::WriteOpts opts) {
+  set_write_opts(std::move(opts));
+  return Write(rdg_name, command_line);
+}
+
 // We do this to avoid a virtual call, since this method is often on a hot path.
 katana::GraphTopology::PropertyIndex
 katana::PropertyGraph::GetEdgePropertyIndexFromOutEdge(
@@ -1106,6 +2220,56 @@ katana::PropertyGraph::GetNodePropertyIndex(const Node& nid) const noexcept {
   return topology().GetNodePropertyIndex(nid);
 }
 
+katana::DynamicBitset
+katana::PropertyGraph::NodesWithType(
+    const std::vector<EntityTypeID>& node_entity_type_ids) const {
+  return EntitiesWithType(
+      GetNodeTypeManager(), node_entity_type_ids, topology().NumNodes(),
+      [&](uint64_t n) { return GetTypeOfNode(n); });
+}
+
+katana::DynamicBitset
+katana::PropertyGraph::EdgesWithType(
+    const std::vector<EntityTypeID>& edge_entity_type_ids) const {
+  return EntitiesWithType(
+      GetEdgeTypeManager(), edge_entity_type_ids, topology().NumEdges(),
+      [&](uint64_t e) { return GetTypeOfEdgeFromTopoIndex(e); });
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::PropertyGraph::MakeNodePropertyTable(
+    const std::string& name,
+    const std::shared_ptr<arrow::Array>& by_node) const {
+  if (static_cast<uint64_t>(by_node->length()) != NumNodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} values found {} instead",
+        NumNodes(), by_node->length());
+  }
+  const GraphTopology& topo = topology();
+  std::shared_ptr<arrow::Array> rows = KATANA_CHECKED(GatherToPropertyRows(
+      by_node, NumOriginalNodes(),
+      [&](Node n) { return topo.GetNodePropertyIndex(n); }));
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, rows->type())}), {rows});
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::PropertyGraph::MakeEdgePropertyTable(
+    const std::string& name,
+    const std::shared_ptr<arrow::Array>& by_edge) const {
+  if (static_cast<uint64_t>(by_edge->length()) != NumEdges()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} values found {} instead",
+        NumEdges(), by_edge->length());
+  }
+  const GraphTopology& topo = topology();
+  std::shared_ptr<arrow::Array> rows = KATANA_CHECKED(GatherToPropertyRows(
+      by_edge, NumOriginalEdges(),
+      [&](Edge e) { return topo.GetEdgePropertyIndexFromOutEdge(e); }));
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, rows->type())}), {rows});
+}
+
 katana::Result<void>
 katana::PropertyGraph::AddNodeProperties(
     const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx) {
@@ -1133,7 +2297,10 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalNodes(), props->num_rows());
   }
-  return rdg_->UpsertNodeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->UpsertNodeProperties(props, txn_ctx));
+  return UpdateIndexes(
+      &node_indexes_, *props, NumNodes(),
+      [this](const std::string& name) { return GetNodeProperty(name); });
 }
 
 katana::Result<void>
@@ -1167,8 +2334,49 @@ katana::PropertyGraph::EnsureNodePropertyLoaded(const std::string& name) {
   return LoadNodeProperty(name);
 }
 
+katana::Result<void>
+katana::PropertyGraph::EnsureNodePropertiesLoaded(
+    const std::vector<std::string>& names) {
+  std::vector<std::string> absent;
+  for (const std::string& name : names) {
+    if (!HasNodeProperty(name) &&
+        std::find(absent.begin(), absent.end(), name) == absent.end()) {
+      absent.emplace_back(name);
+    }
+  }
+  if (absent.empty()) {
+    return katana::ResultSuccess();
+  }
+  return rdg_->LoadNodeProperties(absent);
+}
+
+katana::Result<void>
+katana::PropertyGraph::PinNodeProperty(const std::string& name) {
+  if (!HasNodeProperty(name)) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property {} is not loaded",
+        std::quoted(name));
+  }
+  ++pinned_node_properties_[name];
+  return katana::ResultSuccess();
+}
+
+void
+katana::PropertyGraph::UnpinNodeProperty(const std::string& name) {
+  auto it = pinned_node_properties_.find(name);
+  KATANA_LOG_DEBUG_ASSERT(it != pinned_node_properties_.end());
+  if (it != pinned_node_properties_.end() && --it->second == 0) {
+    pinned_node_properties_.erase(it);
+  }
+}
+
 katana::Result<void>
 katana::PropertyGraph::UnloadNodeProperty(const std::string& prop_name) {
+  if (IsNodePropertyPinned(prop_name)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node property {} is pinned",
+        std::quoted(prop_name));
+  }
   return rdg_->UnloadNodeProperty(prop_name);
 }
 
@@ -1199,7 +2407,10 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalEdges(), props->num_rows());
   }
-  return rdg_->UpsertEdgeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->UpsertEdgeProperties(props, txn_ctx));
+  return UpdateIndexes(
+      &edge_indexes_, *props, NumEdges(),
+      [this](const std::string& name) { return GetEdgeProperty(name); });
 }
 
 katana::Result<void>
@@ -1221,6 +2432,11 @@ katana::PropertyGraph::RemoveEdgeProperty(
 
 katana::Result<void>
 katana::PropertyGraph::UnloadEdgeProperty(const std::string& prop_name) {
+  if (IsEdgePropertyPinned(prop_name)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge property {} is pinned",
+        std::quoted(prop_name));
+  }
   return rdg_->UnloadEdgeProperty(prop_name);
 }
 
@@ -1239,6 +2455,42 @@ katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
   return LoadEdgeProperty(name);
 }
 
+katana::Result<void>
+katana::PropertyGraph::EnsureEdgePropertiesLoaded(
+    const std::vector<std::string>& names) {
+  std::vector<std::string> absent;
+  for (const std::string& name : names) {
+    if (!HasEdgeProperty(name) &&
+        std::find(absent.begin(), absent.end(), name) == absent.end()) {
+      absent.emplace_back(name);
+    }
+  }
+  if (absent.empty()) {
+    return katana::ResultSuccess();
+  }
+  return rdg_->LoadEdgeProperties(absent);
+}
+
+katana::Result<void>
+katana::PropertyGraph::PinEdgeProperty(const std::string& name) {
+  if (!HasEdgeProperty(name)) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property {} is not loaded",
+        std::quoted(name));
+  }
+  ++pinned_edge_properties_[name];
+  return katana::ResultSuccess();
+}
+
+void
+katana::PropertyGraph::UnpinEdgeProperty(const std::string& name) {
+  auto it = pinned_edge_properties_.find(name);
+  KATANA_LOG_DEBUG_ASSERT(it != pinned_edge_properties_.end());
+  if (it != pinned_edge_properties_.end() && --it->second == 0) {
+    pinned_edge_properties_.erase(it);
+  }
+}
+
 // Build an index over nodes.
 katana::Result<void>
 katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
@@ -1253,15 +2505,16 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
   // Get a view of the property.
   std::shared_ptr<arrow::ChunkedArray> chunked_property =
       KATANA_CHECKED(GetNodeProperty(property_name));
-  KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
-  std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(ContiguousArray(*chunked_property));
 
   // Create an index based on the type of the field.
   std::shared_ptr<katana::EntityIndex<GraphTopology::Node>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Node>(
           property_name, NumNodes(), property));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(
+      LoadOrBuildIndex(this, true, *property, NumNodes(), index.get()));
 
   node_indexes_.push_back(std::move(index));
 
@@ -1298,15 +2551,16 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
   // Get a view of the property.
   std::shared_ptr<arrow::ChunkedArray> chunked_property =
       KATANA_CHECKED(GetEdgeProperty(property_name));
-  KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
-  std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(ContiguousArray(*chunked_property));
 
   // Create an index based on the type of the field.
   std::unique_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Edge>(
           property_name, NumEdges(), property));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(
+      LoadOrBuildIndex(this, false, *property, NumEdges(), index.get()));
 
   edge_indexes_.push_back(std::move(index));
 
@@ -1324,10 +2578,81 @@ katana::PropertyGraph::DeleteEdgeIndex(const std::string& property_name) {
   return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
 }
 
+katana::Result<void>
+katana::PropertyGraph::MakeNodeHashIndex(const std::string& property_name) {
+  return MakeHashIndex(
+      &node_hash_indexes_, property_name,
+      KATANA_CHECKED(GetNodeProperty(property_name)), NumNodes());
+}
+
+katana::Result<void>
+katana::PropertyGraph::DeleteNodeHashIndex(const std::string& property_name) {
+  auto it = std::find_if(
+      node_hash_indexes_.begin(), node_hash_indexes_.end(),
+      [&](const auto& index) {
+        return index->property_name() == property_name;
+      });
+  if (it == node_hash_indexes_.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "node hash index not found");
+  }
+  node_hash_indexes_.erase(it);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::MakeEdgeHashIndex(const std::string& property_name) {
+  return MakeHashIndex(
+      &edge_hash_indexes_, property_name,
+      KATANA_CHECKED(GetEdgeProperty(property_name)), NumEdges());
+}
+
+katana::Result<void>
+katana::PropertyGraph::DeleteEdgeHashIndex(const std::string& property_name) {
+  auto it = std::find_if(
+      edge_hash_indexes_.begin(), edge_hash_indexes_.end(),
+      [&](const auto& index) {
+        return index->property_name() == property_name;
+      });
+  if (it == edge_hash_indexes_.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "edge hash index not found");
+  }
+  edge_hash_indexes_.erase(it);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::WriteNodeIndex(const std::string& property_name) {
+  auto index = KATANA_CHECKED(GetNodeIndex(property_name));
+  katana::Uri location = KATANA_CHECKED_CONTEXT(
+      GetNodePropertyStorageLocation(property_name),
+      "property of the index must be stored first");
+  auto property = KATANA_CHECKED(GetNodeProperty(property_name));
+  katana::EntityIndexPrimitive primitive =
+      StoredIndex(*index, location, *property, NumNodes());
+  return WriteEntityIndexPrimitive(
+      EntityIndexPrimitive::Name(true, property_name), primitive);
+}
+
+katana::Result<void>
+katana::PropertyGraph::WriteEdgeIndex(const std::string& property_name) {
+  auto index = KATANA_CHECKED(GetEdgeIndex(property_name));
+  katana::Uri location = KATANA_CHECKED_CONTEXT(
+      GetEdgePropertyStorageLocation(property_name),
+      "property of the index must be stored first");
+  auto property = KATANA_CHECKED(GetEdgeProperty(property_name));
+  katana::EntityIndexPrimitive primitive =
+      StoredIndex(*index, location, *property, NumEdges());
+  return WriteEntityIndexPrimitive(
+      EntityIndexPrimitive::Name(false, property_name), primitive);
+}
+
 katana::Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   // TODO(amber): This function will soon change so that it produces a new sorted
   // topology instead of modifying an existing one. The const_cast will go away
+  pg->MarkTopologyModified();
   const auto& topo = pg->topology();
 
   auto permutation_vec = std::make_unique<katana::NUMAArray<uint64_t>>();
@@ -1395,6 +2720,7 @@ katana::FindEdgeSortedByDest(
 // TODO(amber): this method should return a new sorted topology
 katana::Result<void>
 katana::SortNodesByDegree(katana::PropertyGraph* pg) {
+  pg->MarkTopologyModified();
   const auto& topo = pg->topology();
 
   uint64_t num_nodes = topo.NumNodes();
@@ -1659,3 +2985,115 @@ katana::PropertyGraph::GetEdgeIndex(const std::string& property_name) const {
   }
   return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
 }
+
+bool
+katana::PropertyGraph::HasNodeHashIndex(
+    const std::string& property_name) const {
+  return FindIndex(node_hash_indexes_, property_name) != nullptr;
+}
+
+katana::Result<
+    std::shared_ptr<katana::HashEntityIndex<katana::GraphTopology::Node>>>
+katana::PropertyGraph::GetNodeHashIndex(
+    const std::string& property_name) const {
+  if (auto index = FindIndex(node_hash_indexes_, property_name); index) {
+    return index;
+  }
+  return KATANA_ERROR(katana::ErrorCode::NotFound, "node hash index not found");
+}
+
+bool
+katana::PropertyGraph::HasEdgeHashIndex(
+    const std::string& property_name) const {
+  return FindIndex(edge_hash_indexes_, property_name) != nullptr;
+}
+
+katana::Result<
+    std::shared_ptr<katana::HashEntityIndex<katana::GraphTopology::Edge>>>
+katana::PropertyGraph::GetEdgeHashIndex(
+    const std::string& property_name) const {
+  if (auto index = FindIndex(edge_hash_indexes_, property_name); index) {
+    return index;
+  }
+  return KATANA_ERROR(katana::ErrorCode::NotFound, "edge hash index not found");
+}
+
+katana::Result<
+    std::shared_ptr<katana::CompositeEntityIndex<katana::GraphTopology::Node>>>
+katana::PropertyGraph::MakeNodeCompositeIndex(
+    const std::vector<std::string>& property_names,
+    const std::vector<EntityTypeID>& type_ids) {
+  return MakeCompositeIndex(
+      &node_composite_indexes_, property_names, type_ids,
+      [this](const std::string& name) { return GetNodeProperty(name); },
+      GetNodeTypeManager(), NumNodes(),
+      [this](uint64_t id) { return GetTypeOfNodeFromPropertyIndex(id); });
+}
+
+katana::Result<
+    std::shared_ptr<katana::CompositeEntityIndex<katana::GraphTopology::Node>>>
+katana::PropertyGraph::GetNodeCompositeIndex(
+    const std::vector<std::string>& property_names,
+    const std::vector<EntityTypeID>& type_ids) const {
+  auto it =
+      FindCompositeIndex(node_composite_indexes_, property_names, type_ids);
+  if (it == node_composite_indexes_.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "node composite index not found");
+  }
+  return *it;
+}
+
+katana::Result<void>
+katana::PropertyGraph::DeleteNodeCompositeIndex(
+    const std::vector<std::string>& property_names,
+    const std::vector<EntityTypeID>& type_ids) {
+  auto it =
+      FindCompositeIndex(node_composite_indexes_, property_names, type_ids);
+  if (it == node_composite_indexes_.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "node composite index not found");
+  }
+  node_composite_indexes_.erase(it);
+  return katana::ResultSuccess();
+}
+
+katana::Result<
+    std::shared_ptr<katana::CompositeEntityIndex<katana::GraphTopology::Edge>>>
+katana::PropertyGraph::MakeEdgeCompositeIndex(
+    const std::vector<std::string>& property_names,
+    const std::vector<EntityTypeID>& type_ids) {
+  return MakeCompositeIndex(
+      &edge_composite_indexes_, property_names, type_ids,
+      [this](const std::string& name) { return GetEdgeProperty(name); },
+      GetEdgeTypeManager(), NumEdges(),
+      [this](uint64_t id) { return GetTypeOfEdgeFromPropertyIndex(id); });
+}
+
+katana::Result<
+    std::shared_ptr<katana::CompositeEntityIndex<katana::GraphTopology::Edge>>>
+katana::PropertyGraph::GetEdgeCompositeIndex(
+    const std::vector<std::string>& property_names,
+    const std::vector<EntityTypeID>& type_ids) const {
+  auto it =
+      FindCompositeIndex(edge_composite_indexes_, property_names, type_ids);
+  if (it == edge_composite_indexes_.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "edge composite index not found");
+  }
+  return *it;
+}
+
+katana::Result<void>
+katana::PropertyGraph::DeleteEdgeCompositeIndex(
+    const std::vector<std::string>& property_names,
+    const std::vector<EntityTypeID>& type_ids) {
+  auto it =
+      FindCompositeIndex(edge_composite_indexes_, property_names, type_ids);
+  if (it == edge_composite_indexes_.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "edge composite index not found");
+  }
+  edge_composite_indexes_.erase(it);
+  return katana::ResultSuccess();
+}
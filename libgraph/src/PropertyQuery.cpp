@@ -0,0 +1,376 @@
+#include "katana/PropertyQuery.h"
+
+#include <iomanip>
+#include <limits>
+#include <optional>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+
+namespace {
+
+using katana::PropertyGraph;
+
+/// The node half of the queries
+struct Nodes {
+  static katana::Result<std::shared_ptr<arrow::ChunkedArray>> GetProperty(
+      const PropertyGraph& pg, const std::string& name) {
+    return pg.GetNodeProperty(name);
+  }
+
+  static const katana::EntityTypeManager& TypeManager(
+      const PropertyGraph& pg) {
+    return pg.GetNodeTypeManager();
+  }
+
+  static uint64_t Size(const PropertyGraph& pg) {
+    return pg.topology().NumNodes();
+  }
+
+  static uint64_t Row(const PropertyGraph& pg, uint64_t node) {
+    return pg.GetNodePropertyIndex(node);
+  }
+
+  static katana::DynamicBitset WithType(
+      const PropertyGraph& pg, katana::EntityTypeID type) {
+    return pg.NodesWithType(type);
+  }
+};
+
+/// The edge half of the queries; edges are by id in the topology
+struct Edges {
+  static katana::Result<std::shared_ptr<arrow::ChunkedArray>> GetProperty(
+      const PropertyGraph& pg, const std::string& name) {
+    return pg.GetEdgeProperty(name);
+  }
+
+  static const katana::EntityTypeManager& TypeManager(
+      const PropertyGraph& pg) {
+    return pg.GetEdgeTypeManager();
+  }
+
+  static uint64_t Size(const PropertyGraph& pg) {
+    return pg.topology().NumEdges();
+  }
+
+  static uint64_t Row(const PropertyGraph& pg, uint64_t edge) {
+    return pg.GetEdgePropertyIndexFromOutEdge(edge);
+  }
+
+  static katana::DynamicBitset WithType(
+      const PropertyGraph& pg, katana::EntityTypeID type) {
+    return pg.EdgesWithType(type);
+  }
+};
+
+/// The values of a property as one array, by property row
+template <typename Entities>
+katana::Result<std::shared_ptr<arrow::Array>>
+GetPropertyArray(const PropertyGraph& pg, const std::string& name) {
+  auto column = KATANA_CHECKED(Entities::GetProperty(pg, name));
+  return katana::ContiguousArray(*column);
+}
+
+const char*
+CompareFunction(katana::CompareOp op) {
+  switch (op) {
+  case katana::CompareOp::kEqual:
+    return "equal";
+  case katana::CompareOp::kNotEqual:
+    return "not_equal";
+  case katana::CompareOp::kLess:
+    return "less";
+  case katana::CompareOp::kLessEqual:
+    return "less_equal";
+  case katana::CompareOp::kGreater:
+    return "greater";
+  case katana::CompareOp::kGreaterEqual:
+    return "greater_equal";
+  }
+  KATANA_LOG_FATAL("unknown comparison: {}", static_cast<int>(op));
+}
+
+std::string
+AggregateName(const katana::Aggregate& aggregate) {
+  const char* op = "";
+  switch (aggregate.op) {
+  case katana::AggregateOp::kCount:
+    if (aggregate.property.empty()) {
+      return "count";
+    }
+    op = "count";
+    break;
+  case katana::AggregateOp::kSum:
+    op = "sum";
+    break;
+  case katana::AggregateOp::kMin:
+    op = "min";
+    break;
+  case katana::AggregateOp::kMax:
+    op = "max";
+    break;
+  case katana::AggregateOp::kMean:
+    op = "mean";
+    break;
+  }
+  return fmt::format("{}({})", op, aggregate.property);
+}
+
+/// Compare a property to the value of condition. Dictionary encoded strings
+/// are compared by comparing their dictionary, and taking the result for
+/// every row by its code.
+katana::Result<arrow::Datum>
+Compare(
+    const std::shared_ptr<arrow::Array>& column,
+    const katana::PropertyFilter::Condition& condition) {
+  const char* function = CompareFunction(condition.op);
+  if (column->type_id() != arrow::Type::DICTIONARY) {
+    return KATANA_CHECKED(
+        arrow::compute::CallFunction(function, {column, condition.value}));
+  }
+  const auto& encoded = static_cast<const arrow::DictionaryArray&>(*column);
+  arrow::Datum by_code = KATANA_CHECKED(arrow::compute::CallFunction(
+      function, {encoded.dictionary(), condition.value}));
+  return KATANA_CHECKED(arrow::compute::Take(by_code, encoded.indices()));
+}
+
+template <typename Entities>
+katana::Result<katana::DynamicBitset>
+Filter(const PropertyGraph& pg, const katana::PropertyFilter& filter) {
+  const auto& type = filter.type();
+  if (type && !Entities::TypeManager(pg).HasEntityType(*type)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no entity type {}", *type);
+  }
+
+  // Whether every property row satisfies all the conditions on properties;
+  // null where one of them is null
+  std::shared_ptr<arrow::BooleanArray> matches;
+  for (const auto& condition : filter.conditions()) {
+    auto column =
+        KATANA_CHECKED(GetPropertyArray<Entities>(pg, condition.property));
+    arrow::Datum compared = KATANA_CHECKED(Compare(column, condition));
+    if (matches) {
+      compared = KATANA_CHECKED(arrow::compute::And(matches, compared));
+    }
+    matches =
+        std::static_pointer_cast<arrow::BooleanArray>(compared.make_array());
+  }
+
+  std::optional<katana::DynamicBitset> with_type;
+  if (type) {
+    with_type = Entities::WithType(pg, *type);
+  }
+
+  uint64_t size = Entities::Size(pg);
+  katana::DynamicBitset mask;
+  mask.resize(size);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, size),
+      [&](uint64_t id) {
+        if (with_type && !with_type->test(id)) {
+          return;
+        }
+        if (matches) {
+          uint64_t row = Entities::Row(pg, id);
+          if (!matches->IsValid(row) || !matches->Value(row)) {
+            return;
+          }
+        }
+        mask.set(id);
+      },
+      katana::no_stats());
+  return mask;
+}
+
+struct Accumulator {
+  uint64_t count{0};
+  double sum{0};
+  double min{std::numeric_limits<double>::infinity()};
+  double max{-std::numeric_limits<double>::infinity()};
+
+  void Add(double value) {
+    ++count;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+
+  void Merge(const Accumulator& other) {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+};
+
+template <typename Entities>
+katana::Result<std::shared_ptr<arrow::Table>>
+AggregateEntities(
+    const PropertyGraph& pg, const katana::DynamicBitset& mask,
+    const std::string& group_by,
+    const std::vector<katana::Aggregate>& aggregates) {
+  if (mask.size() != Entities::Size(pg)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "mask of {} bits for {} entities",
+        mask.size(), Entities::Size(pg));
+  }
+
+  // Groups are numbered by the position of their value in keys, and found
+  // for every property row with a hash lookup by arrow
+  std::shared_ptr<arrow::Array> keys;
+  std::shared_ptr<arrow::Int32Array> group_of_row;
+  size_t num_groups = 1;
+  if (!group_by.empty()) {
+    auto column = KATANA_CHECKED(GetPropertyArray<Entities>(pg, group_by));
+    keys = KATANA_CHECKED(arrow::compute::Unique(column));
+    arrow::compute::SetLookupOptions options(keys, /*skip_nulls=*/false);
+    arrow::Datum groups =
+        KATANA_CHECKED(arrow::compute::IndexIn(column, options));
+    group_of_row =
+        std::static_pointer_cast<arrow::Int32Array>(groups.make_array());
+    num_groups = keys->length();
+  }
+
+  // Counts of properties only read validity, and the other aggregates read
+  // their properties as doubles
+  size_t num_aggregates = aggregates.size();
+  std::vector<std::shared_ptr<arrow::Array>> counted(num_aggregates);
+  std::vector<std::shared_ptr<arrow::DoubleArray>> values(num_aggregates);
+  for (size_t a = 0; a < num_aggregates; ++a) {
+    const katana::Aggregate& aggregate = aggregates[a];
+    if (aggregate.property.empty()) {
+      if (aggregate.op != katana::AggregateOp::kCount) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "only counts are of entities without a property");
+      }
+      continue;
+    }
+    auto column =
+        KATANA_CHECKED(GetPropertyArray<Entities>(pg, aggregate.property));
+    if (aggregate.op == katana::AggregateOp::kCount) {
+      counted[a] = std::move(column);
+      continue;
+    }
+    auto cast = KATANA_CHECKED_CONTEXT(
+        arrow::compute::Cast(*column, arrow::float64()), "property {}",
+        std::quoted(aggregate.property));
+    values[a] = std::static_pointer_cast<arrow::DoubleArray>(cast);
+  }
+
+  katana::PerThreadStorage<std::vector<Accumulator>> partials;
+  for (unsigned i = 0; i < partials.size(); ++i) {
+    partials.getRemote(i)->resize(num_groups * num_aggregates);
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, static_cast<uint64_t>(mask.size())),
+      [&](uint64_t id) {
+        if (!mask.test(id)) {
+          return;
+        }
+        uint64_t row = Entities::Row(pg, id);
+        size_t group = group_of_row ? group_of_row->Value(row) : 0;
+        Accumulator* accumulators =
+            &(*partials.getLocal())[group * num_aggregates];
+        for (size_t a = 0; a < num_aggregates; ++a) {
+          if (values[a]) {
+            if (values[a]->IsValid(row)) {
+              accumulators[a].Add(values[a]->Value(row));
+            }
+          } else if (!counted[a] || counted[a]->IsValid(row)) {
+            ++accumulators[a].count;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Accumulator> totals(num_groups * num_aggregates);
+  for (unsigned i = 0; i < partials.size(); ++i) {
+    const std::vector<Accumulator>& partial = *partials.getRemote(i);
+    for (size_t j = 0; j < totals.size(); ++j) {
+      totals[j].Merge(partial[j]);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  if (keys) {
+    fields.emplace_back(arrow::field(group_by, keys->type()));
+    columns.emplace_back(keys);
+  }
+  for (size_t a = 0; a < num_aggregates; ++a) {
+    katana::AggregateOp op = aggregates[a].op;
+    std::shared_ptr<arrow::Array> column;
+    if (op == katana::AggregateOp::kCount) {
+      arrow::UInt64Builder builder;
+      KATANA_CHECKED(builder.Reserve(num_groups));
+      for (size_t g = 0; g < num_groups; ++g) {
+        KATANA_CHECKED(builder.Append(totals[g * num_aggregates + a].count));
+      }
+      KATANA_CHECKED(builder.Finish(&column));
+    } else {
+      arrow::DoubleBuilder builder;
+      KATANA_CHECKED(builder.Reserve(num_groups));
+      for (size_t g = 0; g < num_groups; ++g) {
+        const Accumulator& total = totals[g * num_aggregates + a];
+        if (total.count == 0) {
+          KATANA_CHECKED(builder.AppendNull());
+          continue;
+        }
+        double result = 0;
+        switch (op) {
+        case katana::AggregateOp::kSum:
+          result = total.sum;
+          break;
+        case katana::AggregateOp::kMin:
+          result = total.min;
+          break;
+        case katana::AggregateOp::kMax:
+          result = total.max;
+          break;
+        default:
+          result = total.sum / total.count;
+          break;
+        }
+        KATANA_CHECKED(builder.Append(result));
+      }
+      KATANA_CHECKED(builder.Finish(&column));
+    }
+    fields.emplace_back(
+        arrow::field(AggregateName(aggregates[a]), column->type()));
+    columns.emplace_back(std::move(column));
+  }
+
+  return arrow::Table::Make(arrow::schema(fields), columns, num_groups);
+}
+
+}  // namespace
+
+katana::Result<katana::DynamicBitset>
+katana::FilterNodes(const PropertyGraph& pg, const PropertyFilter& filter) {
+  return Filter<Nodes>(pg, filter);
+}
+
+katana::Result<katana::DynamicBitset>
+katana::FilterEdges(const PropertyGraph& pg, const PropertyFilter& filter) {
+  return Filter<Edges>(pg, filter);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::AggregateNodes(
+    const PropertyGraph& pg, const DynamicBitset& mask,
+    const std::string& group_by, const std::vector<Aggregate>& aggregates) {
+  return AggregateEntities<Nodes>(pg, mask, group_by, aggregates);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::AggregateEdges(
+    const PropertyGraph& pg, const DynamicBitset& mask,
+    const std::string& group_by, const std::vector<Aggregate>& aggregates) {
+  return AggregateEntities<Edges>(pg, mask, group_by, aggregates);
+}
@@ -1,9 +1,9 @@
 #include <katana/PropertyViews.h>
 
-katana::Result<std::vector<arrow::Array*>>
+katana::Result<std::vector<arrow::ChunkedArray*>>
 katana::internal::ExtractArrays(
     const arrow::Table* table, const std::vector<std::string>& properties) {
-  std::vector<arrow::Array*> ret;
+  std::vector<arrow::ChunkedArray*> ret;
   for (auto& property : properties) {
     auto column = table->GetColumnByName(property);
     if (!column) {
@@ -11,30 +11,21 @@ katana::internal::ExtractArrays(
           ErrorCode::PropertyNotFound, "property named {}",
           std::quoted(property));
     }
-    if (column->num_chunks() != 1) {
-      // Katana form graphs only contain single chunk property columns.
-      return KATANA_ERROR(
-          ErrorCode::NotImplemented, "property is in the wrong format");
-    }
-    ret.emplace_back(column->chunks()[0].get());
+    // the table holds the column, so it outlives this shared_ptr
+    ret.emplace_back(column.get());
   }
 
   return ret;
 }
 
-katana::Result<std::vector<arrow::Array*>>
+katana::Result<std::vector<arrow::ChunkedArray*>>
 katana::internal::ExtractArrays(
     const PropertyGraph::ReadOnlyPropertyView& pview,
     const std::vector<std::string>& properties) {
-  std::vector<arrow::Array*> ret;
+  std::vector<arrow::ChunkedArray*> ret;
   for (auto& property : properties) {
     auto column = KATANA_CHECKED(pview.GetProperty(property));
-    if (column->num_chunks() != 1) {
-      // Katana form graphs only contain single chunk property columns.
-      return KATANA_ERROR(
-          ErrorCode::NotImplemented, "property is in the wrong format");
-    }
-    ret.emplace_back(column->chunks()[0].get());
+    ret.emplace_back(column.get());
   }
 
   return ret;
@@ -0,0 +1,469 @@
+#include "katana/RDGPartitioner.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include "katana/CSRTopology.h"
+#include "katana/ErrorCode.h"
+#include "katana/FileView.h"
+#include "katana/Logging.h"
+#include "katana/RDGManifest.h"
+#include "katana/RDGSlice.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace {
+
+/// An edge on its way to the host it is assigned to, by global ids
+struct EdgeRecord {
+  uint32_t src;
+  uint32_t dst;
+  katana::EntityTypeID type;
+};
+
+uint64_t
+OutIndexOffset(uint64_t n) {
+  return sizeof(katana::CSRTopologyHeader) + n * sizeof(uint64_t);
+}
+
+katana::Result<uint64_t>
+ReadOutIndex(const std::string& topology_path, uint64_t n) {
+  uint64_t index;
+  KATANA_CHECKED(katana::FileGet(
+      topology_path, &index, OutIndexOffset(n), sizeof(index)));
+  return index;
+}
+
+/// Which host owns each node and which host each edge goes to
+class Placement {
+public:
+  Placement(
+      uint64_t num_nodes, uint32_t num_hosts,
+      const katana::RDGPartitionOptions& opts)
+      : policy_(opts.policy), threshold_(opts.hybrid_degree_threshold) {
+    for (uint32_t h = 0; h <= num_hosts; ++h) {
+      begins_.emplace_back(num_nodes * h / num_hosts);
+    }
+    // as square a grid as num_hosts allows
+    rows_ = 1;
+    for (uint32_t r = 1; uint64_t{r} * r <= num_hosts; ++r) {
+      if (num_hosts % r == 0) {
+        rows_ = r;
+      }
+    }
+    cols_ = num_hosts / rows_;
+  }
+
+  uint64_t begin(uint32_t host) const { return begins_[host]; }
+  uint64_t end(uint32_t host) const { return begins_[host + 1]; }
+  uint32_t rows() const { return rows_; }
+  uint32_t cols() const { return cols_; }
+
+  uint32_t Owner(uint64_t node) const {
+    return std::upper_bound(begins_.begin(), begins_.end(), node) -
+           begins_.begin() - 1;
+  }
+
+  uint32_t HostOf(uint64_t src, uint64_t dst, uint64_t src_degree) const {
+    switch (policy_) {
+    case katana::PartitionPolicy::kCartesianVertexCut:
+      return (Owner(src) / cols_) * cols_ + Owner(dst) % cols_;
+    case katana::PartitionPolicy::kHybridVertexCut:
+      return src_degree <= threshold_ ? Owner(src) : Owner(dst);
+    case katana::PartitionPolicy::kEdgeCut:
+    default:
+      return Owner(src);
+    }
+  }
+
+private:
+  katana::PartitionPolicy policy_;
+  uint64_t threshold_;
+  /// Host h owns the nodes [begins_[h], begins_[h + 1])
+  std::vector<uint64_t> begins_;
+  uint32_t rows_;
+  uint32_t cols_;
+};
+
+/// A column of length nulls
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+NullColumn(const std::shared_ptr<arrow::DataType>& type, int64_t length) {
+  std::shared_ptr<arrow::Array> nulls =
+      KATANA_CHECKED(arrow::MakeArrayOfNull(type, length));
+  return std::make_shared<arrow::ChunkedArray>(nulls);
+}
+
+template <typename Builder, typename T>
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+ToChunkedArray(const std::vector<T>& vals) {
+  Builder builder;
+  KATANA_CHECKED(builder.AppendValues(vals));
+  std::shared_ptr<arrow::Array> array = KATANA_CHECKED(builder.Finish());
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+/// Reads the out edges of the nodes of one host a slice at a time
+class BlockReader {
+public:
+  BlockReader(
+      katana::RDGFile* file, std::string topology_path, uint64_t num_nodes,
+      uint64_t first, uint64_t end, uint64_t nodes_per_slice, bool has_types,
+      bool load_node_properties)
+      : file_(file),
+        topology_path_(std::move(topology_path)),
+        num_nodes_(num_nodes),
+        first_(first),
+        end_(end),
+        nodes_per_slice_(nodes_per_slice),
+        has_types_(has_types),
+        load_node_properties_(load_node_properties) {}
+
+  uint64_t num_slices() const {
+    return (end_ - first_ + nodes_per_slice_ - 1) / nodes_per_slice_;
+  }
+
+  /// Calls fn(src, dst, out_degree(src), type) for each edge of slice s,
+  /// which must be read in order; the types of its nodes go to node_types
+  /// and their properties to tables
+  template <typename Fn>
+  katana::Result<void> Read(
+      uint64_t s, std::vector<katana::EntityTypeID>* node_types,
+      std::vector<std::shared_ptr<arrow::Table>>* tables, const Fn& fn) {
+    uint64_t first = first_ + s * nodes_per_slice_;
+    uint64_t end = std::min(first + nodes_per_slice_, end_);
+    uint64_t first_edge =
+        first == 0 ? 0
+                   : KATANA_CHECKED(ReadOutIndex(topology_path_, first - 1));
+    uint64_t end_edge = KATANA_CHECKED(ReadOutIndex(topology_path_, end - 1));
+
+    std::vector<std::string> no_props;
+    std::optional<std::vector<std::string>> node_props;
+    if (!load_node_properties_) {
+      node_props = no_props;
+    }
+    katana::RDGSlice::SliceArg arg{
+        .node_range = {first, end},
+        .edge_range = {first_edge, end_edge},
+        .topo_off = OutIndexOffset(first),
+        .topo_size = (end - first) * sizeof(uint64_t)};
+    katana::RDGSlice slice = KATANA_CHECKED(
+        katana::RDGSlice::Make(*file_, arg, 0, node_props, no_props));
+    const uint64_t* out_indexes =
+        slice.topology_file_storage().ptr<uint64_t>(OutIndexOffset(first));
+
+    // the destinations are not contiguous with the out indexes in the
+    // topology file
+    uint64_t dests_offset = OutIndexOffset(num_nodes_);
+    katana::FileView dests_view;
+    const uint32_t* dests = nullptr;
+    if (end_edge > first_edge) {
+      KATANA_CHECKED(dests_view.Bind(
+          topology_path_, dests_offset + first_edge * sizeof(uint32_t),
+          dests_offset + end_edge * sizeof(uint32_t), true));
+      dests = dests_view.ptr<uint32_t>(
+          dests_offset + first_edge * sizeof(uint32_t));
+    }
+
+    katana::NUMAArray<katana::EntityTypeID> edge_types;
+    if (has_types_) {
+      katana::NUMAArray<katana::EntityTypeID> types =
+          KATANA_CHECKED(slice.node_entity_type_id_array());
+      node_types->insert(node_types->end(), types.begin(), types.end());
+      edge_types = KATANA_CHECKED(slice.edge_entity_type_id_array());
+    }
+    if (load_node_properties_) {
+      tables->emplace_back(slice.node_properties());
+    }
+
+    for (uint64_t n = first; n < end; ++n) {
+      uint64_t edge_begin =
+          n == first ? first_edge : out_indexes[n - first - 1];
+      uint64_t edge_end = out_indexes[n - first];
+      for (uint64_t e = edge_begin; e < edge_end; ++e) {
+        uint32_t dst = dests[e - first_edge];
+        if (dst >= num_nodes_) {
+          return KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument,
+              "edge {} has destination {} but there are {} nodes", e, dst,
+              num_nodes_);
+        }
+        fn(n, dst, edge_end - edge_begin,
+           has_types_ ? edge_types[e - first_edge] : katana::EntityTypeID{0});
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  katana::RDGFile* file_;
+  std::string topology_path_;
+  uint64_t num_nodes_;
+  uint64_t first_;
+  uint64_t end_;
+  uint64_t nodes_per_slice_;
+  bool has_types_;
+  bool load_node_properties_;
+};
+
+}  // namespace
+
+katana::Result<katana::RDGPartition>
+katana::PartitionRDG(
+    const std::string& rdg_name, CommBackend* comm,
+    const RDGPartitionOptions& opts) {
+  RDGManifest manifest = KATANA_CHECKED(FindManifest(rdg_name));
+  if (manifest.num_hosts() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} is already partitioned {} ways",
+        rdg_name, manifest.num_hosts());
+  }
+  RDGHandle handle = KATANA_CHECKED(Open(std::move(manifest), kReadOnly));
+  RDGFile file(handle);
+
+  // a slice of just the header, for the topology file, the size of the
+  // graph and its types
+  std::vector<std::string> no_props;
+  RDGSlice::SliceArg header_arg{
+      .node_range = {0, 0},
+      .edge_range = {0, 0},
+      .topo_off = 0,
+      .topo_size = sizeof(CSRTopologyHeader)};
+  RDGSlice meta = KATANA_CHECKED(
+      RDGSlice::Make(file, header_arg, 0, no_props, no_props));
+  const FileView& storage = meta.topology_file_storage();
+  std::string topology_path = storage.filename();
+  uint64_t num_nodes = storage.ptr<CSRTopologyHeader>()->num_nodes;
+  uint64_t num_edges = storage.ptr<CSRTopologyHeader>()->num_edges;
+  if (num_nodes > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "graphs of {} nodes are not supported",
+        num_nodes);
+  }
+
+  RDGPartition part;
+  bool has_types = meta.IsEntityTypeIDsOutsideProperties();
+  if (has_types) {
+    part.node_type_manager = KATANA_CHECKED(meta.node_entity_type_manager());
+    part.edge_type_manager = KATANA_CHECKED(meta.edge_entity_type_manager());
+  }
+
+  Placement placement(num_nodes, comm->Num, opts);
+  uint64_t begin = placement.begin(comm->Rank);
+  uint64_t end = placement.end(comm->Rank);
+  uint64_t num_owned = end - begin;
+
+  uint64_t bytes_per_node =
+      sizeof(uint64_t) + sizeof(EntityTypeID) +
+      (sizeof(uint32_t) + sizeof(EntityTypeID)) * num_edges /
+          std::max<uint64_t>(num_nodes, 1);
+  uint64_t nodes_per_slice =
+      std::max<uint64_t>(1, opts.slice_bytes / bytes_per_node);
+  BlockReader reader(
+      &file, topology_path, num_nodes, begin, end, nodes_per_slice, has_types,
+      opts.load_node_properties);
+
+  // Every host takes part in as many exchanges as the host with the most
+  // slices, so that memory is bounded by a slice and the edges received
+  std::vector<uint64_t> num_rounds = comm->AllReduce(
+      std::vector<uint64_t>{reader.num_slices()},
+      [](uint64_t a, uint64_t b) { return std::max(a, b); });
+  std::vector<EdgeRecord> edges;
+  std::vector<EntityTypeID> node_types;
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (uint64_t round = 0; round < num_rounds[0]; ++round) {
+    std::vector<std::vector<EdgeRecord>> out(comm->Num);
+    if (round < reader.num_slices()) {
+      auto res = reader.Read(
+          round, &node_types, &tables,
+          [&](uint64_t src, uint32_t dst, uint64_t degree, EntityTypeID type) {
+            out[placement.HostOf(src, dst, degree)].emplace_back(
+                EdgeRecord{static_cast<uint32_t>(src), dst, type});
+          });
+      if (!res) {
+        comm->NotifyFailure();
+        return res.error().WithContext("reading nodes of round {}", round);
+      }
+    }
+    for (const std::vector<EdgeRecord>& in : comm->AllToAll(out)) {
+      edges.insert(edges.end(), in.begin(), in.end());
+    }
+  }
+
+  // the endpoints owned by other hosts are mirrored, in global id order
+  std::vector<uint32_t> mirrors;
+  for (const EdgeRecord& edge : edges) {
+    for (uint32_t n : {edge.src, edge.dst}) {
+      if (n < begin || n >= end) {
+        mirrors.emplace_back(n);
+      }
+    }
+  }
+  std::sort(mirrors.begin(), mirrors.end());
+  mirrors.erase(std::unique(mirrors.begin(), mirrors.end()), mirrors.end());
+  uint64_t num_local = num_owned + mirrors.size();
+  auto to_local = [&](uint32_t n) -> uint32_t {
+    if (n >= begin && n < end) {
+      return n - begin;
+    }
+    return num_owned +
+           (std::lower_bound(mirrors.begin(), mirrors.end(), n) -
+            mirrors.begin());
+  };
+
+  // the edges by local source, in the order received
+  part.out_indexes.assign(num_local, 0);
+  for (const EdgeRecord& edge : edges) {
+    ++part.out_indexes[to_local(edge.src)];
+  }
+  std::vector<uint64_t> next(num_local, 0);
+  for (uint64_t n = 1; n < num_local; ++n) {
+    part.out_indexes[n] += part.out_indexes[n - 1];
+    next[n] = part.out_indexes[n - 1];
+  }
+  part.dests.resize(edges.size());
+  if (has_types) {
+    part.edge_types.resize(edges.size());
+  }
+  for (const EdgeRecord& edge : edges) {
+    uint64_t e = next[to_local(edge.src)]++;
+    part.dests[e] = to_local(edge.dst);
+    if (has_types) {
+      part.edge_types[e] = edge.type;
+    }
+  }
+
+  // Each host tells the owners of its mirrors which of their masters it
+  // mirrors, in the order of its mirrors
+  std::vector<std::vector<uint32_t>> mirrored(comm->Num);
+  for (uint32_t n : mirrors) {
+    mirrored[placement.Owner(n)].emplace_back(n);
+  }
+  std::vector<std::vector<uint32_t>> masters = comm->AllToAll(mirrored);
+  part.master_nodes.resize(comm->Num);
+  part.mirror_nodes.resize(comm->Num);
+  uint32_t next_mirror = num_owned;
+  for (uint32_t h = 0; h < comm->Num; ++h) {
+    for (size_t i = 0; i < mirrored[h].size(); ++i) {
+      part.mirror_nodes[h].emplace_back(next_mirror++);
+    }
+    for (uint32_t n : masters[h]) {
+      KATANA_LOG_ASSERT(n >= begin && n < end);
+      part.master_nodes[h].emplace_back(n - begin);
+    }
+  }
+
+  if (has_types) {
+    std::vector<std::vector<EntityTypeID>> master_types(comm->Num);
+    for (uint32_t h = 0; h < comm->Num; ++h) {
+      for (uint32_t n : masters[h]) {
+        master_types[h].emplace_back(node_types[n - begin]);
+      }
+    }
+    part.node_types = std::move(node_types);
+    for (const auto& types : comm->AllToAll(master_types)) {
+      part.node_types.insert(part.node_types.end(), types.begin(), types.end());
+    }
+    KATANA_LOG_ASSERT(part.node_types.size() == num_local);
+  }
+
+  if (opts.load_node_properties) {
+    if (tables.empty()) {
+      std::shared_ptr<arrow::Schema> schema = meta.full_node_schema();
+      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+      for (const auto& field : schema->fields()) {
+        columns.emplace_back(KATANA_CHECKED(NullColumn(field->type(), 0)));
+      }
+      part.master_properties = arrow::Table::Make(schema, columns, 0);
+    } else {
+      part.master_properties =
+          KATANA_CHECKED(arrow::ConcatenateTables(tables));
+    }
+  }
+
+  part.local_to_global.reserve(num_local);
+  for (uint64_t n = begin; n < end; ++n) {
+    part.local_to_global.emplace_back(n);
+  }
+  part.local_to_global.insert(
+      part.local_to_global.end(), mirrors.begin(), mirrors.end());
+
+  PartitionMetadata& metadata = part.metadata;
+  metadata.policy_id_ = static_cast<uint32_t>(opts.policy);
+  metadata.is_outgoing_edge_cut_ = opts.policy == PartitionPolicy::kEdgeCut;
+  metadata.num_global_nodes_ = num_nodes;
+  metadata.max_global_node_id_ = num_nodes == 0 ? 0 : num_nodes - 1;
+  metadata.num_global_edges_ = num_edges;
+  metadata.num_edges_ = edges.size();
+  metadata.num_nodes_ = num_local;
+  metadata.num_owned_ = num_owned;
+  if (opts.policy == PartitionPolicy::kCartesianVertexCut) {
+    metadata.cartesian_grid_ = {placement.rows(), placement.cols()};
+  }
+  return part;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::MakePartitionedGraph(RDGPartition&& part, TxnContext* txn_ctx) {
+  uint64_t num_nodes = part.out_indexes.size();
+  uint64_t num_owned = part.metadata.num_owned_;
+  GraphTopology topo(
+      part.out_indexes.data(), num_nodes, part.dests.data(),
+      part.dests.size());
+
+  std::unique_ptr<PropertyGraph> pg;
+  if (part.node_types.empty() && part.edge_types.empty()) {
+    pg = KATANA_CHECKED(PropertyGraph::Make(std::move(topo)));
+  } else {
+    PropertyGraph::EntityTypeIDArray node_types;
+    PropertyGraph::EntityTypeIDArray edge_types;
+    node_types.allocateInterleaved(part.node_types.size());
+    edge_types.allocateInterleaved(part.edge_types.size());
+    std::copy(
+        part.node_types.begin(), part.node_types.end(), node_types.begin());
+    std::copy(
+        part.edge_types.begin(), part.edge_types.end(), edge_types.begin());
+    pg = KATANA_CHECKED(PropertyGraph::Make(
+        std::move(topo), std::move(node_types), std::move(edge_types),
+        std::move(part.node_type_manager), std::move(part.edge_type_manager)));
+  }
+
+  if (part.master_properties != nullptr &&
+      part.master_properties->num_columns() > 0) {
+    // the mirrors have no properties of their own
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (const auto& column : part.master_properties->columns()) {
+      arrow::ArrayVector chunks = column->chunks();
+      std::shared_ptr<arrow::ChunkedArray> nulls =
+          KATANA_CHECKED(NullColumn(column->type(), num_nodes - num_owned));
+      chunks.insert(
+          chunks.end(), nulls->chunks().begin(), nulls->chunks().end());
+      columns.emplace_back(
+          KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, column->type())));
+    }
+    KATANA_CHECKED(pg->AddNodeProperties(
+        arrow::Table::Make(
+            part.master_properties->schema(), columns, num_nodes),
+        txn_ctx));
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes;
+  for (const auto& nodes : part.master_nodes) {
+    master_nodes.emplace_back(
+        KATANA_CHECKED(ToChunkedArray<arrow::UInt32Builder>(nodes)));
+  }
+  for (const auto& nodes : part.mirror_nodes) {
+    mirror_nodes.emplace_back(
+        KATANA_CHECKED(ToChunkedArray<arrow::UInt32Builder>(nodes)));
+  }
+  std::vector<uint64_t> owned(
+      part.local_to_global.begin(), part.local_to_global.begin() + num_owned);
+  pg->SetPartition(
+      part.metadata, std::move(master_nodes), std::move(mirror_nodes),
+      KATANA_CHECKED(
+          ToChunkedArray<arrow::UInt64Builder>(part.local_to_global)),
+      KATANA_CHECKED(ToChunkedArray<arrow::UInt64Builder>(owned)));
+  return std::unique_ptr<PropertyGraph>(std::move(pg));
+}
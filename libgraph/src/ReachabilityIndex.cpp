@@ -0,0 +1,292 @@
+#include "katana/ReachabilityIndex.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+
+namespace {
+
+using Node = katana::ReachabilityIndex::Node;
+
+constexpr uint32_t kInfinity = katana::ReachabilityIndex::kUnreachable;
+
+/// The batch of hubs that starts at rank r has r / kBatchGrowth hubs, at
+/// least one and at most kMaxBatchSize: the first hubs cover most paths and
+/// are labeled one at a time, so that each prunes the searches of the next,
+/// and the later ones have short searches that are labeled many at a time
+constexpr uint32_t kBatchGrowth = 16;
+constexpr uint32_t kMaxBatchSize = 1024;
+
+/// The label of a node while it is built: (rank of hub, distance) entries,
+/// sorted by rank
+using Label = std::vector<std::pair<uint32_t, uint32_t>>;
+
+/// A new entry of the label of node
+struct Entry {
+  Node node;
+  uint32_t distance;
+};
+
+struct Scratch {
+  /// Distance of every node from the hub of the search, or kInfinity
+  std::vector<uint32_t> distance;
+  /// Distance between the hub of the search and every hub of its label,
+  /// by rank, or kInfinity
+  std::vector<uint32_t> hub_distance;
+  /// Queue of the search, which is also the list of nodes to reset after it
+  std::vector<Node> queue;
+  /// The entries of the searches of this thread in the current batch, those
+  /// of every search contiguous
+  std::vector<Entry> entries;
+};
+
+/// Where the entries of the search of a hub are
+struct Segment {
+  const Scratch* scratch{nullptr};
+  size_t begin{0};
+  size_t end{0};
+};
+
+/// Breadth first search from hub, along out edges if kForward to label the
+/// in labels of the nodes it reaches, and along in edges otherwise to label
+/// the out labels of the nodes that reach it. Nodes whose distance to hub is
+/// covered by the labels already, and the nodes past them, are pruned.
+template <bool kForward>
+Segment
+PrunedBfs(
+    const katana::SimpleBiDirTopology& topo, Node hub,
+    const std::vector<Label>& hub_labels, const std::vector<Label>& labels,
+    Scratch* s) {
+  for (auto [rank, distance] : hub_labels[hub]) {
+    s->hub_distance[rank] = distance;
+  }
+
+  Segment segment{s, s->entries.size(), 0};
+  s->queue.clear();
+  s->queue.emplace_back(hub);
+  s->distance[hub] = 0;
+  for (size_t head = 0; head < s->queue.size(); ++head) {
+    Node n = s->queue[head];
+    uint32_t distance = s->distance[n];
+
+    bool covered = false;
+    for (auto [rank, label_distance] : labels[n]) {
+      if (s->hub_distance[rank] != kInfinity &&
+          s->hub_distance[rank] + label_distance <= distance) {
+        covered = true;
+        break;
+      }
+    }
+    if (covered) {
+      continue;
+    }
+    s->entries.emplace_back(Entry{n, distance});
+
+    auto visit = [&](Node next) {
+      if (s->distance[next] == kInfinity) {
+        s->distance[next] = distance + 1;
+        s->queue.emplace_back(next);
+      }
+    };
+    if constexpr (kForward) {
+      for (auto e : topo.OutEdges(n)) {
+        visit(topo.OutEdgeDst(e));
+      }
+    } else {
+      for (auto e : topo.InEdges(n)) {
+        visit(topo.InEdgeSrc(e));
+      }
+    }
+  }
+  segment.end = s->entries.size();
+
+  for (Node n : s->queue) {
+    s->distance[n] = kInfinity;
+  }
+  for (auto [rank, distance] : hub_labels[hub]) {
+    s->hub_distance[rank] = kInfinity;
+  }
+  return segment;
+}
+
+/// Flattens labels into a CSR
+katana::ReachabilityIndexPrimitive::Labels
+Flatten(const std::vector<Label>& labels) {
+  std::vector<uint64_t> offsets(labels.size() + 1);
+  offsets[0] = 0;
+  for (size_t n = 0; n < labels.size(); ++n) {
+    offsets[n + 1] = offsets[n] + labels[n].size();
+  }
+  std::vector<uint32_t> hubs(offsets.back());
+  std::vector<uint32_t> distances(offsets.back());
+  katana::do_all(
+      katana::iterate(size_t{0}, labels.size()),
+      [&](size_t n) {
+        uint64_t i = offsets[n];
+        for (auto [rank, distance] : labels[n]) {
+          hubs[i] = rank;
+          distances[i] = distance;
+          ++i;
+        }
+      },
+      katana::no_stats());
+
+  katana::ReachabilityIndexPrimitive::Labels flat;
+  flat.offsets = katana::ReachabilityIndexPrimitive::Array<uint64_t>(
+      std::move(offsets));
+  flat.hubs =
+      katana::ReachabilityIndexPrimitive::Array<uint32_t>(std::move(hubs));
+  flat.distances =
+      katana::ReachabilityIndexPrimitive::Array<uint32_t>(std::move(distances));
+  return flat;
+}
+
+}  // namespace
+
+katana::ReachabilityIndex
+katana::ReachabilityIndex::Build(PropertyGraph* pg) {
+  return Build(pg->BuildView<PropertyGraphViews::BiDirectional>());
+}
+
+katana::ReachabilityIndex
+katana::ReachabilityIndex::Build(const SimpleBiDirTopology& topo) {
+  katana::StatTimer timer("Build", "ReachabilityIndex");
+  timer.start();
+
+  uint32_t num_nodes = topo.NumNodes();
+
+  // Hubs by decreasing degree, which cover the most paths
+  std::vector<Node> order(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    order[n] = n;
+  }
+  katana::ParallelSTL::sort(order.begin(), order.end(), [&](Node a, Node b) {
+    auto degree_a = topo.OutDegree(a) + topo.InDegree(a);
+    auto degree_b = topo.OutDegree(b) + topo.InDegree(b);
+    return degree_a > degree_b || (degree_a == degree_b && a < b);
+  });
+
+  std::vector<Label> out_labels(num_nodes);
+  std::vector<Label> in_labels(num_nodes);
+  katana::PerThreadStorage<Scratch> scratch;
+  std::vector<Segment> out_segments;
+  std::vector<Segment> in_segments;
+
+  uint32_t num_batches = 0;
+  for (uint32_t begin = 0; begin < num_nodes; ++num_batches) {
+    uint32_t size = std::clamp(begin / kBatchGrowth, 1U, kMaxBatchSize);
+    uint32_t end = std::min(begin + size, num_nodes);
+    out_segments.assign(end - begin, Segment{});
+    in_segments.assign(end - begin, Segment{});
+
+    // The searches read the labels of the batches before and write their
+    // entries to scratch, so that they do not prune each other
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint32_t rank) {
+          Scratch& s = *scratch.getLocal();
+          if (s.distance.empty()) {
+            s.distance.assign(num_nodes, kInfinity);
+            s.hub_distance.assign(num_nodes, kInfinity);
+          }
+          Node hub = order[rank];
+          in_segments[rank - begin] =
+              PrunedBfs<true>(topo, hub, out_labels, in_labels, &s);
+          out_segments[rank - begin] =
+              PrunedBfs<false>(topo, hub, in_labels, out_labels, &s);
+        },
+        katana::steal(), katana::no_stats());
+
+    // Appending the entries in the order of the hubs keeps every label
+    // sorted by rank
+    for (uint32_t rank = begin; rank < end; ++rank) {
+      const Segment& in = in_segments[rank - begin];
+      for (size_t i = in.begin; i < in.end; ++i) {
+        const Entry& entry = in.scratch->entries[i];
+        in_labels[entry.node].emplace_back(rank, entry.distance);
+      }
+      const Segment& out = out_segments[rank - begin];
+      for (size_t i = out.begin; i < out.end; ++i) {
+        const Entry& entry = out.scratch->entries[i];
+        out_labels[entry.node].emplace_back(rank, entry.distance);
+      }
+    }
+    katana::on_each([&](unsigned, unsigned) {
+      scratch.getLocal()->entries.clear();
+    });
+    begin = end;
+  }
+
+  ReachabilityIndexPrimitive primitive;
+  primitive.set_num_nodes(num_nodes);
+  primitive.set_out_labels(Flatten(out_labels));
+  primitive.set_in_labels(Flatten(in_labels));
+  ReachabilityIndex index(std::move(primitive));
+
+  timer.stop();
+  katana::ReportStatSingle("ReachabilityIndex", "Batches", num_batches);
+  katana::ReportStatSingle("ReachabilityIndex", "Entries", index.NumEntries());
+  KATANA_LOG_VERBOSE(
+      "reachability index of {} nodes: {} entries, {:.1f} per node", num_nodes,
+      index.NumEntries(),
+      num_nodes == 0 ? 0.0
+                     : static_cast<double>(index.NumEntries()) / num_nodes);
+  return index;
+}
+
+katana::Result<std::optional<katana::ReachabilityIndex>>
+katana::ReachabilityIndex::Load(PropertyGraph* pg) {
+  std::optional<ReachabilityIndexPrimitive> primitive =
+      KATANA_CHECKED(pg->LoadReachabilityIndexPrimitive());
+  if (!primitive) {
+    return std::nullopt;
+  }
+  if (primitive->num_nodes() != pg->NumNodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "reachability index is of {} nodes but the graph has {}",
+        primitive->num_nodes(), pg->NumNodes());
+  }
+  return std::make_optional(ReachabilityIndex(std::move(primitive.value())));
+}
+
+katana::Result<void>
+katana::ReachabilityIndex::Write(PropertyGraph* pg) {
+  return pg->WriteReachabilityIndexPrimitive(primitive_);
+}
+
+uint32_t
+katana::ReachabilityIndex::Distance(Node src, Node dst) const {
+  KATANA_LOG_DEBUG_ASSERT(src < NumNodes() && dst < NumNodes());
+  const ReachabilityIndexPrimitive::Labels& out = primitive_.out_labels();
+  const ReachabilityIndexPrimitive::Labels& in = primitive_.in_labels();
+  const uint32_t* out_hubs = out.hubs.data();
+  const uint32_t* in_hubs = in.hubs.data();
+  uint64_t i = out.offsets.data()[src];
+  uint64_t i_end = out.offsets.data()[src + 1];
+  uint64_t j = in.offsets.data()[dst];
+  uint64_t j_end = in.offsets.data()[dst + 1];
+
+  uint32_t best = kUnreachable;
+  while (i < i_end && j < j_end) {
+    if (out_hubs[i] < in_hubs[j]) {
+      ++i;
+    } else if (in_hubs[j] < out_hubs[i]) {
+      ++j;
+    } else {
+      best = std::min(best, out.distances.data()[i] + in.distances.data()[j]);
+      ++i;
+      ++j;
+    }
+  }
+  return best;
+}
@@ -0,0 +1,544 @@
+#include "katana/SharedGraph.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// "SHDGRAPH" in little endian
+constexpr uint64_t kSegmentMagic = 0x4850415247444853;
+constexpr uint64_t kSegmentVersion = 1;
+/// Sections start at cache line boundaries, which is also the alignment
+/// that arrow wants for the buffers of the properties
+constexpr uint64_t kSectionAlignment = 64;
+constexpr uint64_t kHugePageSize = uint64_t{1} << 21;
+/// The seals reading a segment relies on: nothing can write to it or
+/// shrink it under a mapping
+constexpr int kRequiredSeals = F_SEAL_WRITE | F_SEAL_SHRINK;
+constexpr int kSeals = kRequiredSeals | F_SEAL_GROW | F_SEAL_SEAL;
+
+enum Section : size_t {
+  kAdjIndices,
+  kDests,
+  kNodeTypes,
+  kEdgeTypes,
+  kNodeTypeManager,
+  kEdgeTypeManager,
+  kNodeProperties,
+  kEdgeProperties,
+  kNumSections,
+};
+
+struct SectionExtent {
+  uint64_t offset;
+  uint64_t size;
+};
+
+/// The start of a segment; the sections follow it in order
+struct SegmentHeader {
+  uint64_t magic;
+  uint64_t version;
+  uint64_t num_nodes;
+  uint64_t num_edges;
+  SectionExtent sections[kNumSections];
+};
+
+uint64_t
+AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+void
+AppendValue(std::string* out, T value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/// The sets of the atomic types of each entity type and the names of the
+/// atomic types
+std::string
+SerializeTypeManager(const katana::EntityTypeManager& manager) {
+  const katana::EntityTypeIDToSetOfEntityTypeIDsMap& sets =
+      manager.GetEntityTypeIDToAtomicEntityTypeIDs();
+  std::string out;
+  AppendValue<uint64_t>(&out, sets.size());
+  std::vector<katana::EntityTypeID> atomic_ids;
+  for (const katana::SetOfEntityTypeIDs& set : sets) {
+    atomic_ids.clear();
+    for (size_t id = 0; id < sets.size(); ++id) {
+      if (set.test(id)) {
+        atomic_ids.emplace_back(id);
+      }
+    }
+    AppendValue<uint64_t>(&out, atomic_ids.size());
+    for (katana::EntityTypeID id : atomic_ids) {
+      AppendValue(&out, id);
+    }
+  }
+
+  const katana::EntityTypeIDToAtomicTypeNameMap& names =
+      manager.GetEntityTypeIDToAtomicTypeNameMap();
+  AppendValue<uint64_t>(&out, names.size());
+  for (const auto& [id, name] : names) {
+    AppendValue(&out, id);
+    AppendValue<uint64_t>(&out, name.size());
+    out.append(name);
+  }
+  return out;
+}
+
+/// Reads the values of a section, failing instead of reading past its end
+class SectionReader {
+public:
+  SectionReader(const uint8_t* data, uint64_t size)
+      : pos_(data), end_(data + size) {}
+
+  template <typename T>
+  katana::Result<T> Read() {
+    T value;
+    KATANA_CHECKED(Read(&value, sizeof(value)));
+    return value;
+  }
+
+  katana::Result<std::string> ReadString(uint64_t size) {
+    std::string value(size, '\0');
+    KATANA_CHECKED(Read(value.data(), size));
+    return value;
+  }
+
+private:
+  katana::Result<void> Read(void* out, uint64_t size) {
+    if (size > static_cast<uint64_t>(end_ - pos_)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "truncated shared graph section");
+    }
+    std::memcpy(out, pos_, size);
+    pos_ += size;
+    return katana::ResultSuccess();
+  }
+
+  const uint8_t* pos_;
+  const uint8_t* end_;
+};
+
+katana::Result<katana::EntityTypeManager>
+DeserializeTypeManager(const uint8_t* data, uint64_t size) {
+  SectionReader reader(data, size);
+  auto num_types = KATANA_CHECKED(reader.Read<uint64_t>());
+  if (num_types == 0 || num_types > katana::kMaxSetOfEntityTypeIDsSize) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "invalid number of types {}",
+        num_types);
+  }
+  size_t set_size = katana::EntityTypeManager::CalculateSetOfEntityTypeIDsSize(
+      num_types - 1);
+  katana::EntityTypeIDToSetOfEntityTypeIDsMap sets(num_types);
+  for (katana::SetOfEntityTypeIDs& set : sets) {
+    set.resize(set_size);
+    auto num_atomic = KATANA_CHECKED(reader.Read<uint64_t>());
+    for (uint64_t i = 0; i < num_atomic; ++i) {
+      auto id = KATANA_CHECKED(reader.Read<katana::EntityTypeID>());
+      if (id == katana::kUnknownEntityType || id >= num_types) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "invalid atomic type {}", id);
+      }
+      set.set(id);
+    }
+  }
+
+  katana::EntityTypeIDToAtomicTypeNameMap names;
+  auto num_names = KATANA_CHECKED(reader.Read<uint64_t>());
+  for (uint64_t i = 0; i < num_names; ++i) {
+    auto id = KATANA_CHECKED(reader.Read<katana::EntityTypeID>());
+    auto name_size = KATANA_CHECKED(reader.Read<uint64_t>());
+    if (id == katana::kUnknownEntityType || id >= num_types) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "invalid atomic type {}", id);
+    }
+    names.emplace(id, KATANA_CHECKED(reader.ReadString(name_size)));
+  }
+  return katana::EntityTypeManager(std::move(names), std::move(sets));
+}
+
+katana::Result<void>
+WriteProperties(
+    const std::shared_ptr<arrow::Table>& table,
+    arrow::io::OutputStream* stream) {
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  options.alignment = kSectionAlignment;
+  auto writer = KATANA_CHECKED(
+      arrow::ipc::MakeStreamWriter(stream, table->schema(), options));
+  KATANA_CHECKED(writer->WriteTable(*table));
+  KATANA_CHECKED(writer->Close());
+  return katana::ResultSuccess();
+}
+
+/// The size of the arrow IPC stream of table, or zero if it has no
+/// properties to write
+katana::Result<uint64_t>
+PropertiesSize(const std::shared_ptr<arrow::Table>& table) {
+  if (!table || table->num_columns() == 0) {
+    return 0;
+  }
+  arrow::io::MockOutputStream stream;
+  KATANA_CHECKED(WriteProperties(table, &stream));
+  return stream.GetExtentBytesWritten();
+}
+
+/// A buffer in a mapping of a segment, that keeps the mapping while arrow
+/// keeps the buffer or any slice of it
+class MappedBuffer : public arrow::Buffer {
+public:
+  MappedBuffer(
+      std::shared_ptr<const void> mapping, const uint8_t* data, int64_t size)
+      : arrow::Buffer(data, size), mapping_(std::move(mapping)) {}
+
+private:
+  std::shared_ptr<const void> mapping_;
+};
+
+/// Read an arrow IPC stream without copying: the columns of the table are
+/// slices of buffer
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadProperties(const std::shared_ptr<arrow::Buffer>& buffer) {
+  auto input = std::make_shared<arrow::io::BufferReader>(buffer);
+  auto reader =
+      KATANA_CHECKED(arrow::ipc::RecordBatchStreamReader::Open(input));
+  arrow::RecordBatchVector batches;
+  KATANA_CHECKED(reader->ReadAll(&batches));
+  return KATANA_CHECKED(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+}
+
+katana::Result<std::shared_ptr<const void>>
+MapSegment(int fd, size_t size) {
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "mapping shared graph of size {}", size);
+  }
+  return std::shared_ptr<const void>(addr, [size](const void* p) {
+    if (munmap(const_cast<void*>(p), size) != 0) {  // NOLINT
+      KATANA_LOG_WARN(
+          "unmapping shared graph: {}", katana::ResultErrno().message());
+    }
+  });
+}
+
+}  // namespace
+
+katana::SharedGraph::SharedGraph(SharedGraph&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      size_(std::exchange(other.size_, 0)) {}
+
+katana::SharedGraph&
+katana::SharedGraph::operator=(SharedGraph&& other) noexcept {
+  if (this != &other) {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    fd_ = std::exchange(other.fd_, -1);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+katana::SharedGraph::~SharedGraph() {
+  if (fd_ >= 0 && close(fd_) != 0) {
+    KATANA_LOG_WARN("closing shared graph: {}", ResultErrno().message());
+  }
+}
+
+katana::Result<katana::SharedGraph>
+katana::SharedGraph::Export(
+    const PropertyGraph& pg, const SharedGraphOptions& opts) {
+  const GraphTopology& topo = pg.topology();
+  if (pg.is_transformed || topo.edge_property_index_data() != nullptr ||
+      topo.node_property_index_data() != nullptr) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "only graphs whose properties are indexed by node and edge ids can "
+        "be shared");
+  }
+  if (pg.node_entity_type_ids_->size() != pg.NumNodes() ||
+      pg.edge_entity_type_ids_->size() != pg.NumEdges()) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed, "entity type ids do not match topology");
+  }
+
+  std::string node_type_manager = SerializeTypeManager(pg.GetNodeTypeManager());
+  std::string edge_type_manager = SerializeTypeManager(pg.GetEdgeTypeManager());
+  const std::shared_ptr<arrow::Table>& node_properties =
+      pg.rdg().node_properties();
+  const std::shared_ptr<arrow::Table>& edge_properties =
+      pg.rdg().edge_properties();
+
+  uint64_t node_properties_size =
+      KATANA_CHECKED(PropertiesSize(node_properties));
+  uint64_t edge_properties_size =
+      KATANA_CHECKED(PropertiesSize(edge_properties));
+
+  SegmentHeader header{};
+  header.magic = kSegmentMagic;
+  header.version = kSegmentVersion;
+  header.num_nodes = pg.NumNodes();
+  header.num_edges = pg.NumEdges();
+  uint64_t section_sizes[kNumSections] = {
+      sizeof(GraphTopology::Edge) * pg.NumNodes(),
+      sizeof(GraphTopology::Node) * pg.NumEdges(),
+      sizeof(EntityTypeID) * pg.NumNodes(),
+      sizeof(EntityTypeID) * pg.NumEdges(),
+      node_type_manager.size(),
+      edge_type_manager.size(),
+      node_properties_size,
+      edge_properties_size,
+  };
+  uint64_t end = sizeof(header);
+  for (size_t i = 0; i < kNumSections; ++i) {
+    header.sections[i].offset = AlignUp(end, kSectionAlignment);
+    header.sections[i].size = section_sizes[i];
+    end = header.sections[i].offset + section_sizes[i];
+  }
+  // hugetlbfs files are sized in whole huge pages
+  uint64_t size = opts.use_huge_pages ? AlignUp(end, kHugePageSize) : end;
+
+  unsigned int flags = MFD_CLOEXEC | MFD_ALLOW_SEALING;
+  if (opts.use_huge_pages) {
+    flags |= MFD_HUGETLB;
+  }
+  int fd = memfd_create("katana-shared-graph", flags);
+  if (fd < 0) {
+    return KATANA_ERROR(ResultErrno(), "creating shared graph segment");
+  }
+  SharedGraph segment(fd, size);
+  if (ftruncate(fd, size) != 0) {
+    return KATANA_ERROR(
+        ResultErrno(), "sizing shared graph segment to {}", size);
+  }
+
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    return KATANA_ERROR(
+        ResultErrno(), "mapping shared graph segment of size {}", size);
+  }
+  auto* base = static_cast<uint8_t*>(addr);
+  auto section = [&](Section s) { return base + header.sections[s].offset; };
+  auto write_sections = [&]() -> Result<void> {
+    std::memcpy(base, &header, sizeof(header));
+    std::memcpy(
+        section(kAdjIndices), topo.AdjData(), section_sizes[kAdjIndices]);
+    std::memcpy(section(kDests), topo.DestData(), section_sizes[kDests]);
+    std::memcpy(
+        section(kNodeTypes), pg.node_entity_type_ids_->data(),
+        section_sizes[kNodeTypes]);
+    std::memcpy(
+        section(kEdgeTypes), pg.edge_entity_type_ids_->data(),
+        section_sizes[kEdgeTypes]);
+    std::memcpy(
+        section(kNodeTypeManager), node_type_manager.data(),
+        node_type_manager.size());
+    std::memcpy(
+        section(kEdgeTypeManager), edge_type_manager.data(),
+        edge_type_manager.size());
+    for (Section s : {kNodeProperties, kEdgeProperties}) {
+      if (section_sizes[s] == 0) {
+        continue;
+      }
+      auto buffer =
+          std::make_shared<arrow::MutableBuffer>(section(s), section_sizes[s]);
+      arrow::io::FixedSizeBufferWriter stream(buffer);
+      KATANA_CHECKED(WriteProperties(
+          s == kNodeProperties ? node_properties : edge_properties, &stream));
+    }
+    return ResultSuccess();
+  };
+  auto write_res = write_sections();
+  if (munmap(addr, size) != 0) {
+    return KATANA_ERROR(ResultErrno(), "unmapping shared graph segment");
+  }
+  KATANA_CHECKED_CONTEXT(write_res, "writing shared graph segment");
+
+  if (fcntl(fd, F_ADD_SEALS, kSeals) != 0) {
+    return KATANA_ERROR(ResultErrno(), "sealing shared graph segment");
+  }
+  return MakeResult(std::move(segment));
+}
+
+katana::Result<katana::SharedGraph>
+katana::SharedGraph::FromFd(int fd) {
+  SharedGraph segment(fd, 0);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return KATANA_ERROR(ResultErrno(), "reading size of shared graph");
+  }
+  int seals = fcntl(fd, F_GET_SEALS);
+  if (seals < 0) {
+    return KATANA_ERROR(ResultErrno(), "reading seals of shared graph");
+  }
+  if ((seals & kRequiredSeals) != kRequiredSeals) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "shared graph segment is not sealed");
+  }
+  segment.size_ = st.st_size;
+  return MakeResult(std::move(segment));
+}
+
+katana::Result<void>
+katana::SharedGraph::Send(int socket_fd) const {
+  char byte = 0;
+  iovec iov{&byte, sizeof(byte)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), &fd_, sizeof(int));
+
+  ssize_t sent = 0;
+  do {
+    sent = sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+  } while (sent < 0 && errno == EINTR);
+  if (sent < 0) {
+    return KATANA_ERROR(ResultErrno(), "sending shared graph");
+  }
+  return ResultSuccess();
+}
+
+katana::Result<katana::SharedGraph>
+katana::SharedGraph::Receive(int socket_fd) {
+  char byte = 0;
+  iovec iov{&byte, sizeof(byte)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t received = 0;
+  do {
+    received = recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC);
+  } while (received < 0 && errno == EINTR);
+  if (received < 0) {
+    return KATANA_ERROR(ResultErrno(), "receiving shared graph");
+  }
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (received == 0 || (msg.msg_flags & MSG_CTRUNC) || cmsg == nullptr ||
+      cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no shared graph received");
+  }
+  int fd = -1;
+  std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+  return FromFd(fd);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::SharedGraph::Attach(TxnContext* txn_ctx) const {
+  if (size_ < sizeof(SegmentHeader)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "shared graph segment is too small");
+  }
+  std::shared_ptr<const void> mapping = KATANA_CHECKED(MapSegment(fd_, size_));
+  const auto* base = static_cast<const uint8_t*>(mapping.get());
+  SegmentHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (header.magic != kSegmentMagic || header.version != kSegmentVersion) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "not a shared graph segment");
+  }
+
+  uint64_t num_nodes = header.num_nodes;
+  uint64_t num_edges = header.num_edges;
+  uint64_t expected_sizes[] = {
+      sizeof(GraphTopology::Edge) * num_nodes,
+      sizeof(GraphTopology::Node) * num_edges,
+      sizeof(EntityTypeID) * num_nodes,
+      sizeof(EntityTypeID) * num_edges,
+  };
+  for (size_t i = 0; i < kNumSections; ++i) {
+    const SectionExtent& extent = header.sections[i];
+    bool in_segment = extent.offset <= size_ &&
+                      extent.size <= size_ - extent.offset &&
+                      extent.offset % kSectionAlignment == 0;
+    bool expected_size = i < std::size(expected_sizes)
+                             ? extent.size == expected_sizes[i]
+                             : true;
+    if (!in_segment || !expected_size) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "invalid shared graph section {}", i);
+    }
+  }
+  auto section = [&](Section s) { return base + header.sections[s].offset; };
+
+  GraphTopology topo = GraphTopology::MakeInPlace(
+      reinterpret_cast<const GraphTopology::Edge*>(section(kAdjIndices)),
+      num_nodes,
+      reinterpret_cast<const GraphTopology::Node*>(section(kDests)),
+      num_edges, mapping);
+  // NUMAArray only wraps the type ids, it never writes to or frees them
+  auto* node_types = const_cast<uint8_t*>(section(kNodeTypes));  // NOLINT
+  auto* edge_types = const_cast<uint8_t*>(section(kEdgeTypes));  // NOLINT
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(
+      std::move(topo), PropertyGraph::EntityTypeIDArray(node_types, num_nodes),
+      PropertyGraph::EntityTypeIDArray(edge_types, num_edges),
+      KATANA_CHECKED(DeserializeTypeManager(
+          section(kNodeTypeManager), header.sections[kNodeTypeManager].size)),
+      KATANA_CHECKED(DeserializeTypeManager(
+          section(kEdgeTypeManager),
+          header.sections[kEdgeTypeManager].size))));
+
+  // The type ids outlive the topology if it is replaced, so they keep the
+  // mapping too
+  auto keep_mapping = [mapping](PropertyGraph::EntityTypeIDArray* array) {
+    delete array;
+  };
+  pg->node_entity_type_ids_ = std::shared_ptr<PropertyGraph::EntityTypeIDArray>(
+      new PropertyGraph::EntityTypeIDArray(node_types, num_nodes),
+      keep_mapping);
+  pg->edge_entity_type_ids_ = std::shared_ptr<PropertyGraph::EntityTypeIDArray>(
+      new PropertyGraph::EntityTypeIDArray(edge_types, num_edges),
+      keep_mapping);
+  pg->node_entity_data_ = pg->node_entity_type_ids_->data();
+  pg->edge_entity_data_ = pg->edge_entity_type_ids_->data();
+
+  for (Section s : {kNodeProperties, kEdgeProperties}) {
+    uint64_t size = header.sections[s].size;
+    if (size == 0) {
+      continue;
+    }
+    auto buffer = std::make_shared<MappedBuffer>(mapping, section(s), size);
+    std::shared_ptr<arrow::Table> table =
+        KATANA_CHECKED(ReadProperties(buffer));
+    if (s == kNodeProperties) {
+      KATANA_CHECKED(pg->AddNodeProperties(table, txn_ctx));
+    } else {
+      KATANA_CHECKED(pg->AddEdgeProperties(table, txn_ctx));
+    }
+  }
+  return MakeResult(std::move(pg));
+}
@@ -20,11 +20,14 @@
 #include "katana/SharedMemSys.h"
 
 #include "katana/CommBackend.h"
+#include "katana/Env.h"
 #include "katana/Experimental.h"
 #include "katana/FileStorage.h"
 #include "katana/Galois.h"
 #include "katana/GaloisRuntime.h"
 #include "katana/Logging.h"
+#include "katana/Metrics.h"
+#include "katana/OTLPTracer.h"
 #include "katana/Plugin.h"
 #include "katana/Strings.h"
 #include "katana/TextTracer.h"
@@ -38,12 +41,28 @@ katana::NullCommBackend comm_backend;
 
 struct katana::SharedMemSys::Impl {
   katana::GaloisRuntime galois_rt;
+  /// From KATANA_METRICS_PUSH_URL, if set
+  std::unique_ptr<katana::MetricsPusher> metrics_pusher{
+      katana::MetricsPusher::MakeFromEnv()};
 };
 
 katana::SharedMemSys::SharedMemSys(std::unique_ptr<ProgressTracer> tracer)
+    : SharedMemSys(&comm_backend, std::move(tracer)) {}
+
+katana::SharedMemSys::SharedMemSys(
+    CommBackend* comm, std::unique_ptr<ProgressTracer> tracer)
     : impl_(std::make_unique<Impl>()) {
+  // Spans for an OpenTelemetry collector replace those of the given tracer
+  if (std::string path; katana::GetEnv("KATANA_OTLP_TRACES_FILE", &path)) {
+    if (auto otlp_res = katana::OTLPTracer::MakeFile(path); !otlp_res) {
+      KATANA_LOG_WARN("exporting spans to {}: {}", path, otlp_res.error());
+    } else {
+      tracer = std::move(otlp_res.value());
+    }
+  }
+
   LoadPlugins();
-  if (auto init_good = katana::InitTsuba(&comm_backend); !init_good) {
+  if (auto init_good = katana::InitTsuba(comm); !init_good) {
     KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
   }
 
@@ -0,0 +1,290 @@
+#include "katana/SortedIntersection.h"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KATANA_INTERSECTION_X86 1
+#include <immintrin.h>
+#endif
+
+#include "katana/Logging.h"
+
+namespace {
+
+/// Appends to out when it is not null; the counting kernels pass null
+inline void
+Emit(uint32_t value, uint32_t* out, size_t* count) {
+  if (out != nullptr) {
+    out[*count] = value;
+  }
+  ++*count;
+}
+
+size_t
+MergeTail(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out, size_t count) {
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      Emit(a[i], out, &count);
+      ++i;
+      ++j;
+    }
+  }
+  return count;
+}
+
+size_t
+GallopIntersection(
+    const uint32_t* small, size_t small_size, const uint32_t* large,
+    size_t large_size, uint32_t* out) {
+  size_t count = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < small_size && j < large_size; ++i) {
+    j += katana::GallopLowerBound(large + j, large_size - j, small[i]);
+    if (j < large_size && large[j] == small[i]) {
+      Emit(small[i], out, &count);
+      ++j;
+    }
+  }
+  return count;
+}
+
+size_t
+ScalarIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  return MergeTail(a, a_size, b, b_size, out, 0);
+}
+
+#ifdef KATANA_INTERSECTION_X86
+
+// The vector kernels compare a block of kLanes elements of a against every
+// rotation of a block of b, which finds all the matches between the two
+// blocks, then advance past whichever block ends with the smaller element.
+// Since neither range has duplicates, each match is found exactly once.
+
+/// Emits the elements of the block at a whose lanes are set in mask
+inline void
+EmitMask(const uint32_t* a, uint32_t mask, uint32_t* out, size_t* count) {
+  if (out == nullptr) {
+    *count += __builtin_popcount(mask);
+    return;
+  }
+  while (mask != 0) {
+    Emit(a[__builtin_ctz(mask)], out, count);
+    mask &= mask - 1;
+  }
+}
+
+__attribute__((target("sse4.2"))) size_t
+SSE42Intersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  constexpr size_t kLanes = 4;
+  size_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + kLanes <= a_size && j + kLanes <= b_size) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+    __m128i eq = _mm_cmpeq_epi32(va, vb);
+    vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, vb));
+    vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, vb));
+    vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, vb));
+    EmitMask(a + i, _mm_movemask_ps(_mm_castsi128_ps(eq)), out, &count);
+
+    uint32_t a_last = a[i + kLanes - 1];
+    uint32_t b_last = b[j + kLanes - 1];
+    i += a_last <= b_last ? kLanes : 0;
+    j += b_last <= a_last ? kLanes : 0;
+  }
+  return MergeTail(a + i, a_size - i, b + j, b_size - j, out, count);
+}
+
+__attribute__((target("avx2"))) size_t
+AVX2Intersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  constexpr size_t kLanes = 8;
+  const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  size_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + kLanes <= a_size && j + kLanes <= b_size) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+    for (size_t r = 1; r < kLanes; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+    EmitMask(a + i, _mm256_movemask_ps(_mm256_castsi256_ps(eq)), out, &count);
+
+    uint32_t a_last = a[i + kLanes - 1];
+    uint32_t b_last = b[j + kLanes - 1];
+    i += a_last <= b_last ? kLanes : 0;
+    j += b_last <= a_last ? kLanes : 0;
+  }
+  return MergeTail(a + i, a_size - i, b + j, b_size - j, out, count);
+}
+
+__attribute__((target("avx512f"))) size_t
+AVX512Intersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  constexpr size_t kLanes = 16;
+  const __m512i rotate = _mm512_setr_epi32(
+      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0);
+  size_t count = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + kLanes <= a_size && j + kLanes <= b_size) {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + j);
+    __mmask16 eq = _mm512_cmpeq_epi32_mask(va, vb);
+    for (size_t r = 1; r < kLanes; ++r) {
+      // The masked form avoids an undefined source vector, which GCC warns
+      // about
+      vb = _mm512_mask_permutexvar_epi32(vb, 0xFFFF, rotate, vb);
+      eq |= _mm512_cmpeq_epi32_mask(va, vb);
+    }
+    if (out != nullptr) {
+      _mm512_mask_compressstoreu_epi32(out + count, eq, va);
+    }
+    count += __builtin_popcount(eq);
+
+    uint32_t a_last = a[i + kLanes - 1];
+    uint32_t b_last = b[j + kLanes - 1];
+    i += a_last <= b_last ? kLanes : 0;
+    j += b_last <= a_last ? kLanes : 0;
+  }
+  return MergeTail(a + i, a_size - i, b + j, b_size - j, out, count);
+}
+
+#endif
+
+/// Whether [first, first + size) is sorted and free of duplicates
+[[maybe_unused]] bool
+IsStrictlyIncreasing(const uint32_t* first, size_t size) {
+  return std::adjacent_find(
+             first, first + size, std::greater_equal<uint32_t>()) ==
+         first + size;
+}
+
+using IntersectionFn =
+    size_t (*)(const uint32_t*, size_t, const uint32_t*, size_t, uint32_t*);
+
+IntersectionFn
+KernelFn(katana::IntersectionKernel kernel) {
+  switch (kernel) {
+#ifdef KATANA_INTERSECTION_X86
+  case katana::IntersectionKernel::kSSE42:
+    return SSE42Intersection;
+  case katana::IntersectionKernel::kAVX2:
+    return AVX2Intersection;
+  case katana::IntersectionKernel::kAVX512:
+    return AVX512Intersection;
+#endif
+  default:
+    return ScalarIntersection;
+  }
+}
+
+katana::IntersectionKernel
+DetectKernel() {
+  for (auto kernel :
+       {katana::IntersectionKernel::kAVX512, katana::IntersectionKernel::kAVX2,
+        katana::IntersectionKernel::kSSE42}) {
+    if (katana::IsIntersectionKernelSupported(kernel)) {
+      return kernel;
+    }
+  }
+  return katana::IntersectionKernel::kScalar;
+}
+
+size_t
+Intersect(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out, katana::IntersectionKernel kernel) {
+  KATANA_LOG_DEBUG_ASSERT(katana::IsIntersectionKernelSupported(kernel));
+  KATANA_LOG_DEBUG_ASSERT(IsStrictlyIncreasing(a, a_size));
+  KATANA_LOG_DEBUG_ASSERT(IsStrictlyIncreasing(b, b_size));
+  if (a_size == 0 || b_size == 0) {
+    return 0;
+  }
+  // Skewed sizes: merging would touch every element of the longer range
+  if (a_size * katana::kIntersectionGallopRatio < b_size) {
+    return GallopIntersection(a, a_size, b, b_size, out);
+  }
+  if (b_size * katana::kIntersectionGallopRatio < a_size) {
+    return GallopIntersection(b, b_size, a, a_size, out);
+  }
+  return KernelFn(kernel)(a, a_size, b, b_size, out);
+}
+
+}  // namespace
+
+bool
+katana::IsIntersectionKernelSupported(IntersectionKernel kernel) noexcept {
+  switch (kernel) {
+  case IntersectionKernel::kScalar:
+    return true;
+#ifdef KATANA_INTERSECTION_X86
+  case IntersectionKernel::kSSE42:
+    return __builtin_cpu_supports("sse4.2");
+  case IntersectionKernel::kAVX2:
+    return __builtin_cpu_supports("avx2");
+  case IntersectionKernel::kAVX512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+katana::IntersectionKernel
+katana::SelectedIntersectionKernel() noexcept {
+  static const IntersectionKernel kernel = DetectKernel();
+  return kernel;
+}
+
+size_t
+katana::SortedIntersectionCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b,
+    size_t b_size) noexcept {
+  return Intersect(
+      a, a_size, b, b_size, nullptr, SelectedIntersectionKernel());
+}
+
+size_t
+katana::SortedIntersectionCount(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    IntersectionKernel kernel) noexcept {
+  return Intersect(a, a_size, b, b_size, nullptr, kernel);
+}
+
+size_t
+katana::SortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) noexcept {
+  return Intersect(a, a_size, b, b_size, out, SelectedIntersectionKernel());
+}
+
+size_t
+katana::SortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out, IntersectionKernel kernel) noexcept {
+  return Intersect(a, a_size, b, b_size, out, kernel);
+}
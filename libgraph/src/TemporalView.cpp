@@ -0,0 +1,55 @@
+#include "katana/TemporalView.h"
+
+#include <iomanip>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PropertyGraph.h"
+
+katana::Result<katana::TemporalView>
+katana::TemporalView::Make(
+    PropertyGraph* pg, const std::string& timestamp_property,
+    RDGTopology::TransposeKind tpose_todo) {
+  std::shared_ptr<arrow::ChunkedArray> column =
+      KATANA_CHECKED(pg->GetEdgeProperty(timestamp_property));
+  const auto& type = column->type();
+  if (!arrow::is_integer(type->id()) && type->id() != arrow::Type::TIMESTAMP) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "timestamp property {} is of type {}, not an integer or timestamp",
+        std::quoted(timestamp_property), type->ToString());
+  }
+  auto cast = KATANA_CHECKED_CONTEXT(
+      arrow::compute::Cast(
+          *KATANA_CHECKED(ContiguousArray(*column)), arrow::int64()),
+      "property {}",
+      std::quoted(timestamp_property));
+  auto values = std::static_pointer_cast<arrow::Int64Array>(cast);
+
+  // timestamps by property index, for sorting
+  const uint64_t num_rows = values->length();
+  std::vector<Timestamp> keys(num_rows);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_rows),
+      [&](uint64_t i) {
+        keys[i] = values->IsValid(i) ? values->Value(i) : kMaxTimestamp;
+      },
+      katana::no_stats());
+
+  std::shared_ptr<const EdgeShuffleTopology> topo =
+      EdgeShuffleTopology::MakeSortedByEdgeKey(pg, tpose_todo, keys);
+
+  // and by edge id, for the binary searches of OutEdges
+  auto times = std::make_shared<std::vector<Timestamp>>(topo->NumEdges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topo->NumEdges()),
+      [&](uint64_t e) {
+        (*times)[e] = keys[topo->GetEdgePropertyIndexFromOutEdge(e)];
+      },
+      katana::no_stats());
+
+  return TemporalView(std::move(topo), std::move(times));
+}
@@ -0,0 +1,147 @@
+#include "katana/TiledTopology.h"
+
+#include <algorithm>
+
+namespace {
+
+using Node = katana::TiledTopology::Node;
+using PropertyIndex = katana::TiledTopology::PropertyIndex;
+
+struct Entry {
+  Node dst;
+  Node src;
+  PropertyIndex property_index;
+};
+
+/// A tile while it is built: its edges are entries [entry_begin, entry_begin
+/// + num_edges) of its source block
+struct PendingTile {
+  uint32_t src_block;
+  uint32_t dst_block;
+  uint64_t entry_begin;
+  uint64_t num_edges;
+  /// The number of destinations with edges
+  uint32_t num_rows;
+};
+
+}  // namespace
+
+katana::TiledTopology
+katana::TiledTopology::Make(const GraphTopology& topo, uint32_t block_size) {
+  KATANA_LOG_DEBUG_ASSERT(block_size > 0);
+  TiledTopology tiled;
+  tiled.num_nodes_ = topo.NumNodes();
+  tiled.block_size_ = block_size;
+  const auto num_blocks =
+      static_cast<uint32_t>((tiled.num_nodes_ + block_size - 1) / block_size);
+
+  // the edges out of every source block, by destination then source, cut
+  // into tiles
+  std::vector<std::vector<Entry>> entries(num_blocks);
+  std::vector<std::vector<PendingTile>> pending(num_blocks);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_blocks),
+      [&](uint32_t src_block) {
+        std::vector<Entry>& block_entries = entries[src_block];
+        for (Node src = tiled.BlockBegin(src_block);
+             src < tiled.BlockEnd(src_block); ++src) {
+          for (auto e : topo.OutEdges(src)) {
+            block_entries.emplace_back(Entry{
+                topo.OutEdgeDst(e), src,
+                topo.GetEdgePropertyIndexFromOutEdge(e)});
+          }
+        }
+        // entries are already by source
+        std::stable_sort(
+            block_entries.begin(), block_entries.end(),
+            [](const Entry& a, const Entry& b) { return a.dst < b.dst; });
+
+        for (uint64_t i = 0; i < block_entries.size();) {
+          PendingTile tile{
+              src_block, block_entries[i].dst / block_size, i, 0, 0};
+          uint64_t j = i;
+          for (; j < block_entries.size() &&
+                 block_entries[j].dst / block_size == tile.dst_block;
+               ++j) {
+            if (j == i || block_entries[j].dst != block_entries[j - 1].dst) {
+              ++tile.num_rows;
+            }
+          }
+          tile.num_edges = j - i;
+          pending[src_block].emplace_back(tile);
+          i = j;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<PendingTile> all_pending;
+  for (const auto& block_pending : pending) {
+    all_pending.insert(
+        all_pending.end(), block_pending.begin(), block_pending.end());
+  }
+  std::sort(
+      all_pending.begin(), all_pending.end(),
+      [](const PendingTile& a, const PendingTile& b) {
+        return std::make_pair(a.dst_block, a.src_block) <
+               std::make_pair(b.dst_block, b.src_block);
+      });
+
+  std::vector<uint64_t> edge_begins;
+  uint64_t num_edges = 0;
+  uint64_t num_row_offsets = 0;
+  uint64_t num_sparse_rows = 0;
+  tiled.column_begins_.assign(num_blocks + 1, 0);
+  for (const PendingTile& p : all_pending) {
+    const uint32_t width =
+        tiled.BlockEnd(p.dst_block) - tiled.BlockBegin(p.dst_block);
+    const bool dense = uint64_t{p.num_rows} * kDenseTileDivisor > width;
+    const uint32_t num_rows = dense ? width : p.num_rows;
+    tiled.tiles_.emplace_back(Tile{
+        p.src_block, p.dst_block, dense, num_rows, num_row_offsets,
+        num_sparse_rows});
+    edge_begins.emplace_back(num_edges);
+    num_edges += p.num_edges;
+    num_row_offsets += num_rows + 1;
+    num_sparse_rows += dense ? 0 : num_rows;
+    ++tiled.column_begins_[p.dst_block + 1];
+  }
+  for (uint32_t b = 0; b < num_blocks; ++b) {
+    tiled.column_begins_[b + 1] += tiled.column_begins_[b];
+  }
+  KATANA_LOG_DEBUG_ASSERT(num_edges == topo.NumEdges());
+
+  tiled.row_offsets_.allocateInterleaved(num_row_offsets);
+  tiled.row_dsts_.allocateInterleaved(num_sparse_rows);
+  tiled.srcs_.allocateInterleaved(num_edges);
+  tiled.property_indices_.allocateInterleaved(num_edges);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{tiled.tiles_.size()}),
+      [&](uint64_t t) {
+        const Tile& tile = tiled.tiles_[t];
+        const PendingTile& p = all_pending[t];
+        const Entry* tile_entries = &entries[p.src_block][p.entry_begin];
+        const uint64_t edge_begin = edge_begins[t];
+        const Node block_begin = tiled.BlockBegin(tile.dst_block);
+
+        uint64_t k = 0;
+        for (uint32_t r = 0; r < tile.num_rows; ++r) {
+          Node dst = block_begin + r;
+          if (!tile.dense) {
+            dst = tile_entries[k].dst;
+            tiled.row_dsts_[tile.sparse_row_begin + r] = dst;
+          }
+          tiled.row_offsets_[tile.row_begin + r] = edge_begin + k;
+          for (; k < p.num_edges && tile_entries[k].dst == dst; ++k) {
+            tiled.srcs_[edge_begin + k] = tile_entries[k].src;
+            tiled.property_indices_[edge_begin + k] =
+                tile_entries[k].property_index;
+          }
+        }
+        tiled.row_offsets_[tile.row_begin + tile.num_rows] =
+            edge_begin + p.num_edges;
+      },
+      katana::steal(), katana::no_stats());
+
+  return tiled;
+}
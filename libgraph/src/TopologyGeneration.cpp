@@ -1,5 +1,14 @@
 #include "katana/TopologyGeneration.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Random.h"
+
 namespace {
 template <typename F>
 std::unique_ptr<katana::PropertyGraph>
@@ -12,6 +21,210 @@ MakeTopologyImpl(F builder_fun) {
   KATANA_LOG_ASSERT(res);
   return std::move(res.value());
 }
+
+/// Edges or nodes generated from one random number stream
+constexpr uint64_t kGenerationBlock = uint64_t{1} << 16;
+
+/// The streams of random numbers of a seed
+enum Stream : uint32_t {
+  kEdgeStream,
+  kNodeTypeStream,
+  kEdgeTypeStream,
+};
+
+/// The random number generator of a block of a stream of seed
+katana::RandGenerator
+BlockGenerator(uint64_t seed, Stream stream, uint64_t block) {
+  katana::Seed words{
+      static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), stream,
+      static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32)};
+  return katana::CreateGenerator(words).first;
+}
+
+/// A bijection of the ids [0, 2^scale) that scatters neighbouring ids:
+/// multiplying by an odd number and xoring with a right shift are both
+/// invertible modulo 2^scale.
+class IdScrambler {
+public:
+  IdScrambler(uint32_t scale, uint64_t seed)
+      : mask_((uint64_t{1} << scale) - 1),
+        shift_(std::max(scale / 2, 1U)),
+        mul1_(katana::StatelessRandom(seed, 0) | 1),
+        mul2_(katana::StatelessRandom(seed, 1) | 1) {}
+
+  uint64_t operator()(uint64_t id) const {
+    id = (id * mul1_) & mask_;
+    id ^= id >> shift_;
+    id = (id * mul2_) & mask_;
+    return id ^ (id >> shift_);
+  }
+
+private:
+  uint64_t mask_;
+  uint32_t shift_;
+  uint64_t mul1_;
+  uint64_t mul2_;
+};
+
+/// Sort the edges of each node of the topology of adj_indices and dests by
+/// destination
+void
+SortEdges(
+    const katana::GraphTopology::AdjIndexVec& adj_indices,
+    katana::GraphTopology::EdgeDestVec* dests) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, adj_indices.size()),
+      [&](uint64_t n) {
+        uint64_t begin = n == 0 ? 0 : adj_indices[n - 1];
+        std::sort(dests->begin() + begin, dests->begin() + adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// The topology of the edges srcs[e] -> dests[e] of num_nodes nodes
+katana::GraphTopology
+MakeCSR(
+    uint64_t num_nodes, const katana::NUMAArray<uint32_t>& srcs,
+    const katana::NUMAArray<uint32_t>& dests) {
+  using Edge = katana::GraphTopology::Edge;
+  uint64_t num_edges = srcs.size();
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(adj_indices.begin(), adj_indices.end(), Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { __sync_fetch_and_add(&adj_indices[srcs[e]], 1); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  // the next free position of the edges of each node
+  katana::NUMAArray<Edge> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = n == 0 ? 0 : adj_indices[n - 1]; },
+      katana::no_stats());
+
+  katana::GraphTopology::EdgeDestVec out_dests;
+  out_dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        out_dests[__sync_fetch_and_add(&cursors[srcs[e]], 1)] = dests[e];
+      },
+      katana::no_stats());
+  // positions are claimed in any order, so the edges of a node are sorted
+  // to make the graph independent of the schedule
+  SortEdges(adj_indices, &out_dests);
+
+  return katana::GraphTopology{std::move(adj_indices), std::move(out_dests)};
+}
+
+katana::Result<katana::GraphTopology>
+MakeRMATTopology(const katana::RMATParameters& params) {
+  if (params.scale > 31) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "scale {} has more nodes than node ids", params.scale);
+  }
+  double d = 1.0 - params.a - params.b - params.c;
+  if (params.a < 0 || params.b < 0 || params.c < 0 || d < -1e-9) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "quadrant probabilities a {}, b {} and c {} are not a distribution",
+        params.a, params.b, params.c);
+  }
+  uint64_t num_nodes = uint64_t{1} << params.scale;
+  if (params.edge_factor >
+      std::numeric_limits<uint64_t>::max() / num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge factor {} is too large",
+        params.edge_factor);
+  }
+  uint64_t num_edges = num_nodes * params.edge_factor;
+
+  katana::NUMAArray<uint32_t> srcs;
+  srcs.allocateInterleaved(num_edges);
+  katana::NUMAArray<uint32_t> dests;
+  dests.allocateInterleaved(num_edges);
+  IdScrambler scramble(params.scale, params.seed);
+  double ab = params.a + params.b;
+  double abc = ab + params.c;
+
+  uint64_t num_blocks = (num_edges + kGenerationBlock - 1) / kGenerationBlock;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        katana::RandGenerator gen =
+            BlockGenerator(params.seed, kEdgeStream, block);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        uint64_t end = std::min((block + 1) * kGenerationBlock, num_edges);
+        for (uint64_t e = block * kGenerationBlock; e < end; ++e) {
+          uint64_t src = 0;
+          uint64_t dst = 0;
+          for (uint32_t level = 0; level < params.scale; ++level) {
+            double r = unit(gen);
+            src = (src << 1) | (r >= ab);
+            dst = (dst << 1) | ((r >= params.a && r < ab) || r >= abc);
+          }
+          if (params.scramble_ids) {
+            src = scramble(src);
+            dst = scramble(dst);
+          }
+          srcs[e] = src;
+          dests[e] = dst;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return MakeCSR(num_nodes, srcs, dests);
+}
+
+/// Set types[i] to one of type_ids, the jth with probability proportional
+/// to 1 / (j + 1)^skew
+void
+AssignTypes(
+    const std::vector<katana::EntityTypeID>& type_ids, double skew,
+    uint64_t seed, Stream stream,
+    katana::PropertyGraph::EntityTypeIDArray* types) {
+  std::vector<double> cdf(type_ids.size());
+  double total = 0;
+  for (size_t j = 0; j < type_ids.size(); ++j) {
+    total += 1.0 / std::pow(static_cast<double>(j + 1), skew);
+    cdf[j] = total;
+  }
+
+  uint64_t num = types->size();
+  uint64_t num_blocks = (num + kGenerationBlock - 1) / kGenerationBlock;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        katana::RandGenerator gen = BlockGenerator(seed, stream, block);
+        std::uniform_real_distribution<double> share(0.0, total);
+        uint64_t end = std::min((block + 1) * kGenerationBlock, num);
+        for (uint64_t i = block * kGenerationBlock; i < end; ++i) {
+          size_t j = std::upper_bound(cdf.begin(), cdf.end(), share(gen)) -
+                     cdf.begin();
+          (*types)[i] = type_ids[std::min(j, type_ids.size() - 1)];
+        }
+      },
+      katana::no_stats());
+}
+
+katana::Result<std::vector<katana::EntityTypeID>>
+AddTypes(
+    const std::string& prefix, uint32_t num_types,
+    katana::EntityTypeManager* manager) {
+  std::vector<katana::EntityTypeID> type_ids;
+  for (uint32_t j = 0; j < num_types; ++j) {
+    type_ids.emplace_back(KATANA_CHECKED(
+        manager->AddAtomicEntityType(fmt::format("{}{}", prefix, j))));
+  }
+  return type_ids;
+}
+
 }  // namespace
 
 namespace katana {
@@ -176,4 +389,98 @@ MakeTriangle(size_t num_rows) noexcept {
   });
 }
 
+Result<std::unique_ptr<katana::PropertyGraph>>
+MakeRMAT(const RMATParameters& params) {
+  GraphTopology topo = KATANA_CHECKED(MakeRMATTopology(params));
+  return katana::PropertyGraph::Make(std::move(topo));
+}
+
+Result<std::unique_ptr<katana::PropertyGraph>>
+MakeBarabasiAlbert(uint64_t num_nodes, uint64_t edges_per_node, uint64_t seed) {
+  if (num_nodes > std::numeric_limits<GraphTopology::Node>::max() ||
+      (num_nodes > 0 &&
+       edges_per_node > std::numeric_limits<uint64_t>::max() / 2 / num_nodes)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} nodes of {} edges are too many",
+        num_nodes, edges_per_node);
+  }
+  uint64_t num_edges = num_nodes * edges_per_node;
+
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { adj_indices[n] = (n + 1) * edges_per_node; },
+      katana::no_stats());
+
+  /*
+  Edge e, of node e / edges_per_node, attaches to one of the 2e endpoints of
+  the edges before it, chosen uniformly, so nodes are chosen in proportion to
+  their degrees. Endpoint 2k is the source of edge k, which is known, and
+  2k + 1 its destination, which is drawn the same way, so no edge waits for
+  another.
+  */
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        uint64_t k = e;
+        uint64_t endpoint = 0;
+        while (k > 0) {
+          endpoint = StatelessRandom(seed, k) % (2 * k);
+          k = endpoint / 2;
+          if (endpoint % 2 == 0) {
+            break;
+          }
+        }
+        dests[e] = endpoint / 2 / edges_per_node;
+      },
+      katana::no_stats());
+  SortEdges(adj_indices, &dests);
+
+  return katana::PropertyGraph::Make(
+      GraphTopology{std::move(adj_indices), std::move(dests)});
+}
+
+Result<std::unique_ptr<katana::PropertyGraph>>
+MakeTypedGraph(const TypedGraphParameters& params) {
+  constexpr uint32_t kMaxTypes = std::numeric_limits<EntityTypeID>::max() - 1;
+  if (params.num_node_types == 0 || params.num_edge_types == 0 ||
+      params.num_node_types > kMaxTypes || params.num_edge_types > kMaxTypes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} node types and {} edge types are not between 1 and {}",
+        params.num_node_types, params.num_edge_types, kMaxTypes);
+  }
+  if (params.type_skew < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "type skew {} is negative",
+        params.type_skew);
+  }
+  GraphTopology topo = KATANA_CHECKED(MakeRMATTopology(params.topology));
+
+  EntityTypeManager node_type_manager;
+  EntityTypeManager edge_type_manager;
+  std::vector<EntityTypeID> node_type_ids = KATANA_CHECKED(
+      AddTypes("node_type_", params.num_node_types, &node_type_manager));
+  std::vector<EntityTypeID> edge_type_ids = KATANA_CHECKED(
+      AddTypes("edge_type_", params.num_edge_types, &edge_type_manager));
+
+  PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(topo.NumNodes());
+  AssignTypes(
+      node_type_ids, params.type_skew, params.topology.seed, kNodeTypeStream,
+      &node_types);
+  PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(topo.NumEdges());
+  AssignTypes(
+      edge_type_ids, params.type_skew, params.topology.seed, kEdgeTypeStream,
+      &edge_types);
+
+  return katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_types), std::move(edge_types),
+      std::move(node_type_manager), std::move(edge_type_manager));
+}
+
 }  // namespace katana
@@ -0,0 +1,143 @@
+#include "katana/TypeSegmentedProperties.h"
+
+#include <utility>
+
+#include <arrow/compute/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Number of bytes of the buffers of data and its children
+uint64_t
+BufferSize(const arrow::ArrayData& data) {
+  uint64_t size = 0;
+  for (const auto& buffer : data.buffers) {
+    if (buffer) {
+      size += buffer->size();
+    }
+  }
+  for (const auto& child : data.child_data) {
+    size += BufferSize(*child);
+  }
+  return size;
+}
+
+}  // namespace
+
+katana::Result<katana::TypeSegmentedNodeProperties>
+katana::TypeSegmentedNodeProperties::Make(const PropertyGraph& pg) {
+  return Make(pg, pg.loaded_node_schema()->field_names());
+}
+
+katana::Result<katana::TypeSegmentedNodeProperties>
+katana::TypeSegmentedNodeProperties::Make(
+    const PropertyGraph& pg, const std::vector<std::string>& properties) {
+  katana::StatTimer timer("Make", "TypeSegmentedNodeProperties");
+  timer.start();
+
+  uint64_t num_nodes = pg.NumNodes();
+  TypeSegmentedNodeProperties storage;
+  storage.local_index_.allocateBlocked(num_nodes);
+
+  // One pass in order of node id numbers the nodes of every type, so that
+  // the rows of a segment are in the order of its nodes
+  std::vector<uint32_t>& segment_of_type = storage.segment_of_type_;
+  segment_of_type.assign(
+      pg.GetNodeTypeManager().GetNumEntityTypes(), kNoSegment);
+  std::vector<uint32_t> num_nodes_of_type(segment_of_type.size(), 0);
+  for (Node n = 0; n < num_nodes; ++n) {
+    EntityTypeID type = pg.GetTypeOfNode(n);
+    if (type >= num_nodes_of_type.size()) {
+      num_nodes_of_type.resize(type + 1, 0);
+      segment_of_type.resize(type + 1, kNoSegment);
+    }
+    storage.local_index_[n] = num_nodes_of_type[type]++;
+  }
+
+  std::vector<Segment>& segments = storage.segments_;
+  for (size_t type = 0; type < num_nodes_of_type.size(); ++type) {
+    if (num_nodes_of_type[type] > 0) {
+      segment_of_type[type] = segments.size();
+      Segment segment;
+      segment.type = static_cast<EntityTypeID>(type);
+      segment.nodes.resize(num_nodes_of_type[type]);
+      segments.emplace_back(std::move(segment));
+    }
+  }
+
+  // The property rows of the nodes of every segment, by local index
+  std::vector<NUMAArray<uint64_t>> rows(segments.size());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    rows[i].allocateBlocked(segments[i].nodes.size());
+  }
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(num_nodes)),
+      [&](Node n) {
+        uint32_t segment = segment_of_type[pg.GetTypeOfNode(n)];
+        uint32_t index = storage.local_index_[n];
+        segments[segment].nodes[index] = n;
+        rows[segment][index] = pg.GetNodePropertyIndex(n);
+      },
+      katana::no_stats());
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : properties) {
+    columns.emplace_back(KATANA_CHECKED(pg.GetNodeProperty(name)));
+  }
+
+  // Every column of every segment is taken by its own kernel, and those of
+  // the segments none of whose nodes have the property are dropped
+  size_t num_columns = columns.size();
+  std::vector<arrow::Result<arrow::Datum>> taken(
+      segments.size() * num_columns);
+  katana::do_all(
+      katana::iterate(size_t{0}, taken.size()),
+      [&](size_t i) {
+        const NUMAArray<uint64_t>& segment_rows = rows[i / num_columns];
+        // the indices only have to live as long as the kernel, so they are
+        // wrapped rather than copied
+        auto indices = std::make_shared<arrow::UInt64Array>(
+            segment_rows.size(),
+            arrow::Buffer::Wrap(segment_rows.data(), segment_rows.size()));
+        taken[i] = arrow::compute::Take(
+            arrow::Datum(columns[i % num_columns]), arrow::Datum(indices));
+      },
+      katana::steal(), katana::loopname("TypeSegmentedNodeProperties-Take"));
+
+  for (size_t s = 0; s < segments.size(); ++s) {
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> segment_columns;
+    for (size_t c = 0; c < num_columns; ++c) {
+      std::shared_ptr<arrow::ChunkedArray> column =
+          KATANA_CHECKED(std::move(taken[s * num_columns + c])).chunked_array();
+      if (column->null_count() == column->length()) {
+        continue;
+      }
+      fields.emplace_back(arrow::field(properties[c], column->type()));
+      segment_columns.emplace_back(std::move(column));
+    }
+    segments[s].properties = arrow::Table::Make(
+        arrow::schema(fields), segment_columns, segments[s].nodes.size());
+  }
+
+  timer.stop();
+  KATANA_LOG_VERBOSE(
+      "type segmented properties of {} nodes: {} segments, {} bytes",
+      num_nodes, segments.size(), storage.SizeInBytes());
+  return storage;
+}
+
+uint64_t
+katana::TypeSegmentedNodeProperties::SizeInBytes() const {
+  uint64_t size = 0;
+  for (const Segment& segment : segments_) {
+    for (const auto& column : segment.properties->columns()) {
+      for (const auto& chunk : column->chunks()) {
+        size += BufferSize(*chunk->data());
+      }
+    }
+  }
+  return size;
+}
@@ -0,0 +1,112 @@
+#include "katana/analytics/AsyncAnalytics.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "katana/ErrorCode.h"
+#include "katana/ThreadGroup.h"
+
+namespace katana::analytics::internal {
+
+/// What an analytic shares with its handle
+struct AnalyticsJobState {
+  AnalyticsProgressCallback on_progress;
+  std::atomic<bool> cancelled{false};
+  std::mutex mutex;
+  std::optional<AnalyticsProgress> last_progress;
+};
+
+}  // namespace katana::analytics::internal
+
+namespace {
+
+using katana::analytics::internal::AnalyticsJobState;
+
+/// The job of the analytic the thread runs, if it runs one
+thread_local AnalyticsJobState* current_job = nullptr;
+
+/// Held while a launched analytic runs, so that they run one at a time
+std::mutex launch_mutex;
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::CheckProgress(const AnalyticsProgress& progress) {
+  AnalyticsJobState* job = current_job;
+  if (job == nullptr) {
+    return ResultSuccess();
+  }
+  {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->last_progress = progress;
+  }
+  if (job->on_progress) {
+    job->on_progress(progress);
+  }
+  if (job->cancelled.load(std::memory_order_relaxed)) {
+    return KATANA_ERROR(
+        ErrorCode::Cancelled, "{} cancelled after {} rounds",
+        progress.analytic, progress.iteration);
+  }
+  return ResultSuccess();
+}
+
+katana::analytics::AnalyticsHandle::~AnalyticsHandle() {
+  if (result_.valid()) {
+    Cancel();
+    result_.wait();
+  }
+}
+
+void
+katana::analytics::AnalyticsHandle::Cancel() {
+  state_->cancelled.store(true, std::memory_order_relaxed);
+}
+
+bool
+katana::analytics::AnalyticsHandle::IsDone() const {
+  return !result_.valid() || result_.wait_for(std::chrono::seconds(0)) ==
+                                 std::future_status::ready;
+}
+
+std::optional<katana::analytics::AnalyticsProgress>
+katana::analytics::AnalyticsHandle::LastProgress() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->last_progress;
+}
+
+katana::Result<void>
+katana::analytics::AnalyticsHandle::Wait() {
+  if (!result_.valid()) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed, "analytic was already waited for");
+  }
+  return result_.get();
+}
+
+katana::analytics::AnalyticsHandle
+katana::analytics::LaunchAnalytics(
+    std::function<Result<void>()> analytic,
+    AnalyticsProgressCallback on_progress, unsigned num_threads) {
+  auto state = std::make_shared<AnalyticsJobState>();
+  state->on_progress = std::move(on_progress);
+  auto start = [state, analytic = std::move(analytic)]() -> Result<void> {
+    if (state->cancelled.load(std::memory_order_relaxed)) {
+      return KATANA_ERROR(ErrorCode::Cancelled, "cancelled before it started");
+    }
+    current_job = state.get();
+    Result<void> res = analytic();
+    current_job = nullptr;
+    return res;
+  };
+  auto run = [start = std::move(start), num_threads]() -> Result<void> {
+    if (num_threads == 0) {
+      std::lock_guard<std::mutex> lock(launch_mutex);
+      return start();
+    }
+    ThreadGroupLease lease = KATANA_CHECKED(LeaseThreadGroup(num_threads));
+    return lease.Run(start);
+  };
+  return AnalyticsHandle(state, std::async(std::launch::async, std::move(run)));
+}
@@ -0,0 +1,222 @@
+#include "katana/analytics/Checkpoint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "katana/ContentHash.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+
+namespace {
+
+/// "KCKPT001": the format of the checkpoint files
+constexpr uint64_t kCheckpointMagic = 0x31303054504b434bULL;
+
+/// The bytes a task of the parallel copies copies
+constexpr uint64_t kCopyChunkSize = uint64_t{1} << 20;
+
+/// The start of a checkpoint file. The sizes of the buffers follow it, and
+/// then their contents, one after another.
+struct CheckpointHeader {
+  uint64_t magic;
+  uint64_t key_hash;
+  uint64_t round;
+  uint64_t num_buffers;
+  uint64_t contents_size;
+  uint64_t contents_hash;
+};
+
+uint64_t
+HeaderSize(uint64_t num_buffers) {
+  return sizeof(CheckpointHeader) + num_buffers * sizeof(uint64_t);
+}
+
+uint64_t
+TotalSize(const std::vector<katana::analytics::CheckpointBuffer>& buffers) {
+  uint64_t total = 0;
+  for (const auto& buffer : buffers) {
+    total += buffer.size;
+  }
+  return total;
+}
+
+/// Copy size bytes in parallel
+void
+ParallelCopy(void* dest, const void* src, uint64_t size) {
+  uint64_t num_chunks = (size + kCopyChunkSize - 1) / kCopyChunkSize;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_chunks),
+      [&](uint64_t chunk) {
+        uint64_t begin = chunk * kCopyChunkSize;
+        uint64_t end = std::min(size, begin + kCopyChunkSize);
+        std::memcpy(
+            static_cast<char*>(dest) + begin,
+            static_cast<const char*>(src) + begin, end - begin);
+      },
+      katana::no_stats());
+}
+
+/// The checkpoint stored at path, if it is one of the run of key_hash with
+/// buffers of the given sizes and its contents are intact
+katana::Result<std::optional<std::vector<uint8_t>>>
+ReadCheckpoint(
+    const std::string& path, uint64_t key_hash,
+    const std::vector<katana::analytics::CheckpointBuffer>& buffers) {
+  katana::StatBuf stat;
+  if (!katana::FileStat(path, &stat)) {
+    return std::nullopt;
+  }
+  uint64_t header_size = HeaderSize(buffers.size());
+  uint64_t expected_size = header_size + TotalSize(buffers);
+  if (stat.size != expected_size) {
+    KATANA_LOG_WARN(
+        "skipping checkpoint {}: it has {} bytes rather than {}", path,
+        stat.size, expected_size);
+    return std::nullopt;
+  }
+
+  std::vector<uint8_t> data(stat.size);
+  KATANA_CHECKED_CONTEXT(
+      katana::FileGet(path, data.data(), 0, data.size()), "reading {}", path);
+  CheckpointHeader header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kCheckpointMagic || header.key_hash != key_hash ||
+      header.num_buffers != buffers.size() ||
+      header.contents_size != stat.size - header_size) {
+    KATANA_LOG_WARN("skipping checkpoint {}: it is of another run", path);
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    uint64_t size = 0;
+    std::memcpy(
+        &size, data.data() + sizeof(header) + i * sizeof(uint64_t),
+        sizeof(size));
+    if (size != buffers[i].size) {
+      KATANA_LOG_WARN(
+          "skipping checkpoint {}: buffer {} has {} bytes rather than {}",
+          path, i, size, buffers[i].size);
+      return std::nullopt;
+    }
+  }
+  uint64_t contents_hash = katana::ContentHash::HashBytes(
+      data.data() + header_size, header.contents_size);
+  if (contents_hash != header.contents_hash) {
+    KATANA_LOG_WARN("skipping checkpoint {}: its contents are damaged", path);
+    return std::nullopt;
+  }
+  return std::make_optional(std::move(data));
+}
+
+}  // namespace
+
+katana::analytics::Checkpointer::Checkpointer(
+    CheckpointOptions options, const std::string& key)
+    : options_(std::move(options)),
+      key_hash_(katana::ContentHash::HashBytes(key.data(), key.size())) {}
+
+katana::analytics::Checkpointer::~Checkpointer() {
+  if (auto res = Finish(); !res) {
+    KATANA_LOG_ERROR("writing checkpoint: {}", res.error());
+  }
+}
+
+std::string
+katana::analytics::Checkpointer::SlotPath(uint32_t slot) const {
+  return katana::Uri::JoinPath(
+      options_.dir, fmt::format("checkpoint-{}.bin", slot));
+}
+
+katana::Result<std::optional<uint64_t>>
+katana::analytics::Checkpointer::Restore(
+    const std::vector<CheckpointBuffer>& buffers) {
+  if (!options_.enabled()) {
+    return std::nullopt;
+  }
+  KATANA_CHECKED(Finish());
+
+  std::optional<std::vector<uint8_t>> latest;
+  uint64_t latest_round = 0;
+  for (uint32_t slot = 0; slot < 2; ++slot) {
+    auto data =
+        KATANA_CHECKED(ReadCheckpoint(SlotPath(slot), key_hash_, buffers));
+    if (!data) {
+      continue;
+    }
+    CheckpointHeader header;
+    std::memcpy(&header, data->data(), sizeof(header));
+    if (!latest || header.round > latest_round) {
+      latest = std::move(data);
+      latest_round = header.round;
+      // the other file holds the older checkpoint, overwrite that next
+      next_slot_ = 1 - slot;
+    }
+  }
+  if (!latest) {
+    return std::nullopt;
+  }
+
+  const uint8_t* contents = latest->data() + HeaderSize(buffers.size());
+  for (const auto& buffer : buffers) {
+    ParallelCopy(buffer.data, contents, buffer.size);
+    contents += buffer.size;
+  }
+  return std::make_optional(latest_round);
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Save(
+    uint64_t round, const std::vector<CheckpointBuffer>& buffers) {
+  if (!options_.enabled() || options_.interval == 0 ||
+      round % options_.interval != 0) {
+    return katana::ResultSuccess();
+  }
+  KATANA_CHECKED_CONTEXT(Finish(), "writing the previous checkpoint");
+
+  uint64_t header_size = HeaderSize(buffers.size());
+  uint64_t contents_size = TotalSize(buffers);
+  snapshot_.resize(header_size + contents_size);
+  uint8_t* contents = snapshot_.data() + header_size;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    std::memcpy(
+        snapshot_.data() + sizeof(CheckpointHeader) + i * sizeof(uint64_t),
+        &buffers[i].size, sizeof(uint64_t));
+    ParallelCopy(contents, buffers[i].data, buffers[i].size);
+    contents += buffers[i].size;
+  }
+
+  // hashing and writing happen on a thread of their own, while the analytic
+  // goes on with the next rounds
+  write_ = std::async(
+      std::launch::async,
+      [this, round, header_size, contents_size,
+       path = SlotPath(next_slot_)]() -> katana::CopyableResult<void> {
+        CheckpointHeader header{
+            kCheckpointMagic,
+            key_hash_,
+            round,
+            (header_size - sizeof(CheckpointHeader)) / sizeof(uint64_t),
+            contents_size,
+            katana::ContentHash::HashBytes(
+                snapshot_.data() + header_size, contents_size)};
+        std::memcpy(snapshot_.data(), &header, sizeof(header));
+        KATANA_CHECKED_CONTEXT(
+            katana::FileStore(path, snapshot_.data(), snapshot_.size()),
+            "storing checkpoint {}", path);
+        return katana::CopyableResultSuccess();
+      });
+  next_slot_ = 1 - next_slot_;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Finish() {
+  if (!write_.valid()) {
+    return katana::ResultSuccess();
+  }
+  KATANA_CHECKED(write_.get());
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,31 @@
+#include "katana/analytics/GpuAnalytics.h"
+
+#include <atomic>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+std::atomic<katana::analytics::GpuAnalytics*> registered_gpu{nullptr};
+
+}  // namespace
+
+katana::DeviceTopologyCache::~DeviceTopologyCache() = default;
+
+katana::analytics::GpuAnalytics::~GpuAnalytics() = default;
+
+void
+katana::analytics::RegisterGpuAnalytics(GpuAnalytics* gpu) {
+  registered_gpu.store(gpu);
+}
+
+katana::Result<katana::analytics::GpuAnalytics*>
+katana::analytics::GetGpuAnalytics() {
+  GpuAnalytics* gpu = registered_gpu.load();
+  if (gpu == nullptr) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "GPU plans need the GPU analytics plugin, which is not loaded");
+  }
+  return gpu;
+}
@@ -0,0 +1,134 @@
+#include "katana/analytics/Planner.h"
+
+#include <algorithm>
+
+#include "katana/Logging.h"
+
+namespace {
+
+using katana::GraphStatistics;
+
+/// Whether some adjacency lists are long enough to be split into tiles
+bool
+HasLongAdjacencies(const GraphStatistics& stats, ptrdiff_t edge_tile_size) {
+  return stats.max_degree > static_cast<uint64_t>(edge_tile_size);
+}
+
+/// Whether the graph has nodes that the hub bitmap views keep bitmaps for
+bool
+HasHubs(const GraphStatistics& stats) {
+  return stats.power_law &&
+         stats.max_degree >= std::max<uint64_t>(stats.num_nodes / 32, 1);
+}
+
+void
+LogChoice(
+    const char* analytic, const char* choice, const char* reason,
+    const GraphStatistics& stats) {
+  KATANA_LOG_VERBOSE(
+      "{} plan: {}, since {} ({})", analytic, choice, reason,
+      stats.ToString());
+}
+
+}  // namespace
+
+katana::analytics::BfsPlan
+katana::analytics::ChooseBfsPlan(const GraphStatistics& stats) {
+  if (stats.small_world()) {
+    LogChoice(
+        "Bfs", "SynchronousDirectOpt",
+        "the diameter is small and a few levels are large enough to pull",
+        stats);
+    return BfsPlan::SynchronousDirectOpt();
+  }
+  if (HasLongAdjacencies(stats, BfsPlan::kDefaultEdgeTileSize)) {
+    LogChoice(
+        "Bfs", "AsynchronousTile",
+        "the diameter is large and some adjacency lists span tiles", stats);
+    return BfsPlan::AsynchronousTile();
+  }
+  LogChoice(
+      "Bfs", "Asynchronous",
+      "the diameter is large and the adjacency lists are short", stats);
+  return BfsPlan::Asynchronous();
+}
+
+katana::analytics::SsspPlan
+katana::analytics::ChooseSsspPlan(const GraphStatistics& stats) {
+  // The delta depends on the weights, which the statistics do not cover
+  if (!stats.power_law) {
+    LogChoice(
+        "Sssp", "DeltaStepBarrier",
+        "the degrees are even and buckets fill evenly", stats);
+    return SsspPlan::DeltaStepBarrier(SsspPlan::kAutomaticDelta);
+  }
+  if (HasLongAdjacencies(stats, SsspPlan::kDefaultEdgeTileSize)) {
+    LogChoice(
+        "Sssp", "DeltaTile",
+        "the degrees follow a power law and hubs span tiles", stats);
+    return SsspPlan::DeltaTile(SsspPlan::kAutomaticDelta);
+  }
+  LogChoice(
+      "Sssp", "DeltaStep", "the degrees follow a power law", stats);
+  return SsspPlan::DeltaStep(SsspPlan::kAutomaticDelta);
+}
+
+katana::analytics::ConnectedComponentsPlan
+katana::analytics::ChooseConnectedComponentsPlan(const GraphStatistics& stats) {
+  // Sampling more neighbors than most nodes have only repeats the full pass
+  uint32_t neighbor_sample_size =
+      stats.average_degree <
+              ConnectedComponentsPlan::kDefaultNeighborSampleSize
+          ? 1
+          : ConnectedComponentsPlan::kDefaultNeighborSampleSize;
+  if (stats.power_law &&
+      HasLongAdjacencies(
+          stats, ConnectedComponentsPlan::kDefaultEdgeTileSize)) {
+    LogChoice(
+        "ConnectedComponents", "EdgeTiledAfforest",
+        "the degrees follow a power law and hubs span tiles", stats);
+    return ConnectedComponentsPlan::EdgeTiledAfforest(
+        ConnectedComponentsPlan::kDefaultEdgeTileSize, neighbor_sample_size);
+  }
+  LogChoice(
+      "ConnectedComponents", "Afforest",
+      "sampling links most nodes whatever the diameter", stats);
+  return ConnectedComponentsPlan::Afforest(neighbor_sample_size);
+}
+
+katana::analytics::TriangleCountPlan
+katana::analytics::ChooseTriangleCountPlan(const GraphStatistics& stats) {
+  auto relabeling = stats.power_law ? TriangleCountPlan::kRelabel
+                                    : TriangleCountPlan::kNoRelabel;
+  bool hub_bitmaps = HasHubs(stats);
+  LogChoice(
+      "TriangleCount", hub_bitmaps ? "OrderedCount with hub bitmaps"
+                                   : "OrderedCount",
+      hub_bitmaps ? "the degrees follow a power law with hubs"
+                  : "the graph has no hubs worth a bitmap",
+      stats);
+  return TriangleCountPlan::OrderedCount(
+      stats.edges_sorted, relabeling, hub_bitmaps);
+}
+
+katana::analytics::LocalClusteringCoefficientPlan
+katana::analytics::ChooseLocalClusteringCoefficientPlan(
+    const GraphStatistics& stats) {
+  bool hub_bitmaps = HasHubs(stats);
+  if (stats.power_law) {
+    // Exact, since sampling is a trade off for the caller to make
+    LogChoice(
+        "LocalClusteringCoefficient",
+        hub_bitmaps ? "DegreeOrdered with hub bitmaps" : "DegreeOrdered",
+        "the degrees follow a power law and hubs are costly to intersect",
+        stats);
+    return LocalClusteringCoefficientPlan::DegreeOrdered(
+        LocalClusteringCoefficientPlan::kNoSampling,
+        LocalClusteringCoefficientPlan::kDefaultMaxError, hub_bitmaps);
+  }
+  LogChoice(
+      "LocalClusteringCoefficient", "OrderedCountPerThread",
+      "the degrees are even and ordering by degree does not pay off", stats);
+  return LocalClusteringCoefficientPlan::OrderedCountPerThread(
+      stats.edges_sorted, LocalClusteringCoefficientPlan::kNoRelabel, false);
+}
@@ -0,0 +1,100 @@
+#include "katana/analytics/PropertyRequirements.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "katana/Timer.h"
+
+namespace {
+
+void
+AddName(std::vector<std::string>* names, const std::string& name) {
+  if (!name.empty() &&
+      std::find(names->begin(), names->end(), name) == names->end()) {
+    names->emplace_back(name);
+  }
+}
+
+}  // namespace
+
+katana::analytics::PropertyRequirements&
+katana::analytics::PropertyRequirements::AddNodeProperty(
+    const std::string& name) {
+  AddName(&node_properties, name);
+  return *this;
+}
+
+katana::analytics::PropertyRequirements&
+katana::analytics::PropertyRequirements::AddEdgeProperty(
+    const std::string& name) {
+  AddName(&edge_properties, name);
+  return *this;
+}
+
+katana::analytics::PropertyRequirements&
+katana::analytics::PropertyRequirements::Merge(
+    const PropertyRequirements& other) {
+  for (const std::string& name : other.node_properties) {
+    AddNodeProperty(name);
+  }
+  for (const std::string& name : other.edge_properties) {
+    AddEdgeProperty(name);
+  }
+  return *this;
+}
+
+katana::Result<katana::analytics::PinnedProperties>
+katana::analytics::PinnedProperties::Make(
+    PropertyGraph* pg, const PropertyRequirements& requirements) {
+  katana::StatTimer prefetch_timer("PrefetchTimer", "PinnedProperties");
+  prefetch_timer.start();
+  KATANA_CHECKED(pg->EnsureNodePropertiesLoaded(requirements.node_properties));
+  KATANA_CHECKED(pg->EnsureEdgePropertiesLoaded(requirements.edge_properties));
+  prefetch_timer.stop();
+
+  // Pins are recorded as they are taken, so that those taken before a
+  // failure are released with pins
+  PinnedProperties pins(pg);
+  for (const std::string& name : requirements.node_properties) {
+    KATANA_CHECKED(pg->PinNodeProperty(name));
+    pins.pinned_.node_properties.emplace_back(name);
+  }
+  for (const std::string& name : requirements.edge_properties) {
+    KATANA_CHECKED(pg->PinEdgeProperty(name));
+    pins.pinned_.edge_properties.emplace_back(name);
+  }
+  return pins;
+}
+
+katana::analytics::PinnedProperties::PinnedProperties(
+    PinnedProperties&& other) noexcept
+    : pg_(std::exchange(other.pg_, nullptr)),
+      pinned_(std::move(other.pinned_)) {}
+
+katana::analytics::PinnedProperties&
+katana::analytics::PinnedProperties::operator=(
+    PinnedProperties&& other) noexcept {
+  if (this != &other) {
+    Unpin();
+    pg_ = std::exchange(other.pg_, nullptr);
+    pinned_ = std::move(other.pinned_);
+  }
+  return *this;
+}
+
+katana::analytics::PinnedProperties::~PinnedProperties() { Unpin(); }
+
+void
+katana::analytics::PinnedProperties::Unpin() noexcept {
+  if (pg_ == nullptr) {
+    return;
+  }
+  for (const std::string& name : pinned_.node_properties) {
+    pg_->UnpinNodeProperty(name);
+  }
+  for (const std::string& name : pinned_.edge_properties) {
+    pg_->UnpinEdgeProperty(name);
+  }
+  pg_ = nullptr;
+  pinned_ = PropertyRequirements{};
+}
@@ -0,0 +1,266 @@
+#include "katana/analytics/analytics_session/analytics_session.h"
+
+#include <algorithm>
+#include <set>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Timer.h"
+
+using katana::analytics::AnalyticsSession;
+
+namespace {
+
+bool
+SamePlan(
+    const katana::analytics::BfsPlan& a, const katana::analytics::BfsPlan& b) {
+  return a.algorithm() == b.algorithm() && a.alpha() == b.alpha() &&
+         a.beta() == b.beta();
+}
+
+}  // namespace
+
+AnalyticsSession&
+AnalyticsSession::AddBfs(
+    uint32_t start_node, const std::string& output_property_name,
+    BfsPlan plan) {
+  outputs_.emplace_back(output_property_name);
+  jobs_.emplace_back(Job{
+      kBiDirectional,
+      {output_property_name},
+      [this, start_node, output_property_name, plan](
+          katana::TxnContext* txn_ctx) {
+        return Bfs(pg_, start_node, output_property_name, txn_ctx, plan);
+      }});
+  return *this;
+}
+
+AnalyticsSession&
+AnalyticsSession::AddBfsLevels(
+    uint32_t start_node, const std::string& output_property_name,
+    BfsPlan plan) {
+  outputs_.emplace_back(output_property_name);
+  bfs_levels_.emplace_back(BfsLevels{start_node, output_property_name, plan});
+  return *this;
+}
+
+AnalyticsSession&
+AnalyticsSession::AddSssp(
+    uint32_t start_node, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan) {
+  outputs_.emplace_back(output_property_name);
+  jobs_.emplace_back(Job{
+      kDefault,
+      {output_property_name},
+      [this, start_node, edge_weight_property_name, output_property_name,
+       plan](katana::TxnContext* txn_ctx) {
+        return Sssp(
+            pg_, start_node, edge_weight_property_name, output_property_name,
+            txn_ctx, plan);
+      },
+      SsspPropertyRequirements(edge_weight_property_name)});
+  return *this;
+}
+
+AnalyticsSession&
+AnalyticsSession::AddPagerank(
+    const std::string& output_property_name, PagerankPlan plan) {
+  outputs_.emplace_back(output_property_name);
+  bool pull = plan.algorithm() == PagerankPlan::kPullTopological ||
+              plan.algorithm() == PagerankPlan::kPullResidual;
+  jobs_.emplace_back(Job{
+      pull ? kTransposed : kDefault,
+      {output_property_name},
+      [this, output_property_name, plan](katana::TxnContext* txn_ctx) {
+        return Pagerank(pg_, output_property_name, txn_ctx, plan);
+      }});
+  return *this;
+}
+
+AnalyticsSession&
+AnalyticsSession::AddConnectedComponents(
+    const std::string& output_property_name, bool is_symmetric,
+    ConnectedComponentsPlan plan) {
+  outputs_.emplace_back(output_property_name);
+  jobs_.emplace_back(Job{
+      is_symmetric ? kDefault : kUndirected,
+      {output_property_name},
+      [this, output_property_name, is_symmetric,
+       plan](katana::TxnContext* txn_ctx) {
+        return ConnectedComponents(
+            pg_, output_property_name, txn_ctx, is_symmetric, plan);
+      }});
+  return *this;
+}
+
+AnalyticsSession&
+AnalyticsSession::AddLocalClusteringCoefficient(
+    const std::string& output_property_name,
+    LocalClusteringCoefficientPlan plan) {
+  outputs_.emplace_back(output_property_name);
+  View view = plan.hub_bitmaps() ? kEdgesSortedByDestIDHubBitmaps
+                                 : kEdgesSortedByDestID;
+  if (plan.algorithm() == LocalClusteringCoefficientPlan::kDegreeOrdered) {
+    view = plan.hub_bitmaps()
+               ? kNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps
+               : kNodesSortedByDegreeEdgesSortedByDestID;
+  }
+  jobs_.emplace_back(Job{
+      view,
+      {output_property_name},
+      [this, output_property_name, plan](katana::TxnContext* txn_ctx) {
+        return LocalClusteringCoefficient(
+            pg_, output_property_name, txn_ctx, plan);
+      }});
+  return *this;
+}
+
+std::shared_ptr<void>
+AnalyticsSession::BuildView(View view) {
+  // Holding the view holds the topologies it is made of, which the view
+  // cache does not release while they are in use.
+  using namespace katana::PropertyGraphViews;
+  switch (view) {
+  case kDefault:
+    return std::make_shared<Default>(pg_->BuildView<Default>());
+  case kBiDirectional:
+    return std::make_shared<BiDirectional>(pg_->BuildView<BiDirectional>());
+  case kTransposed:
+    return std::make_shared<Transposed>(pg_->BuildView<Transposed>());
+  case kUndirected:
+    return std::make_shared<Undirected>(pg_->BuildView<Undirected>());
+  case kEdgesSortedByDestID:
+    return std::make_shared<EdgesSortedByDestID>(
+        pg_->BuildView<EdgesSortedByDestID>());
+  case kEdgesSortedByDestIDHubBitmaps:
+    return std::make_shared<EdgesSortedByDestIDHubBitmaps>(
+        pg_->BuildView<EdgesSortedByDestIDHubBitmaps>());
+  case kNodesSortedByDegreeEdgesSortedByDestID:
+    return std::make_shared<NodesSortedByDegreeEdgesSortedByDestID>(
+        pg_->BuildView<NodesSortedByDegreeEdgesSortedByDestID>());
+  case kNodesSortedByDegreeEdgesSortedByDestIDHubBitmaps:
+    return std::make_shared<NodesSortedByDegreeEdgesSortedByDestIDHubBitmaps>(
+        pg_->BuildView<NodesSortedByDegreeEdgesSortedByDestIDHubBitmaps>());
+  }
+  KATANA_LOG_FATAL("unknown view: {}", static_cast<int>(view));
+}
+
+void
+AnalyticsSession::AddFusedBfsLevels(std::vector<Job>* jobs) const {
+  std::vector<bool> fused(bfs_levels_.size(), false);
+  for (size_t i = 0; i < bfs_levels_.size(); ++i) {
+    if (fused[i]) {
+      continue;
+    }
+    BfsPlan plan = bfs_levels_[i].plan;
+    std::vector<uint32_t> start_nodes;
+    std::vector<std::string> output_property_names;
+    for (size_t j = i; j < bfs_levels_.size(); ++j) {
+      if (!fused[j] && SamePlan(bfs_levels_[j].plan, plan)) {
+        fused[j] = true;
+        start_nodes.emplace_back(bfs_levels_[j].start_node);
+        output_property_names.emplace_back(
+            bfs_levels_[j].output_property_name);
+      }
+    }
+    jobs->emplace_back(Job{
+        kBiDirectional, output_property_names,
+        [this, start_nodes, output_property_names,
+         plan](katana::TxnContext* txn_ctx) {
+          return MultiSourceBfs(
+              pg_, start_nodes, output_property_names, txn_ctx, plan);
+        }});
+  }
+}
+
+katana::Result<void>
+AnalyticsSession::Run(katana::TxnContext* txn_ctx) {
+  std::vector<Job> jobs = std::move(jobs_);
+  jobs_.clear();
+  AddFusedBfsLevels(&jobs);
+  bfs_levels_.clear();
+  outputs_.clear();
+
+  std::set<std::string> outputs;
+  for (const Job& job : jobs) {
+    for (const std::string& name : job.output_property_names) {
+      if (!outputs.emplace(name).second) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "output property {} is queued more than once", name);
+      }
+      if (pg_->HasNodeProperty(name)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AlreadyExists,
+            "output property {} already exists", name);
+      }
+    }
+  }
+
+  // Keep the order the analytics were queued in among those of a view
+  std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) {
+    return a.view < b.view;
+  });
+
+  PropertyRequirements requirements;
+  for (const Job& job : jobs) {
+    requirements.Merge(job.requirements);
+  }
+  auto pins = KATANA_CHECKED(PinnedProperties::Make(pg_, requirements));
+
+  katana::StatTimer views_timer("ViewsTimer", "AnalyticsSession");
+  views_timer.start();
+  if (held_views_version_ != pg_->topology_version()) {
+    held_views_.clear();
+    held_views_version_ = pg_->topology_version();
+  }
+  for (const Job& job : jobs) {
+    std::shared_ptr<void>& view = held_views_[job.view];
+    if (!view) {
+      view = BuildView(job.view);
+    }
+  }
+  views_timer.stop();
+
+  katana::StatTimer run_timer("RunTimer", "AnalyticsSession");
+  run_timer.start();
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (auto res = jobs[i].run(txn_ctx); !res) {
+      // Roll back the outputs of this job and of the ones before it
+      for (size_t j = 0; j <= i; ++j) {
+        for (const std::string& name : jobs[j].output_property_names) {
+          if (pg_->HasNodeProperty(name)) {
+            if (auto r = pg_->RemoveNodeProperty(name, txn_ctx); !r) {
+              KATANA_LOG_WARN(
+                  "could not remove output property {}: {}", name, r.error());
+            }
+          }
+        }
+      }
+      return res.error().WithContext(
+          "analytic {} of {} of the session", i + 1, jobs.size());
+    }
+  }
+  run_timer.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+AnalyticsSession::RunToTable(katana::TxnContext* txn_ctx) {
+  std::vector<std::string> names = outputs_;
+  KATANA_CHECKED(Run(txn_ctx));
+
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& name : names) {
+    auto column = KATANA_CHECKED(pg_->GetNodeProperty(name));
+    fields.emplace_back(arrow::field(name, column->type()));
+    columns.emplace_back(std::move(column));
+  }
+  // The columns keep their data after the properties are gone
+  for (const std::string& name : names) {
+    KATANA_CHECKED(pg_->RemoveNodeProperty(name, txn_ctx));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
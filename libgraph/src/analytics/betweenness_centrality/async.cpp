@@ -1,17 +1,20 @@
-#include <iomanip>
-#include <iostream>
-
 #include "BCEdge.h"
 #include "BCNode.h"
+#include "betweenness_centrality_impl.h"
 #include "katana/Bag.h"
-#include "katana/BufferedGraph.h"
-#include "katana/LC_CSR_CSC_Graph.h"
+#include "katana/NUMAArray.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
 
 // WARNING: optimal chunk size may differ depending on input graph
 constexpr static const unsigned ASYNC_CHUNK_SIZE = 64U;
 using NodeType = BCNode<BC_USE_MARKING, BC_CONCURRENT>;
-using AsynchronousGraph =
-    katana::LC_CSR_CSC_Graph<NodeType, BCEdge, false, true>;
+using AsynchronousGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<>, std::tuple<>>;
+using GNode = AsynchronousGraph::Node;
 
 // Work items for the forward phase
 struct ForwardPhaseWorkItem {
@@ -38,7 +41,10 @@ struct Counter : public T {
 
   Counter(std::string s) : name(std::move(s)) {}
 
-  ~Counter() { katana::ReportStatSingle("(NULL)", name, this->reduce()); }
+  ~Counter() {
+    katana::ReportStatSingle(
+        "BetweennessCentralityAsynchronous", name, this->reduce());
+  }
 };
 
 template <typename T>
@@ -49,10 +55,26 @@ struct Counter<T, false> {
   void update(Args...) {}
 };
 
+/**
+ * Builds the shortest path DAG of a source without level barriers: nodes
+ * are expanded in roughly increasing distance from an ordered worklist and
+ * edges that turn out not to be on shortest paths are corrected as shorter
+ * paths are found. Dependencies are then propagated back from the leaves
+ * of the DAG, again without barriers.
+ *
+ * Node state lives in an array by node and edge state in an array by edge
+ * property index, which out and in edges of the bidirectional view share.
+ */
 struct BetweenessCentralityAsynchronous {
-  AsynchronousGraph& graph;
-
-  BetweenessCentralityAsynchronous(AsynchronousGraph& _graph) : graph(_graph) {}
+  const AsynchronousGraph& graph;
+  katana::NUMAArray<NodeType> nodes;
+  katana::NUMAArray<BCEdge> edges;
+
+  BetweenessCentralityAsynchronous(const AsynchronousGraph& _graph)
+      : graph(_graph) {
+    nodes.create(graph.NumNodes());
+    edges.create(graph.NumEdges());
+  }
 
   using SumCounter =
       Counter<katana::GAccumulator<unsigned long>, BC_COUNT_ACTIONS>;
@@ -71,18 +93,26 @@ struct BetweenessCentralityAsynchronous {
   using LeafCounter =
       Counter<katana::GAccumulator<unsigned long>, BC_COUNT_LEAVES>;
 
+  BCEdge& OutEdgeData(AsynchronousGraph::Edge e) {
+    return edges[graph.GetEdgePropertyIndexFromOutEdge(e)];
+  }
+
+  BCEdge& InEdgeData(AsynchronousGraph::Edge e) {
+    return edges[graph.GetEdgePropertyIndexFromInEdge(e)];
+  }
+
   void CorrectNode(uint32_t dstID, BCEdge&) {
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& dstData = nodes[dstID];
 
     // loop through in edges
-    for (auto e : graph.in_edges(dstID)) {
-      BCEdge& inEdgeData = graph.getInEdgeData(e);
+    for (auto e : graph.InEdges(dstID)) {
+      BCEdge& inEdgeData = InEdgeData(e);
 
-      uint32_t srcID = graph.getInEdgeDst(e);
+      uint32_t srcID = graph.InEdgeSrc(e);
       if (srcID == dstID)
         continue;
 
-      NodeType& srcData = graph.getData(srcID);
+      NodeType& srcData = nodes[srcID];
 
       // lock in right order
       if (srcID < dstID) {
@@ -119,8 +149,8 @@ struct BetweenessCentralityAsynchronous {
   void SpAndFU(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
     spfuCount.update(1);
 
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& srcData = nodes[srcID];
+    NodeType& dstData = nodes[dstID];
 
     // make dst a successor of src, src predecessor of dst
     srcData.nsuccs++;
@@ -143,7 +173,7 @@ struct BetweenessCentralityAsynchronous {
       ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
     dstData.unlock();
     if (dstPredsNotEmpty) {
-      correctNode(dstID, ed);
+      CorrectNode(dstID, ed);
     }
   }
 
@@ -151,8 +181,8 @@ struct BetweenessCentralityAsynchronous {
   void UpdateSigma(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
     updateSigmaP1Count.update(1);
 
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& srcData = nodes[srcID];
+    NodeType& dstData = nodes[dstID];
 
     const ShortPathType srcSigma = srcData.sigma;
     const ShortPathType eval = ed.val;
@@ -164,14 +194,8 @@ struct BetweenessCentralityAsynchronous {
       updateSigmaP2Count.update(1);
       ed.val = srcSigma;
 
-      // ShortPathType old = dstData.sigma;
       dstData.sigma += diff;
 
-      // if (old >= dstData.sigma) {
-      //  katana::gDebug("Overflow detected; capping at max uint64_t");
-      //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-      //}
-
       int nbsuccs = dstData.nsuccs;
 
       if (nbsuccs > 0) {
@@ -188,21 +212,16 @@ struct BetweenessCentralityAsynchronous {
   void FirstUpdate(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
     firstUpdateCount.update(1);
 
-    NodeType& srcData = graph.getData(srcID);
+    NodeType& srcData = nodes[srcID];
     srcData.nsuccs++;
     const ShortPathType srcSigma = srcData.sigma;
 
-    NodeType& dstData = graph.getData(dstID);
+    NodeType& dstData = nodes[dstID];
     dstData.preds.push_back(srcID);
 
     const ShortPathType dstSigma = dstData.sigma;
 
-    // ShortPathType old = dstData.sigma;
     dstData.sigma = dstSigma + srcSigma;
-    // if (old >= dstData.sigma) {
-    //  katana::gDebug("Overflow detected; capping at max uint64_t");
-    //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-    //}
 
     ed.val = srcSigma;
     ed.level = srcData.distance;
@@ -220,14 +239,14 @@ struct BetweenessCentralityAsynchronous {
         katana::iterate(wl),
         [&](ForwardPhaseWorkItem& wi, auto& ctx) {
           uint32_t srcID = wi.nodeID;
-          NodeType& srcData = graph.getData(srcID);
+          NodeType& srcData = nodes[srcID];
           srcData.markOut();
 
           // loop through all edges
-          for (auto e : graph.edges(srcID)) {
-            BCEdge& edgeData = graph.getEdgeData(e);
-            uint32_t dstID = graph.getEdgeDst(e);
-            NodeType& dstData = graph.getData(dstID);
+          for (auto e : graph.OutEdges(srcID)) {
+            BCEdge& edgeData = OutEdgeData(e);
+            uint32_t dstID = graph.OutEdgeDst(e);
+            NodeType& dstData = nodes[dstID];
 
             if (srcID == dstID)
               continue;  // ignore self loops
@@ -250,13 +269,13 @@ struct BetweenessCentralityAsynchronous {
 
             if (BDist - ADist > 1) {
               // Shortest Path + First Update (and Correct Node)
-              this->spAndFU(srcID, dstID, edgeData, ctx);
+              this->SpAndFU(srcID, dstID, edgeData, ctx);
             } else if (elevel == ADist && BDist == ADist + 1) {
               // Update Sigma
-              this->updateSigma(srcID, dstID, edgeData, ctx);
+              this->UpdateSigma(srcID, dstID, edgeData, ctx);
             } else if (BDist == ADist + 1 && elevel != ADist) {
               // First Update not combined with Shortest Path
-              this->firstUpdate(srcID, dstID, edgeData, ctx);
+              this->FirstUpdate(srcID, dstID, edgeData, ctx);
             } else {  // No Action
               noActionCount.update(1);
               srcData.unlock();
@@ -272,7 +291,7 @@ struct BetweenessCentralityAsynchronous {
     katana::for_each(
         katana::iterate(wl),
         [&](uint32_t srcID, auto& ctx) {
-          NodeType& srcData = graph.getData(srcID);
+          NodeType& srcData = nodes[srcID];
           srcData.lock();
 
           if (srcData.nsuccs == 0) {
@@ -286,15 +305,11 @@ struct BetweenessCentralityAsynchronous {
             // loop through src's predecessors
             for (unsigned i = 0; i < srcPreds.size(); i++) {
               uint32_t predID = srcPreds[i];
-              NodeType& predData = graph.getData(predID);
+              NodeType& predData = nodes[predID];
 
               KATANA_LOG_DEBUG_ASSERT(srcData.sigma >= 1);
               const double term =
                   (double)predData.sigma * (1.0 + srcDelta) / srcData.sigma;
-              // if (std::isnan(term)) {
-              //  katana::gPrint(predData.sigma, " ", srcDelta, "
-              //  ", srcData.sigma, "\n");
-              //}
               predData.lock();
               predData.delta += term;
               const unsigned prevPdNsuccs = predData.nsuccs;
@@ -310,8 +325,8 @@ struct BetweenessCentralityAsynchronous {
 
             // reset data in preparation for next source
             srcData.reset();
-            for (auto e : graph.edges(srcID)) {
-              graph.getEdgeData(e).reset();
+            for (auto e : graph.OutEdges(srcID)) {
+              OutEdgeData(e).reset();
             }
           } else {
             srcData.unlock();
@@ -326,7 +341,7 @@ struct BetweenessCentralityAsynchronous {
     katana::do_all(
         katana::iterate(0u, nnodes),
         [&](auto i) {
-          NodeType& n = graph.getData(i);
+          NodeType& n = nodes[i];
 
           if (n.nsuccs == 0 && n.distance < kInfinity) {
             leafCount.update(1);
@@ -335,79 +350,40 @@ struct BetweenessCentralityAsynchronous {
         },
         katana::loopname("LeafFind"));
   }
-};
-
-void
-AsynchronousSanity(AsynchronousGraph& graph) {
-  katana::GReduceMax<float> accum_max;
-  katana::GReduceMin<float> accum_min;
-  katana::GAccumulator<float> accum_sum;
-  accum_max.reset();
-  accum_min.reset();
-  accum_sum.reset();
-
-  // get max, min, sum of BC values using accumulators and reducers
-  katana::do_all(
-      katana::iterate(graph),
-      [&](unsigned n) {
-        auto& nodeData = graph.getData(n);
-        accum_max.update(nodeData.bc);
-        accum_min.update(nodeData.bc);
-        accum_sum += nodeData.bc;
-      },
-      katana::no_stats(), katana::loopname("AsynchronousSanity"));
-
-  katana::gPrint("Max BC is ", accum_max.reduce(), "\n");
-  katana::gPrint("Min BC is ", accum_min.reduce(), "\n");
-  katana::gPrint("BC sum is ", accum_sum.reduce(), "\n");
-}
-////////////////////////////////////////////////////////////////////////////////
-
-//! runs asynchronous BC
-void
-BetweennessCentralityAsynchronous() {
-  if (BC_CONCURRENT) {
-    katana::gInfo("Running in concurrent mode with ", numThreads, " threads");
-  } else {
-    katana::gInfo("Running in serial mode");
-  }
 
-  katana::gInfo("Constructing async BC graph");
-  // create bidirectional graph
-  AsynchronousGraph bcGraph;
+  //! Adds the dependencies of all nodes on source to their centrality
+  void Run(uint32_t source) {
+    katana::InsertBag<ForwardPhaseWorkItem> forwardPhaseWL;
+    katana::InsertBag<uint32_t> backwardPhaseWL;
 
-  katana::StatTimer graph_construct_timer("GRAPH_CONSTRUCT");
-  graph_construct_timer.start();
-
-  katana::FileGraph fileReader;
-  fileReader.fromFile(inputFile);
-  bcGraph.allocateFrom(fileReader.size(), fileReader.sizeEdges());
-  bcGraph.constructNodes();
+    forwardPhaseWL.push_back(ForwardPhaseWorkItem(source, 0));
+    NodeType& active = nodes[source];
+    active.initAsSource();
 
-  katana::do_all(katana::iterate(fileReader), [&](uint32_t i) {
-    auto b = fileReader.edge_begin(i);
-    auto e = fileReader.edge_end(i);
+    DagConstruction(forwardPhaseWL);
+    FindLeaves(backwardPhaseWL, graph.NumNodes());
 
-    bcGraph.fixEndEdge(i, *e);
+    double backupSrcBC = active.bc;
+    DependencyBackProp(backwardPhaseWL);
+    active.bc = backupSrcBC;  // current source BC should not get updated
+  }
+};
 
-    while (b < e) {
-      bcGraph.constructEdge(*b, fileReader.getEdgeDst(*b));
-      b++;
-    }
-  });
-  bcGraph.constructIncomingEdges();
+}  // namespace
 
-  graph_construct_timer.stop();
+katana::Result<void>
+BetweennessCentralityAsynchronous(
+    katana::PropertyGraph* pg, BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    BetweennessCentralityPlan plan [[maybe_unused]],
+    katana::TxnContext* txn_ctx) {
+  AsynchronousGraph graph =
+      KATANA_CHECKED(AsynchronousGraph::Make(pg, {}, {}));
 
-  BetweenessCentralityAsynchronous bcExecutor(bcGraph);
+  BetweenessCentralityAsynchronous bc_executor(graph);
 
-  unsigned nnodes = bcGraph.size();
-  uint64_t nedges = bcGraph.sizeEdges();
-  katana::gInfo("Num nodes is ", nnodes, ", num edges is ", nedges);
-  katana::gInfo("Using OBIM chunk size: ", ASYNC_CHUNK_SIZE);
-  katana::gInfo(
-      "Note that optimal chunk size may differ depending on input "
-      "graph");
+  uint32_t nnodes = graph.NumNodes();
+  uint64_t nedges = graph.NumEdges();
   katana::ReportStatSingle(
       "BetweennessCentralityAsynchronous", "ChunkSize", ASYNC_CHUNK_SIZE);
 
@@ -421,118 +397,48 @@ BetweennessCentralityAsynchronous() {
       5);
   katana::ReportPageAllocGuard page_alloc;
 
-  // reset everything in preparation for run
-  katana::do_all(
-      katana::iterate(0u, nnodes), [&](auto i) { bcGraph.getData(i).reset(); });
-  katana::do_all(katana::iterate(UINT64_C(0), nedges), [&](auto i) {
-    bcGraph.getEdgeData(i).reset();
-  });
-
-  // reading in list of sources to operate on if provided
-  std::ifstream sourceFile;
-  std::vector<uint64_t> sourceVector;
-  if (sourcesToUse != "") {
-    sourceFile.open(sourcesToUse);
-    std::vector<uint64_t> t(
-        std::istream_iterator<uint64_t>{sourceFile},
-        std::istream_iterator<uint64_t>{});
-    sourceVector = t;
-    sourceFile.close();
-  }
-
-  if (numOfSources == 0) {
-    numOfSources = nnodes;
-  }
-
-  // if user does specifes a certain number of out sources (i.e. only sources
-  // with outgoing edges), we need to loop over the entire node set to look for
-  // good sources to use
-  uint32_t goodSource = 0;
-  if (iterLimit != 0) {
-    numOfSources = nnodes;
-  }
-
-  // only use at most the number of sources in the passed in source file (if
-  // such a file was actually pass in)
-  if (sourceVector.size() != 0) {
-    if (numOfSources > sourceVector.size()) {
-      numOfSources = sourceVector.size();
+  // sources to process, chosen as BetweennessCentralityLevel chooses them
+  // so that every plan gives the same answer for the same sources
+  std::vector<uint32_t> source_vector;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+  } else {
+    uint32_t num_sources = std::get<uint32_t>(sources);
+    uint32_t loop_end = (num_sources == kBetweennessCentralityAllNodes)
+                            ? nnodes
+                            : std::min(num_sources, nnodes);
+    for (uint32_t n = 0; n < loop_end; ++n) {
+      source_vector.push_back(n);
     }
   }
 
-  katana::InsertBag<ForwardPhaseWorkItem> forwardPhaseWL;
-  katana::InsertBag<uint32_t> backwardPhaseWL;
-
-  katana::gInfo("Beginning execution");
-
   katana::StatTimer exec_time("BetweennessCentralityAsynchronous");
   exec_time.start();
-  for (uint32_t i = 0; i < numOfSources; ++i) {
-    uint32_t sourceToUse = i;
-    if (sourceVector.size() != 0) {
-      sourceToUse = sourceVector[i];
+  for (size_t i = 0; i < source_vector.size(); ++i) {
+    KATANA_CHECKED(CheckProgress(
+        {"BetweennessCentrality", i, source_vector.size() - i}));
+    // a source with no out edges adds nothing to any centrality
+    if (!graph.OutEdges(source_vector[i]).empty()) {
+      bc_executor.Run(source_vector[i]);
     }
-
-    // ignore nodes with no neighbors
-    if (!std::distance(
-            bcGraph.edge_begin(sourceToUse), bcGraph.edge_end(sourceToUse))) {
-      katana::gDebug(sourceToUse, " has no outgoing edges");
-      continue;
-    }
-
-    forwardPhaseWL.push_back(ForwardPhaseWorkItem(sourceToUse, 0));
-    NodeType& active = bcGraph.getData(sourceToUse);
-    active.initAsSource();
-    katana::gDebug("Source is ", sourceToUse);
-
-    bcExecutor.dagConstruction(forwardPhaseWL);
-    forwardPhaseWL.clear();
-
-    bcExecutor.findLeaves(backwardPhaseWL, nnodes);
-
-    double backupSrcBC = active.bc;
-    bcExecutor.dependencyBackProp(backwardPhaseWL);
-
-    active.bc = backupSrcBC;  // current source BC should not get updated
-
-    backwardPhaseWL.clear();
-
-    // break out once number of sources user specified to do (if any) has been
-    // reached
-    goodSource++;
-    if (iterLimit != 0 && goodSource >= iterLimit)
-      break;
   }
   exec_time.stop();
 
-  katana::gInfo("Number of sources with outgoing edges was ", goodSource);
-
-  page_alloc.Report();
-
-  // sanity
-  AsynchronousSanity(bcGraph);
+  katana::ReportStatSingle(
+      "BetweennessCentralityAsynchronous", "Sources", source_vector.size());
 
-  // prints out first 10 node BC values
-  if (!skipVerify) {
-    int count = 0;
-    for (unsigned i = 0; i < nnodes && count < 10; ++i, ++count) {
-      katana::gPrint(
-          count, ": ", std::setiosflags(std::ios::fixed), std::setprecision(6),
-          bcGraph.getData(i).bc, "\n");
-    }
+  arrow::FloatBuilder builder;
+  KATANA_CHECKED(builder.Resize(nnodes));
+  for (uint32_t n = 0; n < nnodes; ++n) {
+    KATANA_CHECKED(builder.Append(bc_executor.nodes[n].bc));
   }
+  std::shared_ptr<arrow::FloatArray> data;
+  KATANA_CHECKED(builder.Finish(&data));
 
-  if (output) {
-    std::cerr << "Writting out bc values...\n";
-    std::stringstream outfname;
-    outfname << "certificate"
-             << "_" << numThreads << ".txt";
-    std::string fname = outfname.str();
-    std::ofstream outfile(fname.c_str());
-    for (unsigned i = 0; i < nnodes; ++i) {
-      outfile << i << " " << std::setiosflags(std::ios::fixed)
-              << std::setprecision(9) << bcGraph.getData(i).bc << "\n";
-    }
-    outfile.close();
-  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::float32())}),
+      {data});
+  KATANA_CHECKED(pg->AddNodeProperties(table, txn_ctx));
+
+  return katana::ResultSuccess();
 }
@@ -19,8 +19,84 @@
 
 #include "betweenness_centrality_impl.h"
 
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/NUMAArray.h"
+#include "katana/TypedPropertyGraph.h"
+
 using namespace katana::analytics;
 
+namespace {
+
+/// Estimated diameter from which the asynchronous algorithm beats the
+/// barrier per level of the level algorithm
+constexpr uint32_t kMinAsynchronousDiameter = 64;
+
+using DiameterGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, std::tuple<>, std::tuple<>>;
+using DiameterGNode = DiameterGraph::Node;
+
+/// The number of levels of a BFS along out edges from source and a node of
+/// the last level
+std::pair<uint32_t, DiameterGNode>
+Eccentricity(const DiameterGraph& graph, DiameterGNode source) {
+  katana::NUMAArray<std::atomic<bool>> visited;
+  visited.allocateInterleaved(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const DiameterGNode& n) { visited[n] = false; }, katana::no_stats());
+
+  auto current = std::make_unique<katana::InsertBag<DiameterGNode>>();
+  auto next = std::make_unique<katana::InsertBag<DiameterGNode>>();
+  visited[source] = true;
+  next->push(source);
+  uint32_t levels = 0;
+  DiameterGNode last = source;
+  while (!next->empty()) {
+    std::swap(current, next);
+    next->clear();
+    last = *current->begin();
+    katana::do_all(
+        katana::iterate(*current),
+        [&](const DiameterGNode& n) {
+          for (auto e : graph.OutEdges(n)) {
+            auto dst = graph.OutEdgeDst(e);
+            if (!visited[dst].load(std::memory_order_relaxed) &&
+                !visited[dst].exchange(true)) {
+              next->push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    levels += 1;
+  }
+  return {levels - 1, last};
+}
+
+/// Lower bound on the diameter by a double sweep: the eccentricity of a
+/// node farthest from a node of highest out degree
+katana::Result<uint32_t>
+EstimateDiameter(katana::PropertyGraph* pg) {
+  DiameterGraph graph = KATANA_CHECKED(DiameterGraph::Make(pg, {}, {}));
+  if (graph.NumNodes() == 0) {
+    return 0;
+  }
+  katana::GReduceMax<std::pair<size_t, DiameterGNode>> hub;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const DiameterGNode& n) {
+        hub.update({graph.OutEdges(n).size(), n});
+      },
+      katana::no_stats());
+  auto [first_levels, far] = Eccentricity(graph, hub.reduce().second);
+  return std::max(first_levels, Eccentricity(graph, far).first);
+}
+
+}  // namespace
+
 const BetweennessCentralitySources
     katana::analytics::kBetweennessCentralityAllNodes =
         std::numeric_limits<uint32_t>::max();
@@ -31,18 +107,33 @@ katana::analytics::BetweennessCentrality(
     katana::TxnContext* txn_ctx, const BetweennessCentralitySources& sources,
     BetweennessCentralityPlan plan) {
   switch (plan.algorithm()) {
-    //TODO (gill) Needs bidirectional graph (CSR_CSC)
-    //   case Asynchronous:
-    //     // see AsyncStructs.h
-    //     katana::gInfo("Running async BC");
-    //     doAsyncBC();
-    //     break;
+  case BetweennessCentralityPlan::kAutomatic: {
+    uint32_t diameter = KATANA_CHECKED(EstimateDiameter(pg));
+    katana::ReportStatSingle(
+        "BetweennessCentrality", "EstimatedDiameter", diameter);
+    return BetweennessCentrality(
+        pg, output_property_name, txn_ctx, sources,
+        diameter >= kMinAsynchronousDiameter
+            ? BetweennessCentralityPlan::Asynchronous()
+            : BetweennessCentralityPlan::Level());
+  }
+  case BetweennessCentralityPlan::kAsynchronous:
+    return BetweennessCentralityAsynchronous(
+        pg, sources, output_property_name, plan, txn_ctx);
   case BetweennessCentralityPlan::kLevel:
     return BetweennessCentralityLevel(
         pg, sources, output_property_name, plan, txn_ctx);
   case BetweennessCentralityPlan::kOuter:
     return BetweennessCentralityOuter(
         pg, sources, output_property_name, plan, txn_ctx);
+  case BetweennessCentralityPlan::kAdaptive:
+    if (sources != kBetweennessCentralityAllNodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the adaptive plan picks its own sources");
+    }
+    return BetweennessCentralityAdaptive(
+        pg, output_property_name, plan, txn_ctx);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBGRAPH_ANALYTICS_BETWEENNESSCENTRALITY_BETWEENNESSCENTRALITYIMPL_H_
 #define KATANA_LIBGRAPH_ANALYTICS_BETWEENNESSCENTRALITY_BETWEENNESSCENTRALITYIMPL_H_
 
+#include "katana/analytics/AsyncAnalytics.h"
 #include "katana/analytics/Utils.h"
 #include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
 
@@ -18,4 +19,16 @@ katana::Result<void> BetweennessCentralityLevel(
     katana::analytics::BetweennessCentralityPlan plan,
     katana::TxnContext* txn_ctx);
 
+katana::Result<void> BetweennessCentralityAsynchronous(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan,
+    katana::TxnContext* txn_ctx);
+
+katana::Result<void> BetweennessCentralityAdaptive(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan,
+    katana::TxnContext* txn_ctx);
+
 #endif
@@ -0,0 +1,26 @@
+#ifndef KATANA_LIBGRAPH_ANALYTICS_BETWEENNESSCENTRALITY_CONTROL_H_
+#define KATANA_LIBGRAPH_ANALYTICS_BETWEENNESSCENTRALITY_CONTROL_H_
+
+#include <cstdint>
+#include <limits>
+
+#include "katana/Logging.h"
+#include "katana/gIO.h"
+
+// Mark nodes while they are on the forward phase worklist so that each is
+// pushed once however many of its predecessors change
+#define BC_USE_MARKING true
+// Lock node state; only false for serial debugging
+#define BC_CONCURRENT true
+// Report how often each action of the forward phase runs
+#define BC_COUNT_ACTIONS false
+// Report the number of leaves of the DAG of each source
+#define BC_COUNT_LEAVES false
+
+// Number of shortest paths; a double so it does not overflow on large graphs
+using ShortPathType = double;
+
+// Distances are compared as ints, so infinity must leave room to add to it
+constexpr static uint32_t kInfinity = std::numeric_limits<uint32_t>::max() / 4;
+
+#endif
@@ -298,6 +298,8 @@ BetweennessCentralityLevel(
 
   // loop over all specified sources for SSSP/Brandes calculation
   for (uint64_t i = 0; i < loop_end; i++) {
+    KATANA_CHECKED(
+        CheckProgress({"BetweennessCentrality", i, loop_end - i}));
     LevelGNode src_node;
     if (!source_vector.empty()) {
       if (i > source_vector.size()) {
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
 #include <boost/iterator/filter_iterator.hpp>
 
 #include "betweenness_centrality_impl.h"
@@ -28,12 +32,19 @@ class BCOuter {
   katana::PerThreadStorage<int*> per_thread_distance_;
   katana::PerThreadStorage<float*> per_thread_delta_;
   katana::PerThreadStorage<katana::gdeque<OuterGNode>*> per_thread_successor_;
+  // Sums of squared dependencies, if tracked
+  katana::PerThreadStorage<float*> per_thread_squares_;
+  bool track_squares_;
 
 public:
   /**
    * Constructor initializes thread local storage.
+   *
+   * @param track_squares Also sum the squares of the dependencies of each
+   * node, which bounding the error of sampling needs
    */
-  BCOuter(const OuterGraph& g) : graph_(g), num_nodes_(g.NumNodes()) {
+  BCOuter(const OuterGraph& g, bool track_squares = false)
+      : graph_(g), num_nodes_(g.NumNodes()), track_squares_(track_squares) {
     InitializeLocal();
   }
 
@@ -99,8 +110,12 @@ public:
     // save result of this source's BC, reset all local values for next
     // source
     float* Vec = *centrality_measure_.getLocal();
+    float* squares = track_squares_ ? *per_thread_squares_.getLocal() : nullptr;
     for (int i = 0; i < num_nodes_; ++i) {
       Vec[i] += delta[i];
+      if (squares) {
+        squares[i] += delta[i] * delta[i];
+      }
       delta[i] = 0;
       sigma[i] = 0;
       distance[i] = 0;
@@ -126,6 +141,24 @@ public:
         katana::steal(), katana::loopname("Main"));
   }
 
+  /**
+   * Runs betweenness-centrality from num_sources sources in batches of a
+   * few sources per thread, checking for cancellation between batches.
+   *
+   * @param make_batch Returns the data structure that holds the sources
+   * [begin, end) of a batch
+   */
+  template <typename MakeBatch>
+  katana::Result<void> RunInBatches(size_t num_sources, MakeBatch make_batch) {
+    size_t batch_size = 16 * katana::getActiveThreads();
+    for (size_t begin = 0; begin < num_sources; begin += batch_size) {
+      KATANA_CHECKED(CheckProgress(
+          {"BetweennessCentrality", begin, num_sources - begin}));
+      Run(make_batch(begin, std::min(num_sources, begin + batch_size)));
+    }
+    return katana::ResultSuccess();
+  }
+
   /**
    * Verification for reference torus graph inputs.
    * All nodes should have the same betweenness value up to
@@ -155,8 +188,28 @@ public:
     }
   }
 
+  /**
+   * The sum over all threads of the dependencies of node i and, if squares
+   * are tracked, of their squares.
+   */
+  std::pair<double, double> Sums(size_t i) {
+    double sum = 0;
+    double squares = 0;
+    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
+      sum += (*centrality_measure_.getRemote(j))[i];
+      if (track_squares_) {
+        squares += (*per_thread_squares_.getRemote(j))[i];
+      }
+    }
+    return {sum, squares};
+  }
+
+  /**
+   * @param scale Factor to multiply every centrality by, e.g., to turn a sum
+   * over sampled sources into an estimate of the sum over all of them
+   */
   katana::Result<std::shared_ptr<arrow::FloatArray>> ExtractBCValues(
-      size_t begin, size_t end) {
+      size_t begin, size_t end, float scale = 1) {
     arrow::FloatBuilder builder;
     if (auto r = builder.Resize(end - begin); !r.ok()) {
       return katana::ErrorCode::ArrowError;
@@ -168,7 +221,7 @@ public:
         bc += (*centrality_measure_.getRemote(j))[begin];
       }
 
-      if (auto r = builder.Append(bc); !r.ok()) {
+      if (auto r = builder.Append(bc * scale); !r.ok()) {
         return katana::ErrorCode::ArrowError;
       }
     }
@@ -210,6 +263,10 @@ private:
       this->InitArray(per_thread_distance_.getLocal());
       this->InitArray(per_thread_delta_.getLocal());
       this->InitArray(per_thread_successor_.getLocal());
+      *per_thread_squares_.getLocal() = nullptr;
+      if (track_squares_) {
+        this->InitArray(per_thread_squares_.getLocal());
+      }
     });
   }
 
@@ -223,6 +280,7 @@ private:
       this->DeleteArray(per_thread_distance_.getLocal());
       this->DeleteArray(per_thread_delta_.getLocal());
       this->DeleteArray(per_thread_successor_.getLocal());
+      this->DeleteArray(per_thread_squares_.getLocal());
     });
   }
 };
@@ -240,6 +298,13 @@ struct HasOut {
     return !edge_range.empty();
   }
 };
+
+/// The nodes [begin, end) as a batch of sources for BCOuter::RunInBatches
+auto
+NodeBatch(size_t begin, size_t end) {
+  return katana::iterate(
+      static_cast<OuterGNode>(begin), static_cast<OuterGNode>(end));
+}
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -287,9 +352,13 @@ BetweennessCentralityOuter(
   katana::StatTimer exec_time("Betweenness Centrality Outer");
   exec_time.start();
   if (sources == kBetweennessCentralityAllNodes) {
-    bc_outer.Run(katana::iterate(*pg));
+    KATANA_CHECKED(bc_outer.RunInBatches(graph.NumNodes(), NodeBatch));
   } else {
-    bc_outer.Run(source_vector);
+    KATANA_CHECKED(bc_outer.RunInBatches(
+        source_vector.size(), [&](size_t begin, size_t end) {
+          return katana::iterate(
+              source_vector.begin() + begin, source_vector.begin() + end);
+        }));
   }
   exec_time.stop();
 
@@ -307,3 +376,102 @@ BetweennessCentralityOuter(
 
   return katana::ResultSuccess();
 }
+
+katana::Result<void>
+BetweennessCentralityAdaptive(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    BetweennessCentralityPlan plan, katana::TxnContext* txn_ctx) {
+  if (!(plan.epsilon() > 0 && plan.epsilon() < 1 && plan.delta() > 0 &&
+        plan.delta() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "epsilon {} and delta {} must be in (0, 1)", plan.epsilon(),
+        plan.delta());
+  }
+
+  OuterGraph graph = KATANA_CHECKED(OuterGraph::Make(pg, {}, {}));
+  size_t num_nodes = graph.NumNodes();
+
+  BCOuter bc_outer(graph, true);
+
+  katana::EnsurePreallocated(
+      katana::getActiveThreads() * graph.NumNodes() / 1650);
+  katana::ReportPageAllocGuard page_alloc;
+
+  // Half of delta goes to the Hoeffding bound on the most sources needed and
+  // half to the batches, batch i getting delta / 2^(i + 2), each split over
+  // all nodes and both sides of the estimate.
+  double log_nodes = std::log(std::max<double>(num_nodes, 1));
+  double epsilon = plan.epsilon();
+  size_t max_sources = std::ceil(
+      (std::log(4 / plan.delta()) + log_nodes) / (2 * epsilon * epsilon));
+
+  katana::StatTimer exec_time("Betweenness Centrality Adaptive");
+  exec_time.start();
+
+  size_t num_sources = 0;
+  size_t num_batches = 0;
+  if (num_nodes < 3 || max_sources >= num_nodes) {
+    // every source costs no more than the samples the bound asks for
+    KATANA_CHECKED(bc_outer.RunInBatches(num_nodes, NodeBatch));
+    num_sources = num_nodes;
+  } else {
+    // a dependency is at most n - 2; scale them to [0, 1]
+    double norm = num_nodes - 2;
+    std::mt19937 generator;
+    std::uniform_int_distribution<uint32_t> pick(0, num_nodes - 1);
+    std::vector<uint32_t> batch;
+    size_t batch_size = 16 * katana::getActiveThreads();
+    while (num_sources < max_sources) {
+      KATANA_CHECKED(CheckProgress(
+          {"BetweennessCentrality", num_sources, max_sources - num_sources}));
+      batch.resize(std::min(batch_size, max_sources - num_sources));
+      for (uint32_t& source : batch) {
+        source = pick(generator);
+      }
+      bc_outer.Run(batch);
+      num_sources += batch.size();
+      num_batches += 1;
+      if (num_sources >= max_sources) {
+        break;
+      }
+
+      double log_term = std::log(4 / plan.delta()) + log_nodes +
+                        (num_batches + 1) * std::log(2.0);
+      double r = num_sources;
+      katana::GReduceMax<double> max_variance;
+      katana::do_all(
+          katana::iterate(graph),
+          [&](const OuterGNode& n) {
+            auto [sum, squares] = bc_outer.Sums(n);
+            double mean = sum / norm / r;
+            max_variance.update(std::max(
+                0.0, (squares / (norm * norm) - r * mean * mean) / (r - 1)));
+          },
+          katana::no_stats());
+      double bound = std::sqrt(2 * max_variance.reduce() * log_term / r) +
+                     7 * log_term / (3 * (r - 1));
+      if (bound <= epsilon) {
+        break;
+      }
+      batch_size *= 2;
+    }
+  }
+  exec_time.stop();
+
+  katana::ReportStatSingle(
+      "Betweenness Centrality Adaptive", "Sources", num_sources);
+  katana::ReportStatSingle(
+      "Betweenness Centrality Adaptive", "Batches", num_batches);
+
+  float scale = num_sources ? static_cast<float>(num_nodes) / num_sources : 0;
+  auto data = KATANA_CHECKED(
+      bc_outer.ExtractBCValues(0, graph.NumNodes(), scale));
+
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::float32())}),
+      {data});
+  KATANA_CHECKED(pg->AddNodeProperties(table, txn_ctx));
+
+  return katana::ResultSuccess();
+}
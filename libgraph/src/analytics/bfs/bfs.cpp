@@ -24,10 +24,15 @@
 
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/Frontier.h"
+#include "katana/NumaMem.h"
+#include "katana/PropertyColumn.h"
 #include "katana/Result.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/AsyncAnalytics.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/GpuAnalytics.h"
 
 using namespace katana::analytics;
 
@@ -37,13 +42,15 @@ namespace {
 using BfsNodeDistance = katana::PODProperty<uint32_t>;
 using BfsNodeParent = katana::PODProperty<uint32_t>;
 
+/// BFS computes the parents into a PropertyColumn, which becomes the output
+/// property at the end, so the graphs it runs on have no properties.
 struct BfsImplementation
     : BfsSsspImplementationBase<
-          katana::TypedPropertyGraph<std::tuple<BfsNodeParent>, std::tuple<>>,
-          unsigned int, false> {
+          katana::TypedPropertyGraph<std::tuple<>, std::tuple<>>, unsigned int,
+          false> {
   BfsImplementation(ptrdiff_t edge_tile_size)
       : BfsSsspImplementationBase<
-            katana::TypedPropertyGraph<std::tuple<BfsNodeParent>, std::tuple<>>,
+            katana::TypedPropertyGraph<std::tuple<>, std::tuple<>>,
             unsigned int, false>{edge_tile_size} {}
 };
 
@@ -51,10 +58,18 @@ using Graph = BfsImplementation::Graph;
 using GNode = Graph::Node;
 using Dist = BfsImplementation::Dist;
 using BiDirGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<>, std::tuple<>>;
+
+/// The graphs of the output property, for checking it
+using ParentGraph =
+    katana::TypedPropertyGraph<std::tuple<BfsNodeParent>, std::tuple<>>;
+using ParentBiDirGraphView = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::BiDirectional, std::tuple<BfsNodeParent>,
     std::tuple<>>;
 
 constexpr unsigned kChunkSize = 256U;
+/// How many nodes ahead the bottom-up step prefetches for
+constexpr unsigned kPrefetchDistance = 8U;
 
 constexpr bool kTrackWork = BfsImplementation::kTrackWork;
 
@@ -116,28 +131,6 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void
-WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
-  katana::do_all(
-      katana::iterate(wl), [&](const GNode& src) { bitset->set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
-}
-
-template <typename G, typename WL>
-void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
-  wl->clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
-        }
-      },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
-}
-
 template <typename T, typename P, typename R>
 void
 AsynchronousAlgo(
@@ -217,12 +210,12 @@ AsynchronousAlgo(
 }
 
 template <typename P>
-void
+katana::Result<void>
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
     const GNode source, const P& pushWrap, const uint32_t alpha,
     const uint32_t beta) {
-  using Cont = katana::InsertBag<GNode>;
+  using Cont = katana::Frontier<GNode>;
   using Loop = katana::DoAll;
 
   katana::GAccumulator<uint32_t> work_items;
@@ -231,17 +224,11 @@ SynchronousDirectOpt(
 
   Loop loop;
 
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
-
   uint32_t num_nodes = bidir_view.NumNodes();
   uint64_t num_edges = bidir_view.NumEdges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
-
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  auto frontier = std::make_unique<Cont>(num_nodes);
+  auto next_frontier = std::make_unique<Cont>(num_nodes);
 
   (*node_data)[source] = source;
 
@@ -256,12 +243,15 @@ SynchronousDirectOpt(
   katana::GAccumulator<uint64_t> writes_pull;
   katana::GAccumulator<uint64_t> writes_push;
 
+  uint64_t level = 0;
   while (!next_frontier->empty()) {
+    KATANA_CHECKED(CheckProgress({"Bfs", level++, next_frontier->size()}));
     std::swap(frontier, next_frontier);
     next_frontier->clear();
     if (scout_count > edges_to_check / alpha) {
       wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
+      frontier->ToDense();
+      next_frontier->ToDense();
       wl_to_bitset_timer.stop();
       do {
         old_num_work_items = work_items.reduce();
@@ -275,10 +265,10 @@ SynchronousDirectOpt(
                 for (auto e : bidir_view.InEdges(dst)) {
                   auto src = bidir_view.InEdgeSrc(e);
 
-                  if (front_bitset.test(src)) {
+                  if (frontier->test(src)) {
                     // assign parents on the bfs path.
                     ddata = src;
-                    next_bitset.set(dst);
+                    next_frontier->push(dst);
                     work_items += 1;
                     break;
                   }
@@ -286,21 +276,33 @@ SynchronousDirectOpt(
               }
             },
             katana::steal(), katana::chunk_size<kChunkSize>(),
+            katana::prefetch_distance<kPrefetchDistance>(
+                [&](const GNode& dst) -> const void* {
+                  // the frontier bit of the first in-neighbor
+                  auto edges = bidir_view.InEdges(dst);
+                  if (edges.empty()) {
+                    return nullptr;
+                  }
+                  auto src = bidir_view.InEdgeSrc(*edges.begin());
+                  return frontier->bitset().get_vec().data() +
+                         src / katana::DynamicBitset::kNumBitsInUint64;
+                }),
             katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
+        std::swap(frontier, next_frontier);
+        next_frontier->clear();
       } while (work_items.reduce() >= old_num_work_items ||
                (work_items.reduce() > num_nodes / beta));
       bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
+      std::swap(frontier, next_frontier);
+      next_frontier->ToSparse();
+      frontier->ToSparse();
       bitset_to_wl_timer.stop();
       scout_count = 1;
     } else {
       edges_to_check -= scout_count;
       work_items.reset();
 
-      loop(
-          katana::iterate(*frontier),
+      frontier->ForEach(
           [&](const GNode& src) {
             for (auto e : bidir_view.OutEdges(src)) {
               auto dst = bidir_view.OutEdgeDst(e);
@@ -319,6 +321,7 @@ SynchronousDirectOpt(
       scout_count = work_items.reduce();
     }
   }
+  return katana::ResultSuccess();
 }
 
 template <typename NDType, typename ValueTy>
@@ -329,14 +332,6 @@ InitNodeDataVec(const ValueTy& value, katana::NUMAArray<NDType>* node_data) {
   });
 }
 
-template <typename NDType>
-void
-UpdateGraphNodeData(Graph* graph, const katana::NUMAArray<NDType>& node_data) {
-  katana::do_all(katana::iterate(*graph), [&](auto& node) {
-    graph->GetData<BfsNodeParent>(node) = node_data[node];
-  });
-}
-
 void
 ComputeParentFromDistance(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_parent,
@@ -370,42 +365,33 @@ ComputeParentFromDistance(
 katana::Result<void>
 RunAlgo(
     BfsPlan algo, Graph* graph, const BiDirGraphView& bidir_view,
-    const GNode& source) {
+    const GNode& source, katana::PropertyColumn<GNode>* parents) {
   BfsImplementation impl{algo.edge_tile_size()};
   katana::StatTimer exec_time("BFS");
 
+  InitNodeDataVec(BfsImplementation::kDistanceInfinity, &parents->values());
+
   switch (algo.algorithm()) {
   case BfsPlan::kSynchronousDirectOpt: {
-    // Set up node data
-    katana::NUMAArray<GNode> node_data;
-    node_data.allocateInterleaved(graph->NumNodes());
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_data);
-
     exec_time.start();
-    SynchronousDirectOpt(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+    KATANA_CHECKED(SynchronousDirectOpt(
+        bidir_view, &parents->values(), source, NodePushWrap(), algo.alpha(),
+        algo.beta()));
     exec_time.stop();
-
-    UpdateGraphNodeData(graph, node_data);
     break;
   }
   case BfsPlan::kAsynchronous: {
-    katana::NUMAArray<GNode> node_parent;
     katana::NUMAArray<Dist> node_dist;
-    node_parent.allocateInterleaved(graph->NumNodes());
     node_dist.allocateInterleaved(graph->NumNodes());
 
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_parent);
     InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_dist);
 
     exec_time.start();
     AsynchronousAlgo<UpdateRequest>(
         *graph, source, &node_dist, ReqPushWrap(), OutEdgeRangeFn{graph});
-    ComputeParentFromDistance(bidir_view, &node_parent, node_dist, source);
+    ComputeParentFromDistance(
+        bidir_view, &parents->values(), node_dist, source);
     exec_time.stop();
-
-    UpdateGraphNodeData(graph, node_parent);
     break;
   }
   default:
@@ -420,7 +406,7 @@ RunAlgo(
 katana::Result<void>
 BfsImpl(
     Graph* graph, const BiDirGraphView& bidir_view, size_t start_node,
-    BfsPlan algo) {
+    BfsPlan algo, katana::PropertyColumn<GNode>* parents) {
   if (start_node >= graph->NumNodes()) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -440,13 +426,37 @@ BfsImpl(
   katana::EnsurePreallocated(8, approxNodeData);
   katana::ReportPageAllocGuard page_alloc;
 
-  if (auto res = RunAlgo(algo, graph, bidir_view, source); !res) {
+  if (auto res = RunAlgo(algo, graph, bidir_view, source, parents); !res) {
     return res.error();
   }
 
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+BfsGpu(
+    katana::PropertyGraph* pg, size_t start_node,
+    katana::PropertyColumn<GNode>* parents) {
+  if (start_node >= pg->NumNodes()) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  GpuAnalytics* gpu = KATANA_CHECKED(GetGpuAnalytics());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, pg->NumNodes()),
+      [&](size_t n) { (*parents)[n] = BfsImplementation::kDistanceInfinity; },
+      katana::no_stats());
+  (*parents)[start_node] = start_node;
+
+  katana::StatTimer exec_time("BFS");
+  exec_time.start();
+  KATANA_CHECKED(gpu->Bfs(
+      pg, start_node, BfsImplementation::kDistanceInfinity,
+      parents->values().data()));
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -454,24 +464,26 @@ katana::analytics::Bfs(
     PropertyGraph* pg, GNode start_node,
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     BfsPlan algo) {
-  if (auto result = pg->ConstructNodeProperties<std::tuple<BfsNodeParent>>(
-          txn_ctx, {output_property_name});
-      !result) {
-    return result.error();
+  if (algo.architecture() == kGPU) {
+    auto parents =
+        katana::PropertyColumn<GNode>::MakeInterleaved(pg->NumNodes());
+    KATANA_CHECKED(BfsGpu(pg, start_node, &parents));
+    return pg->AddNodeProperty(
+        output_property_name, std::move(parents), txn_ctx);
   }
 
-  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
-  auto bidir_view =
-      KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+  auto bidir_view = KATANA_CHECKED(BiDirGraphView::Make(pg, {}, {}));
 
-  /*
-  auto pg_result = Graph::Make(pg, {output_property_name}, {});
-  if (!pg_result) {
-    return pg_result.error();
-  }
-  */
+  // The views are accounted for as topologies; the node data arrays from
+  // here on are the analytic's own
+  katana::AllocationAccount account("analytics");
+  auto parents = katana::PropertyColumn<GNode>::MakeInterleaved(pg->NumNodes());
+  KATANA_CHECKED(BfsImpl(&graph, bidir_view, start_node, algo, &parents));
 
-  return BfsImpl(&graph, bidir_view, start_node, algo);
+  // the parents become the property without a copy
+  return pg->AddNodeProperty(
+      output_property_name, std::move(parents), txn_ctx);
 }
 
 template <typename LevelVec>
@@ -518,7 +530,7 @@ ComputeLevels(
 template <typename LevelVec>
 katana::Result<void>
 CheckParentByLevel(
-    const BiDirGraphView& bidir_view, const GNode& source,
+    const ParentBiDirGraphView& bidir_view, const GNode& source,
     const LevelVec& levels) {
   if (levels[source] != 0u ||
       bidir_view.GetData<BfsNodeParent>(source) != source) {
@@ -612,9 +624,9 @@ katana::Result<void>
 katana::analytics::BfsAssertValid(
     PropertyGraph* pg, const GNode source,
     const std::string& output_property_name) {
-  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
-  auto bidir_view =
-      KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+  auto bidir_view = KATANA_CHECKED(
+      ParentBiDirGraphView::Make(pg, {output_property_name}, {}));
 
   katana::NUMAArray<Dist> levels;
   levels.allocateInterleaved(graph.NumNodes());
@@ -630,12 +642,12 @@ katana::analytics::BfsAssertValid(
 katana::Result<BfsStatistics>
 katana::analytics::BfsStatistics::Compute(
     katana::PropertyGraph* pg, const std::string& property_name) {
-  auto pg_result = BfsImplementation::Graph::Make(pg, {property_name}, {});
+  auto pg_result = ParentGraph::Make(pg, {property_name}, {});
   if (!pg_result) {
     return pg_result.error();
   }
 
-  BfsImplementation::Graph graph = pg_result.value();
+  ParentGraph graph = pg_result.value();
 
   GNode source_node = std::numeric_limits<GNode>::max();
   GAccumulator<uint64_t> num_visited;
@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Frontier.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BfsNodeLevel = katana::PODProperty<uint32_t>;
+
+using LevelGraph =
+    katana::TypedPropertyGraph<std::tuple<BfsNodeLevel>, std::tuple<>>;
+using BiDirGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<>, std::tuple<>>;
+using GNode = BiDirGraphView::Node;
+using Level = uint32_t;
+
+constexpr Level kLevelInfinity = std::numeric_limits<Level>::max() / 4;
+constexpr unsigned kChunkSize = 256U;
+constexpr size_t kBitsPerWord = katana::DynamicBitset::kNumBitsInUint64;
+/// Most sources searched together, in kMaxWords words per node
+constexpr size_t kMaxWords = 8;
+
+/// The BFS from up to 64 * kWords sources at once, as in MS-BFS: every node
+/// holds a bit per source in each of seen, visit and next, and scanning the
+/// edges of a node advances the search of all the sources whose frontier
+/// the node is in.
+///
+/// Each level either pushes the visit bits of frontier nodes to their out
+/// neighbors, or has every node that some source has not yet seen pull the
+/// visit bits of its in neighbors, stopping as soon as all those sources have
+/// seen it. Like BfsPlan::SynchronousDirectOpt, the search pulls when the
+/// out edges of the frontier outnumber the unexplored edges divided by
+/// alpha, and pushes again once the frontier shrinks below the nodes of the
+/// graph divided by beta.
+template <size_t kWords>
+class MultiSourceBfsBatch {
+  using Bits = std::array<uint64_t, kWords>;
+
+public:
+  explicit MultiSourceBfsBatch(const BiDirGraphView& view)
+      : view_(view), frontier_(view.NumNodes()), touched_(view.NumNodes()) {
+    seen_.allocateInterleaved(view.NumNodes());
+    visit_.allocateInterleaved(view.NumNodes());
+    next_.allocateInterleaved(view.NumNodes());
+  }
+
+  /// Runs the BFS from sources, calling record(node, i, level) for each
+  /// node reached from sources[i]. record is called concurrently, but never
+  /// for the same node.
+  template <typename Record>
+  void Run(
+      const std::vector<GNode>& sources, bool direction_optimizing,
+      uint32_t alpha, uint32_t beta, const Record& record) {
+    KATANA_LOG_DEBUG_ASSERT(sources.size() <= kWords * kBitsPerWord);
+    Reset(sources.size());
+
+    frontier_.clear();
+    for (size_t i = 0; i < sources.size(); ++i) {
+      GNode src = sources[i];
+      uint64_t bit = uint64_t{1} << (i % kBitsPerWord);
+      // frontier_ is sparse; push each source node once
+      if (IsZero(visit_[src])) {
+        frontier_.push(src);
+      }
+      visit_[src][i / kBitsPerWord] |= bit;
+      seen_[src][i / kBitsPerWord] |= bit;
+      record(src, i, Level{0});
+    }
+
+    uint64_t num_nodes = view_.NumNodes();
+    int64_t edges_to_check = view_.NumEdges();
+    int64_t scout_count = 0;
+    for (GNode src : sources) {
+      scout_count += view_.OutDegree(src);
+    }
+    size_t frontier_size = frontier_.size();
+    size_t old_frontier_size = 0;
+    bool pull = false;
+
+    touched_.ToDense();
+    for (Level level = 1; !frontier_.empty(); ++level) {
+      if (direction_optimizing) {
+        if (!pull) {
+          pull = scout_count > edges_to_check / alpha;
+        } else {
+          pull = frontier_size >= old_frontier_size ||
+                 frontier_size > num_nodes / beta;
+        }
+      }
+
+      if (pull) {
+        Pull();
+      } else {
+        edges_to_check -= scout_count;
+        Push();
+      }
+
+      frontier_.ForEach(
+          [&](GNode n) { visit_[n] = Bits{}; }, katana::no_stats());
+      frontier_.clear();
+      scout_count = Advance(level, record);
+      frontier_.Adapt();
+      old_frontier_size = frontier_size;
+      frontier_size = frontier_.size();
+    }
+  }
+
+private:
+  static bool IsZero(const Bits& bits) {
+    return std::all_of(
+        bits.begin(), bits.end(), [](uint64_t w) { return w == 0; });
+  }
+
+  void Reset(size_t num_sources) {
+    for (size_t w = 0; w < kWords; ++w) {
+      size_t first = w * kBitsPerWord;
+      if (num_sources >= first + kBitsPerWord) {
+        mask_[w] = ~uint64_t{0};
+      } else if (num_sources > first) {
+        mask_[w] = (uint64_t{1} << (num_sources - first)) - 1;
+      } else {
+        mask_[w] = 0;
+      }
+    }
+    katana::do_all(
+        katana::iterate(view_),
+        [&](GNode n) {
+          seen_[n] = Bits{};
+          visit_[n] = Bits{};
+          next_[n] = Bits{};
+        },
+        katana::no_stats());
+  }
+
+  /// Ors the visit bits of frontier nodes into next of their out neighbors
+  void Push() {
+    frontier_.ForEach(
+        [&](GNode src) {
+          const Bits& bits = visit_[src];
+          for (auto e : view_.OutEdges(src)) {
+            GNode dst = view_.OutEdgeDst(e);
+            Bits& dst_next = next_[dst];
+            bool fresh = false;
+            for (size_t w = 0; w < kWords; ++w) {
+              uint64_t add = bits[w] & ~seen_[dst][w];
+              if (add != 0 &&
+                  (__atomic_load_n(&dst_next[w], __ATOMIC_RELAXED) & add) !=
+                      add) {
+                __atomic_fetch_or(&dst_next[w], add, __ATOMIC_RELAXED);
+                fresh = true;
+              }
+            }
+            if (fresh) {
+              touched_.push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("MultiSourceBfs-push"));
+  }
+
+  /// Has every node not yet seen by all sources or the visit bits of its in
+  /// neighbors into its next
+  void Pull() {
+    katana::do_all(
+        katana::iterate(view_),
+        [&](GNode dst) {
+          Bits unseen;
+          bool any_unseen = false;
+          for (size_t w = 0; w < kWords; ++w) {
+            unseen[w] = mask_[w] & ~seen_[dst][w];
+            any_unseen |= unseen[w] != 0;
+          }
+          if (!any_unseen) {
+            return;
+          }
+
+          Bits found{};
+          for (auto e : view_.InEdges(dst)) {
+            const Bits& bits = visit_[view_.InEdgeSrc(e)];
+            bool done = true;
+            for (size_t w = 0; w < kWords; ++w) {
+              found[w] |= bits[w] & unseen[w];
+              done &= found[w] == unseen[w];
+            }
+            if (done) {
+              break;
+            }
+          }
+          if (!IsZero(found)) {
+            next_[dst] = found;
+            touched_.push(dst);
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("MultiSourceBfs-pull"));
+  }
+
+  /// Moves the bits in next that are not yet seen into seen and visit,
+  /// records their level and makes their nodes the new frontier. Returns the
+  /// out edges of the new frontier.
+  template <typename Record>
+  int64_t Advance(Level level, const Record& record) {
+    katana::GAccumulator<int64_t> scout_count;
+    touched_.ForEach(
+        [&](GNode n) {
+          Bits& n_next = next_[n];
+          Bits& n_seen = seen_[n];
+          Bits fresh;
+          for (size_t w = 0; w < kWords; ++w) {
+            fresh[w] = n_next[w] & ~n_seen[w];
+            n_seen[w] |= fresh[w];
+          }
+          n_next = Bits{};
+          if (IsZero(fresh)) {
+            return;
+          }
+
+          visit_[n] = fresh;
+          frontier_.push(n);
+          scout_count += view_.OutDegree(n);
+          for (size_t w = 0; w < kWords; ++w) {
+            for (uint64_t bits = fresh[w]; bits != 0; bits &= bits - 1) {
+              record(n, w * kBitsPerWord + __builtin_ctzll(bits), level);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("MultiSourceBfs-advance"));
+    touched_.clear();
+    return scout_count.reduce();
+  }
+
+  const BiDirGraphView& view_;
+  katana::NUMAArray<Bits> seen_;
+  katana::NUMAArray<Bits> visit_;
+  katana::NUMAArray<Bits> next_;
+  Bits mask_{};
+  katana::Frontier<GNode> frontier_;
+  /// Nodes whose next changed in this level
+  katana::Frontier<GNode> touched_;
+};
+
+/// Runs MultiSourceBfsBatch over batches of the sources, each with as few
+/// words per node as fit it; record(node, i, level) gets indices into
+/// sources
+template <typename Record>
+katana::Result<void>
+RunBatches(
+    const BiDirGraphView& view, const std::vector<GNode>& sources,
+    const BfsPlan& algo, const Record& record) {
+  bool direction_optimizing;
+  switch (algo.algorithm()) {
+  case BfsPlan::kSynchronousDirectOpt:
+    direction_optimizing = true;
+    break;
+  case BfsPlan::kSynchronous:
+    direction_optimizing = false;
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
+        algo.algorithm());
+  }
+  if (direction_optimizing && (algo.alpha() == 0 || algo.beta() == 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha and beta must be positive");
+  }
+  for (GNode src : sources) {
+    if (src >= view.NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "start node {} out of range",
+          src);
+    }
+  }
+
+  constexpr size_t kMaxBatch = kMaxWords * kBitsPerWord;
+  for (size_t first = 0; first < sources.size(); first += kMaxBatch) {
+    size_t last = std::min(sources.size(), first + kMaxBatch);
+    std::vector<GNode> batch(sources.begin() + first, sources.begin() + last);
+    auto batch_record = [&](GNode n, size_t i, Level level) {
+      record(n, first + i, level);
+    };
+    auto run = [&](auto words) {
+      MultiSourceBfsBatch<decltype(words)::value> bfs(view);
+      bfs.Run(
+          batch, direction_optimizing, algo.alpha(), algo.beta(),
+          batch_record);
+    };
+
+    size_t words = (batch.size() + kBitsPerWord - 1) / kBitsPerWord;
+    if (words <= 1) {
+      run(std::integral_constant<size_t, 1>{});
+    } else if (words <= 2) {
+      run(std::integral_constant<size_t, 2>{});
+    } else if (words <= 4) {
+      run(std::integral_constant<size_t, 4>{});
+    } else {
+      run(std::integral_constant<size_t, kMaxWords>{});
+    }
+  }
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& start_nodes,
+    const std::vector<std::string>& output_property_names,
+    katana::TxnContext* txn_ctx, BfsPlan algo) {
+  if (start_nodes.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} start nodes but {} output properties", start_nodes.size(),
+        output_property_names.size());
+  }
+
+  std::vector<LevelGraph> level_graphs;
+  level_graphs.reserve(start_nodes.size());
+  for (const std::string& name : output_property_names) {
+    KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<BfsNodeLevel>>(
+        txn_ctx, {name}));
+    level_graphs.emplace_back(KATANA_CHECKED(LevelGraph::Make(pg, {name}, {})));
+  }
+  auto view = KATANA_CHECKED(BiDirGraphView::Make(pg, {}, {}));
+
+  katana::AllocationAccount account("analytics");
+  katana::do_all(
+      katana::iterate(view),
+      [&](GNode n) {
+        for (auto& graph : level_graphs) {
+          graph.GetData<BfsNodeLevel>(n) = kLevelInfinity;
+        }
+      },
+      katana::no_stats());
+
+  katana::StatTimer exec_time("MultiSourceBfs");
+  exec_time.start();
+  auto res = RunBatches(
+      view, start_nodes, algo, [&](GNode n, size_t i, Level level) {
+        level_graphs[i].GetData<BfsNodeLevel>(n) = level;
+      });
+  exec_time.stop();
+  return res;
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::MultiSourceBfsDistances(
+    PropertyGraph* pg, const std::vector<uint32_t>& start_nodes,
+    BfsPlan algo) {
+  auto view = KATANA_CHECKED(BiDirGraphView::Make(pg, {}, {}));
+  size_t num_sources = start_nodes.size();
+
+  // the indices of start_nodes, grouped by node, for looking up which
+  // sources a reached node is
+  std::vector<std::pair<GNode, size_t>> source_index(num_sources);
+  katana::DynamicBitset is_source;
+  is_source.resize(view.NumNodes());
+  for (size_t j = 0; j < num_sources; ++j) {
+    source_index[j] = {start_nodes[j], j};
+    if (start_nodes[j] < view.NumNodes()) {
+      is_source.set(start_nodes[j]);
+    }
+  }
+  std::sort(source_index.begin(), source_index.end());
+
+  std::vector<uint32_t> distances(num_sources * num_sources, kLevelInfinity);
+  katana::AllocationAccount account("analytics");
+  katana::StatTimer exec_time("MultiSourceBfsDistances");
+  exec_time.start();
+  auto res = RunBatches(
+      view, start_nodes, algo, [&](GNode n, size_t i, Level level) {
+        if (!is_source.test(n)) {
+          return;
+        }
+        auto it = std::lower_bound(
+            source_index.begin(), source_index.end(),
+            std::make_pair(n, size_t{0}));
+        for (; it != source_index.end() && it->first == n; ++it) {
+          distances[i * num_sources + it->second] = level;
+        }
+      });
+  exec_time.stop();
+  KATANA_CHECKED(res);
+  return distances;
+}
@@ -0,0 +1,106 @@
+#include <atomic>
+#include <memory>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyColumn.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TemporalView.h"
+#include "katana/analytics/AsyncAnalytics.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using GNode = katana::TemporalView::Node;
+using Timestamp = katana::TemporalView::Timestamp;
+
+constexpr unsigned kChunkSize = 256U;
+
+/// Rounds of relaxing the edges of the nodes whose arrival time dropped in
+/// the previous round. The edges of a node are sorted by timestamp, so those
+/// that leave it no earlier than it is reached are a suffix found by binary
+/// search.
+katana::Result<void>
+ComputeEarliestArrival(
+    const katana::TemporalView& window, GNode source,
+    katana::NUMAArray<std::atomic<Timestamp>>* arrival) {
+  auto curr = std::make_unique<katana::InsertBag<GNode>>();
+  auto next = std::make_unique<katana::InsertBag<GNode>>();
+
+  (*arrival)[source] = window.window_begin();
+  next->push(source);
+
+  katana::GAccumulator<uint64_t> pushed;
+  uint64_t round = 0;
+  while (!next->empty()) {
+    std::swap(curr, next);
+    next->clear();
+    pushed.reset();
+    ++round;
+
+    katana::do_all(
+        katana::iterate(*curr),
+        [&](GNode src) {
+          const Timestamp t = (*arrival)[src].load(std::memory_order_relaxed);
+          for (auto e : window.OutEdgesAtOrAfter(src, t)) {
+            const GNode dst = window.OutEdgeDst(e);
+            const Timestamp te = window.GetEdgeTimestamp(e);
+            if (te < katana::atomicMin((*arrival)[dst], te)) {
+              next->push(dst);
+              pushed += 1;
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("TemporalBfs"));
+
+    KATANA_CHECKED(CheckProgress({"TemporalBfs", round, pushed.reduce(), 0}));
+  }
+  katana::ReportStatSingle("TemporalBfs", "Rounds", round);
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::TemporalBfs(
+    PropertyGraph* pg, const TemporalView& window, uint32_t start_node,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  if (window.is_transposed()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "temporal BFS follows out edges, but the view is transposed");
+  }
+  if (start_node >= window.NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "start node {} does not exist",
+        start_node);
+  }
+
+  katana::AllocationAccount account("analytics");
+  katana::NUMAArray<std::atomic<Timestamp>> arrival;
+  arrival.allocateInterleaved(window.NumNodes());
+  katana::do_all(
+      katana::iterate(window.Nodes()),
+      [&](GNode n) { arrival[n] = TemporalView::kMaxTimestamp; },
+      katana::no_stats());
+
+  katana::StatTimer exec_time("TemporalBfs");
+  exec_time.start();
+  KATANA_CHECKED(ComputeEarliestArrival(window, start_node, &arrival));
+  exec_time.stop();
+
+  auto output = katana::PropertyColumn<Timestamp>::MakeInterleaved(
+      window.NumNodes());
+  katana::do_all(
+      katana::iterate(window.Nodes()),
+      [&](GNode n) { output[n] = arrival[n]; },
+      katana::no_stats());
+  return pg->AddNodeProperty(output_property_name, std::move(output), txn_ctx);
+}
@@ -0,0 +1,540 @@
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+struct Partner : public katana::PODProperty<uint32_t> {};
+
+using NodeData = std::tuple<Partner>;
+using EdgeData = std::tuple<>;
+
+using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+using GNode = Graph::Node;
+
+enum Side : uint8_t { kNeither, kLeft, kRight };
+
+/// The side of every node, by the node types named left_node_type and
+/// right_node_type
+katana::Result<katana::NUMAArray<uint8_t>>
+NodeSides(
+    const katana::PropertyGraph& pg, const std::string& left_node_type,
+    const std::string& right_node_type) {
+  for (const std::string& type : {left_node_type, right_node_type}) {
+    if (!pg.HasAtomicNodeType(type)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "no node type named {}", type);
+    }
+  }
+  if (left_node_type == right_node_type) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "both sides are of type {}",
+        left_node_type);
+  }
+  katana::EntityTypeID left = pg.GetNodeEntityTypeID(left_node_type);
+  katana::EntityTypeID right = pg.GetNodeEntityTypeID(right_node_type);
+
+  katana::NUMAArray<uint8_t> sides;
+  sides.allocateBlocked(pg.NumNodes());
+  katana::GReduceLogicalOr both;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, static_cast<uint32_t>(pg.NumNodes())),
+      [&](uint32_t n) {
+        bool is_left = pg.DoesNodeHaveType(n, left);
+        bool is_right = pg.DoesNodeHaveType(n, right);
+        both.update(is_left && is_right);
+        sides[n] = is_left ? kLeft : (is_right ? kRight : kNeither);
+      },
+      katana::no_stats());
+  if (both.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a node is of both type {} and type {}", left_node_type,
+        right_node_type);
+  }
+  return std::move(sides);
+}
+
+/// The bipartite graph: the neighbors of a left node are the right nodes it
+/// has an edge to or from, and the other way around. Parallel and
+/// antiparallel edges make repeated neighbors, which do no harm.
+struct BipartiteGraph {
+  /// The neighbors of node n are [offsets[n], offsets[n + 1])
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> neighbors;
+  /// The left nodes with neighbors
+  std::vector<uint32_t> lefts;
+
+  uint32_t NumNodes() const { return offsets.size() - 1; }
+  uint64_t Degree(uint32_t n) const { return offsets[n + 1] - offsets[n]; }
+
+  BipartiteGraph(
+      const katana::GraphTopology& topology,
+      const katana::NUMAArray<uint8_t>& sides) {
+    uint32_t num_nodes = topology.NumNodes();
+    auto crosses = [&](uint32_t n, uint32_t dest) {
+      return sides[n] != kNeither && sides[dest] != kNeither &&
+             sides[n] != sides[dest];
+    };
+
+    katana::NUMAArray<uint64_t> out_degrees;
+    katana::NUMAArray<std::atomic<uint64_t>> cursors;
+    out_degrees.allocateBlocked(num_nodes);
+    cursors.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) { cursors[n].store(0, std::memory_order_relaxed); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          uint64_t degree = 0;
+          for (auto e : topology.OutEdges(n)) {
+            uint32_t dest = topology.OutEdgeDst(e);
+            if (crosses(n, dest)) {
+              ++degree;
+              cursors[dest].fetch_add(1, std::memory_order_relaxed);
+            }
+          }
+          out_degrees[n] = degree;
+        },
+        katana::steal(), katana::no_stats());
+
+    offsets.allocateBlocked(num_nodes + 1);
+    offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) { offsets[n + 1] = out_degrees[n] + cursors[n]; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets.begin(), offsets.end(), offsets.begin());
+    // the destinations of the edges of a node come first, then the sources
+    // of the edges to it
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) { cursors[n].store(offsets[n] + out_degrees[n]); },
+        katana::no_stats());
+
+    neighbors.allocateBlocked(offsets[num_nodes]);
+    katana::PerThreadStorage<std::vector<uint32_t>> local_lefts;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          uint64_t next = offsets[n];
+          for (auto e : topology.OutEdges(n)) {
+            uint32_t dest = topology.OutEdgeDst(e);
+            if (crosses(n, dest)) {
+              neighbors[next++] = dest;
+              neighbors[cursors[dest].fetch_add(1)] = n;
+            }
+          }
+          if (sides[n] == kLeft && Degree(n) > 0) {
+            local_lefts.getLocal()->emplace_back(n);
+          }
+        },
+        katana::steal(), katana::no_stats());
+    for (unsigned t = 0; t < local_lefts.size(); ++t) {
+      std::vector<uint32_t>& local = *local_lefts.getRemote(t);
+      lefts.insert(lefts.end(), local.begin(), local.end());
+    }
+  }
+};
+
+class PothenFan {
+public:
+  explicit PothenFan(const BipartiteGraph& graph) : graph_(graph) {
+    uint32_t num_nodes = graph_.NumNodes();
+    mates_.allocateBlocked(num_nodes);
+    visited_.allocateBlocked(num_nodes);
+    lookahead_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          mates_[n].store(kUnmatchedNode, std::memory_order_relaxed);
+          visited_[n].store(0, std::memory_order_relaxed);
+          lookahead_[n] = graph_.offsets[n];
+        },
+        katana::no_stats());
+  }
+
+  uint32_t Mate(uint32_t n) const {
+    return mates_[n].load(std::memory_order_relaxed);
+  }
+
+  /// Match the left nodes with a single unmatched neighbor to it, then the
+  /// others to any unmatched neighbor, following the chains of left nodes
+  /// left with a single unmatched neighbor by each match
+  void KarpSipser() {
+    uint32_t num_nodes = graph_.NumNodes();
+    degrees_.allocateBlocked(num_nodes);
+    claimed_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(graph_.lefts.begin(), graph_.lefts.end()),
+        [&](uint32_t n) {
+          degrees_[n].store(graph_.Degree(n), std::memory_order_relaxed);
+          claimed_[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+
+    katana::PerThreadStorage<std::vector<uint32_t>> chains;
+    katana::do_all(
+        katana::iterate(graph_.lefts.begin(), graph_.lefts.end()),
+        [&](uint32_t n) {
+          if (degrees_[n].load(std::memory_order_relaxed) == 1) {
+            KarpSipserVisit(n, chains.getLocal());
+          }
+        },
+        katana::steal(), katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph_.lefts.begin(), graph_.lefts.end()),
+        [&](uint32_t n) { KarpSipserVisit(n, chains.getLocal()); },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Augment the matching to a maximum one
+  void Run() {
+    std::vector<uint32_t> unmatched;
+    for (uint32_t n : graph_.lefts) {
+      if (Mate(n) == kUnmatchedNode) {
+        unmatched.emplace_back(n);
+      }
+    }
+
+    katana::PerThreadStorage<std::vector<Frame>> stacks;
+    for (uint32_t phase = 1; !unmatched.empty(); ++phase) {
+      katana::GAccumulator<uint64_t> augmented;
+      katana::do_all(
+          katana::iterate(unmatched.begin(), unmatched.end()),
+          [&](uint32_t n) {
+            if (Augment(n, phase, stacks.getLocal())) {
+              augmented += 1;
+            }
+          },
+          katana::steal(), katana::no_stats());
+      // with no path augmented, the searches of the phase together searched
+      // all of the alternating paths from the unmatched nodes
+      if (augmented.reduce() == 0) {
+        break;
+      }
+      unmatched.erase(
+          std::remove_if(
+              unmatched.begin(), unmatched.end(),
+              [&](uint32_t n) { return Mate(n) != kUnmatchedNode; }),
+          unmatched.end());
+    }
+  }
+
+private:
+  /// A left node on the path of a search, the neighbors it has left to try
+  /// and the right node the path goes on to
+  struct Frame {
+    uint32_t left;
+    uint64_t remaining;
+    uint32_t right;
+  };
+
+  void KarpSipserVisit(uint32_t n, std::vector<uint32_t>* chain) {
+    chain->clear();
+    chain->emplace_back(n);
+    while (!chain->empty()) {
+      uint32_t left = chain->back();
+      chain->pop_back();
+      if (claimed_[left].exchange(1, std::memory_order_relaxed) == 0) {
+        KarpSipserMatch(left, chain);
+      }
+    }
+  }
+
+  /// Match left to its first unmatched neighbor, and add to chain the left
+  /// nodes that the match leaves with a single unmatched neighbor
+  void KarpSipserMatch(uint32_t left, std::vector<uint32_t>* chain) {
+    for (uint64_t a = graph_.offsets[left]; a < graph_.offsets[left + 1];
+         ++a) {
+      uint32_t right = graph_.neighbors[a];
+      uint32_t unmatched = kUnmatchedNode;
+      if (Mate(right) != kUnmatchedNode ||
+          !mates_[right].compare_exchange_strong(unmatched, left)) {
+        continue;
+      }
+      mates_[left].store(right, std::memory_order_relaxed);
+      for (uint64_t b = graph_.offsets[right]; b < graph_.offsets[right + 1];
+           ++b) {
+        uint32_t other = graph_.neighbors[b];
+        if (other != left &&
+            degrees_[other].fetch_sub(1, std::memory_order_relaxed) == 2) {
+          chain->emplace_back(other);
+        }
+      }
+      return;
+    }
+  }
+
+  /// Claim right for the searches of phase; a right node is searched by
+  /// one search a phase, so the paths augmented in a phase are disjoint
+  bool Claim(uint32_t right, uint32_t phase) {
+    return visited_[right].exchange(phase, std::memory_order_relaxed) !=
+           phase;
+  }
+
+  /// An unmatched neighbor of left, claimed for phase, or kUnmatchedNode.
+  /// Matched nodes stay matched, so the neighbors passed over are never
+  /// looked at again; an unmatched node claimed by another search is
+  /// matched by that search.
+  uint32_t LookAhead(uint32_t left, uint32_t phase) {
+    for (uint64_t& a = lookahead_[left]; a < graph_.offsets[left + 1];) {
+      uint32_t right = graph_.neighbors[a++];
+      if (Mate(right) == kUnmatchedNode && Claim(right, phase)) {
+        return right;
+      }
+    }
+    return kUnmatchedNode;
+  }
+
+  Frame NewFrame(uint32_t left) const {
+    return Frame{left, graph_.Degree(left), kUnmatchedNode};
+  }
+
+  /// The next neighbor of frame to try: phases alternate between searching
+  /// neighbors first to last and last to first, so that no search always
+  /// goes down the same paths first
+  uint32_t NextNeighbor(Frame* frame, uint32_t phase) const {
+    uint64_t begin = graph_.offsets[frame->left];
+    uint64_t i = --frame->remaining;
+    if (phase % 2 == 1) {
+      i = graph_.Degree(frame->left) - 1 - i;
+    }
+    return graph_.neighbors[begin + i];
+  }
+
+  /// Search depth first for an augmenting path from the unmatched node root
+  /// and augment the matching along it
+  bool Augment(uint32_t root, uint32_t phase, std::vector<Frame>* stack) {
+    stack->clear();
+    stack->emplace_back(NewFrame(root));
+    while (!stack->empty()) {
+      Frame& frame = stack->back();
+      if (uint32_t right = LookAhead(frame.left, phase);
+          right != kUnmatchedNode) {
+        frame.right = right;
+        Flip(*stack);
+        return true;
+      }
+      uint32_t next = kUnmatchedNode;
+      while (frame.remaining > 0 && next == kUnmatchedNode) {
+        uint32_t right = NextNeighbor(&frame, phase);
+        if (!Claim(right, phase)) {
+          continue;
+        }
+        frame.right = right;
+        next = Mate(right);
+        if (next == kUnmatchedNode) {
+          Flip(*stack);
+          return true;
+        }
+      }
+      if (next == kUnmatchedNode) {
+        stack->pop_back();
+      } else {
+        stack->emplace_back(NewFrame(next));
+      }
+    }
+    return false;
+  }
+
+  /// Match every left node of the path to the right node after it
+  void Flip(const std::vector<Frame>& path) {
+    for (const Frame& frame : path) {
+      mates_[frame.left].store(frame.right, std::memory_order_relaxed);
+      mates_[frame.right].store(frame.left, std::memory_order_relaxed);
+    }
+  }
+
+  const BipartiteGraph& graph_;
+  katana::NUMAArray<std::atomic<uint32_t>> mates_;
+  /// The last phase that each right node was claimed in
+  katana::NUMAArray<std::atomic<uint32_t>> visited_;
+  /// The next neighbor that each left node looks ahead at
+  katana::NUMAArray<uint64_t> lookahead_;
+  /// The number of neighbors of each left node not matched by Karp-Sipser
+  katana::NUMAArray<std::atomic<uint64_t>> degrees_;
+  /// Whether Karp-Sipser has tried to match each left node
+  katana::NUMAArray<std::atomic<uint8_t>> claimed_;
+};
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::BipartiteMatching(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BipartiteMatchingPlan plan) {
+  if (plan.algorithm() != BipartiteMatchingPlan::kPothenFan) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm: {}",
+        plan.algorithm());
+  }
+  katana::NUMAArray<uint8_t> sides =
+      KATANA_CHECKED(NodeSides(*pg, left_node_type, right_node_type));
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("BipartiteMatching");
+  exec_time.start();
+  BipartiteGraph bipartite(pg->topology(), sides);
+  PothenFan matcher(bipartite);
+  if (plan.karp_sipser_init()) {
+    matcher.KarpSipser();
+  }
+  matcher.Run();
+
+  katana::GAccumulator<uint64_t> cardinality;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        uint32_t mate = matcher.Mate(n);
+        graph.GetData<Partner>(n) = mate;
+        if (mate != kUnmatchedNode && sides[n] == kLeft) {
+          cardinality += 1;
+        }
+      },
+      katana::no_stats());
+  exec_time.stop();
+  page_alloc.Report();
+
+  return cardinality.reduce();
+}
+
+katana::Result<void>
+katana::analytics::BipartiteMatchingAssertValid(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  katana::NUMAArray<uint8_t> sides =
+      KATANA_CHECKED(NodeSides(*pg, left_node_type, right_node_type));
+  BipartiteGraph bipartite(pg->topology(), sides);
+  uint32_t num_nodes = bipartite.NumNodes();
+
+  katana::GReduceLogicalOr invalid;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        uint32_t mate = graph.GetData<Partner>(n);
+        if (mate == kUnmatchedNode) {
+          return;
+        }
+        if (mate >= num_nodes || graph.GetData<Partner>(mate) != n ||
+            sides[n] == kNeither) {
+          invalid.update(true);
+          return;
+        }
+        const uint32_t* begin =
+            bipartite.neighbors.data() + bipartite.offsets[n];
+        const uint32_t* end =
+            bipartite.neighbors.data() + bipartite.offsets[n + 1];
+        invalid.update(std::find(begin, end, mate) == end);
+      },
+      katana::steal(), katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the partners are not a matching of the bipartite graph");
+  }
+
+  // a breadth first search along alternating paths from the unmatched left
+  // nodes must not reach an unmatched right node
+  katana::NUMAArray<std::atomic<uint8_t>> reached;
+  reached.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { reached[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  std::vector<uint32_t> frontier;
+  for (uint32_t n : bipartite.lefts) {
+    if (graph.GetData<Partner>(n) == kUnmatchedNode) {
+      frontier.emplace_back(n);
+    }
+  }
+  katana::GReduceLogicalOr augmenting;
+  while (!frontier.empty() && !augmenting.reduce()) {
+    katana::PerThreadStorage<std::vector<uint32_t>> next;
+    katana::do_all(
+        katana::iterate(frontier.begin(), frontier.end()),
+        [&](uint32_t n) {
+          for (uint64_t a = bipartite.offsets[n]; a < bipartite.offsets[n + 1];
+               ++a) {
+            uint32_t right = bipartite.neighbors[a];
+            if (reached[right].exchange(1, std::memory_order_relaxed)) {
+              continue;
+            }
+            uint32_t mate = graph.GetData<Partner>(right);
+            if (mate == kUnmatchedNode) {
+              augmenting.update(true);
+            } else {
+              next.getLocal()->emplace_back(mate);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    frontier.clear();
+    for (unsigned t = 0; t < next.size(); ++t) {
+      std::vector<uint32_t>& local = *next.getRemote(t);
+      frontier.insert(frontier.end(), local.begin(), local.end());
+    }
+  }
+  if (augmenting.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the matching has an augmenting path, so it is not a maximum one");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::BipartiteMatchingStatistics::Print(std::ostream& os) const {
+  os << "Size of the matching = " << cardinality << std::endl;
+  os << "Unmatched left nodes = " << unmatched_left << std::endl;
+  os << "Unmatched right nodes = " << unmatched_right << std::endl;
+}
+
+katana::Result<katana::analytics::BipartiteMatchingStatistics>
+katana::analytics::BipartiteMatchingStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  katana::NUMAArray<uint8_t> sides =
+      KATANA_CHECKED(NodeSides(*pg, left_node_type, right_node_type));
+
+  katana::GAccumulator<uint64_t> cardinality;
+  katana::GAccumulator<uint64_t> unmatched_left;
+  katana::GAccumulator<uint64_t> unmatched_right;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        bool matched = graph.GetData<Partner>(n) != kUnmatchedNode;
+        if (sides[n] == kLeft) {
+          (matched ? cardinality : unmatched_left) += 1;
+        } else if (sides[n] == kRight && !matched) {
+          unmatched_right += 1;
+        }
+      },
+      katana::no_stats());
+
+  return BipartiteMatchingStatistics{
+      cardinality.reduce(), unmatched_left.reduce(), unmatched_right.reduce()};
+}
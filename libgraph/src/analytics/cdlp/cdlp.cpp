@@ -19,9 +19,16 @@
 
 #include "katana/analytics/cdlp/cdlp.h"
 
-#include <boost/unordered_map.hpp>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/ConcurrentHashMap.h"
+#include "katana/DynamicBitset.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -30,13 +37,110 @@ namespace {
 
 const unsigned int kMaxIterations = CdlpPlan::kMaxIterations;
 
-template <typename GraphViewTy>
+/// Slots of the open addressing table of LabelCounter: 16 bytes each, so
+/// that the table of every thread stays in its L1 or L2 cache
+constexpr size_t kLabelTableBits = 12;
+constexpr size_t kLabelTableSize = size_t{1} << kLabelTableBits;
+/// Nodes with more neighbors than this are hubs, whose labels may not fit in
+/// the table; at most half full, probes stay short
+constexpr size_t kHubDegree = kLabelTableSize / 2;
+
+/// Finds the label of largest total weight among the neighbors of a node, or
+/// the smallest such label on ties. Labels of ordinary nodes are counted in
+/// a small reused open addressing table; those of hubs are sorted and
+/// counted in runs, which needs no table as large as their degree.
+template <typename Freq>
+class LabelCounter {
+  using CommunityType = uint64_t;
+
+public:
+  LabelCounter() : table_(kLabelTableSize, Slot{kEmpty, Freq{}}) {}
+
+  void Start(size_t degree) {
+    hub_ = degree > kHubDegree;
+    used_.clear();
+    hub_labels_.clear();
+  }
+
+  void Add(CommunityType label, Freq weight) {
+    if (hub_) {
+      hub_labels_.emplace_back(label, weight);
+      return;
+    }
+    size_t i = (label * 0x9e3779b97f4a7c15ULL) >> (64 - kLabelTableBits);
+    while (table_[i].label != label) {
+      if (table_[i].label == kEmpty) {
+        table_[i] = Slot{label, Freq{}};
+        used_.emplace_back(i);
+        break;
+      }
+      i = (i + 1) & (kLabelTableSize - 1);
+    }
+    table_[i].freq += weight;
+  }
+
+  /// The most frequent label added since Start, or current if there is none
+  CommunityType Best(CommunityType current) {
+    CommunityType best = current;
+    bool found = false;
+    Freq best_freq{};
+    auto consider = [&](CommunityType label, Freq freq) {
+      if (!found || freq > best_freq || (freq == best_freq && label < best)) {
+        best = label;
+        best_freq = freq;
+        found = true;
+      }
+    };
+    if (hub_) {
+      // (label, weight) order makes float sums independent of edge order
+      std::sort(hub_labels_.begin(), hub_labels_.end());
+      for (size_t i = 0; i < hub_labels_.size();) {
+        CommunityType label = hub_labels_[i].first;
+        Freq freq{};
+        for (; i < hub_labels_.size() && hub_labels_[i].first == label; ++i) {
+          freq += hub_labels_[i].second;
+        }
+        consider(label, freq);
+      }
+    } else {
+      for (size_t i : used_) {
+        consider(table_[i].label, table_[i].freq);
+        table_[i].label = kEmpty;
+      }
+    }
+    return best;
+  }
+
+private:
+  static constexpr CommunityType kEmpty =
+      std::numeric_limits<CommunityType>::max();
+
+  struct Slot {
+    CommunityType label;
+    Freq freq;
+  };
+
+  bool hub_{false};
+  std::vector<Slot> table_;
+  std::vector<size_t> used_;
+  std::vector<std::pair<CommunityType, Freq>> hub_labels_;
+};
+
+/// EdgeWeightType is void for unweighted CDLP, which counts neighbors
+template <typename GraphViewTy, typename EdgeWeightType = void>
 struct CdlpAlgo {
   using CommunityType = uint64_t;
   struct NodeCommunity : public katana::PODProperty<CommunityType> {};
+  struct EdgeWeight : public katana::PODProperty<std::conditional_t<
+                          std::is_void_v<EdgeWeightType>, uint32_t,
+                          EdgeWeightType>> {};
+
+  static constexpr bool kWeighted = !std::is_void_v<EdgeWeightType>;
+  using Freq = std::conditional_t<kWeighted, double, size_t>;
 
   using NodeData = std::tuple<NodeCommunity>;
-  using EdgeData = std::tuple<>;
+  using EdgeData =
+      std::conditional_t<kWeighted, std::tuple<EdgeWeight>, std::tuple<>>;
   using Graph = katana::TypedPropertyGraphView<GraphViewTy, NodeData, EdgeData>;
   using GNode = typename Graph::Node;
 
@@ -48,12 +152,15 @@ struct CdlpAlgo {
   virtual void operator()(Graph* graph, size_t max_iterations) = 0;
 };
 
-template <typename GraphViewTy>
-struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy> {
-  using Graph = typename CdlpAlgo<GraphViewTy>::Graph;
-  using GNode = typename CdlpAlgo<GraphViewTy>::GNode;
-  using CommunityType = typename CdlpAlgo<GraphViewTy>::CommunityType;
-  using NodeCommunity = typename CdlpAlgo<GraphViewTy>::NodeCommunity;
+template <typename GraphViewTy, typename EdgeWeightType = void>
+struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy, EdgeWeightType> {
+  using Base = CdlpAlgo<GraphViewTy, EdgeWeightType>;
+  using Graph = typename Base::Graph;
+  using GNode = typename Base::GNode;
+  using CommunityType = typename Base::CommunityType;
+  using NodeCommunity = typename Base::NodeCommunity;
+  using EdgeWeight = typename Base::EdgeWeight;
+  using Freq = typename Base::Freq;
 
   void operator()(Graph* graph, size_t max_iterations = kMaxIterations) {
     if (max_iterations == 0)
@@ -67,43 +174,53 @@ struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy> {
 
     size_t iterations = 0;
     katana::InsertBag<NodeDataPair> apply_bag;
+    katana::PerThreadStorage<LabelCounter<Freq>> counters;
+    katana::GAccumulator<uint64_t> evaluations;
+
+    // The new label of a node only depends on the labels of its neighbors,
+    // so only the neighbors of nodes that changed are evaluated again
+    katana::DynamicBitset active;
+    katana::DynamicBitset next_active;
+    active.resize(graph->size());
+    next_active.resize(graph->size());
+    katana::do_all(
+        katana::iterate(*graph), [&](const GNode& node) { active.set(node); },
+        katana::no_stats());
 
-    /// TODO (Yasin): in this implementation, in each iteration, all the nodes are active
-    /// for gather phase. If InsertBag does not accept duplicate items then this
-    /// can be improved to have only the affected nodes to be active in next iteration
     while (iterations < max_iterations) {
       // Gather Phase
       katana::do_all(
           katana::iterate(*graph),
           [&](const GNode& node) {
+            if (!active.test(node)) {
+              return;
+            }
+            evaluations += 1;
             const auto ndata_current_comm =
                 graph->template GetData<NodeCommunity>(node);
-            using Histogram_type = boost::unordered_map<CommunityType, size_t>;
-            Histogram_type histogram;
+            LabelCounter<Freq>& counter = *counters.getLocal();
+            counter.Start(Degree(*graph, node));
             // Iterate over all neighbors (this is undirected view)
             for (auto e : Edges(*graph, node)) {
               auto neighbor = EdgeDst(*graph, e);
               const auto neighbor_data =
                   graph->template GetData<NodeCommunity>(neighbor);
-              histogram[neighbor_data]++;
+              if constexpr (Base::kWeighted) {
+                counter.Add(
+                    neighbor_data, graph->template GetEdgeData<EdgeWeight>(e));
+              } else {
+                counter.Add(neighbor_data, 1);
+              }
             }
 
             // Pick the most frequent community as the new community for node
             // pick the smallest one if more than one max frequent exist.
-            auto ndata_new_comm = ndata_current_comm;
-            size_t best_freq = 0;
-            for (const auto& [comm, freq] : histogram) {
-              if (freq > best_freq ||
-                  (freq == best_freq && comm < ndata_new_comm)) {
-                ndata_new_comm = comm;
-                best_freq = freq;
-              }
-            }
+            auto ndata_new_comm = counter.Best(ndata_current_comm);
 
             if (ndata_new_comm != ndata_current_comm)
               apply_bag.push(NodeDataPair(node, (CommunityType)ndata_new_comm));
           },
-          katana::loopname("CDLP_Gather"));
+          katana::steal(), katana::loopname("CDLP_Gather"));
 
       // No change! break!
       if (apply_bag.empty())
@@ -115,13 +232,20 @@ struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy> {
           [&](const NodeDataPair node_data) {
             GNode node = node_data.node;
             graph->template GetData<NodeCommunity>(node) = node_data.data;
+            for (auto e : Edges(*graph, node)) {
+              next_active.set(EdgeDst(*graph, e));
+            }
           },
           katana::loopname("CDLP_Apply"));
 
       apply_bag.clear();
+      std::swap(active, next_active);
+      next_active.reset();
       iterations += 1;
     }
     katana::ReportStatSingle("CDLP_Synchronous", "iterations", iterations);
+    katana::ReportStatSingle(
+        "CDLP_Synchronous", "evaluations", evaluations.reduce());
   }
 };
 
@@ -137,7 +261,8 @@ template <typename Algorithm>
 static katana::Result<void>
 CdlpWithWrap(
     katana::PropertyGraph* pg, std::string output_property_name,
-    size_t max_iterations, katana::TxnContext* txn_ctx) {
+    size_t max_iterations, katana::TxnContext* txn_ctx,
+    const std::vector<std::string>& edge_properties = {}) {
   katana::EnsurePreallocated(
       2, pg->topology().NumNodes() * sizeof(typename Algorithm::NodeCommunity));
   katana::ReportPageAllocGuard page_alloc;
@@ -148,7 +273,8 @@ CdlpWithWrap(
       !r) {
     return r.error();
   }
-  auto pg_result = Algorithm::Graph::Make(pg, {output_property_name}, {});
+  auto pg_result =
+      Algorithm::Graph::Make(pg, {output_property_name}, edge_properties);
   if (!pg_result) {
     return pg_result.error();
   }
@@ -194,6 +320,72 @@ katana::analytics::Cdlp(
   }
 }
 
+namespace {
+
+template <typename EdgeWeightType>
+katana::Result<void>
+CdlpWeightedWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, size_t max_iterations,
+    katana::TxnContext* txn_ctx, bool is_symmetric, CdlpPlan plan) {
+  if (plan.algorithm() != CdlpPlan::kSynchronous) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  if (is_symmetric) {
+    return CdlpWithWrap<CdlpSynchronousAlgo<
+        katana::PropertyGraphViews::Default, EdgeWeightType>>(
+        pg, output_property_name, max_iterations, txn_ctx,
+        {edge_weight_property_name});
+  }
+  return CdlpWithWrap<CdlpSynchronousAlgo<
+      katana::PropertyGraphViews::Undirected, EdgeWeightType>>(
+      pg, output_property_name, max_iterations, txn_ctx,
+      {edge_weight_property_name});
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Cdlp(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, size_t max_iterations,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric, CdlpPlan plan) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return CdlpWeightedWithWrap<uint32_t>(
+        pg, edge_weight_property_name, output_property_name, max_iterations,
+        txn_ctx, is_symmetric, plan);
+  case arrow::Int32Type::type_id:
+    return CdlpWeightedWithWrap<int32_t>(
+        pg, edge_weight_property_name, output_property_name, max_iterations,
+        txn_ctx, is_symmetric, plan);
+  case arrow::UInt64Type::type_id:
+    return CdlpWeightedWithWrap<uint64_t>(
+        pg, edge_weight_property_name, output_property_name, max_iterations,
+        txn_ctx, is_symmetric, plan);
+  case arrow::Int64Type::type_id:
+    return CdlpWeightedWithWrap<int64_t>(
+        pg, edge_weight_property_name, output_property_name, max_iterations,
+        txn_ctx, is_symmetric, plan);
+  case arrow::FloatType::type_id:
+    return CdlpWeightedWithWrap<float>(
+        pg, edge_weight_property_name, output_property_name, max_iterations,
+        txn_ctx, is_symmetric, plan);
+  case arrow::DoubleType::type_id:
+    return CdlpWeightedWithWrap<double>(
+        pg, edge_weight_property_name, output_property_name, max_iterations,
+        txn_ctx, is_symmetric, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
 /// TODO (Yasin): This function is now being used by louvain,
 /// cc, and cdlp, basically everything which is calculating communities. Explore
 /// possiblity of moving it to some common .h file in libgalois/include/analytics
@@ -216,37 +408,21 @@ katana::analytics::CdlpStatistics::Compute(
 
   auto graph = pg_result.value();
 
-  using Map = katana::gstl::Map<CommunityType, int>;
-
-  auto reduce = [](Map& lhs, Map&& rhs) -> Map& {
-    Map v{std::move(rhs)};
-
-    for (auto& kv : v) {
-      if (lhs.count(kv.first) == 0) {
-        lhs[kv.first] = 0;
-      }
-      lhs[kv.first] += kv.second;
-    }
-
-    return lhs;
-  };
-
-  auto mapIdentity = []() { return Map(); };
-
-  auto accumMap = katana::make_reducible(reduce, mapIdentity);
+  // one concurrent map instead of per thread maps merged afterwards
+  katana::ConcurrentHashMap<CommunityType, uint64_t> community_sizes(
+      graph.size());
 
   katana::do_all(
       katana::iterate(graph),
       [&](const GNode& x) {
         auto& n = graph.template GetData<NodeCommunity>(x);
-        accumMap.update(Map{std::make_pair(n, 1)});
+        community_sizes.Add(n, 1);
       },
       katana::loopname("CountLargest"));
 
-  Map& map = accumMap.reduce();
-  size_t reps = map.size();
+  size_t reps = community_sizes.size();
 
-  using CommunitySizePair = std::pair<CommunityType, int>;
+  using CommunitySizePair = std::pair<CommunityType, uint64_t>;
 
   auto sizeMax = [](const CommunitySizePair& a, const CommunitySizePair& b) {
     if (a.second > b.second) {
@@ -260,9 +436,9 @@ katana::analytics::CdlpStatistics::Compute(
   auto maxComm = katana::make_reducible(sizeMax, identity);
 
   katana::GAccumulator<uint64_t> non_trivial_communities;
-  katana::do_all(katana::iterate(map), [&](const CommunitySizePair& x) {
-    maxComm.update(x);
-    if (x.second > 1) {
+  community_sizes.ForEach([&](CommunityType community, uint64_t size) {
+    maxComm.update(CommunitySizePair{community, size});
+    if (size > 1) {
       non_trivial_communities += 1;
     }
   });
@@ -19,8 +19,13 @@
 
 #include "katana/analytics/connected_components/connected_components.h"
 
+#include <type_traits>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/PropertyColumn.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/AsyncAnalytics.h"
+#include "katana/analytics/GpuAnalytics.h"
 
 using namespace katana::analytics;
 
@@ -32,6 +37,8 @@ namespace {
 // using PropGraphView = katana::PropertyGraphViews::Default;
 
 const unsigned int kInfinity = std::numeric_limits<unsigned int>::max();
+/// How many nodes ahead label propagation prefetches for
+constexpr unsigned kPrefetchDistance = 8;
 struct ConnectedComponentsNode
     : public katana::UnionFindNode<ConnectedComponentsNode> {
   using ComponentType = ConnectedComponentsNode*;
@@ -123,9 +130,11 @@ struct ConnectedComponentsLabelPropAlgo {
 
   void Deallocate(Graph*) {}
 
-  void operator()(Graph* graph) {
+  katana::Result<void> operator()(Graph* graph) {
     katana::GReduceLogicalOr changed;
+    uint64_t rounds = 0;
     do {
+      KATANA_CHECKED(CheckProgress({"ConnectedComponents", rounds++}));
       changed.reset();
       katana::do_all(
           katana::iterate(*graph),
@@ -148,8 +157,19 @@ struct ConnectedComponentsLabelPropAlgo {
             }
           },
           katana::disable_conflict_detection(), katana::steal(),
+          katana::prefetch_distance<kPrefetchDistance>(
+              [&](const GNode& src) -> const void* {
+                // the component of the first neighbor
+                auto edges = Edges(*graph, src);
+                if (edges.empty()) {
+                  return nullptr;
+                }
+                return &graph->template GetData<NodeComponent>(
+                    EdgeDst(*graph, *edges.begin()));
+              }),
           katana::loopname("ConnectedComponentsLabelPropAlgo"));
     } while (changed.reduce());
+    return katana::ResultSuccess();
   }
 };
 
@@ -191,7 +211,7 @@ struct ConnectedComponentsSynchronousAlgo {
     });
   }
 
-  void operator()(Graph* graph) {
+  katana::Result<void> operator()(Graph* graph) {
     size_t rounds = 0;
     katana::GAccumulator<size_t> empty_merges;
 
@@ -214,6 +234,8 @@ struct ConnectedComponentsSynchronousAlgo {
     });
 
     while (!current_bag->empty()) {
+      KATANA_CHECKED(CheckProgress(
+          {"ConnectedComponents", rounds, current_bag->size()}));
       katana::do_all(
           katana::iterate(*current_bag),
           [&](const Edge& edge) {
@@ -265,6 +287,7 @@ struct ConnectedComponentsSynchronousAlgo {
     katana::ReportStatSingle("CC-Synchronous", "rounds", rounds);
     katana::ReportStatSingle(
         "CC-Synchronous", "empty_merges", empty_merges.reduce());
+    return katana::ResultSuccess();
   }
 };
 
@@ -1163,11 +1186,17 @@ ConnectedComponentsWithWrap(
   katana::StatTimer execTime("ConnectedComponent");
   execTime.start();
 
-  algo(&graph);
+  // the algorithms that check for cancellation return a result
+  katana::Result<void> res = katana::ResultSuccess();
+  if constexpr (std::is_void_v<decltype(algo(&graph))>) {
+    algo(&graph);
+  } else {
+    res = algo(&graph);
+  }
   execTime.stop();
 
   algo.Deallocate(&graph);
-  return katana::ResultSuccess();
+  return res;
 }
 
 template <typename GraphViewTy>
@@ -1222,11 +1251,32 @@ ConnectedComponentsSelectAlgorithm(
   return katana::ResultSuccess();
 }
 
+static katana::Result<void>
+ConnectedComponentsGpu(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx) {
+  GpuAnalytics* gpu = KATANA_CHECKED(GetGpuAnalytics());
+  auto components =
+      katana::PropertyColumn<uint64_t>::MakeInterleaved(pg->NumNodes());
+
+  katana::StatTimer exec_time("Connected Components");
+  exec_time.start();
+  // edges are followed both ways, so the graph need not be symmetric
+  KATANA_CHECKED(gpu->ConnectedComponents(pg, components.values().data()));
+  exec_time.stop();
+
+  return pg->AddNodeProperty(
+      output_property_name, std::move(components), txn_ctx);
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, const bool& is_symmetric,
     ConnectedComponentsPlan plan) {
+  if (plan.architecture() == kGPU) {
+    return ConnectedComponentsGpu(pg, output_property_name, txn_ctx);
+  }
   if (is_symmetric) {
     using GraphView = katana::PropertyGraphViews::Default;
     return ConnectedComponentsSelectAlgorithm<GraphView>(
@@ -0,0 +1,189 @@
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Parent = katana::AtomicPODProperty<uint64_t>;
+using NodeData = std::tuple<Parent>;
+using EdgeData = std::tuple<>;
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+using GNode = Graph::Node;
+using Edge = std::pair<uint32_t, uint32_t>;
+
+/// Union-find over node ids stored in a node property rather than the
+/// pointers of katana::UnionFindNode, so that it outlives the process. A
+/// root is always linked below a root of smaller id, so every parent is at
+/// most its child and the root of a component is its least node.
+class ParentForest {
+public:
+  explicit ParentForest(Graph* graph) : graph_(graph) {}
+
+  /// The root of n. Halves the path on the way up: a node whose parent is
+  /// still the one read is pointed at its grandparent, which keeps racing
+  /// finds and links consistent.
+  uint64_t Find(uint64_t n) {
+    while (true) {
+      uint64_t parent = parent_of(n).load(std::memory_order_relaxed);
+      uint64_t grandparent = parent_of(parent).load(std::memory_order_relaxed);
+      if (parent == grandparent) {
+        return parent;
+      }
+      parent_of(n).compare_exchange_weak(
+          parent, grandparent, std::memory_order_relaxed);
+      n = grandparent;
+    }
+  }
+
+  /// Joins the components of a and b. Returns whether they were apart.
+  bool Union(uint64_t a, uint64_t b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return false;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      // a may have been linked since it was found; then find again
+      uint64_t expected = a;
+      if (parent_of(a).compare_exchange_strong(
+              expected, b, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+private:
+  std::atomic<uint64_t>& parent_of(uint64_t n) {
+    return graph_->GetData<Parent>(static_cast<GNode>(n));
+  }
+
+  Graph* graph_;
+};
+
+/// Sets every node to its own component, joins the endpoints of every edge
+/// of the graph and then points every node at its root
+void
+Initialize(Graph* graph, katana::GAccumulator<uint64_t>* merges) {
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<Parent>(n).store(n, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  ParentForest forest(graph);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& src) {
+        for (auto e : graph->OutEdges(src)) {
+          if (forest.Union(src, graph->OutEdgeDst(e))) {
+            *merges += 1;
+          }
+        }
+      },
+      katana::steal(),
+      katana::loopname("ConnectedComponentsIncremental-Initialize"));
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<Parent>(n).store(
+            forest.Find(n), std::memory_order_relaxed);
+      },
+      katana::no_stats());
+}
+
+katana::Result<void>
+CheckNode(const katana::PropertyGraph* pg, uint32_t n) {
+  uint64_t num_nodes = pg->topology().NumNodes();
+  if (n >= num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node {} is not in a graph of {} nodes", n, num_nodes);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& parent_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    katana::TxnContext* txn_ctx) {
+  for (const Edge& edge : inserted_edges) {
+    KATANA_CHECKED(CheckNode(pg, edge.first));
+    KATANA_CHECKED(CheckNode(pg, edge.second));
+  }
+
+  bool initialize = !pg->HasNodeProperty(parent_property_name);
+  if (initialize) {
+    KATANA_CHECKED(
+        pg->ConstructNodeProperties<NodeData>(txn_ctx, {parent_property_name}));
+  }
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {parent_property_name}, {}));
+
+  katana::StatTimer exec_time("ConnectedComponentsIncremental");
+  exec_time.start();
+
+  katana::GAccumulator<uint64_t> merges;
+  if (initialize) {
+    Initialize(&graph, &merges);
+  }
+
+  ParentForest forest(&graph);
+  katana::do_all(
+      katana::iterate(inserted_edges),
+      [&](const Edge& edge) {
+        if (forest.Union(edge.first, edge.second)) {
+          merges += 1;
+        }
+      },
+      katana::steal(), katana::loopname("ConnectedComponentsIncremental"));
+
+  // make the components of the batch quick to find for the next queries
+  katana::do_all(
+      katana::iterate(inserted_edges),
+      [&](const Edge& edge) {
+        forest.Find(edge.first);
+        forest.Find(edge.second);
+      },
+      katana::no_stats());
+
+  exec_time.stop();
+
+  katana::ReportStatSingle(
+      "ConnectedComponentsIncremental", "Merges", merges.reduce());
+  return merges.reduce();
+}
+
+katana::Result<std::vector<uint64_t>>
+katana::analytics::ConnectedComponentsFind(
+    PropertyGraph* pg, const std::string& parent_property_name,
+    const std::vector<uint32_t>& nodes) {
+  for (uint32_t n : nodes) {
+    KATANA_CHECKED(CheckNode(pg, n));
+  }
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {parent_property_name}, {}));
+
+  std::vector<uint64_t> components(nodes.size());
+  ParentForest forest(&graph);
+  katana::do_all(
+      katana::iterate(size_t{0}, nodes.size()),
+      [&](size_t i) { components[i] = forest.Find(nodes[i]); },
+      katana::no_stats());
+  return components;
+}
@@ -0,0 +1,196 @@
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/PriorityRoundsImplementationBase.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+struct NodeColor : public katana::PODProperty<uint32_t> {};
+
+using NodeData = std::tuple<NodeColor>;
+using EdgeData = std::tuple<>;
+
+using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+using GNode = Graph::Node;
+
+constexpr uint32_t kUncolored = std::numeric_limits<uint32_t>::max();
+constexpr GNode kNoNode = std::numeric_limits<GNode>::max();
+
+katana::NUMAArray<uint64_t>
+Priorities(const Graph& graph, GraphColoringPlan::Algorithm algorithm) {
+  katana::NUMAArray<uint64_t> priorities;
+  priorities.allocateBlocked(graph.size());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        uint64_t random = katana::StatelessRandom(1, n);
+        if (algorithm == GraphColoringPlan::kLargestDegreeFirst) {
+          uint64_t degree = std::min<uint64_t>(
+              graph.OutDegree(n), std::numeric_limits<uint32_t>::max());
+          priorities[n] = (degree << 32) | (random >> 32);
+        } else {
+          priorities[n] = random;
+        }
+      },
+      katana::loopname("GraphColoring-Priorities"));
+  return priorities;
+}
+
+void
+JonesPlassmann(Graph* graph, GraphColoringPlan::Algorithm algorithm) {
+  PriorityRoundsImplementationBase<Graph> rounds(
+      *graph, Priorities(*graph, algorithm));
+
+  // The colors taken by the neighbors of the node being colored, marked with
+  // its id so that they need not be cleared between nodes; a node of degree d
+  // takes one of the colors 0 to d, so only those are tracked
+  katana::PerThreadStorage<std::vector<GNode>> taken;
+  rounds.Run(
+      [&](const GNode& n) {
+        std::vector<GNode>& marks = *taken.getLocal();
+        uint64_t degree = graph->OutDegree(n);
+        if (marks.size() < degree + 1) {
+          marks.resize(degree + 1, kNoNode);
+        }
+        // The neighbors colored before n are those of earlier rounds, whose
+        // colors do not change while this round runs
+        for (auto e : graph->OutEdges(n)) {
+          uint32_t color = graph->GetData<NodeColor>(graph->OutEdgeDst(e));
+          if (color != kUncolored && color <= degree) {
+            marks[color] = n;
+          }
+        }
+        uint32_t color = 0;
+        while (marks[color] == n) {
+          ++color;
+        }
+        graph->GetData<NodeColor>(n) = color;
+      },
+      "GraphColoring");
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphColoring(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, GraphColoringPlan plan) {
+  if (plan.algorithm() != GraphColoringPlan::kJonesPlassmann &&
+      plan.algorithm() != GraphColoringPlan::kLargestDegreeFirst) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm: {}",
+        plan.algorithm());
+  }
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodeColor>(n) = kUncolored; },
+      katana::no_stats());
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("GraphColoring");
+  exec_time.start();
+  JonesPlassmann(&graph, plan.algorithm());
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::GraphColoringAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::GReduceLogicalOr uncolored;
+  katana::GReduceLogicalOr conflict;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        uint32_t color = graph.GetData<NodeColor>(n);
+        if (color == kUncolored) {
+          uncolored.update(true);
+          return;
+        }
+        for (auto e : graph.OutEdges(n)) {
+          GNode dest = graph.OutEdgeDst(e);
+          if (dest != n && graph.GetData<NodeColor>(dest) == color) {
+            conflict.update(true);
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (uncolored.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "found an uncolored node");
+  }
+  if (conflict.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "found adjacent nodes of the same color");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::GraphColoringStatistics::Print(std::ostream& os) const {
+  os << "Number of colors = " << num_colors << std::endl;
+  os << "Nodes of the most common color = " << largest_color_size << std::endl;
+}
+
+katana::Result<katana::analytics::GraphColoringStatistics>
+katana::analytics::GraphColoringStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::PerThreadStorage<std::vector<uint64_t>> histograms;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        std::vector<uint64_t>& histogram = *histograms.getLocal();
+        uint32_t color = graph.GetData<NodeColor>(n);
+        if (color == kUncolored) {
+          return;
+        }
+        if (histogram.size() <= color) {
+          histogram.resize(color + 1, 0);
+        }
+        ++histogram[color];
+      },
+      katana::no_stats());
+
+  std::vector<uint64_t> sizes;
+  for (const std::vector<uint64_t>& histogram : histograms) {
+    if (sizes.size() < histogram.size()) {
+      sizes.resize(histogram.size(), 0);
+    }
+    for (size_t color = 0; color < histogram.size(); ++color) {
+      sizes[color] += histogram[color];
+    }
+  }
+
+  uint64_t largest = 0;
+  for (uint64_t size : sizes) {
+    largest = std::max(largest, size);
+  }
+  return GraphColoringStatistics{static_cast<uint32_t>(sizes.size()), largest};
+}
@@ -26,11 +26,13 @@
 
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
 #include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
 #include "katana/Timer.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/PriorityRoundsImplementationBase.h"
 #include "katana/analytics/Utils.h"
 
 namespace {
@@ -322,8 +324,12 @@ const auto kUndecided = uint8_t{0x01};
 const auto kTemporaryYes = uint8_t{0x02};
 const auto kPermanentNo = uint8_t{0x00};
 
+/// Luby's algorithm on the priority rounds engine, with nodes of lower degree
+/// first, which makes for larger sets: degrees are bucketed by their
+/// logarithm, so that nodes of similar degree are ordered at random and few
+/// rounds are needed.
 struct PrioAlgo {
-  struct NodeFlag : public katana::PODProperty<uint8_t> {};
+  struct NodeFlag : public katana::PODProperty<uint8_t, MatchFlag> {};
 
   using NodeData = std::tuple<NodeFlag>;
   using EdgeData = std::tuple<>;
@@ -333,80 +339,32 @@ struct PrioAlgo {
 
   void Initialize(Graph* graph) {
     for (auto n : *graph) {
-      graph->GetData<NodeFlag>(n) = kUndecided;
+      graph->GetData<NodeFlag>(n) = MatchFlag::KOtherMatched;
     }
   }
 
   void operator()(Graph* graph) {
-    katana::GAccumulator<size_t> rounds;
-    katana::GReduceLogicalOr unmatched;
-    katana::PerThreadStorage<std::mt19937*> generator;
-
-    float avg_degree = graph->NumEdges() / graph->size();
-    uint8_t in = ~1;
-    float scale_avg = ((in / 2) - 1) * avg_degree;
-
+    katana::NUMAArray<uint64_t> priorities;
+    priorities.allocateBlocked(graph->size());
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
-          auto& src_flag = graph->GetData<NodeFlag>(src);
-          float degree = graph->OutEdges(src).size();
-          float x = degree - hash(src) * kHashScale;
-          int res = round(scale_avg / (avg_degree + x));
-          uint8_t val = (res + res) | 1;
-          src_flag = val;
+          uint64_t degree = graph->OutDegree(src);
+          uint64_t degree_bits = degree == 0 ? 0 : 64 - __builtin_clzll(degree);
+          priorities[src] = ((64 - degree_bits) << 32) | hash(src);
         },
         katana::loopname("IndependentSet-init-prio"));
 
-    do {
-      unmatched.reset();
-      katana::do_all(
-          katana::iterate(*graph),
-          [&](const GNode& src) {
-            auto& src_flag = graph->GetData<NodeFlag>(src);
-
-            if (!(src_flag & kUndecided)) {
-              return;
-            }
-
-            for (auto edge : graph->OutEdges(src)) {
-              auto dest = graph->OutEdgeDst(edge);
-
-              auto dest_flag = graph->GetData<NodeFlag>(dest);
-
-              if (dest_flag == kPermanentYes) {  // matched, highest prio
-                src_flag = kPermanentNo;
-                unmatched.update(true);
-                return;
-              }
-
-              if (src_flag > dest_flag) {
-                continue;
-              }
-              if (src_flag == dest_flag) {
-                if (src > dest) {
-                  continue;
-                } else if (src == dest) {
-                  src_flag = kPermanentNo;  // other_matched
-                  return;
-                } else {
-                  unmatched.update(true);
-                  return;
-                }
-              } else {
-                unmatched.update(true);
-                return;
-              }
-            }
-            src_flag = kPermanentYes;  // matched, highest prio
-          },
-          katana::loopname("IndependentSet-execute"), katana::steal());
-
-      rounds += 1;
-    } while (unmatched.reduce());
-
-    katana::ReportStatSingle(
-        "IndependentSet-prioAlgo", "rounds", rounds.reduce());
+    katana::analytics::PriorityRoundsImplementationBase<Graph> rounds(
+        *graph, std::move(priorities));
+    rounds.Run(
+        [&](const GNode& src) {
+          graph->GetData<NodeFlag>(src) = MatchFlag::kMatched;
+          for (auto edge : graph->OutEdges(src)) {
+            rounds.Decide(graph->OutEdgeDst(edge));
+          }
+        },
+        "IndependentSet-prioAlgo");
   }
 };
 
@@ -633,9 +591,8 @@ Run(katana::PropertyGraph* pg, const std::string& output_property_name,
   exec_time.stop();
   page_alloc.Report();
 
-  if (std::is_same<Algo, PrioAlgo>::value ||
-      std::is_same<Algo, EdgeTiledPrioAlgo>::value) {
-    // For these algorithms we need to translate the flags into MatchFlag/bool.
+  if (std::is_same<Algo, EdgeTiledPrioAlgo>::value) {
+    // For this algorithm we need to translate the flags into MatchFlag/bool.
     // Check for errors as we go since it costs almost nothing.
     katana::GReduceLogicalOr has_error;
     katana::do_all(
@@ -19,6 +19,7 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include "katana/SortedIntersection.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -30,6 +31,9 @@ using EdgeData = std::tuple<>;
 
 using Graph = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+using HubBitmapGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::EdgesSortedByDestIDHubBitmaps, NodeData,
+    EdgeData>;
 using GNode = typename Graph::Node;
 
 namespace {
@@ -38,33 +42,25 @@ struct IntersectWithSortedEdgeList {
 private:
   const GNode base_;
   const Graph& graph_;
+  const bool has_parallel_edges_;
 
 public:
   IntersectWithSortedEdgeList(const Graph& graph, GNode base)
-      : base_(base), graph_(graph) {}
+      : base_(base),
+        graph_(graph),
+        has_parallel_edges_(HasParallelEdges(graph)) {}
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.OutEdges(n2).begin();
-    auto edges_n2_end = graph_.OutEdges(n2).end();
-    auto edges_base_iter = graph_.OutEdges(base_).begin();
-    auto edges_base_end = graph_.OutEdges(base_).end();
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.OutEdgeDst(*edges_n2_iter);
-      auto edge_base_dst = graph_.OutEdgeDst(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
+    // Relies on the assumption that edges lists are sorted.
+    const GNode* dsts = graph_.DestData();
+    const GNode* n2_dsts = dsts + *graph_.OutEdges(n2).begin();
+    const GNode* base_dsts = dsts + *graph_.OutEdges(base_).begin();
+    if (has_parallel_edges_) {
+      return katana::SortedMultisetIntersectionCount(
+          n2_dsts, graph_.OutDegree(n2), base_dsts, graph_.OutDegree(base_));
     }
-    return intersection_size;
+    return katana::SortedIntersectionCount(
+        n2_dsts, graph_.OutDegree(n2), base_dsts, graph_.OutDegree(base_));
   }
 };
 
@@ -94,9 +90,23 @@ public:
   }
 };
 
-template <typename IntersectAlgorithm>
+struct IntersectWithHubBitmaps {
+private:
+  const GNode base_;
+  const HubBitmapGraph& graph_;
+
+public:
+  IntersectWithHubBitmaps(const HubBitmapGraph& graph, GNode base)
+      : base_(base), graph_(graph) {}
+
+  uint32_t operator()(GNode n2) {
+    return graph_.CountCommonNeighbors(base_, n2, 0, graph_.NumNodes());
+  }
+};
+
+template <typename IntersectAlgorithm, typename G>
 katana::Result<void>
-JaccardImpl(Graph& graph, size_t compare_node, JaccardPlan /*plan*/) {
+JaccardImpl(G& graph, size_t compare_node, JaccardPlan /*plan*/) {
   if (compare_node >= graph.size()) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -108,7 +118,7 @@ JaccardImpl(Graph& graph, size_t compare_node, JaccardPlan /*plan*/) {
 
   auto it = graph.begin();
   std::advance(it, compare_node);
-  Graph::Node base = *it;
+  GNode base = *it;
 
   uint32_t base_size = graph.OutDegree(base);
 
@@ -116,7 +126,7 @@ JaccardImpl(Graph& graph, size_t compare_node, JaccardPlan /*plan*/) {
 
   // Compute the similarity for each node
   katana::do_all(katana::iterate(graph), [&](const GNode& n2) {
-    double& n2_data = graph.GetData<JaccardSimilarity>(n2);
+    double& n2_data = graph.template GetData<JaccardSimilarity>(n2);
     uint32_t n2_size = graph.OutDegree(n2);
     // Count the number of neighbors of n2 and the number that are shared
     // with base
@@ -147,6 +157,12 @@ katana::analytics::Jaccard(
     return result.error();
   }
 
+  if (plan.hub_bitmaps()) {
+    HubBitmapGraph graph =
+        KATANA_CHECKED(HubBitmapGraph::Make(pg, {output_property_name}, {}));
+    return JaccardImpl<IntersectWithHubBitmaps>(graph, compare_node, plan);
+  }
+
   Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
 
   katana::Result<void> r = katana::ResultSuccess();
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SortedIntersection.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, std::tuple<>, std::tuple<>>;
+using GNode = Graph::Node;
+using Match = std::pair<uint32_t, double>;
+
+/// The filters below are exact in real numbers; they are loosened by this
+/// much so that rounding can only let more candidates through
+constexpr double kSlack = 1e-9;
+
+/// The neighbor set of every node, each neighbor replaced by its rank in
+/// increasing order of in degree and the ranks sorted, so that every set
+/// starts with its rarest neighbors and sets can be intersected as sorted
+/// ranges.
+struct RankedSets {
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> sizes;
+  katana::NUMAArray<uint32_t> ranks;
+
+  const uint32_t* begin(GNode n) const { return &ranks[0] + offsets[n]; }
+  uint32_t size(GNode n) const { return sizes[n]; }
+
+  void Build(const Graph& graph) {
+    size_t num_nodes = graph.NumNodes();
+
+    katana::NUMAArray<std::atomic<uint32_t>> in_degree;
+    in_degree.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(graph), [&](GNode n) { in_degree[n] = 0; },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          for (auto e : graph.OutEdges(n)) {
+            in_degree[graph.OutEdgeDst(e)].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    std::vector<uint32_t> order(num_nodes);
+    katana::do_all(
+        katana::iterate(graph), [&](GNode n) { order[n] = n; },
+        katana::no_stats());
+    katana::ParallelSTL::sort(
+        order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+          uint32_t a_degree = in_degree[a].load(std::memory_order_relaxed);
+          uint32_t b_degree = in_degree[b].load(std::memory_order_relaxed);
+          return a_degree < b_degree || (a_degree == b_degree && a < b);
+        });
+    katana::NUMAArray<uint32_t> rank;
+    rank.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t i) { rank[order[i]] = i; }, katana::no_stats());
+
+    offsets.allocateInterleaved(num_nodes + 1);
+    sizes.allocateInterleaved(num_nodes);
+    ranks.allocateInterleaved(graph.NumEdges());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto edges = graph.OutEdges(n);
+          offsets[n] = *edges.begin();
+          uint32_t* first = &ranks[0] + *edges.begin();
+          uint32_t* last = first;
+          for (auto e : edges) {
+            *last++ = rank[graph.OutEdgeDst(e)];
+          }
+          std::sort(first, last);
+          sizes[n] = std::unique(first, last) - first;
+        },
+        katana::steal(), katana::no_stats());
+  }
+};
+
+/// Per node state of the search for the matches of one node, reused by all
+/// the nodes a thread searches from
+struct Scratch {
+  /// stamp[v] == u + 1 if v was already a candidate of u
+  std::vector<uint32_t> stamp;
+  /// Min heap by Better of the best matches so far
+  std::vector<Match> heap;
+};
+
+/// Whether a is a better match than b: more similar, or closer by node id
+bool
+Better(const Match& a, const Match& b) {
+  return a.second > b.second || (a.second == b.second && a.first < b.first);
+}
+
+}  // namespace
+
+katana::Result<std::vector<std::vector<std::pair<uint32_t, double>>>>
+katana::analytics::SimilarityTopK(
+    PropertyGraph* pg, uint32_t k, double min_similarity,
+    SetSimilarity measure) {
+  if (!(min_similarity >= 0 && min_similarity <= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "min_similarity {} must be in [0, 1]", min_similarity);
+  }
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+  size_t num_nodes = graph.NumNodes();
+
+  std::vector<std::vector<Match>> matches(num_nodes);
+  if (k == 0) {
+    return matches;
+  }
+
+  katana::StatTimer exec_time("SimilarityTopK");
+  exec_time.start();
+
+  RankedSets sets;
+  sets.Build(graph);
+
+  // Both measures need an overlap of at least factor * |u| for u to match
+  // v at similarity t, and |v| within [factor * |u|, |u| / factor]
+  bool cosine = measure == SetSimilarity::kCosine;
+  auto overlap_factor = [&](double t) { return cosine ? t * t : t; };
+  auto similarity = [&](uint32_t overlap, uint32_t u_size, uint32_t v_size) {
+    if (cosine) {
+      return overlap / std::sqrt(static_cast<double>(u_size) * v_size);
+    }
+    return static_cast<double>(overlap) / (u_size + v_size - overlap);
+  };
+
+  // Prefix filtering: two sets that overlap in at least factor * |u| and
+  // factor * |v| elements share an element among the first
+  // |u| - ceil(factor * |u|) + 1 of u and the first |v| - ...  + 1 of v
+  double factor = overlap_factor(min_similarity);
+  auto prefix_size = [&](GNode n) -> uint32_t {
+    uint32_t size = sets.size(n);
+    double min_overlap = std::ceil(factor * size - kSlack);
+    return std::min<double>(size, size - min_overlap + 1);
+  };
+
+  // nodes by the ranks in their prefixes
+  katana::NUMAArray<std::atomic<uint64_t>> index_cursor;
+  index_cursor.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(graph), [&](GNode n) { index_cursor[n] = 0; },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        const uint32_t* set = sets.begin(n);
+        for (uint32_t i = 0, end = prefix_size(n); i < end; ++i) {
+          index_cursor[set[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::NUMAArray<uint64_t> index_offsets;
+  index_offsets.allocateInterleaved(num_nodes + 1);
+  index_offsets[0] = 0;
+  for (size_t r = 0; r < num_nodes; ++r) {
+    index_offsets[r + 1] = index_offsets[r] + index_cursor[r];
+    index_cursor[r] = index_offsets[r];
+  }
+  katana::NUMAArray<uint32_t> index;
+  index.allocateInterleaved(index_offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        const uint32_t* set = sets.begin(n);
+        for (uint32_t i = 0, end = prefix_size(n); i < end; ++i) {
+          index[index_cursor[set[i]].fetch_add(1, std::memory_order_relaxed)] =
+              n;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::PerThreadStorage<Scratch> scratches;
+  katana::GAccumulator<uint64_t> num_candidates;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode u) {
+        uint32_t u_size = sets.size(u);
+        if (u_size == 0) {
+          return;
+        }
+        Scratch& scratch = *scratches.getLocal();
+        if (scratch.stamp.size() != num_nodes) {
+          scratch.stamp.assign(num_nodes, 0);
+        }
+        std::vector<Match>& heap = scratch.heap;
+        heap.clear();
+
+        const uint32_t* u_set = sets.begin(u);
+        for (uint32_t i = 0, end = prefix_size(u); i < end; ++i) {
+          uint32_t r = u_set[i];
+          for (uint64_t j = index_offsets[r]; j < index_offsets[r + 1]; ++j) {
+            GNode v = index[j];
+            if (v == u || scratch.stamp[v] == u + 1) {
+              continue;
+            }
+            scratch.stamp[v] = u + 1;
+
+            // once k matches are in, a candidate must beat the worst of them
+            double bound = heap.size() == k
+                               ? std::max(min_similarity, heap.front().second)
+                               : min_similarity;
+            double f = overlap_factor(bound);
+            uint32_t v_size = sets.size(v);
+            if (v_size < f * u_size - kSlack || f * v_size > u_size + kSlack) {
+              continue;
+            }
+
+            num_candidates += 1;
+            uint32_t overlap = katana::SortedIntersectionCount(
+                u_set, u_size, sets.begin(v), v_size);
+            Match match{v, similarity(overlap, u_size, v_size)};
+            if (match.second < min_similarity) {
+              continue;
+            }
+            if (heap.size() < k) {
+              heap.emplace_back(match);
+              std::push_heap(heap.begin(), heap.end(), Better);
+            } else if (Better(match, heap.front())) {
+              std::pop_heap(heap.begin(), heap.end(), Better);
+              heap.back() = match;
+              std::push_heap(heap.begin(), heap.end(), Better);
+            }
+          }
+        }
+        std::sort_heap(heap.begin(), heap.end(), Better);
+        matches[u].assign(heap.begin(), heap.end());
+      },
+      katana::steal(), katana::loopname("SimilarityTopK"));
+
+  exec_time.stop();
+
+  katana::ReportStatSingle(
+      "SimilarityTopK", "Candidates", num_candidates.reduce());
+  return matches;
+}
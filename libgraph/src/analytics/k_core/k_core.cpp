@@ -19,7 +19,11 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <limits>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Frontier.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -36,6 +40,8 @@ struct KCoreNodeCurrentDegree : public katana::AtomicPODProperty<uint32_t> {};
 
 struct KCoreNodeAlive : public katana::PODProperty<uint32_t> {};
 
+struct KCoreNodeCoreNumber : public katana::PODProperty<uint32_t> {};
+
 using NodeData = std::tuple<KCoreNodeCurrentDegree>;
 using EdgeData = std::tuple<>;
 
@@ -66,11 +72,10 @@ DegreeCounting(GraphTy* graph) {
  * @param initial_worklist Empty worklist to be filled with dead nodes.
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number.
  */
-template <typename GraphTy>
+template <typename GraphTy, typename WorklistTy>
 void
 SetupInitialWorklist(
-    const GraphTy& graph,
-    katana::InsertBag<typename GraphTy::Node>& initial_worklist,
+    const GraphTy& graph, WorklistTy& initial_worklist,
     uint32_t k_core_number) {
   using GNode = typename GraphTy::Node;
   katana::do_all(
@@ -80,7 +85,7 @@ SetupInitialWorklist(
             graph.template GetData<KCoreNodeCurrentDegree>(node);
         if (node_current_degree < k_core_number) {
           //! Dead node, add to initial_worklist for processing later.
-          initial_worklist.emplace(node);
+          initial_worklist.push(node);
         }
       },
       katana::loopname("InitialWorklistSetup"), katana::no_stats());
@@ -98,19 +103,25 @@ template <typename GraphTy>
 void
 SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
   using GNode = typename GraphTy::Node;
-  auto current = std::make_unique<katana::InsertBag<GNode>>();
-  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  auto current = std::make_unique<katana::Frontier<GNode>>(graph->size());
+  auto next = std::make_unique<katana::Frontier<GNode>>(graph->size());
 
   //! Setup worklist.
   SetupInitialWorklist(*graph, *next, k_core_number);
 
   while (!next->empty()) {
-    //! Make "next" into current.
+    //! Make "next" into current; large rounds are followed by large rounds,
+    //! so the next worklist is dense if this one is.
     std::swap(current, next);
+    current->Adapt();
     next->clear();
+    if (current->IsDense()) {
+      next->ToDense();
+    } else {
+      next->ToSparse();
+    }
 
-    katana::do_all(
-        katana::iterate(*current),
+    current->ForEach(
         [&](const GNode& dead_node) {
           //! Decrement degree of all neighbors.
           for (auto e : Edges(*graph, dead_node)) {
@@ -122,7 +133,7 @@ SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
             if (old_degree == k_core_number) {
               //! This thread was responsible for putting degree of destination
               //! below threshold; add to worklist.
-              next->emplace(dest);
+              next->push(dest);
             }
           }
         },
@@ -195,6 +206,119 @@ KCoreMarkAliveNodes(GraphTy* graph, uint32_t k_core_number) {
   return katana::ResultSuccess();
 }
 
+/**
+ * Peel nodes in increasing order of core number. Unpeeled nodes wait in
+ * buckets by current degree for a window of kNumBuckets degrees; peeling
+ * bucket k runs synchronous rounds that peel the nodes of degree at most k,
+ * decrement the degree of their neighbors and move the touched neighbors
+ * into the next round, if their degree is now at most k, or into the bucket
+ * of their new degree. Buckets hold stale entries for nodes whose degree
+ * has since dropped; those are skipped. When the window runs out, it moves
+ * to the smallest degree left and the unpeeled nodes are bucketed again.
+ *
+ * @param graph Graph to operate on; degrees must be initialized
+ */
+template <typename GraphTy>
+void
+BucketedPeelCoreDecomposition(GraphTy* graph) {
+  using GNode = typename GraphTy::Node;
+  constexpr uint32_t kNumBuckets = 128;
+  constexpr uint32_t kUnpeeled = std::numeric_limits<uint32_t>::max();
+
+  auto degree = [graph](const GNode& node) -> auto& {
+    return graph->template GetData<KCoreNodeCurrentDegree>(node);
+  };
+  auto core = [graph](const GNode& node) -> uint32_t& {
+    return graph->template GetData<KCoreNodeCoreNumber>(node);
+  };
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& node) { core(node) = kUnpeeled; }, katana::no_stats());
+
+  std::vector<katana::InsertBag<GNode>> buckets(kNumBuckets);
+  katana::Frontier<GNode> current(graph->size());
+  katana::Frontier<GNode> touched(graph->size());
+  touched.ToDense();
+  uint64_t num_unpeeled = graph->size();
+  uint32_t base = 0;
+
+  auto fill_buckets = [&]() {
+    katana::GReduceMin<uint32_t> min_degree;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          if (core(node) == kUnpeeled) {
+            min_degree.update(degree(node));
+          }
+        },
+        katana::no_stats());
+    base = min_degree.reduce();
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          uint32_t d = degree(node);
+          if (core(node) == kUnpeeled && d - base < kNumBuckets) {
+            buckets[d - base].push(node);
+          }
+        },
+        katana::loopname("CoreDecomposition Buckets"), katana::no_stats());
+  };
+
+  while (num_unpeeled > 0) {
+    fill_buckets();
+    for (uint32_t b = 0; b < kNumBuckets && num_unpeeled > 0; ++b) {
+      uint32_t k = base + b;
+      current.clear();
+      katana::do_all(
+          katana::iterate(buckets[b]),
+          [&](const GNode& node) {
+            if (core(node) == kUnpeeled && degree(node) == k) {
+              current.push(node);
+            }
+          },
+          katana::no_stats());
+      buckets[b].clear();
+      current.Adapt();
+
+      while (!current.empty()) {
+        num_unpeeled -= current.size();
+        current.ForEach(
+            [&](const GNode& node) { core(node) = k; }, katana::no_stats());
+        current.ForEach(
+            [&](const GNode& node) {
+              for (auto e : Edges(*graph, node)) {
+                auto dest = EdgeDst(*graph, e);
+                if (core(dest) == kUnpeeled) {
+                  katana::atomicSub(degree(dest), 1u);
+                  touched.push(dest);
+                }
+              }
+            },
+            katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
+            katana::loopname("CoreDecomposition Peel"));
+
+        current.clear();
+        touched.ForEach(
+            [&](const GNode& node) {
+              if (core(node) != kUnpeeled) {
+                return;
+              }
+              uint32_t d = degree(node);
+              if (d <= k) {
+                current.push(node);
+              } else if (d - base < kNumBuckets) {
+                buckets[d - base].push(node);
+              }
+            },
+            katana::no_stats());
+        touched.clear();
+        current.Adapt();
+      }
+    }
+  }
+}
+
 template <typename GraphTy>
 static katana::Result<void>
 KCoreImpl(GraphTy* graph, KCorePlan algo, uint32_t k_core_number) {
@@ -265,6 +389,171 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+template <typename GraphTy>
+static katana::Result<void>
+CoreDecompositionImpl(GraphTy* graph, KCorePlan algo) {
+  if (algo.algorithm() != KCorePlan::kSynchronous) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
+        algo.algorithm());
+  }
+
+  size_t approxNodeData = 4 * (graph->NumNodes() + graph->NumEdges());
+  katana::EnsurePreallocated(8, approxNodeData);
+  katana::ReportPageAllocGuard page_alloc;
+
+  DegreeCounting(graph);
+
+  katana::StatTimer exec_time("CoreDecomposition");
+  exec_time.start();
+  BucketedPeelCoreDecomposition(graph);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::CoreDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric, KCorePlan plan) {
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<std::tuple<KCoreNodeCurrentDegree>>(
+          txn_ctx, {temporary_property.name()}));
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<KCoreNodeCoreNumber>>(
+      txn_ctx, {output_property_name}));
+
+  using CoreNodeData = std::tuple<KCoreNodeCurrentDegree, KCoreNodeCoreNumber>;
+  std::vector<std::string> node_properties{
+      temporary_property.name(), output_property_name};
+  if (is_symmetric) {
+    using Graph = katana::TypedPropertyGraphView<
+        katana::PropertyGraphViews::Default, CoreNodeData, EdgeData>;
+    Graph graph = KATANA_CHECKED(Graph::Make(pg, node_properties, {}));
+
+    return CoreDecompositionImpl(&graph, plan);
+  }
+
+  using Graph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Undirected, CoreNodeData, EdgeData>;
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, node_properties, {}));
+
+  return CoreDecompositionImpl(&graph, plan);
+}
+
+template <typename GraphTy>
+static katana::Result<void>
+CoreDecompositionCheck(const GraphTy& graph) {
+  using GNode = typename GraphTy::Node;
+  katana::GReduceLogicalOr too_few_neighbors;
+  katana::GReduceLogicalOr too_many_neighbors;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        uint32_t k = graph.template GetData<KCoreNodeCoreNumber>(node);
+        uint64_t at_least_k = 0;
+        uint64_t above_k = 0;
+        for (auto e : Edges(graph, node)) {
+          auto dest = EdgeDst(graph, e);
+          uint32_t dest_k = graph.template GetData<KCoreNodeCoreNumber>(dest);
+          if (dest_k >= k) {
+            ++at_least_k;
+          }
+          if (dest_k > k) {
+            ++above_k;
+          }
+        }
+        if (at_least_k < k) {
+          too_few_neighbors.update(true);
+        }
+        if (above_k > k) {
+          too_many_neighbors.update(true);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (too_few_neighbors.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "found a node with core number k and fewer than k neighbors in the "
+        "k-core");
+  }
+  if (too_many_neighbors.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "found a node with core number k and more than k neighbors in the "
+        "(k + 1)-core");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::CoreDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    const bool& is_symmetric) {
+  using CoreNodeData = std::tuple<KCoreNodeCoreNumber>;
+  if (is_symmetric) {
+    using Graph = katana::TypedPropertyGraphView<
+        katana::PropertyGraphViews::Default, CoreNodeData, EdgeData>;
+    Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+    return CoreDecompositionCheck(graph);
+  }
+
+  using Graph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Undirected, CoreNodeData, EdgeData>;
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  return CoreDecompositionCheck(graph);
+}
+
+katana::Result<katana::analytics::CoreDecompositionStatistics>
+katana::analytics::CoreDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<KCoreNodeCoreNumber>, std::tuple<>>;
+  using GNode = Graph::Node;
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<uint32_t> max_core;
+  katana::GAccumulator<uint64_t> core_sum;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        uint32_t k = graph.GetData<KCoreNodeCoreNumber>(node);
+        max_core.update(k);
+        core_sum += k;
+      },
+      katana::no_stats());
+
+  uint32_t max_core_number = max_core.reduce();
+  katana::GAccumulator<uint64_t> in_max_core;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        if (graph.GetData<KCoreNodeCoreNumber>(node) == max_core_number) {
+          in_max_core += 1;
+        }
+      },
+      katana::no_stats());
+
+  double average = 0.0;
+  if (graph.NumNodes() > 0) {
+    average = static_cast<double>(core_sum.reduce()) / graph.NumNodes();
+  }
+  return CoreDecompositionStatistics{
+      max_core_number, in_max_core.reduce(), average};
+}
+
+void
+katana::analytics::CoreDecompositionStatistics::Print(std::ostream& os) const {
+  os << "Maximum core number = " << max_core_number << std::endl;
+  os << "Number of nodes in the maximum core = " << number_of_nodes_in_max_core
+     << std::endl;
+  os << "Average core number = " << average_core_number << std::endl;
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
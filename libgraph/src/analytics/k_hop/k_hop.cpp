@@ -0,0 +1,291 @@
+#include "katana/analytics/k_hop/k_hop.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+
+using katana::analytics::KHopNeighborhood;
+using katana::analytics::KHopOptions;
+using katana::analytics::KHopQuery;
+
+namespace {
+
+using View = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+
+/// The nodes a query may visit in its hash set before it moves them to a
+/// bitset, as a fraction of the nodes of the graph
+constexpr uint64_t kBitsetFraction = 64;
+constexpr uint64_t kMinHashCapacity = 64;
+
+}  // namespace
+
+/// The set of the nodes one query visited. It starts as an open addressing
+/// hash set whose slots hold a generation next to the node, so that clearing
+/// it only bumps the generation. Once a query visits more than
+/// 1 / kBitsetFraction of the nodes, it moves them to a bitset of the whole
+/// graph, whose bits are cleared one by one after the query.
+class KHopQuery::Scratch {
+public:
+  explicit Scratch(uint64_t num_nodes)
+      : num_nodes_(num_nodes),
+        bitset_threshold_(
+            std::max(kMinHashCapacity, num_nodes / kBitsetFraction)) {}
+
+  /// Add node; returns whether it was not in the set
+  bool Insert(uint32_t node) {
+    if (use_bitset_) {
+      uint64_t& word = bits_[node / 64];
+      uint64_t mask = uint64_t{1} << (node % 64);
+      if (word & mask) {
+        return false;
+      }
+      word |= mask;
+      members_.emplace_back(node);
+      return true;
+    }
+    if ((size_ + 1) * 2 > slots_.size()) {
+      Grow();
+      if (use_bitset_) {
+        return Insert(node);
+      }
+    }
+    uint64_t stamped = (uint64_t{generation_} << 32) | node;
+    for (uint64_t i = Slot(node);; i = (i + 1) & (slots_.size() - 1)) {
+      if (slots_[i] == stamped) {
+        return false;
+      }
+      if ((slots_[i] >> 32) != generation_) {
+        slots_[i] = stamped;
+        ++size_;
+        members_.emplace_back(node);
+        return true;
+      }
+    }
+  }
+
+  /// Empty the set, in time that depends on its size
+  void Clear() {
+    if (use_bitset_) {
+      for (uint32_t node : members_) {
+        bits_[node / 64] = 0;
+      }
+      use_bitset_ = false;
+    }
+    members_.clear();
+    size_ = 0;
+    if (++generation_ == 0) {
+      // the generations wrapped around, so old slots could look current
+      std::fill(slots_.begin(), slots_.end(), 0);
+      generation_ = 1;
+    }
+  }
+
+private:
+  uint64_t Slot(uint32_t node) const {
+    // Fibonacci hashing into the power of two table
+    return (uint64_t{node} * 0x9e3779b97f4a7c15ULL) >> shift_;
+  }
+
+  /// Double the table, or move to the bitset once there are many members
+  void Grow() {
+    if (size_ + 1 > bitset_threshold_) {
+      if (bits_.empty()) {
+        bits_.resize((num_nodes_ + 63) / 64);
+      }
+      for (uint32_t node : members_) {
+        bits_[node / 64] |= uint64_t{1} << (node % 64);
+      }
+      use_bitset_ = true;
+      return;
+    }
+    uint64_t capacity = std::max(kMinHashCapacity, slots_.size() * 2);
+    slots_.assign(capacity, 0);
+    shift_ = 64 - __builtin_ctzll(capacity);
+    generation_ = 1;
+    size_ = 0;
+    std::vector<uint32_t> members = std::move(members_);
+    members_.clear();
+    for (uint32_t node : members) {
+      Insert(node);
+    }
+  }
+
+  uint64_t num_nodes_;
+  uint64_t bitset_threshold_;
+
+  /// The members in the order they were added, to rehash them and to clear
+  /// their bits
+  std::vector<uint32_t> members_;
+
+  std::vector<uint64_t> slots_;
+  uint32_t shift_{64};
+  uint32_t generation_{1};
+  uint64_t size_{0};
+
+  bool use_bitset_{false};
+  std::vector<uint64_t> bits_;
+};
+
+KHopQuery::KHopQuery(katana::PropertyGraph* pg, KHopOptions options)
+    : pg_(pg), options_(std::move(options)) {}
+
+KHopQuery::~KHopQuery() = default;
+
+katana::Result<std::unique_ptr<KHopQuery>>
+KHopQuery::Make(katana::PropertyGraph* pg, KHopOptions options) {
+  if (!options.out_edges && !options.in_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a k-hop query walks over out edges, in edges or both");
+  }
+  std::unique_ptr<KHopQuery> query(new KHopQuery(pg, std::move(options)));
+  const KHopOptions& opts = query->options_;
+
+  const katana::EntityTypeManager& node_manager = pg->GetNodeTypeManager();
+  if (!opts.node_types.empty()) {
+    std::vector<katana::EntityTypeID> types;
+    for (const std::string& name : opts.node_types) {
+      if (!node_manager.HasAtomicType(name)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "node type {} does not exist", name);
+      }
+      types.emplace_back(node_manager.GetEntityTypeID(name));
+    }
+    // a node has a type if its own type is a subtype of it
+    query->node_type_reached_.resize(node_manager.GetNumEntityTypes());
+    for (size_t t = 0; t < query->node_type_reached_.size(); ++t) {
+      query->node_type_reached_[t] =
+          std::any_of(types.begin(), types.end(), [&](auto type) {
+            return node_manager.IsSubtypeOf(type, t);
+          });
+    }
+  }
+
+  if (opts.edge_types.empty() && !opts.in_edges) {
+    return katana::MakeResult(std::move(query));
+  }
+  query->view_ = std::make_unique<View>(pg->BuildView<View>());
+  if (opts.edge_types.empty()) {
+    return katana::MakeResult(std::move(query));
+  }
+  const katana::EntityTypeManager& edge_manager = pg->GetEdgeTypeManager();
+  std::vector<katana::EntityTypeID> types;
+  for (const std::string& name : opts.edge_types) {
+    if (!edge_manager.HasAtomicType(name)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "edge type {} does not exist", name);
+    }
+    types.emplace_back(edge_manager.GetEntityTypeID(name));
+  }
+  // the view groups the edges by their own most specific types
+  for (katana::EntityTypeID t : query->view_->GetDistinctEdgeTypes()) {
+    if (std::any_of(types.begin(), types.end(), [&](auto type) {
+          return edge_manager.IsSubtypeOf(type, t);
+        })) {
+      query->edge_types_.emplace_back(t);
+    }
+  }
+  return katana::MakeResult(std::move(query));
+}
+
+std::unique_ptr<KHopQuery::Scratch>
+KHopQuery::AcquireScratch() const {
+  {
+    std::lock_guard<std::mutex> lock(scratch_mutex_);
+    if (!free_scratch_.empty()) {
+      std::unique_ptr<Scratch> scratch = std::move(free_scratch_.back());
+      free_scratch_.pop_back();
+      return scratch;
+    }
+  }
+  return std::make_unique<Scratch>(pg_->NumNodes());
+}
+
+void
+KHopQuery::ReleaseScratch(std::unique_ptr<Scratch> scratch) const {
+  scratch->Clear();
+  std::lock_guard<std::mutex> lock(scratch_mutex_);
+  free_scratch_.emplace_back(std::move(scratch));
+}
+
+katana::Result<KHopNeighborhood>
+KHopQuery::Neighbors(uint32_t start_node, uint32_t hops) const {
+  if (start_node >= pg_->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "start node {} is not in a graph of {} nodes", start_node,
+        pg_->NumNodes());
+  }
+  std::unique_ptr<Scratch> scratch = AcquireScratch();
+  scratch->Insert(start_node);
+
+  KHopNeighborhood result;
+  result.hop_offsets.reserve(uint64_t{hops} + 1);
+  result.hop_offsets.emplace_back(0);
+
+  auto visit = [&](uint32_t dst) {
+    if (!node_type_reached_.empty() &&
+        !node_type_reached_[pg_->GetTypeOfNode(dst)]) {
+      return;
+    }
+    if (scratch->Insert(dst)) {
+      result.nodes.emplace_back(dst);
+    }
+  };
+  auto expand = [&](uint32_t src) {
+    if (!view_) {
+      for (auto e : pg_->topology().OutEdges(src)) {
+        visit(pg_->topology().OutEdgeDst(e));
+      }
+      return;
+    }
+    if (edge_types_.empty() && options_.edge_types.empty()) {
+      if (options_.out_edges) {
+        for (auto e : view_->OutEdges(src)) {
+          visit(view_->OutEdgeDst(e));
+        }
+      }
+      if (options_.in_edges) {
+        for (auto e : view_->InEdges(src)) {
+          visit(view_->InEdgeSrc(e));
+        }
+      }
+      return;
+    }
+    for (katana::EntityTypeID type : edge_types_) {
+      if (options_.out_edges) {
+        for (auto e : view_->OutEdges(src, type)) {
+          visit(view_->OutEdgeDst(e));
+        }
+      }
+      if (options_.in_edges) {
+        for (auto e : view_->InEdges(src, type)) {
+          visit(view_->InEdgeSrc(e));
+        }
+      }
+    }
+  };
+
+  // the frontier of each hop is the part of the result the hop before added
+  uint64_t begin = 0;
+  for (uint32_t hop = 0; hop < hops; ++hop) {
+    uint64_t end = result.nodes.size();
+    if (hop == 0) {
+      expand(start_node);
+    } else if (begin == end) {
+      break;
+    } else {
+      for (uint64_t i = begin; i < end; ++i) {
+        expand(result.nodes[i]);
+      }
+    }
+    begin = end;
+    result.hop_offsets.emplace_back(result.nodes.size());
+  }
+  // hops past the end of the neighborhood are empty
+  result.hop_offsets.resize(uint64_t{hops} + 1, result.nodes.size());
+
+  ReleaseScratch(std::move(scratch));
+  return result;
+}
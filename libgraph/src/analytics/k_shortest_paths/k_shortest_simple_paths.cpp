@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/k_shortest_paths/ksssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<>, std::tuple<>>;
+using GNode = BiDirGraphView::Node;
+using Query = std::pair<uint32_t, uint32_t>;
+
+constexpr GNode kNoNode = std::numeric_limits<GNode>::max();
+
+/// A path with the distance from its source to each of its nodes
+template <typename Dist>
+struct Path {
+  std::vector<GNode> nodes;
+  std::vector<Dist> dist;
+  /// Index of the node at which the path leaves the path it was found from;
+  /// spur searches from earlier nodes would only find paths already found
+  uint32_t deviation{0};
+
+  Dist weight() const { return dist.back(); }
+
+  /// The order of the candidates: by weight, then by nodes
+  bool operator>(const Path& other) const {
+    if (weight() != other.weight()) {
+      return weight() > other.weight();
+    }
+    return nodes > other.nodes;
+  }
+};
+
+/// The shortest path tree to the target of a query, found backward along in
+/// edges: every node's distance to the target and its next node there
+template <typename Dist>
+struct TargetTree {
+  static constexpr Dist kInfinity = std::numeric_limits<Dist>::max() / 4;
+
+  std::vector<Dist> dist;
+  std::vector<GNode> next;
+  std::vector<std::pair<Dist, GNode>> heap;
+
+  template <typename View, typename InWeightFn>
+  void Build(const View& view, GNode t, const InWeightFn& in_w) {
+    dist.assign(view.NumNodes(), kInfinity);
+    next.assign(view.NumNodes(), kNoNode);
+    auto cmp = std::greater<std::pair<Dist, GNode>>();
+    heap.clear();
+    dist[t] = 0;
+    heap.emplace_back(0, t);
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), cmp);
+      auto [d, v] = heap.back();
+      heap.pop_back();
+      if (d > dist[v]) {
+        continue;
+      }
+      for (auto e : view.InEdges(v)) {
+        GNode u = view.InEdgeSrc(e);
+        Dist new_dist = d + in_w(e);
+        if (new_dist < dist[u]) {
+          dist[u] = new_dist;
+          next[u] = v;
+          heap.emplace_back(new_dist, u);
+          std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+      }
+    }
+  }
+
+  bool Reaches(GNode n) const { return dist[n] != kInfinity; }
+
+  /// The tree path from s to the target
+  Path<Dist> PathFrom(GNode s) const {
+    Path<Dist> path;
+    for (GNode n = s; n != kNoNode; n = next[n]) {
+      path.nodes.emplace_back(n);
+      path.dist.emplace_back(dist[s] - dist[n]);
+    }
+    return path;
+  }
+};
+
+/// The per thread state of spur searches, allocated on the first search a
+/// thread runs and reused by all its later searches. Like the point to point
+/// searches, arrays are only valid where their stamp is the version of the
+/// current search.
+template <typename Dist>
+class SpurSearch {
+public:
+  /// The shortest path from the node at spur of path to the target of tree
+  /// that avoids the nodes of path before spur and, as its first edge, the
+  /// edges to the next nodes of the accepted paths that share path up to
+  /// spur, appended to that root of path
+  template <typename View, typename OutWeightFn>
+  std::optional<Path<Dist>> Find(
+      const View& view, const TargetTree<Dist>& tree,
+      const OutWeightFn& out_w, const Path<Dist>& path, uint32_t spur,
+      const std::vector<Path<Dist>>& accepted) {
+    Start(view);
+    GNode u = path.nodes[spur];
+    for (uint32_t j = 0; j <= spur; ++j) {
+      blocked_[path.nodes[j]] = version_;
+    }
+    blocked_next_.clear();
+    for (const Path<Dist>& other : accepted) {
+      if (other.nodes.size() > spur + 1 &&
+          std::equal(
+              path.nodes.begin(), path.nodes.begin() + spur + 1,
+              other.nodes.begin())) {
+        blocked_next_.emplace_back(other.nodes[spur + 1]);
+      }
+    }
+
+    // A* with the tree distances, which are exact without the blocked
+    // nodes, so a consistent heuristic. The first node popped whose tree
+    // path is clean of blocked nodes closes a shortest spur path.
+    auto cmp = std::greater<std::pair<Dist, GNode>>();
+    heap_.clear();
+    Reach(u, 0, kNoNode);
+    heap_.emplace_back(tree.dist[u], u);
+    ++num_searches_;
+    while (!heap_.empty()) {
+      std::pop_heap(heap_.begin(), heap_.end(), cmp);
+      auto [f, v] = heap_.back();
+      heap_.pop_back();
+      if (f > dist_[v] + tree.dist[v]) {
+        continue;
+      }
+      ++num_expanded_;
+      if (v != u && Clean(tree, v)) {
+        return Join(tree, path, spur, v);
+      }
+      for (auto e : view.OutEdges(v)) {
+        GNode x = view.OutEdgeDst(e);
+        if (blocked_[x] == version_ || !tree.Reaches(x)) {
+          continue;
+        }
+        if (v == u && std::find(
+                          blocked_next_.begin(), blocked_next_.end(), x) !=
+                          blocked_next_.end()) {
+          continue;
+        }
+        Dist new_dist = dist_[v] + out_w(e);
+        if (reached_[x] != version_ || new_dist < dist_[x]) {
+          Reach(x, new_dist, v);
+          heap_.emplace_back(new_dist + tree.dist[x], x);
+          std::push_heap(heap_.begin(), heap_.end(), cmp);
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+  size_t num_searches() const { return num_searches_; }
+  size_t num_expanded() const { return num_expanded_; }
+
+private:
+  template <typename View>
+  void Start(const View& view) {
+    if (dist_.size() != view.NumNodes()) {
+      dist_.assign(view.NumNodes(), 0);
+      parent_.assign(view.NumNodes(), kNoNode);
+      clean_.assign(view.NumNodes(), 0);
+      for (std::vector<uint32_t>* stamps : {&reached_, &blocked_, &checked_}) {
+        stamps->assign(view.NumNodes(), 0);
+      }
+      version_ = 0;
+    }
+    if (++version_ == 0) {
+      // wrapped around; stamps from 2^32 searches ago would look current
+      for (std::vector<uint32_t>* stamps : {&reached_, &blocked_, &checked_}) {
+        std::fill(stamps->begin(), stamps->end(), 0);
+      }
+      version_ = 1;
+    }
+  }
+
+  void Reach(GNode n, Dist d, GNode parent) {
+    reached_[n] = version_;
+    dist_[n] = d;
+    parent_[n] = parent;
+  }
+
+  /// Whether the tree path from n avoids the blocked nodes. Walks the path
+  /// up to the first node already checked in this search and remembers the
+  /// answer for every node on the way.
+  bool Clean(const TargetTree<Dist>& tree, GNode n) {
+    walk_.clear();
+    bool clean = true;
+    for (GNode x = n; x != kNoNode; x = tree.next[x]) {
+      if (checked_[x] == version_) {
+        clean = clean_[x];
+        break;
+      }
+      if (blocked_[x] == version_) {
+        clean = false;
+        break;
+      }
+      walk_.emplace_back(x);
+    }
+    for (GNode x : walk_) {
+      checked_[x] = version_;
+      clean_[x] = clean;
+    }
+    return clean;
+  }
+
+  /// The root of path up to spur, then the search path to v, then the tree
+  /// path from v to the target
+  Path<Dist> Join(
+      const TargetTree<Dist>& tree, const Path<Dist>& path, uint32_t spur,
+      GNode v) {
+    Path<Dist> joined;
+    joined.deviation = spur;
+    joined.nodes.assign(path.nodes.begin(), path.nodes.begin() + spur);
+    joined.dist.assign(path.dist.begin(), path.dist.begin() + spur);
+    Dist base = path.dist[spur];
+
+    walk_.clear();
+    for (GNode x = v; x != kNoNode; x = parent_[x]) {
+      walk_.emplace_back(x);
+    }
+    for (auto it = walk_.rbegin(); it != walk_.rend(); ++it) {
+      joined.nodes.emplace_back(*it);
+      joined.dist.emplace_back(base + dist_[*it]);
+    }
+    Dist at_v = base + dist_[v];
+    for (GNode x = tree.next[v]; x != kNoNode; x = tree.next[x]) {
+      joined.nodes.emplace_back(x);
+      joined.dist.emplace_back(at_v + (tree.dist[v] - tree.dist[x]));
+    }
+    return joined;
+  }
+
+  std::vector<Dist> dist_;
+  std::vector<GNode> parent_;
+  std::vector<uint8_t> clean_;
+  std::vector<uint32_t> reached_;
+  std::vector<uint32_t> blocked_;
+  std::vector<uint32_t> checked_;
+  std::vector<GNode> blocked_next_;
+  std::vector<GNode> walk_;
+  std::vector<std::pair<Dist, GNode>> heap_;
+  uint32_t version_{0};
+  size_t num_searches_{0};
+  size_t num_expanded_{0};
+};
+
+/// Runs the k shortest simple paths queries, in parallel over queries or,
+/// with fewer queries than threads, over the spurs of every path
+template <
+    typename Dist, typename View, typename OutWeightFn, typename InWeightFn>
+std::vector<std::vector<SimplePath>>
+RunQueries(
+    const View& view, const std::vector<Query>& queries, uint32_t k,
+    const OutWeightFn& out_w, const InWeightFn& in_w) {
+  std::vector<std::vector<SimplePath>> results(queries.size());
+  katana::PerThreadStorage<TargetTree<Dist>> trees;
+  katana::PerThreadStorage<SpurSearch<Dist>> searches;
+  bool parallel_spurs = queries.size() < katana::getActiveThreads();
+
+  auto query_fn = [&](size_t q) {
+    auto [s, t] = queries[q];
+    std::vector<SimplePath>& result = results[q];
+    if (k == 0) {
+      return;
+    }
+    if (s == t) {
+      result.emplace_back(SimplePath{{s}, 0});
+      return;
+    }
+    TargetTree<Dist>& tree = *trees.getLocal();
+    tree.Build(view, t, in_w);
+    if (!tree.Reaches(s)) {
+      return;
+    }
+
+    std::vector<Path<Dist>> accepted{tree.PathFrom(s)};
+    std::set<std::vector<GNode>> seen{accepted[0].nodes};
+    std::priority_queue<
+        Path<Dist>, std::vector<Path<Dist>>, std::greater<Path<Dist>>>
+        candidates;
+    std::vector<std::optional<Path<Dist>>> spurs;
+
+    while (accepted.size() < k) {
+      const Path<Dist>& last = accepted.back();
+      uint32_t first_spur = last.deviation;
+      uint32_t num_spurs = last.nodes.size() - 1 - first_spur;
+      spurs.assign(num_spurs, std::nullopt);
+      auto spur_fn = [&](uint32_t i) {
+        spurs[i] = searches.getLocal()->Find(
+            view, tree, out_w, last, first_spur + i, accepted);
+      };
+      if (parallel_spurs) {
+        katana::do_all(
+            katana::iterate(uint32_t{0}, num_spurs), spur_fn,
+            katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+      } else {
+        for (uint32_t i = 0; i < num_spurs; ++i) {
+          spur_fn(i);
+        }
+      }
+      for (std::optional<Path<Dist>>& spur : spurs) {
+        if (spur && seen.insert(spur->nodes).second) {
+          candidates.emplace(std::move(*spur));
+        }
+      }
+      if (candidates.empty()) {
+        break;
+      }
+      accepted.emplace_back(candidates.top());
+      candidates.pop();
+    }
+
+    result.reserve(accepted.size());
+    for (const Path<Dist>& path : accepted) {
+      result.emplace_back(SimplePath{
+          std::vector<uint32_t>(path.nodes.begin(), path.nodes.end()),
+          static_cast<double>(path.weight())});
+    }
+  };
+
+  katana::StatTimer exec_time("KShortestSimplePaths");
+  exec_time.start();
+  if (parallel_spurs) {
+    for (size_t q = 0; q < queries.size(); ++q) {
+      query_fn(q);
+    }
+  } else {
+    katana::do_all(
+        katana::iterate(size_t{0}, queries.size()), query_fn, katana::steal(),
+        katana::chunk_size<1>(), katana::loopname("KShortestSimplePaths"));
+  }
+  exec_time.stop();
+
+  katana::GAccumulator<size_t> num_searches;
+  katana::GAccumulator<size_t> num_expanded;
+  katana::on_each([&](unsigned, unsigned) {
+    num_searches += searches.getLocal()->num_searches();
+    num_expanded += searches.getLocal()->num_expanded();
+  });
+  katana::ReportStatSingle(
+      "KShortestSimplePaths", "Spur searches", num_searches.reduce());
+  katana::ReportStatSingle(
+      "KShortestSimplePaths", "Expanded nodes", num_expanded.reduce());
+  return results;
+}
+
+template <typename Weight>
+katana::Result<std::vector<std::vector<SimplePath>>>
+WeightedQueries(
+    katana::PropertyGraph* pg, const std::vector<Query>& queries, uint32_t k,
+    const std::string& edge_weight_property_name) {
+  using EdgeWeight = katana::PODProperty<Weight>;
+  using WeightedView = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::BiDirectional, std::tuple<>,
+      std::tuple<EdgeWeight>>;
+
+  auto view =
+      KATANA_CHECKED(WeightedView::Make(pg, {}, {edge_weight_property_name}));
+
+  // weights by edge property index, which both out and in edges map to
+  katana::NUMAArray<Weight> weights;
+  weights.allocateInterleaved(view.NumEdges());
+  katana::do_all(
+      katana::iterate(view),
+      [&](GNode n) {
+        for (auto e : view.OutEdges(n)) {
+          weights[view.GetEdgePropertyIndexFromOutEdge(e)] =
+              view.template GetEdgeData<EdgeWeight>(e);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if constexpr (!std::is_unsigned_v<Weight>) {
+    katana::GReduceLogicalOr bad_weight;
+    katana::do_all(
+        katana::iterate(size_t{0}, weights.size()),
+        [&](size_t i) {
+          // written so that NaN fails too
+          if (!(weights[i] >= 0)) {
+            bad_weight.update(true);
+          }
+        },
+        katana::no_stats());
+    if (bad_weight.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights {} must be non-negative", edge_weight_property_name);
+    }
+  }
+
+  auto out_w = [&](auto e) {
+    return weights[view.GetEdgePropertyIndexFromOutEdge(e)];
+  };
+  auto in_w = [&](auto e) {
+    return weights[view.GetEdgePropertyIndexFromInEdge(e)];
+  };
+  return RunQueries<Weight>(view, queries, k, out_w, in_w);
+}
+
+}  // namespace
+
+katana::Result<std::vector<std::vector<SimplePath>>>
+katana::analytics::KShortestSimplePaths(
+    PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries, uint32_t k,
+    const std::string& edge_weight_property_name) {
+  size_t num_nodes = pg->topology().NumNodes();
+  for (const Query& query : queries) {
+    if (query.first >= num_nodes || query.second >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query ({}, {}) is not in a graph of {} nodes", query.first,
+          query.second, num_nodes);
+    }
+  }
+
+  if (edge_weight_property_name.empty()) {
+    auto view = KATANA_CHECKED(BiDirGraphView::Make(pg, {}, {}));
+    auto unit = [](auto) { return uint32_t{1}; };
+    return RunQueries<uint32_t>(view, queries, k, unit, unit);
+  }
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return WeightedQueries<uint32_t>(
+        pg, queries, k, edge_weight_property_name);
+  case arrow::Int32Type::type_id:
+    return WeightedQueries<int32_t>(pg, queries, k, edge_weight_property_name);
+  case arrow::UInt64Type::type_id:
+    return WeightedQueries<uint64_t>(
+        pg, queries, k, edge_weight_property_name);
+  case arrow::Int64Type::type_id:
+    return WeightedQueries<int64_t>(pg, queries, k, edge_weight_property_name);
+  case arrow::FloatType::type_id:
+    return WeightedQueries<float>(pg, queries, k, edge_weight_property_name);
+  case arrow::DoubleType::type_id:
+    return WeightedQueries<double>(pg, queries, k, edge_weight_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
@@ -208,9 +208,6 @@ DeltaStepAlgo(
       GraphTy, Weight, const Path, true>;
   using kSSSPUpdateRequestIndexer = typename kSSSP::UpdateRequestIndexer;
 
-  using OBIM =
-      katana::OrderedByIntegerMetric<kSSSPUpdateRequestIndexer, PSchunk>;
-
   //! [reducible for self-defined stats]
   katana::GAccumulator<size_t> bad_work;
   //! [reducible for self-defined stats]
@@ -269,7 +266,7 @@ DeltaStepAlgo(
           }
         }
       },
-      katana::wl<OBIM>(kSSSPUpdateRequestIndexer{step_shift}),
+      katana::wl<OBIMTy>(kSSSPUpdateRequestIndexer{step_shift}),
       katana::disable_conflict_detection(), katana::loopname("kSSSP"));
 
   if (kTrackWork) {
@@ -356,6 +353,7 @@ KssspImpl(
       katana::OrderedByIntegerMetric<kSSSPUpdateRequestIndexer, PSchunk>;
   using OBIM_Barrier = typename katana::OrderedByIntegerMetric<
       kSSSPUpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  using MultiQueueWL = katana::MultiQueue<kSSSPUpdateRequestIndexer>;
 
   using BFS = BfsSsspImplementationBase<GraphTy, unsigned int, false>;
   using BFSUpdateRequest = typename BFS::UpdateRequest;
@@ -422,6 +420,12 @@ KssspImpl(
           &paths, &path_pointers, path_alloc, report_node, num_paths,
           step_shift);
       break;
+    case kSsspPlan::kDeltaStepMultiQueue:
+      DeltaStepAlgo<GraphTy, Weight, kSSSPUpdateRequest, MultiQueueWL>(
+          &graph, source, kSSSPReqPushWrap(), kSSSPOutEdgeRangeFn{&graph},
+          &paths, &path_pointers, path_alloc, report_node, num_paths,
+          step_shift);
+      break;
 
     default:
       return katana::ErrorCode::InvalidArgument;
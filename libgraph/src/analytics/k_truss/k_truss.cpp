@@ -20,6 +20,7 @@
 #include "katana/analytics/k_truss/k_truss.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/SortedIntersection.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -96,37 +97,24 @@ bool
 IsSupportNoLessThanJ(
     const SortedGraphView& g, GNode src, GNode dest, unsigned int j) {
   size_t numValidEqual = 0;
-  auto srcI = g.OutEdges(src).begin(), srcE = g.OutEdges(src).end(),
-       dstI = g.OutEdges(dest).begin(), dstE = g.OutEdges(dest).end();
-
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.GetEdgeData<EdgeFlag>(*srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.GetEdgeData<EdgeFlag>(*dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
-
-    //! Check for intersection.
-    auto sN = g.OutEdgeDst(*srcI), dN = g.OutEdgeDst(*dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
-    }
+  if (j == 0) {
+    return true;
   }
+  auto srcBegin = *g.OutEdges(src).begin();
+  auto dstBegin = *g.OutEdges(dest).begin();
+  const GNode* dsts = g.DestData();
+
+  //! Intersect all edges, then only count the matches between valid edges.
+  katana::ForEachSortedIntersection(
+      dsts + srcBegin, g.OutDegree(src), dsts + dstBegin, g.OutDegree(dest),
+      [&](size_t src_i, size_t dst_i) {
+        if ((g.GetEdgeData<EdgeFlag>(srcBegin + src_i) & removed) ||
+            (g.GetEdgeData<EdgeFlag>(dstBegin + dst_i) & removed)) {
+          return true;
+        }
+        numValidEqual += 1;
+        return numValidEqual < j;
+      });
 
   return numValidEqual >= j;
 }
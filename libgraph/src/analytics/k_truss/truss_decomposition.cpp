@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/SortedIntersection.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/k_truss/k_truss.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using EdgeData = std::tuple<EdgeTrussness>;
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, std::tuple<>, EdgeData>;
+using GNode = Graph::Node;
+
+/// Trussness of the edges that are not part of the simple graph: self loops
+constexpr uint32_t kNoTrussness = 0;
+
+/// The simple undirected graph underlying a symmetric graph: adjacency lists
+/// sorted, without duplicates or self loops, so that they can be passed to
+/// the sorted intersection kernels. Every slot knows the id of its
+/// undirected edge, which is the slot of the edge's direction from its
+/// smaller endpoint.
+struct SimpleGraph {
+  size_t num_nodes;
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> sizes;
+  katana::NUMAArray<GNode> neighbors;
+  katana::NUMAArray<uint64_t> edge_ids;
+
+  const GNode* begin(GNode n) const { return &neighbors[0] + offsets[n]; }
+  uint32_t size(GNode n) const { return sizes[n]; }
+
+  /// The slot of dst in the list of src, which must be adjacent
+  uint64_t Slot(GNode src, GNode dst) const {
+    const GNode* first = begin(src);
+    return offsets[src] +
+           (std::lower_bound(first, first + size(src), dst) - first);
+  }
+
+  /// The undirected edge of two adjacent nodes
+  uint64_t EdgeId(GNode src, GNode dst) const {
+    return edge_ids[Slot(src, dst)];
+  }
+
+  /// The node whose list has the given slot
+  GNode Source(uint64_t slot) const {
+    const uint64_t* first = &offsets[0];
+    return std::upper_bound(first, first + num_nodes + 1, slot) - first - 1;
+  }
+
+  void Build(const Graph& graph) {
+    num_nodes = graph.NumNodes();
+    offsets.allocateInterleaved(num_nodes + 1);
+    offsets[num_nodes] = graph.NumEdges();
+    sizes.allocateInterleaved(num_nodes);
+    neighbors.allocateInterleaved(graph.NumEdges());
+    edge_ids.allocateInterleaved(graph.NumEdges());
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto edges = graph.OutEdges(n);
+          offsets[n] = *edges.begin();
+          GNode* first = &neighbors[0] + *edges.begin();
+          GNode* last = first;
+          for (auto e : edges) {
+            GNode dst = graph.OutEdgeDst(e);
+            if (dst != n) {
+              *last++ = dst;
+            }
+          }
+          std::sort(first, last);
+          sizes[n] = std::unique(first, last) - first;
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          const GNode* first = begin(n);
+          for (uint32_t i = 0; i < size(n); ++i) {
+            GNode dst = first[i];
+            if (n < dst) {
+              edge_ids[offsets[n] + i] = offsets[n] + i;
+            } else {
+              edge_ids[offsets[n] + i] = Slot(dst, n);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Calls fn(u, v, e) for every undirected edge e, where u < v
+  template <typename Fn>
+  void ForEachEdge(Fn fn) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](GNode n) {
+          const GNode* first = begin(n);
+          for (uint32_t i = 0; i < size(n); ++i) {
+            if (n < first[i]) {
+              fn(n, first[i], offsets[n] + i);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Calls fn(uw, vw) with the ids of the other two edges of every triangle
+  /// of the edge of u and v
+  template <typename Fn>
+  void ForEachTriangle(GNode u, GNode v, Fn fn) const {
+    uint64_t u_offset = offsets[u];
+    uint64_t v_offset = offsets[v];
+    katana::ForEachSortedIntersection(
+        begin(u), size(u), begin(v), size(v), [&](size_t i, size_t j) {
+          fn(edge_ids[u_offset + i], edge_ids[v_offset + j]);
+          return true;
+        });
+  }
+};
+
+/// Where an undirected edge is in the peeling
+enum EdgeState : uint8_t {
+  kAlive,
+  /// Being peeled at the current level
+  kPeeling,
+  kPeeled,
+};
+
+}  // namespace
+
+katana::Result<uint32_t>
+katana::analytics::TrussDecomposition(
+    katana::TxnContext* txn_ctx, katana::PropertyGraph* pg,
+    const std::string& output_property_name) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  KATANA_CHECKED(
+      pg->ConstructEdgeProperties<EdgeData>(txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {}, {output_property_name}));
+
+  katana::StatTimer exec_time("TrussDecomposition");
+  exec_time.start();
+
+  SimpleGraph simple;
+  simple.Build(graph);
+  size_t num_slots = graph.NumEdges();
+
+  // the support of an edge is the number of its triangles among edges that
+  // are not peeled yet
+  katana::NUMAArray<std::atomic<uint32_t>> support;
+  katana::NUMAArray<EdgeState> state;
+  katana::NUMAArray<uint32_t> trussness;
+  support.allocateInterleaved(num_slots);
+  state.allocateInterleaved(num_slots);
+  trussness.allocateInterleaved(num_slots);
+
+  auto alive = std::make_unique<katana::InsertBag<uint64_t>>();
+  simple.ForEachEdge([&](GNode u, GNode v, uint64_t e) {
+    support[e].store(
+        katana::SortedIntersectionCount(
+            simple.begin(u), simple.size(u), simple.begin(v), simple.size(v)),
+        std::memory_order_relaxed);
+    state[e] = kAlive;
+    alive->push(e);
+  });
+
+  // Peeling, after Kabir and Madduri's PKT: at each level, the edges whose
+  // support is at most the level get trussness level + 2 and are peeled
+  // together, lowering the support of the edges of their triangles, which
+  // may then join the next round of the same level. A triangle with two
+  // edges peeled in the same round is only accounted for by the smaller.
+  auto current = std::make_unique<katana::InsertBag<uint64_t>>();
+  auto next = std::make_unique<katana::InsertBag<uint64_t>>();
+  uint32_t level = 0;
+  uint32_t num_levels = 0;
+  while (true) {
+    katana::GReduceMin<uint32_t> min_support;
+    auto still_alive = std::make_unique<katana::InsertBag<uint64_t>>();
+    katana::do_all(
+        katana::iterate(*alive),
+        [&](uint64_t e) {
+          if (state[e] == kAlive) {
+            min_support.update(support[e].load(std::memory_order_relaxed));
+            still_alive->push(e);
+          }
+        },
+        katana::no_stats());
+    std::swap(alive, still_alive);
+    if (alive->empty()) {
+      break;
+    }
+    // skip the levels at which no edge would be peeled
+    level = std::max(level, min_support.reduce());
+    num_levels += 1;
+
+    katana::do_all(
+        katana::iterate(*alive),
+        [&](uint64_t e) {
+          if (support[e].load(std::memory_order_relaxed) <= level) {
+            current->push(e);
+          }
+        },
+        katana::no_stats());
+
+    // lowers the support of e, unless it is already low enough to be peeled
+    // at this level
+    auto lower = [&](uint64_t e) {
+      uint32_t s = support[e].load(std::memory_order_relaxed);
+      while (s > level) {
+        if (support[e].compare_exchange_weak(
+                s, s - 1, std::memory_order_relaxed)) {
+          if (s - 1 == level) {
+            next->push(e);
+          }
+          return;
+        }
+      }
+    };
+
+    while (!current->empty()) {
+      katana::do_all(
+          katana::iterate(*current), [&](uint64_t e) { state[e] = kPeeling; },
+          katana::no_stats());
+      katana::do_all(
+          katana::iterate(*current),
+          [&](uint64_t e) {
+            GNode u = simple.Source(e);
+            GNode v = simple.neighbors[e];
+            simple.ForEachTriangle(u, v, [&](uint64_t uw, uint64_t vw) {
+              EdgeState uw_state = state[uw];
+              EdgeState vw_state = state[vw];
+              if (uw_state == kPeeled || vw_state == kPeeled) {
+                return;
+              }
+              if (uw_state == kPeeling && vw_state == kPeeling) {
+                return;
+              }
+              if (uw_state == kPeeling) {
+                if (e < uw) {
+                  lower(vw);
+                }
+              } else if (vw_state == kPeeling) {
+                if (e < vw) {
+                  lower(uw);
+                }
+              } else {
+                lower(uw);
+                lower(vw);
+              }
+            });
+          },
+          katana::steal(), katana::loopname("TrussDecomposition"));
+      katana::do_all(
+          katana::iterate(*current),
+          [&](uint64_t e) {
+            state[e] = kPeeled;
+            trussness[e] = level + 2;
+          },
+          katana::no_stats());
+      current->clear();
+      std::swap(current, next);
+    }
+  }
+
+  katana::GReduceMax<uint32_t> max_trussness;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.OutEdges(n)) {
+          GNode dst = graph.OutEdgeDst(e);
+          uint32_t t = kNoTrussness;
+          if (dst != n) {
+            t = trussness[simple.EdgeId(n, dst)];
+          }
+          graph.GetEdgeData<EdgeTrussness>(e) = t;
+          max_trussness.update(t);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  exec_time.stop();
+
+  katana::ReportStatSingle("TrussDecomposition", "Levels", num_levels);
+  return max_trussness.reduce();
+}
+
+katana::Result<void>
+katana::analytics::TrussDecompositionAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {}, {property_name}));
+
+  SimpleGraph simple;
+  simple.Build(graph);
+  katana::NUMAArray<uint32_t> trussness;
+  trussness.allocateInterleaved(graph.NumEdges());
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.OutEdges(n)) {
+          GNode dst = graph.OutEdgeDst(e);
+          if (n < dst) {
+            trussness[simple.EdgeId(n, dst)] =
+                graph.GetEdgeData<EdgeTrussness>(e);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // every direction and parallel copy of an edge has the same trussness
+  katana::GAccumulator<uint64_t> inconsistent;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.OutEdges(n)) {
+          GNode dst = graph.OutEdgeDst(e);
+          uint32_t expected =
+              dst == n ? kNoTrussness : trussness[simple.EdgeId(n, dst)];
+          if (graph.GetEdgeData<EdgeTrussness>(e) != expected) {
+            inconsistent += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (uint64_t count = inconsistent.reduce(); count > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} edges differ in trussness from their reverse or parallel edges",
+        count);
+  }
+
+  // An edge of trussness t has t - 2 triangles among the edges of trussness
+  // at least t, so it is in the t-truss, and fewer than t - 1 among those of
+  // trussness more than t
+  katana::GAccumulator<uint64_t> wrong;
+  simple.ForEachEdge([&](GNode u, GNode v, uint64_t e) {
+    uint32_t t = trussness[e];
+    uint32_t at_least = 0;
+    uint32_t more = 0;
+    simple.ForEachTriangle(u, v, [&](uint64_t uw, uint64_t vw) {
+      uint32_t other = std::min(trussness[uw], trussness[vw]);
+      at_least += other >= t;
+      more += other > t;
+    });
+    if (t < 2 || at_least < t - 2 || more >= t - 1) {
+      wrong += 1;
+    }
+  });
+  if (uint64_t count = wrong.reduce(); count > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} edges do not have the trussness of the decomposition", count);
+  }
+  return katana::ResultSuccess();
+}
@@ -22,6 +22,7 @@
 #include <deque>
 #include <type_traits>
 
+#include "katana/Arena.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
 
@@ -98,6 +99,15 @@ struct LeidenClusteringImplementation
             c_info[n_data_curr_comm_id].degree_wt, n_data_degree_wt);
       });
     }
+    // Only the nodes with a neighbor that moved in the last round may gain
+    // by moving
+    katana::DynamicBitset active;
+    katana::DynamicBitset next_active;
+    active.resize(graph->NumNodes());
+    next_active.resize(graph->NumNodes());
+    active.set();
+    katana::GAccumulator<uint64_t> evaluations;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -106,6 +116,9 @@ struct LeidenClusteringImplementation
       katana::do_all(
           katana::iterate(*graph),
           [&](GNode n) {
+            if (!active.test(n)) {
+              return;
+            }
             auto& n_data_curr_comm_id =
                 graph->template GetData<CurrentCommunityID>(n);
             auto& n_data_degree_wt =
@@ -113,6 +126,13 @@ struct LeidenClusteringImplementation
             auto& n_data_node_wt = graph->template GetData<NodeWeight>(n);
 
             uint64_t degree = Degree(*graph, n);
+            if (degree > 0 &&
+                Base::template CannotGainByMoving<EdgeWeightType>(
+                    *graph, n, n_data_node_wt, n_data_curr_comm_id,
+                    constant_for_second_term)) {
+              return;
+            }
+            evaluations += 1;
             uint64_t local_target = Base::UNASSIGNED;
             std::map<uint64_t, uint64_t>
                 cluster_local_map;  // Map each neighbor's cluster to local number:
@@ -148,9 +168,14 @@ struct LeidenClusteringImplementation
 
               /* Set the new cluster id */
               n_data_curr_comm_id = local_target;
+              for (auto e : Edges(*graph, n)) {
+                next_active.set(EdgeDst(*graph, e));
+              }
             }
           },
           katana::loopname("leiden algo: Phase 1"));
+      std::swap(active, next_active);
+      next_active.reset();
 
       /* Calculate the overall modularity */
       double e_xx = 0;
@@ -168,6 +193,7 @@ struct LeidenClusteringImplementation
 
     }  // End while
     TimerClusteringWhile.stop();
+    katana::ReportStatSingle("Leiden", "evaluations", evaluations.reduce());
 
     iter = num_iter;
 
@@ -388,12 +414,15 @@ public:
       katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
       const std::vector<std::string>& temp_node_property_names,
       katana::NUMAArray<uint64_t>& clusters_orig, LeidenClusteringPlan plan,
-      katana::TxnContext* txn_ctx) {
+      katana::TxnContext* txn_ctx, const ClusteringWarmStart* warm_start) {
     katana::StatTimer TimerTotal("Timer_Leiden_Total");
     TimerTotal.start();
     TemporaryPropertyGuard temp_edge_property{pg->EdgeMutablePropertyView()};
     std::vector<std::string> temp_edge_property_names = {
         temp_edge_property.name()};
+    // Scratch buffers of each coarsening round, reusing the memory of the
+    // previous round
+    katana::Arena scratch;
 
     /*
      * Construct temp property graph. This graph gets coarsened as the
@@ -405,14 +434,23 @@ public:
         Graph::Make(pg, temp_node_property_names, {edge_weight_property_name}));
 
     /*
-    * Vertex following optimization
+    * A warm start, or the vertex following optimization, coarsens the
+    * graph before the first level
     */
-    if (plan.enable_vf()) {
-      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
-
-      uint64_t num_unique_clusters =
-          Base::template RenumberClustersContiguously<CurrentCommunityID>(
-              &graph_curr);
+    const bool coarsen_first = warm_start || plan.enable_vf();
+    if (coarsen_first) {
+      uint64_t num_unique_clusters = 0;
+      if (warm_start) {
+        num_unique_clusters =
+            KATANA_CHECKED(Base::template SeedClusters<CurrentCommunityID>(
+                &graph_curr, pg, *warm_start, plan.warm_start_hops()));
+      } else {
+        Base::VertexFollowing(
+            &graph_curr);  // Find nodes that follow other nodes
+        num_unique_clusters =
+            Base::template RenumberClustersContiguously<CurrentCommunityID>(
+                &graph_curr);
+      }
 
       /*
      * Initialize node cluster id.
@@ -427,7 +465,8 @@ public:
       auto coarsened_graph_result = Base::template GraphCoarsening<
           NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
           graph_curr, pg_empty.get(), num_unique_clusters,
-          temp_node_property_names, temp_edge_property_names, txn_ctx);
+          temp_node_property_names, temp_edge_property_names, txn_ctx,
+          &scratch);
       if (!coarsened_graph_result) {
         return coarsened_graph_result.error();
       }
@@ -468,7 +507,7 @@ public:
 
       graph_curr = KATANA_CHECKED(Graph::Make(pg_curr.get()));
 
-      if (iter == 1) {
+      if (iter == 1 && !coarsen_first) {
         /* Initialization each node to its own cluster */
         katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
           graph_curr.template GetData<CurrentCommunityID>(n) = n;
@@ -476,8 +515,31 @@ public:
           clusters_orig[n] = n;
           graph_curr.template GetData<NodeWeight>(n) = 1;
         });
+      } else if (iter == 1) {
+        // The nodes of a coarsened first level already stand for the nodes
+        // of clusters_orig, and weigh as much as the nodes they contract
+        katana::NUMAArray<std::atomic<uint64_t>> cluster_node_wt;
+        cluster_node_wt.allocateBlocked(graph_curr.NumNodes());
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          cluster_node_wt[n] = 0;
+        });
+        katana::do_all(
+            katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+              if (clusters_orig[n] != Base::UNASSIGNED) {
+                katana::atomicAdd(
+                    cluster_node_wt[clusters_orig[n]], uint64_t{1});
+              }
+            });
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          graph_curr.template GetData<CurrentCommunityID>(n) = n;
+          graph_curr.template GetData<PreviousCommunityID>(n) = n;
+          graph_curr.template GetData<NodeWeight>(n) = cluster_node_wt[n];
+        });
       }
-      if (graph_curr.NumNodes() > plan.min_graph_size()) {
+      // the first level of a warm start always runs, so that the nodes
+      // screened for it are re-evaluated
+      if (graph_curr.NumNodes() > plan.min_graph_size() ||
+          (warm_start && phase == 1)) {
         switch (plan.algorithm()) {
         case LeidenClusteringPlan::kDoAll: {
           curr_mod = KATANA_CHECKED(LeidenWithoutLockingDoAll(
@@ -506,7 +568,7 @@ public:
       katana::StatTimer TimerRefine("Timer_Refine_Total");
       TimerRefine.start();
       Base::template RefinePartition<EdgeWeightType>(
-          &graph_curr, plan.resolution());
+          &graph_curr, plan.resolution(), &scratch);
       TimerRefine.stop();
       uint64_t num_unique_subclusters =
           Base::template RenumberClustersContiguously<CurrentSubCommunityID>(
@@ -514,7 +576,7 @@ public:
 
       if (iter < plan.max_iterations() &&
           (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
-        if (!plan.enable_vf() && phase == 1) {
+        if (!coarsen_first && phase == 1) {
           KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.NumNodes());
           katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
             clusters_orig[n] =
@@ -560,7 +622,8 @@ public:
         auto coarsened_graph_result = Base::template GraphCoarsening<
             NodeData, EdgeData, EdgeWeightType, CurrentSubCommunityID>(
             graph_curr, pg_curr.get(), num_unique_subclusters,
-            temp_node_property_names, temp_edge_property_names, txn_ctx);
+            temp_node_property_names, temp_edge_property_names, txn_ctx,
+            &scratch);
         if (!coarsened_graph_result) {
           return coarsened_graph_result.error();
         }
@@ -602,7 +665,7 @@ public:
     auto coarsened_graph_result = Base::template GraphCoarsening<
         NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
         graph_curr, pg_curr.get(), num_unique_clusters,
-        temp_node_property_names, temp_edge_property_names, txn_ctx);
+        temp_node_property_names, temp_edge_property_names, txn_ctx, &scratch);
     if (!coarsened_graph_result) {
       return coarsened_graph_result.error();
     }
@@ -657,7 +720,8 @@ static katana::Result<void>
 LeidenClusteringWithWrap(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, const bool& is_symmetric,
-    LeidenClusteringPlan plan, katana::TxnContext* txn_ctx) {
+    LeidenClusteringPlan plan, katana::TxnContext* txn_ctx,
+    const ClusteringWarmStart* warm_start) {
   static_assert(
       std::is_integral_v<EdgeWeightType> ||
       std::is_floating_point_v<EdgeWeightType>);
@@ -691,7 +755,7 @@ LeidenClusteringWithWrap(
         impl{};
     KATANA_CHECKED(impl.LeidenClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, warm_start));
   } else {
     using Impl = LeidenClusteringImplementation<
         EdgeWeightType, katana::PropertyGraphViews::Undirected>;
@@ -703,7 +767,7 @@ LeidenClusteringWithWrap(
         impl{};
     KATANA_CHECKED(impl.LeidenClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, warm_start));
   }
 
   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
@@ -725,11 +789,12 @@ LeidenClusteringWithWrap(
 
 }  // anonymous namespace
 
-katana::Result<void>
-katana::analytics::LeidenClustering(
+static katana::Result<void>
+LeidenClusteringDispatch(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
-    const bool& is_symmetric, LeidenClusteringPlan plan) {
+    const bool& is_symmetric, LeidenClusteringPlan plan,
+    const ClusteringWarmStart* warm_start) {
   if (!edge_weight_property_name.empty() &&
       !pg->HasEdgeProperty(edge_weight_property_name)) {
     return KATANA_ERROR(
@@ -746,7 +811,7 @@ katana::analytics::LeidenClustering(
         pg, temporary_edge_property.name(), txn_ctx));
     return LeidenClusteringWithWrap<int64_t>(
         pg, temporary_edge_property.name(), output_property_name, is_symmetric,
-        plan, txn_ctx);
+        plan, txn_ctx, warm_start);
   }
 
   switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
@@ -755,27 +820,27 @@ katana::analytics::LeidenClustering(
   case arrow::UInt32Type::type_id:
     return LeidenClusteringWithWrap<uint32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::Int32Type::type_id:
     return LeidenClusteringWithWrap<int32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::UInt64Type::type_id:
     return LeidenClusteringWithWrap<uint64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::Int64Type::type_id:
     return LeidenClusteringWithWrap<int64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::FloatType::type_id:
     return LeidenClusteringWithWrap<float>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::DoubleType::type_id:
     return LeidenClusteringWithWrap<double>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   default:
     return KATANA_ERROR(
         katana::ErrorCode::TypeError, "Unsupported type: {}",
@@ -785,6 +850,39 @@ katana::analytics::LeidenClustering(
   }
 }
 
+katana::Result<void>
+katana::analytics::LeidenClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, LeidenClusteringPlan plan) {
+  auto pins = KATANA_CHECKED(PinnedProperties::Make(
+      pg, LeidenClusteringPropertyRequirements(edge_weight_property_name)));
+  return LeidenClusteringDispatch(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, nullptr);
+}
+
+katana::Result<void>
+katana::analytics::LeidenClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& initial_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, LeidenClusteringPlan plan) {
+  auto pins = KATANA_CHECKED(PinnedProperties::Make(
+      pg, LeidenClusteringPropertyRequirements(
+              edge_weight_property_name, initial_property_name)));
+  if (!pg->HasNodeProperty(initial_property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Node Property: {} Not found",
+        initial_property_name);
+  }
+  ClusteringWarmStart warm_start{initial_property_name, changed_edges};
+  return LeidenClusteringDispatch(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, &warm_start);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::LeidenClusteringAssertValid(
@@ -19,7 +19,16 @@
 
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/SortedIntersection.h"
+#include "katana/Statistics.h"
 
 using namespace katana::analytics;
 
@@ -34,8 +43,86 @@ using EdgeData = typename std::tuple<>;
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 using SortedGraphView =
     katana::TypedPropertyGraphView<SortedPropertyGraphView, NodeData, EdgeData>;
+using HubBitmapGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::EdgesSortedByDestIDHubBitmaps, NodeData,
+    EdgeData>;
+// The views of triangle counting, whose nodes are sorted by decreasing degree
+using DegreeSortedGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID,
+    NodeData, EdgeData>;
+using DegreeSortedHubBitmapGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::
+        NodesSortedByDegreeEdgesSortedByDestIDHubBitmaps,
+    NodeData, EdgeData>;
 using Node = SortedGraphView::Node;
 
+/// Whether membership tests on high degree nodes can use their bitmaps
+template <typename G>
+constexpr bool kHasHubBitmaps =
+    std::is_same_v<G, HubBitmapGraphView> ||
+    std::is_same_v<G, DegreeSortedHubBitmapGraphView>;
+
+/// Confidence of the bound of the error of sampled coefficients
+constexpr double kSampleConfidence = 0.95;
+
+/**
+ * Calls fn(v, w) for each triangle (n, v, w) with w <= v <= n. It assumes that
+ * edgelist of each node is sorted.
+ *
+ * @param has_parallel_edges whether the graph has parallel edges, in which
+ *   case the triangle is reported for every edge from v to w
+ * @param scratch per-thread buffer for the intersections
+ */
+template <typename Graph, typename Fn>
+void
+ForEachOrderedTriangle(
+    const Graph& graph, bool has_parallel_edges, Node n,
+    std::vector<Node>* scratch, Fn fn) {
+  bool n_is_hub = false;
+  if constexpr (kHasHubBitmaps<Graph>) {
+    n_is_hub = graph.IsHub(n);
+  }
+  const Node* dsts = graph.DestData();
+  const Node* n_first = dsts + *graph.OutEdges(n).begin();
+  const Node* n_last = n_first + graph.OutDegree(n);
+
+  // TODO(amber): replace with NodeIteratingAlgo for triangle counting
+  for (const Node* it_n = n_first; it_n != n_last && *it_n <= n; ++it_n) {
+    Node v = *it_n;
+    const Node* v_first = dsts + *graph.OutEdges(v).begin();
+    const Node* v_last =
+        std::upper_bound(v_first, v_first + graph.OutDegree(v), v);
+
+    if (n_is_hub) {
+      for (const Node* w = v_first; w != v_last; ++w) {
+        if (graph.HasEdge(n, *w)) {
+          fn(v, *w);
+        }
+      }
+      continue;
+    }
+
+    // Neighbors of n above v cannot close a triangle
+    const Node* n_upto_v = std::upper_bound(n_first, n_last, v);
+    if (has_parallel_edges) {
+      // The vector kernels need sets
+      for (const Node* w = v_first; w != v_last; ++w) {
+        if (std::binary_search(n_first, n_upto_v, *w)) {
+          fn(v, *w);
+        }
+      }
+      continue;
+    }
+    scratch->resize(std::min<size_t>(n_upto_v - n_first, v_last - v_first));
+    size_t num_common = katana::SortedIntersection(
+        n_first, n_upto_v - n_first, v_first, v_last - v_first,
+        scratch->data());
+    for (size_t i = 0; i < num_common; ++i) {
+      fn(v, (*scratch)[i]);
+    }
+  }
+}
+
 struct LocalClusteringCoefficientAtomics {
   /**
    * Counts the number of triangles for each node
@@ -45,35 +132,20 @@ struct LocalClusteringCoefficientAtomics {
    * triangles. It assumes that edgelist of each node
    * is sorted.
    */
-  template <typename CountVec>
+  template <typename Graph, typename CountVec>
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, CountVec* count_vec) {
-    // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.OutEdges(n)) {
-      auto v = graph.OutEdgeDst(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.OutEdges(n).begin();
-
-      for (auto edges_v : graph.OutEdges(v)) {
-        auto dst_v = graph.OutEdgeDst(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.OutEdgeDst(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.OutEdgeDst(*e_it_n)) {
+      const Graph& graph, bool has_parallel_edges, Node n,
+      std::vector<Node>* scratch, CountVec* count_vec) {
+    ForEachOrderedTriangle(
+        graph, has_parallel_edges, n, scratch, [&](Node v, Node w) {
           __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
           __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
-        }
-      }
-    }
+          __sync_fetch_and_add(&(*count_vec)[w], uint32_t{1});
+        });
   }
 
-  void ComputeLocalClusteringCoefficient(SortedGraphView* graph) {
+  template <typename Graph>
+  void ComputeLocalClusteringCoefficient(Graph* graph) {
     katana::NUMAArray<uint32_t> per_node_triangles;
     per_node_triangles.allocateInterleaved(graph->NumNodes());
 
@@ -81,10 +153,14 @@ struct LocalClusteringCoefficientAtomics {
         per_node_triangles.begin(), per_node_triangles.end(), uint32_t{0});
 
     // Count triangles
+    const bool has_parallel_edges = HasParallelEdges(*graph);
+    katana::PerThreadStorage<std::vector<Node>> scratch;
     katana::do_all(
         katana::iterate(*graph),
         [&](const Node& n) {
-          OrderedCountFunc(*graph, n, &per_node_triangles);
+          OrderedCountFunc(
+              *graph, has_parallel_edges, n, scratch.getLocal(),
+              &per_node_triangles);
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -103,7 +179,8 @@ struct LocalClusteringCoefficientAtomics {
     return;
   }
 
-  katana::Result<void> operator()(SortedGraphView* graph) {
+  template <typename Graph>
+  katana::Result<void> operator()(Graph* graph) {
     katana::StatTimer execTime(
         "LocalClusteringCoefficient", "LocalClusteringCoefficient");
     execTime.start();
@@ -131,31 +208,16 @@ struct LocalClusteringCoefficientPerThread {
  * triangles. It assumes that edgelist of each node
  * is sorted.
  */
+  template <typename Graph>
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, IterPair per_thread_count_range) {
-    // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.OutEdges(n)) {
-      auto v = graph.OutEdgeDst(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.OutEdges(n).begin();
-
-      for (auto edges_v : graph.OutEdges(v)) {
-        auto dst_v = graph.OutEdgeDst(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.OutEdgeDst(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.OutEdgeDst(*e_it_n)) {
+      const Graph& graph, bool has_parallel_edges, Node n,
+      std::vector<Node>* scratch, IterPair per_thread_count_range) {
+    ForEachOrderedTriangle(
+        graph, has_parallel_edges, n, scratch, [&](Node v, Node w) {
           *(per_thread_count_range.first + n) += 1;
           *(per_thread_count_range.first + v) += 1;
-          *(per_thread_count_range.first + dst_v) += 1;
-        }
-      }
-    }
+          *(per_thread_count_range.first + w) += 1;
+        });
   }
 
   /*
@@ -163,7 +225,8 @@ struct LocalClusteringCoefficientPerThread {
  * It assumes that edgelist of each node is sorted.
  * This uses a PerThreadStorage implementation.
  */
-  void OrderedCountAlgo(const SortedGraphView& graph) {
+  template <typename Graph>
+  void OrderedCountAlgo(const Graph& graph) {
     const uint64_t num_nodes = graph.size();
     const uint32_t num_threads = katana::getActiveThreads();
 
@@ -180,11 +243,14 @@ struct LocalClusteringCoefficientPerThread {
           all_thread_count_vec.begin(), all_thread_count_vec.end(), tid, numT);
     });
 
+    const bool has_parallel_edges = HasParallelEdges(graph);
+    katana::PerThreadStorage<std::vector<Node>> scratch;
     katana::do_all(
         katana::iterate(graph),
         [&](const Node& n) {
           OrderedCountFunc(
-              graph, n, *per_thread_node_triangle_count.getLocal());
+              graph, has_parallel_edges, n, scratch.getLocal(),
+              *per_thread_node_triangle_count.getLocal());
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -203,7 +269,8 @@ struct LocalClusteringCoefficientPerThread {
         katana::loopname("TriangleCount_Reduce"));
   }
 
-  void ComputeLocalClusteringCoefficient(SortedGraphView* graph) {
+  template <typename Graph>
+  void ComputeLocalClusteringCoefficient(Graph* graph) {
     katana::do_all(katana::iterate(*graph), [&](Node n) {
       auto degree = graph->OutDegree(n);
       if (degree > 1) {
@@ -218,7 +285,8 @@ struct LocalClusteringCoefficientPerThread {
     return;
   }
 
-  katana::Result<void> operator()(SortedGraphView* graph) {
+  template <typename Graph>
+  katana::Result<void> operator()(Graph* graph) {
     katana::StatTimer execTime(
         "LocalClusteringCoefficient", "LocalClusteringCoefficient");
     execTime.start();
@@ -237,25 +305,154 @@ struct LocalClusteringCoefficientPerThread {
     return katana::ResultSuccess();
   }
 };
+
+struct LocalClusteringCoefficientDegreeOrdered {
+  uint32_t sample_min_degree;
+  double max_error;
+
+  /// Number of wedges for an estimate within max_error of the coefficient
+  /// with kSampleConfidence, by Hoeffding's inequality
+  uint64_t NumSamples() const {
+    return std::ceil(
+        std::log(2 / (1 - kSampleConfidence)) / (2 * max_error * max_error));
+  }
+
+  /**
+   * Share of the wedges of n that are closed, of a sample of num_samples
+   * wedges or of all of them if there are fewer. Requires a degree of at
+   * least 2.
+   */
+  template <typename Graph>
+  double SampleCoefficient(
+      const Graph& graph, Node n, uint64_t num_samples) const {
+    uint64_t degree = graph.OutDegree(n);
+    const Node* dsts = graph.DestData() + *graph.OutEdges(n).begin();
+    uint64_t num_wedges = degree * (degree - 1) / 2;
+    uint64_t num_closed = 0;
+
+    if (num_wedges <= num_samples) {
+      for (uint64_t i = 0; i < degree; ++i) {
+        for (uint64_t j = i + 1; j < degree; ++j) {
+          num_closed += graph.HasEdge(dsts[i], dsts[j]);
+        }
+      }
+      return static_cast<double>(num_closed) / num_wedges;
+    }
+
+    for (uint64_t s = 0; s < num_samples; ++s) {
+      // A uniform pair of distinct neighbors
+      uint64_t i = katana::StatelessRandom(2 * s, n) % degree;
+      uint64_t j = katana::StatelessRandom(2 * s + 1, n) % (degree - 1);
+      if (j >= i) {
+        ++j;
+      }
+      num_closed += graph.HasEdge(dsts[i], dsts[j]);
+    }
+    return static_cast<double>(num_closed) / num_samples;
+  }
+
+  template <typename Graph>
+  katana::Result<void> operator()(Graph* graph) {
+    katana::StatTimer execTime(
+        "LocalClusteringCoefficient", "LocalClusteringCoefficient");
+    execTime.start();
+
+    katana::NUMAArray<uint32_t> per_node_triangles;
+    per_node_triangles.allocateInterleaved(graph->NumNodes());
+    katana::ParallelSTL::fill(
+        per_node_triangles.begin(), per_node_triangles.end(), uint32_t{0});
+
+    // The nodes are sorted by decreasing degree, so the triangles found from
+    // a sampled node only have sampled nodes, and are not needed
+    auto is_sampled = [&](Node n) {
+      return graph->OutDegree(n) >= sample_min_degree;
+    };
+
+    const bool has_parallel_edges = HasParallelEdges(*graph);
+    katana::PerThreadStorage<std::vector<Node>> scratch;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const Node& n) {
+          if (is_sampled(n)) {
+            return;
+          }
+          uint32_t num_triangles = 0;
+          ForEachOrderedTriangle(
+              *graph, has_parallel_edges, n, scratch.getLocal(),
+              [&](Node v, Node w) {
+                ++num_triangles;
+                __sync_fetch_and_add(&per_node_triangles[v], uint32_t{1});
+                __sync_fetch_and_add(&per_node_triangles[w], uint32_t{1});
+              });
+          __sync_fetch_and_add(&per_node_triangles[n], num_triangles);
+        },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::loopname("TriangleCount_DegreeOrdered"));
+
+    uint64_t num_samples = NumSamples();
+    katana::GAccumulator<uint64_t> num_sampled;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const Node& n) {
+          uint64_t degree = graph->OutDegree(n);
+          double coefficient = 0.0;
+          if (degree > 1 && is_sampled(n)) {
+            coefficient = SampleCoefficient(*graph, n, num_samples);
+            num_sampled += 1;
+          } else if (degree > 1) {
+            coefficient = static_cast<double>(2 * per_node_triangles[n]) /
+                          (degree * (degree - 1));
+          }
+          graph->template GetData<NodeClusteringCoefficient>(n) = coefficient;
+        },
+        katana::steal(),
+        katana::loopname("LocalClusteringCoefficient_DegreeOrdered"));
+
+    execTime.stop();
+    katana::ReportStatSingle(
+        "LocalClusteringCoefficient", "SampledNodes", num_sampled.reduce());
+    return katana::ResultSuccess();
+  }
+};
 }  // namespace
 
-template <typename Algorithm>
+template <typename Graph, typename Algorithm>
 katana::Result<void>
 LocalClusteringCoefficientWithWrap(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::TxnContext* txn_ctx) {
+    katana::TxnContext* txn_ctx, Algorithm algo = {}) {
   if (auto result = pg->ConstructNodeProperties<NodeData>(
           txn_ctx, {output_property_name});
       !result) {
     return result.error();
   }
   auto sorted_view =
-      KATANA_CHECKED(SortedGraphView::Make(pg, {output_property_name}, {}));
+      KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
 
-  Algorithm algo;
   return algo(&sorted_view);
 }
 
+template <typename Graph>
+katana::Result<void>
+LocalClusteringCoefficientWithAlgorithm(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const LocalClusteringCoefficientPlan& plan) {
+  switch (plan.algorithm()) {
+  case LocalClusteringCoefficientPlan::kOrderedCountAtomics: {
+    return LocalClusteringCoefficientWithWrap<
+        Graph, LocalClusteringCoefficientAtomics>(
+        pg, output_property_name, txn_ctx);
+  }
+  case LocalClusteringCoefficientPlan::kOrderedCountPerThread: {
+    return LocalClusteringCoefficientWithWrap<
+        Graph, LocalClusteringCoefficientPerThread>(
+        pg, output_property_name, txn_ctx);
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
 katana::Result<void>
 katana::analytics::LocalClusteringCoefficient(
     katana::PropertyGraph* pg, const std::string& output_property_name,
@@ -276,7 +473,7 @@ katana::analytics::LocalClusteringCoefficient(
     break;
   case LocalClusteringCoefficientPlan::kAutoRelabel:
     timer_auto_algo.start();
-    relabel = IsApproximateDegreeDistributionPowerLaw(*pg);
+    relabel = pg->GetGraphStatistics().power_law;
     timer_auto_algo.stop();
     break;
   default:
@@ -312,16 +509,26 @@ katana::analytics::LocalClusteringCoefficient(
 
   katana::EnsurePreallocated(1, 16 * (pg->NumNodes() + pg->NumEdges()));
 
-  switch (plan.algorithm()) {
-  case LocalClusteringCoefficientPlan::kOrderedCountAtomics: {
-    return LocalClusteringCoefficientWithWrap<
-        LocalClusteringCoefficientAtomics>(pg, output_property_name, txn_ctx);
-  }
-  case LocalClusteringCoefficientPlan::kOrderedCountPerThread: {
-    return LocalClusteringCoefficientWithWrap<
-        LocalClusteringCoefficientPerThread>(pg, output_property_name, txn_ctx);
+  if (plan.algorithm() == LocalClusteringCoefficientPlan::kDegreeOrdered) {
+    if (!(plan.max_error() > 0 && plan.max_error() <= 1)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "max error must be in (0, 1], not {}", plan.max_error());
+    }
+    LocalClusteringCoefficientDegreeOrdered algo{
+        plan.sample_min_degree(), plan.max_error()};
+    if (plan.hub_bitmaps()) {
+      return LocalClusteringCoefficientWithWrap<DegreeSortedHubBitmapGraphView>(
+          pg, output_property_name, txn_ctx, algo);
+    }
+    return LocalClusteringCoefficientWithWrap<DegreeSortedGraphView>(
+        pg, output_property_name, txn_ctx, algo);
   }
-  default:
-    return katana::ErrorCode::InvalidArgument;
+
+  if (plan.hub_bitmaps()) {
+    return LocalClusteringCoefficientWithAlgorithm<HubBitmapGraphView>(
+        pg, output_property_name, txn_ctx, plan);
   }
+  return LocalClusteringCoefficientWithAlgorithm<SortedGraphView>(
+      pg, output_property_name, txn_ctx, plan);
 }
@@ -19,10 +19,12 @@
 
 #include "katana/analytics/louvain_clustering/louvain_clustering.h"
 
+#include <atomic>
 #include <cmath>
 #include <deque>
 #include <type_traits>
 
+#include "katana/Arena.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
 
@@ -90,6 +92,15 @@ struct LouvainClusteringImplementation
       KATANA_LOG_FATAL("constant_for_second_term is INFINITY\n");
     }
 
+    // Only the nodes with a neighbor that moved in the last round may gain
+    // by moving
+    katana::DynamicBitset active;
+    katana::DynamicBitset next_active;
+    active.resize(graph->NumNodes());
+    next_active.resize(graph->NumNodes());
+    active.set();
+    katana::GAccumulator<uint64_t> evaluations;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -103,12 +114,22 @@ struct LouvainClusteringImplementation
       katana::do_all(
           katana::iterate(*graph),
           [&](GNode n) {
+            if (!active.test(n)) {
+              return;
+            }
             auto& n_data_curr_comm_id =
                 graph->template GetData<CurrentCommunityID>(n);
             auto& n_data_degree_wt =
                 graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
 
             uint64_t degree = Degree(*graph, n);
+            if (degree > 0 &&
+                Base::template CannotGainByMoving<EdgeWeightType>(
+                    *graph, n, n_data_degree_wt, n_data_curr_comm_id,
+                    constant_for_second_term)) {
+              return;
+            }
+            evaluations += 1;
             uint64_t local_target = Base::UNASSIGNED;
             // TODO(amber): use scalable allocator with these containers
             std::map<uint64_t, uint64_t>
@@ -143,9 +164,14 @@ struct LouvainClusteringImplementation
 
               /* Set the new cluster id */
               n_data_curr_comm_id = local_target;
+              for (auto e : Edges(*graph, n)) {
+                next_active.set(EdgeDst(*graph, e));
+              }
             }
           },
           katana::loopname("louvain algo: Phase 1"));
+      std::swap(active, next_active);
+      next_active.reset();
 
       /* Calculate the overall modularity */
       double e_xx = 0;
@@ -167,6 +193,7 @@ struct LouvainClusteringImplementation
 
     }  // End while
     TimerClusteringWhile.stop();
+    katana::ReportStatSingle("Louvain", "evaluations", evaluations.reduce());
 
     iter = num_iter;
 
@@ -223,15 +250,18 @@ struct LouvainClusteringImplementation
     // partition nodes
     std::vector<katana::InsertBag<GNode>> bag(16);
 
+    // Communities changed by the current round, each pushed once by the
+    // thread that marks it in_bag first, so that they can be committed in
+    // parallel
     katana::InsertBag<GNode> to_process;
-    katana::NUMAArray<bool> in_bag;
+    katana::NUMAArray<std::atomic<bool>> in_bag;
 
     in_bag.allocateBlocked(graph->NumNodes());
 
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
       uint64_t idx = n % 16;
       bag[idx].push(n);
-      in_bag[n] = false;
+      in_bag.constructAt(n, false);
       local_target[n] = Base::UNASSIGNED;
     });
 
@@ -295,14 +325,14 @@ struct LouvainClusteringImplementation
                 katana::atomicAdd(
                     c_update_subtract[n_data_curr_comm_id].size, (uint64_t)1);
 
-                if (!in_bag[local_target[n]]) {
+                if (!in_bag[local_target[n]].exchange(
+                        true, std::memory_order_relaxed)) {
                   to_process.push(local_target[n]);
-                  in_bag[local_target[n]] = true;
                 }
 
-                if (!in_bag[n_data_curr_comm_id]) {
+                if (!in_bag[n_data_curr_comm_id].exchange(
+                        true, std::memory_order_relaxed)) {
                   to_process.push(n_data_curr_comm_id);
-                  in_bag[n_data_curr_comm_id] = true;
                 }
               }
             },
@@ -312,22 +342,25 @@ struct LouvainClusteringImplementation
           graph->template GetData<CurrentCommunityID>(n) = local_target[n];
         });
 
-        for (auto n : to_process) {
-          if (in_bag[n]) {
-            katana::atomicAdd(c_info[n].size, c_update_add[n].size.load());
-            katana::atomicAdd(
-                c_info[n].degree_wt, c_update_add[n].degree_wt.load());
-
-            katana::atomicSub(c_info[n].size, c_update_subtract[n].size.load());
-            katana::atomicSub(
-                c_info[n].degree_wt, c_update_subtract[n].degree_wt.load());
-            c_update_add[n].size = 0;
-            c_update_add[n].degree_wt = 0;
-            c_update_subtract[n].size = 0;
-            c_update_subtract[n].degree_wt = 0;
-            in_bag[n] = false;
-          }
-        }
+        katana::do_all(
+            katana::iterate(to_process),
+            [&](GNode n) {
+              katana::atomicAdd(c_info[n].size, c_update_add[n].size.load());
+              katana::atomicAdd(
+                  c_info[n].degree_wt, c_update_add[n].degree_wt.load());
+
+              katana::atomicSub(
+                  c_info[n].size, c_update_subtract[n].size.load());
+              katana::atomicSub(
+                  c_info[n].degree_wt, c_update_subtract[n].degree_wt.load());
+              c_update_add[n].size = 0;
+              c_update_add[n].degree_wt = 0;
+              c_update_subtract[n].size = 0;
+              c_update_subtract[n].degree_wt = 0;
+              in_bag[n] = false;
+            },
+            katana::loopname("louvain algo: Commit"));
+        to_process.clear();
 
       }  // end for
 
@@ -360,10 +393,13 @@ public:
       katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
       const std::vector<std::string>& temp_node_property_names,
       katana::NUMAArray<uint64_t>& clusters_orig, LouvainClusteringPlan plan,
-      katana::TxnContext* txn_ctx) {
+      katana::TxnContext* txn_ctx, const ClusteringWarmStart* warm_start) {
     TemporaryPropertyGuard temp_edge_property{pg->EdgeMutablePropertyView()};
     std::vector<std::string> temp_edge_property_names = {
         temp_edge_property.name()};
+    // Scratch buffers of each coarsening round, reusing the memory of the
+    // previous round
+    katana::Arena scratch;
 
     /*
      * Construct temp property graph. This graph gets coarsened as the
@@ -371,18 +407,30 @@ public:
      */
     std::unique_ptr<katana::PropertyGraph> pg_mutable;
 
-    Graph graph_curr = KATANA_CHECKED(
-        Graph::Make(pg, temp_node_property_names, {edge_weight_property_name}));
+    // This graph only reads the weights, to coarsen it before the first
+    // level, so read them in the edge order of the view rather than through
+    // the property indices of its edges
+    Graph graph_curr = KATANA_CHECKED(Graph::MakeWithEdgePropertiesInViewOrder(
+        pg, temp_node_property_names, {edge_weight_property_name}));
 
     /*
-    * Vertex following optimization
+    * A warm start, or the vertex following optimization, coarsens the
+    * graph before the first level
     */
-    if (plan.enable_vf()) {
-      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
-
-      uint64_t num_unique_clusters =
-          Base::template RenumberClustersContiguously<CurrentCommunityID>(
-              &graph_curr);
+    const bool coarsen_first = warm_start || plan.enable_vf();
+    if (coarsen_first) {
+      uint64_t num_unique_clusters = 0;
+      if (warm_start) {
+        num_unique_clusters =
+            KATANA_CHECKED(Base::template SeedClusters<CurrentCommunityID>(
+                &graph_curr, pg, *warm_start, plan.warm_start_hops()));
+      } else {
+        Base::VertexFollowing(
+            &graph_curr);  // Find nodes that follow other nodes
+        num_unique_clusters =
+            Base::template RenumberClustersContiguously<CurrentCommunityID>(
+                &graph_curr);
+      }
 
       /*
      * Initialize node cluster id.
@@ -397,7 +445,8 @@ public:
       auto coarsened_graph_result = Base::template GraphCoarsening<
           NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
           graph_curr, pg_empty.get(), num_unique_clusters,
-          temp_node_property_names, temp_edge_property_names, txn_ctx);
+          temp_node_property_names, temp_edge_property_names, txn_ctx,
+          &scratch);
       if (!coarsened_graph_result) {
         return coarsened_graph_result.error();
       }
@@ -436,7 +485,10 @@ public:
       phase++;
 
       Graph graph_curr = KATANA_CHECKED(Graph::Make(pg_curr.get()));
-      if (graph_curr.NumNodes() > plan.min_graph_size()) {
+      // the first level of a warm start always runs, so that the nodes
+      // screened for it are re-evaluated
+      if (graph_curr.NumNodes() > plan.min_graph_size() ||
+          (warm_start && phase == 1)) {
         switch (plan.algorithm()) {
         case LouvainClusteringPlan::kDoAll: {
           curr_mod = KATANA_CHECKED(LouvainWithoutLockingDoAll(
@@ -464,7 +516,7 @@ public:
 
       if (iter < plan.max_iterations() &&
           (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
-        if (!plan.enable_vf() && phase == 1) {
+        if (!coarsen_first && phase == 1) {
           KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.NumNodes());
           katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
             clusters_orig[n] =
@@ -486,7 +538,8 @@ public:
         auto coarsened_graph_result = Base::template GraphCoarsening<
             NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
             graph_curr, pg_curr.get(), num_unique_clusters,
-            temp_node_property_names, temp_edge_property_names, txn_ctx);
+            temp_node_property_names, temp_edge_property_names, txn_ctx,
+            &scratch);
         if (!coarsened_graph_result) {
           return coarsened_graph_result.error();
         }
@@ -530,7 +583,8 @@ static katana::Result<void>
 LouvainClusteringWithWrap(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, const bool& is_symmetric,
-    LouvainClusteringPlan plan, katana::TxnContext* txn_ctx) {
+    LouvainClusteringPlan plan, katana::TxnContext* txn_ctx,
+    const ClusteringWarmStart* warm_start) {
   static_assert(
       std::is_integral_v<EdgeWeightType> ||
       std::is_floating_point_v<EdgeWeightType>);
@@ -562,7 +616,7 @@ LouvainClusteringWithWrap(
     LouvainClusteringImplementation<EdgeWeightType, GraphViewTy> impl{};
     KATANA_CHECKED(impl.LouvainClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, warm_start));
   } else {
     using GraphViewTy = katana::PropertyGraphViews::Undirected;
     using Impl = LouvainClusteringImplementation<EdgeWeightType, GraphViewTy>;
@@ -572,7 +626,7 @@ LouvainClusteringWithWrap(
     LouvainClusteringImplementation<EdgeWeightType, GraphViewTy> impl{};
     KATANA_CHECKED(impl.LouvainClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, warm_start));
   }
 
   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
@@ -594,11 +648,12 @@ LouvainClusteringWithWrap(
 
 }  // anonymous namespace
 
-katana::Result<void>
-katana::analytics::LouvainClustering(
+static katana::Result<void>
+LouvainClusteringDispatch(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
-    const bool& is_symmetric, LouvainClusteringPlan plan) {
+    const bool& is_symmetric, LouvainClusteringPlan plan,
+    const ClusteringWarmStart* warm_start) {
   if (!edge_weight_property_name.empty() &&
       !pg->HasEdgeProperty(edge_weight_property_name)) {
     return KATANA_ERROR(
@@ -615,7 +670,7 @@ katana::analytics::LouvainClustering(
         pg, temporary_edge_property.name(), txn_ctx));
     return LouvainClusteringWithWrap<int64_t>(
         pg, temporary_edge_property.name(), output_property_name, is_symmetric,
-        plan, txn_ctx);
+        plan, txn_ctx, warm_start);
   }
 
   switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
@@ -624,27 +679,27 @@ katana::analytics::LouvainClustering(
   case arrow::UInt32Type::type_id:
     return LouvainClusteringWithWrap<uint32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::Int32Type::type_id:
     return LouvainClusteringWithWrap<int32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::UInt64Type::type_id:
     return LouvainClusteringWithWrap<uint64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::Int64Type::type_id:
     return LouvainClusteringWithWrap<int64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::FloatType::type_id:
     return LouvainClusteringWithWrap<float>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   case arrow::DoubleType::type_id:
     return LouvainClusteringWithWrap<double>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, warm_start);
   default:
     return KATANA_ERROR(
         katana::ErrorCode::TypeError, "Unsupported type: {}",
@@ -654,6 +709,39 @@ katana::analytics::LouvainClustering(
   }
 }
 
+katana::Result<void>
+katana::analytics::LouvainClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, LouvainClusteringPlan plan) {
+  auto pins = KATANA_CHECKED(PinnedProperties::Make(
+      pg, LouvainClusteringPropertyRequirements(edge_weight_property_name)));
+  return LouvainClusteringDispatch(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, nullptr);
+}
+
+katana::Result<void>
+katana::analytics::LouvainClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& initial_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& changed_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, LouvainClusteringPlan plan) {
+  auto pins = KATANA_CHECKED(PinnedProperties::Make(
+      pg, LouvainClusteringPropertyRequirements(
+              edge_weight_property_name, initial_property_name)));
+  if (!pg->HasNodeProperty(initial_property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Node Property: {} Not found",
+        initial_property_name);
+  }
+  ClusteringWarmStart warm_start{initial_property_name, changed_edges};
+  return LouvainClusteringDispatch(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, &warm_start);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::LouvainClusteringAssertValid(
@@ -19,6 +19,8 @@
 
 #include "katana/analytics/matrix_completion/matrix_completion.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <type_traits>
 #include <utility>
@@ -28,6 +30,7 @@
 #include "katana/AtomicWrapper.h"
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
 #include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
@@ -368,6 +371,304 @@ public:
   }
 };
 
+/// Alternating least squares: every round solves the regularized least
+/// squares problem of every item with the user vectors fixed, and then that
+/// of every user with the item vectors fixed. The vectors are copied into
+/// one dense array allocated in blocks, so that the nodes of a thread are
+/// on its NUMA node, and are written back to the graph once converged.
+class ALSAlgo {
+public:
+  bool IsSgd() const { return false; }
+
+  std::string Name() const { return "alsAlgo"; }
+
+  size_t NumItems() const { return kNumItemNodes; }
+
+private:
+  static constexpr int K = LATENT_VECTOR_SIZE;
+  /// Neighbors whose vectors are added to the normal equations together
+  static constexpr int kGramBlock = 4;
+  static constexpr unsigned kChunkSize = 4;
+
+  struct Rating {
+    GNode item;
+    LatentValue value;
+  };
+
+  /// The normal equations (X^T X + lambda I) x = X^T r of one node, where
+  /// the rows of X are the vectors of its neighbors. Only the upper
+  /// triangle of the Gram matrix X^T X is accumulated.
+  struct NormalEquations {
+    LatentValue gram[K][K];
+    LatentValue rhs[K];
+
+    void Reset() {
+      for (int r = 0; r < K; ++r) {
+        for (int c = r; c < K; ++c) {
+          gram[r][c] = 0;
+        }
+        rhs[r] = 0;
+      }
+    }
+
+    /// Adds count neighbor vectors at once, so that every entry of the
+    /// Gram matrix is loaded and stored once per block of neighbors
+    void Add(
+        const LatentValue* const* vectors, const LatentValue* ratings,
+        int count) {
+      for (int r = 0; r < K; ++r) {
+        for (int c = r; c < K; ++c) {
+          LatentValue sum = 0;
+          for (int j = 0; j < count; ++j) {
+            sum += vectors[j][r] * vectors[j][c];
+          }
+          gram[r][c] += sum;
+        }
+        LatentValue sum = 0;
+        for (int j = 0; j < count; ++j) {
+          sum += ratings[j] * vectors[j][r];
+        }
+        rhs[r] += sum;
+      }
+    }
+
+    /// Solves the equations by Cholesky factorization, writing the factor
+    /// into the lower triangle. Returns false, leaving out unchanged, if the
+    /// system is not positive definite.
+    bool Solve(LatentValue lambda, LatentValue* out) {
+      for (int j = 0; j < K; ++j) {
+        LatentValue d = gram[j][j] + lambda;
+        for (int k = 0; k < j; ++k) {
+          d -= gram[j][k] * gram[j][k];
+        }
+        if (!(d > 0)) {
+          return false;
+        }
+        d = std::sqrt(d);
+        gram[j][j] = d;
+        for (int i = j + 1; i < K; ++i) {
+          LatentValue v = gram[j][i];
+          for (int k = 0; k < j; ++k) {
+            v -= gram[i][k] * gram[j][k];
+          }
+          gram[i][j] = v / d;
+        }
+      }
+
+      LatentValue y[K];
+      for (int i = 0; i < K; ++i) {
+        LatentValue v = rhs[i];
+        for (int k = 0; k < i; ++k) {
+          v -= gram[i][k] * y[k];
+        }
+        y[i] = v / gram[i][i];
+      }
+      for (int i = K - 1; i >= 0; --i) {
+        LatentValue v = y[i];
+        for (int k = i + 1; k < K; ++k) {
+          v -= gram[k][i] * out[k];
+        }
+        out[i] = v / gram[i][i];
+      }
+      return true;
+    }
+  };
+
+  katana::NUMAArray<LatentValue> factors_;
+  /// The ratings of every user, by item, which the graph only has as the
+  /// out edges of the items
+  katana::NUMAArray<uint64_t> user_offsets_;
+  katana::NUMAArray<Rating> user_ratings_;
+
+  LatentValue* Vector(GNode n) { return &factors_[0] + uint64_t{n} * K; }
+
+  void Initialize(Graph& graph) {
+    size_t num_nodes = graph.size();
+    factors_.allocateBlocked(num_nodes * K);
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto node_latent_vector = graph.GetData<NodeLatentVector>(n);
+          LatentValue* vector = Vector(n);
+          for (int i = 0; i < K; i++) {
+            vector[i] = node_latent_vector[i];
+          }
+        },
+        katana::no_stats());
+
+    size_t num_users = num_nodes - kNumItemNodes;
+    katana::NUMAArray<std::atomic<uint64_t>> cursors;
+    cursors.allocateBlocked(num_users);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_users),
+        [&](size_t u) { cursors[u] = 0; }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph.begin(), graph.begin() + kNumItemNodes),
+        [&](GNode item) {
+          for (auto ii : graph.OutEdges(item)) {
+            cursors[graph.OutEdgeDst(ii) - kNumItemNodes].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    user_offsets_.allocateBlocked(num_users + 1);
+    user_offsets_[0] = 0;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_users),
+        [&](size_t u) { user_offsets_[u + 1] = cursors[u]; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        user_offsets_.begin(), user_offsets_.end(), user_offsets_.begin());
+    katana::do_all(
+        katana::iterate(size_t{0}, num_users),
+        [&](size_t u) { cursors[u] = user_offsets_[u]; }, katana::no_stats());
+
+    user_ratings_.allocateBlocked(user_offsets_[num_users]);
+    katana::do_all(
+        katana::iterate(graph.begin(), graph.begin() + kNumItemNodes),
+        [&](GNode item) {
+          for (auto ii : graph.OutEdges(item)) {
+            uint64_t slot =
+                cursors[graph.OutEdgeDst(ii) - kNumItemNodes].fetch_add(
+                    1, std::memory_order_relaxed);
+            user_ratings_[slot] = {item, graph.GetEdgeData<EdgeWeight>(ii)};
+          }
+        },
+        katana::steal(), katana::no_stats());
+    // in order of item, so that the sums of a user do not depend on the
+    // schedule
+    katana::do_all(
+        katana::iterate(size_t{0}, num_users),
+        [&](size_t u) {
+          std::sort(
+              &user_ratings_[0] + user_offsets_[u],
+              &user_ratings_[0] + user_offsets_[u + 1],
+              [](const Rating& a, const Rating& b) { return a.item < b.item; });
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Solves for the vector of every node in [begin, end) with the vectors of
+  /// its neighbors fixed, where for_each_rating(n, fn) calls
+  /// fn(neighbor, rating) for every rating of n. Returns the number of
+  /// nodes whose equations were singular and kept their vectors.
+  template <typename ForEachRating>
+  uint64_t SolveAll(
+      size_t begin, size_t end, LatentValue lambda,
+      ForEachRating for_each_rating, const char* loopname) {
+    katana::PerThreadStorage<NormalEquations> equations;
+    katana::GAccumulator<uint64_t> singular;
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](size_t n) {
+          NormalEquations& normal = *equations.getLocal();
+          normal.Reset();
+          const LatentValue* block[kGramBlock];
+          LatentValue ratings[kGramBlock];
+          int count = 0;
+          for_each_rating(n, [&](GNode neighbor, LatentValue rating) {
+            block[count] = Vector(neighbor);
+            ratings[count] = rating;
+            if (++count == kGramBlock) {
+              normal.Add(block, ratings, count);
+              count = 0;
+            }
+          });
+          normal.Add(block, ratings, count);
+          if (!normal.Solve(lambda, Vector(n))) {
+            singular += 1;
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname(loopname));
+    return singular.reduce();
+  }
+
+  double SumSquaredError(Graph& graph) {
+    katana::GAccumulator<double> error;
+    katana::do_all(
+        katana::iterate(graph.begin(), graph.begin() + kNumItemNodes),
+        [&](GNode n) {
+          const LatentValue* item_vector = Vector(n);
+          for (auto ii : graph.OutEdges(n)) {
+            const LatentValue* user_vector = Vector(graph.OutEdgeDst(ii));
+            LatentValue e = graph.GetEdgeData<EdgeWeight>(ii);
+            for (int i = 0; i < K; i++) {
+              e -= item_vector[i] * user_vector[i];
+            }
+            error += e * e;
+          }
+        },
+        katana::steal(), katana::no_stats());
+    return error.reduce();
+  }
+
+public:
+  void operator()(
+      Graph& graph, const MatrixCompletionImplementation::StepFunction&,
+      MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
+    katana::StatTimer executeTimer("Time");
+    executeTimer.start();
+
+    Initialize(graph);
+
+    auto item_ratings = [&](size_t item, auto fn) {
+      for (auto ii : graph.OutEdges(item)) {
+        fn(graph.OutEdgeDst(ii), graph.GetEdgeData<EdgeWeight>(ii));
+      }
+    };
+    auto user_ratings = [&](size_t user, auto fn) {
+      size_t u = user - kNumItemNodes;
+      for (uint64_t i = user_offsets_[u]; i < user_offsets_[u + 1]; ++i) {
+        fn(user_ratings_[i].item, user_ratings_[i].value);
+      }
+    };
+
+    uint64_t singular = 0;
+    uint32_t rounds = 0;
+    double last = -1.0;
+    double error = SumSquaredError(graph);
+    for (uint32_t round = 0;; ++round) {
+      if (plan.fixedRounds() > 0 && round >= plan.fixedRounds())
+        break;
+
+      singular += SolveAll(
+          0, kNumItemNodes, plan.lambda(), item_ratings, "alsAlgo-items");
+      singular += SolveAll(
+          kNumItemNodes, graph.size(), plan.lambda(), user_ratings,
+          "alsAlgo-users");
+      rounds += 1;
+
+      last = error;
+      error = SumSquaredError(graph);
+      if (!impl.IsFinite(error))
+        break;
+      if (plan.fixedRounds() <= 0 &&
+          (rounds >= plan.maxUpdates() ||
+           std::abs((last - error) / last) < plan.tolerance()))
+        break;
+    }
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto node_latent_vector = graph.GetData<NodeLatentVector>(n);
+          const LatentValue* vector = Vector(n);
+          for (int i = 0; i < K; i++) {
+            node_latent_vector[i] = vector[i];
+          }
+        },
+        katana::no_stats());
+
+    executeTimer.stop();
+
+    katana::ReportStatSingle("alsAlgo", "Rounds", rounds);
+    katana::ReportStatSingle("alsAlgo", "SingularSystems", singular);
+    katana::ReportStatSingle("alsAlgo", "SumSquaredError", error);
+  }
+};
+
 template <typename Algo>
 katana::Result<void>
 Run(katana::PropertyGraph* pg, MatrixCompletionPlan plan,
@@ -403,6 +704,8 @@ katana::analytics::MatrixCompletion(
   switch (plan.algorithm()) {
   case MatrixCompletionPlan::kSGDByItems:
     return Run<SGDItemsAlgo>(pg, plan, txn_ctx);
+  case MatrixCompletionPlan::kALS:
+    return Run<ALSAlgo>(pg, plan, txn_ctx);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
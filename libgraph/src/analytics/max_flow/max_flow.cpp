@@ -0,0 +1,574 @@
+#include "katana/analytics/max_flow/max_flow.h"
+
+#include <atomic>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+struct MinCutSide : public katana::PODProperty<uint8_t> {};
+
+using NodeData = std::tuple<MinCutSide>;
+using EdgeData = std::tuple<>;
+
+using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+using GNode = Graph::Node;
+
+/// The work of a global relabeling per node besides the edges it scans, as
+/// in Goldberg's push-relabel implementations
+constexpr uint64_t kAlpha = 6;
+/// The work of a relabel besides the edges it scans
+constexpr uint64_t kBeta = 12;
+
+template <typename T>
+katana::Result<void>
+CopyCapacities(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    katana::NUMAArray<int64_t>* capacities) {
+  using Capacity = katana::PODProperty<T>;
+  using CapacityGraph =
+      katana::TypedPropertyGraph<std::tuple<>, std::tuple<Capacity>>;
+  CapacityGraph graph =
+      KATANA_CHECKED(CapacityGraph::Make(pg, {}, {property_name}));
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const typename CapacityGraph::Node& n) {
+        for (auto e : graph.OutEdges(n)) {
+          T capacity = graph.template GetEdgeData<Capacity>(e);
+          if constexpr (std::is_signed_v<T>) {
+            if (capacity < 0) {
+              out_of_range.update(true);
+              continue;
+            }
+          }
+          if (uint64_t(capacity) >
+              uint64_t(std::numeric_limits<int64_t>::max())) {
+            out_of_range.update(true);
+            continue;
+          }
+          (*capacities)[e] = capacity;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "found a capacity that is negative or larger than the largest int64");
+  }
+  return katana::ResultSuccess();
+}
+
+/// The capacity of every edge of the graph, by edge id
+katana::Result<katana::NUMAArray<int64_t>>
+EdgeCapacities(katana::PropertyGraph* pg, const std::string& property_name) {
+  katana::NUMAArray<int64_t> capacities;
+  capacities.allocateBlocked(pg->NumEdges());
+  auto type = KATANA_CHECKED(pg->GetEdgeProperty(property_name))->type();
+  switch (type->id()) {
+  case arrow::UInt32Type::type_id:
+    KATANA_CHECKED(CopyCapacities<uint32_t>(pg, property_name, &capacities));
+    break;
+  case arrow::Int32Type::type_id:
+    KATANA_CHECKED(CopyCapacities<int32_t>(pg, property_name, &capacities));
+    break;
+  case arrow::UInt64Type::type_id:
+    KATANA_CHECKED(CopyCapacities<uint64_t>(pg, property_name, &capacities));
+    break;
+  case arrow::Int64Type::type_id:
+    KATANA_CHECKED(CopyCapacities<int64_t>(pg, property_name, &capacities));
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        type->ToString());
+  }
+  return std::move(capacities);
+}
+
+/// The residual graph: every edge u -> v of the graph, other than self
+/// loops, is an arc from u with its capacity and a reverse arc from v with
+/// none, and pushing flow along an arc moves residual capacity to its
+/// reverse
+struct ResidualGraph {
+  /// The arcs of node n are [offsets[n], offsets[n + 1])
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> dests;
+  katana::NUMAArray<uint64_t> reverse;
+  katana::NUMAArray<int64_t> residual;
+
+  uint32_t NumNodes() const { return offsets.size() - 1; }
+  uint64_t NumArcs() const { return dests.size(); }
+  uint64_t Degree(uint32_t n) const { return offsets[n + 1] - offsets[n]; }
+
+  ResidualGraph(
+      const katana::GraphTopology& topology,
+      const katana::NUMAArray<int64_t>& capacities) {
+    uint32_t num_nodes = topology.NumNodes();
+    katana::NUMAArray<uint64_t> out_degrees;
+    katana::NUMAArray<std::atomic<uint64_t>> cursors;
+    out_degrees.allocateBlocked(num_nodes);
+    cursors.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) { cursors[n].store(0, std::memory_order_relaxed); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          uint64_t degree = 0;
+          for (auto e : topology.OutEdges(n)) {
+            uint32_t dest = topology.OutEdgeDst(e);
+            if (dest != n) {
+              ++degree;
+              cursors[dest].fetch_add(1, std::memory_order_relaxed);
+            }
+          }
+          out_degrees[n] = degree;
+        },
+        katana::steal(), katana::no_stats());
+
+    offsets.allocateBlocked(num_nodes + 1);
+    offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) { offsets[n + 1] = out_degrees[n] + cursors[n]; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets.begin(), offsets.end(), offsets.begin());
+    // the arcs of the edges of a node come first, then the reverse arcs
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) { cursors[n].store(offsets[n] + out_degrees[n]); },
+        katana::no_stats());
+
+    uint64_t num_arcs = offsets[num_nodes];
+    dests.allocateBlocked(num_arcs);
+    reverse.allocateBlocked(num_arcs);
+    residual.allocateBlocked(num_arcs);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          uint64_t arc = offsets[n];
+          for (auto e : topology.OutEdges(n)) {
+            uint32_t dest = topology.OutEdgeDst(e);
+            if (dest == n) {
+              continue;
+            }
+            uint64_t back = cursors[dest].fetch_add(1);
+            dests[arc] = dest;
+            dests[back] = n;
+            reverse[arc] = back;
+            reverse[back] = arc;
+            residual[arc] = capacities[e];
+            residual[back] = 0;
+            ++arc;
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+};
+
+class PushRelabel {
+public:
+  PushRelabel(
+      ResidualGraph* graph, uint32_t source, uint32_t sink,
+      const MaxFlowPlan& plan)
+      : graph_(*graph), source_(source), sink_(sink), plan_(plan) {
+    uint32_t num_nodes = graph_.NumNodes();
+    labels_.allocateBlocked(num_nodes);
+    excess_.allocateBlocked(num_nodes);
+    stamps_.allocateBlocked(num_nodes);
+    label_counts_.allocateBlocked(num_nodes + 1);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          excess_[n].store(0, std::memory_order_relaxed);
+          stamps_[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  /// Run to a maximum preflow and return its value, the flow into the sink
+  int64_t Run() {
+    uint32_t num_nodes = graph_.NumNodes();
+    for (uint64_t a = graph_.offsets[source_]; a < graph_.offsets[source_ + 1];
+         ++a) {
+      int64_t amount = graph_.residual[a];
+      graph_.residual[a] = 0;
+      graph_.residual[graph_.reverse[a]] += amount;
+      excess_[graph_.dests[a]].fetch_add(amount);
+    }
+
+    auto relabel_work = static_cast<uint64_t>(
+        plan_.global_relabel_interval() *
+        (kAlpha * num_nodes + graph_.NumArcs()));
+    std::vector<uint32_t> active = GlobalRelabel();
+    uint64_t work = 0;
+    uint32_t round = 0;
+    while (!active.empty()) {
+      ++round;
+      katana::PerThreadStorage<std::vector<uint32_t>> next;
+      katana::GAccumulator<uint64_t> round_work;
+
+      katana::do_all(
+          katana::iterate(active.begin(), active.end()),
+          [&](uint32_t n) { Push(n, round, &next, &round_work); },
+          katana::steal(), katana::no_stats());
+
+      std::atomic<uint32_t> gap{num_nodes};
+      katana::do_all(
+          katana::iterate(active.begin(), active.end()),
+          [&](uint32_t n) {
+            Relabel(n, &gap, &round_work);
+            if (IsActive(n)) {
+              Activate(n, round, &next);
+            }
+          },
+          katana::steal(), katana::no_stats());
+
+      if (uint32_t g = gap.load(); g < num_nodes && label_counts_[g] == 0) {
+        RemoveGap(g);
+      }
+
+      work += round_work.reduce();
+      if (work >= relabel_work) {
+        active = GlobalRelabel();
+        work = 0;
+        continue;
+      }
+      active.clear();
+      for (unsigned t = 0; t < next.size(); ++t) {
+        std::vector<uint32_t>& local = *next.getRemote(t);
+        for (uint32_t n : local) {
+          if (IsActive(n)) {
+            active.emplace_back(n);
+          }
+        }
+      }
+    }
+
+    // the nodes that cannot reach the sink are the source side of a
+    // minimum cut
+    GlobalRelabel();
+    return excess_[sink_].load();
+  }
+
+  bool IsSourceSide(uint32_t n) const {
+    return labels_[n].load(std::memory_order_relaxed) >= graph_.NumNodes();
+  }
+
+private:
+  bool IsActive(uint32_t n) const {
+    return n != source_ && n != sink_ &&
+           excess_[n].load(std::memory_order_relaxed) > 0 &&
+           labels_[n].load(std::memory_order_relaxed) < graph_.NumNodes();
+  }
+
+  void Activate(
+      uint32_t n, uint32_t round,
+      katana::PerThreadStorage<std::vector<uint32_t>>* next) {
+    if (stamps_[n].exchange(round, std::memory_order_relaxed) != round) {
+      next->getLocal()->emplace_back(n);
+    }
+  }
+
+  /// Push the excess of n along its arcs to nodes one label lower. Labels
+  /// do not change while pushing, so two nodes never push to each other.
+  void Push(
+      uint32_t n, uint32_t round,
+      katana::PerThreadStorage<std::vector<uint32_t>>* next,
+      katana::GAccumulator<uint64_t>* work) {
+    if (!IsActive(n)) {
+      return;
+    }
+    int64_t excess = excess_[n].load(std::memory_order_relaxed);
+    uint32_t label = labels_[n].load(std::memory_order_relaxed);
+    int64_t pushed = 0;
+    uint64_t a = graph_.offsets[n];
+    for (; a < graph_.offsets[n + 1] && pushed < excess; ++a) {
+      uint32_t dest = graph_.dests[a];
+      // the label first: only then is dest sure not to push along the
+      // reverse arc
+      if (labels_[dest].load(std::memory_order_relaxed) + 1 != label ||
+          graph_.residual[a] == 0) {
+        continue;
+      }
+      int64_t amount = std::min(excess - pushed, graph_.residual[a]);
+      graph_.residual[a] -= amount;
+      graph_.residual[graph_.reverse[a]] += amount;
+      pushed += amount;
+      excess_[dest].fetch_add(amount, std::memory_order_relaxed);
+      if (IsActive(dest)) {
+        Activate(dest, round, next);
+      }
+    }
+    excess_[n].fetch_sub(pushed, std::memory_order_relaxed);
+    *work += a - graph_.offsets[n];
+  }
+
+  /// Relabel n to one more than its lowest residual neighbor if it is
+  /// active and has no residual arc to a node one label lower. A neighbor
+  /// relabeled concurrently is only seen higher, which keeps the labels
+  /// valid.
+  void Relabel(
+      uint32_t n, std::atomic<uint32_t>* gap,
+      katana::GAccumulator<uint64_t>* work) {
+    if (!IsActive(n)) {
+      return;
+    }
+    uint32_t num_nodes = graph_.NumNodes();
+    uint32_t label = labels_[n].load(std::memory_order_relaxed);
+    uint32_t lowest = num_nodes;
+    for (uint64_t a = graph_.offsets[n]; a < graph_.offsets[n + 1]; ++a) {
+      if (graph_.residual[a] > 0) {
+        lowest = std::min(
+            lowest, labels_[graph_.dests[a]].load(std::memory_order_relaxed));
+      }
+    }
+    *work += graph_.Degree(n) + kBeta;
+    uint32_t new_label = std::min(lowest + 1, num_nodes);
+    if (new_label <= label) {
+      return;
+    }
+    labels_[n].store(new_label, std::memory_order_relaxed);
+    label_counts_[new_label].fetch_add(1, std::memory_order_relaxed);
+    if (label_counts_[label].fetch_sub(1, std::memory_order_relaxed) == 1) {
+      uint32_t current = gap->load();
+      while (label < current && !gap->compare_exchange_weak(current, label)) {
+      }
+    }
+  }
+
+  /// No node has label gap, so the nodes above it cannot reach the sink
+  void RemoveGap(uint32_t gap) {
+    uint32_t num_nodes = graph_.NumNodes();
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          uint32_t label = labels_[n].load(std::memory_order_relaxed);
+          if (label > gap && label < num_nodes) {
+            labels_[n].store(num_nodes, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(gap + 1, num_nodes),
+        [&](uint32_t l) { label_counts_[l].store(0); }, katana::no_stats());
+  }
+
+  /// Set every label to the distance to the sink in the residual graph, by
+  /// a breadth first search back from the sink a level at a time, and
+  /// return the active nodes
+  std::vector<uint32_t> GlobalRelabel() {
+    uint32_t num_nodes = graph_.NumNodes();
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          labels_[n].store(n == sink_ ? 0 : num_nodes);
+          label_counts_[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    label_counts_[num_nodes].store(0);
+
+    std::vector<uint32_t> frontier{sink_};
+    for (uint32_t distance = 1; !frontier.empty(); ++distance) {
+      katana::PerThreadStorage<std::vector<uint32_t>> next;
+      katana::do_all(
+          katana::iterate(frontier.begin(), frontier.end()),
+          [&](uint32_t n) {
+            for (uint64_t a = graph_.offsets[n]; a < graph_.offsets[n + 1];
+                 ++a) {
+              uint32_t dest = graph_.dests[a];
+              uint32_t unreached = num_nodes;
+              if (dest != source_ && graph_.residual[graph_.reverse[a]] > 0 &&
+                  labels_[dest].compare_exchange_strong(unreached, distance)) {
+                next.getLocal()->emplace_back(dest);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+      frontier.clear();
+      for (unsigned t = 0; t < next.size(); ++t) {
+        std::vector<uint32_t>& local = *next.getRemote(t);
+        frontier.insert(frontier.end(), local.begin(), local.end());
+      }
+    }
+
+    katana::PerThreadStorage<std::vector<uint32_t>> local_active;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          uint32_t label = labels_[n].load(std::memory_order_relaxed);
+          if (n != source_ && label < num_nodes) {
+            label_counts_[label].fetch_add(1, std::memory_order_relaxed);
+          }
+          if (IsActive(n)) {
+            local_active.getLocal()->emplace_back(n);
+          }
+        },
+        katana::no_stats());
+    std::vector<uint32_t> active;
+    for (unsigned t = 0; t < local_active.size(); ++t) {
+      std::vector<uint32_t>& local = *local_active.getRemote(t);
+      active.insert(active.end(), local.begin(), local.end());
+    }
+    return active;
+  }
+
+  ResidualGraph& graph_;
+  uint32_t source_;
+  uint32_t sink_;
+  MaxFlowPlan plan_;
+  katana::NUMAArray<std::atomic<uint32_t>> labels_;
+  katana::NUMAArray<std::atomic<int64_t>> excess_;
+  /// The last round that each node was made active in
+  katana::NUMAArray<std::atomic<uint32_t>> stamps_;
+  /// The number of nodes other than the source of each label
+  katana::NUMAArray<std::atomic<uint64_t>> label_counts_;
+};
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::MaxFlow(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MaxFlowPlan plan) {
+  if (plan.algorithm() != MaxFlowPlan::kSynchronousPushRelabel) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm: {}",
+        plan.algorithm());
+  }
+  if (source >= pg->NumNodes() || sink >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} or sink {} is not one of the {} nodes of the graph", source,
+        sink, pg->NumNodes());
+  }
+  if (source == sink) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source and sink are both {}",
+        source);
+  }
+
+  katana::NUMAArray<int64_t> capacities =
+      KATANA_CHECKED(EdgeCapacities(pg, edge_capacity_property_name));
+  const katana::GraphTopology& topology = pg->topology();
+  // no excess can be more than the capacity out of the source
+  int64_t out_of_source = 0;
+  for (auto e : topology.OutEdges(source)) {
+    if (topology.OutEdgeDst(e) != source &&
+        __builtin_add_overflow(out_of_source, capacities[e], &out_of_source)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the capacity out of the source is larger than the largest int64");
+    }
+  }
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("MaxFlow");
+  exec_time.start();
+  ResidualGraph residual(topology, capacities);
+  PushRelabel push_relabel(&residual, source, sink, plan);
+  int64_t flow = push_relabel.Run();
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<MinCutSide>(n) = push_relabel.IsSourceSide(n);
+      },
+      katana::no_stats());
+  exec_time.stop();
+  page_alloc.Report();
+
+  return flow;
+}
+
+katana::Result<void>
+katana::analytics::MaxFlowAssertValid(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& edge_capacity_property_name,
+    const std::string& property_name, uint64_t flow) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  if (source >= graph.NumNodes() || sink >= graph.NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} or sink {} is not one of the {} nodes of the graph", source,
+        sink, graph.NumNodes());
+  }
+  if (graph.GetData<MinCutSide>(source) != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the source is not on the source side");
+  }
+  if (graph.GetData<MinCutSide>(sink) != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "the sink is on the source side");
+  }
+
+  MaxFlowStatistics stats = KATANA_CHECKED(MaxFlowStatistics::Compute(
+      pg, edge_capacity_property_name, property_name));
+  if (stats.cut_capacity != flow) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the cut has capacity {} rather than the flow {}", stats.cut_capacity,
+        flow);
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::MaxFlowStatistics::Print(std::ostream& os) const {
+  os << "Capacity of the minimum cut = " << cut_capacity << std::endl;
+  os << "Edges of the minimum cut = " << cut_edges << std::endl;
+  os << "Nodes on the source side = " << source_side_size << std::endl;
+}
+
+katana::Result<katana::analytics::MaxFlowStatistics>
+katana::analytics::MaxFlowStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_capacity_property_name,
+    const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  katana::NUMAArray<int64_t> capacities =
+      KATANA_CHECKED(EdgeCapacities(pg, edge_capacity_property_name));
+
+  katana::GAccumulator<uint64_t> cut_capacity;
+  katana::GAccumulator<uint64_t> cut_edges;
+  katana::GAccumulator<uint64_t> source_side_size;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (!graph.GetData<MinCutSide>(n)) {
+          return;
+        }
+        source_side_size += 1;
+        for (auto e : graph.OutEdges(n)) {
+          if (!graph.GetData<MinCutSide>(graph.OutEdgeDst(e))) {
+            cut_capacity += capacities[e];
+            cut_edges += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return MaxFlowStatistics{
+      cut_capacity.reduce(), cut_edges.reduce(), source_side_size.reduce()};
+}
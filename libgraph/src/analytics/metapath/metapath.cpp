@@ -0,0 +1,290 @@
+#include "katana/analytics/metapath/metapath.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyColumn.h"
+#include "katana/Random.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/AsyncAnalytics.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::PropertyGraphViews::EdgeTypeAwareBiDir::Node;
+
+/// Looks up the atomic type name of a metapath; empty names are any type
+katana::Result<std::optional<katana::EntityTypeID>>
+ResolveType(
+    const katana::EntityTypeManager& manager, const std::string& name,
+    const char* kind) {
+  if (name.empty()) {
+    return std::optional<katana::EntityTypeID>();
+  }
+  if (!manager.HasAtomicType(name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "{} type {} does not exist", kind, name);
+  }
+  return std::optional<katana::EntityTypeID>(manager.GetEntityTypeID(name));
+}
+
+}  // namespace
+
+katana::Result<MetapathTraversal>
+MetapathTraversal::Make(katana::PropertyGraph* pg, const Metapath& metapath) {
+  if (metapath.steps.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "the metapath has no steps");
+  }
+  const katana::EntityTypeManager& node_types = pg->GetNodeTypeManager();
+  const katana::EntityTypeManager& edge_types = pg->GetEdgeTypeManager();
+
+  auto start_type =
+      KATANA_CHECKED(ResolveType(node_types, metapath.start_node_type, "node"));
+  std::vector<Step> steps;
+  for (const MetapathStep& step : metapath.steps) {
+    auto edge_type =
+        KATANA_CHECKED(ResolveType(edge_types, step.edge_type, "edge"));
+    if (!edge_type) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "every step of a metapath needs an edge type");
+    }
+    auto node_type =
+        KATANA_CHECKED(ResolveType(node_types, step.node_type, "node"));
+    steps.emplace_back(Step{
+        step.reverse, true, *edge_type, !node_type.has_value(),
+        node_type.value_or(katana::EntityTypeID{0})});
+  }
+
+  MetapathTraversal traversal(
+      pg, !start_type.has_value(), start_type.value_or(katana::EntityTypeID{0}),
+      std::move(steps));
+  for (Step& step : traversal.steps_) {
+    step.edge_exists = traversal.view_.DoesEdgeTypeExist(step.edge_type);
+  }
+  return traversal;
+}
+
+katana::Result<void>
+MetapathTraversal::CheckSources(const std::vector<uint32_t>& sources) const {
+  for (uint32_t source : sources) {
+    if (source >= view_.NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} does not exist",
+          source);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+bool
+MetapathTraversal::MatchesPosition(uint32_t n, size_t pos) const noexcept {
+  if (pos == 0) {
+    return any_start_type_ || pg_->DoesNodeHaveType(n, start_type_);
+  }
+  const Step& step = steps_[pos - 1];
+  return step.any_node_type || pg_->DoesNodeHaveType(n, step.node_type);
+}
+
+template <typename F>
+void
+MetapathTraversal::ForEachNeighbor(
+    uint32_t n, const Step& step, const F& f) const {
+  if (!step.edge_exists) {
+    return;
+  }
+  if (step.reverse) {
+    for (auto e : view_.InEdges(n, step.edge_type)) {
+      f(view_.InEdgeSrc(e));
+    }
+  } else {
+    for (auto e : view_.OutEdges(n, step.edge_type)) {
+      f(view_.OutEdgeDst(e));
+    }
+  }
+}
+
+katana::Result<void>
+MetapathTraversal::CountInstances(
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  katana::StatTimer exec_time("MetapathCountInstances");
+  exec_time.start();
+
+  // counts[n] is the number of instances of the suffix of the metapath from
+  // position pos starting at n, for pos from the end to the start
+  katana::AllocationAccount account("analytics");
+  katana::NUMAArray<uint64_t> next;
+  next.allocateInterleaved(view_.NumNodes());
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateInterleaved(view_.NumNodes());
+
+  for (size_t pos = steps_.size() + 1; pos-- > 0;) {
+    std::swap(counts, next);
+    katana::do_all(
+        katana::iterate(view_.Nodes()),
+        [&](Node n) {
+          if (!MatchesPosition(n, pos)) {
+            counts[n] = 0;
+            return;
+          }
+          if (pos == steps_.size()) {
+            counts[n] = 1;
+            return;
+          }
+          uint64_t sum = 0;
+          ForEachNeighbor(n, steps_[pos], [&](Node other) {
+            sum += next[other];
+          });
+          counts[n] = sum;
+        },
+        katana::steal(), katana::loopname("MetapathCountInstances"));
+
+    KATANA_CHECKED(CheckProgress(
+        {"MetapathCountInstances", steps_.size() + 1 - pos, 0, 0}));
+  }
+  exec_time.stop();
+
+  auto output = katana::PropertyColumn<uint64_t>::MakeInterleaved(
+      view_.NumNodes());
+  katana::do_all(
+      katana::iterate(view_.Nodes()), [&](Node n) { output[n] = counts[n]; },
+      katana::no_stats());
+  return pg_->AddNodeProperty(
+      output_property_name, std::move(output), txn_ctx);
+}
+
+katana::Result<std::vector<std::vector<std::pair<uint32_t, uint64_t>>>>
+MetapathTraversal::CountEndpoints(const std::vector<uint32_t>& sources) const {
+  KATANA_CHECKED(CheckSources(sources));
+
+  std::vector<std::vector<std::pair<uint32_t, uint64_t>>> endpoints(
+      sources.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, sources.size()),
+      [&](size_t i) {
+        if (!MatchesPosition(sources[i], 0)) {
+          return;
+        }
+        std::unordered_map<Node, uint64_t> frontier{{sources[i], 1}};
+        std::unordered_map<Node, uint64_t> next;
+        for (size_t pos = 0; pos < steps_.size() && !frontier.empty(); ++pos) {
+          next.clear();
+          for (const auto& [n, count] : frontier) {
+            ForEachNeighbor(n, steps_[pos], [&](Node other) {
+              if (MatchesPosition(other, pos + 1)) {
+                next[other] += count;
+              }
+            });
+          }
+          std::swap(frontier, next);
+        }
+        endpoints[i].assign(frontier.begin(), frontier.end());
+        std::sort(endpoints[i].begin(), endpoints[i].end());
+      },
+      katana::steal(), katana::loopname("MetapathCountEndpoints"));
+
+  return endpoints;
+}
+
+katana::Result<std::vector<MetapathTraversal::Instance>>
+MetapathTraversal::Sample(
+    const std::vector<uint32_t>& sources, uint32_t walks_per_source,
+    uint64_t seed) const {
+  KATANA_CHECKED(CheckSources(sources));
+
+  const size_t num_walks = sources.size() * size_t{walks_per_source};
+  std::vector<Instance> walks(num_walks);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_walks),
+      [&](size_t w) {
+        Node n = sources[w / walks_per_source];
+        if (!MatchesPosition(n, 0)) {
+          return;
+        }
+        // the numbers of each walk are its own stream
+        uint64_t walk_seed = katana::StatelessRandom(seed, w);
+        uint64_t drawn = 0;
+        Instance walk{n};
+        for (size_t pos = 0; pos < steps_.size(); ++pos) {
+          // reservoir sampling of one of the edges reaching the right type
+          uint64_t seen = 0;
+          Node picked = 0;
+          ForEachNeighbor(walk.back(), steps_[pos], [&](Node other) {
+            if (!MatchesPosition(other, pos + 1)) {
+              return;
+            }
+            ++seen;
+            if (katana::StatelessRandom(walk_seed, drawn++) % seen == 0) {
+              picked = other;
+            }
+          });
+          if (seen == 0) {
+            return;
+          }
+          walk.emplace_back(picked);
+        }
+        walks[w] = std::move(walk);
+      },
+      katana::steal(), katana::loopname("MetapathSample"));
+
+  walks.erase(
+      std::remove_if(
+          walks.begin(), walks.end(),
+          [](const Instance& walk) { return walk.empty(); }),
+      walks.end());
+  return walks;
+}
+
+katana::Result<std::vector<MetapathTraversal::Instance>>
+MetapathTraversal::Materialize(
+    const std::vector<uint32_t>& sources,
+    uint64_t max_instances_per_source) const {
+  KATANA_CHECKED(CheckSources(sources));
+
+  std::vector<std::vector<Instance>> per_source(sources.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, sources.size()),
+      [&](size_t i) {
+        if (!MatchesPosition(sources[i], 0)) {
+          return;
+        }
+        std::vector<Instance>& instances = per_source[i];
+        Instance path{sources[i]};
+        // depth first, stopping once enough instances are found
+        auto extend = [&](auto& self) -> void {
+          const size_t pos = path.size() - 1;
+          if (pos == steps_.size()) {
+            if (instances.size() < max_instances_per_source) {
+              instances.emplace_back(path);
+            }
+            return;
+          }
+          ForEachNeighbor(path.back(), steps_[pos], [&](Node other) {
+            if (instances.size() >= max_instances_per_source ||
+                !MatchesPosition(other, pos + 1)) {
+              return;
+            }
+            path.emplace_back(other);
+            self(self);
+            path.pop_back();
+          });
+        };
+        extend(extend);
+      },
+      katana::steal(), katana::loopname("MetapathMaterialize"));
+
+  std::vector<Instance> instances;
+  for (auto& source_instances : per_source) {
+    std::move(
+        source_instances.begin(), source_instances.end(),
+        std::back_inserter(instances));
+  }
+  return instances;
+}
@@ -0,0 +1,489 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicUnionFind.h"
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+template <typename Weight>
+struct EdgeWeight : public katana::PODProperty<Weight> {};
+struct EdgeInForest : public katana::PODProperty<uint8_t> {};
+
+/// best_[c] of a tree c that has not been offered an edge yet
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+
+template <typename Weight>
+struct BoruvkaAlgo {
+  static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
+
+  using Graph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<>,
+      std::tuple<EdgeWeight<Weight>, EdgeInForest>>;
+  using GNode = typename Graph::Node;
+  using Edge = typename Graph::Edge;
+
+  /// An edge still between two trees
+  struct Candidate {
+    GNode src;
+    GNode dst;
+    Edge edge;
+  };
+
+  Graph* graph_;
+  katana::AtomicUnionFind<GNode> trees_;
+  /// The lightest edge offered to every tree in the current round
+  katana::NUMAArray<std::atomic<uint64_t>> best_;
+  /// The trees offered an edge in the current round
+  katana::InsertBag<GNode> offered_;
+
+  explicit BoruvkaAlgo(Graph* graph) : graph_(graph) {}
+
+  Weight weight(Edge e) const {
+    return graph_->template GetEdgeData<EdgeWeight<Weight>>(e);
+  }
+
+  /// The total order of the edges: by weight, then by id. Every tree picks
+  /// its least edge in this order, so the edges picked in a round can not
+  /// close a cycle.
+  bool Lighter(Edge a, Edge b) const {
+    Weight a_weight = weight(a);
+    Weight b_weight = weight(b);
+    return a_weight < b_weight || (a_weight == b_weight && a < b);
+  }
+
+  void Offer(GNode tree, Edge e) {
+    uint64_t current = best_[tree].load(std::memory_order_relaxed);
+    while (current == kNoEdge || Lighter(e, current)) {
+      if (best_[tree].compare_exchange_weak(
+              current, e, std::memory_order_relaxed)) {
+        if (current == kNoEdge) {
+          offered_.push(tree);
+        }
+        return;
+      }
+    }
+  }
+
+  /// Offers e to the trees of both its ends, if they differ. Returns
+  /// whether they do.
+  bool Visit(GNode src, GNode dst, Edge e) {
+    GNode src_tree = trees_.Find(src);
+    GNode dst_tree = trees_.Find(dst);
+    if (src_tree == dst_tree) {
+      return false;
+    }
+    Offer(src_tree, e);
+    Offer(dst_tree, e);
+    return true;
+  }
+
+  /// Merges every offered tree along its lightest edge, which joins the
+  /// forest unless the tree at its other end merged along it first
+  void Hook() {
+    katana::do_all(
+        katana::iterate(offered_),
+        [&](GNode tree) {
+          Edge e = best_[tree].load(std::memory_order_relaxed);
+          best_[tree].store(kNoEdge, std::memory_order_relaxed);
+          if (trees_.Union(graph_->GetEdgeSrc(e), graph_->OutEdgeDst(e))) {
+            graph_->template GetEdgeData<EdgeInForest>(e) = 1;
+          }
+        },
+        katana::steal(), katana::loopname("MinimumSpanningForest_Hook"));
+    offered_.clear();
+  }
+
+  katana::Result<void> operator()() {
+    size_t num_nodes = graph_->NumNodes();
+    trees_.Reset(num_nodes);
+    best_.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) { best_[n].store(kNoEdge, std::memory_order_relaxed); },
+        katana::no_stats());
+
+    // The first round offers every edge straight from the graph and the
+    // second keeps the edges still between trees, which later rounds filter
+    // further
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) {
+          for (auto e : graph_->OutEdges(n)) {
+            graph_->template GetEdgeData<EdgeInForest>(e) = 0;
+            Visit(n, graph_->OutEdgeDst(e), e);
+          }
+        },
+        katana::steal(), katana::loopname("MinimumSpanningForest_Find"));
+    size_t rounds = 1;
+    Hook();
+
+    auto current = std::make_unique<katana::InsertBag<Candidate>>();
+    auto next = std::make_unique<katana::InsertBag<Candidate>>();
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) {
+          for (auto e : graph_->OutEdges(n)) {
+            GNode dst = graph_->OutEdgeDst(e);
+            if (Visit(n, dst, e)) {
+              next->push(Candidate{n, dst, e});
+            }
+          }
+        },
+        katana::steal(), katana::loopname("MinimumSpanningForest_Find"));
+
+    while (!next->empty()) {
+      rounds += 1;
+      Hook();
+      std::swap(current, next);
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const Candidate& c) {
+            if (Visit(c.src, c.dst, c.edge)) {
+              next->push(c);
+            }
+          },
+          katana::steal(), katana::loopname("MinimumSpanningForest_Find"));
+      current->clear();
+    }
+
+    katana::ReportStatSingle("MinimumSpanningForest", "Rounds", rounds);
+    return katana::ResultSuccess();
+  }
+};
+
+/// NaN weights are not ordered, so no forest is minimum with them
+template <typename Weight>
+katana::Result<void>
+CheckNoNaN(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  using Graph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<>,
+      std::tuple<EdgeWeight<Weight>>>;
+  auto graph =
+      KATANA_CHECKED(Graph::Make(pg, {}, {edge_weight_property_name}));
+
+  katana::GReduceLogicalOr has_nan;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](typename Graph::Node n) {
+        for (auto e : graph.OutEdges(n)) {
+          if (std::isnan(graph.template GetEdgeData<EdgeWeight<Weight>>(e))) {
+            has_nan.update(true);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (has_nan.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge weights {} contain NaN",
+        edge_weight_property_name);
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  using Algo = BoruvkaAlgo<Weight>;
+  if constexpr (std::is_floating_point_v<Weight>) {
+    KATANA_CHECKED(CheckNoNaN<Weight>(pg, edge_weight_property_name));
+  }
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<EdgeInForest>>(
+      txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Algo::Graph::Make(
+      pg, {}, {edge_weight_property_name, output_property_name}));
+
+  katana::StatTimer exec_time("MinimumSpanningForest");
+  exec_time.start();
+  Algo algo(&graph);
+  KATANA_CHECKED(algo());
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+/// The weight and the number of edges of the forest marked in property_name,
+/// with integral weights summed modulo 2^64 so that sums compare exactly
+template <typename Weight>
+struct ForestSum {
+  using Sum = std::conditional_t<std::is_integral_v<Weight>, uint64_t, double>;
+
+  Sum weight{};
+  uint64_t num_edges{};
+
+  bool operator==(const ForestSum& other) const {
+    if constexpr (std::is_integral_v<Weight>) {
+      return weight == other.weight && num_edges == other.num_edges;
+    } else {
+      double scale = std::max({std::abs(weight), std::abs(other.weight), 1.0});
+      return std::abs(weight - other.weight) <= 1e-9 * scale &&
+             num_edges == other.num_edges;
+    }
+  }
+};
+
+template <typename Weight>
+katana::Result<ForestSum<Weight>>
+SumForest(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  using Graph = typename BoruvkaAlgo<Weight>::Graph;
+  using GNode = typename Graph::Node;
+  using Sum = typename ForestSum<Weight>::Sum;
+  auto graph = KATANA_CHECKED(
+      Graph::Make(pg, {}, {edge_weight_property_name, property_name}));
+
+  katana::GAccumulator<Sum> weight;
+  katana::GAccumulator<uint64_t> num_edges;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.OutEdges(n)) {
+          if (graph.template GetEdgeData<EdgeInForest>(e)) {
+            weight += static_cast<Sum>(
+                graph.template GetEdgeData<EdgeWeight<Weight>>(e));
+            num_edges += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return ForestSum<Weight>{weight.reduce(), num_edges.reduce()};
+}
+
+template <typename Weight>
+katana::Result<void>
+AssertValidWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  using Graph = typename BoruvkaAlgo<Weight>::Graph;
+  using GNode = typename Graph::Node;
+  using Edge = typename Graph::Edge;
+  using Sum = typename ForestSum<Weight>::Sum;
+  auto graph = KATANA_CHECKED(
+      Graph::Make(pg, {}, {edge_weight_property_name, property_name}));
+  size_t num_nodes = graph.NumNodes();
+
+  // a union of the ends of a tree edge fails exactly when it closes a cycle
+  katana::AtomicUnionFind<GNode> forest(num_nodes);
+  katana::GAccumulator<uint64_t> cycles;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.OutEdges(n)) {
+          if (graph.template GetEdgeData<EdgeInForest>(e) &&
+              !forest.Union(n, graph.OutEdgeDst(e))) {
+            cycles += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (uint64_t count = cycles.reduce(); count > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} edges of the forest close a cycle", count);
+  }
+
+  katana::GAccumulator<uint64_t> between;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.OutEdges(n)) {
+          if (!forest.SameSet(n, graph.OutEdgeDst(e))) {
+            between += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (uint64_t count = between.reduce(); count > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} edges join different trees of the forest", count);
+  }
+
+  // A spanning forest is minimum if it weighs as much as Kruskal's
+  std::vector<Edge> order(graph.NumEdges());
+  katana::do_all(
+      katana::iterate(size_t{0}, order.size()),
+      [&](size_t i) { order[i] = i; }, katana::no_stats());
+  katana::ParallelSTL::sort(order.begin(), order.end(), [&](Edge a, Edge b) {
+    Weight a_weight = graph.template GetEdgeData<EdgeWeight<Weight>>(a);
+    Weight b_weight = graph.template GetEdgeData<EdgeWeight<Weight>>(b);
+    return a_weight < b_weight || (a_weight == b_weight && a < b);
+  });
+  katana::AtomicUnionFind<GNode> kruskal(num_nodes);
+  ForestSum<Weight> expected;
+  for (Edge e : order) {
+    if (kruskal.Union(graph.GetEdgeSrc(e), graph.OutEdgeDst(e))) {
+      expected.weight +=
+          static_cast<Sum>(graph.template GetEdgeData<EdgeWeight<Weight>>(e));
+      expected.num_edges += 1;
+    }
+  }
+
+  auto found = KATANA_CHECKED(
+      SumForest<Weight>(pg, edge_weight_property_name, property_name));
+  if (!(found == expected)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "forest of {} edges weighs {}, but the minimum forest weighs {}",
+        found.num_edges, found.weight, expected.weight);
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<MinimumSpanningForestStatistics>
+StatisticsWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto sum = KATANA_CHECKED(
+      SumForest<Weight>(pg, edge_weight_property_name, property_name));
+  // integral sums are only exact modulo 2^64; report them signed for signed
+  // weights
+  double total_weight = sum.weight;
+  if constexpr (std::is_signed_v<Weight> && std::is_integral_v<Weight>) {
+    total_weight = static_cast<int64_t>(sum.weight);
+  }
+  return MinimumSpanningForestStatistics{
+      total_weight, sum.num_edges, pg->topology().NumNodes() - sum.num_edges};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MinimumSpanningForestPlan plan) {
+  if (plan.algorithm() != MinimumSpanningForestPlan::kBoruvka) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        plan.algorithm());
+  }
+  auto pins = KATANA_CHECKED(PinnedProperties::Make(
+      pg,
+      MinimumSpanningForestPropertyRequirements(edge_weight_property_name)));
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return MinimumSpanningForestWithWrap<uint32_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx);
+  case arrow::Int32Type::type_id:
+    return MinimumSpanningForestWithWrap<int32_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx);
+  case arrow::UInt64Type::type_id:
+    return MinimumSpanningForestWithWrap<uint64_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx);
+  case arrow::Int64Type::type_id:
+    return MinimumSpanningForestWithWrap<int64_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx);
+  case arrow::FloatType::type_id:
+    return MinimumSpanningForestWithWrap<float>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx);
+  case arrow::DoubleType::type_id:
+    return MinimumSpanningForestWithWrap<double>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return AssertValidWithWrap<uint32_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::Int32Type::type_id:
+    return AssertValidWithWrap<int32_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::UInt64Type::type_id:
+    return AssertValidWithWrap<uint64_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::Int64Type::type_id:
+    return AssertValidWithWrap<int64_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::FloatType::type_id:
+    return AssertValidWithWrap<float>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::DoubleType::type_id:
+    return AssertValidWithWrap<double>(
+        pg, edge_weight_property_name, property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+katana::analytics::MinimumSpanningForestStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return StatisticsWithWrap<uint32_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::Int32Type::type_id:
+    return StatisticsWithWrap<int32_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::UInt64Type::type_id:
+    return StatisticsWithWrap<uint64_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::Int64Type::type_id:
+    return StatisticsWithWrap<int64_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::FloatType::type_id:
+    return StatisticsWithWrap<float>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::DoubleType::type_id:
+    return StatisticsWithWrap<double>(
+        pg, edge_weight_property_name, property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+void
+katana::analytics::MinimumSpanningForestStatistics::Print(
+    std::ostream& os) const {
+  os << "Total weight = " << total_weight << std::endl;
+  os << "Number of edges = " << number_of_edges << std::endl;
+  os << "Number of trees = " << number_of_trees << std::endl;
+}
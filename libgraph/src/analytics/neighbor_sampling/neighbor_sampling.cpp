@@ -0,0 +1,634 @@
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <utility>
+#include <vector>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using View = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+using Node = View::Node;
+using Edge = View::Edge;
+using PropertyIndex = katana::GraphTopology::PropertyIndex;
+
+/// A splitmix64 stream. It is cheap enough to seed one for every node of
+/// every hop, which keeps the draws independent of the schedule.
+struct Random {
+  uint64_t seed;
+  uint64_t drawn{0};
+
+  uint64_t Next() { return katana::StatelessRandom(seed, drawn++); }
+
+  /// Uniform in [0, 1)
+  double Uniform() { return (Next() >> 11) * 0x1.0p-53; }
+
+  /// Uniform in [0, n)
+  uint32_t Below(uint32_t n) { return (Next() >> 32) * n >> 32; }
+
+  /// The key of an item of weight w in a weighted sample without
+  /// replacement, after Efraimidis and Spirakis: the items of smallest keys
+  /// are the sample
+  double Key(double w) { return -std::log1p(-Uniform()) / w; }
+};
+
+/// The edges of one relation of the sampler seen from the nodes of a layer:
+/// their in or out edges, of one edge type or of all of them
+struct Adjacency {
+  const View& view;
+  bool out;
+  bool all_types;
+  katana::EntityTypeID edge_type;
+  const katana::NUMAArray<double>* weights;
+
+  auto Edges(Node n) const {
+    if (out) {
+      return all_types ? view.OutEdges(n) : view.OutEdges(n, edge_type);
+    }
+    return all_types ? view.InEdges(n) : view.InEdges(n, edge_type);
+  }
+
+  Node Neighbor(Edge e) const {
+    return out ? view.OutEdgeDst(e) : view.InEdgeSrc(e);
+  }
+
+  PropertyIndex GetPropertyIndex(Edge e) const {
+    return out ? view.GetEdgePropertyIndexFromOutEdge(e)
+               : view.GetEdgePropertyIndexFromInEdge(e);
+  }
+
+  double Weight(Edge e) const {
+    return weights ? (*weights)[GetPropertyIndex(e)] : 1;
+  }
+
+  /// The number of edges of n that DrawEdges draws
+  uint32_t NumDraws(Node n, uint32_t fanout, bool replace) const {
+    uint32_t candidates = 0;
+    if (!weights) {
+      candidates = Edges(n).size();
+    } else {
+      for (Edge e : Edges(n)) {
+        candidates += Weight(e) > 0;
+      }
+    }
+    if (replace) {
+      return candidates > 0 ? fanout : 0;
+    }
+    return std::min(fanout, candidates);
+  }
+};
+
+/// Per thread buffers of DrawEdges
+struct Scratch {
+  std::vector<uint32_t> chosen;
+  std::vector<double> prefix;
+  std::vector<std::pair<double, uint32_t>> keys;
+};
+
+/// Draws fanout edges of n, or all of them if it has fewer and replace is
+/// false, and calls emit with each
+template <typename Emit>
+void
+DrawEdges(
+    const Adjacency& adj, Node n, uint32_t fanout, bool replace, Random* rng,
+    Scratch* scratch, Emit emit) {
+  auto edges = adj.Edges(n);
+  uint32_t degree = edges.size();
+  if (degree == 0 || fanout == 0) {
+    return;
+  }
+  Edge first = *edges.begin();
+
+  if (!adj.weights) {
+    if (replace) {
+      for (uint32_t i = 0; i < fanout; ++i) {
+        emit(first + rng->Below(degree));
+      }
+    } else if (fanout >= degree) {
+      for (Edge e : edges) {
+        emit(e);
+      }
+    } else {
+      // Floyd's algorithm, in time of the fanout rather than the degree
+      std::vector<uint32_t>& chosen = scratch->chosen;
+      chosen.clear();
+      for (uint32_t j = degree - fanout; j < degree; ++j) {
+        uint32_t t = rng->Below(j + 1);
+        if (std::find(chosen.begin(), chosen.end(), t) != chosen.end()) {
+          t = j;
+        }
+        chosen.emplace_back(t);
+      }
+      for (uint32_t i : chosen) {
+        emit(first + i);
+      }
+    }
+    return;
+  }
+
+  if (replace) {
+    std::vector<double>& prefix = scratch->prefix;
+    prefix.clear();
+    double total = 0;
+    for (Edge e : edges) {
+      total += adj.Weight(e);
+      prefix.emplace_back(total);
+    }
+    if (total == 0) {
+      return;
+    }
+    // the last edge of positive weight, in case rounding pushes a draw past
+    // the end
+    uint32_t last =
+        std::lower_bound(prefix.begin(), prefix.end(), total) - prefix.begin();
+    for (uint32_t i = 0; i < fanout; ++i) {
+      uint32_t drawn = std::upper_bound(
+                           prefix.begin(), prefix.end(),
+                           rng->Uniform() * total) -
+                       prefix.begin();
+      emit(first + std::min(drawn, last));
+    }
+    return;
+  }
+
+  std::vector<std::pair<double, uint32_t>>& keys = scratch->keys;
+  keys.clear();
+  for (uint32_t i = 0; i < degree; ++i) {
+    double w = adj.Weight(first + i);
+    if (w > 0) {
+      keys.emplace_back(rng->Key(w), i);
+    }
+  }
+  if (keys.size() > fanout) {
+    std::nth_element(keys.begin(), keys.begin() + fanout, keys.end());
+    keys.resize(fanout);
+  }
+  for (const auto& key : keys) {
+    emit(first + key.second);
+  }
+}
+
+/// Turns the neighbors of the sampled edges of a block into its src nodes
+/// and the indices of its edges among them
+katana::Result<void>
+IndexSrcNodes(const std::vector<Node>& neighbors, SampledBlock* block) {
+  const std::vector<Node>& dst_nodes = block->dst_nodes;
+  std::vector<std::pair<Node, uint32_t>> dst_positions(dst_nodes.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, dst_nodes.size()),
+      [&](size_t i) { dst_positions[i] = {dst_nodes[i], i}; },
+      katana::no_stats());
+  katana::ParallelSTL::sort(dst_positions.begin(), dst_positions.end());
+  auto adjacent = std::adjacent_find(
+      dst_positions.begin(), dst_positions.end(),
+      [](const auto& a, const auto& b) { return a.first == b.first; });
+  if (adjacent != dst_positions.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "seed {} appears more than once",
+        adjacent->first);
+  }
+  auto find_dst = [&](Node n) {
+    return std::lower_bound(
+        dst_positions.begin(), dst_positions.end(), std::make_pair(n, 0U));
+  };
+  auto is_dst = [&](Node n) {
+    auto it = find_dst(n);
+    return it != dst_positions.end() && it->first == n;
+  };
+
+  std::vector<Node> fresh(neighbors);
+  katana::ParallelSTL::sort(fresh.begin(), fresh.end());
+  fresh.erase(std::unique(fresh.begin(), fresh.end()), fresh.end());
+  fresh.erase(std::remove_if(fresh.begin(), fresh.end(), is_dst), fresh.end());
+
+  block->src_nodes.reserve(dst_nodes.size() + fresh.size());
+  block->src_nodes = dst_nodes;
+  block->src_nodes.insert(block->src_nodes.end(), fresh.begin(), fresh.end());
+
+  block->indices.resize(neighbors.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, neighbors.size()),
+      [&](size_t j) {
+        Node n = neighbors[j];
+        auto it = find_dst(n);
+        if (it != dst_positions.end() && it->first == n) {
+          block->indices[j] = it->second;
+        } else {
+          block->indices[j] =
+              dst_nodes.size() +
+              (std::lower_bound(fresh.begin(), fresh.end(), n) - fresh.begin());
+        }
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// Fills the edges of a block from every relation, given which of the edges
+/// of a dst node to keep: keep(r, i, fn) calls fn(e) with the kept edges e of
+/// relation r of dst node i, and count(r, i) tells how many there are
+template <typename Count, typename Keep>
+katana::Result<void>
+FillBlock(
+    const std::vector<Adjacency>& relations, Count count, Keep keep,
+    SampledBlock* block) {
+  size_t num_dst = block->dst_nodes.size();
+  block->offsets.assign(num_dst + 1, 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_dst),
+      [&](size_t i) {
+        uint64_t total = 0;
+        for (size_t r = 0; r < relations.size(); ++r) {
+          total += count(r, i);
+        }
+        block->offsets[i + 1] = total;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      block->offsets.begin(), block->offsets.end(), block->offsets.begin());
+
+  uint64_t num_edges = block->offsets[num_dst];
+  std::vector<Node> neighbors(num_edges);
+  block->edge_ids.resize(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_dst),
+      [&](size_t i) {
+        uint64_t slot = block->offsets[i];
+        for (size_t r = 0; r < relations.size(); ++r) {
+          keep(r, i, [&](Edge e) {
+            neighbors[slot] = relations[r].Neighbor(e);
+            block->edge_ids[slot] = relations[r].GetPropertyIndex(e);
+            ++slot;
+          });
+        }
+        KATANA_LOG_DEBUG_ASSERT(slot == block->offsets[i + 1]);
+      },
+      katana::steal(), katana::loopname("NeighborSampling-Fill"));
+
+  return IndexSrcNodes(neighbors, block);
+}
+
+/// The random stream of relation r at a hop of a batch
+uint64_t
+Stream(uint64_t seed, uint64_t batch, size_t hop, size_t r) {
+  uint64_t batch_stream = katana::StatelessRandom(seed, batch);
+  uint64_t hop_stream = katana::StatelessRandom(batch_stream, hop);
+  return katana::StatelessRandom(hop_stream, r);
+}
+
+/// One hop of node-wise sampling: every dst node draws up to the fanout of
+/// its edges of every relation
+katana::Result<void>
+FanoutHop(
+    const std::vector<Adjacency>& relations,
+    const std::vector<uint32_t>& fanouts, bool replace, uint64_t seed,
+    uint64_t batch, size_t hop, SampledBlock* block) {
+  katana::PerThreadStorage<Scratch> scratch;
+  const std::vector<Node>& dst_nodes = block->dst_nodes;
+  return FillBlock(
+      relations,
+      [&](size_t r, size_t i) {
+        return relations[r].NumDraws(dst_nodes[i], fanouts[r], replace);
+      },
+      [&](size_t r, size_t i, auto emit) {
+        Random rng{katana::StatelessRandom(
+            Stream(seed, batch, hop, r), dst_nodes[i])};
+        DrawEdges(
+            relations[r], dst_nodes[i], fanouts[r], replace, &rng,
+            scratch.getLocal(), emit);
+      },
+      block);
+}
+
+/// Draws the nodes of the next layer of one relation for layer-wise
+/// sampling: up to budget neighbors of the dst nodes, in proportion to the
+/// weight of their edges to them, without replacement. Returns them sorted.
+std::vector<Node>
+DrawLayer(
+    const Adjacency& adj, const std::vector<Node>& dst_nodes, uint32_t budget,
+    uint64_t stream) {
+  katana::PerThreadStorage<std::vector<std::pair<Node, double>>> local;
+  katana::do_all(
+      katana::iterate(dst_nodes.begin(), dst_nodes.end()),
+      [&](Node n) {
+        auto& pairs = *local.getLocal();
+        for (Edge e : adj.Edges(n)) {
+          double w = adj.Weight(e);
+          if (w > 0) {
+            pairs.emplace_back(adj.Neighbor(e), w);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<std::pair<Node, double>> pairs;
+  for (unsigned t = 0; t < local.size(); ++t) {
+    auto& part = *local.getRemote(t);
+    pairs.insert(pairs.end(), part.begin(), part.end());
+  }
+  // sorted by weight too, so that the sums do not depend on the schedule
+  katana::ParallelSTL::sort(pairs.begin(), pairs.end());
+
+  std::vector<std::pair<double, Node>> keys;
+  for (size_t i = 0; i < pairs.size();) {
+    Node n = pairs[i].first;
+    double score = 0;
+    for (; i < pairs.size() && pairs[i].first == n; ++i) {
+      score += pairs[i].second;
+    }
+    Random rng{katana::StatelessRandom(stream, n)};
+    keys.emplace_back(rng.Key(score), n);
+  }
+  if (keys.size() > budget) {
+    std::nth_element(keys.begin(), keys.begin() + budget, keys.end());
+    keys.resize(budget);
+  }
+
+  std::vector<Node> layer;
+  layer.reserve(keys.size());
+  for (const auto& key : keys) {
+    layer.emplace_back(key.second);
+  }
+  std::sort(layer.begin(), layer.end());
+  return layer;
+}
+
+/// One hop of layer-wise sampling: every relation draws up to its fanout of
+/// nodes for the next layer, and all its edges between the layers are kept
+katana::Result<void>
+LayerWiseHop(
+    const std::vector<Adjacency>& relations,
+    const std::vector<uint32_t>& fanouts, uint64_t seed, uint64_t batch,
+    size_t hop, SampledBlock* block) {
+  const std::vector<Node>& dst_nodes = block->dst_nodes;
+  std::vector<std::vector<Node>> layers;
+  for (size_t r = 0; r < relations.size(); ++r) {
+    layers.emplace_back(DrawLayer(
+        relations[r], dst_nodes, fanouts[r], Stream(seed, batch, hop, r)));
+  }
+
+  auto for_each_kept = [&](size_t r, size_t i, auto fn) {
+    const Adjacency& adj = relations[r];
+    for (Edge e : adj.Edges(dst_nodes[i])) {
+      if (adj.Weight(e) > 0 &&
+          std::binary_search(
+              layers[r].begin(), layers[r].end(), adj.Neighbor(e))) {
+        fn(e);
+      }
+    }
+  };
+  return FillBlock(
+      relations,
+      [&](size_t r, size_t i) {
+        uint32_t kept = 0;
+        for_each_kept(r, i, [&](Edge) { ++kept; });
+        return kept;
+      },
+      for_each_kept, block);
+}
+
+/// Copies the given rows of the named properties into a new table, one
+/// column per Take kernel, running the kernels in parallel
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeNodeRows(
+    const katana::PropertyGraph* pg, const std::vector<std::string>& names,
+    const std::vector<Node>& nodes) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (const auto& name : names) {
+    columns.emplace_back(KATANA_CHECKED(pg->GetNodeProperty(name)));
+    fields.emplace_back(arrow::field(name, columns.back()->type()));
+  }
+
+  std::vector<uint64_t> rows(nodes.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, nodes.size()),
+      [&](size_t i) { rows[i] = pg->GetNodePropertyIndex(nodes[i]); },
+      katana::no_stats());
+  // the indices only have to live as long as the kernels, so they are
+  // wrapped rather than copied
+  auto indices = std::make_shared<arrow::UInt64Array>(
+      rows.size(), arrow::Buffer::Wrap(rows.data(), rows.size()));
+  std::vector<arrow::Result<arrow::Datum>> taken(columns.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, columns.size()),
+      [&](size_t i) {
+        taken[i] = arrow::compute::Take(
+            arrow::Datum(columns[i]), arrow::Datum(indices));
+      },
+      katana::steal(), katana::loopname("NeighborSampling-Take"));
+  for (size_t i = 0; i < columns.size(); ++i) {
+    columns[i] = KATANA_CHECKED(std::move(taken[i])).chunked_array();
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, rows.size());
+}
+
+template <typename EdgeWeightType>
+katana::Result<void>
+LoadEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    katana::NUMAArray<double>* weights) {
+  using EdgeWeight = katana::PODProperty<EdgeWeightType>;
+  using WeightGraph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<>,
+      std::tuple<EdgeWeight>>;
+  auto graph =
+      KATANA_CHECKED(WeightGraph::Make(pg, {}, {edge_weight_property_name}));
+
+  weights->allocateBlocked(graph.NumEdges());
+  katana::GAccumulator<uint64_t> invalid;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](typename WeightGraph::Node n) {
+        for (auto e : graph.OutEdges(n)) {
+          double weight = graph.template GetEdgeData<EdgeWeight>(e);
+          if (!(weight >= 0 && std::isfinite(weight))) {
+            invalid += 1;
+          }
+          (*weights)[graph.GetEdgePropertyIndexFromOutEdge(e)] = weight;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (uint64_t count = invalid.reduce(); count > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} edge weights are negative or not finite", count);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<NeighborSampler>
+NeighborSampler::Make(
+    katana::PropertyGraph* pg, NeighborSamplingOptions options,
+    NeighborSamplingPlan plan) {
+  std::vector<Relation> relations;
+  if (options.edge_type_fanouts.empty()) {
+    relations.emplace_back(Relation{true, true, 0, options.fanouts});
+  } else {
+    const katana::EntityTypeManager& manager = pg->GetEdgeTypeManager();
+    for (const auto& type_fanouts : options.edge_type_fanouts) {
+      if (!manager.HasAtomicType(type_fanouts.edge_type)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "edge type {} does not exist",
+            type_fanouts.edge_type);
+      }
+      relations.emplace_back(Relation{
+          false, true, manager.GetEntityTypeID(type_fanouts.edge_type),
+          type_fanouts.fanouts});
+    }
+  }
+  size_t num_hops = relations.front().fanouts.size();
+  if (num_hops == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no fanouts are given");
+  }
+  for (const Relation& relation : relations) {
+    if (relation.fanouts.size() != num_hops) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the edge types have fanouts for different numbers of hops");
+    }
+  }
+  for (const auto& name : options.node_feature_properties) {
+    KATANA_CHECKED(pg->GetNodeProperty(name));
+  }
+
+  std::string weight_name = options.edge_weight_property_name;
+  NeighborSampler sampler(pg, std::move(options), plan, std::move(relations));
+  for (Relation& relation : sampler.relations_) {
+    // a type without edges is not in the index of the view
+    relation.exists = relation.all_types ||
+                      sampler.view_.DoesEdgeTypeExist(relation.edge_type);
+  }
+
+  if (!weight_name.empty()) {
+    katana::NUMAArray<double>* weights = &sampler.weights_;
+    switch (KATANA_CHECKED(pg->GetEdgeProperty(weight_name))->type()->id()) {
+    case arrow::UInt32Type::type_id:
+      KATANA_CHECKED(LoadEdgeWeights<uint32_t>(pg, weight_name, weights));
+      break;
+    case arrow::Int32Type::type_id:
+      KATANA_CHECKED(LoadEdgeWeights<int32_t>(pg, weight_name, weights));
+      break;
+    case arrow::UInt64Type::type_id:
+      KATANA_CHECKED(LoadEdgeWeights<uint64_t>(pg, weight_name, weights));
+      break;
+    case arrow::Int64Type::type_id:
+      KATANA_CHECKED(LoadEdgeWeights<int64_t>(pg, weight_name, weights));
+      break;
+    case arrow::FloatType::type_id:
+      KATANA_CHECKED(LoadEdgeWeights<float>(pg, weight_name, weights));
+      break;
+    case arrow::DoubleType::type_id:
+      KATANA_CHECKED(LoadEdgeWeights<double>(pg, weight_name, weights));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "Unsupported type: {}",
+          KATANA_CHECKED(pg->GetEdgeProperty(weight_name))
+              ->type()
+              ->ToString());
+    }
+  }
+  return sampler;
+}
+
+katana::Result<SampledMiniBatch>
+NeighborSampler::Sample(const std::vector<uint32_t>& seeds) {
+  for (uint32_t seed : seeds) {
+    if (seed >= pg_->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is not a node", seed);
+    }
+  }
+
+  katana::StatTimer exec_time("NeighborSampling");
+  exec_time.start();
+
+  std::vector<Adjacency> relations;
+  for (const Relation& relation : relations_) {
+    if (relation.exists) {
+      relations.emplace_back(Adjacency{
+          view_, options_.sample_out_edges, relation.all_types,
+          relation.edge_type, weights_.empty() ? nullptr : &weights_});
+    }
+  }
+
+  SampledMiniBatch batch;
+  size_t num_hops = relations_.front().fanouts.size();
+  batch.blocks.resize(num_hops);
+  for (size_t hop = 0; hop < num_hops; ++hop) {
+    SampledBlock& block = batch.blocks[hop];
+    block.dst_nodes = hop == 0 ? seeds : batch.blocks[hop - 1].src_nodes;
+    std::vector<uint32_t> fanouts;
+    for (const Relation& relation : relations_) {
+      if (relation.exists) {
+        fanouts.emplace_back(relation.fanouts[hop]);
+      }
+    }
+
+    switch (plan_.algorithm()) {
+    case NeighborSamplingPlan::kFanout:
+      KATANA_CHECKED(FanoutHop(
+          relations, fanouts, options_.with_replacement, options_.seed,
+          num_batches_, hop, &block));
+      break;
+    case NeighborSamplingPlan::kLayerWise:
+      KATANA_CHECKED(LayerWiseHop(
+          relations, fanouts, options_.seed, num_batches_, hop, &block));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "Unknown algorithm");
+    }
+  }
+
+  if (!options_.node_feature_properties.empty()) {
+    batch.node_features = KATANA_CHECKED(TakeNodeRows(
+        pg_, options_.node_feature_properties, batch.input_nodes()));
+  }
+  exec_time.stop();
+
+  ++num_batches_;
+  return batch;
+}
+
+katana::Result<void>
+NeighborSampler::Pipeline(
+    const std::vector<std::vector<uint32_t>>& batches,
+    const std::function<katana::Result<void>(SampledMiniBatch&&)>& train) {
+  if (batches.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  // the runtime's threads sample on the calling thread while the previous
+  // minibatch trains on its own, one minibatch ahead at most
+  SampledMiniBatch current = KATANA_CHECKED(Sample(batches.front()));
+  for (size_t i = 0; i < batches.size(); ++i) {
+    auto step = std::async(
+        std::launch::async, [&train, batch = std::move(current)]() mutable {
+          return train(std::move(batch));
+        });
+    katana::Result<SampledMiniBatch> next = SampledMiniBatch{};
+    if (i + 1 < batches.size()) {
+      next = Sample(batches[i + 1]);
+    }
+    KATANA_CHECKED(step.get());
+    current = KATANA_CHECKED(std::move(next));
+  }
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "katana/HWTopo.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "pagerank-impl.h"
+
+namespace {
+
+using NodeData = std::tuple<NodeValue>;
+using EdgeData = std::tuple<>;
+
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+using GNode = typename Graph::Node;
+
+//! Last level cache size to assume when the hardware does not say
+constexpr size_t kDefaultLLCBytes = 8 << 20;
+//! Fewest destinations per block, so that binning does not spread over too
+//! many bins on machines with small caches
+constexpr size_t kMinBlockNodes = 4096;
+
+//! Destinations per block. Each thread accumulates one block at a time, so
+//! the sums of a block get half of a thread's share of the last level cache
+//! of its socket.
+size_t
+BlockNodes() {
+  katana::MachineTopoInfo topo = katana::getHWTopo().machineTopoInfo;
+  size_t llc_bytes = topo.llcBytes ? topo.llcBytes : kDefaultLLCBytes;
+  size_t num_sockets = std::max(topo.maxSockets, 1U);
+  size_t threads = std::min(katana::getActiveThreads(), topo.maxThreads);
+  size_t threads_per_socket =
+      std::max<size_t>((threads + num_sockets - 1) / num_sockets, 1);
+  return std::max(
+      llc_bytes / 2 / threads_per_socket / sizeof(PRTy), kMinBlockNodes);
+}
+
+//! The sources thread tid of total scatters from: about as many edges as
+//! every other thread, so that binning is balanced on skewed graphs
+std::pair<GNode, GNode>
+SourceRange(const Graph& graph, unsigned tid, unsigned total) {
+  auto first_node_from = [&](size_t edge) {
+    GNode lo = 0;
+    GNode hi = graph.size();
+    while (lo < hi) {
+      GNode mid = lo + (hi - lo) / 2;
+      if (*graph.OutEdges(mid).end() <= edge) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  };
+  size_t num_edges = graph.NumEdges();
+  GNode begin = tid == 0 ? 0 : first_node_from(num_edges * tid / total);
+  GNode end = tid + 1 == total ? graph.size()
+                               : first_node_from(num_edges * (tid + 1) / total);
+  return {begin, end};
+}
+
+//! The contributions one thread scatters, binned by the block of their
+//! destination. The order of the edges, and so of the destinations in each
+//! bin, is the same every iteration, so destinations are only binned once
+//! and later iterations only rewrite contributions.
+struct Bins {
+  std::vector<std::vector<GNode>> destinations;
+  std::vector<std::vector<PRTy>> contributions;
+  std::vector<size_t> cursors;
+};
+
+}  // namespace
+
+katana::Result<void>
+PagerankPropagationBlocking(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::EnsurePreallocated(2, 2 * graph.size() * sizeof(PRTy));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::StatTimer exec_time("PagerankPropagationBlocking");
+  exec_time.start();
+
+  size_t num_nodes = graph.size();
+  size_t block_nodes = BlockNodes();
+  size_t num_blocks = (num_nodes + block_nodes - 1) / block_nodes;
+  unsigned num_threads = katana::getActiveThreads();
+
+  katana::NUMAArray<PRTy> value;
+  katana::NUMAArray<PRTy> sum;
+  value.allocateInterleaved(num_nodes);
+  sum.allocateInterleaved(num_nodes);
+  PRTy init_value = 1.0f / num_nodes;
+  katana::do_all(
+      katana::iterate(graph), [&](const GNode& n) { value[n] = init_value; },
+      katana::no_stats());
+
+  katana::PerThreadStorage<Bins> bins;
+  katana::on_each([&](unsigned tid, unsigned total) {
+    Bins& b = *bins.getLocal();
+    b.destinations.assign(num_blocks, {});
+    b.cursors.assign(num_blocks, 0);
+    auto [begin, end] = SourceRange(graph, tid, total);
+    for (GNode src = begin; src < end; ++src) {
+      for (auto e : graph.OutEdges(src)) {
+        GNode dst = graph.OutEdgeDst(e);
+        b.destinations[dst / block_nodes].emplace_back(dst);
+      }
+    }
+    b.contributions.resize(num_blocks);
+    for (size_t block = 0; block < num_blocks; ++block) {
+      b.contributions[block].resize(b.destinations[block].size());
+    }
+  });
+
+  katana::GAccumulator<float> accum;
+  float base_score = 1.0f - plan.alpha();
+  unsigned int iteration = 0;
+  while (true) {
+    // binning: each source writes its contribution to the bins of its
+    // destinations, a few sequential streams per thread
+    katana::on_each([&](unsigned tid, unsigned total) {
+      Bins& b = *bins.getLocal();
+      std::fill(b.cursors.begin(), b.cursors.end(), 0);
+      auto [begin, end] = SourceRange(graph, tid, total);
+      for (GNode src = begin; src < end; ++src) {
+        auto edges = graph.OutEdges(src);
+        if (edges.empty()) {
+          continue;
+        }
+        PRTy contribution = value[src] / edges.size();
+        for (auto e : edges) {
+          size_t block = graph.OutEdgeDst(e) / block_nodes;
+          b.contributions[block][b.cursors[block]++] = contribution;
+        }
+      }
+    });
+
+    // accumulation: the sums of a block stay in cache while every thread's
+    // bin for it is added in
+    katana::do_all(
+        katana::iterate(size_t{0}, num_blocks),
+        [&](size_t block) {
+          GNode lo = block * block_nodes;
+          GNode hi = std::min(num_nodes, lo + block_nodes);
+          for (GNode n = lo; n < hi; ++n) {
+            sum[n] = 0;
+          }
+          for (unsigned t = 0; t < num_threads; ++t) {
+            const Bins& b = *bins.getRemote(t);
+            const auto& destinations = b.destinations[block];
+            const auto& contributions = b.contributions[block];
+            for (size_t i = 0; i < destinations.size(); ++i) {
+              sum[destinations[i]] += contributions[i];
+            }
+          }
+          for (GNode n = lo; n < hi; ++n) {
+            PRTy new_value = sum[n] * plan.alpha() + base_score;
+            accum += std::fabs(new_value - value[n]);
+            value[n] = new_value;
+          }
+        },
+        katana::steal(), katana::chunk_size<1>(),
+        katana::loopname("PagerankPropagationBlocking"));
+
+    iteration += 1;
+    KATANA_CHECKED(katana::analytics::CheckProgress(
+        {"Pagerank", iteration, 0, accum.reduce()}));
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+
+  katana::ReportStatSingle("PageRank", "Iterations", iteration);
+  katana::ReportStatSingle("PageRank", "Blocks", num_blocks);
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodeValue>(n) = value[n]; },
+      katana::loopname("Extract pagerank"), katana::no_stats());
+
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
@@ -21,12 +21,15 @@
 #define KATANA_LIBGRAPH_ANALYTICS_PAGERANK_PAGERANKIMPL_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/analytics/AsyncAnalytics.h"
 #include "katana/analytics/Utils.h"
 #include "katana/analytics/pagerank/pagerank.h"
 
@@ -35,7 +38,8 @@ using NodeValue = katana::PODProperty<PRTy>;
 
 katana::Result<void> PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx,
+    const katana::analytics::CheckpointOptions& checkpoint = {});
 
 katana::Result<void> PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
@@ -49,4 +53,25 @@ katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
 
+katana::Result<void> PagerankPropagationBlocking(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+
+katana::Result<void> PagerankIncrementalPush(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const std::string& output_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+
+katana::Result<void> PersonalizedPagerankPush(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+
+katana::Result<std::vector<std::vector<std::pair<uint32_t, float>>>>
+PersonalizedPagerankTopKPush(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds, size_t k,
+    katana::analytics::PagerankPlan plan);
+
 #endif
@@ -19,6 +19,7 @@
 
 #include <arrow/type.h>
 
+#include "katana/BalancedRange.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
@@ -45,6 +46,22 @@ using EdgeData = std::tuple<>;
 using Graph = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::Transposed, NodeData, EdgeData>;
 
+//! How many nodes ahead the pull loops prefetch the data of the first
+//! neighbor for.
+constexpr unsigned kPrefetchDistance = 8;
+
+//! Address of the element of \p data for the first neighbor of \p src, to
+//! prefetch ahead of pulling from its neighbors.
+template <typename Array>
+const void*
+FirstNeighborData(const Graph& graph, const Array& data, Graph::Node src) {
+  auto edges = graph.OutEdges(src);
+  if (edges.empty()) {
+    return nullptr;
+  }
+  return &data[graph.OutEdgeDst(*edges.begin())];
+}
+
 //! Initialize nodes for the topological algorithm.
 katana::Result<void>
 InitNodeDataTopological(
@@ -96,10 +113,11 @@ ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
       [&](const GNode& src) { vec.constructAt(src, 0ul); },
       katana::loopname("InitDegVec"));
 
+  // hubs are split across threads, which is fine since dests are atomic
   katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        for (auto nbr : graph.OutEdges(src)) {
+      katana::iterate_balanced(graph),
+      [&](const auto& item) {
+        for (auto nbr : item.edges) {
           auto dest = graph.OutEdgeDst(nbr);
           vec[dest].fetch_add(1ul);
         }
@@ -131,10 +149,11 @@ ComputeOutDeg(const Graph& graph, NodeOutDegreeArray* node_data) {
       [&](const GNode& src) { vec.constructAt(src, 0ul); },
       katana::loopname("InitDegVec"));
 
+  // hubs are split across threads, which is fine since dests are atomic
   katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        for (auto nbr : graph.OutEdges(src)) {
+      katana::iterate_balanced(graph),
+      [&](const auto& item) {
+        for (auto nbr : item.edges) {
           auto dest = graph.OutEdgeDst(nbr);
           vec[dest].fetch_add(1ul);
         }
@@ -209,12 +228,17 @@ ComputePRResidual(
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+        katana::prefetch_distance<kPrefetchDistance>([&](const GNode& src) {
+          return FirstNeighborData(*graph, *delta, src);
+        }),
         katana::loopname("PageRank"));
 
 #if DEBUG
     std::cout << "iteration: " << iterations << "\n";
 #endif
     iterations++;
+    KATANA_CHECKED(katana::analytics::CheckProgress(
+        {"Pagerank", iterations, accum.reduce()}));
     if (iterations >= plan.max_iterations() || !accum.reduce()) {
       break;
     }
@@ -232,7 +256,8 @@ ComputePRResidual(
 katana::Result<void>
 ComputePRTopological(
     Graph* graph, katana::analytics::PagerankPlan plan,
-    PagerankValueAndOutDegreeArray* node_data) {
+    PagerankValueAndOutDegreeArray* node_data,
+    katana::analytics::Checkpointer* checkpointer) {
   katana::StatTimer exec_time("PagerankPullTopological");
   exec_time.start();
 
@@ -240,6 +265,13 @@ ComputePRTopological(
   unsigned int iteration = 0;
   katana::GAccumulator<float> accum;
 
+  std::vector<katana::analytics::CheckpointBuffer> state{
+      {node_data->data(), node_data->size() * sizeof(*node_data->data())}};
+  if (auto restored = KATANA_CHECKED(checkpointer->Restore(state))) {
+    iteration = *restored;
+    katana::ReportStatSingle("PageRank", "RestoredIteration", iteration);
+  }
+
   float base_score = (1.0f - plan.alpha());
   while (true) {
     katana::do_all(
@@ -268,19 +300,26 @@ ComputePRTopological(
         },
         katana::steal(),
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+        katana::prefetch_distance<kPrefetchDistance>([&](const GNode& src) {
+          return FirstNeighborData(*graph, *node_data, src);
+        }),
         katana::loopname("Pagerank Topological"));
 
 #if DEBUG
     std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
 #endif
     iteration += 1;
+    KATANA_CHECKED(katana::analytics::CheckProgress(
+        {"Pagerank", iteration, 0, accum.reduce()}));
     if (accum.reduce() <= plan.tolerance() ||
         iteration >= plan.max_iterations()) {
       break;
     }
     accum.reset();
+    KATANA_CHECKED(checkpointer->Save(iteration, state));
 
   }  ///< End while(true).
+  KATANA_CHECKED(checkpointer->Finish());
 
   katana::ReportStatSingle("PageRank", "Iterations", iteration);
 
@@ -301,7 +340,8 @@ ComputePRTopological(
 katana::Result<void>
 PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx,
+    const katana::analytics::CheckpointOptions& checkpoint) {
   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeValue>>(
       txn_ctx, {output_property_name}));
 
@@ -317,7 +357,12 @@ PagerankPullTopological(
   KATANA_CHECKED(InitNodeDataTopological(graph, &node_data));
   KATANA_CHECKED(ComputeOutDeg(graph, &node_data));
 
-  return ComputePRTopological(&graph, plan, &node_data);
+  katana::analytics::Checkpointer checkpointer(
+      checkpoint,
+      fmt::format(
+          "PagerankPullTopological tolerance={} alpha={} nodes={} edges={}",
+          plan.tolerance(), plan.alpha(), pg->NumNodes(), pg->NumEdges()));
+  return ComputePRTopological(&graph, plan, &node_data, &checkpointer);
 }
 
 katana::Result<void>
@@ -17,10 +17,19 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
+#include "katana/gstl.h"
 #include "pagerank-impl.h"
 
 using katana::atomicAdd;
@@ -38,6 +47,9 @@ using Graph = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::Default, NodeData, EdgeData>;
 using GNode = typename Graph::Node;
 
+using TopologyView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, std::tuple<>, std::tuple<>>;
+
 void
 InitializeNodeResidual(
     Graph* graph, const katana::analytics::PagerankPlan& plan) {
@@ -50,51 +62,55 @@ InitializeNodeResidual(
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
-}  // namespace
-
-katana::Result<void>
-PagerankPushAsynchronous(
-    katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
-  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
-  katana::ReportPageAllocGuard page_alloc;
-
-  katana::analytics::TemporaryPropertyGuard temporary_property{
-      pg->NodeMutablePropertyView()};
-
-  if (auto result = pg->ConstructNodeProperties<NodeData>(
-          txn_ctx, {output_property_name, temporary_property.name()});
-      !result) {
-    return result.error();
+/// Residuals for personalized PageRank: the initial residual of all nodes
+/// is split among the seeds, and all other nodes start out with none
+void
+InitializeSeedResidual(
+    Graph* graph, const std::vector<GNode>& seeds,
+    const katana::analytics::PagerankPlan& plan) {
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<NodeResidual>(n) = 0;
+        graph->GetData<NodeValue>(n) = 0;
+      },
+      katana::no_stats(), katana::loopname("Initialize"));
+  for (GNode seed : seeds) {
+    graph->GetData<NodeResidual>(seed) +=
+        plan.initial_residual() / seeds.size();
   }
+}
 
-  Graph graph = KATANA_CHECKED(
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
-
-  InitializeNodeResidual(&graph, plan);
-
+/// Pushes residuals until none is above the tolerance in magnitude,
+/// starting from the nodes of initial. Residuals are negative only when an
+/// incremental run takes back rank that an earlier run pushed.
+template <typename Range>
+void
+PushResidualAsynchronous(
+    Graph* graph, const katana::analytics::PagerankPlan& plan,
+    const Range& initial) {
   typedef katana::PerSocketChunkFIFO<
       katana::analytics::PagerankPlan::kChunkSize>
       WL;
   katana::for_each(
-      katana::iterate(graph),
+      katana::iterate(initial),
       [&](const GNode& src, auto& ctx) {
-        auto& src_residual = graph.GetData<NodeResidual>(src);
-        if (src_residual > plan.tolerance()) {
+        auto& src_residual = graph->GetData<NodeResidual>(src);
+        if (std::fabs(src_residual) > plan.tolerance()) {
           PRTy old_residual = src_residual.exchange(0.0);
-          auto& src_value = graph.GetData<NodeValue>(src);
+          auto& src_value = graph->GetData<NodeValue>(src);
           src_value += old_residual;
-          int src_nout = graph.OutDegree(src);
+          int src_nout = graph->OutDegree(src);
           if (src_nout > 0) {
             PRTy delta = old_residual * plan.alpha() / src_nout;
             //! For each out-going neighbors.
-            for (const auto& jj : graph.OutEdges(src)) {
-              auto dest = graph.OutEdgeDst(jj);
-              auto& dest_residual = graph.GetData<NodeResidual>(dest);
-              if (delta > 0) {
+            for (const auto& jj : graph->OutEdges(src)) {
+              auto dest = graph->OutEdgeDst(jj);
+              auto& dest_residual = graph->GetData<NodeResidual>(dest);
+              if (delta != 0) {
                 auto old = atomicAdd(dest_residual, delta);
-                if ((old < plan.tolerance()) &&
-                    (old + delta >= plan.tolerance())) {
+                if ((std::fabs(old) < plan.tolerance()) &&
+                    (std::fabs(old + delta) >= plan.tolerance())) {
                   ctx.push(dest);
                 }
               }
@@ -104,31 +120,14 @@ PagerankPushAsynchronous(
       },
       katana::loopname("PushResidualAsynchronous"),
       katana::disable_conflict_detection(), katana::wl<WL>());
-
-  return katana::ResultSuccess();
 }
 
+/// Pushes residuals in rounds until none is above the tolerance or
+/// max_iterations rounds have run, starting from the nodes of active_nodes
 katana::Result<void>
-PagerankPushSynchronous(
-    katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
-  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
-  katana::ReportPageAllocGuard page_alloc;
-
-  katana::analytics::TemporaryPropertyGuard temporary_property{
-      pg->NodeMutablePropertyView()};
-
-  if (auto result = pg->ConstructNodeProperties<NodeData>(
-          txn_ctx, {output_property_name, temporary_property.name()});
-      !result) {
-    return result.error();
-  }
-
-  Graph graph = KATANA_CHECKED(
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
-
-  InitializeNodeResidual(&graph, plan);
-
+PushResidualSynchronous(
+    Graph* graph, const katana::analytics::PagerankPlan& plan,
+    katana::InsertBag<GNode>* active_nodes) {
   struct Update {
     PRTy delta;
     Graph::edge_iterator beg;
@@ -138,29 +137,26 @@ PagerankPushSynchronous(
   constexpr ptrdiff_t kEdgeTileSize = 128;
 
   katana::InsertBag<Update> updates;
-  katana::InsertBag<GNode> active_nodes;
-
-  katana::do_all(
-      katana::iterate(graph), [&](const auto& src) { active_nodes.push(src); },
-      katana::no_stats());
 
   size_t iter = 0;
-  for (; !active_nodes.empty() && iter < plan.max_iterations(); ++iter) {
+  for (; !active_nodes->empty() && iter < plan.max_iterations(); ++iter) {
+    KATANA_CHECKED(katana::analytics::CheckProgress(
+        {"Pagerank", iter, active_nodes->size()}));
     katana::do_all(
-        katana::iterate(active_nodes),
+        katana::iterate(*active_nodes),
         [&](const GNode& src) {
-          auto& sdata_residual = graph.GetData<NodeResidual>(src);
+          auto& sdata_residual = graph->GetData<NodeResidual>(src);
 
           if (sdata_residual > plan.tolerance()) {
             PRTy old_residual = sdata_residual;
-            graph.GetData<NodeValue>(src) += old_residual;
+            graph->GetData<NodeValue>(src) += old_residual;
             sdata_residual = 0.0;
 
-            int src_nout = graph.OutEdges(src).size();
+            int src_nout = graph->OutEdges(src).size();
             PRTy delta = old_residual * plan.alpha() / src_nout;
 
-            auto beg = graph.OutEdges(src).begin();
-            const auto end = graph.OutEdges(src).end();
+            auto beg = graph->OutEdges(src).begin();
+            const auto end = graph->OutEdges(src).end();
 
             KATANA_LOG_ASSERT(beg <= end);
 
@@ -182,22 +178,22 @@ PagerankPushSynchronous(
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
         katana::loopname("CreateEdgeTiles"), katana::no_stats());
 
-    active_nodes.clear();
+    active_nodes->clear();
 
     katana::do_all(
         katana::iterate(updates),
         [&](const Update& up) {
           //! For each out-going neighbors.
           for (auto jj = up.beg; jj != up.end; ++jj) {
-            auto dest = graph.OutEdgeDst(*jj);
-            auto& ddata_residual = graph.GetData<NodeResidual>(dest);
+            auto dest = graph->OutEdgeDst(*jj);
+            auto& ddata_residual = graph->GetData<NodeResidual>(dest);
             auto old = atomicAdd(ddata_residual, up.delta);
             //! If fabs(old) is greater than tolerance, then it would
             //! already have been processed in the previous do_all
             //! loop.
             if ((old <= plan.tolerance()) &&
                 (old + up.delta >= plan.tolerance())) {
-              active_nodes.push(dest);
+              active_nodes->push(dest);
             }
           }
         },
@@ -209,3 +205,284 @@ PagerankPushSynchronous(
   }
   return katana::ResultSuccess();
 }
+
+/// The residuals and ranks of one seed of a batched personalized PageRank,
+/// kept sparse since a push from a single seed touches few nodes. Each
+/// thread reuses one for all the seeds it processes.
+struct SparsePush {
+  katana::gstl::UnorderedMap<GNode, PRTy> residual;
+  katana::gstl::UnorderedMap<GNode, PRTy> value;
+  katana::gstl::Vector<GNode> queue;
+  size_t num_pushes{0};
+
+  /// Runs the push of PushResidualAsynchronous serially from seed alone and
+  /// returns the k nodes of highest rank
+  std::vector<std::pair<uint32_t, float>> Run(
+      const TopologyView& graph, GNode seed, size_t k,
+      const katana::analytics::PagerankPlan& plan) {
+    residual.clear();
+    value.clear();
+    queue.clear();
+
+    residual[seed] = plan.initial_residual();
+    queue.push_back(seed);
+    for (size_t head = 0; head < queue.size(); ++head) {
+      GNode src = queue[head];
+      PRTy& src_residual = residual[src];
+      if (src_residual <= plan.tolerance()) {
+        continue;
+      }
+      PRTy old_residual = src_residual;
+      src_residual = 0;
+      value[src] += old_residual;
+      ++num_pushes;
+      int src_nout = graph.OutDegree(src);
+      if (src_nout == 0) {
+        continue;
+      }
+      PRTy delta = old_residual * plan.alpha() / src_nout;
+      for (const auto& jj : graph.OutEdges(src)) {
+        auto dest = graph.OutEdgeDst(jj);
+        PRTy& dest_residual = residual[dest];
+        PRTy old = dest_residual;
+        dest_residual += delta;
+        if ((old <= plan.tolerance()) && (dest_residual > plan.tolerance())) {
+          queue.push_back(dest);
+        }
+      }
+    }
+
+    std::vector<std::pair<uint32_t, float>> top(value.begin(), value.end());
+    auto higher = [](const auto& a, const auto& b) {
+      return a.second > b.second || (a.second == b.second && a.first < b.first);
+    };
+    size_t num_top = std::min(k, top.size());
+    std::partial_sort(top.begin(), top.begin() + num_top, top.end(), higher);
+    top.resize(num_top);
+    return top;
+  }
+};
+
+}  // namespace
+
+katana::Result<void>
+PagerankPushAsynchronous(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  if (auto result = pg->ConstructNodeProperties<NodeData>(
+          txn_ctx, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  Graph graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+
+  InitializeNodeResidual(&graph, plan);
+  PushResidualAsynchronous(&graph, plan, graph);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+PagerankPushSynchronous(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  if (auto result = pg->ConstructNodeProperties<NodeData>(
+          txn_ctx, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  Graph graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+
+  InitializeNodeResidual(&graph, plan);
+
+  katana::InsertBag<GNode> active_nodes;
+  katana::do_all(
+      katana::iterate(graph), [&](const auto& src) { active_nodes.push(src); },
+      katana::no_stats());
+  return PushResidualSynchronous(&graph, plan, &active_nodes);
+}
+
+katana::Result<void>
+PersonalizedPagerankPush(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  if (auto result = pg->ConstructNodeProperties<NodeData>(
+          txn_ctx, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  Graph graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+
+  std::vector<GNode> seed_nodes(seeds.begin(), seeds.end());
+  InitializeSeedResidual(&graph, seed_nodes, plan);
+
+  if (plan.algorithm() == katana::analytics::PagerankPlan::kPushSynchronous) {
+    katana::InsertBag<GNode> active_nodes;
+    for (GNode seed : seed_nodes) {
+      active_nodes.push(seed);
+    }
+    KATANA_CHECKED(PushResidualSynchronous(&graph, plan, &active_nodes));
+  } else {
+    PushResidualAsynchronous(&graph, plan, seed_nodes);
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<std::vector<std::pair<uint32_t, float>>>>
+PersonalizedPagerankTopKPush(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds, size_t k,
+    katana::analytics::PagerankPlan plan) {
+  TopologyView graph = KATANA_CHECKED(TopologyView::Make(pg, {}, {}));
+
+  std::vector<std::vector<std::pair<uint32_t, float>>> top(seeds.size());
+  katana::PerThreadStorage<SparsePush> pushes;
+  katana::do_all(
+      katana::iterate(size_t{0}, seeds.size()),
+      [&](size_t i) {
+        top[i] = pushes.getLocal()->Run(graph, seeds[i], k, plan);
+      },
+      katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("PersonalizedPagerankTopK"));
+
+  katana::GAccumulator<size_t> num_pushes;
+  katana::on_each([&](unsigned, unsigned) {
+    num_pushes += pushes.getLocal()->num_pushes;
+  });
+  katana::ReportStatSingle(
+      "PersonalizedPagerankTopK", "Pushes", num_pushes.reduce());
+
+  return top;
+}
+
+katana::Result<void>
+PagerankIncrementalPush(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const std::string& output_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  using PreviousGraph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<NodeValue>,
+      std::tuple<>>;
+  using Edge = std::pair<uint32_t, uint32_t>;
+
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  PreviousGraph previous =
+      KATANA_CHECKED(PreviousGraph::Make(pg, {previous_property_name}, {}));
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  if (auto result = pg->ConstructNodeProperties<NodeData>(
+          txn_ctx, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  Graph graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+
+  // the previous ranks had converged, so they leave no residual behind
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeValue>(n) = previous.GetData<NodeValue>(n);
+        graph.GetData<NodeResidual>(n) = 0;
+      },
+      katana::no_stats(), katana::loopname("Initialize"));
+
+  // the changed edges grouped by source
+  std::vector<Edge> inserted(inserted_edges);
+  std::vector<Edge> deleted(deleted_edges);
+  std::sort(inserted.begin(), inserted.end());
+  std::sort(deleted.begin(), deleted.end());
+  std::vector<GNode> sources;
+  for (const auto* edges : {&inserted, &deleted}) {
+    for (const Edge& edge : *edges) {
+      sources.emplace_back(edge.first);
+    }
+  }
+  std::sort(sources.begin(), sources.end());
+  sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+  auto edges_of = [](const std::vector<Edge>& edges, GNode src) {
+    auto less = [](const Edge& a, const Edge& b) { return a.first < b.first; };
+    return std::equal_range(edges.begin(), edges.end(), Edge{src, 0}, less);
+  };
+
+  // A changed source u of rank x passed alpha * x / old_degree to each of
+  // its old out neighbors and should pass alpha * x / new_degree to each of
+  // its new ones; the difference becomes residual at those neighbors.
+  katana::InsertBag<GNode> touched;
+  katana::GReduceLogicalOr inconsistent;
+  katana::do_all(
+      katana::iterate(sources),
+      [&](GNode src) {
+        auto [ins_begin, ins_end] = edges_of(inserted, src);
+        auto [del_begin, del_end] = edges_of(deleted, src);
+        int64_t new_degree = graph.OutDegree(src);
+        int64_t old_degree =
+            new_degree - (ins_end - ins_begin) + (del_end - del_begin);
+        if (old_degree < 0) {
+          inconsistent.update(true);
+          return;
+        }
+        PRTy share = plan.alpha() * graph.GetData<NodeValue>(src);
+        PRTy old_share = old_degree > 0 ? share / old_degree : 0;
+        PRTy new_share = new_degree > 0 ? share / new_degree : 0;
+        auto add = [&](GNode dest, PRTy delta) {
+          atomicAdd(graph.GetData<NodeResidual>(dest), delta);
+          touched.push(dest);
+        };
+        // charge every current edge as if it was there before and then
+        // correct for the inserted ones
+        for (const auto& jj : graph.OutEdges(src)) {
+          add(graph.OutEdgeDst(jj), new_share - old_share);
+        }
+        for (auto it = ins_begin; it != ins_end; ++it) {
+          add(it->second, old_share);
+        }
+        for (auto it = del_begin; it != del_end; ++it) {
+          add(it->second, -old_share);
+        }
+      },
+      katana::steal(), katana::loopname("InjectResidual"));
+
+  if (inconsistent.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the edge changes do not match the out degrees of the graph");
+  }
+
+  PushResidualAsynchronous(&graph, plan, touched);
+
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,122 @@
+#include <atomic>
+#include <cmath>
+
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyColumn.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TemporalView.h"
+#include "pagerank-impl.h"
+
+namespace {
+
+using GNode = katana::TemporalView::Node;
+
+constexpr unsigned kChunkSize = katana::analytics::PagerankPlan::kChunkSize;
+
+struct WindowNodeData {
+  PRTy value;
+  uint32_t out;
+};
+
+/// The topological pull algorithm of PagerankPullTopological, run on the
+/// edges of a window of the transposed graph; out degrees count only the
+/// edges in the window.
+katana::Result<void>
+ComputePRWindowed(
+    const katana::TemporalView& window, katana::analytics::PagerankPlan plan,
+    katana::NUMAArray<WindowNodeData>* node_data) {
+  unsigned int iteration = 0;
+  katana::GAccumulator<float> accum;
+
+  float base_score = (1.0f - plan.alpha());
+  while (true) {
+    katana::do_all(
+        katana::iterate(window.Nodes()),
+        [&](const GNode& src) {
+          float sum = 0.0;
+          for (auto jj : window.OutEdges(src)) {
+            auto& ddata = (*node_data)[window.OutEdgeDst(jj)];
+            sum += ddata.value / ddata.out;
+          }
+
+          float value = sum * plan.alpha() + base_score;
+          float diff = std::fabs(value - (*node_data)[src].value);
+          (*node_data)[src].value = value;
+          accum += diff;
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("Pagerank Windowed"));
+
+    iteration += 1;
+    KATANA_CHECKED(katana::analytics::CheckProgress(
+        {"WindowedPagerank", iteration, 0, accum.reduce()}));
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+
+  katana::ReportStatSingle("WindowedPagerank", "Iterations", iteration);
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::WindowedPagerank(
+    PropertyGraph* pg, const TemporalView& window,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PagerankPlan plan) {
+  if (!window.is_transposed()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "windowed Pagerank pulls from in neighbors, so the view must be "
+        "transposed");
+  }
+
+  katana::StatTimer exec_time("WindowedPagerank");
+  exec_time.start();
+
+  katana::AllocationAccount account("analytics");
+  katana::NUMAArray<std::atomic<uint32_t>> out_degrees;
+  out_degrees.allocateInterleaved(window.NumNodes());
+  katana::do_all(
+      katana::iterate(window.Nodes()),
+      [&](const GNode& n) { out_degrees.constructAt(n, 0u); },
+      katana::no_stats());
+  // an in edge of the transposed graph is an out edge of its destination
+  katana::do_all(
+      katana::iterate(window.Nodes()),
+      [&](const GNode& n) {
+        for (auto e : window.OutEdges(n)) {
+          out_degrees[window.OutEdgeDst(e)].fetch_add(
+              1u, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(), katana::no_stats());
+
+  katana::NUMAArray<WindowNodeData> node_data;
+  node_data.allocateInterleaved(window.NumNodes());
+  PRTy init_value = 1.0f / window.NumNodes();
+  katana::do_all(
+      katana::iterate(window.Nodes()),
+      [&](const GNode& n) {
+        node_data[n].value = init_value;
+        node_data[n].out = out_degrees[n];
+      },
+      katana::no_stats());
+
+  KATANA_CHECKED(ComputePRWindowed(window, plan, &node_data));
+  exec_time.stop();
+
+  auto output =
+      katana::PropertyColumn<PRTy>::MakeInterleaved(window.NumNodes());
+  katana::do_all(
+      katana::iterate(window.Nodes()),
+      [&](const GNode& n) { output[n] = node_data[n].value; },
+      katana::no_stats());
+  return pg->AddNodeProperty(output_property_name, std::move(output), txn_ctx);
+}
@@ -17,27 +17,134 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "katana/PropertyColumn.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/GpuAnalytics.h"
 #include "pagerank-impl.h"
 
+namespace {
+
+katana::Result<void>
+PagerankGpu(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::analytics::GpuAnalytics* gpu =
+      KATANA_CHECKED(katana::analytics::GetGpuAnalytics());
+  auto ranks = katana::PropertyColumn<PRTy>::MakeInterleaved(pg->NumNodes());
+
+  katana::StatTimer exec_time("PagerankGpu");
+  exec_time.start();
+  KATANA_CHECKED(gpu->Pagerank(
+      pg, plan.alpha(), plan.tolerance(), plan.max_iterations(),
+      ranks.values().data()));
+  exec_time.stop();
+
+  return pg->AddNodeProperty(output_property_name, std::move(ranks), txn_ctx);
+}
+
+}  // namespace
+
 katana::Result<void>
 katana::analytics::Pagerank(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::TxnContext* txn_ctx, katana::analytics::PagerankPlan plan) {
+    katana::TxnContext* txn_ctx, katana::analytics::PagerankPlan plan,
+    const katana::analytics::CheckpointOptions& checkpoint) {
+  if (checkpoint.enabled() &&
+      (plan.architecture() != kCPU ||
+       plan.algorithm() != PagerankPlan::kPullTopological)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "only the topological pull algorithm supports checkpoints");
+  }
+  if (plan.architecture() == kGPU) {
+    return PagerankGpu(pg, output_property_name, plan, txn_ctx);
+  }
   switch (plan.algorithm()) {
   case PagerankPlan::kPullResidual:
     return PagerankPullResidual(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPullTopological:
-    return PagerankPullTopological(pg, output_property_name, plan, txn_ctx);
+    return PagerankPullTopological(
+        pg, output_property_name, plan, txn_ctx, checkpoint);
   case PagerankPlan::kPushAsynchronous:
     return PagerankPushAsynchronous(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPushSynchronous:
     return PagerankPushSynchronous(pg, output_property_name, plan, txn_ctx);
+  case PagerankPlan::kPropagationBlocking:
+    return PagerankPropagationBlocking(pg, output_property_name, plan, txn_ctx);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+namespace {
+
+katana::Result<void>
+CheckPersonalized(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const katana::analytics::PagerankPlan& plan) {
+  using katana::analytics::PagerankPlan;
+  if (plan.algorithm() != PagerankPlan::kPushAsynchronous &&
+      plan.algorithm() != PagerankPlan::kPushSynchronous) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "personalized pagerank needs a push algorithm");
+  }
+  for (uint32_t seed : seeds) {
+    if (seed >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "seed {} is not in a graph of {} nodes", seed, pg->NumNodes());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::PagerankIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const std::string& output_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges,
+    katana::TxnContext* txn_ctx, katana::analytics::PagerankPlan plan) {
+  for (const auto* edges : {&inserted_edges, &deleted_edges}) {
+    for (const auto& [src, dst] : *edges) {
+      if (src >= pg->NumNodes() || dst >= pg->NumNodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "edge ({}, {}) is not in a graph of {} nodes", src, dst,
+            pg->NumNodes());
+      }
+    }
+  }
+  return PagerankIncrementalPush(
+      pg, previous_property_name, output_property_name, inserted_edges,
+      deleted_edges, plan, txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::PersonalizedPagerank(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    katana::analytics::PagerankPlan plan) {
+  KATANA_CHECKED(CheckPersonalized(pg, seeds, plan));
+  if (seeds.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no seeds were given");
+  }
+  return PersonalizedPagerankPush(
+      pg, seeds, output_property_name, plan, txn_ctx);
+}
+
+katana::Result<std::vector<std::vector<std::pair<uint32_t, float>>>>
+katana::analytics::PersonalizedPagerankTopK(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds, size_t k,
+    katana::analytics::PagerankPlan plan) {
+  KATANA_CHECKED(CheckPersonalized(pg, seeds, plan));
+  return PersonalizedPagerankTopKPush(pg, seeds, k, plan);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::PagerankAssertValid(
@@ -0,0 +1,1072 @@
+#include "katana/analytics/partition/hypergraph_partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "partition-impl.h"
+
+namespace {
+
+using namespace katana::analytics;
+using namespace katana::analytics::internal;
+
+using Objective = HypergraphPartitionPlan::Objective;
+
+/// Rounds of proposals of a matching
+constexpr uint32_t kMatchingRounds = 4;
+/// Hyperedges with more nodes than this are too weak a sign that their
+/// nodes belong together to rate the matching of them
+constexpr uint64_t kMaxRatedHedgeSize = 256;
+/// Coarsening stops at a level with more than this fraction of the nodes of
+/// the level before it
+constexpr double kMinCoarsening = 0.95;
+constexpr uint32_t kRebalanceRounds = 8;
+
+/// A level of the multilevel scheme: the first is the input hypergraph and
+/// each of the others merges the nodes of a matching of the level before it
+struct Level {
+  /// The nodes of hyperedge h are pins[hedge_offsets[h], hedge_offsets[h + 1])
+  katana::NUMAArray<uint64_t> hedge_offsets;
+  katana::NUMAArray<uint32_t> pins;
+  katana::NUMAArray<uint64_t> hedge_weights;
+  /// The hyperedges of node n are
+  /// incidence[node_offsets[n], node_offsets[n + 1])
+  katana::NUMAArray<uint64_t> node_offsets;
+  katana::NUMAArray<uint32_t> incidence;
+  katana::NUMAArray<uint64_t> node_weights;
+  /// The node of the next level each node is merged into
+  katana::NUMAArray<uint32_t> coarse_of;
+
+  uint32_t NumNodes() const { return node_weights.size(); }
+  uint64_t NumHedges() const { return hedge_weights.size(); }
+  uint64_t HedgeSize(uint64_t h) const {
+    return hedge_offsets[h + 1] - hedge_offsets[h];
+  }
+  const uint32_t* PinsBegin(uint64_t h) const {
+    return pins.data() + hedge_offsets[h];
+  }
+  const uint32_t* PinsEnd(uint64_t h) const {
+    return pins.data() + hedge_offsets[h + 1];
+  }
+  const uint32_t* HedgesBegin(uint32_t n) const {
+    return incidence.data() + node_offsets[n];
+  }
+  const uint32_t* HedgesEnd(uint32_t n) const {
+    return incidence.data() + node_offsets[n + 1];
+  }
+};
+
+uint64_t
+HashPins(const uint32_t* begin, const uint32_t* end) {
+  uint64_t hash = end - begin;
+  for (const uint32_t* p = begin; p != end; ++p) {
+    hash = katana::StatelessRandom(0, hash ^ *p);
+  }
+  return hash;
+}
+
+void
+BuildIncidence(Level* level) {
+  uint32_t num_nodes = level->NumNodes();
+  katana::NUMAArray<std::atomic<uint64_t>> cursors;
+  cursors.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { cursors[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, level->NumHedges()),
+      [&](uint64_t h) {
+        for (const uint32_t* p = level->PinsBegin(h); p != level->PinsEnd(h);
+             ++p) {
+          cursors[*p].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  level->node_offsets.allocateBlocked(num_nodes + 1);
+  level->node_offsets[0] = 0;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { level->node_offsets[n + 1] = cursors[n].load(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      level->node_offsets.begin(), level->node_offsets.end(),
+      level->node_offsets.begin());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { cursors[n].store(level->node_offsets[n]); },
+      katana::no_stats());
+
+  level->incidence.allocateBlocked(level->node_offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, level->NumHedges()),
+      [&](uint64_t h) {
+        for (const uint32_t* p = level->PinsBegin(h); p != level->PinsEnd(h);
+             ++p) {
+          level->incidence[cursors[*p].fetch_add(1)] = h;
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// Make a level with the hyperedges raw_pins[raw_offsets[h],
+/// raw_offsets[h + 1]) of weights raw_weights. The nodes of each hyperedge
+/// are deduplicated, the hyperedges of fewer than two nodes, which can never
+/// be cut, are dropped and those with the same nodes are merged into one of
+/// their total weight.
+Level
+MakeLevel(
+    katana::NUMAArray<uint64_t>&& node_weights,
+    const katana::NUMAArray<uint64_t>& raw_offsets,
+    katana::NUMAArray<uint32_t>* raw_pins,
+    const katana::NUMAArray<uint64_t>& raw_weights) {
+  uint64_t num_raw = raw_weights.size();
+  katana::NUMAArray<uint64_t> sizes;
+  katana::NUMAArray<uint64_t> hashes;
+  sizes.allocateBlocked(num_raw);
+  hashes.allocateBlocked(num_raw);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_raw),
+      [&](uint64_t h) {
+        uint32_t* begin = raw_pins->data() + raw_offsets[h];
+        uint32_t* end = raw_pins->data() + raw_offsets[h + 1];
+        std::sort(begin, end);
+        end = std::unique(begin, end);
+        sizes[h] = end - begin;
+        hashes[h] = HashPins(begin, end);
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> order;
+  for (uint64_t h = 0; h < num_raw; ++h) {
+    if (sizes[h] > 1) {
+      order.emplace_back(h);
+    }
+  }
+  katana::ParallelSTL::sort(
+      order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+        if (sizes[a] != sizes[b]) {
+          return sizes[a] < sizes[b];
+        }
+        return hashes[a] != hashes[b] ? hashes[a] < hashes[b] : a < b;
+      });
+
+  // a hyperedge that starts a run of identical ones is kept
+  std::vector<uint64_t> kept(order.size() + 1, 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, order.size()),
+      [&](size_t i) {
+        uint64_t h = order[i];
+        bool duplicate = false;
+        if (i > 0) {
+          uint64_t prev = order[i - 1];
+          duplicate = sizes[prev] == sizes[h] && hashes[prev] == hashes[h] &&
+                      std::equal(
+                          raw_pins->data() + raw_offsets[h],
+                          raw_pins->data() + raw_offsets[h] + sizes[h],
+                          raw_pins->data() + raw_offsets[prev]);
+        }
+        kept[i + 1] = !duplicate;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(kept.begin(), kept.end(), kept.begin());
+  uint64_t num_hedges = kept.back();
+
+  Level level;
+  level.node_weights = std::move(node_weights);
+  level.hedge_weights.allocateBlocked(num_hedges);
+  level.hedge_offsets.allocateBlocked(num_hedges + 1);
+  level.hedge_offsets[0] = 0;
+  std::vector<uint64_t> firsts(num_hedges);
+  katana::do_all(
+      katana::iterate(size_t{0}, order.size()),
+      [&](size_t i) {
+        if (kept[i + 1] != kept[i]) {
+          firsts[kept[i]] = i;
+        }
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_hedges),
+      [&](uint64_t h) {
+        size_t end = h + 1 < num_hedges ? firsts[h + 1] : order.size();
+        uint64_t weight = 0;
+        for (size_t i = firsts[h]; i < end; ++i) {
+          weight += raw_weights[order[i]];
+        }
+        level.hedge_weights[h] = weight;
+        level.hedge_offsets[h + 1] = sizes[order[firsts[h]]];
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      level.hedge_offsets.begin(), level.hedge_offsets.end(),
+      level.hedge_offsets.begin());
+
+  level.pins.allocateBlocked(level.hedge_offsets[num_hedges]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_hedges),
+      [&](uint64_t h) {
+        const uint32_t* begin =
+            raw_pins->data() + raw_offsets[order[firsts[h]]];
+        std::copy(
+            begin, begin + level.HedgeSize(h),
+            level.pins.data() + level.hedge_offsets[h]);
+      },
+      katana::steal(), katana::no_stats());
+
+  BuildIncidence(&level);
+  return level;
+}
+
+Level
+InputLevel(const Hypergraph& hypergraph) {
+  uint64_t num_hedges = hypergraph.NumHedges();
+  katana::NUMAArray<uint64_t> raw_offsets;
+  katana::NUMAArray<uint32_t> raw_pins;
+  katana::NUMAArray<uint64_t> raw_weights;
+  katana::NUMAArray<uint64_t> node_weights;
+  raw_offsets.allocateBlocked(num_hedges + 1);
+  raw_pins.allocateBlocked(hypergraph.pins.size());
+  raw_weights.allocateBlocked(num_hedges);
+  node_weights.allocateBlocked(hypergraph.num_nodes);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_hedges + 1),
+      [&](uint64_t h) {
+        raw_offsets[h] = hypergraph.offsets[h];
+        if (h < num_hedges) {
+          raw_weights[h] = hypergraph.hedge_weights.empty()
+                               ? 1
+                               : hypergraph.hedge_weights[h];
+        }
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, hypergraph.pins.size()),
+      [&](size_t i) { raw_pins[i] = hypergraph.pins[i]; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, hypergraph.num_nodes),
+      [&](uint32_t n) {
+        node_weights[n] =
+            hypergraph.node_weights.empty() ? 1 : hypergraph.node_weights[n];
+      },
+      katana::no_stats());
+  return MakeLevel(
+      std::move(node_weights), raw_offsets, &raw_pins, raw_weights);
+}
+
+/// Match the nodes of level and merge each pair into a node of the next
+/// level, keeping the nodes of the next level no heavier than
+/// max_node_weight. A pair is rated by the weight of the hyperedges it
+/// shares, each in inverse proportion to its size, over the product of the
+/// weights of the pair so that the nodes stay of similar weights. Every
+/// round each unmatched node proposes to its unmatched neighbor of the best
+/// rating, ties broken at random, and pairs that propose to each other are
+/// matched.
+Level
+Coarsen(Level* level, uint64_t max_node_weight) {
+  uint32_t num_nodes = level->NumNodes();
+  const auto& weights = level->node_weights;
+  katana::NUMAArray<uint32_t> match;
+  katana::NUMAArray<uint32_t> proposal;
+  match.allocateBlocked(num_nodes);
+  proposal.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(match.begin(), match.end(), kNone);
+
+  katana::PerThreadStorage<std::vector<std::pair<uint32_t, double>>> ratings;
+  for (uint32_t round = 0; round < kMatchingRounds; ++round) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          proposal[n] = kNone;
+          if (match[n] != kNone) {
+            return;
+          }
+          std::vector<std::pair<uint32_t, double>>& rated =
+              *ratings.getLocal();
+          rated.clear();
+          for (const uint32_t* h = level->HedgesBegin(n);
+               h != level->HedgesEnd(n); ++h) {
+            uint64_t size = level->HedgeSize(*h);
+            if (size > kMaxRatedHedgeSize) {
+              continue;
+            }
+            double rating = double(level->hedge_weights[*h]) / (size - 1);
+            for (const uint32_t* p = level->PinsBegin(*h);
+                 p != level->PinsEnd(*h); ++p) {
+              if (*p != n && match[*p] == kNone &&
+                  weights[n] + weights[*p] <= max_node_weight) {
+                rated.emplace_back(*p, rating);
+              }
+            }
+          }
+          std::sort(rated.begin(), rated.end());
+
+          std::pair<double, uint64_t> best{0, 0};
+          for (size_t i = 0; i < rated.size();) {
+            uint32_t m = rated[i].first;
+            double rating = 0;
+            for (; i < rated.size() && rated[i].first == m; ++i) {
+              rating += rated[i].second;
+            }
+            // the tie breaker is the same from either end of the pair, so
+            // a pair of the best rating around both ends is proposed by both
+            uint64_t lo = std::min(n, m);
+            uint64_t hi = std::max(n, m);
+            std::pair<double, uint64_t> key{
+                rating / (double(weights[n]) * weights[m]),
+                katana::StatelessRandom(round, (lo << 32) | hi)};
+            if (proposal[n] == kNone || key > best) {
+              best = key;
+              proposal[n] = m;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::GAccumulator<uint64_t> matched;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          if (proposal[n] != kNone && proposal[proposal[n]] == n) {
+            match[n] = proposal[n];
+            matched += 1;
+          }
+        },
+        katana::no_stats());
+    if (matched.reduce() == 0) {
+      break;
+    }
+  }
+
+  // a pair is numbered after the lesser of its nodes
+  katana::NUMAArray<uint64_t> coarse_ids;
+  coarse_ids.allocateBlocked(num_nodes + 1);
+  coarse_ids[0] = 0;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        coarse_ids[n + 1] = match[n] == kNone || n < match[n];
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      coarse_ids.begin(), coarse_ids.end(), coarse_ids.begin());
+  uint32_t num_coarse = coarse_ids[num_nodes];
+
+  level->coarse_of.allocateBlocked(num_nodes);
+  katana::NUMAArray<uint64_t> coarse_weights;
+  coarse_weights.allocateBlocked(num_coarse);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        uint32_t first = match[n] == kNone ? n : std::min(n, match[n]);
+        level->coarse_of[n] = coarse_ids[first];
+        if (first == n) {
+          coarse_weights[coarse_ids[n]] =
+              weights[n] + (match[n] == kNone ? 0 : weights[match[n]]);
+        }
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<uint32_t> raw_pins;
+  raw_pins.allocateBlocked(level->pins.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, level->pins.size()),
+      [&](size_t i) { raw_pins[i] = level->coarse_of[level->pins[i]]; },
+      katana::no_stats());
+
+  return MakeLevel(
+      std::move(coarse_weights), level->hedge_offsets, &raw_pins,
+      level->hedge_weights);
+}
+
+/// The partitions that the nodes of each hyperedge are in: those of
+/// hyperedge h are parts[offsets[h], offsets[h] + num_parts[h]), with
+/// counts of nodes in them, in space that the nodes of h take in the pins
+/// of the level
+struct PinCounts {
+  katana::NUMAArray<uint32_t> parts;
+  katana::NUMAArray<uint32_t> counts;
+  katana::NUMAArray<uint32_t> num_parts;
+
+  explicit PinCounts(const Level& level) {
+    parts.allocateBlocked(level.pins.size());
+    counts.allocateBlocked(level.pins.size());
+    num_parts.allocateBlocked(level.NumHedges());
+  }
+
+  void Count(
+      const Level& level, const uint32_t* node_parts, uint64_t h,
+      Connections* counter) {
+    counter->Clear();
+    for (const uint32_t* p = level.PinsBegin(h); p != level.PinsEnd(h); ++p) {
+      counter->Add(node_parts[*p], 1);
+    }
+    uint64_t offset = level.hedge_offsets[h];
+    num_parts[h] = counter->touched().size();
+    for (uint32_t part : counter->touched()) {
+      parts[offset] = part;
+      counts[offset] = counter->Of(part);
+      ++offset;
+    }
+  }
+
+  uint32_t Of(const Level& level, uint64_t h, uint32_t part) const {
+    uint64_t offset = level.hedge_offsets[h];
+    for (uint64_t i = offset; i < offset + num_parts[h]; ++i) {
+      if (parts[i] == part) {
+        return counts[i];
+      }
+    }
+    return 0;
+  }
+
+  /// Account for a node of hyperedge h moving from partition from to to
+  void Move(const Level& level, uint64_t h, uint32_t from, uint32_t to) {
+    uint64_t offset = level.hedge_offsets[h];
+    uint64_t end = offset + num_parts[h];
+    // from is taken off first so that there is a free slot for to if it
+    // is new to the hyperedge
+    for (uint64_t i = offset; i < end; ++i) {
+      if (parts[i] == from) {
+        if (--counts[i] == 0) {
+          parts[i] = parts[end - 1];
+          counts[i] = counts[end - 1];
+          --num_parts[h];
+          --end;
+        }
+        break;
+      }
+    }
+    for (uint64_t i = offset; i < end; ++i) {
+      if (parts[i] == to) {
+        ++counts[i];
+        return;
+      }
+    }
+    parts[end] = to;
+    counts[end] = 1;
+    ++num_parts[h];
+  }
+};
+
+/// The objective of hyperedge h
+uint64_t
+HedgeObjective(
+    const Level& level, const PinCounts& counts, uint64_t h,
+    Objective objective) {
+  uint64_t spanned = counts.num_parts[h];
+  if (objective == HypergraphPartitionPlan::kCut) {
+    return spanned > 1 ? level.hedge_weights[h] : 0;
+  }
+  return (spanned - 1) * level.hedge_weights[h];
+}
+
+/// Count the partitions of every hyperedge and return the objective
+uint64_t
+CountPins(
+    const Level& level, const katana::NUMAArray<uint32_t>& parts,
+    Objective objective, PinCounts* counts) {
+  katana::PerThreadStorage<Connections> counters;
+  katana::GAccumulator<uint64_t> total;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, level.NumHedges()),
+      [&](uint64_t h) {
+        counts->Count(level, parts.data(), h, counters.getLocal());
+        total += HedgeObjective(level, *counts, h, objective);
+      },
+      katana::steal(), katana::no_stats());
+  return total.reduce();
+}
+
+/// The gain of moving node n out of its partition from is base plus the
+/// weight that conn has for the partition it moves to
+int64_t
+Gains(
+    const Level& level, const PinCounts& counts, uint32_t n, uint32_t from,
+    Objective objective, Connections* conn) {
+  conn->Clear();
+  int64_t base = 0;
+  for (const uint32_t* h = level.HedgesBegin(n); h != level.HedgesEnd(n);
+       ++h) {
+    uint64_t weight = level.hedge_weights[*h];
+    uint64_t size = level.HedgeSize(*h);
+    uint64_t offset = level.hedge_offsets[*h];
+    uint32_t in_from = 0;
+    for (uint64_t i = offset; i < offset + counts.num_parts[*h]; ++i) {
+      if (counts.parts[i] == from) {
+        in_from = counts.counts[i];
+      } else if (
+          objective == HypergraphPartitionPlan::kConnectivity ||
+          counts.counts[i] == size - 1) {
+        conn->Add(counts.parts[i], weight);
+      }
+    }
+    if (objective == HypergraphPartitionPlan::kConnectivity) {
+      // the hyperedge leaves from if n is its last node there, and joins
+      // a partition that it has no nodes in
+      base += (in_from == 1 ? weight : 0) - weight;
+    } else if (in_from == size) {
+      base -= weight;
+    }
+  }
+  return base;
+}
+
+std::vector<uint64_t>
+PartWeights(
+    const Level& level, const katana::NUMAArray<uint32_t>& parts,
+    uint32_t num_parts) {
+  katana::PerThreadStorage<std::vector<uint64_t>> local_weights;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, level.NumNodes()),
+      [&](uint32_t n) {
+        std::vector<uint64_t>& local = *local_weights.getLocal();
+        if (local.empty()) {
+          local.resize(num_parts, 0);
+        }
+        local[parts[n]] += level.node_weights[n];
+      },
+      katana::no_stats());
+  std::vector<uint64_t> weights(num_parts, 0);
+  for (unsigned t = 0; t < local_weights.size(); ++t) {
+    const std::vector<uint64_t>& local = *local_weights.getRemote(t);
+    for (size_t p = 0; p < local.size(); ++p) {
+      weights[p] += local[p];
+    }
+  }
+  return weights;
+}
+
+/// Collect a move of every node for which choose_move(base, conn, move)
+/// returns true, given the gains of the node
+template <typename ChooseMove>
+std::vector<Move>
+CollectMoves(
+    const Level& level, const katana::NUMAArray<uint32_t>& parts,
+    const PinCounts& counts, Objective objective,
+    const ChooseMove& choose_move) {
+  katana::PerThreadStorage<Connections> connections;
+  katana::PerThreadStorage<std::vector<Move>> local_moves;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, level.NumNodes()),
+      [&](uint32_t n) {
+        Connections& conn = *connections.getLocal();
+        int64_t base = Gains(level, counts, n, parts[n], objective, &conn);
+        Move move{0, n, parts[n], kNone};
+        if (choose_move(base, conn, &move)) {
+          local_moves.getLocal()->emplace_back(move);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Move> moves;
+  for (unsigned t = 0; t < local_moves.size(); ++t) {
+    const std::vector<Move>& local = *local_moves.getRemote(t);
+    moves.insert(moves.end(), local.begin(), local.end());
+  }
+  return moves;
+}
+
+/// Move nodes out of the partitions heavier than max_part_weight, those
+/// that cost the least first
+void
+Rebalance(
+    const Level& level, uint32_t num_parts, uint64_t max_part_weight,
+    Objective objective, katana::NUMAArray<uint32_t>* parts) {
+  PinCounts counts(level);
+  for (uint32_t round = 0; round < kRebalanceRounds; ++round) {
+    std::vector<uint64_t> weights = PartWeights(level, *parts, num_parts);
+    if (*std::max_element(weights.begin(), weights.end()) <= max_part_weight) {
+      return;
+    }
+    uint32_t lightest =
+        std::min_element(weights.begin(), weights.end()) - weights.begin();
+    CountPins(level, *parts, objective, &counts);
+
+    std::vector<Move> moves = CollectMoves(
+        level, *parts, counts, objective,
+        [&](int64_t base, const Connections& conn, Move* move) {
+          uint64_t weight = level.node_weights[move->node];
+          if (weights[move->from] <= max_part_weight) {
+            return false;
+          }
+          for (uint32_t p : conn.touched()) {
+            int64_t gain = base + conn.Of(p);
+            if (weights[p] + weight <= max_part_weight &&
+                (move->to == kNone || gain > move->gain ||
+                 (gain == move->gain && p < move->to))) {
+              move->gain = gain;
+              move->to = p;
+            }
+          }
+          if (move->to == kNone) {
+            if (lightest == move->from ||
+                weights[lightest] + weight > max_part_weight) {
+              return false;
+            }
+            move->to = lightest;
+            move->gain = base + conn.Of(lightest);
+          }
+          return true;
+        });
+    katana::ParallelSTL::sort(
+        moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+          return a.gain != b.gain ? a.gain > b.gain : a.node < b.node;
+        });
+
+    bool moved = false;
+    for (const Move& move : moves) {
+      uint64_t weight = level.node_weights[move.node];
+      if (weights[move.from] > max_part_weight &&
+          weights[move.to] + weight <= max_part_weight) {
+        weights[move.from] -= weight;
+        weights[move.to] += weight;
+        (*parts)[move.node] = move.to;
+        moved = true;
+      }
+    }
+    if (!moved) {
+      return;
+    }
+  }
+}
+
+/// Move nodes to the partitions of most gain, those of the most gain first
+/// as long as the partitions do not get heavier than max_part_weight. The
+/// gains of a round are computed before any of its moves, so a round that
+/// turns out to make the objective worse is undone.
+void
+Refine(
+    const Level& level, uint32_t num_parts, uint64_t max_part_weight,
+    uint32_t rounds, Objective objective, katana::NUMAArray<uint32_t>* parts) {
+  PinCounts counts(level);
+  uint64_t current = CountPins(level, *parts, objective, &counts);
+  uint32_t rounds_without_gain = 0;
+  for (uint32_t round = 0; round < rounds && rounds_without_gain < 2;
+       ++round) {
+    std::vector<uint64_t> weights = PartWeights(level, *parts, num_parts);
+    // moving to higher partitions on even rounds and to lower ones on odd
+    // rounds keeps neighbors from trading places
+    bool upward = round % 2 == 0;
+
+    std::vector<Move> moves = CollectMoves(
+        level, *parts, counts, objective,
+        [&](int64_t base, const Connections& conn, Move* move) {
+          uint64_t weight = level.node_weights[move->node];
+          for (uint32_t p : conn.touched()) {
+            if ((upward ? p <= move->from : p >= move->from) ||
+                weights[p] + weight > max_part_weight) {
+              continue;
+            }
+            int64_t gain = base + conn.Of(p);
+            if (gain > move->gain ||
+                (gain == move->gain && gain > 0 && p < move->to)) {
+              move->gain = gain;
+              move->to = p;
+            }
+          }
+          return move->to != kNone && move->gain > 0;
+        });
+
+    // the moves to each partition, the most gain first
+    katana::ParallelSTL::sort(
+        moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+          if (a.to != b.to) {
+            return a.to < b.to;
+          }
+          return a.gain != b.gain ? a.gain > b.gain : a.node < b.node;
+        });
+    std::vector<uint8_t> applied(moves.size(), 0);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_parts),
+        [&](uint32_t p) {
+          auto it = std::lower_bound(
+              moves.begin(), moves.end(), p,
+              [](const Move& move, uint32_t part) { return move.to < part; });
+          uint64_t weight = weights[p];
+          for (; it != moves.end() && it->to == p; ++it) {
+            uint64_t node_weight = level.node_weights[it->node];
+            if (weight + node_weight <= max_part_weight) {
+              weight += node_weight;
+              (*parts)[it->node] = p;
+              applied[it - moves.begin()] = 1;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    uint64_t next = CountPins(level, *parts, objective, &counts);
+    if (next >= current) {
+      if (next > current) {
+        katana::do_all(
+            katana::iterate(size_t{0}, moves.size()),
+            [&](size_t i) {
+              if (applied[i]) {
+                (*parts)[moves[i].node] = moves[i].from;
+              }
+            },
+            katana::no_stats());
+        CountPins(level, *parts, objective, &counts);
+      }
+      ++rounds_without_gain;
+    } else {
+      current = next;
+      rounds_without_gain = 0;
+    }
+  }
+}
+
+/// A k way partition of the coarsest level, growing the partitions in turn
+/// greedily from seed and then moving nodes while that improves the
+/// objective, all in the calling thread so that tries run in parallel
+std::pair<std::vector<uint32_t>, uint64_t>
+InitialPartition(
+    const Level& level, uint32_t num_parts, uint64_t max_part_weight,
+    uint32_t rounds, Objective objective, uint64_t seed) {
+  uint32_t num_nodes = level.NumNodes();
+  uint64_t total_weight = 0;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    total_weight += level.node_weights[n];
+  }
+
+  // each partition is grown from a seed, taking the unassigned node most
+  // connected to it next, until it has its share of the weight; a node
+  // not connected to it is taken when there is none
+  std::vector<uint32_t> parts(num_nodes, kNone);
+  std::vector<uint64_t> weights(num_parts, 0);
+  std::vector<double> connection(num_nodes, 0);
+  std::vector<uint32_t> connected;
+  std::priority_queue<std::pair<double, uint32_t>> frontier;
+  std::vector<uint32_t> order;
+  order.reserve(num_nodes);
+  uint32_t start = katana::StatelessRandom(seed, num_nodes) % num_nodes;
+  uint32_t next_unconnected = 0;
+  uint32_t part = 0;
+  uint64_t filled = 0;
+  while (order.size() < num_nodes) {
+    uint32_t n = kNone;
+    while (!frontier.empty() && n == kNone) {
+      auto [conn, candidate] = frontier.top();
+      frontier.pop();
+      if (parts[candidate] == kNone && conn == connection[candidate]) {
+        n = candidate;
+      }
+    }
+    while (n == kNone) {
+      uint32_t candidate = (start + next_unconnected++) % num_nodes;
+      if (parts[candidate] == kNone) {
+        n = candidate;
+      }
+    }
+
+    parts[n] = part;
+    order.emplace_back(n);
+    weights[part] += level.node_weights[n];
+    filled += level.node_weights[n];
+    if (part + 1 < num_parts &&
+        filled * num_parts >= (part + 1) * total_weight) {
+      ++part;
+      frontier = {};
+      for (uint32_t m : connected) {
+        connection[m] = 0;
+      }
+      connected.clear();
+      continue;
+    }
+    for (const uint32_t* h = level.HedgesBegin(n); h != level.HedgesEnd(n);
+         ++h) {
+      uint64_t size = level.HedgeSize(*h);
+      if (size > kMaxRatedHedgeSize) {
+        continue;
+      }
+      double rating = double(level.hedge_weights[*h]) / (size - 1);
+      for (const uint32_t* p = level.PinsBegin(*h); p != level.PinsEnd(*h);
+           ++p) {
+        if (parts[*p] == kNone) {
+          if (connection[*p] == 0) {
+            connected.emplace_back(*p);
+          }
+          connection[*p] += rating;
+          frontier.emplace(connection[*p], *p);
+        }
+      }
+    }
+  }
+
+  PinCounts counts(level);
+  Connections counter;
+  uint64_t current = 0;
+  for (uint64_t h = 0; h < level.NumHedges(); ++h) {
+    counts.Count(level, parts.data(), h, &counter);
+    current += HedgeObjective(level, counts, h, objective);
+  }
+
+  // the moves are applied as they are found, so their gains are exact
+  for (uint32_t round = 0; round < rounds; ++round) {
+    bool moved = false;
+    for (uint32_t n : order) {
+      uint32_t from = parts[n];
+      uint64_t weight = level.node_weights[n];
+      int64_t base = Gains(level, counts, n, from, objective, &counter);
+      int64_t best_gain = 0;
+      uint32_t best = kNone;
+      for (uint32_t p : counter.touched()) {
+        int64_t gain = base + counter.Of(p);
+        if (weights[p] + weight <= max_part_weight && gain > best_gain) {
+          best_gain = gain;
+          best = p;
+        }
+      }
+      if (best == kNone) {
+        continue;
+      }
+      for (const uint32_t* h = level.HedgesBegin(n); h != level.HedgesEnd(n);
+           ++h) {
+        counts.Move(level, *h, from, best);
+      }
+      parts[n] = best;
+      weights[from] -= weight;
+      weights[best] += weight;
+      current -= best_gain;
+      moved = true;
+    }
+    if (!moved) {
+      break;
+    }
+  }
+  return {std::move(parts), current};
+}
+
+katana::NUMAArray<uint32_t>
+MultilevelKWay(
+    const Hypergraph& hypergraph, uint32_t num_parts,
+    const HypergraphPartitionPlan& plan) {
+  Objective objective = plan.objective();
+  std::vector<Level> levels;
+  levels.emplace_back(InputLevel(hypergraph));
+
+  katana::GAccumulator<uint64_t> total;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, levels.back().NumNodes()),
+      [&](uint32_t n) { total += levels.back().node_weights[n]; },
+      katana::no_stats());
+  uint64_t total_weight = total.reduce();
+  uint64_t coarsest =
+      std::max<uint64_t>(uint64_t{plan.coarsening_limit()} * num_parts, 1);
+  // nodes of the coarsest level much heavier than its average would make
+  // the initial partition hard to balance
+  uint64_t max_node_weight = std::max<uint64_t>(
+      2, std::ceil(1.5 * total_weight / std::min(coarsest, total_weight + 1)));
+  uint64_t max_part_weight = std::ceil(
+      (1 + plan.imbalance()) * ((total_weight + num_parts - 1) / num_parts));
+
+  while (levels.back().NumNodes() > coarsest) {
+    Level next = Coarsen(&levels.back(), max_node_weight);
+    if (next.NumNodes() > kMinCoarsening * levels.back().NumNodes()) {
+      break;
+    }
+    levels.emplace_back(std::move(next));
+  }
+
+  const Level& coarsest_level = levels.back();
+  katana::NUMAArray<uint32_t> parts;
+  parts.allocateBlocked(coarsest_level.NumNodes());
+  if (coarsest_level.NumNodes() > 0) {
+    uint32_t tries = std::max(plan.initial_tries(), uint32_t{1});
+    std::vector<std::pair<std::vector<uint32_t>, uint64_t>> results(tries);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, tries),
+        [&](uint32_t t) {
+          results[t] = InitialPartition(
+              coarsest_level, num_parts, max_part_weight,
+              plan.refinement_rounds(), objective, t);
+        },
+        katana::steal(), katana::no_stats());
+    // balanced partitions first, then those of the best objective
+    auto key = [&](const std::pair<std::vector<uint32_t>, uint64_t>& result) {
+      std::vector<uint64_t> weights(num_parts, 0);
+      for (uint32_t n = 0; n < coarsest_level.NumNodes(); ++n) {
+        weights[result.first[n]] += coarsest_level.node_weights[n];
+      }
+      uint64_t heaviest = *std::max_element(weights.begin(), weights.end());
+      return std::make_pair(
+          std::max(heaviest, max_part_weight), result.second);
+    };
+    auto best = std::min_element(
+        results.begin(), results.end(),
+        [&](const auto& a, const auto& b) { return key(a) < key(b); });
+    std::copy(best->first.begin(), best->first.end(), parts.begin());
+  }
+
+  for (size_t l = levels.size(); l-- > 0;) {
+    const Level& level = levels[l];
+    if (l + 1 < levels.size()) {
+      katana::NUMAArray<uint32_t> fine_parts;
+      fine_parts.allocateBlocked(level.NumNodes());
+      katana::do_all(
+          katana::iterate(uint32_t{0}, level.NumNodes()),
+          [&](uint32_t n) { fine_parts[n] = parts[level.coarse_of[n]]; },
+          katana::no_stats());
+      parts = std::move(fine_parts);
+    }
+    Rebalance(level, num_parts, max_part_weight, objective, &parts);
+    Refine(
+        level, num_parts, max_part_weight, plan.refinement_rounds(), objective,
+        &parts);
+  }
+  return parts;
+}
+
+katana::Result<void>
+CheckHypergraph(const Hypergraph& hypergraph) {
+  const auto& offsets = hypergraph.offsets;
+  if (offsets.empty() || offsets.front() != 0 ||
+      offsets.back() != hypergraph.pins.size() ||
+      !std::is_sorted(offsets.begin(), offsets.end())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "hyperedge offsets are not increasing from 0 to the number of pins");
+  }
+  if (!hypergraph.hedge_weights.empty() &&
+      hypergraph.hedge_weights.size() != hypergraph.NumHedges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} hyperedge weights for {} hyperedges",
+        hypergraph.hedge_weights.size(), hypergraph.NumHedges());
+  }
+  if (!hypergraph.node_weights.empty() &&
+      hypergraph.node_weights.size() != hypergraph.num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} node weights for {} nodes",
+        hypergraph.node_weights.size(), hypergraph.num_nodes);
+  }
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(size_t{0}, hypergraph.pins.size()),
+      [&](size_t i) {
+        if (hypergraph.pins[i] >= hypergraph.num_nodes) {
+          out_of_range.update(true);
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "found a hyperedge with a node outside [0, {})", hypergraph.num_nodes);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::PartitionHypergraph(
+    const Hypergraph& hypergraph, uint32_t num_partitions,
+    std::vector<uint32_t>* partitions, HypergraphPartitionPlan plan) {
+  if (plan.algorithm() != HypergraphPartitionPlan::kMultilevelKWay) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm: {}",
+        plan.algorithm());
+  }
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no partitions requested");
+  }
+  if (plan.imbalance() < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "negative imbalance: {}",
+        plan.imbalance());
+  }
+  KATANA_CHECKED(CheckHypergraph(hypergraph));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("PartitionHypergraph");
+  exec_time.start();
+  katana::NUMAArray<uint32_t> parts =
+      MultilevelKWay(hypergraph, num_partitions, plan);
+  partitions->assign(parts.begin(), parts.end());
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::HypergraphPartitionStatistics::Print(
+    std::ostream& os) const {
+  os << "Cut = " << cut << std::endl;
+  os << "Connectivity = " << connectivity << std::endl;
+  os << "Weight of the heaviest partition = " << largest_partition_weight
+     << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
+
+katana::Result<katana::analytics::HypergraphPartitionStatistics>
+katana::analytics::HypergraphPartitionStatistics::Compute(
+    const Hypergraph& hypergraph, uint32_t num_partitions,
+    const std::vector<uint32_t>& partitions) {
+  KATANA_CHECKED(CheckHypergraph(hypergraph));
+  if (partitions.size() != hypergraph.num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} partitions for {} nodes",
+        partitions.size(), hypergraph.num_nodes);
+  }
+  if (std::any_of(partitions.begin(), partitions.end(), [&](uint32_t p) {
+        return p >= num_partitions;
+      })) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "found a node of a partition outside [0, {})", num_partitions);
+  }
+
+  katana::PerThreadStorage<Connections> counters;
+  katana::GAccumulator<uint64_t> cut;
+  katana::GAccumulator<uint64_t> connectivity;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, hypergraph.NumHedges()),
+      [&](uint64_t h) {
+        Connections& counter = *counters.getLocal();
+        counter.Clear();
+        for (uint64_t i = hypergraph.offsets[h]; i < hypergraph.offsets[h + 1];
+             ++i) {
+          counter.Add(partitions[hypergraph.pins[i]], 1);
+        }
+        uint64_t weight =
+            hypergraph.hedge_weights.empty() ? 1 : hypergraph.hedge_weights[h];
+        uint64_t spanned = counter.touched().size();
+        if (spanned > 1) {
+          cut += weight;
+          connectivity += (spanned - 1) * weight;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> weights(num_partitions, 0);
+  uint64_t total_weight = 0;
+  for (uint32_t n = 0; n < hypergraph.num_nodes; ++n) {
+    uint64_t weight =
+        hypergraph.node_weights.empty() ? 1 : hypergraph.node_weights[n];
+    weights[partitions[n]] += weight;
+    total_weight += weight;
+  }
+  uint64_t largest = *std::max_element(weights.begin(), weights.end());
+  double even_share = double(total_weight) / num_partitions;
+  double imbalance = even_share > 0 ? largest / even_share - 1 : 0;
+  return HypergraphPartitionStatistics{
+      cut.reduce(), connectivity.reduce(), largest, imbalance};
+}
@@ -0,0 +1,59 @@
+#ifndef KATANA_LIBGRAPH_ANALYTICS_PARTITION_PARTITIONIMPL_H_
+#define KATANA_LIBGRAPH_ANALYTICS_PARTITION_PARTITIONIMPL_H_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace katana::analytics::internal {
+
+/// No node or partition
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+/// The weights of the edges from a node to each partition
+class Connections {
+public:
+  void Add(uint32_t part, uint64_t weight) {
+    if (part >= weights_.size()) {
+      weights_.resize(part + 1, 0);
+      present_.resize(part + 1, false);
+    }
+    if (!present_[part]) {
+      present_[part] = true;
+      touched_.emplace_back(part);
+    }
+    weights_[part] += weight;
+  }
+
+  uint64_t Of(uint32_t part) const {
+    return part < weights_.size() ? weights_[part] : 0;
+  }
+
+  /// The partitions added to since the last Clear
+  const std::vector<uint32_t>& touched() const { return touched_; }
+
+  void Clear() {
+    for (uint32_t part : touched_) {
+      weights_[part] = 0;
+      present_[part] = false;
+    }
+    touched_.clear();
+  }
+
+private:
+  std::vector<uint64_t> weights_;
+  std::vector<bool> present_;
+  std::vector<uint32_t> touched_;
+};
+
+/// A move of node from partition from to partition to
+struct Move {
+  int64_t gain;
+  uint32_t node;
+  uint32_t from;
+  uint32_t to;
+};
+
+}  // namespace katana::analytics::internal
+
+#endif
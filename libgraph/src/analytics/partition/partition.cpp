@@ -0,0 +1,831 @@
+#include "katana/analytics/partition/partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+#include "partition-impl.h"
+
+namespace {
+
+using namespace katana::analytics;
+using namespace katana::analytics::internal;
+
+struct NodePartition : public katana::PODProperty<uint32_t> {};
+
+using NodeData = std::tuple<NodePartition>;
+using EdgeData = std::tuple<>;
+
+using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+using GNode = Graph::Node;
+
+/// Rounds of proposals of a matching
+constexpr uint32_t kMatchingRounds = 4;
+/// Coarsening stops at a level with more than this fraction of the nodes of
+/// the level before it
+constexpr double kMinCoarsening = 0.95;
+/// Seeds each bisection of the coarsest level is grown from
+constexpr uint32_t kBisectionTries = 4;
+constexpr uint32_t kRebalanceRounds = 8;
+
+struct WeightedEdge {
+  uint32_t dest;
+  uint64_t weight;
+};
+
+/// An undirected graph with weights on its nodes and edges, a level of the
+/// multilevel scheme: the first is the input graph with each edge either
+/// way, and each of the others merges the nodes of a matching of the level
+/// before it
+struct Level {
+  /// The edges of node n are edges[offsets[n], offsets[n + 1])
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<WeightedEdge> edges;
+  katana::NUMAArray<uint64_t> node_weights;
+  /// The node of the next level each node is merged into
+  katana::NUMAArray<uint32_t> coarse_of;
+
+  uint32_t NumNodes() const { return node_weights.size(); }
+  const WeightedEdge* begin(uint32_t n) const {
+    return edges.data() + offsets[n];
+  }
+  const WeightedEdge* end(uint32_t n) const {
+    return edges.data() + offsets[n + 1];
+  }
+};
+
+/// Make a level with the edges of each node n that are
+/// raw_edges[raw_offsets[n], raw_offsets[n + 1]), summing the weights of
+/// the edges to the same node and dropping those to n itself
+Level
+MakeLevel(
+    katana::NUMAArray<uint64_t>&& node_weights,
+    const katana::NUMAArray<uint64_t>& raw_offsets,
+    katana::NUMAArray<WeightedEdge>* raw_edges) {
+  Level level;
+  level.node_weights = std::move(node_weights);
+  uint32_t num_nodes = level.NumNodes();
+  level.offsets.allocateBlocked(num_nodes + 1);
+  level.offsets[0] = 0;
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        WeightedEdge* begin = raw_edges->data() + raw_offsets[n];
+        WeightedEdge* end = raw_edges->data() + raw_offsets[n + 1];
+        std::sort(begin, end, [](const auto& a, const auto& b) {
+          return a.dest < b.dest;
+        });
+        uint64_t degree = 0;
+        for (WeightedEdge* e = begin; e != end; ++e) {
+          if (e->dest == n) {
+            continue;
+          }
+          if (degree > 0 && begin[degree - 1].dest == e->dest) {
+            begin[degree - 1].weight += e->weight;
+          } else {
+            begin[degree++] = *e;
+          }
+        }
+        level.offsets[n + 1] = degree;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      level.offsets.begin(), level.offsets.end(), level.offsets.begin());
+
+  level.edges.allocateBlocked(level.offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        const WeightedEdge* begin = raw_edges->data() + raw_offsets[n];
+        std::copy(
+            begin, begin + (level.offsets[n + 1] - level.offsets[n]),
+            level.edges.data() + level.offsets[n]);
+      },
+      katana::steal(), katana::no_stats());
+  return level;
+}
+
+/// The level of the input graph, with nodes and edges of weight 1
+Level
+InputLevel(const katana::GraphTopology& topology) {
+  uint32_t num_nodes = topology.NumNodes();
+  katana::NUMAArray<std::atomic<uint64_t>> cursors;
+  cursors.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { cursors[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        for (auto e : topology.OutEdges(n)) {
+          uint32_t dest = topology.OutEdgeDst(e);
+          if (dest != n) {
+            cursors[n].fetch_add(1, std::memory_order_relaxed);
+            cursors[dest].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::NUMAArray<uint64_t> raw_offsets;
+  raw_offsets.allocateBlocked(num_nodes + 1);
+  raw_offsets[0] = 0;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { raw_offsets[n + 1] = cursors[n].load(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      raw_offsets.begin(), raw_offsets.end(), raw_offsets.begin());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) { cursors[n].store(raw_offsets[n]); },
+      katana::no_stats());
+
+  katana::NUMAArray<WeightedEdge> raw_edges;
+  raw_edges.allocateBlocked(raw_offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        for (auto e : topology.OutEdges(n)) {
+          uint32_t dest = topology.OutEdgeDst(e);
+          if (dest != n) {
+            raw_edges[cursors[n].fetch_add(1)] = WeightedEdge{dest, 1};
+            raw_edges[cursors[dest].fetch_add(1)] = WeightedEdge{n, 1};
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::NUMAArray<uint64_t> node_weights;
+  node_weights.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(node_weights.begin(), node_weights.end(), 1);
+  return MakeLevel(std::move(node_weights), raw_offsets, &raw_edges);
+}
+
+/// Match the nodes of level by heavy edges and merge each pair into a node
+/// of the next level, keeping the nodes of the next level no heavier than
+/// max_node_weight. Every round each unmatched node proposes to its
+/// unmatched neighbor of the heaviest edge, ties broken at random, and the
+/// pairs that propose to each other are matched.
+Level
+Coarsen(Level* level, uint64_t max_node_weight) {
+  uint32_t num_nodes = level->NumNodes();
+  const auto& weights = level->node_weights;
+  katana::NUMAArray<uint32_t> match;
+  katana::NUMAArray<uint32_t> proposal;
+  match.allocateBlocked(num_nodes);
+  proposal.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(match.begin(), match.end(), kNone);
+
+  for (uint32_t round = 0; round < kMatchingRounds; ++round) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          proposal[n] = kNone;
+          if (match[n] != kNone) {
+            return;
+          }
+          std::pair<uint64_t, uint64_t> best{0, 0};
+          for (const WeightedEdge* e = level->begin(n); e != level->end(n);
+               ++e) {
+            if (match[e->dest] != kNone ||
+                weights[n] + weights[e->dest] > max_node_weight) {
+              continue;
+            }
+            // the tie breaker is the same from either end of the edge, so
+            // the heaviest edge around both ends is proposed by both
+            uint64_t lo = std::min(n, e->dest);
+            uint64_t hi = std::max(n, e->dest);
+            std::pair<uint64_t, uint64_t> key{
+                e->weight, katana::StatelessRandom(round, (lo << 32) | hi)};
+            if (proposal[n] == kNone || key > best) {
+              best = key;
+              proposal[n] = e->dest;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::GAccumulator<uint64_t> matched;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          if (proposal[n] != kNone && proposal[proposal[n]] == n) {
+            match[n] = proposal[n];
+            matched += 1;
+          }
+        },
+        katana::no_stats());
+    if (matched.reduce() == 0) {
+      break;
+    }
+  }
+
+  // a pair is numbered after the lesser of its nodes
+  katana::NUMAArray<uint64_t> coarse_ids;
+  coarse_ids.allocateBlocked(num_nodes + 1);
+  coarse_ids[0] = 0;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        coarse_ids[n + 1] = match[n] == kNone || n < match[n];
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      coarse_ids.begin(), coarse_ids.end(), coarse_ids.begin());
+  uint32_t num_coarse = coarse_ids[num_nodes];
+
+  level->coarse_of.allocateBlocked(num_nodes);
+  katana::NUMAArray<uint32_t> first_of;
+  first_of.allocateBlocked(num_coarse);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        uint32_t first = match[n] == kNone ? n : std::min(n, match[n]);
+        level->coarse_of[n] = coarse_ids[first];
+        if (first == n) {
+          first_of[coarse_ids[n]] = n;
+        }
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<uint64_t> coarse_weights;
+  coarse_weights.allocateBlocked(num_coarse);
+  katana::NUMAArray<uint64_t> raw_offsets;
+  raw_offsets.allocateBlocked(num_coarse + 1);
+  raw_offsets[0] = 0;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_coarse),
+      [&](uint32_t c) {
+        uint32_t n = first_of[c];
+        coarse_weights[c] = weights[n];
+        raw_offsets[c + 1] = level->offsets[n + 1] - level->offsets[n];
+        if (uint32_t m = match[n]; m != kNone) {
+          coarse_weights[c] += weights[m];
+          raw_offsets[c + 1] += level->offsets[m + 1] - level->offsets[m];
+        }
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      raw_offsets.begin(), raw_offsets.end(), raw_offsets.begin());
+
+  katana::NUMAArray<WeightedEdge> raw_edges;
+  raw_edges.allocateBlocked(raw_offsets[num_coarse]);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_coarse),
+      [&](uint32_t c) {
+        uint64_t out = raw_offsets[c];
+        for (uint32_t n : {first_of[c], match[first_of[c]]}) {
+          if (n == kNone) {
+            continue;
+          }
+          for (const WeightedEdge* e = level->begin(n); e != level->end(n);
+               ++e) {
+            raw_edges[out++] =
+                WeightedEdge{level->coarse_of[e->dest], e->weight};
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return MakeLevel(std::move(coarse_weights), raw_offsets, &raw_edges);
+}
+
+/// Partition nodes, the nodes of level marked with stamp, into num_parts
+/// partitions numbered from first_part, by recursive bisection. Each half
+/// is grown from a seed, taking the node most connected to it next, and the
+/// half of the least cut out of kBisectionTries seeds is kept.
+void
+Bisect(
+    const Level& level, const std::vector<uint32_t>& nodes, uint32_t num_parts,
+    uint32_t first_part, std::vector<uint32_t>* marks, uint32_t* next_stamp,
+    katana::NUMAArray<uint32_t>* parts) {
+  if (num_parts == 1 || nodes.size() <= 1) {
+    for (uint32_t n : nodes) {
+      (*parts)[n] = first_part;
+    }
+    return;
+  }
+
+  uint32_t stamp = (*next_stamp)++;
+  uint64_t total = 0;
+  for (uint32_t n : nodes) {
+    (*marks)[n] = stamp;
+    total += level.node_weights[n];
+  }
+  uint32_t left_parts = num_parts / 2;
+  uint64_t target = total * left_parts / num_parts;
+
+  std::vector<uint32_t> best_region;
+  uint64_t best_cut = std::numeric_limits<uint64_t>::max();
+  std::vector<uint64_t> connection(level.NumNodes());
+  for (uint32_t t = 0; t < kBisectionTries; ++t) {
+    uint32_t region_stamp = (*next_stamp)++;
+    for (uint32_t n : nodes) {
+      connection[n] = 0;
+    }
+    std::vector<uint32_t> region;
+    uint64_t weight = 0;
+    std::priority_queue<std::pair<uint64_t, uint32_t>> frontier;
+    uint64_t start = katana::StatelessRandom(first_part, t) % nodes.size();
+    frontier.emplace(0, nodes[start]);
+    // nodes not connected to the region are taken in order once the
+    // frontier runs out
+    size_t next_unconnected = 0;
+    while (weight < target) {
+      uint32_t n = kNone;
+      while (!frontier.empty() && n == kNone) {
+        auto [conn, candidate] = frontier.top();
+        frontier.pop();
+        if ((*marks)[candidate] == stamp && conn == connection[candidate]) {
+          n = candidate;
+        }
+      }
+      while (n == kNone && next_unconnected < nodes.size()) {
+        if ((*marks)[nodes[next_unconnected]] == stamp) {
+          n = nodes[next_unconnected];
+        }
+        ++next_unconnected;
+      }
+      if (n == kNone) {
+        break;
+      }
+      (*marks)[n] = region_stamp;
+      region.emplace_back(n);
+      weight += level.node_weights[n];
+      for (const WeightedEdge* e = level.begin(n); e != level.end(n); ++e) {
+        if ((*marks)[e->dest] == stamp) {
+          connection[e->dest] += e->weight;
+          frontier.emplace(connection[e->dest], e->dest);
+        }
+      }
+    }
+
+    uint64_t cut = 0;
+    for (uint32_t n : region) {
+      for (const WeightedEdge* e = level.begin(n); e != level.end(n); ++e) {
+        if ((*marks)[e->dest] == stamp) {
+          cut += e->weight;
+        }
+      }
+    }
+    if (cut < best_cut) {
+      best_cut = cut;
+      best_region = region;
+    }
+    for (uint32_t n : region) {
+      (*marks)[n] = stamp;
+    }
+  }
+
+  uint32_t left_stamp = (*next_stamp)++;
+  for (uint32_t n : best_region) {
+    (*marks)[n] = left_stamp;
+  }
+  std::vector<uint32_t> right;
+  for (uint32_t n : nodes) {
+    if ((*marks)[n] == stamp) {
+      right.emplace_back(n);
+    }
+  }
+  Bisect(level, best_region, left_parts, first_part, marks, next_stamp, parts);
+  Bisect(
+      level, right, num_parts - left_parts, first_part + left_parts, marks,
+      next_stamp, parts);
+}
+
+std::vector<uint64_t>
+PartWeights(
+    const Level& level, const katana::NUMAArray<uint32_t>& parts,
+    uint32_t num_parts) {
+  katana::PerThreadStorage<std::vector<uint64_t>> local_weights;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, level.NumNodes()),
+      [&](uint32_t n) {
+        std::vector<uint64_t>& local = *local_weights.getLocal();
+        if (local.empty()) {
+          local.resize(num_parts, 0);
+        }
+        local[parts[n]] += level.node_weights[n];
+      },
+      katana::no_stats());
+  std::vector<uint64_t> weights(num_parts, 0);
+  for (unsigned t = 0; t < local_weights.size(); ++t) {
+    const std::vector<uint64_t>& local = *local_weights.getRemote(t);
+    for (size_t p = 0; p < local.size(); ++p) {
+      weights[p] += local[p];
+    }
+  }
+  return weights;
+}
+
+/// Collect a move of every node for which move(n, connections) returns one
+template <typename ChooseMove>
+std::vector<Move>
+CollectMoves(
+    const Level& level, const katana::NUMAArray<uint32_t>& parts,
+    const ChooseMove& choose_move) {
+  katana::PerThreadStorage<Connections> connections;
+  katana::PerThreadStorage<std::vector<Move>> local_moves;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, level.NumNodes()),
+      [&](uint32_t n) {
+        Connections& conn = *connections.getLocal();
+        conn.Clear();
+        for (const WeightedEdge* e = level.begin(n); e != level.end(n); ++e) {
+          conn.Add(parts[e->dest], e->weight);
+        }
+        Move move{0, n, parts[n], kNone};
+        if (choose_move(conn, &move)) {
+          local_moves.getLocal()->emplace_back(move);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Move> moves;
+  for (unsigned t = 0; t < local_moves.size(); ++t) {
+    const std::vector<Move>& local = *local_moves.getRemote(t);
+    moves.insert(moves.end(), local.begin(), local.end());
+  }
+  return moves;
+}
+
+/// Move nodes out of the partitions heavier than max_part_weight, those that
+/// lose the least cut first
+void
+Rebalance(
+    const Level& level, uint32_t num_parts, uint64_t max_part_weight,
+    katana::NUMAArray<uint32_t>* parts) {
+  for (uint32_t round = 0; round < kRebalanceRounds; ++round) {
+    std::vector<uint64_t> weights = PartWeights(level, *parts, num_parts);
+    if (*std::max_element(weights.begin(), weights.end()) <= max_part_weight) {
+      return;
+    }
+    uint32_t lightest =
+        std::min_element(weights.begin(), weights.end()) - weights.begin();
+
+    std::vector<Move> moves = CollectMoves(
+        level, *parts, [&](const Connections& conn, Move* move) {
+          uint64_t weight = level.node_weights[move->node];
+          if (weights[move->from] <= max_part_weight) {
+            return false;
+          }
+          uint64_t best = 0;
+          for (uint32_t p : conn.touched()) {
+            if (p != move->from && weights[p] + weight <= max_part_weight &&
+                (move->to == kNone || conn.Of(p) > best ||
+                 (conn.Of(p) == best && p < move->to))) {
+              best = conn.Of(p);
+              move->to = p;
+            }
+          }
+          if (move->to == kNone) {
+            if (lightest == move->from ||
+                weights[lightest] + weight > max_part_weight) {
+              return false;
+            }
+            move->to = lightest;
+          }
+          move->gain = int64_t(conn.Of(move->to)) - conn.Of(move->from);
+          return true;
+        });
+    katana::ParallelSTL::sort(
+        moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+          return a.gain != b.gain ? a.gain > b.gain : a.node < b.node;
+        });
+
+    bool moved = false;
+    for (const Move& move : moves) {
+      uint64_t weight = level.node_weights[move.node];
+      if (weights[move.from] > max_part_weight &&
+          weights[move.to] + weight <= max_part_weight) {
+        weights[move.from] -= weight;
+        weights[move.to] += weight;
+        (*parts)[move.node] = move.to;
+        moved = true;
+      }
+    }
+    if (!moved) {
+      return;
+    }
+  }
+}
+
+/// Move nodes to the neighboring partitions they are most connected to,
+/// those of the most gain first as long as the partitions do not get heavier
+/// than max_part_weight
+void
+Refine(
+    const Level& level, uint32_t num_parts, uint64_t max_part_weight,
+    uint32_t rounds, katana::NUMAArray<uint32_t>* parts) {
+  uint32_t rounds_without_moves = 0;
+  for (uint32_t round = 0; round < rounds && rounds_without_moves < 2;
+       ++round) {
+    std::vector<uint64_t> weights = PartWeights(level, *parts, num_parts);
+    bool upward = round % 2 == 0;
+
+    std::vector<Move> moves = CollectMoves(
+        level, *parts, [&](const Connections& conn, Move* move) {
+          for (uint32_t p : conn.touched()) {
+            if (upward ? p <= move->from : p >= move->from) {
+              continue;
+            }
+            int64_t gain = int64_t(conn.Of(p)) - conn.Of(move->from);
+            if (gain > move->gain || (gain == move->gain && gain > 0 &&
+                                      p < move->to)) {
+              move->gain = gain;
+              move->to = p;
+            }
+          }
+          return move->to != kNone && move->gain > 0;
+        });
+
+    // the moves to each partition, the most gain first
+    katana::ParallelSTL::sort(
+        moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+          if (a.to != b.to) {
+            return a.to < b.to;
+          }
+          return a.gain != b.gain ? a.gain > b.gain : a.node < b.node;
+        });
+    katana::GAccumulator<uint64_t> moved;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_parts),
+        [&](uint32_t p) {
+          auto it = std::lower_bound(
+              moves.begin(), moves.end(), p,
+              [](const Move& move, uint32_t part) { return move.to < part; });
+          uint64_t weight = weights[p];
+          for (; it != moves.end() && it->to == p; ++it) {
+            uint64_t node_weight = level.node_weights[it->node];
+            if (weight + node_weight <= max_part_weight) {
+              weight += node_weight;
+              (*parts)[it->node] = p;
+              moved += 1;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    rounds_without_moves = moved.reduce() == 0 ? rounds_without_moves + 1 : 0;
+  }
+}
+
+katana::NUMAArray<uint32_t>
+MultilevelPartition(
+    const katana::GraphTopology& topology, uint32_t num_parts,
+    const PartitionPlan& plan) {
+  std::vector<Level> levels;
+  levels.emplace_back(InputLevel(topology));
+
+  uint64_t total_weight = topology.NumNodes();
+  uint64_t coarsest =
+      std::max<uint64_t>(uint64_t{plan.coarsening_limit()} * num_parts, 1);
+  // nodes of the coarsest level much heavier than its average would make
+  // the initial partition hard to balance
+  uint64_t max_node_weight = std::max<uint64_t>(
+      2, std::ceil(1.5 * total_weight / std::min(coarsest, total_weight + 1)));
+  uint64_t max_part_weight = std::ceil(
+      (1 + plan.imbalance()) * ((total_weight + num_parts - 1) / num_parts));
+
+  while (levels.back().NumNodes() > coarsest) {
+    Level next = Coarsen(&levels.back(), max_node_weight);
+    if (next.NumNodes() > kMinCoarsening * levels.back().NumNodes()) {
+      break;
+    }
+    levels.emplace_back(std::move(next));
+  }
+
+  const Level& coarsest_level = levels.back();
+  katana::NUMAArray<uint32_t> parts;
+  parts.allocateBlocked(coarsest_level.NumNodes());
+  std::vector<uint32_t> nodes(coarsest_level.NumNodes());
+  std::iota(nodes.begin(), nodes.end(), 0);
+  std::vector<uint32_t> marks(coarsest_level.NumNodes(), 0);
+  uint32_t next_stamp = 1;
+  Bisect(coarsest_level, nodes, num_parts, 0, &marks, &next_stamp, &parts);
+
+  for (size_t l = levels.size(); l-- > 0;) {
+    const Level& level = levels[l];
+    if (l + 1 < levels.size()) {
+      katana::NUMAArray<uint32_t> fine_parts;
+      fine_parts.allocateBlocked(level.NumNodes());
+      katana::do_all(
+          katana::iterate(uint32_t{0}, level.NumNodes()),
+          [&](uint32_t n) { fine_parts[n] = parts[level.coarse_of[n]]; },
+          katana::no_stats());
+      parts = std::move(fine_parts);
+    }
+    Rebalance(level, num_parts, max_part_weight, &parts);
+    Refine(
+        level, num_parts, max_part_weight, plan.refinement_rounds(), &parts);
+  }
+  return parts;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Partition(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PartitionPlan plan) {
+  if (plan.algorithm() != PartitionPlan::kMultilevel) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm: {}",
+        plan.algorithm());
+  }
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no partitions requested");
+  }
+  if (plan.imbalance() < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "negative imbalance: {}",
+        plan.imbalance());
+  }
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("Partition");
+  exec_time.start();
+  katana::NUMAArray<uint32_t> parts =
+      MultilevelPartition(pg->topology(), num_partitions, plan);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodePartition>(n) = parts[n]; },
+      katana::no_stats());
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::PartitionAssertValid(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (graph.GetData<NodePartition>(n) >= num_partitions) {
+          out_of_range.update(true);
+        }
+      },
+      katana::no_stats());
+
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "found a node of a partition outside [0, {})", num_partitions);
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::PartitionStatistics::Print(std::ostream& os) const {
+  os << "Edge cut = " << edge_cut << std::endl;
+  os << "Nodes of the largest partition = " << largest_partition_size
+     << std::endl;
+  os << "Nodes of the smallest partition = " << smallest_partition_size
+     << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
+
+katana::Result<katana::analytics::PartitionStatistics>
+katana::analytics::PartitionStatistics::Compute(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  KATANA_CHECKED(PartitionAssertValid(pg, num_partitions, property_name));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::GAccumulator<uint64_t> edge_cut;
+  katana::PerThreadStorage<std::vector<uint64_t>> local_sizes;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        std::vector<uint64_t>& local = *local_sizes.getLocal();
+        if (local.empty()) {
+          local.resize(num_partitions, 0);
+        }
+        uint32_t part = graph.GetData<NodePartition>(n);
+        ++local[part];
+        for (auto e : graph.OutEdges(n)) {
+          if (graph.GetData<NodePartition>(graph.OutEdgeDst(e)) != part) {
+            edge_cut += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> sizes(num_partitions, 0);
+  for (unsigned t = 0; t < local_sizes.size(); ++t) {
+    const std::vector<uint64_t>& local = *local_sizes.getRemote(t);
+    for (size_t p = 0; p < local.size(); ++p) {
+      sizes[p] += local[p];
+    }
+  }
+  uint64_t largest = *std::max_element(sizes.begin(), sizes.end());
+  uint64_t smallest = *std::min_element(sizes.begin(), sizes.end());
+  double even_share = double(graph.NumNodes()) / num_partitions;
+  double imbalance = even_share > 0 ? largest / even_share - 1 : 0;
+  return PartitionStatistics{edge_cut.reduce(), largest, smallest, imbalance};
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::RenumberByPartition(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name, katana::TxnContext* txn_ctx,
+    std::vector<katana::PartitionMetadata>* metadata) {
+  KATANA_CHECKED(PartitionAssertValid(pg, num_partitions, property_name));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  // the nodes by partition and then by id
+  std::vector<uint64_t> keys(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        keys[n] = (uint64_t{graph.GetData<NodePartition>(n)} << 32) | n;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(keys.begin(), keys.end());
+  std::vector<katana::PropertyGraph::Node> order(keys.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, keys.size()),
+      [&](size_t i) { order[i] = keys[i] & 0xffffffff; }, katana::no_stats());
+
+  SubGraphProjection projection;
+  for (int32_t i = 0; i < pg->GetNumNodeProperties(); ++i) {
+    projection.node_properties.emplace_back(pg->GetNodePropertyName(i));
+  }
+  for (int32_t i = 0; i < pg->GetNumEdgeProperties(); ++i) {
+    projection.edge_properties.emplace_back(pg->GetEdgePropertyName(i));
+  }
+  std::unique_ptr<katana::PropertyGraph> renumbered =
+      KATANA_CHECKED(SubGraphExtraction(pg, order, projection, txn_ctx));
+
+  if (metadata == nullptr) {
+    return std::unique_ptr<katana::PropertyGraph>(std::move(renumbered));
+  }
+
+  // partition p is the nodes [begins[p], begins[p + 1]) of the new graph
+  std::vector<uint64_t> begins(num_partitions + 1, keys.size());
+  for (uint32_t p = 0; p < num_partitions; ++p) {
+    begins[p] = std::lower_bound(keys.begin(), keys.end(), uint64_t{p} << 32) -
+                keys.begin();
+  }
+
+  const katana::GraphTopology& topology = renumbered->topology();
+  katana::DynamicBitset mirrors;
+  mirrors.resize(topology.NumNodes());
+  metadata->assign(num_partitions, katana::PartitionMetadata{});
+  for (uint32_t p = 0; p < num_partitions; ++p) {
+    mirrors.reset();
+    katana::GAccumulator<uint64_t> num_edges;
+    katana::do_all(
+        katana::iterate(begins[p], begins[p + 1]),
+        [&](uint64_t n) {
+          for (auto e : topology.OutEdges(n)) {
+            uint64_t dest = topology.OutEdgeDst(e);
+            if (dest < begins[p] || dest >= begins[p + 1]) {
+              mirrors.set(dest);
+            }
+            num_edges += 1;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::PartitionMetadata& part = (*metadata)[p];
+    part.is_outgoing_edge_cut_ = true;
+    part.num_global_nodes_ = topology.NumNodes();
+    part.max_global_node_id_ = topology.NumNodes() - 1;
+    part.num_global_edges_ = topology.NumEdges();
+    part.num_edges_ = num_edges.reduce();
+    part.num_owned_ = begins[p + 1] - begins[p];
+    part.num_nodes_ = part.num_owned_ + mirrors.count();
+  }
+  return std::unique_ptr<katana::PropertyGraph>(std::move(renumbered));
+}
@@ -19,6 +19,24 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/ParquetWriter.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyColumn.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -29,6 +47,129 @@ namespace {
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
+/// The seed of the random streams of the walks; walk i draws from stream i
+constexpr uint64_t kWalkSeed = 5489;
+
+/// Builds the alias table of weights[0, size) by Vose's method into keep and
+/// aliases, with small and large as scratch, and returns the total weight;
+/// no table is built when it is 0
+double
+BuildAliasTable(
+    const double* weights, uint32_t size, double* keep, uint32_t* aliases,
+    std::vector<uint32_t>* small, std::vector<uint32_t>* large) {
+  double total = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    total += weights[i];
+  }
+  if (total == 0) {
+    return total;
+  }
+
+  // keep holds the weights scaled to an average of 1 until the slots are
+  // paired, underfull ones with overfull ones
+  for (uint32_t i = 0; i < size; ++i) {
+    keep[i] = weights[i] * size / total;
+    aliases[i] = i;
+    (keep[i] < 1 ? small : large)->emplace_back(i);
+  }
+  while (!small->empty() && !large->empty()) {
+    uint32_t s = small->back();
+    small->pop_back();
+    uint32_t l = large->back();
+    aliases[s] = l;
+    keep[l] -= 1 - keep[s];
+    if (keep[l] < 1) {
+      large->pop_back();
+      small->emplace_back(l);
+    }
+  }
+  // what is left is full up to rounding
+  for (uint32_t i : *small) {
+    keep[i] = 1;
+  }
+  for (uint32_t i : *large) {
+    keep[i] = 1;
+  }
+  small->clear();
+  large->clear();
+  return total;
+}
+
+/// Walker's alias tables of the out edges of every node, to sample an out
+/// edge in proportion to its weight in constant time. The tables of all the
+/// nodes share the edge ids of the graph; each is built by Vose's method.
+struct AliasTables {
+  /// Weight of every edge
+  katana::NUMAArray<double> weights;
+  /// Total weight of the out edges of every node
+  katana::NUMAArray<double> totals;
+  /// Probability of a slot picking its own edge rather than its alias
+  katana::NUMAArray<double> keep;
+  /// Every slot's alias, as an index among the out edges of its node
+  katana::NUMAArray<uint32_t> aliases;
+
+  /// Builds the tables from weights, which must be set
+  template <typename Graph>
+  void Build(const Graph& graph) {
+    totals.allocateBlocked(graph.NumNodes());
+    keep.allocateBlocked(graph.NumEdges());
+    aliases.allocateBlocked(graph.NumEdges());
+
+    katana::PerThreadStorage<std::vector<uint32_t>> smalls;
+    katana::PerThreadStorage<std::vector<uint32_t>> larges;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename Graph::Node n) {
+          auto edges = graph.OutEdges(n);
+          uint64_t first = *edges.begin();
+          totals[n] = BuildAliasTable(
+              weights.data() + first, edges.size(), keep.data() + first,
+              aliases.data() + first, smalls.getLocal(), larges.getLocal());
+        },
+        katana::steal(), katana::loopname("RandomWalks-AliasTables"));
+  }
+
+  /// The index, among the out edges starting at first_edge, of the edge
+  /// sampled by the given slot and fraction of the slot
+  uint32_t Pick(uint64_t first_edge, uint32_t slot, double fraction) const {
+    return fraction < keep[first_edge + slot] ? slot
+                                              : aliases[first_edge + slot];
+  }
+};
+
+template <typename EdgeWeightType>
+katana::Result<void>
+LoadEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    katana::NUMAArray<double>* weights) {
+  using EdgeWeight = katana::PODProperty<EdgeWeightType>;
+  using WeightGraph = katana::TypedPropertyGraphView<
+      SortedPropertyGraphView, std::tuple<>, std::tuple<EdgeWeight>>;
+  auto graph =
+      KATANA_CHECKED(WeightGraph::Make(pg, {}, {edge_weight_property_name}));
+
+  weights->allocateBlocked(graph.NumEdges());
+  katana::GAccumulator<uint64_t> invalid;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](typename WeightGraph::Node n) {
+        for (auto e : graph.OutEdges(n)) {
+          double weight = graph.template GetEdgeData<EdgeWeight>(e);
+          if (!(weight >= 0 && std::isfinite(weight))) {
+            invalid += 1;
+          }
+          (*weights)[e] = weight;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (uint64_t count = invalid.reduce(); count > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} edge weights are negative or not finite", count);
+  }
+  return katana::ResultSuccess();
+}
+
 struct Node2VecAlgo {
   using NodeData = std::tuple<>;
   using EdgeData = std::tuple<>;
@@ -38,7 +179,10 @@ struct Node2VecAlgo {
   using GNode = typename SortedGraphView::Node;
 
   const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  /// The edge weights to walk by, or null to walk every edge alike
+  const AliasTables* tables_;
+  Node2VecAlgo(const RandomWalksPlan& plan, const AliasTables* tables = nullptr)
+      : plan_(plan), tables_(tables) {}
 
   GNode FindSampleNeighbor(
       const SortedGraphView& graph, const GNode& n,
@@ -48,41 +192,53 @@ struct Node2VecAlgo {
     }
     double total_wt = degree[n];
 
-    uint32_t edge_index = std::floor(prob * total_wt);
+    double slot = prob * total_wt;
+    uint32_t edge_index = std::floor(slot);
     auto ei = graph.OutEdges(n).begin() + edge_index;
+    if (tables_) {
+      ei = graph.OutEdges(n).begin() +
+           tables_->Pick(
+               *graph.OutEdges(n).begin(), edge_index, slot - edge_index);
+    }
     return graph.OutEdgeDst(*ei);
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
+  /// The total weight of the edges from src to dst
+  double WeightTo(const SortedGraphView& graph, GNode src, GNode dst) const {
+    auto edges = graph.OutEdges(src);
+    auto e = std::lower_bound(
+        edges.begin(), edges.end(), dst,
+        [&](auto edge, GNode node) { return graph.OutEdgeDst(edge) < node; });
+    double weight = 0;
+    for (; e != edges.end() && graph.OutEdgeDst(*e) == dst; ++e) {
+      weight += tables_ ? tables_->weights[*e] : 1;
     }
+    return weight;
+  }
+
+  /// Generates the walks of ids [begin, end), walk idx starting from node
+  /// idx % graph.size(), and calls emit(idx, walk) with those that are not
+  /// empty. emit may take the contents of walk.
+  template <typename Emit>
+  void GraphRandomWalk(
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      uint64_t begin, uint64_t end, Emit emit) {
+    katana::PerThreadStorage<std::vector<uint32_t>> walk_buffers;
 
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
 
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    double lower_bound = 1.0;
-
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+    // Rejection sampling of the second order bias, after KnightKing: a
+    // candidate drawn by the first order weights is accepted with
+    // probability bias / upper_bound. The bias of the way back may be far
+    // above the others, so it is folded out of the bound and its excess is
+    // drawn on its own instead.
+    double upper_bound = std::max(1.0, prob_forward);
+    double lower_bound = std::min({1.0, prob_forward, prob_backward});
+    bool fold_backward = prob_backward > upper_bound;
 
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
+        katana::iterate(begin, end),
         [&](uint64_t idx) {
           GNode n = idx % graph.size();
 
@@ -91,14 +247,16 @@ struct Node2VecAlgo {
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          // a stream of its own makes a walk the same whatever thread
+          // takes it
+          katana::RandomStream random(kWalkSeed, idx);
 
-          std::vector<uint32_t> walk;
+          std::vector<uint32_t>& walk = *walk_buffers.getLocal();
+          walk.clear();
           walk.push_back(n);
 
           //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          double prob = random.NextDouble();
 
           //Assumption: All edges have weight 1
           auto nbr = FindSampleNeighbor(graph, n, degree, prob);
@@ -115,16 +273,26 @@ struct Node2VecAlgo {
             if (degree[curr] == 0) {
               break;
             }
+            if (fold_backward) {
+              double total_wt = tables_ ? tables_->totals[curr] : degree[curr];
+              double excess =
+                  (prob_backward - upper_bound) * WeightTo(graph, curr, prev);
+              double area = total_wt * upper_bound + excess;
+              if (random.NextDouble() * area < excess) {
+                walk.push_back(prev);
+                continue;
+              }
+            }
             //acceptance-rejection sampling
             while (true) {
               //sample x
-              double prob = (*dist)(*generator.getLocal());
+              double prob = random.NextDouble();
 
               auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
               KATANA_LOG_ASSERT(nbr < graph.NumNodes());
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
+              double y = random.NextDouble();
               y = y * upper_bound;
 
               if (y <= lower_bound) {
@@ -137,7 +305,7 @@ struct Node2VecAlgo {
 
                 //check if nbr is same as the previous node on this walk
                 if (nbr == prev) {
-                  alpha = prob_backward;
+                  alpha = std::min(prob_backward, upper_bound);
                 }  //check if nbr is also a neighbor of the previous node on this walk
                 else if (graph.HasEdge(prev, nbr)) {
                   alpha = 1.0;
@@ -154,21 +322,21 @@ struct Node2VecAlgo {
             }
           }
 
-          walks->push(std::move(walk));
+          emit(idx, walk);
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Node2vec walks"), katana::no_stats());
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
-    }
   }
 
   void operator()(
       const SortedGraphView& graph,
       katana::InsertBag<std::vector<uint32_t>>* walks,
       const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+    GraphRandomWalk(
+        graph, degree, 0, graph.size() * plan_.number_of_walks(),
+        [&](uint64_t, std::vector<uint32_t>& walk) {
+          walks->push(std::move(walk));
+        });
   }
 };
 
@@ -182,20 +350,195 @@ struct Edge2VecAlgo {
       SortedPropertyGraphView, NodeData, EdgeData>;
   using GNode = typename SortedGraphView::Node;
 
-  const RandomWalksPlan& plan_;
-  Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
-
-  //transition matrix
-  std::vector<std::vector<double>> transition_matrix_;
+  /// Sums over the walks of the number of edges of every type in them and of
+  /// the products of those numbers for every pair of types, from which the
+  /// types are correlated
+  struct TypeCounts {
+    uint64_t num_walks{0};
+    /// The sum for type i at i, and for types i and j at
+    /// num_types + i * num_types + j
+    std::vector<uint64_t> sums;
+    /// Scratch: the number of edges of every type in the walk being added,
+    /// and the types it has
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> seen;
+
+    /// Adds the types of a walk; only the pairs of types in it are touched
+    void Add(const std::vector<uint32_t>& types_walk, uint32_t num_types) {
+      if (sums.empty()) {
+        sums.resize(num_types + uint64_t{num_types} * num_types);
+        counts.resize(num_types);
+      }
+      for (uint32_t type : types_walk) {
+        if (counts[type]++ == 0) {
+          seen.emplace_back(type);
+        }
+      }
+      for (uint32_t i : seen) {
+        sums[i] += counts[i];
+        uint64_t* row = &sums[num_types + uint64_t{i} * num_types];
+        for (uint32_t j : seen) {
+          row[j] += uint64_t{counts[i]} * counts[j];
+        }
+      }
+      for (uint32_t i : seen) {
+        counts[i] = 0;
+      }
+      seen.clear();
+      ++num_walks;
+    }
 
-  void Initialize() {
-    transition_matrix_.resize(plan_.number_of_edge_types() + 1);
-    //initialize transition matrix
-    for (uint32_t i = 0; i <= plan_.number_of_edge_types(); i++) {
-      for (uint32_t j = 0; j <= plan_.number_of_edge_types(); j++) {
-        transition_matrix_[i].push_back(1.0);
+    void Merge(TypeCounts* other) {
+      if (other->sums.empty()) {
+        return;
       }
+      if (sums.empty()) {
+        std::swap(sums, other->sums);
+      } else {
+        for (size_t i = 0; i < sums.size(); ++i) {
+          sums[i] += other->sums[i];
+        }
+      }
+      num_walks += other->num_walks;
     }
+  };
+
+  /// The out edges of every node grouped by type, like EdgeTypeAwareTopology
+  /// groups them by entity type but for the type property of the walks. The
+  /// edges of a node are a run for each of its types: run k has the edges
+  /// edges[begins[k], begins[k + 1]) of type types[k], and the runs of node
+  /// n are [run_offsets[n], run_offsets[n + 1]).
+  struct TypeRuns {
+    katana::NUMAArray<uint64_t> run_offsets;
+    katana::NUMAArray<uint32_t> types;
+    katana::NUMAArray<uint64_t> begins;
+    katana::NUMAArray<uint64_t> edges;
+  };
+
+  const RandomWalksPlan& plan_;
+  Edge2VecAlgo(const RandomWalksPlan& plan)
+      : plan_(plan), num_types_(plan.number_of_edge_types() + 1) {}
+
+  /// The types are 0 to number_of_edge_types
+  uint32_t num_types_;
+  /// The weight of taking an edge of type j after one of type i, at
+  /// i * num_types_ + j
+  std::vector<double> transition_matrix_;
+  TypeRuns runs_;
+  /// Walker's alias tables of the runs of every node for every type of the
+  /// edge the walk came by, weighing each run by its size and the
+  /// transition weight of its type; the tables of node n start at
+  /// run_offsets[n] * num_types_, one after another
+  katana::NUMAArray<double> keep_;
+  katana::NUMAArray<uint32_t> aliases_;
+
+  void Initialize(const SortedGraphView& graph) {
+    transition_matrix_.assign(uint64_t{num_types_} * num_types_, 1.0);
+    BuildTypeRuns(graph);
+    keep_.allocateBlocked(runs_.types.size() * num_types_);
+    aliases_.allocateBlocked(runs_.types.size() * num_types_);
+  }
+
+  void BuildTypeRuns(const SortedGraphView& graph) {
+    uint64_t num_nodes = graph.NumNodes();
+    runs_.run_offsets.allocateBlocked(num_nodes + 1);
+    runs_.edges.allocateBlocked(graph.NumEdges());
+    runs_.run_offsets[0] = 0;
+    auto type_of = [&](uint64_t e) { return graph.GetEdgeData<EdgeType>(e); };
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto edges = graph.OutEdges(n);
+          uint64_t* first = runs_.edges.data() + *edges.begin();
+          uint64_t* last = first + edges.size();
+          std::iota(first, last, *edges.begin());
+          // stable, so that a run keeps the order of the destinations
+          std::stable_sort(first, last, [&](uint64_t a, uint64_t b) {
+            return type_of(a) < type_of(b);
+          });
+          uint64_t num_runs = 0;
+          for (uint64_t* e = first; e != last; ++e) {
+            KATANA_LOG_VASSERT(
+                type_of(*e) < num_types_, "edge type {} is out of range",
+                type_of(*e));
+            num_runs += e == first || type_of(*e) != type_of(*(e - 1));
+          }
+          runs_.run_offsets[n + 1] = num_runs;
+        },
+        katana::steal(), katana::loopname("Edge2vec type runs"));
+    katana::ParallelSTL::partial_sum(
+        runs_.run_offsets.begin(), runs_.run_offsets.end(),
+        runs_.run_offsets.begin());
+
+    uint64_t num_runs = runs_.run_offsets[num_nodes];
+    runs_.types.allocateBlocked(num_runs);
+    runs_.begins.allocateBlocked(num_runs + 1);
+    runs_.begins[num_runs] = graph.NumEdges();
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto edges = graph.OutEdges(n);
+          uint64_t run = runs_.run_offsets[n];
+          for (uint64_t i = *edges.begin(); i != *edges.end(); ++i) {
+            uint32_t type = type_of(runs_.edges[i]);
+            if (i == *edges.begin() || type != runs_.types[run - 1]) {
+              runs_.types[run] = type;
+              runs_.begins[run] = i;
+              ++run;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Rebuilds the alias tables of the runs from the transition matrix
+  void BuildTransitionTables() {
+    uint64_t num_nodes = runs_.run_offsets.size() - 1;
+    katana::PerThreadStorage<std::vector<double>> weights_local;
+    katana::PerThreadStorage<std::vector<uint32_t>> smalls;
+    katana::PerThreadStorage<std::vector<uint32_t>> larges;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t first_run = runs_.run_offsets[n];
+          uint32_t num_runs = runs_.run_offsets[n + 1] - first_run;
+          std::vector<double>& weights = *weights_local.getLocal();
+          weights.resize(num_runs);
+          for (uint32_t prev = 0; prev < num_types_; ++prev) {
+            const double* row = &transition_matrix_[prev * num_types_];
+            for (uint32_t r = 0; r < num_runs; ++r) {
+              uint64_t run = first_run + r;
+              weights[r] = (runs_.begins[run + 1] - runs_.begins[run]) *
+                           row[runs_.types[run]];
+            }
+            uint64_t table = first_run * num_types_ + prev * num_runs;
+            BuildAliasTable(
+                weights.data(), num_runs, keep_.data() + table,
+                aliases_.data() + table, smalls.getLocal(), larges.getLocal());
+          }
+        },
+        katana::steal(), katana::loopname("Edge2vec transition tables"));
+  }
+
+  /// Samples an out edge of n, choosing its type by the transition weights
+  /// after an edge of type prev, and returns its destination and type
+  std::pair<GNode, uint32_t> SampleNeighbor(
+      const SortedGraphView& graph, GNode n, uint32_t prev,
+      katana::RandomStream* random) const {
+    uint64_t first_run = runs_.run_offsets[n];
+    uint32_t num_runs = runs_.run_offsets[n + 1] - first_run;
+    uint64_t table = first_run * num_types_ + prev * num_runs;
+    uint32_t slot = random->NextBelow(num_runs);
+    uint64_t run = first_run + (random->NextDouble() < keep_[table + slot]
+                                    ? slot
+                                    : aliases_[table + slot]);
+
+    // every edge of the run alike
+    uint64_t begin = runs_.begins[run];
+    uint64_t size = runs_.begins[run + 1] - begin;
+    uint64_t e = runs_.edges[begin + random->NextBelow(size)];
+    return std::make_pair(graph.OutEdgeDst(e), runs_.types[run]);
   }
 
   std::pair<GNode, EdgeType::ViewType::value_type> FindSampleNeighbor(
@@ -215,17 +558,8 @@ struct Edge2VecAlgo {
   void GraphRandomWalk(
       const SortedGraphView& graph,
       katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
+      katana::PerThreadStorage<TypeCounts>* type_counts,
       const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
 
@@ -246,8 +580,7 @@ struct Edge2VecAlgo {
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          katana::RandomStream random(kWalkSeed, idx);
 
           std::vector<uint32_t> walk;
           std::vector<uint32_t> types_vec;
@@ -255,7 +588,7 @@ struct Edge2VecAlgo {
           walk.push_back(n);
 
           //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          double prob = random.NextDouble();
 
           //Assumption: All edges have weight 1
           auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
@@ -275,20 +608,14 @@ struct Edge2VecAlgo {
 
             uint32_t p1 = types_vec.back();  //last element of types_vec
 
-            //acceptance-rejection sampling
+            //acceptance-rejection sampling; the type is drawn by its
+            //transition weight already, so only the return and in-out
+            //biases are left to accept
             while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.NumNodes());
-
-              GNode nbr = nbr_type_pair.first;
-              EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
+              auto [nbr, p2] = SampleNeighbor(graph, curr, p1, &random);
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
+              double y = random.NextDouble();
               y = y * upper_bound;
 
               //compute transition probability
@@ -304,10 +631,9 @@ struct Edge2VecAlgo {
                 alpha = prob_forward;
               }
 
-              alpha = alpha * transition_matrix_[p1][p2];
               if (alpha >= y) {
                 //accept y
-                walk.push_back(std::move(nbr));
+                walk.push_back(nbr);
                 types_vec.push_back(p2);
                 break;
               }
@@ -315,127 +641,62 @@ struct Edge2VecAlgo {
 
           }  //end for
 
+          type_counts->getLocal()->Add(types_vec, num_types_);
           (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Edge2vec walks"), katana::no_stats());
   }
 
-  //compute the histogram of edge types for each walk
-  std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
-    std::vector<std::vector<uint32_t>> num_edge_types_walks;
-
-    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
-        per_thread_num_edge_types_walks;
-    katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
-          std::vector<uint32_t> num_edge_types(
-              plan_.number_of_edge_types() + 1, 0);
-
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
-          }
-
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
-        });
-
-    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
-           *per_thread_num_edge_types_walks.getRemote(j)) {
-        num_edge_types_walks.push_back(std::move(num_edge_types));
-      }
-    }
-
-    return num_edge_types_walks;
-  }
-
-  std::vector<std::vector<uint32_t>> TransformVectors(
-      const std::vector<std::vector<uint32_t>>& num_edge_types_walks) {
-    uint32_t rows = num_edge_types_walks.size();
-    std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks;
-    transformed_num_edge_types_walks.resize(plan_.number_of_edge_types() + 1);
-
-    katana::do_all(
-        katana::iterate(uint32_t(0), plan_.number_of_edge_types() + 1),
-        [&](uint32_t j) {
-          for (uint32_t i = 0; i < rows; i++) {
-            transformed_num_edge_types_walks[j].push_back(
-                num_edge_types_walks[i][j]);
-          }
-        });
-
-    return transformed_num_edge_types_walks;
-  }
-
-  std::vector<double> ComputeMeans(const std::vector<std::vector<uint32_t>>&
-                                       transformed_num_edge_types_walks) {
-    std::vector<double> means(plan_.number_of_edge_types() + 1);
-
-    for (uint32_t i = 1; i <= plan_.number_of_edge_types(); i++) {
-      uint32_t sum = 0;
-      for (auto n : transformed_num_edge_types_walks[i]) {
-        sum += n;
-      }
-
-      means[i] = ((double)sum) / (transformed_num_edge_types_walks[i].size());
+  /// Sums the counts of all the threads into those of thread 0, pairwise in
+  /// a tree
+  static TypeCounts& ReduceTypeCounts(
+      katana::PerThreadStorage<TypeCounts>* type_counts) {
+    uint32_t num_threads = katana::getActiveThreads();
+    for (uint32_t stride = 1; stride < num_threads; stride *= 2) {
+      katana::do_all(
+          katana::iterate(uint32_t{0}, num_threads),
+          [&](uint32_t t) {
+            if (t % (2 * stride) == 0 && t + stride < num_threads) {
+              type_counts->getRemote(t)->Merge(
+                  type_counts->getRemote(t + stride));
+            }
+          },
+          katana::no_stats());
     }
-
-    return means;
+    return *type_counts->getRemote(0);
   }
 
   double sigmoidCal(const double pears) {
     return 1 / (1 + exp(-pears));  //exact sig
   }
 
-  double pearsonCorr(
-      const uint32_t i, const uint32_t j,
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
-    const std::vector<uint32_t>& x = transformed_num_edge_types_walks[i];
-    const std::vector<uint32_t>& y = transformed_num_edge_types_walks[j];
-
-    double sum = 0.0;
-    double sig1 = 0.0;
-    double sig2 = 0.0;
-
-    for (uint32_t m = 0; m < x.size(); m++) {
-      sum += ((double)x[m] - means[i]) * ((double)y[m] - means[j]);
-      sig1 += ((double)x[m] - means[i]) * ((double)x[m] - means[i]);
-      sig2 += ((double)y[m] - means[j]) * ((double)y[m] - means[j]);
+  /// Sets the transition weight of every pair of types other than 0 to the
+  /// sigmoid of the Pearson correlation of their numbers over the walks
+  void ComputeTransitionMatrix(const TypeCounts& type_counts) {
+    if (type_counts.num_walks == 0) {
+      return;
     }
+    double num_walks = type_counts.num_walks;
+    const std::vector<uint64_t>& sums = type_counts.sums;
+    auto covariance = [&](uint32_t i, uint32_t j) {
+      double mean_i = sums[i] / num_walks;
+      double mean_j = sums[j] / num_walks;
+      return sums[num_types_ + uint64_t{i} * num_types_ + j] / num_walks -
+             mean_i * mean_j;
+    };
 
-    sum = sum / x.size();
-
-    sig1 = sig1 / x.size();
-    sig1 = sqrt(sig1);
-
-    sig2 = sig2 / x.size();
-    sig2 = sqrt(sig2);
-
-    double corr = sum / (sig1 * sig2);
-    return corr;
-  }
-
-  void ComputeTransitionMatrix(
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
     katana::do_all(
-        katana::iterate(uint32_t(1), plan_.number_of_edge_types() + 1),
+        katana::iterate(uint32_t(1), num_types_),
         [&](uint32_t i) {
-          for (uint32_t j = 1; j <= plan_.number_of_edge_types(); j++) {
-            double pearson_corr =
-                pearsonCorr(i, j, transformed_num_edge_types_walks, means);
-            double sigmoid = sigmoidCal(pearson_corr);
-
-            transition_matrix_[i][j] = sigmoid;
+          for (uint32_t j = 1; j < num_types_; j++) {
+            double sig = std::sqrt(covariance(i, i) * covariance(j, j));
+            // a type whose number never changes correlates with nothing
+            double pearson_corr = sig > 0 ? covariance(i, j) / sig : 0;
+            transition_matrix_[i * num_types_ + j] = sigmoidCal(pearson_corr);
           }
-        });
+        },
+        katana::no_stats());
   }
 
   void operator()(
@@ -444,25 +705,17 @@ struct Edge2VecAlgo {
       const katana::NUMAArray<uint64_t>& degree) {
     uint32_t iterations = plan_.max_iterations();
 
-    Initialize();
+    Initialize(graph);
 
     for (uint32_t iter = 0; iter < iterations; iter++) {
-      //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
-
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      BuildTransitionTables();
 
-      //Update transition matrix
-      std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
-
-      std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
-          TransformVectors(num_edge_types_walks);
-
-      std::vector<double> means =
-          ComputeMeans(transformed_num_edge_types_walks);
+      //E step; generate walks
+      katana::PerThreadStorage<TypeCounts> type_counts;
+      GraphRandomWalk(graph, walks, &type_counts, degree);
 
-      ComputeTransitionMatrix(transformed_num_edge_types_walks, means);
+      //M step; update transition matrix
+      ComputeTransitionMatrix(ReduceTypeCounts(&type_counts));
     }
   }
 };
@@ -477,51 +730,358 @@ InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
   });
 }
 
-}  //namespace
+/// The out degrees of graph for the walks, zero at the nodes whose out edges
+/// all weigh nothing so that walks end there
+template <typename Graph>
+static katana::NUMAArray<uint64_t>
+WalkDegrees(const Graph& graph, const AliasTables* tables) {
+  katana::NUMAArray<uint64_t> degree;
+  degree.allocateBlocked(graph.size());
+  InitializeDegrees(graph, &degree);
+  if (tables) {
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename Graph::Node n) {
+          if (tables->totals[n] == 0) {
+            degree[n] = 0;
+          }
+        },
+        katana::no_stats());
+  }
+  return degree;
+}
 
 template <typename Algorithm>
 static katana::Result<std::vector<std::vector<uint32_t>>>
 RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
+    const typename Algorithm::SortedGraphView& graph, Algorithm* algo,
+    const AliasTables* tables = nullptr) {
   katana::ReportPageAllocGuard page_alloc;
 
-  Algorithm algo(plan);
-
-  katana::NUMAArray<uint64_t> degree;
-  degree.allocateBlocked(graph.size());
-  InitializeDegrees(graph, &degree);
+  katana::NUMAArray<uint64_t> degree = WalkDegrees(graph, tables);
 
   katana::StatTimer execTime("RandomWalks");
   execTime.start();
   katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
+  (*algo)(graph, &walks, degree);
   execTime.stop();
 
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
+  std::vector<std::vector<uint32_t>> walks_in_vector(walks.size());
+  walks.MoveTo(walks_in_vector.begin());
   return walks_in_vector;
 }
 
+/// Stores the entity type of every edge in the new edge property
+/// property_name, for Edge2Vec to walk by
+static katana::Result<void>
+InitializeEdgeTypes(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    uint32_t number_of_edge_types) {
+  using EdgeData = Edge2VecAlgo::EdgeData;
+  // the property is temporary, so its transaction is too
+  katana::TxnContext txn_ctx;
+  KATANA_CHECKED(pg->ConstructEdgeProperties<EdgeData>(
+      &txn_ctx, {property_name}));
+  auto typed_graph =
+      KATANA_CHECKED((katana::TypedPropertyGraph<std::tuple<>, EdgeData>::Make(
+          pg, {}, {property_name})));
+
+  katana::GReduceMax<uint32_t> max_type;
+  katana::do_all(
+      katana::iterate(typed_graph.OutEdges()),
+      [&](auto e) {
+        uint32_t type = pg->GetTypeOfEdgeFromTopoIndex(e);
+        typed_graph.template GetEdgeData<Edge2VecAlgo::EdgeType>(e) = type;
+        max_type.update(type);
+      },
+      katana::steal(), katana::loopname("Edge2vec edge types"));
+  if (max_type.reduce() > number_of_edge_types) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge type {} is past the {} edge types of the plan",
+        max_type.reduce(), number_of_edge_types);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Loads the weights of edge_weight_property_name into tables and builds them
+static katana::Result<void>
+BuildAliasTables(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const Node2VecAlgo::SortedGraphView& graph, AliasTables* tables) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    KATANA_CHECKED(LoadEdgeWeights<uint32_t>(
+        pg, edge_weight_property_name, &tables->weights));
+    break;
+  case arrow::Int32Type::type_id:
+    KATANA_CHECKED(LoadEdgeWeights<int32_t>(
+        pg, edge_weight_property_name, &tables->weights));
+    break;
+  case arrow::UInt64Type::type_id:
+    KATANA_CHECKED(LoadEdgeWeights<uint64_t>(
+        pg, edge_weight_property_name, &tables->weights));
+    break;
+  case arrow::Int64Type::type_id:
+    KATANA_CHECKED(LoadEdgeWeights<int64_t>(
+        pg, edge_weight_property_name, &tables->weights));
+    break;
+  case arrow::FloatType::type_id:
+    KATANA_CHECKED(LoadEdgeWeights<float>(
+        pg, edge_weight_property_name, &tables->weights));
+    break;
+  case arrow::DoubleType::type_id:
+    KATANA_CHECKED(LoadEdgeWeights<double>(
+        pg, edge_weight_property_name, &tables->weights));
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+
+  // the weights were read through the same sorted view, so they are in its
+  // order of edges
+  KATANA_LOG_ASSERT(tables->weights.size() == graph.NumEdges());
+  tables->Build(graph);
+  return katana::ResultSuccess();
+}
+
+/// Packs walks laid out at a fixed stride, walk i at slots[i * stride] with
+/// lengths[i] nodes, into a list array of the walks that are not empty,
+/// reusing slots as the values when the walks fill it
+static std::shared_ptr<arrow::LargeListArray>
+PackWalks(
+    katana::NUMAArray<uint32_t>&& slots,
+    const katana::NUMAArray<uint32_t>& lengths, uint64_t stride) {
+  uint64_t num_slots = lengths.size();
+
+  // for every slot, the index of its walk and the offset of its values
+  katana::NUMAArray<uint64_t> list_index;
+  katana::NUMAArray<uint64_t> value_offset;
+  list_index.allocateBlocked(num_slots + 1);
+  value_offset.allocateBlocked(num_slots + 1);
+  list_index[0] = 0;
+  value_offset[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_slots),
+      [&](uint64_t i) {
+        list_index[i + 1] = lengths[i] > 0;
+        value_offset[i + 1] = lengths[i];
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      list_index.begin(), list_index.end(), list_index.begin());
+  katana::ParallelSTL::partial_sum(
+      value_offset.begin(), value_offset.end(), value_offset.begin());
+  uint64_t num_walks = list_index[num_slots];
+  uint64_t num_values = value_offset[num_slots];
+
+  katana::NUMAArray<int64_t> offsets;
+  offsets.allocateBlocked(num_walks + 1);
+  offsets[num_walks] = num_values;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_slots),
+      [&](uint64_t i) {
+        if (lengths[i] > 0) {
+          offsets[list_index[i]] = value_offset[i];
+        }
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<uint32_t> values;
+  if (num_values == num_slots * stride) {
+    values = std::move(slots);
+  } else {
+    values.allocateBlocked(num_values);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_slots),
+        [&](uint64_t i) {
+          std::copy_n(
+              &slots[i * stride], lengths[i], &values[0] + value_offset[i]);
+        },
+        katana::no_stats());
+  }
+
+  auto value_array = std::make_shared<arrow::UInt32Array>(
+      num_values,
+      std::make_shared<katana::NUMAArrayBuffer<uint32_t>>(std::move(values)));
+  return std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint32()), num_walks,
+      std::make_shared<katana::NUMAArrayBuffer<int64_t>>(std::move(offsets)),
+      value_array);
+}
+
+/// The Node2Vec walks of ids [begin, end) as a list array
+static std::shared_ptr<arrow::LargeListArray>
+Node2VecWalkBatch(
+    const Node2VecAlgo::SortedGraphView& graph, Node2VecAlgo* algo,
+    const katana::NUMAArray<uint64_t>& degree, uint64_t begin, uint64_t end,
+    uint32_t walk_length) {
+  // a walk has its start and at least one more node
+  uint64_t stride = std::max(walk_length, uint32_t{1}) + 1;
+  katana::NUMAArray<uint32_t> slots;
+  katana::NUMAArray<uint32_t> lengths;
+  slots.allocateBlocked((end - begin) * stride);
+  lengths.allocateBlocked(end - begin);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, end - begin),
+      [&](uint64_t i) { lengths[i] = 0; }, katana::no_stats());
+
+  algo->GraphRandomWalk(
+      graph, degree, begin, end,
+      [&](uint64_t idx, const std::vector<uint32_t>& walk) {
+        std::copy(walk.begin(), walk.end(), &slots[(idx - begin) * stride]);
+        lengths[idx - begin] = walk.size();
+      });
+  return PackWalks(std::move(slots), lengths, stride);
+}
+
+}  // namespace
+
 katana::Result<std::vector<std::vector<uint32_t>>>
 katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
     auto graph =
         KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    Node2VecAlgo algo(plan);
+    return RandomWalksWithWrap(graph, &algo);
   }
   case RandomWalksPlan::kEdge2Vec: {
-    TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
+    TemporaryPropertyGuard tmp_edge_prop{pg->EdgeMutablePropertyView()};
+    KATANA_CHECKED(InitializeEdgeTypes(
+        pg, tmp_edge_prop.name(), plan.number_of_edge_types()));
     auto graph = KATANA_CHECKED(
         Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    Edge2VecAlgo algo(plan);
+    return RandomWalksWithWrap(graph, &algo);
   }
   default:
     return ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<std::vector<std::vector<uint32_t>>>
+katana::analytics::RandomWalks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan) {
+  if (plan.algorithm() != RandomWalksPlan::kNode2Vec) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "weighted walks need the Node2Vec plan");
+  }
+
+  auto graph = KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
+  AliasTables tables;
+  KATANA_CHECKED(
+      BuildAliasTables(pg, edge_weight_property_name, graph, &tables));
+  Node2VecAlgo algo(plan, &tables);
+  return RandomWalksWithWrap(graph, &algo, &tables);
+}
+
+katana::Result<std::shared_ptr<arrow::LargeListArray>>
+katana::analytics::RandomWalksCompact(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan) {
+  if (plan.algorithm() != RandomWalksPlan::kNode2Vec) {
+    if (!edge_weight_property_name.empty()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "weighted walks need the Node2Vec plan");
+    }
+    // Edge2Vec learns from all the walks of a round at once, so they are
+    // gathered first
+    auto walks = KATANA_CHECKED(RandomWalks(pg, plan));
+    uint64_t stride = 0;
+    for (const auto& walk : walks) {
+      stride = std::max<uint64_t>(stride, walk.size());
+    }
+    katana::NUMAArray<uint32_t> slots;
+    katana::NUMAArray<uint32_t> lengths;
+    slots.allocateBlocked(walks.size() * stride);
+    lengths.allocateBlocked(walks.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, walks.size()),
+        [&](size_t i) {
+          std::copy(walks[i].begin(), walks[i].end(), &slots[i * stride]);
+          lengths[i] = walks[i].size();
+        },
+        katana::no_stats());
+    return PackWalks(std::move(slots), lengths, stride);
+  }
+
+  katana::ReportPageAllocGuard page_alloc;
+  auto graph = KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
+  AliasTables tables;
+  if (!edge_weight_property_name.empty()) {
+    KATANA_CHECKED(
+        BuildAliasTables(pg, edge_weight_property_name, graph, &tables));
+  }
+  const AliasTables* weights =
+      edge_weight_property_name.empty() ? nullptr : &tables;
+  Node2VecAlgo algo(plan, weights);
+  katana::NUMAArray<uint64_t> degree = WalkDegrees(graph, weights);
+
+  katana::StatTimer execTime("RandomWalks");
+  execTime.start();
+  auto walks = Node2VecWalkBatch(
+      graph, &algo, degree, 0, graph.size() * plan.number_of_walks(),
+      plan.walk_length());
+  execTime.stop();
+  return walks;
+}
+
+katana::Result<uint64_t>
+katana::analytics::RandomWalksToParquet(
+    PropertyGraph* pg, const std::string& path,
+    const std::string& edge_weight_property_name, RandomWalksPlan plan,
+    uint64_t walks_per_batch) {
+  if (plan.algorithm() != RandomWalksPlan::kNode2Vec) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "only Node2Vec walks can be generated a batch at a time");
+  }
+  if (walks_per_batch == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "walks_per_batch must be positive");
+  }
+
+  katana::ReportPageAllocGuard page_alloc;
+  auto graph = KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
+  AliasTables tables;
+  if (!edge_weight_property_name.empty()) {
+    KATANA_CHECKED(
+        BuildAliasTables(pg, edge_weight_property_name, graph, &tables));
+  }
+  const AliasTables* weights =
+      edge_weight_property_name.empty() ? nullptr : &tables;
+  Node2VecAlgo algo(plan, weights);
+  katana::NUMAArray<uint64_t> degree = WalkDegrees(graph, weights);
+
+  auto schema = arrow::schema(
+      {arrow::field("walk", arrow::large_list(arrow::uint32()))});
+  auto stream =
+      KATANA_CHECKED(katana::ParquetWriter::Stream::Make(path, schema));
+
+  katana::StatTimer execTime("RandomWalks");
+  execTime.start();
+  uint64_t total_walks = graph.size() * plan.number_of_walks();
+  for (uint64_t begin = 0; begin < total_walks; begin += walks_per_batch) {
+    uint64_t end = std::min(total_walks, begin + walks_per_batch);
+    auto walks = Node2VecWalkBatch(
+        graph, &algo, degree, begin, end, plan.walk_length());
+    KATANA_CHECKED(stream->Append(arrow::Table::Make(schema, {walks})));
+  }
+  execTime.stop();
+
+  uint64_t num_walks = stream->num_rows();
+  KATANA_CHECKED(stream->Finish());
+  return num_walks;
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::RandomWalksAssertValid(
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<>, std::tuple<>>;
+using GNode = BiDirGraphView::Node;
+using Query = std::pair<uint32_t, uint32_t>;
+
+/// One direction of a bidirectional search: the distances it has found and
+/// the nodes it is to expand next. A distance is only valid if its stamp is
+/// the version of the current query, so starting a query takes constant time
+/// rather than a pass over all nodes.
+template <typename Dist>
+struct SearchSide {
+  std::vector<Dist> dist;
+  std::vector<uint32_t> stamp;
+  /// Min heap of (distance, node) for Dijkstra
+  std::vector<std::pair<Dist, GNode>> heap;
+  /// Nodes of the last level and the level being found for BFS
+  std::vector<GNode> frontier;
+  std::vector<GNode> next;
+
+  bool Reached(GNode n, uint32_t version) const {
+    return stamp[n] == version;
+  }
+
+  void Set(GNode n, Dist d, uint32_t version) {
+    stamp[n] = version;
+    dist[n] = d;
+  }
+};
+
+/// The per thread state of point to point searches, allocated on the first
+/// query a thread runs and reused by all its later queries
+template <typename Dist>
+class PointToPointSearch {
+public:
+  static constexpr Dist kInfinity = std::numeric_limits<Dist>::max() / 4;
+
+  /// Bidirectional Dijkstra from s to t. Expands the side with the smaller
+  /// heap and stops once the least distances of the two heaps add up to at
+  /// least the shortest path found so far.
+  template <typename View, typename OutWeightFn, typename InWeightFn>
+  Dist Dijkstra(
+      const View& view, GNode s, GNode t, const OutWeightFn& out_w,
+      const InWeightFn& in_w) {
+    Start(view, s, t);
+    if (s == t) {
+      return 0;
+    }
+    auto cmp = std::greater<std::pair<Dist, GNode>>();
+    fwd_.heap.emplace_back(0, s);
+    bwd_.heap.emplace_back(0, t);
+    Dist best = kInfinity;
+
+    auto relax = [&](SearchSide<Dist>& side, const SearchSide<Dist>& other,
+                     GNode v, Dist new_dist) {
+      if (side.Reached(v, version_) && side.dist[v] <= new_dist) {
+        return;
+      }
+      side.Set(v, new_dist, version_);
+      side.heap.emplace_back(new_dist, v);
+      std::push_heap(side.heap.begin(), side.heap.end(), cmp);
+      if (other.Reached(v, version_)) {
+        best = std::min(best, new_dist + other.dist[v]);
+      }
+    };
+
+    while (!fwd_.heap.empty() && !bwd_.heap.empty()) {
+      if (fwd_.heap.front().first + bwd_.heap.front().first >= best) {
+        break;
+      }
+      bool forward = fwd_.heap.size() <= bwd_.heap.size();
+      SearchSide<Dist>& side = forward ? fwd_ : bwd_;
+      std::pop_heap(side.heap.begin(), side.heap.end(), cmp);
+      auto [d, u] = side.heap.back();
+      side.heap.pop_back();
+      if (d > side.dist[u]) {
+        continue;
+      }
+      ++num_expanded_;
+      if (forward) {
+        for (auto e : view.OutEdges(u)) {
+          relax(fwd_, bwd_, view.OutEdgeDst(e), d + out_w(e));
+        }
+      } else {
+        for (auto e : view.InEdges(u)) {
+          relax(bwd_, fwd_, view.InEdgeSrc(e), d + in_w(e));
+        }
+      }
+    }
+    return best;
+  }
+
+  /// Bidirectional BFS from s to t. Expands a whole level of the side with
+  /// the smaller frontier at a time; the first level that meets the other
+  /// side yields the shortest path.
+  template <typename View>
+  Dist Bfs(const View& view, GNode s, GNode t) {
+    Start(view, s, t);
+    if (s == t) {
+      return 0;
+    }
+    fwd_.frontier.emplace_back(s);
+    bwd_.frontier.emplace_back(t);
+    Dist best = kInfinity;
+
+    while (best == kInfinity && !fwd_.frontier.empty() &&
+           !bwd_.frontier.empty()) {
+      bool forward = fwd_.frontier.size() <= bwd_.frontier.size();
+      SearchSide<Dist>& side = forward ? fwd_ : bwd_;
+      const SearchSide<Dist>& other = forward ? bwd_ : fwd_;
+      auto visit = [&](GNode v, Dist new_dist) {
+        if (other.Reached(v, version_)) {
+          best = std::min(best, new_dist + other.dist[v]);
+        }
+        if (!side.Reached(v, version_)) {
+          side.Set(v, new_dist, version_);
+          side.next.emplace_back(v);
+        }
+      };
+      for (GNode u : side.frontier) {
+        ++num_expanded_;
+        Dist new_dist = side.dist[u] + 1;
+        if (forward) {
+          for (auto e : view.OutEdges(u)) {
+            visit(view.OutEdgeDst(e), new_dist);
+          }
+        } else {
+          for (auto e : view.InEdges(u)) {
+            visit(view.InEdgeSrc(e), new_dist);
+          }
+        }
+      }
+      std::swap(side.frontier, side.next);
+      side.next.clear();
+    }
+    return best;
+  }
+
+  /// Nodes this thread has expanded over all its queries
+  size_t num_expanded() const { return num_expanded_; }
+
+private:
+  template <typename View>
+  void Start(const View& view, GNode s, GNode t) {
+    if (fwd_.dist.size() != view.NumNodes()) {
+      for (SearchSide<Dist>* side : {&fwd_, &bwd_}) {
+        side->dist.assign(view.NumNodes(), kInfinity);
+        side->stamp.assign(view.NumNodes(), 0);
+      }
+      version_ = 0;
+    }
+    if (++version_ == 0) {
+      // wrapped around; stamps from 2^32 queries ago would look current
+      for (SearchSide<Dist>* side : {&fwd_, &bwd_}) {
+        std::fill(side->stamp.begin(), side->stamp.end(), 0);
+      }
+      version_ = 1;
+    }
+    for (SearchSide<Dist>* side : {&fwd_, &bwd_}) {
+      side->heap.clear();
+      side->frontier.clear();
+      side->next.clear();
+    }
+    fwd_.Set(s, 0, version_);
+    bwd_.Set(t, 0, version_);
+  }
+
+  SearchSide<Dist> fwd_;
+  SearchSide<Dist> bwd_;
+  uint32_t version_{0};
+  size_t num_expanded_{0};
+};
+
+/// Runs query_fn(search, s, t) for every query in parallel and converts the
+/// distances it returns to doubles
+template <typename Dist, typename QueryFn>
+std::vector<double>
+RunQueries(const std::vector<Query>& queries, const QueryFn& query_fn) {
+  constexpr Dist kInfinity = PointToPointSearch<Dist>::kInfinity;
+
+  std::vector<double> distances(queries.size());
+  katana::PerThreadStorage<PointToPointSearch<Dist>> searches;
+
+  katana::StatTimer exec_time("SsspPointToPoint");
+  exec_time.start();
+  katana::do_all(
+      katana::iterate(size_t{0}, queries.size()),
+      [&](size_t i) {
+        Dist d = query_fn(
+            *searches.getLocal(), queries[i].first, queries[i].second);
+        distances[i] = d == kInfinity ? std::numeric_limits<double>::infinity()
+                                      : static_cast<double>(d);
+      },
+      katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("SsspPointToPoint"));
+  exec_time.stop();
+
+  katana::GAccumulator<size_t> num_expanded;
+  katana::on_each([&](unsigned, unsigned) {
+    num_expanded += searches.getLocal()->num_expanded();
+  });
+  katana::ReportStatSingle(
+      "SsspPointToPoint", "Expanded nodes", num_expanded.reduce());
+  return distances;
+}
+
+template <typename Weight>
+katana::Result<std::vector<double>>
+WeightedQueries(
+    katana::PropertyGraph* pg, const std::vector<Query>& queries,
+    const std::string& edge_weight_property_name) {
+  using EdgeWeight = katana::PODProperty<Weight>;
+  using WeightedView = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::BiDirectional, std::tuple<>,
+      std::tuple<EdgeWeight>>;
+
+  auto view =
+      KATANA_CHECKED(WeightedView::Make(pg, {}, {edge_weight_property_name}));
+
+  // weights by edge property index, which both out and in edges map to
+  katana::NUMAArray<Weight> weights;
+  weights.allocateInterleaved(view.NumEdges());
+  katana::do_all(
+      katana::iterate(view),
+      [&](GNode n) {
+        for (auto e : view.OutEdges(n)) {
+          weights[view.GetEdgePropertyIndexFromOutEdge(e)] =
+              view.template GetEdgeData<EdgeWeight>(e);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto out_w = [&](auto e) {
+    return weights[view.GetEdgePropertyIndexFromOutEdge(e)];
+  };
+  auto in_w = [&](auto e) {
+    return weights[view.GetEdgePropertyIndexFromInEdge(e)];
+  };
+  return RunQueries<Weight>(
+      queries, [&](PointToPointSearch<Weight>& search, GNode s, GNode t) {
+        return search.Dijkstra(view, s, t, out_w, in_w);
+      });
+}
+
+}  // namespace
+
+katana::Result<std::vector<double>>
+katana::analytics::SsspPointToPoint(
+    PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::string& edge_weight_property_name) {
+  size_t num_nodes = pg->topology().NumNodes();
+  for (const Query& query : queries) {
+    if (query.first >= num_nodes || query.second >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query ({}, {}) is not in a graph of {} nodes", query.first,
+          query.second, num_nodes);
+    }
+  }
+
+  if (edge_weight_property_name.empty()) {
+    auto view = KATANA_CHECKED(BiDirGraphView::Make(pg, {}, {}));
+    return RunQueries<uint32_t>(
+        queries, [&](PointToPointSearch<uint32_t>& search, GNode s, GNode t) {
+          return search.Bfs(view, s, t);
+        });
+  }
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return WeightedQueries<uint32_t>(pg, queries, edge_weight_property_name);
+  case arrow::Int32Type::type_id:
+    return WeightedQueries<int32_t>(pg, queries, edge_weight_property_name);
+  case arrow::UInt64Type::type_id:
+    return WeightedQueries<uint64_t>(pg, queries, edge_weight_property_name);
+  case arrow::Int64Type::type_id:
+    return WeightedQueries<int64_t>(pg, queries, edge_weight_property_name);
+  case arrow::FloatType::type_id:
+    return WeightedQueries<float>(pg, queries, edge_weight_property_name);
+  case arrow::DoubleType::type_id:
+    return WeightedQueries<double>(pg, queries, edge_weight_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
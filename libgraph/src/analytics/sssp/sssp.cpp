@@ -19,10 +19,17 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "katana/PropertyColumn.h"
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/GpuAnalytics.h"
+#include "katana/analytics/Planner.h"
 #include "katana/gstl.h"
 
 using namespace katana::analytics;
@@ -69,6 +76,7 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
   using OBIMBarrier = typename katana::OrderedByIntegerMetric<
       UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  using MultiQueueWL = katana::MultiQueue<UpdateRequestIndexer>;
 
   template <typename T, typename OBIMTy = OBIM, typename P, typename R>
   static void DeltaStepAlgo(
@@ -400,6 +408,190 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
 
+  /// Picks the delta of delta stepping from a sample of the edge weights.
+  /// Buckets about as wide as a heavy edge weight over the average degree
+  /// (Meyer and Sanders) hold enough nodes to keep threads busy but little
+  /// work that is later redone. The 90th percentile of the sampled weights
+  /// stands in for the heaviest weight, which tends to be an outlier, and
+  /// buckets are at least as wide as a light edge so that light edges do not
+  /// all become heavy.
+  static unsigned ChooseDelta(
+      const Graph& graph, const katana::NUMAArray<Weight>& edge_data) {
+    constexpr size_t kNumSamples = 4096;
+    constexpr unsigned kMaxDelta = 30;
+
+    size_t num_edges = graph.NumEdges();
+    if (num_edges == 0) {
+      return SsspPlan::kDefaultDelta;
+    }
+
+    std::vector<double> samples;
+    samples.reserve(std::min(num_edges, kNumSamples));
+    size_t stride = std::max<size_t>(num_edges / kNumSamples, 1);
+    for (size_t e = 0; e < num_edges; e += stride) {
+      samples.emplace_back(std::max<double>(edge_data[e], 0));
+    }
+    auto quantile = [&](double q) {
+      auto it = samples.begin() + static_cast<size_t>(q * (samples.size() - 1));
+      std::nth_element(samples.begin(), it, samples.end());
+      return *it;
+    };
+    double heavy = quantile(0.9);
+    double light = quantile(0.1);
+    double average_degree =
+        std::max(static_cast<double>(num_edges) / graph.size(), 1.0);
+    double delta = std::max(heavy / average_degree, light);
+
+    unsigned shift = 0;
+    while (shift < kMaxDelta && std::ldexp(1.0, shift + 1) <= delta) {
+      ++shift;
+    }
+    return shift;
+  }
+
+  static void RadiusStepAlgo(
+      katana::NUMAArray<std::atomic<Weight>>* node_data,
+      katana::NUMAArray<Weight>* edge_data, Graph* graph,
+      const typename Graph::Node& source, unsigned radius_neighbors) {
+    using Node = typename Graph::Node;
+
+    // radius[n] is the weight of the radius_neighbors-th lightest out edge of
+    // n, or of its heaviest if it has fewer
+    katana::NUMAArray<Dist> radius;
+    radius.allocateInterleaved(graph->size());
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const Node& n) {
+          Dist lightest[SsspPlan::kMaxRadiusNeighbors];
+          unsigned num = 0;
+          for (auto e : graph->OutEdges(n)) {
+            Dist w = (*edge_data)[e];
+            if (num < radius_neighbors) {
+              lightest[num++] = w;
+              std::push_heap(lightest, lightest + num);
+            } else if (w < lightest[0]) {
+              std::pop_heap(lightest, lightest + num);
+              lightest[num - 1] = w;
+              std::push_heap(lightest, lightest + num);
+            }
+          }
+          radius[n] = num == 0 ? kDistanceInfinity : lightest[0];
+        },
+        katana::steal(), katana::no_stats(), katana::loopname("Radius"));
+
+    // stamp[n] is the last epoch in which n was put on a worklist, so that
+    // each worklist holds a node at most once
+    katana::NUMAArray<std::atomic<uint32_t>> stamp;
+    stamp.allocateInterleaved(graph->size());
+    katana::do_all(
+        katana::iterate(size_t{0}, graph->size()),
+        [&](size_t i) { stamp[i].store(0, std::memory_order_relaxed); },
+        katana::no_stats());
+    uint32_t epoch = 0;
+    auto first_in = [&](Node n) {
+      return stamp[n].exchange(epoch, std::memory_order_relaxed) != epoch;
+    };
+
+    katana::InsertBag<Node> pending;
+    katana::InsertBag<Node> live;
+    katana::InsertBag<Node> current;
+    katana::InsertBag<Node> next;
+    pending.push(source);
+
+    katana::GAccumulator<size_t> relaxed;
+    size_t rounds = 0;
+    size_t substeps = 0;
+    bool first_round = true;
+    Dist settled = 0;
+
+    while (!pending.empty()) {
+      // nodes within the bound of an earlier round are settled; of the
+      // others, the least distance plus radius bounds this round
+      ++epoch;
+      katana::GReduceMin<Dist> bound;
+      katana::do_all(
+          katana::iterate(pending),
+          [&](const Node& n) {
+            Dist d = (*node_data)[n];
+            if ((!first_round && d <= settled) || !first_in(n)) {
+              return;
+            }
+            live.push(n);
+            bound.update(d + radius[n]);
+          },
+          katana::no_stats(), katana::loopname("RadiusStepBound"));
+      pending.clear();
+      if (live.empty()) {
+        break;
+      }
+      ++rounds;
+      Dist bound_dist = bound.reduce();
+
+      ++epoch;
+      katana::do_all(
+          katana::iterate(live),
+          [&](const Node& n) {
+            if ((*node_data)[n] <= bound_dist) {
+              current.push(n);
+            } else {
+              pending.push(n);
+            }
+          },
+          katana::no_stats());
+      live.clear();
+
+      // Bellman-Ford substeps until no node within the bound improves
+      while (!current.empty()) {
+        ++substeps;
+        ++epoch;
+        katana::do_all(
+            katana::iterate(current),
+            [&](const Node& n) {
+              relaxed += 1;
+              Dist sdist = (*node_data)[n];
+              for (auto e : graph->OutEdges(n)) {
+                auto dest = graph->OutEdgeDst(e);
+                Dist new_dist = sdist + (*edge_data)[e];
+                Dist old_dist = katana::atomicMin((*node_data)[dest], new_dist);
+                if (new_dist >= old_dist) {
+                  continue;
+                }
+                if (new_dist > bound_dist) {
+                  pending.push(dest);
+                } else if (first_in(dest)) {
+                  next.push(dest);
+                }
+              }
+            },
+            katana::steal(), katana::no_stats(),
+            katana::loopname("RadiusStepRelax"));
+        std::swap(current, next);
+        next.clear();
+      }
+
+      settled = bound_dist;
+      first_round = false;
+    }
+
+    katana::GAccumulator<size_t> reached;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const Node& n) {
+          if ((*node_data)[n] < kDistanceInfinity) {
+            reached += 1;
+          }
+        },
+        katana::no_stats());
+
+    // relaxed nodes over reached nodes is the work inflation over Dijkstra
+    katana::ReportStatSingle("SSSP-RadiusStep", "rounds", rounds);
+    katana::ReportStatSingle("SSSP-RadiusStep", "substeps", substeps);
+    katana::ReportStatSingle(
+        "SSSP-RadiusStep", "relaxed nodes", relaxed.reduce());
+    katana::ReportStatSingle(
+        "SSSP-RadiusStep", "reached nodes", reached.reduce());
+  }
+
 public:
   katana::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
     if (start_node >= graph.size()) {
@@ -440,36 +632,47 @@ public:
     execTime.start();
 
     if (plan.algorithm() == SsspPlan::kAutomatic) {
-      plan = SsspPlan(&graph.GetPropertyGraph());
+      plan = ChooseSsspPlan(graph.GetPropertyGraph().GetGraphStatistics());
+    }
+
+    unsigned delta = plan.delta();
+    if (delta == SsspPlan::kAutomaticDelta) {
+      delta = ChooseDelta(graph, edge_data);
+      katana::ReportStatSingle("SSSP", "Delta", delta);
     }
 
     switch (plan.algorithm()) {
     case SsspPlan::kDeltaTile:
       DeltaStepAlgo<SrcEdgeTile>(
           &node_data, &edge_data, &graph, source,
-          SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), plan.delta());
+          SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), delta);
       break;
     case SsspPlan::kDeltaStep:
       DeltaStepAlgo<UpdateRequest>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
-          OutEdgeRangeFn{&graph}, plan.delta());
+          OutEdgeRangeFn{&graph}, delta);
       break;
     case SsspPlan::kDeltaStepBarrier:
       DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
-          OutEdgeRangeFn{&graph}, plan.delta());
+          OutEdgeRangeFn{&graph}, delta);
       break;
     case SsspPlan::kDeltaStepFusion:
-      DeltaStepFusionAlgo(&node_data, &edge_data, &graph, source, plan.delta());
+      DeltaStepFusionAlgo(&node_data, &edge_data, &graph, source, delta);
+      break;
+    case SsspPlan::kDeltaStepMultiQueue:
+      DeltaStepAlgo<UpdateRequest, MultiQueueWL>(
+          &node_data, &edge_data, &graph, source, ReqPushWrap(),
+          OutEdgeRangeFn{&graph}, delta);
       break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          delta);
       break;
     case SsspPlan::kSerialDelta:
       SerDeltaAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, delta);
       break;
     case SsspPlan::kDijkstraTile:
       DijkstraAlgo<SrcEdgeTile>(
@@ -485,6 +688,17 @@ public:
     case SsspPlan::kTopologicalTile:
       TopoTileAlgo(&graph, source);
       break;
+    case SsspPlan::kRadiusStep:
+      if (plan.radius_neighbors() == 0 ||
+          plan.radius_neighbors() > SsspPlan::kMaxRadiusNeighbors) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "radius neighbors must be between 1 and {}",
+            SsspPlan::kMaxRadiusNeighbors);
+      }
+      RadiusStepAlgo(
+          &node_data, &edge_data, &graph, source, plan.radius_neighbors());
+      break;
     default:
       return katana::ErrorCode::InvalidArgument;
     }
@@ -511,6 +725,56 @@ Sssp(
   return impl.SSSP(pg, start_node, plan);
 }
 
+template <typename Weight>
+katana::Result<void>
+SsspGpu(
+    katana::PropertyGraph* pg, size_t start_node,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  using EdgeWeight = SsspEdgeWeight<Weight>;
+  using WeightGraph =
+      katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeWeight>>;
+  constexpr Weight kDistanceInfinity =
+      SsspImplementation<Weight>::kDistanceInfinity;
+
+  if (start_node >= pg->NumNodes()) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  GpuAnalytics* gpu = KATANA_CHECKED(GetGpuAnalytics());
+  WeightGraph graph = KATANA_CHECKED(
+      WeightGraph::Make(pg, {}, {edge_weight_property_name}));
+
+  // the weights in the edge order of the default topology, which is the
+  // order the GPU uploads them in
+  katana::NUMAArray<Weight> weights;
+  weights.allocateInterleaved(pg->NumEdges());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const typename WeightGraph::Node& n) {
+        for (auto e : graph.OutEdges(n)) {
+          weights[e] = graph.template GetEdgeData<EdgeWeight>(e);
+        }
+      },
+      katana::no_stats());
+
+  auto distances =
+      katana::PropertyColumn<Weight>::MakeInterleaved(pg->NumNodes());
+  katana::do_all(
+      katana::iterate(size_t{0}, pg->NumNodes()),
+      [&](size_t n) { distances[n] = kDistanceInfinity; }, katana::no_stats());
+  distances[start_node] = 0;
+
+  katana::StatTimer exec_time("SSSP");
+  exec_time.start();
+  KATANA_CHECKED(gpu->Sssp(
+      pg, start_node, arrow::CTypeTraits<Weight>::ArrowType::type_id,
+      weights.data(), distances.values().data()));
+  exec_time.stop();
+
+  return pg->AddNodeProperty(
+      output_property_name, std::move(distances), txn_ctx);
+}
+
 template <typename Weight>
 static katana::Result<void>
 SSSPWithWrap(
@@ -518,6 +782,11 @@ SSSPWithWrap(
     const std::string& edge_weight_property_name,
     const std::string& output_property_name, SsspPlan plan,
     katana::TxnContext* txn_ctx) {
+  if (plan.architecture() == kGPU) {
+    return SsspGpu<Weight>(
+        pg, start_node, edge_weight_property_name, output_property_name,
+        txn_ctx);
+  }
   if (auto r =
           pg->ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
               txn_ctx, {output_property_name});
@@ -550,6 +819,8 @@ katana::analytics::Sssp(
     const std::string& edge_weight_property_name,
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     SsspPlan plan) {
+  auto pins = KATANA_CHECKED(PinnedProperties::Make(
+      pg, SsspPropertyRequirements(edge_weight_property_name)));
   switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
               ->type()
               ->id()) {
@@ -0,0 +1,623 @@
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+const int StronglyConnectedComponentsPlan::kChunkSize = 64;
+
+namespace {
+
+using ComponentType = uint64_t;
+struct NodeComponent : public katana::PODProperty<ComponentType> {};
+
+using NodeData = std::tuple<NodeComponent>;
+using EdgeData = std::tuple<>;
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, NodeData, EdgeData>;
+using GNode = Graph::Node;
+
+/// The component of the nodes that are not in one yet
+constexpr ComponentType kUnassigned = std::numeric_limits<ComponentType>::max();
+
+/// The decomposition of a graph in progress. Every node is either in a
+/// component, identified by one of its nodes until the end, or still active
+/// in a part of the graph. A part is a union of components, so the edges
+/// between parts are ignored. Part 3p + 1 is the nodes that a pivot p reached
+/// forward but not backward and part 3p + 2 the reverse; the nodes reached
+/// neither way keep their part.
+template <typename GraphTy>
+class Decomposition {
+public:
+  using Node = typename GraphTy::Node;
+
+  explicit Decomposition(const GraphTy& graph) : graph_(graph) {
+    size_t num_nodes = graph.NumNodes();
+    component_.allocateBlocked(num_nodes);
+    part_.allocateBlocked(num_nodes);
+    in_count_.allocateBlocked(num_nodes);
+    out_count_.allocateBlocked(num_nodes);
+    forward_.allocateBlocked(num_nodes);
+    backward_.allocateBlocked(num_nodes);
+    color_.allocateBlocked(num_nodes);
+    best_.allocateBlocked(3 * num_nodes);
+    active_ = std::make_unique<katana::InsertBag<Node>>();
+    katana::do_all(
+        katana::iterate(graph),
+        [&](Node n) {
+          component_[n].store(kUnassigned, std::memory_order_relaxed);
+          part_[n] = 0;
+          forward_[n].store(0, std::memory_order_relaxed);
+          backward_[n].store(0, std::memory_order_relaxed);
+          active_->push(n);
+        },
+        katana::no_stats());
+  }
+
+  bool empty() const { return active_->empty(); }
+  uint64_t rounds() const { return round_; }
+  uint64_t trimmed() const { return trimmed_; }
+
+  /// Removes the nodes without in or out edges in their part, which are
+  /// their own components, until every node left has both
+  void Trim() {
+    katana::InsertBag<Node> isolated;
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) {
+          uint32_t in = 0;
+          uint32_t out = 0;
+          for (auto e : graph_.OutEdges(n)) {
+            out += Linked(n, graph_.OutEdgeDst(e));
+          }
+          for (auto e : graph_.InEdges(n)) {
+            in += Linked(n, graph_.InEdgeSrc(e));
+          }
+          in_count_[n].store(in, std::memory_order_relaxed);
+          out_count_[n].store(out, std::memory_order_relaxed);
+          if (in == 0 || out == 0) {
+            isolated.push(n);
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::GAccumulator<uint64_t> trimmed;
+    katana::for_each(
+        katana::iterate(isolated),
+        [&](Node n, auto& ctx) {
+          if (!Claim(n, n)) {
+            return;
+          }
+          trimmed += 1;
+          for (auto e : graph_.OutEdges(n)) {
+            Node dst = graph_.OutEdgeDst(e);
+            if (Linked(n, dst) &&
+                in_count_[dst].fetch_sub(1, std::memory_order_relaxed) == 1) {
+              ctx.push(dst);
+            }
+          }
+          for (auto e : graph_.InEdges(n)) {
+            Node src = graph_.InEdgeSrc(e);
+            if (Linked(n, src) &&
+                out_count_[src].fetch_sub(1, std::memory_order_relaxed) == 1) {
+              ctx.push(src);
+            }
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::chunk_size<StronglyConnectedComponentsPlan::kChunkSize>(),
+        katana::loopname("StronglyConnectedComponents-Trim"));
+    trimmed_ += trimmed.reduce();
+    Compact();
+  }
+
+  /// Splits every part at a pivot: the pivot's component is the nodes of
+  /// the part that it reaches forward and backward, and the rest of the
+  /// part is split three ways by which of the two reached them
+  void ForwardBackward() {
+    uint32_t round = ++round_;
+
+    // the pivot of a part is its node with the most edges in the part, as
+    // the largest component is likely to have those
+    auto key = [&](Node n) {
+      uint64_t in = in_count_[n].load(std::memory_order_relaxed);
+      uint64_t out = out_count_[n].load(std::memory_order_relaxed);
+      uint64_t degree = (in + 1) * (out + 1);
+      return std::min<uint64_t>(degree, std::numeric_limits<uint32_t>::max())
+                 << 32 |
+             n;
+    };
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) { best_[part_[n]].store(0, std::memory_order_relaxed); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) { katana::atomicMax(best_[part_[n]], key(n)); },
+        katana::no_stats());
+    auto pivot = [&](Node n) -> Node {
+      return best_[part_[n]].load(std::memory_order_relaxed) &
+             std::numeric_limits<uint32_t>::max();
+    };
+
+    katana::InsertBag<Node> pivots;
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) {
+          if (pivot(n) == n) {
+            pivots.push(n);
+          }
+        },
+        katana::no_stats());
+
+    auto same_part = [](Node, Node) { return true; };
+    Reach(pivots, true, same_part, &forward_, round);
+    Reach(pivots, false, same_part, &backward_, round);
+
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) {
+          bool forward = forward_[n].load(std::memory_order_relaxed) == round;
+          bool backward = backward_[n].load(std::memory_order_relaxed) == round;
+          Node p = pivot(n);
+          if (forward && backward) {
+            component_[n].store(p, std::memory_order_relaxed);
+          } else if (forward) {
+            part_[n] = 3 * uint64_t{p} + 1;
+          } else if (backward) {
+            part_[n] = 3 * uint64_t{p} + 2;
+          }
+        },
+        katana::no_stats());
+    Compact();
+  }
+
+  /// Colors every node with the largest node that reaches it in its part;
+  /// the nodes of a color that reach the node of that color form its
+  /// component
+  void Color() {
+    uint32_t round = ++round_;
+
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) { color_[n].store(n, std::memory_order_relaxed); },
+        katana::no_stats());
+    katana::for_each(
+        katana::iterate(*active_),
+        [&](Node n, auto& ctx) {
+          Node color = color_[n].load(std::memory_order_relaxed);
+          for (auto e : graph_.OutEdges(n)) {
+            Node dst = graph_.OutEdgeDst(e);
+            if (Linked(n, dst) &&
+                katana::atomicMax(color_[dst], color) < color) {
+              ctx.push(dst);
+            }
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::chunk_size<StronglyConnectedComponentsPlan::kChunkSize>(),
+        katana::loopname("StronglyConnectedComponents-Color"));
+
+    katana::InsertBag<Node> roots;
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) {
+          if (color_[n].load(std::memory_order_relaxed) == n) {
+            roots.push(n);
+          }
+        },
+        katana::no_stats());
+    auto same_color = [&](Node a, Node b) {
+      return color_[a].load(std::memory_order_relaxed) ==
+             color_[b].load(std::memory_order_relaxed);
+    };
+    Reach(roots, false, same_color, &backward_, round);
+
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) {
+          if (backward_[n].load(std::memory_order_relaxed) == round) {
+            component_[n].store(
+                color_[n].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+    Compact();
+  }
+
+  /// The components, each identified by its least node
+  template <typename Fn>
+  void ForEachComponent(Fn fn) {
+    katana::NUMAArray<std::atomic<ComponentType>> least;
+    least.allocateBlocked(graph_.NumNodes());
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](Node n) { least[n].store(kUnassigned, std::memory_order_relaxed); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](Node n) {
+          katana::atomicMin(
+              least[component_[n].load(std::memory_order_relaxed)],
+              ComponentType{n});
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](Node n) {
+          fn(n, least[component_[n].load(std::memory_order_relaxed)].load(
+                    std::memory_order_relaxed));
+        },
+        katana::no_stats());
+  }
+
+private:
+  bool Active(Node n) const {
+    return component_[n].load(std::memory_order_relaxed) == kUnassigned;
+  }
+
+  /// Whether an edge between n and m, the latter possibly in a component
+  /// already, counts for the part of the active node n
+  bool Linked(Node n, Node m) const {
+    return m != n && Active(m) && part_[m] == part_[n];
+  }
+
+  bool Claim(Node n, ComponentType component) {
+    ComponentType expected = kUnassigned;
+    return component_[n].compare_exchange_strong(
+        expected, component, std::memory_order_relaxed);
+  }
+
+  /// Marks with round the nodes reached from seeds in their parts over out
+  /// edges, or in edges if not forward, and edges between nodes for which
+  /// linked holds
+  template <typename Predicate>
+  void Reach(
+      katana::InsertBag<Node>& seeds, bool forward, Predicate linked,
+      katana::NUMAArray<std::atomic<uint32_t>>* reached, uint32_t round) {
+    auto visit = [&](Node n, Node m, katana::InsertBag<Node>* next) {
+      if (Linked(n, m) && linked(n, m) &&
+          (*reached)[m].load(std::memory_order_relaxed) != round &&
+          (*reached)[m].exchange(round, std::memory_order_relaxed) != round) {
+        next->push(m);
+      }
+    };
+
+    katana::do_all(
+        katana::iterate(seeds),
+        [&](Node n) { (*reached)[n].store(round, std::memory_order_relaxed); },
+        katana::no_stats());
+    auto frontier = std::make_unique<katana::InsertBag<Node>>();
+    auto next = std::make_unique<katana::InsertBag<Node>>();
+    katana::InsertBag<Node>* current = &seeds;
+    while (!current->empty()) {
+      katana::do_all(
+          katana::iterate(*current),
+          [&](Node n) {
+            if (forward) {
+              for (auto e : graph_.OutEdges(n)) {
+                visit(n, graph_.OutEdgeDst(e), next.get());
+              }
+            } else {
+              for (auto e : graph_.InEdges(n)) {
+                visit(n, graph_.InEdgeSrc(e), next.get());
+              }
+            }
+          },
+          katana::steal(),
+          katana::loopname("StronglyConnectedComponents-Reach"));
+      frontier->clear();
+      std::swap(frontier, next);
+      current = frontier.get();
+    }
+  }
+
+  /// Drops the nodes that are in a component from the active nodes
+  void Compact() {
+    auto still_active = std::make_unique<katana::InsertBag<Node>>();
+    katana::do_all(
+        katana::iterate(*active_),
+        [&](Node n) {
+          if (Active(n)) {
+            still_active->push(n);
+          }
+        },
+        katana::no_stats());
+    std::swap(active_, still_active);
+  }
+
+  const GraphTy& graph_;
+  katana::NUMAArray<std::atomic<ComponentType>> component_;
+  katana::NUMAArray<uint64_t> part_;
+  katana::NUMAArray<std::atomic<uint32_t>> in_count_;
+  katana::NUMAArray<std::atomic<uint32_t>> out_count_;
+  /// The last round a node was reached in
+  katana::NUMAArray<std::atomic<uint32_t>> forward_;
+  katana::NUMAArray<std::atomic<uint32_t>> backward_;
+  katana::NUMAArray<std::atomic<Node>> color_;
+  /// The key of the pivot of every part
+  katana::NUMAArray<std::atomic<uint64_t>> best_;
+  std::unique_ptr<katana::InsertBag<Node>> active_;
+  uint32_t round_ = 0;
+  uint64_t trimmed_ = 0;
+};
+
+template <typename GraphTy>
+void
+Decompose(
+    Decomposition<GraphTy>* decomposition,
+    StronglyConnectedComponentsPlan plan) {
+  bool coloring =
+      plan.algorithm() == StronglyConnectedComponentsPlan::kColoring;
+  bool first = true;
+  while (true) {
+    decomposition->Trim();
+    if (decomposition->empty()) {
+      break;
+    }
+    if (coloring && !first) {
+      decomposition->Color();
+    } else {
+      decomposition->ForwardBackward();
+    }
+    first = false;
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, StronglyConnectedComponentsPlan plan) {
+  if (plan.algorithm() != StronglyConnectedComponentsPlan::kTrimFWBW &&
+      plan.algorithm() != StronglyConnectedComponentsPlan::kColoring) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::StatTimer exec_time("StronglyConnectedComponents");
+  exec_time.start();
+
+  Decomposition<Graph> decomposition(graph);
+  Decompose(&decomposition, plan);
+  decomposition.ForEachComponent([&](GNode n, ComponentType component) {
+    graph.GetData<NodeComponent>(n) = component;
+  });
+
+  exec_time.stop();
+
+  katana::ReportStatSingle(
+      "StronglyConnectedComponents", "Rounds", decomposition.rounds());
+  katana::ReportStatSingle(
+      "StronglyConnectedComponents", "Trimmed", decomposition.trimmed());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  size_t num_nodes = graph.NumNodes();
+  auto component = [&](GNode n) { return graph.GetData<NodeComponent>(n); };
+
+  katana::GAccumulator<uint64_t> misnamed;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        ComponentType c = component(n);
+        if (c > n || component(c) != c) {
+          misnamed += 1;
+        }
+      },
+      katana::no_stats());
+  if (uint64_t count = misnamed.reduce(); count > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} nodes are not in components named by their least node", count);
+  }
+
+  // every node is reached from and reaches the node naming its component
+  // within the component
+  for (bool forward : {true, false}) {
+    katana::NUMAArray<std::atomic<bool>> reached;
+    reached.allocateBlocked(num_nodes);
+    auto frontier = std::make_unique<katana::InsertBag<GNode>>();
+    auto next = std::make_unique<katana::InsertBag<GNode>>();
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          bool root = component(n) == n;
+          reached[n].store(root, std::memory_order_relaxed);
+          if (root) {
+            frontier->push(n);
+          }
+        },
+        katana::no_stats());
+    while (!frontier->empty()) {
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](GNode n) {
+            auto visit = [&](GNode m) {
+              if (component(m) == component(n) &&
+                  !reached[m].exchange(true, std::memory_order_relaxed)) {
+                next->push(m);
+              }
+            };
+            if (forward) {
+              for (auto e : graph.OutEdges(n)) {
+                visit(graph.OutEdgeDst(e));
+              }
+            } else {
+              for (auto e : graph.InEdges(n)) {
+                visit(graph.InEdgeSrc(e));
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+      frontier->clear();
+      std::swap(frontier, next);
+    }
+    katana::GAccumulator<uint64_t> unreached;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          if (!reached[n].load(std::memory_order_relaxed)) {
+            unreached += 1;
+          }
+        },
+        katana::no_stats());
+    if (uint64_t count = unreached.reduce(); count > 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "{} nodes are not strongly connected to their components", count);
+    }
+  }
+
+  // the edges between components form no cycle, so no components should
+  // have been merged: peel the components without edges in from others
+  katana::NUMAArray<std::atomic<uint64_t>> in_edges;
+  in_edges.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) { in_edges[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.InEdges(n)) {
+          if (component(graph.InEdgeSrc(e)) != component(n)) {
+            in_edges[component(n)].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // the members of every component, to walk the edges out of it
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<GNode> members;
+  offsets.allocateBlocked(num_nodes + 1);
+  members.allocateBlocked(num_nodes);
+  std::fill(offsets.begin(), offsets.end(), 0);
+  for (GNode n : graph) {
+    offsets[component(n) + 1] += 1;
+  }
+  for (size_t i = 0; i < num_nodes; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  {
+    std::vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (GNode n : graph) {
+      members[cursor[component(n)]++] = n;
+    }
+  }
+
+  std::vector<GNode> ready;
+  for (GNode n : graph) {
+    if (component(n) == n && in_edges[n].load() == 0) {
+      ready.emplace_back(n);
+    }
+  }
+  uint64_t peeled = 0;
+  while (!ready.empty()) {
+    GNode c = ready.back();
+    ready.pop_back();
+    peeled += 1;
+    for (uint64_t i = offsets[c]; i < offsets[c + 1]; ++i) {
+      for (auto e : graph.OutEdges(members[i])) {
+        ComponentType d = component(graph.OutEdgeDst(e));
+        if (d != c && in_edges[d].fetch_sub(1) == 1) {
+          ready.emplace_back(d);
+        }
+      }
+    }
+  }
+  uint64_t num_components = 0;
+  for (GNode n : graph) {
+    num_components += component(n) == n;
+  }
+  if (peeled != num_components) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} components are on cycles of other components",
+        num_components - peeled);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<StronglyConnectedComponentsStatistics>
+katana::analytics::StronglyConnectedComponentsStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using StatsGraph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+  StatsGraph graph = KATANA_CHECKED(StatsGraph::Make(pg, {property_name}, {}));
+
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(graph.size());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) { sizes[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        sizes[graph.GetData<NodeComponent>(n)].fetch_add(
+            1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  katana::GAccumulator<uint64_t> total_components;
+  katana::GAccumulator<uint64_t> non_trivial_components;
+  katana::GReduceMax<uint64_t> largest_component;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        uint64_t size = sizes[n].load(std::memory_order_relaxed);
+        if (size > 0) {
+          total_components += 1;
+        }
+        if (size > 1) {
+          non_trivial_components += 1;
+        }
+        largest_component.update(size);
+      },
+      katana::no_stats());
+
+  uint64_t largest_component_size = largest_component.reduce();
+  double largest_component_ratio = 0;
+  if (!graph.empty()) {
+    largest_component_ratio = double(largest_component_size) / graph.size();
+  }
+
+  return StronglyConnectedComponentsStatistics{
+      total_components.reduce(), non_trivial_components.reduce(),
+      largest_component_size, largest_component_ratio};
+}
+
+void
+katana::analytics::StronglyConnectedComponentsStatistics::Print(
+    std::ostream& os) const {
+  os << "Total number of components = " << total_components << std::endl;
+  os << "Total number of non trivial components = "
+     << total_non_trivial_components << std::endl;
+  os << "Number of nodes in the largest component = " << largest_component_size
+     << std::endl;
+  os << "Ratio of nodes in the largest component = " << largest_component_ratio
+     << std::endl;
+}
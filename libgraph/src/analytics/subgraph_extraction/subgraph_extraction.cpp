@@ -19,8 +19,20 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
-#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -33,34 +45,135 @@ using edge_iterator = boost::counting_iterator<uint64_t>;
 using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 using Node = SortedGraphView::Node;
 using Edge = SortedGraphView::Edge;
+using PropertyIndex = katana::GraphTopology::PropertyIndex;
+
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+
+/// The types a sub-graph keeps; all of them if a list is empty
+struct TypeFilter {
+  const katana::PropertyGraph* pg;
+  std::vector<katana::EntityTypeID> node_types;
+  std::vector<katana::EntityTypeID> edge_types;
+
+  static katana::Result<std::vector<katana::EntityTypeID>> TypeIDs(
+      const katana::EntityTypeManager& manager,
+      const std::vector<std::string>& names) {
+    std::vector<katana::EntityTypeID> ids;
+    for (const auto& name : names) {
+      if (!manager.HasAtomicType(name)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "type {} does not exist", name);
+      }
+      ids.emplace_back(manager.GetEntityTypeID(name));
+    }
+    return ids;
+  }
+
+  static katana::Result<TypeFilter> Make(
+      const katana::PropertyGraph* pg, const SubGraphProjection& projection) {
+    return TypeFilter{
+        pg,
+        KATANA_CHECKED(
+            TypeIDs(pg->GetNodeTypeManager(), projection.node_types)),
+        KATANA_CHECKED(
+            TypeIDs(pg->GetEdgeTypeManager(), projection.edge_types))};
+  }
 
+  bool KeepNode(Node n) const {
+    if (node_types.empty()) {
+      return true;
+    }
+    for (katana::EntityTypeID type : node_types) {
+      if (pg->DoesNodeHaveType(n, type)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool KeepEdge(PropertyIndex e) const {
+    if (edge_types.empty()) {
+      return true;
+    }
+    for (katana::EntityTypeID type : edge_types) {
+      if (pg->DoesEdgeHaveTypeFromPropertyIndex(e, type)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/// Copies the given rows of the named properties into a new table, one
+/// column per Take kernel, running the kernels in parallel
+template <typename GetProperty>
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::vector<std::string>& names, GetProperty get_property,
+    const katana::NUMAArray<PropertyIndex>& rows) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (const auto& name : names) {
+    columns.emplace_back(KATANA_CHECKED(get_property(name)));
+    fields.emplace_back(arrow::field(name, columns.back()->type()));
+  }
+
+  // the indices only have to live as long as the kernels, so they are
+  // wrapped rather than copied
+  auto indices = std::make_shared<arrow::UInt64Array>(
+      rows.size(), arrow::Buffer::Wrap(rows.data(), rows.size()));
+  std::vector<arrow::Result<arrow::Datum>> taken(columns.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, columns.size()),
+      [&](size_t i) {
+        taken[i] = arrow::compute::Take(
+            arrow::Datum(columns[i]), arrow::Datum(indices));
+      },
+      katana::steal(), katana::loopname("SubGraphExtraction-Take"));
+  for (size_t i = 0; i < columns.size(); ++i) {
+    columns[i] = KATANA_CHECKED(std::move(taken[i])).chunked_array();
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, rows.size());
+}
+
+/// The sub-graph of the nodes in node_set and the edges between them, in
+/// the order of node_set
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 SubGraphNodeSet(
-    const SortedGraphView& graph, const std::vector<Node>& node_set) {
+    katana::PropertyGraph* pg, const SortedGraphView& graph,
+    const std::vector<Node>& node_set, const TypeFilter& filter,
+    const SubGraphProjection& projection, katana::TxnContext* txn_ctx) {
   uint64_t num_nodes = node_set.size();
+
+  // the new ids of the nodes, looked up by binary search so that a small
+  // sub-graph of a large graph costs about as much as its own edges
+  std::vector<std::pair<Node, Node>> new_ids(num_nodes);
+  katana::do_all(
+      katana::iterate(Node(0), Node(num_nodes)),
+      [&](const Node& n) { new_ids[n] = {node_set[n], n}; },
+      katana::no_stats());
+  katana::ParallelSTL::sort(new_ids.begin(), new_ids.end());
+  auto new_id = [&](Node n) {
+    auto it = std::lower_bound(
+        new_ids.begin(), new_ids.end(), std::make_pair(n, Node(0)));
+    return it != new_ids.end() && it->first == n ? it->second : kNoNode;
+  };
+
   // Subgraph topology : out indices
   katana::NUMAArray<Edge> out_indices;
   out_indices.allocateInterleaved(num_nodes);
 
-  katana::gstl::Vector<katana::gstl::Vector<Node>> subgraph_edges;
-  subgraph_edges.resize(num_nodes);
-
   katana::do_all(
       katana::iterate(Node(0), Node(num_nodes)),
       [&](const Node& n) {
-        Node src = node_set[n];
-
-        auto last = graph.OutEdges(src).end();
-        for (Node m = 0; m < num_nodes; ++m) {
-          auto dest = node_set[m];
-          // Binary search on the edges sorted by destination id
-          for (auto edge_it = graph.FindEdge(src, dest);
-               edge_it != last && graph.OutEdgeDst(*edge_it) == dest;
-               ++edge_it) {
-            subgraph_edges[n].push_back(m);
+        Edge count = 0;
+        for (auto e : graph.OutEdges(node_set[n])) {
+          if (new_id(graph.OutEdgeDst(e)) != kNoNode &&
+              filter.KeepEdge(graph.GetEdgePropertyIndexFromOutEdge(e))) {
+            count += 1;
           }
         }
-        out_indices[n] = subgraph_edges[n].size();
+        out_indices[n] = count;
       },
       katana::steal(), katana::loopname("SubgraphExtraction"));
 
@@ -69,43 +182,111 @@ SubGraphNodeSet(
       out_indices.begin(), out_indices.end(), out_indices.begin());
   uint64_t num_edges = out_indices[num_nodes - 1];
 
-  // Subgraph topology : out dests
+  // Subgraph topology : out dests, sorted by their new ids and then by the
+  // edges they come from
   katana::NUMAArray<Node> out_dests;
+  katana::NUMAArray<PropertyIndex> edge_rows;
   out_dests.allocateInterleaved(num_edges);
+  edge_rows.allocateInterleaved(num_edges);
 
+  katana::PerThreadStorage<std::vector<std::pair<Node, PropertyIndex>>>
+      buffers;
   katana::do_all(
       katana::iterate(Node(0), Node(num_nodes)),
       [&](const Node& n) {
+        auto& edges = *buffers.getLocal();
+        edges.clear();
+        for (auto e : graph.OutEdges(node_set[n])) {
+          Node dest = new_id(graph.OutEdgeDst(e));
+          PropertyIndex row = graph.GetEdgePropertyIndexFromOutEdge(e);
+          if (dest != kNoNode && filter.KeepEdge(row)) {
+            edges.emplace_back(dest, row);
+          }
+        }
+        std::sort(edges.begin(), edges.end());
         uint64_t offset = n == 0 ? 0 : out_indices[n - 1];
-        for (Node dest : subgraph_edges[n]) {
+        for (const auto& [dest, row] : edges) {
           out_dests[offset] = dest;
+          edge_rows[offset] = row;
           offset++;
         }
       },
       katana::steal(), katana::loopname("ConstructTopology"));
 
+  katana::NUMAArray<PropertyIndex> node_rows;
+  katana::EntityTypeIDArray node_type_ids;
+  katana::EntityTypeIDArray edge_type_ids;
+  node_rows.allocateInterleaved(num_nodes);
+  node_type_ids.allocateInterleaved(num_nodes);
+  edge_type_ids.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(Node(0), Node(num_nodes)),
+      [&](const Node& n) {
+        node_rows[n] = graph.GetNodePropertyIndex(node_set[n]);
+        node_type_ids[n] = pg->GetTypeOfNode(node_set[n]);
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        edge_type_ids[e] = pg->GetTypeOfEdgeFromPropertyIndex(edge_rows[e]);
+      },
+      katana::no_stats());
+
   katana::GraphTopology sub_g_topo{
       std::move(out_indices), std::move(out_dests)};
-  auto sub_g_res = katana::PropertyGraph::Make(std::move(sub_g_topo));
+  auto sub_g = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(sub_g_topo), std::move(node_type_ids), std::move(edge_type_ids),
+      katana::EntityTypeManager{pg->GetNodeTypeManager()},
+      katana::EntityTypeManager{pg->GetEdgeTypeManager()}));
 
-  return sub_g_res;
+  if (!projection.node_properties.empty()) {
+    auto table = KATANA_CHECKED(TakeRows(
+        projection.node_properties,
+        [&](const std::string& name) { return pg->GetNodeProperty(name); },
+        node_rows));
+    KATANA_CHECKED(sub_g->AddNodeProperties(table, txn_ctx));
+  }
+  if (!projection.edge_properties.empty()) {
+    auto table = KATANA_CHECKED(TakeRows(
+        projection.edge_properties,
+        [&](const std::string& name) { return pg->GetEdgeProperty(name); },
+        edge_rows));
+    KATANA_CHECKED(sub_g->AddEdgeProperties(table, txn_ctx));
+  }
+
+  return sub_g;
 }
-}  // namespace
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::analytics::SubGraphExtraction(
-    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
-    SubGraphExtractionPlan plan) {
+/// The nodes of node_vec that exist and pass the filter, without
+/// duplicates, in the order they first appear
+katana::Result<std::vector<Node>>
+SelectNodes(
+    const katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    const TypeFilter& filter) {
   // Remove duplicates from the node vector
   std::unordered_set<uint32_t> set;
   std::vector<uint32_t> dedup_node_vec;
   for (auto n : node_vec) {
-    if (set.insert(n).second) {  // If n wasn't already present.
+    if (n >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} is not in a graph of {} nodes", n, pg->NumNodes());
+    }
+    if (filter.KeepNode(n) && set.insert(n).second) {
+      // If n wasn't already present.
       dedup_node_vec.push_back(n);
     }
   }
+  return dedup_node_vec;
+}
 
-  if (dedup_node_vec.empty()) {
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Extract(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_set,
+    const TypeFilter& filter, const SubGraphProjection& projection,
+    katana::TxnContext* txn_ctx, SubGraphExtractionPlan plan) {
+  if (node_set.empty()) {
     return std::make_unique<katana::PropertyGraph>();
   }
 
@@ -115,12 +296,78 @@ katana::analytics::SubGraphExtraction(
   switch (plan.algorithm()) {
   case SubGraphExtractionPlan::kNodeSet: {
     execTime.start();
-    auto subgraph = SubGraphNodeSet(sg, dedup_node_vec);
+    auto subgraph =
+        SubGraphNodeSet(pg, sg, node_set, filter, projection, txn_ctx);
     execTime.stop();
-    KATANA_LOG_DEBUG_ASSERT(subgraph);
-    return std::move(subgraph.value());
+    return subgraph;
   }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    SubGraphExtractionPlan plan) {
+  return SubGraphExtraction(pg, node_vec, {}, nullptr, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    const SubGraphProjection& projection, katana::TxnContext* txn_ctx,
+    SubGraphExtractionPlan plan) {
+  TypeFilter filter = KATANA_CHECKED(TypeFilter::Make(pg, projection));
+  std::vector<Node> node_set =
+      KATANA_CHECKED(SelectNodes(pg, node_vec, filter));
+  return Extract(pg, node_set, filter, projection, txn_ctx, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtractionKHop(
+    katana::PropertyGraph* pg, const std::vector<Node>& seeds, uint32_t hops,
+    const SubGraphProjection& projection, katana::TxnContext* txn_ctx,
+    SubGraphExtractionPlan plan) {
+  TypeFilter filter = KATANA_CHECKED(TypeFilter::Make(pg, projection));
+  std::vector<Node> node_set = KATANA_CHECKED(SelectNodes(pg, seeds, filter));
+
+  SortedGraphView sg = pg->BuildView<SortedGraphView>();
+
+  katana::StatTimer expandTime("SubGraph-Extraction-Expand");
+  expandTime.start();
+  katana::DynamicBitset visited;
+  visited.resize(pg->NumNodes());
+  for (Node n : node_set) {
+    visited.set(n);
+  }
+
+  // breadth first, over the edges and to the nodes that pass the filter;
+  // every level is sorted so that the ids do not depend on the schedule
+  size_t level_begin = 0;
+  for (uint32_t hop = 0; hop < hops && level_begin < node_set.size(); ++hop) {
+    size_t level_end = node_set.size();
+    katana::InsertBag<Node> next;
+    katana::do_all(
+        katana::iterate(node_set.begin() + level_begin, node_set.end()),
+        [&](Node src) {
+          for (auto e : sg.OutEdges(src)) {
+            Node dst = sg.OutEdgeDst(e);
+            if (!visited.test(dst) && filter.KeepNode(dst) &&
+                filter.KeepEdge(sg.GetEdgePropertyIndexFromOutEdge(e)) &&
+                !visited.set(dst)) {
+              next.push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("SubGraphExtraction-Expand"));
+    node_set.insert(node_set.end(), next.begin(), next.end());
+    std::sort(node_set.begin() + level_end, node_set.end());
+    level_begin = level_end;
+  }
+  expandTime.stop();
+
+  return Extract(pg, node_set, filter, projection, txn_ctx, plan);
+}
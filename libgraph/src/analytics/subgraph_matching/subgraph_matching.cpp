@@ -0,0 +1,566 @@
+#include "katana/analytics/subgraph_matching/subgraph_matching.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/SortedIntersection.h"
+#include "katana/Statistics.h"
+
+using katana::analytics::PatternEdge;
+using katana::analytics::SubgraphPattern;
+
+namespace {
+
+using View = katana::PropertyGraphViews::EdgesSortedByDestID;
+using Node = View::Node;
+
+/// The sorted neighbors of a node that are candidates for a pattern node
+using NeighborRange = std::pair<const Node*, size_t>;
+
+/// A typed edge between a pattern node and one matched before it
+struct TypedEdge {
+  /// The depth of the pattern node matched before
+  uint32_t depth;
+  /// Whether the edge goes from that pattern node rather than to it
+  bool from_earlier;
+  katana::EntityTypeID type;
+};
+
+/// A pattern node and what its matches must satisfy, with the pattern nodes
+/// matched before it given by the depths they are matched at
+struct Step {
+  uint32_t node;
+  uint32_t degree;
+  /// The pattern neighbors matched before, whose matches the match of node
+  /// must be a neighbor of
+  std::vector<uint32_t> parents;
+  std::vector<TypedEdge> typed_edges;
+  /// The symmetry breaking order: the match of node must have a larger id
+  /// than the matches of greater_than and a smaller one than those of
+  /// less_than
+  std::vector<uint32_t> greater_than;
+  std::vector<uint32_t> less_than;
+  bool has_node_type{false};
+  katana::EntityTypeID node_type{katana::kUnknownEntityType};
+};
+
+/// The same labels of pairs of pattern nodes and of pattern nodes are kept by
+/// its automorphisms. A typed edge is labeled by its type and direction, an
+/// untyped one by 1 and a missing one by 0.
+struct PatternLabels {
+  uint32_t num_nodes;
+  std::vector<uint32_t> edges;
+  std::vector<uint32_t> nodes;
+
+  uint32_t Edge(uint32_t a, uint32_t b) const {
+    return edges[a * num_nodes + b];
+  }
+};
+
+void
+FindAutomorphisms(
+    const PatternLabels& labels, std::vector<uint32_t>* perm,
+    std::vector<bool>* used, std::vector<std::vector<uint32_t>>* out) {
+  uint32_t pos = perm->size();
+  if (pos == labels.num_nodes) {
+    out->emplace_back(*perm);
+    return;
+  }
+  for (uint32_t v = 0; v < labels.num_nodes; ++v) {
+    if ((*used)[v] || labels.nodes[v] != labels.nodes[pos]) {
+      continue;
+    }
+    bool keeps_labels = true;
+    for (uint32_t a = 0; a < pos && keeps_labels; ++a) {
+      keeps_labels = labels.Edge(a, pos) == labels.Edge((*perm)[a], v) &&
+                     labels.Edge(pos, a) == labels.Edge(v, (*perm)[a]);
+    }
+    if (!keeps_labels) {
+      continue;
+    }
+    (*used)[v] = true;
+    perm->emplace_back(v);
+    FindAutomorphisms(labels, perm, used, out);
+    perm->pop_back();
+    (*used)[v] = false;
+  }
+}
+
+/// The order to match the pattern nodes in: each one after the one with the
+/// most pattern neighbors already matched, so that candidates come from the
+/// smallest intersections
+katana::Result<std::vector<uint32_t>>
+MatchingOrder(const PatternLabels& labels, const std::vector<uint32_t>& deg) {
+  uint32_t k = labels.num_nodes;
+  std::vector<bool> matched(k);
+  std::vector<uint32_t> order;
+  order.emplace_back(std::max_element(deg.begin(), deg.end()) - deg.begin());
+  matched[order[0]] = true;
+  while (order.size() < k) {
+    uint32_t best = k;
+    uint32_t best_links = 0;
+    for (uint32_t v = 0; v < k; ++v) {
+      if (matched[v]) {
+        continue;
+      }
+      uint32_t links = 0;
+      for (uint32_t u : order) {
+        links += labels.Edge(u, v) != 0;
+      }
+      if (links > best_links ||
+          (links == best_links && links > 0 && deg[v] > deg[best])) {
+        best = v;
+        best_links = links;
+      }
+    }
+    if (best == k) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "the pattern is not connected");
+    }
+    matched[best] = true;
+    order.emplace_back(best);
+  }
+  return order;
+}
+
+/// The steps to match pattern in, in order
+katana::Result<std::vector<Step>>
+CompilePattern(
+    const katana::PropertyGraph* pg, const SubgraphPattern& pattern) {
+  uint32_t k = pattern.num_nodes;
+  if (k < 2 || k > SubgraphPattern::kMaxNodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a pattern has 2 to {} nodes, not {}", SubgraphPattern::kMaxNodes, k);
+  }
+  if (!pattern.node_types.empty() && pattern.node_types.size() != k) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a pattern of {} nodes has {} node types", k,
+        pattern.node_types.size());
+  }
+
+  PatternLabels labels{
+      k, std::vector<uint32_t>(k * k), std::vector<uint32_t>(k)};
+  std::vector<katana::EntityTypeID> node_types(k, katana::kUnknownEntityType);
+  const katana::EntityTypeManager& node_manager = pg->GetNodeTypeManager();
+  for (uint32_t v = 0; v < pattern.node_types.size(); ++v) {
+    const std::string& name = pattern.node_types[v];
+    if (name.empty()) {
+      continue;
+    }
+    if (!node_manager.HasAtomicType(name)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "node type {} does not exist", name);
+    }
+    node_types[v] = node_manager.GetEntityTypeID(name);
+    labels.nodes[v] = node_types[v] + 1;
+  }
+
+  std::vector<uint32_t> degrees(k);
+  const katana::EntityTypeManager& edge_manager = pg->GetEdgeTypeManager();
+  for (const PatternEdge& edge : pattern.edges) {
+    if (edge.src >= k || edge.dst >= k || edge.src == edge.dst) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the pattern edge ({}, {}) is not between two of its {} nodes",
+          edge.src, edge.dst, k);
+    }
+    if (labels.Edge(edge.src, edge.dst) != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the pattern has more than one edge between {} and {}", edge.src,
+          edge.dst);
+    }
+    uint32_t forward = 1;
+    uint32_t backward = 1;
+    if (!edge.type.empty()) {
+      if (!edge_manager.HasAtomicType(edge.type)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "edge type {} does not exist",
+            edge.type);
+      }
+      katana::EntityTypeID type = edge_manager.GetEntityTypeID(edge.type);
+      forward = 2 * (type + 1);
+      backward = forward + 1;
+    }
+    labels.edges[edge.src * k + edge.dst] = forward;
+    labels.edges[edge.dst * k + edge.src] = backward;
+    ++degrees[edge.src];
+    ++degrees[edge.dst];
+  }
+
+  std::vector<uint32_t> order = KATANA_CHECKED(MatchingOrder(labels, degrees));
+  std::vector<uint32_t> depth_of(k);
+  for (uint32_t d = 0; d < k; ++d) {
+    depth_of[order[d]] = d;
+  }
+
+  std::vector<Step> steps(k);
+  for (uint32_t d = 0; d < k; ++d) {
+    Step& step = steps[d];
+    step.node = order[d];
+    step.degree = degrees[step.node];
+    step.has_node_type = node_types[step.node] != katana::kUnknownEntityType;
+    step.node_type = node_types[step.node];
+    for (uint32_t e = 0; e < d; ++e) {
+      uint32_t label = labels.Edge(order[e], step.node);
+      if (label == 0) {
+        continue;
+      }
+      step.parents.emplace_back(e);
+      if (label > 1) {
+        auto type = static_cast<katana::EntityTypeID>(label / 2 - 1);
+        step.typed_edges.emplace_back(TypedEdge{e, label % 2 == 0, type});
+      }
+    }
+  }
+
+  // Break the automorphisms as in Grochow and Kellis, Network Motif
+  // Discovery Using Subgraph Enumeration and Symmetry-Breaking, RECOMB 2007:
+  // the first node in matching order that some automorphism moves gets the
+  // smallest id of its orbit, and then only the automorphisms that fix it
+  // are left
+  std::vector<std::vector<uint32_t>> automorphisms;
+  {
+    std::vector<uint32_t> perm;
+    std::vector<bool> used(k);
+    FindAutomorphisms(labels, &perm, &used, &automorphisms);
+  }
+  std::vector<bool> smaller(k * k);
+  for (uint32_t v : order) {
+    if (automorphisms.size() <= 1) {
+      break;
+    }
+    for (const auto& automorphism : automorphisms) {
+      uint32_t u = automorphism[v];
+      if (u == v || smaller[v * k + u]) {
+        continue;
+      }
+      smaller[v * k + u] = true;
+      if (depth_of[v] < depth_of[u]) {
+        steps[depth_of[u]].greater_than.emplace_back(depth_of[v]);
+      } else {
+        steps[depth_of[v]].less_than.emplace_back(depth_of[u]);
+      }
+    }
+    automorphisms.erase(
+        std::remove_if(
+            automorphisms.begin(), automorphisms.end(),
+            [v](const auto& automorphism) { return automorphism[v] != v; }),
+        automorphisms.end());
+  }
+  return steps;
+}
+
+/// The state of the matches of one thread
+struct Scratch {
+  /// The match of the pattern node of each depth
+  std::vector<Node> match;
+  /// The neighbor lists intersected at each depth
+  std::vector<std::vector<NeighborRange>> lists;
+  /// Two intersection buffers for each depth
+  std::vector<std::vector<Node>> buffers;
+  /// A complete match, by pattern node
+  std::vector<Node> pattern_match;
+  uint64_t count{0};
+  std::vector<Node> matches;
+};
+
+/// Matches the steps of a pattern depth by depth, generic join style
+class Matcher {
+public:
+  Matcher(
+      const katana::PropertyGraph* pg, const View& view,
+      std::vector<Step> steps)
+      : pg_(pg), view_(view), steps_(std::move(steps)) {}
+
+  void InitScratch(Scratch* scratch) const {
+    scratch->match.resize(steps_.size());
+    scratch->pattern_match.resize(steps_.size());
+    scratch->lists.resize(steps_.size());
+    scratch->buffers.resize(2 * steps_.size());
+  }
+
+  /// Whether c may be matched to the pattern node at depth, given the
+  /// matches of the depths before, apart from being their neighbor
+  bool Accept(uint32_t depth, Node c, const std::vector<Node>& match) const {
+    const Step& step = steps_[depth];
+    for (uint32_t d = 0; d < depth; ++d) {
+      if (match[d] == c) {
+        return false;
+      }
+    }
+    if (view_.OutDegree(c) < step.degree) {
+      return false;
+    }
+    if (step.has_node_type && !pg_->DoesNodeHaveType(c, step.node_type)) {
+      return false;
+    }
+    for (const TypedEdge& edge : step.typed_edges) {
+      Node other = match[edge.depth];
+      if (!(edge.from_earlier ? HasEdgeOfType(other, c, edge.type)
+                              : HasEdgeOfType(c, other, edge.type))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Match the depths from depth on, given the matches of the ones before,
+  /// calling on_match with each complete match, in the pattern_match of
+  /// scratch, until it returns false.
+  /// Returns false if on_match did. If count_only, on_match is not called
+  /// and the matches are counted in scratch instead.
+  template <bool count_only, typename OnMatch>
+  bool Extend(uint32_t depth, Scratch* scratch, const OnMatch& on_match) const {
+    const Step& step = steps_[depth];
+    std::vector<Node>& match = scratch->match;
+    Node lo = 0;
+    auto hi = static_cast<Node>(view_.NumNodes());
+    for (uint32_t d : step.greater_than) {
+      lo = std::max(lo, match[d] + 1);
+    }
+    for (uint32_t d : step.less_than) {
+      hi = std::min(hi, match[d]);
+    }
+    if (lo >= hi) {
+      return true;
+    }
+
+    std::vector<NeighborRange>& lists = scratch->lists[depth];
+    lists.clear();
+    for (uint32_t d : step.parents) {
+      NeighborRange range = NeighborsIn(match[d], lo, hi);
+      if (range.second == 0) {
+        return true;
+      }
+      lists.emplace_back(range);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) {
+      return a.second < b.second;
+    });
+
+    bool last = depth + 1 == steps_.size();
+    if (count_only && last && !step.has_node_type &&
+        step.typed_edges.empty()) {
+      // every candidate but the matched nodes is a match, and any of them
+      // has the degree of the pattern node
+      scratch->count += CountCandidates(depth, scratch);
+      return true;
+    }
+
+    auto [candidates, num_candidates] = Intersect(
+        lists.data(), lists.size(), &scratch->buffers[2 * depth],
+        &scratch->buffers[2 * depth + 1]);
+    for (size_t i = 0; i < num_candidates; ++i) {
+      Node c = candidates[i];
+      if (!Accept(depth, c, match)) {
+        continue;
+      }
+      match[depth] = c;
+      if (!last) {
+        if (!Extend<count_only>(depth + 1, scratch, on_match)) {
+          return false;
+        }
+      } else if (count_only) {
+        ++scratch->count;
+      } else {
+        for (uint32_t d = 0; d < steps_.size(); ++d) {
+          scratch->pattern_match[steps_[d].node] = match[d];
+        }
+        if (!on_match(scratch)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+private:
+  /// The neighbors of n in [lo, hi)
+  NeighborRange NeighborsIn(Node n, Node lo, Node hi) const {
+    auto edges = view_.OutEdges(n);
+    const Node* first = view_.DestData() + *edges.begin();
+    const Node* last = first + edges.size();
+    first = std::lower_bound(first, last, lo);
+    last = std::lower_bound(first, last, hi);
+    return {first, last - first};
+  }
+
+  bool HasEdgeOfType(Node src, Node dst, katana::EntityTypeID type) const {
+    for (auto e : view_.FindAllEdges(src, dst)) {
+      if (pg_->DoesEdgeHaveTypeFromPropertyIndex(
+              view_.GetEdgePropertyIndexFromOutEdge(e), type)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// The nodes in all of the num_lists lists, which are sorted by size; the
+  /// only list or one of the buffers
+  static NeighborRange Intersect(
+      const NeighborRange* lists, size_t num_lists, std::vector<Node>* a,
+      std::vector<Node>* b) {
+    if (num_lists == 1) {
+      return lists[0];
+    }
+    NeighborRange result = lists[0];
+    for (size_t i = 1; i < num_lists; ++i) {
+      if (a->size() < result.second) {
+        a->resize(result.second);
+      }
+      size_t size = katana::SortedIntersection(
+          result.first, result.second, lists[i].first, lists[i].second,
+          a->data());
+      result = {a->data(), size};
+      std::swap(a, b);
+    }
+    return result;
+  }
+
+  /// The number of nodes in all lists of depth but the matched ones
+  uint64_t CountCandidates(uint32_t depth, Scratch* scratch) const {
+    const std::vector<NeighborRange>& lists = scratch->lists[depth];
+    uint64_t count = 0;
+    if (lists.size() == 1) {
+      count = lists[0].second;
+    } else {
+      auto [first, size] = Intersect(
+          lists.data(), lists.size() - 1, &scratch->buffers[2 * depth],
+          &scratch->buffers[2 * depth + 1]);
+      count = katana::SortedIntersectionCount(
+          first, size, lists.back().first, lists.back().second);
+    }
+    for (uint32_t d = 0; d < depth; ++d) {
+      Node u = scratch->match[d];
+      if (std::all_of(lists.begin(), lists.end(), [u](const auto& list) {
+            return std::binary_search(
+                list.first, list.first + list.second, u);
+          })) {
+        --count;
+      }
+    }
+    return count;
+  }
+
+  const katana::PropertyGraph* pg_;
+  const View& view_;
+  std::vector<Step> steps_;
+};
+
+/// Match pattern in pg in parallel from every node, calling on_match as in
+/// Matcher::Extend; returns the matches counted if count_only
+template <bool count_only, typename OnMatch>
+katana::Result<uint64_t>
+MatchSubgraphs(
+    katana::PropertyGraph* pg, const SubgraphPattern& pattern,
+    katana::PerThreadStorage<Scratch>* scratch, const OnMatch& on_match) {
+  std::vector<Step> steps = KATANA_CHECKED(CompilePattern(pg, pattern));
+  View view = pg->BuildView<View>();
+  Matcher matcher(pg, view, std::move(steps));
+  for (unsigned t = 0; t < scratch->size(); ++t) {
+    matcher.InitScratch(scratch->getRemote(t));
+  }
+
+  std::atomic<bool> stopped{false};
+  katana::do_all(
+      katana::iterate(view),
+      [&](Node n) {
+        if (stopped.load(std::memory_order_relaxed)) {
+          return;
+        }
+        Scratch* local = scratch->getLocal();
+        if (!matcher.Accept(0, n, local->match)) {
+          return;
+        }
+        local->match[0] = n;
+        if (!matcher.Extend<count_only>(1, local, on_match)) {
+          stopped.store(true, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::loopname("SubgraphMatching"));
+
+  uint64_t count = 0;
+  for (unsigned t = 0; t < scratch->size(); ++t) {
+    count += scratch->getRemote(t)->count;
+  }
+  return count;
+}
+
+}  // namespace
+
+SubgraphPattern
+SubgraphPattern::Clique(uint32_t k) {
+  SubgraphPattern pattern;
+  pattern.num_nodes = k;
+  for (uint32_t a = 0; a < k; ++a) {
+    for (uint32_t b = a + 1; b < k; ++b) {
+      pattern.edges.emplace_back(PatternEdge{a, b, ""});
+    }
+  }
+  return pattern;
+}
+
+SubgraphPattern
+SubgraphPattern::Cycle(uint32_t k) {
+  SubgraphPattern pattern = Path(k);
+  if (k > 2) {
+    pattern.edges.emplace_back(PatternEdge{k - 1, 0, ""});
+  }
+  return pattern;
+}
+
+SubgraphPattern
+SubgraphPattern::Path(uint32_t k) {
+  SubgraphPattern pattern;
+  pattern.num_nodes = k;
+  for (uint32_t a = 0; a + 1 < k; ++a) {
+    pattern.edges.emplace_back(PatternEdge{a, a + 1, ""});
+  }
+  return pattern;
+}
+
+katana::Result<uint64_t>
+katana::analytics::CountSubgraphMatches(
+    PropertyGraph* pg, const SubgraphPattern& pattern) {
+  katana::StatTimer exec_time("SubgraphMatching");
+  exec_time.start();
+  katana::PerThreadStorage<Scratch> scratch;
+  uint64_t count = KATANA_CHECKED(MatchSubgraphs<true>(
+      pg, pattern, &scratch, [](Scratch*) { return true; }));
+  exec_time.stop();
+  return count;
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::FindSubgraphMatches(
+    PropertyGraph* pg, const SubgraphPattern& pattern, uint64_t max_matches) {
+  katana::StatTimer exec_time("SubgraphMatching");
+  exec_time.start();
+  katana::PerThreadStorage<Scratch> scratch;
+  std::atomic<uint64_t> num_found{0};
+  KATANA_CHECKED(MatchSubgraphs<false>(
+      pg, pattern, &scratch, [&](Scratch* local) {
+        if (max_matches != 0 && num_found.fetch_add(1) >= max_matches) {
+          return false;
+        }
+        local->matches.insert(
+            local->matches.end(), local->pattern_match.begin(),
+            local->pattern_match.end());
+        return true;
+      }));
+
+  std::vector<uint32_t> matches;
+  for (unsigned t = 0; t < scratch.size(); ++t) {
+    const std::vector<Node>& local = scratch.getRemote(t)->matches;
+    matches.insert(matches.end(), local.begin(), local.end());
+  }
+  exec_time.stop();
+  return matches;
+}
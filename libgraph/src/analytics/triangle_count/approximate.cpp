@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/SortedIntersection.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "triangle_count-impl.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, std::tuple<>, std::tuple<>>;
+using GNode = Graph::Node;
+
+/// Graphs with at most this many edges are counted exactly; larger ones
+/// start with enough colors to sample about this many edges
+constexpr uint64_t kMinSampleEdges = 1 << 20;
+
+/// The edges of the graph between nodes of the same color, each pointing
+/// from the endpoint of lower degree (ties broken by id) to the other and
+/// each list sorted by destination without duplicates. Every triangle of
+/// the sample is then found exactly once, from its lowest node, and the
+/// lists to intersect are short even at hubs.
+struct Sample {
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> sizes;
+  katana::NUMAArray<GNode> dsts;
+
+  const GNode* begin(GNode n) const { return &dsts[0] + offsets[n]; }
+  uint32_t size(GNode n) const { return sizes[n]; }
+
+  void Build(const Graph& graph, uint64_t num_colors, uint64_t seed) {
+    size_t num_nodes = graph.NumNodes();
+    auto color = [&](GNode n) {
+      return katana::StatelessRandom(seed, n) % num_colors;
+    };
+    auto kept = [&](GNode src, GNode dst) {
+      if (src == dst || color(src) != color(dst)) {
+        return false;
+      }
+      size_t src_degree = graph.OutDegree(src);
+      size_t dst_degree = graph.OutDegree(dst);
+      return src_degree < dst_degree || (src_degree == dst_degree && src < dst);
+    };
+
+    offsets.allocateInterleaved(num_nodes + 1);
+    offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          uint64_t count = 0;
+          for (auto e : graph.OutEdges(n)) {
+            count += kept(n, graph.OutEdgeDst(e));
+          }
+          offsets[n + 1] = count;
+        },
+        katana::steal(), katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        &offsets[1], &offsets[0] + num_nodes + 1, &offsets[1]);
+
+    sizes.allocateInterleaved(num_nodes);
+    dsts.allocateInterleaved(offsets[num_nodes]);
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          GNode* first = &dsts[0] + offsets[n];
+          GNode* last = first;
+          for (auto e : graph.OutEdges(n)) {
+            GNode dst = graph.OutEdgeDst(e);
+            if (kept(n, dst)) {
+              *last++ = dst;
+            }
+          }
+          std::sort(first, last);
+          sizes[n] = std::unique(first, last) - first;
+        },
+        katana::steal(), katana::no_stats());
+  }
+};
+
+/// The triangles of the sample. If local_counts is not null, also adds the
+/// triangles of every node to local_counts.
+uint64_t
+CountSampled(
+    const Sample& sample, size_t num_nodes,
+    katana::NUMAArray<std::atomic<uint64_t>>* local_counts) {
+  katana::GAccumulator<uint64_t> num_triangles;
+  katana::PerThreadStorage<std::vector<GNode>> buffers;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](GNode u) {
+        const GNode* u_dsts = sample.begin(u);
+        uint32_t u_size = sample.size(u);
+        uint64_t local = 0;
+        for (uint32_t i = 0; i < u_size; ++i) {
+          GNode v = u_dsts[i];
+          if (!local_counts) {
+            local += katana::SortedIntersectionCount(
+                u_dsts, u_size, sample.begin(v), sample.size(v));
+            continue;
+          }
+          std::vector<GNode>& common = *buffers.getLocal();
+          common.resize(std::min(u_size, sample.size(v)));
+          size_t num_common = katana::SortedIntersection(
+              u_dsts, u_size, sample.begin(v), sample.size(v), common.data());
+          if (num_common == 0) {
+            continue;
+          }
+          local += num_common;
+          (*local_counts)[v].fetch_add(num_common, std::memory_order_relaxed);
+          for (size_t j = 0; j < num_common; ++j) {
+            (*local_counts)[common[j]].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+        if (local_counts && local) {
+          (*local_counts)[u].fetch_add(local, std::memory_order_relaxed);
+        }
+        num_triangles += local;
+      },
+      katana::steal(), katana::loopname("TriangleCount_Approximate"));
+  return num_triangles.reduce();
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+TriangleCountApproximate(
+    katana::PropertyGraph* pg, const TriangleCountPlan& plan,
+    katana::NUMAArray<std::atomic<uint64_t>>* local_counts) {
+  double relative_error = plan.relative_error();
+  if (!(relative_error >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "relative error {} must not be negative", relative_error);
+  }
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+  size_t num_nodes = graph.NumNodes();
+
+  katana::StatTimer exec_time("TriangleCount", "TriangleCount");
+  exec_time.start();
+
+  if (local_counts) {
+    local_counts->allocateInterleaved(num_nodes);
+  }
+
+  // the sampled count is about Poisson, so its relative standard error is
+  // 1 / sqrt(sampled) and 1 / relative_error^2 sampled triangles are enough
+  double min_sampled =
+      relative_error > 0 ? 1 / (relative_error * relative_error) : 0;
+  uint64_t num_colors = 1;
+  if (relative_error > 0) {
+    num_colors = std::max<uint64_t>(graph.NumEdges() / kMinSampleEdges, 1);
+  }
+
+  uint64_t sampled = 0;
+  uint32_t attempts = 0;
+  while (true) {
+    if (local_counts) {
+      katana::do_all(
+          katana::iterate(size_t{0}, num_nodes),
+          [&](GNode n) { (*local_counts)[n] = 0; }, katana::no_stats());
+    }
+    Sample sample;
+    sample.Build(graph, num_colors, attempts++);
+    sampled = CountSampled(sample, num_nodes, local_counts);
+    if (num_colors == 1 || sampled >= min_sampled) {
+      break;
+    }
+    // the sample grows with the square of 1 / num_colors, so aim for
+    // min_sampled right away, but at least halve the colors
+    double target = num_colors * std::sqrt((sampled + 1) / min_sampled);
+    num_colors = std::clamp<uint64_t>(target, 1, num_colors / 2);
+  }
+
+  uint64_t scale = num_colors * num_colors;
+  if (local_counts && scale > 1) {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](GNode n) { (*local_counts)[n] = (*local_counts)[n] * scale; },
+        katana::no_stats());
+  }
+
+  exec_time.stop();
+
+  katana::ReportStatSingle("TriangleCount", "Colors", num_colors);
+  katana::ReportStatSingle("TriangleCount", "Attempts", attempts);
+  katana::ReportStatSingle("TriangleCount", "SampledTriangles", sampled);
+  return sampled * scale;
+}
+
+katana::Result<uint64_t>
+katana::analytics::TriangleCountLocal(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, TriangleCountPlan plan) {
+  if (plan.algorithm() != TriangleCountPlan::kApproximate) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "local triangle counts need the approximate plan");
+  }
+
+  using NodeData = std::tuple<TriangleCountLocalCount>;
+  using CountGraph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, NodeData, std::tuple<>>;
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+  CountGraph graph =
+      KATANA_CHECKED(CountGraph::Make(pg, {output_property_name}, {}));
+
+  katana::NUMAArray<std::atomic<uint64_t>> local_counts;
+  uint64_t total =
+      KATANA_CHECKED(TriangleCountApproximate(pg, plan, &local_counts));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        graph.GetData<TriangleCountLocalCount>(n) = local_counts[n];
+      },
+      katana::no_stats());
+  return total;
+}
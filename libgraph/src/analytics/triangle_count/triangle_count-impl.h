@@ -0,0 +1,17 @@
+#ifndef KATANA_LIBGRAPH_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNTIMPL_H_
+#define KATANA_LIBGRAPH_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNTIMPL_H_
+
+#include <atomic>
+
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+/// The kApproximate plan of TriangleCount. If local_counts is not null, it is
+/// allocated and filled with the estimated count of every node.
+katana::Result<uint64_t> TriangleCountApproximate(
+    katana::PropertyGraph* pg,
+    const katana::analytics::TriangleCountPlan& plan,
+    katana::NUMAArray<std::atomic<uint64_t>>* local_counts);
+
+#endif
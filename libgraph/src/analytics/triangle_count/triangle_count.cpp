@@ -19,15 +19,27 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include <optional>
+#include <type_traits>
+
+#include "katana/SortedIntersection.h"
+#include "katana/analytics/GpuAnalytics.h"
 #include "katana/analytics/Utils.h"
+#include "triangle_count-impl.h"
 
 using namespace katana::analytics;
 
 using SortedGraphView =
     katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+using HubBitmapGraphView = katana::PropertyGraphViews::
+    NodesSortedByDegreeEdgesSortedByDestIDHubBitmaps;
 using Node = SortedGraphView::Node;
 using edge_iterator = SortedGraphView::edge_iterator;
 
+/// Whether intersections with high degree nodes can use their bitmaps
+template <typename G>
+constexpr bool kHasHubBitmaps = std::is_same_v<G, HubBitmapGraphView>;
+
 constexpr static const unsigned kChunkSize = 16U;
 
 /**
@@ -60,28 +72,22 @@ LowerBound(Iterator first, Iterator last, Compare comp) {
 }
 
 /**
- * std::set_intersection over edge_iterators.
+ * Size of the intersection of the destinations of two sorted edge ranges, as
+ * std::set_intersection counts it when the ranges have parallel edges.
  */
 template <typename G>
 size_t
 CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = g.OutEdgeDst(*aa);
-    typename G::Node b = g.OutEdgeDst(*bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
+    const G& g, bool has_parallel_edges, typename G::edge_iterator aa,
+    typename G::edge_iterator ea, typename G::edge_iterator bb,
+    typename G::edge_iterator eb) {
+  const typename G::Node* dsts = g.DestData();
+  if (has_parallel_edges) {
+    return katana::SortedMultisetIntersectionCount(
+        dsts + *aa, std::distance(aa, ea), dsts + *bb, std::distance(bb, eb));
   }
-  return retval;
+  return katana::SortedIntersectionCount(
+      dsts + *aa, std::distance(aa, ea), dsts + *bb, std::distance(bb, eb));
 }
 
 template <typename G>
@@ -116,8 +122,9 @@ struct GreaterThanOrEqual {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-NodeIteratingAlgo(const SortedGraphView* graph) {
+NodeIteratingAlgo(const Graph* graph) {
   katana::GAccumulator<size_t> numTriangles;
 
   katana::do_all(
@@ -128,18 +135,26 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
         edge_iterator first = graph->OutEdges(n).begin();
         edge_iterator last = graph->OutEdges(n).end();
         edge_iterator ea =
-            LowerBound(first, last, LessThan<SortedGraphView>(*graph, n));
-        edge_iterator bb = LowerBound(
-            first, last, GreaterThanOrEqual<SortedGraphView>(*graph, n));
+            LowerBound(first, last, LessThan<Graph>(*graph, n));
+        edge_iterator bb =
+            LowerBound(first, last, GreaterThanOrEqual<Graph>(*graph, n));
 
         for (; bb != last; ++bb) {
           Node B = graph->OutEdgeDst(*bb);
           for (auto aa = first; aa != ea; ++aa) {
             Node A = graph->OutEdgeDst(*aa);
+            if constexpr (kHasHubBitmaps<Graph>) {
+              if (graph->IsHub(A)) {
+                if (graph->HasEdge(A, B)) {
+                  numTriangles += 1;
+                }
+                continue;
+              }
+            }
             edge_iterator vv = graph->OutEdges(A).begin();
             edge_iterator ev = graph->OutEdges(A).end();
             edge_iterator it =
-                LowerBound(vv, ev, LessThan<SortedGraphView>(*graph, B));
+                LowerBound(vv, ev, LessThan<Graph>(*graph, B));
             if (it != ev && graph->OutEdgeDst(*it) == B) {
               numTriangles += 1;
             }
@@ -155,9 +170,10 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
 /**
  * Lambda function to count triangles
  */
+template <typename Graph>
 void
 OrderedCountFunc(
-    const SortedGraphView* graph, Node n,
+    const Graph* graph, Node n,
     katana::GAccumulator<size_t>& numTriangles) {
   size_t numTriangles_local = 0;
   for (auto edges_n : graph->OutEdges(n)) {
@@ -165,6 +181,12 @@ OrderedCountFunc(
     if (v >= n) {
       break;
     }
+    if constexpr (kHasHubBitmaps<Graph>) {
+      if (graph->IsHub(n) || graph->IsHub(v)) {
+        numTriangles_local += graph->CountCommonNeighbors(n, v, 0, v);
+        continue;
+      }
+    }
     edge_iterator it_n = graph->OutEdges(n).begin();
 
     for (auto edges_v : graph->OutEdges(v)) {
@@ -191,8 +213,9 @@ OrderedCountFunc(
 /*
  * Simple counting loop, instead of binary searching.
  */
+template <typename Graph>
 size_t
-OrderedCountAlgo(const SortedGraphView* graph) {
+OrderedCountAlgo(const Graph* graph) {
   katana::GAccumulator<size_t> numTriangles;
   katana::do_all(
       katana::iterate(*graph),
@@ -216,8 +239,9 @@ OrderedCountAlgo(const SortedGraphView* graph) {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-EdgeIteratingAlgo(const SortedGraphView* graph) {
+EdgeIteratingAlgo(const Graph* graph) {
   struct WorkItem {
     Node src;
     Node dst;
@@ -226,6 +250,7 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
 
   katana::InsertBag<WorkItem> items;
   katana::GAccumulator<size_t> numTriangles;
+  const bool has_parallel_edges = HasParallelEdges(*graph);
 
   katana::do_all(
       katana::iterate(*graph),
@@ -244,21 +269,28 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
+        if constexpr (kHasHubBitmaps<Graph>) {
+          if (graph->IsHub(w.src) || graph->IsHub(w.dst)) {
+            numTriangles +=
+                graph->CountCommonNeighbors(w.src, w.dst, w.src + 1, w.dst);
+            return;
+          }
+        }
         edge_iterator abegin = graph->OutEdges(w.src).begin();
         edge_iterator aend = graph->OutEdges(w.src).end();
         edge_iterator bbegin = graph->OutEdges(w.dst).begin();
         edge_iterator bend = graph->OutEdges(w.dst).end();
 
         edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
+            abegin, aend, GreaterThanOrEqual<Graph>(*graph, w.src));
         edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<SortedGraphView>(*graph, w.dst));
+            LowerBound(abegin, aend, LessThan<Graph>(*graph, w.dst));
         edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
+            bbegin, bend, GreaterThanOrEqual<Graph>(*graph, w.src));
         edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<SortedGraphView>(*graph, w.dst));
+            LowerBound(bbegin, bend, LessThan<Graph>(*graph, w.dst));
 
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        numTriangles += CountEqual(*graph, has_parallel_edges, aa, ea, bb, eb);
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -266,9 +298,46 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
   return numTriangles.reduce();
 }
 
+template <typename Graph>
+katana::Result<uint64_t>
+CountTriangles(const Graph* graph, const TriangleCountPlan& plan) {
+  size_t total_count;
+  katana::StatTimer execTime("TriangleCount", "TriangleCount");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case TriangleCountPlan::kNodeIteration:
+    total_count = NodeIteratingAlgo(graph);
+    break;
+  case TriangleCountPlan::kEdgeIteration:
+    total_count = EdgeIteratingAlgo(graph);
+    break;
+  case TriangleCountPlan::kOrderedCount:
+    total_count = OrderedCountAlgo(graph);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  return total_count;
+}
+
 katana::Result<uint64_t>
 katana::analytics::TriangleCount(
     katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  if (plan.architecture() == kGPU) {
+    GpuAnalytics* gpu = KATANA_CHECKED(GetGpuAnalytics());
+    katana::StatTimer exec_time("TriangleCount");
+    exec_time.start();
+    uint64_t total_count = KATANA_CHECKED(gpu->TriangleCount(pg));
+    exec_time.stop();
+    return total_count;
+  }
+  if (plan.algorithm() == TriangleCountPlan::kApproximate) {
+    // samples the default topology rather than building a sorted view
+    return TriangleCountApproximate(pg, plan, nullptr);
+  }
+
   katana::StatTimer timer_graph_read("GraphReadingTime", "TriangleCount");
   katana::StatTimer timer_auto_algo("AutoRelabel", "TriangleCount");
 
@@ -276,7 +345,13 @@ katana::analytics::TriangleCount(
 
   katana::StatTimer timer_relabel("GraphRelabelTimer", "TriangleCount");
   timer_relabel.start();
-  SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
+  std::optional<SortedGraphView> sorted_view;
+  std::optional<HubBitmapGraphView> hub_bitmap_view;
+  if (plan.hub_bitmaps()) {
+    hub_bitmap_view = pg->BuildView<HubBitmapGraphView>();
+  } else {
+    sorted_view = pg->BuildView<SortedGraphView>();
+  }
   timer_relabel.stop();
 
   // TODO(amber): Today we sort unconditionally. Figure out a way to re-enable the
@@ -335,23 +410,8 @@ katana::analytics::TriangleCount(
 
   KATANA_LOG_VERBOSE("Done relabeling. Starting TriangleCount");
 
-  size_t total_count;
-  katana::StatTimer execTime("TriangleCount", "TriangleCount");
-  execTime.start();
-  switch (plan.algorithm()) {
-  case TriangleCountPlan::kNodeIteration:
-    total_count = NodeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kEdgeIteration:
-    total_count = EdgeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kOrderedCount:
-    total_count = OrderedCountAlgo(&sorted_view);
-    break;
-  default:
-    return katana::ErrorCode::InvalidArgument;
+  if (hub_bitmap_view) {
+    return CountTriangles(&*hub_bitmap_view, plan);
   }
-  execTime.stop();
-
-  return total_count;
+  return CountTriangles(&*sorted_view, plan);
 }
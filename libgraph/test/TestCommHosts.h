@@ -0,0 +1,107 @@
+#ifndef KATANA_LIBGRAPH_TESTCOMMHOSTS_H_
+#define KATANA_LIBGRAPH_TESTCOMMHOSTS_H_
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Logging.h"
+
+/// Run the hosts of a CommBackend on one machine for testing.
+///
+/// \file TestCommHosts.h
+
+/// Loopback addresses for the hosts of a test. Each port stays bound to a
+/// socket of ours until destruction, so no other process can be given it
+/// in the meantime. The socket does not listen and sets SO_REUSEADDR, as
+/// TcpCommBackend does, so the backend can still listen on the port.
+class ReservedAddresses {
+public:
+  explicit ReservedAddresses(uint32_t num) {
+    for (uint32_t r = 0; r < num; ++r) {
+      int fd = socket(AF_INET, SOCK_STREAM, 0);
+      KATANA_LOG_ASSERT(fd >= 0);
+      int one = 1;
+      KATANA_LOG_ASSERT(
+          setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) == 0);
+      struct sockaddr_in addr {};
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t len = sizeof(addr);
+      KATANA_LOG_ASSERT(
+          bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) ==
+          0);
+      KATANA_LOG_ASSERT(
+          getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len) ==
+          0);
+      fds_.emplace_back(fd);
+      addresses_.emplace_back(
+          "127.0.0.1:" + std::to_string(ntohs(addr.sin_port)));
+    }
+  }
+
+  ReservedAddresses(const ReservedAddresses&) = delete;
+  ReservedAddresses& operator=(const ReservedAddresses&) = delete;
+
+  ~ReservedAddresses() {
+    for (int fd : fds_) {
+      close(fd);
+    }
+  }
+
+  const std::vector<std::string>& addresses() const { return addresses_; }
+
+private:
+  std::vector<int> fds_;
+  std::vector<std::string> addresses_;
+};
+
+/// Runs fn(rank, addresses) for each of num_hosts hosts, each in a thread
+/// of its own
+template <typename Fn>
+void
+RunHostThreads(uint32_t num_hosts, Fn fn) {
+  ReservedAddresses reserved(num_hosts);
+  std::vector<std::thread> hosts;
+  for (uint32_t r = 0; r < num_hosts; ++r) {
+    hosts.emplace_back([&fn, &reserved, r]() { fn(r, reserved.addresses()); });
+  }
+  for (std::thread& host : hosts) {
+    host.join();
+  }
+}
+
+/// Runs fn(rank, addresses) for each of num_hosts hosts, each in a process
+/// of its own, for hosts that need a runtime of their own
+///
+/// \returns whether every host exited successfully
+template <typename Fn>
+bool
+RunHostProcesses(uint32_t num_hosts, Fn fn) {
+  ReservedAddresses reserved(num_hosts);
+  std::vector<pid_t> hosts;
+  for (uint32_t r = 0; r < num_hosts; ++r) {
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      fn(r, reserved.addresses());
+      _exit(0);
+    }
+    hosts.emplace_back(pid);
+  }
+  bool ok = true;
+  for (pid_t pid : hosts) {
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  return ok;
+}
+
+#endif
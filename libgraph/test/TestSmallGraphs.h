@@ -0,0 +1,113 @@
+#ifndef KATANA_LIBGRAPH_TESTSMALLGRAPHS_H_
+#define KATANA_LIBGRAPH_TESTSMALLGRAPHS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/TopologyGeneration.h"
+
+/// Build small property graphs edge by edge, to test analytics against
+/// hand-checked answers or brute force.
+///
+/// \file TestSmallGraphs.h
+
+/// The edges, in both directions if symmetric, in the order of their edge
+/// ids: by source, then in the order given
+template <typename Edge>
+std::vector<Edge>
+OrderTestEdges(const std::vector<Edge>& edges, bool symmetric) {
+  std::vector<Edge> ordered;
+  for (const Edge& edge : edges) {
+    ordered.emplace_back(edge);
+    if (symmetric && std::get<0>(edge) != std::get<1>(edge)) {
+      Edge reversed = edge;
+      std::get<0>(reversed) = std::get<1>(edge);
+      std::get<1>(reversed) = std::get<0>(edge);
+      ordered.emplace_back(reversed);
+    }
+  }
+  std::stable_sort(
+      ordered.begin(), ordered.end(), [](const Edge& a, const Edge& b) {
+        return std::get<0>(a) < std::get<0>(b);
+      });
+  return ordered;
+}
+
+/// A graph of num_nodes nodes and the edges (source, destination). If
+/// symmetric, every edge but a self loop is added in both directions.
+inline std::unique_ptr<katana::PropertyGraph>
+MakeTestGraph(
+    size_t num_nodes, const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+    bool symmetric = false) {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(num_nodes);
+  // the builder keeps the edges of every node in the order they were added
+  for (const auto& [src, dst] : OrderTestEdges(edges, symmetric)) {
+    builder.AddEdge(src, dst);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+/// A graph of num_nodes nodes and the edges (source, destination, weight),
+/// with the weights in the edge property property_name. If symmetric, every
+/// edge but a self loop is added in both directions with its weight.
+template <typename T>
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedTestGraph(
+    size_t num_nodes,
+    const std::vector<std::tuple<uint32_t, uint32_t, T>>& edges,
+    bool symmetric = false, const std::string& property_name = "weight") {
+  std::vector<std::tuple<uint32_t, uint32_t, T>> ordered =
+      OrderTestEdges(edges, symmetric);
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  for (const auto& [src, dst, weight] : ordered) {
+    pairs.emplace_back(src, dst);
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = MakeTestGraph(num_nodes, pairs);
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(property_name, [&](uint64_t e) {
+        return std::get<2>(ordered[e]);
+      }));
+  KATANA_LOG_VASSERT(res, "adding weights: {}", res.error());
+  return pg;
+}
+
+/// The values of the node property name, by node
+template <typename T>
+std::vector<T>
+NodeValues(katana::PropertyGraph* pg, const std::string& name) {
+  auto array_res = pg->GetNodePropertyTyped<T>(name);
+  KATANA_LOG_VASSERT(array_res, "reading {}: {}", name, array_res.error());
+  std::vector<T> values;
+  for (int64_t i = 0; i < array_res.value()->length(); ++i) {
+    values.emplace_back(array_res.value()->Value(i));
+  }
+  return values;
+}
+
+/// The values of the edge property name, by edge
+template <typename T>
+std::vector<T>
+EdgeValues(katana::PropertyGraph* pg, const std::string& name) {
+  auto array_res = pg->GetEdgePropertyTyped<T>(name);
+  KATANA_LOG_VASSERT(array_res, "reading {}: {}", name, array_res.error());
+  std::vector<T> values;
+  for (int64_t i = 0; i < array_res.value()->length(); ++i) {
+    values.emplace_back(array_res.value()->Value(i));
+  }
+  return values;
+}
+
+#endif
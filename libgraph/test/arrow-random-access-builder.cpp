@@ -0,0 +1,91 @@
+#include <arrow/api.h>
+
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// Test that parallel writes to indices that share validity words are all
+/// kept, and that the values and nulls are the ones written
+void
+TestParallelNullable(size_t length) {
+  katana::ArrowRandomAccessBuilder<arrow::Int64Type> builder(length);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, length),
+      [&](size_t i) {
+        if (i % 3 != 0) {
+          builder[i] = 2 * i;
+        }
+      },
+      katana::steal(), katana::chunk_size<1>());
+  builder.SetValue(0, 7);
+  builder.UnsetValue(1);
+  KATANA_LOG_ASSERT(builder.IsValid(0));
+  KATANA_LOG_ASSERT(!builder.IsValid(1));
+
+  auto array_res = builder.Finalize();
+  KATANA_LOG_ASSERT(array_res);
+  auto array = std::static_pointer_cast<arrow::Int64Array>(array_res.value());
+  KATANA_LOG_ASSERT(static_cast<size_t>(array->length()) == length);
+  KATANA_LOG_ASSERT(array->ValidateFull().ok());
+
+  size_t num_nulls = 0;
+  for (size_t i = 0; i < length; ++i) {
+    bool valid = i == 0 || (i % 3 != 0 && i != 1);
+    KATANA_LOG_VASSERT(array->IsValid(i) == valid, "index {}", i);
+    if (!valid) {
+      ++num_nulls;
+    } else if (i > 0) {
+      KATANA_LOG_VASSERT(
+          array->Value(i) == static_cast<int64_t>(2 * i), "index {}", i);
+    }
+  }
+  KATANA_LOG_ASSERT(array->Value(0) == 7);
+  KATANA_LOG_ASSERT(static_cast<size_t>(array->null_count()) == num_nulls);
+}
+
+/// Test that a column without nulls is finished without a bitmap
+void
+TestNoNulls(size_t length) {
+  katana::ArrowRandomAccessBuilder<arrow::DoubleType> builder(length);
+  katana::do_all(
+      katana::iterate(size_t{0}, length), [&](size_t i) { builder[i] = i; });
+
+  auto array = builder.Finalize().value();
+  KATANA_LOG_ASSERT(array->null_count() == 0);
+  KATANA_LOG_ASSERT(array->data()->buffers[0] == nullptr);
+  KATANA_LOG_ASSERT(builder.size() == 0);
+}
+
+/// Test that the builders of types that arrow packs still work
+void
+TestString() {
+  katana::ArrowRandomAccessBuilder<arrow::StringType> builder(3);
+  builder[2] = "two";
+  builder.SetValue(0, "zero");
+
+  auto array = std::static_pointer_cast<arrow::StringArray>(
+      builder.Finalize().value());
+  KATANA_LOG_ASSERT(array->GetString(0) == "zero");
+  KATANA_LOG_ASSERT(array->IsNull(1));
+  KATANA_LOG_ASSERT(array->GetString(2) == "two");
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+  katana::setActiveThreads(4);
+
+  TestParallelNullable(1000);
+  TestParallelNullable(64);
+  TestParallelNullable(2);
+  TestNoNulls(100);
+  TestString();
+
+  return 0;
+}
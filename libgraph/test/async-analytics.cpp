@@ -0,0 +1,98 @@
+#include <future>
+#include <optional>
+#include <string>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/AsyncAnalytics.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+
+namespace {
+
+/// Outside of a launched analytic, progress is ignored
+void
+TestNoJob() {
+  KATANA_LOG_ASSERT(katana::analytics::CheckProgress({"None", 7}));
+}
+
+/// A launched analytic reports its iterations and returns its result
+void
+TestProgress(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  using katana::analytics::AnalyticsProgress;
+  uint64_t reports = 0;
+  uint64_t last_iteration = 0;
+  auto handle = katana::analytics::LaunchAnalytics(
+      [&]() {
+        return katana::analytics::Pagerank(
+            pg, "pagerank", txn_ctx,
+            katana::analytics::PagerankPlan::PullTopological());
+      },
+      [&](const AnalyticsProgress& progress) {
+        KATANA_LOG_ASSERT(progress.analytic == "Pagerank");
+        ++reports;
+        last_iteration = progress.iteration;
+      });
+
+  auto res = handle.Wait();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(handle.IsDone());
+  KATANA_LOG_ASSERT(reports > 0);
+
+  std::optional<AnalyticsProgress> last = handle.LastProgress();
+  KATANA_LOG_ASSERT(last && last->iteration == last_iteration);
+  KATANA_LOG_ASSERT(pg->HasNodeProperty("pagerank"));
+
+  KATANA_LOG_ASSERT(!handle.Wait());
+}
+
+/// A cancelled analytic stops at its next round boundary
+void
+TestCancel(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  std::promise<void> cancelled;
+  std::shared_future<void> cancelled_future = cancelled.get_future();
+  auto handle = katana::analytics::LaunchAnalytics(
+      [&]() {
+        return katana::analytics::BetweennessCentrality(
+            pg, "bc", txn_ctx,
+            katana::analytics::kBetweennessCentralityAllNodes,
+            katana::analytics::BetweennessCentralityPlan::Outer());
+      },
+      [&](const katana::analytics::AnalyticsProgress&) {
+        cancelled_future.wait();
+      });
+
+  handle.Cancel();
+  cancelled.set_value();
+
+  auto res = handle.Wait();
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_VASSERT(
+      res.error() == katana::ErrorCode::Cancelled, "{}", res.error());
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  katana::TxnContext txn_ctx;
+  auto pg_res = katana::PropertyGraph::Make(inputFile, &txn_ctx);
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  TestNoJob();
+  TestProgress(pg, &txn_ctx);
+  TestCancel(pg, &txn_ctx);
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include <atomic>
+
+#include "katana/BalancedRange.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using namespace katana;
+
+namespace {
+
+constexpr uint64_t kNumNodes = 1000;
+constexpr uint64_t kHub = 17;
+constexpr uint64_t kHubDegree = 5000;
+constexpr uint64_t kMaxEdgesPerItem = 64;
+
+/// A graph where node kHub has an edge to every node kHubDegree / kNumNodes
+/// times and every other node has an edge to the next one
+GraphTopology
+MakeHubTopology() {
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(kNumNodes);
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(kNumNodes - 1 + kHubDegree);
+
+  uint64_t e = 0;
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    if (n == kHub) {
+      for (uint64_t i = 0; i < kHubDegree; ++i) {
+        dests[e++] = i % kNumNodes;
+      }
+    } else {
+      dests[e++] = (n + 1) % kNumNodes;
+    }
+    adj_indices[n] = e;
+  }
+  return GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+/// Checks that looping over iterate_balanced(view) visits every edge of
+/// view once as an edge of its own node
+template <typename View, typename... Args>
+void
+CheckCoversEdges(const View& view, uint64_t max_edges, Args... args) {
+  auto range = iterate_balanced(view, max_edges);
+  KATANA_LOG_ASSERT(range.size() >= view.NumNodes());
+
+  NUMAArray<std::atomic<uint32_t>> seen;
+  seen.allocateInterleaved(view.NumEdges());
+  do_all(
+      iterate(uint64_t{0}, view.NumEdges()),
+      [&](uint64_t e) { seen.constructAt(e, 0u); }, no_stats());
+
+  std::atomic<uint64_t> num_items{0};
+  do_all(
+      range,
+      [&](const auto& item) {
+        num_items.fetch_add(1);
+        uint64_t num_edges = 0;
+        for (auto e : item.edges) {
+          KATANA_LOG_ASSERT(view.GetEdgeSrc(e) == item.node);
+          seen[e].fetch_add(1);
+          ++num_edges;
+        }
+        KATANA_LOG_ASSERT(num_edges <= max_edges);
+        KATANA_LOG_ASSERT(
+            item.whole == (num_edges == view.OutDegree(item.node)));
+      },
+      args..., no_stats());
+  KATANA_LOG_ASSERT(num_items == range.size());
+
+  for (uint64_t e = 0; e < view.NumEdges(); ++e) {
+    KATANA_LOG_VASSERT(seen[e] == 1, "edge {} seen {} times", e, seen[e]);
+  }
+
+  // the iterators agree with each other
+  auto it = range.begin();
+  for (uint64_t i = 0; i < range.size(); ++i, ++it) {
+    KATANA_LOG_ASSERT((*(range.begin() + i)).node == (*it).node);
+    KATANA_LOG_ASSERT(it - range.begin() == static_cast<ptrdiff_t>(i));
+  }
+  KATANA_LOG_ASSERT(it == range.end());
+}
+
+template <typename View>
+void
+CheckHub(const View& view) {
+  auto range = iterate_balanced(view, kMaxEdgesPerItem);
+  const uint64_t hub_items =
+      (kHubDegree + kMaxEdgesPerItem - 1) / kMaxEdgesPerItem;
+  KATANA_LOG_ASSERT(range.size() == kNumNodes - 1 + hub_items);
+
+  uint64_t num_hub_items = 0;
+  for (const auto& item : range) {
+    if (item.node == kHub) {
+      KATANA_LOG_ASSERT(!item.whole);
+      ++num_hub_items;
+    } else {
+      KATANA_LOG_ASSERT(item.whole);
+    }
+  }
+  KATANA_LOG_ASSERT(num_hub_items == hub_items);
+
+  CheckCoversEdges(view, kMaxEdgesPerItem);
+  CheckCoversEdges(view, kMaxEdgesPerItem, steal());
+}
+
+Result<void>
+TestHub() {
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(MakeHubTopology()));
+  CheckHub(pg->BuildView<PropertyGraphViews::Default>());
+  CheckHub(pg->BuildView<PropertyGraphViews::Compact>());
+  return katana::ResultSuccess();
+}
+
+Result<void>
+TestUniform() {
+  auto pg =
+      KATANA_CHECKED(PropertyGraph::Make(CreateUniformRandomTopology(2000, 5)));
+  auto view = pg->BuildView<PropertyGraphViews::Default>();
+
+  // no node has more edges than an item
+  KATANA_LOG_ASSERT(iterate_balanced(view).size() == view.NumNodes());
+  CheckCoversEdges(
+      view, BalancedRange<decltype(view)>::kDefaultMaxEdgesPerItem);
+  CheckCoversEdges(view, 2, steal());
+  return katana::ResultSuccess();
+}
+
+Result<void>
+TestEmpty() {
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(GraphTopology()));
+  auto view = pg->BuildView<PropertyGraphViews::Default>();
+  auto range = iterate_balanced(view);
+  KATANA_LOG_ASSERT(range.empty());
+  KATANA_LOG_ASSERT(range.begin() == range.end());
+  do_all(
+      range, [&](const auto&) { KATANA_LOG_FATAL("no items"); }, no_stats());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  SharedMemSys sys;
+
+  auto res = TestHub();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = TestUniform();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = TestEmpty();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "katana/BufferedGraph.h"
+#include "katana/FileGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+// enough edges that their destinations span several blocks of a parallel
+// read
+constexpr uint64_t kNumNodes = uint64_t{1} << 18;
+constexpr uint64_t kDegree = 48;
+
+uint32_t
+Dest(uint64_t n, uint64_t i) {
+  return (n * 7 + i * 13) % kNumNodes;
+}
+
+uint32_t
+Data(uint64_t n, uint64_t i) {
+  return n * 3 + i;
+}
+
+/// A .gr file of kNumNodes nodes, node n having n % kDegree edges
+std::string
+WriteGraph() {
+  katana::FileGraphWriter writer;
+  writer.setNumNodes(kNumNodes);
+  uint64_t num_edges = 0;
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    num_edges += n % kDegree;
+  }
+  writer.setNumEdges(num_edges);
+  writer.setSizeofEdgeData(sizeof(uint32_t));
+  writer.phase1();
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    writer.incrementDegree(n, n % kDegree);
+  }
+  writer.phase2();
+  std::vector<uint32_t> data(num_edges);
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    for (uint64_t i = 0; i < n % kDegree; ++i) {
+      data[writer.addNeighbor(n, Dest(n, i))] = Data(n, i);
+    }
+  }
+  uint32_t* edge_data = writer.finish<uint32_t>();
+  std::copy(data.begin(), data.end(), edge_data);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/bufferedgraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string filename = uri_res.value().path();
+  writer.toFile(filename);
+  return filename;
+}
+
+void
+CheckGraph(
+    katana::BufferedGraph<uint32_t>& graph, uint64_t begin, uint64_t end,
+    bool with_data) {
+  for (uint64_t n = begin; n < end; ++n) {
+    auto e = graph.edgeBegin(n);
+    KATANA_LOG_VASSERT(
+        *graph.edgeEnd(n) - *e == n % kDegree, "degree of node {}", n);
+    for (uint64_t i = 0; i < n % kDegree; ++i, ++e) {
+      KATANA_LOG_VASSERT(
+          graph.edgeDestination(*e) == Dest(n, i), "edge {} of node {}", i, n);
+      if (with_data) {
+        KATANA_LOG_VASSERT(
+            graph.edgeData(*e) == Data(n, i), "data of edge {} of node {}", i,
+            n);
+      }
+    }
+  }
+}
+
+void
+TestLoad(const std::string& filename, bool direct) {
+  katana::BufferedGraphLoadOptions opts;
+  opts.directIO = direct;
+
+  katana::BufferedGraph<uint32_t> graph;
+  graph.loadGraph(filename, opts);
+  KATANA_LOG_ASSERT(graph.size() == kNumNodes);
+  CheckGraph(graph, 0, kNumNodes, true);
+
+  // a partial graph that starts and ends at unaligned offsets of the file
+  uint64_t node_begin = 1001;
+  uint64_t node_end = 40003;
+  uint64_t edge_begin = *graph.edgeBegin(node_begin);
+  uint64_t edge_end = *graph.edgeEnd(node_end - 1);
+  uint64_t num_edges = graph.sizeEdges();
+
+  katana::BufferedGraph<uint32_t> partial;
+  partial.loadPartialGraph(
+      filename, node_begin, node_end, edge_begin, edge_end, kNumNodes,
+      num_edges, opts);
+  CheckGraph(partial, node_begin, node_end, true);
+
+  opts.loadEdgeData = false;
+  katana::BufferedGraph<uint32_t> no_data;
+  no_data.loadPartialGraph(
+      filename, node_begin, node_end, edge_begin, edge_end, kNumNodes,
+      num_edges, opts);
+  CheckGraph(no_data, node_begin, node_end, false);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  std::string filename = WriteGraph();
+  TestLoad(filename, false);
+  TestLoad(filename, true);
+  std::remove(filename.c_str());
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "katana/analytics/Checkpoint.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace fs = boost::filesystem;
+
+using katana::analytics::CheckpointBuffer;
+using katana::analytics::Checkpointer;
+using katana::analytics::CheckpointOptions;
+
+namespace {
+
+std::string
+MakeDir() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/checkpoint");
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value().path();
+}
+
+/// The last checkpoint is restored, and a damaged one leaves the one before
+void
+TestSaveRestore() {
+  CheckpointOptions options{MakeDir(), 2};
+  std::vector<uint64_t> values(100000);
+  std::vector<uint8_t> flags(17);
+  std::vector<CheckpointBuffer> state{
+      {values.data(), values.size() * sizeof(uint64_t)},
+      {flags.data(), flags.size()}};
+  {
+    Checkpointer checkpointer(options, "test");
+    for (uint64_t round = 1; round <= 5; ++round) {
+      std::iota(values.begin(), values.end(), round);
+      std::fill(flags.begin(), flags.end(), round);
+      KATANA_LOG_ASSERT(checkpointer.Save(round, state));
+    }
+  }
+
+  auto restore = [&](const std::string& key) {
+    Checkpointer checkpointer(options, key);
+    auto res = checkpointer.Restore(state);
+    KATANA_LOG_VASSERT(res, "restoring: {}", res.error());
+    return res.value();
+  };
+  std::fill(values.begin(), values.end(), 0);
+  auto round = restore("test");
+  KATANA_LOG_ASSERT(round && *round == 4);
+  KATANA_LOG_ASSERT(values[0] == 4 && values.back() == 4 + values.size() - 1);
+  KATANA_LOG_ASSERT(flags[16] == 4);
+
+  KATANA_LOG_ASSERT(!restore("another run"));
+
+  // round 4 went to the second file
+  {
+    std::fstream file(
+        options.dir + "/checkpoint-1.bin",
+        std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(1000);
+    file.put(7);
+  }
+  round = restore("test");
+  KATANA_LOG_ASSERT(round && *round == 2);
+  KATANA_LOG_ASSERT(values[0] == 2 && flags[0] == 2);
+
+  fs::remove_all(options.dir);
+  KATANA_LOG_ASSERT(!restore("test"));
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  constexpr uint32_t kNumNodes = 2000;
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  for (uint32_t e = 0; e < 5 * kNumNodes; ++e) {
+    builder.AddEdge(
+        katana::StatelessRandom(3, 2 * e) % kNumNodes,
+        katana::StatelessRandom(3, 2 * e + 1) % kNumNodes);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+std::vector<float>
+Ranks(katana::PropertyGraph* pg, const std::string& name) {
+  auto res = pg->GetNodePropertyTyped<float>(name);
+  KATANA_LOG_VASSERT(res, "getting ranks: {}", res.error());
+  auto ranks = res.value();
+  return {ranks->raw_values(), ranks->raw_values() + ranks->length()};
+}
+
+/// A run resumed from a checkpoint ends with the ranks of a run that was
+/// never stopped
+void
+TestPagerankResume() {
+  using katana::analytics::Pagerank;
+  using katana::analytics::PagerankPlan;
+  auto pg = MakeGraph();
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(Pagerank(
+      pg.get(), "full", &txn_ctx, PagerankPlan::PullTopological(0, 20)));
+
+  CheckpointOptions options{MakeDir(), 5};
+  // stopped after 12 iterations, with checkpoints after 5 and 10
+  KATANA_LOG_ASSERT(Pagerank(
+      pg.get(), "stopped", &txn_ctx, PagerankPlan::PullTopological(0, 12),
+      options));
+  KATANA_LOG_ASSERT(Ranks(pg.get(), "stopped") != Ranks(pg.get(), "full"));
+  KATANA_LOG_ASSERT(Pagerank(
+      pg.get(), "resumed", &txn_ctx, PagerankPlan::PullTopological(0, 20),
+      options));
+  KATANA_LOG_ASSERT(Ranks(pg.get(), "resumed") == Ranks(pg.get(), "full"));
+  fs::remove_all(options.dir);
+
+  KATANA_LOG_ASSERT(!Pagerank(
+      pg.get(), "push", &txn_ctx, PagerankPlan::PushAsynchronous(), options));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSaveRestore();
+  TestPagerankResume();
+
+  return 0;
+}
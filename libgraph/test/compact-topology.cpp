@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using namespace katana;
+using CompactGraphView = PropertyGraphViews::Compact;
+using CompactSortedGraphView = PropertyGraphViews::CompactEdgesSortedByDestID;
+using SortedGraphView = PropertyGraphViews::EdgesSortedByDestID;
+
+Result<void>
+TestCompactView() {
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 5;
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(
+      CreateUniformRandomTopology(kNumNodes, kEdgesPerNode)));
+  CompactGraphView view = pg->BuildView<CompactGraphView>();
+  const GraphTopology& topo = pg->topology();
+
+  KATANA_LOG_ASSERT(view.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(view.NumEdges() == topo.NumEdges());
+
+  for (auto node : topo.Nodes()) {
+    KATANA_LOG_ASSERT(
+        *view.OutEdges(node).begin() == *topo.OutEdges(node).begin());
+    KATANA_LOG_ASSERT(
+        *view.OutEdges(node).end() == *topo.OutEdges(node).end());
+    KATANA_LOG_ASSERT(view.OutDegree(node) == topo.OutDegree(node));
+    for (auto e : view.OutEdges(node)) {
+      KATANA_LOG_ASSERT(view.OutEdgeDst(e) == topo.OutEdgeDst(e));
+      KATANA_LOG_ASSERT(view.GetEdgeSrc(e) == node);
+    }
+  }
+
+  auto compact = CompactGraphTopology::Make(
+      std::make_shared<GraphTopology>(GraphTopology::Copy(topo)));
+  KATANA_LOG_ASSERT(compact->is_narrow());
+
+  return katana::ResultSuccess();
+}
+
+/// The compact sorted view has the edges, in the same order, of the sorted
+/// view
+Result<void>
+TestCompactSortedView() {
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 5;
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(
+      CreateUniformRandomTopology(kNumNodes, kEdgesPerNode)));
+  CompactSortedGraphView view = pg->BuildView<CompactSortedGraphView>();
+  SortedGraphView sorted = pg->BuildView<SortedGraphView>();
+
+  KATANA_LOG_ASSERT(view.NumNodes() == sorted.NumNodes());
+  KATANA_LOG_ASSERT(view.NumEdges() == sorted.NumEdges());
+
+  for (auto node : sorted.Nodes()) {
+    KATANA_LOG_ASSERT(
+        *view.OutEdges(node).begin() == *sorted.OutEdges(node).begin());
+    KATANA_LOG_ASSERT(
+        *view.OutEdges(node).end() == *sorted.OutEdges(node).end());
+    auto edges = view.OutEdges(node);
+    auto by_dst = [&](auto a, auto b) {
+      return view.OutEdgeDst(a) < view.OutEdgeDst(b);
+    };
+    KATANA_LOG_ASSERT(std::is_sorted(edges.begin(), edges.end(), by_dst));
+    for (auto e : edges) {
+      KATANA_LOG_ASSERT(view.OutEdgeDst(e) == sorted.OutEdgeDst(e));
+      KATANA_LOG_ASSERT(
+          view.GetEdgePropertyIndexFromOutEdge(e) ==
+          sorted.GetEdgePropertyIndexFromOutEdge(e));
+    }
+  }
+
+  return katana::ResultSuccess();
+}
+
+int
+main() {
+  SharedMemSys sys;
+
+  auto res = TestCompactView();
+  KATANA_LOG_ASSERT(res);
+
+  auto sorted_res = TestCompactSortedView();
+  KATANA_LOG_ASSERT(sorted_res);
+
+  KATANA_LOG_ASSERT(!CompactGraphTopology::FitsNarrow(uint64_t{1} << 32));
+
+  return 0;
+}
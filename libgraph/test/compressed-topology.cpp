@@ -0,0 +1,162 @@
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+using namespace katana;
+using CompressedGraphView = PropertyGraphViews::Compressed;
+
+void
+TestCompressedTopology(const GraphTopology& topo) noexcept {
+  auto compressed = CompressedGraphTopology::Make(topo);
+
+  KATANA_LOG_ASSERT(compressed->NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(compressed->NumEdges() == topo.NumEdges());
+
+  for (auto node : topo.Nodes()) {
+    KATANA_LOG_ASSERT(compressed->OutDegree(node) == topo.OutDegree(node));
+
+    auto e = *topo.OutEdges(node).begin();
+    for (auto dst : compressed->OutNeighbors(node)) {
+      KATANA_LOG_VASSERT(
+          dst == topo.OutEdgeDst(e), "neighbor mismatch at edge {}", e);
+      ++e;
+    }
+    KATANA_LOG_ASSERT(e == *topo.OutEdges(node).end());
+
+    for (auto e : topo.OutEdges(node)) {
+      KATANA_LOG_VASSERT(
+          compressed->OutEdgeDst(e) == topo.OutEdgeDst(e),
+          "destination mismatch at edge {}", e);
+      KATANA_LOG_ASSERT(compressed->GetEdgeSrc(e) == node);
+    }
+  }
+}
+
+Result<void>
+TestCompressedView() {
+  // Includes a node with no edges and large jumps in both directions to
+  // exercise negative deltas and multi-byte varints.
+  AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(300);
+
+  std::vector<std::array<uint32_t, 2>> edges = {
+      {0, 299}, {0, 1}, {0, 200}, {2, 2}, {2, 0}, {299, 150}, {299, 298}};
+  for (const auto& [n1, n2] : edges) {
+    builder.AddEdge(n1, n2);
+  }
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(builder.ConvertToCSR()));
+  CompressedGraphView view = pg->BuildView<CompressedGraphView>();
+
+  KATANA_LOG_ASSERT(view.NumEdges() == pg->NumEdges());
+  for (auto e : view.OutEdges()) {
+    KATANA_LOG_VASSERT(
+        view.OutEdgeDst(e) == pg->topology().OutEdgeDst(e),
+        "Edge destinations do not match");
+    KATANA_LOG_VASSERT(
+        view.GetEdgeSrc(e) == pg->topology().GetEdgeSrc(e),
+        "Edge sources do not match");
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// Writes pg and returns where, and in num_files how many files it took
+Result<std::string>
+WriteGraph(PropertyGraph* pg, size_t* num_files) {
+  Uri uri = KATANA_CHECKED(Uri::MakeRand("/tmp/compressedtopology"));
+  std::string rdg_dir(uri.path());  // path() because local
+  KATANA_CHECKED(pg->Write(rdg_dir, "compressed-topology"));
+  *num_files = 0;
+  for (boost::filesystem::recursive_directory_iterator it(rdg_dir), end;
+       it != end; ++it) {
+    *num_files += boost::filesystem::is_regular_file(it->status());
+  }
+  return rdg_dir;
+}
+
+/// A compressed topology stored with its graph is loaded back with the
+/// neighbors and edge ids of the uncompressed topology
+Result<void>
+TestCompressedPersistence(size_t num_nodes, size_t edges_per_node) {
+  auto plain_pg = KATANA_CHECKED(PropertyGraph::Make(
+      CreateUniformRandomTopology(num_nodes, edges_per_node)));
+  size_t plain_files = 0;
+  std::string plain_dir =
+      KATANA_CHECKED(WriteGraph(plain_pg.get(), &plain_files));
+  boost::filesystem::remove_all(plain_dir);
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(
+      CreateUniformRandomTopology(num_nodes, edges_per_node)));
+  CompressedGraphView stored = pg->BuildView<CompressedGraphView>();
+  size_t view_files = 0;
+  std::string rdg_dir = KATANA_CHECKED(WriteGraph(pg.get(), &view_files));
+
+  KATANA_LOG_VASSERT(
+      view_files > plain_files, "{} files with the view, {} without",
+      view_files, plain_files);
+
+  // the view is loaded from storage when it is built, so rdg_dir is kept
+  // until then
+  TxnContext txn_ctx;
+  auto loaded_res = PropertyGraph::Make(rdg_dir, &txn_ctx, RDGLoadOptions());
+  if (!loaded_res) {
+    boost::filesystem::remove_all(rdg_dir);
+    return loaded_res.error();
+  }
+  std::unique_ptr<PropertyGraph> loaded = std::move(loaded_res.value());
+  CompressedGraphView view = loaded->BuildView<CompressedGraphView>();
+  boost::filesystem::remove_all(rdg_dir);
+
+  const GraphTopology& topo = pg->topology();
+  KATANA_LOG_ASSERT(view.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(view.NumEdges() == topo.NumEdges());
+  KATANA_LOG_ASSERT(view.EncodedDestSize() == stored.EncodedDestSize());
+  for (auto node : topo.Nodes()) {
+    KATANA_LOG_ASSERT(
+        *view.OutEdges(node).begin() == *topo.OutEdges(node).begin());
+    auto e = *topo.OutEdges(node).begin();
+    for (auto dst : view.OutNeighbors(node)) {
+      KATANA_LOG_VASSERT(
+          dst == topo.OutEdgeDst(e), "neighbor mismatch at edge {}", e);
+      KATANA_LOG_ASSERT(
+          view.GetEdgePropertyIndexFromOutEdge(e) ==
+          topo.GetEdgePropertyIndexFromOutEdge(e));
+      ++e;
+    }
+    KATANA_LOG_ASSERT(e == *topo.OutEdges(node).end());
+  }
+
+  return ResultSuccess();
+}
+
+int
+main() {
+  SharedMemSys sys;
+
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 5;
+
+  TestCompressedTopology(GraphTopology{});
+  TestCompressedTopology(
+      CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  auto res = TestCompressedView();
+  KATANA_LOG_ASSERT(res);
+
+  auto persistence_res = TestCompressedPersistence(kNumNodes, kEdgesPerNode);
+  KATANA_LOG_VASSERT(
+      persistence_res, "storing the compressed topology: {}",
+      persistence_res.error());
+
+  return 0;
+}
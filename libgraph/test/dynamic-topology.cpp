@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "katana/DynamicTopology.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+using namespace katana;
+using Node = GraphTopology::Node;
+using Edge = GraphTopology::Edge;
+using PropertyIndex = GraphTopology::PropertyIndex;
+using EdgeTriple = std::tuple<Node, Node, PropertyIndex>;
+
+namespace {
+
+// spans several blocks, with a partial one at the end
+constexpr Node kNumNodes = 3 * DynamicTopologySnapshot::kNodesPerBlock + 5;
+
+/// A ring where each node also points back at 0
+GraphTopology
+MakeRing() {
+  std::vector<Edge> adj_indices;
+  std::vector<Node> dests;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    dests.emplace_back((n + 1) % kNumNodes);
+    dests.emplace_back(0);
+    adj_indices.emplace_back(dests.size());
+  }
+  return GraphTopology(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+}
+
+template <typename View>
+std::vector<EdgeTriple>
+CollectEdges(const View& view) {
+  std::vector<EdgeTriple> edges;
+  for (auto n : view.Nodes()) {
+    for (auto e : view.OutEdges(n)) {
+      KATANA_LOG_ASSERT(view.GetEdgeSrc(e) == n);
+      edges.emplace_back(
+          n, view.OutEdgeDst(e), view.GetEdgePropertyIndexFromOutEdge(e));
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+void
+TestBatches() {
+  GraphTopology ring = MakeRing();
+  auto dyn = DynamicTopology::Make(ring);
+
+  DynamicTopologyWrapper v0 = dyn->View();
+  KATANA_LOG_ASSERT(v0.version() == 0);
+  const std::vector<EdgeTriple> expected0 = CollectEdges(ring);
+  KATANA_LOG_ASSERT(CollectEdges(v0) == expected0);
+
+  DynamicTopology::EdgeBatch batch;
+  batch.insertions = {{5, 7, 100}, {kNumNodes - 1, 3, 101}, {5, 1, 102}};
+  // deletes the ring edge of node 2 and the back edge of node 5, and
+  // replaces the back edge of node 10 with one of a new property index
+  batch.deletions = {{2, 3}, {5, 0}, {10, 0}};
+  batch.insertions.push_back({10, 0, 103});
+  auto res = dyn->ApplyEdgeBatch(batch);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  std::vector<EdgeTriple> expected1;
+  for (const auto& [src, dst, prop] : expected0) {
+    if ((src == 2 && dst == 3) || (src == 5 && dst == 0) ||
+        (src == 10 && dst == 0)) {
+      continue;
+    }
+    expected1.emplace_back(src, dst, prop);
+  }
+  for (const auto& ins : batch.insertions) {
+    expected1.emplace_back(ins.src, ins.dst, ins.prop_index);
+  }
+  std::sort(expected1.begin(), expected1.end());
+
+  DynamicTopologyWrapper v1 = dyn->View();
+  KATANA_LOG_ASSERT(v1.version() == 1);
+  KATANA_LOG_ASSERT(v1.NumEdges() == v0.NumEdges() + 4 - 3);
+  KATANA_LOG_ASSERT(CollectEdges(v1) == expected1);
+
+  // the old version is unchanged
+  KATANA_LOG_ASSERT(CollectEdges(v0) == expected0);
+
+  // edges of each node stay sorted by destination
+  for (auto n : v1.Nodes()) {
+    auto neighbors = v1.OutNeighbors(n);
+    KATANA_LOG_ASSERT(std::is_sorted(neighbors.begin(), neighbors.end()));
+    KATANA_LOG_ASSERT(neighbors.size() == v1.OutDegree(n));
+  }
+
+  GraphTopology csr = dyn->Snapshot()->ToGraphTopology();
+  KATANA_LOG_ASSERT(csr.NumEdges() == v1.NumEdges());
+  KATANA_LOG_ASSERT(CollectEdges(csr) == expected1);
+
+  // invalid node ids are rejected and leave the topology untouched
+  DynamicTopology::EdgeBatch bad;
+  bad.insertions = {{0, kNumNodes, 0}};
+  KATANA_LOG_ASSERT(!dyn->ApplyEdgeBatch(bad));
+  KATANA_LOG_ASSERT(dyn->View().version() == 1);
+}
+
+/// Readers see whole versions while batches are applied
+void
+TestConcurrentReaders() {
+  auto dyn = DynamicTopology::Make(MakeRing());
+  constexpr int kBatches = 20;
+
+  std::thread writer([&]() {
+    for (int i = 0; i < kBatches; ++i) {
+      DynamicTopology::EdgeBatch batch;
+      for (Node n = 0; n < kNumNodes; n += 97) {
+        batch.insertions.push_back({n, static_cast<Node>(i), 0});
+      }
+      auto res = dyn->ApplyEdgeBatch(batch);
+      KATANA_LOG_VASSERT(res, "{}", res.error());
+    }
+  });
+
+  const uint64_t base_edges = 2 * uint64_t{kNumNodes};
+  const uint64_t per_batch = (kNumNodes + 96) / 97;
+  uint64_t version = 0;
+  while (version < kBatches) {
+    auto snapshot = dyn->Snapshot();
+    KATANA_LOG_ASSERT(snapshot->version() >= version);
+    version = snapshot->version();
+    KATANA_LOG_ASSERT(
+        snapshot->NumEdges() == base_edges + version * per_batch);
+    uint64_t edges = 0;
+    for (auto n : snapshot->Nodes()) {
+      edges += snapshot->OutDegree(n);
+    }
+    KATANA_LOG_ASSERT(edges == snapshot->NumEdges());
+  }
+  writer.join();
+}
+
+}  // namespace
+
+int
+main() {
+  SharedMemSys sys;
+
+  TestBatches();
+  TestConcurrentReaders();
+
+  return 0;
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "katana/EdgeStreamingGraph.h"
+#include "katana/FileGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+using Node = katana::EdgeStreamingGraph::Node;
+using AdjacencyList = std::vector<std::vector<Node>>;
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// Two random components, of nodes [0, n / 2) and [n / 2, n), with a few
+/// nodes of each left without edges
+AdjacencyList
+MakeGraph(Node num_nodes) {
+  AdjacencyList adj(num_nodes);
+  uint64_t state = 12345;
+  auto next = [&state]() {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
+  };
+  Node half = num_nodes / 2;
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (n % 97 == 0) {
+      continue;
+    }
+    Node base = n < half ? 0 : half;
+    uint64_t degree = next() % 8;
+    for (uint64_t i = 0; i < degree; ++i) {
+      Node dst = base + next() % half;
+      if (dst % 97 != 0) {
+        adj[n].emplace_back(dst);
+      }
+    }
+  }
+  return adj;
+}
+
+std::string
+WriteGraph(const AdjacencyList& adj) {
+  katana::FileGraphWriter writer;
+  uint64_t num_edges = 0;
+  for (const auto& edges : adj) {
+    num_edges += edges.size();
+  }
+  writer.setNumNodes(adj.size());
+  writer.setNumEdges(num_edges);
+  writer.setSizeofEdgeData(0);
+  writer.phase1();
+  for (Node n = 0; n < adj.size(); ++n) {
+    writer.incrementDegree(n, adj[n].size());
+  }
+  writer.phase2();
+  for (Node n = 0; n < adj.size(); ++n) {
+    for (Node dst : adj[n]) {
+      writer.addNeighbor(n, dst);
+    }
+  }
+  writer.finish<void>();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/edgestreaminggraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string filename = uri_res.value().path();
+  writer.toFile(filename);
+  return filename;
+}
+
+void
+TestBFS(katana::EdgeStreamingGraph* graph, const AdjacencyList& adj) {
+  Node source = 1;
+  std::vector<uint32_t> expected(adj.size(), kUnreached);
+  std::deque<Node> queue{source};
+  expected[source] = 0;
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop_front();
+    for (Node dst : adj[n]) {
+      if (expected[dst] == kUnreached) {
+        expected[dst] = expected[n] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+
+  katana::NUMAArray<uint32_t> levels;
+  KATANA_LOG_ASSERT(katana::StreamingBFS(graph, source, &levels));
+  for (Node n = 0; n < adj.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        levels[n] == expected[n], "level of {}: {} != {}", n, levels[n],
+        expected[n]);
+  }
+}
+
+void
+TestConnectedComponents(
+    katana::EdgeStreamingGraph* graph, const AdjacencyList& adj) {
+  // the least node of each component, by a union find
+  std::vector<Node> parent(adj.size());
+  for (Node n = 0; n < adj.size(); ++n) {
+    parent[n] = n;
+  }
+  auto find = [&](Node n) {
+    while (parent[n] != n) {
+      n = parent[n] = parent[parent[n]];
+    }
+    return n;
+  };
+  for (Node n = 0; n < adj.size(); ++n) {
+    for (Node dst : adj[n]) {
+      Node a = find(n);
+      Node b = find(dst);
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  }
+
+  katana::NUMAArray<uint32_t> components;
+  KATANA_LOG_ASSERT(katana::StreamingConnectedComponents(graph, &components));
+  for (Node n = 0; n < adj.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        components[n] == find(n), "component of {}: {} != {}", n,
+        components[n], find(n));
+  }
+}
+
+void
+TestPageRank(katana::EdgeStreamingGraph* graph, const AdjacencyList& adj) {
+  katana::StreamingPageRankOptions opts;
+  opts.tolerance = 1.0e-5;
+  opts.max_iterations = 200;
+
+  uint64_t num_nodes = adj.size();
+  std::vector<double> expected(num_nodes, 1.0 / num_nodes);
+  for (uint32_t iteration = 0; iteration < opts.max_iterations; ++iteration) {
+    std::vector<double> sums(num_nodes);
+    double dangling = 0;
+    for (Node n = 0; n < num_nodes; ++n) {
+      if (adj[n].empty()) {
+        dangling += expected[n];
+      }
+      for (Node dst : adj[n]) {
+        sums[dst] += expected[n] / adj[n].size();
+      }
+    }
+    double delta = 0;
+    for (Node n = 0; n < num_nodes; ++n) {
+      double rank = (1 - opts.alpha + opts.alpha * dangling) / num_nodes +
+                    opts.alpha * sums[n];
+      delta += std::fabs(rank - expected[n]);
+      expected[n] = rank;
+    }
+    if (delta < opts.tolerance) {
+      break;
+    }
+  }
+
+  katana::NUMAArray<float> ranks;
+  KATANA_LOG_ASSERT(katana::StreamingPageRank(graph, opts, &ranks));
+  double total = 0;
+  for (Node n = 0; n < num_nodes; ++n) {
+    total += ranks[n];
+    KATANA_LOG_VASSERT(
+        std::fabs(ranks[n] - expected[n]) < 1.0e-5, "rank of {}: {} != {}", n,
+        ranks[n], expected[n]);
+  }
+  KATANA_LOG_VASSERT(std::fabs(total - 1) < 1.0e-3, "ranks sum to {}", total);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  AdjacencyList adj = MakeGraph(10000);
+  std::string filename = WriteGraph(adj);
+
+  // shards small enough that there are many of them, and the edges of the
+  // first level of the search are in few of them
+  katana::EdgeStreamingOptions opts;
+  opts.shard_bytes = 4096;
+  opts.io_threads = 3;
+  auto graph_res = katana::EdgeStreamingGraph::Make(filename, opts);
+  KATANA_LOG_ASSERT(graph_res);
+  katana::EdgeStreamingGraph graph = std::move(graph_res.value());
+  KATANA_LOG_ASSERT(graph.NumNodes() == adj.size());
+  KATANA_LOG_VASSERT(graph.NumShards() > 10, "{} shards", graph.NumShards());
+
+  TestBFS(&graph, adj);
+  TestConnectedComponents(&graph, adj);
+  TestPageRank(&graph, adj);
+
+  std::remove(filename.c_str());
+  return 0;
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Embeddings.h"
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+
+namespace {
+
+constexpr size_t kDim = 20;
+constexpr size_t kNumNodes = 100;
+
+using Embedding = katana::EmbeddingProperty<float, kDim>;
+
+void
+TestDot() {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  for (size_t dim = 0; dim < 70; ++dim) {
+    std::vector<float> a(dim);
+    std::vector<float> b(dim);
+    double expected = 0;
+    for (size_t i = 0; i < dim; ++i) {
+      a[i] = dist(gen);
+      b[i] = dist(gen);
+      expected += a[i] * b[i];
+    }
+    float dot = katana::EmbeddingDot(a.data(), b.data(), dim);
+    KATANA_LOG_VASSERT(std::abs(dot - expected) < 1e-4, "dim {}", dim);
+  }
+
+  std::vector<float> a{1, 0, 0};
+  std::vector<float> b{2, 2, 0};
+  float cosine = katana::EmbeddingCosine(a.data(), b.data(), a.size());
+  KATANA_LOG_ASSERT(std::abs(cosine - std::sqrt(0.5)) < 1e-6);
+  std::vector<float> zero(3, 0);
+  KATANA_LOG_ASSERT(katana::EmbeddingCosine(a.data(), zero.data(), 3) == 0);
+}
+
+void
+TestAllocate() {
+  using Aligned = katana::EmbeddingProperty<float, 16>;
+  static_assert(Aligned::kRowsAligned);
+  static_assert(!Embedding::kRowsAligned);
+
+  auto table = Aligned::Allocate(10, "aligned").value();
+  auto array = std::static_pointer_cast<arrow::FixedSizeListArray>(
+      table->column(0)->chunk(0));
+  auto view = Aligned::ViewType::Make(*array).value();
+  KATANA_LOG_ASSERT(view.size() == 10);
+  for (size_t i = 0; i < view.size(); ++i) {
+    KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(view.data(i)) % 64 == 0);
+    KATANA_LOG_ASSERT(view.IsValid(i));
+    KATANA_LOG_ASSERT(view[i][15] == 0);
+  }
+}
+
+/// The neighbors of query by brute force
+std::vector<katana::EmbeddingNeighbor>
+BruteForce(
+    const std::vector<std::vector<float>>& embeddings, const float* query,
+    size_t k, katana::EmbeddingSimilarity similarity, bool even_only) {
+  std::vector<katana::EmbeddingNeighbor> all;
+  for (uint32_t n = 0; n < embeddings.size(); ++n) {
+    if (even_only && n % 2 != 0) {
+      continue;
+    }
+    const float* embedding = embeddings[n].data();
+    float s = similarity == katana::EmbeddingSimilarity::kDot
+                  ? katana::EmbeddingDot(embedding, query, kDim)
+                  : katana::EmbeddingCosine(embedding, query, kDim);
+    all.emplace_back(katana::EmbeddingNeighbor{n, s});
+  }
+  std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) {
+    return a.similarity > b.similarity ||
+           (a.similarity == b.similarity && a.node < b.node);
+  });
+  all.resize(std::min(k, all.size()));
+  return all;
+}
+
+void
+TestNearestNeighbors() {
+  LinePolicy policy{1};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy, &txn_ctx);
+  auto table = Embedding::Allocate(kNumNodes, "embedding").value();
+  if (auto r = g->AddNodeProperties(table, &txn_ctx); !r) {
+    KATANA_LOG_FATAL("could not add node property: {}", r.error());
+  }
+
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::vector<std::vector<float>> embeddings(
+      kNumNodes, std::vector<float>(kDim));
+  using Graph = katana::TypedPropertyGraph<std::tuple<Embedding>, std::tuple<>>;
+  auto graph = Graph::Make(g.get(), {"embedding"}, {}).value();
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    auto embedding = graph.GetData<Embedding>(n);
+    for (size_t i = 0; i < kDim; ++i) {
+      embeddings[n][i] = dist(gen);
+      embedding[i] = embeddings[n][i];
+    }
+  }
+
+  constexpr size_t kNumQueries = 11;
+  std::vector<float> queries(kNumQueries * kDim);
+  for (float& value : queries) {
+    value = dist(gen);
+  }
+  katana::DynamicBitset even;
+  even.resize(kNumNodes);
+  for (uint32_t n = 0; n < kNumNodes; n += 2) {
+    even.set(n);
+  }
+
+  for (auto similarity :
+       {katana::EmbeddingSimilarity::kDot,
+        katana::EmbeddingSimilarity::kCosine}) {
+    for (bool even_only : {false, true}) {
+      auto neighbors = katana::EmbeddingNearestNeighbors(
+                           *g, "embedding", queries.data(), kNumQueries, 5,
+                           similarity, even_only ? &even : nullptr)
+                           .value();
+      KATANA_LOG_ASSERT(neighbors.size() == kNumQueries);
+      for (size_t q = 0; q < kNumQueries; ++q) {
+        auto expected = BruteForce(
+            embeddings, queries.data() + q * kDim, 5, similarity, even_only);
+        KATANA_LOG_ASSERT(neighbors[q].size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+          KATANA_LOG_VASSERT(
+              neighbors[q][i].node == expected[i].node, "query {} rank {}", q,
+              i);
+          KATANA_LOG_ASSERT(
+              neighbors[q][i].similarity == expected[i].similarity);
+        }
+      }
+    }
+  }
+
+  auto bad = katana::EmbeddingNearestNeighbors(
+      *g, g->loaded_node_schema()->field(0)->name(), queries.data(), 1, 1,
+      katana::EmbeddingSimilarity::kDot);
+  KATANA_LOG_ASSERT(!bad);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestDot();
+  TestAllocate();
+  TestNearestNeighbors();
+
+  return 0;
+}
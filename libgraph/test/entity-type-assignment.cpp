@@ -0,0 +1,122 @@
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "katana/EntityTypeAssignment.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+const std::vector<std::string> kNames{
+    "Person", "Place", "Post", "Comment", "Tag", ""};
+
+/// Up to four labels of kNames for every entity, some repeated or empty
+std::vector<std::vector<std::string_view>>
+MakeLabels(uint64_t num_entities) {
+  std::vector<std::vector<std::string_view>> labels(num_entities);
+  for (uint64_t i = 0; i < num_entities; ++i) {
+    uint64_t num_labels = katana::StatelessRandom(1, i) % 5;
+    for (uint64_t j = 0; j < num_labels; ++j) {
+      labels[i].emplace_back(
+          kNames[katana::StatelessRandom(2, i * 5 + j) % kNames.size()]);
+    }
+  }
+  return labels;
+}
+
+katana::PropertyGraph::EntityTypeIDArray
+Assign(
+    const std::vector<std::vector<std::string_view>>& labels,
+    katana::EntityTypeManager* manager) {
+  auto res = katana::AssignEntityTypes(
+      labels.size(),
+      [&](uint64_t i, std::vector<std::string_view>* out) {
+        out->insert(out->end(), labels[i].begin(), labels[i].end());
+      },
+      manager);
+  KATANA_LOG_VASSERT(res, "assigning types: {}", res.error());
+  return std::move(res.value());
+}
+
+void
+TestAssign() {
+  auto labels = MakeLabels(20000);
+  katana::EntityTypeManager manager;
+  auto types = Assign(labels, &manager);
+
+  for (uint64_t i = 0; i < labels.size(); ++i) {
+    katana::TypeNameSet expected;
+    for (std::string_view label : labels[i]) {
+      if (!label.empty()) {
+        expected.emplace(label);
+      }
+    }
+    auto names = manager.EntityTypeToTypeNameSet(types[i]);
+    KATANA_LOG_ASSERT(names);
+    KATANA_LOG_VASSERT(
+        names.value() == expected, "entity {}: {} rather than {}", i,
+        names.value(), expected);
+  }
+
+  // the ids do not depend on the threads, and known types are not added
+  // again
+  katana::setActiveThreads(1);
+  katana::EntityTypeManager serial_manager;
+  auto serial_types = Assign(labels, &serial_manager);
+  katana::setActiveThreads(4);
+  KATANA_LOG_ASSERT(
+      serial_manager.GetNumEntityTypes() == manager.GetNumEntityTypes());
+  auto again = Assign(labels, &manager);
+  KATANA_LOG_ASSERT(
+      serial_manager.GetNumEntityTypes() == manager.GetNumEntityTypes());
+  for (uint64_t i = 0; i < labels.size(); ++i) {
+    KATANA_LOG_ASSERT(serial_types[i] == types[i]);
+    KATANA_LOG_ASSERT(again[i] == types[i]);
+  }
+}
+
+void
+TestFindEntityType() {
+  katana::EntityTypeManager manager;
+  auto person = manager.AddAtomicEntityType("Person");
+  auto place = manager.AddAtomicEntityType("Place");
+  KATANA_LOG_ASSERT(person && place);
+  auto both = manager.GetOrAddNonAtomicEntityTypeFromStrings(
+      std::vector<std::string>{"Person", "Place"});
+  KATANA_LOG_ASSERT(both);
+
+  KATANA_LOG_ASSERT(manager.FindEntityType({}) == katana::kUnknownEntityType);
+  KATANA_LOG_ASSERT(manager.FindEntityType({person.value()}) == person.value());
+  KATANA_LOG_ASSERT(
+      manager.FindEntityType({person.value(), place.value()}) == both.value());
+  KATANA_LOG_ASSERT(
+      manager.FindEntityType({both.value()}) == katana::kInvalidEntityType);
+
+  // a manager made from the maps of another finds the same types
+  katana::EntityTypeManager copy(
+      katana::EntityTypeIDToAtomicTypeNameMap(
+          manager.GetEntityTypeIDToAtomicTypeNameMap()),
+      katana::EntityTypeIDToSetOfEntityTypeIDsMap(
+          manager.GetEntityTypeIDToAtomicEntityTypeIDs()));
+  KATANA_LOG_ASSERT(
+      copy.FindEntityType({person.value(), place.value()}) == both.value());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestAssign();
+  TestFindEntityType();
+
+  return 0;
+}
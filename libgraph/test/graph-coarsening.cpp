@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Arena.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/ClusteringImplementationBase.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Weight = uint32_t;
+using NodeData =
+    std::tuple<PreviousCommunityID, CurrentCommunityID, DegreeWeight<Weight>>;
+using EdgeData = std::tuple<EdgeWeight<Weight>>;
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+using Base = ClusteringImplementationBase<Graph, Weight, CommunityType<Weight>>;
+
+using WeightedEdges = std::vector<std::tuple<uint32_t, uint32_t, Weight>>;
+/// The out edges of every cluster as (cluster, weight)
+using Coarsened = std::vector<std::vector<std::pair<uint64_t, Weight>>>;
+
+/// The coarsened graph as the serial per cluster map built it: the clusters
+/// in order, their members by id and the edges of each member in order, each
+/// adjacent cluster appended when first seen and its weights summed
+Coarsened
+SerialCoarsening(
+    uint32_t num_nodes, const WeightedEdges& edges,
+    const std::vector<uint64_t>& clusters, uint64_t num_clusters) {
+  WeightedEdges ordered = OrderTestEdges(edges, false);
+  std::vector<std::vector<std::pair<uint32_t, Weight>>> out(num_nodes);
+  for (const auto& [src, dst, weight] : ordered) {
+    out[src].emplace_back(dst, weight);
+  }
+  Coarsened coarsened(num_clusters);
+  for (uint64_t c = 0; c < num_clusters; ++c) {
+    std::map<uint64_t, size_t> position;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      if (clusters[n] != c) {
+        continue;
+      }
+      for (const auto& [dst, weight] : out[n]) {
+        auto [it, inserted] =
+            position.emplace(clusters[dst], coarsened[c].size());
+        if (inserted) {
+          coarsened[c].emplace_back(clusters[dst], weight);
+        } else {
+          coarsened[c][it->second].second += weight;
+        }
+      }
+    }
+  }
+  return coarsened;
+}
+
+void
+CheckCoarsening(
+    uint32_t num_nodes, const WeightedEdges& edges,
+    const std::vector<uint64_t>& clusters, uint64_t num_clusters) {
+  auto pg = MakeWeightedTestGraph(num_nodes, edges);
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "previous", [&](uint64_t n) { return clusters[n]; }),
+      katana::PropertyGenerator(
+          "current", [&](uint64_t n) { return clusters[n]; }),
+      katana::PropertyGenerator("degree", [](uint64_t) { return Weight{0}; }));
+  KATANA_LOG_VASSERT(add_res, "adding clusters: {}", add_res.error());
+  auto graph_res =
+      Graph::Make(pg.get(), {"previous", "current", "degree"}, {"weight"});
+  KATANA_LOG_VASSERT(graph_res, "view: {}", graph_res.error());
+
+  auto pg_empty = std::make_unique<katana::PropertyGraph>();
+  katana::Arena scratch;
+  auto next_res = Base::GraphCoarsening<
+      NodeData, EdgeData, Weight, CurrentCommunityID>(
+      graph_res.value(), pg_empty.get(), num_clusters,
+      {"next_previous", "next_current", "next_degree"}, {"next_weight"},
+      &txn_ctx, &scratch);
+  KATANA_LOG_VASSERT(next_res, "coarsening: {}", next_res.error());
+  katana::PropertyGraph* next = next_res.value().get();
+
+  Coarsened expected =
+      SerialCoarsening(num_nodes, edges, clusters, num_clusters);
+  const auto& topology = next->topology();
+  KATANA_LOG_ASSERT(topology.NumNodes() == num_clusters);
+  std::vector<Weight> weights = EdgeValues<Weight>(next, "next_weight");
+  for (uint64_t c = 0; c < num_clusters; ++c) {
+    Coarsened::value_type found;
+    for (auto e : topology.OutEdges(c)) {
+      found.emplace_back(topology.OutEdgeDst(e), weights[e]);
+    }
+    KATANA_LOG_VASSERT(
+        found == expected[c], "edges of cluster {} differ from serial", c);
+  }
+}
+
+void
+TestSmall() {
+  // clusters {0, 1} and {2, 3}
+  WeightedEdges edges = {
+      {0, 1, 1}, {0, 2, 2}, {1, 3, 3}, {2, 3, 4}, {3, 0, 5}};
+  std::vector<uint64_t> clusters = {0, 0, 1, 1};
+  KATANA_LOG_ASSERT(
+      SerialCoarsening(4, edges, clusters, 2) ==
+      (Coarsened{{{0, 1}, {1, 5}}, {{1, 4}, {0, 5}}}));
+  CheckCoarsening(4, edges, clusters, 2);
+}
+
+void
+TestRandom() {
+  constexpr uint32_t kNumNodes = 3000;
+  std::mt19937 gen(15);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::uniform_int_distribution<Weight> weight(1, 9);
+  WeightedEdges edges;
+  for (uint32_t e = 0; e < 6 * kNumNodes; ++e) {
+    edges.emplace_back(node(gen), node(gen), weight(gen));
+  }
+
+  // many small clusters, and a few where one cluster has most nodes and so
+  // many more neighbors than the others
+  for (uint64_t num_clusters : {uint64_t{400}, uint64_t{3}}) {
+    std::vector<uint64_t> clusters(kNumNodes);
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      clusters[n] = n < num_clusters ? n : node(gen) % num_clusters;
+      if (num_clusters == 3 && n >= num_clusters && n % 10 != 0) {
+        clusters[n] = 0;
+      }
+    }
+    std::shuffle(clusters.begin(), clusters.end(), gen);
+    CheckCoarsening(kNumNodes, edges, clusters, num_clusters);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSmall();
+  TestRandom();
+
+  return 0;
+}
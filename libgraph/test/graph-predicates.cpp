@@ -24,6 +24,7 @@ TestIsApproximateDegreeDistributionPowerLaw() {
 
     KATANA_LOG_ASSERT(
         !katana::analytics::IsApproximateDegreeDistributionPowerLaw(*g.get()));
+    KATANA_LOG_ASSERT(!g->GetGraphStatistics().power_law);
   }
   {
     auto g = katana::PropertyGraph::Make(
@@ -32,6 +33,7 @@ TestIsApproximateDegreeDistributionPowerLaw() {
     KATANA_LOG_ASSERT(
         katana::analytics::IsApproximateDegreeDistributionPowerLaw(
             *g.assume_value().get()));
+    KATANA_LOG_ASSERT(g.assume_value()->GetGraphStatistics().power_law);
   }
 }
 
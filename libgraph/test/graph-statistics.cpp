@@ -0,0 +1,84 @@
+#include "katana/GraphStatistics.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/Planner.h"
+
+namespace {
+
+void
+TestGrid() {
+  // A mesh, as road networks are: even degrees and a large diameter
+  const size_t kWidth = 100;
+  auto pg = katana::MakeGrid(kWidth, kWidth, false);
+  katana::GraphStatistics stats = pg->GetGraphStatistics();
+
+  KATANA_LOG_ASSERT(stats.num_nodes == kWidth * kWidth);
+  KATANA_LOG_ASSERT(stats.num_edges == pg->NumEdges());
+  KATANA_LOG_ASSERT(stats.max_degree == 4);
+  KATANA_LOG_ASSERT(!stats.power_law);
+  KATANA_LOG_ASSERT(stats.symmetric && stats.symmetry == 1);
+  // Double sweeps from any node of a grid end in opposite corners
+  KATANA_LOG_ASSERT(stats.estimated_diameter == 2 * (kWidth - 1));
+  KATANA_LOG_ASSERT(!stats.small_world());
+
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseBfsPlan(stats).algorithm() ==
+      katana::analytics::BfsPlan::kAsynchronous);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseSsspPlan(stats).algorithm() ==
+      katana::analytics::SsspPlan::kDeltaStepBarrier);
+  KATANA_LOG_ASSERT(
+      !katana::analytics::ChooseTriangleCountPlan(stats).hub_bitmaps());
+}
+
+void
+TestClique() {
+  const size_t kNumNodes = 100;
+  auto pg = katana::MakeClique(kNumNodes);
+  katana::GraphStatistics stats = pg->GetGraphStatistics();
+
+  KATANA_LOG_ASSERT(stats.max_degree == kNumNodes - 1);
+  KATANA_LOG_ASSERT(stats.median_degree == kNumNodes - 1);
+  KATANA_LOG_ASSERT(!stats.power_law);
+  KATANA_LOG_ASSERT(stats.symmetric);
+  KATANA_LOG_ASSERT(stats.estimated_diameter == 1);
+  KATANA_LOG_ASSERT(stats.small_world());
+
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseBfsPlan(stats).algorithm() ==
+      katana::analytics::BfsPlan::kSynchronousDirectOpt);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ChooseConnectedComponentsPlan(stats).algorithm() ==
+      katana::analytics::ConnectedComponentsPlan::kAfforest);
+
+  // The statistics are computed once and then cached
+  katana::GraphStatistics again = pg->GetGraphStatistics();
+  KATANA_LOG_ASSERT(again.ToString() == stats.ToString());
+  katana::GraphStatistics computed =
+      katana::ComputeGraphStatistics(pg->topology());
+  KATANA_LOG_ASSERT(computed.ToString() == stats.ToString());
+}
+
+void
+TestEmpty() {
+  auto res = katana::PropertyGraph::Make(katana::GraphTopology{});
+  KATANA_LOG_ASSERT(res);
+  katana::GraphStatistics stats = res.value()->GetGraphStatistics();
+  KATANA_LOG_ASSERT(stats.num_nodes == 0 && stats.num_edges == 0);
+  KATANA_LOG_ASSERT(stats.estimated_diameter == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestGrid();
+  TestClique();
+  TestEmpty();
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/LC_Morph_Graph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Graph = katana::LC_Morph_Graph<uint32_t, uint64_t, true>;
+using GNode = Graph::GraphNode;
+
+constexpr uint32_t kNumNodes = 1000;
+constexpr uint32_t kNumHubs = 4;
+// edges appended to each hub, by every node
+constexpr uint32_t kEdgesPerHub = kNumNodes;
+// edges appended to each other node, by the hubs; most are left unused
+constexpr uint32_t kEdgesPerNode = 2;
+constexpr uint32_t kCapacity = 8;
+
+std::vector<GNode>
+MakeNodes(Graph& g) {
+  std::vector<GNode> nodes;
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    nodes.emplace_back(g.createNode(i < kNumHubs ? kEdgesPerHub : kCapacity));
+    g.getData(nodes.back()) = i;
+  }
+  return nodes;
+}
+
+void
+CheckEdges(Graph& g, const std::vector<GNode>& nodes) {
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    GNode n = nodes[i];
+    std::vector<uint32_t> counts(kNumNodes);
+    uint64_t num_edges = 0;
+    for (auto e : g.edges(n, katana::MethodFlag::UNPROTECTED)) {
+      uint32_t dst = g.getData(g.getEdgeDst(e));
+      KATANA_LOG_ASSERT(g.getEdgeData(e) == uint64_t{i} * kNumNodes + dst);
+      ++counts[dst];
+      ++num_edges;
+    }
+    if (i < kNumHubs) {
+      KATANA_LOG_ASSERT(num_edges == kEdgesPerHub);
+      for (uint32_t c : counts) {
+        KATANA_LOG_ASSERT(c == 1);
+      }
+    } else {
+      KATANA_LOG_ASSERT(num_edges == kEdgesPerNode);
+    }
+  }
+}
+
+void
+TestAppendEdge() {
+  Graph g;
+  std::vector<GNode> nodes = MakeNodes(g);
+
+  // every node appends an edge to each hub at once, and the hubs append to
+  // every other node
+  katana::do_all(katana::iterate(uint32_t{0}, kNumNodes), [&](uint32_t i) {
+    for (uint32_t h = 0; h < kNumHubs; ++h) {
+      g.appendEdge(nodes[h], nodes[i], uint64_t{h} * kNumNodes + i);
+    }
+  });
+  katana::do_all(katana::iterate(kNumHubs, kNumNodes), [&](uint32_t i) {
+    for (uint32_t h = 0; h < kEdgesPerNode; ++h) {
+      g.appendEdge(nodes[i], nodes[h], uint64_t{i} * kNumNodes + h);
+    }
+  });
+  CheckEdges(g, nodes);
+
+  g.compactEdges();
+  CheckEdges(g, nodes);
+
+  // the edges of consecutive nodes are adjacent
+  Graph::edge_iterator prev_end{};
+  uint64_t total = 0;
+  for (GNode n : g) {
+    auto begin = g.edge_begin(n, katana::MethodFlag::UNPROTECTED);
+    auto end = g.edge_end(n, katana::MethodFlag::UNPROTECTED);
+    KATANA_LOG_ASSERT(total == 0 || begin == prev_end);
+    prev_end = end;
+    total += std::distance(begin, end);
+  }
+  KATANA_LOG_ASSERT(
+      total ==
+      kNumHubs * kEdgesPerHub + (kNumNodes - kNumHubs) * kEdgesPerNode);
+
+  // nodes created after compaction can still get edges
+  GNode late = g.createNode(1);
+  g.getData(late) = kNumNodes;
+  g.appendEdge(late, nodes[0], uint64_t{0});
+  KATANA_LOG_ASSERT(
+      g.getEdgeDst(g.edge_begin(late, katana::MethodFlag::UNPROTECTED)) ==
+      nodes[0]);
+
+  // compacting again moves the edges of compacted and new nodes
+  g.compactEdges();
+  CheckEdges(g, nodes);
+}
+
+/// Edges whose data counts its live copies
+struct Counted {
+  static inline std::atomic<int> num_live{0};
+  uint32_t value;
+
+  explicit Counted(uint32_t v) : value(v) { ++num_live; }
+  Counted(Counted&& other) noexcept : value(other.value) { ++num_live; }
+  ~Counted() { --num_live; }
+};
+
+void
+TestCompactEdgeData() {
+  {
+    katana::LC_Morph_Graph<uint32_t, Counted, true> g;
+    std::vector<decltype(g)::GraphNode> nodes;
+    for (uint32_t i = 0; i < 100; ++i) {
+      nodes.emplace_back(g.createNode(4));
+    }
+    katana::do_all(
+        katana::iterate(uint32_t{0}, uint32_t{100}),
+        [&](uint32_t i) { g.appendEdge(nodes[i % 10], nodes[i], i); });
+    KATANA_LOG_ASSERT(Counted::num_live == 100);
+
+    g.compactEdges();
+    KATANA_LOG_ASSERT(Counted::num_live == 100);
+    uint32_t sum = 0;
+    for (auto n : g) {
+      for (auto e : g.edges(n, katana::MethodFlag::UNPROTECTED)) {
+        sum += g.getEdgeData(e).value;
+      }
+    }
+    KATANA_LOG_ASSERT(sum == 99 * 100 / 2);
+  }
+  KATANA_LOG_ASSERT(Counted::num_live == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestAppendEdge();
+  TestCompactEdgeData();
+
+  return 0;
+}
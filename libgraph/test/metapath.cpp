@@ -0,0 +1,170 @@
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/RDG.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/metapath/metapath.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+using namespace katana::analytics;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+namespace {
+
+/// Person -LIKES-> Comment -HAS_CREATOR-> Person
+const Metapath kLikedAuthors{
+    "Person", {{"LIKES", "Comment", false}, {"HAS_CREATOR", "Person", false}}};
+
+/// Person <-HAS_CREATOR- Comment -HAS_CREATOR-> Person, which only leads back
+/// to the start
+const Metapath kSelfByComments{
+    "Person",
+    {{"HAS_CREATOR", "Comment", true}, {"HAS_CREATOR", "Person", false}}};
+
+/// Whether the graph has an edge from src to dst of the type named edge_type
+bool
+HasEdge(
+    const katana::PropertyGraph& pg, uint32_t src, uint32_t dst,
+    const std::string& edge_type) {
+  katana::EntityTypeID type =
+      pg.GetEdgeTypeManager().GetEntityTypeID(edge_type);
+  const katana::GraphTopology& topo = pg.topology();
+  for (auto e : topo.OutEdges(src)) {
+    if (topo.OutEdgeDst(e) == dst && pg.GetTypeOfEdgeFromTopoIndex(e) == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Checks that instance follows the edges and node types of metapath
+void
+CheckInstance(
+    const katana::PropertyGraph& pg, const Metapath& metapath,
+    const MetapathTraversal::Instance& instance) {
+  KATANA_LOG_ASSERT(instance.size() == metapath.steps.size() + 1);
+  const auto& node_types = pg.GetNodeTypeManager();
+  KATANA_LOG_ASSERT(pg.DoesNodeHaveType(
+      instance[0], node_types.GetEntityTypeID(metapath.start_node_type)));
+  for (size_t i = 0; i < metapath.steps.size(); ++i) {
+    const MetapathStep& step = metapath.steps[i];
+    uint32_t from = instance[i];
+    uint32_t to = instance[i + 1];
+    KATANA_LOG_ASSERT(
+        step.reverse ? HasEdge(pg, to, from, step.edge_type)
+                     : HasEdge(pg, from, to, step.edge_type));
+    KATANA_LOG_ASSERT(
+        pg.DoesNodeHaveType(to, node_types.GetEntityTypeID(step.node_type)));
+  }
+}
+
+katana::Result<void>
+TestCounts(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  auto traversal = KATANA_CHECKED(MetapathTraversal::Make(pg, kLikedAuthors));
+  KATANA_CHECKED(traversal.CountInstances("liked-authors", txn_ctx));
+  auto column = KATANA_CHECKED(pg->GetNodeProperty("liked-authors"));
+  auto counts = std::static_pointer_cast<arrow::UInt64Array>(column->chunk(0));
+
+  std::vector<uint32_t> sources(pg->NumNodes());
+  std::iota(sources.begin(), sources.end(), 0);
+  auto endpoints = KATANA_CHECKED(traversal.CountEndpoints(sources));
+  auto instances = KATANA_CHECKED(
+      traversal.Materialize(sources, std::numeric_limits<uint64_t>::max()));
+
+  uint64_t total = 0;
+  for (uint32_t n : sources) {
+    uint64_t sum = 0;
+    for (const auto& [end, count] : endpoints[n]) {
+      sum += count;
+    }
+    KATANA_LOG_VASSERT(
+        sum == counts->Value(n), "node {}: {} != {}", n, sum,
+        counts->Value(n));
+    total += sum;
+  }
+  KATANA_LOG_ASSERT(total > 0);
+  KATANA_LOG_ASSERT(instances.size() == total);
+  for (const auto& instance : instances) {
+    CheckInstance(*pg, kLikedAuthors, instance);
+  }
+
+  // the cap applies to each source
+  auto capped = KATANA_CHECKED(traversal.Materialize(sources, 1));
+  uint64_t num_started = 0;
+  for (uint32_t n : sources) {
+    num_started += counts->Value(n) > 0;
+  }
+  KATANA_LOG_ASSERT(capped.size() == num_started);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestReverseStep(katana::PropertyGraph* pg) {
+  auto traversal =
+      KATANA_CHECKED(MetapathTraversal::Make(pg, kSelfByComments));
+  std::vector<uint32_t> sources(pg->NumNodes());
+  std::iota(sources.begin(), sources.end(), 0);
+  auto endpoints = KATANA_CHECKED(traversal.CountEndpoints(sources));
+  for (uint32_t n : sources) {
+    KATANA_LOG_ASSERT(endpoints[n].size() <= 1);
+    if (!endpoints[n].empty()) {
+      KATANA_LOG_ASSERT(endpoints[n][0].first == n);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestSample(katana::PropertyGraph* pg) {
+  auto traversal = KATANA_CHECKED(MetapathTraversal::Make(pg, kLikedAuthors));
+  std::vector<uint32_t> sources(pg->NumNodes());
+  std::iota(sources.begin(), sources.end(), 0);
+
+  auto walks = KATANA_CHECKED(traversal.Sample(sources, 3, 7));
+  KATANA_LOG_ASSERT(!walks.empty());
+  for (const auto& walk : walks) {
+    CheckInstance(*pg, kLikedAuthors, walk);
+  }
+  auto again = KATANA_CHECKED(traversal.Sample(sources, 3, 7));
+  KATANA_LOG_ASSERT(again == walks);
+
+  KATANA_LOG_ASSERT(!traversal.Sample({uint32_t(pg->NumNodes())}, 1));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  katana::TxnContext txn_ctx;
+  auto pg_res = katana::PropertyGraph::Make(
+      inputFile, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  KATANA_LOG_ASSERT(!MetapathTraversal::Make(
+      pg, Metapath{"Person", {{"NO_SUCH_TYPE", "", false}}}));
+  KATANA_LOG_ASSERT(!MetapathTraversal::Make(pg, Metapath{"Person", {}}));
+
+  auto res = TestCounts(pg, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = TestReverseStep(pg);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = TestSample(pg);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "TestCommHosts.h"
+#include "katana/Logging.h"
+#include "katana/MirrorSync.h"
+#include "katana/TcpCommBackend.h"
+
+namespace {
+
+constexpr uint32_t kNumHosts = 3;
+constexpr uint32_t kNumOwned = 200;
+
+/// Every host owns kNumOwned nodes, local ids [0, kNumOwned), and mirrors
+/// the nodes of every other host, in rank order after its own
+struct Partition {
+  uint32_t rank;
+
+  uint32_t num_nodes() const { return kNumOwned * kNumHosts; }
+
+  uint32_t ToGlobal(uint32_t local) const {
+    uint32_t host = local / kNumOwned;
+    // Local blocks are this host's, then the others' in rank order
+    uint32_t owner = host == 0 ? rank : (host <= rank ? host - 1 : host);
+    return owner * kNumOwned + local % kNumOwned;
+  }
+
+  uint32_t MirrorBase(uint32_t owner) const {
+    return (owner < rank ? owner + 1 : owner) * kNumOwned;
+  }
+
+  katana::MirrorSync MakeSync(katana::CommBackend* comm) const {
+    std::vector<std::vector<uint32_t>> masters(kNumHosts);
+    std::vector<std::vector<uint32_t>> mirrors(kNumHosts);
+    for (uint32_t h = 0; h < kNumHosts; ++h) {
+      if (h == rank) {
+        continue;
+      }
+      for (uint32_t i = 0; i < kNumOwned; ++i) {
+        masters[h].emplace_back(i);
+        mirrors[h].emplace_back(MirrorBase(h) + i);
+      }
+    }
+    auto sync_res = katana::MirrorSync::Make(
+        comm, num_nodes(), std::move(masters), std::move(mirrors));
+    KATANA_LOG_VASSERT(sync_res, "{}", sync_res.error());
+    return std::move(sync_res.value());
+  }
+};
+
+bool
+Min(uint64_t& master, const uint64_t& mirror) {
+  if (mirror < master) {
+    master = mirror;
+    return true;
+  }
+  return false;
+}
+
+/// Every copy of every node gets the minimum over its copies
+void
+TestFullSync(katana::CommBackend* comm, const Partition& part) {
+  katana::MirrorSync sync = part.MakeSync(comm);
+  std::vector<uint64_t> values(part.num_nodes());
+  for (uint32_t n = 0; n < part.num_nodes(); ++n) {
+    values[n] = (part.ToGlobal(n) * 7 + part.rank * 3) % 11;
+    sync.MarkDirty(n);
+  }
+  sync.Sync(values.data(), Min);
+
+  for (uint32_t n = 0; n < part.num_nodes(); ++n) {
+    uint64_t expected = 11;
+    for (uint32_t h = 0; h < kNumHosts; ++h) {
+      expected =
+          std::min<uint64_t>(expected, (part.ToGlobal(n) * 7 + h * 3) % 11);
+    }
+    KATANA_LOG_VASSERT(
+        values[n] == expected, "node {}: {} != {}", n, values[n], expected);
+  }
+  KATANA_LOG_ASSERT(sync.dirty().count() == 0);
+}
+
+/// Only dirty values move, and few of them in a small message
+void
+TestSparseSync(katana::CommBackend* comm, const Partition& part) {
+  katana::MirrorSync sync = part.MakeSync(comm);
+  std::vector<uint64_t> values(part.num_nodes(), 100);
+
+  // Host 1 lowers its mirror of the first node of host 0
+  if (part.rank == 1) {
+    uint32_t mirror = part.MirrorBase(0);
+    values[mirror] = 5;
+    sync.MarkDirty(mirror);
+  }
+  sync.Sync(values.data(), Min);
+
+  for (uint32_t n = 0; n < part.num_nodes(); ++n) {
+    uint64_t expected = part.ToGlobal(n) == 0 ? 5 : 100;
+    KATANA_LOG_ASSERT(values[n] == expected);
+    KATANA_LOG_ASSERT(sync.updated().test(n) == (part.ToGlobal(n) == 0));
+  }
+  // A position and a value per message, rather than a value per node
+  uint64_t sent = comm->AllReduceSum({sync.num_bytes_sent()})[0];
+  KATANA_LOG_VASSERT(sent < 100, "sent {} bytes", sent);
+
+  // Nothing dirty, nothing sent
+  sync.Sync(values.data(), Min);
+  KATANA_LOG_ASSERT(comm->AllReduceSum({sync.num_bytes_sent()})[0] == sent);
+  KATANA_LOG_ASSERT(sync.updated().count() == 0);
+}
+
+/// Half of the masters changed, which a bitset encodes best
+void
+TestBroadcast(katana::CommBackend* comm, const Partition& part) {
+  katana::MirrorSync sync = part.MakeSync(comm);
+  std::vector<uint64_t> values(part.num_nodes(), 0);
+  for (uint32_t n = 0; n < kNumOwned; n += 2) {
+    values[n] = part.ToGlobal(n) + 1;
+    sync.MarkDirty(n);
+  }
+  sync.BroadcastToMirrors(values.data());
+
+  for (uint32_t n = 0; n < part.num_nodes(); ++n) {
+    uint32_t global = part.ToGlobal(n);
+    KATANA_LOG_ASSERT(values[n] == (global % 2 == 0 ? global + 1 : 0));
+  }
+}
+
+void
+RunHost(uint32_t rank, const std::vector<std::string>& addresses) {
+  auto comm_res = katana::TcpCommBackend::Make(rank, addresses);
+  KATANA_LOG_VASSERT(comm_res, "{}", comm_res.error());
+  std::unique_ptr<katana::TcpCommBackend> comm = std::move(comm_res.value());
+  Partition part{rank};
+
+  TestFullSync(comm.get(), part);
+  TestSparseSync(comm.get(), part);
+  TestBroadcast(comm.get(), part);
+
+  KATANA_LOG_ASSERT(!katana::MirrorSync::Make(comm.get(), 1, {{}, {}}, {}));
+  KATANA_LOG_ASSERT(
+      !katana::MirrorSync::Make(comm.get(), 1, {{7}, {7}, {7}}, {}));
+}
+
+}  // namespace
+
+int
+main() {
+  RunHostThreads(kNumHosts, RunHost);
+
+  return 0;
+}
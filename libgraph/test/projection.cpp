@@ -108,5 +108,30 @@ main(int argc, char** argv) {
       "\n Num Valid Nodes: {} Num Nodes: {}", num_valid_nodes,
       typed_pg_view.NumNodes());
 
+  // The lazy projection selects the same nodes and edges without
+  // materializing them, and is cached
+  std::shared_ptr<const katana::LazyProjectedGraph> lazy =
+      full_graph.GetLazyProjectedGraph(node_types, edge_types);
+  KATANA_LOG_VASSERT(
+      lazy->NumNodes() == pg_view->NumNodes(),
+      "\n Lazy Num Nodes: {} Num Nodes: {}", lazy->NumNodes(),
+      pg_view->NumNodes());
+  KATANA_LOG_VASSERT(
+      lazy->NumEdges() == pg_view->NumEdges(),
+      "\n Lazy Num Edges: {} Num Edges: {}", lazy->NumEdges(),
+      pg_view->NumEdges());
+  KATANA_LOG_ASSERT(
+      full_graph.GetLazyProjectedGraph(node_types, edge_types) == lazy);
+
+  auto materialized = katana::PropertyGraph::MakeProjectedGraph(*lazy);
+  KATANA_LOG_ASSERT(materialized->NumNodes() == pg_view->NumNodes());
+  KATANA_LOG_ASSERT(materialized->NumEdges() == pg_view->NumEdges());
+  for (GNode n = 0; n < pg_view->NumNodes(); ++n) {
+    KATANA_LOG_ASSERT(
+        materialized->GetNodePropertyIndex(n) ==
+        pg_view->GetNodePropertyIndex(n));
+    KATANA_LOG_ASSERT(lazy->HasNode(pg_view->GetNodePropertyIndex(n)));
+  }
+
   return 0;
 }
@@ -0,0 +1,100 @@
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyColumn.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+
+namespace {
+
+using Value = katana::PODProperty<uint32_t>;
+
+/// Test that a column becomes a property without a copy, and that property
+/// views can write into it
+void
+TestAddNodeProperty(size_t num_nodes) {
+  LinePolicy policy{3};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 1, &policy, &txn_ctx);
+
+  auto column = katana::PropertyColumn<uint32_t>::MakeBlocked(g->NumNodes());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, static_cast<uint32_t>(column.size())),
+      [&](uint32_t n) { column[n] = 2 * n; });
+  const uint32_t* values = column.data();
+
+  if (auto r = g->AddNodeProperty("value", std::move(column), &txn_ctx); !r) {
+    KATANA_LOG_FATAL("could not add node property: {}", r.error());
+  }
+  KATANA_LOG_ASSERT(column.empty());
+
+  auto array = g->GetNodePropertyTyped<uint32_t>("value").value();
+  KATANA_LOG_ASSERT(array->raw_values() == values);
+  for (size_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(array->Value(n) == 2 * n, "node {}", n);
+  }
+
+  using Graph = katana::TypedPropertyGraph<std::tuple<Value>, std::tuple<>>;
+  auto graph = Graph::Make(g.get(), {"value"}, {});
+  if (!graph) {
+    KATANA_LOG_FATAL("could not make typed graph: {}", graph.error());
+  }
+  graph.value().GetData<Value>(0) = 7;
+  KATANA_LOG_ASSERT(array->Value(0) == 7);
+
+  auto upsert = katana::PropertyColumn<uint32_t>::MakeInterleaved(num_nodes);
+  std::fill(upsert.begin(), upsert.end(), 1);
+  if (auto r = g->UpsertNodeProperty("value", std::move(upsert), &txn_ctx);
+      !r) {
+    KATANA_LOG_FATAL("could not upsert node property: {}", r.error());
+  }
+  auto upserted = g->GetNodePropertyTyped<uint32_t>("value").value();
+  KATANA_LOG_ASSERT(upserted->Value(0) == 1);
+
+  auto too_short = katana::PropertyColumn<uint32_t>::MakeBlocked(1);
+  auto r = g->AddNodeProperty("short", std::move(too_short), &txn_ctx);
+  KATANA_LOG_ASSERT(r.error() == katana::ErrorCode::InvalidArgument);
+}
+
+/// Test that edge columns become properties by edge
+void
+TestAddEdgeProperty(size_t num_nodes) {
+  LinePolicy policy{2};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 1, &policy, &txn_ctx);
+
+  auto column =
+      katana::PropertyColumn<uint64_t>::MakeInterleaved(g->NumEdges());
+  for (size_t e = 0; e < column.size(); ++e) {
+    column[e] = e;
+  }
+  if (auto r = g->AddEdgeProperty("id", std::move(column), &txn_ctx); !r) {
+    KATANA_LOG_FATAL("could not add edge property: {}", r.error());
+  }
+
+  auto array = g->GetEdgePropertyTyped<uint64_t>("id").value();
+  KATANA_LOG_ASSERT(static_cast<uint64_t>(array->length()) == g->NumEdges());
+  for (uint64_t e = 0; e < g->NumEdges(); ++e) {
+    KATANA_LOG_ASSERT(array->Value(e) == e);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestAddNodeProperty(10);
+  TestAddEdgeProperty(10);
+
+  return 0;
+}
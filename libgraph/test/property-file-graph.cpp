@@ -1,11 +1,16 @@
+#include <set>
+#include <string>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/ContentHash.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
 #include "katana/URI.h"
+#include "katana/analytics/PropertyRequirements.h"
 
 namespace {
 
@@ -456,8 +461,529 @@ TestTopologyAccess() {
   }
   KATANA_LOG_ASSERT(n_nodes == 10);
 }
+
+void
+TestTopologyMappedInPlace() {
+  RandomPolicy policy{3};
+  katana::TxnContext txn_ctx;
+  auto g = MakeFileGraph<uint32_t>(10, 1, &policy, &txn_ctx);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.map_topology_in_place = true;
+  opts.topology_map_advice = katana::FileView::MapAdvice::kRandom;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  auto make_sorted_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  // The mapping outlives the files it maps
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  if (!make_sorted_result) {
+    KATANA_LOG_FATAL("making result: {}", make_sorted_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  std::unique_ptr<katana::PropertyGraph> g3 =
+      std::move(make_sorted_result.value());
+
+  KATANA_LOG_ASSERT(g2->topology().in_place());
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+
+  katana::GraphTopology copy = katana::GraphTopology::Copy(g2->topology());
+  KATANA_LOG_ASSERT(!copy.in_place());
+  KATANA_LOG_ASSERT(copy.Equals(g->topology()));
+
+  // Sorts change the topology in place, so they copy the read-only mapping
+  // first
+  auto sorted_res = katana::SortAllEdgesByDest(g2.get());
+  KATANA_LOG_VASSERT(sorted_res, "{}", sorted_res.error());
+  KATANA_LOG_ASSERT(!g2->topology().in_place());
+  KATANA_LOG_ASSERT(katana::SortAllEdgesByDest(g.get()));
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+
+  KATANA_LOG_ASSERT(g3->topology().in_place());
+  auto by_degree_res = katana::SortNodesByDegree(g3.get());
+  KATANA_LOG_VASSERT(by_degree_res, "{}", by_degree_res.error());
+  KATANA_LOG_ASSERT(!g3->topology().in_place());
+  KATANA_LOG_ASSERT(g3->NumNodes() == g->NumNodes());
+  KATANA_LOG_ASSERT(g3->NumEdges() == g->NumEdges());
+  for (uint32_t n = 1; n < g3->NumNodes(); ++n) {
+    KATANA_LOG_ASSERT(
+        g3->topology().OutDegree(n - 1) >= g3->topology().OutDegree(n));
+  }
+}
+
+std::set<std::string>
+ListFiles(const std::string& dir) {
+  std::set<std::string> files;
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    files.emplace(entry.path().filename().string());
+  }
+  return files;
+}
+
+void
+TestCommitWritesOnlyChanges() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<uint8_t>("node-name", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs(&txn_ctx));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // only the new property, the part header and the manifest are written
+  std::set<std::string> before = ListFiles(rdg_dir);
+  KATANA_LOG_ASSERT(g2->AddNodeProperties(
+      MakeProps<int64_t>("node-added", test_length), &txn_ctx));
+  auto commit_result = g2->Commit(command_line);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", commit_result.error());
+  }
+  for (const std::string& file : ListFiles(rdg_dir)) {
+    if (before.count(file) == 0) {
+      KATANA_LOG_VASSERT(
+          file.find("topology") == std::string::npos &&
+              file.find("entity_type_id_array") == std::string::npos,
+          "commit rewrote {}", file);
+    }
+  }
+
+  // dropping the node type changes only the node entity type ids
+  before = ListFiles(rdg_dir);
+  KATANA_LOG_ASSERT(g2->RemoveNodeProperty("node-name", &txn_ctx));
+  KATANA_LOG_ASSERT(g2->ConstructEntityTypeIDs(&txn_ctx));
+  commit_result = g2->Commit(command_line);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", commit_result.error());
+  }
+  size_t new_node_type_files = 0;
+  for (const std::string& file : ListFiles(rdg_dir)) {
+    if (before.count(file) == 0) {
+      KATANA_LOG_VASSERT(
+          file.find("edge_entity_type_id_array") == std::string::npos,
+          "commit rewrote {}", file);
+      if (file.find("node_entity_type_id_array") != std::string::npos) {
+        ++new_node_type_files;
+      }
+    }
+  }
+  KATANA_LOG_ASSERT(new_node_type_files == 1);
+
+  make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(make_result.value()->Equals(g2.get()));
+}
+
+void
+TestPrefetchAndPinProperties() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-a", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-b", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<uint32_t>("edge-a", g->NumEdges()), &txn_ctx));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>{};
+  opts.edge_properties = std::vector<std::string>{};
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->ListLoadedNodeProperties().empty());
+
+  katana::analytics::PropertyRequirements requirements;
+  requirements.AddNodeProperty("node-a")
+      .AddNodeProperty("node-b")
+      .AddNodeProperty("node-a")
+      .AddEdgeProperty("edge-a")
+      .AddEdgeProperty("");
+  KATANA_LOG_ASSERT(requirements.node_properties.size() == 2);
+  KATANA_LOG_ASSERT(requirements.edge_properties.size() == 1);
+
+  {
+    auto pins_result =
+        katana::analytics::PinnedProperties::Make(g2.get(), requirements);
+    if (!pins_result) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("pinning result: {}", pins_result.error());
+    }
+    auto pins = std::move(pins_result.value());
+    KATANA_LOG_ASSERT(g2->HasNodeProperty("node-a"));
+    KATANA_LOG_ASSERT(g2->HasNodeProperty("node-b"));
+    KATANA_LOG_ASSERT(g2->HasEdgeProperty("edge-a"));
+    KATANA_LOG_ASSERT(g2->GetNodeProperty("node-b").value()->Equals(
+        g->GetNodeProperty("node-b").value()));
+
+    // pinned properties stay loaded
+    KATANA_LOG_ASSERT(!g2->UnloadNodeProperty("node-a"));
+    KATANA_LOG_ASSERT(!g2->UnloadEdgeProperty("edge-a"));
+
+    // a second pin of a loaded property loads nothing and outlives the first
+    katana::analytics::PropertyRequirements node_a;
+    node_a.AddNodeProperty("node-a");
+    auto inner = katana::analytics::PinnedProperties::Make(g2.get(), node_a);
+    KATANA_LOG_ASSERT(inner);
+    pins = katana::analytics::PinnedProperties();
+    KATANA_LOG_ASSERT(g2->IsNodePropertyPinned("node-a"));
+    KATANA_LOG_ASSERT(!g2->IsNodePropertyPinned("node-b"));
+  }
+  KATANA_LOG_ASSERT(!g2->IsNodePropertyPinned("node-a"));
+  KATANA_LOG_ASSERT(g2->UnloadNodeProperty("node-a"));
+  KATANA_LOG_ASSERT(g2->UnloadEdgeProperty("edge-a"));
+
+  // properties that are not in storage are reported rather than skipped
+  katana::analytics::PropertyRequirements missing;
+  missing.AddNodeProperty("node-missing");
+  KATANA_LOG_ASSERT(
+      !katana::analytics::PinnedProperties::Make(g2.get(), missing));
+  fs::remove_all(rdg_dir);
+}
+
+void
+TestLoadVersion() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-a", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-b", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<uint32_t>("edge-a", g->NumEdges()), &txn_ctx));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // the next version changes one property and adds another
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  uint64_t first_version = g2->CurrentVersion().value();
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(
+      MakeProps<int32_t>("node-b", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g2->AddNodeProperties(
+      MakeProps<int64_t>("node-added", test_length), &txn_ctx));
+  auto commit_result = g2->Commit(command_line);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", commit_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.share_loaded_files = true;
+  make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> today = std::move(make_result.value());
+  auto version_result = today->LoadVersion(first_version, &txn_ctx);
+  if (!version_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("loading version result: {}", version_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> yesterday =
+      std::move(version_result.value());
+  KATANA_LOG_ASSERT(yesterday->CurrentVersion().value() == first_version);
+
+  // what did not change is shared rather than loaded again
+  KATANA_LOG_ASSERT(&yesterday->topology() == &today->topology());
+  KATANA_LOG_ASSERT(
+      yesterday->GetNodeProperty("node-a").value() ==
+      today->GetNodeProperty("node-a").value());
+  KATANA_LOG_ASSERT(
+      yesterday->GetEdgeProperty("edge-a").value() ==
+      today->GetEdgeProperty("edge-a").value());
+  KATANA_LOG_ASSERT(
+      yesterday->GetNodeProperty("node-b").value() !=
+      today->GetNodeProperty("node-b").value());
+
+  auto diff_result = today->Diff(*yesterday);
+  KATANA_LOG_ASSERT(diff_result);
+  katana::PropertyGraphDiff diff = std::move(diff_result.value());
+  KATANA_LOG_ASSERT(!diff.topology_changed);
+  KATANA_LOG_ASSERT(
+      diff.node_properties.added == std::vector<std::string>{"node-added"});
+  KATANA_LOG_ASSERT(diff.node_properties.removed.empty());
+  KATANA_LOG_ASSERT(
+      diff.node_properties.changed == std::vector<std::string>{"node-b"});
+  KATANA_LOG_ASSERT(diff.edge_properties.empty());
+  KATANA_LOG_ASSERT(yesterday->Diff(*yesterday).value().empty());
+
+  // changing a topology in place gives that graph one of its own
+  KATANA_LOG_ASSERT(katana::SortAllEdgesByDest(yesterday.get()));
+  KATANA_LOG_ASSERT(&yesterday->topology() != &today->topology());
+  fs::remove_all(rdg_dir);
+}
+
 }  // namespace
 
+/// Hashes do not depend on how columns are split into Arrow chunks, and
+/// Equals and ReportDiff compare graphs by their hashes
+void
+TestContentHash() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  auto whole = MakeProps<int64_t>("node-a", test_length)->column(0);
+  arrow::ChunkedArray split(
+      {whole->chunk(0)->Slice(0, 3), whole->chunk(0)->Slice(3)});
+  auto hash = katana::ContentHash::OfColumn(*whole, 4);
+  auto split_hash = katana::ContentHash::OfColumn(split, 4);
+  KATANA_LOG_ASSERT(hash && split_hash);
+  KATANA_LOG_ASSERT(hash.value() == split_hash.value());
+  KATANA_LOG_ASSERT(hash.value().chunks.size() == 3);
+  KATANA_LOG_ASSERT(hash.value().ChunkLength(2) == 2);
+
+  arrow::Int64Builder builder;
+  for (size_t i = 0; i < test_length; ++i) {
+    int64_t value = i == 5 ? -1 : static_cast<int64_t>(i);
+    KATANA_LOG_ASSERT(builder.Append(value).ok());
+  }
+  std::shared_ptr<arrow::Array> changed;
+  KATANA_LOG_ASSERT(builder.Finish(&changed).ok());
+  auto changed_hash =
+      katana::ContentHash::OfColumn(arrow::ChunkedArray(changed), 4);
+  KATANA_LOG_ASSERT(changed_hash);
+  KATANA_LOG_ASSERT(
+      hash.value().DifferingChunks(changed_hash.value()) ==
+      std::vector<uint64_t>{1});
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-a", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<uint32_t>("edge-a", g->NumEdges()), &txn_ctx));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+
+  auto changed_table = arrow::Table::Make(
+      arrow::schema({arrow::field("node-a", arrow::int64())}),
+      {std::make_shared<arrow::ChunkedArray>(changed)});
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(changed_table, &txn_ctx));
+  KATANA_LOG_ASSERT(!g->Equals(g2.get()));
+  std::string diff = g->ReportDiff(g2.get());
+  KATANA_LOG_VASSERT(
+      diff.find("Node property node-a") != std::string::npos &&
+          diff.find("rows [0, 10)") != std::string::npos,
+      "{}", diff);
+
+  fs::remove_all(rdg_dir);
+}
+
+/// Commits deferred in a batch are stored as one new version
+void
+TestGroupCommit() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  uint64_t first_version = g2->CurrentVersion().value();
+
+  txn_ctx.BeginBatch();
+  for (const auto& name : {"node-a", "node-b"}) {
+    KATANA_LOG_ASSERT(g2->AddNodeProperties(
+        MakeProps<int64_t>(name, test_length), &txn_ctx));
+    KATANA_LOG_ASSERT(g2->Commit(command_line, &txn_ctx));
+  }
+  KATANA_LOG_ASSERT(g2->CurrentVersion().value() == first_version);
+  auto commit_result = txn_ctx.CommitBatch();
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing result: {}", commit_result.error());
+  }
+  KATANA_LOG_ASSERT(!txn_ctx.batching());
+  KATANA_LOG_ASSERT(g2->CurrentVersion().value() == first_version + 1);
+
+  make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(make_result, "{}", make_result.error());
+  KATANA_LOG_ASSERT(make_result.value()->GetNodeProperty("node-a"));
+  KATANA_LOG_ASSERT(make_result.value()->GetNodeProperty("node-b"));
+}
+
+/// The names of the files in dir that start with prefix
+std::set<std::string>
+FilesStartingWith(const std::string& dir, const std::string& prefix) {
+  std::set<std::string> names;
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    std::string name = entry.path().filename().string();
+    if (name.rfind(prefix, 0) == 0) {
+      names.emplace(name);
+    }
+  }
+  return names;
+}
+
+/// Writing a graph somewhere else copies the files of unmodified
+/// properties, loaded or not, instead of storing them again
+void
+TestWriteToNewLocation() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-a", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-b", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<uint32_t>("edge-a", g->NumEdges()), &txn_ctx));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string new_rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // node-b stays in storage
+  katana::RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>{"node-a"};
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  write_result = g2->Write(new_rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    fs::remove_all(new_rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  make_result = katana::PropertyGraph::Make(
+      new_rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    fs::remove_all(new_rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(g->Equals(make_result.value().get()));
+
+  // copies keep the names of the files they were copied from
+  for (const auto& prefix : {"node-a", "node-b", "edge-a"}) {
+    std::set<std::string> names = FilesStartingWith(rdg_dir, prefix);
+    KATANA_LOG_ASSERT(!names.empty());
+    KATANA_LOG_VASSERT(
+        names == FilesStartingWith(new_rdg_dir, prefix),
+        "{} was stored again", prefix);
+  }
+
+  fs::remove_all(rdg_dir);
+  fs::remove_all(new_rdg_dir);
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys sys;
@@ -474,6 +1000,13 @@ main(int argc, char** argv) {
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
+  TestTopologyMappedInPlace();
+  TestCommitWritesOnlyChanges();
+  TestPrefetchAndPinProperties();
+  TestLoadVersion();
+  TestContentHash();
+  TestGroupCommit();
+  TestWriteToNewLocation();
   TestTypesFromPropertiesCompareTypesFromStorage();
   TestCompositeTypesFromPropertiesCompareCompositeTypesFromStorage();
 
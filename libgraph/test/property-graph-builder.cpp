@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr uint32_t kNumDeclared = 300;
+constexpr uint32_t kNumPlaceholders = 40;
+constexpr uint32_t kNumEdges = 3000;
+constexpr uint32_t kUnresolved = std::numeric_limits<uint32_t>::max();
+
+using Values = std::vector<std::optional<int64_t>>;
+
+/// What the builder is told, in order: a node of the ID, or an edge between
+/// two IDs. IDs from kNumDeclared on name no node, so they become
+/// placeholders.
+struct Operation {
+  bool is_node;
+  uint32_t id;
+  uint32_t target;
+};
+
+std::vector<Operation>
+RandomOperations() {
+  std::mt19937 gen(41);
+  std::uniform_int_distribution<uint32_t> any_id(
+      0, kNumDeclared + kNumPlaceholders - 1);
+  std::vector<Operation> operations;
+  for (uint32_t id = 0; id < kNumDeclared; ++id) {
+    operations.emplace_back(Operation{true, id, 0});
+  }
+  for (uint32_t e = 0; e < kNumEdges; ++e) {
+    operations.emplace_back(Operation{false, any_id(gen), any_id(gen)});
+  }
+  std::shuffle(operations.begin(), operations.end(), gen);
+  return operations;
+}
+
+std::string
+ID(uint32_t id) {
+  return "n" + std::to_string(id);
+}
+
+/// Gives every node the property "value", its ID, and every edge the
+/// property "rank", the order in which it was added
+katana::GraphComponents
+Build(const std::vector<Operation>& operations) {
+  katana::PropertyGraphBuilder builder(64);
+  katana::PropertyKey value_key(
+      "value", true, false, "value", katana::ImportDataType::kInt64, false);
+  katana::PropertyKey rank_key(
+      "rank", false, true, "rank", katana::ImportDataType::kInt64, false);
+  auto int64_value = [](int64_t value) {
+    return [value](katana::ImportDataType, bool) {
+      katana::ImportData data(katana::ImportDataType::kInt64, false);
+      data.value = value;
+      return data;
+    };
+  };
+
+  int64_t rank = 0;
+  for (const auto& op : operations) {
+    if (op.is_node) {
+      KATANA_LOG_ASSERT(builder.StartNode(ID(op.id)));
+      builder.AddValue(
+          "value", [&]() { return value_key; }, int64_value(op.id));
+      KATANA_LOG_ASSERT(builder.FinishNode());
+    } else {
+      KATANA_LOG_ASSERT(builder.StartEdge(ID(op.id), ID(op.target)));
+      builder.AddValue(
+          "rank", [&]() { return rank_key; }, int64_value(rank++));
+      KATANA_LOG_ASSERT(builder.FinishEdge());
+    }
+  }
+  auto res = builder.Finish(false);
+  KATANA_LOG_VASSERT(res, "building: {}", res.error());
+  return std::move(res.value());
+}
+
+Values
+Int64Column(const std::shared_ptr<arrow::Table>& table, const char* name) {
+  auto column = table->GetColumnByName(name);
+  KATANA_LOG_ASSERT(column != nullptr);
+  Values values;
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<arrow::Int64Array>(chunk);
+    for (int64_t i = 0; i < array->length(); ++i) {
+      values.emplace_back(
+          array->IsNull(i) ? std::nullopt
+                           : std::optional<int64_t>(array->Value(i)));
+    }
+  }
+  return values;
+}
+
+/// Checks graph against a sequential model of the builder: nodes are
+/// numbered as they are added, then the placeholders of the unknown targets
+/// and then of the unknown sources, each in edge order; the edges of a node
+/// stay in the order they were added
+void
+CheckGraph(
+    const std::vector<Operation>& operations,
+    const katana::GraphComponents& graph) {
+  std::unordered_map<uint32_t, uint32_t> nodes;
+  Values node_values;
+  // by edge, the IDs and, if they were known when it was added, the nodes
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  auto find = [&](uint32_t id) {
+    auto it = nodes.find(id);
+    return it == nodes.end() ? kUnresolved : it->second;
+  };
+  for (const auto& op : operations) {
+    if (op.is_node) {
+      nodes.emplace(op.id, node_values.size());
+      node_values.emplace_back(op.id);
+    } else {
+      edges.emplace_back(op.id, op.target);
+      sources.emplace_back(find(op.id));
+      targets.emplace_back(find(op.target));
+    }
+  }
+  auto resolve = [&](uint32_t id) {
+    auto it = nodes.emplace(id, node_values.size()).first;
+    if (it->second == node_values.size()) {
+      node_values.emplace_back(std::nullopt);
+    }
+    return it->second;
+  };
+  for (size_t e = 0; e < edges.size(); ++e) {
+    if (targets[e] == kUnresolved) {
+      targets[e] = resolve(edges[e].second);
+    }
+  }
+  for (size_t e = 0; e < edges.size(); ++e) {
+    if (sources[e] == kUnresolved) {
+      sources[e] = resolve(edges[e].first);
+    }
+  }
+
+  std::vector<std::vector<uint32_t>> out(node_values.size());
+  for (size_t e = 0; e < edges.size(); ++e) {
+    out[sources[e]].emplace_back(e);
+  }
+
+  const katana::GraphTopology& topo = graph.topology;
+  KATANA_LOG_ASSERT(topo.NumNodes() == node_values.size());
+  KATANA_LOG_ASSERT(topo.NumEdges() == edges.size());
+  KATANA_LOG_ASSERT(
+      Int64Column(graph.nodes.properties, "value") == node_values);
+  Values ranks = Int64Column(graph.edges.properties, "rank");
+  KATANA_LOG_ASSERT(ranks.size() == edges.size());
+  for (uint32_t n = 0; n < node_values.size(); ++n) {
+    auto edge_range = topo.OutEdges(n);
+    KATANA_LOG_VASSERT(
+        *edge_range.end() - *edge_range.begin() == out[n].size(),
+        "node {} has the wrong number of edges", n);
+    auto next = out[n].begin();
+    for (auto e : edge_range) {
+      uint32_t added = *next++;
+      KATANA_LOG_ASSERT(topo.OutEdgeDst(e) == targets[added]);
+      KATANA_LOG_ASSERT(ranks[e] == std::optional<int64_t>(added));
+    }
+  }
+}
+
+void
+TestBuilder() {
+  std::vector<Operation> operations = RandomOperations();
+  for (int threads : {1, 4}) {
+    katana::setActiveThreads(threads);
+    CheckGraph(operations, Build(operations));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestBuilder();
+
+  return 0;
+}
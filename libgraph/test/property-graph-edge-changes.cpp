@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using namespace katana;
+using Node = PropertyGraph::Node;
+using PropertyIndex = GraphTopology::PropertyIndex;
+using EdgeTriple = std::tuple<Node, Node, PropertyIndex>;
+
+template <typename View>
+std::vector<EdgeTriple>
+CollectEdges(const View& view, bool transposed) {
+  std::vector<EdgeTriple> edges;
+  for (auto n : view.Nodes()) {
+    for (auto e : view.OutEdges(n)) {
+      auto dst = view.OutEdgeDst(e);
+      auto prop = view.GetEdgePropertyIndexFromOutEdge(e);
+      edges.emplace_back(transposed ? dst : n, transposed ? n : dst, prop);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+Result<void>
+TestApplyEdgeChanges() {
+  AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(6);
+
+  std::vector<std::array<Node, 2>> edges = {
+      {0, 4}, {0, 1}, {1, 5}, {1, 2}, {2, 0}, {3, 5}, {5, 1}};
+  for (const auto& [n1, n2] : edges) {
+    builder.AddEdge(n1, n2);
+  }
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(builder.ConvertToCSR()));
+  const uint64_t num_edges = pg->NumEdges();
+
+  // populate the cache before mutating
+  pg->BuildView<PropertyGraphViews::Transposed>();
+  pg->BuildView<PropertyGraphViews::EdgesSortedByDestID>();
+
+  EdgeChangeSet changes;
+  // reuse existing property rows for the new edges
+  changes.insertions = {{0, 2, 0}, {4, 3, 1}, {0, 0, 2}};
+  changes.deletions = {3, 5};
+  KATANA_CHECKED(pg->ApplyEdgeChanges(changes));
+
+  KATANA_LOG_ASSERT(pg->topology_version() == 1);
+  KATANA_LOG_ASSERT(pg->NumEdges() == num_edges + 3 - 2);
+
+  auto expected = CollectEdges(pg->topology(), false);
+  for (const auto& edge : expected) {
+    KATANA_LOG_ASSERT(std::get<2>(edge) != 3 && std::get<2>(edge) != 5);
+  }
+
+  auto sorted_view = pg->BuildView<PropertyGraphViews::EdgesSortedByDestID>();
+  for (auto n : sorted_view.Nodes()) {
+    Node prev = 0;
+    for (auto e : sorted_view.OutEdges(n)) {
+      KATANA_LOG_ASSERT(sorted_view.OutEdgeDst(e) >= prev);
+      prev = sorted_view.OutEdgeDst(e);
+    }
+  }
+  KATANA_LOG_ASSERT(CollectEdges(sorted_view, false) == expected);
+
+  auto transposed_view = pg->BuildView<PropertyGraphViews::Transposed>();
+  KATANA_LOG_ASSERT(CollectEdges(transposed_view, true) == expected);
+
+  // invalid node ids are rejected and leave the graph untouched
+  EdgeChangeSet bad;
+  bad.insertions = {{0, 6, 0}};
+  KATANA_LOG_ASSERT(!pg->ApplyEdgeChanges(bad));
+  KATANA_LOG_ASSERT(pg->topology_version() == 1);
+
+  return katana::ResultSuccess();
+}
+
+int
+main() {
+  SharedMemSys sys;
+
+  auto res = TestApplyEdgeChanges();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  return 0;
+}
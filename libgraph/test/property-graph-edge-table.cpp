@@ -0,0 +1,150 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+template <typename Builder, typename T>
+std::shared_ptr<arrow::Array>
+MakeArray(const std::vector<T>& values) {
+  Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(values).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::shared_ptr<arrow::Table>
+MakeEdgeTable(
+    const std::vector<int64_t>& src, const std::vector<int64_t>& dst,
+    const std::vector<double>& weight) {
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("src", arrow::int64()),
+           arrow::field("weight", arrow::float64()),
+           arrow::field("dst", arrow::int64())}),
+      {MakeArray<arrow::Int64Builder>(src),
+       MakeArray<arrow::DoubleBuilder>(weight),
+       MakeArray<arrow::Int64Builder>(dst)});
+}
+
+katana::Uri
+MakeDir() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/edge-table");
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value();
+}
+
+/// The destinations and weights of the edges of node n
+std::vector<std::pair<uint32_t, double>>
+EdgesOf(katana::PropertyGraph* pg, uint32_t n) {
+  auto weights_res = pg->GetEdgePropertyTyped<double>("weight");
+  KATANA_LOG_VASSERT(weights_res, "getting weights: {}", weights_res.error());
+  auto weights = weights_res.value();
+  std::vector<std::pair<uint32_t, double>> edges;
+  for (auto e : pg->topology().OutEdges(n)) {
+    edges.emplace_back(pg->topology().OutEdgeDst(e), weights->Value(e));
+  }
+  return edges;
+}
+
+void
+TestMake() {
+  katana::TxnContext txn_ctx;
+  auto table =
+      MakeEdgeTable({2, 0, 1, 0, 2}, {1, 2, 0, 1, 0}, {0., 1., 2., 3., 4.});
+  auto pg_res =
+      katana::PropertyGraph::MakeFromEdgeTable(MakeDir(), table, &txn_ctx);
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  KATANA_LOG_ASSERT(pg->NumNodes() == 3 && pg->NumEdges() == 5);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 1);
+  // the edges of each node are in the order of the table
+  using Edges = std::vector<std::pair<uint32_t, double>>;
+  KATANA_LOG_ASSERT(EdgesOf(pg, 0) == (Edges{{2, 1.}, {1, 3.}}));
+  KATANA_LOG_ASSERT(EdgesOf(pg, 1) == (Edges{{0, 2.}}));
+  KATANA_LOG_ASSERT(EdgesOf(pg, 2) == (Edges{{1, 0.}, {0, 4.}}));
+
+  // nodes without edges
+  katana::EdgeTableOptions opts;
+  opts.num_nodes = 5;
+  pg_res = katana::PropertyGraph::MakeFromEdgeTable(
+      MakeDir(), table, &txn_ctx, opts);
+  KATANA_LOG_ASSERT(pg_res && pg_res.value()->NumNodes() == 5);
+  KATANA_LOG_ASSERT(pg_res.value()->topology().OutDegree(4) == 0);
+
+  // a table that is sorted by source already
+  auto sorted = MakeEdgeTable({0, 0, 1}, {1, 2, 2}, {5., 6., 7.});
+  pg_res =
+      katana::PropertyGraph::MakeFromEdgeTable(MakeDir(), sorted, &txn_ctx);
+  KATANA_LOG_ASSERT(pg_res);
+  KATANA_LOG_ASSERT(EdgesOf(pg_res.value().get(), 1) == (Edges{{2, 7.}}));
+}
+
+void
+TestNodeIDs() {
+  katana::TxnContext txn_ctx;
+  auto table =
+      MakeEdgeTable({1000, -5, 42}, {42, 1000, 1000}, {0., 1., 2.});
+  katana::EdgeTableOptions opts;
+  opts.node_id_property = "id";
+  auto pg_res = katana::PropertyGraph::MakeFromEdgeTable(
+      MakeDir(), table, &txn_ctx, opts);
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  KATANA_LOG_ASSERT(pg->NumNodes() == 3 && pg->NumEdges() == 3);
+  auto ids_res = pg->GetNodePropertyTyped<int64_t>("id");
+  KATANA_LOG_ASSERT(ids_res);
+  auto ids = ids_res.value();
+  KATANA_LOG_ASSERT(
+      ids->Value(0) == -5 && ids->Value(1) == 42 && ids->Value(2) == 1000);
+  using Edges = std::vector<std::pair<uint32_t, double>>;
+  KATANA_LOG_ASSERT(EdgesOf(pg, 0) == (Edges{{2, 1.}}));
+  KATANA_LOG_ASSERT(EdgesOf(pg, 1) == (Edges{{2, 2.}}));
+  KATANA_LOG_ASSERT(EdgesOf(pg, 2) == (Edges{{1, 0.}}));
+}
+
+void
+TestInvalidTables() {
+  katana::TxnContext txn_ctx;
+  auto negative = MakeEdgeTable({0, -1}, {1, 0}, {0., 1.});
+  KATANA_LOG_ASSERT(!katana::PropertyGraph::MakeFromEdgeTable(
+      MakeDir(), negative, &txn_ctx));
+
+  auto table = MakeEdgeTable({0, 3}, {1, 0}, {0., 1.});
+  katana::EdgeTableOptions opts;
+  opts.num_nodes = 3;
+  KATANA_LOG_ASSERT(!katana::PropertyGraph::MakeFromEdgeTable(
+      MakeDir(), table, &txn_ctx, opts));
+
+  opts = {};
+  opts.dst_column = "weight";
+  KATANA_LOG_ASSERT(!katana::PropertyGraph::MakeFromEdgeTable(
+      MakeDir(), table, &txn_ctx, opts));
+  opts.dst_column = "missing";
+  KATANA_LOG_ASSERT(!katana::PropertyGraph::MakeFromEdgeTable(
+      MakeDir(), table, &txn_ctx, opts));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestMake();
+  TestNodeIDs();
+  TestInvalidTables();
+
+  return 0;
+}
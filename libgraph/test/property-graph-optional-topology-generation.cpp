@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
@@ -34,6 +38,44 @@ TestOptionalTopologyGenerationEdgeShuffleTopology() {
   pg.BuildView<SortedGraphView>();
 }
 
+void
+TestOptionalTopologyGenerationEdgesSortedByDestType() {
+  KATANA_LOG_DEBUG("##### Testing EdgesSortedByDestType Generation #####");
+
+  katana::TxnContext txn_ctx;
+  katana::PropertyGraph pg = LoadGraph(ldbc_003InputFile, &txn_ctx);
+
+  using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestType;
+  SortedGraphView view = pg.BuildView<SortedGraphView>();
+
+  auto dest_type = [&](auto e) {
+    return pg.GetTypeOfNodeFromPropertyIndex(
+        view.GetNodePropertyIndex(view.OutEdgeDst(e)));
+  };
+
+  for (auto n : view.Nodes()) {
+    auto edges = view.OutEdges(n);
+    for (auto it = edges.begin(); it != edges.end(); ++it) {
+      // Sorted by destination type, then by destination
+      if (it != edges.begin()) {
+        auto prev = *std::prev(it);
+        KATANA_LOG_ASSERT(
+            dest_type(prev) < dest_type(*it) ||
+            (dest_type(prev) == dest_type(*it) &&
+             view.OutEdgeDst(prev) <= view.OutEdgeDst(*it)));
+      }
+
+      // Each edge lies in the segment of its destination type, whose bounds
+      // are edges of that type
+      auto type = dest_type(*it);
+      auto segment = view.OutEdges(n, type);
+      KATANA_LOG_ASSERT(*it >= *segment.begin() && *it < *segment.end());
+      KATANA_LOG_ASSERT(dest_type(*segment.begin()) == type);
+      KATANA_LOG_ASSERT(dest_type(*segment.end() - 1) == type);
+    }
+  }
+}
+
 void
 TestOptionalTopologyGenerationShuffleTopology() {
   KATANA_LOG_DEBUG("##### Testing ShuffleTopology Generation #####");
@@ -48,6 +90,116 @@ TestOptionalTopologyGenerationShuffleTopology() {
   pg.BuildView<SortedGraphView>();
 }
 
+template <typename View>
+void
+TestNodeOrderingView() {
+  katana::TxnContext txn_ctx;
+  katana::PropertyGraph pg = LoadGraph(ldbc_003InputFile, &txn_ctx);
+  const auto& orig = pg.topology();
+
+  View view = pg.BuildView<View>();
+  KATANA_LOG_ASSERT(view.NumNodes() == orig.NumNodes());
+  KATANA_LOG_ASSERT(view.NumEdges() == orig.NumEdges());
+
+  // The node property indices are a permutation of the original node ids and
+  // every node keeps its neighbors
+  std::vector<bool> seen(orig.NumNodes(), false);
+  for (auto n : view.Nodes()) {
+    auto old_n = view.GetNodePropertyIndex(n);
+    KATANA_LOG_ASSERT(old_n < orig.NumNodes() && !seen[old_n]);
+    seen[old_n] = true;
+
+    std::vector<uint64_t> expected;
+    for (auto e : orig.OutEdges(old_n)) {
+      expected.emplace_back(orig.OutEdgeDst(e));
+    }
+    std::vector<uint64_t> found;
+    for (auto e : view.OutEdges(n)) {
+      found.emplace_back(view.GetNodePropertyIndex(view.OutEdgeDst(e)));
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    KATANA_LOG_ASSERT(expected == found);
+  }
+}
+
+void
+TestOptionalTopologyGenerationLocalityOrderings() {
+  KATANA_LOG_DEBUG("##### Testing locality node orderings Generation #####");
+
+  TestNodeOrderingView<
+      katana::PropertyGraphViews::NodesSortedByRCMEdgesSortedByDestID>();
+  TestNodeOrderingView<
+      katana::PropertyGraphViews::NodesHubSortedEdgesSortedByDestID>();
+  TestNodeOrderingView<
+      katana::PropertyGraphViews::NodesHubClusteredEdgesSortedByDestID>();
+}
+
+std::vector<uint64_t>
+SortedNeighbors(const katana::GraphTopology& topo, uint64_t n) {
+  std::vector<uint64_t> neighbors;
+  for (auto e : topo.OutEdges(n)) {
+    neighbors.emplace_back(topo.OutEdgeDst(e));
+  }
+  std::sort(neighbors.begin(), neighbors.end());
+  neighbors.erase(
+      std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+  return neighbors;
+}
+
+void
+TestOptionalTopologyGenerationHubBitmaps() {
+  KATANA_LOG_DEBUG("##### Testing hub adjacency bitmaps Generation #####");
+
+  katana::TxnContext txn_ctx;
+  katana::PropertyGraph pg = LoadGraph(ldbc_003InputFile, &txn_ctx);
+  const auto& topo = pg.topology();
+
+  auto hubs = katana::HubAdjacencyBitmaps::Make(topo, 1);
+
+  std::vector<uint64_t> hub_nodes;
+  for (auto n : topo.Nodes()) {
+    KATANA_LOG_ASSERT(
+        hubs->IsHub(n) == (topo.OutDegree(n) >= hubs->hub_threshold()));
+    if (!hubs->IsHub(n)) {
+      continue;
+    }
+    hub_nodes.emplace_back(n);
+    auto neighbors = SortedNeighbors(topo, n);
+    KATANA_LOG_ASSERT(hubs->Bitmap(n).count() == neighbors.size());
+    for (auto dst : neighbors) {
+      KATANA_LOG_ASSERT(hubs->Bitmap(n).test(dst));
+    }
+  }
+
+  // Bitmap intersections over a sub range match set intersections
+  const uint64_t lo = topo.NumNodes() / 4;
+  const uint64_t hi = topo.NumNodes() - lo;
+  for (size_t i = 0; i + 1 < hub_nodes.size(); ++i) {
+    auto a = SortedNeighbors(topo, hub_nodes[i]);
+    auto b = SortedNeighbors(topo, hub_nodes[i + 1]);
+    size_t expected = 0;
+    for (auto dst : a) {
+      if (dst >= lo && dst < hi &&
+          std::binary_search(b.begin(), b.end(), dst)) {
+        ++expected;
+      }
+    }
+    KATANA_LOG_ASSERT(
+        katana::HubAdjacencyBitmaps::CountCommon(
+            hubs->Bitmap(hub_nodes[i]), hubs->Bitmap(hub_nodes[i + 1]), lo,
+            hi) == expected);
+  }
+
+  using View = katana::PropertyGraphViews::EdgesSortedByDestIDHubBitmaps;
+  View view = pg.BuildView<View>();
+  for (auto n : view.Nodes()) {
+    for (auto e : view.OutEdges(n)) {
+      KATANA_LOG_ASSERT(view.HasEdge(n, view.OutEdgeDst(e)));
+    }
+  }
+}
+
 void
 TestOptionalTopologyGenerationEdgeTypeAwareTopology() {
   KATANA_LOG_DEBUG("##### Testing EdgeTypeAware Topology Generation ######");
@@ -67,7 +219,10 @@ main(int argc, char** argv) {
   cll::ParseCommandLineOptions(argc, argv);
 
   TestOptionalTopologyGenerationEdgeShuffleTopology();
+  TestOptionalTopologyGenerationEdgesSortedByDestType();
   TestOptionalTopologyGenerationShuffleTopology();
+  TestOptionalTopologyGenerationLocalityOrderings();
+  TestOptionalTopologyGenerationHubBitmaps();
   TestOptionalTopologyGenerationEdgeTypeAwareTopology();
   return 0;
 }
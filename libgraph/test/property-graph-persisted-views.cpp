@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+using ShuffledView =
+    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+
+constexpr uint32_t kNumNodes = 2000;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::mt19937 gen(31);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t e = 0; e < 6 * kNumNodes; ++e) {
+    edges.emplace_back(node(gen), node(gen));
+  }
+  return MakeTestGraph(kNumNodes, edges);
+}
+
+/// Writes pg and returns where, and in num_files how many files it took
+std::string
+WriteGraph(katana::PropertyGraph* pg, size_t* num_files) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertygraphpersistedviews");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_res = pg->Write(rdg_dir, "property-graph-persisted-views");
+  if (!write_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing graph: {}", write_res.error());
+  }
+  *num_files = 0;
+  for (fs::recursive_directory_iterator it(rdg_dir), end; it != end; ++it) {
+    *num_files += fs::is_regular_file(it->status());
+  }
+  return rdg_dir;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+LoadGraph(const std::string& rdg_dir) {
+  katana::TxnContext txn_ctx;
+  auto pg_res =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "loading graph: {}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+/// Checks that a view built on a reloaded graph, whether loaded from storage
+/// or built again, is the view built on the graph it was written from
+template <typename View>
+void
+CheckSameView(const View& expected, const View& found) {
+  KATANA_LOG_ASSERT(found.NumNodes() == expected.NumNodes());
+  KATANA_LOG_ASSERT(found.NumEdges() == expected.NumEdges());
+  for (auto n : expected.Nodes()) {
+    KATANA_LOG_ASSERT(
+        found.GetNodePropertyIndex(n) == expected.GetNodePropertyIndex(n));
+    KATANA_LOG_ASSERT(
+        *found.OutEdges(n).begin() == *expected.OutEdges(n).begin());
+  }
+  for (auto e : expected.OutEdges()) {
+    KATANA_LOG_VASSERT(
+        found.OutEdgeDst(e) == expected.OutEdgeDst(e),
+        "destination mismatch at edge {}", e);
+    KATANA_LOG_ASSERT(
+        found.GetEdgePropertyIndexFromOutEdge(e) ==
+        expected.GetEdgePropertyIndexFromOutEdge(e));
+  }
+}
+
+void
+TestPersistedViews() {
+  auto expected_pg = MakeGraph();
+  SortedView expected_sorted = expected_pg->BuildView<SortedView>();
+  ShuffledView expected_shuffled = expected_pg->BuildView<ShuffledView>();
+
+  size_t plain_files = 0;
+  std::string plain_dir = WriteGraph(MakeGraph().get(), &plain_files);
+  fs::remove_all(plain_dir);
+
+  // by default every view that was built is stored
+  auto pg = MakeGraph();
+  pg->BuildView<SortedView>();
+  pg->BuildView<ShuffledView>();
+  size_t view_files = 0;
+  std::string view_dir = WriteGraph(pg.get(), &view_files);
+  KATANA_LOG_VASSERT(
+      view_files > plain_files, "{} files with views, {} without", view_files,
+      plain_files);
+
+  auto loaded = LoadGraph(view_dir);
+  CheckSameView(expected_sorted, loaded->BuildView<SortedView>());
+  CheckSameView(expected_shuffled, loaded->BuildView<ShuffledView>());
+
+  // views loaded from storage are stored again whatever the threshold
+  loaded->SetMinPersistedViewBuildTime(std::chrono::hours(1));
+  size_t rewritten_files = 0;
+  std::string rewritten_dir = WriteGraph(loaded.get(), &rewritten_files);
+  fs::remove_all(rewritten_dir);
+  fs::remove_all(view_dir);
+  KATANA_LOG_ASSERT(rewritten_files == view_files);
+
+  // views that built faster than the threshold are left out
+  auto cheap_pg = MakeGraph();
+  cheap_pg->BuildView<SortedView>();
+  cheap_pg->BuildView<ShuffledView>();
+  cheap_pg->SetMinPersistedViewBuildTime(std::chrono::hours(1));
+  size_t cheap_files = 0;
+  std::string cheap_dir = WriteGraph(cheap_pg.get(), &cheap_files);
+  KATANA_LOG_VASSERT(
+      cheap_files == plain_files, "{} files with cheap views, {} without",
+      cheap_files, plain_files);
+
+  // and built again once the graph is loaded
+  auto rebuilt = LoadGraph(cheap_dir);
+  fs::remove_all(cheap_dir);
+  CheckSameView(expected_sorted, rebuilt->BuildView<SortedView>());
+  CheckSameView(expected_shuffled, rebuilt->BuildView<ShuffledView>());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestPersistedViews();
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using Edge = katana::GraphTopology::Edge;
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kNumNodes = 100000;
+
+std::string
+WriteGraph(katana::PropertyGraph* pg) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertygraphvalidation");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_res = pg->Write(rdg_dir, "property-graph-validation");
+  if (!write_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing graph: {}", write_res.error());
+  }
+  return rdg_dir;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Load(const std::string& rdg_dir, bool trusted) {
+  katana::TxnContext txn_ctx;
+  katana::RDGLoadOptions opts;
+  opts.trusted_load = trusted;
+  return katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+}
+
+/// Writes the topology of adj_indices and dests with every type id at
+/// type_id, and checks that an untrusted load of it succeeds only if valid
+/// and a trusted load only if trusted_valid
+void
+CheckLoad(
+    const std::vector<Edge>& adj_indices, const std::vector<Node>& dests,
+    katana::EntityTypeID type_id, bool valid, bool trusted_valid) {
+  katana::GraphTopology topo(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(adj_indices.size());
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateInterleaved(dests.size());
+  katana::do_all(katana::iterate(size_t{0}, adj_indices.size()), [&](size_t n) {
+    node_type_ids[n] = type_id;
+  });
+  katana::do_all(katana::iterate(size_t{0}, dests.size()), [&](size_t e) {
+    edge_type_ids[e] = katana::kUnknownEntityType;
+  });
+  auto pg_res = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_type_ids), std::move(edge_type_ids),
+      katana::EntityTypeManager{}, katana::EntityTypeManager{});
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+
+  std::string rdg_dir = WriteGraph(pg_res.value().get());
+  auto untrusted_res = Load(rdg_dir, false);
+  auto trusted_res = Load(rdg_dir, true);
+  fs::remove_all(rdg_dir);
+
+  KATANA_LOG_ASSERT(static_cast<bool>(untrusted_res) == valid);
+  KATANA_LOG_ASSERT(static_cast<bool>(trusted_res) == trusted_valid);
+  if (trusted_res) {
+    KATANA_LOG_ASSERT(trusted_res.value()->NumNodes() == adj_indices.size());
+    KATANA_LOG_ASSERT(trusted_res.value()->NumEdges() == dests.size());
+  }
+}
+
+/// A ring with a chord from every node, over several chunks of the
+/// parallel scans
+void
+MakeRing(std::vector<Edge>* adj_indices, std::vector<Node>* dests) {
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    dests->emplace_back((n + 1) % kNumNodes);
+    dests->emplace_back((7 * n + 3) % kNumNodes);
+    adj_indices->emplace_back(dests->size());
+  }
+}
+
+void
+TestValidGraph() {
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    edges.emplace_back(n, (n + 1) % kNumNodes);
+    edges.emplace_back(n, (7 * n + 3) % kNumNodes);
+  }
+  auto pg = MakeTestGraph(kNumNodes, edges);
+  katana::TxnContext txn_ctx;
+  auto node_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("Even", [](uint64_t n) {
+        return static_cast<uint8_t>(n % 2 == 0);
+      }));
+  KATANA_LOG_VASSERT(node_res, "adding node types: {}", node_res.error());
+  auto edge_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("Ring", [](uint64_t e) {
+        return static_cast<uint8_t>(e % 2 == 0);
+      }));
+  KATANA_LOG_VASSERT(edge_res, "adding edge types: {}", edge_res.error());
+  auto types_res = pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+
+  std::string rdg_dir = WriteGraph(pg.get());
+  auto untrusted_res = Load(rdg_dir, false);
+  auto trusted_res = Load(rdg_dir, true);
+  fs::remove_all(rdg_dir);
+
+  KATANA_LOG_VASSERT(untrusted_res, "loading: {}", untrusted_res.error());
+  KATANA_LOG_VASSERT(trusted_res, "trusted load: {}", trusted_res.error());
+  KATANA_LOG_ASSERT(pg->Equals(untrusted_res.value().get()));
+  KATANA_LOG_ASSERT(pg->Equals(trusted_res.value().get()));
+}
+
+void
+TestInvalidTopology() {
+  std::vector<Edge> adj_indices;
+  std::vector<Node> dests;
+  MakeRing(&adj_indices, &dests);
+  CheckLoad(adj_indices, dests, katana::kUnknownEntityType, true, true);
+
+  // a destination past the nodes, far from the first chunk
+  std::vector<Node> outside = dests;
+  outside[dests.size() - 3] = kNumNodes;
+  CheckLoad(adj_indices, outside, katana::kUnknownEntityType, false, true);
+
+  // decreasing indices that still end at the number of edges
+  std::vector<Edge> decreasing = adj_indices;
+  decreasing[3 * kNumNodes / 4] = 1;
+  CheckLoad(decreasing, dests, katana::kUnknownEntityType, false, true);
+
+  // the indices end before the last edge, which even a trusted load checks
+  std::vector<Edge> short_indices = adj_indices;
+  short_indices.back() -= 1;
+  CheckLoad(short_indices, dests, katana::kUnknownEntityType, false, false);
+}
+
+void
+TestInvalidTypeIDs() {
+  std::vector<Edge> adj_indices;
+  std::vector<Node> dests;
+  MakeRing(&adj_indices, &dests);
+  // a default manager knows only kUnknownEntityType
+  CheckLoad(adj_indices, dests, katana::EntityTypeID{7}, false, true);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestValidGraph();
+  TestInvalidTopology();
+  TestInvalidTypeIDs();
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include <array>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/PropertyColumn.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana;
+using Node = PropertyGraph::Node;
+using Weight = PODProperty<uint64_t>;
+
+namespace {
+
+constexpr uint64_t kScale = 10;
+
+Result<std::unique_ptr<PropertyGraph>>
+MakeGraph(TxnContext* txn_ctx) {
+  AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(6);
+
+  std::vector<std::array<Node, 2>> edges = {
+      {0, 4}, {0, 1}, {1, 5}, {1, 2}, {2, 0}, {3, 5}, {5, 1}, {4, 1}};
+  for (const auto& [n1, n2] : edges) {
+    builder.AddEdge(n1, n2);
+  }
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(builder.ConvertToCSR()));
+
+  auto weights = PropertyColumn<uint64_t>::MakeInterleaved(pg->NumEdges());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = kScale * i;
+  }
+  KATANA_CHECKED(pg->AddEdgeProperty("weight", std::move(weights), txn_ctx));
+
+  auto ids = PropertyColumn<uint64_t>::MakeInterleaved(pg->NumNodes());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ids[i] = kScale * i;
+  }
+  KATANA_CHECKED(pg->AddNodeProperty("id", std::move(ids), txn_ctx));
+
+  return MakeResult(std::move(pg));
+}
+
+/// Copies of edge properties follow the edge order of the view
+Result<void>
+TestEdgeOrder(PropertyGraph* pg) {
+  auto view = pg->BuildView<PropertyGraphViews::Transposed>();
+  auto copy = KATANA_CHECKED(pg->GetEdgePropertyInViewOrder(view, "weight"));
+  auto typed = std::static_pointer_cast<arrow::UInt64Array>(copy);
+  KATANA_LOG_ASSERT(static_cast<uint64_t>(typed->length()) == pg->NumEdges());
+
+  bool shuffled = false;
+  for (auto e : view.OutEdges()) {
+    auto prop = view.GetEdgePropertyIndexFromOutEdge(e);
+    KATANA_LOG_ASSERT(typed->Value(e) == kScale * prop);
+    shuffled |= prop != e;
+  }
+  KATANA_LOG_ASSERT(shuffled);
+
+  // cached while the topology is
+  auto again = KATANA_CHECKED(pg->GetEdgePropertyInViewOrder(view, "weight"));
+  KATANA_LOG_ASSERT(again == copy);
+
+  // the default topology does not shuffle edges, so there is nothing to copy
+  auto default_view = pg->BuildView<PropertyGraphViews::Default>();
+  auto original =
+      KATANA_CHECKED(pg->GetEdgePropertyInViewOrder(default_view, "weight"));
+  auto column = KATANA_CHECKED(pg->GetEdgeProperty("weight"));
+  KATANA_LOG_ASSERT(original == column->chunk(0));
+
+  KATANA_LOG_ASSERT(!pg->GetEdgePropertyInViewOrder(view, "missing"));
+
+  return ResultSuccess();
+}
+
+/// Typed views read copies and the shuffled properties alike
+Result<void>
+TestTypedView(PropertyGraph* pg) {
+  using View = TypedPropertyGraphView<
+      PropertyGraphViews::Transposed, std::tuple<>, std::tuple<Weight>>;
+  auto shuffled = KATANA_CHECKED(View::Make(pg, {}, {"weight"}));
+  auto in_order = KATANA_CHECKED(
+      View::MakeWithEdgePropertiesInViewOrder(pg, {}, {"weight"}));
+
+  for (auto e : in_order.OutEdges()) {
+    KATANA_LOG_ASSERT(
+        in_order.GetEdgeData<Weight>(e) == shuffled.GetEdgeData<Weight>(e));
+  }
+  return ResultSuccess();
+}
+
+/// Copies of node properties follow the node order of the view
+Result<void>
+TestNodeOrder(PropertyGraph* pg) {
+  using View = PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+  auto view = pg->BuildView<View>();
+  auto copy = KATANA_CHECKED(pg->GetNodePropertyInViewOrder(view, "id"));
+  auto typed = std::static_pointer_cast<arrow::UInt64Array>(copy);
+
+  for (auto n : view.Nodes()) {
+    KATANA_LOG_ASSERT(typed->Value(n) == kScale * view.GetNodePropertyIndex(n));
+  }
+  return ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  SharedMemSys sys;
+
+  TxnContext txn_ctx;
+  auto pg_res = MakeGraph(&txn_ctx);
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  PropertyGraph* pg = pg_res.value().get();
+
+  auto res = TestEdgeOrder(pg);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = TestTypedView(pg);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = TestNodeOrder(pg);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  return 0;
+}
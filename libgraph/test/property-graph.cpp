@@ -135,6 +135,53 @@ TestError1(size_t num_nodes, size_t line_width) {
       "Should return PropertyNotFound when node property doesn't exist.");
 }
 
+/// Test that copies share columns and topology until they are changed
+void
+TestCopy(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 2, &policy, &txn_ctx);
+
+  auto copy_res = g->Copy(&txn_ctx);
+  if (!copy_res) {
+    KATANA_LOG_FATAL("could not copy property graph: {}", copy_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> copy = std::move(copy_res.value());
+
+  auto data = [](const katana::PropertyGraph& pg, int i) {
+    return pg.GetNodeProperty(i)->chunk(0)->data()->buffers[1]->data();
+  };
+
+  KATANA_LOG_ASSERT(copy->GetNumNodeProperties() == 2);
+  KATANA_LOG_ASSERT(copy->GetNumEdgeProperties() == 2);
+  KATANA_LOG_ASSERT(data(*copy, 0) == data(*g, 0));
+  KATANA_LOG_ASSERT(data(*copy, 1) == data(*g, 1));
+  KATANA_LOG_ASSERT(copy->topology().DestData() == g->topology().DestData());
+
+  // Upserting a column replaces it in the copy only
+  const auto* node_data_0 = data(*g, 0);
+  katana::TableBuilder builder{num_nodes};
+  builder.AddColumn<DataType>(katana::ColumnOptions());
+  if (auto r = copy->UpsertNodeProperties(builder.Finish(), &txn_ctx); !r) {
+    KATANA_LOG_FATAL("could not upsert node property: {}", r.error());
+  }
+  KATANA_LOG_ASSERT(data(*g, 0) == node_data_0);
+  KATANA_LOG_ASSERT(data(*copy, 0) != node_data_0);
+  KATANA_LOG_ASSERT(data(*copy, 1) == data(*g, 1));
+
+  // Sorting in place gives the copy a topology of its own
+  const auto* dests = g->topology().DestData();
+  if (auto r = katana::SortAllEdgesByDest(copy.get()); !r) {
+    KATANA_LOG_FATAL("could not sort edges: {}", r.error());
+  }
+  KATANA_LOG_ASSERT(g->topology().DestData() == dests);
+  KATANA_LOG_ASSERT(copy->topology().DestData() != dests);
+  KATANA_LOG_ASSERT(copy->topology().NumEdges() == g->topology().NumEdges());
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -143,6 +190,7 @@ main() {
   TestIterate3(10, 3);
   TestIterate4(10, 3);
   TestError1(10, 3);
+  TestCopy(10, 3);
 
   return 0;
 }
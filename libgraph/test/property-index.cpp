@@ -1,9 +1,14 @@
+#include <algorithm>
+#include <tuple>
+
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/CompositeEntityIndex.h"
 #include "katana/EntityIndex.h"
+#include "katana/HashEntityIndex.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
 #include "katana/SharedMemSys.h"
@@ -133,6 +138,16 @@ CreateStringProperty(const std::string& name, bool uniform, size_t num_rows) {
       {std::make_shared<arrow::ChunkedArray>(chunks)});
 }
 
+std::shared_ptr<arrow::Table>
+DictionaryEncodeProperty(const std::shared_ptr<arrow::Table>& property) {
+  auto encoded = katana::DictionaryEncodeStrings(property->column(0));
+  KATANA_LOG_VASSERT(encoded, "Could not encode: {}", encoded.error());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(
+          property->field(0)->name(), katana::DictionaryStringType())}),
+      {encoded.value()});
+}
+
 template <typename node_or_edge, typename DataType>
 void
 TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
@@ -207,7 +222,7 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
 
 template <typename node_or_edge>
 void
-TestStringIndex(size_t num_nodes, size_t line_width) {
+TestStringIndex(size_t num_nodes, size_t line_width, bool dictionary) {
   using IndexType = katana::StringEntityIndex<node_or_edge>;
   using ArrayType = arrow::LargeStringArray;
 
@@ -222,10 +237,14 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
       "uniform", true, NodeOrEdge<node_or_edge>::num_entities(g.get()));
   std::shared_ptr<arrow::Table> nonuniform_prop = CreateStringProperty(
       "nonuniform", false, NodeOrEdge<node_or_edge>::num_entities(g.get()));
-  KATANA_LOG_ASSERT(
-      NodeOrEdge<node_or_edge>::AddProperties(g.get(), uniform_prop, &txn_ctx));
   KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
-      g.get(), nonuniform_prop, &txn_ctx));
+      g.get(),
+      dictionary ? DictionaryEncodeProperty(uniform_prop) : uniform_prop,
+      &txn_ctx));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(),
+      dictionary ? DictionaryEncodeProperty(nonuniform_prop) : nonuniform_prop,
+      &txn_ctx));
 
   auto uniform_index_result =
       NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "uniform");
@@ -271,6 +290,391 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound("aaak");
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
+
+  if (!dictionary) {
+    return;
+  }
+  std::shared_ptr<arrow::Table> encoded_prop =
+      DictionaryEncodeProperty(nonuniform_prop);
+  const auto& encoded =
+      static_cast<arrow::DictionaryArray&>(*encoded_prop->column(0)->chunk(0));
+  auto view_result =
+      katana::ConstructPropertyView<katana::DictionaryStringReadOnlyProperty>(
+          encoded_prop->column(0)->chunk(0).get());
+  KATANA_LOG_ASSERT(view_result);
+  auto view = view_result.value();
+  for (node_or_edge id = 0; id < num_entities; ++id) {
+    KATANA_LOG_ASSERT(view.GetValue(id) == typed_prop->GetString(id));
+    KATANA_LOG_ASSERT(view.FindCode(view.GetView(id)) == view.GetCode(id));
+  }
+  KATANA_LOG_ASSERT(!view.FindCode("aaaj"));
+  KATANA_LOG_ASSERT(
+      encoded.dictionary()->length() == static_cast<int64_t>(num_entities));
+}
+
+// Checks the order of an index over a property with repeated values and
+// nulls, large enough to be sorted in parallel.
+void
+TestIndexOrder(size_t num_nodes) {
+  using IndexType =
+      katana::PrimitiveEntityIndex<katana::GraphTopology::Node, int64_t>;
+
+  LinePolicy policy{1};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  auto value = [](size_t id) { return static_cast<int64_t>(id * 7919 % 97); };
+  auto valid = [](size_t id) { return id % 5 != 0; };
+  arrow::Int64Builder builder;
+  for (size_t id = 0; id < num_nodes; ++id) {
+    KATANA_LOG_ASSERT(
+        valid(id) ? builder.Append(value(id)).ok() : builder.AppendNull().ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field("mod", arrow::int64())}), {array}),
+      &txn_ctx));
+
+  auto index_result = Node::MakeIndex(g.get(), "mod");
+  KATANA_LOG_VASSERT(
+      index_result, "Could not create index: {}", index_result.error());
+  auto* index = static_cast<IndexType*>(index_result.value());
+
+  size_t num_valid = 0;
+  for (size_t id = 0; id < num_nodes; ++id) {
+    num_valid += valid(id) ? 1 : 0;
+  }
+  KATANA_LOG_ASSERT(index->size() == num_valid);
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(std::distance(index->begin(), index->end())) ==
+      num_valid);
+
+  // Sorted by value, then by id, without the nulls
+  auto prev = index->end();
+  for (auto it = index->begin(); it != index->end(); prev = it++) {
+    KATANA_LOG_ASSERT(valid(*it));
+    if (prev != index->end()) {
+      KATANA_LOG_ASSERT(
+          value(*prev) < value(*it) ||
+          (value(*prev) == value(*it) && *prev < *it));
+    }
+  }
+
+  for (int64_t key = -1; key <= 97; ++key) {
+    auto lower = index->LowerBound(key);
+    auto upper = index->UpperBound(key);
+    KATANA_LOG_ASSERT(lower == index->end() || value(*lower) >= key);
+    KATANA_LOG_ASSERT(lower == index->begin() || value(*(lower - 1)) < key);
+    KATANA_LOG_ASSERT(upper == index->end() || value(*upper) > key);
+    KATANA_LOG_ASSERT(upper == index->begin() || value(*(upper - 1)) <= key);
+    auto found = index->Find(key);
+    KATANA_LOG_ASSERT(found == (lower == upper ? index->end() : lower));
+  }
+}
+
+// Checks the lookups of a hash index over a property with repeated values
+// and nulls, of integers or of (dictionary encoded) strings.
+void
+TestHashIndex(size_t num_nodes, bool strings, bool dictionary) {
+  using Node = katana::GraphTopology::Node;
+  using Index = katana::HashEntityIndex<Node>;
+
+  LinePolicy policy{1};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  auto value = [](size_t id) { return static_cast<int64_t>(id * 7919 % 97); };
+  auto valid = [](size_t id) { return id % 5 != 0; };
+  std::shared_ptr<arrow::Array> array;
+  if (strings) {
+    arrow::LargeStringBuilder builder;
+    for (size_t id = 0; id < num_nodes; ++id) {
+      KATANA_LOG_ASSERT(
+          valid(id) ? builder.Append(std::to_string(value(id))).ok()
+                    : builder.AppendNull().ok());
+    }
+    KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  } else {
+    arrow::Int64Builder builder;
+    for (size_t id = 0; id < num_nodes; ++id) {
+      KATANA_LOG_ASSERT(
+          valid(id) ? builder.Append(value(id)).ok()
+                    : builder.AppendNull().ok());
+    }
+    KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("mod", array->type())}), {array});
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      dictionary ? DictionaryEncodeProperty(table) : table, &txn_ctx));
+
+  auto res = g->MakeNodeHashIndex("mod");
+  KATANA_LOG_VASSERT(res, "Could not create hash index: {}", res.error());
+  KATANA_LOG_ASSERT(!g->MakeNodeHashIndex("mod"));
+  auto index_result = g->GetNodeHashIndex("mod");
+  KATANA_LOG_ASSERT(index_result);
+  std::shared_ptr<Index> index = index_result.value();
+  KATANA_LOG_ASSERT(index->num_keys() == 97);
+
+  size_t num_valid = 0;
+  for (size_t id = 0; id < num_nodes; ++id) {
+    num_valid += valid(id) ? 1 : 0;
+  }
+  KATANA_LOG_ASSERT(index->size() == num_valid);
+
+  auto equal_range = [&](int64_t key) {
+    if (strings) {
+      return static_cast<katana::StringHashEntityIndex<Node>&>(*index)
+          .EqualRange(std::to_string(key));
+    }
+    return static_cast<katana::PrimitiveHashEntityIndex<Node, int64_t>&>(
+               *index)
+        .EqualRange(key);
+  };
+  std::vector<int64_t> keys;
+  std::vector<std::string> string_keys;
+  std::vector<Node> expected;
+  for (int64_t key = -1; key <= 98; ++key) {
+    std::vector<Node> matching;
+    for (size_t id = 0; id < num_nodes; ++id) {
+      if (valid(id) && value(id) == key) {
+        matching.emplace_back(id);
+      }
+    }
+    auto [begin, end] = equal_range(key);
+    KATANA_LOG_ASSERT(std::vector<Node>(begin, end) == matching);
+
+    keys.emplace_back(key);
+    string_keys.emplace_back(std::to_string(key));
+    expected.emplace_back(matching.empty() ? Index::kNotFound : matching[0]);
+  }
+
+  std::vector<Node> found(keys.size());
+  if (strings) {
+    std::vector<std::string_view> views(string_keys.begin(), string_keys.end());
+    static_cast<katana::StringHashEntityIndex<Node>&>(*index).FindBatch(
+        views.data(), views.size(), found.data());
+  } else {
+    static_cast<katana::PrimitiveHashEntityIndex<Node, int64_t>&>(*index)
+        .FindBatch(keys.data(), keys.size(), found.data());
+  }
+  KATANA_LOG_ASSERT(found == expected);
+
+  KATANA_LOG_ASSERT(g->DeleteNodeHashIndex("mod"));
+  KATANA_LOG_ASSERT(!g->HasNodeHashIndex("mod"));
+}
+
+// Checks the order and the prefix searches of a composite index over an
+// integer and a string property with nulls, unscoped and scoped to the type
+// of every node.
+void
+TestCompositeIndex(size_t num_nodes) {
+  using Node = katana::GraphTopology::Node;
+  using Index = katana::CompositeEntityIndex<Node>;
+
+  LinePolicy policy{1};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  auto first = [](size_t id) { return static_cast<int64_t>(id * 7919 % 13); };
+  auto second = [](size_t id) { return std::to_string(id * 31 % 7); };
+  auto valid = [](size_t id) { return id % 5 != 0 && id % 7 != 3; };
+  arrow::Int64Builder first_builder;
+  arrow::LargeStringBuilder second_builder;
+  for (size_t id = 0; id < num_nodes; ++id) {
+    KATANA_LOG_ASSERT(
+        id % 5 != 0 ? first_builder.Append(first(id)).ok()
+                    : first_builder.AppendNull().ok());
+    KATANA_LOG_ASSERT(
+        id % 7 != 3 ? second_builder.Append(second(id)).ok()
+                    : second_builder.AppendNull().ok());
+  }
+  std::shared_ptr<arrow::Array> first_array;
+  std::shared_ptr<arrow::Array> second_array;
+  KATANA_LOG_ASSERT(first_builder.Finish(&first_array).ok());
+  KATANA_LOG_ASSERT(second_builder.Finish(&second_array).ok());
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema(
+              {arrow::field("first", arrow::int64()),
+               arrow::field("second", arrow::large_utf8())}),
+          {first_array, second_array}),
+      &txn_ctx));
+
+  std::vector<std::string> names{"first", "second"};
+  auto res = g->MakeNodeCompositeIndex(names);
+  KATANA_LOG_VASSERT(res, "Could not create composite index: {}", res.error());
+  KATANA_LOG_ASSERT(!g->MakeNodeCompositeIndex(names));
+  std::shared_ptr<Index> index = res.value();
+
+  size_t num_valid = 0;
+  for (size_t id = 0; id < num_nodes; ++id) {
+    num_valid += valid(id) ? 1 : 0;
+  }
+  KATANA_LOG_ASSERT(index->size() == num_valid);
+
+  // Sorted by both values, then by id, without the nulls
+  auto prev = index->end();
+  for (auto it = index->begin(); it != index->end(); prev = it++) {
+    KATANA_LOG_ASSERT(valid(*it));
+    if (prev != index->end()) {
+      auto prev_key = std::make_tuple(first(*prev), second(*prev), *prev);
+      KATANA_LOG_ASSERT(
+          prev_key < std::make_tuple(first(*it), second(*it), *it));
+    }
+  }
+
+  for (int64_t key = -1; key <= 13; ++key) {
+    std::vector<Node> matching;
+    for (size_t id = 0; id < num_nodes; ++id) {
+      if (valid(id) && first(id) == key) {
+        matching.emplace_back(id);
+      }
+    }
+    auto prefix_range = index->EqualRange({int64_t{key}});
+    KATANA_LOG_ASSERT(prefix_range);
+    auto [begin, end] = prefix_range.value();
+    std::vector<Node> found(begin, end);
+    std::sort(found.begin(), found.end());
+    KATANA_LOG_ASSERT(found == matching);
+
+    for (size_t s = 0; s < 7; ++s) {
+      std::string second_key = std::to_string(s);
+      auto range =
+          index->EqualRange({int64_t{key}, std::string_view(second_key)});
+      KATANA_LOG_ASSERT(range);
+      for (auto it = range.value().first; it != range.value().second; ++it) {
+        KATANA_LOG_ASSERT(first(*it) == key && second(*it) == second_key);
+      }
+      size_t expected = std::count_if(
+          matching.begin(), matching.end(),
+          [&](Node id) { return second(id) == second_key; });
+      KATANA_LOG_ASSERT(
+          static_cast<size_t>(std::distance(
+              range.value().first, range.value().second)) == expected);
+    }
+  }
+  KATANA_LOG_ASSERT(!index->EqualRange({std::string_view("0")}));
+  KATANA_LOG_ASSERT(
+      !index->EqualRange({int64_t{0}, std::string_view("0"), int64_t{0}}));
+
+  // Every node has the type of node 0, so the scoped index is the same
+  std::vector<katana::EntityTypeID> types{g->GetTypeOfNode(0)};
+  auto scoped = g->MakeNodeCompositeIndex(names, types);
+  KATANA_LOG_VASSERT(
+      scoped, "Could not create scoped index: {}", scoped.error());
+  KATANA_LOG_ASSERT(std::equal(
+      index->begin(), index->end(), scoped.value()->begin(),
+      scoped.value()->end()));
+  KATANA_LOG_ASSERT(g->GetNodeCompositeIndex(names, types));
+
+  KATANA_LOG_ASSERT(g->DeleteNodeCompositeIndex(names));
+  KATANA_LOG_ASSERT(!g->GetNodeCompositeIndex(names));
+  KATANA_LOG_ASSERT(g->GetNodeCompositeIndex(names, types));
+}
+
+// Checks an index after an upsert of its property that changes a few values,
+// makes some values null and gives others a value, of integers or of
+// strings.
+void
+TestIndexUpdate(size_t num_nodes, bool strings) {
+  using Node = katana::GraphTopology::Node;
+
+  LinePolicy policy{1};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  auto make_table = [&](const auto& value, const auto& valid) {
+    std::shared_ptr<arrow::Array> array;
+    if (strings) {
+      arrow::LargeStringBuilder builder;
+      for (size_t id = 0; id < num_nodes; ++id) {
+        KATANA_LOG_ASSERT(
+            valid(id) ? builder.Append(std::to_string(value(id))).ok()
+                      : builder.AppendNull().ok());
+      }
+      KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+    } else {
+      arrow::Int64Builder builder;
+      for (size_t id = 0; id < num_nodes; ++id) {
+        KATANA_LOG_ASSERT(
+            valid(id) ? builder.Append(value(id)).ok()
+                      : builder.AppendNull().ok());
+      }
+      KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+    }
+    return arrow::Table::Make(
+        arrow::schema({arrow::field("mod", array->type())}), {array});
+  };
+
+  auto old_value = [](size_t id) {
+    return static_cast<int64_t>(id * 7919 % 97);
+  };
+  auto old_valid = [](size_t id) { return id % 5 != 0; };
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(make_table(old_value, old_valid), &txn_ctx));
+  auto index_result = Node::MakeIndex(g.get(), "mod");
+  KATANA_LOG_VASSERT(
+      index_result, "Could not create index: {}", index_result.error());
+
+  auto value = [&](size_t id) {
+    return id % 53 == 0 ? static_cast<int64_t>(100 + id % 11) : old_value(id);
+  };
+  auto valid = [&](size_t id) {
+    return id % 53 != 1 && (old_valid(id) || id % 106 == 0);
+  };
+  KATANA_LOG_ASSERT(
+      g->UpsertNodeProperties(make_table(value, valid), &txn_ctx));
+
+  auto* index = index_result.value();
+  KATANA_LOG_ASSERT(g->node_indexes().size() == 1);
+  KATANA_LOG_ASSERT(g->node_indexes()[0].get() == index);
+
+  size_t num_valid = 0;
+  for (size_t id = 0; id < num_nodes; ++id) {
+    num_valid += valid(id) ? 1 : 0;
+  }
+  KATANA_LOG_ASSERT(index->size() == num_valid);
+
+  // The order of a fresh index: by value, then by id, without the nulls
+  auto less = [&](Node a, Node b) {
+    if (strings) {
+      return std::make_pair(std::to_string(value(a)), a) <
+             std::make_pair(std::to_string(value(b)), b);
+    }
+    return std::make_pair(value(a), a) < std::make_pair(value(b), b);
+  };
+  std::vector<Node> expected;
+  for (size_t id = 0; id < num_nodes; ++id) {
+    if (valid(id)) {
+      expected.emplace_back(id);
+    }
+  }
+  std::sort(expected.begin(), expected.end(), less);
+  KATANA_LOG_ASSERT(std::equal(
+      index->begin(), index->end(), expected.begin(), expected.end()));
+
+  for (int64_t key = -1; key <= 111; ++key) {
+    auto first = std::find_if(expected.begin(), expected.end(), [&](Node id) {
+      return value(id) == key;
+    });
+    katana::EntityIndex<Node>::iterator found;
+    if (strings) {
+      found = static_cast<katana::StringEntityIndex<Node>*>(index)->Find(
+          std::to_string(key));
+    } else {
+      found = static_cast<katana::PrimitiveEntityIndex<Node, int64_t>*>(index)
+                  ->Find(key);
+    }
+    KATANA_LOG_ASSERT(
+        first == expected.end() ? found == index->end() : *found == *first);
+  }
 }
 
 int
@@ -282,8 +686,21 @@ main() {
   TestPrimitiveIndex<katana::GraphTopology::Node, double_t>(10, 3);
   TestPrimitiveIndex<katana::GraphTopology::Edge, double_t>(10, 3);
 
-  TestStringIndex<katana::GraphTopology::Node>(10, 3);
-  TestStringIndex<katana::GraphTopology::Edge>(10, 3);
+  TestStringIndex<katana::GraphTopology::Node>(10, 3, false);
+  TestStringIndex<katana::GraphTopology::Edge>(10, 3, false);
+  TestStringIndex<katana::GraphTopology::Node>(10, 3, true);
+  TestStringIndex<katana::GraphTopology::Edge>(10, 3, true);
+
+  TestIndexOrder(5000);
+
+  TestHashIndex(5000, false, false);
+  TestHashIndex(5000, true, false);
+  TestHashIndex(5000, true, true);
+
+  TestIndexUpdate(5000, false);
+  TestIndexUpdate(5000, true);
+
+  TestCompositeIndex(5000);
 
   return 0;
 }
@@ -0,0 +1,154 @@
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/LazyProjectedGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyQuery.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 10;
+
+/// A line graph whose node n has age n, except for the last one whose age is
+/// null, and is in group "even" or "odd"
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(katana::TxnContext* txn_ctx) {
+  LinePolicy policy{1};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy, txn_ctx);
+
+  arrow::Int64Builder ages;
+  arrow::StringBuilder groups;
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    if (n + 1 == kNumNodes) {
+      KATANA_LOG_ASSERT(ages.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(ages.Append(n).ok());
+    }
+    KATANA_LOG_ASSERT(groups.Append(n % 2 == 0 ? "even" : "odd").ok());
+  }
+  std::shared_ptr<arrow::Array> age_array;
+  KATANA_LOG_ASSERT(ages.Finish(&age_array).ok());
+  std::shared_ptr<arrow::Array> group_array;
+  KATANA_LOG_ASSERT(groups.Finish(&group_array).ok());
+
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("age", arrow::int64()),
+           arrow::field("group", arrow::utf8())}),
+      {age_array, group_array});
+  if (auto r = g->AddNodeProperties(table, txn_ctx); !r) {
+    KATANA_LOG_FATAL("could not add node properties: {}", r.error());
+  }
+  return g;
+}
+
+void
+TestFilter(const katana::PropertyGraph& g) {
+  auto mask = katana::FilterNodes(
+                  g, katana::PropertyFilter()
+                         .Where("age", katana::CompareOp::kGreater, 3)
+                         .Where(
+                             "group", katana::CompareOp::kEqual,
+                             std::string("odd")))
+                  .value();
+  KATANA_LOG_ASSERT(mask.size() == kNumNodes);
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    bool expected = n > 3 && n % 2 == 1 && n + 1 != kNumNodes;
+    KATANA_LOG_VASSERT(mask.test(n) == expected, "node {}", n);
+  }
+
+  // Every node has the type of node 0, and no condition selects every node
+  auto all = katana::FilterNodes(
+                 g, katana::PropertyFilter().OfType(g.GetTypeOfNode(0)))
+                 .value();
+  KATANA_LOG_ASSERT(all.count() == kNumNodes);
+
+  auto projection = katana::LazyProjectedGraph::MakeFromMasks(g, mask);
+  KATANA_LOG_ASSERT(projection.NumNodes() == mask.count());
+  // Consecutive nodes are never both odd
+  KATANA_LOG_ASSERT(projection.NumEdges() == 0);
+
+  auto edges = katana::FilterEdges(g, katana::PropertyFilter()).value();
+  KATANA_LOG_ASSERT(edges.count() == g.NumEdges());
+
+  auto missing = katana::FilterNodes(
+      g, katana::PropertyFilter().Where(
+             "missing", katana::CompareOp::kEqual, 1));
+  KATANA_LOG_ASSERT(!missing);
+}
+
+void
+TestAggregate(const katana::PropertyGraph& g) {
+  auto all = katana::FilterNodes(g, katana::PropertyFilter()).value();
+  auto table =
+      katana::AggregateNodes(
+          g, all, "group",
+          {{katana::AggregateOp::kCount, ""},
+           {katana::AggregateOp::kCount, "age"},
+           {katana::AggregateOp::kSum, "age"},
+           {katana::AggregateOp::kMin, "age"},
+           {katana::AggregateOp::kMax, "age"},
+           {katana::AggregateOp::kMean, "age"}})
+          .value();
+  KATANA_LOG_ASSERT(table->num_rows() == 2);
+  KATANA_LOG_ASSERT(table->num_columns() == 7);
+  KATANA_LOG_ASSERT(table->field(2)->name() == "count(age)");
+
+  auto groups = std::static_pointer_cast<arrow::StringArray>(
+      table->GetColumnByName("group")->chunk(0));
+  auto counts = std::static_pointer_cast<arrow::UInt64Array>(
+      table->GetColumnByName("count")->chunk(0));
+  auto age_counts = std::static_pointer_cast<arrow::UInt64Array>(
+      table->GetColumnByName("count(age)")->chunk(0));
+  auto sums = std::static_pointer_cast<arrow::DoubleArray>(
+      table->GetColumnByName("sum(age)")->chunk(0));
+  auto mins = std::static_pointer_cast<arrow::DoubleArray>(
+      table->GetColumnByName("min(age)")->chunk(0));
+  auto maxes = std::static_pointer_cast<arrow::DoubleArray>(
+      table->GetColumnByName("max(age)")->chunk(0));
+  auto means = std::static_pointer_cast<arrow::DoubleArray>(
+      table->GetColumnByName("mean(age)")->chunk(0));
+  for (int64_t i = 0; i < table->num_rows(); ++i) {
+    KATANA_LOG_ASSERT(counts->Value(i) == 5);
+    if (groups->GetString(i) == "even") {
+      KATANA_LOG_ASSERT(age_counts->Value(i) == 5);
+      KATANA_LOG_ASSERT(sums->Value(i) == 20);
+      KATANA_LOG_ASSERT(mins->Value(i) == 0);
+      KATANA_LOG_ASSERT(maxes->Value(i) == 8);
+      KATANA_LOG_ASSERT(means->Value(i) == 4);
+    } else {
+      // the age of node 9 is null
+      KATANA_LOG_ASSERT(groups->GetString(i) == "odd");
+      KATANA_LOG_ASSERT(age_counts->Value(i) == 4);
+      KATANA_LOG_ASSERT(sums->Value(i) == 16);
+      KATANA_LOG_ASSERT(mins->Value(i) == 1);
+      KATANA_LOG_ASSERT(maxes->Value(i) == 7);
+      KATANA_LOG_ASSERT(means->Value(i) == 4);
+    }
+  }
+
+  katana::DynamicBitset none;
+  none.resize(kNumNodes);
+  auto empty = katana::AggregateNodes(
+                   g, none, "", {{katana::AggregateOp::kSum, "age"}})
+                   .value();
+  KATANA_LOG_ASSERT(empty->num_rows() == 1);
+  KATANA_LOG_ASSERT(empty->column(0)->null_count() == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph(&txn_ctx);
+
+  TestFilter(*g);
+  TestAggregate(*g);
+
+  return 0;
+}
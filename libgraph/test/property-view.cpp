@@ -1,3 +1,7 @@
+#include <memory>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
 #include "katana/Properties.h"
 #include "katana/Result.h"
 
@@ -60,8 +64,93 @@ GenerateFixedBinaryTestArray() {
           array_of_fixed_size_binaries));
 }
 
+/// A column of chunks of the given lengths holding 0, 1, 2, ... with every
+/// seventh value null
+std::shared_ptr<arrow::ChunkedArray>
+MakeChunkedColumn(const std::vector<int64_t>& lengths) {
+  arrow::ArrayVector chunks;
+  int32_t value = 0;
+  for (int64_t length : lengths) {
+    arrow::Int32Builder builder;
+    for (int64_t i = 0; i < length; ++i, ++value) {
+      if (value % 7 == 3) {
+        KATANA_LOG_ASSERT(builder.AppendNull().ok());
+      } else {
+        KATANA_LOG_ASSERT(builder.Append(value).ok());
+      }
+    }
+    std::shared_ptr<arrow::Array> chunk;
+    KATANA_LOG_ASSERT(builder.Finish(&chunk).ok());
+    chunks.emplace_back(chunk);
+  }
+  return std::make_shared<arrow::ChunkedArray>(chunks, arrow::int32());
+}
+
 }  // namespace
 
+katana::Result<void>
+TestChunkIndex() {
+  std::vector<std::vector<int64_t>> layouts{
+      {100}, {16, 16, 16, 5}, {7, 0, 30, 1, 0, 64, 2}, {1, 1000, 3}, {0, 9}};
+  for (const auto& lengths : layouts) {
+    auto column = MakeChunkedColumn(lengths);
+    katana::ChunkIndex index(*column);
+    KATANA_LOG_ASSERT(index.num_chunks() == column->num_chunks());
+    KATANA_LOG_ASSERT(index.length() == column->length());
+
+    int64_t row = 0;
+    for (int c = 0, n = lengths.size(); c < n; ++c) {
+      for (int64_t i = 0; i < lengths[c]; ++i, ++row) {
+        auto [chunk, chunk_row] = index.Locate(row);
+        KATANA_LOG_VASSERT(
+            chunk == c && chunk_row == i, "row {} is at {}:{}, not {}:{}", row,
+            chunk, chunk_row, c, i);
+      }
+    }
+  }
+
+  KATANA_LOG_ASSERT(katana::ChunkIndex().length() == 0);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestChunkedPODView() {
+  using Prop = katana::PODProperty<int32_t>;
+  auto column = MakeChunkedColumn({16, 16, 16, 5});
+  auto view = KATANA_CHECKED(katana::ConstructPropertyView<Prop>(column.get()));
+  KATANA_LOG_ASSERT(view.size() == 53);
+  for (size_t i = 0; i < view.size(); ++i) {
+    KATANA_LOG_ASSERT(view.IsValid(i) == (i % 7 != 3));
+    if (view.IsValid(i)) {
+      KATANA_LOG_ASSERT(view[i] == static_cast<int32_t>(i));
+    }
+  }
+
+  // writes go to the chunks, which were not copied
+  view[40] = -1;
+  auto chunk = std::static_pointer_cast<arrow::Int32Array>(column->chunk(2));
+  KATANA_LOG_ASSERT(chunk->Value(8) == -1);
+
+  // views of one chunk are unchanged by chunked columns
+  auto single = MakeChunkedColumn({10});
+  auto single_view =
+      KATANA_CHECKED(katana::ConstructPropertyView<Prop>(single.get()));
+  KATANA_LOG_ASSERT(single_view.size() == 10 && single_view[9] == 9);
+
+  // views that read one array only do not take several chunks
+  arrow::BooleanBuilder builder;
+  KATANA_CHECKED(builder.AppendValues(std::vector<bool>{true, false}));
+  std::shared_ptr<arrow::Array> flags;
+  KATANA_CHECKED(builder.Finish(&flags));
+  auto two_chunks = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{flags, flags});
+  KATANA_LOG_ASSERT(
+      !katana::ConstructPropertyView<katana::BooleanReadOnlyProperty>(
+          two_chunks.get()));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestNoBitmapValidity() {
   auto valid_array = KATANA_CHECKED(AllValid());
@@ -115,6 +204,8 @@ katana::Result<void>
 TestAll() {
   KATANA_CHECKED(TestNoBitmapValidity());
   KATANA_CHECKED(TestFixedSizedBinaryArray());
+  KATANA_CHECKED(TestChunkIndex());
+  KATANA_CHECKED(TestChunkedPODView());
   return katana::ResultSuccess();
 }
 
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestCommHosts.h"
+#include "katana/Logging.h"
+#include "katana/RDGPartitioner.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TcpCommBackend.h"
+#include "katana/URI.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+namespace fs = std::filesystem;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+
+namespace {
+
+constexpr uint32_t kNumHosts = 4;
+
+using GlobalEdge = std::pair<uint64_t, uint64_t>;
+
+uint32_t
+Owner(uint64_t node, uint64_t num_nodes) {
+  uint32_t h = 0;
+  while (num_nodes * (h + 1) / kNumHosts <= node) {
+    ++h;
+  }
+  return h;
+}
+
+/// The host the policy sends edge (src, dst) to, with the grid of 4 hosts
+/// being 2 by 2
+uint32_t
+HostOf(
+    katana::PartitionPolicy policy, const katana::PropertyGraph& pg,
+    uint64_t src, uint64_t dst) {
+  uint64_t num_nodes = pg.NumNodes();
+  switch (policy) {
+  case katana::PartitionPolicy::kCartesianVertexCut:
+    return (Owner(src, num_nodes) / 2) * 2 + Owner(dst, num_nodes) % 2;
+  case katana::PartitionPolicy::kHybridVertexCut:
+    return pg.topology().OutDegree(src) <= 8 ? Owner(src, num_nodes)
+                                             : Owner(dst, num_nodes);
+  default:
+    return Owner(src, num_nodes);
+  }
+}
+
+void
+TestPolicy(
+    katana::CommBackend* comm, const katana::PropertyGraph& input,
+    katana::PartitionPolicy policy, const std::string& output) {
+  katana::RDGPartitionOptions opts;
+  opts.policy = policy;
+  opts.hybrid_degree_threshold = 8;
+  // many slices, to exercise the rounds of exchanges
+  opts.slice_bytes = 1024;
+  auto part_res = katana::PartitionRDG(inputFile, comm, opts);
+  KATANA_LOG_VASSERT(part_res, "{}", part_res.error());
+  katana::RDGPartition part = std::move(part_res.value());
+
+  uint64_t num_nodes = input.NumNodes();
+  uint64_t begin = num_nodes * comm->Rank / kNumHosts;
+  uint64_t end = num_nodes * (comm->Rank + 1) / kNumHosts;
+  uint64_t num_local = part.out_indexes.size();
+  KATANA_LOG_ASSERT(part.metadata.num_owned_ == end - begin);
+  KATANA_LOG_ASSERT(part.metadata.num_nodes_ == num_local);
+  KATANA_LOG_ASSERT(part.local_to_global.size() == num_local);
+  for (uint64_t n = 0; n < num_local; ++n) {
+    KATANA_LOG_ASSERT(
+        n < end - begin ? part.local_to_global[n] == begin + n
+                        : Owner(part.local_to_global[n], num_nodes) !=
+                              comm->Rank);
+  }
+
+  // every edge is on exactly the host the policy assigns it to
+  std::vector<uint64_t> edges;
+  for (uint64_t n = 0; n < num_local; ++n) {
+    uint64_t edge_begin = n == 0 ? 0 : part.out_indexes[n - 1];
+    for (uint64_t e = edge_begin; e < part.out_indexes[n]; ++e) {
+      uint64_t src = part.local_to_global[n];
+      uint64_t dst = part.local_to_global[part.dests[e]];
+      KATANA_LOG_ASSERT(HostOf(policy, input, src, dst) == comm->Rank);
+      edges.emplace_back(src);
+      edges.emplace_back(dst);
+    }
+  }
+  std::vector<GlobalEdge> all_edges;
+  for (const std::vector<uint64_t>& host_edges : comm->AllGather(edges)) {
+    for (size_t i = 0; i < host_edges.size(); i += 2) {
+      all_edges.emplace_back(host_edges[i], host_edges[i + 1]);
+    }
+  }
+  std::vector<GlobalEdge> expected;
+  const katana::GraphTopology& topo = input.topology();
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topo.OutEdges(n)) {
+      expected.emplace_back(n, topo.OutEdgeDst(e));
+    }
+  }
+  std::sort(all_edges.begin(), all_edges.end());
+  std::sort(expected.begin(), expected.end());
+  KATANA_LOG_ASSERT(all_edges == expected);
+
+  // the mirrors of each host are the masters their owners list for it
+  std::vector<std::vector<uint64_t>> mirrored(kNumHosts);
+  for (uint32_t h = 0; h < kNumHosts; ++h) {
+    for (uint32_t n : part.mirror_nodes[h]) {
+      mirrored[h].emplace_back(part.local_to_global[n]);
+    }
+  }
+  std::vector<std::vector<uint64_t>> masters = comm->AllToAll(mirrored);
+  for (uint32_t h = 0; h < kNumHosts; ++h) {
+    KATANA_LOG_ASSERT(masters[h].size() == part.master_nodes[h].size());
+    for (size_t i = 0; i < masters[h].size(); ++i) {
+      KATANA_LOG_ASSERT(masters[h][i] == begin + part.master_nodes[h][i]);
+    }
+  }
+
+  for (uint64_t n = 0; n < part.node_types.size(); ++n) {
+    KATANA_LOG_ASSERT(
+        part.node_types[n] == input.GetTypeOfNode(part.local_to_global[n]));
+  }
+
+  // Every host writes its partition of one RDG and loads it back
+  katana::TxnContext txn_ctx;
+  auto pg_res = katana::MakePartitionedGraph(std::move(part), &txn_ctx);
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  auto write_res = pg_res.value()->Write(output, "rdg-partitioner");
+  KATANA_LOG_VASSERT(write_res, "{}", write_res.error());
+  auto loaded_res = katana::PropertyGraph::Make(output, &txn_ctx);
+  KATANA_LOG_VASSERT(loaded_res, "{}", loaded_res.error());
+  const katana::PropertyGraph& loaded = *loaded_res.value();
+  KATANA_LOG_ASSERT(loaded.NumNodes() == num_local);
+  KATANA_LOG_ASSERT(loaded.NumEdges() == edges.size() / 2);
+  KATANA_LOG_ASSERT(
+      loaded.partition_policy_id() == static_cast<uint32_t>(policy));
+  KATANA_LOG_ASSERT(loaded.master_nodes().size() == kNumHosts);
+  KATANA_LOG_ASSERT(loaded.mirror_nodes().size() == kNumHosts);
+  KATANA_LOG_ASSERT(
+      loaded.GetNumNodeProperties() == input.GetNumNodeProperties());
+}
+
+/// One host, in a process of its own
+void
+RunHost(
+    uint32_t rank, const std::vector<std::string>& addresses,
+    const std::string& output) {
+  auto comm_res = katana::TcpCommBackend::Make(rank, addresses);
+  KATANA_LOG_VASSERT(comm_res, "{}", comm_res.error());
+  std::unique_ptr<katana::TcpCommBackend> comm = std::move(comm_res.value());
+  katana::SharedMemSys sys(comm.get());
+
+  katana::TxnContext txn_ctx;
+  auto input_res = katana::PropertyGraph::Make(inputFile, &txn_ctx);
+  KATANA_LOG_VASSERT(input_res, "{}", input_res.error());
+  const katana::PropertyGraph& input = *input_res.value();
+
+  for (katana::PartitionPolicy policy :
+       {katana::PartitionPolicy::kEdgeCut,
+        katana::PartitionPolicy::kCartesianVertexCut,
+        katana::PartitionPolicy::kHybridVertexCut}) {
+    TestPolicy(
+        comm.get(), input, policy,
+        output + "-" + std::to_string(static_cast<uint32_t>(policy)));
+  }
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  cll::ParseCommandLineOptions(argc, argv);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/rdgpartitioner");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string output = uri_res.value().path();
+  // The runtime of each host is its own, so hosts are processes rather
+  // than threads
+  bool ok = RunHostProcesses(
+      kNumHosts, [&](uint32_t rank, const std::vector<std::string>& addresses) {
+        RunHost(rank, addresses, output);
+      });
+  for (uint32_t p = 1; p <= 3; ++p) {
+    fs::remove_all(output + "-" + std::to_string(p));
+  }
+  KATANA_LOG_ASSERT(ok);
+
+  return 0;
+}
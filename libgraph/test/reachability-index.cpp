@@ -0,0 +1,93 @@
+#include <queue>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/ReachabilityIndex.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+using Node = katana::ReachabilityIndex::Node;
+
+/// Distances from source along the out edges of graph, by serial BFS
+std::vector<uint32_t>
+SerialBfs(const katana::GraphTopology& graph, Node source) {
+  std::vector<uint32_t> distances(
+      graph.NumNodes(), katana::ReachabilityIndex::kUnreachable);
+  std::queue<Node> queue;
+  distances[source] = 0;
+  queue.push(source);
+  while (!queue.empty()) {
+    Node n = queue.front();
+    queue.pop();
+    for (auto e : graph.OutEdges(n)) {
+      Node dst = graph.OutEdgeDst(e);
+      if (distances[dst] == katana::ReachabilityIndex::kUnreachable) {
+        distances[dst] = distances[n] + 1;
+        queue.push(dst);
+      }
+    }
+  }
+  return distances;
+}
+
+/// Checks the queries of the index of pg against BFS from every stride-th node
+void
+TestGraph(katana::PropertyGraph* pg, uint32_t stride) {
+  katana::ReachabilityIndex index = katana::ReachabilityIndex::Build(pg);
+  KATANA_LOG_ASSERT(index.NumNodes() == pg->NumNodes());
+  // Every node is at least a hub of itself in both directions
+  KATANA_LOG_ASSERT(index.NumEntries() >= 2 * pg->NumNodes());
+
+  for (Node src = 0; src < pg->NumNodes(); src += stride) {
+    std::vector<uint32_t> expected = SerialBfs(pg->topology(), src);
+    for (Node dst = 0; dst < pg->NumNodes(); ++dst) {
+      KATANA_LOG_VASSERT(
+          index.Distance(src, dst) == expected[dst],
+          "distance from {} to {} is {} but should be {}", src, dst,
+          index.Distance(src, dst), expected[dst]);
+      KATANA_LOG_ASSERT(
+          index.Reachable(src, dst) ==
+          (expected[dst] != katana::ReachabilityIndex::kUnreachable));
+    }
+  }
+}
+
+void
+TestRandom() {
+  // Directed, with nodes that reach few others and nodes that reach most
+  auto res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(2000, 2));
+  KATANA_LOG_ASSERT(res);
+  TestGraph(res.value().get(), 7);
+}
+
+void
+TestGrid() {
+  auto pg = katana::MakeGrid(30, 30, false);
+  TestGraph(pg.get(), 11);
+}
+
+void
+TestEmpty() {
+  auto res = katana::PropertyGraph::Make(katana::GraphTopology{});
+  KATANA_LOG_ASSERT(res);
+  katana::ReachabilityIndex index =
+      katana::ReachabilityIndex::Build(res.value().get());
+  KATANA_LOG_ASSERT(index.NumNodes() == 0 && index.NumEntries() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestRandom();
+  TestGrid();
+  TestEmpty();
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedGraph.h"
+#include "katana/SharedMemSys.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+
+namespace {
+
+constexpr int kNumWorkers = 2;
+
+/// Attach the graph the pool sends and check it against a graph loaded
+/// directly
+void
+RunWorker(int socket_fd) {
+  katana::SharedMemSys sys;
+  katana::TxnContext txn_ctx;
+
+  auto shared_res = katana::SharedGraph::Receive(socket_fd);
+  KATANA_LOG_VASSERT(shared_res, "{}", shared_res.error());
+  katana::SharedGraph shared = std::move(shared_res.value());
+
+  // The segment is sealed, so nothing can map it for writing
+  void* addr = mmap(
+      nullptr, shared.size(), PROT_READ | PROT_WRITE, MAP_SHARED, shared.fd(),
+      0);
+  KATANA_LOG_ASSERT(addr == MAP_FAILED);
+
+  auto attached_res = shared.Attach(&txn_ctx);
+  KATANA_LOG_VASSERT(attached_res, "{}", attached_res.error());
+  std::unique_ptr<katana::PropertyGraph> attached =
+      std::move(attached_res.value());
+  KATANA_LOG_ASSERT(attached->topology().in_place());
+
+  auto loaded_res = katana::PropertyGraph::Make(inputFile, &txn_ctx);
+  KATANA_LOG_VASSERT(loaded_res, "{}", loaded_res.error());
+  std::unique_ptr<katana::PropertyGraph> loaded =
+      std::move(loaded_res.value());
+  KATANA_LOG_VASSERT(
+      attached->Equals(loaded.get()), "{}",
+      attached->ReportDiff(loaded.get()));
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  cll::ParseCommandLineOptions(argc, argv);
+
+  // Fork the workers before any runtime starts its threads
+  std::vector<pid_t> workers;
+  std::vector<int> sockets;
+  for (int w = 0; w < kNumWorkers; ++w) {
+    int fds[2];
+    KATANA_LOG_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      close(fds[0]);
+      RunWorker(fds[1]);
+      _exit(0);
+    }
+    close(fds[1]);
+    workers.emplace_back(pid);
+    sockets.emplace_back(fds[0]);
+  }
+
+  {
+    katana::SharedMemSys sys;
+    katana::TxnContext txn_ctx;
+    auto pg_res = katana::PropertyGraph::Make(inputFile, &txn_ctx);
+    KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+    auto shared_res = katana::SharedGraph::Export(*pg_res.value());
+    KATANA_LOG_VASSERT(shared_res, "{}", shared_res.error());
+    for (int socket_fd : sockets) {
+      auto send_res = shared_res.value().Send(socket_fd);
+      KATANA_LOG_VASSERT(send_res, "{}", send_res.error());
+      close(socket_fd);
+    }
+  }
+
+  bool ok = true;
+  for (pid_t pid : workers) {
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  KATANA_LOG_ASSERT(ok);
+
+  return 0;
+}
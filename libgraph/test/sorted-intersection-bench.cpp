@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Logging.h"
+#include "katana/SortedIntersection.h"
+
+namespace {
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  // (size of a, size of b): similar sizes use the vector kernels, skewed ones
+  // gallop
+  for (long a_size : {16, 256, 4096}) {
+    b->Args({a_size, a_size});
+  }
+  b->Args({32, 32 * 1024});
+}
+
+/// Two sorted sets of the given sizes drawn from a range about twice as large
+/// as the bigger one, so that a fair fraction of elements match
+struct Sets {
+  std::vector<uint32_t> a;
+  std::vector<uint32_t> b;
+  std::vector<uint32_t> out;
+
+  Sets(size_t a_size, size_t b_size) {
+    std::mt19937 gen{static_cast<uint32_t>(a_size ^ b_size)};
+    std::vector<uint32_t> universe(2 * std::max(a_size, b_size));
+    std::iota(universe.begin(), universe.end(), uint32_t{0});
+    for (auto [set, size] : {std::pair{&a, a_size}, std::pair{&b, b_size}}) {
+      std::shuffle(universe.begin(), universe.end(), gen);
+      set->assign(universe.begin(), universe.begin() + size);
+      std::sort(set->begin(), set->end());
+    }
+    out.resize(std::min(a.size(), b.size()));
+  }
+};
+
+template <katana::IntersectionKernel kKernel>
+void
+IntersectionCount(benchmark::State& state) {
+  if (!katana::IsIntersectionKernelSupported(kKernel)) {
+    state.SkipWithError("kernel is not supported by this CPU");
+    return;
+  }
+  Sets sets(state.range(0), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(katana::SortedIntersectionCount(
+        sets.a.data(), sets.a.size(), sets.b.data(), sets.b.size(), kKernel));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * (sets.a.size() + sets.b.size()));
+}
+
+template <katana::IntersectionKernel kKernel>
+void
+Intersection(benchmark::State& state) {
+  if (!katana::IsIntersectionKernelSupported(kKernel)) {
+    state.SkipWithError("kernel is not supported by this CPU");
+    return;
+  }
+  Sets sets(state.range(0), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(katana::SortedIntersection(
+        sets.a.data(), sets.a.size(), sets.b.data(), sets.b.size(),
+        sets.out.data(), kKernel));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(
+      state.iterations() * (sets.a.size() + sets.b.size()));
+}
+
+using katana::IntersectionKernel;
+
+BENCHMARK_TEMPLATE(IntersectionCount, IntersectionKernel::kScalar)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(IntersectionCount, IntersectionKernel::kSSE42)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(IntersectionCount, IntersectionKernel::kAVX2)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(IntersectionCount, IntersectionKernel::kAVX512)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(Intersection, IntersectionKernel::kScalar)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(Intersection, IntersectionKernel::kSSE42)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(Intersection, IntersectionKernel::kAVX2)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(Intersection, IntersectionKernel::kAVX512)
+    ->Apply(MakeArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+}
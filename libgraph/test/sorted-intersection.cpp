@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SortedIntersection.h"
+
+namespace {
+
+constexpr katana::IntersectionKernel kKernels[] = {
+    katana::IntersectionKernel::kScalar,
+    katana::IntersectionKernel::kSSE42,
+    katana::IntersectionKernel::kAVX2,
+    katana::IntersectionKernel::kAVX512,
+};
+
+std::vector<uint32_t>
+MakeSortedSet(std::mt19937* gen, size_t size, uint32_t max_value) {
+  std::uniform_int_distribution<uint32_t> dist{0, max_value};
+  std::vector<uint32_t> set;
+  for (size_t i = 0; i < size; ++i) {
+    set.emplace_back(dist(*gen));
+  }
+  std::sort(set.begin(), set.end());
+  set.erase(std::unique(set.begin(), set.end()), set.end());
+  return set;
+}
+
+void
+CheckIntersection(
+    const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  for (auto kernel : kKernels) {
+    if (!katana::IsIntersectionKernelSupported(kernel)) {
+      continue;
+    }
+    KATANA_LOG_ASSERT(
+        katana::SortedIntersectionCount(
+            a.data(), a.size(), b.data(), b.size(), kernel) ==
+        expected.size());
+
+    std::vector<uint32_t> found(std::min(a.size(), b.size()));
+    found.resize(katana::SortedIntersection(
+        a.data(), a.size(), b.data(), b.size(), found.data(), kernel));
+    KATANA_LOG_ASSERT(found == expected);
+  }
+
+  size_t num_found = 0;
+  katana::ForEachSortedIntersection(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+        KATANA_LOG_ASSERT(a[i] == b[j] && a[i] == expected[num_found]);
+        ++num_found;
+        return true;
+      });
+  KATANA_LOG_ASSERT(num_found == expected.size());
+}
+
+void
+TestRandomSets() {
+  std::mt19937 gen{0};
+  for (size_t size : {0, 1, 3, 17, 64, 250, 1000}) {
+    for (uint32_t max_value : {16, 512, 100000}) {
+      auto a = MakeSortedSet(&gen, size, max_value);
+      auto b = MakeSortedSet(&gen, size / 2 + 5, max_value);
+      CheckIntersection(a, b);
+      CheckIntersection(b, a);
+    }
+  }
+}
+
+void
+TestSkewedSets() {
+  // Sizes far enough apart that the shorter set is galloped
+  std::mt19937 gen{1};
+  auto small = MakeSortedSet(&gen, 20, 1 << 20);
+  auto large =
+      MakeSortedSet(&gen, 80 * katana::kIntersectionGallopRatio, 1 << 20);
+  large.insert(large.end(), small.begin(), small.end());
+  std::sort(large.begin(), large.end());
+  large.erase(std::unique(large.begin(), large.end()), large.end());
+  CheckIntersection(small, large);
+  CheckIntersection(large, small);
+}
+
+/// Ranges with duplicates, as the adjacency lists of multigraphs are, count
+/// as std::set_intersection does
+void
+TestMultisets() {
+  std::mt19937 gen{2};
+  auto make_multiset = [&](size_t size, uint32_t max_value) {
+    std::uniform_int_distribution<uint32_t> dist{0, max_value};
+    std::vector<uint32_t> multiset;
+    for (size_t i = 0; i < size; ++i) {
+      multiset.emplace_back(dist(gen));
+    }
+    std::sort(multiset.begin(), multiset.end());
+    return multiset;
+  };
+  // similar sizes merge, skewed ones gallop
+  for (size_t b_size : {size_t{40}, 60 * katana::kIntersectionGallopRatio}) {
+    auto a = make_multiset(50, 20);
+    auto b = make_multiset(b_size, 20);
+    std::vector<uint32_t> expected;
+    std::set_intersection(
+        a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    KATANA_LOG_ASSERT(
+        katana::SortedMultisetIntersectionCount(
+            a.data(), a.size(), b.data(), b.size()) == expected.size());
+    KATANA_LOG_ASSERT(
+        katana::SortedMultisetIntersectionCount(
+            b.data(), b.size(), a.data(), a.size()) == expected.size());
+  }
+}
+
+void
+TestEarlyStop() {
+  std::vector<uint32_t> a{1, 2, 3, 4, 5};
+  size_t calls = 0;
+  bool finished = katana::ForEachSortedIntersection(
+      a.data(), a.size(), a.data(), a.size(), [&](size_t, size_t) {
+        return ++calls < 2;
+      });
+  KATANA_LOG_ASSERT(!finished && calls == 2);
+}
+
+}  // namespace
+
+int
+main() {
+  KATANA_LOG_ASSERT(katana::IsIntersectionKernelSupported(
+      katana::SelectedIntersectionKernel()));
+
+  TestRandomSets();
+  TestSkewedSets();
+  TestMultisets();
+  TestEarlyStop();
+
+  return 0;
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/SparseLinearAlgebra.h"
+
+namespace {
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using DefaultView = katana::PropertyGraphViews::Default;
+using Node = katana::GraphTopology::Node;
+
+constexpr katana::SpMVDirection kDirections[] = {
+    katana::SpMVDirection::kPush,
+    katana::SpMVDirection::kPull,
+    katana::SpMVDirection::kAuto,
+};
+
+/// y = A' x computed serially over the out edges
+template <typename Semiring, typename Graph, typename EdgeValue>
+std::vector<typename Semiring::value_type>
+SerialSpMV(
+    const Graph& graph, const EdgeValue& edge_value,
+    const std::vector<typename Semiring::value_type>& x) {
+  std::vector<typename Semiring::value_type> y(
+      graph.NumNodes(), Semiring::Zero());
+  for (Node u = 0; u < graph.NumNodes(); ++u) {
+    for (auto e : graph.OutEdges(u)) {
+      Node v = graph.OutEdgeDst(e);
+      y[v] = Semiring::Add(
+          y[v], Semiring::Multiply(
+                    edge_value(graph.GetEdgePropertyIndexFromOutEdge(e)),
+                    x[u]));
+    }
+  }
+  return y;
+}
+
+template <typename T>
+void
+Assign(const std::vector<T>& values, katana::SemiringVector<T>* vector) {
+  vector->clear();
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i] != vector->zero()) {
+      vector->Set(i, values[i]);
+    }
+  }
+  vector->Adapt();
+}
+
+template <typename T>
+std::vector<T>
+ToStdVector(const katana::SemiringVector<T>& vector) {
+  std::vector<T> values(vector.size());
+  for (size_t i = 0; i < vector.size(); ++i) {
+    values[i] = vector[i];
+  }
+  return values;
+}
+
+/// Checks SpMV against the serial product for inputs of every density, in
+/// every direction, over views with and without in edges
+template <typename Semiring, typename EdgeValue>
+void
+TestSpMV(
+    katana::PropertyGraph* pg, const EdgeValue& edge_value,
+    std::mt19937* gen) {
+  using T = typename Semiring::value_type;
+  BiDirView bidir = pg->BuildView<BiDirView>();
+  DefaultView out_only = pg->BuildView<DefaultView>();
+  // small blocks make sparse tiles, a single block a dense one
+  auto sparse_tiles = katana::TiledTopology::Make(pg->topology(), 64);
+  auto dense_tiles =
+      katana::TiledTopology::Make(pg->topology(), pg->NumNodes());
+  std::uniform_int_distribution<uint32_t> dist{1, 9};
+
+  for (size_t divisor : {1000, 50, 1}) {
+    std::vector<T> x(pg->NumNodes(), Semiring::Zero());
+    for (size_t i = 0; i < x.size(); ++i) {
+      if ((*gen)() % divisor == 0) {
+        // the boolean semiring only has 0 and 1
+        x[i] = std::is_same_v<T, uint8_t> ? 1 : dist(*gen);
+      }
+    }
+    auto expected = SerialSpMV<Semiring>(bidir, edge_value, x);
+    katana::SemiringVector<T> x_vector(pg->NumNodes(), Semiring::Zero());
+    Assign(x, &x_vector);
+    katana::SemiringVector<T> y(pg->NumNodes(), Semiring::Zero());
+
+    for (katana::SpMVDirection direction : kDirections) {
+      katana::SpMV<Semiring>(
+          bidir, edge_value, x_vector, &y, katana::NoMask{}, direction);
+      KATANA_LOG_ASSERT(ToStdVector(y) == expected);
+      KATANA_LOG_ASSERT(y.NumEntries() ==
+                        static_cast<size_t>(std::count_if(
+                            expected.begin(), expected.end(),
+                            [](T v) { return v != Semiring::Zero(); })));
+    }
+    katana::SpMV<Semiring>(out_only, edge_value, x_vector, &y);
+    KATANA_LOG_ASSERT(ToStdVector(y) == expected);
+    for (const katana::TiledTopology* tiles : {&sparse_tiles, &dense_tiles}) {
+      katana::TiledSpMV<Semiring>(*tiles, edge_value, x_vector, &y);
+      KATANA_LOG_ASSERT(ToStdVector(y) == expected);
+    }
+
+    // the masked entries stay zero
+    auto mask = [](Node v) { return v % 3 != 0; };
+    for (katana::SpMVDirection direction : kDirections) {
+      katana::SpMV<Semiring>(bidir, edge_value, x_vector, &y, mask, direction);
+      for (Node v = 0; v < pg->NumNodes(); ++v) {
+        KATANA_LOG_ASSERT(y[v] == (mask(v) ? expected[v] : Semiring::Zero()));
+      }
+    }
+    katana::TiledSpMV<Semiring>(sparse_tiles, edge_value, x_vector, &y, mask);
+    for (Node v = 0; v < pg->NumNodes(); ++v) {
+      KATANA_LOG_ASSERT(y[v] == (mask(v) ? expected[v] : Semiring::Zero()));
+    }
+  }
+}
+
+/// BFS as repeated boolean products masked by the visited nodes
+void
+TestBFS(katana::PropertyGraph* pg) {
+  BiDirView graph = pg->BuildView<BiDirView>();
+  const uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> expected(graph.NumNodes(), kUnvisited);
+  std::vector<Node> queue{0};
+  expected[0] = 0;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    for (auto e : graph.OutEdges(queue[i])) {
+      Node v = graph.OutEdgeDst(e);
+      if (expected[v] == kUnvisited) {
+        expected[v] = expected[queue[i]] + 1;
+        queue.emplace_back(v);
+      }
+    }
+  }
+
+  for (katana::SpMVDirection direction : kDirections) {
+    std::vector<uint32_t> level(graph.NumNodes(), kUnvisited);
+    auto frontier =
+        std::make_unique<katana::SemiringVector<uint8_t>>(graph.NumNodes(), 0);
+    auto next =
+        std::make_unique<katana::SemiringVector<uint8_t>>(graph.NumNodes(), 0);
+    frontier->Set(0, 1);
+    level[0] = 0;
+    for (uint32_t depth = 1; frontier->NumEntries() > 0; ++depth) {
+      katana::SpMV<katana::OrAndSemiring>(
+          graph, katana::UnitEdgeValue<uint8_t>{}, *frontier, next.get(),
+          [&](Node v) { return level[v] == kUnvisited; }, direction);
+      next->ForEach([&](Node v, uint8_t) { level[v] = depth; });
+      std::swap(frontier, next);
+    }
+    KATANA_LOG_ASSERT(level == expected);
+  }
+}
+
+/// Every column of SpMM is the SpMV of the column
+void
+TestSpMM(katana::PropertyGraph* pg, const std::vector<uint32_t>& weights) {
+  using Semiring = katana::PlusTimesSemiring<uint64_t>;
+  BiDirView graph = pg->BuildView<BiDirView>();
+  auto edge_value = [&](uint64_t e) { return uint64_t{weights[e]}; };
+  const size_t kNumColumns = 5;
+
+  katana::NUMAArray<uint64_t> x;
+  x.allocateBlocked(graph.NumNodes() * kNumColumns);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = i % 7;
+  }
+  katana::NUMAArray<uint64_t> y;
+  auto mask = [](Node v) { return v % 4 != 1; };
+  katana::SpMM<Semiring>(graph, edge_value, x, kNumColumns, &y, mask);
+  katana::NUMAArray<uint64_t> tiled_y;
+  katana::TiledSpMM<Semiring>(
+      katana::TiledTopology::Make(pg->topology(), 64), edge_value, x,
+      kNumColumns, &tiled_y, mask);
+  KATANA_LOG_ASSERT(
+      std::equal(y.begin(), y.end(), tiled_y.begin(), tiled_y.end()));
+
+  for (size_t c = 0; c < kNumColumns; ++c) {
+    std::vector<uint64_t> column(graph.NumNodes());
+    for (Node v = 0; v < graph.NumNodes(); ++v) {
+      column[v] = x[v * kNumColumns + c];
+    }
+    auto expected = SerialSpMV<Semiring>(graph, edge_value, column);
+    for (Node v = 0; v < graph.NumNodes(); ++v) {
+      KATANA_LOG_ASSERT(
+          y[v * kNumColumns + c] == (mask(v) ? expected[v] : 0));
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  std::mt19937 gen{42};
+
+  auto res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(2000, 4));
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+
+  std::vector<uint32_t> weights(pg->NumEdges());
+  for (auto& weight : weights) {
+    weight = gen() % 10 + 1;
+  }
+  auto weight = [&](uint64_t e) { return weights[e]; };
+
+  TestSpMV<katana::PlusTimesSemiring<uint32_t>>(pg.get(), weight, &gen);
+  TestSpMV<katana::MinPlusSemiring<uint32_t>>(pg.get(), weight, &gen);
+  TestSpMV<katana::MinSecondSemiring<uint32_t>>(
+      pg.get(), katana::UnitEdgeValue<uint32_t>{}, &gen);
+  TestSpMV<katana::OrAndSemiring>(
+      pg.get(), katana::UnitEdgeValue<uint8_t>{}, &gen);
+  TestBFS(pg.get());
+  TestSpMM(pg.get(), weights);
+
+  return 0;
+}
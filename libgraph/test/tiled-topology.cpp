@@ -0,0 +1,120 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/TiledTopology.h"
+
+using namespace katana;
+
+namespace {
+
+/// Checks the layout of the tiles of topo and that ForEachEdge visits every
+/// edge once, every destination from a single thread
+void
+CheckTiles(const GraphTopology& topo, uint32_t block_size) {
+  auto tiles = TiledTopology::Make(topo, block_size);
+  KATANA_LOG_ASSERT(tiles.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(tiles.NumEdges() == topo.NumEdges());
+  KATANA_LOG_ASSERT(
+      tiles.NumBlocks() == (topo.NumNodes() + block_size - 1) / block_size);
+
+  for (uint32_t block = 0; block < tiles.NumBlocks(); ++block) {
+    for (uint64_t i = tiles.ColumnBegin(block); i < tiles.ColumnEnd(block);
+         ++i) {
+      const TiledTopology::Tile& tile = tiles.GetTile(i);
+      KATANA_LOG_ASSERT(tile.dst_block == block);
+      if (i > tiles.ColumnBegin(block)) {
+        KATANA_LOG_ASSERT(tiles.GetTile(i - 1).src_block < tile.src_block);
+      }
+      TiledTopology::Node prev_dst = 0;
+      bool first = true;
+      tiles.ForEachRowOfTile(
+          i, [&](TiledTopology::Node dst, const TiledTopology::RowEdges& row) {
+            KATANA_LOG_ASSERT(first || prev_dst < dst);
+            KATANA_LOG_ASSERT(dst >= tiles.BlockBegin(tile.dst_block));
+            KATANA_LOG_ASSERT(dst < tiles.BlockEnd(tile.dst_block));
+            for (size_t j = 0; j < row.size; ++j) {
+              TiledTopology::Node src = row.srcs[j];
+              KATANA_LOG_ASSERT(src >= tiles.BlockBegin(tile.src_block));
+              KATANA_LOG_ASSERT(src < tiles.BlockEnd(tile.src_block));
+              KATANA_LOG_ASSERT(j == 0 || row.srcs[j - 1] <= row.srcs[j]);
+            }
+            prev_dst = dst;
+            first = false;
+          });
+    }
+  }
+
+  NUMAArray<std::atomic<uint32_t>> seen;
+  seen.allocateInterleaved(topo.NumEdges());
+  NUMAArray<std::atomic<uint32_t>> owner;
+  owner.allocateInterleaved(topo.NumNodes());
+  for (uint64_t e = 0; e < topo.NumEdges(); ++e) {
+    seen.constructAt(e, 0u);
+  }
+  const uint32_t kNoOwner = ~uint32_t{0};
+  for (uint64_t n = 0; n < topo.NumNodes(); ++n) {
+    owner.constructAt(n, kNoOwner);
+  }
+
+  tiles.ForEachEdge([&](TiledTopology::Node dst, TiledTopology::Node,
+                        TiledTopology::PropertyIndex property_index) {
+    seen[property_index].fetch_add(1);
+    uint32_t expected = kNoOwner;
+    uint32_t tid = ThreadPool::getTID();
+    owner[dst].compare_exchange_strong(expected, tid);
+    KATANA_LOG_ASSERT(owner[dst] == tid);
+  });
+
+  for (auto src : topo.Nodes()) {
+    for (auto e : topo.OutEdges(src)) {
+      KATANA_LOG_ASSERT(seen[topo.GetEdgePropertyIndexFromOutEdge(e)] == 1);
+    }
+  }
+}
+
+void
+TestDenseAndSparse() {
+  GraphTopology topo = CreateUniformRandomTopology(3000, 6);
+
+  // a single block is one dense tile
+  auto single = TiledTopology::Make(topo, 3000);
+  KATANA_LOG_ASSERT(single.NumTiles() == 1);
+  KATANA_LOG_ASSERT(single.GetTile(0).dense);
+
+  // with small blocks, tiles have few edges and are sparse
+  auto small = TiledTopology::Make(topo, 100);
+  uint64_t num_sparse = 0;
+  for (uint64_t i = 0; i < small.NumTiles(); ++i) {
+    num_sparse += !small.GetTile(i).dense;
+  }
+  KATANA_LOG_ASSERT(num_sparse > 0);
+
+  for (uint32_t block_size : {1u, 7u, 100u, 1024u, 3000u, 5000u}) {
+    CheckTiles(topo, block_size);
+  }
+}
+
+void
+TestEmpty() {
+  auto tiles = TiledTopology::Make(GraphTopology());
+  KATANA_LOG_ASSERT(tiles.NumBlocks() == 0);
+  KATANA_LOG_ASSERT(tiles.NumTiles() == 0);
+  tiles.ForEachEdge([](auto, auto, auto) { KATANA_LOG_FATAL("no edges"); });
+}
+
+}  // namespace
+
+int
+main() {
+  SharedMemSys sys;
+
+  TestDenseAndSparse();
+  TestEmpty();
+
+  return 0;
+}
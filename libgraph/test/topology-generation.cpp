@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+std::vector<uint32_t>
+Dests(const katana::PropertyGraph& pg) {
+  std::vector<uint32_t> dests;
+  for (auto e : pg.OutEdges()) {
+    dests.emplace_back(pg.topology().OutEdgeDst(e));
+  }
+  return dests;
+}
+
+void
+CheckSorted(const katana::PropertyGraph& pg) {
+  for (auto n : pg.Nodes()) {
+    auto edges = pg.OutEdges(n);
+    uint32_t prev = 0;
+    for (auto e : edges) {
+      uint32_t dst = pg.topology().OutEdgeDst(e);
+      KATANA_LOG_VASSERT(dst >= prev, "edges of {} are not sorted", n);
+      prev = dst;
+    }
+  }
+}
+
+void
+TestRMAT() {
+  katana::RMATParameters params;
+  params.scale = 10;
+  params.edge_factor = 8;
+  params.seed = 42;
+
+  katana::setActiveThreads(1);
+  auto serial = katana::MakeRMAT(params).value();
+  katana::setActiveThreads(4);
+  auto parallel = katana::MakeRMAT(params).value();
+
+  KATANA_LOG_ASSERT(serial->NumNodes() == 1024);
+  KATANA_LOG_ASSERT(serial->NumEdges() == 8 * 1024);
+  CheckSorted(*serial);
+  KATANA_LOG_VASSERT(
+      serial->topology().Equals(parallel->topology()),
+      "a seed must generate the same graph with any number of threads");
+
+  // the degrees of an R-MAT graph are skewed
+  uint64_t max_degree = 0;
+  for (auto n : serial->Nodes()) {
+    max_degree = std::max<uint64_t>(max_degree, serial->OutEdges(n).size());
+  }
+  KATANA_LOG_VASSERT(max_degree > 8 * 4, "max degree {}", max_degree);
+
+  params.seed = 43;
+  auto other = katana::MakeRMAT(params).value();
+  KATANA_LOG_ASSERT(Dests(*serial) != Dests(*other));
+
+  params.a = 0.9;
+  KATANA_LOG_ASSERT(!katana::MakeRMAT(params));
+}
+
+void
+TestBarabasiAlbert() {
+  auto pg = katana::MakeBarabasiAlbert(1000, 4, 7).value();
+  KATANA_LOG_ASSERT(pg->NumNodes() == 1000);
+  KATANA_LOG_ASSERT(pg->NumEdges() == 4000);
+  CheckSorted(*pg);
+  for (auto n : pg->Nodes()) {
+    KATANA_LOG_ASSERT(pg->OutEdges(n).size() == 4);
+    for (auto e : pg->OutEdges(n)) {
+      KATANA_LOG_VASSERT(
+          pg->topology().OutEdgeDst(e) <= n,
+          "nodes attach to earlier nodes");
+    }
+  }
+}
+
+void
+TestTypedGraph() {
+  katana::TypedGraphParameters params;
+  params.topology.scale = 12;
+  params.num_node_types = 4;
+  params.num_edge_types = 3;
+  params.type_skew = 2.0;
+  auto pg = katana::MakeTypedGraph(params).value();
+
+  std::vector<uint64_t> node_counts(params.num_node_types);
+  for (auto n : pg->Nodes()) {
+    std::string name =
+        pg->GetNodeAtomicTypeName(pg->GetTypeOfNode(n)).value();
+    node_counts[std::stoul(name.substr(std::string("node_type_").size()))]++;
+  }
+  // with a skew of 2, the shares are 1, 1/4, 1/9 and 1/16 of the total
+  double total = 1 + 1 / 4.0 + 1 / 9.0 + 1 / 16.0;
+  double expected = pg->NumNodes() / total;
+  KATANA_LOG_VASSERT(
+      node_counts[0] > 0.9 * expected && node_counts[0] < 1.1 * expected,
+      "{} nodes of the first type rather than about {}", node_counts[0],
+      expected);
+  KATANA_LOG_ASSERT(node_counts[0] > node_counts[1]);
+  KATANA_LOG_ASSERT(node_counts[1] > node_counts[3]);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeAtomicTypes() == 3);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestRMAT();
+  TestBarabasiAlbert();
+  TestTypedGraph();
+
+  return 0;
+}
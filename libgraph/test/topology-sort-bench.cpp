@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/GraphTopology.h"
+#include "katana/Iterators.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/RadixSort.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using PropertyIndex = katana::GraphTopology::PropertyIndex;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long num_nodes : {1 << 14, 1 << 18}) {
+    b->Args({num_nodes});
+  }
+}
+
+/// Power law topology: the node of rank r has about max_degree / (r + 1) ^ 0.8
+/// out edges to uniformly random destinations, so a few hubs hold most of the
+/// edges. Ranks are shuffled so that the hubs are spread over the id space.
+katana::GraphTopology
+MakePowerLawTopology(size_t num_nodes) {
+  std::mt19937 gen{static_cast<uint32_t>(num_nodes)};
+  std::uniform_int_distribution<Node> dest_dist{
+      0, static_cast<Node>(num_nodes - 1)};
+  const double max_degree = static_cast<double>(num_nodes) / 4;
+
+  std::vector<size_t> rank(num_nodes);
+  std::iota(rank.begin(), rank.end(), size_t{0});
+  std::shuffle(rank.begin(), rank.end(), gen);
+
+  katana::NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  std::vector<Node> dests;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    double r = static_cast<double>(rank[i] + 1);
+    size_t degree = 1 + static_cast<size_t>(max_degree / std::pow(r, 0.8));
+    for (size_t j = 0; j < degree; ++j) {
+      dests.emplace_back(dest_dist(gen));
+    }
+    adj_indices[i] = dests.size();
+  }
+
+  katana::NUMAArray<Node> dests_array;
+  dests_array.allocateInterleaved(dests.size());
+  std::copy(dests.begin(), dests.end(), dests_array.begin());
+
+  return katana::GraphTopology{std::move(adj_indices), std::move(dests_array)};
+}
+
+/// Copies of the destinations and edge property indices of a topology to sort
+/// in each iteration
+struct AdjacencyArrays {
+  katana::NUMAArray<Node> dests;
+  katana::NUMAArray<PropertyIndex> prop_indices;
+
+  explicit AdjacencyArrays(const katana::GraphTopology& topo) {
+    dests.allocateInterleaved(topo.NumEdges());
+    prop_indices.allocateInterleaved(topo.NumEdges());
+  }
+
+  void Reset(const katana::GraphTopology& topo) {
+    katana::ParallelSTL::copy(
+        topo.DestData(), topo.DestData() + topo.NumEdges(), dests.begin());
+    katana::ParallelSTL::iota(
+        prop_indices.begin(), prop_indices.end(), PropertyIndex{0});
+  }
+};
+
+void
+SortAdjacencyComparison(benchmark::State& state) {
+  auto topo = MakePowerLawTopology(state.range(0));
+  AdjacencyArrays arrays{topo};
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    arrays.Reset(topo);
+    state.ResumeTiming();
+
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node n) {
+          auto e_beg = *topo.OutEdges(n).begin();
+          auto e_end = *topo.OutEdges(n).end();
+          auto begin = katana::make_zip_iterator(
+              arrays.prop_indices.begin() + e_beg,
+              arrays.dests.begin() + e_beg);
+          auto end = katana::make_zip_iterator(
+              arrays.prop_indices.begin() + e_end,
+              arrays.dests.begin() + e_end);
+          std::sort(begin, end, [](const auto& a, const auto& b) {
+            return std::get<1>(a) < std::get<1>(b);
+          });
+        },
+        katana::steal(), katana::no_stats());
+  }
+  state.SetItemsProcessed(state.iterations() * topo.NumEdges());
+}
+
+void
+SortAdjacencyRadix(benchmark::State& state) {
+  auto topo = MakePowerLawTopology(state.range(0));
+  AdjacencyArrays arrays{topo};
+
+  struct Scratch {
+    std::vector<Node> keys;
+    std::vector<PropertyIndex> values;
+  };
+  katana::PerThreadStorage<Scratch> scratch;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    arrays.Reset(topo);
+    state.ResumeTiming();
+
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node n) {
+          auto e_beg = *topo.OutEdges(n).begin();
+          auto e_end = *topo.OutEdges(n).end();
+          auto& local = *scratch.getLocal();
+          if (local.keys.size() < e_end - e_beg) {
+            local.keys.resize(e_end - e_beg);
+            local.values.resize(e_end - e_beg);
+          }
+          katana::RadixSortPairs(
+              arrays.dests.data() + e_beg, arrays.prop_indices.data() + e_beg,
+              e_end - e_beg, local.keys.data(), local.values.data());
+        },
+        katana::steal(), katana::no_stats());
+  }
+  state.SetItemsProcessed(state.iterations() * topo.NumEdges());
+}
+
+void
+SortByDegreeComparison(benchmark::State& state) {
+  auto topo = MakePowerLawTopology(state.range(0));
+  katana::NUMAArray<PropertyIndex> new_to_old;
+  new_to_old.allocateInterleaved(topo.NumNodes());
+
+  for (auto _ : state) {
+    katana::ParallelSTL::iota(
+        new_to_old.begin(), new_to_old.end(), PropertyIndex{0});
+    katana::ParallelSTL::sort(
+        new_to_old.begin(), new_to_old.end(), [&](auto i1, auto i2) {
+          return topo.OutDegree(i1) > topo.OutDegree(i2);
+        });
+  }
+  state.SetItemsProcessed(state.iterations() * topo.NumNodes());
+}
+
+void
+SortByDegreeRadix(benchmark::State& state) {
+  auto topo = MakePowerLawTopology(state.range(0));
+  katana::NUMAArray<PropertyIndex> new_to_old;
+  new_to_old.allocateInterleaved(topo.NumNodes());
+
+  Edge max_degree = 0;
+  for (auto n : topo.Nodes()) {
+    max_degree = std::max(max_degree, topo.OutDegree(n));
+  }
+
+  for (auto _ : state) {
+    katana::ParallelSTL::iota(
+        new_to_old.begin(), new_to_old.end(), PropertyIndex{0});
+    katana::ParallelRadixSortByKey(
+        new_to_old.data(), new_to_old.size(),
+        [&](PropertyIndex n) { return max_degree - topo.OutDegree(n); },
+        max_degree);
+  }
+  state.SetItemsProcessed(state.iterations() * topo.NumNodes());
+}
+
+/// End to end view building, which uses the radix sorts above
+template <typename View>
+void
+BuildView(benchmark::State& state) {
+  uint64_t num_edges = 0;
+  for (auto _ : state) {
+    // Use a fresh graph every iteration so that the view is not cached
+    state.PauseTiming();
+    auto res =
+        katana::PropertyGraph::Make(MakePowerLawTopology(state.range(0)));
+    KATANA_LOG_ASSERT(res);
+    std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+    num_edges = pg->NumEdges();
+    state.ResumeTiming();
+
+    View view = pg->BuildView<View>();
+    benchmark::DoNotOptimize(view.NumEdges());
+  }
+  state.SetItemsProcessed(state.iterations() * num_edges);
+}
+
+BENCHMARK(SortAdjacencyComparison)->Apply(MakeArguments);
+BENCHMARK(SortAdjacencyRadix)->Apply(MakeArguments);
+BENCHMARK(SortByDegreeComparison)->Apply(MakeArguments);
+BENCHMARK(SortByDegreeRadix)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(BuildView, katana::PropertyGraphViews::EdgesSortedByDestID)
+    ->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(
+    BuildView,
+    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID)
+    ->Apply(MakeArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,93 @@
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/RDG.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypeSegmentedProperties.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+using GNode = katana::GraphTopology::Node;
+
+katana::PropertyGraph
+LoadGraph(const std::string& rdg_file) {
+  KATANA_LOG_ASSERT(!rdg_file.empty());
+  katana::TxnContext txn_ctx;
+  auto g_res =
+      katana::PropertyGraph::Make(rdg_file, &txn_ctx, katana::RDGLoadOptions());
+
+  if (!g_res) {
+    KATANA_LOG_FATAL("making result: {}", g_res.error());
+  }
+  katana::PropertyGraph g = std::move(*g_res.value());
+  return g;
+}
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  katana::PropertyGraph pg = LoadGraph(inputFile);
+
+  auto storage_res = katana::TypeSegmentedNodeProperties::Make(pg);
+  if (!storage_res) {
+    KATANA_LOG_FATAL("making segments: {}", storage_res.error());
+  }
+  const katana::TypeSegmentedNodeProperties& storage = storage_res.value();
+
+  uint64_t num_rows = 0;
+  for (const auto& segment : storage.segments()) {
+    KATANA_LOG_ASSERT(storage.GetSegment(segment.type) == &segment);
+    KATANA_LOG_ASSERT(
+        static_cast<uint64_t>(segment.properties->num_rows()) ==
+        segment.nodes.size());
+    num_rows += segment.nodes.size();
+
+    for (const auto& column : segment.properties->columns()) {
+      KATANA_LOG_VASSERT(
+          column->null_count() < column->length(),
+          "\n all null column in segment of type {}", segment.type);
+    }
+  }
+  KATANA_LOG_VASSERT(
+      num_rows == pg.NumNodes(), "\n Num Rows: {} Num Nodes: {}", num_rows,
+      pg.NumNodes());
+
+  // Every value of a segment is the value of the node in the wide table, and
+  // the columns that are dropped from a segment are null for its nodes
+  for (GNode n = 0; n < pg.NumNodes(); ++n) {
+    katana::EntityTypeID type = pg.GetTypeOfNode(n);
+    const auto* segment = storage.GetSegment(type);
+    KATANA_LOG_ASSERT(segment != nullptr);
+    uint32_t index = storage.LocalIndex(n);
+    KATANA_LOG_ASSERT(segment->nodes[index] == n);
+
+    for (const auto& field : pg.loaded_node_schema()->fields()) {
+      auto wide = pg.GetNodeProperty(field->name())
+                      .value()
+                      ->GetScalar(pg.GetNodePropertyIndex(n))
+                      .ValueOrDie();
+      auto column = segment->properties->GetColumnByName(field->name());
+      if (!column) {
+        KATANA_LOG_VASSERT(
+            !wide->is_valid, "\n node {} has dropped property {}", n,
+            field->name());
+        continue;
+      }
+      auto local = column->GetScalar(index).ValueOrDie();
+      KATANA_LOG_VASSERT(
+          local->Equals(*wide), "\n node {} property {}: {} != {}", n,
+          field->name(), local->ToString(), wide->ToString());
+    }
+  }
+
+  KATANA_LOG_ASSERT(storage.SizeInBytes() > 0);
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+/// Betweenness centrality over every source by a serial Brandes
+std::vector<double>
+SerialBrandes(uint32_t num_nodes, const Edges& edges) {
+  std::vector<std::vector<uint32_t>> out(num_nodes);
+  for (const auto& [src, dst] : edges) {
+    out[src].emplace_back(dst);
+  }
+  std::vector<double> bc(num_nodes, 0);
+  for (uint32_t s = 0; s < num_nodes; ++s) {
+    std::vector<int64_t> level(num_nodes, -1);
+    std::vector<double> paths(num_nodes, 0);
+    std::vector<double> dependency(num_nodes, 0);
+    std::vector<uint32_t> order;
+    std::queue<uint32_t> queue;
+    level[s] = 0;
+    paths[s] = 1;
+    queue.push(s);
+    while (!queue.empty()) {
+      uint32_t v = queue.front();
+      queue.pop();
+      order.emplace_back(v);
+      for (uint32_t u : out[v]) {
+        if (level[u] < 0) {
+          level[u] = level[v] + 1;
+          queue.push(u);
+        }
+        if (level[u] == level[v] + 1) {
+          paths[u] += paths[v];
+        }
+      }
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      uint32_t v = *it;
+      for (uint32_t u : out[v]) {
+        if (level[u] == level[v] + 1) {
+          dependency[v] += paths[v] / paths[u] * (1 + dependency[u]);
+        }
+      }
+      if (v != s) {
+        bc[v] += dependency[v];
+      }
+    }
+  }
+  return bc;
+}
+
+Edges
+RandomEdges(uint32_t num_nodes, uint32_t num_edges, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  Edges edges;
+  for (uint32_t e = 0; e < num_edges; ++e) {
+    edges.emplace_back(node(gen), node(gen));
+  }
+  return edges;
+}
+
+std::vector<float>
+Run(katana::PropertyGraph* pg, const std::string& name,
+    const BetweennessCentralityPlan& plan) {
+  katana::TxnContext txn_ctx;
+  auto res = BetweennessCentrality(
+      pg, name, &txn_ctx, kBetweennessCentralityAllNodes, plan);
+  KATANA_LOG_VASSERT(res, "{}: {}", name, res.error());
+  return NodeValues<float>(pg, name);
+}
+
+void
+CheckClose(
+    const std::vector<float>& found, const std::vector<double>& expected) {
+  KATANA_LOG_ASSERT(found.size() == expected.size());
+  for (size_t n = 0; n < found.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(found[n] - expected[n]) <= 1e-4 * (1 + expected[n]),
+        "node {}: centrality {}, expected {}", n, found[n], expected[n]);
+  }
+}
+
+void
+TestSmall() {
+  // the path 0 -> 1 -> 2 -> 3, with 4 -> 2 joining it halfway
+  Edges edges = {{0, 1}, {1, 2}, {2, 3}, {4, 2}};
+  std::vector<double> expected = SerialBrandes(5, edges);
+  KATANA_LOG_ASSERT(expected == (std::vector<double>{0, 2, 3, 0, 0}));
+
+  auto pg = MakeTestGraph(5, edges);
+  CheckClose(
+      Run(pg.get(), "level", BetweennessCentralityPlan::Level()), expected);
+  CheckClose(
+      Run(pg.get(), "outer", BetweennessCentralityPlan::Outer()), expected);
+  // the bound asks for more sources than there are nodes, so all are run
+  CheckClose(
+      Run(pg.get(), "adaptive", BetweennessCentralityPlan::Adaptive()),
+      expected);
+}
+
+void
+TestExactWhenBoundExceedsNodes() {
+  constexpr uint32_t kNumNodes = 300;
+  Edges edges = RandomEdges(kNumNodes, 4 * kNumNodes, 4);
+  auto pg = MakeTestGraph(kNumNodes, edges);
+  std::vector<double> expected = SerialBrandes(kNumNodes, edges);
+  CheckClose(
+      Run(pg.get(), "level", BetweennessCentralityPlan::Level()), expected);
+  CheckClose(
+      Run(pg.get(), "adaptive", BetweennessCentralityPlan::Adaptive()),
+      expected);
+}
+
+void
+TestSampled() {
+  // with epsilon 0.05 the Hoeffding bound, about 2300 sources, is below the
+  // number of nodes, so the sources are sampled
+  constexpr uint32_t kNumNodes = 3000;
+  constexpr float kEpsilon = 0.05;
+  Edges edges = RandomEdges(kNumNodes, 3 * kNumNodes, 8);
+  auto pg = MakeTestGraph(kNumNodes, edges);
+  std::vector<double> expected = SerialBrandes(kNumNodes, edges);
+
+  std::vector<float> adaptive = Run(
+      pg.get(), "adaptive", BetweennessCentralityPlan::Adaptive(kEpsilon, 0.1));
+  double norm = static_cast<double>(kNumNodes) * (kNumNodes - 2);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(adaptive[n] - expected[n]) / norm <= kEpsilon,
+        "node {}: centrality {}, expected {}", n, adaptive[n], expected[n]);
+  }
+}
+
+void
+TestRejected() {
+  auto pg = MakeTestGraph(3, {{0, 1}, {1, 2}});
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg.get(), "count", &txn_ctx, 2U, BetweennessCentralityPlan::Adaptive()));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg.get(), "zero", &txn_ctx, kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Adaptive(0, 0.1)));
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg.get(), "certain", &txn_ctx, kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Adaptive(0.1, 0)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSmall();
+  TestExactWhenBoundExceedsNodes();
+  TestSampled();
+  TestRejected();
+
+  return 0;
+}
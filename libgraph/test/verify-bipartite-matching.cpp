@@ -0,0 +1,184 @@
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+using namespace katana::analytics;
+using Node = katana::GraphTopology::Node;
+
+namespace {
+
+/// A graph with a node for each of node_types and the edges (source,
+/// destination), where the nodes are of type "Worker" (1), "Task" (2), both (3)
+/// or neither (0)
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(
+    const std::vector<uint8_t>& node_types,
+    const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(node_types.size());
+  for (const auto& [src, dst] : edges) {
+    builder.AddEdge(src, dst);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "Worker",
+          [&](Node n) { return static_cast<uint8_t>(node_types[n] & 1); }),
+      katana::PropertyGenerator("Task", [&](Node n) {
+        return static_cast<uint8_t>((node_types[n] >> 1) & 1);
+      }));
+  KATANA_LOG_VASSERT(res, "adding types: {}", res.error());
+  auto types_res = pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+  return pg;
+}
+
+/// The size of a maximum matching by augmenting paths one at a time
+uint64_t
+ReferenceMatching(
+    const std::vector<uint8_t>& node_types,
+    const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+  std::vector<std::vector<uint32_t>> neighbors(node_types.size());
+  for (const auto& [src, dst] : edges) {
+    if (node_types[src] == 1 && node_types[dst] == 2) {
+      neighbors[src].emplace_back(dst);
+    } else if (node_types[src] == 2 && node_types[dst] == 1) {
+      neighbors[dst].emplace_back(src);
+    }
+  }
+  std::vector<uint32_t> mates(node_types.size(), kUnmatchedNode);
+  std::vector<bool> visited;
+  std::function<bool(uint32_t)> augment = [&](uint32_t left) {
+    for (uint32_t right : neighbors[left]) {
+      if (visited[right]) {
+        continue;
+      }
+      visited[right] = true;
+      if (mates[right] == kUnmatchedNode || augment(mates[right])) {
+        mates[right] = left;
+        return true;
+      }
+    }
+    return false;
+  };
+  uint64_t size = 0;
+  for (uint32_t n = 0; n < node_types.size(); ++n) {
+    visited.assign(node_types.size(), false);
+    size += node_types[n] == 1 && augment(n);
+  }
+  return size;
+}
+
+void
+RunMatching(katana::PropertyGraph* pg, uint64_t expected_size) {
+  std::vector<BipartiteMatchingPlan> plans{
+      BipartiteMatchingPlan::PothenFan(),
+      BipartiteMatchingPlan::PothenFan(false)};
+  for (size_t i = 0; i < plans.size(); ++i) {
+    std::string name = "partner-" + std::to_string(i);
+    katana::TxnContext txn_ctx;
+    auto size_res =
+        BipartiteMatching(pg, "Worker", "Task", name, &txn_ctx, plans[i]);
+    KATANA_LOG_VASSERT(size_res, "matching: {}", size_res.error());
+    KATANA_LOG_VASSERT(
+        size_res.value() == expected_size, "size {}, expected {}",
+        size_res.value(), expected_size);
+
+    auto valid_res = BipartiteMatchingAssertValid(pg, "Worker", "Task", name);
+    KATANA_LOG_VASSERT(valid_res, "invalid matching: {}", valid_res.error());
+
+    auto stats_res =
+        BipartiteMatchingStatistics::Compute(pg, "Worker", "Task", name);
+    KATANA_LOG_VASSERT(stats_res, "statistics: {}", stats_res.error());
+    KATANA_LOG_ASSERT(stats_res.value().cardinality == expected_size);
+  }
+}
+
+void
+TestSmall() {
+  // greedily matching 0 to 2 leaves 1 unmatched; 4 has no type, and the
+  // edge between the workers 5 and 0 is ignored
+  std::vector<uint8_t> types{1, 1, 2, 2, 0, 1};
+  std::vector<std::pair<uint32_t, uint32_t>> edges{
+      {0, 2}, {0, 3}, {2, 1}, {1, 4}, {4, 3}, {5, 0}};
+  auto pg = MakeGraph(types, edges);
+  RunMatching(pg.get(), 2);
+
+  // a node may not be of both types
+  types[4] = 3;
+  auto both = MakeGraph(types, edges);
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      !BipartiteMatching(both.get(), "Worker", "Task", "partner", &txn_ctx));
+}
+
+void
+TestRandom() {
+  for (uint32_t seed = 0; seed < 6; ++seed) {
+    uint32_t num_nodes = 500 + 300 * seed;
+    std::vector<uint8_t> types(num_nodes);
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      // more workers than tasks, and a few nodes of neither
+      uint64_t r = katana::StatelessRandom(seed, n) % 10;
+      types[n] = r < 6 ? 1 : (r < 9 ? 2 : 0);
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    uint64_t num_edges = uint64_t{num_nodes} * (1 + seed % 3);
+    for (uint64_t e = 0; e < num_edges; ++e) {
+      edges.emplace_back(
+          katana::StatelessRandom(seed + 100, 2 * e) % num_nodes,
+          katana::StatelessRandom(seed + 100, 2 * e + 1) % num_nodes);
+    }
+    auto pg = MakeGraph(types, edges);
+    RunMatching(pg.get(), ReferenceMatching(types, edges));
+  }
+}
+
+void
+TestInvalid() {
+  auto pg = MakeGraph({1, 2}, {{0, 1}});
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      !BipartiteMatching(pg.get(), "Worker", "Job", "partner", &txn_ctx));
+  KATANA_LOG_ASSERT(
+      !BipartiteMatching(pg.get(), "Task", "Task", "partner", &txn_ctx));
+
+  // a matching that is not a maximum one fails the check
+  KATANA_LOG_ASSERT(
+      BipartiteMatching(pg.get(), "Worker", "Task", "partner", &txn_ctx));
+  auto res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "nobody", [](Node) { return kUnmatchedNode; }));
+  KATANA_LOG_VASSERT(res, "adding partners: {}", res.error());
+  KATANA_LOG_ASSERT(
+      !BipartiteMatchingAssertValid(pg.get(), "Worker", "Task", "nobody"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSmall();
+  TestRandom();
+  TestInvalid();
+
+  return 0;
+}
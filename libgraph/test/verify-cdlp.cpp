@@ -1,9 +1,127 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "TestSmallGraphs.h"
 #include "katana/SharedMemSys.h"
 #include "katana/TopologyGeneration.h"
 #include "katana/analytics/cdlp/cdlp.h"
 
 using namespace katana::analytics;
 
+/// Labels after max_iterations synchronous rounds in which every node takes
+/// the label of largest total weight among its neighbors, the smallest on
+/// ties. Every edge makes its endpoints neighbors of each other.
+std::vector<uint64_t>
+SerialCdlp(
+    uint32_t num_nodes,
+    const std::vector<std::tuple<uint32_t, uint32_t, double>>& edges,
+    size_t max_iterations) {
+  std::vector<std::vector<std::pair<uint32_t, double>>> neighbors(num_nodes);
+  for (const auto& [src, dst, weight] : edges) {
+    neighbors[src].emplace_back(dst, weight);
+    neighbors[dst].emplace_back(src, weight);
+  }
+  std::vector<uint64_t> labels(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    labels[n] = n;
+  }
+  for (size_t iter = 0; iter < max_iterations; ++iter) {
+    std::vector<uint64_t> next = labels;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      std::map<uint64_t, double> freq;
+      for (const auto& [neighbor, weight] : neighbors[n]) {
+        freq[labels[neighbor]] += weight;
+      }
+      double best_freq = 0;
+      for (const auto& [label, f] : freq) {
+        // in increasing label order, so only a larger total replaces
+        if (label == freq.begin()->first || f > best_freq) {
+          next[n] = label;
+          best_freq = f;
+        }
+      }
+    }
+    if (next == labels) {
+      break;
+    }
+    labels = next;
+  }
+  return labels;
+}
+
+/// A sparse random graph without self loops and a hub, node 0, with more
+/// neighbors than fit the label table of ordinary nodes; weights are small
+/// integers so float and integer sums agree
+std::vector<std::tuple<uint32_t, uint32_t, uint32_t>>
+RandomWeightedEdges(uint32_t num_nodes, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<uint32_t> node(1, num_nodes - 1);
+  std::uniform_int_distribution<uint32_t> weight(1, 4);
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> edges;
+  for (uint32_t e = 0; e < 2 * num_nodes; ++e) {
+    uint32_t a = node(gen);
+    uint32_t b = node(gen);
+    if (a != b) {
+      edges.emplace_back(a, b, weight(gen));
+    }
+  }
+  for (uint32_t e = 0; e < 2500; ++e) {
+    edges.emplace_back(node(gen), 0, weight(gen));
+  }
+  return edges;
+}
+
+void
+TestMatchesSerial() {
+  constexpr uint32_t kNumNodes = 4000;
+  constexpr size_t kIterations = 10;
+  auto edges = RandomWeightedEdges(kNumNodes, 14);
+  std::vector<std::tuple<uint32_t, uint32_t, double>> unit_edges;
+  std::vector<std::tuple<uint32_t, uint32_t, double>> weighted_edges;
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  std::vector<std::tuple<uint32_t, uint32_t, float>> float_edges;
+  for (const auto& [src, dst, weight] : edges) {
+    unit_edges.emplace_back(src, dst, 1);
+    weighted_edges.emplace_back(src, dst, weight);
+    pairs.emplace_back(src, dst);
+    float_edges.emplace_back(src, dst, weight * 0.5F);
+  }
+  std::vector<uint64_t> unweighted =
+      SerialCdlp(kNumNodes, unit_edges, kIterations);
+  std::vector<uint64_t> weighted =
+      SerialCdlp(kNumNodes, weighted_edges, kIterations);
+
+  katana::TxnContext txn_ctx;
+  // stored one way for the undirected view, and both ways
+  for (bool symmetric : {false, true}) {
+    auto pg = MakeWeightedTestGraph(kNumNodes, edges, symmetric);
+    auto res = Cdlp(pg.get(), "unweighted", kIterations, &txn_ctx, symmetric);
+    KATANA_LOG_VASSERT(res, "cdlp: {}", res.error());
+    KATANA_LOG_ASSERT(
+        NodeValues<uint64_t>(pg.get(), "unweighted") == unweighted);
+
+    auto weighted_res = Cdlp(
+        pg.get(), "weight", "weighted", kIterations, &txn_ctx, symmetric);
+    KATANA_LOG_VASSERT(weighted_res, "weighted cdlp: {}", weighted_res.error());
+    KATANA_LOG_ASSERT(NodeValues<uint64_t>(pg.get(), "weighted") == weighted);
+
+    // halving every weight changes no choice
+    auto float_pg = MakeWeightedTestGraph(kNumNodes, float_edges, symmetric);
+    auto float_res = Cdlp(
+        float_pg.get(), "weight", "weighted", kIterations, &txn_ctx,
+        symmetric);
+    KATANA_LOG_VASSERT(float_res, "float weights: {}", float_res.error());
+    KATANA_LOG_ASSERT(
+        NodeValues<uint64_t>(float_pg.get(), "weighted") == weighted);
+  }
+
+  auto pg = MakeTestGraph(kNumNodes, pairs);
+  KATANA_LOG_ASSERT(!Cdlp(pg.get(), "none", "missing", 1, &txn_ctx));
+}
+
 void
 RunCdlp(
     std::unique_ptr<katana::PropertyGraph>&& pg, const bool& is_symmetric,
@@ -64,5 +182,7 @@ main() {
   // Triangular array tests
   RunCdlp(katana::MakeTriangle(1), true, CdlpStatistics{1, 1, 3, 1});
 
+  TestMatchesSerial();
+
   return 0;
 }
@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/ClusteringImplementationBase.h"
+#include "katana/analytics/leiden_clustering/leiden_clustering.h"
+#include "katana/analytics/louvain_clustering/louvain_clustering.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+using WeightedEdges = std::vector<std::tuple<uint32_t, uint32_t, uint32_t>>;
+
+constexpr uint32_t kNumCliques = 8;
+constexpr uint32_t kCliqueSize = 20;
+constexpr uint32_t kNumNodes = kNumCliques * kCliqueSize;
+
+using FollowingGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, std::tuple<CurrentCommunityID>,
+    std::tuple<EdgeWeight<uint32_t>>>;
+using FollowingBase = ClusteringImplementationBase<
+    FollowingGraph, uint32_t, CommunityType<uint32_t>>;
+
+/// Whether two clusterings group the nodes the same way, whatever the ids
+bool
+SamePartition(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  std::unordered_map<uint64_t, uint64_t> a_to_b;
+  std::unordered_map<uint64_t, uint64_t> b_to_a;
+  for (size_t n = 0; n < a.size(); ++n) {
+    auto a_it = a_to_b.emplace(a[n], b[n]).first;
+    auto b_it = b_to_a.emplace(b[n], a[n]).first;
+    if (a_it->second != b[n] || b_it->second != a[n]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// A ring of cliques, each joined to the next by one edge: every clique is
+/// a cluster of the best modularity
+Edges
+RingOfCliques() {
+  Edges edges;
+  for (uint32_t c = 0; c < kNumCliques; ++c) {
+    for (uint32_t a = 0; a < kCliqueSize; ++a) {
+      for (uint32_t b = a + 1; b < kCliqueSize; ++b) {
+        edges.emplace_back(c * kCliqueSize + a, c * kCliqueSize + b);
+      }
+    }
+    edges.emplace_back(
+        c * kCliqueSize, ((c + 1) % kNumCliques) * kCliqueSize + 1);
+  }
+  return edges;
+}
+
+std::vector<uint64_t>
+CliqueClusters() {
+  std::vector<uint64_t> clusters(kNumNodes);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    clusters[n] = n / kCliqueSize;
+  }
+  return clusters;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const Edges& edges, uint32_t num_nodes = kNumNodes) {
+  WeightedEdges weighted;
+  for (const auto& [src, dst] : edges) {
+    weighted.emplace_back(src, dst, 1);
+  }
+  return MakeWeightedTestGraph(num_nodes, weighted, true);
+}
+
+/// Checks a clustering, run cold by run_cold(graph, output) and warm started
+/// by run_warm(graph, initial, changed edges, output), on a ring of cliques
+/// and after two of its cliques are joined
+template <typename Cold, typename Warm, typename Valid>
+void
+CheckWarmStart(
+    const std::string& name, const Cold& run_cold, const Warm& run_warm,
+    const Valid& assert_valid) {
+  Edges edges = RingOfCliques();
+  auto pg = MakeGraph(edges);
+
+  auto cold_res = run_cold(pg.get(), "cold");
+  KATANA_LOG_VASSERT(cold_res, "{}: {}", name, cold_res.error());
+  KATANA_LOG_VASSERT(assert_valid(pg.get(), "cold"), "{} is invalid", name);
+  std::vector<uint64_t> cold = NodeValues<uint64_t>(pg.get(), "cold");
+  KATANA_LOG_VASSERT(
+      SamePartition(cold, CliqueClusters()), "{} does not find the cliques",
+      name);
+
+  // nothing changed, so the clusters stay
+  auto same_res = run_warm(pg.get(), "cold", Edges{}, "same");
+  KATANA_LOG_VASSERT(same_res, "{} warm: {}", name, same_res.error());
+  KATANA_LOG_ASSERT(
+      SamePartition(NodeValues<uint64_t>(pg.get(), "same"), cold));
+
+  // join the first two cliques into one
+  Edges inserted;
+  for (uint32_t a = 0; a < kCliqueSize; ++a) {
+    for (uint32_t b = kCliqueSize; b < 2 * kCliqueSize; ++b) {
+      inserted.emplace_back(a, b);
+    }
+  }
+  Edges changed_edges = edges;
+  changed_edges.insert(changed_edges.end(), inserted.begin(), inserted.end());
+  auto changed = MakeGraph(changed_edges);
+  std::vector<uint64_t> expected = CliqueClusters();
+  for (uint32_t n = kCliqueSize; n < 2 * kCliqueSize; ++n) {
+    expected[n] = 0;
+  }
+
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddNodeProperties(
+      changed.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "initial", [&](uint64_t n) { return cold[n]; }));
+  KATANA_LOG_VASSERT(add_res, "adding clusters: {}", add_res.error());
+  auto warm_res = run_warm(changed.get(), "initial", inserted, "warm");
+  KATANA_LOG_VASSERT(warm_res, "{} warm: {}", name, warm_res.error());
+  KATANA_LOG_VASSERT(
+      assert_valid(changed.get(), "warm"), "{} warm is invalid", name);
+  KATANA_LOG_VASSERT(
+      SamePartition(NodeValues<uint64_t>(changed.get(), "warm"), expected),
+      "{} warm start does not join the cliques", name);
+
+  auto rerun_res = run_cold(changed.get(), "rerun");
+  KATANA_LOG_VASSERT(rerun_res, "{}: {}", name, rerun_res.error());
+  KATANA_LOG_ASSERT(
+      SamePartition(NodeValues<uint64_t>(changed.get(), "rerun"), expected));
+
+  KATANA_LOG_ASSERT(!run_warm(changed.get(), "initial", {{0, kNumNodes}}, "x"));
+  KATANA_LOG_ASSERT(!run_warm(changed.get(), "missing", Edges{}, "y"));
+}
+
+void
+TestLouvainWarmStart() {
+  katana::TxnContext txn_ctx;
+  CheckWarmStart(
+      "louvain",
+      [&](katana::PropertyGraph* pg, const std::string& output) {
+        return LouvainClustering(pg, "weight", output, &txn_ctx, true);
+      },
+      [&](katana::PropertyGraph* pg, const std::string& initial,
+          const Edges& changed, const std::string& output) {
+        return LouvainClustering(
+            pg, "weight", initial, changed, output, &txn_ctx, true);
+      },
+      [](katana::PropertyGraph* pg, const std::string& output) {
+        return bool(LouvainClusteringAssertValid(pg, "weight", output));
+      });
+}
+
+void
+TestLeidenWarmStart() {
+  katana::TxnContext txn_ctx;
+  CheckWarmStart(
+      "leiden",
+      [&](katana::PropertyGraph* pg, const std::string& output) {
+        return LeidenClustering(pg, "weight", output, &txn_ctx, true);
+      },
+      [&](katana::PropertyGraph* pg, const std::string& initial,
+          const Edges& changed, const std::string& output) {
+        return LeidenClustering(
+            pg, "weight", initial, changed, output, &txn_ctx, true);
+      },
+      [](katana::PropertyGraph* pg, const std::string& output) {
+        return bool(LeidenClusteringAssertValid(pg, "weight", output));
+      });
+}
+
+void
+TestLouvainDeterministic() {
+  // the cliques with random edges between them, so that rounds move many
+  // nodes at once and communities change in more than one round
+  Edges noisy = RingOfCliques();
+  std::mt19937 gen(37);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  while (noisy.size() < RingOfCliques().size() + 3 * kNumNodes) {
+    uint32_t a = node(gen);
+    uint32_t b = node(gen);
+    if (a / kCliqueSize != b / kCliqueSize) {
+      noisy.emplace_back(a, b);
+    }
+  }
+
+  katana::TxnContext txn_ctx;
+  for (const auto& [edges, cliques] :
+       {std::make_pair(RingOfCliques(), true), std::make_pair(noisy, false)}) {
+    std::vector<uint64_t> first;
+    // and twice with the most threads
+    for (int threads : {1, 2, 4, 4}) {
+      katana::setActiveThreads(threads);
+      auto pg = MakeGraph(edges);
+      auto res = LouvainClustering(
+          pg.get(), "weight", "det", &txn_ctx, true,
+          LouvainClusteringPlan::Deterministic());
+      KATANA_LOG_VASSERT(res, "deterministic louvain: {}", res.error());
+      KATANA_LOG_ASSERT(
+          LouvainClusteringAssertValid(pg.get(), "weight", "det"));
+      std::vector<uint64_t> clusters = NodeValues<uint64_t>(pg.get(), "det");
+      if (first.empty()) {
+        first = clusters;
+      }
+      KATANA_LOG_VASSERT(
+          SamePartition(clusters, first),
+          "deterministic louvain differs with {} threads", threads);
+    }
+    KATANA_LOG_ASSERT(!cliques || SamePartition(first, CliqueClusters()));
+  }
+  katana::setActiveThreads(4);
+}
+
+/// The clusters VertexFollowing assigns to the nodes of the symmetric graph
+/// of edges, and the number of nodes it says can be removed
+std::pair<std::vector<uint64_t>, uint64_t>
+RunVertexFollowing(uint32_t num_nodes, const Edges& edges) {
+  auto pg = MakeGraph(edges, num_nodes);
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "current", [](uint64_t) { return uint64_t{0}; }));
+  KATANA_LOG_VASSERT(add_res, "adding clusters: {}", add_res.error());
+  auto graph_res = FollowingGraph::Make(pg.get(), {"current"}, {"weight"});
+  KATANA_LOG_VASSERT(graph_res, "view: {}", graph_res.error());
+  uint64_t removed = FollowingBase::VertexFollowing(&graph_res.value());
+  return {NodeValues<uint64_t>(pg.get(), "current"), removed};
+}
+
+/// Checks VertexFollowing against serial peeling of nodes with at most one
+/// neighbor left besides themselves, which leaves the 2-core: its nodes lead
+/// themselves, a tree of peeled nodes hanging off one of them follows it,
+/// and a tree on its own follows one of its nodes. Nodes without edges are
+/// unassigned.
+void
+CheckVertexFollowing(uint32_t num_nodes, const Edges& edges) {
+  auto [clusters, removed] = RunVertexFollowing(num_nodes, edges);
+
+  std::vector<std::set<uint32_t>> neighbors(num_nodes);
+  std::vector<bool> has_edges(num_nodes, false);
+  for (const auto& [a, b] : edges) {
+    has_edges[a] = has_edges[b] = true;
+    if (a != b) {
+      neighbors[a].emplace(b);
+      neighbors[b].emplace(a);
+    }
+  }
+  std::vector<size_t> degree(num_nodes);
+  std::vector<uint32_t> queue;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    degree[n] = neighbors[n].size();
+    if (degree[n] == 1) {
+      queue.emplace_back(n);
+    }
+  }
+  std::vector<bool> peeled(num_nodes, false);
+  while (!queue.empty()) {
+    uint32_t n = queue.back();
+    queue.pop_back();
+    if (peeled[n] || degree[n] > 1) {
+      continue;
+    }
+    peeled[n] = true;
+    for (uint32_t m : neighbors[n]) {
+      if (!peeled[m] && --degree[m] == 1) {
+        queue.emplace_back(m);
+      }
+    }
+  }
+
+  // the trees of peeled nodes, and the node each hangs off if any
+  std::vector<uint32_t> tree(num_nodes);
+  std::iota(tree.begin(), tree.end(), 0);
+  auto find = [&](uint32_t n) {
+    while (tree[n] != n) {
+      n = tree[n];
+    }
+    return n;
+  };
+  for (const auto& [a, b] : edges) {
+    if (peeled[a] && peeled[b]) {
+      tree[find(a)] = find(b);
+    }
+  }
+  std::unordered_map<uint32_t, uint64_t> leader;
+  for (const auto& [a, b] : edges) {
+    for (auto [n, m] : {std::make_pair(a, b), std::make_pair(b, a)}) {
+      if (peeled[n] && !peeled[m]) {
+        auto it = leader.emplace(find(n), m).first;
+        KATANA_LOG_ASSERT(it->second == m);
+      }
+    }
+  }
+
+  uint64_t expected_removed = 0;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    if (!has_edges[n]) {
+      KATANA_LOG_ASSERT(clusters[n] == FollowingBase::UNASSIGNED);
+      expected_removed += 1;
+      continue;
+    }
+    if (!peeled[n]) {
+      KATANA_LOG_VASSERT(
+          clusters[n] == n, "node {} follows {}", n, clusters[n]);
+      continue;
+    }
+    // a tree on its own follows the first of its nodes seen
+    auto it = leader.emplace(find(n), clusters[n]).first;
+    KATANA_LOG_VASSERT(
+        clusters[n] == it->second, "node {} follows {}, not {}", n,
+        clusters[n], it->second);
+    expected_removed += clusters[n] != n;
+  }
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    if (peeled[n] && clusters[n] == n) {
+      // the leader of a tree on its own is in it
+      KATANA_LOG_ASSERT(find(leader[find(n)]) == find(n));
+    }
+  }
+  KATANA_LOG_VASSERT(
+      removed == expected_removed, "{} nodes removed, expected {}", removed,
+      expected_removed);
+
+  // the same whatever the schedule
+  katana::setActiveThreads(1);
+  auto serial = RunVertexFollowing(num_nodes, edges);
+  katana::setActiveThreads(4);
+  KATANA_LOG_ASSERT(serial.first == clusters && serial.second == removed);
+}
+
+void
+TestVertexFollowing() {
+  // a triangle {0, 1, 2}; the chain 3 - 4 - 5 off 0; the star of 6 with 7
+  // and 8 off 1; the isolated node 9; the pair 10 - 11; the path
+  // 12 - 13 - 14; 15 with only a self loop; and 16 off 2, with a self loop
+  Edges edges = {{0, 1},   {1, 2},   {2, 0},   {0, 3},   {3, 4},
+                 {4, 5},   {1, 6},   {6, 7},   {6, 8},   {10, 11},
+                 {12, 13}, {13, 14}, {15, 15}, {16, 16}, {2, 16}};
+  constexpr uint64_t kNone = FollowingBase::UNASSIGNED;
+  auto [clusters, removed] = RunVertexFollowing(17, edges);
+  KATANA_LOG_ASSERT(
+      clusters == (std::vector<uint64_t>{0, 1, 2, 0, 0, 0, 1, 1, 1, kNone, 10,
+                                         10, 13, 13, 13, 15, 2}));
+  KATANA_LOG_VASSERT(removed == 11, "{} nodes removed", removed);
+  CheckVertexFollowing(17, edges);
+
+  // a core with cycles, trees and chains grown off it, and trees on their
+  // own
+  constexpr uint32_t kCore = 100;
+  constexpr uint32_t kNumFollowing = 600;
+  std::mt19937 gen(31);
+  // each edge once, so that degrees count neighbors
+  std::set<std::pair<uint32_t, uint32_t>> unique;
+  auto add = [&](uint32_t a, uint32_t b) {
+    unique.emplace(std::min(a, b), std::max(a, b));
+  };
+  for (uint32_t n = 0; n < kCore; ++n) {
+    add(n, (n + 1) % kCore);
+    add(n, gen() % kCore);
+  }
+  for (uint32_t n = kCore; n < 400; ++n) {
+    // mostly the last node, for long chains
+    add(gen() % 3 ? n - 1 : gen() % n, n);
+  }
+  for (uint32_t n = 401; n < kNumFollowing - 20; ++n) {
+    if (gen() % 8) {
+      add(400 + gen() % (n - 400), n);
+    }
+  }
+  CheckVertexFollowing(kNumFollowing, Edges(unique.begin(), unique.end()));
+}
+
+/// Checks that a clustering puts the chains hanging off a ring of cliques
+/// in the cluster of their clique: single nodes when moved one at a time,
+/// and chains of three when vertex following collapses them first. Once
+/// the graph is coarsened below min_graph_size, longer chains left as
+/// clusters of their own would stay so.
+template <typename Run>
+void
+CheckChains(const std::string& name, const Run& run) {
+  for (auto [enable_vf, chain] :
+       {std::make_pair(false, 1U), std::make_pair(true, 3U)}) {
+    Edges edges = RingOfCliques();
+    std::vector<uint64_t> expected = CliqueClusters();
+    uint32_t num_nodes = kNumNodes;
+    for (uint32_t c = 0; c < kNumCliques; ++c) {
+      uint32_t prev = c * kCliqueSize + 5;
+      for (uint32_t i = 0; i < chain; ++i) {
+        edges.emplace_back(prev, num_nodes);
+        expected.emplace_back(c);
+        prev = num_nodes++;
+      }
+    }
+    auto pg = MakeGraph(edges, num_nodes);
+
+    std::string output = name + (enable_vf ? "_vf" : "");
+    auto res = run(pg.get(), output, enable_vf);
+    KATANA_LOG_VASSERT(res, "{}: {}", output, res.error());
+    KATANA_LOG_VASSERT(
+        SamePartition(NodeValues<uint64_t>(pg.get(), output), expected),
+        "{} does not find the cliques and their chains", output);
+  }
+}
+
+void
+TestChains() {
+  katana::TxnContext txn_ctx;
+  CheckChains(
+      "louvain",
+      [&](katana::PropertyGraph* pg, const std::string& output, bool vf) {
+        return LouvainClustering(
+            pg, "weight", output, &txn_ctx, true,
+            LouvainClusteringPlan::DoAll(vf));
+      });
+  CheckChains(
+      "leiden",
+      [&](katana::PropertyGraph* pg, const std::string& output, bool vf) {
+        return LeidenClustering(
+            pg, "weight", output, &txn_ctx, true,
+            LeidenClusteringPlan::DoAll(vf));
+      });
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestLouvainWarmStart();
+  TestLeidenWarmStart();
+  TestLouvainDeterministic();
+  TestVertexFollowing();
+  TestChains();
+
+  return 0;
+}
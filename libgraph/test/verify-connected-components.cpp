@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+/// Component ids by serial union-find, each the least node of its component
+std::vector<uint64_t>
+SerialComponents(uint32_t num_nodes, const Edges& edges) {
+  std::vector<uint32_t> parent(num_nodes);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](uint32_t n) {
+    while (parent[n] != n) {
+      n = parent[n];
+    }
+    return n;
+  };
+  for (const auto& [a, b] : edges) {
+    uint32_t ra = find(a);
+    uint32_t rb = find(b);
+    // the smaller root wins, so roots are least nodes
+    if (ra < rb) {
+      parent[rb] = ra;
+    } else {
+      parent[ra] = rb;
+    }
+  }
+  std::vector<uint64_t> components(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    components[n] = find(n);
+  }
+  return components;
+}
+
+uint64_t
+NumComponents(const std::vector<uint64_t>& components) {
+  uint64_t num = 0;
+  for (size_t n = 0; n < components.size(); ++n) {
+    num += components[n] == n;
+  }
+  return num;
+}
+
+Edges
+RandomEdges(uint32_t num_nodes, uint32_t num_edges, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  Edges edges;
+  for (uint32_t e = 0; e < num_edges; ++e) {
+    edges.emplace_back(node(*gen), node(*gen));
+  }
+  return edges;
+}
+
+void
+TestIncremental() {
+  constexpr uint32_t kNumNodes = 500;
+  std::mt19937 gen(6);
+  Edges edges = RandomEdges(kNumNodes, 250, &gen);
+  auto pg = MakeTestGraph(kNumNodes, edges);
+
+  std::vector<uint32_t> all(kNumNodes);
+  std::iota(all.begin(), all.end(), 0);
+
+  // the first call joins the edges of the graph
+  katana::TxnContext txn_ctx;
+  auto res = ConnectedComponentsIncremental(pg.get(), "parent", {}, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "initial components: {}", res.error());
+  std::vector<uint64_t> expected = SerialComponents(kNumNodes, edges);
+  KATANA_LOG_ASSERT(res.value() == kNumNodes - NumComponents(expected));
+
+  for (int batch = 0; batch < 5; ++batch) {
+    uint64_t before = NumComponents(expected);
+    Edges inserted = RandomEdges(kNumNodes, 40, &gen);
+    // and the same edges again, which merge nothing
+    Edges repeated = inserted;
+    inserted.insert(inserted.end(), repeated.begin(), repeated.end());
+    edges.insert(edges.end(), inserted.begin(), inserted.end());
+    expected = SerialComponents(kNumNodes, edges);
+
+    auto batch_res =
+        ConnectedComponentsIncremental(pg.get(), "parent", inserted, &txn_ctx);
+    KATANA_LOG_VASSERT(batch_res, "batch {}: {}", batch, batch_res.error());
+    KATANA_LOG_ASSERT(batch_res.value() == before - NumComponents(expected));
+
+    auto find_res = ConnectedComponentsFind(pg.get(), "parent", all);
+    KATANA_LOG_VASSERT(find_res, "find: {}", find_res.error());
+    KATANA_LOG_ASSERT(find_res.value() == expected);
+  }
+
+  // the same components as a full run over every edge so far
+  auto full = MakeTestGraph(kNumNodes, edges, true);
+  auto cc_res = ConnectedComponents(full.get(), "component", &txn_ctx, true);
+  KATANA_LOG_VASSERT(cc_res, "connected components: {}", cc_res.error());
+  std::vector<uint64_t> labels =
+      NodeValues<uint64_t>(full.get(), "component");
+  std::unordered_map<uint64_t, uint64_t> label_to_id;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    auto it = label_to_id.emplace(labels[n], expected[n]).first;
+    KATANA_LOG_ASSERT(it->second == expected[n]);
+  }
+  KATANA_LOG_ASSERT(label_to_id.size() == NumComponents(expected));
+
+  KATANA_LOG_ASSERT(!ConnectedComponentsIncremental(
+      pg.get(), "parent", {{0, kNumNodes}}, &txn_ctx));
+  KATANA_LOG_ASSERT(!ConnectedComponentsFind(pg.get(), "parent", {kNumNodes}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestIncremental();
+
+  return 0;
+}
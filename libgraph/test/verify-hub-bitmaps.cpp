@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/jaccard/jaccard.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace {
+
+constexpr uint32_t kNumNodes = 640;
+constexpr uint32_t kNumHubs = 6;
+
+/// A symmetric graph without parallel edges or self loops: random edges of
+/// low degree nodes, and kNumHubs nodes with edges to about a third of
+/// all nodes, which are hubs at the threshold of kNumNodes / 32
+std::unique_ptr<katana::PropertyGraph>
+MakeHubGraph() {
+  std::set<std::pair<uint32_t, uint32_t>> edges;
+  auto add_edge = [&](uint32_t a, uint32_t b) {
+    if (a != b) {
+      edges.emplace(std::min(a, b), std::max(a, b));
+    }
+  };
+  for (uint32_t hub = 0; hub < kNumHubs; ++hub) {
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      if (katana::StatelessRandom(hub, n) % 3 == 0) {
+        add_edge(hub, n);
+      }
+    }
+  }
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint32_t i = 0; i < 3; ++i) {
+      add_edge(n, katana::StatelessRandom(kNumHubs + i, n) % kNumNodes);
+    }
+  }
+  std::vector<std::pair<uint32_t, uint32_t>> edge_list(
+      edges.begin(), edges.end());
+  return MakeTestGraph(kNumNodes, edge_list, true);
+}
+
+void
+CheckClose(
+    const std::vector<double>& a, const std::vector<double>& b,
+    const std::string& what) {
+  KATANA_LOG_ASSERT(a.size() == b.size());
+  for (size_t n = 0; n < a.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(a[n] - b[n]) < 1e-9,
+        "{} of node {} is {} with bitmaps and {} without", what, n, b[n],
+        a[n]);
+  }
+}
+
+/// The views build bitmaps of the hubs, so that the analytics below do take
+/// the bitmap paths
+void
+TestHubsFound(katana::PropertyGraph* pg) {
+  using View = katana::PropertyGraphViews::
+      NodesSortedByDegreeEdgesSortedByDestIDHubBitmaps;
+  View view = pg->BuildView<View>();
+  KATANA_LOG_ASSERT(view.hubs().hub_threshold() == kNumNodes / 32);
+  KATANA_LOG_ASSERT(view.hubs().num_hubs() >= kNumHubs);
+  KATANA_LOG_ASSERT(view.hubs().num_hubs() < kNumNodes / 4);
+  KATANA_LOG_ASSERT(!view.hubs().has_parallel_edges());
+}
+
+void
+TestTriangleCount(katana::PropertyGraph* pg) {
+  using Plan = katana::analytics::TriangleCountPlan;
+  for (auto make : {&Plan::NodeIteration, &Plan::EdgeIteration,
+                    &Plan::OrderedCount}) {
+    for (auto relabeling : {Plan::kRelabel, Plan::kNoRelabel}) {
+      auto plain_res = katana::analytics::TriangleCount(
+          pg, make(Plan::kDefaultEdgeSorted, relabeling, false));
+      KATANA_LOG_VASSERT(plain_res, "counting: {}", plain_res.error());
+      auto hub_res = katana::analytics::TriangleCount(
+          pg, make(Plan::kDefaultEdgeSorted, relabeling, true));
+      KATANA_LOG_VASSERT(hub_res, "counting with bitmaps: {}", hub_res.error());
+      KATANA_LOG_VASSERT(
+          hub_res.value() == plain_res.value(),
+          "{} triangles with bitmaps, {} without", hub_res.value(),
+          plain_res.value());
+      KATANA_LOG_ASSERT(plain_res.value() > 0);
+    }
+  }
+}
+
+void
+TestLocalClusteringCoefficient(katana::PropertyGraph* pg) {
+  using Plan = katana::analytics::LocalClusteringCoefficientPlan;
+  std::vector<std::pair<Plan, Plan>> plans{
+      {Plan::OrderedCountAtomics(
+           Plan::kDefaultEdgesSorted, Plan::kAutoRelabel, false),
+       Plan::OrderedCountAtomics(
+           Plan::kDefaultEdgesSorted, Plan::kAutoRelabel, true)},
+      {Plan::OrderedCountPerThread(
+           Plan::kDefaultEdgesSorted, Plan::kRelabel, false),
+       Plan::OrderedCountPerThread(
+           Plan::kDefaultEdgesSorted, Plan::kRelabel, true)},
+      {Plan::DegreeOrdered(
+           Plan::kNoSampling, Plan::kDefaultMaxError, false),
+       Plan::DegreeOrdered(Plan::kNoSampling, Plan::kDefaultMaxError, true)},
+  };
+  katana::TxnContext txn_ctx;
+  for (size_t i = 0; i < plans.size(); ++i) {
+    std::string plain = "lcc-" + std::to_string(i);
+    std::string hub = "lcc-hub-" + std::to_string(i);
+    auto plain_res = katana::analytics::LocalClusteringCoefficient(
+        pg, plain, &txn_ctx, plans[i].first);
+    KATANA_LOG_VASSERT(plain_res, "coefficients: {}", plain_res.error());
+    auto hub_res = katana::analytics::LocalClusteringCoefficient(
+        pg, hub, &txn_ctx, plans[i].second);
+    KATANA_LOG_VASSERT(
+        hub_res, "coefficients with bitmaps: {}", hub_res.error());
+    CheckClose(
+        NodeValues<double>(pg, plain), NodeValues<double>(pg, hub),
+        "coefficient");
+  }
+}
+
+void
+TestJaccard(katana::PropertyGraph* pg) {
+  using Plan = katana::analytics::JaccardPlan;
+  katana::TxnContext txn_ctx;
+  // a hub and a node that is not
+  for (uint32_t compare_node : {uint32_t{0}, kNumNodes - 1}) {
+    std::string plain = "jaccard-" + std::to_string(compare_node);
+    std::string hub = "jaccard-hub-" + std::to_string(compare_node);
+    auto plain_res = katana::analytics::Jaccard(
+        pg, compare_node, plain, &txn_ctx, Plan::Unsorted());
+    KATANA_LOG_VASSERT(plain_res, "similarities: {}", plain_res.error());
+    auto hub_res = katana::analytics::Jaccard(
+        pg, compare_node, hub, &txn_ctx, Plan::HubBitmaps());
+    KATANA_LOG_VASSERT(
+        hub_res, "similarities with bitmaps: {}", hub_res.error());
+    CheckClose(
+        NodeValues<double>(pg, plain), NodeValues<double>(pg, hub),
+        "similarity");
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  // Only the kNumNodes / 32 floor of the threshold applies
+  katana::SetEnv("KATANA_MIN_HUB_DEGREE", "1", true);
+  katana::SharedMemSys sys;
+
+  auto pg = MakeHubGraph();
+  TestHubsFound(pg.get());
+  TestTriangleCount(pg.get());
+  TestLocalClusteringCoefficient(pg.get());
+  TestJaccard(pg.get());
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <random>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/partition/hypergraph_partition.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// num_clusters clusters of cluster_size nodes with num_hedges random
+/// hyperedges of 3 nodes each within each cluster and one hyperedge
+/// joining every cluster to the next
+Hypergraph
+MakeClusters(
+    uint32_t num_clusters, uint32_t cluster_size, uint32_t num_hedges) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<uint32_t> dist(0, cluster_size - 1);
+  Hypergraph hypergraph;
+  hypergraph.num_nodes = num_clusters * cluster_size;
+  for (uint32_t c = 0; c < num_clusters; ++c) {
+    uint32_t first = c * cluster_size;
+    // a path through the cluster keeps it connected
+    for (uint32_t n = first; n + 1 < first + cluster_size; ++n) {
+      hypergraph.AddHedge({n, n + 1});
+    }
+    for (uint32_t h = 0; h < num_hedges; ++h) {
+      hypergraph.AddHedge(
+          {first + dist(gen), first + dist(gen), first + dist(gen)});
+    }
+    if (c + 1 < num_clusters) {
+      hypergraph.AddHedge({first, first + cluster_size});
+    }
+  }
+  return hypergraph;
+}
+
+void
+TestClusters(HypergraphPartitionPlan::Objective objective) {
+  uint32_t num_clusters = 4;
+  Hypergraph hypergraph = MakeClusters(num_clusters, 250, 2000);
+  auto plan = HypergraphPartitionPlan::MultilevelKWay(objective);
+
+  std::vector<uint32_t> partitions;
+  auto res = PartitionHypergraph(hypergraph, num_clusters, &partitions, plan);
+  KATANA_LOG_VASSERT(res, "partitioning: {}", res.error());
+
+  auto stats_res = HypergraphPartitionStatistics::Compute(
+      hypergraph, num_clusters, partitions);
+  KATANA_LOG_VASSERT(stats_res, "statistics: {}", stats_res.error());
+  HypergraphPartitionStatistics stats = stats_res.value();
+  KATANA_LOG_VASSERT(
+      stats.cut == num_clusters - 1, "cut {}, expected {}", stats.cut,
+      num_clusters - 1);
+  KATANA_LOG_VASSERT(
+      stats.connectivity == num_clusters - 1, "connectivity {}",
+      stats.connectivity);
+  KATANA_LOG_VASSERT(
+      stats.imbalance <= plan.imbalance(), "imbalance {}", stats.imbalance);
+}
+
+void
+TestWeights() {
+  // the heavy nodes must be apart, and nodes 1 and 2 with node 5
+  Hypergraph hypergraph;
+  hypergraph.num_nodes = 6;
+  hypergraph.node_weights = {4, 1, 1, 1, 1, 4};
+  hypergraph.AddHedge({0, 1, 2, 3, 4});
+  hypergraph.AddHedge({1, 5});
+  hypergraph.AddHedge({2, 5});
+  hypergraph.hedge_weights = {1, 3, 3};
+
+  std::vector<uint32_t> partitions;
+  auto plan = HypergraphPartitionPlan::MultilevelKWay(
+      HypergraphPartitionPlan::kConnectivity, 0);
+  auto res = PartitionHypergraph(hypergraph, 2, &partitions, plan);
+  KATANA_LOG_VASSERT(res, "partitioning: {}", res.error());
+  KATANA_LOG_ASSERT(partitions[0] != partitions[5]);
+  KATANA_LOG_ASSERT(partitions[1] == partitions[5]);
+  KATANA_LOG_ASSERT(partitions[2] == partitions[5]);
+
+  auto stats =
+      HypergraphPartitionStatistics::Compute(hypergraph, 2, partitions);
+  KATANA_LOG_ASSERT(stats);
+  KATANA_LOG_ASSERT(stats.value().largest_partition_weight == 6);
+  KATANA_LOG_VASSERT(
+      stats.value().connectivity == 1, "connectivity {}",
+      stats.value().connectivity);
+}
+
+void
+TestInvalid() {
+  std::vector<uint32_t> partitions;
+  Hypergraph hypergraph;
+  hypergraph.num_nodes = 2;
+  hypergraph.AddHedge({0, 2});
+  KATANA_LOG_ASSERT(!PartitionHypergraph(hypergraph, 2, &partitions));
+
+  hypergraph.pins.back() = 1;
+  KATANA_LOG_ASSERT(!PartitionHypergraph(hypergraph, 0, &partitions));
+  hypergraph.hedge_weights = {1, 1};
+  KATANA_LOG_ASSERT(!PartitionHypergraph(hypergraph, 2, &partitions));
+
+  hypergraph.hedge_weights.clear();
+  KATANA_LOG_ASSERT(PartitionHypergraph(hypergraph, 1, &partitions));
+  KATANA_LOG_ASSERT((partitions == std::vector<uint32_t>{0, 0}));
+  KATANA_LOG_ASSERT(!HypergraphPartitionStatistics::Compute(
+      hypergraph, 1, std::vector<uint32_t>{0, 1}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestClusters(HypergraphPartitionPlan::kConnectivity);
+  TestClusters(HypergraphPartitionPlan::kCut);
+  TestWeights();
+  TestInvalid();
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_core/k_core.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+/// Core numbers by serial peeling of a node of least degree at a time
+std::vector<uint32_t>
+SerialCores(uint32_t num_nodes, const Edges& edges) {
+  std::vector<std::vector<uint32_t>> neighbors(num_nodes);
+  for (const auto& [a, b] : edges) {
+    neighbors[a].emplace_back(b);
+    neighbors[b].emplace_back(a);
+  }
+  std::vector<uint32_t> degree(num_nodes);
+  std::set<std::pair<uint32_t, uint32_t>> by_degree;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    degree[n] = neighbors[n].size();
+    by_degree.emplace(degree[n], n);
+  }
+  std::vector<uint32_t> core(num_nodes);
+  std::vector<bool> peeled(num_nodes, false);
+  uint32_t k = 0;
+  while (!by_degree.empty()) {
+    auto [d, v] = *by_degree.begin();
+    by_degree.erase(by_degree.begin());
+    k = std::max(k, d);
+    core[v] = k;
+    peeled[v] = true;
+    for (uint32_t u : neighbors[v]) {
+      if (!peeled[u]) {
+        by_degree.erase({degree[u], u});
+        by_degree.emplace(--degree[u], u);
+      }
+    }
+  }
+  return core;
+}
+
+/// Each undirected edge once, without self loops or parallel edges
+Edges
+RandomEdges(uint32_t num_nodes, uint32_t num_edges, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  std::set<std::pair<uint32_t, uint32_t>> edges;
+  while (edges.size() < num_edges) {
+    uint32_t a = node(gen);
+    uint32_t b = node(gen);
+    if (a != b) {
+      edges.emplace(std::min(a, b), std::max(a, b));
+    }
+  }
+  return Edges(edges.begin(), edges.end());
+}
+
+void
+CheckCores(uint32_t num_nodes, const Edges& edges) {
+  std::vector<uint32_t> expected = SerialCores(num_nodes, edges);
+
+  // stored both ways, and once for the undirected view
+  for (bool symmetric : {true, false}) {
+    auto pg = MakeTestGraph(num_nodes, edges, symmetric);
+    katana::TxnContext txn_ctx;
+    auto res = CoreDecomposition(pg.get(), "core", &txn_ctx, symmetric);
+    KATANA_LOG_VASSERT(res, "core decomposition: {}", res.error());
+    auto valid_res = CoreDecompositionAssertValid(pg.get(), "core", symmetric);
+    KATANA_LOG_VASSERT(valid_res, "invalid cores: {}", valid_res.error());
+
+    std::vector<uint32_t> cores = NodeValues<uint32_t>(pg.get(), "core");
+    KATANA_LOG_ASSERT(cores == expected);
+
+    auto stats_res = CoreDecompositionStatistics::Compute(pg.get(), "core");
+    KATANA_LOG_VASSERT(stats_res, "statistics: {}", stats_res.error());
+    uint32_t max_core = *std::max_element(expected.begin(), expected.end());
+    KATANA_LOG_ASSERT(stats_res.value().max_core_number == max_core);
+    KATANA_LOG_ASSERT(
+        stats_res.value().number_of_nodes_in_max_core ==
+        static_cast<uint64_t>(
+            std::count(expected.begin(), expected.end(), max_core)));
+
+    // the k-core is the nodes of core number at least k
+    for (uint32_t k :
+         std::set<uint32_t>{1, std::max(1U, max_core / 2), max_core + 1}) {
+      std::string name = "kcore_" + std::to_string(k);
+      auto kcore_res = KCore(pg.get(), k, name, &txn_ctx, symmetric);
+      KATANA_LOG_VASSERT(kcore_res, "k-core: {}", kcore_res.error());
+      std::vector<uint32_t> alive = NodeValues<uint32_t>(pg.get(), name);
+      for (uint32_t n = 0; n < num_nodes; ++n) {
+        KATANA_LOG_ASSERT((alive[n] != 0) == (expected[n] >= k));
+      }
+    }
+  }
+}
+
+void
+TestSmall() {
+  // a 4-clique {0, 1, 2, 3}, a triangle {3, 4, 5} sharing node 3, the path
+  // 5 - 6 - 7 and the isolated node 8
+  Edges edges = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3},
+                 {3, 4}, {3, 5}, {4, 5}, {5, 6}, {6, 7}};
+  KATANA_LOG_ASSERT(
+      SerialCores(9, edges) ==
+      (std::vector<uint32_t>{3, 3, 3, 3, 2, 2, 1, 1, 0}));
+  CheckCores(9, edges);
+}
+
+void
+TestRandom() {
+  CheckCores(500, RandomEdges(500, 3000, 3));
+}
+
+void
+TestDeepCores() {
+  // a clique of 150 nodes has core number 149, past one window of bucket
+  // degrees, with a sparse fringe of lower cores around it
+  constexpr uint32_t kClique = 150;
+  Edges edges = RandomEdges(kClique + 300, 600, 5);
+  std::set<std::pair<uint32_t, uint32_t>> unique(edges.begin(), edges.end());
+  for (uint32_t a = 0; a < kClique; ++a) {
+    for (uint32_t b = a + 1; b < kClique; ++b) {
+      unique.emplace(a, b);
+    }
+  }
+  CheckCores(kClique + 300, Edges(unique.begin(), unique.end()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSmall();
+  TestRandom();
+  TestDeepCores();
+
+  return 0;
+}
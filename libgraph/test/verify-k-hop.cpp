@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/k_hop/k_hop.h"
+
+using namespace katana::analytics;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+namespace {
+
+constexpr uint32_t kNumNodes = 3000;
+constexpr uint64_t kNumEdges = 4 * kNumNodes;
+
+struct TestEdge {
+  uint32_t src;
+  uint32_t dst;
+  bool is_a;
+};
+
+std::vector<TestEdge>
+MakeEdges() {
+  std::vector<TestEdge> edges;
+  for (uint64_t e = 0; e < kNumEdges; ++e) {
+    edges.emplace_back(TestEdge{
+        static_cast<uint32_t>(katana::StatelessRandom(5, 3 * e) % kNumNodes),
+        static_cast<uint32_t>(
+            katana::StatelessRandom(5, 3 * e + 1) % kNumNodes),
+        katana::StatelessRandom(5, 3 * e + 2) % 3 != 0});
+  }
+  return edges;
+}
+
+bool
+IsX(uint32_t n) {
+  return n % 4 != 0;
+}
+
+/// A graph of edges whose nodes have type "X" if IsX and whose edges have
+/// type "A" or "B"
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const std::vector<TestEdge>& edges) {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  for (const TestEdge& edge : edges) {
+    builder.AddEdge(edge.src, edge.dst);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  // the builder keeps the edges of every node in the order they were added
+  std::vector<uint8_t> edge_is_a;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    for (const TestEdge& edge : edges) {
+      if (edge.src == n) {
+        edge_is_a.emplace_back(edge.is_a);
+      }
+    }
+  }
+  katana::TxnContext txn_ctx;
+  auto node_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("X", [](Node n) {
+        return static_cast<uint8_t>(IsX(n));
+      }));
+  KATANA_LOG_VASSERT(node_res, "adding node types: {}", node_res.error());
+  auto edge_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "A", [&](Edge e) { return static_cast<uint8_t>(edge_is_a[e]); }),
+      katana::PropertyGenerator(
+          "B", [&](Edge e) { return static_cast<uint8_t>(!edge_is_a[e]); }));
+  KATANA_LOG_VASSERT(edge_res, "adding edge types: {}", edge_res.error());
+  auto types_res = pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+  return pg;
+}
+
+/// The nodes of every hop, sorted, by a breadth first search of the edges
+/// that pass the filters
+template <typename KeepEdge, typename KeepNode>
+std::vector<std::vector<uint32_t>>
+ReferenceHops(
+    const std::vector<TestEdge>& edges, uint32_t start, uint32_t hops,
+    bool out, bool in, KeepEdge keep_edge, KeepNode keep_node) {
+  std::vector<std::vector<uint32_t>> neighbors(kNumNodes);
+  for (const TestEdge& edge : edges) {
+    if (!keep_edge(edge)) {
+      continue;
+    }
+    if (out) {
+      neighbors[edge.src].emplace_back(edge.dst);
+    }
+    if (in) {
+      neighbors[edge.dst].emplace_back(edge.src);
+    }
+  }
+  std::vector<bool> visited(kNumNodes);
+  visited[start] = true;
+  std::vector<std::vector<uint32_t>> result;
+  std::vector<uint32_t> frontier{start};
+  for (uint32_t hop = 0; hop < hops; ++hop) {
+    std::vector<uint32_t> next;
+    for (uint32_t n : frontier) {
+      for (uint32_t dst : neighbors[n]) {
+        if (!visited[dst] && keep_node(dst)) {
+          visited[dst] = true;
+          next.emplace_back(dst);
+        }
+      }
+    }
+    frontier = next;
+    std::sort(next.begin(), next.end());
+    result.emplace_back(std::move(next));
+  }
+  return result;
+}
+
+std::vector<std::vector<uint32_t>>
+QueryHops(const KHopQuery& query, uint32_t start, uint32_t hops) {
+  auto res = query.Neighbors(start, hops);
+  KATANA_LOG_VASSERT(res, "querying: {}", res.error());
+  const KHopNeighborhood& neighborhood = res.value();
+  KATANA_LOG_ASSERT(neighborhood.hop_offsets.size() == hops + 1);
+  KATANA_LOG_ASSERT(
+      neighborhood.hop_offsets.back() == neighborhood.nodes.size());
+  std::vector<std::vector<uint32_t>> result;
+  for (uint32_t hop = 0; hop < hops; ++hop) {
+    std::vector<uint32_t> nodes(
+        neighborhood.nodes.begin() + neighborhood.hop_offsets[hop],
+        neighborhood.nodes.begin() + neighborhood.hop_offsets[hop + 1]);
+    std::sort(nodes.begin(), nodes.end());
+    result.emplace_back(std::move(nodes));
+  }
+  return result;
+}
+
+template <typename KeepEdge, typename KeepNode>
+void
+CheckQueries(
+    katana::PropertyGraph* pg, const std::vector<TestEdge>& edges,
+    KHopOptions options, KeepEdge keep_edge, KeepNode keep_node) {
+  auto query_res = KHopQuery::Make(pg, options);
+  KATANA_LOG_VASSERT(query_res, "making the query: {}", query_res.error());
+  const KHopQuery& query = *query_res.value();
+  // few hops stay in the hash set, many move to the bitset
+  for (uint32_t hops : {0, 1, 2, 3, 12}) {
+    for (uint32_t start : {0U, 7U, 1234U}) {
+      auto expected = ReferenceHops(
+          edges, start, hops, options.out_edges, options.in_edges, keep_edge,
+          keep_node);
+      KATANA_LOG_VASSERT(
+          QueryHops(query, start, hops) == expected,
+          "{} hops from node {} differ", hops, start);
+    }
+  }
+}
+
+void
+TestQueries() {
+  auto edges = MakeEdges();
+  auto pg = MakeGraph(edges);
+  auto all_edges = [](const TestEdge&) { return true; };
+  auto all_nodes = [](uint32_t) { return true; };
+
+  CheckQueries(pg.get(), edges, KHopOptions{}, all_edges, all_nodes);
+  CheckQueries(
+      pg.get(), edges, KHopOptions{{}, {}, true, true}, all_edges, all_nodes);
+  CheckQueries(
+      pg.get(), edges, KHopOptions{{}, {}, false, true}, all_edges, all_nodes);
+  CheckQueries(
+      pg.get(), edges, KHopOptions{{"A"}, {}, true, false},
+      [](const TestEdge& edge) { return edge.is_a; }, all_nodes);
+  CheckQueries(
+      pg.get(), edges, KHopOptions{{"B"}, {"X"}, true, true},
+      [](const TestEdge& edge) { return !edge.is_a; }, IsX);
+
+  KATANA_LOG_ASSERT(!KHopQuery::Make(pg.get(), KHopOptions{{"C"}}));
+  KATANA_LOG_ASSERT(!KHopQuery::Make(pg.get(), KHopOptions{{}, {}, false}));
+  auto query = KHopQuery::Make(pg.get());
+  KATANA_LOG_ASSERT(query && !query.value()->Neighbors(kNumNodes, 1));
+}
+
+void
+TestConcurrentQueries() {
+  auto edges = MakeEdges();
+  auto pg = MakeGraph(edges);
+  auto query_res = KHopQuery::Make(pg.get(), KHopOptions{{}, {}, true, true});
+  KATANA_LOG_ASSERT(query_res);
+  const KHopQuery& query = *query_res.value();
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (uint32_t i = 0; i < 50; ++i) {
+        uint32_t start = (t * 50 + i) * 13 % kNumNodes;
+        uint32_t hops = 1 + i % 4;
+        auto expected = ReferenceHops(
+            edges, start, hops, true, true,
+            [](const TestEdge&) { return true; },
+            [](uint32_t) { return true; });
+        KATANA_LOG_ASSERT(QueryHops(query, start, hops) == expected);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestQueries();
+  TestConcurrentQueries();
+
+  return 0;
+}
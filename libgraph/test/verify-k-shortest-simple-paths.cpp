@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_shortest_paths/ksssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using WeightedEdge = std::tuple<uint32_t, uint32_t, int32_t>;
+
+/// The least weight of an edge from src to dst, over parallel edges
+using EdgeWeights = std::map<std::pair<uint32_t, uint32_t>, int32_t>;
+
+EdgeWeights
+LeastWeights(const std::vector<WeightedEdge>& edges) {
+  EdgeWeights least;
+  for (const auto& [src, dst, weight] : edges) {
+    auto [it, inserted] = least.emplace(std::make_pair(src, dst), weight);
+    if (!inserted) {
+      it->second = std::min(it->second, weight);
+    }
+  }
+  return least;
+}
+
+/// The weights of all simple paths from s to t, by depth first search
+void
+EnumeratePaths(
+    const EdgeWeights& least, uint32_t num_nodes, uint32_t v, uint32_t t,
+    int64_t weight, std::vector<bool>* on_path,
+    std::vector<int64_t>* weights) {
+  if (v == t) {
+    weights->emplace_back(weight);
+    return;
+  }
+  (*on_path)[v] = true;
+  for (uint32_t u = 0; u < num_nodes; ++u) {
+    auto it = least.find({v, u});
+    if (it != least.end() && !(*on_path)[u]) {
+      EnumeratePaths(
+          least, num_nodes, u, t, weight + it->second, on_path, weights);
+    }
+  }
+  (*on_path)[v] = false;
+}
+
+/// Checks paths is a k shortest simple paths answer for (s, t)
+void
+CheckPaths(
+    const std::vector<WeightedEdge>& edges, uint32_t num_nodes, uint32_t s,
+    uint32_t t, uint32_t k, const std::vector<SimplePath>& paths) {
+  EdgeWeights least = LeastWeights(edges);
+
+  std::vector<int64_t> expected;
+  std::vector<bool> on_path(num_nodes, false);
+  EnumeratePaths(least, num_nodes, s, t, 0, &on_path, &expected);
+  std::sort(expected.begin(), expected.end());
+  expected.resize(std::min<size_t>(expected.size(), k));
+
+  KATANA_LOG_VASSERT(
+      paths.size() == expected.size(), "({}, {}): {} paths, expected {}", s,
+      t, paths.size(), expected.size());
+
+  std::set<std::vector<uint32_t>> seen;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    const SimplePath& path = paths[i];
+    KATANA_LOG_ASSERT(path.nodes.front() == s);
+    KATANA_LOG_ASSERT(path.nodes.back() == t);
+    KATANA_LOG_ASSERT(seen.emplace(path.nodes).second);
+
+    std::set<uint32_t> nodes(path.nodes.begin(), path.nodes.end());
+    KATANA_LOG_ASSERT(nodes.size() == path.nodes.size());
+
+    int64_t weight = 0;
+    for (size_t j = 0; j + 1 < path.nodes.size(); ++j) {
+      auto it = least.find({path.nodes[j], path.nodes[j + 1]});
+      KATANA_LOG_ASSERT(it != least.end());
+      weight += it->second;
+    }
+    KATANA_LOG_VASSERT(
+        path.weight == weight && weight == expected[i],
+        "({}, {}) path {}: weight {}, sum {}, expected {}", s, t, i,
+        path.weight, weight, expected[i]);
+  }
+}
+
+void
+TestRandomGraphs() {
+  std::mt19937 gen(4);
+  constexpr uint32_t kNumNodes = 7;
+  constexpr uint32_t kK = 12;
+  for (int round = 0; round < 20; ++round) {
+    std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+    // zero weights, parallel edges and self loops included
+    std::uniform_int_distribution<int32_t> weight(0, 4);
+    std::vector<WeightedEdge> edges;
+    for (int e = 0; e < 18; ++e) {
+      edges.emplace_back(node(gen), node(gen), weight(gen));
+    }
+
+    auto pg = MakeWeightedTestGraph(kNumNodes, edges);
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    for (uint32_t s = 0; s < kNumNodes; ++s) {
+      for (uint32_t t = 0; t < kNumNodes; ++t) {
+        if (s != t) {
+          queries.emplace_back(s, t);
+        }
+      }
+    }
+
+    auto res = KShortestSimplePaths(pg.get(), queries, kK, "weight");
+    KATANA_LOG_VASSERT(res, "k shortest simple paths: {}", res.error());
+    auto unit_res = KShortestSimplePaths(pg.get(), queries, kK);
+    KATANA_LOG_VASSERT(unit_res, "unit weights: {}", unit_res.error());
+
+    std::vector<WeightedEdge> unit_edges;
+    for (const auto& [src, dst, w] : edges) {
+      unit_edges.emplace_back(src, dst, 1);
+    }
+    for (size_t q = 0; q < queries.size(); ++q) {
+      auto [s, t] = queries[q];
+      CheckPaths(edges, kNumNodes, s, t, kK, res.value()[q]);
+      CheckPaths(unit_edges, kNumNodes, s, t, kK, unit_res.value()[q]);
+    }
+  }
+}
+
+void
+TestNegativeWeights() {
+  auto pg = MakeWeightedTestGraph<int32_t>(
+      3, {{0, 1, 2}, {1, 2, -1}, {0, 2, 3}});
+  KATANA_LOG_ASSERT(!KShortestSimplePaths(pg.get(), {{0, 2}}, 2, "weight"));
+
+  auto nan = MakeWeightedTestGraph<double>(
+      2, {{0, 1, std::numeric_limits<double>::quiet_NaN()}});
+  KATANA_LOG_ASSERT(!KShortestSimplePaths(nan.get(), {{0, 1}}, 1, "weight"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestRandomGraphs();
+  TestNegativeWeights();
+
+  return 0;
+}
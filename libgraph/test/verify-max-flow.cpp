@@ -0,0 +1,166 @@
+#include <tuple>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/max_flow/max_flow.h"
+
+using namespace katana::analytics;
+using Edge = katana::GraphTopology::Edge;
+
+namespace {
+
+/// A graph of num_nodes nodes with the edges (source, destination, capacity)
+/// and their capacities in the edge property "capacity"
+template <typename T>
+std::unique_ptr<katana::PropertyGraph>
+MakeNetwork(
+    size_t num_nodes,
+    const std::vector<std::tuple<uint32_t, uint32_t, T>>& edges) {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(num_nodes);
+  for (const auto& [src, dst, capacity] : edges) {
+    builder.AddEdge(src, dst);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  // the builder may reorder the edges
+  std::vector<T> capacities(pg->NumEdges());
+  std::vector<bool> assigned(pg->NumEdges());
+  const katana::GraphTopology& topology = pg->topology();
+  for (const auto& [src, dst, capacity] : edges) {
+    for (auto e : topology.OutEdges(src)) {
+      if (topology.OutEdgeDst(e) == dst && !assigned[e]) {
+        capacities[e] = capacity;
+        assigned[e] = true;
+        break;
+      }
+    }
+  }
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "capacity", [&](Edge e) { return capacities[e]; }));
+  KATANA_LOG_VASSERT(res, "adding capacities: {}", res.error());
+  return pg;
+}
+
+void
+RunMaxFlow(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    uint64_t expected_flow) {
+  std::vector<MaxFlowPlan> plans{
+      MaxFlowPlan::SynchronousPushRelabel(),
+      MaxFlowPlan::SynchronousPushRelabel(0.01),
+      MaxFlowPlan::SynchronousPushRelabel(100)};
+  for (size_t i = 0; i < plans.size(); ++i) {
+    std::string name = fmt::format("side-{}-{}-{}", source, sink, i);
+    katana::TxnContext txn_ctx;
+    auto flow_res =
+        MaxFlow(pg, source, sink, "capacity", name, &txn_ctx, plans[i]);
+    KATANA_LOG_VASSERT(flow_res, "max flow: {}", flow_res.error());
+    KATANA_LOG_VASSERT(
+        flow_res.value() == expected_flow, "flow {}, expected {}",
+        flow_res.value(), expected_flow);
+
+    auto valid_res =
+        MaxFlowAssertValid(pg, source, sink, "capacity", name, expected_flow);
+    KATANA_LOG_VASSERT(valid_res, "invalid cut: {}", valid_res.error());
+  }
+}
+
+void
+TestTextbook() {
+  // the network of figure 26.1 of Cormen et al.
+  auto pg = MakeNetwork<uint32_t>(
+      6, {{0, 1, 16},
+          {0, 2, 13},
+          {1, 3, 12},
+          {2, 1, 4},
+          {2, 4, 14},
+          {3, 2, 9},
+          {3, 5, 20},
+          {4, 3, 7},
+          {4, 5, 4}});
+  RunMaxFlow(pg.get(), 0, 5, 23);
+  RunMaxFlow(pg.get(), 5, 0, 0);
+
+  auto stats_res =
+      MaxFlowStatistics::Compute(pg.get(), "capacity", "side-5-0-0");
+  KATANA_LOG_VASSERT(stats_res, "statistics: {}", stats_res.error());
+  KATANA_LOG_ASSERT(stats_res.value().cut_capacity == 0);
+  KATANA_LOG_ASSERT(stats_res.value().cut_edges == 0);
+}
+
+void
+TestParallelEdges() {
+  // parallel edges, antiparallel edges and a self loop
+  auto pg = MakeNetwork<int64_t>(
+      4, {{0, 1, 3},
+          {0, 1, 2},
+          {1, 0, 7},
+          {1, 1, 9},
+          {1, 2, 4},
+          {2, 1, 4},
+          {2, 3, 10},
+          {0, 2, 1}});
+  RunMaxFlow(pg.get(), 0, 3, 5);
+}
+
+void
+TestSynthetic() {
+  auto grid = katana::MakeGrid(20, 20, false);
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      grid.get(), &txn_ctx,
+      katana::PropertyGenerator("capacity", [](Edge e) {
+        return static_cast<uint32_t>(katana::StatelessRandom(1, e) % 100);
+      }));
+  KATANA_LOG_VASSERT(res, "adding capacities: {}", res.error());
+  for (size_t i = 0; i < 3; ++i) {
+    std::string name = "side-" + std::to_string(i);
+    auto flow_res = MaxFlow(
+        grid.get(), 0, grid->NumNodes() - 1, "capacity", name, &txn_ctx,
+        MaxFlowPlan::SynchronousPushRelabel(0.5 * i));
+    KATANA_LOG_VASSERT(flow_res, "max flow: {}", flow_res.error());
+    auto valid_res = MaxFlowAssertValid(
+        grid.get(), 0, grid->NumNodes() - 1, "capacity", name,
+        flow_res.value());
+    KATANA_LOG_VASSERT(valid_res, "invalid cut: {}", valid_res.error());
+  }
+}
+
+void
+TestInvalid() {
+  katana::TxnContext txn_ctx;
+  auto pg = MakeNetwork<int32_t>(3, {{0, 1, 5}, {1, 2, -1}});
+  KATANA_LOG_ASSERT(!MaxFlow(pg.get(), 0, 2, "capacity", "side", &txn_ctx));
+  KATANA_LOG_ASSERT(!MaxFlow(pg.get(), 0, 0, "capacity", "side", &txn_ctx));
+  KATANA_LOG_ASSERT(!MaxFlow(pg.get(), 0, 3, "capacity", "side", &txn_ctx));
+
+  auto doubles = MakeNetwork<double>(2, {{0, 1, 1.5}});
+  KATANA_LOG_ASSERT(
+      !MaxFlow(doubles.get(), 0, 1, "capacity", "side", &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestTextbook();
+  TestParallelEdges();
+  TestSynthetic();
+  TestInvalid();
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// The graph of figure 23.1 of Cormen et al., with nodes a to i numbered 0
+/// to 8; its minimum spanning trees weigh 37
+template <typename T>
+std::vector<std::tuple<uint32_t, uint32_t, T>>
+TextbookEdges() {
+  return {{0, 1, 4},  {0, 7, 8},  {1, 2, 8}, {1, 7, 11}, {2, 3, 7},
+          {2, 5, 4},  {2, 8, 2},  {3, 4, 9}, {3, 5, 14}, {4, 5, 10},
+          {5, 6, 2},  {6, 7, 1},  {6, 8, 6}, {7, 8, 7}};
+}
+
+MinimumSpanningForestStatistics
+RunForest(katana::PropertyGraph* pg, const std::string& name) {
+  katana::TxnContext txn_ctx;
+  auto res = MinimumSpanningForest(pg, "weight", name, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "forest: {}", res.error());
+  auto valid_res = MinimumSpanningForestAssertValid(pg, "weight", name);
+  KATANA_LOG_VASSERT(valid_res, "invalid forest: {}", valid_res.error());
+  auto stats_res = MinimumSpanningForestStatistics::Compute(pg, "weight", name);
+  KATANA_LOG_VASSERT(stats_res, "statistics: {}", stats_res.error());
+  return stats_res.value();
+}
+
+void
+TestTextbook() {
+  // directed one way and symmetric
+  for (bool symmetric : {false, true}) {
+    auto pg = MakeWeightedTestGraph(9, TextbookEdges<uint32_t>(), symmetric);
+    auto stats = RunForest(pg.get(), "forest");
+    KATANA_LOG_ASSERT(stats.total_weight == 37);
+    KATANA_LOG_ASSERT(stats.number_of_edges == 8);
+    KATANA_LOG_ASSERT(stats.number_of_trees == 1);
+  }
+
+  auto doubles = MakeWeightedTestGraph(9, TextbookEdges<double>());
+  auto stats = RunForest(doubles.get(), "forest");
+  KATANA_LOG_ASSERT(stats.total_weight == 37);
+}
+
+void
+TestForest() {
+  // two triangles, a self loop, parallel edges and an isolated node
+  auto pg = MakeWeightedTestGraph<int64_t>(
+      8, {{0, 1, -5},
+          {1, 2, 3},
+          {2, 0, 1},
+          {3, 3, -100},
+          {3, 4, 7},
+          {4, 3, 2},
+          {4, 5, 4},
+          {5, 3, 9}});
+  auto stats = RunForest(pg.get(), "forest");
+  // {0, 1, 2}, {3, 4, 5}, {6} and {7}
+  KATANA_LOG_ASSERT(stats.number_of_trees == 4);
+  KATANA_LOG_ASSERT(stats.number_of_edges == 4);
+  KATANA_LOG_ASSERT(stats.total_weight == -5 + 1 + 2 + 4);
+}
+
+void
+TestNaN() {
+  auto pg = MakeWeightedTestGraph<double>(
+      3, {{0, 1, 1.0}, {1, 2, std::numeric_limits<double>::quiet_NaN()}});
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!MinimumSpanningForest(pg.get(), "weight", "f", &txn_ctx));
+  // nothing is left behind
+  KATANA_LOG_ASSERT(!pg->GetEdgeProperty("f"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestTextbook();
+  TestForest();
+  TestNaN();
+
+  return 0;
+}
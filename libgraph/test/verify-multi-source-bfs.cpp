@@ -0,0 +1,127 @@
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max() / 4;
+
+/// Levels from source by a serial BFS
+std::vector<uint32_t>
+SerialBfs(uint32_t num_nodes, const Edges& edges, uint32_t source) {
+  std::vector<std::vector<uint32_t>> out(num_nodes);
+  for (const auto& [src, dst] : edges) {
+    out[src].emplace_back(dst);
+  }
+  std::vector<uint32_t> level(num_nodes, kInfinity);
+  std::queue<uint32_t> queue;
+  level[source] = 0;
+  queue.push(source);
+  while (!queue.empty()) {
+    uint32_t v = queue.front();
+    queue.pop();
+    for (uint32_t u : out[v]) {
+      if (level[u] == kInfinity) {
+        level[u] = level[v] + 1;
+        queue.push(u);
+      }
+    }
+  }
+  return level;
+}
+
+/// A sparse random directed graph, with some nodes unreachable from others
+Edges
+RandomEdges(uint32_t num_nodes, uint32_t num_edges, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  Edges edges;
+  for (uint32_t e = 0; e < num_edges; ++e) {
+    edges.emplace_back(node(gen), node(gen));
+  }
+  return edges;
+}
+
+void
+TestMatchesSerial(const BfsPlan& plan) {
+  constexpr uint32_t kNumNodes = 700;
+  Edges edges = RandomEdges(kNumNodes, 2 * kNumNodes, 7);
+  auto pg = MakeTestGraph(kNumNodes, edges);
+
+  // more sources than fit in one batch of 512, and one repeated
+  std::vector<uint32_t> sources;
+  for (uint32_t i = 0; i < 550; ++i) {
+    sources.emplace_back((i * 37) % kNumNodes);
+  }
+  sources.emplace_back(sources.front());
+
+  std::vector<std::string> names;
+  for (size_t i = 0; i < sources.size(); ++i) {
+    names.emplace_back("level_" + std::to_string(i));
+  }
+  katana::TxnContext txn_ctx;
+  auto res = MultiSourceBfs(pg.get(), sources, names, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "multi source bfs: {}", res.error());
+
+  auto distances_res = MultiSourceBfsDistances(pg.get(), sources, plan);
+  KATANA_LOG_VASSERT(distances_res, "distances: {}", distances_res.error());
+  const std::vector<uint32_t>& distances = distances_res.value();
+  KATANA_LOG_ASSERT(distances.size() == sources.size() * sources.size());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    std::vector<uint32_t> expected = SerialBfs(kNumNodes, edges, sources[i]);
+    std::vector<uint32_t> found = NodeValues<uint32_t>(pg.get(), names[i]);
+    KATANA_LOG_VASSERT(
+        found == expected, "levels from source {} differ", sources[i]);
+    for (size_t j = 0; j < sources.size(); ++j) {
+      KATANA_LOG_ASSERT(
+          distances[i * sources.size() + j] == expected[sources[j]]);
+    }
+  }
+}
+
+void
+TestDirected() {
+  // 0 -> 1 -> 2, and 3 reaches 0 but nothing reaches 3
+  auto pg = MakeTestGraph(4, {{0, 1}, {1, 2}, {3, 0}});
+  auto res = MultiSourceBfsDistances(pg.get(), {0, 2, 3});
+  KATANA_LOG_VASSERT(res, "distances: {}", res.error());
+  std::vector<uint32_t> expected = {0,         2,         kInfinity,
+                                    kInfinity, 0,         kInfinity,
+                                    1,         3,         0};
+  KATANA_LOG_ASSERT(res.value() == expected);
+
+  KATANA_LOG_ASSERT(!MultiSourceBfsDistances(pg.get(), {4}));
+  KATANA_LOG_ASSERT(
+      !MultiSourceBfsDistances(pg.get(), {0}, BfsPlan::Asynchronous()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestMatchesSerial(BfsPlan::Synchronous());
+  TestMatchesSerial(BfsPlan::SynchronousDirectOpt());
+  // pulls as soon as it can and keeps pulling
+  TestMatchesSerial(BfsPlan::SynchronousDirectOpt(1000, 1000));
+  TestDirected();
+
+  return 0;
+}
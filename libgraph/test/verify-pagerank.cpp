@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+constexpr uint32_t kNumNodes = 6;
+constexpr double kAlpha = PagerankPlan::kDefaultAlpha;
+constexpr double kEpsilon = 1e-4;
+
+/// A strongly connected graph in which every node has out edges, so that no
+/// walk ends and personalized ranks sum to 1
+const Edges kEdges = {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 0},
+                      {0, 2}, {2, 5}, {3, 0}, {4, 1}, {5, 2}};
+
+/// PageRank by power iteration in double precision, with each walk
+/// restarting at node n with probability restart[n] * (1 - alpha)
+std::vector<double>
+PowerIteration(const Edges& edges, const std::vector<double>& restart) {
+  size_t num_nodes = restart.size();
+  std::vector<uint32_t> degree(num_nodes, 0);
+  for (const auto& [src, dst] : edges) {
+    ++degree[src];
+  }
+  std::vector<double> rank = restart;
+  for (int iter = 0; iter < 500; ++iter) {
+    std::vector<double> next(num_nodes);
+    for (size_t n = 0; n < num_nodes; ++n) {
+      next[n] = (1 - kAlpha) * restart[n];
+    }
+    for (const auto& [src, dst] : edges) {
+      next[dst] += kAlpha * rank[src] / degree[src];
+    }
+    rank = next;
+  }
+  return rank;
+}
+
+std::vector<double>
+PowerIteration(const std::vector<double>& restart) {
+  return PowerIteration(kEdges, restart);
+}
+
+std::vector<double>
+SeedRestart(const std::vector<uint32_t>& seeds) {
+  std::vector<double> restart(kNumNodes, 0);
+  for (uint32_t seed : seeds) {
+    restart[seed] += 1.0 / seeds.size();
+  }
+  return restart;
+}
+
+void
+CheckClose(
+    const std::vector<float>& found, const std::vector<double>& expected,
+    double scale = 1) {
+  KATANA_LOG_ASSERT(found.size() == expected.size());
+  for (size_t n = 0; n < found.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(found[n] - scale * expected[n]) < scale * kEpsilon,
+        "node {}: rank {}, expected {}", n, found[n], scale * expected[n]);
+  }
+}
+
+double
+Sum(const std::vector<float>& values) {
+  double sum = 0;
+  for (float v : values) {
+    sum += v;
+  }
+  return sum;
+}
+
+std::vector<float>
+RunPersonalized(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& name, const PagerankPlan& plan) {
+  katana::TxnContext txn_ctx;
+  auto res = PersonalizedPagerank(pg, seeds, name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "personalized pagerank: {}", res.error());
+  return NodeValues<float>(pg, name);
+}
+
+void
+TestUniformSeeds() {
+  auto pg = MakeTestGraph(kNumNodes, kEdges);
+  std::vector<uint32_t> all;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    all.emplace_back(n);
+  }
+
+  katana::TxnContext txn_ctx;
+  auto res = Pagerank(
+      pg.get(), "global", &txn_ctx, PagerankPlan::PushAsynchronous(1e-6));
+  KATANA_LOG_VASSERT(res, "pagerank: {}", res.error());
+  std::vector<float> global = NodeValues<float>(pg.get(), "global");
+
+  // with every node a seed, personalized PageRank is plain PageRank over
+  // the number of nodes
+  std::vector<double> exact = PowerIteration(SeedRestart(all));
+  CheckClose(global, exact, kNumNodes);
+
+  constexpr double kTolerance = PagerankPlan::kDefaultPersonalizedTolerance;
+  std::vector<std::pair<std::string, PagerankPlan>> plans = {
+      {"async", PagerankPlan::PushAsynchronous(kTolerance)},
+      {"sync", PagerankPlan::PushSynchronous(kTolerance)}};
+  for (const auto& [name, plan] : plans) {
+    std::vector<float> personalized =
+        RunPersonalized(pg.get(), all, name, plan);
+    CheckClose(personalized, exact);
+    KATANA_LOG_ASSERT(std::fabs(Sum(personalized) - 1) < kEpsilon);
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      KATANA_LOG_ASSERT(
+          std::fabs(kNumNodes * personalized[n] - global[n]) <
+          kNumNodes * kEpsilon);
+    }
+  }
+}
+
+void
+TestSeeds() {
+  auto pg = MakeTestGraph(kNumNodes, kEdges);
+  std::vector<uint32_t> seeds = {1, 4};
+  std::vector<float> personalized = RunPersonalized(
+      pg.get(), seeds, "ppr",
+      PagerankPlan::PushAsynchronous(
+          PagerankPlan::kDefaultPersonalizedTolerance));
+  CheckClose(personalized, PowerIteration(SeedRestart(seeds)));
+  KATANA_LOG_ASSERT(std::fabs(Sum(personalized) - 1) < kEpsilon);
+
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!PersonalizedPagerank(pg.get(), {}, "none", &txn_ctx));
+  KATANA_LOG_ASSERT(
+      !PersonalizedPagerank(pg.get(), {kNumNodes}, "outside", &txn_ctx));
+  KATANA_LOG_ASSERT(!PersonalizedPagerank(
+      pg.get(), seeds, "pull", &txn_ctx, PagerankPlan::PullTopological()));
+}
+
+void
+TestTopK() {
+  auto pg = MakeTestGraph(kNumNodes, kEdges);
+  std::vector<uint32_t> seeds = {0, 3, 5};
+  for (size_t k : {size_t{1}, size_t{3}, size_t{kNumNodes}}) {
+    auto res = PersonalizedPagerankTopK(pg.get(), seeds, k);
+    KATANA_LOG_VASSERT(res, "top k: {}", res.error());
+    KATANA_LOG_ASSERT(res.value().size() == seeds.size());
+
+    for (size_t i = 0; i < seeds.size(); ++i) {
+      const auto& top = res.value()[i];
+      std::vector<double> exact = PowerIteration(SeedRestart({seeds[i]}));
+      KATANA_LOG_ASSERT(top.size() == k);
+
+      std::vector<bool> in_top(kNumNodes, false);
+      for (size_t j = 0; j < top.size(); ++j) {
+        const auto& [node, rank] = top[j];
+        KATANA_LOG_ASSERT(!in_top[node]);
+        in_top[node] = true;
+        KATANA_LOG_VASSERT(
+            std::fabs(rank - exact[node]) < kEpsilon,
+            "seed {} node {}: rank {}, expected {}", seeds[i], node, rank,
+            exact[node]);
+        KATANA_LOG_ASSERT(j == 0 || top[j - 1].second >= rank);
+      }
+      // nothing left out ranks higher than what was kept
+      for (uint32_t n = 0; n < kNumNodes; ++n) {
+        KATANA_LOG_ASSERT(
+            in_top[n] || exact[n] <= top.back().second + kEpsilon);
+      }
+    }
+  }
+}
+
+void
+TestIncremental() {
+  auto before_pg = MakeTestGraph(kNumNodes, kEdges);
+  katana::TxnContext txn_ctx;
+  auto plan = PagerankPlan::PushAsynchronous(1e-7);
+  auto res = Pagerank(before_pg.get(), "before", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "pagerank: {}", res.error());
+  std::vector<float> before = NodeValues<float>(before_pg.get(), "before");
+
+  // every node keeps an out edge
+  Edges inserted = {{1, 4}, {3, 5}, {3, 1}};
+  Edges deleted = {{0, 2}, {4, 1}};
+  Edges after_edges;
+  for (const auto& edge : kEdges) {
+    if (std::find(deleted.begin(), deleted.end(), edge) == deleted.end()) {
+      after_edges.emplace_back(edge);
+    }
+  }
+  after_edges.insert(after_edges.end(), inserted.begin(), inserted.end());
+
+  auto pg = MakeTestGraph(kNumNodes, after_edges);
+  auto add_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("before", [&](uint64_t n) {
+        return before[n];
+      }));
+  KATANA_LOG_VASSERT(add_res, "adding ranks: {}", add_res.error());
+
+  auto inc_res = PagerankIncremental(
+      pg.get(), "before", "after", inserted, deleted, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(inc_res, "incremental: {}", inc_res.error());
+  CheckClose(
+      NodeValues<float>(pg.get(), "after"),
+      PowerIteration(after_edges, std::vector<double>(kNumNodes, 1.0)));
+
+  // node 5 has two out edges, too few to have had three inserted
+  KATANA_LOG_ASSERT(!PagerankIncremental(
+      pg.get(), "before", "wrong", {{5, 1}, {5, 3}, {5, 4}}, {}, &txn_ctx,
+      plan));
+  KATANA_LOG_ASSERT(!PagerankIncremental(
+      pg.get(), "before", "outside", {{0, kNumNodes}}, {}, &txn_ctx, plan));
+}
+
+void
+TestPropagationBlocking() {
+  // large enough for several blocks where the last level cache is small,
+  // with a few nodes without out edges
+  constexpr uint32_t kLarge = 20000;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<uint32_t> node(0, kLarge - 1);
+  Edges edges;
+  for (uint32_t n = 0; n + 10 < kLarge; ++n) {
+    edges.emplace_back(n, n + 1);
+    for (int e = 0; e < 3; ++e) {
+      edges.emplace_back(n, node(gen));
+    }
+  }
+
+  for (const auto& [num_nodes, graph_edges] :
+       {std::make_pair(kNumNodes, kEdges), std::make_pair(kLarge, edges)}) {
+    auto pg = MakeTestGraph(num_nodes, graph_edges);
+    katana::TxnContext txn_ctx;
+    // a fixed number of iterations, far past convergence
+    auto res = Pagerank(
+        pg.get(), "blocked", &txn_ctx,
+        PagerankPlan::PropagationBlocking(0, 200));
+    KATANA_LOG_VASSERT(res, "propagation blocking: {}", res.error());
+
+    std::vector<float> blocked = NodeValues<float>(pg.get(), "blocked");
+    std::vector<double> exact =
+        PowerIteration(graph_edges, std::vector<double>(num_nodes, 1.0));
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          std::fabs(blocked[n] - exact[n]) < 1e-3 * std::max(exact[n], 1.0),
+          "node {}: rank {}, expected {}", n, blocked[n], exact[n]);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestUniformSeeds();
+  TestSeeds();
+  TestTopK();
+  TestIncremental();
+  TestPropagationBlocking();
+
+  return 0;
+}
@@ -0,0 +1,490 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParquetReader.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using WeightedEdges = std::vector<std::tuple<uint32_t, uint32_t, uint32_t>>;
+using Walks = std::vector<std::vector<uint32_t>>;
+
+constexpr uint32_t kNumNodes = 8;
+/// Steps drawn from the same state before their frequencies are compared
+constexpr uint32_t kMinSamples = 5000;
+constexpr double kTolerance = 0.035;
+constexpr uint32_t kWalksPerNode = 8000;
+
+/// A ring, so that every node has an edge of positive weight, and a few
+/// chords; one chord has weight 0 and is never walked
+WeightedEdges
+SmallGraph() {
+  WeightedEdges edges;
+  std::mt19937 gen(16);
+  std::uniform_int_distribution<uint32_t> weight(1, 5);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    edges.emplace_back(n, (n + 1) % kNumNodes, weight(gen));
+  }
+  for (auto [a, b] : {std::make_pair(0, 2), std::make_pair(0, 4),
+                      std::make_pair(1, 5), std::make_pair(2, 4),
+                      std::make_pair(3, 6)}) {
+    edges.emplace_back(a, b, weight(gen));
+  }
+  edges.emplace_back(5, 7, 0);
+  return edges;
+}
+
+/// The probability of every next node of a walk at cur that came from prev,
+/// or that starts at cur if prev is cur: the weight of the edge to it times
+/// 1/p back to prev, 1 to a neighbor of prev and 1/q further away
+template <typename T>
+std::map<uint32_t, double>
+Node2VecStep(
+    const std::vector<std::tuple<uint32_t, uint32_t, T>>& edges, uint32_t prev,
+    uint32_t cur, double p, double q) {
+  std::map<uint32_t, double> weight;
+  std::set<uint32_t> prev_neighbors;
+  for (const auto& [a, b, w] : edges) {
+    for (auto [src, dst] : {std::make_pair(a, b), std::make_pair(b, a)}) {
+      if (src == cur) {
+        weight[dst] += w;
+      }
+      if (src == prev) {
+        prev_neighbors.emplace(dst);
+      }
+    }
+  }
+  double total = 0;
+  for (auto& [dst, w] : weight) {
+    if (prev != cur) {
+      w *= dst == prev ? 1 / p : prev_neighbors.count(dst) ? 1 : 1 / q;
+    }
+    total += w;
+  }
+  for (auto& [dst, w] : weight) {
+    w /= total;
+  }
+  return weight;
+}
+
+/// Compares the frequency of every step of the walks with the probabilities
+/// step(prev, cur) gives, for the states (prev, cur) seen often enough
+template <typename Step>
+void
+CheckStepFrequencies(const Walks& walks, const Step& step) {
+  std::map<std::pair<uint32_t, uint32_t>, std::map<uint32_t, uint32_t>> seen;
+  for (const auto& walk : walks) {
+    KATANA_LOG_ASSERT(walk.size() >= 2);
+    seen[{walk[0], walk[0]}][walk[1]] += 1;
+    for (size_t i = 2; i < walk.size(); ++i) {
+      seen[{walk[i - 2], walk[i - 1]}][walk[i]] += 1;
+    }
+  }
+  size_t num_checked = 0;
+  for (const auto& [state, next] : seen) {
+    const auto& [prev, cur] = state;
+    std::map<uint32_t, double> expected = step(prev, cur);
+    uint32_t total = 0;
+    for (const auto& [dst, count] : next) {
+      KATANA_LOG_VASSERT(
+          expected.count(dst) && expected[dst] > 0,
+          "step {} -> {} -> {} is not an edge of positive weight", prev, cur,
+          dst);
+      total += count;
+    }
+    if (total < kMinSamples) {
+      continue;
+    }
+    num_checked += 1;
+    for (const auto& [dst, probability] : expected) {
+      double found = next.count(dst) ? double(next.at(dst)) / total : 0;
+      KATANA_LOG_VASSERT(
+          std::fabs(found - probability) < kTolerance,
+          "{} -> {} -> {}: frequency {}, expected {}", prev, cur, dst, found,
+          probability);
+    }
+  }
+  // every start and most (prev, cur) pairs
+  KATANA_LOG_ASSERT(num_checked > kNumNodes);
+}
+
+/// Compares the frequency of every step of the walks with Node2VecStep
+void
+CheckSteps(const WeightedEdges& edges, const Walks& walks, double p, double q) {
+  CheckStepFrequencies(walks, [&](uint32_t prev, uint32_t cur) {
+    return Node2VecStep(edges, prev, cur, p, q);
+  });
+}
+
+/// The type of every edge, both ways, of edges of (source, destination, type)
+std::map<std::pair<uint32_t, uint32_t>, uint32_t>
+EdgeTypes(const WeightedEdges& edges) {
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> types;
+  for (const auto& [a, b, type] : edges) {
+    types[{a, b}] = type;
+    types[{b, a}] = type;
+  }
+  return types;
+}
+
+/// The transition weights Edge2Vec learns from walks: for types i and j past
+/// 0, the sigmoid of the Pearson correlation of their numbers of edges over
+/// the walks, or of 0 if either number never changes; 1 otherwise
+std::vector<double>
+Edge2VecTransitions(
+    const WeightedEdges& edges, const Walks& walks, uint32_t num_types) {
+  auto types = EdgeTypes(edges);
+  std::vector<double> sums(num_types, 0);
+  std::vector<double> product_sums(num_types * num_types, 0);
+  for (const auto& walk : walks) {
+    std::vector<double> counts(num_types, 0);
+    for (size_t i = 1; i < walk.size(); ++i) {
+      counts[types.at({walk[i - 1], walk[i]})] += 1;
+    }
+    for (uint32_t i = 0; i < num_types; ++i) {
+      sums[i] += counts[i];
+      for (uint32_t j = 0; j < num_types; ++j) {
+        product_sums[i * num_types + j] += counts[i] * counts[j];
+      }
+    }
+  }
+  double num_walks = walks.size();
+  auto covariance = [&](uint32_t i, uint32_t j) {
+    return product_sums[i * num_types + j] / num_walks -
+           (sums[i] / num_walks) * (sums[j] / num_walks);
+  };
+  std::vector<double> transitions(num_types * num_types, 1.0);
+  for (uint32_t i = 1; i < num_types; ++i) {
+    for (uint32_t j = 1; j < num_types; ++j) {
+      double sig = std::sqrt(covariance(i, i) * covariance(j, j));
+      double pearson = sig > 0 ? covariance(i, j) / sig : 0;
+      transitions[i * num_types + j] = 1 / (1 + std::exp(-pearson));
+    }
+  }
+  return transitions;
+}
+
+/// The probabilities of an Edge2Vec step: those of Node2VecStep with the
+/// weight of an edge the transition weight from the type of the edge the
+/// walk came by to its own
+std::map<uint32_t, double>
+Edge2VecStep(
+    const WeightedEdges& edges, const std::vector<double>& transitions,
+    uint32_t num_types, uint32_t prev, uint32_t cur, double p, double q) {
+  auto types = EdgeTypes(edges);
+  std::vector<std::tuple<uint32_t, uint32_t, double>> weighted;
+  for (const auto& [a, b, type] : edges) {
+    // the first step is uniform
+    double weight = 1;
+    if (prev != cur) {
+      weight = transitions[types.at({prev, cur}) * num_types + type];
+    }
+    weighted.emplace_back(a, b, weight);
+  }
+  return Node2VecStep(weighted, prev, cur, p, q);
+}
+
+void
+TestWalks() {
+  WeightedEdges edges = SmallGraph();
+  WeightedEdges unit_edges;
+  for (const auto& [a, b, w] : edges) {
+    unit_edges.emplace_back(a, b, w ? 1 : 0);
+  }
+  auto pg = MakeWeightedTestGraph(kNumNodes, edges, true);
+  // without the chord of weight 0, which unweighted walks would take
+  WeightedEdges positive(unit_edges.begin(), unit_edges.end() - 1);
+  auto unweighted_pg = MakeWeightedTestGraph(kNumNodes, positive, true);
+
+  // first order; a return bias below, between and above max(1, 1/q), the
+  // last folded out of the rejection sampler
+  for (auto [p, q] : {std::make_pair(1.0, 1.0), std::make_pair(4.0, 0.25),
+                      std::make_pair(0.25, 0.5), std::make_pair(0.25, 2.0)}) {
+    auto plan = RandomWalksPlan::Node2Vec(6, kWalksPerNode, p, q);
+    auto res = RandomWalks(pg.get(), "weight", plan);
+    KATANA_LOG_VASSERT(res, "weighted walks: {}", res.error());
+    KATANA_LOG_ASSERT(res.value().size() == kNumNodes * kWalksPerNode);
+    CheckSteps(edges, res.value(), p, q);
+
+    auto unweighted_res = RandomWalks(unweighted_pg.get(), plan);
+    KATANA_LOG_VASSERT(unweighted_res, "walks: {}", unweighted_res.error());
+    CheckSteps(positive, unweighted_res.value(), p, q);
+
+    // weighted walks are the same whatever the thread that takes them
+    katana::setActiveThreads(1);
+    auto serial_res = RandomWalks(pg.get(), "weight", plan);
+    katana::setActiveThreads(4);
+    KATANA_LOG_VASSERT(serial_res, "serial walks: {}", serial_res.error());
+    std::multiset<std::vector<uint32_t>> parallel(
+        res.value().begin(), res.value().end());
+    std::multiset<std::vector<uint32_t>> serial(
+        serial_res.value().begin(), serial_res.value().end());
+    KATANA_LOG_ASSERT(parallel == serial);
+  }
+}
+
+/// Appends the walks of a list array of uint32 node ids, large or not
+template <typename ListArray>
+void
+AppendWalks(const ListArray& lists, Walks* walks) {
+  const auto& values =
+      static_cast<const arrow::UInt32Array&>(*lists.values());
+  for (int64_t i = 0; i < lists.length(); ++i) {
+    std::vector<uint32_t> walk;
+    for (auto v = lists.value_offset(i); v < lists.value_offset(i + 1); ++v) {
+      walk.emplace_back(values.Value(v));
+    }
+    walks->emplace_back(std::move(walk));
+  }
+}
+
+Walks
+ReadWalks(const std::string& path) {
+  auto reader_res = katana::ParquetReader::Make();
+  KATANA_LOG_VASSERT(reader_res, "reader: {}", reader_res.error());
+  auto uri_res = katana::Uri::Make(path);
+  KATANA_LOG_ASSERT(uri_res);
+  auto table_res = reader_res.value()->ReadTable(uri_res.value());
+  KATANA_LOG_VASSERT(table_res, "reading walks: {}", table_res.error());
+  auto column = table_res.value()->GetColumnByName("walk");
+  KATANA_LOG_ASSERT(column);
+
+  Walks walks;
+  for (const auto& chunk : column->chunks()) {
+    if (chunk->type_id() == arrow::Type::LARGE_LIST) {
+      AppendWalks(static_cast<const arrow::LargeListArray&>(*chunk), &walks);
+    } else {
+      KATANA_LOG_ASSERT(chunk->type_id() == arrow::Type::LIST);
+      AppendWalks(static_cast<const arrow::ListArray&>(*chunk), &walks);
+    }
+  }
+  return walks;
+}
+
+/// Checks that RandomWalksCompact and RandomWalksToParquet give the walks of
+/// RandomWalks, in order of walk: walk idx starts at node idx % num_nodes
+/// and nodes without edges start none
+void
+CheckCompact(
+    katana::PropertyGraph* pg, const std::vector<bool>& isolated,
+    const std::string& weight, const RandomWalksPlan& plan) {
+  auto res = weight.empty() ? RandomWalks(pg, plan)
+                            : RandomWalks(pg, weight, plan);
+  KATANA_LOG_VASSERT(res, "walks: {}", res.error());
+  auto compact_res = RandomWalksCompact(pg, weight, plan);
+  KATANA_LOG_VASSERT(compact_res, "compact walks: {}", compact_res.error());
+  Walks compact;
+  AppendWalks(*compact_res.value(), &compact);
+
+  std::multiset<std::vector<uint32_t>> expected(
+      res.value().begin(), res.value().end());
+  KATANA_LOG_ASSERT(
+      std::multiset<std::vector<uint32_t>>(compact.begin(), compact.end()) ==
+      expected);
+
+  uint32_t num_nodes = isolated.size();
+  size_t k = 0;
+  for (uint64_t idx = 0; idx < num_nodes * plan.number_of_walks(); ++idx) {
+    if (isolated[idx % num_nodes]) {
+      continue;
+    }
+    KATANA_LOG_ASSERT(k < compact.size());
+    KATANA_LOG_VASSERT(
+        compact[k].front() == idx % num_nodes, "walk {} starts at {}", idx,
+        compact[k].front());
+    ++k;
+  }
+  KATANA_LOG_ASSERT(k == compact.size());
+
+  // batches that do not divide the walks, and one batch of them all
+  for (uint64_t per_batch : {uint64_t{7}, uint64_t{1} << 22}) {
+    auto uri_res = katana::Uri::MakeRand("/tmp/randomwalks");
+    KATANA_LOG_ASSERT(uri_res);
+    std::string path = uri_res.value().path() + ".parquet";
+    auto num_res = RandomWalksToParquet(pg, path, weight, plan, per_batch);
+    KATANA_LOG_VASSERT(num_res, "writing walks: {}", num_res.error());
+    KATANA_LOG_ASSERT(num_res.value() == compact.size());
+    KATANA_LOG_ASSERT(ReadWalks(path) == compact);
+    fs::remove(path);
+  }
+}
+
+void
+TestCompact() {
+  constexpr uint32_t kRing = 50;
+  WeightedEdges edges;
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<uint32_t> weight(1, 5);
+  std::uniform_int_distribution<uint32_t> node(0, kRing - 1);
+  for (uint32_t n = 0; n < kRing; ++n) {
+    edges.emplace_back(n, (n + 1) % kRing, weight(gen));
+    edges.emplace_back(n, node(gen), weight(gen));
+  }
+
+  // every walk full length, so that the values are used as generated, and
+  // with two nodes without edges, so that they are packed
+  for (uint32_t num_isolated : {0U, 2U}) {
+    uint32_t num_nodes = kRing + num_isolated;
+    std::vector<bool> isolated(num_nodes, false);
+    std::fill(isolated.begin() + kRing, isolated.end(), true);
+    auto pg = MakeWeightedTestGraph(num_nodes, edges, true);
+    for (const auto& plan :
+         {RandomWalksPlan::Node2Vec(5, 3, 1.0, 1.0),
+          RandomWalksPlan::Node2Vec(9, 2, 0.5, 2.0),
+          RandomWalksPlan::Node2Vec(1, 1, 1.0, 1.0)}) {
+      CheckCompact(pg.get(), isolated, "", plan);
+      CheckCompact(pg.get(), isolated, "weight", plan);
+    }
+  }
+
+  auto pg = MakeWeightedTestGraph(kRing, edges, true);
+  auto uri_res = katana::Uri::MakeRand("/tmp/randomwalks");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string path = uri_res.value().path() + ".parquet";
+  KATANA_LOG_ASSERT(
+      !RandomWalksToParquet(pg.get(), path, "", RandomWalksPlan(), 0));
+  KATANA_LOG_ASSERT(!RandomWalksToParquet(
+      pg.get(), path, "missing", RandomWalksPlan(), 7));
+  fs::remove(path);
+}
+
+void
+TestEdge2Vec() {
+  // every edge of positive weight, of type "A" or "B"
+  WeightedEdges edges = SmallGraph();
+  edges.pop_back();
+  std::mt19937 gen(32);
+  std::vector<bool> is_a;
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  for (const auto& [a, b, w] : edges) {
+    is_a.emplace_back(gen() % 2);
+    pairs.emplace_back(a, b);
+  }
+  auto pg = MakeTestGraph(kNumNodes, pairs, true);
+  std::vector<std::tuple<uint32_t, uint32_t, bool>> ordered;
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    ordered.emplace_back(pairs[i].first, pairs[i].second, is_a[i]);
+  }
+  ordered = OrderTestEdges(ordered, true);
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "A",
+          [&](uint64_t e) {
+            return static_cast<uint8_t>(std::get<2>(ordered[e]));
+          }),
+      katana::PropertyGenerator("B", [&](uint64_t e) {
+        return static_cast<uint8_t>(!std::get<2>(ordered[e]));
+      }));
+  KATANA_LOG_VASSERT(add_res, "adding edge types: {}", add_res.error());
+  auto types_res = pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+
+  const auto& manager = pg->GetEdgeTypeManager();
+  uint32_t a_type = manager.GetEntityTypeID("A");
+  uint32_t b_type = manager.GetEntityTypeID("B");
+  uint32_t num_edge_types = std::max(a_type, b_type);
+  uint32_t num_types = num_edge_types + 1;
+  WeightedEdges typed;
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    typed.emplace_back(
+        pairs[i].first, pairs[i].second, is_a[i] ? a_type : b_type);
+  }
+
+  for (auto [p, q] : {std::make_pair(1.0, 1.0), std::make_pair(4.0, 0.25)}) {
+    auto first_res = RandomWalks(
+        pg.get(),
+        RandomWalksPlan::Edge2Vec(6, kWalksPerNode, p, q, 1, num_edge_types));
+    KATANA_LOG_VASSERT(first_res, "edge2vec: {}", first_res.error());
+    const Walks& first = first_res.value();
+    KATANA_LOG_ASSERT(first.size() == kNumNodes * kWalksPerNode);
+    for (const auto& walk : first) {
+      KATANA_LOG_ASSERT(walk.size() == 7);
+    }
+    // every transition weight starts at 1, so the types do not matter yet
+    std::vector<double> ones(num_types * num_types, 1.0);
+    CheckStepFrequencies(first, [&](uint32_t prev, uint32_t cur) {
+      return Edge2VecStep(typed, ones, num_types, prev, cur, p, q);
+    });
+
+    // the walks of every iteration are kept, and the first iteration of two
+    // is the one above
+    auto plan = RandomWalksPlan::Edge2Vec(
+        6, kWalksPerNode, p, q, 2, num_edge_types);
+    auto both_res = RandomWalks(pg.get(), plan);
+    KATANA_LOG_VASSERT(both_res, "edge2vec: {}", both_res.error());
+    KATANA_LOG_ASSERT(both_res.value().size() == 2 * first.size());
+    std::multiset<std::vector<uint32_t>> both(
+        both_res.value().begin(), both_res.value().end());
+    for (const auto& walk : first) {
+      auto it = both.find(walk);
+      KATANA_LOG_ASSERT(it != both.end());
+      both.erase(it);
+    }
+    std::vector<double> transitions =
+        Edge2VecTransitions(typed, first, num_types);
+    CheckStepFrequencies(
+        Walks(both.begin(), both.end()), [&](uint32_t prev, uint32_t cur) {
+          return Edge2VecStep(typed, transitions, num_types, prev, cur, p, q);
+        });
+
+    // the statistics sum the same whatever the threads
+    katana::setActiveThreads(1);
+    auto serial_res = RandomWalks(pg.get(), plan);
+    katana::setActiveThreads(4);
+    KATANA_LOG_VASSERT(serial_res, "serial edge2vec: {}", serial_res.error());
+    std::multiset<std::vector<uint32_t>> parallel(
+        both_res.value().begin(), both_res.value().end());
+    std::multiset<std::vector<uint32_t>> serial(
+        serial_res.value().begin(), serial_res.value().end());
+    KATANA_LOG_ASSERT(parallel == serial);
+  }
+
+  KATANA_LOG_ASSERT(!RandomWalks(
+      pg.get(), RandomWalksPlan::Edge2Vec(6, 1, 1, 1, 1, num_edge_types - 1)));
+  KATANA_LOG_ASSERT(!RandomWalksToParquet(
+      pg.get(), "unused.parquet", "", RandomWalksPlan::Edge2Vec()));
+}
+
+void
+TestRejected() {
+  auto pg = MakeWeightedTestGraph<int32_t>(2, {{0, 1, -1}}, true);
+  KATANA_LOG_ASSERT(!RandomWalks(pg.get(), "weight"));
+  KATANA_LOG_ASSERT(!RandomWalks(pg.get(), "missing"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestWalks();
+  TestCompact();
+  TestEdge2Vec();
+  TestRejected();
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+using Matches = std::vector<std::vector<std::pair<uint32_t, double>>>;
+
+/// The top k matches of every node by comparing all pairs of neighbor sets
+Matches
+BruteForceTopK(
+    uint32_t num_nodes, const Edges& edges, uint32_t k, double min_similarity,
+    SetSimilarity measure) {
+  std::vector<std::set<uint32_t>> sets(num_nodes);
+  for (const auto& [src, dst] : edges) {
+    sets[src].emplace(dst);
+  }
+  Matches matches(num_nodes);
+  for (uint32_t u = 0; u < num_nodes; ++u) {
+    auto& found = matches[u];
+    for (uint32_t v = 0; v < num_nodes; ++v) {
+      if (v == u) {
+        continue;
+      }
+      uint32_t overlap = 0;
+      for (uint32_t x : sets[u]) {
+        overlap += sets[v].count(x);
+      }
+      if (overlap == 0) {
+        continue;
+      }
+      // the same arithmetic as SimilarityTopK, so equal pairs compare equal
+      uint32_t u_size = sets[u].size();
+      uint32_t v_size = sets[v].size();
+      double similarity =
+          measure == SetSimilarity::kCosine
+              ? overlap / std::sqrt(static_cast<double>(u_size) * v_size)
+              : static_cast<double>(overlap) / (u_size + v_size - overlap);
+      if (similarity >= min_similarity) {
+        found.emplace_back(v, similarity);
+      }
+    }
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+      return a.second > b.second || (a.second == b.second && a.first < b.first);
+    });
+    if (found.size() > k) {
+      found.resize(k);
+    }
+  }
+  return matches;
+}
+
+void
+TestSmall() {
+  // 0 and 1 point at {3, 4}, 2 at {4}; 3 and 4 point nowhere
+  Edges edges = {{0, 3}, {0, 4}, {1, 4}, {1, 3}, {2, 4}, {2, 4}};
+  auto pg = MakeTestGraph(5, edges);
+
+  auto jaccard_res = SimilarityTopK(pg.get(), 2);
+  KATANA_LOG_VASSERT(jaccard_res, "jaccard: {}", jaccard_res.error());
+  Matches jaccard = {
+      {{1, 1.0}, {2, 0.5}}, {{0, 1.0}, {2, 0.5}}, {{0, 0.5}, {1, 0.5}}, {}, {}};
+  KATANA_LOG_ASSERT(jaccard_res.value() == jaccard);
+
+  auto cosine_res = SimilarityTopK(pg.get(), 1, 0, SetSimilarity::kCosine);
+  KATANA_LOG_VASSERT(cosine_res, "cosine: {}", cosine_res.error());
+  const Matches& cosine = cosine_res.value();
+  KATANA_LOG_ASSERT(cosine[0] == (std::vector<std::pair<uint32_t, double>>{
+                                     {1, 1.0}}));
+  KATANA_LOG_ASSERT(cosine[2].size() == 1 && cosine[2][0].first == 0);
+  KATANA_LOG_ASSERT(std::fabs(cosine[2][0].second - std::sqrt(0.5)) < 1e-12);
+
+  KATANA_LOG_ASSERT(SimilarityTopK(pg.get(), 0).value() == Matches(5));
+  KATANA_LOG_ASSERT(!SimilarityTopK(pg.get(), 2, -0.1));
+  KATANA_LOG_ASSERT(!SimilarityTopK(pg.get(), 2, 1.1));
+}
+
+void
+TestMatchesBruteForce() {
+  // skewed out degrees, with parallel edges which count once
+  constexpr uint32_t kNumNodes = 300;
+  std::mt19937 gen(12);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::uniform_int_distribution<uint32_t> popular(0, 19);
+  Edges edges;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    uint32_t degree = 1 + (n % 7) * (n % 5);
+    for (uint32_t e = 0; e < degree; ++e) {
+      edges.emplace_back(n, e % 2 ? node(gen) : popular(gen));
+    }
+  }
+  auto pg = MakeTestGraph(kNumNodes, edges);
+
+  for (SetSimilarity measure :
+       {SetSimilarity::kJaccard, SetSimilarity::kCosine}) {
+    for (double min_similarity : {0.0, 0.3, 0.8}) {
+      for (uint32_t k : {1U, 5U, kNumNodes}) {
+        auto res = SimilarityTopK(pg.get(), k, min_similarity, measure);
+        KATANA_LOG_VASSERT(res, "top k: {}", res.error());
+        KATANA_LOG_VASSERT(
+            res.value() ==
+                BruteForceTopK(kNumNodes, edges, k, min_similarity, measure),
+            "k {} min similarity {} differs from brute force", k,
+            min_similarity);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSmall();
+  TestMatchesBruteForce();
+
+  return 0;
+}
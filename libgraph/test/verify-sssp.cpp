@@ -0,0 +1,181 @@
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+template <typename T>
+using WeightedEdges = std::vector<std::tuple<uint32_t, uint32_t, T>>;
+
+/// Distances from source by a serial Dijkstra, with unreached nodes at
+/// infinity
+template <typename T>
+std::vector<T>
+SerialDijkstra(
+    uint32_t num_nodes, const WeightedEdges<T>& edges, uint32_t source,
+    T infinity) {
+  std::vector<std::vector<std::pair<uint32_t, T>>> out(num_nodes);
+  for (const auto& [src, dst, weight] : edges) {
+    out[src].emplace_back(dst, weight);
+  }
+  std::vector<T> dist(num_nodes, infinity);
+  using Item = std::pair<T, uint32_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  dist[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty()) {
+    auto [d, v] = queue.top();
+    queue.pop();
+    if (d > dist[v]) {
+      continue;
+    }
+    for (const auto& [u, weight] : out[v]) {
+      if (d + weight < dist[u]) {
+        dist[u] = d + weight;
+        queue.emplace(dist[u], u);
+      }
+    }
+  }
+  return dist;
+}
+
+/// A random directed graph whose weights span a few orders of magnitude,
+/// zero included, so that the choice of delta matters
+template <typename T>
+WeightedEdges<T>
+RandomWeightedEdges(uint32_t num_nodes, uint32_t num_edges, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  std::uniform_int_distribution<uint32_t> exponent(0, 12);
+  WeightedEdges<T> edges;
+  for (uint32_t e = 0; e < num_edges; ++e) {
+    T weight = std::uniform_int_distribution<uint32_t>(
+        0, 1U << exponent(gen))(gen);
+    edges.emplace_back(node(gen), node(gen), weight);
+  }
+  return edges;
+}
+
+template <typename T>
+void
+TestPlansMatchDijkstra() {
+  constexpr uint32_t kNumNodes = 2000;
+  constexpr uint32_t kSource = 3;
+  WeightedEdges<T> edges = RandomWeightedEdges<T>(kNumNodes, 5 * kNumNodes, 9);
+  auto pg = MakeWeightedTestGraph(kNumNodes, edges);
+
+  katana::TxnContext txn_ctx;
+  auto res = Sssp(
+      pg.get(), kSource, "weight", "dijkstra", &txn_ctx,
+      SsspPlan::Dijkstra());
+  KATANA_LOG_VASSERT(res, "dijkstra: {}", res.error());
+  std::vector<T> dijkstra = NodeValues<T>(pg.get(), "dijkstra");
+  // unreached nodes are at the infinity of BfsSsspImplementationBase
+  T infinity = std::numeric_limits<T>::max() / 4;
+  KATANA_LOG_ASSERT(
+      dijkstra == SerialDijkstra(kNumNodes, edges, kSource, infinity));
+
+  std::vector<std::pair<std::string, SsspPlan>> plans = {
+      {"automatic", SsspPlan()},
+      {"graph", SsspPlan(pg.get())},
+      {"tile", SsspPlan::DeltaTile(SsspPlan::kAutomaticDelta)},
+      {"step", SsspPlan::DeltaStep(SsspPlan::kAutomaticDelta)},
+      {"barrier", SsspPlan::DeltaStepBarrier(SsspPlan::kAutomaticDelta)},
+      {"fusion", SsspPlan::DeltaStepFusion(SsspPlan::kAutomaticDelta)},
+      {"radius1", SsspPlan::RadiusStep(1)},
+      {"radius4", SsspPlan::RadiusStep()},
+      {"radius_max", SsspPlan::RadiusStep(SsspPlan::kMaxRadiusNeighbors)}};
+  for (const auto& [name, plan] : plans) {
+    auto plan_res = Sssp(pg.get(), kSource, "weight", name, &txn_ctx, plan);
+    KATANA_LOG_VASSERT(plan_res, "{}: {}", name, plan_res.error());
+    KATANA_LOG_VASSERT(
+        NodeValues<T>(pg.get(), name) == dijkstra, "{} differs from Dijkstra",
+        name);
+    auto valid_res = SsspAssertValid(pg.get(), kSource, "weight", name);
+    KATANA_LOG_VASSERT(valid_res, "{}: {}", name, valid_res.error());
+  }
+}
+
+template <typename T>
+void
+TestPointToPoint() {
+  constexpr uint32_t kNumNodes = 300;
+  WeightedEdges<T> edges = RandomWeightedEdges<T>(kNumNodes, 3 * kNumNodes, 2);
+  WeightedEdges<T> unit_edges;
+  for (const auto& [src, dst, weight] : edges) {
+    unit_edges.emplace_back(src, dst, 1);
+  }
+  auto pg = MakeWeightedTestGraph(kNumNodes, edges);
+
+  std::vector<std::pair<uint32_t, uint32_t>> queries;
+  for (uint32_t s : {0U, 1U, 17U, 150U, 299U}) {
+    for (uint32_t t = 0; t < kNumNodes; ++t) {
+      queries.emplace_back(s, t);
+    }
+  }
+  auto res = SsspPointToPoint(pg.get(), queries, "weight");
+  KATANA_LOG_VASSERT(res, "point to point: {}", res.error());
+  auto unit_res = SsspPointToPoint(pg.get(), queries);
+  KATANA_LOG_VASSERT(unit_res, "unit weights: {}", unit_res.error());
+
+  T infinity = std::numeric_limits<T>::max() / 4;
+  auto as_double = [&](T d) {
+    return d == infinity ? std::numeric_limits<double>::infinity()
+                         : static_cast<double>(d);
+  };
+  for (size_t first = 0; first < queries.size(); first += kNumNodes) {
+    uint32_t s = queries[first].first;
+    std::vector<T> dist = SerialDijkstra(kNumNodes, edges, s, infinity);
+    std::vector<T> hops = SerialDijkstra(kNumNodes, unit_edges, s, infinity);
+    for (uint32_t t = 0; t < kNumNodes; ++t) {
+      KATANA_LOG_VASSERT(
+          res.value()[first + t] == as_double(dist[t]),
+          "({}, {}): {}, expected {}", s, t, res.value()[first + t],
+          as_double(dist[t]));
+      KATANA_LOG_ASSERT(unit_res.value()[first + t] == as_double(hops[t]));
+    }
+  }
+
+  KATANA_LOG_ASSERT(!SsspPointToPoint(pg.get(), {{0, kNumNodes}}, "weight"));
+}
+
+void
+TestRadiusNeighbors() {
+  auto pg = MakeWeightedTestGraph<uint32_t>(2, {{0, 1, 1}});
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!Sssp(
+      pg.get(), 0, "weight", "none", &txn_ctx, SsspPlan::RadiusStep(0)));
+  KATANA_LOG_ASSERT(!Sssp(
+      pg.get(), 0, "weight", "many", &txn_ctx,
+      SsspPlan::RadiusStep(SsspPlan::kMaxRadiusNeighbors + 1)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestPlansMatchDijkstra<uint32_t>();
+  TestPlansMatchDijkstra<uint64_t>();
+  TestRadiusNeighbors();
+  TestPointToPoint<uint32_t>();
+  TestPointToPoint<int64_t>();
+
+  return 0;
+}
@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// (source, destination, id), the id indexing is_a
+using Edges = std::vector<std::tuple<uint32_t, uint32_t, uint32_t>>;
+
+constexpr uint32_t kNumNodes = 200;
+
+struct TestGraph {
+  Edges edges;
+  std::vector<bool> is_a;
+  std::unique_ptr<katana::PropertyGraph> pg;
+};
+
+bool
+IsX(uint32_t n) {
+  return n % 4 != 0;
+}
+
+/// A random directed graph, with self loops and parallel edges, whose nodes
+/// have type "X" if IsX and whose edges have type "A" or "B". Node n has the
+/// property "value" 10 n and every edge its id in the property "id".
+TestGraph
+MakeGraph() {
+  TestGraph graph;
+  std::mt19937 gen(23);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  for (uint32_t e = 0; e < 5 * kNumNodes; ++e) {
+    uint32_t src = node(gen);
+    graph.edges.emplace_back(src, node(gen), e);
+    graph.is_a.emplace_back(gen() % 3 != 0);
+  }
+  for (uint32_t e = 0; e < 20; ++e) {
+    auto edge = graph.edges[e];
+    std::get<2>(edge) = graph.edges.size();
+    graph.edges.emplace_back(edge);
+    graph.is_a.emplace_back(gen() % 2);
+  }
+  graph.pg = MakeWeightedTestGraph(kNumNodes, graph.edges, false, "id");
+
+  Edges ordered = OrderTestEdges(graph.edges, false);
+  auto is_a = [&](uint64_t e) {
+    return static_cast<uint8_t>(graph.is_a[std::get<2>(ordered[e])]);
+  };
+  katana::TxnContext txn_ctx;
+  auto node_res = katana::AddNodeProperties(
+      graph.pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "value", [](uint64_t n) { return uint64_t{10} * n; }),
+      katana::PropertyGenerator(
+          "X", [](uint64_t n) { return static_cast<uint8_t>(IsX(n)); }));
+  KATANA_LOG_VASSERT(node_res, "adding node properties: {}", node_res.error());
+  auto edge_res = katana::AddEdgeProperties(
+      graph.pg.get(), &txn_ctx, katana::PropertyGenerator("A", is_a),
+      katana::PropertyGenerator(
+          "B", [&](uint64_t e) { return static_cast<uint8_t>(!is_a(e)); }));
+  KATANA_LOG_VASSERT(edge_res, "adding edge types: {}", edge_res.error());
+  auto types_res = graph.pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+  return graph;
+}
+
+/// Checks that sub is the sub-graph of node_set: node i is node_set[i], and
+/// the out edges of a node are the kept edges between nodes of node_set, by
+/// new destination and then by id, with their types and properties
+void
+CheckSubGraph(
+    const TestGraph& graph, katana::PropertyGraph* sub,
+    const std::vector<uint32_t>& node_set, bool only_a, bool with_properties) {
+  KATANA_LOG_ASSERT(sub->NumNodes() == node_set.size());
+  std::vector<uint32_t> new_id(kNumNodes, kNumNodes);
+  for (uint32_t i = 0; i < node_set.size(); ++i) {
+    new_id[node_set[i]] = i;
+  }
+  std::vector<std::set<std::pair<uint32_t, uint32_t>>> expected(
+      node_set.size());
+  uint64_t num_edges = 0;
+  for (const auto& [src, dst, id] : graph.edges) {
+    if (new_id[src] != kNumNodes && new_id[dst] != kNumNodes &&
+        (!only_a || graph.is_a[id])) {
+      expected[new_id[src]].emplace(new_id[dst], id);
+      num_edges += 1;
+    }
+  }
+  KATANA_LOG_ASSERT(sub->NumEdges() == num_edges);
+
+  std::vector<uint32_t> ids;
+  std::vector<uint64_t> values;
+  if (with_properties) {
+    ids = EdgeValues<uint32_t>(sub, "id");
+    values = NodeValues<uint64_t>(sub, "value");
+  }
+  const katana::GraphTopology& topo = sub->topology();
+  auto x_type = sub->GetNodeTypeManager().GetEntityTypeID("X");
+  auto a_type = sub->GetEdgeTypeManager().GetEntityTypeID("A");
+  for (uint32_t i = 0; i < node_set.size(); ++i) {
+    KATANA_LOG_ASSERT(sub->DoesNodeHaveType(i, x_type) == IsX(node_set[i]));
+    if (with_properties) {
+      KATANA_LOG_ASSERT(values[i] == uint64_t{10} * node_set[i]);
+    }
+    auto edges = topo.OutEdges(i);
+    KATANA_LOG_VASSERT(
+        static_cast<size_t>(std::distance(edges.begin(), edges.end())) ==
+            expected[i].size(),
+        "node {} (originally {}) has the wrong number of edges", i,
+        node_set[i]);
+    auto next = expected[i].begin();
+    for (auto e : edges) {
+      const auto& [dst, id] = *next++;
+      KATANA_LOG_ASSERT(topo.OutEdgeDst(e) == dst);
+      KATANA_LOG_ASSERT(
+          sub->DoesEdgeHaveTypeFromPropertyIndex(e, a_type) == graph.is_a[id]);
+      if (with_properties) {
+        KATANA_LOG_ASSERT(ids[e] == id);
+      }
+    }
+  }
+}
+
+/// The nodes reached breadth first from the seeds over hops out edges, the
+/// seeds first and then every hop sorted
+std::vector<uint32_t>
+ReferenceKHop(
+    const TestGraph& graph, const std::vector<uint32_t>& seeds, uint32_t hops,
+    bool only_x, bool only_a) {
+  std::vector<std::vector<uint32_t>> out(kNumNodes);
+  for (const auto& [src, dst, id] : graph.edges) {
+    if (!only_a || graph.is_a[id]) {
+      out[src].emplace_back(dst);
+    }
+  }
+  std::vector<bool> visited(kNumNodes, false);
+  std::vector<uint32_t> node_set;
+  for (uint32_t n : seeds) {
+    if ((!only_x || IsX(n)) && !visited[n]) {
+      visited[n] = true;
+      node_set.emplace_back(n);
+    }
+  }
+  size_t level_begin = 0;
+  for (uint32_t hop = 0; hop < hops; ++hop) {
+    size_t level_end = node_set.size();
+    for (size_t i = level_begin; i < level_end; ++i) {
+      for (uint32_t dst : out[node_set[i]]) {
+        if ((!only_x || IsX(dst)) && !visited[dst]) {
+          visited[dst] = true;
+          node_set.emplace_back(dst);
+        }
+      }
+    }
+    std::sort(node_set.begin() + level_end, node_set.end());
+    level_begin = level_end;
+  }
+  return node_set;
+}
+
+void
+TestExtraction() {
+  TestGraph graph = MakeGraph();
+  katana::PropertyGraph* pg = graph.pg.get();
+
+  // unsorted, with duplicates
+  std::vector<uint32_t> nodes;
+  std::mt19937 gen(29);
+  for (uint32_t i = 0; i < 60; ++i) {
+    nodes.emplace_back(gen() % kNumNodes);
+  }
+  std::vector<uint32_t> unique;
+  std::vector<uint32_t> unique_x;
+  for (uint32_t n : nodes) {
+    if (std::find(unique.begin(), unique.end(), n) == unique.end()) {
+      unique.emplace_back(n);
+      if (IsX(n)) {
+        unique_x.emplace_back(n);
+      }
+    }
+  }
+
+  auto res = SubGraphExtraction(pg, nodes);
+  KATANA_LOG_VASSERT(res, "extraction: {}", res.error());
+  CheckSubGraph(graph, res.value().get(), unique, false, false);
+
+  SubGraphProjection projection;
+  projection.node_properties = {"value"};
+  projection.edge_properties = {"id"};
+  katana::TxnContext txn_ctx;
+  auto projected_res = SubGraphExtraction(pg, nodes, projection, &txn_ctx);
+  KATANA_LOG_VASSERT(projected_res, "projection: {}", projected_res.error());
+  CheckSubGraph(graph, projected_res.value().get(), unique, false, true);
+
+  projection.node_types = {"X"};
+  projection.edge_types = {"A"};
+  auto typed_res = SubGraphExtraction(pg, nodes, projection, &txn_ctx);
+  KATANA_LOG_VASSERT(typed_res, "type filters: {}", typed_res.error());
+  CheckSubGraph(graph, typed_res.value().get(), unique_x, true, true);
+
+  // both edge types are every edge
+  projection.edge_types = {"A", "B"};
+  auto both_res = SubGraphExtraction(pg, nodes, projection, &txn_ctx);
+  KATANA_LOG_VASSERT(both_res, "both types: {}", both_res.error());
+  CheckSubGraph(graph, both_res.value().get(), unique_x, false, true);
+
+  KATANA_LOG_ASSERT(!SubGraphExtraction(pg, {0, kNumNodes}));
+  SubGraphProjection missing;
+  missing.node_types = {"missing"};
+  KATANA_LOG_ASSERT(!SubGraphExtraction(pg, nodes, missing, &txn_ctx));
+  missing.node_types = {};
+  missing.edge_properties = {"missing"};
+  KATANA_LOG_ASSERT(!SubGraphExtraction(pg, nodes, missing, &txn_ctx));
+}
+
+void
+TestKHop() {
+  TestGraph graph = MakeGraph();
+  katana::PropertyGraph* pg = graph.pg.get();
+  std::vector<uint32_t> seeds = {17, 4, 17, 150};
+
+  katana::TxnContext txn_ctx;
+  for (uint32_t hops : {0U, 1U, 2U, 3U}) {
+    for (auto [only_x, only_a] :
+         {std::make_pair(false, false), std::make_pair(true, true),
+          std::make_pair(false, true)}) {
+      SubGraphProjection projection;
+      projection.edge_properties = {"id"};
+      projection.node_properties = {"value"};
+      if (only_x) {
+        projection.node_types = {"X"};
+      }
+      if (only_a) {
+        projection.edge_types = {"A"};
+      }
+      auto res = SubGraphExtractionKHop(pg, seeds, hops, projection, &txn_ctx);
+      KATANA_LOG_VASSERT(res, "{} hops: {}", hops, res.error());
+      std::vector<uint32_t> expected =
+          ReferenceKHop(graph, seeds, hops, only_x, only_a);
+      CheckSubGraph(graph, res.value().get(), expected, only_a, true);
+    }
+  }
+
+  KATANA_LOG_ASSERT(!SubGraphExtractionKHop(pg, {kNumNodes}, 1, {}, &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestExtraction();
+  TestKHop();
+
+  return 0;
+}
@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/subgraph_matching/subgraph_matching.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+using katana::analytics::CountSubgraphMatches;
+using katana::analytics::FindSubgraphMatches;
+using katana::analytics::PatternEdge;
+using katana::analytics::SubgraphPattern;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+namespace {
+
+/// The type of the edges between two nodes of a small graph: 0 for none, 1
+/// for "A" and 2 for "B"
+using EdgeMatrix = std::vector<std::vector<uint8_t>>;
+
+bool
+IsX(uint32_t n) {
+  return n % 3 != 0;
+}
+
+EdgeMatrix
+MakeEdgeMatrix(uint32_t num_nodes, uint32_t percent) {
+  EdgeMatrix edges(num_nodes, std::vector<uint8_t>(num_nodes));
+  for (uint32_t a = 0; a < num_nodes; ++a) {
+    for (uint32_t b = a + 1; b < num_nodes; ++b) {
+      uint64_t r = katana::StatelessRandom(11, a * num_nodes + b);
+      if (r % 100 < percent) {
+        edges[a][b] = edges[b][a] = 1 + (r / 100) % 2;
+      }
+    }
+  }
+  return edges;
+}
+
+/// A symmetric graph of edges whose nodes have type "X" if IsX
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const EdgeMatrix& edges) {
+  uint32_t num_nodes = edges.size();
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(num_nodes);
+  std::vector<uint8_t> edge_types;
+  for (uint32_t a = 0; a < num_nodes; ++a) {
+    for (uint32_t b = 0; b < num_nodes; ++b) {
+      if (edges[a][b] != 0) {
+        builder.AddEdge(a, b);
+        edge_types.emplace_back(edges[a][b]);
+      }
+    }
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "making the graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto node_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("X", [](Node n) {
+        return static_cast<uint8_t>(IsX(n));
+      }));
+  KATANA_LOG_VASSERT(node_res, "adding node types: {}", node_res.error());
+  auto edge_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "A",
+          [&](Edge e) { return static_cast<uint8_t>(edge_types[e] == 1); }),
+      katana::PropertyGenerator("B", [&](Edge e) {
+        return static_cast<uint8_t>(edge_types[e] == 2);
+      }));
+  KATANA_LOG_VASSERT(edge_res, "adding edge types: {}", edge_res.error());
+  auto types_res = pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+  return pg;
+}
+
+/// Whether mapping the first map.size() pattern nodes with map keeps the
+/// edges and types between them in a graph of edges
+bool
+IsEmbedding(
+    const SubgraphPattern& pattern, const EdgeMatrix& edges,
+    const std::vector<uint32_t>& map) {
+  for (const PatternEdge& edge : pattern.edges) {
+    if (edge.src >= map.size() || edge.dst >= map.size()) {
+      continue;
+    }
+    uint8_t type = edges[map[edge.src]][map[edge.dst]];
+    if (type == 0 || (edge.type == "A" && type != 1) ||
+        (edge.type == "B" && type != 2)) {
+      return false;
+    }
+  }
+  for (uint32_t v = 0; v < pattern.node_types.size() && v < map.size(); ++v) {
+    if (pattern.node_types[v] == "X" && !IsX(map[v])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// The one to one maps of the pattern nodes to nodes of edges that keep the
+/// pattern, extending map
+uint64_t
+CountEmbeddings(
+    const SubgraphPattern& pattern, const EdgeMatrix& edges,
+    std::vector<uint32_t>* map) {
+  if (map->size() == pattern.num_nodes) {
+    return 1;
+  }
+  uint64_t count = 0;
+  for (uint32_t n = 0; n < edges.size(); ++n) {
+    if (std::find(map->begin(), map->end(), n) != map->end()) {
+      continue;
+    }
+    map->emplace_back(n);
+    if (IsEmbedding(pattern, edges, *map)) {
+      count += CountEmbeddings(pattern, edges, map);
+    }
+    map->pop_back();
+  }
+  return count;
+}
+
+/// The copies of pattern in edges: its embeddings over its automorphisms
+uint64_t
+ReferenceCount(const SubgraphPattern& pattern, const EdgeMatrix& edges) {
+  std::vector<uint32_t> map;
+  uint64_t embeddings = CountEmbeddings(pattern, edges, &map);
+
+  // the automorphisms are the embeddings of the pattern in itself
+  EdgeMatrix self(
+      pattern.num_nodes, std::vector<uint8_t>(pattern.num_nodes));
+  for (const PatternEdge& edge : pattern.edges) {
+    uint8_t type = edge.type == "A" ? 1 : edge.type == "B" ? 2 : 3;
+    self[edge.src][edge.dst] = type;
+    // the reverse of a typed edge is not a typed edge of the pattern
+    self[edge.dst][edge.src] = edge.type.empty() ? 3 : 4;
+  }
+  uint64_t automorphisms = 0;
+  std::vector<uint32_t> perm(pattern.num_nodes);
+  std::iota(perm.begin(), perm.end(), 0);
+  do {
+    bool keeps = true;
+    for (uint32_t a = 0; a < pattern.num_nodes && keeps; ++a) {
+      if (!pattern.node_types.empty() &&
+          pattern.node_types[a] != pattern.node_types[perm[a]]) {
+        keeps = false;
+      }
+      for (uint32_t b = 0; b < pattern.num_nodes && keeps; ++b) {
+        keeps = self[a][b] == self[perm[a]][perm[b]];
+      }
+    }
+    automorphisms += keeps;
+  } while (std::next_permutation(perm.begin(), perm.end()));
+  KATANA_LOG_ASSERT(embeddings % automorphisms == 0);
+  return embeddings / automorphisms;
+}
+
+uint64_t
+Count(katana::PropertyGraph* pg, const SubgraphPattern& pattern) {
+  auto res = CountSubgraphMatches(pg, pattern);
+  KATANA_LOG_VASSERT(res, "counting: {}", res.error());
+  return res.value();
+}
+
+/// Counts in the complete graph
+void
+TestCompleteGraph() {
+  auto pg = MakeGraph(MakeEdgeMatrix(7, 100));
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Clique(2)) == 21);
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Clique(3)) == 35);
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Clique(4)) == 35);
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Clique(7)) == 1);
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Clique(8)) == 0);
+  // 3 4-cycles on each 4 nodes, 12 5-cycles on each 5 nodes
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Cycle(4)) == 105);
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Cycle(5)) == 252);
+  // a center and 2 of the 6 other nodes
+  KATANA_LOG_ASSERT(Count(pg.get(), SubgraphPattern::Path(3)) == 105);
+}
+
+SubgraphPattern
+TypedMotif() {
+  // a triangle of an "A" and a "B" edge out of an "X" node, and a tail
+  SubgraphPattern pattern;
+  pattern.num_nodes = 4;
+  pattern.node_types = {"X", "", "", ""};
+  pattern.edges = {{0, 1, "A"}, {0, 2, "B"}, {1, 2, ""}, {2, 3, ""}};
+  return pattern;
+}
+
+void
+TestAgainstReference() {
+  EdgeMatrix edges = MakeEdgeMatrix(40, 25);
+  auto pg = MakeGraph(edges);
+
+  std::vector<SubgraphPattern> patterns{
+      SubgraphPattern::Clique(3), SubgraphPattern::Clique(4),
+      SubgraphPattern::Cycle(4),  SubgraphPattern::Path(4),
+      TypedMotif()};
+  SubgraphPattern star;
+  star.num_nodes = 4;
+  star.edges = {{0, 1, ""}, {0, 2, ""}, {0, 3, ""}};
+  patterns.emplace_back(star);
+  SubgraphPattern typed_cycle = SubgraphPattern::Cycle(4);
+  typed_cycle.node_types = {"X", "X", "X", "X"};
+  for (PatternEdge& edge : typed_cycle.edges) {
+    edge.type = "A";
+  }
+  patterns.emplace_back(typed_cycle);
+
+  for (const SubgraphPattern& pattern : patterns) {
+    uint64_t expected = ReferenceCount(pattern, edges);
+    uint64_t count = Count(pg.get(), pattern);
+    KATANA_LOG_VASSERT(
+        count == expected, "{} matches of a pattern rather than {}", count,
+        expected);
+
+    auto res = FindSubgraphMatches(pg.get(), pattern);
+    KATANA_LOG_VASSERT(res, "finding: {}", res.error());
+    const std::vector<uint32_t>& matches = res.value();
+    KATANA_LOG_ASSERT(matches.size() == count * pattern.num_nodes);
+    std::set<std::vector<uint32_t>> distinct;
+    for (size_t i = 0; i < matches.size(); i += pattern.num_nodes) {
+      std::vector<uint32_t> match(
+          matches.begin() + i, matches.begin() + i + pattern.num_nodes);
+      KATANA_LOG_ASSERT(IsEmbedding(pattern, edges, match));
+      distinct.emplace(match);
+    }
+    KATANA_LOG_ASSERT(distinct.size() == count);
+  }
+
+  auto triangles = katana::analytics::TriangleCount(pg.get());
+  KATANA_LOG_ASSERT(triangles);
+  KATANA_LOG_ASSERT(
+      triangles.value() == Count(pg.get(), SubgraphPattern::Clique(3)));
+
+  auto limited = FindSubgraphMatches(pg.get(), SubgraphPattern::Path(3), 10);
+  KATANA_LOG_ASSERT(limited && limited.value().size() == 30);
+}
+
+void
+TestInvalidPatterns() {
+  auto pg = MakeGraph(MakeEdgeMatrix(10, 50));
+  SubgraphPattern disconnected;
+  disconnected.num_nodes = 4;
+  disconnected.edges = {{0, 1, ""}, {2, 3, ""}};
+  KATANA_LOG_ASSERT(!CountSubgraphMatches(pg.get(), disconnected));
+
+  SubgraphPattern unknown_type = SubgraphPattern::Path(2);
+  unknown_type.edges[0].type = "C";
+  KATANA_LOG_ASSERT(!CountSubgraphMatches(pg.get(), unknown_type));
+
+  SubgraphPattern parallel = SubgraphPattern::Path(2);
+  parallel.edges.emplace_back(PatternEdge{1, 0, ""});
+  KATANA_LOG_ASSERT(!CountSubgraphMatches(pg.get(), parallel));
+
+  KATANA_LOG_ASSERT(!CountSubgraphMatches(
+      pg.get(), SubgraphPattern::Clique(SubgraphPattern::kMaxNodes + 1)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestCompleteGraph();
+  TestAgainstReference();
+  TestInvalidPatterns();
+
+  return 0;
+}
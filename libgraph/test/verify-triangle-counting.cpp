@@ -1,3 +1,9 @@
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
 #include "katana/SharedMemSys.h"
 #include "katana/TopologyGeneration.h"
 #include "katana/analytics/triangle_count/triangle_count.h"
@@ -9,7 +15,9 @@ RunTriCount(
   using Plan = katana::analytics::TriangleCountPlan;
   std::vector<Plan> plans{
       Plan::NodeIteration(Plan::kRelabel), Plan::EdgeIteration(Plan::kRelabel),
-      Plan::OrderedCount(Plan::kRelabel)};
+      Plan::OrderedCount(Plan::kRelabel),
+      // small graphs are counted exactly whatever the error asked for
+      Plan::Approximate(), Plan::Approximate(0)};
 
   for (const auto& p : plans) {
     katana::Result<size_t> num_tri =
@@ -22,6 +30,65 @@ RunTriCount(
   }
 }
 
+void
+TestLocalCounts() {
+  using Plan = katana::analytics::TriangleCountPlan;
+  // the triangles {0, 1, 2} and {1, 2, 3} share the edge 1 - 2, and 4 hangs
+  // off 3
+  auto pg = MakeTestGraph(
+      5, {{0, 1}, {0, 2}, {1, 2}, {1, 3}, {2, 3}, {3, 4}}, true);
+  katana::TxnContext txn_ctx;
+  auto res = katana::analytics::TriangleCountLocal(pg.get(), "local", &txn_ctx);
+  KATANA_LOG_VASSERT(res, "local counts: {}", res.error());
+  KATANA_LOG_ASSERT(res.value() == 2);
+  KATANA_LOG_ASSERT(
+      NodeValues<uint64_t>(pg.get(), "local") ==
+      (std::vector<uint64_t>{1, 2, 2, 1, 0}));
+
+  KATANA_LOG_ASSERT(!katana::analytics::TriangleCountLocal(
+      pg.get(), "ordered", &txn_ctx, Plan::OrderedCount()));
+  KATANA_LOG_ASSERT(
+      !katana::analytics::TriangleCount(pg.get(), Plan::Approximate(-1)));
+}
+
+void
+TestSampled() {
+  // disjoint 8-cliques, enough edges for the approximate plan to sample
+  // with more than one color
+  constexpr uint32_t kCliques = 40000;
+  constexpr uint32_t kCliqueSize = 8;
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t c = 0; c < kCliques; ++c) {
+    for (uint32_t a = 0; a < kCliqueSize; ++a) {
+      for (uint32_t b = a + 1; b < kCliqueSize; ++b) {
+        edges.emplace_back(c * kCliqueSize + a, c * kCliqueSize + b);
+      }
+    }
+  }
+  auto pg = MakeTestGraph(kCliques * kCliqueSize, edges, true);
+  // each clique has 8 choose 3 triangles
+  const double expected = kCliques * 56.0;
+
+  using Plan = katana::analytics::TriangleCountPlan;
+  auto exact_res =
+      katana::analytics::TriangleCount(pg.get(), Plan::Approximate(0));
+  KATANA_LOG_VASSERT(exact_res, "exact count: {}", exact_res.error());
+  KATANA_LOG_ASSERT(exact_res.value() == expected);
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::analytics::TriangleCountLocal(pg.get(), "local", &txn_ctx);
+  KATANA_LOG_VASSERT(res, "sampled count: {}", res.error());
+  KATANA_LOG_VASSERT(
+      std::fabs(res.value() - expected) < 0.05 * expected,
+      "estimated {} triangles, expected {}", res.value(), expected);
+  // every sampled triangle is counted at its three nodes
+  uint64_t local_sum = 0;
+  for (uint64_t count : NodeValues<uint64_t>(pg.get(), "local")) {
+    local_sum += count;
+  }
+  KATANA_LOG_ASSERT(local_sum == 3 * res.value());
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -52,5 +119,8 @@ main() {
   RunTriCount(katana::MakeTriangle(3), 9);
   RunTriCount(katana::MakeTriangle(4), 16);
 
+  TestLocalCounts();
+  TestSampled();
+
   return 0;
 }
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "TestSmallGraphs.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/k_truss/k_truss.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+using Edge = std::pair<uint32_t, uint32_t>;
+
+Edge
+Undirected(uint32_t a, uint32_t b) {
+  return {std::min(a, b), std::max(a, b)};
+}
+
+/// Trussness of every undirected edge by computing each k-truss in turn:
+/// remove edges in fewer than k - 2 triangles until none are left
+std::map<Edge, uint32_t>
+SerialTrussness(const Edges& edges) {
+  std::set<Edge> alive;
+  for (const auto& [a, b] : edges) {
+    if (a != b) {
+      alive.emplace(Undirected(a, b));
+    }
+  }
+  std::map<Edge, uint32_t> trussness;
+  for (const Edge& edge : alive) {
+    trussness[edge] = 2;
+  }
+  for (uint32_t k = 3; !alive.empty(); ++k) {
+    bool removed = true;
+    while (removed) {
+      removed = false;
+      std::map<uint32_t, std::set<uint32_t>> neighbors;
+      for (const auto& [a, b] : alive) {
+        neighbors[a].emplace(b);
+        neighbors[b].emplace(a);
+      }
+      for (auto it = alive.begin(); it != alive.end();) {
+        const auto& [a, b] = *it;
+        uint32_t support = 0;
+        for (uint32_t w : neighbors[a]) {
+          support += neighbors[b].count(w);
+        }
+        if (support + 2 < k) {
+          it = alive.erase(it);
+          removed = true;
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (const Edge& edge : alive) {
+      trussness[edge] = k;
+    }
+  }
+  return trussness;
+}
+
+void
+CheckTrussness(uint32_t num_nodes, const Edges& edges) {
+  auto pg = MakeTestGraph(num_nodes, edges, true);
+  katana::TxnContext txn_ctx;
+  auto res = TrussDecomposition(&txn_ctx, pg.get(), "trussness");
+  KATANA_LOG_VASSERT(res, "truss decomposition: {}", res.error());
+  auto valid_res = TrussDecompositionAssertValid(pg.get(), "trussness");
+  KATANA_LOG_VASSERT(valid_res, "invalid trussness: {}", valid_res.error());
+
+  std::map<Edge, uint32_t> expected = SerialTrussness(edges);
+  uint32_t max_trussness = 0;
+  for (const auto& [edge, t] : expected) {
+    max_trussness = std::max(max_trussness, t);
+  }
+  KATANA_LOG_ASSERT(res.value() == max_trussness);
+
+  // edge ids follow the order in which the test graph added the edges
+  std::vector<uint32_t> found = EdgeValues<uint32_t>(pg.get(), "trussness");
+  Edges ordered = OrderTestEdges(edges, true);
+  KATANA_LOG_ASSERT(found.size() == ordered.size());
+  for (size_t e = 0; e < ordered.size(); ++e) {
+    const auto& [a, b] = ordered[e];
+    uint32_t t = a == b ? 0 : expected.at(Undirected(a, b));
+    KATANA_LOG_VASSERT(
+        found[e] == t, "edge {} - {}: trussness {}, expected {}", a, b,
+        found[e], t);
+  }
+}
+
+void
+TestSmall() {
+  // a 4-clique {0, 1, 2, 3}, a triangle {3, 4, 5} sharing node 3, the edge
+  // 5 - 6, a self loop at 6 and a parallel copy of 4 - 5
+  Edges edges = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3},
+                 {3, 4}, {3, 5}, {4, 5}, {5, 6}, {6, 6}, {5, 4}};
+  std::map<Edge, uint32_t> expected = SerialTrussness(edges);
+  KATANA_LOG_ASSERT(expected.at({0, 1}) == 4 && expected.at({2, 3}) == 4);
+  KATANA_LOG_ASSERT(expected.at({3, 4}) == 3 && expected.at({4, 5}) == 3);
+  KATANA_LOG_ASSERT(expected.at({5, 6}) == 2);
+  CheckTrussness(7, edges);
+}
+
+void
+TestRandom() {
+  // dense enough for several levels of trussness
+  constexpr uint32_t kNumNodes = 120;
+  std::mt19937 gen(13);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::uniform_int_distribution<uint32_t> dense(0, 19);
+  Edges edges;
+  for (uint32_t e = 0; e < 600; ++e) {
+    edges.emplace_back(node(gen), node(gen));
+  }
+  for (uint32_t e = 0; e < 150; ++e) {
+    edges.emplace_back(dense(gen), dense(gen));
+  }
+  CheckTrussness(kNumNodes, edges);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestSmall();
+  TestRandom();
+
+  return 0;
+}
@@ -11,6 +11,7 @@ KATANA_EXPORT void InitReductions(pybind11::module& m);
 KATANA_EXPORT void InitEntityTypeManager(pybind11::module& m);
 KATANA_EXPORT void InitImportData(pybind11::module& m);
 KATANA_EXPORT void InitPropertyGraph(pybind11::module& m);
+KATANA_EXPORT void InitMetrics(pybind11::module& m);
 
 }  // namespace katana::python
 
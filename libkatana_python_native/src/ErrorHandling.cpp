@@ -39,6 +39,8 @@ GetPythonExceptionType(std::error_code code) {
     case katana::ErrorCode::BadVersion:
     case katana::ErrorCode::MpiError:
     case katana::ErrorCode::GSError:
+    case katana::ErrorCode::CudaError:
+    case katana::ErrorCode::Cancelled:
       break;
     }
   }
@@ -25,6 +25,8 @@ katana::python::InitImportData(py::module& m) {
       [](py::array_t<PropertyGraph::Edge> edge_indices,
          py::array_t<PropertyGraph::Node> edge_destinations)
           -> Result<std::shared_ptr<PropertyGraph>> {
+        // the arguments keep the arrays alive while copying them
+        py::gil_scoped_release release;
         return KATANA_CHECKED(katana::PropertyGraph::Make(GraphTopology(
             edge_indices.data(), edge_indices.size(), edge_destinations.data(),
             edge_destinations.size())));
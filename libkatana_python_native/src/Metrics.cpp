@@ -0,0 +1,34 @@
+#include "katana/Metrics.h"
+
+#include <pybind11/pybind11.h>
+
+#include "katana/python/ErrorHandling.h"
+#include "katana/python/PythonModuleInitializers.h"
+
+namespace py = pybind11;
+
+void
+katana::python::InitMetrics(py::module& m) {
+  m.def(
+      "export_metrics", [] { return katana::GetMetrics().ExportPrometheus(); },
+      R"""(
+      Return the live metrics of the process, e.g., cache hits, memory by manager, loop times and bytes read from
+      storage, in the Prometheus text format. A service can serve this as its ``/metrics`` endpoint.
+
+      :returns: the metrics as a `str`
+      )""");
+
+  m.def(
+      "push_metrics",
+      [](const std::string& url) -> Result<void> {
+        py::gil_scoped_release release;
+        return katana::PushMetrics(url);
+      },
+      py::arg("url"),
+      R"""(
+      Replace the metrics of a group of a Prometheus Pushgateway with those of this process.
+
+      :param url: The URL of the group, e.g., ``http://localhost:9091/metrics/job/katana``.
+      :type url: str
+      )""");
+}
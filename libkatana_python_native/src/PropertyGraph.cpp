@@ -6,11 +6,13 @@
 // not included by arrow/python headers.
 #include <arrow/python/numpy_convert.h>
 #include <arrow/python/numpy_to_arrow.h>
+#include <arrow/python/pyarrow.h>
 #include <arrow/python/python_to_arrow.h>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "katana/PropertyQuery.h"
 #include "katana/python/Conventions.h"
 #include "katana/python/CythonIntegration.h"
 #include "katana/python/EntityTypeManagerPython.h"
@@ -152,6 +154,116 @@ out_edge_dst(katana::PropertyGraph* pg, katana::GraphTopologyTypes::Edge e) {
   return *pg->OutEdgeDst(e);
 }
 
+/// A read only numpy array over the size elements at data, which holds on to
+/// owner, so the memory it points into lives as long as the array
+template <typename T>
+py::array
+ZeroCopyArray(const T* data, size_t size, const py::object& owner) {
+  py::array_t<T> array(size, data, owner);
+  array.attr("setflags")(py::arg("write") = false);
+  return std::move(array);
+}
+
+/// The CSR of the View of pg, (out_indices, out_dests), as numpy arrays over
+/// the memory of its topology. The arrays hold a View, so, like any view in
+/// use, the topology is neither evicted nor freed while they are alive, even
+/// if pg is.
+template <typename View>
+py::object
+TopologyArrays(katana::PropertyGraph* pg) {
+  std::unique_ptr<View> view;
+  {
+    py::gil_scoped_release release;
+    view = std::make_unique<View>(pg->BuildView<View>());
+  }
+  const View* v = view.get();
+  py::capsule owner(
+      view.release(), [](void* p) { delete static_cast<View*>(p); });
+  return py::make_tuple(
+      ZeroCopyArray(v->AdjData(), v->NumNodes(), owner),
+      ZeroCopyArray(v->DestData(), v->NumEdges(), owner));
+}
+
+/// A condition of a filter from Python, (property, op, value), with op a
+/// Python comparison operator, e.g., "<="
+using FilterCondition = std::tuple<std::string, std::string, py::object>;
+
+katana::Result<katana::CompareOp>
+ParseCompareOp(const std::string& op) {
+  if (op == "==") {
+    return katana::CompareOp::kEqual;
+  }
+  if (op == "!=") {
+    return katana::CompareOp::kNotEqual;
+  }
+  if (op == "<") {
+    return katana::CompareOp::kLess;
+  }
+  if (op == "<=") {
+    return katana::CompareOp::kLessEqual;
+  }
+  if (op == ">") {
+    return katana::CompareOp::kGreater;
+  }
+  if (op == ">=") {
+    return katana::CompareOp::kGreaterEqual;
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument, "unknown comparison: {}", op);
+}
+
+/// The filter of conditions and, if it is not null, type. Converting the
+/// values to arrow scalars needs the GIL.
+katana::Result<katana::PropertyFilter>
+MakePropertyFilter(
+    const std::vector<FilterCondition>& conditions,
+    const katana::python::EntityType* type) {
+  katana::PropertyFilter filter;
+  if (type != nullptr) {
+    filter.OfType(type->type_id);
+  }
+  py::object to_scalar = py::module::import("pyarrow").attr("scalar");
+  for (const auto& [property, op, value] : conditions) {
+    std::shared_ptr<arrow::Scalar> scalar = KATANA_CHECKED(
+        arrow::py::unwrap_scalar(to_scalar(value).ptr()));
+    filter.Where(property, KATANA_CHECKED(ParseCompareOp(op)), scalar);
+  }
+  return filter;
+}
+
+/// The ids of the entities of pg that satisfy conditions and have type, as a
+/// numpy array, loading the properties the conditions read
+template <typename Id, typename EnsureLoadedFn, typename FilterFn>
+katana::Result<py::object>
+FilterIds(
+    katana::PropertyGraph* pg, const std::vector<FilterCondition>& conditions,
+    const katana::python::EntityType* type, EnsureLoadedFn ensure_loaded,
+    FilterFn filter_fn) {
+  katana::PropertyFilter filter =
+      KATANA_CHECKED(MakePropertyFilter(conditions, type));
+  std::vector<Id> ids;
+  {
+    py::gil_scoped_release release;
+    for (const auto& condition : filter.conditions()) {
+      KATANA_CHECKED((pg->*ensure_loaded)(condition.property));
+    }
+    katana::DynamicBitset mask = KATANA_CHECKED(filter_fn(*pg, filter));
+    ids = mask.GetOffsets<Id>();
+  }
+  return py::object(py::array_t<Id>(ids.size(), ids.data()));
+}
+
+constexpr const char* kFilterDoc = R"""(
+      Return the ids of the {0}s that satisfy every condition and have type `type`, or a subtype of it, as a sorted
+      `numpy.ndarray`. The conditions are evaluated in native code by vectorized arrow kernels over whole property
+      columns, loading the properties they read if needed.
+
+      :param conditions: A sequence of `(property, op, value)` where op is one of "==", "!=", "<", "<=", ">" and
+          ">=". A null property never satisfies a condition on it.
+      :param type: An entity type of the {0}s to keep, or None for any.
+      :type type: Optional[EntityType]
+      )""";
+
 // Functions which define specific types or groups of types. These are all
 // called from InitPropertyGraph.
 
@@ -454,9 +566,46 @@ DefPropertyGraph(py::module& m) {
       py::call_guard<py::gil_scoped_release>());
 
   // GetEdgeDst(LocalEdgeID)-> NodeHandle - destination of an edge
-  cls.def("get_edge_dst", [](PropertyGraph& self, GraphTopologyTypes::Edge e) {
-    return self.BuildView<PropertyGraphViews::BiDirectional>().OutEdgeDst(e);
-  });
+  cls.def(
+      "get_edge_dst",
+      [](PropertyGraph& self, GraphTopologyTypes::Edge e) {
+        return self.BuildView<PropertyGraphViews::BiDirectional>().OutEdgeDst(
+            e);
+      },
+      py::call_guard<py::gil_scoped_release>());
+
+  cls.def(
+      "topology_arrays",
+      [](PropertyGraph& self, const std::string& view) -> Result<py::object> {
+        if (view == "default") {
+          return TopologyArrays<PropertyGraphViews::Default>(&self);
+        }
+        if (view == "transposed") {
+          return TopologyArrays<PropertyGraphViews::Transposed>(&self);
+        }
+        if (view == "edges_sorted_by_dest_id") {
+          return TopologyArrays<PropertyGraphViews::EdgesSortedByDestID>(
+              &self);
+        }
+        if (view == "nodes_sorted_by_degree_edges_sorted_by_dest_id") {
+          return TopologyArrays<
+              PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID>(
+              &self);
+        }
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "unknown topology view: {}", view);
+      },
+      py::arg("view") = "default",
+      R"""(
+      Return the compressed sparse row representation of a view of the topology, building the view if it is not
+      cached, as a pair of read only `numpy.ndarray`, `(out_indices, out_dests)`. `out_indices[n]` is the end of the
+      edges of node `n` in `out_dests`, the destinations of the edges. The arrays share the memory of the topology
+      without copying it and keep it alive, even after the graph is gone.
+
+      :param view: One of "default", "transposed" (the in-edges of each node), "edges_sorted_by_dest_id" and
+          "nodes_sorted_by_degree_edges_sorted_by_dest_id" (whose node ids are those of the sorted order).
+      :type view: str
+      )""");
 
   // In addition, all access views will support property and type queries:
 
@@ -465,21 +614,31 @@ DefPropertyGraph(py::module& m) {
       "get_node_property",
       [](PropertyGraph& self,
          const std::string& name) -> katana::Result<py::object> {
-        KATANA_CHECKED(self.EnsureNodePropertyLoaded(name));
-        return py::reinterpret_steal<py::object>(arrow::py::wrap_chunked_array(
-            KATANA_CHECKED(self.GetNodeProperty(name))));
-      },
-      py::call_guard<py::gil_scoped_release>());
+        std::shared_ptr<arrow::ChunkedArray> property;
+        {
+          py::gil_scoped_release release;
+          KATANA_CHECKED(self.EnsureNodePropertyLoaded(name));
+          property = KATANA_CHECKED(self.GetNodeProperty(name));
+        }
+        // wrapping makes a Python object, which needs the GIL
+        return py::reinterpret_steal<py::object>(
+            arrow::py::wrap_chunked_array(property));
+      });
   // GetEdgeProperty(string) -> PropertyArray - property array for all edges
   cls.def(
       "get_edge_property",
       [](PropertyGraph& self,
          const std::string& name) -> katana::Result<py::object> {
-        KATANA_CHECKED(self.EnsureEdgePropertyLoaded(name));
-        return py::reinterpret_steal<py::object>(arrow::py::wrap_chunked_array(
-            KATANA_CHECKED(self.GetEdgeProperty(name))));
-      },
-      py::call_guard<py::gil_scoped_release>());
+        std::shared_ptr<arrow::ChunkedArray> property;
+        {
+          py::gil_scoped_release release;
+          KATANA_CHECKED(self.EnsureEdgePropertyLoaded(name));
+          property = KATANA_CHECKED(self.GetEdgeProperty(name));
+        }
+        // wrapping makes a Python object, which needs the GIL
+        return py::reinterpret_steal<py::object>(
+            arrow::py::wrap_chunked_array(property));
+      });
 
   cls.def(
       "unload_node_property", &PropertyGraph::UnloadNodeProperty,
@@ -496,6 +655,37 @@ DefPropertyGraph(py::module& m) {
     return py::reinterpret_steal<py::object>(
         arrow::py::wrap_schema(self.loaded_edge_schema()));
   });
+  cls.def("full_node_schema", [](PropertyGraph& self) {
+    return py::reinterpret_steal<py::object>(
+        arrow::py::wrap_schema(self.full_node_schema()));
+  });
+  cls.def("full_edge_schema", [](PropertyGraph& self) {
+    return py::reinterpret_steal<py::object>(
+        arrow::py::wrap_schema(self.full_edge_schema()));
+  });
+
+  cls.def(
+      "filter_nodes",
+      [](PropertyGraph& self, const std::vector<FilterCondition>& conditions,
+         const EntityType* type) {
+        return FilterIds<GraphTopologyTypes::Node>(
+            &self, conditions, type, &PropertyGraph::EnsureNodePropertyLoaded,
+            &FilterNodes);
+      },
+      py::arg("conditions") = std::vector<FilterCondition>{},
+      py::arg("type") = py::none(),
+      fmt::format(kFilterDoc, "node").c_str());
+  cls.def(
+      "filter_edges",
+      [](PropertyGraph& self, const std::vector<FilterCondition>& conditions,
+         const EntityType* type) {
+        return FilterIds<GraphTopologyTypes::Edge>(
+            &self, conditions, type, &PropertyGraph::EnsureEdgePropertyLoaded,
+            &FilterEdges);
+      },
+      py::arg("conditions") = std::vector<FilterCondition>{},
+      py::arg("type") = py::none(),
+      fmt::format(kFilterDoc, "edge").c_str());
 
   // GetNodeEntityType(NodePropertyIndex)-> EntityTypeID - entity type for a node
   cls.def(
@@ -609,7 +799,8 @@ DefPropertyGraph(py::module& m) {
         }
         return self.GetNodeIndex(name);
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::return_value_policy::reference_internal,
+      py::call_guard<py::gil_scoped_release>());
   cls.def("has_edge_index", &PropertyGraph::HasEdgeIndex, py::arg("name"));
   cls.def(
       "get_edge_index",
@@ -621,7 +812,46 @@ DefPropertyGraph(py::module& m) {
         }
         return self.GetEdgeIndex(name);
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::return_value_policy::reference_internal,
+      py::call_guard<py::gil_scoped_release>());
+
+  cls.def(
+      "has_node_hash_index", &PropertyGraph::HasNodeHashIndex,
+      py::arg("name"));
+  cls.def(
+      "get_node_hash_index",
+      [](PropertyGraph& self, const std::string& name)
+          -> Result<std::shared_ptr<
+              katana::HashEntityIndex<katana::GraphTopology::Node>>> {
+        if (!self.HasNodeHashIndex(name)) {
+          KATANA_CHECKED(self.MakeNodeHashIndex(name));
+        }
+        return self.GetNodeHashIndex(name);
+      },
+      py::arg("name"), py::return_value_policy::reference_internal,
+      py::call_guard<py::gil_scoped_release>(),
+      R"""(
+      Return the hash index of the node property `name`, building it if there is none. A hash index only answers
+      equality lookups, e.g., of nodes by an external id, but does so in constant time and in batches.
+      )""");
+  cls.def(
+      "has_edge_hash_index", &PropertyGraph::HasEdgeHashIndex,
+      py::arg("name"));
+  cls.def(
+      "get_edge_hash_index",
+      [](PropertyGraph& self, const std::string& name)
+          -> Result<std::shared_ptr<
+              katana::HashEntityIndex<katana::GraphTopology::Edge>>> {
+        if (!self.HasEdgeHashIndex(name)) {
+          KATANA_CHECKED(self.MakeEdgeHashIndex(name));
+        }
+        return self.GetEdgeHashIndex(name);
+      },
+      py::arg("name"), py::return_value_policy::reference_internal,
+      py::call_guard<py::gil_scoped_release>(),
+      R"""(
+      Return the hash index of the edge property `name`, building it if there is none.
+      )""");
 
   cls.def("unload_topologies", &PropertyGraph::DropAllTopologies);
 
@@ -711,6 +941,107 @@ DefEntityIndex(py::module& m) {
       m, ("String" + cls_name).c_str());
 }
 
+constexpr const char* kFindBatchDoc = R"""(
+      Find the entity with the least id whose property is each of keys, in parallel.
+
+      :returns: a `numpy.ndarray` of the ids, with `not_found` for keys that no entity has
+      )""";
+
+template <typename node_or_edge>
+struct WrapPrimitiveHashEntityIndex {
+  py::class_<katana::HashEntityIndex<node_or_edge>> base_cls;
+
+  template <typename T>
+  py::object instantiate(py::module& m, const char* name) {
+    using Cls = katana::PrimitiveHashEntityIndex<node_or_edge, T>;
+    py::class_<Cls, std::shared_ptr<Cls>> cls(m, name, base_cls);
+
+    cls.template def("__getitem__", [](Cls& self, const T& v) {
+      auto it = self.Find(v);
+      if (it == self.end()) {
+        throw py::key_error(std::to_string(v));
+      }
+      return *it;
+    });
+    cls.template def("find_all", [](Cls& self, const T& v) {
+      auto [begin, end] = self.EqualRange(v);
+      return py::make_iterator(begin, end);
+    });
+    cls.template def(
+        "find_batch",
+        [](Cls& self,
+           py::array_t<T, py::array::c_style | py::array::forcecast> keys) {
+          py::array_t<node_or_edge> out(keys.size());
+          {
+            py::gil_scoped_release release;
+            self.FindBatch(keys.data(), keys.size(), out.mutable_data());
+          }
+          return out;
+        },
+        py::arg("keys"), kFindBatchDoc);
+
+    return std::move(cls);
+  }
+};
+
+template <typename node_or_edge>
+struct WrapStringHashEntityIndex {
+  py::class_<katana::HashEntityIndex<node_or_edge>> base_cls;
+
+  py::object instantiate(py::module& m, const char* name) {
+    using Cls = katana::StringHashEntityIndex<node_or_edge>;
+    py::class_<Cls, std::shared_ptr<Cls>> cls(m, name, base_cls);
+
+    cls.template def("__getitem__", [](Cls& self, const std::string& v) {
+      auto it = self.Find(v);
+      if (it == self.end()) {
+        throw py::key_error(v);
+      }
+      return *it;
+    });
+    cls.template def("find_all", [](Cls& self, const std::string& v) {
+      auto [begin, end] = self.EqualRange(v);
+      return py::make_iterator(begin, end);
+    });
+    cls.template def(
+        "find_batch",
+        [](Cls& self, const std::vector<std::string>& keys) {
+          py::array_t<node_or_edge> out(keys.size());
+          {
+            py::gil_scoped_release release;
+            std::vector<std::string_view> views(keys.begin(), keys.end());
+            self.FindBatch(views.data(), views.size(), out.mutable_data());
+          }
+          return out;
+        },
+        py::arg("keys"), kFindBatchDoc);
+
+    return std::move(cls);
+  }
+};
+
+template <typename node_or_edge>
+void
+DefHashEntityIndex(py::module& m) {
+  using HashEntityIndex = katana::HashEntityIndex<node_or_edge>;
+  constexpr bool is_node =
+      std::is_same_v<node_or_edge, katana::GraphTopologyTypes::Node>;
+  auto cls_name = std::string(is_node ? "Node" : "Edge") + "HashIndex";
+  py::class_<HashEntityIndex, std::shared_ptr<HashEntityIndex>> cls(
+      m, cls_name.c_str());
+
+  cls.template def("property_name", &HashEntityIndex::property_name);
+  cls.template def_property_readonly("num_keys", &HashEntityIndex::num_keys);
+  cls.attr("not_found") = HashEntityIndex::kNotFound;
+  katana::DefIterable(cls);
+
+  katana::InstantiateForTypes<uint8_t, int64_t, uint64_t>(
+      m, ("Primitive" + cls_name).c_str(),
+      WrapPrimitiveHashEntityIndex<node_or_edge>{cls});
+  WrapStringHashEntityIndex<node_or_edge>{cls}.instantiate(
+      m, ("String" + cls_name).c_str());
+}
+
 void
 DefTxnContext(py::module& m) {
   py::class_<katana::TxnContext> cls(m, "TxnContext");
@@ -747,6 +1078,8 @@ katana::python::InitPropertyGraph(py::module& m) {
   DefAccessors(m);
   DefEntityIndex<katana::GraphTopologyTypes::Node>(m);
   DefEntityIndex<katana::GraphTopologyTypes::Edge>(m);
+  DefHashEntityIndex<katana::GraphTopologyTypes::Node>(m);
+  DefHashEntityIndex<katana::GraphTopologyTypes::Edge>(m);
   DefTxnContext(m);
   DefRanges(m);
   DefPropertyGraph(m);
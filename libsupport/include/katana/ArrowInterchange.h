@@ -1,6 +1,10 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_ARROWINTERCHANGE_H_
 #define KATANA_LIBSUPPORT_KATANA_ARROWINTERCHANGE_H_
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <arrow/stl.h>
 #include <arrow/type_traits.h>
 
@@ -304,6 +308,67 @@ KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> TakeRows(
     const std::shared_ptr<arrow::Table>& original,
     const std::shared_ptr<arrow::BooleanArray> picker);
 
+/// The type of dictionary encoded string columns: int32 codes into a
+/// dictionary of large strings
+inline std::shared_ptr<arrow::DataType>
+DictionaryStringType() {
+  return arrow::dictionary(arrow::int32(), arrow::large_utf8());
+}
+
+/// Dictionary encode \p array, of strings or of dictionary encoded strings,
+/// as DictionaryStringType. Every chunk of the result shares one dictionary,
+/// so that a code means the same string in all of them.
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>>
+DictionaryEncodeStrings(const std::shared_ptr<arrow::ChunkedArray>& array);
+
+/// The values of \p array as one array: its chunk if it has one, and a copy
+/// of its chunks otherwise. Columns loaded from storage may keep the chunks
+/// they were decoded in (see ParquetReader::ReadOpts::combine_chunks), so
+/// code that needs the values of a property contiguous, like an index over
+/// them, gets them with this rather than with chunk(0).
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> ContiguousArray(
+    const arrow::ChunkedArray& array);
+
+/// ChunkIndex finds the chunk of a row of a chunked array, and the index of
+/// the row in the chunk, from the prefix offsets of the chunks.
+///
+/// Lookups take O(1): rows are bucketed by a power of two no longer than the
+/// chunks, save the last one, so every bucket starts in a known chunk and
+/// ends at most a chunk later. Chunks of very different lengths, which
+/// parquet row groups are not, make buckets span more chunks; those are
+/// searched by binary search.
+class KATANA_EXPORT ChunkIndex {
+public:
+  ChunkIndex() = default;
+  explicit ChunkIndex(const arrow::ChunkedArray& array);
+
+  /// \returns the chunk of row i and the index of row i in the chunk
+  std::pair<int, int64_t> Locate(int64_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i >= 0 && i < length());
+    size_t bucket = i >> shift_;
+    const int64_t* first = offsets_.data() + buckets_[bucket] + 1;
+    const int64_t* last = offsets_.data() + buckets_[bucket + 1] + 1;
+    if (*first <= i) {
+      first = std::upper_bound(first + 1, last + 1, i);
+    }
+    int chunk = first - offsets_.data() - 1;
+    return std::make_pair(chunk, i - offsets_[chunk]);
+  }
+
+  int num_chunks() const { return offsets_.size() - 1; }
+
+  int64_t length() const { return offsets_.back(); }
+
+  /// The first row of each chunk followed by the number of rows
+  const std::vector<int64_t>& offsets() const { return offsets_; }
+
+private:
+  std::vector<int64_t> offsets_{0};
+  /// The chunk of the first row of each bucket, and of the number of rows
+  std::vector<int> buckets_;
+  int shift_{0};
+};
+
 }  // namespace katana
 
 #endif
@@ -1,8 +1,9 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_CACHE_H_
 #define KATANA_LIBSUPPORT_KATANA_CACHE_H_
 
-// This is single threaded only, it is not intended to store large objects,
-// but rather metadata (e.g., a shared_ptr to a property column).
+// Cache is single threaded only, it is not intended to store large objects,
+// but rather metadata (e.g., a shared_ptr to a property column). ShardedCache
+// is the thread safe version.
 
 // The problem witchel had implementing a multi-threaded version using
 // parallel-hashmap is a lock ordering problem.  parallel-hashmap 1.33 allows
@@ -11,17 +12,26 @@
 // lock ordering is parallel-hashmap write lock, then list lock.  But without a way to
 // execute insert code with the parallel-hashmap write lock held, it seemed like there
 // would be some form of race condition.
+//
+// ShardedCache avoids the problem by never holding more than one lock: each
+// shard is a Cache with its own mutex, and keeping the whole cache within its
+// capacity only ever locks one shard at a time.
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <arrow/table.h>
 
 #include "katana/Logging.h"
+#include "katana/Metrics.h"
 #include "katana/ProgressTracer.h"
 #include "katana/URI.h"
 
@@ -50,6 +60,13 @@ struct CacheStats {
            total_count();
   }
   uint64_t total_count() const { return insert_count + get_count; }
+  CacheStats& operator+=(const CacheStats& other) {
+    get_count += other.get_count;
+    get_hit_count += other.get_hit_count;
+    insert_count += other.insert_count;
+    insert_hit_count += other.insert_hit_count;
+    return *this;
+  }
   void Log() const {
     katana::GetTracer().GetActiveSpan().Log(
         "cache stats",
@@ -63,6 +80,33 @@ struct CacheStats {
         });
   }
 
+  /// Set the metrics of the cache named cache, e.g.,
+  /// katana_cache_gets_total{cache="property"}, to these stats
+  void Publish(const std::string& cache) const {
+    MetricsRegistry& metrics = GetMetrics();
+    MetricLabels labels{{"cache", cache}};
+    metrics.Counter("katana_cache_gets_total", "Lookups in a cache", labels)
+        .Set(get_count);
+    metrics
+        .Counter(
+            "katana_cache_get_hits_total", "Lookups that found their entry",
+            labels)
+        .Set(get_hit_count);
+    metrics
+        .Counter("katana_cache_inserts_total", "Insertions in a cache", labels)
+        .Set(insert_count);
+    metrics
+        .Counter(
+            "katana_cache_insert_hits_total",
+            "Insertions of entries that were already cached", labels)
+        .Set(insert_hit_count);
+    metrics
+        .Gauge(
+            "katana_cache_hit_ratio",
+            "Hits over lookups and insertions of a cache", labels)
+        .Set(total_hit_percentage() / 100);
+  }
+
   uint64_t get_count{0ULL};
   uint64_t get_hit_count{0ULL};
   uint64_t insert_count{0ULL};
@@ -287,10 +331,171 @@ private:
   std::function<size_t(const Value& value)> value_to_bytes_;
 };
 
+/// A thread safe Cache. Keys are spread by hash over shards, each a Cache
+/// behind its own mutex, so threads only contend when their keys share a
+/// shard. The capacity (in number of elements or size of elements) is a
+/// budget for the whole cache. When an insert goes over it, least recently
+/// used entries are evicted from the shards in turn, so replacement is LRU
+/// within each shard rather than across the whole cache.
+template <typename Value>
+class KATANA_EXPORT ShardedCache {
+  using Key = katana::Uri;
+
+  struct Shard {
+    template <typename... Args>
+    Shard(Args&&... args) : cache(std::forward<Args>(args)...) {}
+
+    std::mutex mutex;
+    Cache<Value> cache;
+  };
+
+public:
+  static constexpr size_t kDefaultNumShards = 16;
+
+  /// Construct an LRU cache that has a fixed number of entries.
+  ShardedCache(size_t capacity, size_t num_shards = kDefaultNumShards)
+      : capacity_(capacity) {
+    KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    // every shard counts entries as bytes of size one so that they add up
+    MakeShards(num_shards, capacity_, [](const Value&) { return size_t{1}; });
+  }
+  /// Construct an LRU cache that holds fixed number of bytes.
+  ShardedCache(
+      size_t capacity,  // bytes of entries
+      std::function<size_t(const Value& value)> value_to_bytes,
+      size_t num_shards = kDefaultNumShards)
+      : capacity_(capacity) {
+    KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    MakeShards(num_shards, capacity_, std::move(value_to_bytes));
+  }
+  /// Construct an LRU cache that holds whatever we put in it and only evicts
+  /// when we explicitly tell it to do so.
+  ShardedCache(
+      std::function<size_t(const Value& value)> value_to_bytes,
+      size_t num_shards = kDefaultNumShards)
+      : capacity_(std::numeric_limits<size_t>::max()) {
+    KATANA_LOG_VASSERT(num_shards > 0, "cache requires shards");
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>(value_to_bytes));
+    }
+  }
+
+  /// Returns the size of the cache (in number of elements or size of
+  /// elements, depending on the replacement policy).
+  size_t size() const { return total_.load(std::memory_order_relaxed); }
+
+  /// Returns the capacity (in number of elements or size of elements,
+  /// depending on the replacement policy).
+  size_t capacity() const { return capacity_; }
+
+  size_t num_shards() const { return shards_.size(); }
+
+  /// Clear cache
+  void clear() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      total_ -= shard->cache.size();
+      shard->cache.clear();
+    }
+  }
+
+  /// Returns true if the cache is empty
+  bool empty() const { return size() == 0; }
+
+  /// Try to reclaim \p goal bytes (#entries), evicting least recently used
+  /// entries of each shard in turn to do it. Returns the number of bytes
+  /// actually evicted.
+  size_t Reclaim(size_t goal) {
+    size_t reclaimed{};
+    for (size_t empty_shards = 0;
+         reclaimed < goal && empty_shards < shards_.size();) {
+      Shard& shard = *shards_[next_victim_++ % shards_.size()];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (shard.cache.empty()) {
+        ++empty_shards;
+        continue;
+      }
+      empty_shards = 0;
+      size_t bytes = shard.cache.Reclaim(1);
+      total_ -= bytes;
+      reclaimed += bytes;
+    }
+    return reclaimed;
+  }
+
+  bool Contains(const Key& key) {
+    Shard& shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Contains(key);
+  }
+
+  void Insert(const Key& key, const Value& value) {
+    Shard& shard = ShardOf(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      size_t before = shard.cache.size();
+      shard.cache.Insert(key, value);
+      // may wrap around if the shard shrank, which the unsigned add undoes
+      total_ += shard.cache.size() - before;
+    }
+    size_t total = size();
+    if (total > capacity_) {
+      Reclaim(total - capacity_);
+    }
+  }
+
+  std::optional<Value> Get(const Key& key) {
+    Shard& shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Get(key);
+  }
+
+  std::optional<Value> GetAndEvict(const Key& key) {
+    Shard& shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size_t before = shard.cache.size();
+    auto ret = shard.cache.GetAndEvict(key);
+    total_ -= before - shard.cache.size();
+    return ret;
+  }
+
+  /// Hit statistics summed over all shards
+  CacheStats GetStats() const {
+    CacheStats stats;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      stats += shard->cache.GetStats();
+    }
+    return stats;
+  }
+
+private:
+  void MakeShards(
+      size_t num_shards, size_t capacity,
+      std::function<size_t(const Value& value)> value_to_bytes) {
+    KATANA_LOG_VASSERT(num_shards > 0, "cache requires shards");
+    // Shards hold up to the whole capacity, so that they reject the same
+    // objects that are too big as a Cache would; Insert keeps the total
+    // within capacity.
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>(capacity, value_to_bytes));
+    }
+  }
+
+  Shard& ShardOf(const Key& key) {
+    return *shards_[Key::Hash()(key) % shards_.size()];
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  size_t capacity_;
+  std::atomic<size_t> total_{0};
+  std::atomic<size_t> next_victim_{0};
+};
+
 // The property cache contains properties NOT in use by the graph and never contains a
 // property that IS in use by the graph.  When a graph unloads a property, it goes
 // into the cache, and when it loads a property it (hopefully) comes from the cache.
-using PropertyCache = Cache<std::shared_ptr<arrow::Table>>;
+using PropertyCache = ShardedCache<std::shared_ptr<arrow::Table>>;
 
 }  // namespace katana
 
@@ -2,7 +2,12 @@
 #define KATANA_LIBSUPPORT_KATANA_COMMBACKEND_H_
 
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -10,6 +15,15 @@
 
 namespace katana {
 
+/// The tasks of a distributed computation and the ways they communicate.
+///
+/// Collectives (Barrier, Broadcast, AllReduceSum, AllGatherBytes,
+/// AllToAllBytes and the typed templates over them) must be called by every
+/// task in the same order. Backends implement at least Barrier and
+/// Broadcast; the other collectives have default implementations over
+/// Broadcast that backends with native ones (e.g., MPI_Alltoallv) should
+/// override. Messages sent with Send between two tasks arrive in order per
+/// tag.
 class KATANA_EXPORT CommBackend {
 public:
   CommBackend() = default;
@@ -28,6 +42,73 @@ public:
       uint32_t root, const std::string& val, uint64_t max_size) = 0;
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
+  /// Element-wise sum of vals over all tasks, which must pass vectors of the
+  /// same size. The default broadcasts the values of each task in turn;
+  /// backends with a native all-reduce (e.g., MPI_Allreduce) should use it.
+  virtual std::vector<uint64_t> AllReduceSum(const std::vector<uint64_t>& vals);
+  /// The val of every task, by rank
+  virtual std::vector<std::string> AllGatherBytes(const std::string& val);
+  /// Sends to_each[r] to task r, which must pass Num buffers, and returns the
+  /// buffers the other tasks sent to this one, by rank
+  virtual std::vector<std::string> AllToAllBytes(
+      const std::vector<std::string>& to_each);
+
+  /// Sends msg to task dest without waiting for it to be received; tags
+  /// must be below kMaxTag. Backends without point-to-point messages fail.
+  virtual void Send(uint32_t dest, uint32_t tag, std::string msg);
+  /// Waits for the next message from task src with tag
+  virtual std::string Receive(uint32_t src, uint32_t tag);
+  /// Waits until the messages passed to Send so far have left this task
+  virtual void WaitForSends() {}
+
+  /// Element-wise reduction with op of vals over all tasks, which must pass
+  /// vectors of the same size
+  template <typename T, typename Op>
+  std::vector<T> AllReduce(const std::vector<T>& vals, Op op) {
+    std::vector<std::vector<T>> all = AllGather(vals);
+    std::vector<T> ret = all[0];
+    for (uint32_t r = 1; r < Num; ++r) {
+      KATANA_LOG_ASSERT(all[r].size() == ret.size());
+      for (size_t i = 0; i < ret.size(); ++i) {
+        ret[i] = op(ret[i], all[r][i]);
+      }
+    }
+    return ret;
+  }
+
+  /// The vals of every task, by rank
+  template <typename T>
+  std::vector<std::vector<T>> AllGather(const std::vector<T>& vals) {
+    std::vector<std::string> all = AllGatherBytes(ToBytes(vals));
+    std::vector<std::vector<T>> ret;
+    ret.reserve(all.size());
+    for (const std::string& bytes : all) {
+      ret.emplace_back(FromBytes<T>(bytes));
+    }
+    return ret;
+  }
+
+  /// Sends to_each[r] to task r and returns what the other tasks sent to
+  /// this one, by rank
+  template <typename T>
+  std::vector<std::vector<T>> AllToAll(
+      const std::vector<std::vector<T>>& to_each) {
+    std::vector<std::string> bytes;
+    bytes.reserve(to_each.size());
+    for (const auto& vals : to_each) {
+      bytes.emplace_back(ToBytes(vals));
+    }
+    std::vector<std::string> all = AllToAllBytes(bytes);
+    std::vector<std::vector<T>> ret;
+    ret.reserve(all.size());
+    for (const std::string& b : all) {
+      ret.emplace_back(FromBytes<T>(b));
+    }
+    return ret;
+  }
+
+  /// Tags at or above this are reserved for backends
+  static constexpr uint32_t kMaxTag = UINT32_C(1) << 30;
 
   // TODO(thunt): Num and ID were chosen because of NetworkInterface. Changing
   // them is very disruptive so I'll defer for a time in the future where we're
@@ -39,6 +120,23 @@ public:
   uint32_t Rank{0};
   /// The local rank of this task (process ordinal number within within its machine)
   uint32_t LocalRank{0};
+
+private:
+  template <typename T>
+  static std::string ToBytes(const std::vector<T>& vals) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return std::string(
+        reinterpret_cast<const char*>(vals.data()), vals.size() * sizeof(T));
+  }
+
+  template <typename T>
+  static std::vector<T> FromBytes(const std::string& bytes) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    KATANA_LOG_ASSERT(bytes.size() % sizeof(T) == 0);
+    std::vector<T> vals(bytes.size() / sizeof(T));
+    std::memcpy(vals.data(), bytes.data(), bytes.size());
+    return vals;
+  }
 };
 
 class KATANA_EXPORT NullCommBackend : public CommBackend {
@@ -53,6 +151,24 @@ public:
       uint64_t max_size) override {
     return val.substr(0, max_size);
   }
+  std::vector<uint64_t> AllReduceSum(
+      const std::vector<uint64_t>& vals) override {
+    return vals;
+  }
+  std::vector<std::string> AllGatherBytes(const std::string& val) override {
+    return {val};
+  }
+  std::vector<std::string> AllToAllBytes(
+      const std::vector<std::string>& to_each) override {
+    KATANA_LOG_ASSERT(to_each.size() == 1);
+    return to_each;
+  }
+  /// Messages only go to this task itself
+  void Send(uint32_t dest, uint32_t tag, std::string msg) override;
+  std::string Receive(uint32_t src, uint32_t tag) override;
+
+private:
+  std::map<uint32_t, std::deque<std::string>> messages_;
 };
 
 }  // namespace katana
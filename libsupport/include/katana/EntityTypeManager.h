@@ -2,15 +2,18 @@
 
 #include <bitset>
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include <arrow/array/array_primitive.h>
 #include <arrow/table.h>
 
+#include "katana/AtomicWrapper.h"
 #include "katana/DynamicBitsetSlow.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -47,6 +50,9 @@ static constexpr EntityTypeID kInvalidEntityType =
 static constexpr size_t kDefaultSetOfEntityTypeIDsSize = 256;
 /// The maximum size of the dynamically sized SetOfEntityTypeIDs
 static constexpr size_t kMaxSetOfEntityTypeIDsSize = kInvalidEntityType + 1;
+/// The most entity types for which IsSubtypeOf is answered from a flattened
+/// bitmap of all pairs of types, which takes 2 MB at this size
+static constexpr size_t kMaxFlattenedEntityTypes = 4096;
 
 /// A dynamically sized set of EntityTypeIDs
 using SetOfEntityTypeIDs = DynamicBitsetSlow;
@@ -114,6 +120,7 @@ public:
     for (size_t i = 0; i < num_entity_types; i++) {
       entity_type_id_to_atomic_entity_type_ids_.at(i).resize(set_size);
     }
+    IndexEntityTypes();
   }
 
   EntityTypeManager(
@@ -142,6 +149,7 @@ public:
     //Must ensure all sets are at least big enough to fit all EntityTypeIDs
     size_t num_entity_types = entity_type_id_to_atomic_entity_type_ids_.size();
     ResizeSetOfEntityTypeIDsMaps(num_entity_types - 1);
+    IndexEntityTypes();
   }
 
   /// This function can be used to convert "old style" graphs (storage format 1,
@@ -277,8 +285,7 @@ public:
   /// this function is required to be deterministic because it adds new entity
   /// type ids
   ///
-  /// \warning This operation is currently `O(number of types)` due to a linear
-  ///     search. This can be fixed with a space--time trade-off if needed.
+  /// The type is looked up by hashing the atomic types in \p type_id_set.
   ///
   /// \returns the EntityTypeID of the intersection type.
   Result<EntityTypeID> GetOrAddNonAtomicEntityType(
@@ -286,13 +293,26 @@ public:
 
   /// Get the intersection of the types passed in.
   ///
-  /// \warning This operation is currently `O(number of types)` due to a linear
-  ///     search. This can be fixed with a space--time trade-off if needed.
+  /// The type is looked up by hashing the atomic types in \p type_id_set.
   ///
   /// \returns the EntityTypeID of the intersection type.
   Result<EntityTypeID> GetNonAtomicEntityType(
       const SetOfEntityTypeIDs& type_id_set) const;
 
+  /// \returns the EntityTypeID of the intersection of the atomic types
+  /// \p atomic_type_ids, which must be sorted and without repeats, or
+  /// kInvalidEntityType if there is none. This is a hash lookup that does not
+  /// build a SetOfEntityTypeIDs, and it may be called from several threads at
+  /// once as long as no type is added meanwhile.
+  EntityTypeID FindEntityType(
+      const std::vector<EntityTypeID>& atomic_type_ids) const {
+    auto found = atomic_type_ids_to_entity_type_id_.find(atomic_type_ids);
+    if (found == atomic_type_ids_to_entity_type_id_.end()) {
+      return kInvalidEntityType;
+    }
+    return found->second;
+  }
+
   /// \returns the number of atomic types
   size_t GetNumAtomicTypes() const {
     return atomic_entity_type_id_to_type_name_.size();
@@ -434,16 +454,26 @@ public:
   /// \returns true iff the type \p sub_type is a
   /// sub-type of the type \p super_type
   /// (assumes that the sub_type and super_type EntityTypeIDs exists)
+  ///
+  /// With up to kMaxFlattenedEntityTypes types, this is a bit test in a
+  /// bitmap of all pairs of types, which is built on first use after a type
+  /// is added; otherwise it compares the sets of atomic types word by word.
   bool IsSubtypeOf(EntityTypeID sub_type, EntityTypeID super_type) const {
-    const auto& super_atomic_types = GetAtomicSubtypes(super_type);
-    const auto& sub_atomic_types = GetAtomicSubtypes(sub_type);
+    if (const SubtypeMatrix* matrix = GetSubtypeMatrix(); matrix != nullptr) {
+      return matrix->Test(sub_type, super_type);
+    }
     // return true if sub_atomic_types is a subset of super_atomic_types
-    SetOfEntityTypeIDs res;
-    res.resize(SetOfEntityTypeIDsSize_);
-    res.bitwise_and(sub_atomic_types, super_atomic_types);
-    return (res == sub_atomic_types);
+    return IsSubsetOf(
+        GetAtomicSubtypes(sub_type), GetAtomicSubtypes(super_type));
   }
 
+  /// \returns the set of entity types T for which
+  /// IsSubtypeOf(\p entity_type_id, T), i.e., the most specific types of the
+  /// entities that have the type \p entity_type_id; testing the type of an
+  /// entity against it is a single bit test
+  /// (assumes that the entity type exists)
+  SetOfEntityTypeIDs GetEntityTypesWithType(EntityTypeID entity_type_id) const;
+
   const EntityTypeIDToSetOfEntityTypeIDsMap&
   GetEntityTypeIDToAtomicEntityTypeIDs() const {
     return entity_type_id_to_atomic_entity_type_ids_;
@@ -507,6 +537,42 @@ private:
   Result<EntityTypeID> AddNonAtomicEntityType(
       const SetOfEntityTypeIDs& type_id_set);
 
+  /// Bit super of row sub is IsSubtypeOf(sub, super)
+  struct SubtypeMatrix {
+    size_t words_per_row;
+    std::vector<uint64_t> bits;
+
+    bool Test(EntityTypeID sub_type, EntityTypeID super_type) const {
+      uint64_t word = bits[sub_type * words_per_row + super_type / 64];
+      return (word >> (super_type % 64)) & 1;
+    }
+  };
+
+  /// \returns the subtype matrix, building it if needed, or nullptr if there
+  /// are more than kMaxFlattenedEntityTypes types
+  const SubtypeMatrix* GetSubtypeMatrix() const {
+    const SubtypeMatrix* matrix =
+        subtype_matrix_ptr_.load(std::memory_order_acquire);
+    return matrix != nullptr ? matrix : BuildSubtypeMatrix();
+  }
+
+  const SubtypeMatrix* BuildSubtypeMatrix() const;
+
+  struct AtomicTypeIDsHash {
+    size_t operator()(const std::vector<EntityTypeID>& ids) const noexcept;
+  };
+
+  /// \returns the sorted ids of the types in \p type_id_set
+  static std::vector<EntityTypeID> ToAtomicTypeIDs(
+      const SetOfEntityTypeIDs& type_id_set);
+
+  /// Rebuilds atomic_type_ids_to_entity_type_id_ from
+  /// entity_type_id_to_atomic_entity_type_ids_
+  void IndexEntityTypes();
+
+  static bool IsSubsetOf(
+      const SetOfEntityTypeIDs& sub, const SetOfEntityTypeIDs& super);
+
   static Result<TypeProperties> DoAssignEntityTypeIDsFromProperties(
       const std::shared_ptr<arrow::Table>& properties,
       EntityTypeManager* entity_type_manager);
@@ -550,6 +616,20 @@ private:
   /// ex: atomic_entity_type_id_to_entity_type_ids_[atomic_id][atomic_id] == 1
   /// but atomic_entity_type_id_to_entity_type_ids_[non_atomic_id][non_atomic_id] == 0
   EntityTypeIDToSetOfEntityTypeIDsMap atomic_entity_type_id_to_entity_type_ids_;
+
+  /// A map from the sorted atomic types of every entity type to its
+  /// EntityTypeID, the smallest one if several have the same atomic types:
+  /// derived from entity_type_id_to_atomic_entity_type_ids_
+  std::unordered_map<std::vector<EntityTypeID>, EntityTypeID, AtomicTypeIDsHash>
+      atomic_type_ids_to_entity_type_id_;
+
+  /// Built by BuildSubtypeMatrix, possibly from several threads at once, and
+  /// dropped whenever a type is added
+  mutable std::shared_ptr<const SubtypeMatrix> subtype_matrix_;
+  /// subtype_matrix_.get(), which is read without taking the lock of an
+  /// atomic shared_ptr once the matrix is built
+  mutable katana::CopyableAtomic<const SubtypeMatrix*> subtype_matrix_ptr_{
+      nullptr};
 };
 
 }  // namespace katana
@@ -77,6 +77,8 @@ enum class ErrorCode {
   MpiError,
   BadVersion,
   GSError,
+  CudaError,
+  Cancelled,
 };
 
 KATANA_EXPORT ErrorCode ArrowToKatana(arrow::StatusCode);
@@ -136,6 +138,10 @@ public:
       return "some MPI process reported an error";
     case ErrorCode::GSError:
       return "Google storage error";
+    case ErrorCode::CudaError:
+      return "CUDA error";
+    case ErrorCode::Cancelled:
+      return "cancelled";
     default:
       return "unknown error";
     }
@@ -170,7 +176,10 @@ public:
     case ErrorCode::AzureError:
     case ErrorCode::MpiError:
     case ErrorCode::GSError:
+    case ErrorCode::CudaError:
       return make_error_condition(std::errc::io_error);
+    case ErrorCode::Cancelled:
+      return make_error_condition(std::errc::operation_canceled);
     default:
       return std::error_condition(c, *this);
     }
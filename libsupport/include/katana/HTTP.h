@@ -12,6 +12,13 @@ KATANA_EXPORT Result<void> HttpInit();
 KATANA_EXPORT Result<void> HttpGet(
     const std::string& url, std::vector<char>* response);
 
+/// Perform an HTTP get request of the size bytes of url starting at begin
+/// and fill buffer, which holds size bytes, with them. Requests reuse
+/// connections kept alive by earlier ones, so issuing the ranges of a large
+/// object concurrently downloads it over several streams.
+KATANA_EXPORT Result<void> HttpGetRange(
+    const std::string& url, uint64_t begin, uint64_t size, uint8_t* buffer);
+
 /// Perform an HTTP post request on url and send the contents of buffer
 KATANA_EXPORT Result<void> HttpPost(
     const std::string& url, const std::string& data,
@@ -56,6 +56,16 @@
 /// library, but this should be avoided because it is not compliant with the
 /// C++20 STL interface and does not support traditional ostream usage.
 ///
+/// Messages below the level of the environment variable KATANA_LOG_LEVEL are
+/// dropped before they are formatted. By default, messages are written on the
+/// calling thread under a lock. With asynchronous logging, enabled by the
+/// environment variable KATANA_LOG_ASYNC=1 or by SetAsyncLogging, each thread
+/// only copies its formatted messages to a buffer of its own, and a
+/// background thread writes them out. Messages of one thread keep their
+/// order, but messages of different threads may be interleaved differently
+/// than they were logged. Error messages and AbortApplication flush the
+/// buffers.
+///
 /// There is a bug in fmt<8 with fmt::join(format_string, args...) when
 /// elements of args only overload operator<<. This manifests as a compilation
 /// error. To work around this, use katana::Join instead of fmt::join.
@@ -91,9 +101,23 @@ enum class LogLevel {
 
 namespace internal {
 
+/// Whether messages at level are logged rather than dropped
+KATANA_EXPORT bool IsLogged(LogLevel level);
+
 KATANA_EXPORT void LogString(LogLevel level, const std::string& s);
 
-}
+/// Write text as is to standard error or standard output, through the
+/// buffers of asynchronous logging when it is enabled
+KATANA_EXPORT void WriteOutput(bool to_stderr, const std::string& text);
+
+}  // namespace internal
+
+/// Write log messages from per thread buffers on a background thread rather
+/// than on the calling thread. See Logging.h.
+KATANA_EXPORT void SetAsyncLogging(bool enabled);
+
+/// Write out the messages buffered by asynchronous logging
+KATANA_EXPORT void FlushLog();
 
 /// Log at a specific LogLevel.
 ///
@@ -104,6 +128,9 @@ KATANA_EXPORT void LogString(LogLevel level, const std::string& s);
 template <typename F, typename... Args>
 void
 Log(LogLevel level, F fmt_string, Args&&... args) {
+  if (!internal::IsLogged(level)) {
+    return;
+  }
   std::string s = fmt::format(fmt_string, std::forward<Args>(args)...);
   internal::LogString(level, s);
 }
@@ -121,6 +148,9 @@ void
 LogLine(
     LogLevel level, const char* file_name, int line_no, F fmt_string,
     Args&&... args) {
+  if (!internal::IsLogged(level)) {
+    return;
+  }
   std::string s = fmt::format(fmt_string, std::forward<Args>(args)...);
   std::string with_line = fmt::format("{}:{}: {}", file_name, line_no, s);
   internal::LogString(level, with_line);
@@ -0,0 +1,136 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_METRICS_H_
+#define KATANA_LIBSUPPORT_KATANA_METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+/// Metrics are the live counterpart of the stats that StatManager prints at
+/// exit: values that a long-running process publishes as it goes and that
+/// can be read at any time, in the text format of Prometheus. For example,
+///
+/// \code
+/// static katana::MetricCounter& bytes = katana::GetMetrics().Counter(
+///     "katana_storage_read_bytes_total", "Bytes read from storage");
+/// bytes.Add(size);
+/// \endcode
+///
+/// Updating a metric is a relaxed atomic operation, so metrics may be updated
+/// from any thread. Looking one up takes a lock; keep the reference.
+///
+/// \file
+
+namespace katana {
+
+/// Name and value pairs that tell apart the metrics of a family, e.g.,
+/// {{"op", "get"}}
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/// A count that only goes up, e.g., bytes read
+class KATANA_EXPORT MetricCounter {
+public:
+  void Add(uint64_t v) { value_.fetch_add(v, std::memory_order_relaxed); }
+  /// For counts that are kept elsewhere, e.g., in a CacheStats
+  void Set(uint64_t v) { value_.store(v, std::memory_order_relaxed); }
+  uint64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> value_{0};
+};
+
+/// A value that goes up and down, e.g., bytes of memory in use
+class KATANA_EXPORT MetricGauge {
+public:
+  void Set(double v) { value_.store(v, std::memory_order_relaxed); }
+  double Value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<double> value_{0};
+};
+
+class KATANA_EXPORT MetricsRegistry {
+public:
+  /// The counter of family name with labels, which is created the first time
+  /// it is asked for. Names must be valid Prometheus metric names and a
+  /// family is either counters or gauges. The reference stays valid for the
+  /// lifetime of the registry.
+  MetricCounter& Counter(
+      const std::string& name, const std::string& help,
+      const MetricLabels& labels = {});
+
+  MetricGauge& Gauge(
+      const std::string& name, const std::string& help,
+      const MetricLabels& labels = {});
+
+  /// All metrics in the Prometheus text exposition format (version 0.0.4),
+  /// families sorted by name
+  std::string ExportPrometheus() const;
+
+private:
+  struct Family {
+    std::string help;
+    bool is_counter;
+    /// By rendered labels, e.g., {op="get"}
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+    std::map<std::string, std::unique_ptr<MetricGauge>> gauges;
+  };
+
+  Family& GetFamily(
+      const std::string& name, const std::string& help, bool is_counter);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+};
+
+/// The registry of the process
+KATANA_EXPORT MetricsRegistry& GetMetrics();
+
+/// Replace the metrics of the group at url of a Prometheus Pushgateway, e.g.,
+/// http://localhost:9091/metrics/job/katana, with GetMetrics()
+KATANA_EXPORT Result<void> PushMetrics(const std::string& url);
+
+/// Pushes the metrics to url (see PushMetrics) every interval from a thread
+/// of its own, and once more when it is destroyed. Failed pushes are logged
+/// and retried at the next interval.
+///
+/// SharedMemSys makes one if the environment variable KATANA_METRICS_PUSH_URL
+/// is set, with the interval in seconds in KATANA_METRICS_PUSH_INTERVAL or 15
+/// seconds.
+class KATANA_EXPORT MetricsPusher {
+public:
+  MetricsPusher(std::string url, std::chrono::milliseconds interval);
+  ~MetricsPusher();
+
+  MetricsPusher(const MetricsPusher&) = delete;
+  MetricsPusher& operator=(const MetricsPusher&) = delete;
+  MetricsPusher(MetricsPusher&&) = delete;
+  MetricsPusher& operator=(MetricsPusher&&) = delete;
+
+  /// A pusher configured by the environment, or nullptr
+  static std::unique_ptr<MetricsPusher> MakeFromEnv();
+
+private:
+  void Run();
+
+  std::string url_;
+  std::chrono::milliseconds interval_;
+  std::mutex mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_MPICOMMBACKEND_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CommBackend over MPI_COMM_WORLD; only built with KATANA_USE_MPI.
+///
+/// The collectives are the native MPI ones, Send is MPI_Isend and Receive
+/// is MPI_Probe and MPI_Recv. MPI is initialized with MPI_THREAD_MULTIPLE,
+/// so that any thread may communicate, unless it was initialized before, in
+/// which case it is also left for the caller to finalize.
+class KATANA_EXPORT MpiCommBackend : public CommBackend {
+public:
+  MpiCommBackend();
+  ~MpiCommBackend() override;
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  void NotifyFailure() override;
+  std::vector<uint64_t> AllReduceSum(
+      const std::vector<uint64_t>& vals) override;
+  std::vector<std::string> AllGatherBytes(const std::string& val) override;
+  std::vector<std::string> AllToAllBytes(
+      const std::vector<std::string>& to_each) override;
+
+  void Send(uint32_t dest, uint32_t tag, std::string msg) override;
+  std::string Receive(uint32_t src, uint32_t tag) override;
+  void WaitForSends() override;
+
+private:
+  struct PendingSend;
+
+  bool finalize_{false};
+  std::mutex pending_mutex_;
+  /// Sends not known to be complete, with their buffers; guarded by
+  /// pending_mutex_
+  std::list<PendingSend> pending_;
+};
+
+}  // namespace katana
+
+#endif
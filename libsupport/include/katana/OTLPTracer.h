@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_OTLPTRACER_H_
+#define KATANA_LIBSUPPORT_KATANA_OTLPTRACER_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "katana/JSONTracer.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// OTLPTracer exports spans in the JSON encoding of the OpenTelemetry
+/// protocol (OTLP): one ExportTraceServiceRequest per line, which is what the
+/// otlpjsonfile receiver of the OpenTelemetry Collector reads. A span is
+/// exported when it finishes, with its tags as attributes and its logs as
+/// events.
+///
+/// Contexts are injected and extracted as W3C traceparent headers. If the
+/// environment variable TRACEPARENT holds one, the top-level spans of the
+/// process are children of that span, so that the spans of a job join the
+/// trace of whatever started the job. The service name of the spans is
+/// OTEL_SERVICE_NAME, or "katana".
+///
+/// SharedMemSys uses an OTLPTracer that appends to the file named by the
+/// environment variable KATANA_OTLP_TRACES_FILE, if it is set.
+class KATANA_EXPORT OTLPTracer : public ProgressTracer {
+public:
+  /// Write the spans to standard output
+  static std::unique_ptr<OTLPTracer> Make(
+      uint32_t host_id = 0, uint32_t num_hosts = 1);
+  static std::unique_ptr<OTLPTracer> Make(
+      uint32_t host_id, uint32_t num_hosts, OutputCB out_callback);
+  /// Append the spans to the local file at path
+  static Result<std::unique_ptr<OTLPTracer>> MakeFile(
+      const std::string& path, uint32_t host_id = 0, uint32_t num_hosts = 1);
+
+  std::shared_ptr<ProgressSpan> StartSpan(
+      const std::string& span_name, const ProgressContext& child_of) override;
+
+  std::string Inject(const ProgressContext& ctx) override;
+  std::unique_ptr<ProgressContext> Extract(const std::string& carrier) override;
+
+private:
+  OTLPTracer(uint32_t host_id, uint32_t num_hosts, OutputCB out_callback);
+
+  std::shared_ptr<ProgressSpan> StartSpan(
+      const std::string& span_name,
+      std::shared_ptr<ProgressSpan> child_of) override;
+
+  void Close() override {}
+
+  OutputCB out_callback_;
+  /// The resource of the spans: the service, host and process
+  std::shared_ptr<const std::string> resource_json_;
+  /// From TRACEPARENT, the parent of top-level spans, if any
+  std::unique_ptr<ProgressContext> remote_parent_;
+};
+
+class KATANA_EXPORT OTLPContext : public ProgressContext {
+public:
+  std::unique_ptr<ProgressContext> Clone() const noexcept override;
+  /// 32 hex digits
+  std::string GetTraceID() const noexcept override { return trace_id_; }
+  /// 16 hex digits
+  std::string GetSpanID() const noexcept override { return span_id_; }
+
+private:
+  friend class OTLPTracer;
+  friend class OTLPSpan;
+
+  OTLPContext(std::string trace_id, std::string span_id)
+      : trace_id_(std::move(trace_id)), span_id_(std::move(span_id)) {}
+
+  std::string trace_id_;
+  std::string span_id_;
+};
+
+class KATANA_EXPORT OTLPSpan : public ProgressSpan {
+public:
+  ~OTLPSpan() override { Finish(); }
+
+  void SetTags(const Tags& tags) override;
+
+  void Log(const std::string& message, const Tags& tags) override;
+
+  const ProgressContext& GetContext() const noexcept override {
+    return context_;
+  }
+
+private:
+  friend OTLPTracer;
+
+  struct Event {
+    std::string name;
+    uint64_t time_unix_ns;
+    Tags tags;
+  };
+
+  OTLPSpan(
+      const std::string& span_name, std::shared_ptr<ProgressSpan> parent,
+      const std::string& trace_id, std::string parent_span_id,
+      OutputCB out_callback, std::shared_ptr<const std::string> resource_json);
+
+  void Close() override;
+
+  OTLPContext context_;
+  std::string span_name_;
+  std::string parent_span_id_;
+  uint64_t start_unix_ns_;
+  OutputCB out_callback_;
+  std::shared_ptr<const std::string> resource_json_;
+
+  /// Guards the tags and events, which any thread may add
+  std::mutex mutex_;
+  Tags tags_;
+  std::vector<Event> events_;
+};
+
+}  // namespace katana
+
+#endif
@@ -3,11 +3,13 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <variant>
 #include <vector>
 
 #include "katana/Result.h"
+#include "katana/Time.h"
 #include "katana/config.h"
 
 /// Tracers do not currently support thread-local tracers or concurrency controls.
@@ -41,6 +43,9 @@
 ///
 /// - Raw ProgressSpans should be used for special scenarios like tracing asynchronous calls
 ///
+/// - Use OperationSpans for fine-grained operations like I/O requests, which
+///   may run on any thread
+///
 /// Notes:
 ///
 /// SharedMemSys and DistMemSys will initialize the global ProgressTracer to a
@@ -132,6 +137,18 @@ public:
   virtual std::shared_ptr<ProgressSpan> StartSpan(
       const std::string& span_name, const ProgressContext& child_of) = 0;
 
+  /// StartDetachedSpan creates a child span of the active span, or a new
+  /// top-level span if there is none, that never becomes the active span.
+  /// Unlike the other functions that start spans, it is thread-safe, and the
+  /// span may be finished by any thread. Detached spans are only recorded if
+  /// TracesOperations(); otherwise the returned span ignores everything
+  std::shared_ptr<ProgressSpan> StartDetachedSpan(const std::string& span_name);
+
+  /// Whether detached spans are recorded, which the environment variable
+  /// KATANA_TRACE_OPERATIONS turns on. They are off by default because there
+  /// is a span for every I/O request
+  static bool TracesOperations();
+
   /// Calls finish on the active span, its parent is set to be active
   /// Primarily for internal use only, preferred to use ProgressSpan's Finish function
   void FinishActiveSpan();
@@ -166,6 +183,7 @@ private:
   virtual std::shared_ptr<ProgressSpan> StartSpan(
       const std::string& span_name, std::shared_ptr<ProgressSpan> child_of) = 0;
   ProgressScope SetActiveSpan(std::shared_ptr<ProgressSpan> span);
+  void ReplaceActiveSpan(std::shared_ptr<ProgressSpan> span);
 
   /// Close flushes any buffered spans
   virtual void Close() = 0;
@@ -173,6 +191,9 @@ private:
   static std::unique_ptr<ProgressTracer> tracer_;
 
   std::shared_ptr<ProgressSpan> active_span_ = nullptr;
+  /// Guards writes to active_span_, which only the thread tracing the active
+  /// spans makes, against StartDetachedSpan on other threads
+  std::mutex active_span_mutex_;
   uint32_t host_id_;
   uint32_t num_hosts_;
   std::shared_ptr<ProgressSpan> default_active_span_ = nullptr;
@@ -271,11 +292,55 @@ protected:
       : parent_(std::move(parent)) {}
 
 private:
+  friend class ProgressTracer;
+
   virtual void Close() = 0;
 
   std::shared_ptr<ProgressSpan> parent_ = nullptr;
   bool finished_ = false;
   bool scope_closed_ = false;
+  /// Started by StartDetachedSpan, so never the active span
+  bool detached_ = false;
+};
+
+/// An OperationSpan traces one fine-grained operation, like an I/O request or
+/// the build of a view, with a detached span (see
+/// ProgressTracer::StartDetachedSpan), so it may be started and finished on
+/// any thread. Finishing it tags the span with
+///
+/// - latency_us: the wall time of the operation
+/// - bytes and mb_per_s: what the operation moved, if given
+/// - busy_threads: the cpu time of the process over the wall time of the
+///   operation, the average number of threads that were running
+///
+/// All of it is skipped unless ProgressTracer::TracesOperations().
+class KATANA_EXPORT OperationSpan {
+public:
+  OperationSpan(const std::string& span_name, const Tags& tags = {});
+  ~OperationSpan() { Finish(); }
+
+  OperationSpan(const OperationSpan&) = delete;
+  OperationSpan& operator=(const OperationSpan&) = delete;
+  /// Movable, so that asynchronous operations can take their span along
+  OperationSpan(OperationSpan&& other) noexcept;
+  OperationSpan& operator=(OperationSpan&& other) = delete;
+
+  /// Whether the span is recorded
+  bool enabled() const { return span_ != nullptr; }
+
+  void SetTags(const Tags& tags);
+
+  /// Tag the span as failed with error
+  void SetError(const std::string& error);
+
+  /// Finish the span; later calls do nothing
+  void Finish();
+  void Finish(uint64_t bytes);
+
+private:
+  std::shared_ptr<ProgressSpan> span_;
+  TimePoint begin_;
+  uint64_t begin_cpu_us_{};
 };
 
 }  // namespace katana
@@ -2,9 +2,13 @@
 #define KATANA_LIBSUPPORT_KATANA_RANDOM_H_
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "katana/config.h"
 
@@ -59,6 +63,178 @@ GenerateUniformRandomSequence(
   });
 }
 
+/// The finalizer of splitmix64: a bijection of 64 bit integers in which
+/// every bit of the result depends on every bit of x. Hashes of integer
+/// keys use it so that consecutive keys, e.g., node ids, scatter, and both
+/// the low and the high bits of the hash are well mixed.
+inline uint64_t
+Mix64(uint64_t x) noexcept {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// A uniformly distributed random number determined by seed and i alone:
+/// the ith number of the splitmix64 sequence of seed. Loops that need a
+/// few numbers per item, like a priority per node, can draw them with no
+/// state and get the same numbers whatever the schedule.
+inline uint64_t
+StatelessRandom(uint64_t seed, uint64_t i) noexcept {
+  return Mix64(seed + (i + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+/// A counter-based random number generator: Philox4x32-10 of Salmon et al.,
+/// "Parallel Random Numbers: As Easy as 1, 2, 3" (SC 2011). The nth number
+/// of a stream is a function of the seed, the stream and n alone, so
+///
+/// - each thread, or each item of a loop like a walk or a node, can draw
+///   from a stream of its own, chosen by its id, with no state shared with
+///   the others;
+/// - the numbers an item draws are the same whatever the number of threads
+///   and the schedule of the loop;
+/// - skipping ahead (discard) takes constant time; and
+/// - a run of numbers is made of independent blocks of four, which Fill
+///   computes many at a time with vector instructions.
+///
+/// A stream costs a few words and no work to make, so making one per item
+/// is cheap. It is a UniformRandomBitGenerator, so the distributions of
+/// <random> take it too.
+class RandomStream {
+public:
+  using result_type = uint32_t;
+
+  RandomStream(uint64_t seed, uint64_t stream) noexcept
+      : key0_(static_cast<uint32_t>(seed)),
+        key1_(static_cast<uint32_t>(seed >> 32)),
+        stream_(stream) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() noexcept {
+    uint64_t block = position_ / kBlockSize;
+    if (block != buffered_block_) {
+      uint32_t counter[4][1];
+      SetCounter(block, counter, 0);
+      Rounds<1>(counter);
+      for (size_t i = 0; i < kBlockSize; ++i) {
+        buffer_[i] = counter[i][0];
+      }
+      buffered_block_ = block;
+    }
+    return buffer_[position_++ % kBlockSize];
+  }
+
+  /// Skips the next n numbers
+  void discard(uint64_t n) noexcept { position_ += n; }
+
+  /// The number of numbers drawn so far
+  uint64_t position() const noexcept { return position_; }
+
+  uint64_t Next64() noexcept {
+    uint64_t low = (*this)();
+    return low | (uint64_t{(*this)()} << 32);
+  }
+
+  /// A uniform double of [0, 1), of 53 random bits
+  double NextDouble() noexcept {
+    return static_cast<double>(Next64() >> 11) * 0x1.0p-53;
+  }
+
+  /// A uniform integer of [0, bound), without bias, for bound > 0; after
+  /// Lemire, "Fast Random Integer Generation in an Interval" (2019)
+  uint32_t NextBelow(uint32_t bound) noexcept {
+    uint64_t m = uint64_t{(*this)()} * bound;
+    if (static_cast<uint32_t>(m) < bound) {
+      uint32_t threshold = -bound % bound;
+      while (static_cast<uint32_t>(m) < threshold) {
+        m = uint64_t{(*this)()} * bound;
+      }
+    }
+    return m >> 32;
+  }
+
+  /// Writes the next size numbers to out, the same as calling this size
+  /// times but computing whole batches of blocks at once
+  void Fill(result_type* out, size_t size) noexcept {
+    size_t i = 0;
+    for (; i < size && position_ % kBlockSize != 0; ++i) {
+      out[i] = (*this)();
+    }
+    constexpr size_t kBatchSize = kBatchBlocks * kBlockSize;
+    for (; size - i >= kBatchSize; i += kBatchSize) {
+      uint32_t counter[4][kBatchBlocks];
+      for (size_t b = 0; b < kBatchBlocks; ++b) {
+        SetCounter(position_ / kBlockSize + b, counter, b);
+      }
+      Rounds<kBatchBlocks>(counter);
+      for (size_t b = 0; b < kBatchBlocks; ++b) {
+        for (size_t w = 0; w < kBlockSize; ++w) {
+          out[i + b * kBlockSize + w] = counter[w][b];
+        }
+      }
+      position_ += kBatchSize;
+    }
+    for (; i < size; ++i) {
+      out[i] = (*this)();
+    }
+  }
+
+private:
+  static constexpr size_t kBlockSize = 4;
+  /// The blocks that Fill computes together, enough for the widest vectors
+  static constexpr size_t kBatchBlocks = 16;
+
+  static constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  static constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+  /// The counter of a block is its index in the stream and the stream
+  template <size_t kLanes>
+  void SetCounter(
+      uint64_t block, uint32_t (&counter)[4][kLanes], size_t lane) const {
+    counter[0][lane] = static_cast<uint32_t>(block);
+    counter[1][lane] = static_cast<uint32_t>(block >> 32);
+    counter[2][lane] = static_cast<uint32_t>(stream_);
+    counter[3][lane] = static_cast<uint32_t>(stream_ >> 32);
+  }
+
+  /// The ten Philox rounds, over kLanes counters laid out word by word so
+  /// that the loop over the lanes vectorizes
+  template <size_t kLanes>
+  void Rounds(uint32_t (&counter)[4][kLanes]) const {
+    uint32_t key0 = key0_;
+    uint32_t key1 = key1_;
+    for (int round = 0; round < 10; ++round) {
+      for (size_t j = 0; j < kLanes; ++j) {
+        uint64_t product0 = uint64_t{kMultiplier0} * counter[0][j];
+        uint64_t product1 = uint64_t{kMultiplier1} * counter[2][j];
+        uint32_t word0 =
+            static_cast<uint32_t>(product1 >> 32) ^ counter[1][j] ^ key0;
+        uint32_t word2 =
+            static_cast<uint32_t>(product0 >> 32) ^ counter[3][j] ^ key1;
+        counter[0][j] = word0;
+        counter[1][j] = static_cast<uint32_t>(product1);
+        counter[2][j] = word2;
+        counter[3][j] = static_cast<uint32_t>(product0);
+      }
+      key0 += kWeyl0;
+      key1 += kWeyl1;
+    }
+  }
+
+  uint32_t key0_;
+  uint32_t key1_;
+  uint64_t stream_;
+  uint64_t position_{0};
+  /// The block of buffer_; blocks are numbered below max
+  uint64_t buffered_block_{std::numeric_limits<uint64_t>::max()};
+  result_type buffer_[kBlockSize]{};
+};
+
 }  // namespace katana
 
 #endif
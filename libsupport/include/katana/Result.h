@@ -5,7 +5,10 @@
 #include <cstring>
 #include <iterator>
 #include <ostream>
+#include <string>
 #include <system_error>
+#include <type_traits>
+#include <utility>
 
 #include <arrow/result.h>
 #include <boost/outcome/outcome.hpp>
@@ -119,6 +122,17 @@
 ///
 /// will create error strings like `making number 0: number should be positive`.
 ///
+/// Adding context does not allocate. The context of an error lives in a
+/// fixed size thread local buffer, and the context added by KATANA_ERROR,
+/// KATANA_CHECKED and KATANA_CHECKED_CONTEXT whose arguments are all numbers
+/// or enums is not even formatted: its format string and arguments are
+/// copied to the buffer and only formatted when the error is written, e.g.,
+/// with `operator<<` or when converted to a CopyableErrorInfo. Errors that
+/// are handled rather than reported, like the NotFound of a lookup, cost
+/// little more than their error code. Context with other arguments, e.g.,
+/// strings, is formatted when it is added, as its arguments may not outlive
+/// the call.
+///
 /// On older compilers, auto conversion to `katana::Result` will fail for types
 /// that can't be copied. One symptom is compiler errors on GCC 7 but not on GCC 9.
 /// We've adopted the workaround of returning such objects like so:
@@ -158,6 +172,138 @@ struct abort_policy : BOOST_OUTCOME_V2_NAMESPACE::policy::base {
   }
 };
 
+/// A LiteralFormat is a format string known to be a string literal, which
+/// outlives any error it may be captured in. Made by the error macros.
+template <typename F>
+struct LiteralFormat {
+  F fmt;
+};
+
+template <typename F>
+LiteralFormat<F>
+MakeLiteralFormat(F fmt) {
+  return LiteralFormat<F>{fmt};
+}
+
+template <typename T>
+struct IsLiteralFormat : std::false_type {};
+
+template <typename F>
+struct IsLiteralFormat<LiteralFormat<F>> : std::true_type {};
+
+template <typename F>
+const F&
+UnwrapFormat(const LiteralFormat<F>& fmt_string) {
+  return fmt_string.fmt;
+}
+
+template <typename F>
+const F&
+UnwrapFormat(const F& fmt_string) {
+  return fmt_string;
+}
+
+/// Whether an argument of an error context can be copied into the context
+/// and formatted later
+template <typename... Args>
+constexpr bool kAreLazyArgs =
+    (... && (std::is_arithmetic_v<std::decay_t<Args>> ||
+             std::is_enum_v<std::decay_t<Args>>));
+
+/// LazyArgs holds the arguments of a lazy context. Unlike std::tuple, it is
+/// trivially copyable when its elements are.
+template <typename... Ts>
+struct LazyArgs {};
+
+template <typename T, typename... Ts>
+struct LazyArgs<T, Ts...> {
+  T head;
+  LazyArgs<Ts...> tail;
+};
+
+inline LazyArgs<>
+MakeLazyArgs() {
+  return {};
+}
+
+template <typename T, typename... Ts>
+LazyArgs<std::decay_t<T>, std::decay_t<Ts>...>
+MakeLazyArgs(const T& head, const Ts&... tail) {
+  return {head, MakeLazyArgs(tail...)};
+}
+
+template <size_t I, typename T, typename... Ts>
+const auto&
+GetLazyArg(const LazyArgs<T, Ts...>& args) {
+  if constexpr (I == 0) {
+    return args.head;
+  } else {
+    return GetLazyArg<I - 1>(args.tail);
+  }
+}
+
+/// A LazyContext is error context that is formatted when the error is
+/// written: a literal format string and its arguments
+template <typename... Ts>
+struct LazyContext {
+  fmt::string_view fmt_string;
+  LazyArgs<Ts...> args;
+};
+
+/// A LazyRootContext is the context of a root error made by KATANA_ERROR,
+/// which ends with the source location of the error
+template <typename... Ts>
+struct LazyRootContext {
+  LazyContext<Ts...> context;
+  const char* file_name;
+  int line_no;
+};
+
+/// A SourceInfo is the source location where an error was propagated
+struct SourceInfo {
+  const char* file_name;
+  int line_no;
+};
+
+/// Returns the base name of a source file
+KATANA_EXPORT const char* SourceBaseName(const char* file_name);
+
+KATANA_EXPORT std::string FormatLazy(const SourceInfo& info);
+
+template <typename... Ts, size_t... I>
+std::string
+FormatLazy(
+    const LazyContext<Ts...>& ctx, std::index_sequence<I...> /*unused*/) {
+  return fmt::vformat(
+      ctx.fmt_string, fmt::make_format_args(GetLazyArg<I>(ctx.args)...));
+}
+
+template <typename... Ts>
+std::string
+FormatLazy(const LazyContext<Ts...>& ctx) {
+  return FormatLazy(ctx, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+std::string
+FormatLazy(const LazyRootContext<Ts...>& ctx) {
+  return FormatLazy(ctx.context) +
+         fmt::format(
+             FMT_STRING(" ({}:{})"), SourceBaseName(ctx.file_name),
+             ctx.line_no);
+}
+
+/// Formats a lazy record of type Record
+template <typename Record>
+std::string
+FormatLazyRecord(const char* record) {
+  Record r;
+  std::memcpy(&r, record, sizeof(r));
+  return FormatLazy(r);
+}
+
+using LazyFormatFn = std::string (*)(const char* record);
+
 }  // namespace internal
 
 class CopyableErrorInfo;
@@ -228,7 +374,8 @@ public:
 
   ErrorInfo() : ErrorInfo(std::error_code()) {}
 
-  ErrorInfo(const std::error_code& ec) : error_code_(ec) {}
+  ErrorInfo(const std::error_code& ec)
+      : value_(ec.value()), category_(&ec.category()) {}
 
   template <
       typename ErrorEnum, typename U = std::enable_if_t<
@@ -246,7 +393,9 @@ public:
 
   ErrorInfo(const CopyableErrorInfo& cei);
 
-  const std::error_code& error_code() const { return error_code_; }
+  std::error_code error_code() const {
+    return std::error_code(value_, *category_);
+  }
 
   /// MakeWithSourceInfo makes an ErrorInfo from a root error with additional
   /// arguments passed to fmt::format
@@ -254,21 +403,26 @@ public:
   static ErrorInfo MakeWithSourceInfo(
       const char* file_name, int line_no, const std::error_code& ec,
       F fmt_string, Args&&... args) {
-    fmt::memory_buffer out;
-    fmt::format_to(
-        std::back_inserter(out), fmt_string, std::forward<Args>(args)...);
-    const char* base_name = std::strrchr(file_name, '/');
-    if (!base_name) {
-      base_name = file_name;
+    ErrorInfo ei(ec);
+
+    if constexpr (
+        internal::IsLiteralFormat<F>::value &&
+        internal::kAreLazyArgs<Args...>) {
+      ei.PrependLazy(internal::LazyRootContext<std::decay_t<Args>...>{
+          {fmt::string_view(fmt_string.fmt), internal::MakeLazyArgs(args...)},
+          file_name, line_no});
     } else {
-      base_name++;
+      fmt::memory_buffer out;
+      fmt::format_to(
+          std::back_inserter(out), internal::UnwrapFormat(fmt_string),
+          std::forward<Args>(args)...);
+      fmt::format_to(
+          std::back_inserter(out), " ({}:{})",
+          internal::SourceBaseName(file_name), line_no);
+
+      ei.Prepend(out.data(), out.data() + out.size());
     }
 
-    fmt::format_to(std::back_inserter(out), " ({}:{})", base_name, line_no);
-
-    ErrorInfo ei(ec);
-    ei.Prepend(out.data(), out.data() + out.size());
-
     return ei;
   }
 
@@ -276,7 +430,7 @@ public:
   ErrorInfo WithContext(F&& fmt_string, Args&&... args) {
     SpillMessage();
 
-    PrependFmt(std::forward<F>(fmt_string), std::forward<Args>(args)...);
+    PrependContext(std::forward<F>(fmt_string), std::forward<Args>(args)...);
 
     return *this;
   }
@@ -289,9 +443,21 @@ public:
   WithContext(ErrorEnum err, F&& fmt_string, Args&&... args) {
     SpillMessage();
 
-    error_code_ = make_error_code(err);
+    std::error_code ec = make_error_code(err);
+    value_ = ec.value();
+    category_ = &ec.category();
 
-    PrependFmt(std::forward<F>(fmt_string), std::forward<Args>(args)...);
+    PrependContext(std::forward<F>(fmt_string), std::forward<Args>(args)...);
+
+    return *this;
+  }
+
+  /// WithSourceInfo adds the source location where an error was propagated
+  /// as context. file_name must be a string literal, e.g., __FILE__.
+  ErrorInfo WithSourceInfo(const char* file_name, int line_no) {
+    SpillMessage();
+
+    PrependLazy(internal::SourceInfo{file_name, line_no});
 
     return *this;
   }
@@ -300,23 +466,54 @@ public:
 
 private:
   template <typename F, typename... Args>
-  void PrependFmt(F fmt_string, Args&&... args) {
-    std::vector<char> out;
+  void PrependContext(F&& fmt_string, Args&&... args) {
+    if constexpr (
+        internal::IsLiteralFormat<std::decay_t<F>>::value &&
+        internal::kAreLazyArgs<Args...>) {
+      PrependLazy(internal::LazyContext<std::decay_t<Args>...>{
+          fmt::string_view(fmt_string.fmt), internal::MakeLazyArgs(args...)});
+    } else {
+      PrependFmt(
+          internal::UnwrapFormat(fmt_string), std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename F, typename... Args>
+  void PrependFmt(const F& fmt_string, Args&&... args) {
+    fmt::memory_buffer out;
     fmt::format_to(
         std::back_inserter(out), fmt_string, std::forward<Args>(args)...);
     Prepend(out.data(), out.data() + out.size());
   }
 
+  template <typename Record>
+  void PrependLazy(const Record& record) {
+    static_assert(std::is_trivially_copyable_v<Record>);
+    PrependLazy(
+        &internal::FormatLazyRecord<Record>,
+        reinterpret_cast<const char*>(&record), sizeof(record));
+  }
+
   void Prepend(const char* begin, const char* end);
 
-  /// SpillMessage writes the current error_code message to the error
-  /// context if the error context is empty
+  /// PrependLazy adds context that is formatted by calling format on a copy
+  /// of record when the error is written
+  void PrependLazy(
+      internal::LazyFormatFn format, const char* record, size_t size);
+
+  /// SpillMessage adds the current error_code message to the error context
+  /// if the error context is empty
   void SpillMessage();
 
   void CheckContext();
 
-  std::error_code error_code_;
-  std::pair<Context*, int> context_{};
+  // The error code is stored unpacked so that its padding holds the size of
+  // the context, which keeps an ErrorInfo, and with it a Result<void>, small
+  // to return.
+  int value_{};
+  int context_size_{};
+  const std::error_category* category_;
+  Context* context_{};
 };
 
 inline std::ostream&
@@ -328,7 +525,9 @@ operator<<(std::ostream& out, const ErrorInfo& ei) {
 /// callsite (e.g., line number).
 #define KATANA_ERROR(ec, fmt_string, ...)                                      \
   ::katana::ErrorInfo::MakeWithSourceInfo(                                     \
-      __FILE__, __LINE__, (ec), FMT_STRING(fmt_string), ##__VA_ARGS__)
+      __FILE__, __LINE__, (ec),                                                \
+      ::katana::internal::MakeLiteralFormat(FMT_STRING(fmt_string)),           \
+      ##__VA_ARGS__)
 
 /// A CopyableErrorInfo is like an ErrorInfo but used outside a thread's error
 /// stack.
@@ -372,6 +571,12 @@ public:
     return *this;
   }
 
+  CopyableErrorInfo WithSourceInfo(const char* file_name, int line_no) {
+    PrependFmt(FMT_STRING("({}:{})"), file_name, line_no);
+
+    return *this;
+  }
+
   const std::error_code& error_code() const { return error_code_; }
 
   const std::string& message() const { return message_; }
@@ -380,10 +585,11 @@ public:
 
 private:
   template <typename F, typename... Args>
-  void PrependFmt(F fmt_string, Args&&... args) {
-    std::vector<char> out;
+  void PrependFmt(const F& fmt_string, Args&&... args) {
+    fmt::memory_buffer out;
     fmt::format_to(
-        std::back_inserter(out), fmt_string, std::forward<Args>(args)...);
+        std::back_inserter(out), internal::UnwrapFormat(fmt_string),
+        std::forward<Args>(args)...);
     Prepend(out.data(), out.data() + out.size());
   }
 
@@ -629,7 +835,7 @@ CheckedExpressionToValue(arrow::Status&&) {
     if (::katana::internal::CheckedExpressionFailed(result_name)) {            \
       return ::katana::internal::CheckedExpressionToError(result_name)         \
           .WithContext(__VA_ARGS__)                                            \
-          .WithContext(FMT_STRING("({}:{})"), __FILE__, __LINE__);             \
+          .WithSourceInfo(__FILE__, __LINE__);                                 \
     }                                                                          \
     std::move(                                                                 \
         ::katana::internal::CheckedExpressionToValue(std::move(result_name))); \
@@ -660,7 +866,8 @@ CheckedExpressionToValue(arrow::Status&&) {
 #define KATANA_CHECKED_CONTEXT(expression, format_str, ...)                    \
   KATANA_CHECKED_IMPL(                                                         \
       KATANA_CHECKED_NAME(_error_or_value, __COUNTER__), expression,           \
-      FMT_STRING(format_str), ##__VA_ARGS__)
+      ::katana::internal::MakeLiteralFormat(FMT_STRING(format_str)),           \
+      ##__VA_ARGS__)
 
 /// KATANA_CHECKED_ERROR_CODE takes an expression that returns a Result, an
 /// error code, an error format string, and additional formatting expressions.
@@ -674,7 +881,9 @@ CheckedExpressionToValue(arrow::Status&&) {
 #define KATANA_CHECKED_ERROR_CODE(expression, error_code, format_str, ...)     \
   KATANA_CHECKED_IMPL(                                                         \
       KATANA_CHECKED_NAME(_error_or_value, __COUNTER__), expression,           \
-      error_code, FMT_STRING(format_str), ##__VA_ARGS__)
+      error_code,                                                              \
+      ::katana::internal::MakeLiteralFormat(FMT_STRING(format_str)),           \
+      ##__VA_ARGS__)
 
 /// KATANA_CHECKED takes an expression that returns a Result, and if the Result
 /// has an error, the function calling KATANA_CHECKED will return the error.
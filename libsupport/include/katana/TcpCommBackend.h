@@ -0,0 +1,102 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_TCPCOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_TCPCOMMBACKEND_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CommBackend over TCP connections between every pair of tasks, for
+/// clusters without MPI.
+///
+/// Every task is given the same list of "host:port" addresses, one per
+/// task, and its rank in the list; it listens on its own address, connects
+/// to the tasks of lower rank and accepts connections from the tasks of
+/// higher rank. A thread per peer sends the messages queued by Send and a
+/// thread per peer receives messages into per (source, tag) queues, so Send
+/// never waits for the receiver. Collectives are messages with reserved
+/// tags, e.g., Broadcast sends the value from the root to every other task.
+///
+/// As with MPI, communication errors are fatal, and NotifyFailure aborts
+/// every task.
+class KATANA_EXPORT TcpCommBackend : public CommBackend {
+public:
+  /// Connects task rank to the tasks at addresses, waiting up to
+  /// timeout_seconds for them to start listening
+  static Result<std::unique_ptr<TcpCommBackend>> Make(
+      uint32_t rank, const std::vector<std::string>& addresses,
+      int timeout_seconds = 60);
+
+  /// Make with the comma separated addresses of KATANA_COMM_ADDRESSES and
+  /// the rank of KATANA_COMM_RANK
+  static Result<std::unique_ptr<TcpCommBackend>> MakeFromEnv();
+
+  ~TcpCommBackend() override;
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  void NotifyFailure() override;
+  std::vector<uint64_t> AllReduceSum(
+      const std::vector<uint64_t>& vals) override;
+  std::vector<std::string> AllGatherBytes(const std::string& val) override;
+  std::vector<std::string> AllToAllBytes(
+      const std::vector<std::string>& to_each) override;
+
+  void Send(uint32_t dest, uint32_t tag, std::string msg) override;
+  std::string Receive(uint32_t src, uint32_t tag) override;
+  void WaitForSends() override;
+
+private:
+  struct Peer {
+    int fd{-1};
+    std::thread sender;
+    std::thread receiver;
+    /// Guarded by send_mutex_
+    std::deque<std::pair<uint32_t, std::string>> outbox;
+    /// Set by the receiver when the connection closes; guarded by mutex_
+    bool closed{false};
+  };
+
+  TcpCommBackend(uint32_t rank, uint32_t num);
+
+  Result<void> Connect(
+      const std::vector<std::string>& addresses, int timeout_seconds);
+  void Start();
+  void SendLoop(uint32_t dest);
+  void ReceiveLoop(uint32_t src);
+  /// Send without checking that tag is not reserved
+  void Enqueue(uint32_t dest, uint32_t tag, std::string msg);
+  void Deliver(uint32_t src, uint32_t tag, std::string msg);
+  /// Receive without checking that tag is not reserved
+  std::string Take(uint32_t src, uint32_t tag);
+
+  std::vector<Peer> peers_;
+
+  std::mutex send_mutex_;
+  std::condition_variable send_cv_;
+  /// Messages queued but not yet written; guarded by send_mutex_
+  uint64_t num_unsent_{0};
+  bool stopping_{false};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<std::pair<uint32_t, uint32_t>, std::deque<std::string>> inbox_;
+};
+
+}  // namespace katana
+
+#endif
@@ -4,7 +4,9 @@
 #include <iterator>
 #include <sstream>
 
+#include <arrow/array/array_dict.h>
 #include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
 
 #include "katana/Random.h"
 #include "katana/Result.h"
@@ -59,6 +61,55 @@ katana::TakeRows(
   return filtered.table();
 }
 
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::DictionaryEncodeStrings(
+    const std::shared_ptr<arrow::ChunkedArray>& array) {
+  std::shared_ptr<arrow::ChunkedArray> encoded = array;
+  if (array->type()->id() == arrow::Type::STRING ||
+      array->type()->id() == arrow::Type::LARGE_STRING) {
+    arrow::Datum strings =
+        KATANA_CHECKED(arrow::compute::Cast(array, arrow::large_utf8()));
+    arrow::Datum dictionary_encoded =
+        KATANA_CHECKED(arrow::compute::DictionaryEncode(strings));
+    encoded = dictionary_encoded.chunked_array();
+  }
+  if (encoded->type()->id() != arrow::Type::DICTIONARY) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "cannot dictionary encode {} as strings",
+        array->type()->ToString());
+  }
+  const auto& value_type =
+      static_cast<const arrow::DictionaryType&>(*encoded->type()).value_type();
+  if (value_type->id() != arrow::Type::STRING &&
+      value_type->id() != arrow::Type::LARGE_STRING) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "dictionary of {} is not of strings",
+        value_type->ToString());
+  }
+
+  // The chunks of the result of DictionaryEncode, or the row groups of a
+  // parquet column, each have a dictionary of their own
+  encoded =
+      KATANA_CHECKED(arrow::DictionaryUnifier::UnifyChunkedArray(encoded));
+
+  std::shared_ptr<arrow::DataType> type = DictionaryStringType();
+  std::shared_ptr<arrow::Array> dictionary;
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  for (const auto& chunk : encoded->chunks()) {
+    const auto& dictionary_chunk =
+        static_cast<const arrow::DictionaryArray&>(*chunk);
+    if (!dictionary) {
+      dictionary = KATANA_CHECKED(arrow::compute::Cast(
+          *dictionary_chunk.dictionary(), arrow::large_utf8()));
+    }
+    std::shared_ptr<arrow::Array> codes = KATANA_CHECKED(
+        arrow::compute::Cast(*dictionary_chunk.indices(), arrow::int32()));
+    chunks.emplace_back(KATANA_CHECKED(
+        arrow::DictionaryArray::FromArrays(type, codes, dictionary)));
+  }
+  return std::make_shared<arrow::ChunkedArray>(std::move(chunks), type);
+}
+
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::NullChunkedArray(
     const std::shared_ptr<arrow::DataType>& type, int64_t length) {
@@ -67,6 +118,49 @@ katana::NullChunkedArray(
   return std::make_shared<arrow::ChunkedArray>(chunks);
 }
 
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::ContiguousArray(const arrow::ChunkedArray& array) {
+  if (array.num_chunks() == 1) {
+    return array.chunk(0);
+  }
+  if (array.num_chunks() == 0) {
+    return KATANA_CHECKED(arrow::MakeArrayOfNull(array.type(), 0));
+  }
+  return KATANA_CHECKED(arrow::Concatenate(array.chunks()));
+}
+
+katana::ChunkIndex::ChunkIndex(const arrow::ChunkedArray& array) {
+  int num_chunks = array.num_chunks();
+  offsets_.reserve(num_chunks + 1);
+  int64_t min_length = array.length();
+  for (int c = 0; c < num_chunks; ++c) {
+    int64_t chunk_length = array.chunk(c)->length();
+    offsets_.emplace_back(offsets_.back() + chunk_length);
+    if (chunk_length > 0 && c + 1 < num_chunks) {
+      min_length = std::min(min_length, chunk_length);
+    }
+  }
+  if (length() == 0) {
+    return;
+  }
+
+  // a few buckets per chunk at most, should some chunks be much shorter
+  // than the others
+  int64_t bucket_length = std::max<int64_t>(
+      {min_length, length() / (4 * static_cast<int64_t>(num_chunks)), 1});
+  shift_ = 63 - __builtin_clzll(bucket_length);
+  int64_t num_buckets = ((length() - 1) >> shift_) + 1;
+  buckets_.reserve(num_buckets + 1);
+  int chunk = 0;
+  for (int64_t b = 0; b < num_buckets; ++b) {
+    while (offsets_[chunk + 1] <= (b << shift_)) {
+      ++chunk;
+    }
+    buckets_.emplace_back(chunk);
+  }
+  buckets_.emplace_back(num_chunks - 1);
+}
+
 std::shared_ptr<arrow::Table>
 katana::MakeEmptyArrowTable() {
   return arrow::Table::Make(
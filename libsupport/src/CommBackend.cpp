@@ -1,8 +1,99 @@
 #include "katana/CommBackend.h"
 
+#include <cstring>
+
 // Anchor vtables
 
 katana::CommBackend::~CommBackend() = default;
 
 void
 katana::NullCommBackend::NotifyFailure() {}
+
+void
+katana::NullCommBackend::Send(uint32_t dest, uint32_t tag, std::string msg) {
+  KATANA_LOG_ASSERT(dest == 0 && tag < kMaxTag);
+  messages_[tag].emplace_back(std::move(msg));
+}
+
+std::string
+katana::NullCommBackend::Receive(uint32_t src, uint32_t tag) {
+  auto it = messages_.find(tag);
+  KATANA_LOG_VASSERT(
+      src == 0 && it != messages_.end() && !it->second.empty(),
+      "Receive would wait forever for a message of tag {}", tag);
+  std::string msg = std::move(it->second.front());
+  it->second.pop_front();
+  return msg;
+}
+
+void
+katana::CommBackend::Send(uint32_t, uint32_t, std::string) {
+  KATANA_LOG_FATAL("this CommBackend does not support Send");
+}
+
+std::string
+katana::CommBackend::Receive(uint32_t, uint32_t) {
+  KATANA_LOG_FATAL("this CommBackend does not support Receive");
+}
+
+std::vector<uint64_t>
+katana::CommBackend::AllReduceSum(const std::vector<uint64_t>& vals) {
+  size_t num_bytes = vals.size() * sizeof(uint64_t);
+  std::string mine(reinterpret_cast<const char*>(vals.data()), num_bytes);
+  std::vector<uint64_t> sum(vals.size());
+  for (uint32_t root = 0; root < Num; ++root) {
+    std::string theirs = Broadcast(root, mine, num_bytes);
+    KATANA_LOG_ASSERT(theirs.size() == num_bytes);
+    for (size_t i = 0; i < sum.size(); ++i) {
+      uint64_t val;
+      std::memcpy(&val, theirs.data() + i * sizeof(uint64_t), sizeof(val));
+      sum[i] += val;
+    }
+  }
+  return sum;
+}
+
+std::vector<std::string>
+katana::CommBackend::AllGatherBytes(const std::string& val) {
+  std::vector<uint64_t> sizes(Num);
+  sizes[Rank] = val.size();
+  sizes = AllReduceSum(sizes);
+
+  std::vector<std::string> all(Num);
+  for (uint32_t root = 0; root < Num; ++root) {
+    all[root] = Broadcast(root, val, sizes[root]);
+    KATANA_LOG_ASSERT(all[root].size() == sizes[root]);
+  }
+  return all;
+}
+
+std::vector<std::string>
+katana::CommBackend::AllToAllBytes(const std::vector<std::string>& to_each) {
+  KATANA_LOG_ASSERT(to_each.size() == Num);
+  // Each task gathers everything and keeps its part, which costs Num times
+  // the bytes of a native all-to-all
+  std::string packed;
+  for (const std::string& val : to_each) {
+    uint64_t size = val.size();
+    packed.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    packed.append(val);
+  }
+  std::vector<std::string> all = AllGatherBytes(packed);
+
+  std::vector<std::string> mine(Num);
+  for (uint32_t src = 0; src < Num; ++src) {
+    const std::string& theirs = all[src];
+    size_t pos = 0;
+    for (uint32_t dest = 0; dest <= Rank; ++dest) {
+      uint64_t size;
+      KATANA_LOG_ASSERT(pos + sizeof(size) <= theirs.size());
+      std::memcpy(&size, theirs.data() + pos, sizeof(size));
+      pos += sizeof(size);
+      if (dest == Rank) {
+        mine[src] = theirs.substr(pos, size);
+      }
+      pos += size;
+    }
+  }
+  return mine;
+}
@@ -1,5 +1,6 @@
 #include "katana/EntityTypeManager.h"
 
+#include "katana/ArrowInterchange.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 
@@ -43,17 +44,6 @@ katana::Result<katana::EntityTypeManager::TypeProperties>
 katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
     const std::shared_ptr<arrow::Table>& properties,
     EntityTypeManager* entity_type_manager) {
-  // throw an error if each column/property has more than 1 chunk
-  for (int i = 0, n = properties->num_columns(); i < n; i++) {
-    std::shared_ptr<arrow::ChunkedArray> property = properties->column(i);
-    if (property->num_chunks() != 1) {
-      return KATANA_ERROR(
-          katana::ErrorCode::NotImplemented,
-          "property {} has {} chunks (1 chunk expected)",
-          properties->schema()->field(i)->name(), property->num_chunks());
-    }
-  }
-
   // collect the list of types
   TypeProperties type_properties;
   TypeProperties::FieldEntity type_field_indices;
@@ -66,8 +56,10 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
     // a uint8 property is (always) considered a type
     if (current_field->type()->Equals(arrow::uint8())) {
       type_field_indices.push_back(i);
-      KATANA_LOG_DEBUG_ASSERT(properties->column(i)->num_chunks() == 1);
-      std::shared_ptr<arrow::Array> property = properties->column(i)->chunk(0);
+      // loaded properties may be chunked; type properties are one byte a
+      // row, so a copy of their chunks is cheap
+      std::shared_ptr<arrow::Array> property =
+          KATANA_CHECKED(ContiguousArray(*properties->column(i)));
       auto uint8_property =
           std::static_pointer_cast<arrow::UInt8Array>(property);
       type_properties.uint8_properties.emplace_back(i, uint8_property);
@@ -152,6 +144,8 @@ katana::EntityTypeManager::AddNonAtomicEntityType(
 
   // Ensure the bitmaps can fit the new entity_type_id
   ResizeSetOfEntityTypeIDsMaps(new_entity_type_id);
+  subtype_matrix_.reset();
+  subtype_matrix_ptr_ = nullptr;
   SetOfEntityTypeIDs type_id_set_resized = type_id_set;
   type_id_set_resized.resize(SetOfEntityTypeIDsSize_);
   entity_type_id_to_atomic_entity_type_ids_.emplace_back(type_id_set_resized);
@@ -168,15 +162,14 @@ katana::EntityTypeManager::AddNonAtomicEntityType(
     }
   }
 
-  // Ideally this would return an error instead of failing. But checking is
-  // probably too slow. Remember kids, fast is more important than correct.
+  // Ideally this would return an error instead of failing, but the type is
+  // added anyway, and lookups keep finding the first id with these types.
   // Exclude this check if our EntityTypeID == 0, as we expect it to have the empty set
+  [[maybe_unused]] bool added = atomic_type_ids_to_entity_type_id_
+                   .emplace(ToAtomicTypeIDs(type_id_set), new_entity_type_id)
+                   .second;
   KATANA_LOG_DEBUG_VASSERT(
-      new_entity_type_id == 0 ||
-          std::count(
-              entity_type_id_to_atomic_entity_type_ids_.begin(),
-              entity_type_id_to_atomic_entity_type_ids_.end(),
-              type_id_set_resized) == 1,
+      new_entity_type_id == 0 || added,
       "AddNonAtomicEntityType called with type_id_set that is already "
       "present.");
 
@@ -186,22 +179,9 @@ katana::EntityTypeManager::AddNonAtomicEntityType(
 katana::Result<katana::EntityTypeID>
 katana::EntityTypeManager::GetOrAddNonAtomicEntityType(
     const katana::SetOfEntityTypeIDs& type_id_set) {
-  // Find a previous type ID for this set of types. This is a linear search
-  // and O(n types). However, n types is expected to stay small so this isn't
-  // a big issue. If this does turn out to be a performance problem we could
-  // keep around an extra map from type ID sets to type IDs.
-
-  katana::SetOfEntityTypeIDs type_id_set_resized = type_id_set;
-  type_id_set_resized.resize(SetOfEntityTypeIDsSize_);
-
-  auto existing_id = std::find(
-      entity_type_id_to_atomic_entity_type_ids_.cbegin(),
-      entity_type_id_to_atomic_entity_type_ids_.cend(), type_id_set_resized);
-  if (existing_id != entity_type_id_to_atomic_entity_type_ids_.cend()) {
-    // We rely on the fact that entity_type_id_to_atomic_entity_type_ids_ is a
-    // vector here so that distances are the same as type IDs.
-    return Result<EntityTypeID>(std::distance(
-        entity_type_id_to_atomic_entity_type_ids_.cbegin(), existing_id));
+  if (EntityTypeID id = FindEntityType(ToAtomicTypeIDs(type_id_set));
+      id != kInvalidEntityType) {
+    return Result<EntityTypeID>(id);
   }
 
   return AddNonAtomicEntityType(type_id_set);
@@ -210,22 +190,9 @@ katana::EntityTypeManager::GetOrAddNonAtomicEntityType(
 katana::Result<katana::EntityTypeID>
 katana::EntityTypeManager::GetNonAtomicEntityType(
     const katana::SetOfEntityTypeIDs& type_id_set) const {
-  // Find a previous type ID for this set of types. This is a linear search
-  // and O(n types). However, n types is expected to stay small so this isn't
-  // a big issue. If this does turn out to be a performance problem we could
-  // keep around an extra map from type ID sets to type IDs.
-
-  katana::SetOfEntityTypeIDs type_id_set_resized = type_id_set;
-  type_id_set_resized.resize(SetOfEntityTypeIDsSize_);
-
-  auto existing_id = std::find(
-      entity_type_id_to_atomic_entity_type_ids_.cbegin(),
-      entity_type_id_to_atomic_entity_type_ids_.cend(), type_id_set_resized);
-  if (existing_id != entity_type_id_to_atomic_entity_type_ids_.cend()) {
-    // We rely on the fact that entity_type_id_to_atomic_entity_type_ids_ is a
-    // vector here so that distances are the same as type IDs.
-    return Result<EntityTypeID>(std::distance(
-        entity_type_id_to_atomic_entity_type_ids_.cbegin(), existing_id));
+  if (EntityTypeID id = FindEntityType(ToAtomicTypeIDs(type_id_set));
+      id != kInvalidEntityType) {
+    return Result<EntityTypeID>(id);
   }
 
   return KATANA_ERROR(
@@ -233,6 +200,43 @@ katana::EntityTypeManager::GetNonAtomicEntityType(
       "no compound type found for given set of atomic types");
 }
 
+size_t
+katana::EntityTypeManager::AtomicTypeIDsHash::operator()(
+    const std::vector<EntityTypeID>& ids) const noexcept {
+  // FNV-1a over the ids
+  uint64_t hash = 0xcbf29ce484222325;
+  for (EntityTypeID id : ids) {
+    hash = (hash ^ id) * 0x100000001b3;
+  }
+  return hash;
+}
+
+std::vector<katana::EntityTypeID>
+katana::EntityTypeManager::ToAtomicTypeIDs(
+    const SetOfEntityTypeIDs& type_id_set) {
+  std::vector<EntityTypeID> ids;
+  const auto& words = type_id_set.get_vec();
+  for (size_t i = 0; i < words.size(); ++i) {
+    uint64_t word = words[i].load();
+    while (word != 0) {
+      ids.emplace_back(i * 64 + __builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+  return ids;
+}
+
+void
+katana::EntityTypeManager::IndexEntityTypes() {
+  atomic_type_ids_to_entity_type_id_.clear();
+  for (size_t id = 0; id < entity_type_id_to_atomic_entity_type_ids_.size();
+       ++id) {
+    // emplace keeps the first, smallest, id of repeated atomic types
+    atomic_type_ids_to_entity_type_id_.emplace(
+        ToAtomicTypeIDs(entity_type_id_to_atomic_entity_type_ids_[id]), id);
+  }
+}
+
 katana::Result<katana::EntityTypeID>
 katana::EntityTypeManager::AddAtomicEntityType(const std::string& name) {
   // This is a hash lookup, so this should be fast enough for production code.
@@ -250,6 +254,8 @@ katana::EntityTypeManager::AddAtomicEntityType(const std::string& name) {
 
   // Ensure the bitmaps can fit the new entity_type_id
   ResizeSetOfEntityTypeIDsMaps(new_entity_type_id);
+  subtype_matrix_.reset();
+  subtype_matrix_ptr_ = nullptr;
 
   atomic_entity_type_id_to_type_name_.emplace(new_entity_type_id, name);
   atomic_type_name_to_entity_type_id_.emplace(name, new_entity_type_id);
@@ -260,10 +266,93 @@ katana::EntityTypeManager::AddAtomicEntityType(const std::string& name) {
   entity_type_ids.set(new_entity_type_id);
   entity_type_id_to_atomic_entity_type_ids_.emplace_back(entity_type_ids);
   atomic_entity_type_id_to_entity_type_ids_.emplace_back(entity_type_ids);
+  atomic_type_ids_to_entity_type_id_.emplace(
+      std::vector<EntityTypeID>{new_entity_type_id}, new_entity_type_id);
 
   return Result<EntityTypeID>(new_entity_type_id);
 }
 
+bool
+katana::EntityTypeManager::IsSubsetOf(
+    const SetOfEntityTypeIDs& sub, const SetOfEntityTypeIDs& super) {
+  const auto& sub_words = sub.get_vec();
+  const auto& super_words = super.get_vec();
+  for (size_t i = 0; i < sub_words.size(); ++i) {
+    uint64_t super_word = i < super_words.size() ? super_words[i].load() : 0;
+    if ((sub_words[i].load() & ~super_word) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const katana::EntityTypeManager::SubtypeMatrix*
+katana::EntityTypeManager::BuildSubtypeMatrix() const {
+  size_t num_types = GetNumEntityTypes();
+  if (num_types > kMaxFlattenedEntityTypes) {
+    return nullptr;
+  }
+
+  // The supertypes of a type are the types that intersect every one of its
+  // atomic types, so every row is an intersection of a few rows of
+  // atomic_entity_type_id_to_entity_type_ids_
+  auto matrix = std::make_shared<SubtypeMatrix>();
+  size_t words_per_row = (num_types + 63) / 64;
+  matrix->words_per_row = words_per_row;
+  matrix->bits.assign(num_types * words_per_row, ~uint64_t{0});
+  for (size_t sub_type = 0; sub_type < num_types; ++sub_type) {
+    uint64_t* row = &matrix->bits[sub_type * words_per_row];
+    const auto& atomic_words = GetAtomicSubtypes(sub_type).get_vec();
+    for (size_t i = 0; i < atomic_words.size(); ++i) {
+      uint64_t atomic_word = atomic_words[i].load();
+      while (atomic_word != 0) {
+        size_t atomic_type = i * 64 + __builtin_ctzll(atomic_word);
+        atomic_word &= atomic_word - 1;
+        const auto& super_words = GetSupertypes(atomic_type).get_vec();
+        for (size_t w = 0; w < words_per_row; ++w) {
+          row[w] &= super_words[w].load();
+        }
+      }
+    }
+    if (num_types % 64 != 0) {
+      row[words_per_row - 1] &= (uint64_t{1} << (num_types % 64)) - 1;
+    }
+  }
+
+  // Whichever thread builds it first wins, so that the matrix of other
+  // threads stays alive as long as the manager is not modified
+  std::shared_ptr<const SubtypeMatrix> expected;
+  std::atomic_compare_exchange_strong(
+      &subtype_matrix_, &expected,
+      std::shared_ptr<const SubtypeMatrix>(std::move(matrix)));
+  const SubtypeMatrix* built = std::atomic_load(&subtype_matrix_).get();
+  subtype_matrix_ptr_.store(built, std::memory_order_release);
+  return built;
+}
+
+katana::SetOfEntityTypeIDs
+katana::EntityTypeManager::GetEntityTypesWithType(
+    EntityTypeID entity_type_id) const {
+  SetOfEntityTypeIDs types;
+  types.resize(SetOfEntityTypeIDsSize_);
+  size_t num_types = GetNumEntityTypes();
+  if (const SubtypeMatrix* matrix = GetSubtypeMatrix(); matrix != nullptr) {
+    auto& words = types.get_vec();
+    const uint64_t* row = &matrix->bits[entity_type_id * matrix->words_per_row];
+    for (size_t w = 0; w < matrix->words_per_row; ++w) {
+      words[w] = row[w];
+    }
+    return types;
+  }
+  const SetOfEntityTypeIDs& atomic_types = GetAtomicSubtypes(entity_type_id);
+  for (size_t type = 0; type < num_types; ++type) {
+    if (IsSubsetOf(atomic_types, GetAtomicSubtypes(type))) {
+      types.set(type);
+    }
+  }
+  return types;
+}
+
 void
 katana::EntityTypeManager::ResizeSetOfEntityTypeIDsMaps(
     katana::EntityTypeID new_entity_type_id) {
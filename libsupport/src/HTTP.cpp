@@ -1,5 +1,9 @@
 #include "katana/HTTP.h"
 
+#include <cstring>
+#include <mutex>
+#include <vector>
+
 #include <curl/curl.h>
 
 #include "katana/ErrorCode.h"
@@ -8,6 +12,75 @@
 
 namespace {
 
+/// The curl easy handles kept between requests. A handle keeps its
+/// connections open (HTTP keep-alive) and caches DNS lookups and TLS
+/// sessions, so a request that reuses a handle that has talked to its host
+/// skips connection setup.
+class HandlePool {
+  std::mutex mutex_;
+  std::vector<CURL*> idle_;
+
+public:
+  /// The most idle handles kept; more are cleaned up as they are released
+  static constexpr size_t kMaxIdle = 32;
+
+  static HandlePool& Get() {
+    static HandlePool pool;
+    return pool;
+  }
+
+  ~HandlePool() {
+    for (CURL* handle : idle_) {
+      curl_easy_cleanup(handle);
+    }
+  }
+
+  CURL* Acquire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        CURL* handle = idle_.back();
+        idle_.pop_back();
+        return handle;
+      }
+    }
+    return curl_easy_init();
+  }
+
+  void Release(CURL* handle) {
+    // reset options but keep connections and caches
+    curl_easy_reset(handle);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (idle_.size() < kMaxIdle) {
+        idle_.emplace_back(handle);
+        return;
+      }
+    }
+    curl_easy_cleanup(handle);
+  }
+};
+
+/// A caller's buffer filled by a ranged request
+struct RangeBuffer {
+  uint8_t* data;
+  uint64_t size;
+  uint64_t filled{0};
+};
+
+size_t
+WriteDataToRangeCB(char* ptr, size_t size, size_t nmemb, void* user_data) {
+  size_t real_size = size * nmemb;
+  auto buffer = static_cast<RangeBuffer*>(user_data);
+  if (real_size > buffer->size - buffer->filled) {
+    // more than was asked for: fail the transfer
+    return 0;
+  }
+  std::memcpy(buffer->data + buffer->filled, ptr, real_size);
+  buffer->filled += real_size;
+  return real_size;
+}
+
 class CurlHandle {
   CURL* handle_{};
   struct curl_slist* headers_{};
@@ -36,14 +109,21 @@ public:
     return *this;
   }
 
-  static katana::Result<CurlHandle> Make(
-      const std::string& url, std::vector<char>* response) {
-    CURL* curl = curl_easy_init();
+  /// A handle, from the pool, for a request of url
+  static katana::Result<CurlHandle> Make(const std::string& url) {
+    CURL* curl = HandlePool::Get().Acquire();
     if (!curl) {
       return katana::ErrorCode::HTTPError;
     }
     CurlHandle handle(curl);
     KATANA_CHECKED(handle.SetOpt(CURLOPT_URL, url.c_str()));
+    KATANA_CHECKED(handle.SetOpt(CURLOPT_TCP_KEEPALIVE, 1L));
+    return CurlHandle(std::move(handle));
+  }
+
+  static katana::Result<CurlHandle> Make(
+      const std::string& url, std::vector<char>* response) {
+    CurlHandle handle = KATANA_CHECKED(Make(url));
     KATANA_CHECKED(handle.SetOpt(CURLOPT_WRITEDATA, response));
     KATANA_CHECKED(handle.SetOpt(CURLOPT_WRITEFUNCTION, WriteDataToVectorCB));
     return CurlHandle(std::move(handle));
@@ -55,7 +135,7 @@ public:
       curl_slist_free_all(headers_);
     }
     if (handle_ != nullptr) {
-      curl_easy_cleanup(handle_);
+      HandlePool::Get().Release(handle_);
     }
   }
 
@@ -88,6 +168,7 @@ public:
     curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &response_code);
     switch (response_code) {
     case 200:
+    case 206:
       return katana::ResultSuccess();
     case 404:
       return katana::ErrorCode::NotFound;
@@ -122,6 +203,29 @@ katana::HttpGet(const std::string& url, std::vector<char>* response) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::HttpGetRange(
+    const std::string& url, uint64_t begin, uint64_t size, uint8_t* buffer) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  RangeBuffer range{buffer, size};
+  CurlHandle curl = KATANA_CHECKED(CurlHandle::Make(url));
+  KATANA_CHECKED(curl.SetOpt(CURLOPT_WRITEDATA, &range));
+  KATANA_CHECKED(curl.SetOpt(CURLOPT_WRITEFUNCTION, WriteDataToRangeCB));
+  KATANA_CHECKED(curl.SetOpt(CURLOPT_HTTPGET, 1L));
+  std::string bytes = fmt::format("{}-{}", begin, begin + size - 1);
+  KATANA_CHECKED(curl.SetOpt(CURLOPT_RANGE, bytes.c_str()));
+  KATANA_CHECKED_CONTEXT(
+      curl.Perform(), "GET failed for url: {} range: {}", url, bytes);
+  if (range.filled != size) {
+    return KATANA_ERROR(
+        ErrorCode::HTTPError, "GET of url: {} range: {} returned {} bytes",
+        url, bytes, range.filled);
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::HttpPost(
     const std::string& url, const std::string& data,
@@ -3,12 +3,12 @@
 #include <sys/time.h>
 
 #include <cstring>
-#include <iostream>
 #include <limits>
 #include <mutex>
 
 #include <arrow/memory_pool.h>
 
+#include "katana/Logging.h"
 #include "katana/Random.h"
 #include "katana/Time.h"
 
@@ -152,7 +152,9 @@ std::unique_ptr<katana::JSONTracer>
 katana::JSONTracer::Make(uint32_t host_id, uint32_t num_hosts) {
   return std::unique_ptr<JSONTracer>(new JSONTracer(
       host_id, num_hosts,
-      [](const std::string& output) { std::cout << output; }));
+      [](const std::string& output) {
+        katana::internal::WriteOutput(false, output);
+      }));
 }
 
 std::unique_ptr<katana::JSONTracer>
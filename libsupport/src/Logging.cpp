@@ -1,17 +1,26 @@
 #include "katana/Logging.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "katana/Env.h"
 
 namespace {
 
+std::mutex print_lock;
+
 void
 PrintString(
     bool error, bool flush, const std::string& prefix, const std::string& s) {
-  static std::mutex lock;
-  std::lock_guard<std::mutex> lg(lock);
+  std::lock_guard<std::mutex> lg(print_lock);
 
   std::ostream& o = error ? std::cerr : std::cout;
   if (!prefix.empty()) {
@@ -23,33 +32,266 @@ PrintString(
   }
 }
 
+const char*
+LevelPrefix(katana::LogLevel level) {
+  switch (level) {
+  case katana::LogLevel::Debug:
+    return "DEBUG";
+  case katana::LogLevel::Verbose:
+    return "VERBOSE";
+  case katana::LogLevel::Warning:
+    return "WARNING";
+  case katana::LogLevel::Error:
+    return "ERROR";
+  default:
+    return "UNKNOWN LOG LEVEL";
+  }
+}
+
+/// LogRing is the buffer of the messages one thread wrote while logging is
+/// asynchronous. Its thread is the only producer and whoever holds the drain
+/// lock of the LogSink the only consumer, so the two only share the atomic
+/// positions. A message is stored as its length, whether it goes to standard
+/// error and its bytes, wrapping around the end of the buffer.
+class LogRing {
+public:
+  static constexpr uint64_t kCapacity = uint64_t{1} << 16;
+  static constexpr uint64_t kHeaderSize = sizeof(uint32_t) + 1;
+
+  /// Add a message unless there is no room for it
+  bool TryPush(bool to_stderr, const std::string& text) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t size = kHeaderSize + text.size();
+    if (kCapacity - (head - tail) < size) {
+      return false;
+    }
+    uint32_t length = text.size();
+    char flag = to_stderr ? 1 : 0;
+    Copy(head, reinterpret_cast<const char*>(&length), sizeof(length));
+    Copy(head + sizeof(length), &flag, 1);
+    Copy(head + kHeaderSize, text.data(), text.size());
+    head_.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  /// Move every message to err or out, in the order they were added
+  void Drain(std::string* err, std::string* out) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (tail != head) {
+      uint32_t length = 0;
+      char flag = 0;
+      Read(tail, reinterpret_cast<char*>(&length), sizeof(length));
+      Read(tail + sizeof(length), &flag, 1);
+      std::string* dest = flag ? err : out;
+      size_t offset = dest->size();
+      dest->resize(offset + length);
+      Read(tail + kHeaderSize, dest->data() + offset, length);
+      tail += kHeaderSize + length;
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+private:
+  void Copy(uint64_t pos, const char* src, uint64_t n) {
+    uint64_t begin = pos % kCapacity;
+    uint64_t first = std::min(n, kCapacity - begin);
+    std::memcpy(&data_[begin], src, first);
+    std::memcpy(&data_[0], src + first, n - first);
+  }
+
+  void Read(uint64_t pos, char* dest, uint64_t n) const {
+    uint64_t begin = pos % kCapacity;
+    uint64_t first = std::min(n, kCapacity - begin);
+    std::memcpy(dest, &data_[begin], first);
+    std::memcpy(dest + first, &data_[0], n - first);
+  }
+
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+  char data_[kCapacity];
+};
+
+/// LogSink writes log messages to the standard streams, either right away on
+/// the calling thread or, when asynchronous, through per thread LogRings and
+/// a background thread that drains them.
+class LogSink {
+public:
+  static LogSink& Get() {
+    static LogSink sink;
+    return sink;
+  }
+
+  ~LogSink() { SetAsync(false); }
+
+  bool async() const { return async_.load(std::memory_order_relaxed); }
+
+  void SetAsync(bool enabled) {
+    std::lock_guard<std::mutex> lg(flusher_lock_);
+    if (enabled == async()) {
+      return;
+    }
+    if (enabled) {
+      stop_ = false;
+      async_.store(true);
+      flusher_ = std::thread([this] { RunFlusher(); });
+      return;
+    }
+    async_.store(false);
+    {
+      std::lock_guard<std::mutex> wake_lg(wake_lock_);
+      stop_ = true;
+    }
+    wake_.notify_one();
+    flusher_.join();
+    Drain();
+  }
+
+  void Write(bool to_stderr, const std::string& text) {
+    if (!async()) {
+      std::lock_guard<std::mutex> lg(print_lock);
+      (to_stderr ? std::cerr : std::cout) << text;
+      return;
+    }
+    if (text.size() > LogRing::kCapacity / 2) {
+      // too large to buffer: keep it after the messages before it
+      Drain();
+      std::lock_guard<std::mutex> lg(print_lock);
+      (to_stderr ? std::cerr : std::cout) << text;
+      return;
+    }
+    LogRing* ring = LocalRing();
+    while (!ring->TryPush(to_stderr, text)) {
+      // the flusher fell behind; rather than wait for it, drain the rings
+      // here
+      Drain();
+    }
+  }
+
+  /// Write out every buffered message
+  void Drain() {
+    std::lock_guard<std::mutex> drain_lg(drain_lock_);
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+      std::lock_guard<std::mutex> lg(rings_lock_);
+      rings = rings_;
+      // rings of threads that exited are dropped once they are drained
+      rings_.erase(
+          std::remove_if(
+              rings_.begin(), rings_.end(),
+              [](const auto& ring) { return ring.use_count() == 2; }),
+          rings_.end());
+    }
+    std::string err;
+    std::string out;
+    for (const auto& ring : rings) {
+      ring->Drain(&err, &out);
+    }
+    if (err.empty() && out.empty()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lg(print_lock);
+    std::cerr << err;
+    std::cout << out;
+    std::cerr.flush();
+    std::cout.flush();
+  }
+
+private:
+  static constexpr auto kFlushInterval = std::chrono::milliseconds(10);
+
+  LogRing* LocalRing() {
+    thread_local std::shared_ptr<LogRing> ring;
+    if (!ring) {
+      ring = std::make_shared<LogRing>();
+      std::lock_guard<std::mutex> lg(rings_lock_);
+      rings_.emplace_back(ring);
+    }
+    return ring.get();
+  }
+
+  void RunFlusher() {
+    std::unique_lock<std::mutex> lk(wake_lock_);
+    while (!stop_) {
+      wake_.wait_for(lk, kFlushInterval, [this] { return stop_; });
+      lk.unlock();
+      Drain();
+      lk.lock();
+    }
+  }
+
+  std::atomic<bool> async_{false};
+
+  std::mutex rings_lock_;
+  std::vector<std::shared_ptr<LogRing>> rings_;
+  std::mutex drain_lock_;
+
+  std::mutex flusher_lock_;
+  std::thread flusher_;
+  std::mutex wake_lock_;
+  std::condition_variable wake_;
+  bool stop_{false};
+};
+
+int
+MinLogLevel() {
+  static int min_level = [] {
+    int level = static_cast<int32_t>(katana::LogLevel::Debug);
+    katana::GetEnv("KATANA_LOG_LEVEL", &level);
+    if (katana::GetEnv("KATANA_LOG_ASYNC")) {
+      LogSink::Get().SetAsync(true);
+    }
+    return level;
+  }();
+  return min_level;
+}
+
 }  // end unnamed namespace
 
+bool
+katana::internal::IsLogged(katana::LogLevel level) {
+  // Only log KATANA_LOG_LEVEL and above (default, log everything)
+  return static_cast<int32_t>(level) >= MinLogLevel();
+}
+
 void
 katana::internal::LogString(katana::LogLevel level, const std::string& s) {
-  int env_log_level = static_cast<int32_t>(LogLevel::Debug);
-  GetEnv("KATANA_LOG_LEVEL", &env_log_level);
-  // Only log KATANA_LOG_LEVEL and above (default, log everything)
-  if (static_cast<int32_t>(level) < env_log_level) {
+  if (!IsLogged(level)) {
     return;
   }
 
-  switch (level) {
-  case LogLevel::Debug:
-    return PrintString(true, false, "DEBUG", s);
-  case LogLevel::Verbose:
-    return PrintString(true, false, "VERBOSE", s);
-  case LogLevel::Warning:
-    return PrintString(true, false, "WARNING", s);
-  case LogLevel::Error:
-    return PrintString(true, false, "ERROR", s);
-  default:
-    return PrintString(true, false, "UNKNOWN LOG LEVEL", s);
+  LogSink& sink = LogSink::Get();
+  if (!sink.async()) {
+    return PrintString(true, false, LevelPrefix(level), s);
+  }
+  sink.Write(true, fmt::format("{}: {}\n", LevelPrefix(level), s));
+  if (level == LogLevel::Error) {
+    // errors often come right before the application stops
+    sink.Drain();
   }
 }
 
+void
+katana::internal::WriteOutput(bool to_stderr, const std::string& text) {
+  MinLogLevel();
+  LogSink::Get().Write(to_stderr, text);
+}
+
+void
+katana::SetAsyncLogging(bool enabled) {
+  MinLogLevel();
+  LogSink::Get().SetAsync(enabled);
+}
+
+void
+katana::FlushLog() {
+  LogSink::Get().Drain();
+}
+
 void
 katana::AbortApplication() {
+  FlushLog();
   // TODO(amp): Replace this with an exception throw that can be caught in
   //  language wrappers to avoid low-level aborting the language runtime.
   std::abort();
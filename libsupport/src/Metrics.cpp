@@ -0,0 +1,181 @@
+#include "katana/Metrics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+#include "katana/Env.h"
+#include "katana/HTTP.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr int kDefaultPushIntervalSeconds = 15;
+
+bool
+IsValidName(const std::string& name) {
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+    return false;
+  }
+  for (char c : name) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != ':') {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Escapes backslashes and newlines, and quotes too in label values
+std::string
+Escape(const std::string& str, bool quotes) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '\\') {
+      escaped += "\\\\";
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else if (c == '"' && quotes) {
+      escaped += "\\\"";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string
+RenderLabels(const katana::MetricLabels& labels) {
+  if (labels.empty()) {
+    return "";
+  }
+  std::string rendered = "{";
+  for (const auto& [key, value] : labels) {
+    KATANA_LOG_VASSERT(IsValidName(key), "invalid label name {}", key);
+    if (rendered.size() > 1) {
+      rendered += ",";
+    }
+    rendered += fmt::format("{}=\"{}\"", key, Escape(value, true));
+  }
+  return rendered + "}";
+}
+
+std::string
+FormatValue(double v) {
+  if (std::isnan(v)) {
+    return "NaN";
+  }
+  if (std::isinf(v)) {
+    return v > 0 ? "+Inf" : "-Inf";
+  }
+  return fmt::format("{}", v);
+}
+
+}  // namespace
+
+katana::MetricsRegistry::Family&
+katana::MetricsRegistry::GetFamily(
+    const std::string& name, const std::string& help, bool is_counter) {
+  auto it = families_.find(name);
+  if (it == families_.end()) {
+    KATANA_LOG_VASSERT(IsValidName(name), "invalid metric name {}", name);
+    it = families_.emplace(name, Family{help, is_counter, {}, {}}).first;
+  }
+  KATANA_LOG_VASSERT(
+      it->second.is_counter == is_counter,
+      "metric {} is already registered with another type", name);
+  return it->second;
+}
+
+katana::MetricCounter&
+katana::MetricsRegistry::Counter(
+    const std::string& name, const std::string& help,
+    const MetricLabels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& counter = GetFamily(name, help, true).counters[RenderLabels(labels)];
+  if (!counter) {
+    counter = std::make_unique<MetricCounter>();
+  }
+  return *counter;
+}
+
+katana::MetricGauge&
+katana::MetricsRegistry::Gauge(
+    const std::string& name, const std::string& help,
+    const MetricLabels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& gauge = GetFamily(name, help, false).gauges[RenderLabels(labels)];
+  if (!gauge) {
+    gauge = std::make_unique<MetricGauge>();
+  }
+  return *gauge;
+}
+
+std::string
+katana::MetricsRegistry::ExportPrometheus() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string text;
+  for (const auto& [name, family] : families_) {
+    text += fmt::format(
+        "# HELP {} {}\n# TYPE {} {}\n", name, Escape(family.help, false), name,
+        family.is_counter ? "counter" : "gauge");
+    for (const auto& [labels, counter] : family.counters) {
+      text += fmt::format("{}{} {}\n", name, labels, counter->Value());
+    }
+    for (const auto& [labels, gauge] : family.gauges) {
+      text += fmt::format(
+          "{}{} {}\n", name, labels, FormatValue(gauge->Value()));
+    }
+  }
+  return text;
+}
+
+katana::MetricsRegistry&
+katana::GetMetrics() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+katana::Result<void>
+katana::PushMetrics(const std::string& url) {
+  std::vector<char> response;
+  return HttpPut(url, GetMetrics().ExportPrometheus(), &response);
+}
+
+katana::MetricsPusher::MetricsPusher(
+    std::string url, std::chrono::milliseconds interval)
+    : url_(std::move(url)), interval_(interval), thread_([this] { Run(); }) {}
+
+katana::MetricsPusher::~MetricsPusher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stop_cv_.notify_one();
+  thread_.join();
+}
+
+std::unique_ptr<katana::MetricsPusher>
+katana::MetricsPusher::MakeFromEnv() {
+  std::string url;
+  if (!GetEnv("KATANA_METRICS_PUSH_URL", &url) || url.empty()) {
+    return nullptr;
+  }
+  int seconds = kDefaultPushIntervalSeconds;
+  GetEnv("KATANA_METRICS_PUSH_INTERVAL", &seconds);
+  return std::make_unique<MetricsPusher>(
+      std::move(url), std::chrono::seconds(std::max(seconds, 1)));
+}
+
+void
+katana::MetricsPusher::Run() {
+  bool stop = false;
+  while (!stop) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      stop = stop_cv_.wait_for(lock, interval_, [this] { return stop_; });
+    }
+    if (auto res = PushMetrics(url_); !res) {
+      KATANA_LOG_WARN("pushing metrics to {}: {}", url_, res.error());
+    }
+  }
+}
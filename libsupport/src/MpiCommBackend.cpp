@@ -0,0 +1,237 @@
+#include "katana/MpiCommBackend.h"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+
+#include "katana/Logging.h"
+
+namespace {
+
+void
+Check(int ret, const char* what) {
+  if (ret != MPI_SUCCESS) {
+    char message[MPI_MAX_ERROR_STRING];
+    int len = 0;
+    MPI_Error_string(ret, message, &len);
+    KATANA_LOG_FATAL("{}: {}", what, std::string(message, len));
+  }
+}
+
+int
+ToCount(uint64_t size) {
+  KATANA_LOG_VASSERT(
+      size <= std::numeric_limits<int>::max(),
+      "MPI messages must be below 2 GB; got {} bytes", size);
+  return static_cast<int>(size);
+}
+
+/// Displacements of buffers of counts laid out one after another; returns
+/// the total count
+uint64_t
+Displacements(const std::vector<int>& counts, std::vector<int>* displs) {
+  uint64_t total = 0;
+  displs->resize(counts.size());
+  for (size_t i = 0; i < counts.size(); ++i) {
+    (*displs)[i] = ToCount(total);
+    total += counts[i];
+  }
+  ToCount(total);
+  return total;
+}
+
+}  // namespace
+
+struct katana::MpiCommBackend::PendingSend {
+  MPI_Request request;
+  std::string msg;
+};
+
+katana::MpiCommBackend::MpiCommBackend() {
+  int initialized = 0;
+  Check(MPI_Initialized(&initialized), "MPI_Initialized");
+  if (!initialized) {
+    int provided = 0;
+    Check(
+        MPI_Init_thread(nullptr, nullptr, MPI_THREAD_MULTIPLE, &provided),
+        "MPI_Init_thread");
+    if (provided < MPI_THREAD_MULTIPLE) {
+      KATANA_LOG_WARN(
+          "MPI does not support MPI_THREAD_MULTIPLE; communicate from one "
+          "thread at a time");
+    }
+    finalize_ = true;
+  }
+
+  int num = 0;
+  int rank = 0;
+  Check(MPI_Comm_size(MPI_COMM_WORLD, &num), "MPI_Comm_size");
+  Check(MPI_Comm_rank(MPI_COMM_WORLD, &rank), "MPI_Comm_rank");
+  Num = num;
+  Rank = rank;
+
+  MPI_Comm local;
+  Check(
+      MPI_Comm_split_type(
+          MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &local),
+      "MPI_Comm_split_type");
+  int local_rank = 0;
+  Check(MPI_Comm_rank(local, &local_rank), "MPI_Comm_rank");
+  LocalRank = local_rank;
+  Check(MPI_Comm_free(&local), "MPI_Comm_free");
+}
+
+katana::MpiCommBackend::~MpiCommBackend() {
+  WaitForSends();
+  if (finalize_) {
+    MPI_Finalize();
+  }
+}
+
+void
+katana::MpiCommBackend::Barrier() {
+  Check(MPI_Barrier(MPI_COMM_WORLD), "MPI_Barrier");
+}
+
+bool
+katana::MpiCommBackend::Broadcast(uint32_t root, bool val) {
+  char c = val ? 1 : 0;
+  Check(MPI_Bcast(&c, 1, MPI_CHAR, root, MPI_COMM_WORLD), "MPI_Bcast");
+  return c != 0;
+}
+
+std::string
+katana::MpiCommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  uint64_t size = Rank == root ? std::min<uint64_t>(val.size(), max_size) : 0;
+  Check(
+      MPI_Bcast(&size, 1, MPI_UINT64_T, root, MPI_COMM_WORLD), "MPI_Bcast");
+  std::string ret = Rank == root ? val.substr(0, size) : std::string(size, 0);
+  Check(
+      MPI_Bcast(ret.data(), ToCount(size), MPI_CHAR, root, MPI_COMM_WORLD),
+      "MPI_Bcast");
+  return ret;
+}
+
+void
+katana::MpiCommBackend::NotifyFailure() {
+  MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+}
+
+std::vector<uint64_t>
+katana::MpiCommBackend::AllReduceSum(const std::vector<uint64_t>& vals) {
+  std::vector<uint64_t> sum(vals.size());
+  Check(
+      MPI_Allreduce(
+          vals.data(), sum.data(), ToCount(vals.size()), MPI_UINT64_T, MPI_SUM,
+          MPI_COMM_WORLD),
+      "MPI_Allreduce");
+  return sum;
+}
+
+std::vector<std::string>
+katana::MpiCommBackend::AllGatherBytes(const std::string& val) {
+  int count = ToCount(val.size());
+  std::vector<int> counts(Num);
+  Check(
+      MPI_Allgather(
+          &count, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD),
+      "MPI_Allgather");
+
+  std::vector<int> displs;
+  std::string all(Displacements(counts, &displs), 0);
+  Check(
+      MPI_Allgatherv(
+          val.data(), count, MPI_CHAR, all.data(), counts.data(),
+          displs.data(), MPI_CHAR, MPI_COMM_WORLD),
+      "MPI_Allgatherv");
+
+  std::vector<std::string> ret(Num);
+  for (uint32_t r = 0; r < Num; ++r) {
+    ret[r] = all.substr(displs[r], counts[r]);
+  }
+  return ret;
+}
+
+std::vector<std::string>
+katana::MpiCommBackend::AllToAllBytes(const std::vector<std::string>& to_each) {
+  KATANA_LOG_ASSERT(to_each.size() == Num);
+  std::vector<int> send_counts(Num);
+  std::string send;
+  for (uint32_t r = 0; r < Num; ++r) {
+    send_counts[r] = ToCount(to_each[r].size());
+    send += to_each[r];
+  }
+  std::vector<int> recv_counts(Num);
+  Check(
+      MPI_Alltoall(
+          send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+          MPI_COMM_WORLD),
+      "MPI_Alltoall");
+
+  std::vector<int> send_displs;
+  std::vector<int> recv_displs;
+  Displacements(send_counts, &send_displs);
+  std::string recv(Displacements(recv_counts, &recv_displs), 0);
+  Check(
+      MPI_Alltoallv(
+          send.data(), send_counts.data(), send_displs.data(), MPI_CHAR,
+          recv.data(), recv_counts.data(), recv_displs.data(), MPI_CHAR,
+          MPI_COMM_WORLD),
+      "MPI_Alltoallv");
+
+  std::vector<std::string> ret(Num);
+  for (uint32_t r = 0; r < Num; ++r) {
+    ret[r] = recv.substr(recv_displs[r], recv_counts[r]);
+  }
+  return ret;
+}
+
+void
+katana::MpiCommBackend::Send(uint32_t dest, uint32_t tag, std::string msg) {
+  KATANA_LOG_VASSERT(tag < kMaxTag, "tag {} is reserved", tag);
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  // Reap the sends that completed so that pending_ does not grow forever
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    int done = 0;
+    Check(MPI_Test(&it->request, &done, MPI_STATUS_IGNORE), "MPI_Test");
+    it = done ? pending_.erase(it) : std::next(it);
+  }
+
+  PendingSend& send = pending_.emplace_back(PendingSend{{}, std::move(msg)});
+  Check(
+      MPI_Isend(
+          send.msg.data(), ToCount(send.msg.size()), MPI_CHAR, dest, tag,
+          MPI_COMM_WORLD, &send.request),
+      "MPI_Isend");
+}
+
+std::string
+katana::MpiCommBackend::Receive(uint32_t src, uint32_t tag) {
+  KATANA_LOG_VASSERT(tag < kMaxTag, "tag {} is reserved", tag);
+  // A matched probe so that another thread cannot take the message between
+  // the probe and the receive
+  MPI_Message message;
+  MPI_Status status;
+  Check(
+      MPI_Mprobe(src, tag, MPI_COMM_WORLD, &message, &status), "MPI_Mprobe");
+  int count = 0;
+  Check(MPI_Get_count(&status, MPI_CHAR, &count), "MPI_Get_count");
+  std::string msg(count, 0);
+  Check(
+      MPI_Mrecv(msg.data(), count, MPI_CHAR, &message, MPI_STATUS_IGNORE),
+      "MPI_Mrecv");
+  return msg;
+}
+
+void
+katana::MpiCommBackend::WaitForSends() {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  for (PendingSend& send : pending_) {
+    Check(MPI_Wait(&send.request, MPI_STATUS_IGNORE), "MPI_Wait");
+  }
+  pending_.clear();
+}
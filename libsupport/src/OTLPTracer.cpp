@@ -0,0 +1,300 @@
+#include "katana/OTLPTracer.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <variant>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Env.h"
+#include "katana/Random.h"
+
+namespace {
+
+std::mutex output_mutex;
+
+constexpr size_t kTraceIDLength = 32;
+constexpr size_t kSpanIDLength = 16;
+
+uint64_t
+NowUnixNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+/// A random id of length hex digits, which is never all zeros; those are
+/// invalid ids in OpenTelemetry
+std::string
+GenerateID(size_t length) {
+  std::uniform_int_distribution<uint64_t> dist(
+      1, std::numeric_limits<uint64_t>::max());
+  std::string id;
+  while (id.size() < length) {
+    id += fmt::format("{:016x}", dist(katana::GetGenerator()));
+  }
+  return id;
+}
+
+bool
+IsID(const std::string& id, size_t length) {
+  if (id.size() != length) {
+    return false;
+  }
+  bool nonzero = false;
+  for (unsigned char c : id) {
+    if (!std::isxdigit(c) || std::isupper(c)) {
+      return false;
+    }
+    nonzero |= c != '0';
+  }
+  return nonzero;
+}
+
+nlohmann::json
+AnyValue(const katana::Value& value) {
+  nlohmann::json any;
+  std::visit(
+      [&any](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, bool>) {
+          any["boolValue"] = v;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+          any["stringValue"] = v;
+        } else if constexpr (std::is_same_v<T, const char*>) {
+          any["stringValue"] = std::string(v);
+        } else if constexpr (std::is_floating_point_v<T>) {
+          any["doubleValue"] = v;
+        } else if constexpr (std::is_unsigned_v<T>) {
+          // OTLP integers are signed 64 bit, written as strings
+          if (v > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            any["doubleValue"] = static_cast<double>(v);
+          } else {
+            any["intValue"] = std::to_string(v);
+          }
+        } else {
+          any["intValue"] = std::to_string(v);
+        }
+      },
+      static_cast<const katana::variant_type&>(value));
+  return any;
+}
+
+nlohmann::json
+Attributes(const katana::Tags& tags) {
+  nlohmann::json attributes = nlohmann::json::array();
+  for (const auto& [key, value] : tags) {
+    attributes.push_back({{"key", key}, {"value", AnyValue(value)}});
+  }
+  return attributes;
+}
+
+std::string
+GetResourceJSON(uint32_t host_id, uint32_t num_hosts) {
+  std::string service_name{"katana"};
+  katana::GetEnv("OTEL_SERVICE_NAME", &service_name);
+  katana::HostStats host_stats = katana::ProgressTracer::GetHostStats();
+
+  nlohmann::json resource;
+  resource["attributes"] = Attributes({
+      {"service.name", service_name},
+      {"host.name", host_stats.hostname},
+      {"process.pid", static_cast<int64_t>(host_stats.pid)},
+      {"katana.host_id", host_id},
+      {"katana.num_hosts", num_hosts},
+  });
+  return resource.dump();
+}
+
+void
+OutputOTLP(const katana::OutputCB& out_callback, const std::string& output) {
+  std::lock_guard<std::mutex> lock(output_mutex);
+  out_callback(output);
+}
+
+}  // namespace
+
+katana::OTLPTracer::OTLPTracer(
+    uint32_t host_id, uint32_t num_hosts, OutputCB out_callback)
+    : ProgressTracer(host_id, num_hosts),
+      out_callback_(std::move(out_callback)),
+      resource_json_(std::make_shared<const std::string>(
+          GetResourceJSON(host_id, num_hosts))) {
+  if (std::string carrier; GetEnv("TRACEPARENT", &carrier)) {
+    remote_parent_ = Extract(carrier);
+    if (remote_parent_ == nullptr) {
+      KATANA_LOG_WARN("ignoring invalid TRACEPARENT: {}", carrier);
+    }
+  }
+}
+
+std::unique_ptr<katana::OTLPTracer>
+katana::OTLPTracer::Make(uint32_t host_id, uint32_t num_hosts) {
+  return std::unique_ptr<OTLPTracer>(new OTLPTracer(
+      host_id, num_hosts,
+      [](const std::string& output) { std::cout << output; }));
+}
+
+std::unique_ptr<katana::OTLPTracer>
+katana::OTLPTracer::Make(
+    uint32_t host_id, uint32_t num_hosts, katana::OutputCB out_callback) {
+  return std::unique_ptr<OTLPTracer>(
+      new OTLPTracer(host_id, num_hosts, std::move(out_callback)));
+}
+
+katana::Result<std::unique_ptr<katana::OTLPTracer>>
+katana::OTLPTracer::MakeFile(
+    const std::string& path, uint32_t host_id, uint32_t num_hosts) {
+  auto file = std::make_shared<std::ofstream>(path, std::ios_base::app);
+  if (!file->good()) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "opening trace file {}", std::quoted(path));
+  }
+  return std::unique_ptr<OTLPTracer>(new OTLPTracer(
+      host_id, num_hosts, [file](const std::string& output) {
+        // flush every span, so that a collector tailing the file sees it
+        // right away, and so that a crash does not lose it
+        *file << output << std::flush;
+      }));
+}
+
+std::shared_ptr<katana::ProgressSpan>
+katana::OTLPTracer::StartSpan(
+    const std::string& span_name, const katana::ProgressContext& child_of) {
+  std::string trace_id = child_of.GetTraceID();
+  std::string parent_span_id = child_of.GetSpanID();
+  if (!IsID(trace_id, kTraceIDLength) || !IsID(parent_span_id, kSpanIDLength)) {
+    trace_id = GenerateID(kTraceIDLength);
+    parent_span_id.clear();
+  }
+  return std::shared_ptr<OTLPSpan>(new OTLPSpan(
+      span_name, nullptr, trace_id, std::move(parent_span_id), out_callback_,
+      resource_json_));
+}
+
+std::shared_ptr<katana::ProgressSpan>
+katana::OTLPTracer::StartSpan(
+    const std::string& span_name,
+    std::shared_ptr<katana::ProgressSpan> child_of) {
+  std::string trace_id;
+  std::string parent_span_id;
+  if (child_of != nullptr) {
+    trace_id = child_of->GetContext().GetTraceID();
+    parent_span_id = child_of->GetContext().GetSpanID();
+  } else if (remote_parent_ != nullptr) {
+    trace_id = remote_parent_->GetTraceID();
+    parent_span_id = remote_parent_->GetSpanID();
+  } else {
+    trace_id = GenerateID(kTraceIDLength);
+  }
+  return std::shared_ptr<OTLPSpan>(new OTLPSpan(
+      span_name, std::move(child_of), trace_id, std::move(parent_span_id),
+      out_callback_, resource_json_));
+}
+
+std::string
+katana::OTLPTracer::Inject(const katana::ProgressContext& ctx) {
+  return fmt::format("00-{}-{}-01", ctx.GetTraceID(), ctx.GetSpanID());
+}
+
+std::unique_ptr<katana::ProgressContext>
+katana::OTLPTracer::Extract(const std::string& carrier) {
+  // version-trace_id-span_id-flags
+  constexpr size_t kLength = 2 + 1 + kTraceIDLength + 1 + kSpanIDLength + 1 + 2;
+  if (carrier.size() != kLength || carrier[2] != '-' ||
+      carrier[3 + kTraceIDLength] != '-' ||
+      carrier[4 + kTraceIDLength + kSpanIDLength] != '-') {
+    return nullptr;
+  }
+  std::string trace_id = carrier.substr(3, kTraceIDLength);
+  std::string span_id = carrier.substr(4 + kTraceIDLength, kSpanIDLength);
+  if (!IsID(trace_id, kTraceIDLength) || !IsID(span_id, kSpanIDLength)) {
+    return nullptr;
+  }
+  return std::unique_ptr<OTLPContext>(new OTLPContext(trace_id, span_id));
+}
+
+std::unique_ptr<katana::ProgressContext>
+katana::OTLPContext::Clone() const noexcept {
+  return std::unique_ptr<OTLPContext>(new OTLPContext(trace_id_, span_id_));
+}
+
+katana::OTLPSpan::OTLPSpan(
+    const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent,
+    const std::string& trace_id, std::string parent_span_id,
+    OutputCB out_callback, std::shared_ptr<const std::string> resource_json)
+    : ProgressSpan(std::move(parent)),
+      context_(OTLPContext{trace_id, GenerateID(kSpanIDLength)}),
+      span_name_(span_name),
+      parent_span_id_(std::move(parent_span_id)),
+      start_unix_ns_(NowUnixNs()),
+      out_callback_(std::move(out_callback)),
+      resource_json_(std::move(resource_json)) {}
+
+void
+katana::OTLPSpan::SetTags(const katana::Tags& tags) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tags_.insert(tags_.end(), tags.begin(), tags.end());
+}
+
+void
+katana::OTLPSpan::Log(const std::string& message, const katana::Tags& tags) {
+  Event event{message, NowUnixNs(), tags};
+  event.tags.emplace_back(
+      "max_mem_gb", ProgressTracer::GetMaxMem() / 1024.0 / 1024.0);
+  event.tags.emplace_back(
+      "mem_gb",
+      ProgressTracer::ParseProcSelfRssBytes() / 1024.0 / 1024.0 / 1024.0);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.emplace_back(std::move(event));
+}
+
+void
+katana::OTLPSpan::Close() {
+  nlohmann::json span;
+  span["traceId"] = context_.GetTraceID();
+  span["spanId"] = context_.GetSpanID();
+  if (!parent_span_id_.empty()) {
+    span["parentSpanId"] = parent_span_id_;
+  }
+  span["name"] = span_name_;
+  // SPAN_KIND_INTERNAL
+  span["kind"] = 1;
+  span["startTimeUnixNano"] = std::to_string(start_unix_ns_);
+  span["endTimeUnixNano"] = std::to_string(NowUnixNs());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    span["attributes"] = Attributes(tags_);
+    nlohmann::json events = nlohmann::json::array();
+    for (const Event& event : events_) {
+      events.push_back(
+          {{"timeUnixNano", std::to_string(event.time_unix_ns)},
+           {"name", event.name},
+           {"attributes", Attributes(event.tags)}});
+    }
+    span["events"] = std::move(events);
+
+    for (const auto& [key, value] : tags_) {
+      if (key == "error" && std::holds_alternative<bool>(value) &&
+          std::get<bool>(value)) {
+        // STATUS_CODE_ERROR
+        span["status"] = {{"code", 2}};
+      }
+    }
+  }
+
+  std::string output = fmt::format(
+      R"({{"resourceSpans":[{{"resource":{},"scopeSpans":[{{"scope":{{"name":"katana"}},"spans":[{}]}}]}}]}})"
+      "\n",
+      *resource_json_, span.dump());
+  OutputOTLP(out_callback_, output);
+}
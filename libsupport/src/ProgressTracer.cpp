@@ -3,9 +3,11 @@
 #include <sys/resource.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <fstream>
 #include <regex>
 
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/config.h"
 
@@ -22,6 +24,47 @@
 std::unique_ptr<katana::ProgressTracer> katana::ProgressTracer::tracer_ =
     nullptr;
 
+namespace {
+
+class IgnoredContext : public katana::ProgressContext {
+public:
+  std::unique_ptr<ProgressContext> Clone() const noexcept override {
+    return std::make_unique<IgnoredContext>();
+  }
+};
+
+/// The detached span of an operation that is not traced
+class IgnoredSpan : public katana::ProgressSpan {
+public:
+  IgnoredSpan() : ProgressSpan(nullptr) {}
+  ~IgnoredSpan() override { Finish(); }
+
+  void SetTags([[maybe_unused]] const katana::Tags& tags) override {}
+  void Log(
+      [[maybe_unused]] const std::string& message,
+      [[maybe_unused]] const katana::Tags& tags) override {}
+  const katana::ProgressContext& GetContext() const noexcept override {
+    return context_;
+  }
+
+private:
+  void Close() override {}
+
+  IgnoredContext context_;
+};
+
+uint64_t
+ProcessCpuUs() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  auto us = [](const timeval& tv) {
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+  };
+  return us(usage.ru_utime) + us(usage.ru_stime);
+}
+
+}  // namespace
+
 katana::ProgressTracer&
 katana::GetTracer() {
   return katana::ProgressTracer::Get();
@@ -130,11 +173,37 @@ katana::ProgressTracer::StartActiveSpan(
   return SetActiveSpan(StartSpan(span_name, child_of));
 }
 
+std::shared_ptr<katana::ProgressSpan>
+katana::ProgressTracer::StartDetachedSpan(const std::string& span_name) {
+  std::shared_ptr<ProgressSpan> span;
+  if (!TracesOperations()) {
+    span = std::make_shared<IgnoredSpan>();
+  } else {
+    std::shared_ptr<ProgressSpan> parent;
+    {
+      std::lock_guard<std::mutex> lock(active_span_mutex_);
+      parent = active_span_;
+    }
+    span = StartSpan(span_name, std::move(parent));
+  }
+  span->detached_ = true;
+  return span;
+}
+
+bool
+katana::ProgressTracer::TracesOperations() {
+  static bool traces = [] {
+    bool value = false;
+    return katana::GetEnv("KATANA_TRACE_OPERATIONS", &value) && value;
+  }();
+  return traces;
+}
+
 void
 katana::ProgressTracer::FinishActiveSpan() {
   if (active_span_ != nullptr) {
     auto old_active_span = active_span_;
-    active_span_ = old_active_span->GetParentSpan();
+    ReplaceActiveSpan(old_active_span->GetParentSpan());
     if (!old_active_span->IsFinished()) {
       old_active_span->Finish();
     }
@@ -161,10 +230,22 @@ katana::ProgressTracer::GetActiveSpan() {
 katana::ProgressScope
 katana::ProgressTracer::SetActiveSpan(
     std::shared_ptr<katana::ProgressSpan> span) {
-  active_span_ = span;
+  ReplaceActiveSpan(span);
   return ProgressScope(std::move(span));
 }
 
+void
+katana::ProgressTracer::ReplaceActiveSpan(
+    std::shared_ptr<katana::ProgressSpan> span) {
+  std::shared_ptr<ProgressSpan> old_active_span;
+  {
+    std::lock_guard<std::mutex> lock(active_span_mutex_);
+    old_active_span = std::move(active_span_);
+    active_span_ = std::move(span);
+  }
+  // the old span may finish when it is released, which may need the lock
+}
+
 void
 katana::ProgressTracer::Finish() {
   while (HasActiveSpan()) {
@@ -174,7 +255,7 @@ katana::ProgressTracer::Finish() {
     default_active_span_->Finish();
   }
 
-  active_span_ = nullptr;
+  ReplaceActiveSpan(nullptr);
   default_active_span_ = nullptr;
 
   Close();
@@ -247,8 +328,70 @@ katana::ProgressSpan::Finish() {
     finished_ = true;
     Close();
   }
+  if (detached_) {
+    return;
+  }
   ProgressTracer& tracer = ProgressTracer::Get();
   if (tracer.HasActiveSpan() && this == &tracer.GetActiveSpan()) {
     tracer.FinishActiveSpan();
   }
 }
+
+katana::OperationSpan::OperationSpan(
+    const std::string& span_name, const katana::Tags& tags) {
+  if (!ProgressTracer::TracesOperations()) {
+    return;
+  }
+  span_ = GetTracer().StartDetachedSpan(span_name);
+  if (!tags.empty()) {
+    span_->SetTags(tags);
+  }
+  begin_ = Now();
+  begin_cpu_us_ = ProcessCpuUs();
+}
+
+katana::OperationSpan::OperationSpan(katana::OperationSpan&& other) noexcept
+    : span_(std::move(other.span_)),
+      begin_(other.begin_),
+      begin_cpu_us_(other.begin_cpu_us_) {}
+
+void
+katana::OperationSpan::SetTags(const katana::Tags& tags) {
+  if (span_ != nullptr) {
+    span_->SetTags(tags);
+  }
+}
+
+void
+katana::OperationSpan::SetError(const std::string& error) {
+  if (span_ != nullptr) {
+    span_->SetTags({{"error", true}, {"error.context", error}});
+  }
+}
+
+void
+katana::OperationSpan::Finish() {
+  if (span_ == nullptr) {
+    return;
+  }
+  uint64_t latency_us = UsSince(begin_);
+  uint64_t cpu_us = ProcessCpuUs() - begin_cpu_us_;
+  double busy_threads =
+      latency_us == 0 ? 0.0 : static_cast<double>(cpu_us) / latency_us;
+  span_->SetTags({{"latency_us", latency_us}, {"busy_threads", busy_threads}});
+  span_->Finish();
+  span_ = nullptr;
+}
+
+void
+katana::OperationSpan::Finish(uint64_t bytes) {
+  if (span_ == nullptr) {
+    return;
+  }
+  uint64_t latency_us = std::max<uint64_t>(UsSince(begin_), 1);
+  // bytes per microsecond are megabytes per second
+  span_->SetTags(
+      {{"bytes", bytes},
+       {"mb_per_s", static_cast<double>(bytes) / latency_us}});
+  Finish();
+}
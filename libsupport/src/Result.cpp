@@ -1,6 +1,10 @@
 #include "katana/Result.h"
 
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string_view>
 
 namespace {
 
@@ -8,6 +12,27 @@ struct Header {
   int size{};
 };
 
+enum class SegmentKind : uint8_t {
+  kText,
+  kLazy,
+};
+
+/// The header of a piece of context. It is followed by the text of the
+/// context or by a lazy record: a LazyFormatFn and the record it formats.
+struct SegmentHeader {
+  uint16_t size;
+  SegmentKind kind;
+};
+
+std::string
+FormatErrorCode(const char* record) {
+  std::error_code ec;
+  std::memcpy(&ec, record, sizeof(ec));
+  return ec.message();
+}
+
+static_assert(std::is_trivially_copyable_v<std::error_code>);
+
 }  // namespace
 
 /// A Context is additional information attached to an ErrorInfo. It is
@@ -18,12 +43,15 @@ struct Header {
 ///
 /// Because there is only one thread local buffer, but it is possible for users
 /// to create multiple ErrorInfo objects at a time, we use a fat pointer
-/// std::pair<Context*,int> to Context to check that uses of ErrorInfo are
-/// linear (i.e., updates only happen at the most recent value). This check is
-/// only best-effort. A more precise implementation would be to atomically
+/// (Context*, size) to Context to check that uses of ErrorInfo are linear
+/// (i.e., updates only happen at the most recent value). This check is only
+/// best-effort. A more precise implementation would be to atomically
 /// increment a version number.
 ///
 /// Our most common operation is prepend, so Context::data_ grows from its end.
+/// The context is a sequence of segments, each either text or a lazy record
+/// that is formatted when the context is written. Segments are separated by
+/// ": " when written.
 ///
 /// Doxygen does not like out-of-line nested structs
 /// \cond DO_NOT_DOCUMENT
@@ -40,24 +68,77 @@ public:
 
   char* end() { return data_.end(); }
 
-  void Prepend(const char* start, const char* end) {
-    size_t remaining = data_.size() - header_.size;
+  /// PrependText adds a text segment, truncating the beginning of the text if
+  /// it does not fit
+  void PrependText(const char* start, const char* end) {
     size_t len = std::distance(start, end);
+    size_t remaining = Remaining();
     if (remaining < len) {
       start += len - remaining;
       len = remaining;
     }
+    if (len == 0) {
+      return;
+    }
 
     header_.size += len;
-
     std::copy(start, end, begin());
+    PrependHeader(len, SegmentKind::kText);
+  }
+
+  /// PrependLazy adds a lazy segment if it fits and returns whether it did
+  bool PrependLazy(
+      katana::internal::LazyFormatFn format, const char* record,
+      size_t record_size) {
+    size_t len = sizeof(format) + record_size;
+    if (Remaining() < len) {
+      return false;
+    }
+
+    header_.size += len;
+    std::memcpy(begin(), &format, sizeof(format));
+    std::memcpy(begin() + sizeof(format), record, record_size);
+    PrependHeader(len, SegmentKind::kLazy);
+    return true;
+  }
+
+  /// ForEach calls fn with the text of each segment from first to last
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    for (const char* seg = begin(); seg < end();) {
+      SegmentHeader header;
+      std::memcpy(&header, seg, sizeof(header));
+      const char* payload = seg + sizeof(header);
+      if (header.kind == SegmentKind::kText) {
+        fn(std::string_view(payload, header.size));
+      } else {
+        katana::internal::LazyFormatFn format;
+        std::memcpy(&format, payload, sizeof(format));
+        fn(std::string_view(format(payload + sizeof(format))));
+      }
+      seg = payload + header.size;
+    }
   }
 
   int size() const { return header_.size; }
 
+  bool full() const { return Remaining() == 0; }
+
   void reset() { header_.size = 0; }
 
 private:
+  size_t Remaining() const {
+    size_t remaining = data_.size() - header_.size;
+    return remaining > sizeof(SegmentHeader) ? remaining - sizeof(SegmentHeader)
+                                             : 0;
+  }
+
+  void PrependHeader(size_t len, SegmentKind kind) {
+    SegmentHeader header{static_cast<uint16_t>(len), kind};
+    header_.size += sizeof(header);
+    std::memcpy(begin(), &header, sizeof(header));
+  }
+
   Header header_;
   std::array<char, kDataSize> data_;
 };
@@ -70,6 +151,10 @@ thread_local katana::ErrorInfo::Context kContext;
 
 }  // namespace
 
+static_assert(
+    sizeof(katana::ErrorInfo) == 2 * sizeof(int) + 2 * sizeof(void*),
+    "ErrorInfo should be no larger than an error_code and a pointer");
+
 katana::ErrorInfo::ErrorInfo(const CopyableErrorInfo& cei)
     : ErrorInfo(cei.error_code(), cei.message()) {}
 
@@ -77,6 +162,17 @@ static_assert(
     fmt::inline_buffer_size > katana::ErrorInfo::kContextSize / 2,
     "libfmt buffer size is small relative to max ErrorInfo context size");
 
+const char*
+katana::internal::SourceBaseName(const char* file_name) {
+  const char* base_name = std::strrchr(file_name, '/');
+  return base_name ? base_name + 1 : file_name;
+}
+
+std::string
+katana::internal::FormatLazy(const SourceInfo& info) {
+  return fmt::format(FMT_STRING("({}:{})"), info.file_name, info.line_no);
+}
+
 inline void
 katana::ErrorInfo::CheckContext() {
   // This assert can fail for a few reasons:
@@ -84,8 +180,8 @@ katana::ErrorInfo::CheckContext() {
   // 2) two ErrorInfos or Results being used at the same time on a thread,
   // 3) multiple copies of libsupport.
   KATANA_LOG_DEBUG_VASSERT(
-      (!context_.first || context_.first == &kContext) &&
-          (!context_.first || context_.first->size() == context_.second),
+      (!context_ || context_ == &kContext) &&
+          (!context_ || context_->size() == context_size_),
       "ErrorInfo object does not match thread-local ErrorInfo data. An "
       "ErrorInfo or Result is probably being misused. Probable original error: "
       "{}",
@@ -96,10 +192,11 @@ void
 katana::ErrorInfo::SpillMessage() {
   CheckContext();
 
-  if (!context_.first) {
-    std::string msg = error_code_.message();
-    const char* start = msg.c_str();
-    Prepend(start, start + msg.size());
+  if (!context_) {
+    // The message of the error code is only made if the error is written
+    std::error_code ec = error_code();
+    PrependLazy(
+        &FormatErrorCode, reinterpret_cast<const char*>(&ec), sizeof(ec));
   }
 }
 
@@ -110,31 +207,54 @@ void
 katana::ErrorInfo::Prepend(const char* begin, const char* end) {
   CheckContext();
 
-  if (context_.first) {
-    constexpr std::array<char, 2> kSep = {':', ' '};
-    context_.first->Prepend(kSep.begin(), kSep.end());
-  } else {
-    context_.first = &kContext;
-    context_.first->reset();
+  if (!context_) {
+    context_ = &kContext;
+    context_->reset();
   }
 
-  context_.first->Prepend(begin, end);
-  context_.second = context_.first->size();
+  context_->PrependText(begin, end);
+  context_size_ = context_->size();
+}
+
+void
+katana::ErrorInfo::PrependLazy(
+    internal::LazyFormatFn format, const char* record, size_t size) {
+  CheckContext();
+
+  if (!context_) {
+    context_ = &kContext;
+    context_->reset();
+  }
+
+  // Context that does not fit is truncated like text, and not formatted at
+  // all once the context is full
+  if (!context_->PrependLazy(format, record, size) && !context_->full()) {
+    std::string text = format(record);
+    context_->PrependText(text.data(), text.data() + text.size());
+  }
+  context_size_ = context_->size();
 }
 
 std::ostream&
 katana::ErrorInfo::Write(std::ostream& out) const {
-  if ((context_.first && context_.first != &kContext) ||
-      (context_.first && context_.first->size() != context_.second)) {
+  if ((context_ && context_ != &kContext) ||
+      (context_ && context_->size() != context_size_)) {
     KATANA_LOG_WARN(
         "ErrorInfo object does not match thread-local ErrorInfo data. Error "
         "messages may be corrupted.");
   }
 
-  if (!context_.first) {
+  if (!context_) {
     out << error_code().message();
   } else {
-    out << std::string_view(context_.first->begin(), context_.first->size());
+    bool first = true;
+    context_->ForEach([&](std::string_view text) {
+      if (!first) {
+        out << ": ";
+      }
+      first = false;
+      out << text;
+    });
   }
 
   return out;
@@ -0,0 +1,449 @@
+#include "katana/TcpCommBackend.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <functional>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Strings.h"
+
+namespace {
+
+constexpr uint32_t kCollectiveTag = katana::CommBackend::kMaxTag;
+constexpr uint32_t kAbortTag = katana::CommBackend::kMaxTag + 1;
+constexpr auto kRetryInterval = std::chrono::milliseconds(100);
+
+struct Header {
+  uint32_t tag;
+  uint32_t unused;
+  uint64_t size;
+};
+
+bool
+WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool
+ReadAll(int fd, char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = recv(fd, data, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+katana::Result<std::pair<std::string, std::string>>
+SplitAddress(const std::string& address) {
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos || colon == 0 ||
+      colon + 1 == address.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "address {} is not of the form host:port", address);
+  }
+  return std::make_pair(address.substr(0, colon), address.substr(colon + 1));
+}
+
+/// A socket for address, bound and listening if passive and connected
+/// otherwise
+katana::Result<int>
+OpenSocket(const std::string& address, bool passive) {
+  auto [host, port] = KATANA_CHECKED(SplitAddress(address));
+
+  struct addrinfo hints {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = passive ? AI_PASSIVE : 0;
+  struct addrinfo* infos = nullptr;
+  if (int ret = getaddrinfo(host.c_str(), port.c_str(), &hints, &infos);
+      ret != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "resolving {}: {}", address,
+        gai_strerror(ret));
+  }
+
+  int fd = -1;
+  std::error_code ec;
+  for (struct addrinfo* info = infos; info != nullptr && fd < 0;
+       info = info->ai_next) {
+    fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd < 0) {
+      ec = katana::ResultErrno();
+      continue;
+    }
+    int one = 1;
+    bool ok;
+    if (passive) {
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      ok = bind(fd, info->ai_addr, info->ai_addrlen) == 0 &&
+           listen(fd, SOMAXCONN) == 0;
+    } else {
+      ok = connect(fd, info->ai_addr, info->ai_addrlen) == 0;
+    }
+    if (!ok) {
+      ec = katana::ResultErrno();
+      close(fd);
+      fd = -1;
+      continue;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  freeaddrinfo(infos);
+
+  if (fd < 0) {
+    return KATANA_ERROR(
+        ec, "{} {}", passive ? "listening on" : "connecting to", address);
+  }
+  return fd;
+}
+
+}  // namespace
+
+katana::TcpCommBackend::TcpCommBackend(uint32_t rank, uint32_t num)
+    : peers_(num) {
+  Num = num;
+  Rank = rank;
+}
+
+katana::Result<std::unique_ptr<katana::TcpCommBackend>>
+katana::TcpCommBackend::Make(
+    uint32_t rank, const std::vector<std::string>& addresses,
+    int timeout_seconds) {
+  if (rank >= addresses.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "rank {} of {} tasks", rank,
+        addresses.size());
+  }
+
+  std::unique_ptr<TcpCommBackend> comm(
+      new TcpCommBackend(rank, addresses.size()));
+  KATANA_CHECKED(comm->Connect(addresses, timeout_seconds));
+
+  std::string host = KATANA_CHECKED(SplitAddress(addresses[rank])).first;
+  for (uint32_t r = 0; r < rank; ++r) {
+    if (KATANA_CHECKED(SplitAddress(addresses[r])).first == host) {
+      comm->LocalRank += 1;
+    }
+  }
+
+  comm->Start();
+  return std::unique_ptr<TcpCommBackend>(std::move(comm));
+}
+
+katana::Result<std::unique_ptr<katana::TcpCommBackend>>
+katana::TcpCommBackend::MakeFromEnv() {
+  std::string addresses;
+  int rank = 0;
+  if (!GetEnv("KATANA_COMM_ADDRESSES", &addresses) ||
+      !GetEnv("KATANA_COMM_RANK", &rank) || rank < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "KATANA_COMM_ADDRESSES and KATANA_COMM_RANK must be set");
+  }
+  std::vector<std::string> list;
+  for (std::string_view address : SplitView(addresses, ",")) {
+    list.emplace_back(address);
+  }
+  return Make(rank, list);
+}
+
+katana::Result<void>
+katana::TcpCommBackend::Connect(
+    const std::vector<std::string>& addresses, int timeout_seconds) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::seconds(timeout_seconds);
+
+  int listen_fd = KATANA_CHECKED(OpenSocket(addresses[Rank], true));
+
+  // Lower ranks may not be listening yet, so retry until the deadline
+  for (uint32_t r = 0; r < Rank; ++r) {
+    while (true) {
+      auto fd = OpenSocket(addresses[r], false);
+      if (fd) {
+        peers_[r].fd = fd.value();
+        break;
+      }
+      if (std::chrono::steady_clock::now() > deadline) {
+        close(listen_fd);
+        return fd.error().WithContext("waiting for task {}", r);
+      }
+      std::this_thread::sleep_for(kRetryInterval);
+    }
+    if (!WriteAll(
+            peers_[r].fd, reinterpret_cast<const char*>(&Rank),
+            sizeof(Rank))) {
+      close(listen_fd);
+      return KATANA_ERROR(ResultErrno(), "greeting task {}", r);
+    }
+  }
+
+  for (uint32_t n = Rank + 1; n < Num; ++n) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    struct pollfd pfd {
+      listen_fd, POLLIN, 0
+    };
+    if (remaining.count() <= 0 || poll(&pfd, 1, remaining.count()) != 1) {
+      close(listen_fd);
+      return KATANA_ERROR(
+          ErrorCode::MpiError, "timed out waiting for {} tasks to connect",
+          Num - n);
+    }
+    int fd = accept(listen_fd, nullptr, nullptr);
+    uint32_t r = 0;
+    if (fd < 0 ||
+        !ReadAll(fd, reinterpret_cast<char*>(&r), sizeof(r)) || r <= Rank ||
+        r >= Num || peers_[r].fd >= 0) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      close(listen_fd);
+      return KATANA_ERROR(
+          ErrorCode::MpiError, "bad connection to task {} from another task",
+          Rank);
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    peers_[r].fd = fd;
+  }
+
+  close(listen_fd);
+  return ResultSuccess();
+}
+
+void
+katana::TcpCommBackend::Start() {
+  for (uint32_t r = 0; r < Num; ++r) {
+    if (r == Rank) {
+      continue;
+    }
+    peers_[r].sender = std::thread([this, r]() { SendLoop(r); });
+    peers_[r].receiver = std::thread([this, r]() { ReceiveLoop(r); });
+  }
+}
+
+katana::TcpCommBackend::~TcpCommBackend() {
+  WaitForSends();
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    stopping_ = true;
+  }
+  send_cv_.notify_all();
+
+  for (Peer& peer : peers_) {
+    if (peer.sender.joinable()) {
+      peer.sender.join();
+    }
+    if (peer.fd >= 0) {
+      shutdown(peer.fd, SHUT_WR);
+    }
+  }
+  // Receivers finish when their peers shut down their side as well
+  for (Peer& peer : peers_) {
+    if (peer.receiver.joinable()) {
+      peer.receiver.join();
+    }
+    if (peer.fd >= 0) {
+      close(peer.fd);
+    }
+  }
+}
+
+void
+katana::TcpCommBackend::SendLoop(uint32_t dest) {
+  Peer& peer = peers_[dest];
+  while (true) {
+    std::pair<uint32_t, std::string> msg;
+    {
+      std::unique_lock<std::mutex> lock(send_mutex_);
+      send_cv_.wait(lock, [&]() { return stopping_ || !peer.outbox.empty(); });
+      if (peer.outbox.empty()) {
+        return;
+      }
+      msg = std::move(peer.outbox.front());
+      peer.outbox.pop_front();
+    }
+
+    Header header{msg.first, 0, msg.second.size()};
+    if (!WriteAll(
+            peer.fd, reinterpret_cast<const char*>(&header),
+            sizeof(header)) ||
+        !WriteAll(peer.fd, msg.second.data(), msg.second.size())) {
+      KATANA_LOG_FATAL("lost the connection to task {}", dest);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(send_mutex_);
+      num_unsent_ -= 1;
+    }
+    send_cv_.notify_all();
+  }
+}
+
+void
+katana::TcpCommBackend::ReceiveLoop(uint32_t src) {
+  Peer& peer = peers_[src];
+  while (true) {
+    Header header;
+    if (!ReadAll(peer.fd, reinterpret_cast<char*>(&header), sizeof(header))) {
+      break;
+    }
+    if (header.tag == kAbortTag) {
+      KATANA_LOG_FATAL("task {} failed", src);
+    }
+    std::string msg(header.size, '\0');
+    if (!ReadAll(peer.fd, msg.data(), msg.size())) {
+      break;
+    }
+    Deliver(src, header.tag, std::move(msg));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peer.closed = true;
+  }
+  cv_.notify_all();
+}
+
+void
+katana::TcpCommBackend::Enqueue(uint32_t dest, uint32_t tag, std::string msg) {
+  KATANA_LOG_ASSERT(dest < Num);
+  if (dest == Rank) {
+    Deliver(Rank, tag, std::move(msg));
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    peers_[dest].outbox.emplace_back(tag, std::move(msg));
+    num_unsent_ += 1;
+  }
+  send_cv_.notify_all();
+}
+
+void
+katana::TcpCommBackend::Deliver(uint32_t src, uint32_t tag, std::string msg) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inbox_[{src, tag}].emplace_back(std::move(msg));
+  }
+  cv_.notify_all();
+}
+
+std::string
+katana::TcpCommBackend::Take(uint32_t src, uint32_t tag) {
+  KATANA_LOG_ASSERT(src < Num);
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::deque<std::string>& queue = inbox_[{src, tag}];
+  cv_.wait(lock, [&]() { return !queue.empty() || peers_[src].closed; });
+  if (queue.empty()) {
+    KATANA_LOG_FATAL("task {} closed its connection", src);
+  }
+  std::string msg = std::move(queue.front());
+  queue.pop_front();
+  return msg;
+}
+
+void
+katana::TcpCommBackend::Send(uint32_t dest, uint32_t tag, std::string msg) {
+  KATANA_LOG_VASSERT(tag < kMaxTag, "tag {} is reserved", tag);
+  Enqueue(dest, tag, std::move(msg));
+}
+
+std::string
+katana::TcpCommBackend::Receive(uint32_t src, uint32_t tag) {
+  KATANA_LOG_VASSERT(tag < kMaxTag, "tag {} is reserved", tag);
+  return Take(src, tag);
+}
+
+void
+katana::TcpCommBackend::WaitForSends() {
+  std::unique_lock<std::mutex> lock(send_mutex_);
+  send_cv_.wait(lock, [&]() { return num_unsent_ == 0; });
+}
+
+void
+katana::TcpCommBackend::Barrier() {
+  AllGatherBytes("");
+}
+
+bool
+katana::TcpCommBackend::Broadcast(uint32_t root, bool val) {
+  return Broadcast(root, std::string(1, val ? '1' : '0'), 1) == "1";
+}
+
+std::string
+katana::TcpCommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  if (Rank != root) {
+    return Take(root, kCollectiveTag);
+  }
+  std::string ret = val.substr(0, max_size);
+  for (uint32_t r = 0; r < Num; ++r) {
+    if (r != Rank) {
+      Enqueue(r, kCollectiveTag, ret);
+    }
+  }
+  return ret;
+}
+
+void
+katana::TcpCommBackend::NotifyFailure() {
+  for (uint32_t r = 0; r < Num; ++r) {
+    if (r != Rank) {
+      Enqueue(r, kAbortTag, "");
+    }
+  }
+  WaitForSends();
+}
+
+std::vector<uint64_t>
+katana::TcpCommBackend::AllReduceSum(const std::vector<uint64_t>& vals) {
+  return AllReduce(vals, std::plus<uint64_t>());
+}
+
+std::vector<std::string>
+katana::TcpCommBackend::AllGatherBytes(const std::string& val) {
+  return AllToAllBytes(std::vector<std::string>(Num, val));
+}
+
+std::vector<std::string>
+katana::TcpCommBackend::AllToAllBytes(const std::vector<std::string>& to_each) {
+  KATANA_LOG_ASSERT(to_each.size() == Num);
+  for (uint32_t r = 0; r < Num; ++r) {
+    if (r != Rank) {
+      Enqueue(r, kCollectiveTag, to_each[r]);
+    }
+  }
+  std::vector<std::string> ret(Num);
+  for (uint32_t r = 0; r < Num; ++r) {
+    ret[r] = r == Rank ? to_each[r] : Take(r, kCollectiveTag);
+  }
+  return ret;
+}
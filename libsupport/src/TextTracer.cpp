@@ -3,19 +3,16 @@
 #include <sys/time.h>
 
 #include <cstring>
-#include <iostream>
-#include <mutex>
 #include <string>
 
 #include <arrow/memory_pool.h>
 
+#include "katana/Logging.h"
 #include "katana/Random.h"
 #include "katana/Time.h"
 
 namespace {
 
-std::mutex output_mutex;
-
 std::string
 GetHostStatsText() {
   katana::HostStats host_stats = katana::ProgressTracer::GetHostStats();
@@ -77,8 +74,7 @@ BuildText(
 
 void
 OutputText(const std::string& output) {
-  std::lock_guard<std::mutex> lock(output_mutex);
-  std::cerr << output;
+  katana::internal::WriteOutput(true, output);
 }
 
 }  // namespace
@@ -2,6 +2,7 @@
 
 #include <map>
 #include <random>
+#include <thread>
 
 #include "katana/Cache.h"
 #include "katana/Logging.h"
@@ -212,6 +213,60 @@ TestLRUSize(size_t lru_size, const std::vector<katana::Uri>& keys) {
   KATANA_LOG_ASSERT(cache.size() == 0);
 }
 
+void
+TestSharded(const std::vector<katana::Uri>& keys) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kByteSize = 50;
+  katana::ShardedCache<CacheValue> cache(
+      kByteSize, [](const CacheValue& value) { return BytesInValue(value); },
+      4);
+  KATANA_LOG_ASSERT(cache.num_shards() == 4);
+
+  // every thread inserts and gets its own slice of the keys
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = t; i < keys.size(); i += kNumThreads) {
+        cache.Insert(keys[i], RandomValue());
+        cache.Get(keys[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  KATANA_LOG_VASSERT(
+      cache.size() <= kByteSize, "size {} capacity {}", cache.size(),
+      kByteSize);
+  KATANA_LOG_ASSERT(!cache.empty());
+  size_t before_reclaim = cache.size();
+  auto stats = cache.GetStats();
+  KATANA_LOG_ASSERT(stats.insert_count == keys.size());
+  KATANA_LOG_ASSERT(stats.get_count == keys.size());
+
+  size_t reclaimed = cache.Reclaim(std::numeric_limits<size_t>::max());
+  KATANA_LOG_ASSERT(reclaimed == before_reclaim);
+  KATANA_LOG_ASSERT(cache.empty());
+
+  cache.Insert(keys[0], SizeFiveValue());
+  KATANA_LOG_ASSERT(cache.Contains(keys[0]));
+  KATANA_LOG_ASSERT(cache.size() == 5);
+  auto val = cache.GetAndEvict(keys[0]);
+  KATANA_LOG_ASSERT(val.has_value());
+  KATANA_LOG_ASSERT(cache.empty());
+  KATANA_LOG_ASSERT(!cache.Contains(keys[0]));
+
+  // counting entries instead of bytes
+  katana::ShardedCache<CacheValue> entries(10);
+  for (const auto& key : keys) {
+    entries.Insert(key, RandomValue());
+  }
+  KATANA_LOG_ASSERT(entries.size() == 10);
+  entries.clear();
+  KATANA_LOG_ASSERT(entries.empty());
+}
+
 int
 main(int argc, char** argv) {
   constexpr size_t lru_size = 10;
@@ -236,5 +291,7 @@ main(int argc, char** argv) {
 
   TestLRUExplicit(keys);
 
+  TestSharded(keys);
+
   return 0;
 }
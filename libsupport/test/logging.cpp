@@ -1,6 +1,8 @@
 #include "katana/Logging.h"
 
 #include <system_error>
+#include <thread>
+#include <vector>
 
 int
 main() {
@@ -18,5 +20,23 @@ main() {
   KATANA_LOG_DEBUG("this will only be printed in debug builds");
   KATANA_LOG_ASSERT(1 == 1);
 
+  // more messages than fit into one buffer, from several threads
+  katana::SetAsyncLogging(true);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < 5000; ++i) {
+        KATANA_LOG_VERBOSE("thread {} message {}", t, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  KATANA_LOG_ERROR("error written right away");
+  katana::FlushLog();
+  katana::SetAsyncLogging(false);
+  KATANA_LOG_WARN("written synchronously again");
+
   return 0;
 }
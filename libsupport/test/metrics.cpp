@@ -0,0 +1,70 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Metrics.h"
+
+namespace {
+
+bool
+Contains(const std::string& text, const std::string& line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+
+void
+TestExport() {
+  katana::MetricsRegistry registry;
+  registry.Counter("test_bytes_total", "Bytes", {{"op", "get"}}).Add(10);
+  registry.Counter("test_bytes_total", "Bytes", {{"op", "get"}}).Add(5);
+  registry.Counter("test_bytes_total", "Bytes", {{"op", "store"}}).Add(1);
+  registry.Gauge("test_ratio", "A ratio").Set(0.25);
+  registry.Gauge("test_name", "Names", {{"name", "a \"b\"\n"}}).Set(1);
+
+  std::string text = registry.ExportPrometheus();
+  KATANA_LOG_ASSERT(Contains(text, "# HELP test_bytes_total Bytes"));
+  KATANA_LOG_ASSERT(Contains(text, "# TYPE test_bytes_total counter"));
+  KATANA_LOG_ASSERT(Contains(text, "test_bytes_total{op=\"get\"} 15"));
+  KATANA_LOG_ASSERT(Contains(text, "test_bytes_total{op=\"store\"} 1"));
+  KATANA_LOG_ASSERT(Contains(text, "# TYPE test_ratio gauge"));
+  KATANA_LOG_ASSERT(Contains(text, "test_ratio 0.25"));
+  KATANA_LOG_VASSERT(
+      Contains(text, "test_name{name=\"a \\\"b\\\"\\n\"} 1"), "{}", text);
+
+  // families are sorted by name
+  KATANA_LOG_ASSERT(
+      text.find("test_bytes_total") < text.find("test_name") &&
+      text.find("test_name") < text.find("test_ratio"));
+}
+
+void
+TestConcurrentUpdates() {
+  katana::MetricsRegistry registry;
+  constexpr int kThreads = 4;
+  constexpr int kAdds = 10000;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&registry] {
+      auto& counter = registry.Counter("test_adds_total", "Adds");
+      for (int j = 0; j < kAdds; ++j) {
+        counter.Add(1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  KATANA_LOG_ASSERT(
+      registry.Counter("test_adds_total", "Adds").Value() == kThreads * kAdds);
+}
+
+}  // namespace
+
+int
+main() {
+  TestExport();
+  TestConcurrentUpdates();
+  return 0;
+}
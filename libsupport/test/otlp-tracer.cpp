@@ -0,0 +1,157 @@
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/OTLPTracer.h"
+
+namespace {
+
+std::vector<std::string> lines;
+
+/// The spans exported so far, by name
+std::map<std::string, std::vector<nlohmann::json>>
+ExportedSpans() {
+  std::map<std::string, std::vector<nlohmann::json>> spans;
+  for (const std::string& line : lines) {
+    auto request = nlohmann::json::parse(line);
+    for (const auto& resource_spans : request.at("resourceSpans")) {
+      for (const auto& scope_spans : resource_spans.at("scopeSpans")) {
+        for (const auto& span : scope_spans.at("spans")) {
+          spans[span.at("name")].emplace_back(span);
+        }
+      }
+    }
+  }
+  return spans;
+}
+
+nlohmann::json
+Attribute(const nlohmann::json& span, const std::string& key) {
+  for (const auto& attribute : span.at("attributes")) {
+    if (attribute.at("key") == key) {
+      return attribute.at("value");
+    }
+  }
+  KATANA_LOG_FATAL("span has no attribute {}", key);
+  return nlohmann::json{};
+}
+
+void
+TestSpans() {
+  auto& tracer = katana::GetTracer();
+  {
+    auto root = tracer.StartActiveSpan("root");
+    auto child = tracer.StartActiveSpan("child");
+    child.span().SetTags({{"answer", 42}, {"kind", "test"}, {"ratio", 0.5}});
+    child.span().Log("halfway", {{"step", 1}});
+    child.span().SetError();
+  }
+
+  auto spans = ExportedSpans();
+  KATANA_LOG_ASSERT(spans["root"].size() == 1 && spans["child"].size() == 1);
+  const auto& root = spans["root"][0];
+  const auto& child = spans["child"][0];
+
+  KATANA_LOG_ASSERT(root.at("traceId").get<std::string>().size() == 32);
+  KATANA_LOG_ASSERT(root.at("spanId").get<std::string>().size() == 16);
+  KATANA_LOG_ASSERT(!root.contains("parentSpanId"));
+  KATANA_LOG_ASSERT(child.at("traceId") == root.at("traceId"));
+  KATANA_LOG_ASSERT(child.at("parentSpanId") == root.at("spanId"));
+
+  KATANA_LOG_ASSERT(Attribute(child, "answer").at("intValue") == "42");
+  KATANA_LOG_ASSERT(Attribute(child, "kind").at("stringValue") == "test");
+  KATANA_LOG_ASSERT(Attribute(child, "ratio").at("doubleValue") == 0.5);
+  KATANA_LOG_ASSERT(child.at("status").at("code") == 2);
+  KATANA_LOG_ASSERT(!root.contains("status"));
+
+  KATANA_LOG_ASSERT(child.at("events").size() == 1);
+  KATANA_LOG_ASSERT(child.at("events")[0].at("name") == "halfway");
+
+  uint64_t begin =
+      std::stoull(child.at("startTimeUnixNano").get<std::string>());
+  uint64_t end = std::stoull(child.at("endTimeUnixNano").get<std::string>());
+  KATANA_LOG_ASSERT(begin <= end);
+}
+
+void
+TestContexts() {
+  auto& tracer = katana::GetTracer();
+  auto scope = tracer.StartActiveSpan("injected");
+  std::string carrier = tracer.Inject(scope.span().GetContext());
+  KATANA_LOG_VASSERT(carrier.size() == 55, "traceparent {}", carrier);
+
+  auto ctx = tracer.Extract(carrier);
+  KATANA_LOG_ASSERT(ctx != nullptr);
+  const katana::ProgressContext& injected = scope.span().GetContext();
+  KATANA_LOG_ASSERT(ctx->GetTraceID() == injected.GetTraceID());
+  KATANA_LOG_ASSERT(ctx->GetSpanID() == injected.GetSpanID());
+
+  KATANA_LOG_ASSERT(tracer.Extract("not a traceparent") == nullptr);
+  // all zero trace ids are invalid
+  KATANA_LOG_ASSERT(
+      tracer.Extract(
+          "00-00000000000000000000000000000000-0123456789abcdef-01") ==
+      nullptr);
+
+  {
+    auto remote = tracer.StartActiveSpan("remote child", *ctx);
+  }
+
+  auto spans = ExportedSpans();
+  KATANA_LOG_ASSERT(spans["remote child"].size() == 1);
+  const auto& remote = spans["remote child"][0];
+  KATANA_LOG_ASSERT(remote.at("traceId") == injected.GetTraceID());
+  KATANA_LOG_ASSERT(remote.at("parentSpanId") == injected.GetSpanID());
+}
+
+void
+TestOperations() {
+  KATANA_LOG_ASSERT(katana::ProgressTracer::TracesOperations());
+
+  auto& tracer = katana::GetTracer();
+  auto scope = tracer.StartActiveSpan("operations");
+  std::string parent_id = scope.span().GetContext().GetSpanID();
+
+  constexpr int kThreads = 4;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([i] {
+      katana::OperationSpan span("read", {{"thread", i}});
+      span.Finish(1000);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  scope.Close();
+
+  auto spans = ExportedSpans();
+  KATANA_LOG_ASSERT(spans["read"].size() == kThreads);
+  for (const auto& span : spans["read"]) {
+    KATANA_LOG_ASSERT(span.at("parentSpanId") == parent_id);
+    KATANA_LOG_ASSERT(Attribute(span, "bytes").at("intValue") == "1000");
+    Attribute(span, "latency_us");
+    Attribute(span, "busy_threads");
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SetEnv("KATANA_TRACE_OPERATIONS", "1", true);
+  katana::ProgressTracer::Set(katana::OTLPTracer::Make(
+      0, 1, [](const std::string& line) { lines.emplace_back(line); }));
+
+  TestSpans();
+  TestContexts();
+  TestOperations();
+
+  katana::GetTracer().Finish();
+  return 0;
+}
@@ -5,8 +5,93 @@
 
 #include "katana/Logging.h"
 
+namespace {
+
+void
+TestMix64() {
+  // the finalizer of splitmix64 fixes zero, and steps the sequence of a
+  // zero seed from the golden ratio
+  KATANA_LOG_ASSERT(katana::Mix64(0) == 0);
+  KATANA_LOG_ASSERT(katana::Mix64(1) == 0x5692161d100b05e5);
+  KATANA_LOG_ASSERT(katana::Mix64(2) == 0xdbd238973a2b148a);
+  KATANA_LOG_ASSERT(
+      katana::Mix64(0x9e3779b97f4a7c15) == katana::StatelessRandom(0, 0));
+}
+
+void
+TestStatelessRandom() {
+  // the known answer of splitmix64 for a zero seed
+  const uint64_t kZeroSequence[] = {
+      0xe220a8397b1dcdaf, 0x6e789e6aa1b965f4, 0x06c45d188009454f};
+  for (uint64_t i = 0; i < 3; ++i) {
+    KATANA_LOG_ASSERT(katana::StatelessRandom(0, i) == kZeroSequence[i]);
+  }
+}
+
+void
+TestRandomStream() {
+  // the known answer of the Random123 library for a zero key and counter
+  const uint32_t kZeroBlock[] = {
+      0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+  katana::RandomStream zero(0, 0);
+  for (uint32_t expected : kZeroBlock) {
+    KATANA_LOG_ASSERT(zero() == expected);
+  }
+  // and of its reference implementation for a block far into a stream,
+  // which discard skips to at once
+  const uint32_t kFarBlock[] = {
+      0xb06534e6, 0xd7c3e991, 0x745c0d4d, 0xffd23e96};
+  katana::RandomStream far(0x299f31d0a4093822, 0x0370734413198a2e);
+  far.discard(uint64_t{0x5243f6a88} * 4);
+  for (uint32_t expected : kFarBlock) {
+    KATANA_LOG_ASSERT(far() == expected);
+  }
+
+  // Fill draws the numbers one at a time would, from any position
+  for (uint64_t skip : {0, 3, 4, 70}) {
+    katana::RandomStream one(42, 7);
+    katana::RandomStream bulk(42, 7);
+    one.discard(skip);
+    bulk.discard(skip);
+    std::vector<uint32_t> filled(1001);
+    bulk.Fill(filled.data(), filled.size());
+    for (uint32_t value : filled) {
+      KATANA_LOG_ASSERT(one() == value);
+    }
+    KATANA_LOG_ASSERT(one.position() == bulk.position());
+    KATANA_LOG_ASSERT(one() == bulk());
+  }
+
+  // streams of the same seed differ
+  katana::RandomStream a(42, 1);
+  katana::RandomStream b(42, 2);
+  int same = 0;
+  for (int i = 0; i < 64; ++i) {
+    same += a() == b();
+  }
+  KATANA_LOG_ASSERT(same < 4);
+
+  std::vector<uint32_t> counts(10);
+  for (int i = 0; i < 10000; ++i) {
+    uint32_t value = a.NextBelow(10);
+    KATANA_LOG_ASSERT(value < 10);
+    ++counts[value];
+    double d = a.NextDouble();
+    KATANA_LOG_ASSERT(d >= 0 && d < 1);
+  }
+  for (uint32_t count : counts) {
+    KATANA_LOG_ASSERT(count > 800 && count < 1200);
+  }
+}
+
+}  // namespace
+
 int
 main() {
+  TestMix64();
+  TestStatelessRandom();
+  TestRandomStream();
+
   // test to make sure we have enough randomness
   std::vector<std::thread> threads;
   for (int i = 0; i < 128; ++i) {
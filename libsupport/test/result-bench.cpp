@@ -1,12 +1,14 @@
 #include <iostream>
 #include <limits>
 #include <random>
+#include <string_view>
 #include <system_error>
 #include <thread>
 
 #include <benchmark/benchmark.h>
 #include <boost/outcome/outcome.hpp>
 
+#include "katana/ErrorCode.h"
 #include "katana/Random.h"
 #include "katana/Result.h"
 
@@ -319,12 +321,87 @@ ReturnKatanaResultWithContext(benchmark::State& state) {
   }
 }
 
+/// Propagates a Result through depth calls that each add context with
+/// KATANA_CHECKED_CONTEXT, like a per-property load or a per-row import
+/// does
+template <bool kLazy>
+katana::Result<int>
+Propagate(int depth, int fail_depth) {
+  if (depth == fail_depth) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "row {} is invalid", depth);
+  }
+  if (depth == 0) {
+    return fail_depth;
+  }
+  if constexpr (kLazy) {
+    // only numbers: formatted if the error is written
+    return KATANA_CHECKED_CONTEXT(
+        Propagate<kLazy>(depth - 1, fail_depth), "row {} of {}", depth,
+        fail_depth);
+  } else {
+    // a string: formatted when the error is propagated
+    std::string_view name = "property";
+    return KATANA_CHECKED_CONTEXT(
+        Propagate<kLazy>(depth - 1, fail_depth), "{} {} of {}", name, depth,
+        fail_depth);
+  }
+}
+
+/// Arguments are the depth of the call chain and whether the innermost call
+/// fails
+void
+MakePropagateArguments(benchmark::internal::Benchmark* b) {
+  for (long depth : {1, 8, 32}) {
+    for (long fail : {0, 1}) {
+      b->Args({depth, fail});
+    }
+  }
+}
+
+template <bool kLazy>
+void
+PropagateKatanaResult(benchmark::State& state) {
+  int depth = state.range(0);
+  int fail_depth = state.range(1) ? 0 : -1;
+
+  for (auto _ : state) {
+    auto res = Propagate<kLazy>(depth, fail_depth);
+    benchmark::DoNotOptimize(res);
+  }
+}
+
+/// Like PropagateKatanaResult but the error is also written, which is when
+/// lazy context is formatted
+template <bool kLazy>
+void
+PropagateAndWriteKatanaResult(benchmark::State& state) {
+  int depth = state.range(0);
+  int fail_depth = state.range(1) ? 0 : -1;
+
+  for (auto _ : state) {
+    auto res = Propagate<kLazy>(depth, fail_depth);
+    if (!res) {
+      std::string message = fmt::format("{}", res.error());
+      benchmark::DoNotOptimize(message);
+    }
+  }
+}
+
 BENCHMARK(ReturnException)->Apply(MakeArguments)->UseRealTime();
 BENCHMARK(ReturnErrorCodeResult)->Apply(MakeArguments)->UseRealTime();
 BENCHMARK(ReturnStringResult)->Apply(MakeArguments)->UseRealTime();
 BENCHMARK(ReturnKatanaResult)->Apply(MakeArguments)->UseRealTime();
 BENCHMARK(ReturnStringResultWithContext)->Apply(MakeArguments)->UseRealTime();
 BENCHMARK(ReturnKatanaResultWithContext)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK_TEMPLATE(PropagateKatanaResult, true)
+    ->Apply(MakePropagateArguments);
+BENCHMARK_TEMPLATE(PropagateKatanaResult, false)
+    ->Apply(MakePropagateArguments);
+BENCHMARK_TEMPLATE(PropagateAndWriteKatanaResult, true)
+    ->Apply(MakePropagateArguments);
+BENCHMARK_TEMPLATE(PropagateAndWriteKatanaResult, false)
+    ->Apply(MakePropagateArguments);
 
 }  // namespace
 
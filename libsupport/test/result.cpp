@@ -101,6 +101,82 @@ TestFmt() {
       fstr);
 }
 
+katana::Result<int>
+FailAt(int depth, int fail_depth) {
+  if (depth == fail_depth) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "failed at {} of {}", depth,
+        fail_depth);
+  }
+  return KATANA_CHECKED_CONTEXT(
+      FailAt(depth + 1, fail_depth), "depth {} flag {}", depth, depth % 2 == 0);
+}
+
+katana::Result<void>
+FailWithString(const std::string& name) {
+  std::string temporary = name + " (copy)";
+  KATANA_CHECKED_CONTEXT(FailAt(0, 1), "reading {}", temporary);
+  return katana::ResultSuccess();
+}
+
+void
+TestLazyContext() {
+  auto res = FailAt(0, 2);
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::InvalidArgument);
+
+  std::string found = ToString(res.error());
+  KATANA_LOG_VASSERT(
+      found.find("depth 0 flag true: (") != std::string::npos &&
+          found.find("depth 1 flag false: failed at 2 of 2 (result.cpp:") !=
+              std::string::npos,
+      "unexpected lazy context: {}", found);
+
+  // context with arguments that may not outlive the call is formatted
+  // eagerly
+  auto str_res = FailWithString("topology");
+  found = ToString(str_res.error());
+  KATANA_LOG_VASSERT(
+      found.find("reading topology (copy): (") != std::string::npos,
+      "unexpected eager context: {}", found);
+
+  // lazy context survives conversion to a copyable error
+  katana::CopyableErrorInfo copied = FailAt(0, 1).error();
+  KATANA_LOG_VASSERT(
+      copied.message().find("failed at 1 of 1 (result.cpp:") !=
+          std::string::npos,
+      "unexpected copied context: {}", copied.message());
+}
+
+void
+TestLazyContextOverflow() {
+  // like text context, lazy context that does not fit in the context buffer
+  // is truncated and the root of the error is kept
+  auto res = FailAt(0, katana::ErrorInfo::kContextSize);
+  std::string found = ToString(res.error());
+  KATANA_LOG_VASSERT(
+      found.find("depth 0 flag true") == std::string::npos &&
+          found.find("failed at 512 of 512 (result.cpp:") != std::string::npos,
+      "unexpected context: {}", found);
+
+  katana::ErrorInfo err = katana::ErrorCode::NotFound;
+  err = err.WithContext(katana::ErrorCode::InvalidArgument, "{}", 1);
+  found = ToString(err);
+  std::error_code ec = katana::ErrorCode::NotFound;
+  KATANA_LOG_VASSERT(
+      err == katana::ErrorCode::InvalidArgument &&
+          found == "1: " + ec.message(),
+      "unexpected context: {}", found);
+}
+
+void
+TestSize() {
+  static_assert(sizeof(katana::ErrorInfo) <= sizeof(std::error_code) + 8);
+  static_assert(
+      sizeof(katana::Result<void>) <= sizeof(katana::ErrorInfo) + 8,
+      "Result<void> should be little more than its error");
+}
+
 }  // namespace
 
 int
@@ -110,4 +186,7 @@ main() {
   TestFmt();
   TestResetBetweenInstances();
   TestContextSpill();
+  TestLazyContext();
+  TestLazyContextOverflow();
+  TestSize();
 }
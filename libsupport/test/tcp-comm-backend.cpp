@@ -0,0 +1,172 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/TcpCommBackend.h"
+
+namespace {
+
+constexpr uint32_t kNumTasks = 3;
+
+/// A port that was free a moment ago
+int
+FreePort() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  KATANA_LOG_ASSERT(fd >= 0);
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  KATANA_LOG_ASSERT(
+      bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+  KATANA_LOG_ASSERT(
+      getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len) == 0);
+  close(fd);
+  return ntohs(addr.sin_port);
+}
+
+/// Only the collectives every backend must implement, to test the default
+/// implementations of the others
+class BroadcastOnly : public katana::CommBackend {
+public:
+  explicit BroadcastOnly(katana::CommBackend* comm) : comm_(comm) {
+    Num = comm->Num;
+    Rank = comm->Rank;
+  }
+
+  void Barrier() override { comm_->Barrier(); }
+  bool Broadcast(uint32_t root, bool val) override {
+    return comm_->Broadcast(root, val);
+  }
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override {
+    return comm_->Broadcast(root, val, max_size);
+  }
+  void NotifyFailure() override { comm_->NotifyFailure(); }
+
+private:
+  katana::CommBackend* comm_;
+};
+
+void
+TestCollectives(katana::CommBackend* comm) {
+  uint32_t rank = comm->Rank;
+  comm->Barrier();
+
+  KATANA_LOG_ASSERT(comm->Broadcast(1, rank == 1));
+  KATANA_LOG_ASSERT(
+      comm->Broadcast(2, std::string(rank + 1, 'x'), 2) == std::string("xx"));
+
+  std::vector<uint64_t> sum = comm->AllReduceSum({rank, 1});
+  KATANA_LOG_ASSERT(sum == std::vector<uint64_t>({0 + 1 + 2, kNumTasks}));
+  std::vector<double> max =
+      comm->AllReduce(std::vector<double>{rank * 1.5}, [](double a, double b) {
+        return std::max(a, b);
+      });
+  KATANA_LOG_ASSERT(max == std::vector<double>({3.0}));
+
+  // Buffers of different sizes, including empty ones
+  std::vector<std::vector<uint32_t>> all =
+      comm->AllGather(std::vector<uint32_t>(rank, rank));
+  KATANA_LOG_ASSERT(all.size() == kNumTasks);
+  for (uint32_t r = 0; r < kNumTasks; ++r) {
+    KATANA_LOG_ASSERT(all[r] == std::vector<uint32_t>(r, r));
+  }
+
+  std::vector<std::vector<uint64_t>> to_each;
+  for (uint32_t r = 0; r < kNumTasks; ++r) {
+    to_each.emplace_back(std::vector<uint64_t>{rank * 10 + r, rank});
+  }
+  std::vector<std::vector<uint64_t>> from_each = comm->AllToAll(to_each);
+  for (uint32_t r = 0; r < kNumTasks; ++r) {
+    KATANA_LOG_ASSERT(
+        from_each[r] == std::vector<uint64_t>({r * 10 + rank, r}));
+  }
+}
+
+void
+TestMessages(katana::CommBackend* comm) {
+  uint32_t rank = comm->Rank;
+  uint32_t next = (rank + 1) % kNumTasks;
+  uint32_t prev = (rank + kNumTasks - 1) % kNumTasks;
+
+  // Tags are received independently of each other, messages of one tag in
+  // the order sent
+  for (uint32_t i = 0; i < 100; ++i) {
+    comm->Send(next, 1, std::to_string(i));
+    comm->Send(next, 2, std::string(i, 'a'));
+  }
+  comm->Send(rank, 3, "self");
+  for (uint32_t i = 0; i < 100; ++i) {
+    KATANA_LOG_ASSERT(comm->Receive(prev, 2) == std::string(i, 'a'));
+  }
+  for (uint32_t i = 0; i < 100; ++i) {
+    KATANA_LOG_ASSERT(comm->Receive(prev, 1) == std::to_string(i));
+  }
+  KATANA_LOG_ASSERT(comm->Receive(rank, 3) == "self");
+  comm->WaitForSends();
+  comm->Barrier();
+}
+
+void
+RunTask(uint32_t rank, const std::vector<std::string>& addresses) {
+  auto comm_res = katana::TcpCommBackend::Make(rank, addresses);
+  KATANA_LOG_VASSERT(comm_res, "{}", comm_res.error());
+  std::unique_ptr<katana::TcpCommBackend> comm = std::move(comm_res.value());
+  KATANA_LOG_ASSERT(comm->Num == kNumTasks && comm->Rank == rank);
+  KATANA_LOG_ASSERT(comm->LocalRank == rank);
+
+  TestCollectives(comm.get());
+  BroadcastOnly broadcast_only(comm.get());
+  TestCollectives(&broadcast_only);
+  TestMessages(comm.get());
+}
+
+void
+TestNull() {
+  katana::NullCommBackend comm;
+  KATANA_LOG_ASSERT(
+      comm.AllGather(std::vector<int>{1, 2}) ==
+      std::vector<std::vector<int>>({{1, 2}}));
+  comm.Send(0, 7, "a");
+  comm.Send(0, 7, "b");
+  KATANA_LOG_ASSERT(comm.Receive(0, 7) == "a");
+  KATANA_LOG_ASSERT(comm.Receive(0, 7) == "b");
+}
+
+void
+TestBadArguments() {
+  KATANA_LOG_ASSERT(!katana::TcpCommBackend::Make(1, {"localhost:1"}));
+  KATANA_LOG_ASSERT(!katana::TcpCommBackend::Make(0, {"localhost"}));
+}
+
+}  // namespace
+
+int
+main() {
+  TestNull();
+  TestBadArguments();
+
+  std::vector<std::string> addresses;
+  for (uint32_t r = 0; r < kNumTasks; ++r) {
+    addresses.emplace_back("127.0.0.1:" + std::to_string(FreePort()));
+  }
+  // Start the tasks in reverse to exercise the connection retries
+  std::vector<std::thread> tasks;
+  for (uint32_t r = kNumTasks; r-- > 0;) {
+    tasks.emplace_back(RunTask, r, std::cref(addresses));
+  }
+  for (std::thread& task : tasks) {
+    task.join();
+  }
+
+  return 0;
+}
@@ -67,8 +67,75 @@ ValidateConstructor() {
   }
 }
 
+katana::EntityTypeID
+AddType(katana::EntityTypeManager* mgr, const katana::TypeNameSet& tns) {
+  auto res = mgr->GetOrAddNonAtomicEntityTypeFromStrings(tns);
+  KATANA_LOG_ASSERT(res);
+  return res.value();
+}
+
+size_t
+CountTypes(const katana::EntityTypeManager& mgr, katana::EntityTypeID type) {
+  katana::SetOfEntityTypeIDs with_type = mgr.GetEntityTypesWithType(type);
+  size_t count = 0;
+  for (size_t i = 0; i < mgr.GetNumEntityTypes(); ++i) {
+    count += with_type.test(i);
+  }
+  return count;
+}
+
+void
+CheckSubtypes() {
+  katana::EntityTypeManager mgr;
+  katana::EntityTypeID alice = AddType(&mgr, {"alice"});
+  katana::EntityTypeID baker = AddType(&mgr, {"baker"});
+  katana::EntityTypeID alice_baker = AddType(&mgr, {"alice", "baker"});
+  katana::EntityTypeID charlie = AddType(&mgr, {"charlie"});
+
+  KATANA_LOG_ASSERT(mgr.IsSubtypeOf(alice, alice));
+  KATANA_LOG_ASSERT(mgr.IsSubtypeOf(alice, alice_baker));
+  KATANA_LOG_ASSERT(!mgr.IsSubtypeOf(alice_baker, alice));
+  KATANA_LOG_ASSERT(!mgr.IsSubtypeOf(alice, charlie));
+  KATANA_LOG_ASSERT(mgr.IsSubtypeOf(katana::kUnknownEntityType, charlie));
+  KATANA_LOG_ASSERT(!mgr.IsSubtypeOf(charlie, katana::kUnknownEntityType));
+
+  katana::SetOfEntityTypeIDs with_alice = mgr.GetEntityTypesWithType(alice);
+  KATANA_LOG_ASSERT(with_alice.test(alice));
+  KATANA_LOG_ASSERT(with_alice.test(alice_baker));
+  KATANA_LOG_ASSERT(!with_alice.test(baker));
+  KATANA_LOG_ASSERT(!with_alice.test(charlie));
+  KATANA_LOG_ASSERT(!with_alice.test(katana::kUnknownEntityType));
+  KATANA_LOG_ASSERT(
+      CountTypes(mgr, katana::kUnknownEntityType) == mgr.GetNumEntityTypes());
+
+  // Types added after a check are seen by later ones
+  katana::EntityTypeID alice_charlie = AddType(&mgr, {"alice", "charlie"});
+  KATANA_LOG_ASSERT(mgr.IsSubtypeOf(charlie, alice_charlie));
+  KATANA_LOG_ASSERT(mgr.GetEntityTypesWithType(alice).test(alice_charlie));
+}
+
+void
+CheckSubtypesOfManyTypes() {
+  // More types than are flattened into a bitmap of all pairs
+  katana::EntityTypeManager mgr;
+  std::vector<katana::EntityTypeID> types;
+  for (size_t i = 0; i <= katana::kMaxFlattenedEntityTypes; ++i) {
+    types.emplace_back(AddType(&mgr, {fmt::format("t{}", i)}));
+  }
+  katana::EntityTypeID pair = AddType(&mgr, {"t0", "t1"});
+
+  KATANA_LOG_ASSERT(mgr.IsSubtypeOf(types[0], pair));
+  KATANA_LOG_ASSERT(!mgr.IsSubtypeOf(types[2], pair));
+  KATANA_LOG_ASSERT(!mgr.IsSubtypeOf(pair, types[1]));
+  katana::SetOfEntityTypeIDs with_t1 = mgr.GetEntityTypesWithType(types[1]);
+  KATANA_LOG_ASSERT(CountTypes(mgr, types[1]) == 2);
+  KATANA_LOG_ASSERT(with_t1.test(types[1]) && with_t1.test(pair));
+}
+
 int
 main() {
   CreateEntityTypeIDs();
   ValidateConstructor();
+  CheckSubtypes();
+  CheckSubtypesOfManyTypes();
 }
@@ -5,10 +5,11 @@
 #include <list>
 
 #include "katana/Result.h"
+#include "katana/config.h"
 
 namespace katana {
 
-class AsyncOpGroup {
+class KATANA_EXPORT AsyncOpGroup {
 public:
   struct AsyncOp {
     std::future<katana::CopyableResult<void>> result;
@@ -27,6 +28,9 @@ public:
   /// wait for the op at the head of the list, return true if there was one
   bool FinishOne();
 
+  /// The number of ops added but not yet finished
+  size_t num_pending() const { return pending_ops_.size(); }
+
 private:
   std::list<AsyncOp> pending_ops_;
   uint64_t errors_{0};
@@ -0,0 +1,89 @@
+#ifndef KATANA_LIBTSUBA_KATANA_CONTENTHASH_H_
+#define KATANA_LIBTSUBA_KATANA_CONTENTHASH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <arrow/api.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A hash of the contents of an array, with one value for every chunk of
+/// chunk_size consecutive elements. Two arrays are compared without touching
+/// their elements, and when they differ only the elements of the chunks
+/// whose hashes differ need to be looked at.
+///
+/// The hash of a chunk is the sum of a strong mix of the index and the hash
+/// of each of its elements, so the chunks are hashed in parallel and the
+/// hash of an Arrow column does not depend on how the column is split into
+/// Arrow chunks. Equal hashes mean equal contents with overwhelming
+/// probability rather than certainty.
+struct KATANA_EXPORT ContentHash {
+  static constexpr uint64_t kDefaultChunkSize = uint64_t{1} << 20;
+
+  uint64_t chunk_size{kDefaultChunkSize};
+  uint64_t length{0};
+  std::vector<uint64_t> chunks;
+
+  /// The first element of chunk i
+  uint64_t ChunkBegin(uint64_t i) const { return i * chunk_size; }
+  /// The number of elements of chunk i; the last chunk may be short
+  uint64_t ChunkLength(uint64_t i) const {
+    return std::min(chunk_size, length - ChunkBegin(i));
+  }
+
+  /// One value for the whole array
+  uint64_t value() const;
+
+  /// The indices of the chunks whose hashes differ from those of other; all
+  /// of them if the lengths or chunk sizes differ
+  std::vector<uint64_t> DifferingChunks(const ContentHash& other) const;
+
+  bool operator==(const ContentHash& other) const {
+    return chunk_size == other.chunk_size && length == other.length &&
+           chunks == other.chunks;
+  }
+  bool operator!=(const ContentHash& other) const { return !(*this == other); }
+
+  /// A hash of size bytes at data, for elements that are not integers
+  static uint64_t HashBytes(const void* data, size_t size);
+
+  /// The term that the element at index, whose own hash is element_hash,
+  /// adds to the hash of its chunk
+  static uint64_t MixElement(uint64_t index, uint64_t element_hash);
+
+  /// Hash an array of length elements, where hash_range(begin, end) returns
+  /// the sum of MixElement over the elements of [begin, end). Chunks are
+  /// hashed in parallel, so hash_range must be safe to call concurrently.
+  static ContentHash Make(
+      uint64_t length,
+      const std::function<uint64_t(uint64_t, uint64_t)>& hash_range,
+      uint64_t chunk_size = kDefaultChunkSize);
+
+  /// Hash length elements of width bytes each stored contiguously at data
+  static ContentHash OfFixedWidth(
+      const void* data, size_t width, uint64_t length,
+      uint64_t chunk_size = kDefaultChunkSize);
+
+  /// Hash the values of an Arrow column of a fixed width, boolean, binary
+  /// or string type; nulls all hash alike. The type itself is not part of
+  /// the hash. Fails with NotImplemented for other (nested or dictionary)
+  /// types, which have to be compared element by element.
+  static Result<ContentHash> OfColumn(
+      const arrow::ChunkedArray& column,
+      uint64_t chunk_size = kDefaultChunkSize);
+};
+
+KATANA_EXPORT void to_json(nlohmann::json& j, const ContentHash& hash);
+KATANA_EXPORT void from_json(const nlohmann::json& j, ContentHash& hash);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+#define KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/RDGOptionalDatastructure.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "katana/file.h"
+
+namespace katana {
+
+const std::string kOptionalDatastructureEntityIndexPrimitive =
+    "kg.v1.entity_index";
+
+/// A stored index of a node or edge property: the ids of the entities with a
+/// value, sorted by it, and the sorted values themselves for indexes that
+/// search them rather than the property. The arrays are bytes; the index
+/// that stores them knows their types.
+///
+/// An index is only valid for the property file it was built from, which it
+/// records in property_path, along with the type of the property and the
+/// number of entities, so that a stale index can be told apart and built
+/// again. The arrays are stored in files of their own, which Load maps in
+/// place rather than reading.
+class KATANA_EXPORT EntityIndexPrimitive
+    : private katana::RDGOptionalDatastructure {
+public:
+  template <typename T>
+  using Array = OptionalDatastructureArray<T>;
+
+  /// The name under which the index of a node or edge property is stored
+  static std::string Name(bool is_node, const std::string& property_name) {
+    return kOptionalDatastructureEntityIndexPrimitive +
+           (is_node ? ".node." : ".edge.") + property_name;
+  }
+
+  static katana::Result<EntityIndexPrimitive> Load(
+      const katana::Uri& rdg_dir_path, const std::string& path) {
+    EntityIndexPrimitive index =
+        KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    KATANA_CHECKED(index.MapArrays(rdg_dir_path));
+    return index;
+  }
+
+  katana::Result<std::string> Write(katana::Uri rdg_dir_path) {
+    paths_.clear();
+    KATANA_CHECKED(StoreArray(rdg_dir_path, "ids", ids_));
+    KATANA_CHECKED(StoreArray(rdg_dir_path, "keys", keys_));
+
+    // Write out our json manifest
+    katana::Uri manifest_path = rdg_dir_path.RandFile("entity_index_manifest");
+    KATANA_CHECKED(WriteManifest(manifest_path.string()));
+    return manifest_path.BaseName();
+  }
+
+  const std::string& property_name() const { return property_name_; }
+  void set_property_name(std::string name) { property_name_ = std::move(name); }
+
+  /// The base name of the file of the property the index was built from
+  const std::string& property_path() const { return property_path_; }
+  void set_property_path(std::string path) { property_path_ = std::move(path); }
+
+  /// The arrow type of the property, as printed by arrow
+  const std::string& type() const { return type_; }
+  void set_type(std::string type) { type_ = std::move(type); }
+
+  uint64_t num_entities() const { return num_entities_; }
+  void set_num_entities(uint64_t num) { num_entities_ = num; }
+
+  const Array<uint8_t>& ids() const { return ids_; }
+  void set_ids(Array<uint8_t> ids) { ids_ = std::move(ids); }
+
+  const Array<uint8_t>& keys() const { return keys_; }
+  void set_keys(Array<uint8_t> keys) { keys_ = std::move(keys); }
+
+  friend void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+  friend void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
+private:
+  std::string property_name_;
+  std::string property_path_;
+  std::string type_;
+  uint64_t num_entities_{0};
+  /// Set by the manifest, for the arrays to be mapped
+  uint64_t ids_size_{0};
+  uint64_t keys_size_{0};
+
+  /// data structures dumped to their own files
+
+  Array<uint8_t> ids_;
+  Array<uint8_t> keys_;
+
+  katana::Result<void> StoreArray(
+      const katana::Uri& rdg_dir_path, const std::string& name,
+      const Array<uint8_t>& array) {
+    katana::Uri path = rdg_dir_path.RandFile("entity_index_" + name);
+    KATANA_CHECKED(array.Store(path));
+    paths_.emplace(name, path.BaseName());
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> MapArrays(const katana::Uri& rdg_dir_path) {
+    auto map = [&](const std::string& name, Array<uint8_t>* array,
+                   uint64_t size) -> katana::Result<void> {
+      auto it = paths_.find(name);
+      if (it == paths_.end()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "entity index manifest has no {} file", name);
+      }
+      return array->Map(rdg_dir_path.Join(it->second), size);
+    };
+    KATANA_CHECKED(map("ids", &ids_, ids_size_));
+    KATANA_CHECKED(map("keys", &keys_, keys_size_));
+    return katana::ResultSuccess();
+  }
+
+  static katana::Result<EntityIndexPrimitive> LoadJson(
+      const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(path, true));
+
+    if (fv.size() == 0) {
+      return EntityIndexPrimitive();
+    }
+
+    EntityIndexPrimitive index;
+    KATANA_CHECKED(katana::JsonParse<EntityIndexPrimitive>(fv, &index));
+
+    return index;
+  }
+
+  katana::Result<void> WriteManifest(const std::string& path) const {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(serialized.size()));
+    if (auto res = ff->Write(serialized.data(), serialized.size()); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path);
+    // persist now
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::ResultSuccess();
+  }
+};
+
+}  // namespace katana
+
+#endif
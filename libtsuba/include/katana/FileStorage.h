@@ -48,6 +48,16 @@ public:
   /// to the LocalStorage when no protocol on the URI is provided
   virtual uint32_t Priority() const { return 0; }
 
+  /// The smallest part FileGet and FileGetAsync split a read into, issuing
+  /// the parts as concurrent GetAsync requests of byte ranges; 0, the
+  /// default, reads a range with one request, which is as fast as several
+  /// for local storage. Remote storage should return a size that a single
+  /// stream moves in well over one round trip, e.g., 8 MiB.
+  virtual uint64_t ReadPartSize() const { return 0; }
+
+  /// The most GetAsync requests of parts of a read outstanding at once
+  virtual uint32_t MaxConcurrentReads() const { return 16; }
+
   // get on future can potentially block (bulk synchronous parallel)
   virtual std::future<katana::CopyableResult<void>> PutAsync(
       const std::string& uri, const uint8_t* data, uint64_t size) = 0;
@@ -1,8 +1,10 @@
 #ifndef KATANA_LIBTSUBA_KATANA_FILEVIEW_H_
 #define KATANA_LIBTSUBA_KATANA_FILEVIEW_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <future>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -16,6 +18,19 @@ namespace katana {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
 public:
+  /// How the pages of a file mapped by MapReadOnly are expected to be
+  /// accessed; passed on to madvise
+  enum class MapAdvice {
+    kNormal,
+    kSequential,
+    kRandom,
+    kWillNeed,
+  };
+
+  /// Pages fetched ahead of a sequential scan at most, unless it is changed
+  /// with set_read_ahead_max_pages
+  static constexpr uint64_t kDefaultReadAheadMaxPages = 16;
+
   FileView() = default;
   FileView(const FileView&) = delete;
   FileView& operator=(const FileView&) = delete;
@@ -29,8 +44,16 @@ public:
         filename_(std::move(other.filename_)),
         bound_(other.bound_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        fetches_(std::move(other.fetches_)),
+        mapped_in_place_(other.mapped_in_place_),
+        read_ahead_max_pages_(other.read_ahead_max_pages_),
+        read_ahead_pages_(other.read_ahead_pages_),
+        last_read_start_(other.last_read_start_),
+        last_read_end_(other.last_read_end_),
+        read_hits_(other.read_hits_),
+        read_misses_(other.read_misses_) {
     other.bound_ = false;
+    other.mapped_in_place_ = false;
   }
 
   FileView& operator=(FileView&& other) noexcept {
@@ -48,7 +71,15 @@ public:
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      mapped_in_place_ = other.mapped_in_place_;
+      read_ahead_max_pages_ = other.read_ahead_max_pages_;
+      read_ahead_pages_ = other.read_ahead_pages_;
+      last_read_start_ = other.last_read_start_;
+      last_read_end_ = other.last_read_end_;
+      read_hits_ = other.read_hits_;
+      read_misses_ = other.read_misses_;
       other.bound_ = false;
+      other.mapped_in_place_ = false;
     }
     return *this;
   }
@@ -75,12 +106,48 @@ public:
     return Bind(filename, 0, std::numeric_limits<uint64_t>::max(), resolve);
   }
 
+  /// Map the whole of a local file read only and shared, so that its pages
+  /// come straight from the page cache: nothing is copied and processes
+  /// mapping the same file share one copy of it. The mapped memory must not
+  /// be written to.
+  ///
+  /// Files that are not on local storage fall back to Bind(filename, true).
+  katana::Result<void> MapReadOnly(
+      std::string_view filename, MapAdvice advice = MapAdvice::kNormal);
+
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Release the memory of the pages that lie entirely within [begin, end);
+  /// a later Fill fetches them from storage again. Pages of a view mapped in
+  /// place are left alone since they belong to the page cache.
+  katana::Result<void> Discard(uint64_t begin, uint64_t end);
+
   bool Valid() const { return bound_; }
 
+  /// Whether this view is a MapReadOnly mapping of the file itself rather
+  /// than a copy of it
+  bool mapped_in_place() const { return mapped_in_place_; }
+
   katana::Result<void> Unbind();
 
+  /// Reads through the arrow interface that start where the previous one
+  /// ended are taken to be a sequential scan. Pages past the end of each
+  /// such read are fetched asynchronously, starting with one page and
+  /// doubling with every sequential read up to max_pages; any other read
+  /// starts over. Zero turns read-ahead off, leaving only a fetch of about
+  /// the size of the last read.
+  void set_read_ahead_max_pages(uint64_t max_pages) {
+    read_ahead_max_pages_ = max_pages;
+    read_ahead_pages_ = std::min(read_ahead_pages_, max_pages);
+  }
+  uint64_t read_ahead_max_pages() const { return read_ahead_max_pages_; }
+
+  /// Reads through the arrow interface whose data had already been fetched or
+  /// was being fetched, e.g., by read-ahead
+  uint64_t read_hits() const { return read_hits_; }
+  /// Reads through the arrow interface that had to start fetching their data
+  uint64_t read_misses() const { return read_misses_; }
+
   /// Be very careful with this function. It is the caller's responsibility to
   /// ensure that the region returned holds meaningful data.
   ///
@@ -125,6 +192,15 @@ public:
   arrow::Result<int64_t> Read(int64_t, void*) override;
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t) override;
   arrow::Result<int64_t> GetSize() override;
+  arrow::Result<int64_t> ReadAt(int64_t, int64_t, void*) override;
+  arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(
+      int64_t, int64_t) override;
+  using arrow::io::RandomAccessFile::ReadAsync;
+  /// Starts fetching the range from storage before handing the read to the
+  /// I/O context, so that the ranges arrow pre-buffers are all fetched at
+  /// once instead of one after another
+  arrow::Future<std::shared_ptr<arrow::Buffer>> ReadAsync(
+      const arrow::io::IOContext&, int64_t, int64_t) override;
 
   ///// End arrow::io::RandomAccessFile methods ///////
 
@@ -156,6 +232,10 @@ private:
   // @start and @size give the location and range of the previous read
   katana::Result<void> PreFetch(int64_t start, int64_t size);
 
+  // Count a read about to be issued for [start, start + size) as a hit or a
+  // miss
+  void CountRead(int64_t start, int64_t size);
+
   struct FillingRange {
     uint64_t first_page;
     uint64_t last_page;
@@ -171,6 +251,17 @@ private:
   bool bound_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  bool mapped_in_place_{false};
+  uint64_t read_ahead_max_pages_{kDefaultReadAheadMaxPages};
+  // current read-ahead window, in pages
+  uint64_t read_ahead_pages_{0};
+  int64_t last_read_start_{0};
+  int64_t last_read_end_{0};
+  uint64_t read_hits_{0};
+  uint64_t read_misses_{0};
+  // Serializes the positional reads, which arrow may issue from several
+  // threads at once; not moved with the view
+  std::mutex read_mutex_;
 };
 }  // namespace katana
 
@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBTSUBA_KATANA_PAGEDPROPERTY_H_
+#define KATANA_LIBTSUBA_KATANA_PAGEDPROPERTY_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/ParquetReader.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A property read from storage one page at a time, as its rows are asked
+/// for, rather than all at once. A page is a parquet row group of the
+/// property's file.
+///
+/// At most max_active_pages pages are kept decoded by the property; when
+/// another page is needed, the least recently used one is handed to the
+/// PropertyManager, which holds on to it as standby memory until it needs
+/// the memory back. So memory pressure evicts the cold pages of a property
+/// rather than the whole column. Arrays returned by GetRows refer to the
+/// pages they were sliced from and keep them in memory while they live.
+///
+/// A PagedProperty is not thread safe.
+class KATANA_EXPORT PagedProperty {
+public:
+  struct Options {
+    /// the pages the property keeps decoded; at least 1
+    size_t max_active_pages{16};
+  };
+
+  /// open the property named name stored in the parquet file at path
+  static katana::Result<std::unique_ptr<PagedProperty>> Make(
+      const katana::Uri& path, const std::string& name,
+      const Options& opts = Options{});
+
+  PagedProperty(const PagedProperty& no_copy) = delete;
+  PagedProperty& operator=(const PagedProperty& no_copy) = delete;
+
+  /// release the active pages
+  ~PagedProperty();
+
+  const std::string& name() const { return name_; }
+  const std::shared_ptr<arrow::DataType>& type() const { return type_; }
+  int64_t num_rows() const { return rows_->num_rows(); }
+  size_t num_pages() const { return rows_->num_row_groups(); }
+  size_t num_active_pages() const { return active_.size(); }
+
+  /// the values of rows [offset, offset + length), reading the pages they are
+  /// on if they are not in memory
+  katana::Result<std::shared_ptr<arrow::ChunkedArray>> GetRows(
+      int64_t offset, int64_t length);
+
+  /// the value of row row
+  katana::Result<std::shared_ptr<arrow::Scalar>> GetScalar(int64_t row);
+
+  /// hand every active page to the PropertyManager
+  void Release();
+
+private:
+  using LRUList = std::list<size_t>;
+
+  struct ActivePage {
+    std::shared_ptr<arrow::ChunkedArray> values;
+    std::shared_ptr<arrow::Table> table;
+    LRUList::iterator lru_pos;
+  };
+
+  PagedProperty(
+      const katana::Uri& path, const std::string& name,
+      std::unique_ptr<ParquetReader::RowGroupTable>&& rows,
+      const Options& opts);
+
+  katana::Result<std::shared_ptr<arrow::ChunkedArray>> GetPage(size_t page);
+
+  /// hand the least recently used active page to the PropertyManager
+  void EvictOne();
+
+  katana::Uri PageKey(size_t page) const;
+
+  katana::Uri path_;
+  std::string name_;
+  std::unique_ptr<ParquetReader::RowGroupTable> rows_;
+  std::shared_ptr<arrow::DataType> type_;
+  Options opts_;
+
+  // most recently used first
+  LRUList lru_;
+  std::unordered_map<size_t, ActivePage> active_;
+};
+
+}  // namespace katana
+
+#endif
@@ -2,6 +2,8 @@
 #define KATANA_LIBTSUBA_KATANA_PARQUETREADER_H_
 
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <arrow/api.h>
 
@@ -14,6 +16,12 @@ class FileReader;
 
 }  // namespace parquet::arrow
 
+namespace arrow::internal {
+
+class ThreadPool;
+
+}  // namespace arrow::internal
+
 namespace katana {
 
 class KATANA_EXPORT ParquetReader {
@@ -23,14 +31,72 @@ public:
     int64_t length;
   };
 
+  /// A predicate on the values of one column of a table:
+  /// lower <= value <= upper, where a null bound is unbounded. Bounds are
+  /// cast to the type of the column. Null values never satisfy a filter.
+  struct ColumnFilter {
+    std::string column;
+    std::shared_ptr<arrow::Scalar> lower;
+    std::shared_ptr<arrow::Scalar> upper;
+
+    static ColumnFilter Equal(
+        std::string column, const std::shared_ptr<arrow::Scalar>& value) {
+      return ColumnFilter{std::move(column), value, value};
+    }
+  };
+
   struct ReadOpts {
     /// if true (default) make sure canonical types are used and table columns
     /// are not chunked
     bool make_canonical{true};
 
+    /// if false, integer and floating point columns of canonical tables keep
+    /// the chunks they were decoded in, e.g., one per row group, rather than
+    /// being copied into one array; property views read such columns in
+    /// place (see PODPropertyView). Other columns are combined as before.
+    bool combine_chunks{true};
+
+    /// if true, decode columns on several threads, fetch all of the column
+    /// chunks a read needs at once (parquet pre-buffering) instead of one at
+    /// a time, and read the files of a blocked table concurrently
+    bool parallel{false};
+
+    /// number of threads issuing the fetches of parallel reads; 0 (default)
+    /// uses arrow's shared I/O thread pool
+    int32_t io_threads{0};
+
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
+  /// A table opened to be read one row group at a time. The bytes of a row
+  /// group are fetched from storage when it is read and released once it is
+  /// decoded, so an open table holds little more than its parquet footers.
+  class KATANA_EXPORT RowGroupTable {
+  public:
+    RowGroupTable(const RowGroupTable& no_copy) = delete;
+    RowGroupTable& operator=(const RowGroupTable& no_copy) = delete;
+    ~RowGroupTable();
+
+    /// the first row of each row group, followed by the number of rows
+    const std::vector<int64_t>& row_group_offsets() const;
+    size_t num_row_groups() const { return row_group_offsets().size() - 1; }
+    int64_t num_rows() const { return row_group_offsets().back(); }
+
+    const std::shared_ptr<arrow::Schema>& schema() const;
+
+    /// read row group row_group of the table
+    katana::Result<std::shared_ptr<arrow::Table>> ReadRowGroup(
+        size_t row_group);
+
+  private:
+    friend class ParquetReader;
+    class Impl;
+
+    RowGroupTable(std::unique_ptr<Impl>&& impl);
+
+    std::unique_ptr<Impl> impl_;
+  };
+
   /// build a reader that will read a table from storage location optionally
   /// reading only part of the table.
   /// \param opts an opt structure detailing how reads should behave (see
@@ -52,17 +118,42 @@ public:
       const katana::Uri& uri, const std::vector<int32_t>& column_bitmap,
       std::optional<Slice> slice = std::nullopt);
 
+  /// Find the rows of a table that may satisfy every filter, judging by the
+  /// statistics parquet keeps for each row group: the rows of row groups that
+  /// cannot match are left out, but the rows returned may still fail the
+  /// filters. Filters on columns whose type has no usable statistics match
+  /// every row.
+  ///   \param uri an identifier for a parquet file
+  ///   \param slice if present, only rows in slice are considered
+  ///   \returns sorted, disjoint and non-adjacent ranges of rows
+  katana::Result<std::vector<Slice>> FindMatchingRows(
+      const katana::Uri& uri, const std::vector<ColumnFilter>& filters,
+      std::optional<Slice> slice = std::nullopt);
+
+  /// read the rows of slice that are in one of ranges; the other rows of the
+  /// result are null and are not fetched from storage
+  ///   \param uri an identifier for a parquet file
+  ///   \param ranges sorted and disjoint, as returned by FindMatchingRows
+  katana::Result<std::shared_ptr<arrow::Table>> ReadRows(
+      const katana::Uri& uri, const std::vector<Slice>& ranges, Slice slice);
+
+  /// open a table to read it one row group at a time
+  ///   \param uri an identifier for a parquet file
+  katana::Result<std::unique_ptr<RowGroupTable>> OpenRowGroups(
+      const katana::Uri& uri);
+
   /// read only the schema from a parquet file in storage
   katana::Result<std::shared_ptr<arrow::Schema>> GetSchema(
       const katana::Uri& uri);
 
-  /// read a column part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
+  /// read a column part of a table from storage, optionally reading only
+  /// the row groups that overlap slice
   ///   \param uri an identifier for a parquet file
   ///   \param column_idx must be a valid column index for the table in that
   ///      file
   katana::Result<std::shared_ptr<arrow::Table>> ReadColumn(
-      const katana::Uri& uri, int32_t column_idx);
+      const katana::Uri& uri, int32_t column_idx,
+      std::optional<Slice> slice = std::nullopt);
 
   /// Get the number of columns for the table stored in a parquet file
   ///   \param uri an identifier for a parquet file
@@ -77,7 +168,13 @@ public:
   katana::Result<std::vector<std::string>> GetFiles(const katana::Uri& uri);
 
 private:
-  ParquetReader(bool make_canonical) : make_canonical_{make_canonical} {}
+  ParquetReader(
+      const ReadOpts& opts,
+      std::shared_ptr<arrow::internal::ThreadPool> io_pool)
+      : make_canonical_{opts.make_canonical},
+        combine_chunks_{opts.combine_chunks},
+        parallel_{opts.parallel},
+        io_pool_{std::move(io_pool)} {}
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::Uri& uri);
@@ -89,6 +186,9 @@ private:
       const std::shared_ptr<arrow::Schema>& schema);
 
   bool make_canonical_;
+  bool combine_chunks_;
+  bool parallel_;
+  std::shared_ptr<arrow::internal::ThreadPool> io_pool_;
 };
 
 }  // namespace katana
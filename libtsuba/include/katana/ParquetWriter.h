@@ -2,6 +2,9 @@
 #define KATANA_LIBTSUBA_KATANA_PARQUETWRITER_H_
 
 #include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <arrow/api.h>
@@ -11,10 +14,21 @@
 #include "katana/URI.h"
 #include "katana/WriteGroup.h"
 
+namespace parquet::arrow {
+class FileWriter;
+}  // namespace parquet::arrow
+
 namespace katana {
 
 class KATANA_EXPORT ParquetWriter {
 public:
+  /// How a column is encoded; unset fields take the value for the table
+  struct ColumnOpts {
+    std::optional<arrow::Compression::type> compression;
+    std::optional<int> compression_level;
+    std::optional<bool> dictionary;
+  };
+
   struct WriteOpts {
     /// int64 timestamps with nanosecond resolution requires Parquet version
     /// 2.0. In Arrow to Parquet version 1.0, nanosecond timestamps will get
@@ -31,6 +45,27 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// tables with string or binary columns larger than this are split into
+    /// part files of about this size, which are encoded in parallel; 0 writes
+    /// them to one file
+    uint64_t mbs_per_part{512};
+
+    /// codec for the column chunks, e.g., arrow::Compression::ZSTD,
+    /// arrow::Compression::LZ4 or arrow::Compression::SNAPPY
+    arrow::Compression::type compression{arrow::Compression::UNCOMPRESSED};
+    /// codec specific level, the codec's default if unset
+    std::optional<int> compression_level;
+    /// dictionary encode columns; pays off for low cardinality columns like
+    /// enums and repeated strings, parquet falls back to plain encoding for a
+    /// column chunk whose dictionary grows too large
+    bool dictionary{true};
+    /// the maximum number of rows in a row group; smaller row groups make
+    /// sliced, filtered and paged reads finer grained
+    int64_t max_row_group_length{parquet::DEFAULT_MAX_ROW_GROUP_LENGTH};
+    /// overrides for the columns with these names
+    std::unordered_map<std::string, ColumnOpts> column_opts;
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -57,14 +92,54 @@ public:
   katana::Result<void> WriteToUri(
       const katana::Uri& uri, WriteGroup* group = nullptr);
 
+  /// A table written to a local file a batch of rows at a time, for tables
+  /// too large to hold in memory. Each Append adds at least one row group.
+  /// Like WriteToUri, a table with more rows than fit in one parquet file is
+  /// split into part files next to a file holding their offsets.
+  class KATANA_EXPORT Stream {
+  public:
+    Stream(const Stream& no_copy) = delete;
+    Stream& operator=(const Stream& no_copy) = delete;
+    ~Stream();
+
+    /// \param path the local file to write; part files, if any, are named
+    ///    by adding a suffix to it
+    /// \param schema the schema of every batch appended
+    static katana::Result<std::unique_ptr<Stream>> Make(
+        const std::string& path, std::shared_ptr<arrow::Schema> schema,
+        WriteOpts opts = WriteOpts::Defaults());
+
+    katana::Result<void> Append(const std::shared_ptr<arrow::Table>& batch);
+
+    /// finish writing the table
+    /// \returns the files written, path first
+    katana::Result<std::vector<std::string>> Finish();
+
+    const std::shared_ptr<arrow::Schema>& schema() const;
+    int64_t num_rows() const;
+
+  private:
+    class Impl;
+
+    Stream(std::unique_ptr<Impl>&& impl);
+
+    katana::Result<void> OpenPart();
+    katana::Result<void> ClosePart();
+
+    std::unique_ptr<Impl> impl_;
+  };
+
 private:
   ParquetWriter(
       std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts)
-      : tables_(std::move(tables)), opts_(opts) {}
+      : tables_(std::move(tables)), opts_(std::move(opts)) {}
+
+  static katana::Result<void> ValidateOpts(const WriteOpts& opts);
 
   std::shared_ptr<parquet::WriterProperties> StandardWriterProperties();
 
-  std::shared_ptr<parquet::ArrowWriterProperties> StandardArrowProperties();
+  std::shared_ptr<parquet::ArrowWriterProperties> StandardArrowProperties(
+      const arrow::Schema& schema);
 
   katana::Result<void> StoreParquet(
       const katana::Uri& uri, katana::WriteGroup* desc);
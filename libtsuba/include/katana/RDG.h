@@ -12,17 +12,22 @@
 #include <nlohmann/json.hpp>
 
 #include "katana/Cache.h"
+#include "katana/ContentHash.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileFrame.h"
 #include "katana/FileView.h"
 #include "katana/NUMAArray.h"
+#include "katana/PagedProperty.h"
+#include "katana/ParquetWriter.h"
 #include "katana/PartitionMetadata.h"
 #include "katana/RDGLineage.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
 #include "katana/RDKLSHIndexPrimitive.h"
 #include "katana/RDKSubstructureIndexPrimitive.h"
+#include "katana/ReachabilityIndexPrimitive.h"
 #include "katana/ReadGroup.h"
 #include "katana/Result.h"
 #include "katana/TxnContext.h"
@@ -48,12 +53,38 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   std::optional<std::vector<std::string>> edge_properties{std::nullopt};
+  /// Map topology files read only in place instead of copying them into
+  /// memory, when they are on local storage. The default topology of a
+  /// PropertyGraph then uses the mapped pages directly, sharing them with
+  /// every other process that maps the same file, and must not be modified.
+  bool map_topology_in_place{false};
+  /// How the topology file is expected to be accessed when it is mapped in
+  /// place
+  FileView::MapAdvice topology_map_advice{FileView::MapAdvice::kNormal};
+  /// Fetch the csr topology file while the RDG is loaded, alongside its
+  /// properties, rather than on the first call to GetTopology. The topology
+  /// stays bound until it is unbound, which must happen before the RDG is
+  /// stored.
+  bool prefetch_topology{false};
+  /// Share the property files that another graph loaded with this option and
+  /// still uses rather than reading them again, e.g., the properties that did
+  /// not change between two versions of an RDG open at the same time. Shared
+  /// properties are the same columns in memory: values written in place
+  /// through a view of one are seen by every graph sharing it. The default
+  /// topology is shared the same way; see PropertyGraph::Make.
+  bool share_loaded_files{false};
+  /// Trust the stored topology and entity type ids rather than scanning them
+  /// when PropertyGraph::Make loads them, leaving only the checks that take
+  /// constant time. For graphs this process or a trusted one wrote, where a
+  /// full scan would cost as much as the load itself.
+  bool trusted_load{false};
 
   /// Build a default options struct the default behavior is:
   ///  * load the partition associated with this host
   ///  * load all node properties
   ///  * load all edge properties
   ///  * do not use a property cache
+  ///  * copy the topology into memory
   static RDGLoadOptions Defaults() { return RDGLoadOptions{}; }
 };
 
@@ -188,6 +219,40 @@ public:
   katana::Result<Uri> GetEdgePropertyStorageLocation(
       const std::string& name) const;
 
+  /// The hash of the contents of a clean or absent node property stored
+  /// with it, if one was; none for dirty properties
+  std::optional<ContentHash> GetNodePropertyContentHash(
+      const std::string& name) const;
+
+  /// Remember the hash of the contents of a clean or absent node property,
+  /// to be stored with it the next time the RDG is stored; it is forgotten
+  /// when the property changes. Will return an error if the property is
+  /// dirty.
+  katana::Result<void> SetNodePropertyContentHash(
+      const std::string& name, ContentHash hash);
+
+  /// Like GetNodePropertyContentHash for edge properties
+  std::optional<ContentHash> GetEdgePropertyContentHash(
+      const std::string& name) const;
+
+  /// Like SetNodePropertyContentHash for edge properties
+  katana::Result<void> SetEdgePropertyContentHash(
+      const std::string& name, ContentHash hash);
+
+  /// Open the node property with a particular name to be read from storage
+  /// a page at a time rather than loaded whole. Will return an error if the
+  /// property is not clean or absent
+  katana::Result<std::unique_ptr<PagedProperty>> OpenPagedNodeProperty(
+      const std::string& name,
+      const PagedProperty::Options& opts = PagedProperty::Options{}) const;
+
+  /// Open the edge property with a particular name to be read from storage
+  /// a page at a time rather than loaded whole. Will return an error if the
+  /// property is not clean or absent
+  katana::Result<std::unique_ptr<PagedProperty>> OpenPagedEdgeProperty(
+      const std::string& name,
+      const PagedProperty::Options& opts = PagedProperty::Options{}) const;
+
   /// Load node property with a particular name and insert it into the
   /// property table at index. If index is invalid, the property is put
   /// in the last slot. A given property cannot be loaded more than once
@@ -199,6 +264,18 @@ public:
   /// cannot be loaded more than once
   katana::Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
+  /// Load the node properties with the given names and append them to the
+  /// property table. Their reads are issued together and overlap, rather
+  /// than one load waiting for the one before it. None of them may be
+  /// loaded already
+  katana::Result<void> LoadNodeProperties(
+      const std::vector<std::string>& names);
+
+  /// Load the edge properties with the given names as LoadNodeProperties
+  /// does node properties
+  katana::Result<void> LoadEdgeProperties(
+      const std::vector<std::string>& names);
+
   std::vector<std::string> ListFullNodeProperties() const;
   std::vector<std::string> ListLoadedNodeProperties() const;
   std::vector<std::string> ListFullEdgeProperties() const;
@@ -230,6 +307,13 @@ public:
   /// If it does, the RDG returns the topology
   katana::Result<katana::RDGTopology*> GetTopology(const RDGTopology& shadow);
 
+  /// Like GetTopology, but without binding the topology file
+  bool HasTopology(const RDGTopology& shadow);
+
+  /// report where the topology matching shadow is stored, without binding
+  /// it; Will return an error if there is none or it is not in storage
+  katana::Result<Uri> GetTopologyStorageLocation(const RDGTopology& shadow);
+
   katana::Result<void> UnbindNodeEntityTypeIDArrayFileStorage();
 
   /// Inform this RDG that its Node Entity Type ID Array is in storage at this
@@ -248,6 +332,22 @@ public:
   katana::Result<void> SetEdgeEntityTypeIDArrayFile(
       const katana::Uri& new_type_id_array);
 
+  /// Inform this RDG of a node property stored, as a parquet table with
+  /// one column named name, at this location without loading it into memory.
+  /// The property is unloaded until it is loaded like any other.
+  /// \param prop_file must exist and be in the correct directory for this RDG
+  /// but it need not be writable
+  katana::Result<void> AddNodePropertyByFile(
+      const std::string& name, const katana::Uri& prop_file);
+
+  /// Inform this RDG of an edge property stored, as a parquet table with
+  /// one column named name, at this location without loading it into memory.
+  /// The property is unloaded until it is loaded like any other.
+  /// \param prop_file must exist and be in the correct directory for this RDG
+  /// but it need not be writable
+  katana::Result<void> AddEdgePropertyByFile(
+      const std::string& name, const katana::Uri& prop_file);
+
   //
   // accessors and mutators
   //
@@ -272,6 +372,10 @@ public:
   /// Remove topology data
   katana::Result<void> DropAllTopologies();
 
+  /// Mark all topologies invalid, so they are neither returned by GetTopology
+  /// nor stored. Use when the graph they describe has changed.
+  void InvalidateAllTopologies();
+
   std::shared_ptr<arrow::Schema> full_node_schema() const;
 
   std::shared_ptr<arrow::Schema> full_edge_schema() const;
@@ -316,6 +420,21 @@ public:
 
   void set_view_name(const std::string& v) { view_type_ = v; }
 
+  /// Whether this was loaded to share files with other graphs; see
+  /// RDGLoadOptions
+  bool share_loaded_files() const { return share_loaded_files_; }
+
+  /// Whether the stored data is trusted without scanning it; see
+  /// RDGLoadOptions
+  bool trusted_load() const { return trusted_load_; }
+
+  /// How properties are encoded when they are written to storage, e.g., the
+  /// compression codec of each property
+  const ParquetWriter::WriteOpts& write_opts() const { return write_opts_; }
+  void set_write_opts(ParquetWriter::WriteOpts opts) {
+    write_opts_ = std::move(opts);
+  }
+
   // Returns katana::ResultErrno if the RDKLSHIndexPrimitive is not found on disk
   katana::Result<std::optional<katana::RDKLSHIndexPrimitive>>
   LoadRDKLSHIndexPrimitive();
@@ -330,8 +449,29 @@ public:
   katana::Result<void> WriteRDKSubstructureIndexPrimitive(
       katana::RDKSubstructureIndexPrimitive& index);
 
+  // Returns katana::ResultErrno if the ReachabilityIndexPrimitive is not found on disk
+  katana::Result<std::optional<katana::ReachabilityIndexPrimitive>>
+  LoadReachabilityIndexPrimitive();
+
+  katana::Result<void> WriteReachabilityIndexPrimitive(
+      katana::ReachabilityIndexPrimitive& index);
+
+  // Returns katana::ResultErrno if the EntityIndexPrimitive stored as name is
+  // not found on disk
+  katana::Result<std::optional<katana::EntityIndexPrimitive>>
+  LoadEntityIndexPrimitive(const std::string& name);
+
+  katana::Result<void> WriteEntityIndexPrimitive(
+      const std::string& name, katana::EntityIndexPrimitive& index);
+
 private:
   std::string view_type_;
+  bool map_topology_in_place_{false};
+  FileView::MapAdvice topology_map_advice_{FileView::MapAdvice::kNormal};
+  bool prefetch_topology_{false};
+  bool share_loaded_files_{false};
+  bool trusted_load_{false};
+  ParquetWriter::WriteOpts write_opts_;
   RDG(std::unique_ptr<RDGCore>&& core);
 
   void InitEmptyTables();
@@ -16,10 +16,71 @@
 #include "katana/URI.h"
 #include "katana/WriteGroup.h"
 #include "katana/config.h"
+#include "katana/file.h"
 #include "katana/tsuba.h"
 
 namespace katana {
 
+/// An array of an optional datastructure: in memory, borrowed from its owner
+/// to be stored, or mapped read only from its file, so that a large
+/// datastructure is usable as soon as it is loaded and shares the page cache
+/// between processes.
+template <typename T>
+class OptionalDatastructureArray {
+public:
+  OptionalDatastructureArray() = default;
+  explicit OptionalDatastructureArray(std::vector<T>&& values)
+      : values_(std::move(values)) {}
+
+  /// An array of the size values at data, which must outlive it
+  static OptionalDatastructureArray Borrow(const T* data, uint64_t size) {
+    OptionalDatastructureArray array;
+    array.borrowed_ = data;
+    array.borrowed_size_ = size;
+    return array;
+  }
+
+  const T* data() const {
+    if (file_.Valid()) {
+      return file_.ptr<T>();
+    }
+    return borrowed_ != nullptr ? borrowed_ : values_.data();
+  }
+  uint64_t size() const {
+    if (file_.Valid()) {
+      return file_.size() / sizeof(T);
+    }
+    return borrowed_ != nullptr ? borrowed_size_ : values_.size();
+  }
+
+  katana::Result<void> Store(const katana::Uri& path) const {
+    return katana::FileStore(path.string(), data(), size() * sizeof(T));
+  }
+
+  katana::Result<void> Map(const katana::Uri& path, uint64_t size) {
+    values_.clear();
+    borrowed_ = nullptr;
+    borrowed_size_ = 0;
+    // mapping an empty file fails, and it has nothing to map anyway
+    if (size > 0) {
+      KATANA_CHECKED(file_.MapReadOnly(path.string()));
+    }
+    if (this->size() != size) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "{} holds {} entries but the manifest says {}", path, this->size(),
+          size);
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  std::vector<T> values_;
+  const T* borrowed_{nullptr};
+  uint64_t borrowed_size_{0};
+  katana::FileView file_;
+};
+
 /// Base class for all optional datastructures.
 /// Paths to the RDGOptionalDatastructure files are stored in the RDGPartHeader::optional_datastructure_manifests_
 class KATANA_EXPORT RDGOptionalDatastructure {
@@ -48,13 +109,9 @@ public:
     // copy over any extra files the optional datastructure relies on
     // Assumes that all OptionalDatastructures properly extend the RDGOptionalDatastructure class
     for (const auto& file : data.paths_) {
-      katana::FileView fvtmp;
-      katana::Uri old_path = old_loc.Join(file.second);
-      KATANA_CHECKED(fvtmp.Bind(old_path.string(), true));
-      katana::Uri new_path = new_loc.Join(file.second);
-      KATANA_CHECKED(katana::FileStore(
-          new_path.string(), fvtmp.ptr<uint8_t>(), fvtmp.size()));
-      KATANA_CHECKED(fvtmp.Unbind());
+      KATANA_CHECKED(katana::FileCopy(
+          old_loc.Join(file.second).string(),
+          new_loc.Join(file.second).string()));
     }
 
     // copy out the manifest itself
@@ -9,6 +9,7 @@
 
 #include "katana/FileView.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParquetReader.h"
 #include "katana/RDGLineage.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
@@ -44,6 +45,14 @@ public:
     std::pair<uint64_t, uint64_t> edge_range;
     uint64_t topo_off;
     uint64_t topo_size;
+    /// Filters on node (edge) properties, named by ColumnFilter::column. If
+    /// there are any, the rows of node_range (edge_range) that cannot satisfy
+    /// all of them, judging by the row group statistics of the filtered
+    /// properties, are not fetched and are null in every loaded node (edge)
+    /// property. Other rows are loaded as stored, whether or not they
+    /// satisfy the filters.
+    std::vector<ParquetReader::ColumnFilter> node_filters;
+    std::vector<ParquetReader::ColumnFilter> edge_filters;
   };
 
   static katana::Result<RDGSlice> Make(
@@ -0,0 +1,140 @@
+#ifndef KATANA_LIBTSUBA_KATANA_RDGSTREAMWRITER_H_
+#define KATANA_LIBTSUBA_KATANA_RDGSTREAMWRITER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ParquetWriter.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Builds an RDG from batches of nodes and edges without holding the graph in
+/// memory, for graphs too large for RDG::Store.
+///
+/// Nodes are numbered in the order they are added, starting from zero, and
+/// their properties are written as they arrive. Edges may arrive in any order.
+/// Once max_run_edges edges are buffered, they are sorted by source into a
+/// run which is spilled to disk. Finish merges the runs into the CSR topology
+/// and the edge properties in CSR order, reading a row group of each run at a
+/// time, and stores a new version of the RDG. Edges with the same source keep
+/// the order in which they were added.
+///
+/// The first batch of nodes (edges) fixes the node (edge) property schema,
+/// which is empty if the batch has no properties. Later batches have the same
+/// schema or no properties, in which case their properties are null. Entity
+/// types are not known to the writer, so every node and edge gets
+/// kUnknownEntityType.
+///
+/// Memory use is bounded by a run and a row group of each run; disk use in
+/// spill_dir is about twice the size of the edges and their properties.
+/// An RDGStreamWriter writes a single partition from a single host.
+class KATANA_EXPORT RDGStreamWriter {
+public:
+  struct Options {
+    /// Directory in which spilled runs and the files of the RDG are written
+    /// before they are copied to the RDG; the system temporary directory if
+    /// empty
+    std::string spill_dir;
+    /// Edges buffered in memory before they are sorted and spilled
+    uint64_t max_run_edges{UINT64_C(64) << 20};
+    /// Rows in each row group of a run, the unit in which runs are read back
+    /// during the merge, and in each batch of merged edge properties
+    int64_t merge_batch_rows{INT64_C(64) << 10};
+    /// How properties are encoded in the new RDG
+    ParquetWriter::WriteOpts write_opts{ParquetWriter::WriteOpts::Defaults()};
+  };
+
+  RDGStreamWriter(const RDGStreamWriter& no_copy) = delete;
+  RDGStreamWriter& operator=(const RDGStreamWriter& no_copy) = delete;
+
+  ~RDGStreamWriter();
+
+  /// Create an RDG named rdg_name to write to
+  static katana::Result<std::unique_ptr<RDGStreamWriter>> Make(
+      const std::string& rdg_name, Options opts = Options());
+
+  /// Add props->num_rows() nodes with properties props
+  katana::Result<void> AddNodes(const std::shared_ptr<arrow::Table>& props);
+
+  /// Add num_nodes nodes whose properties, if any, are null
+  katana::Result<void> AddNodes(uint64_t num_nodes);
+
+  /// Add the edges from srcs[i] to dsts[i] with the properties in row i of
+  /// props, or null properties if props is null. Sources and destinations are
+  /// node numbers, which need only be valid by the time Finish is called.
+  katana::Result<void> AddEdges(
+      const std::shared_ptr<arrow::UInt32Array>& srcs,
+      const std::shared_ptr<arrow::UInt32Array>& dsts,
+      const std::shared_ptr<arrow::Table>& props = nullptr);
+
+  /// Merge the runs and store the RDG with lineage based on command_line.
+  /// Nothing may be added afterwards.
+  katana::Result<void> Finish(const std::string& command_line);
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+  /// Sorted runs spilled so far
+  size_t num_runs() const { return run_paths_.size(); }
+
+private:
+  struct PropStream {
+    std::string name;
+    std::unique_ptr<ParquetWriter::Stream> stream;
+  };
+
+  RDGStreamWriter(
+      std::string rdg_name, Options opts, katana::Uri rdg_dir,
+      std::string work_dir);
+
+  /// Open a stream for each property of schema, writing to the file that
+  /// will hold the property in the RDG
+  katana::Result<std::vector<PropStream>> MakePropStreams(
+      const arrow::Schema& schema);
+
+  /// Hold batch until merge_batch_rows rows can be written as one row group
+  katana::Result<void> BufferNodes(std::shared_ptr<arrow::Table> batch);
+  katana::Result<void> FlushNodes();
+
+  katana::Result<void> SpillRun();
+
+  /// Merge the runs, writing the CSR topology to the local file
+  /// topology_path
+  /// \returns the unfinished streams of the edge properties, in CSR order
+  katana::Result<std::vector<PropStream>> MergeRuns(
+      const std::string& topology_path);
+
+  std::string WorkPath(const std::string& file_name) const;
+
+  std::string rdg_name_;
+  Options opts_;
+  katana::Uri rdg_dir_;
+  /// private to this writer, removed when it is destroyed
+  std::string work_dir_;
+
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+
+  std::shared_ptr<arrow::Schema> node_schema_;
+  std::vector<PropStream> node_props_;
+  std::vector<std::shared_ptr<arrow::Table>> node_batches_;
+  int64_t node_batch_rows_{0};
+
+  std::shared_ptr<arrow::Schema> edge_schema_;
+  /// batches of unsorted edges: src, dst and then the edge properties
+  std::vector<std::shared_ptr<arrow::Table>> run_batches_;
+  uint64_t run_edges_{0};
+  std::vector<std::string> run_paths_;
+
+  bool finished_{false};
+};
+
+}  // namespace katana
+
+#endif
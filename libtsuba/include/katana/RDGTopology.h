@@ -37,14 +37,21 @@ public:
     kAny = 0,  // don't care. Sorted or Unsorted
     kSortedByDestID,
     kSortedByEdgeType,
-    kSortedByNodeType
+    kSortedByNodeType,
+    // by the value of an edge property, then destination; the property is
+    // not recorded, so these topologies are not cached or stored with views
+    kSortedByEdgeProperty
   };
 
   enum class NodeSortKind : int {
     kInvalid = -1,
     kAny = 0,
     kSortedByDegree,
-    kSortedByNodeType
+    kSortedByNodeType,
+    // Locality orderings
+    kReverseCuthillMcKee,
+    kHubSorted,
+    kHubClustered
   };
 
   enum class TopologyKind : int {
@@ -52,7 +59,8 @@ public:
     kCSR = 0,
     kEdgeShuffleTopology,
     kShuffleTopology,
-    kEdgeTypeAwareTopology
+    kEdgeTypeAwareTopology,
+    kCompressedTopology
   };
 
   //
@@ -74,6 +82,7 @@ public:
   void unmap_file_storage() {
     adj_indices_ = nullptr;
     dests_ = nullptr;
+    compressed_dests_ = nullptr;
     edge_index_to_property_index_map_ = nullptr;
     node_index_to_property_index_map_ = nullptr;
     edge_condensed_type_id_map_ = nullptr;
@@ -119,6 +128,21 @@ public:
     return dests_;
   }
 
+  /// Only present for TopologyKind::kCompressedTopology, in which case dests()
+  /// is absent. The blob is opaque to storage; its layout is owned by the
+  /// in-memory topology that produced it.
+  /// Requires backing FileView to be mapped & bound, or the RDGTopology to be filled from memory
+  const uint8_t* compressed_dests() const {
+    KATANA_LOG_VASSERT(
+        compressed_dests_ != nullptr,
+        "Either this optional field is not present, or the RDGTopology must be "
+        "either bound & mapped, or filled from memory.");
+    return compressed_dests_;
+  }
+
+  /// Size in bytes of compressed_dests()
+  uint64_t compressed_dests_size() const { return compressed_dests_size_; }
+
   /// Optional field, may not be present depending on the kind of topology this is
   /// Requires backing FileView to be mapped & bound, or the RDGTopology to be filled from memory
   const uint64_t* node_index_to_property_index_map() const {
@@ -139,6 +163,14 @@ public:
     return edge_index_to_property_index_map_;
   }
 
+  bool has_node_index_to_property_index_map() const {
+    return node_index_to_property_index_map_ != nullptr;
+  }
+
+  bool has_edge_index_to_property_index_map() const {
+    return edge_index_to_property_index_map_ != nullptr;
+  }
+
   /// Optional field, may not be present depending on the kind of topology this is
   /// Requires backing FileView to be mapped & bound, or the RDGTopology to be filled from memory
   const katana::EntityTypeID* edge_condensed_type_id_map() const {
@@ -205,6 +237,12 @@ public:
       const katana::Uri& metadata_dir, uint64_t begin, uint64_t end,
       bool resolve);
 
+  /// Bind the entire topology file read only in place rather than copying
+  /// it, see FileView::MapReadOnly
+  katana::Result<void> BindInPlace(
+      const katana::Uri& metadata_dir,
+      FileView::MapAdvice advice = FileView::MapAdvice::kNormal);
+
   /// Map takes the file buffer of a topology file and extracts the
   /// topology elements
   ///
@@ -222,6 +260,10 @@ public:
   ///   uint32_t[num_edges] out_dests: destinations (node indexes) of each edge
   ///   uint32_t padding if num_edges is odd
   ///
+  /// For TopologyKind::kCompressedTopology, out_dests is replaced by
+  ///   uint8_t[compressed_dests_size] compressed_dests: encoded destinations
+  ///   uint8_t padding to the next uint64_t boundary
+  ///
   ///   <optional topology data structures follow>
   ///
   ///   uint64_t magic_number: sum of num_edges + num_nodes
@@ -294,6 +336,17 @@ public:
       const uint64_t* edge_index_to_property_index_map,
       const uint64_t* node_index_to_property_index_map);
 
+  /// Make an RDGTopology for a Compressed Topology from in memory structures.
+  /// edge_index_to_property_index_map and node_index_to_property_index_map
+  /// may be null, in which case they are not stored.
+  static katana::Result<katana::RDGTopology> Make(
+      const uint64_t* adj_indices, uint64_t num_nodes,
+      const uint8_t* compressed_dests, uint64_t compressed_dests_size,
+      uint64_t num_edges, TransposeKind transpose_state,
+      EdgeSortKind edge_sort_state,
+      const uint64_t* edge_index_to_property_index_map,
+      const uint64_t* node_index_to_property_index_map);
+
   /// Make and fully populate an RDGTopology from in memory structures
   static katana::Result<katana::RDGTopology> Make(
       const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
@@ -322,6 +375,7 @@ private:
   NodeSortKind node_sort_state_{-1};
   uint64_t edge_condensed_type_id_map_size_{0};
   uint64_t node_condensed_type_id_map_size_{0};
+  uint64_t compressed_dests_size_{0};
 
   // File store state
   /// Flag to show if we have mapped the file store to memory
@@ -340,6 +394,7 @@ private:
   // must be loaded from file store or set
   const uint64_t* adj_indices_{nullptr};
   const uint32_t* dests_{nullptr};
+  const uint8_t* compressed_dests_{nullptr};
   const uint64_t* edge_index_to_property_index_map_{nullptr};
   const uint64_t* node_index_to_property_index_map_{nullptr};
   const katana::EntityTypeID* edge_condensed_type_id_map_{nullptr};
@@ -1,12 +1,17 @@
 #ifndef KATANA_LIBTSUBA_KATANA_RDKLSHINDEXPRIMITIVE_H_
 #define KATANA_LIBTSUBA_KATANA_RDKLSHINDEXPRIMITIVE_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "katana/AtomicWrapper.h"
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
 #include "katana/FileView.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
@@ -23,17 +28,48 @@ namespace katana {
 const std::string kOptionalDatastructureRDKLSHIndexPrimitive =
     "kg.v1.rdk_lsh_index";
 
+/// A locality sensitive hashing index of molecule fingerprints: a hash table
+/// per bucket of hashes, from a hash key to the fingerprints that have it.
+///
+/// The tables are flat arrays in files of their own, which Load maps in
+/// place rather than reading, so that loading does not build a node per
+/// key: the sorted keys of every table, one after another, and the members
+/// of every key, with CSR offsets into both. A lookup is a binary search of
+/// the keys of a table and a contiguous scan of the members of the key.
 class KATANA_EXPORT RDKLSHIndexPrimitive
     : private katana::RDGOptionalDatastructure {
 public:
+  template <typename T>
+  using Array = OptionalDatastructureArray<T>;
+
+  /// The hash tables of the buckets: the keys of table t are
+  /// table_offsets[t] to table_offsets[t + 1] of keys, sorted, and the
+  /// members of key k are member_offsets[k] to member_offsets[k + 1] of
+  /// members.
+  struct HashTables {
+    Array<uint64_t> table_offsets;
+    Array<uint64_t> keys;
+    Array<uint64_t> member_offsets;
+    Array<uint64_t> members;
+  };
+
   static katana::Result<RDKLSHIndexPrimitive> Load(
       const katana::Uri& rdg_dir_path, const std::string& path) {
     RDKLSHIndexPrimitive index =
         KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    KATANA_CHECKED(index.MapHashTables(rdg_dir_path));
     return index;
   }
 
   katana::Result<std::string> Write(katana::Uri rdg_dir_path) {
+    paths_.clear();
+    KATANA_CHECKED(StoreArray(
+        rdg_dir_path, "table_offsets", hash_tables_.table_offsets));
+    KATANA_CHECKED(StoreArray(rdg_dir_path, "keys", hash_tables_.keys));
+    KATANA_CHECKED(StoreArray(
+        rdg_dir_path, "member_offsets", hash_tables_.member_offsets));
+    KATANA_CHECKED(StoreArray(rdg_dir_path, "members", hash_tables_.members));
+
     // Write out our json manifest
     katana::Uri manifest_path = rdg_dir_path.RandFile("rdk_lsh_index_manifest");
     KATANA_CHECKED(WriteManifest(manifest_path.string()));
@@ -52,12 +88,74 @@ public:
   size_t num_fingerprints() const { return num_fingerprints_; }
   void set_num_fingerprints(const size_t num) { num_fingerprints_ = num; }
 
-  std::vector<std::map<uint64_t, std::vector<uint64_t>>>& hash_structure() {
-    return hash_structure_;
+  /// The number of hash tables
+  uint64_t num_tables() const {
+    uint64_t num_offsets = hash_tables_.table_offsets.size();
+    return num_offsets == 0 ? 0 : num_offsets - 1;
   }
+
+  const HashTables& hash_tables() const { return hash_tables_; }
+  void set_hash_tables(HashTables tables) { hash_tables_ = std::move(tables); }
+
+  /// The members of key in table, of the num_tables(), as a range
+  std::pair<const uint64_t*, const uint64_t*> Find(
+      uint64_t table, uint64_t key) const {
+    const uint64_t* table_offsets = hash_tables_.table_offsets.data();
+    const uint64_t* keys = hash_tables_.keys.data();
+    const uint64_t* members = hash_tables_.members.data();
+    const uint64_t* first = keys + table_offsets[table];
+    const uint64_t* last = keys + table_offsets[table + 1];
+    const uint64_t* it = std::lower_bound(first, last, key);
+    if (it == last || *it != key) {
+      return {members, members};
+    }
+    const uint64_t* member_offsets = hash_tables_.member_offsets.data();
+    return {
+        members + member_offsets[it - keys],
+        members + member_offsets[it - keys + 1]};
+  }
+
+  /// The hash tables as maps; Find reads them without making the maps
+  std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_structure()
+      const {
+    const uint64_t* table_offsets = hash_tables_.table_offsets.data();
+    const uint64_t* keys = hash_tables_.keys.data();
+    const uint64_t* member_offsets = hash_tables_.member_offsets.data();
+    const uint64_t* members = hash_tables_.members.data();
+    std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_struct(
+        num_tables());
+    for (uint64_t t = 0; t < hash_struct.size(); ++t) {
+      for (uint64_t k = table_offsets[t]; k < table_offsets[t + 1]; ++k) {
+        hash_struct[t].emplace(
+            keys[k], std::vector<uint64_t>(
+                         members + member_offsets[k],
+                         members + member_offsets[k + 1]));
+      }
+    }
+    return hash_struct;
+  }
+
+  /// Set the hash tables to the maps of hash_struct
   void set_hash_structure(
-      std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_struct) {
-    hash_structure_ = std::move(hash_struct);
+      const std::vector<std::map<uint64_t, std::vector<uint64_t>>>&
+          hash_struct) {
+    std::vector<uint64_t> table_offsets{0};
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> member_offsets{0};
+    std::vector<uint64_t> members;
+    for (const auto& table : hash_struct) {
+      for (const auto& [key, key_members] : table) {
+        keys.emplace_back(key);
+        members.insert(members.end(), key_members.begin(), key_members.end());
+        member_offsets.emplace_back(members.size());
+      }
+      table_offsets.emplace_back(keys.size());
+    }
+    hash_tables_ = HashTables{
+        Array<uint64_t>(std::move(table_offsets)),
+        Array<uint64_t>(std::move(keys)),
+        Array<uint64_t>(std::move(member_offsets)),
+        Array<uint64_t>(std::move(members))};
   }
 
   std::vector<katana::DynamicBitset>& fingerprints() { return fingerprints_; }
@@ -78,15 +176,54 @@ private:
   uint64_t num_buckets_;
   uint64_t fingerprint_length_;
   size_t num_fingerprints_;
+  /// Set by the manifest, for the hash tables to be mapped
+  uint64_t table_offsets_size_{0};
+  uint64_t keys_size_{0};
+  uint64_t member_offsets_size_{0};
+  uint64_t members_size_{0};
 
   std::vector<std::string> smiles_;
 
+  // Array of fingerprint bitsets indexed on num_fingerprints_
+  std::vector<katana::DynamicBitset> fingerprints_;
+
   /// data structures dumped to their own files
 
-  std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_structure_;
+  HashTables hash_tables_;
 
-  // Array of fingerprint bitsets indexed on num_fingerprints_
-  std::vector<katana::DynamicBitset> fingerprints_;
+  katana::Result<void> StoreArray(
+      const katana::Uri& rdg_dir_path, const std::string& name,
+      const Array<uint64_t>& array) {
+    katana::Uri path = rdg_dir_path.RandFile("rdk_lsh_index_" + name);
+    KATANA_CHECKED(array.Store(path));
+    paths_.emplace(name, path.BaseName());
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> MapHashTables(const katana::Uri& rdg_dir_path) {
+    auto map = [&](const std::string& name, Array<uint64_t>* array,
+                   uint64_t size) -> katana::Result<void> {
+      auto it = paths_.find(name);
+      if (it == paths_.end()) {
+        // A manifest of the hash tables as maps has them already
+        if (paths_.empty()) {
+          return katana::ResultSuccess();
+        }
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "rdk lsh index manifest has no {} file", name);
+      }
+      return array->Map(rdg_dir_path.Join(it->second), size);
+    };
+    KATANA_CHECKED(map(
+        "table_offsets", &hash_tables_.table_offsets, table_offsets_size_));
+    KATANA_CHECKED(map("keys", &hash_tables_.keys, keys_size_));
+    KATANA_CHECKED(map(
+        "member_offsets", &hash_tables_.member_offsets,
+        member_offsets_size_));
+    KATANA_CHECKED(map("members", &hash_tables_.members, members_size_));
+    return katana::ResultSuccess();
+  }
 
   static katana::Result<RDKLSHIndexPrimitive> LoadJson(
       const std::string& path) {
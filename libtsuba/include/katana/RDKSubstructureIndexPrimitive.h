@@ -1,12 +1,16 @@
 #ifndef KATANA_LIBTSUBA_KATANA_RDKSUBSTRUCTUREINDEXPRIMITIVE_H_
 #define KATANA_LIBTSUBA_KATANA_RDKSUBSTRUCTUREINDEXPRIMITIVE_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "katana/AtomicWrapper.h"
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
 #include "katana/FileView.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
@@ -23,17 +27,37 @@ namespace katana {
 const std::string kOptionalDatastructureRDKSubstructureIndexPrimitive =
     "kg.v1.rdk_substructure_index";
 
+/// A substructure index of molecules: their smiles, their fingerprints and,
+/// for every bit of a fingerprint, the entries that have it.
+///
+/// The fingerprints are one bit matrix, a row per entry, in a file of its
+/// own that Load maps in place. Rows are padded to a multiple of a cache
+/// line, so that Screen, which finds the entries whose fingerprints have
+/// every bit of a query, compares them a vector register at a time.
 class KATANA_EXPORT RDKSubstructureIndexPrimitive
     : private katana::RDGOptionalDatastructure {
 public:
+  template <typename T>
+  using Array = OptionalDatastructureArray<T>;
+
+  /// The words of a row of the fingerprint matrix are a multiple of this
+  static constexpr uint64_t kFingerprintWordAlign = 8;
+
   static katana::Result<RDKSubstructureIndexPrimitive> Load(
       const katana::Uri& rdg_dir_path, const std::string& path) {
     RDKSubstructureIndexPrimitive substructure_index =
         KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    KATANA_CHECKED(substructure_index.MapFingerprints(rdg_dir_path));
     return substructure_index;
   }
 
   katana::Result<std::string> Write(katana::Uri rdg_dir_path) {
+    paths_.clear();
+    katana::Uri fingerprints_path =
+        rdg_dir_path.RandFile("rdk_substructure_index_fingerprints");
+    KATANA_CHECKED(fingerprint_matrix_.Store(fingerprints_path));
+    paths_.emplace("fingerprints", fingerprints_path.BaseName());
+
     // Write out our json manifest
     katana::Uri manifest_path =
         rdg_dir_path.RandFile("rdk_substructure_index_manifest");
@@ -52,11 +76,62 @@ public:
     index_ = std::move(index);
   }
 
-  std::vector<katana::DynamicBitset>& fingerprints() { return fingerprints_; }
-  void set_fingerprints(std::vector<katana::DynamicBitset> prints) {
-    fingerprints_ = std::move(prints);
+  /// The number of bits of a fingerprint
+  uint64_t fingerprint_bits() const { return fingerprint_bits_; }
+
+  /// The number of words of a row of the fingerprint matrix
+  uint64_t fingerprint_words() const {
+    return RowWords(fingerprint_bits_);
+  }
+
+  /// The number of rows of the fingerprint matrix
+  uint64_t num_fingerprints() const {
+    uint64_t words = fingerprint_words();
+    return words == 0 ? 0 : fingerprint_matrix_.size() / words;
+  }
+
+  /// The words of the fingerprint of entry
+  const uint64_t* Fingerprint(uint64_t entry) const {
+    return fingerprint_matrix_.data() + entry * fingerprint_words();
+  }
+
+  /// The fingerprints as bitsets, all of fingerprint_bits()
+  std::vector<katana::DynamicBitset> fingerprints() const {
+    uint64_t words = fingerprint_words();
+    std::vector<katana::DynamicBitset> prints(num_fingerprints());
+    for (uint64_t e = 0; e < prints.size(); ++e) {
+      prints[e].resize(fingerprint_bits_);
+      auto& vec = prints[e].get_vec();
+      for (uint64_t w = 0; w < vec.size(); ++w) {
+        vec[w] = fingerprint_matrix_.data()[e * words + w];
+      }
+    }
+    return prints;
+  }
+
+  /// Set the fingerprint matrix to prints, as fingerprints of the bits of
+  /// the longest of them
+  void set_fingerprints(const std::vector<katana::DynamicBitset>& prints) {
+    fingerprint_bits_ = 0;
+    for (const auto& print : prints) {
+      fingerprint_bits_ = std::max<uint64_t>(fingerprint_bits_, print.size());
+    }
+    uint64_t words = fingerprint_words();
+    std::vector<uint64_t> matrix(prints.size() * words);
+    for (uint64_t e = 0; e < prints.size(); ++e) {
+      const auto& vec = prints[e].get_vec();
+      for (uint64_t w = 0; w < vec.size(); ++w) {
+        matrix[e * words + w] = vec[w];
+      }
+    }
+    fingerprint_matrix_ = Array<uint64_t>(std::move(matrix));
   }
 
+  /// The entries whose fingerprints have every bit of query, by increasing
+  /// entry. Entries are screened in parallel, with the widest vector
+  /// instructions of the machine.
+  std::vector<uint64_t> Screen(const katana::DynamicBitset& query) const;
+
   std::vector<std::string> smiles() { return smiles_; }
   void set_smiles(std::vector<std::string> smiles) {
     smiles_ = std::move(smiles);
@@ -75,12 +150,40 @@ private:
   // Array of smiles strings indexed on num_entries
   std::vector<std::string> smiles_;
 
-  // Array of fingerprint bitsets indexed on num_entries
-  std::vector<katana::DynamicBitset> fingerprints_;
+  uint64_t fingerprint_bits_{0};
+  /// Set by the manifest, for the fingerprints to be mapped
+  uint64_t fingerprint_matrix_size_{0};
 
   // has size fp_size
   std::vector<std::vector<std::uint64_t>> index_;
 
+  /// data structures dumped to their own files
+
+  // The fingerprints of the entries, indexed on num_entries, a row of
+  // fingerprint_words() each
+  Array<uint64_t> fingerprint_matrix_;
+
+  static uint64_t RowWords(uint64_t bits) {
+    uint64_t words = (bits + 63) / 64;
+    return (words + kFingerprintWordAlign - 1) / kFingerprintWordAlign *
+           kFingerprintWordAlign;
+  }
+
+  katana::Result<void> MapFingerprints(const katana::Uri& rdg_dir_path) {
+    auto it = paths_.find("fingerprints");
+    if (it == paths_.end()) {
+      // A manifest of the fingerprints as bitsets has them already
+      if (paths_.empty()) {
+        return katana::ResultSuccess();
+      }
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "rdk substructure index manifest has no fingerprints file");
+    }
+    return fingerprint_matrix_.Map(
+        rdg_dir_path.Join(it->second), fingerprint_matrix_size_);
+  }
+
   static katana::Result<RDKSubstructureIndexPrimitive> LoadJson(
       const std::string& path) {
     katana::FileView fv;
@@ -0,0 +1,168 @@
+#ifndef KATANA_LIBTSUBA_KATANA_REACHABILITYINDEXPRIMITIVE_H_
+#define KATANA_LIBTSUBA_KATANA_REACHABILITYINDEXPRIMITIVE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/RDGOptionalDatastructure.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "katana/file.h"
+
+namespace katana {
+
+const std::string kOptionalDatastructureReachabilityIndexPrimitive =
+    "kg.v1.reachability_index";
+
+/// The labels of a 2-hop cover of the paths of a graph: every node has a
+/// list of (hub, distance) entries for the hubs it reaches, its out labels,
+/// and one for the hubs that reach it, its in labels, sorted by hub. The
+/// hubs are ranks in the order the labels were built in.
+///
+/// The labels are stored in files of their own next to the manifest, which
+/// Load maps in place rather than reading, so that a large index is usable
+/// as soon as it is loaded and shares the page cache between processes.
+class KATANA_EXPORT ReachabilityIndexPrimitive
+    : private katana::RDGOptionalDatastructure {
+public:
+  /// An array of the labels, either in memory or mapped from its file
+  template <typename T>
+  using Array = OptionalDatastructureArray<T>;
+
+  /// The labels of one direction, as a CSR of the nodes
+  struct Labels {
+    /// The labels of node n are offsets[n] to offsets[n + 1]
+    Array<uint64_t> offsets;
+    Array<uint32_t> hubs;
+    Array<uint32_t> distances;
+  };
+
+  static katana::Result<ReachabilityIndexPrimitive> Load(
+      const katana::Uri& rdg_dir_path, const std::string& path) {
+    ReachabilityIndexPrimitive index =
+        KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    KATANA_CHECKED(index.MapLabels(rdg_dir_path));
+    return index;
+  }
+
+  katana::Result<std::string> Write(katana::Uri rdg_dir_path) {
+    paths_.clear();
+    KATANA_CHECKED(StoreLabels(rdg_dir_path, "out", out_labels_));
+    KATANA_CHECKED(StoreLabels(rdg_dir_path, "in", in_labels_));
+
+    // Write out our json manifest
+    katana::Uri manifest_path =
+        rdg_dir_path.RandFile("reachability_index_manifest");
+    KATANA_CHECKED(WriteManifest(manifest_path.string()));
+    return manifest_path.BaseName();
+  }
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  void set_num_nodes(uint64_t num) { num_nodes_ = num; }
+
+  const Labels& out_labels() const { return out_labels_; }
+  void set_out_labels(Labels labels) { out_labels_ = std::move(labels); }
+
+  const Labels& in_labels() const { return in_labels_; }
+  void set_in_labels(Labels labels) { in_labels_ = std::move(labels); }
+
+  friend void to_json(
+      nlohmann::json& j, const ReachabilityIndexPrimitive& index);
+  friend void from_json(
+      const nlohmann::json& j, ReachabilityIndexPrimitive& index);
+
+private:
+  uint64_t num_nodes_{0};
+  /// Set by the manifest, for the labels to be mapped
+  uint64_t num_out_entries_{0};
+  uint64_t num_in_entries_{0};
+
+  /// data structures dumped to their own files
+
+  Labels out_labels_;
+  Labels in_labels_;
+
+  katana::Result<void> StoreLabels(
+      const katana::Uri& rdg_dir_path, const std::string& direction,
+      const Labels& labels) {
+    auto store = [&](const std::string& name,
+                     const auto& array) -> katana::Result<void> {
+      katana::Uri path =
+          rdg_dir_path.RandFile("reachability_index_" + direction + "_" + name);
+      KATANA_CHECKED(array.Store(path));
+      paths_.emplace(direction + "_" + name, path.BaseName());
+      return katana::ResultSuccess();
+    };
+    KATANA_CHECKED(store("offsets", labels.offsets));
+    KATANA_CHECKED(store("hubs", labels.hubs));
+    KATANA_CHECKED(store("distances", labels.distances));
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> MapLabels(const katana::Uri& rdg_dir_path) {
+    auto map = [&](const std::string& name, auto* array,
+                   uint64_t size) -> katana::Result<void> {
+      auto it = paths_.find(name);
+      if (it == paths_.end()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "reachability index manifest has no {} file", name);
+      }
+      return array->Map(rdg_dir_path.Join(it->second), size);
+    };
+    KATANA_CHECKED(map("out_offsets", &out_labels_.offsets, num_nodes_ + 1));
+    KATANA_CHECKED(map("out_hubs", &out_labels_.hubs, num_out_entries_));
+    KATANA_CHECKED(
+        map("out_distances", &out_labels_.distances, num_out_entries_));
+    KATANA_CHECKED(map("in_offsets", &in_labels_.offsets, num_nodes_ + 1));
+    KATANA_CHECKED(map("in_hubs", &in_labels_.hubs, num_in_entries_));
+    KATANA_CHECKED(
+        map("in_distances", &in_labels_.distances, num_in_entries_));
+    return katana::ResultSuccess();
+  }
+
+  static katana::Result<ReachabilityIndexPrimitive> LoadJson(
+      const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(path, true));
+
+    if (fv.size() == 0) {
+      return ReachabilityIndexPrimitive();
+    }
+
+    ReachabilityIndexPrimitive index;
+    KATANA_CHECKED(katana::JsonParse<ReachabilityIndexPrimitive>(fv, &index));
+
+    return index;
+  }
+
+  katana::Result<void> WriteManifest(const std::string& path) const {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(serialized.size()));
+    if (auto res = ff->Write(serialized.data(), serialized.size()); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path);
+    // persist now
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::ResultSuccess();
+  }
+};
+
+}  // namespace katana
+
+#endif
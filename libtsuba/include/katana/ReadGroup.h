@@ -14,6 +14,16 @@ namespace katana {
 /// that they have all completed
 class ReadGroup {
 public:
+  /// The default for the most operations a ReadGroup leaves outstanding
+  static constexpr uint32_t kDefaultMaxOutstanding = 32;
+
+  /// Make a group that, once max_outstanding operations are outstanding,
+  /// waits for the oldest as each new one is added, so that loading many
+  /// small files issues them in batches rather than all at once; 0 for no
+  /// limit
+  explicit ReadGroup(uint32_t max_outstanding = kDefaultMaxOutstanding)
+      : max_outstanding_(max_outstanding) {}
+
   static katana::Result<std::unique_ptr<ReadGroup>> Make();
 
   /// Wait until all operations this descriptor knows about have completed
@@ -21,7 +31,8 @@ public:
 
   /// Add future to the list of futures this ReadGroup will wait for, note
   /// the file name for debugging. `on_complete` is guaranteed to be called
-  /// in FIFO order
+  /// in FIFO order, possibly before Finish if the group is at its limit of
+  /// outstanding operations
   void AddOp(
       std::future<katana::CopyableResult<void>> future, std::string file,
       const std::function<katana::CopyableResult<void>()>& on_complete);
@@ -56,6 +67,7 @@ public:
   }
 
 private:
+  uint32_t max_outstanding_;
   AsyncOpGroup async_op_group_;
 };
 
@@ -1,14 +1,22 @@
 #ifndef KATANA_LIBTSUBA_KATANA_TXNCONTEXT_H_
 #define KATANA_LIBTSUBA_KATANA_TXNCONTEXT_H_
 
+#include <functional>
+#include <mutex>
 #include <set>
+#include <string>
+#include <vector>
 
+#include "katana/Result.h"
 #include "katana/config.h"
 
 namespace katana {
 
 class KATANA_EXPORT TxnContext {
 public:
+  TxnContext() = default;
+  ~TxnContext();
+
   void InsertNodePropertyRead(std::string rdg_dir, std::string name) {
     node_properties_read_.insert(ConcatRDGProperty(rdg_dir, name));
   }
@@ -85,7 +93,49 @@ public:
 
   bool GetTopologyWrite() const { return topology_write_; }
 
+  /// Writes a deferred commit with the command lines of all the commits
+  /// deferred for its graph, oldest first
+  using DeferredCommit =
+      std::function<katana::Result<void>(const std::vector<std::string>&)>;
+
+  /// Start a group commit: until CommitBatch, commits through this context
+  /// are deferred, so that a graph changed by many operations accumulates
+  /// their property and topology changes and stores its manifest and part
+  /// header once. Commits may be deferred concurrently by several threads.
+  void BeginBatch() {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    batching_ = true;
+  }
+
+  bool batching() const {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    return batching_;
+  }
+
+  /// Defer a commit of graph, which is stored at rdg_dir, with
+  /// command_line. The first commit deferred for graph provides the commit
+  /// that CommitBatch runs; graph must outlive the batch.
+  void DeferCommit(
+      const void* graph, const std::string& rdg_dir, std::string command_line,
+      DeferredCommit commit);
+
+  /// Run the deferred commits, once per graph in the order the graphs were
+  /// first deferred, and stop batching. All of them are run even if some
+  /// fail; the error of the last that failed is returned.
+  katana::Result<void> CommitBatch();
+
+  /// Forget the deferred commits and stop batching; the graphs keep their
+  /// changes in memory
+  void AbortBatch();
+
 private:
+  struct PendingCommit {
+    const void* graph;
+    std::string rdg_dir;
+    std::vector<std::string> command_lines;
+    DeferredCommit commit;
+  };
+
   std::string ConcatRDGProperty(std::string rdg_dir, std::string prop) {
     return rdg_dir + kPropSeparator + prop;
   }
@@ -100,6 +150,10 @@ private:
   bool all_properties_write_{false};
   bool topology_read_{false};
   bool topology_write_{false};
+
+  mutable std::mutex batch_mutex_;
+  bool batching_{false};
+  std::vector<PendingCommit> pending_commits_;
 };
 
 }  // namespace katana
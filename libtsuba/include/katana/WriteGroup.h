@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBTSUBA_KATANA_WRITEGROUP_H_
 #define KATANA_LIBTSUBA_KATANA_WRITEGROUP_H_
 
+#include <functional>
 #include <future>
 #include <list>
 #include <memory>
@@ -48,7 +49,9 @@ public:
     AddOp(FileStoreAsync(file, buf, size), file);
   }
 
-  void AddToOutstanding(uint64_t size) { outstanding_size_ += size; }
+  /// Start async copy of source_uri into dest_uri, by the storage itself
+  /// when both are on the same back-end
+  void StartCopy(const std::string& source_uri, const std::string& dest_uri);
 
   /// Add future to the list of futures this descriptor will wait for, note
   /// the file name for debugging. If the operation is associated with a file
@@ -56,6 +59,24 @@ public:
   void AddOp(
       std::future<katana::CopyableResult<void>> future, std::string file,
       uint64_t accounted_size = 0);
+
+  /// Run fn asynchronously as an op of this descriptor, but only once
+  /// accounted_size more bytes fit in kMaxOutstandingSize; until then wait
+  /// for the oldest ops to finish. Unlike AddOp, the memory fn needs is
+  /// bounded before it starts using it, e.g., to encode a file.
+  void StartOp(
+      std::function<katana::CopyableResult<void>()> fn, std::string file,
+      uint64_t accounted_size);
+
+private:
+  /// Wait until accounted_size more bytes fit in kMaxOutstandingSize and
+  /// count them as outstanding; returns the bytes counted, which are at most
+  /// kMaxOutstandingSize
+  uint64_t ReserveOutstanding(uint64_t accounted_size);
+
+  void AddReservedOp(
+      std::future<katana::CopyableResult<void>> future, std::string file,
+      uint64_t accounted_size);
 };
 
 }  // namespace katana
@@ -69,6 +69,15 @@ KATANA_EXPORT katana::Result<void> FileRemoteCopy(
     const std::string& source_uri, const std::string& dest_uri, uint64_t begin,
     uint64_t size);
 
+/// Copy all of source_uri into dest_uri. The copy is done by the storage
+/// with FileRemoteCopy when both are on the same back-end; otherwise the
+/// file is read into memory and stored again.
+///
+/// \param source_uri source URI
+/// \param dest_uri destination URI
+KATANA_EXPORT katana::Result<void> FileCopy(
+    const std::string& source_uri, const std::string& dest_uri);
+
 /// Take whatever is in a buffer and put it in the file
 ///
 /// \param uri the destination file to fill with data
@@ -77,7 +86,9 @@ KATANA_EXPORT katana::Result<void> FileRemoteCopy(
 KATANA_EXPORT std::future<katana::CopyableResult<void>> FileStoreAsync(
     const std::string& uri, const void* data, uint64_t size);
 
-// read a part of the file into a caller defined buffer
+// read a part of the file into a caller defined buffer; large reads from
+// storage with a FileStorage::ReadPartSize are split into concurrent
+// requests of byte ranges
 KATANA_EXPORT katana::Result<void> FileGet(
     const std::string& uri, void* result_buffer, uint64_t begin, uint64_t size);
 
@@ -89,7 +100,8 @@ FileGet(const StrType& uri, T* obj) {
   return FileGet(uri, obj, 0, sizeof(T));
 }
 
-// start reading a part of the file into a caller defined buffer
+// start reading a part of the file into a caller defined buffer, split like
+// the reads of FileGet
 KATANA_EXPORT std::future<katana::CopyableResult<void>> FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin, uint64_t size);
 
@@ -22,12 +22,22 @@ namespace {
 katana::Result<std::shared_ptr<arrow::Table>>
 DoLoadProperties(
     const std::string& expected_name, const katana::Uri& file_path,
-    std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
+    std::optional<katana::ParquetReader::Slice> slice = std::nullopt,
+    const std::optional<std::vector<katana::ParquetReader::Slice>>&
+        matching_rows = std::nullopt) {
+  // keep the decoded chunks of numeric properties rather than copying them
+  // into one array, property views read them in place
+  katana::ParquetReader::ReadOpts opts;
+  opts.combine_chunks = false;
   std::unique_ptr<katana::ParquetReader> reader =
-      KATANA_CHECKED(katana::ParquetReader::Make());
+      KATANA_CHECKED(katana::ParquetReader::Make(opts));
 
-  std::shared_ptr<arrow::Table> out =
-      KATANA_CHECKED(reader->ReadTable(file_path, slice));
+  std::shared_ptr<arrow::Table> out;
+  if (slice && matching_rows) {
+    out = KATANA_CHECKED(reader->ReadRows(file_path, *matching_rows, *slice));
+  } else {
+    out = KATANA_CHECKED(reader->ReadTable(file_path, slice));
+  }
 
   std::shared_ptr<arrow::Schema> schema = out->schema();
   if (schema->num_fields() != 1) {
@@ -60,11 +70,13 @@ katana::LoadProperties(
 katana::Result<std::shared_ptr<arrow::Table>>
 katana::LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length) {
+    int64_t offset, int64_t length,
+    const std::optional<std::vector<ParquetReader::Slice>>& matching_rows) {
   try {
     return DoLoadProperties(
         expected_name, file_path,
-        katana::ParquetReader::Slice{.offset = offset, .length = length});
+        katana::ParquetReader::Slice{.offset = offset, .length = length},
+        matching_rows);
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         katana::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
@@ -76,7 +88,8 @@ katana::AddProperties(
     const katana::Uri& uri, bool is_property,
     const std::vector<katana::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    bool share_loaded) {
   for (katana::PropStorageInfo* prop : properties) {
     if (!prop->IsAbsent()) {
       return KATANA_ERROR(
@@ -89,6 +102,16 @@ katana::AddProperties(
       KATANA_LOG_DEBUG_ASSERT(pm);
       KATANA_LOG_DEBUG_ASSERT(!uri.empty());
       const katana::Uri& cache_key = uri.Join(prop->path());
+      if (share_loaded) {
+        // the memory is already accounted for by the graph that loaded it
+        std::shared_ptr<arrow::Table> shared = pm->GetLoadedProperty(cache_key);
+        if (shared) {
+          KATANA_CHECKED_CONTEXT(
+              add_fn(shared), "adding {}", std::quoted(prop->name()));
+          prop->WasLoaded(shared->field(0)->type());
+          continue;
+        }
+      }
       std::shared_ptr<arrow::Table> props = pm->GetProperty(cache_key);
       if (props) {
         KATANA_CHECKED_CONTEXT(
@@ -126,8 +149,8 @@ katana::AddProperties(
               return KATANA_CHECKED_CONTEXT(
                   LoadProperties(prop->name(), path), "error loading {}", path);
             });
-    auto on_complete = [add_fn, is_property,
-                        prop](const std::shared_ptr<arrow::Table>& props)
+    auto on_complete = [add_fn, is_property, share_loaded, prop,
+                        path](const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
       KATANA_CHECKED_CONTEXT(
           add_fn(props), "adding {}", std::quoted(prop->name()));
@@ -136,6 +159,9 @@ katana::AddProperties(
           katana::MemorySupervisor::Get().GetPropertyManager();
       if (is_property) {
         pm->PropertyLoadedActive(props);
+        if (share_loaded) {
+          pm->PropertyLoadedShared(path, props);
+        }
       }
       return katana::CopyableResultSuccess();
     };
@@ -156,7 +182,9 @@ katana::Result<void>
 katana::AddPropertySlice(
     const katana::Uri& dir,
     const std::vector<katana::PropStorageInfo*>& properties,
-    std::pair<uint64_t, uint64_t> range, ReadGroup* grp,
+    std::pair<uint64_t, uint64_t> range,
+    const std::optional<std::vector<ParquetReader::Slice>>& matching_rows,
+    ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
         add_fn) {
   uint64_t begin = range.first;
@@ -172,11 +200,12 @@ katana::AddPropertySlice(
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
         std::async(
             std::launch::async,
-            [path, prop, begin,
-             size]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+            [path, prop, begin, size, matching_rows]()
+                -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
               std::shared_ptr<arrow::Table> load_result =
                   KATANA_CHECKED_CONTEXT(
-                      LoadPropertySlice(prop->name(), path, begin, size),
+                      LoadPropertySlice(
+                          prop->name(), path, begin, size, matching_rows),
                       "error loading {}", path);
               return load_result;
             });
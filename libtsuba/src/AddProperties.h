@@ -1,9 +1,13 @@
 #ifndef KATANA_LIBTSUBA_ADDPROPERTIES_H_
 #define KATANA_LIBTSUBA_ADDPROPERTIES_H_
 
+#include <optional>
+#include <vector>
+
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
+#include "katana/ParquetReader.h"
 #include "katana/ReadGroup.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
@@ -13,21 +17,30 @@ namespace katana {
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadProperties(
     const std::string& expected_name, const katana::Uri& file_path);
 
+/// If matching_rows is present, only the rows of the slice in those ranges are
+/// read; the others are null (see ParquetReader::ReadRows)
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length);
+    int64_t offset, int64_t length,
+    const std::optional<std::vector<ParquetReader::Slice>>& matching_rows =
+        std::nullopt);
 
-// is_property is true for properties and false for RDG metadata
+// is_property is true for properties and false for RDG metadata. If
+// share_loaded, properties whose files another graph has loaded and still
+// uses are shared with it rather than read again (see RDGLoadOptions)
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::Uri& uri, bool is_property,
     const std::vector<katana::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    bool share_loaded = false);
 
 KATANA_EXPORT katana::Result<void> AddPropertySlice(
     const katana::Uri& dir,
     const std::vector<katana::PropStorageInfo*>& properties,
-    std::pair<uint64_t, uint64_t> range, ReadGroup* grp,
+    std::pair<uint64_t, uint64_t> range,
+    const std::optional<std::vector<ParquetReader::Slice>>& matching_rows,
+    ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
         add_fn);
 
@@ -0,0 +1,221 @@
+#include "katana/ContentHash.h"
+
+#include <cstring>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/Random.h"
+
+namespace {
+
+/// The hash of every null element
+constexpr uint64_t kNullHash = UINT64_C(0x6a09e667f3bcc909);
+
+/// The hash of an element of width bytes at data
+uint64_t
+HashFixedWidth(const uint8_t* data, size_t width) {
+  if (width > sizeof(uint64_t)) {
+    return katana::ContentHash::HashBytes(data, width);
+  }
+  uint64_t value = 0;
+  std::memcpy(&value, data, width);
+  return value;
+}
+
+/// The hashes of elements [begin, end) of one Arrow chunk of a column, the
+/// chunk starting at row offset of the column
+using ChunkRowsHasher = std::function<uint64_t(
+    const arrow::Array& array, uint64_t offset, uint64_t begin, uint64_t end)>;
+
+/// A ChunkRowsHasher over arrays of ArrayType, where get(array, i) is the
+/// hash of the valid element i
+template <typename ArrayType, typename F>
+ChunkRowsHasher
+RowsHasherOf(F get) {
+  return [get](
+             const arrow::Array& array, uint64_t offset, uint64_t begin,
+             uint64_t end) {
+    const auto& typed = static_cast<const ArrayType&>(array);
+    uint64_t sum = 0;
+    for (uint64_t i = begin; i < end; ++i) {
+      uint64_t h = typed.IsValid(i) ? get(typed, i) : kNullHash;
+      sum += katana::ContentHash::MixElement(offset + i, h);
+    }
+    return sum;
+  };
+}
+
+katana::Result<ChunkRowsHasher>
+MakeChunkRowsHasher(const arrow::DataType& type) {
+  switch (type.id()) {
+  case arrow::Type::BOOL:
+    return RowsHasherOf<arrow::BooleanArray>(
+        [](const arrow::BooleanArray& a, int64_t i) -> uint64_t {
+          return a.Value(i);
+        });
+  case arrow::Type::BINARY:
+  case arrow::Type::STRING:
+    return RowsHasherOf<arrow::BinaryArray>(
+        [](const arrow::BinaryArray& a, int64_t i) {
+          auto view = a.GetView(i);
+          return katana::ContentHash::HashBytes(view.data(), view.size());
+        });
+  case arrow::Type::LARGE_BINARY:
+  case arrow::Type::LARGE_STRING:
+    return RowsHasherOf<arrow::LargeBinaryArray>(
+        [](const arrow::LargeBinaryArray& a, int64_t i) {
+          auto view = a.GetView(i);
+          return katana::ContentHash::HashBytes(view.data(), view.size());
+        });
+  case arrow::Type::DICTIONARY:
+    break;
+  default:
+    if (const auto* fixed =
+            dynamic_cast<const arrow::FixedWidthType*>(&type)) {
+      const size_t width = fixed->bit_width() / 8;
+      return RowsHasherOf<arrow::Array>(
+          [width](const arrow::Array& a, int64_t i) {
+            const uint8_t* values = a.data()->buffers[1]->data();
+            return HashFixedWidth(values + (a.offset() + i) * width, width);
+          });
+    }
+    break;
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::NotImplemented, "cannot hash columns of type {}",
+      type.ToString());
+}
+
+}  // namespace
+
+uint64_t
+katana::ContentHash::value() const {
+  uint64_t h = katana::Mix64(length ^ katana::Mix64(chunk_size));
+  for (uint64_t chunk : chunks) {
+    h = katana::Mix64(h ^ chunk);
+  }
+  return h;
+}
+
+std::vector<uint64_t>
+katana::ContentHash::DifferingChunks(const ContentHash& other) const {
+  std::vector<uint64_t> differing;
+  if (chunk_size != other.chunk_size || length != other.length) {
+    for (uint64_t i = 0; i < std::max(chunks.size(), other.chunks.size());
+         ++i) {
+      differing.emplace_back(i);
+    }
+    return differing;
+  }
+  for (uint64_t i = 0; i < chunks.size(); ++i) {
+    if (chunks[i] != other.chunks[i]) {
+      differing.emplace_back(i);
+    }
+  }
+  return differing;
+}
+
+uint64_t
+katana::ContentHash::HashBytes(const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t h = katana::Mix64(size);
+  for (; size >= sizeof(uint64_t);
+       bytes += sizeof(uint64_t), size -= sizeof(uint64_t)) {
+    uint64_t word{};
+    std::memcpy(&word, bytes, sizeof(word));
+    h = katana::Mix64(h ^ word);
+  }
+  if (size > 0) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes, size);
+    h = katana::Mix64(h ^ word);
+  }
+  return h;
+}
+
+uint64_t
+katana::ContentHash::MixElement(uint64_t index, uint64_t element_hash) {
+  return katana::Mix64(
+      katana::Mix64(element_hash) ^ (index * UINT64_C(0x9e3779b97f4a7c15)));
+}
+
+katana::ContentHash
+katana::ContentHash::Make(
+    uint64_t length,
+    const std::function<uint64_t(uint64_t, uint64_t)>& hash_range,
+    uint64_t chunk_size) {
+  KATANA_LOG_DEBUG_ASSERT(chunk_size > 0);
+  ContentHash hash;
+  hash.chunk_size = chunk_size;
+  hash.length = length;
+  hash.chunks.resize((length + chunk_size - 1) / chunk_size);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{hash.chunks.size()}),
+      [&](uint64_t i) {
+        uint64_t begin = hash.ChunkBegin(i);
+        hash.chunks[i] = hash_range(begin, begin + hash.ChunkLength(i));
+      },
+      katana::steal(), katana::no_stats());
+  return hash;
+}
+
+katana::ContentHash
+katana::ContentHash::OfFixedWidth(
+    const void* data, size_t width, uint64_t length, uint64_t chunk_size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  return Make(
+      length,
+      [&](uint64_t begin, uint64_t end) {
+        uint64_t sum = 0;
+        for (uint64_t i = begin; i < end; ++i) {
+          sum += MixElement(i, HashFixedWidth(bytes + i * width, width));
+        }
+        return sum;
+      },
+      chunk_size);
+}
+
+katana::Result<katana::ContentHash>
+katana::ContentHash::OfColumn(
+    const arrow::ChunkedArray& column, uint64_t chunk_size) {
+  ChunkRowsHasher hash_rows =
+      KATANA_CHECKED(MakeChunkRowsHasher(*column.type()));
+
+  // the first row of every Arrow chunk, and the number of rows at the end
+  std::vector<uint64_t> starts{0};
+  for (const auto& array : column.chunks()) {
+    starts.emplace_back(starts.back() + array->length());
+  }
+
+  return Make(
+      column.length(),
+      [&](uint64_t begin, uint64_t end) {
+        uint64_t sum = 0;
+        size_t c = std::upper_bound(starts.begin(), starts.end(), begin) -
+                   starts.begin() - 1;
+        for (; c < column.chunks().size() && starts[c] < end; ++c) {
+          uint64_t first = std::max(begin, starts[c]) - starts[c];
+          uint64_t last = std::min(end, starts[c + 1]) - starts[c];
+          sum += hash_rows(*column.chunk(c), starts[c], first, last);
+        }
+        return sum;
+      },
+      chunk_size);
+}
+
+void
+katana::to_json(nlohmann::json& j, const katana::ContentHash& hash) {
+  j = nlohmann::json{
+      {"chunk_size", hash.chunk_size},
+      {"length", hash.length},
+      {"chunks", hash.chunks},
+  };
+}
+
+void
+katana::from_json(const nlohmann::json& j, katana::ContentHash& hash) {
+  j.at("chunk_size").get_to(hash.chunk_size);
+  j.at("length").get_to(hash.length);
+  j.at("chunks").get_to(hash.chunks);
+}
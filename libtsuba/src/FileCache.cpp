@@ -0,0 +1,419 @@
+#include "FileCache.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr std::string_view kTempPrefix = "tmp-";
+// temporary files older than this were left by processes that died
+constexpr std::time_t kStaleTempAge = 60 * 60;
+
+/// FNV-1a, which unlike std::hash is the same in every build, so that
+/// processes agree on the names of blocks
+uint64_t
+HashKey(const std::string& key) {
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+  for (char c : key) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= UINT64_C(0x100000001b3);
+  }
+  return hash;
+}
+
+/// The key of a block says which bytes it holds; its hash names the block
+std::string
+BlockKey(const std::string& uri, uint64_t file_size, uint64_t block) {
+  return fmt::format("{}\n{}\n{}", uri, file_size, block);
+}
+
+std::string
+BlockName(const std::string& key) {
+  return fmt::format("{:016x}", HashKey(key));
+}
+
+katana::Result<void>
+PReadAll(int fd, uint8_t* buf, uint64_t size, uint64_t offset) {
+  while (size > 0) {
+    ssize_t res = pread(fd, buf, size, offset);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res < 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "reading cached block: {}", strerror(errno));
+    }
+    if (res == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "cached block is truncated");
+    }
+    buf += res;
+    size -= res;
+    offset += res;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+WriteAll(int fd, const uint8_t* data, uint64_t size) {
+  while (size > 0) {
+    ssize_t res = write(fd, data, size);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res < 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "writing cached block: {}", strerror(errno));
+    }
+    data += res;
+    size -= res;
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::FileCache::Options
+katana::FileCache::Options::FromEnv() {
+  Options opts;
+  GetEnv("KATANA_FILE_CACHE_DIR", &opts.dir);
+  if (int size_mb = 0;
+      GetEnv("KATANA_FILE_CACHE_SIZE_MB", &size_mb) && size_mb > 0) {
+    opts.capacity = static_cast<uint64_t>(size_mb) << 20;
+  }
+  return opts;
+}
+
+katana::FileCache::FileCache(const Options& opts) : opts_(opts) {}
+
+katana::FileCache::~FileCache() = default;
+
+katana::Result<std::unique_ptr<katana::FileCache>>
+katana::FileCache::Make(const Options& opts) {
+  if (opts.dir.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "file cache directory is empty");
+  }
+  if (opts.capacity == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "file cache capacity must be positive");
+  }
+
+  // new to access non-public constructor
+  std::unique_ptr<FileCache> cache(new FileCache(opts));
+  KATANA_CHECKED_CONTEXT(cache->Load(), "loading file cache {}", opts.dir);
+  return std::unique_ptr<FileCache>(std::move(cache));
+}
+
+katana::Result<void>
+katana::FileCache::Load() {
+  boost::system::error_code err;
+  fs::create_directories(opts_.dir, err);
+  if (err) {
+    return KATANA_ERROR(
+        std::error_code(err.value(), err.category()),
+        "creating cache directory: {}", err.message());
+  }
+
+  // blocks left by earlier processes, most recently used first
+  std::vector<std::tuple<std::time_t, std::string, uint64_t>> blocks;
+  for (fs::directory_iterator it(opts_.dir, err), end; !err && it != end;
+       it.increment(err)) {
+    if (!fs::is_regular_file(it->path())) {
+      continue;
+    }
+    std::string name = it->path().filename().string();
+    boost::system::error_code stat_err;
+    uint64_t size = fs::file_size(it->path(), stat_err);
+    std::time_t mtime = fs::last_write_time(it->path(), stat_err);
+    if (stat_err) {
+      continue;
+    }
+    if (name.rfind(kTempPrefix, 0) == 0) {
+      // recent temporary files may be blocks another process is writing
+      if (std::time(nullptr) - mtime > kStaleTempAge) {
+        fs::remove(it->path(), stat_err);
+      }
+      continue;
+    }
+    blocks.emplace_back(mtime, std::move(name), size);
+  }
+  if (err) {
+    return KATANA_ERROR(
+        std::error_code(err.value(), err.category()),
+        "listing cache directory: {}", err.message());
+  }
+  std::sort(blocks.begin(), blocks.end(), [](const auto& a, const auto& b) {
+    return std::get<0>(a) > std::get<0>(b);
+  });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [mtime, name, size] : blocks) {
+    lru_.emplace_back(name);
+    entries_.emplace(std::move(name), Entry{size, std::prev(lru_.end())});
+    total_size_ += size;
+  }
+  EvictLocked();
+  return katana::ResultSuccess();
+}
+
+uint64_t
+katana::FileCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_size_;
+}
+
+std::string
+katana::FileCache::Path(const std::string& name) const {
+  return (fs::path(opts_.dir) / name).string();
+}
+
+katana::Result<uint64_t>
+katana::FileCache::FileSize(FileStorage* storage, const std::string& uri) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = file_sizes_.find(uri); it != file_sizes_.end()) {
+      return it->second;
+    }
+  }
+
+  StatBuf stat_buf;
+  KATANA_CHECKED(storage->Stat(uri, &stat_buf));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  file_sizes_[uri] = stat_buf.size;
+  return stat_buf.size;
+}
+
+bool
+katana::FileCache::Touch(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(name);
+  if (it == entries_.end()) {
+    return false;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  return true;
+}
+
+bool
+katana::FileCache::ReadCached(
+    const std::string& key, const std::string& name, uint64_t offset,
+    uint64_t size, uint8_t* result_buf) {
+  if (!Touch(name)) {
+    return false;
+  }
+
+  int fd = open(Path(name).c_str(), O_RDONLY);
+  if (fd < 0) {
+    // another process evicted it
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = entries_.find(name); it != entries_.end()) {
+      total_size_ -= it->second.size;
+      lru_.erase(it->second.lru_pos);
+      entries_.erase(it);
+    }
+    return false;
+  }
+
+  // a block starts with its key, which tells blocks with the same name apart
+  std::vector<uint8_t> header(key.size() + 1);
+  bool found = PReadAll(fd, header.data(), header.size(), 0) &&
+               std::memcmp(header.data(), key.c_str(), header.size()) == 0 &&
+               PReadAll(fd, result_buf, size, header.size() + offset);
+  if (found) {
+    // so that the next process using the cache orders blocks by use too
+    futimens(fd, nullptr);
+  }
+  close(fd);
+  return found;
+}
+
+katana::Result<void>
+katana::FileCache::Insert(
+    const std::string& key, const std::string& name, const uint8_t* data,
+    uint64_t size) {
+  std::string temp_path = Path(fmt::format(
+      "{}{}-{}-{}", kTempPrefix, name, getpid(), temp_counter_++));
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "creating cached block: {}", strerror(errno));
+  }
+
+  auto written = WriteAll(
+      fd, reinterpret_cast<const uint8_t*>(key.c_str()), key.size() + 1);
+  if (written) {
+    written = WriteAll(fd, data, size);
+  }
+  close(fd);
+  if (!written) {
+    unlink(temp_path.c_str());
+    return written.error();
+  }
+  if (rename(temp_path.c_str(), Path(name).c_str()) != 0) {
+    unlink(temp_path.c_str());
+    return KATANA_ERROR(
+        katana::ResultErrno(), "adding cached block: {}", strerror(errno));
+  }
+
+  uint64_t block_size = key.size() + 1 + size;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = entries_.find(name); it != entries_.end()) {
+    total_size_ -= it->second.size;
+    it->second.size = block_size;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  } else {
+    lru_.emplace_front(name);
+    entries_.emplace(name, Entry{block_size, lru_.begin()});
+  }
+  total_size_ += block_size;
+  EvictLocked();
+  return katana::ResultSuccess();
+}
+
+void
+katana::FileCache::EvictLocked() {
+  while (total_size_ > opts_.capacity && !lru_.empty()) {
+    auto it = entries_.find(lru_.back());
+    unlink(Path(it->first).c_str());
+    total_size_ -= it->second.size;
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+}
+
+katana::Result<void>
+katana::FileCache::Get(
+    FileStorage* storage, const std::string& uri, uint64_t start,
+    uint64_t size, uint8_t* result_buf) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+
+  uint64_t file_size = KATANA_CHECKED(FileSize(storage, uri));
+  if (start + size > RoundUpToBlock(file_size) + katana::kBlockSize) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "read of [{}, {}) is past the end of {} ({} bytes)", start,
+        start + size, uri, file_size);
+  }
+  uint64_t end = std::min(start + size, file_size);
+  if (start >= end) {
+    return katana::ResultSuccess();
+  }
+
+  struct Missing {
+    std::string key;
+    std::string name;
+    uint64_t begin;
+    std::vector<uint8_t> data;
+    std::future<katana::CopyableResult<void>> read;
+  };
+  std::vector<Missing> missing;
+
+  for (uint64_t block = start / kBlockSize; block * kBlockSize < end;
+       ++block) {
+    uint64_t block_begin = block * kBlockSize;
+    uint64_t block_end = std::min(file_size, block_begin + kBlockSize);
+    uint64_t lo = std::max(start, block_begin);
+    uint64_t hi = std::min(end, block_end);
+
+    std::string key = BlockKey(uri, file_size, block);
+    std::string name = BlockName(key);
+    if (ReadCached(
+            key, name, lo - block_begin, hi - lo, result_buf + (lo - start))) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    Missing& m = missing.emplace_back(Missing{
+        std::move(key), std::move(name), block_begin,
+        std::vector<uint8_t>(block_end - block_begin), {}});
+    m.read = storage->GetAsync(uri, block_begin, m.data.size(), m.data.data());
+  }
+  if (missing.empty()) {
+    return katana::ResultSuccess();
+  }
+  misses_.fetch_add(missing.size(), std::memory_order_relaxed);
+
+  // wait for every read before returning, they write into missing
+  std::vector<katana::CopyableResult<void>> reads;
+  for (Missing& m : missing) {
+    reads.emplace_back(m.read.get());
+  }
+  for (size_t i = 0; i < missing.size(); ++i) {
+    if (!reads[i]) {
+      return katana::ErrorInfo(reads[i].error())
+          .WithContext("reading {} at {}", uri, missing[i].begin);
+    }
+  }
+
+  for (Missing& m : missing) {
+    uint64_t lo = std::max(start, m.begin);
+    uint64_t hi = std::min(end, m.begin + m.data.size());
+    std::memcpy(
+        result_buf + (lo - start), m.data.data() + (lo - m.begin), hi - lo);
+
+    // the read succeeded even if caching the block did not
+    if (auto res = Insert(m.key, m.name, m.data.data(), m.data.size()); !res) {
+      KATANA_LOG_WARN("caching block of {}: {}", uri, res.error());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::FileCache::GetAsync(
+    FileStorage* storage, const std::string& uri, uint64_t start,
+    uint64_t size, uint8_t* result_buf) {
+  return std::async(
+      std::launch::async,
+      [this, storage, uri, start, size,
+       result_buf]() -> katana::CopyableResult<void> {
+        if (auto res = Get(storage, uri, start, size, result_buf); !res) {
+          return res.error();
+        }
+        return katana::CopyableResultSuccess();
+      });
+}
+
+void
+katana::FileCache::Forget(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto size_it = file_sizes_.find(uri);
+  if (size_it == file_sizes_.end()) {
+    return;
+  }
+  uint64_t file_size = size_it->second;
+  file_sizes_.erase(size_it);
+
+  for (uint64_t block = 0; block * kBlockSize < file_size; ++block) {
+    std::string name = BlockName(BlockKey(uri, file_size, block));
+    if (auto it = entries_.find(name); it != entries_.end()) {
+      unlink(Path(name).c_str());
+      total_size_ -= it->second.size;
+      lru_.erase(it->second.lru_pos);
+      entries_.erase(it);
+    }
+  }
+}
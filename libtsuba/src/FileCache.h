@@ -0,0 +1,133 @@
+#ifndef KATANA_LIBTSUBA_FILECACHE_H_
+#define KATANA_LIBTSUBA_FILECACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "katana/FileStorage.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A read-through cache, on local disk, of files in remote storage, used by
+/// FileGet and FileGetAsync, and so by FileView and ParquetReader.
+///
+/// Files are cached in blocks of kBlockSize bytes. Each block is a file in the
+/// cache directory named by a hash of the URI of the file it comes from, that
+/// file's size and the block's index, so a cache directory is shared by the
+/// processes using it and survives restarts. Blocks are written to a
+/// temporary file and renamed into place, so no process sees part of a block.
+/// Once the cache holds more than its capacity, the least recently used
+/// blocks are removed.
+///
+/// Cached files are assumed not to be rewritten with the same size. RDGs
+/// satisfy this: a file name is never reused for different contents, and a
+/// new RDG version refers to new files. Writes and deletes through this
+/// process drop the blocks of the files they touch.
+class KATANA_EXPORT FileCache {
+public:
+  static constexpr uint64_t kBlockSize = UINT64_C(4) << 20;  // 4M
+
+  struct Options {
+    /// Directory holding the cached blocks, created if needed
+    std::string dir;
+    /// Bytes of blocks kept in dir
+    uint64_t capacity{UINT64_C(10) << 30};  // 10G
+
+    /// The defaults, overridden by the environment variables
+    /// KATANA_FILE_CACHE_DIR and KATANA_FILE_CACHE_SIZE_MB. Caching is off
+    /// when dir is empty.
+    static Options FromEnv();
+  };
+
+  /// Make a cache of the blocks in opts.dir, taking over the blocks a
+  /// previous cache left there
+  static katana::Result<std::unique_ptr<FileCache>> Make(const Options& opts);
+
+  FileCache(const FileCache&) = delete;
+  FileCache& operator=(const FileCache&) = delete;
+  FileCache(FileCache&&) = delete;
+  FileCache& operator=(FileCache&&) = delete;
+
+  ~FileCache();
+
+  /// Read [start, start + size) of the file at uri into result_buf, reading
+  /// the blocks that are not cached from storage. As with LocalStorage, reads
+  /// that end less than a block past the end of the file succeed.
+  katana::Result<void> Get(
+      FileStorage* storage, const std::string& uri, uint64_t start,
+      uint64_t size, uint8_t* result_buf);
+
+  /// Like Get but returns at once; result_buf must stay valid until the
+  /// future is ready
+  std::future<katana::CopyableResult<void>> GetAsync(
+      FileStorage* storage, const std::string& uri, uint64_t start,
+      uint64_t size, uint8_t* result_buf);
+
+  /// Drop what is cached of the file at uri, e.g., because it was written
+  void Forget(const std::string& uri);
+
+  uint64_t capacity() const { return opts_.capacity; }
+  /// Bytes of blocks in the cache
+  uint64_t size() const;
+  /// Blocks read from the cache and from storage
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+  using LRUList = std::list<std::string>;
+
+  struct Entry {
+    uint64_t size{0};
+    LRUList::iterator lru_pos;
+  };
+
+  FileCache(const Options& opts);
+
+  katana::Result<void> Load();
+
+  katana::Result<uint64_t> FileSize(
+      FileStorage* storage, const std::string& uri);
+
+  /// Copy [offset, offset + size) of the block with key and name to
+  /// result_buf, returning false if the block is not cached
+  bool ReadCached(
+      const std::string& key, const std::string& name, uint64_t offset,
+      uint64_t size, uint8_t* result_buf);
+
+  katana::Result<void> Insert(
+      const std::string& key, const std::string& name, const uint8_t* data,
+      uint64_t size);
+
+  /// Record that name was used, returning false if it is not in the cache
+  bool Touch(const std::string& name);
+
+  /// Remove least recently used blocks; requires mutex_
+  void EvictLocked();
+
+  std::string Path(const std::string& name) const;
+
+  Options opts_;
+
+  mutable std::mutex mutex_;
+  // most recently used first
+  LRUList lru_;
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t total_size_{0};
+  std::unordered_map<std::string, uint64_t> file_sizes_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> temp_counter_{0};
+};
+
+}  // namespace katana
+
+#endif
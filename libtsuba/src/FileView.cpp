@@ -1,15 +1,21 @@
 #include "katana/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <iomanip>
 #include <string>
 
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
 #include "katana/file.h"
 
 /*
@@ -30,6 +36,24 @@
  * somehow and also tell users to not modify our files?
  */
 
+namespace {
+
+int
+MadviseFlag(katana::FileView::MapAdvice advice) {
+  switch (advice) {
+  case katana::FileView::MapAdvice::kSequential:
+    return MADV_SEQUENTIAL;
+  case katana::FileView::MapAdvice::kRandom:
+    return MADV_RANDOM;
+  case katana::FileView::MapAdvice::kWillNeed:
+    return MADV_WILLNEED;
+  default:
+    return MADV_NORMAL;
+  }
+}
+
+}  // namespace
+
 katana::FileView::~FileView() {
   if (auto res = Unbind(); !res) {
     KATANA_LOG_ERROR("Unbind: {}", res.error());
@@ -56,8 +80,12 @@ katana::FileView::Unbind() {
     filename_ = "";
     filling_ = std::vector<uint64_t>();
     KATANA_LOG_DEBUG_ASSERT(fetches_->empty());
+    read_ahead_pages_ = 0;
+    last_read_start_ = 0;
+    last_read_end_ = 0;
 
     bound_ = false;
+    mapped_in_place_ = false;
   }
   return katana::ResultSuccess();
 }
@@ -113,6 +141,63 @@ katana::FileView::Bind(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileView::MapReadOnly(std::string_view filename, MapAdvice advice) {
+  katana::Uri uri = KATANA_CHECKED(katana::Uri::Make(std::string(filename)));
+  if (uri.scheme() != katana::Uri::kFileScheme) {
+    return Bind(filename, true);
+  }
+
+  int fd = open(uri.path().c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "opening {}", std::quoted(uri.path()));
+  }
+  struct stat s_buf;
+  if (fstat(fd, &s_buf) != 0) {
+    auto err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "stat {}", std::quoted(uri.path()));
+  }
+  int64_t size = s_buf.st_size;
+
+  void* tmp = nullptr;
+  if (size > 0) {
+    // A shared mapping of the file itself: its pages are the page cache's
+    tmp = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  // The mapping keeps its own reference to the file
+  close(fd);
+  if (tmp == MAP_FAILED) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "mapping {} of size {}", std::quoted(uri.path()),
+        size);
+  }
+  if (size > 0 && advice != MapAdvice::kNormal &&
+      madvise(tmp, size, MadviseFlag(advice)) != 0) {
+    // Only a hint, the mapping is still good
+    KATANA_LOG_WARN(
+        "madvise on {}: {}", std::quoted(uri.path()), std::strerror(errno));
+  }
+
+  KATANA_CHECKED(Unbind());
+
+  page_shift_ = 20; /* 1M */
+  filename_ = filename;
+  map_start_ = static_cast<uint8_t*>(tmp);
+  mem_start_ = 0;
+  file_size_ = size;
+  // Every page is present, so Fill and Read never fetch anything
+  filling_.clear();
+  filling_.resize(page_number(size) / 64 + 1, ~UINT64_C(0));
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+
+  cursor_ = 0;
+  bound_ = true;
+  mapped_in_place_ = true;
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   uint64_t in_end = std::min<uint64_t>(end, file_size_);
@@ -166,6 +251,44 @@ katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileView::Discard(uint64_t begin, uint64_t end) {
+  if (!bound_ || mapped_in_place_) {
+    return katana::ResultSuccess();
+  }
+  uint64_t in_end = std::min<uint64_t>(end, file_size_);
+  uint64_t page_size = UINT64_C(1) << page_shift_;
+  uint64_t first_page = page_number(begin + page_size - 1);
+  // the last page of a file may be short, but it is still whole
+  uint64_t last_page = in_end == static_cast<uint64_t>(file_size_)
+                           ? page_number(in_end + page_size - 1)
+                           : page_number(in_end);
+  if (first_page >= last_page) {
+    return katana::ResultSuccess();
+  }
+
+  uint64_t off = first_page << page_shift_;
+  uint64_t size =
+      std::min<uint64_t>(last_page << page_shift_, file_size_) - off;
+  // outstanding fetches may be writing to these pages
+  KATANA_CHECKED(Resolve(off, size));
+
+  if (madvise(map_start_ + off, size, MADV_DONTNEED) == -1) {
+    return KATANA_ERROR(katana::ResultErrno(), "discarding buffer");
+  }
+  if (mprotect(map_start_ + off, size, PROT_NONE) == -1) {
+    return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
+  }
+  for (uint64_t page = first_page; page < last_page; ++page) {
+    filling_[page / 64] &= ~(UINT64_C(1) << (63 - page % 64));
+  }
+  if (mem_start_ >= static_cast<int64_t>(off) &&
+      mem_start_ < static_cast<int64_t>(off + size)) {
+    mem_start_ = -1;
+  }
+  return katana::ResultSuccess();
+}
+
 bool
 katana::FileView::Equals(const FileView& other) const {
   if (!bound_ || !other.bound_) {
@@ -236,6 +359,7 @@ katana::FileView::Read(int64_t nbytes) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
+  CountRead(cursor_, nbytes_internal);
   // fetch data from storage if necessary
   if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
     return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
@@ -271,6 +395,7 @@ katana::FileView::Read(int64_t nbytes, void* out) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
+  CountRead(cursor_, nbytes_internal);
   // fetch data from storage if necessary
   if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
     return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
@@ -297,6 +422,35 @@ katana::FileView::GetSize() {
   return size();
 }
 
+arrow::Result<int64_t>
+katana::FileView::ReadAt(int64_t position, int64_t nbytes, void* out) {
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  ARROW_RETURN_NOT_OK(Seek(position));
+  return Read(nbytes, out);
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+katana::FileView::ReadAt(int64_t position, int64_t nbytes) {
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  ARROW_RETURN_NOT_OK(Seek(position));
+  return Read(nbytes);
+}
+
+arrow::Future<std::shared_ptr<arrow::Buffer>>
+katana::FileView::ReadAsync(
+    const arrow::io::IOContext& ctx, int64_t position, int64_t nbytes) {
+  if (position >= 0 && nbytes > 0) {
+    std::lock_guard<std::mutex> lock(read_mutex_);
+    if (auto res = Fill(position, position + nbytes, false); !res) {
+      return arrow::Future<std::shared_ptr<arrow::Buffer>>::MakeFinished(
+          arrow::Status(arrow::StatusCode::IOError, "FileView::Fill"));
+    }
+  }
+  // The default implementation runs ReadAt on the context's executor, which
+  // waits for the fetch started above
+  return arrow::io::RandomAccessFile::ReadAsync(ctx, position, nbytes);
+}
+
 ///// End arrow::io::RandomAccessFile method definitions /////////
 
 uint64_t
@@ -482,15 +636,45 @@ katana::FileView::Resolve(int64_t start, int64_t size) {
 
 katana::Result<void>
 katana::FileView::PreFetch(int64_t start, int64_t size) {
-  // Our highly sophisticated prefetching algorithm is to crudely approximate
-  // the size of the last read plus 10%. This is largely motivated by parquet
-  // files, which consecutively read row groups that are (in theory)
-  // approximately the same size.
-  int64_t fetch_size = (size / 10) * 11;
+  // Reads that begin in the page where the previous one ended are taken to be
+  // part of a sequential scan, such as a walk through a topology or the row
+  // groups of a parquet file, and fetch an exponentially growing window of
+  // pages ahead of them, much like the kernel's read-ahead. Other reads fall
+  // back to crudely approximating the size of the last read plus 10%, which
+  // suits parquet files whose row groups are (in theory) approximately the
+  // same size.
+  int64_t end = start + size;
+  bool sequential = start >= last_read_start_ &&
+                    page_number(start) <= page_number(last_read_end_);
+  if (sequential && read_ahead_max_pages_ > 0) {
+    read_ahead_pages_ = std::min(
+        std::max<uint64_t>(read_ahead_pages_ * 2, 1), read_ahead_max_pages_);
+  } else {
+    read_ahead_pages_ = 0;
+  }
+  last_read_start_ = start;
+  last_read_end_ = end;
+
+  int64_t fetch_size = std::max(
+      (size / 10) * 11, static_cast<int64_t>(read_ahead_pages_ << page_shift_));
   // Make sure we haven't overflown
   KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
-  uint64_t begin = static_cast<uint64_t>(start + size);
-  uint64_t end = static_cast<uint64_t>(start + size + fetch_size);
-  KATANA_CHECKED(Fill(begin, end, false));
+  uint64_t begin = static_cast<uint64_t>(end);
+  uint64_t fetch_end = static_cast<uint64_t>(end + fetch_size);
+  KATANA_CHECKED(Fill(begin, fetch_end, false));
   return katana::ResultSuccess();
 }
+
+void
+katana::FileView::CountRead(int64_t start, int64_t size) {
+  if (size <= 0) {
+    return;
+  }
+  uint64_t first_page = page_number(start);
+  uint64_t last_page = page_number(std::min(start + size, file_size_));
+  if (MustFill(&filling_[0], first_page, last_page).has_value()) {
+    ++read_misses_;
+  } else {
+    ++read_hits_;
+  }
+}
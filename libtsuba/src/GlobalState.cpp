@@ -32,6 +32,14 @@ katana::GlobalState::FS(std::string_view uri) const {
   return GetDefaultFS();
 }
 
+katana::FileCache*
+katana::GlobalState::Cache(const FileStorage* fs) const {
+  if (fs == &local_storage_) {
+    return nullptr;
+  }
+  return file_cache_.get();
+}
+
 katana::Result<void>
 katana::GlobalState::Init(katana::CommBackend* comm) {
   KATANA_LOG_DEBUG_ASSERT(ref_ == nullptr);
@@ -56,12 +64,19 @@ katana::GlobalState::Init(katana::CommBackend* comm) {
         fs->Init(), "initializing backend ({})", fs->uri_scheme());
   }
 
+  if (FileCache::Options opts = FileCache::Options::FromEnv();
+      !opts.dir.empty()) {
+    global_state->file_cache_ = KATANA_CHECKED_CONTEXT(
+        FileCache::Make(opts), "initializing file cache");
+  }
+
   ref_ = std::move(global_state);
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 katana::GlobalState::Fini() {
+  ref_->file_cache_.reset();
   for (FileStorage* fs : ref_->file_stores_) {
     KATANA_CHECKED_CONTEXT(
         fs->Fini(), "file storage shutdown ({})", fs->uri_scheme());
@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+#include "FileCache.h"
 #include "LocalStorage.h"
 #include "katana/CommBackend.h"
 #include "katana/FileStorage.h"
@@ -19,6 +20,7 @@ class GlobalState {
   katana::CommBackend* comm_;
 
   katana::LocalStorage local_storage_;
+  std::unique_ptr<FileCache> file_cache_;
 
   GlobalState(katana::CommBackend* comm) : comm_(comm) {
     file_stores_.emplace_back(&local_storage_);
@@ -46,6 +48,11 @@ public:
   /// {no scheme} -> LocalStore
   FileStorage* FS(std::string_view uri) const;
 
+  /// The cache for files in fs, or nullptr if they are not cached. Files in
+  /// remote storage are cached when KATANA_FILE_CACHE_DIR is set, see
+  /// FileCache::Options::FromEnv.
+  FileCache* Cache(const FileStorage* fs) const;
+
   static katana::Result<void> Init(katana::CommBackend* comm);
   static katana::Result<void> Fini();
   static const GlobalState& Get();
@@ -0,0 +1,575 @@
+#include "LocalAsyncIO.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <optional>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+#include "katana/file.h"
+
+// IORING_FEAT_RW_CUR_POS came with the kernel (5.6) that added IORING_OP_READ
+// and IORING_OP_WRITE, which are all this uses
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) &&            \
+    defined(IORING_FEAT_RW_CUR_POS)
+#define KATANA_LOCAL_IO_URING_AVAILABLE 1
+#endif
+
+namespace {
+
+uint64_t
+AlignUp(uint64_t value) {
+  return (value + katana::LocalAsyncIO::kDirectIOAlignment - 1) &
+         ~(katana::LocalAsyncIO::kDirectIOAlignment - 1);
+}
+
+uint64_t
+AlignDown(uint64_t value) {
+  return value & ~(katana::LocalAsyncIO::kDirectIOAlignment - 1);
+}
+
+std::future<katana::CopyableResult<void>>
+ReadyFuture(katana::CopyableResult<void> res) {
+  std::promise<katana::CopyableResult<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
+}  // namespace
+
+struct katana::LocalAsyncIO::Request {
+  std::string path;
+  /// Descriptor for chunks without alignment requirements
+  int fd{-1};
+  /// O_DIRECT descriptor for the aligned part of large reads, if any
+  int direct_fd{-1};
+
+  std::atomic<size_t> outstanding{0};
+  /// Bytes not read because the file ended first
+  std::atomic<uint64_t> missing{0};
+
+  std::mutex mutex;
+  std::optional<katana::CopyableErrorInfo> error;
+
+  std::promise<katana::CopyableResult<void>> promise;
+
+  /// Bytes to transfer, and the span that traces the transfer
+  uint64_t size{0};
+  std::optional<katana::OperationSpan> span;
+
+  void Fail(katana::CopyableErrorInfo err) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) {
+      error = std::move(err);
+    }
+  }
+
+  void CloseFDs() {
+    for (int* fd_ptr : {&fd, &direct_fd}) {
+      if (*fd_ptr >= 0) {
+        close(*fd_ptr);
+        *fd_ptr = -1;
+      }
+    }
+  }
+};
+
+#ifdef KATANA_LOCAL_IO_URING_AVAILABLE
+
+/// A minimal io_uring, set up with the raw system calls so that there is no
+/// dependency on liburing. Only the thread running RingLoop touches it.
+class katana::LocalAsyncIO::Ring {
+public:
+  static katana::Result<std::unique_ptr<Ring>> Make(uint32_t entries) {
+    io_uring_params params{};
+    int fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "io_uring_setup");
+    }
+    std::unique_ptr<Ring> ring(new Ring(fd));
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+      return KATANA_ERROR(
+          ErrorCode::NotImplemented, "io_uring does not support read/write");
+    }
+
+    ring->sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      ring->sq_size_ = ring->cq_size_ =
+          std::max(ring->sq_size_, ring->cq_size_);
+    }
+
+    ring->sq_ptr_ = KATANA_CHECKED_CONTEXT(
+        ring->MapRing(ring->sq_size_, IORING_OFF_SQ_RING), "mapping sq ring");
+    if (single_mmap) {
+      ring->cq_ptr_ = ring->sq_ptr_;
+    } else {
+      ring->cq_ptr_ = KATANA_CHECKED_CONTEXT(
+          ring->MapRing(ring->cq_size_, IORING_OFF_CQ_RING),
+          "mapping cq ring");
+    }
+    ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes_ = static_cast<io_uring_sqe*>(KATANA_CHECKED_CONTEXT(
+        ring->MapRing(ring->sqes_size_, IORING_OFF_SQES), "mapping sqes"));
+
+    auto* sq = static_cast<uint8_t*>(ring->sq_ptr_);
+    ring->sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    auto* cq = static_cast<uint8_t*>(ring->cq_ptr_);
+    ring->cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    ring->entries_ = params.sq_entries;
+    return katana::MakeResult(std::move(ring));
+  }
+
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+
+  ~Ring() {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != nullptr) {
+      munmap(sq_ptr_, sq_size_);
+    }
+    close(fd_);
+  }
+
+  uint32_t entries() const { return entries_; }
+
+  /// Queue chunk to be issued by the next Enter; there must be room for it,
+  /// i.e., fewer than entries() chunks in flight
+  void Prepare(const Chunk& chunk, uint64_t cookie) {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = chunk.write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = chunk.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(chunk.buf);
+    sqe->len = static_cast<uint32_t>(chunk.size);
+    sqe->off = chunk.offset;
+    sqe->user_data = cookie;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++to_submit_;
+  }
+
+  /// Submit the prepared chunks and wait for at least one completion
+  katana::Result<void> Enter() {
+    for (;;) {
+      int ret = syscall(
+          __NR_io_uring_enter, fd_, to_submit_, 1, IORING_ENTER_GETEVENTS,
+          nullptr, 0);
+      if (ret >= 0) {
+        to_submit_ -= std::min<unsigned>(ret, to_submit_);
+        return katana::ResultSuccess();
+      }
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        return KATANA_ERROR(katana::ResultErrno(), "io_uring_enter");
+      }
+    }
+  }
+
+  /// Call fn(cookie, res) for every completion available
+  template <typename Fn>
+  void Reap(const Fn& fn) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      fn(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+private:
+  Ring(int fd) : fd_(fd) {}
+
+  katana::Result<void*> MapRing(size_t size, off_t offset) {
+    void* ptr = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+        offset);
+    if (ptr == MAP_FAILED) {
+      return KATANA_ERROR(katana::ResultErrno(), "mmap");
+    }
+    return ptr;
+  }
+
+  int fd_;
+  uint32_t entries_{0};
+  unsigned to_submit_{0};
+
+  void* sq_ptr_{nullptr};
+  size_t sq_size_{0};
+  void* cq_ptr_{nullptr};
+  size_t cq_size_{0};
+  io_uring_sqe* sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  unsigned* sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned* sq_array_{nullptr};
+  unsigned* cq_head_{nullptr};
+  unsigned* cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe* cqes_{nullptr};
+};
+
+#else
+
+class katana::LocalAsyncIO::Ring {
+public:
+  static katana::Result<std::unique_ptr<Ring>> Make(uint32_t) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "built without io_uring support");
+  }
+
+  uint32_t entries() const { return 0; }
+  void Prepare(const Chunk&, uint64_t) {}
+  katana::Result<void> Enter() { return katana::ResultSuccess(); }
+  template <typename Fn>
+  void Reap(const Fn&) {}
+};
+
+#endif
+
+katana::LocalAsyncIO::Options
+katana::LocalAsyncIO::Options::FromEnv() {
+  Options opts;
+  if (int depth = 0;
+      GetEnv("KATANA_LOCAL_IO_QUEUE_DEPTH", &depth) && depth > 0) {
+    opts.queue_depth = depth;
+  }
+  if (int threads = 0;
+      GetEnv("KATANA_LOCAL_IO_THREADS", &threads) && threads > 0) {
+    opts.num_threads = threads;
+  }
+  if (int threshold_mb = 0;
+      GetEnv("KATANA_LOCAL_IO_DIRECT_THRESHOLD_MB", &threshold_mb) &&
+      threshold_mb >= 0) {
+    opts.direct_io_threshold = static_cast<uint64_t>(threshold_mb) << 20;
+  }
+  GetEnv("KATANA_LOCAL_IO_URING", &opts.use_io_uring);
+  return opts;
+}
+
+katana::LocalAsyncIO::LocalAsyncIO(const Options& opts) : opts_(opts) {}
+
+katana::Result<std::unique_ptr<katana::LocalAsyncIO>>
+katana::LocalAsyncIO::Make(const Options& opts) {
+  if (opts.queue_depth == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "queue depth must be positive");
+  }
+
+  // new to access non-public constructor
+  std::unique_ptr<LocalAsyncIO> io(new LocalAsyncIO(opts));
+  if (opts.use_io_uring) {
+    if (auto ring = Ring::Make(opts.queue_depth); ring) {
+      io->ring_ = std::move(ring.value());
+    } else {
+      KATANA_LOG_DEBUG("io_uring unavailable, using threads: {}", ring.error());
+    }
+  }
+
+  if (io->ring_) {
+    io->threads_.emplace_back(&LocalAsyncIO::RingLoop, io.get());
+  } else {
+    uint32_t num_threads =
+        std::clamp<uint32_t>(opts.num_threads, 1, opts.queue_depth);
+    for (uint32_t i = 0; i < num_threads; ++i) {
+      io->threads_.emplace_back(&LocalAsyncIO::WorkerLoop, io.get());
+    }
+  }
+  return katana::MakeResult(std::move(io));
+}
+
+katana::LocalAsyncIO::~LocalAsyncIO() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  // The loops drain pending_ before they return
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalAsyncIO::Read(
+    const std::string& path, uint64_t start, uint64_t size, uint8_t* buf) {
+  if (size == 0) {
+    return ReadyFuture(katana::CopyableResultSuccess());
+  }
+
+  auto request = std::make_shared<Request>();
+  request->path = path;
+  request->fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (request->fd < 0) {
+    return ReadyFuture(KATANA_ERROR(
+        katana::ResultErrno(), "failed to open source file {}",
+        std::quoted(path)));
+  }
+
+  uint64_t end = start + size;
+  // O_DIRECT transfers must be aligned in memory and in the file alike
+  uint64_t direct_begin = start;
+  uint64_t direct_end = start;
+  if (opts_.direct_io_threshold > 0 && size >= opts_.direct_io_threshold &&
+      (reinterpret_cast<uintptr_t>(buf) - start) % kDirectIOAlignment == 0 &&
+      AlignUp(start) < AlignDown(end)) {
+    // Not every file system supports O_DIRECT; those just skip it
+    request->direct_fd = open(path.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+    if (request->direct_fd >= 0) {
+      direct_begin = AlignUp(start);
+      direct_end = AlignDown(end);
+    }
+  }
+
+  request->size = size;
+  request->span.emplace(
+      "local read",
+      katana::Tags{
+          {"path", path},
+          {"offset", start},
+          {"direct_io", direct_end > direct_begin}});
+
+  std::vector<Chunk> chunks;
+  Split(request, request->fd, buf, start, start, direct_begin, false, &chunks);
+  Split(
+      request, request->direct_fd, buf, start, direct_begin, direct_end, false,
+      &chunks);
+  Split(request, request->fd, buf, start, direct_end, end, false, &chunks);
+
+  auto future = request->promise.get_future();
+  Submit(std::move(chunks));
+  return future;
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalAsyncIO::Write(
+    const std::string& path, const uint8_t* data, uint64_t size) {
+  auto request = std::make_shared<Request>();
+  request->path = path;
+  request->fd =
+      open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  if (request->fd < 0) {
+    return ReadyFuture(KATANA_ERROR(
+        katana::ResultErrno(), "opening file {}", std::quoted(path)));
+  }
+  if (size == 0) {
+    request->CloseFDs();
+    return ReadyFuture(katana::CopyableResultSuccess());
+  }
+
+  request->size = size;
+  request->span.emplace("local write", katana::Tags{{"path", path}});
+
+  std::vector<Chunk> chunks;
+  // Chunks only ever read from the buffers of writes
+  Split(
+      request, request->fd, const_cast<uint8_t*>(data), 0, 0, size,  // NOLINT
+      true, &chunks);
+
+  auto future = request->promise.get_future();
+  Submit(std::move(chunks));
+  return future;
+}
+
+void
+katana::LocalAsyncIO::Split(
+    const std::shared_ptr<Request>& request, int fd, uint8_t* buf,
+    uint64_t buf_offset, uint64_t begin, uint64_t end, bool write,
+    std::vector<Chunk>* chunks) {
+  for (uint64_t offset = begin; offset < end; offset += kChunkSize) {
+    chunks->emplace_back(Chunk{
+        .request = request,
+        .fd = fd,
+        .buf = buf + (offset - buf_offset),
+        .offset = offset,
+        .size = std::min(kChunkSize, end - offset),
+        .write = write,
+    });
+  }
+}
+
+void
+katana::LocalAsyncIO::Submit(std::vector<Chunk>&& chunks) {
+  chunks.front().request->outstanding = chunks.size();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Chunk& chunk : chunks) {
+      pending_.emplace_back(std::move(chunk));
+    }
+  }
+  // A single thread drives the ring; every worker could take a chunk
+  if (ring_) {
+    cv_.notify_one();
+  } else {
+    cv_.notify_all();
+  }
+}
+
+bool
+katana::LocalAsyncIO::Advance(Chunk* chunk, int64_t res) {
+  Request& request = *chunk->request;
+  if (res == -EINTR || res == -EAGAIN) {
+    return false;
+  }
+  if (res < 0) {
+    request.Fail(KATANA_ERROR(
+        std::error_code(-res, std::system_category()),
+        "{} {} bytes at offset {} of {}", chunk->write ? "writing" : "reading",
+        chunk->size, chunk->offset, std::quoted(request.path)));
+    return true;
+  }
+  if (res == 0) {
+    if (chunk->write) {
+      request.Fail(KATANA_ERROR(
+          ErrorCode::LocalStorageError, "no progress writing {}",
+          std::quoted(request.path)));
+    } else {
+      request.missing += chunk->size;
+    }
+    return true;
+  }
+
+  chunk->buf += res;
+  chunk->offset += res;
+  chunk->size -= res;
+  if (chunk->size == 0) {
+    return true;
+  }
+  // What is left of a short transfer may no longer be aligned
+  chunk->fd = request.fd;
+  return false;
+}
+
+void
+katana::LocalAsyncIO::Finish(Chunk* chunk) {
+  std::shared_ptr<Request> request = std::move(chunk->request);
+  if (request->outstanding.fetch_sub(1) != 1) {
+    return;
+  }
+
+  request->CloseFDs();
+  std::lock_guard<std::mutex> lock(request->mutex);
+  if (request->error) {
+    request->span->SetError(fmt::format("{}", *request->error));
+  }
+  request->span->Finish(request->size - request->missing);
+  if (request->error) {
+    request->promise.set_value(*request->error);
+  } else if (request->missing > kBlockSize) {
+    // As in LocalStorage::ReadFile, files that are not block aligned may come
+    // up a little short
+    request->promise.set_value(KATANA_ERROR(
+        ErrorCode::LocalStorageError, "read of {} ended {} bytes early",
+        std::quoted(request->path), request->missing.load()));
+  } else {
+    request->promise.set_value(katana::CopyableResultSuccess());
+  }
+}
+
+void
+katana::LocalAsyncIO::RingLoop() {
+  // Chunks in flight, indexed by the cookie they were submitted with
+  std::vector<Chunk> slots(ring_->entries());
+  std::vector<uint64_t> free_slots(slots.size());
+  for (uint64_t i = 0; i < free_slots.size(); ++i) {
+    free_slots[i] = free_slots.size() - 1 - i;
+  }
+  std::deque<Chunk> retries;
+  size_t in_flight = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] {
+        return stopping_ || !pending_.empty() || !retries.empty() ||
+               in_flight > 0;
+      });
+      if (stopping_ && pending_.empty() && retries.empty() && in_flight == 0) {
+        return;
+      }
+      while (!free_slots.empty() && (!retries.empty() || !pending_.empty())) {
+        std::deque<Chunk>& from = retries.empty() ? pending_ : retries;
+        uint64_t cookie = free_slots.back();
+        free_slots.pop_back();
+        slots[cookie] = std::move(from.front());
+        from.pop_front();
+        ring_->Prepare(slots[cookie], cookie);
+        ++in_flight;
+      }
+    }
+
+    if (auto res = ring_->Enter(); !res) {
+      // Chunks may already be in the kernel, writing to caller buffers, so
+      // there is no way to fail them safely
+      KATANA_LOG_FATAL("local async io: {}", res.error());
+    }
+
+    ring_->Reap([&](uint64_t cookie, int32_t res) {
+      Chunk& chunk = slots[cookie];
+      --in_flight;
+      if (Advance(&chunk, res)) {
+        Finish(&chunk);
+      } else {
+        retries.emplace_back(std::move(chunk));
+      }
+      free_slots.push_back(cookie);
+    });
+  }
+}
+
+void
+katana::LocalAsyncIO::WorkerLoop() {
+  for (;;) {
+    Chunk chunk;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return stopping_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      chunk = std::move(pending_.front());
+      pending_.pop_front();
+    }
+
+    for (;;) {
+      ssize_t res = chunk.write
+                        ? pwrite(chunk.fd, chunk.buf, chunk.size, chunk.offset)
+                        : pread(chunk.fd, chunk.buf, chunk.size, chunk.offset);
+      if (Advance(&chunk, res < 0 ? -errno : res)) {
+        break;
+      }
+    }
+    Finish(&chunk);
+  }
+}
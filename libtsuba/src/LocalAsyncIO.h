@@ -0,0 +1,118 @@
+#ifndef KATANA_LIBTSUBA_LOCALASYNCIO_H_
+#define KATANA_LIBTSUBA_LOCALASYNCIO_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Asynchronous reads and writes of local files, used by LocalStorage.
+///
+/// Requests are split into chunks of at most kChunkSize bytes, and at most
+/// queue_depth chunks are in flight at once. Chunks are issued through
+/// io_uring when the kernel supports it; otherwise a pool of threads issues
+/// them with pread and pwrite. Reads of at least direct_io_threshold bytes
+/// use O_DIRECT for their block aligned part, so that loading large files
+/// once does not churn the page cache.
+class KATANA_EXPORT LocalAsyncIO {
+public:
+  static constexpr uint64_t kChunkSize = UINT64_C(4) << 20;  // 4M
+  static constexpr uint64_t kDirectIOAlignment = UINT64_C(4) << 10;
+
+  struct Options {
+    /// Maximum number of chunks in flight
+    uint32_t queue_depth{64};
+    /// Number of threads issuing chunks when io_uring is not used
+    uint32_t num_threads{8};
+    /// Reads at least this large use direct I/O; 0 disables direct I/O
+    uint64_t direct_io_threshold{UINT64_C(64) << 20};
+    /// Use io_uring if the kernel supports it
+    bool use_io_uring{true};
+
+    /// The defaults, overridden by the environment variables
+    /// KATANA_LOCAL_IO_QUEUE_DEPTH, KATANA_LOCAL_IO_THREADS,
+    /// KATANA_LOCAL_IO_DIRECT_THRESHOLD_MB and KATANA_LOCAL_IO_URING
+    static Options FromEnv();
+  };
+
+  static katana::Result<std::unique_ptr<LocalAsyncIO>> Make(
+      const Options& opts);
+
+  LocalAsyncIO(const LocalAsyncIO&) = delete;
+  LocalAsyncIO& operator=(const LocalAsyncIO&) = delete;
+  LocalAsyncIO(LocalAsyncIO&&) = delete;
+  LocalAsyncIO& operator=(LocalAsyncIO&&) = delete;
+
+  /// Waits for all outstanding requests
+  ~LocalAsyncIO();
+
+  /// Read [start, start + size) of the file at path into buf, which must stay
+  /// valid until the returned future is ready. As with LocalStorage, reads
+  /// that end less than a block past the end of the file succeed.
+  std::future<katana::CopyableResult<void>> Read(
+      const std::string& path, uint64_t start, uint64_t size, uint8_t* buf);
+
+  /// Replace the contents of the file at path with [data, data + size), which
+  /// must stay valid until the returned future is ready
+  std::future<katana::CopyableResult<void>> Write(
+      const std::string& path, const uint8_t* data, uint64_t size);
+
+  bool uses_io_uring() const { return ring_ != nullptr; }
+
+private:
+  class Ring;
+  struct Request;
+
+  struct Chunk {
+    std::shared_ptr<Request> request;
+    int fd{-1};
+    uint8_t* buf{nullptr};
+    uint64_t offset{0};
+    uint64_t size{0};
+    bool write{false};
+  };
+
+  LocalAsyncIO(const Options& opts);
+
+  static void Split(
+      const std::shared_ptr<Request>& request, int fd, uint8_t* buf,
+      uint64_t buf_offset, uint64_t begin, uint64_t end, bool write,
+      std::vector<Chunk>* chunks);
+
+  void Submit(std::vector<Chunk>&& chunks);
+
+  /// Account for the result of issuing chunk, the number of bytes transferred
+  /// or a negative errno. Returns false if what remains of chunk must be
+  /// issued again.
+  static bool Advance(Chunk* chunk, int64_t res);
+
+  /// Retire a chunk, completing its request if it was the last one
+  static void Finish(Chunk* chunk);
+
+  void RingLoop();
+  void WorkerLoop();
+
+  Options opts_;
+  std::unique_ptr<Ring> ring_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Chunk> pending_;
+  bool stopping_{false};
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace katana
+
+#endif
@@ -47,8 +47,67 @@ GetPath(const std::string& uri) {
   return u.path();
 }
 
+std::future<katana::CopyableResult<void>>
+ReadyFuture(katana::CopyableResult<void> res) {
+  std::promise<katana::CopyableResult<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
 }  // namespace
 
+katana::Result<void>
+katana::LocalStorage::Init() {
+  async_io_ =
+      KATANA_CHECKED(LocalAsyncIO::Make(LocalAsyncIO::Options::FromEnv()));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::LocalStorage::Fini() {
+  // Waits for outstanding operations
+  async_io_.reset();
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  if (!async_io_) {
+    if (auto write_res = WriteFile(uri, data, size); !write_res) {
+      return ReadyFuture(write_res.error());
+    }
+    return ReadyFuture(katana::CopyableResultSuccess());
+  }
+
+  auto path = GetPath(uri);
+  if (!path) {
+    return ReadyFuture(path.error());
+  }
+  if (auto res = EnsureDirectories(path.value()); !res) {
+    return ReadyFuture(res.error());
+  }
+  return async_io_->Write(path.value(), data, size);
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (!async_io_) {
+    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
+      return ReadyFuture(read_res.error());
+    }
+    return ReadyFuture(katana::CopyableResultSuccess());
+  }
+
+  auto path = GetPath(uri);
+  if (!path) {
+    return ReadyFuture(path.error());
+  }
+  return async_io_->Read(path.value(), start, size, result_buf);
+}
+
 katana::Result<void>
 katana::LocalStorage::WriteFile(
     const std::string& uri, const uint8_t* data, uint64_t size) {
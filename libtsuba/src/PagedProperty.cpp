@@ -0,0 +1,146 @@
+#include "katana/PagedProperty.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/PropertyManager.h"
+
+katana::PagedProperty::PagedProperty(
+    const katana::Uri& path, const std::string& name,
+    std::unique_ptr<ParquetReader::RowGroupTable>&& rows, const Options& opts)
+    : path_(path),
+      name_(name),
+      rows_(std::move(rows)),
+      type_(rows_->schema()->field(0)->type()),
+      opts_(opts) {}
+
+katana::PagedProperty::~PagedProperty() { Release(); }
+
+katana::Result<std::unique_ptr<katana::PagedProperty>>
+katana::PagedProperty::Make(
+    const katana::Uri& path, const std::string& name, const Options& opts) {
+  if (opts.max_active_pages == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "max_active_pages must be at least 1");
+  }
+
+  std::unique_ptr<ParquetReader> reader =
+      KATANA_CHECKED(ParquetReader::Make());
+  std::unique_ptr<ParquetReader::RowGroupTable> rows;
+  try {
+    rows = KATANA_CHECKED(reader->OpenRowGroups(path));
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+  }
+
+  const std::shared_ptr<arrow::Schema>& schema = rows->schema();
+  if (schema->num_fields() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected 1 field found {} instead",
+        schema->num_fields());
+  }
+  if (schema->field(0)->name() != name) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} found {} instead",
+        std::quoted(name), std::quoted(schema->field(0)->name()));
+  }
+
+  return std::unique_ptr<PagedProperty>(
+      new PagedProperty(path, name, std::move(rows), opts));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PagedProperty::GetRows(int64_t offset, int64_t length) {
+  if (offset < 0 || length < 0 || offset > num_rows() - length) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "rows [{}, {}) are not within the {} rows of {}", offset,
+        offset + length, num_rows(), std::quoted(name_));
+  }
+
+  const std::vector<int64_t>& offsets = rows_->row_group_offsets();
+  int64_t end = offset + length;
+  size_t page =
+      std::upper_bound(offsets.begin(), offsets.end(), offset) -
+      offsets.begin() - 1;
+
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  for (int64_t row = offset; row < end; ++page) {
+    if (offsets[page] == offsets[page + 1]) {
+      continue;
+    }
+    std::shared_ptr<arrow::ChunkedArray> values = KATANA_CHECKED(GetPage(page));
+    int64_t page_end = std::min(end, offsets[page + 1]);
+    std::shared_ptr<arrow::ChunkedArray> sliced =
+        values->Slice(row - offsets[page], page_end - row);
+    chunks.insert(
+        chunks.end(), sliced->chunks().begin(), sliced->chunks().end());
+    row = page_end;
+  }
+
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(std::move(chunks), type_));
+}
+
+katana::Result<std::shared_ptr<arrow::Scalar>>
+katana::PagedProperty::GetScalar(int64_t row) {
+  std::shared_ptr<arrow::ChunkedArray> values =
+      KATANA_CHECKED(GetRows(row, 1));
+  return KATANA_CHECKED(values->GetScalar(0));
+}
+
+void
+katana::PagedProperty::Release() {
+  while (!active_.empty()) {
+    EvictOne();
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PagedProperty::GetPage(size_t page) {
+  if (auto it = active_.find(page); it != active_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+    return it->second.values;
+  }
+
+  PropertyManager* pm = MemorySupervisor::Get().GetPropertyManager();
+  KATANA_LOG_DEBUG_ASSERT(pm);
+  std::shared_ptr<arrow::Table> table = pm->GetProperty(PageKey(page));
+  if (!table) {
+    try {
+      table = KATANA_CHECKED_CONTEXT(
+          rows_->ReadRowGroup(page), "reading page {} of {}", page,
+          std::quoted(name_));
+    } catch (const std::exception& exp) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+    }
+    pm->PropertyLoadedActive(table);
+  }
+
+  while (active_.size() >= opts_.max_active_pages) {
+    EvictOne();
+  }
+  lru_.emplace_front(page);
+  std::shared_ptr<arrow::ChunkedArray> values = table->column(0);
+  active_.emplace(page, ActivePage{values, std::move(table), lru_.begin()});
+  return values;
+}
+
+void
+katana::PagedProperty::EvictOne() {
+  KATANA_LOG_DEBUG_ASSERT(!lru_.empty());
+  size_t page = lru_.back();
+  lru_.pop_back();
+  auto node = active_.extract(page);
+  PropertyManager* pm = MemorySupervisor::Get().GetPropertyManager();
+  pm->PutProperty(PageKey(page), node.mapped().table);
+}
+
+katana::Uri
+katana::PagedProperty::PageKey(size_t page) const {
+  return path_.Join(fmt::format("page-{}", page));
+}
@@ -1,19 +1,33 @@
 #include "katana/ParquetReader.h"
 
+#include <algorithm>
+#include <future>
+#include <iomanip>
 #include <limits>
 #include <memory>
 #include <unordered_map>
+#include <variant>
 
 #include <arrow/array/util.h>
 #include <arrow/chunked_array.h>
 #include <arrow/compute/cast.h>
+#include <arrow/io/interfaces.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <arrow/util/thread_pool.h>
+#include <parquet/arrow/reader.h>
 #include <parquet/arrow/schema.h>
+#include <parquet/metadata.h>
+#include <parquet/properties.h>
+#include <parquet/schema.h>
+#include <parquet/statistics.h>
+#include <parquet/types.h>
 
+#include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileView.h"
 #include "katana/JSON.h"
+#include "katana/ProgressTracer.h"
 
 template <typename T>
 using Result = katana::Result<T>;
@@ -22,6 +36,17 @@ using ErrorCode = katana::ErrorCode;
 
 namespace {
 
+bool
+IsDictionaryOfStrings(const arrow::DataType& type) {
+  if (type.id() != arrow::Type::type::DICTIONARY) {
+    return false;
+  }
+  const auto& value_type =
+      static_cast<const arrow::DictionaryType&>(type).value_type();
+  return value_type->id() == arrow::Type::type::STRING ||
+         value_type->id() == arrow::Type::type::LARGE_STRING;
+}
+
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
   switch (old_array->type()->id()) {
@@ -39,6 +64,12 @@ HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
         KATANA_CHECKED(arrow::compute::Cast(old_array, opts));
     return cast_res.chunked_array();
   }
+  case arrow::Type::type::DICTIONARY:
+    if (!IsDictionaryOfStrings(*old_array->type())) {
+      return old_array;
+    }
+    // Every row group has a dictionary of its own
+    return katana::DictionaryEncodeStrings(old_array);
   default:
     return old_array;
   }
@@ -51,14 +82,50 @@ HandleBadParquetTypes(std::shared_ptr<arrow::Field> old_field) {
     return std::make_shared<arrow::Field>(
         old_field->name(), arrow::large_utf8());
   }
+  case arrow::Type::type::DICTIONARY: {
+    if (!IsDictionaryOfStrings(*old_field->type())) {
+      return old_field;
+    }
+    return std::make_shared<arrow::Field>(
+        old_field->name(), katana::DictionaryStringType());
+  }
   default:
     return old_field;
   }
 }
 
+/// Combine the chunks of the columns of table that property views only read
+/// as one array. Integer and floating point columns keep their chunks.
+katana::Result<std::shared_ptr<arrow::Table>>
+CombineUnviewedChunks(const std::shared_ptr<arrow::Table>& table) {
+  arrow::ChunkedArrayVector columns = table->columns();
+  for (auto& column : columns) {
+    arrow::Type::type id = column->type()->id();
+    if (column->num_chunks() <= 1 || arrow::is_integer(id) ||
+        arrow::is_floating(id)) {
+      continue;
+    }
+    // combine through a table to split binary columns too long for one array
+    // like arrow::Table::CombineChunks does
+    auto single = arrow::Table::Make(
+        arrow::schema({arrow::field("", column->type())}), {column});
+    column = KATANA_CHECKED(single->CombineChunks(arrow::default_memory_pool()))
+                 ->column(0);
+  }
+  return arrow::Table::Make(table->schema(), columns, table->num_rows());
+}
+
+/// How the parquet readers of one ParquetReader call behave
+struct ReaderConfig {
+  bool parallel{false};
+  /// executor for the fetches of parallel reads; null means arrow's shared
+  /// I/O thread pool
+  arrow::internal::Executor* io_executor{nullptr};
+};
+
 Result<std::unique_ptr<parquet::arrow::FileReader>>
 BuildReader(
-    const std::string& uri, bool preload,
+    const std::string& uri, bool preload, const ReaderConfig& config,
     std::shared_ptr<katana::FileView>* fv) {
   auto fv_tmp = std::make_shared<katana::FileView>();
   uint64_t end = preload ? std::numeric_limits<uint64_t>::max() : 0;
@@ -68,21 +135,45 @@ BuildReader(
   *fv = fv_tmp;
 
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  KATANA_CHECKED(
-      parquet::arrow::OpenFile(fv_tmp, arrow::default_memory_pool(), &reader));
+  if (!config.parallel) {
+    KATANA_CHECKED(parquet::arrow::OpenFile(
+        fv_tmp, arrow::default_memory_pool(), &reader));
+    return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
+  }
+
+  parquet::ArrowReaderProperties properties;
+  properties.set_use_threads(true);
+  properties.set_pre_buffer(true);
+  if (config.io_executor != nullptr) {
+    properties.set_io_context(arrow::io::IOContext(
+        arrow::default_memory_pool(), config.io_executor));
+  }
+
+  parquet::arrow::FileReaderBuilder builder;
+  KATANA_CHECKED(builder.Open(fv_tmp));
+  KATANA_CHECKED(builder.memory_pool(arrow::default_memory_pool())
+                     ->properties(properties)
+                     ->Build(&reader));
 
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
-Result<std::shared_ptr<arrow::Table>>
-ReadTableSlice(
-    parquet::arrow::FileReader* reader, katana::FileView* fv, int64_t first_row,
-    int64_t last_row) {
+/// The row groups of a file that hold some range of its rows
+struct RowGroupSelection {
   std::vector<int> row_groups;
+  /// offset of the first row of the range in the first selected row group
+  int64_t row_offset{0};
+  /// approximate location of the selected row groups in the file
+  int64_t file_begin{0};
+  int64_t file_end{0};
+};
+
+RowGroupSelection
+SelectRowGroups(
+    parquet::arrow::FileReader* reader, int64_t first_row, int64_t last_row) {
+  RowGroupSelection selection;
   int rg_count = reader->num_row_groups();
-  int64_t row_offset = 0;
   int64_t cumulative_rows = 0;
-  int64_t file_offset = 0;
   int64_t cumulative_bytes = 0;
 
   for (int i = 0; cumulative_rows < last_row && i < rg_count; ++i) {
@@ -90,23 +181,298 @@ ReadTableSlice(
     int64_t new_rows = rg_md->num_rows();
     int64_t new_bytes = rg_md->total_byte_size();
     if (first_row < cumulative_rows + new_rows) {
-      if (row_groups.empty()) {
-        row_offset = first_row - cumulative_rows;
-        file_offset = cumulative_bytes;
+      if (selection.row_groups.empty()) {
+        selection.row_offset = first_row - cumulative_rows;
+        selection.file_begin = cumulative_bytes;
       }
-      row_groups.push_back(i);
+      selection.row_groups.push_back(i);
     }
     cumulative_rows += new_rows;
     cumulative_bytes += new_bytes;
   }
+  selection.file_end = cumulative_bytes;
+
+  return selection;
+}
+
+Result<std::shared_ptr<arrow::Table>>
+ReadTableSlice(
+    parquet::arrow::FileReader* reader, katana::FileView* fv, int64_t first_row,
+    int64_t last_row) {
+  RowGroupSelection selection = SelectRowGroups(reader, first_row, last_row);
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
+  if (auto res = fv->Fill(selection.file_begin, selection.file_end, false);
+      !res) {
     return res.error();
   }
 
   std::shared_ptr<arrow::Table> out;
-  KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
-  return out->Slice(row_offset, last_row - first_row);
+  KATANA_CHECKED(reader->ReadRowGroups(selection.row_groups, &out));
+  return out->Slice(selection.row_offset, last_row - first_row);
+}
+
+/// Read one column of the selected row groups
+Result<std::shared_ptr<arrow::ChunkedArray>>
+ReadColumnSlice(
+    parquet::arrow::FileReader* reader, const RowGroupSelection& selection,
+    int column_idx, const std::shared_ptr<arrow::DataType>& type) {
+  arrow::ArrayVector chunks;
+  for (int row_group : selection.row_groups) {
+    std::shared_ptr<arrow::ChunkedArray> part;
+    KATANA_CHECKED(
+        reader->RowGroup(row_group)->Column(column_idx)->Read(&part));
+    chunks.insert(chunks.end(), part->chunks().begin(), part->chunks().end());
+  }
+  return std::make_shared<arrow::ChunkedArray>(std::move(chunks), type);
+}
+
+/// A filter bound in the domain that parquet statistics of its column are
+/// compared in: integers (including booleans and temporal types), floating
+/// point numbers or byte strings
+using StatValue = std::variant<int64_t, double, std::string>;
+
+/// A ColumnFilter resolved against the schema of one file
+struct ResolvedFilter {
+  /// leaf column index of the filtered column; -1 if its statistics are not
+  /// usable, in which case the filter matches every row group
+  int column{-1};
+  std::optional<StatValue> lower;
+  std::optional<StatValue> upper;
+};
+
+bool
+SameTimeUnit(
+    arrow::TimeUnit::type arrow_unit,
+    parquet::LogicalType::TimeUnit::unit parquet_unit) {
+  switch (arrow_unit) {
+  case arrow::TimeUnit::MILLI:
+    return parquet_unit == parquet::LogicalType::TimeUnit::MILLIS;
+  case arrow::TimeUnit::MICRO:
+    return parquet_unit == parquet::LogicalType::TimeUnit::MICROS;
+  case arrow::TimeUnit::NANO:
+    return parquet_unit == parquet::LogicalType::TimeUnit::NANOS;
+  default:
+    return false;
+  }
+}
+
+Result<int64_t>
+CastToInt64(const std::shared_ptr<arrow::Scalar>& value) {
+  arrow::Datum cast =
+      KATANA_CHECKED(arrow::compute::Cast(arrow::Datum(value), arrow::int64()));
+  return std::static_pointer_cast<arrow::Int64Scalar>(cast.scalar())->value;
+}
+
+/// Convert a filter bound to the domain the statistics of a column of type
+/// type and parquet logical type logical are compared in. Returns an empty
+/// optional if those statistics cannot be compared with the bound.
+Result<std::optional<StatValue>>
+ToStatValue(
+    const std::shared_ptr<arrow::Scalar>& bound,
+    const std::shared_ptr<arrow::DataType>& type,
+    const parquet::LogicalType& logical) {
+  arrow::Datum cast =
+      KATANA_CHECKED(arrow::compute::Cast(arrow::Datum(bound), type));
+  std::shared_ptr<arrow::Scalar> value = cast.scalar();
+  if (!value->is_valid) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "filter bounds cannot be null values");
+  }
+
+  switch (type->id()) {
+  case arrow::Type::type::BOOL:
+  case arrow::Type::type::INT8:
+  case arrow::Type::type::INT16:
+  case arrow::Type::type::INT32:
+  case arrow::Type::type::INT64:
+  case arrow::Type::type::UINT8:
+  case arrow::Type::type::UINT16:
+    // n.b. the statistics of wider unsigned types are unsigned, so they
+    // cannot be compared as int64
+    return StatValue(KATANA_CHECKED(CastToInt64(value)));
+  case arrow::Type::type::DATE32: {
+    arrow::Datum days = KATANA_CHECKED(
+        arrow::compute::Cast(arrow::Datum(value), arrow::int32()));
+    return StatValue(int64_t{
+        std::static_pointer_cast<arrow::Int32Scalar>(days.scalar())->value});
+  }
+  case arrow::Type::type::TIMESTAMP: {
+    // arrow may have coerced the timestamps to another unit when it wrote
+    // them
+    if (!logical.is_timestamp() ||
+        !SameTimeUnit(
+            std::static_pointer_cast<arrow::TimestampType>(type)->unit(),
+            static_cast<const parquet::TimestampLogicalType&>(logical)
+                .time_unit())) {
+      return std::nullopt;
+    }
+    return StatValue(KATANA_CHECKED(CastToInt64(value)));
+  }
+  case arrow::Type::type::FLOAT:
+  case arrow::Type::type::DOUBLE: {
+    arrow::Datum as_double = KATANA_CHECKED(
+        arrow::compute::Cast(arrow::Datum(value), arrow::float64()));
+    return StatValue(
+        std::static_pointer_cast<arrow::DoubleScalar>(as_double.scalar())
+            ->value);
+  }
+  case arrow::Type::type::STRING:
+  case arrow::Type::type::LARGE_STRING:
+  case arrow::Type::type::BINARY:
+  case arrow::Type::type::LARGE_BINARY:
+    return StatValue(
+        std::static_pointer_cast<arrow::BaseBinaryScalar>(value)
+            ->value->ToString());
+  default:
+    return std::nullopt;
+  }
+}
+
+Result<std::vector<ResolvedFilter>>
+ResolveFilters(
+    parquet::arrow::FileReader* reader,
+    const std::vector<katana::ParquetReader::ColumnFilter>& filters) {
+  std::shared_ptr<arrow::Schema> schema;
+  KATANA_CHECKED(reader->GetSchema(&schema));
+  const parquet::SchemaDescriptor* descr =
+      reader->parquet_reader()->metadata()->schema();
+
+  std::vector<ResolvedFilter> resolved;
+  for (const auto& filter : filters) {
+    int field_idx = schema->GetFieldIndex(filter.column);
+    if (field_idx < 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "cannot filter on missing column {}",
+          std::quoted(filter.column));
+    }
+    const std::shared_ptr<arrow::DataType>& type =
+        schema->field(field_idx)->type();
+
+    ResolvedFilter& out = resolved.emplace_back();
+    // nested columns have no leaf of their own name
+    int column = descr->ColumnIndex(filter.column);
+    if (column < 0) {
+      continue;
+    }
+    const parquet::LogicalType& logical =
+        *descr->Column(column)->logical_type();
+    if (filter.lower) {
+      out.lower = KATANA_CHECKED(ToStatValue(filter.lower, type, logical));
+      if (!out.lower) {
+        continue;
+      }
+    }
+    if (filter.upper) {
+      out.upper = KATANA_CHECKED(ToStatValue(filter.upper, type, logical));
+      if (!out.upper) {
+        continue;
+      }
+    }
+    out.column = column;
+  }
+  return resolved;
+}
+
+template <typename T>
+bool
+InRange(const T& min, const T& max, const ResolvedFilter& filter) {
+  if (filter.lower) {
+    if (const T* lower = std::get_if<T>(&filter.lower.value());
+        lower && max < *lower) {
+      return false;
+    }
+  }
+  if (filter.upper) {
+    if (const T* upper = std::get_if<T>(&filter.upper.value());
+        upper && *upper < min) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Whether the column chunk with statistics stats may hold a value that
+/// satisfies filter
+bool
+MayMatch(const parquet::Statistics& stats, const ResolvedFilter& filter) {
+  if (stats.HasNullCount() && stats.num_values() == 0) {
+    // all null
+    return false;
+  }
+  if (!stats.HasMinMax()) {
+    return true;
+  }
+
+  switch (stats.physical_type()) {
+  case parquet::Type::BOOLEAN: {
+    const auto& typed = static_cast<const parquet::BoolStatistics&>(stats);
+    return InRange<int64_t>(typed.min(), typed.max(), filter);
+  }
+  case parquet::Type::INT32: {
+    const auto& typed = static_cast<const parquet::Int32Statistics&>(stats);
+    return InRange<int64_t>(typed.min(), typed.max(), filter);
+  }
+  case parquet::Type::INT64: {
+    const auto& typed = static_cast<const parquet::Int64Statistics&>(stats);
+    return InRange<int64_t>(typed.min(), typed.max(), filter);
+  }
+  case parquet::Type::FLOAT: {
+    const auto& typed = static_cast<const parquet::FloatStatistics&>(stats);
+    return InRange<double>(typed.min(), typed.max(), filter);
+  }
+  case parquet::Type::DOUBLE: {
+    const auto& typed = static_cast<const parquet::DoubleStatistics&>(stats);
+    return InRange<double>(typed.min(), typed.max(), filter);
+  }
+  case parquet::Type::BYTE_ARRAY: {
+    const auto& typed = static_cast<const parquet::ByteArrayStatistics&>(stats);
+    const parquet::ByteArray& min = typed.min();
+    const parquet::ByteArray& max = typed.max();
+    return InRange<std::string>(
+        std::string(reinterpret_cast<const char*>(min.ptr), min.len),
+        std::string(reinterpret_cast<const char*>(max.ptr), max.len), filter);
+  }
+  default:
+    return true;
+  }
+}
+
+/// Whether the row group with metadata rg_md may hold a row that satisfies
+/// every filter
+bool
+MayMatch(
+    const parquet::RowGroupMetaData& rg_md,
+    const std::vector<ResolvedFilter>& filters) {
+  for (const auto& filter : filters) {
+    if (filter.column < 0) {
+      continue;
+    }
+    auto chunk = rg_md.ColumnChunk(filter.column);
+    if (!chunk->is_stats_set()) {
+      continue;
+    }
+    if (!MayMatch(*chunk->statistics(), filter)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Append [begin, end) to ranges, merging it with the last range if they
+/// are adjacent
+void
+AppendRange(
+    std::vector<katana::ParquetReader::Slice>* ranges, int64_t begin,
+    int64_t end) {
+  if (begin >= end) {
+    return;
+  }
+  if (!ranges->empty() &&
+      ranges->back().offset + ranges->back().length == begin) {
+    ranges->back().length += end - begin;
+    return;
+  }
+  ranges->emplace_back(katana::ParquetReader::Slice{begin, end - begin});
 }
 
 class BlockedParquetReader {
@@ -129,10 +495,14 @@ public:
   /// "[0, 10]" corresponds to a single logical table who's rows 0-9 are in
   /// "s3://example_file/table.parquet.part_000000000" and rows 10-end are
   /// in "s3://example_file/table.parquet.part_000000001"
+  ///
+  /// config.parallel makes the reads of the returned reader use several
+  /// threads.
   static Result<std::unique_ptr<BlockedParquetReader>> Make(
-      const katana::Uri& uri, bool preload) {
+      const katana::Uri& uri, bool preload,
+      const ReaderConfig& config = ReaderConfig{}) {
     std::shared_ptr<katana::FileView> fv;
-    auto builder_res = BuildReader(uri.string(), preload, &fv);
+    auto builder_res = BuildReader(uri.string(), preload, config, &fv);
 
     if (builder_res) {
       std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers;
@@ -141,7 +511,7 @@ public:
       fvs.emplace_back(std::move(fv));
 
       return std::unique_ptr<BlockedParquetReader>(new BlockedParquetReader(
-          uri.string(), std::move(fvs), std::move(readers), {0}));
+          uri.string(), config, std::move(fvs), std::move(readers), {0}));
     }
 
     if (builder_res.error() != katana::ErrorCode::InvalidArgument) {
@@ -168,10 +538,11 @@ public:
     std::vector<std::shared_ptr<katana::FileView>> fvs(row_offsets.size());
 
     std::unique_ptr<BlockedParquetReader> bpr(new BlockedParquetReader(
-        uri.string(), std::move(fvs), std::move(readers),
+        uri.string(), config, std::move(fvs), std::move(readers),
         std::move(row_offsets)));
 
-    if (preload) {
+    // a parallel ReadTable builds the readers it needs concurrently
+    if (preload && !config.parallel) {
       for (size_t i = 0, num_files = bpr->row_offsets_.size(); i < num_files;
            ++i) {
         KATANA_CHECKED(bpr->EnsureReader(i, true));
@@ -204,11 +575,29 @@ public:
       std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
     if (!slice) {
       std::vector<std::shared_ptr<arrow::Table>> tables;
-      for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-        KATANA_CHECKED(EnsureReader(i, true));
-        std::shared_ptr<arrow::Table> table;
-        KATANA_CHECKED(readers_[i]->ReadTable(&table));
-        tables.emplace_back(std::move(table));
+      if (config_.parallel && readers_.size() > 1) {
+        std::vector<std::future<katana::CopyableResult<void>>> reads;
+        tables.resize(readers_.size());
+        for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
+          reads.emplace_back(std::async(
+              std::launch::async,
+              [this, i, &tables]() -> katana::CopyableResult<void> {
+                KATANA_CHECKED_CONTEXT(
+                    ReadFile(i, &tables[i]), "reading part {}", i);
+                return katana::CopyableResultSuccess();
+              }));
+        }
+        // n.b. returning early is safe: destroying reads waits for the reads
+        // still writing to tables
+        for (auto& read : reads) {
+          KATANA_CHECKED(read.get());
+        }
+      } else {
+        for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
+          std::shared_ptr<arrow::Table> table;
+          KATANA_CHECKED(ReadFile(i, &table));
+          tables.emplace_back(std::move(table));
+        }
       }
       return KATANA_CHECKED(arrow::ConcatenateTables(tables));
     }
@@ -256,65 +645,175 @@ public:
     }
 
     if (tables.empty()) {
-      KATANA_CHECKED(EnsureReader(0, false));
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(readers_[idx]->GetSchema(&schema));
-
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
-      for (const auto& field : schema->fields()) {
-        cols.emplace_back(std::make_shared<arrow::ChunkedArray>(
-            KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), 0))));
+      return MakeNullTable(0);
+    }
+
+    return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+  }
+
+  /// Rows [first_row, last_row) that may satisfy every filter
+  Result<std::vector<katana::ParquetReader::Slice>> FindMatchingRows(
+      const std::vector<katana::ParquetReader::ColumnFilter>& filters,
+      int64_t first_row, int64_t last_row) {
+    std::vector<katana::ParquetReader::Slice> matches;
+
+    for (size_t idx = 0, num_files = readers_.size(); idx < num_files; ++idx) {
+      int64_t table_offset = row_offsets_[idx];
+      int64_t next_table_offset =
+          (idx == num_files - 1 ? std::numeric_limits<int64_t>::max()
+                                : row_offsets_[idx + 1]);
+      if (next_table_offset <= first_row || last_row <= table_offset) {
+        continue;
+      }
+      // only the footer of each file is fetched
+      KATANA_CHECKED(EnsureReader(idx, false));
+      auto metadata = readers_[idx]->parquet_reader()->metadata();
+      std::vector<ResolvedFilter> resolved =
+          KATANA_CHECKED(ResolveFilters(readers_[idx].get(), filters));
+
+      int64_t rg_first = table_offset;
+      for (int i = 0, rg_count = metadata->num_row_groups();
+           i < rg_count && rg_first < last_row; ++i) {
+        auto rg_md = metadata->RowGroup(i);
+        int64_t rg_last = rg_first + rg_md->num_rows();
+        if (first_row < rg_last && MayMatch(*rg_md, resolved)) {
+          AppendRange(
+              &matches, std::max(rg_first, first_row),
+              std::min(rg_last, last_row));
+        }
+        rg_first = rg_last;
+      }
+    }
+
+    return matches;
+  }
+
+  /// Read the rows of slice in ranges, with nulls for the others
+  Result<std::shared_ptr<arrow::Table>> ReadRows(
+      const std::vector<katana::ParquetReader::Slice>& ranges,
+      katana::ParquetReader::Slice slice) {
+    int64_t curr_row = slice.offset;
+    int64_t last_row =
+        std::min(KATANA_CHECKED(NumRows()), slice.offset + slice.length);
+    if (last_row < curr_row) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "slice cannot extend past end of table");
+    }
+
+    std::vector<std::shared_ptr<arrow::Table>> tables;
+    for (const auto& range : ranges) {
+      int64_t begin = std::max(range.offset, curr_row);
+      int64_t end = std::min(range.offset + range.length, last_row);
+      if (begin >= end) {
+        continue;
       }
-      return arrow::Table::Make(schema, cols);
+      if (curr_row < begin) {
+        tables.emplace_back(KATANA_CHECKED(MakeNullTable(begin - curr_row)));
+      }
+      tables.emplace_back(KATANA_CHECKED(
+          ReadTable(katana::ParquetReader::Slice{begin, end - begin})));
+      curr_row = end;
+    }
+    if (curr_row < last_row || tables.empty()) {
+      tables.emplace_back(KATANA_CHECKED(MakeNullTable(last_row - curr_row)));
     }
 
     return KATANA_CHECKED(arrow::ConcatenateTables(tables));
   }
 
   Result<std::shared_ptr<arrow::Table>> ReadTable(
-      std::vector<int32_t> col_indexes,
+      const std::vector<int32_t>& col_indexes,
       std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
+    int64_t first_row = 0;
+    int64_t last_row = std::numeric_limits<int64_t>::max();
+    if (slice) {
+      last_row =
+          std::min(KATANA_CHECKED(NumRows()), slice->offset + slice->length);
+      first_row = std::min(slice->offset, last_row);
+    }
+
     std::vector<std::shared_ptr<arrow::Table>> tables;
 
-    for (auto& reader : readers_) {
-      std::vector<std::shared_ptr<arrow::Field>> fields;
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-      std::unordered_map<int32_t, std::shared_ptr<arrow::ChunkedArray>>
-          read_arrays;
-
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(reader->GetSchema(&schema));
-      for (int32_t idx : col_indexes) {
-        if (idx < 0) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument, "column indexes must be positive");
-        }
-        if (idx >= schema->num_fields()) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument,
-              "column index {} should be less than the number of columns {}",
-              idx, schema->num_fields());
-        }
-        std::shared_ptr<arrow::ChunkedArray> column;
-        if (auto arr_it = read_arrays.find(idx); arr_it != read_arrays.end()) {
-          column = arr_it->second;
-        } else {
-          KATANA_CHECKED(reader->ReadColumn(idx, &column));
-          read_arrays.emplace(idx, column);
-        }
-        fields.emplace_back(schema->field(idx));
-        columns.emplace_back(std::move(column));
+    for (size_t idx = 0, num_files = readers_.size(); idx < num_files; ++idx) {
+      int64_t table_offset = row_offsets_[idx];
+      int64_t next_table_offset =
+          (idx == num_files - 1 ? std::numeric_limits<int64_t>::max()
+                                : row_offsets_[idx + 1]);
+      // the first file is always read so that the result has a schema
+      if (idx > 0 &&
+          (next_table_offset <= first_row || last_row <= table_offset)) {
+        continue;
       }
-      tables.emplace_back(arrow::Table::Make(arrow::schema(fields), columns));
+      int64_t local_first = std::max<int64_t>(first_row - table_offset, 0);
+      int64_t local_last = std::max(
+          local_first,
+          std::min(last_row, next_table_offset) - table_offset);
+      tables.emplace_back(KATANA_CHECKED(
+          ReadColumns(idx, col_indexes, local_first, local_last)));
     }
 
-    std::shared_ptr<arrow::Table> concatenated_table =
-        KATANA_CHECKED(arrow::ConcatenateTables(tables));
-    if (slice) {
-      concatenated_table =
-          concatenated_table->Slice(slice->offset, slice->length);
+    return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+  }
+
+  /// The schema of the tables read from this one; unlike ReadSchema, this
+  /// accounts for the arrow schema stored with the parquet schema
+  Result<std::shared_ptr<arrow::Schema>> ReadArrowSchema() {
+    KATANA_CHECKED(EnsureReader(0, false));
+    std::shared_ptr<arrow::Schema> schema;
+    KATANA_CHECKED(readers_[0]->GetSchema(&schema));
+    return schema;
+  }
+
+  /// The first row of every row group followed by the number of rows, and
+  /// the file and index in that file of every row group
+  Result<void> RowGroupLayout(
+      std::vector<int64_t>* offsets,
+      std::vector<std::pair<size_t, int>>* locations) {
+    for (size_t idx = 0, num_files = readers_.size(); idx < num_files; ++idx) {
+      KATANA_CHECKED(EnsureReader(idx, false));
+      auto metadata = readers_[idx]->parquet_reader()->metadata();
+      int64_t rows = row_offsets_[idx];
+      for (int i = 0, rg_count = metadata->num_row_groups(); i < rg_count;
+           ++i) {
+        offsets->emplace_back(rows);
+        locations->emplace_back(idx, i);
+        rows += metadata->RowGroup(i)->num_rows();
+      }
+    }
+    offsets->emplace_back(KATANA_CHECKED(NumRows()));
+    return katana::ResultSuccess();
+  }
+
+  /// Read row group rg of file idx, then release the bytes of the file
+  Result<std::shared_ptr<arrow::Table>> ReadRowGroup(size_t idx, int rg) {
+    KATANA_CHECKED(EnsureReader(idx, false));
+    parquet::arrow::FileReader* reader = readers_[idx].get();
+
+    auto rg_md = reader->parquet_reader()->metadata()->RowGroup(rg);
+    int64_t begin = std::numeric_limits<int64_t>::max();
+    int64_t end = 0;
+    for (int i = 0, num_columns = rg_md->num_columns(); i < num_columns; ++i) {
+      auto chunk = rg_md->ColumnChunk(i);
+      int64_t chunk_begin = chunk->data_page_offset();
+      if (chunk->has_dictionary_page() && chunk->dictionary_page_offset() > 0) {
+        chunk_begin = std::min(chunk_begin, chunk->dictionary_page_offset());
+      }
+      begin = std::min(begin, chunk_begin);
+      end = std::max(end, chunk_begin + chunk->total_compressed_size());
+    }
+    if (begin < end) {
+      KATANA_CHECKED(fvs_[idx]->Fill(begin, end, false));
     }
-    return concatenated_table;
+
+    std::shared_ptr<arrow::Table> table;
+    KATANA_CHECKED(reader->ReadRowGroup(rg, &table));
+
+    // decoded tables do not refer to the bytes they were decoded from, and
+    // the footer was parsed when the reader was built
+    KATANA_CHECKED(
+        fvs_[idx]->Discard(0, std::numeric_limits<uint64_t>::max()));
+    return table;
   }
 
   Result<std::vector<std::string>> GetFiles() {
@@ -332,10 +831,12 @@ public:
 
 private:
   BlockedParquetReader(
-      std::string prefix, std::vector<std::shared_ptr<katana::FileView>>&& fvs,
+      std::string prefix, const ReaderConfig& config,
+      std::vector<std::shared_ptr<katana::FileView>>&& fvs,
       std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
       std::vector<int64_t>&& row_offsets)
       : prefix_(std::move(prefix)),
+        config_(config),
         fvs_(std::move(fvs)),
         readers_(std::move(readers)),
         row_offsets_(std::move(row_offsets)) {}
@@ -346,22 +847,169 @@ private:
       return katana::ResultSuccess();
     }
     readers_[idx] = KATANA_CHECKED(BuildReader(
-        fmt::format("{}.part_{:09}", prefix_, idx), preload, &fvs_[idx]));
+        fmt::format("{}.part_{:09}", prefix_, idx), preload, config_,
+        &fvs_[idx]));
 
     return katana::ResultSuccess();
   }
 
+  /// A table with the schema of this one whose values are all null
+  Result<std::shared_ptr<arrow::Table>> MakeNullTable(int64_t num_rows) {
+    std::shared_ptr<arrow::Schema> schema = KATANA_CHECKED(ReadArrowSchema());
+
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
+    for (const auto& field : schema->fields()) {
+      cols.emplace_back(std::make_shared<arrow::ChunkedArray>(
+          KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), num_rows))));
+    }
+    return arrow::Table::Make(schema, cols);
+  }
+
+  /// Read all of file idx; reads of different files may run concurrently
+  Result<void> ReadFile(size_t idx, std::shared_ptr<arrow::Table>* table) {
+    KATANA_CHECKED(EnsureReader(idx, true));
+    KATANA_CHECKED(readers_[idx]->ReadTable(table));
+    return katana::ResultSuccess();
+  }
+
+  /// Read rows [first_row, last_row) of the columns col_indexes of file idx
+  Result<std::shared_ptr<arrow::Table>> ReadColumns(
+      size_t idx, const std::vector<int32_t>& col_indexes, int64_t first_row,
+      int64_t last_row) {
+    KATANA_CHECKED(EnsureReader(idx, false));
+    parquet::arrow::FileReader* reader = readers_[idx].get();
+
+    std::shared_ptr<arrow::Schema> schema;
+    KATANA_CHECKED(reader->GetSchema(&schema));
+
+    int64_t num_rows = reader->parquet_reader()->metadata()->num_rows();
+    bool whole_file = first_row == 0 && last_row >= num_rows;
+    RowGroupSelection selection;
+    if (!whole_file && first_row < last_row) {
+      selection = SelectRowGroups(reader, first_row, last_row);
+      KATANA_CHECKED(
+          fvs_[idx]->Fill(selection.file_begin, selection.file_end, false));
+    }
+
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    std::unordered_map<int32_t, std::shared_ptr<arrow::ChunkedArray>>
+        read_arrays;
+
+    for (int32_t col_idx : col_indexes) {
+      if (col_idx < 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "column indexes must be positive");
+      }
+      if (col_idx >= schema->num_fields()) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "column index {} should be less than the number of columns {}",
+            col_idx, schema->num_fields());
+      }
+      std::shared_ptr<arrow::ChunkedArray> column;
+      if (auto arr_it = read_arrays.find(col_idx);
+          arr_it != read_arrays.end()) {
+        column = arr_it->second;
+      } else if (whole_file) {
+        KATANA_CHECKED(reader->ReadColumn(col_idx, &column));
+        read_arrays.emplace(col_idx, column);
+      } else {
+        column = KATANA_CHECKED(ReadColumnSlice(
+                                    reader, selection, col_idx,
+                                    schema->field(col_idx)->type()))
+                     ->Slice(selection.row_offset, last_row - first_row);
+        read_arrays.emplace(col_idx, column);
+      }
+      fields.emplace_back(schema->field(col_idx));
+      columns.emplace_back(std::move(column));
+    }
+    return arrow::Table::Make(arrow::schema(fields), columns);
+  }
+
   std::string prefix_;
+  ReaderConfig config_;
   std::vector<std::shared_ptr<katana::FileView>> fvs_;
   std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers_;
   std::vector<int64_t> row_offsets_;
 };
 
+/// Finish the span of a read with the shape and the size in memory of the
+/// table it read
+katana::Result<std::shared_ptr<arrow::Table>>
+FinishRead(
+    katana::OperationSpan* span,
+    katana::Result<std::shared_ptr<arrow::Table>>&& table) {
+  if (!table) {
+    span->SetError(fmt::format("{}", table.error()));
+  } else if (span->enabled()) {
+    span->SetTags(
+        {{"rows", table.value()->num_rows()},
+         {"columns", table.value()->num_columns()}});
+    span->Finish(katana::ApproxTableMemUse(table.value()));
+  }
+  return std::move(table);
+}
+
 }  // namespace
 
+class katana::ParquetReader::RowGroupTable::Impl {
+public:
+  Impl(
+      const ParquetReader& reader_arg,
+      std::unique_ptr<BlockedParquetReader>&& bpr_arg)
+      : reader(reader_arg), bpr(std::move(bpr_arg)) {}
+
+  // used to make the row groups read canonical
+  ParquetReader reader;
+  std::unique_ptr<BlockedParquetReader> bpr;
+  std::vector<int64_t> offsets;
+  std::vector<std::pair<size_t, int>> locations;
+  std::shared_ptr<arrow::Schema> schema;
+};
+
+katana::ParquetReader::RowGroupTable::RowGroupTable(
+    std::unique_ptr<Impl>&& impl)
+    : impl_(std::move(impl)) {}
+
+katana::ParquetReader::RowGroupTable::~RowGroupTable() = default;
+
+const std::vector<int64_t>&
+katana::ParquetReader::RowGroupTable::row_group_offsets() const {
+  return impl_->offsets;
+}
+
+const std::shared_ptr<arrow::Schema>&
+katana::ParquetReader::RowGroupTable::schema() const {
+  return impl_->schema;
+}
+
+Result<std::shared_ptr<arrow::Table>>
+katana::ParquetReader::RowGroupTable::ReadRowGroup(size_t row_group) {
+  if (row_group >= impl_->locations.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "row group {} should be less than the number of row groups {}",
+        row_group, impl_->locations.size());
+  }
+  auto [idx, rg] = impl_->locations[row_group];
+  return impl_->reader.FixTable(
+      KATANA_CHECKED(impl_->bpr->ReadRowGroup(idx, rg)));
+}
+
 Result<std::unique_ptr<katana::ParquetReader>>
 katana::ParquetReader::Make(ReadOpts opts) {
-  return std::unique_ptr<ParquetReader>(new ParquetReader(opts.make_canonical));
+  std::shared_ptr<arrow::internal::ThreadPool> io_pool;
+  if (opts.io_threads < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "io_threads must be non-negative");
+  }
+  if (opts.parallel && opts.io_threads > 0) {
+    io_pool =
+        KATANA_CHECKED(arrow::internal::ThreadPool::Make(opts.io_threads));
+  }
+  return std::unique_ptr<ParquetReader>(
+      new ParquetReader(opts, std::move(io_pool)));
 }
 
 Result<std::shared_ptr<arrow::Table>>
@@ -377,8 +1025,54 @@ katana::ParquetReader::ReadTable(
     preload = false;
   }
 
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, preload));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable(slice)));
+  katana::OperationSpan span("read parquet table", {{"uri", uri.string()}});
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(
+      uri, preload, ReaderConfig{parallel_, io_pool_.get()}));
+  return FinishRead(&span, FixTable(KATANA_CHECKED(bpr->ReadTable(slice))));
+}
+
+Result<std::vector<katana::ParquetReader::Slice>>
+katana::ParquetReader::FindMatchingRows(
+    const katana::Uri& uri, const std::vector<ColumnFilter>& filters,
+    std::optional<katana::ParquetReader::Slice> slice) {
+  if (slice && (slice->offset < 0 || slice->length < 0)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "slice offset and length must be non-negative");
+  }
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  int64_t first_row = 0;
+  int64_t last_row = KATANA_CHECKED(bpr->NumRows());
+  if (slice) {
+    last_row = std::min(last_row, slice->offset + slice->length);
+    first_row = std::min(slice->offset, last_row);
+  }
+  return bpr->FindMatchingRows(filters, first_row, last_row);
+}
+
+Result<std::shared_ptr<arrow::Table>>
+katana::ParquetReader::ReadRows(
+    const katana::Uri& uri, const std::vector<Slice>& ranges, Slice slice) {
+  if (slice.offset < 0 || slice.length < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "slice offset and length must be non-negative");
+  }
+  katana::OperationSpan span("read parquet rows", {{"uri", uri.string()}});
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(
+      uri, false, ReaderConfig{parallel_, io_pool_.get()}));
+  return FinishRead(
+      &span, FixTable(KATANA_CHECKED(bpr->ReadRows(ranges, slice))));
+}
+
+Result<std::unique_ptr<katana::ParquetReader::RowGroupTable>>
+katana::ParquetReader::OpenRowGroups(const katana::Uri& uri) {
+  auto impl = std::make_unique<RowGroupTable::Impl>(
+      *this, KATANA_CHECKED(BlockedParquetReader::Make(uri, false)));
+  KATANA_CHECKED(impl->bpr->RowGroupLayout(&impl->offsets, &impl->locations));
+  impl->schema = KATANA_CHECKED(
+      FixSchema(KATANA_CHECKED(impl->bpr->ReadArrowSchema())));
+  return std::unique_ptr<RowGroupTable>(new RowGroupTable(std::move(impl)));
 }
 
 katana::Result<std::shared_ptr<arrow::Schema>>
@@ -388,17 +1082,29 @@ katana::ParquetReader::GetSchema(const katana::Uri& uri) {
 }
 
 Result<std::shared_ptr<arrow::Table>>
-katana::ParquetReader::ReadColumn(const katana::Uri& uri, int32_t column_idx) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx})));
+katana::ParquetReader::ReadColumn(
+    const katana::Uri& uri, int32_t column_idx,
+    std::optional<katana::ParquetReader::Slice> slice) {
+  return ReadTable(uri, std::vector<int32_t>{column_idx}, slice);
 }
 
 Result<std::shared_ptr<arrow::Table>>
 katana::ParquetReader::ReadTable(
     const katana::Uri& uri, const std::vector<int32_t>& column_indexes,
     std::optional<katana::ParquetReader::Slice> slice) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes, slice)));
+  if (slice && (slice->offset < 0 || slice->length < 0)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "slice offset and length must be non-negative");
+  }
+  katana::OperationSpan span(
+      "read parquet columns",
+      {{"uri", uri.string()},
+       {"num_columns", static_cast<uint64_t>(column_indexes.size())}});
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(
+      uri, false, ReaderConfig{parallel_, io_pool_.get()}));
+  return FinishRead(
+      &span, FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes, slice))));
 }
 
 Result<int32_t>
@@ -466,7 +1172,11 @@ katana::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   // combined into a single chunk due to the fact the offset type for these
   // columns is int32_t and thus the maximum size of an arrow::Array for these
   // types is 2^31.
-  table = KATANA_CHECKED(table->CombineChunks(arrow::default_memory_pool()));
+  if (combine_chunks_) {
+    table = KATANA_CHECKED(table->CombineChunks(arrow::default_memory_pool()));
+  } else {
+    table = KATANA_CHECKED(CombineUnviewedChunks(table));
+  }
 
   // lots of the code base assumes chunks will exist, but arrow allows zero length
   // chunked arrays to have zero chunks. Let's be helpful.
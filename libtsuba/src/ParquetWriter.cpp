@@ -1,5 +1,11 @@
 #include "katana/ParquetWriter.h"
 
+#include <cstdio>
+
+#include <arrow/io/file.h>
+#include <arrow/util/compression.h>
+#include <parquet/arrow/writer.h>
+
 #include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/FaultTest.h"
@@ -58,9 +64,42 @@ BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   return blocks;
 }
 
+Result<void>
+ValidateCompression(
+    arrow::Compression::type compression, std::optional<int> level) {
+  if (!arrow::util::Codec::IsAvailable(compression)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "compression {} is not available in this build",
+        arrow::util::Codec::GetCodecAsString(compression));
+  }
+  if (!level) {
+    return katana::ResultSuccess();
+  }
+  if (!arrow::util::Codec::SupportsCompressionLevel(compression)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "compression {} does not take a compression level",
+        arrow::util::Codec::GetCodecAsString(compression));
+  }
+  int min_level = KATANA_CHECKED(
+      arrow::util::Codec::MinimumCompressionLevel(compression));
+  int max_level = KATANA_CHECKED(
+      arrow::util::Codec::MaximumCompressionLevel(compression));
+  if (*level < min_level || *level > max_level) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "compression level {} of {} is not in [{}, {}]", *level,
+        arrow::util::Codec::GetCodecAsString(compression), min_level,
+        max_level);
+  }
+  return katana::ResultSuccess();
+}
+
 Result<void>
 DoStoreParquet(
     const std::string& path, std::shared_ptr<arrow::Table> table,
+    int64_t max_row_group_length,
     const std::shared_ptr<parquet::WriterProperties>& writer_props,
     const std::shared_ptr<parquet::ArrowWriterProperties>& arrow_props,
     katana::WriteGroup* desc) {
@@ -68,38 +107,53 @@ DoStoreParquet(
   KATANA_CHECKED(ff->Init());
   ff->Bind(path);
 
-  auto future = std::async(
-      std::launch::async,
-      [table = std::move(table), ff = std::move(ff), desc, writer_props,
-       arrow_props]() mutable -> katana::CopyableResult<void> {
-        auto write_result = parquet::arrow::WriteTable(
-            *table, arrow::default_memory_pool(), ff,
-            std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
-        table.reset();
-
-        if (!write_result.ok()) {
-          return KATANA_ERROR(
-              katana::ErrorCode::ArrowError, "arrow error: {}", write_result);
-        }
-        if (desc) {
-          desc->AddToOutstanding(ff->map_size());
-        }
-
-        TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
-        KATANA_CHECKED(ff->Persist());
-
-        return katana::CopyableResultSuccess();
-      });
+  // encoding holds about as much memory as the table takes, so that is what
+  // is accounted for until the file is persisted
+  uint64_t accounted_size = katana::ApproxTableMemUse(table);
+  auto store = [table = std::move(table), ff = std::move(ff),
+                max_row_group_length, writer_props,
+                arrow_props]() mutable -> katana::CopyableResult<void> {
+    auto write_result = parquet::arrow::WriteTable(
+        *table, arrow::default_memory_pool(), ff, max_row_group_length,
+        writer_props, arrow_props);
+    table.reset();
+
+    if (!write_result.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "arrow error: {}", write_result);
+    }
+
+    TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::CopyableResultSuccess();
+  };
 
   if (!desc) {
-    KATANA_CHECKED(future.get());
+    KATANA_CHECKED(store());
     return katana::ResultSuccess();
   }
 
-  desc->AddOp(std::move(future), path);
+  desc->StartOp(std::move(store), path, accounted_size);
   return katana::ResultSuccess();
 }
 
+bool
+HasVariableWidthColumn(const arrow::Table& table) {
+  for (const auto& field : table.schema()->fields()) {
+    switch (field->type()->id()) {
+    case arrow::Type::BINARY:
+    case arrow::Type::STRING:
+    case arrow::Type::LARGE_BINARY:
+    case arrow::Type::LARGE_STRING:
+      return true;
+    default:
+      break;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 Result<std::unique_ptr<katana::ParquetWriter>>
@@ -112,15 +166,35 @@ katana::ParquetWriter::Make(
       opts);
 }
 
+Result<void>
+katana::ParquetWriter::ValidateOpts(const WriteOpts& opts) {
+  if (opts.max_row_group_length <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "max_row_group_length must be positive");
+  }
+  KATANA_CHECKED(ValidateCompression(opts.compression, opts.compression_level));
+  for (const auto& [name, column_opts] : opts.column_opts) {
+    KATANA_CHECKED_CONTEXT(
+        ValidateCompression(
+            column_opts.compression.value_or(opts.compression),
+            column_opts.compression_level ? column_opts.compression_level
+                                          : opts.compression_level),
+        "column {}", name);
+  }
+  return katana::ResultSuccess();
+}
+
 Result<std::unique_ptr<katana::ParquetWriter>>
 katana::ParquetWriter::Make(
     std::shared_ptr<arrow::Table> table, WriteOpts opts) {
+  KATANA_CHECKED(ValidateOpts(opts));
   if (!opts.write_blocked) {
     return std::unique_ptr<ParquetWriter>(
-        new ParquetWriter({std::move(table)}, opts));
+        new ParquetWriter({std::move(table)}, std::move(opts)));
   }
-  return std::unique_ptr<ParquetWriter>(new ParquetWriter(
-      BlockTable(std::move(table), opts.mbs_per_block), opts));
+  auto blocks = BlockTable(std::move(table), opts.mbs_per_block);
+  return std::unique_ptr<ParquetWriter>(
+      new ParquetWriter(std::move(blocks), std::move(opts)));
 }
 
 katana::Result<void>
@@ -135,15 +209,52 @@ katana::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
 
 std::shared_ptr<parquet::WriterProperties>
 katana::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
+  parquet::WriterProperties::Builder builder;
+  builder.version(opts_.parquet_version)
       ->data_page_version(opts_.data_page_version)
-      ->build();
+      ->max_row_group_length(opts_.max_row_group_length)
+      ->compression(opts_.compression);
+  if (opts_.compression_level) {
+    builder.compression_level(*opts_.compression_level);
+  }
+  if (opts_.dictionary) {
+    builder.enable_dictionary();
+  } else {
+    builder.disable_dictionary();
+  }
+
+  // columns of our tables are never nested, so a column's path is its name
+  for (const auto& [name, column_opts] : opts_.column_opts) {
+    if (column_opts.compression) {
+      builder.compression(name, *column_opts.compression);
+    }
+    if (column_opts.compression_level) {
+      builder.compression_level(name, *column_opts.compression_level);
+    }
+    if (column_opts.dictionary) {
+      if (*column_opts.dictionary) {
+        builder.enable_dictionary(name);
+      } else {
+        builder.disable_dictionary(name);
+      }
+    }
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
-katana::ParquetWriter::StandardArrowProperties() {
-  return parquet::ArrowWriterProperties::Builder().build();
+katana::ParquetWriter::StandardArrowProperties(const arrow::Schema& schema) {
+  parquet::ArrowWriterProperties::Builder builder;
+  // parquet has no dictionary type; arrow reads a column back as dictionary
+  // encoded, without decoding its dictionary pages, only if the arrow schema
+  // is stored in the file
+  for (const auto& field : schema.fields()) {
+    if (field->type()->id() == arrow::Type::DICTIONARY) {
+      builder.store_schema();
+      break;
+    }
+  }
+  return builder.build();
 }
 
 /// Store the arrow table in a file
@@ -152,11 +263,26 @@ katana::ParquetWriter::StoreParquet(
     std::shared_ptr<arrow::Table> table, const katana::Uri& uri,
     katana::WriteGroup* desc) {
   auto writer_props = StandardWriterProperties();
-  auto arrow_props = StandardArrowProperties();
+  auto arrow_props = StandardArrowProperties(*table->schema());
   std::string prefix = uri.string();
 
-  if (table->num_rows() <= kMaxRowsPerFile) {
-    return DoStoreParquet(prefix, table, writer_props, arrow_props, desc);
+  // large string columns take long to encode, so they are split into part
+  // files that are encoded in parallel
+  int64_t rows_per_part = kMaxRowsPerFile;
+  if (opts_.mbs_per_part > 0 && HasVariableWidthColumn(*table)) {
+    uint64_t size = katana::ApproxTableMemUse(table);
+    uint64_t part_size = opts_.mbs_per_part * kMB;
+    int64_t num_parts = (size + part_size - 1) / part_size;
+    if (num_parts > 1) {
+      rows_per_part = std::min(
+          rows_per_part, (table->num_rows() + num_parts - 1) / num_parts);
+    }
+  }
+
+  if (table->num_rows() <= rows_per_part) {
+    return DoStoreParquet(
+        prefix, table, opts_.max_row_group_length, writer_props, arrow_props,
+        desc);
   }
 
   std::vector<std::shared_ptr<arrow::Table>> tables;
@@ -169,17 +295,27 @@ katana::ParquetWriter::StoreParquet(
   // read. To make sure we don't end up in that situation, slice the table here
   // into groups of rows that are definitely smaller than the element limit
   for (int64_t i = 0, total_rows = table->num_rows(); i < total_rows;
-       i += kMaxRowsPerFile) {
+       i += rows_per_part) {
     table_offsets.emplace_back(i);
-    tables.emplace_back(table->Slice(i, kMaxRowsPerFile));
+    tables.emplace_back(table->Slice(i, rows_per_part));
   }
   table.reset();
 
+  // the parts are only encoded in parallel as ops of a write group
+  std::unique_ptr<katana::WriteGroup> our_desc;
+  if (!desc) {
+    our_desc = KATANA_CHECKED(WriteGroup::Make());
+    desc = our_desc.get();
+  }
   uint32_t table_count = 0;
   for (const auto& t : tables) {
     KATANA_CHECKED(DoStoreParquet(
-        fmt::format("{}.part_{:09}", prefix, table_count++), t, writer_props,
-        arrow_props, desc));
+        fmt::format("{}.part_{:09}", prefix, table_count++), t,
+        opts_.max_row_group_length, writer_props, arrow_props, desc));
+  }
+  tables.clear();
+  if (our_desc) {
+    KATANA_CHECKED(our_desc->Finish());
   }
   return FileStore(
       uri.string(), KATANA_CHECKED(katana::JsonDump(table_offsets)));
@@ -217,3 +353,150 @@ katana::ParquetWriter::StoreParquet(
   }
   return ret;
 }
+
+class katana::ParquetWriter::Stream::Impl {
+public:
+  std::string path;
+  std::shared_ptr<arrow::Schema> schema;
+  WriteOpts opts;
+  std::shared_ptr<parquet::WriterProperties> writer_props;
+  std::shared_ptr<parquet::ArrowWriterProperties> arrow_props;
+
+  std::shared_ptr<arrow::io::FileOutputStream> sink;
+  std::unique_ptr<parquet::arrow::FileWriter> writer;
+  // the first row of each part file
+  std::vector<int64_t> part_offsets;
+  int64_t num_rows{0};
+  bool finished{false};
+
+  std::string PartPath(size_t part) const {
+    return fmt::format("{}.part_{:09}", path, part);
+  }
+};
+
+katana::ParquetWriter::Stream::Stream(std::unique_ptr<Impl>&& impl)
+    : impl_(std::move(impl)) {}
+
+katana::ParquetWriter::Stream::~Stream() {
+  if (impl_->writer && !impl_->finished) {
+    if (auto res = ClosePart(); !res) {
+      KATANA_LOG_ERROR("closing unfinished stream: {}", res.error());
+    }
+  }
+}
+
+Result<std::unique_ptr<katana::ParquetWriter::Stream>>
+katana::ParquetWriter::Stream::Make(
+    const std::string& path, std::shared_ptr<arrow::Schema> schema,
+    WriteOpts opts) {
+  KATANA_CHECKED(ValidateOpts(opts));
+
+  auto impl = std::make_unique<Impl>();
+  impl->path = path;
+  impl->schema = std::move(schema);
+  // blocking is for parallel writes of whole tables, a stream writes one file
+  opts.write_blocked = false;
+  ParquetWriter props_source({}, opts);
+  impl->writer_props = props_source.StandardWriterProperties();
+  impl->arrow_props = props_source.StandardArrowProperties(*impl->schema);
+  impl->opts = std::move(opts);
+
+  // new to access non-public constructor
+  std::unique_ptr<Stream> stream(new Stream(std::move(impl)));
+  KATANA_CHECKED(stream->OpenPart());
+  return stream;
+}
+
+katana::Result<void>
+katana::ParquetWriter::Stream::OpenPart() {
+  impl_->part_offsets.emplace_back(impl_->num_rows);
+  std::string part_path = impl_->PartPath(impl_->part_offsets.size() - 1);
+  impl_->sink = KATANA_CHECKED_CONTEXT(
+      arrow::io::FileOutputStream::Open(part_path), "opening {}", part_path);
+  KATANA_CHECKED_CONTEXT(
+      parquet::arrow::FileWriter::Open(
+          *impl_->schema, arrow::default_memory_pool(), impl_->sink,
+          impl_->writer_props, impl_->arrow_props, &impl_->writer),
+      "opening {}", part_path);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::ParquetWriter::Stream::ClosePart() {
+  KATANA_CHECKED(impl_->writer->Close());
+  impl_->writer.reset();
+  KATANA_CHECKED(impl_->sink->Close());
+  impl_->sink.reset();
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::ParquetWriter::Stream::Append(
+    const std::shared_ptr<arrow::Table>& batch) {
+  if (impl_->finished) {
+    return KATANA_ERROR(
+        ErrorCode::AssertionFailed, "append to a finished stream");
+  }
+  if (!batch->schema()->Equals(*impl_->schema, /*check_metadata=*/false)) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "batch schema {} does not match stream schema {}",
+        batch->schema()->ToString(), impl_->schema->ToString());
+  }
+
+  // as in StoreParquet, no file may hold more than kMaxRowsPerFile rows
+  for (int64_t row = 0, num_rows = batch->num_rows(); row < num_rows;) {
+    int64_t part_rows = impl_->num_rows - impl_->part_offsets.back();
+    if (part_rows == kMaxRowsPerFile) {
+      KATANA_CHECKED(ClosePart());
+      KATANA_CHECKED(OpenPart());
+      part_rows = 0;
+    }
+    int64_t length = std::min(num_rows - row, kMaxRowsPerFile - part_rows);
+    try {
+      KATANA_CHECKED(impl_->writer->WriteTable(
+          *batch->Slice(row, length), impl_->opts.max_row_group_length));
+    } catch (const std::exception& exp) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+    }
+    row += length;
+    impl_->num_rows += length;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<std::string>>
+katana::ParquetWriter::Stream::Finish() {
+  if (impl_->finished) {
+    return KATANA_ERROR(ErrorCode::AssertionFailed, "stream already finished");
+  }
+  impl_->finished = true;
+  KATANA_CHECKED(ClosePart());
+
+  if (impl_->part_offsets.size() == 1) {
+    std::string part_path = impl_->PartPath(0);
+    if (std::rename(part_path.c_str(), impl_->path.c_str()) != 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "renaming {} to {}", part_path, impl_->path);
+    }
+    return std::vector<std::string>{impl_->path};
+  }
+
+  KATANA_CHECKED(FileStore(
+      impl_->path, KATANA_CHECKED(katana::JsonDump(impl_->part_offsets))));
+  std::vector<std::string> files{impl_->path};
+  for (size_t i = 0, n = impl_->part_offsets.size(); i < n; ++i) {
+    files.emplace_back(impl_->PartPath(i));
+  }
+  return files;
+}
+
+const std::shared_ptr<arrow::Schema>&
+katana::ParquetWriter::Stream::schema() const {
+  return impl_->schema;
+}
+
+int64_t
+katana::ParquetWriter::Stream::num_rows() const {
+  return impl_->num_rows;
+}
@@ -31,6 +31,8 @@ public:
   uint64_t edge_condensed_type_id_map_size_{0};
   bool node_condensed_type_id_map_present_{false};
   uint64_t node_condensed_type_id_map_size_{0};
+  /// only meaningful for TopologyKind::kCompressedTopology
+  uint64_t compressed_dests_size_{0};
   katana::RDGTopology::TopologyKind topology_state_{-1};
   katana::RDGTopology::TransposeKind transpose_state_{-1};
   katana::RDGTopology::EdgeSortKind edge_sort_state_{-1};
@@ -3,6 +3,8 @@
 #include <cassert>
 #include <exception>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -33,9 +35,11 @@
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/ParquetWriter.h"
+#include "katana/ProgressTracer.h"
 #include "katana/RDGTopology.h"
 #include "katana/ReadGroup.h"
 #include "katana/Result.h"
+#include "katana/Time.h"
 #include "katana/URI.h"
 #include "katana/WriteGroup.h"
 #include "katana/file.h"
@@ -48,9 +52,11 @@ namespace {
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
-    const std::string& name, katana::WriteGroup* desc) {
+    const std::string& name, katana::WriteGroup* desc,
+    const katana::ParquetWriter::WriteOpts& opts =
+        katana::ParquetWriter::WriteOpts::Defaults()) {
   std::unique_ptr<katana::ParquetWriter> writer =
-      KATANA_CHECKED(katana::ParquetWriter::Make(array, name));
+      KATANA_CHECKED(katana::ParquetWriter::Make(array, name, opts));
 
   katana::Uri new_path = dir.RandFile(name);
   KATANA_CHECKED_CONTEXT(
@@ -61,7 +67,8 @@ StoreArrowArrayAtName(
 katana::Result<void>
 WriteProperties(
     const arrow::Table& props, std::vector<katana::PropStorageInfo*> prop_info,
-    const katana::Uri& dir, katana::WriteGroup* desc) {
+    const katana::Uri& dir, katana::WriteGroup* desc,
+    const katana::ParquetWriter::WriteOpts& opts) {
   const auto& schema = props.schema();
 
   std::vector<std::string> next_paths;
@@ -71,8 +78,8 @@ WriteProperties(
     }
     std::string name = prop_info[i]->name().empty() ? schema->field(i)->name()
                                                     : prop_info[i]->name();
-    std::string path =
-        KATANA_CHECKED(StoreArrowArrayAtName(props.column(i), dir, name, desc));
+    std::string path = KATANA_CHECKED(
+        StoreArrowArrayAtName(props.column(i), dir, name, desc, opts));
 
     prop_info[i]->WasWritten(path);
   }
@@ -123,6 +130,37 @@ CommitRDG(
   return ret;
 }
 
+/// Run one stage of loading an RDG concurrently with the others in grp, and
+/// report how long it took once grp finishes
+void
+AddLoadStage(
+    katana::ReadGroup* grp, const std::string& stage, const std::string& path,
+    std::function<katana::Result<void>()> fn) {
+  auto us = std::make_shared<uint64_t>(0);
+  std::future<katana::CopyableResult<void>> future = std::async(
+      std::launch::async,
+      [fn = std::move(fn), us, path]() -> katana::CopyableResult<void> {
+        katana::TimePoint start = katana::Now();
+        auto res = fn();
+        *us = katana::UsSince(start);
+        if (!res) {
+          return res.error().WithContext("loading {}", path);
+        }
+        return katana::CopyableResultSuccess();
+      });
+  grp->AddOp(
+      std::move(future), path,
+      [stage, path, us]() -> katana::CopyableResult<void> {
+        katana::GetTracer().GetActiveSpan().Log(
+            "rdg load stage", {
+                                  {"stage", stage},
+                                  {"path", path},
+                                  {"us", *us},
+                              });
+        return katana::CopyableResultSuccess();
+      });
+}
+
 }  // namespace
 
 void
@@ -139,6 +177,12 @@ katana::RDGFile::~RDGFile() {
 
 katana::Result<std::vector<katana::PropStorageInfo>>
 katana::RDG::WritePartArrays(const katana::Uri& dir, katana::WriteGroup* desc) {
+  if (!core_->part_arrays_dirty()) {
+    // the files already in dir hold these arrays; when dir is new they were
+    // copied there by RDGPartHeader::ChangeStorageLocation
+    return core_->part_header().part_prop_info_list();
+  }
+
   std::vector<katana::PropStorageInfo> next_properties;
 
   KATANA_LOG_DEBUG(
@@ -212,8 +256,13 @@ katana::Result<void>
 katana::RDG::DoStoreNodeEntityTypeIDArray(
     RDGHandle handle, std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
     std::unique_ptr<WriteGroup>& write_group) {
-  if (!node_entity_type_id_array_ff &&
-      !node_entity_type_id_array_file_storage().Valid()) {
+  // without an update, the array must either be in storage already or be
+  // bound so that it can be copied to a new location
+  std::string stored_path =
+      core_->part_header().node_entity_type_id_array_path();
+  if (!node_entity_type_id_array_ff && stored_path.empty() &&
+      (handle.impl_->rdg_manifest().dir() == rdg_dir() ||
+       !node_entity_type_id_array_file_storage().Valid())) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument,
         "no node_entity_type_id_array file frame update, but "
@@ -229,6 +278,14 @@ katana::RDG::DoStoreNodeEntityTypeIDArray(
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     core_->part_header().set_node_entity_type_id_array_path(
         path_uri.BaseName());
+  } else if (
+      handle.impl_->rdg_manifest().dir() != rdg_dir() && !stored_path.empty()) {
+    KATANA_LOG_DEBUG("copying node_entity_type_id_array to new location");
+    // we don't have an update, and the file in storage holds the array, so
+    // have the storage copy it to the new location under the same name
+    write_group->StartCopy(
+        rdg_dir().Join(stored_path).string(),
+        handle.impl_->rdg_manifest().dir().Join(stored_path).string());
   } else if (handle.impl_->rdg_manifest().dir() != rdg_dir()) {
     KATANA_LOG_DEBUG("persisting node_entity_type_id_array in new location");
     // we don't have an update, but we are persisting in a new location
@@ -260,8 +317,13 @@ katana::Result<void>
 katana::RDG::DoStoreEdgeEntityTypeIDArray(
     RDGHandle handle, std::unique_ptr<FileFrame> edge_entity_type_id_array_ff,
     std::unique_ptr<WriteGroup>& write_group) {
-  if (!edge_entity_type_id_array_ff &&
-      !edge_entity_type_id_array_file_storage().Valid()) {
+  // without an update, the array must either be in storage already or be
+  // bound so that it can be copied to a new location
+  std::string stored_path =
+      core_->part_header().edge_entity_type_id_array_path();
+  if (!edge_entity_type_id_array_ff && stored_path.empty() &&
+      (handle.impl_->rdg_manifest().dir() == rdg_dir() ||
+       !edge_entity_type_id_array_file_storage().Valid())) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument,
         "no edge_entity_type_id_array file frame update, but "
@@ -277,6 +339,14 @@ katana::RDG::DoStoreEdgeEntityTypeIDArray(
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     core_->part_header().set_edge_entity_type_id_array_path(
         path_uri.BaseName());
+  } else if (
+      handle.impl_->rdg_manifest().dir() != rdg_dir() && !stored_path.empty()) {
+    KATANA_LOG_DEBUG("copying edge_entity_type_id_array to new location");
+    // we don't have an update, and the file in storage holds the array, so
+    // have the storage copy it to the new location under the same name
+    write_group->StartCopy(
+        rdg_dir().Join(stored_path).string(),
+        handle.impl_->rdg_manifest().dir().Join(stored_path).string());
   } else if (handle.impl_->rdg_manifest().dir() != rdg_dir()) {
     KATANA_LOG_DEBUG("persisting edge_entity_type_id_array in new location");
     // we don't have an update, but we are persisting in a new location
@@ -327,7 +397,7 @@ katana::RDG::DoStore(
   // writing node properties
   KATANA_CHECKED(WriteProperties(
       *core_->node_properties(), node_props_to_store,
-      handle.impl_->rdg_manifest().dir(), write_group.get()));
+      handle.impl_->rdg_manifest().dir(), write_group.get(), write_opts_));
 
   std::vector<std::string> edge_prop_names;
   for (const auto& field : core_->edge_properties()->fields()) {
@@ -340,7 +410,7 @@ katana::RDG::DoStore(
   // writing edge properties
   KATANA_CHECKED(WriteProperties(
       *core_->edge_properties(), edge_props_to_store,
-      handle.impl_->rdg_manifest().dir(), write_group.get()));
+      handle.impl_->rdg_manifest().dir(), write_group.get(), write_opts_));
 
   // writing partition metadata
   core_->part_header().set_part_prop_info_list(KATANA_CHECKED(
@@ -363,6 +433,13 @@ katana::RDG::DoStore(
       handle, core_->part_header().metadata().policy_id_,
       core_->part_header().metadata().transposed_, versioning_action,
       core_->lineage(), std::move(write_group)));
+
+  // everything the part header refers to is now in the handle's directory,
+  // so the next store only has to write what changes until then. Topologies
+  // bound to be copied to this directory are no longer needed.
+  core_->set_rdg_dir(handle.impl_->rdg_manifest().dir());
+  core_->set_part_arrays_dirty(false);
+  KATANA_CHECKED(core_->UnbindAllTopologyFile());
   return katana::ResultSuccess();
 }
 
@@ -391,7 +468,8 @@ katana::RDG::DoMake(
         }
         rdg->core_->set_node_properties(std::move(prop_table));
         return katana::ResultSuccess();
-      }));
+      },
+      share_loaded_files_));
 
   // populating edge properties
   KATANA_CHECKED(AddProperties(
@@ -411,7 +489,8 @@ katana::RDG::DoMake(
         }
         rdg->core_->set_edge_properties(std::move(prop_table));
         return katana::ResultSuccess();
-      }));
+      },
+      share_loaded_files_));
 
   // populating topologies
   KATANA_CHECKED(core_->MakeTopologyManager(metadata_dir));
@@ -423,37 +502,62 @@ katana::RDG::DoMake(
       "unable to find csr topology, must have csr topology");
   KATANA_LOG_VASSERT(csr != nullptr, "csr topology is null");
 
+  // the remaining files are independent of each other and of the properties
+  // queued above, so fetch them all at once rather than one after another
+  if (prefetch_topology_) {
+    AddLoadStage(
+        &grp, "topology", metadata_dir.Join(csr->path()).string(),
+        [rdg = this, csr, metadata_dir]() -> katana::Result<void> {
+          if (rdg->map_topology_in_place_) {
+            return csr->BindInPlace(metadata_dir, rdg->topology_map_advice_);
+          }
+          return csr->Bind(metadata_dir);
+        });
+  }
+
   if (core_->part_header().IsEntityTypeIDsOutsideProperties()) {
     katana::Uri node_entity_type_id_array_path = metadata_dir.Join(
         core_->part_header().node_entity_type_id_array_path());
-    KATANA_CHECKED(core_->node_entity_type_id_array_file_storage().Bind(
-        node_entity_type_id_array_path.string(), true));
+    AddLoadStage(
+        &grp, "node entity type ids", node_entity_type_id_array_path.string(),
+        [rdg = this, path = node_entity_type_id_array_path.string()]() {
+          return rdg->core_->node_entity_type_id_array_file_storage().Bind(
+              path, true);
+        });
 
     katana::Uri edge_entity_type_id_array_path = metadata_dir.Join(
         core_->part_header().edge_entity_type_id_array_path());
-    KATANA_CHECKED(core_->edge_entity_type_id_array_file_storage().Bind(
-        edge_entity_type_id_array_path.string(), true));
+    AddLoadStage(
+        &grp, "edge entity type ids", edge_entity_type_id_array_path.string(),
+        [rdg = this, path = edge_entity_type_id_array_path.string()]() {
+          return rdg->core_->edge_entity_type_id_array_file_storage().Bind(
+              path, true);
+        });
   }
   core_->set_rdg_dir(metadata_dir);
 
   std::vector<PropStorageInfo*> part_info =
       KATANA_CHECKED(core_->part_header().SelectPartitionProperties());
 
-  // these are not Node/Edge types but rather property types we are checking
+  // populating partition metadata
+  if (!part_info.empty()) {
+    KATANA_CHECKED(AddProperties(
+        metadata_dir, false /*is_property*/, part_info, &grp,
+        [rdg = this](const std::shared_ptr<arrow::Table>& props) {
+          return rdg->core_->AddPartitionMetadataArray(props);
+        }));
+  }
+  KATANA_CHECKED(grp.Finish());
+
+  // these are not Node/Edge types but rather property types we are checking;
+  // properties loaded above already know theirs
   KATANA_CHECKED(core_->EnsureNodeTypesLoaded());
   KATANA_CHECKED(core_->EnsureEdgeTypesLoaded());
 
   if (part_info.empty()) {
-    return grp.Finish();
+    return katana::ResultSuccess();
   }
-
-  // populating partition metadata
-  KATANA_CHECKED(AddProperties(
-      metadata_dir, false /*is_property*/, part_info, &grp,
-      [rdg = this](const std::shared_ptr<arrow::Table>& props) {
-        return rdg->core_->AddPartitionMetadataArray(props);
-      }));
-  KATANA_CHECKED(grp.Finish());
+  core_->set_part_arrays_dirty(false);
 
   if (local_to_user_id()->length() == 0) {
     // for backward compatibility
@@ -514,6 +618,11 @@ katana::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
   // needs a valid rdg_dir
   rdg.set_rdg_dir(manifest.dir());
   KATANA_LOG_ASSERT(!manifest.dir().empty());
+  rdg.map_topology_in_place_ = opts.map_topology_in_place;
+  rdg.topology_map_advice_ = opts.topology_map_advice;
+  rdg.prefetch_topology_ = opts.prefetch_topology;
+  rdg.share_loaded_files_ = opts.share_loaded_files;
+  rdg.trusted_load_ = opts.trusted_load;
 
   std::vector<PropStorageInfo*> node_props = KATANA_CHECKED(
       rdg.core_->part_header().SelectNodeProperties(opts.node_properties));
@@ -665,7 +774,7 @@ katana::Result<std::shared_ptr<arrow::Table>>
 UnloadProperty(
     const std::shared_ptr<arrow::Table>& props, int i,
     std::vector<katana::PropStorageInfo>* prop_info_list,
-    const katana::Uri& dir) {
+    const katana::Uri& dir, const katana::ParquetWriter::WriteOpts& opts) {
   if (i < 0 || i > props->num_columns()) {
     return KATANA_ERROR(
         katana::ErrorCode::InvalidArgument, "property index out of bounds");
@@ -684,7 +793,7 @@ UnloadProperty(
 
   if (prop_info.IsDirty()) {
     std::string path = KATANA_CHECKED(
-        StoreArrowArrayAtName(props->column(i), dir, name, nullptr));
+        StoreArrowArrayAtName(props->column(i), dir, name, nullptr, opts));
     prop_info.WasWritten(path);
   }
 
@@ -715,11 +824,66 @@ GetStorageLocationIfValid(
   return path;
 }
 
+std::optional<katana::ContentHash>
+GetContentHashIfValid(
+    const std::string& name,
+    const std::vector<katana::PropStorageInfo>& prop_info_list) {
+  auto psi_it = std::find_if(
+      prop_info_list.begin(), prop_info_list.end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+  if (psi_it == prop_info_list.end() || psi_it->IsDirty()) {
+    return std::nullopt;
+  }
+  return psi_it->content_hash();
+}
+
+katana::Result<void>
+SetContentHashIfValid(
+    const std::string& name,
+    std::vector<katana::PropStorageInfo>* prop_info_list,
+    katana::ContentHash hash) {
+  auto psi_it = std::find_if(
+      prop_info_list->begin(), prop_info_list->end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+  if (psi_it == prop_info_list->end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+  if (psi_it->IsDirty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "the property exists but is dirty");
+  }
+  psi_it->set_content_hash(std::move(hash));
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<katana::PagedProperty>>
+OpenPagedProperty(
+    const std::string& name,
+    const std::vector<katana::PropStorageInfo>& prop_info_list,
+    const katana::Uri& dir, const katana::PagedProperty::Options& opts) {
+  auto psi_it = std::find_if(
+      prop_info_list.begin(), prop_info_list.end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+  if (psi_it == prop_info_list.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+
+  if (!(psi_it->IsAbsent() || psi_it->IsClean())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "the property exists but is dirty");
+  }
+  return katana::PagedProperty::Make(dir.Join(psi_it->path()), name, opts);
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 LoadProperty(
     const std::shared_ptr<arrow::Table>& props, const std::string name, int i,
     std::vector<katana::PropStorageInfo>* prop_info_list,
-    const katana::Uri& dir) {
+    const katana::Uri& dir, bool share_loaded) {
   auto psi_it = std::find_if(
       prop_info_list->begin(), prop_info_list->end(),
       [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
@@ -755,20 +919,69 @@ LoadProperty(
           new_table = col;
         }
         return katana::ResultSuccess();
-      }));
+      },
+      share_loaded));
 
   KATANA_LOG_ASSERT(prop_info.IsClean());
 
   return new_table;
 }
 
+/// Load the properties with the given names concurrently and append them to
+/// props. Properties already loaded are an error, as in LoadProperty. On a
+/// failed read, props still gets the properties that loaded, since their
+/// storage info now says they are.
+katana::Result<void>
+LoadProperties(
+    std::shared_ptr<arrow::Table>* props,
+    const std::vector<std::string>& names,
+    std::vector<katana::PropStorageInfo>* prop_info_list,
+    const katana::Uri& dir, bool share_loaded) {
+  std::vector<katana::PropStorageInfo*> to_load;
+  for (const std::string& name : names) {
+    auto psi_it = std::find_if(
+        prop_info_list->begin(), prop_info_list->end(),
+        [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+    if (psi_it == prop_info_list->end()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property named {}",
+          std::quoted(name));
+    }
+    if (!psi_it->IsAbsent() ||
+        std::find(to_load.begin(), to_load.end(), &*psi_it) != to_load.end()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "property {} already loaded",
+          std::quoted(name));
+    }
+    to_load.emplace_back(&*psi_it);
+  }
+
+  // The reads are all issued before any is waited for. Properties in the
+  // property cache are added right away and the others as they complete.
+  katana::ReadGroup grp;
+  KATANA_CHECKED(katana::AddProperties(
+      dir, true /*is_property*/, to_load, &grp,
+      [props](
+          const std::shared_ptr<arrow::Table>& col) -> katana::Result<void> {
+        if (*props && (*props)->num_columns() > 0) {
+          *props = KATANA_CHECKED((*props)->AddColumn(
+              (*props)->num_columns(), col->field(0), col->column(0)));
+        } else {
+          *props = col;
+        }
+        return katana::ResultSuccess();
+      },
+      share_loaded));
+  return grp.Finish();
+}
+
 }  // namespace
 
 katana::Result<void>
 katana::RDG::UnloadNodeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       node_properties(), i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), write_opts_));
   core_->set_node_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -795,7 +1008,7 @@ katana::Result<void>
 katana::RDG::UnloadEdgeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       edge_properties(), i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), write_opts_));
   core_->set_edge_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -806,6 +1019,46 @@ katana::RDG::GetEdgePropertyStorageLocation(const std::string& name) const {
       name, core_->part_header().edge_prop_info_list());
 }
 
+std::optional<katana::ContentHash>
+katana::RDG::GetNodePropertyContentHash(const std::string& name) const {
+  return GetContentHashIfValid(
+      name, core_->part_header().node_prop_info_list());
+}
+
+katana::Result<void>
+katana::RDG::SetNodePropertyContentHash(
+    const std::string& name, ContentHash hash) {
+  return SetContentHashIfValid(
+      name, &core_->part_header().node_prop_info_list(), std::move(hash));
+}
+
+std::optional<katana::ContentHash>
+katana::RDG::GetEdgePropertyContentHash(const std::string& name) const {
+  return GetContentHashIfValid(
+      name, core_->part_header().edge_prop_info_list());
+}
+
+katana::Result<void>
+katana::RDG::SetEdgePropertyContentHash(
+    const std::string& name, ContentHash hash) {
+  return SetContentHashIfValid(
+      name, &core_->part_header().edge_prop_info_list(), std::move(hash));
+}
+
+katana::Result<std::unique_ptr<katana::PagedProperty>>
+katana::RDG::OpenPagedNodeProperty(
+    const std::string& name, const PagedProperty::Options& opts) const {
+  return OpenPagedProperty(
+      name, core_->part_header().node_prop_info_list(), rdg_dir(), opts);
+}
+
+katana::Result<std::unique_ptr<katana::PagedProperty>>
+katana::RDG::OpenPagedEdgeProperty(
+    const std::string& name, const PagedProperty::Options& opts) const {
+  return OpenPagedProperty(
+      name, core_->part_header().edge_prop_info_list(), rdg_dir(), opts);
+}
+
 katana::Result<void>
 katana::RDG::UnloadEdgeProperty(const std::string& name) {
   auto col_names = edge_properties()->ColumnNames();
@@ -822,7 +1075,7 @@ katana::Result<void>
 katana::RDG::LoadNodeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       node_properties(), name, i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), share_loaded_files_));
   core_->set_node_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -831,11 +1084,31 @@ katana::Result<void>
 katana::RDG::LoadEdgeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       edge_properties(), name, i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), share_loaded_files_));
   core_->set_edge_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDG::LoadNodeProperties(const std::vector<std::string>& names) {
+  std::shared_ptr<arrow::Table> props = node_properties();
+  auto res = LoadProperties(
+      &props, names, &core_->part_header().node_prop_info_list(), rdg_dir(),
+      share_loaded_files_);
+  core_->set_node_properties(std::move(props));
+  return res;
+}
+
+katana::Result<void>
+katana::RDG::LoadEdgeProperties(const std::vector<std::string>& names) {
+  std::shared_ptr<arrow::Table> props = edge_properties();
+  auto res = LoadProperties(
+      &props, names, &core_->part_header().edge_prop_info_list(), rdg_dir(),
+      share_loaded_files_);
+  core_->set_edge_properties(std::move(props));
+  return res;
+}
+
 std::vector<std::string>
 katana::RDG::ListFullNodeProperties() const {
   std::vector<std::string> result;
@@ -925,6 +1198,11 @@ katana::RDG::DropAllTopologies() {
   return core_->UnbindAllTopologyFile();
 }
 
+void
+katana::RDG::InvalidateAllTopologies() {
+  core_->topology_manager().InvalidateAll();
+}
+
 std::shared_ptr<arrow::Schema>
 katana::RDG::full_node_schema() const {
   return core_->full_node_schema();
@@ -1010,11 +1288,34 @@ katana::Result<katana::RDGTopology*>
 katana::RDG::GetTopology(const katana::RDGTopology& shadow) {
   RDGTopology* topology =
       KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
-  KATANA_CHECKED(topology->Bind(rdg_dir()));
+  // the csr topology may have been prefetched while the RDG was loaded
+  if (!topology->bound()) {
+    if (map_topology_in_place_) {
+      KATANA_CHECKED(topology->BindInPlace(rdg_dir(), topology_map_advice_));
+    } else {
+      KATANA_CHECKED(topology->Bind(rdg_dir()));
+    }
+  }
   KATANA_CHECKED(topology->Map());
   return topology;
 }
 
+bool
+katana::RDG::HasTopology(const katana::RDGTopology& shadow) {
+  return core_->topology_manager().GetTopology(shadow).has_value();
+}
+
+katana::Result<katana::Uri>
+katana::RDG::GetTopologyStorageLocation(const katana::RDGTopology& shadow) {
+  RDGTopology* topology =
+      KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
+  if (!topology->metadata_entry_valid() || topology->path().empty()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "the topology is not in storage yet");
+  }
+  return rdg_dir().Join(topology->path());
+}
+
 const katana::FileView&
 katana::RDG::node_entity_type_id_array_file_storage() const {
   return core_->node_entity_type_id_array_file_storage();
@@ -1081,6 +1382,30 @@ katana::RDG::edge_entity_type_id_array() const {
   return KATANA_CHECKED(core_->edge_entity_type_id_array());
 }
 
+katana::Result<void>
+katana::RDG::AddNodePropertyByFile(
+    const std::string& name, const katana::Uri& prop_file) {
+  if (prop_file.DirName() != rdg_dir()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "new node property file must be in this RDG's directory ({})",
+        rdg_dir());
+  }
+  return core_->RegisterNodePropertyFile(name, prop_file.BaseName());
+}
+
+katana::Result<void>
+katana::RDG::AddEdgePropertyByFile(
+    const std::string& name, const katana::Uri& prop_file) {
+  if (prop_file.DirName() != rdg_dir()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "new edge property file must be in this RDG's directory ({})",
+        rdg_dir());
+  }
+  return core_->RegisterEdgePropertyFile(name, prop_file.BaseName());
+}
+
 katana::Result<std::optional<katana::RDKLSHIndexPrimitive>>
 katana::RDG::LoadRDKLSHIndexPrimitive() {
   if (!KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat)) {
@@ -1155,6 +1480,78 @@ katana::RDG::WriteRDKSubstructureIndexPrimitive(
   return katana::ResultSuccess();
 }
 
+katana::Result<std::optional<katana::ReachabilityIndexPrimitive>>
+katana::RDG::LoadReachabilityIndexPrimitive() {
+  if (!KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "The UnstableRDGStorageFormat feature flag must be set to use this "
+        "feature");
+  }
+  std::optional<std::string> res =
+      KATANA_CHECKED(core_->part_header().OptionalDatastructureManifest(
+          kOptionalDatastructureReachabilityIndexPrimitive));
+  if (!res) {
+    return std::nullopt;
+  }
+
+  katana::ReachabilityIndexPrimitive index = KATANA_CHECKED_CONTEXT(
+      katana::ReachabilityIndexPrimitive::Load(rdg_dir(), res.value()),
+      "Failed to load ReachabilityIndexPrimitive located at {}", res.value());
+  return index;
+}
+
+katana::Result<void>
+katana::RDG::WriteReachabilityIndexPrimitive(
+    katana::ReachabilityIndexPrimitive& index) {
+  if (!KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "The UnstableRDGStorageFormat feature flag must be set to use this "
+        "feature");
+  }
+  std::string path = KATANA_CHECKED(index.Write(rdg_dir()));
+  core_->part_header().AppendOptionalDatastructureManifest(
+      kOptionalDatastructureReachabilityIndexPrimitive, path);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::optional<katana::EntityIndexPrimitive>>
+katana::RDG::LoadEntityIndexPrimitive(const std::string& name) {
+  if (!KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "The UnstableRDGStorageFormat feature flag must be set to use this "
+        "feature");
+  }
+  std::optional<std::string> res = KATANA_CHECKED(
+      core_->part_header().OptionalDatastructureManifest(name));
+  if (!res) {
+    return std::nullopt;
+  }
+
+  katana::EntityIndexPrimitive index = KATANA_CHECKED_CONTEXT(
+      katana::EntityIndexPrimitive::Load(rdg_dir(), res.value()),
+      "Failed to load EntityIndexPrimitive located at {}", res.value());
+  return index;
+}
+
+katana::Result<void>
+katana::RDG::WriteEntityIndexPrimitive(
+    const std::string& name, katana::EntityIndexPrimitive& index) {
+  if (!KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "The UnstableRDGStorageFormat feature flag must be set to use this "
+        "feature");
+  }
+  std::string path = KATANA_CHECKED(index.Write(rdg_dir()));
+  core_->part_header().AppendOptionalDatastructureManifest(name, path);
+
+  return katana::ResultSuccess();
+}
+
 katana::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {}
 
 katana::RDG::RDG() : core_(std::make_unique<RDGCore>()) {}
@@ -294,6 +294,22 @@ katana::RDGCore::EnsureEdgeTypesLoaded() {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDGCore::RegisterPropertyFile(
+    const std::string& name, const std::string& prop_path,
+    std::vector<PropStorageInfo>* prop_info_list) {
+  for (const auto& prop : *prop_info_list) {
+    if (prop.name() == name) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AlreadyExists, "property {} already exists",
+          std::quoted(name));
+    }
+  }
+  // absent, its type is read from the file when it is needed
+  prop_info_list->emplace_back(name, prop_path);
+  return katana::ResultSuccess();
+}
+
 void
 katana::RDGCore::InitEmptyProperties() {
   std::vector<std::shared_ptr<arrow::Array>> empty;
@@ -116,10 +116,12 @@ public:
 
   void AddMirrorNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     mirror_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   void AddMasterNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     master_nodes_.emplace_back(std::move(a));
+    part_arrays_dirty_ = true;
   }
 
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& master_nodes()
@@ -128,6 +130,7 @@ public:
   }
   void set_master_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     master_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes()
@@ -136,6 +139,7 @@ public:
   }
   void set_mirror_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     mirror_nodes_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& host_to_owned_global_node_ids()
@@ -145,6 +149,7 @@ public:
   void set_host_to_owned_global_node_ids(
       std::shared_ptr<arrow::ChunkedArray>&& a) {
     host_to_owned_global_node_ids_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& host_to_owned_global_edge_ids()
@@ -154,6 +159,7 @@ public:
   void set_host_to_owned_global_edge_ids(
       std::shared_ptr<arrow::ChunkedArray>&& a) {
     host_to_owned_global_edge_ids_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_user_id() const {
@@ -161,6 +167,7 @@ public:
   }
   void set_local_to_user_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_user_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_global_id() const {
@@ -168,8 +175,14 @@ public:
   }
   void set_local_to_global_id(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_global_id_ = std::move(a);
+    part_arrays_dirty_ = true;
   }
 
+  /// Whether the partition metadata arrays changed since they were loaded
+  /// from or last stored to rdg_dir
+  bool part_arrays_dirty() const { return part_arrays_dirty_; }
+  void set_part_arrays_dirty(bool dirty) { part_arrays_dirty_ = dirty; }
+
   const RDGLineage& lineage() const { return lineage_; }
   void set_lineage(RDGLineage&& lineage) { lineage_ = lineage; }
 
@@ -280,6 +293,18 @@ public:
     return edge_entity_type_id_array_file_storage_.Unbind();
   }
 
+  katana::Result<void> RegisterNodePropertyFile(
+      const std::string& name, const std::string& prop_path) {
+    return RegisterPropertyFile(
+        name, prop_path, &part_header_.node_prop_info_list());
+  }
+
+  katana::Result<void> RegisterEdgePropertyFile(
+      const std::string& name, const std::string& prop_path) {
+    return RegisterPropertyFile(
+        name, prop_path, &part_header_.edge_prop_info_list());
+  }
+
   void AddCommandLine(const std::string& command_line) {
     lineage_.AddCommandLine(command_line);
   }
@@ -287,6 +312,10 @@ public:
 private:
   void InitEmptyProperties();
 
+  katana::Result<void> RegisterPropertyFile(
+      const std::string& name, const std::string& prop_path,
+      std::vector<PropStorageInfo>* prop_info_list);
+
   //
   // Data
   //
@@ -307,6 +336,7 @@ private:
   std::shared_ptr<arrow::ChunkedArray> host_to_owned_global_edge_ids_;
   std::shared_ptr<arrow::ChunkedArray> local_to_user_id_;
   std::shared_ptr<arrow::ChunkedArray> local_to_global_id_;
+  bool part_arrays_dirty_{true};
 
   /// name of the graph that was used to load this RDG
   katana::Uri rdg_dir_;
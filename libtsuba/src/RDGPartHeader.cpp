@@ -1,5 +1,6 @@
 #include "RDGPartHeader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
@@ -13,11 +14,14 @@
 #include "katana/Experimental.h"
 #include "katana/FaultTest.h"
 #include "katana/FileView.h"
+#include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/RDGOptionalDatastructure.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
+#include "katana/WriteGroup.h"
+#include "katana/file.h"
 
 using json = nlohmann::json;
 
@@ -60,16 +64,40 @@ const char* kOptionalDatastructuresKey = "kg.v1.optional_datastructures";
 
 // special partition property names
 
+/// Copy the files of a property to new_location without reading them. A
+/// property too large for one parquet file is stored as a json list of row
+/// offsets, one for each of its part files, and those are copied too.
 katana::Result<void>
 CopyProperty(
     katana::PropStorageInfo* prop, const katana::Uri& old_location,
-    const katana::Uri& new_location) {
-  katana::Uri old_path = old_location.Join(prop->path());
-  katana::Uri new_path = new_location.Join(prop->path());
-  katana::FileView fv;
+    const katana::Uri& new_location, katana::WriteGroup* write_group) {
+  static const std::string kParquetMagic = "PAR1";
 
-  KATANA_CHECKED(fv.Bind(old_path.string(), true));
-  return katana::FileStore(new_path.string(), fv.ptr<uint8_t>(), fv.size());
+  katana::Uri old_path = old_location.Join(prop->path());
+  katana::StatBuf stat;
+  KATANA_CHECKED(katana::FileStat(old_path.string(), &stat));
+  std::string head(std::min<uint64_t>(stat.size, kParquetMagic.size()), '\0');
+  KATANA_CHECKED(
+      katana::FileGet(old_path.string(), head.data(), 0, head.size()));
+
+  if (head != kParquetMagic) {
+    std::string raw(stat.size, '\0');
+    KATANA_CHECKED(
+        katana::FileGet(old_path.string(), raw.data(), 0, raw.size()));
+    std::vector<int64_t> row_offsets;
+    KATANA_CHECKED_CONTEXT(
+        katana::JsonParse(raw, &row_offsets),
+        "property file {} is neither parquet nor a list of offsets",
+        old_path.string());
+    for (size_t i = 0; i < row_offsets.size(); ++i) {
+      std::string part = fmt::format("{}.part_{:09}", prop->path(), i);
+      write_group->StartCopy(
+          old_location.Join(part).string(), new_location.Join(part).string());
+    }
+  }
+  write_group->StartCopy(
+      old_path.string(), new_location.Join(prop->path()).string());
+  return katana::ResultSuccess();
 }
 
 katana::PropStorageInfo*
@@ -253,30 +281,23 @@ katana::RDGPartHeader::Validate() const {
 katana::Result<void>
 katana::RDGPartHeader::ChangeStorageLocation(
     const katana::Uri& old_location, const katana::Uri& new_location) {
-  for (PropStorageInfo& prop : node_prop_info_list_) {
-    if (prop.IsAbsent()) {
-      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
-    } else {
-      prop.WasModified(prop.type());
-    }
-  }
-  for (PropStorageInfo& prop : edge_prop_info_list_) {
-    if (prop.IsAbsent()) {
-      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
-    } else {
-      prop.WasModified(prop.type());
-    }
-  }
-  for (PropStorageInfo& prop : part_prop_info_list_) {
-    if (prop.IsAbsent()) {
-      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
-    } else {
-      prop.WasModified(prop.type());
+  // the files of properties that are the same in memory and in storage are
+  // copied by the storage, only modified ones go through this host when
+  // they are stored
+  std::unique_ptr<WriteGroup> copies = KATANA_CHECKED(WriteGroup::Make());
+  for (auto* prop_infos :
+       {&node_prop_info_list_, &edge_prop_info_list_, &part_prop_info_list_}) {
+    for (PropStorageInfo& prop : *prop_infos) {
+      if (!prop.IsDirty()) {
+        KATANA_CHECKED(
+            CopyProperty(&prop, old_location, new_location, copies.get()));
+      }
     }
   }
-  // clear out specific file paths so that we know to store them later
-  node_entity_type_id_array_path_ = "";
-  edge_entity_type_id_array_path_ = "";
+  KATANA_CHECKED(copies->Finish());
+
+  // the entity type id arrays and topologies are copied or stored when the
+  // RDG is, depending on whether they changed
   topology_metadata_.ChangeStorageLocation();
 
   // the OptionalDatastructure Files are loaded and stored on demand,
@@ -522,12 +543,19 @@ void
 katana::from_json(const nlohmann::json& j, katana::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name_);
   j.at(1).get_to(propmd.path_);
+  // the content hash was added later and is optional
+  if (j.size() > 2) {
+    propmd.content_hash_ = j.at(2).get<katana::ContentHash>();
+  }
   propmd.state_ = PropStorageInfo::State::kAbsent;
 }
 
 void
 katana::to_json(json& j, const katana::PropStorageInfo& propmd) {
   j = json{propmd.name(), propmd.path()};
+  if (propmd.content_hash()) {
+    j.push_back(*propmd.content_hash());
+  }
 }
 
 void
@@ -552,6 +580,9 @@ katana::from_json(
       .get_to(topo.node_condensed_type_id_map_present_);
   j.at("node_condensed_type_id_map_size")
       .get_to(topo.node_condensed_type_id_map_size_);
+  if (auto it = j.find("compressed_dests_size"); it != j.end()) {
+    it->get_to(topo.compressed_dests_size_);
+  }
   j.at("topology_state").get_to(topo.topology_state_);
   j.at("transpose_state").get_to(topo.transpose_state_);
   j.at("edge_sort_state").get_to(topo.edge_sort_state_);
@@ -603,6 +634,11 @@ katana::to_json(json& j, const katana::PartitionTopologyMetadataEntry& topo) {
       {"edge_sort_state", topo.edge_sort_state_},
       {"node_sort_state", topo.node_sort_state_}};
 
+  if (topo.topology_state_ ==
+      katana::RDGTopology::TopologyKind::kCompressedTopology) {
+    j["compressed_dests_size"] = topo.compressed_dests_size_;
+  }
+
   KATANA_LOG_DEBUG(
       "stored topology with: topology_state={}, transpose_state={}, "
       "edge_sort_state={}, node_sort_state={}",
@@ -684,9 +720,18 @@ katana::from_json(
   j.at("fingerprint_length").get_to(index.fingerprint_length_);
   j.at("num_fingerprints").get_to(index.num_fingerprints_);
   j.at("smiles").get_to(index.smiles_);
-  j.at("hash_structure").get_to(index.hash_structure_);
   j.at("fingerprints").get_to(index.fingerprints_);
   j.at("paths").get_to(index.paths_);
+  // Older manifests hold the hash tables as maps rather than files
+  if (auto it = j.find("hash_structure"); it != j.end()) {
+    index.set_hash_structure(
+        it->get<std::vector<std::map<uint64_t, std::vector<uint64_t>>>>());
+    return;
+  }
+  j.at("table_offsets_size").get_to(index.table_offsets_size_);
+  j.at("keys_size").get_to(index.keys_size_);
+  j.at("member_offsets_size").get_to(index.member_offsets_size_);
+  j.at("members_size").get_to(index.members_size_);
 }
 
 void
@@ -697,8 +742,11 @@ katana::to_json(nlohmann::json& j, const katana::RDKLSHIndexPrimitive& index) {
       {"fingerprint_length", index.fingerprint_length_},
       {"num_fingerprints", index.num_fingerprints_},
       {"smiles", index.smiles_},
-      {"hash_structure", index.hash_structure_},
       {"fingerprints", index.fingerprints_},
+      {"table_offsets_size", index.hash_tables_.table_offsets.size()},
+      {"keys_size", index.hash_tables_.keys.size()},
+      {"member_offsets_size", index.hash_tables_.member_offsets.size()},
+      {"members_size", index.hash_tables_.members.size()},
       {"paths", index.paths_}};
 }
 
@@ -709,8 +757,14 @@ katana::from_json(
   j.at("num_entries").get_to(index.num_entries_);
   j.at("smiles").get_to(index.smiles_);
   j.at("index").get_to(index.index_);
-  j.at("fingerprints").get_to(index.fingerprints_);
   j.at("paths").get_to(index.paths_);
+  // Older manifests hold the fingerprints as bitsets rather than a file
+  if (auto it = j.find("fingerprints"); it != j.end()) {
+    index.set_fingerprints(it->get<std::vector<katana::DynamicBitset>>());
+    return;
+  }
+  j.at("fingerprint_bits").get_to(index.fingerprint_bits_);
+  j.at("fingerprint_matrix_size").get_to(index.fingerprint_matrix_size_);
 }
 
 void
@@ -721,7 +775,51 @@ katana::to_json(
       {"num_entries", index.num_entries_},
       {"smiles", index.smiles_},
       {"index", index.index_},
-      {"fingerprints", index.fingerprints_},
+      {"fingerprint_bits", index.fingerprint_bits_},
+      {"fingerprint_matrix_size", index.fingerprint_matrix_.size()},
+      {"paths", index.paths_}};
+}
+
+void
+katana::from_json(
+    const nlohmann::json& j, katana::ReachabilityIndexPrimitive& index) {
+  j.at("num_nodes").get_to(index.num_nodes_);
+  j.at("num_out_entries").get_to(index.num_out_entries_);
+  j.at("num_in_entries").get_to(index.num_in_entries_);
+  j.at("paths").get_to(index.paths_);
+}
+
+void
+katana::to_json(
+    nlohmann::json& j, const katana::ReachabilityIndexPrimitive& index) {
+  j = nlohmann::json{
+      {"num_nodes", index.num_nodes_},
+      {"num_out_entries", index.out_labels_.hubs.size()},
+      {"num_in_entries", index.in_labels_.hubs.size()},
+      {"paths", index.paths_}};
+}
+
+void
+katana::from_json(
+    const nlohmann::json& j, katana::EntityIndexPrimitive& index) {
+  j.at("property_name").get_to(index.property_name_);
+  j.at("property_path").get_to(index.property_path_);
+  j.at("type").get_to(index.type_);
+  j.at("num_entities").get_to(index.num_entities_);
+  j.at("ids_size").get_to(index.ids_size_);
+  j.at("keys_size").get_to(index.keys_size_);
+  j.at("paths").get_to(index.paths_);
+}
+
+void
+katana::to_json(nlohmann::json& j, const katana::EntityIndexPrimitive& index) {
+  j = nlohmann::json{
+      {"property_name", index.property_name_},
+      {"property_path", index.property_path_},
+      {"type", index.type_},
+      {"num_entities", index.num_entities_},
+      {"ids_size", index.ids_.size()},
+      {"keys_size", index.keys_.size()},
       {"paths", index.paths_}};
 }
 
@@ -13,6 +13,8 @@
 #include <arrow/api.h>
 
 #include "PartitionTopologyMetadata.h"
+#include "katana/ContentHash.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/JSON.h"
@@ -23,6 +25,7 @@
 #include "katana/RDGTopology.h"
 #include "katana/RDKLSHIndexPrimitive.h"
 #include "katana/RDKSubstructureIndexPrimitive.h"
+#include "katana/ReachabilityIndexPrimitive.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/WriteGroup.h"
@@ -82,6 +85,7 @@ public:
 
   void WasModified(const std::shared_ptr<arrow::DataType>& type) {
     path_.clear();
+    content_hash_.reset();
     state_ = State::kDirty;
     type_ = type;
   }
@@ -107,6 +111,17 @@ public:
   const std::string& path() const { return path_; }
   const std::shared_ptr<arrow::DataType>& type() const { return type_; }
 
+  /// The hash of the contents of the property stored at path, if it was
+  /// computed; it is stored along with the path
+  const std::optional<ContentHash>& content_hash() const {
+    return content_hash_;
+  }
+
+  void set_content_hash(ContentHash hash) {
+    KATANA_LOG_ASSERT(state_ != State::kDirty);
+    content_hash_ = std::move(hash);
+  }
+
   // since we don't have type info in the header don't know the
   // type when this would have been constructed. Allow others to
   // fix up the type in this case, required until we can get the type
@@ -127,6 +142,7 @@ private:
   std::string path_;
   std::shared_ptr<arrow::DataType> type_;
   State state_;
+  std::optional<ContentHash> content_hash_;
 };
 
 class KATANA_EXPORT RDGPartHeader {
@@ -141,8 +157,9 @@ public:
       RDGHandle handle, WriteGroup* writes,
       RDG::RDGVersioningPolicy retain_version) const;
 
-  /// Mark all in-memory properties dirty so that they can be written
-  /// out, copy out-of-memory properties
+  /// Copy the files of all properties that are not dirty to new_location
+  /// in storage, and blank the topology paths so that RDG::Store relocates
+  /// the topologies
   katana::Result<void> ChangeStorageLocation(
       const katana::Uri& old_location, const katana::Uri& new_location);
 
@@ -484,10 +501,12 @@ public:
     return std::nullopt;
   }
 
+  /// Record the manifest of an optional datastructure, replacing the one
+  /// stored under its name, e.g., by an index built again
   void AppendOptionalDatastructureManifest(
       const std::string& optional_datastructure_name,
       const std::string& optional_datastructure_path) {
-    optional_datastructure_manifests_.emplace(
+    optional_datastructure_manifests_.insert_or_assign(
         optional_datastructure_name, optional_datastructure_path);
   }
 
@@ -684,6 +703,12 @@ void from_json(const nlohmann::json& j, RDKLSHIndexPrimitive& index);
 void to_json(nlohmann::json& j, const RDKSubstructureIndexPrimitive& index);
 void from_json(const nlohmann::json& j, RDKSubstructureIndexPrimitive& index);
 
+void to_json(nlohmann::json& j, const ReachabilityIndexPrimitive& index);
+void from_json(const nlohmann::json& j, ReachabilityIndexPrimitive& index);
+
+void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
 void to_json(nlohmann::json& j, const RDGOptionalDatastructure& data);
 void from_json(const nlohmann::json& j, RDGOptionalDatastructure& data);
 
@@ -703,14 +728,20 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
      {RDGTopology::EdgeSortKind::kAny, "kAny"},
      {RDGTopology::EdgeSortKind::kSortedByDestID, "kSortedByDestID"},
      {RDGTopology::EdgeSortKind::kSortedByEdgeType, "kSortedByEdgeType"},
-     {RDGTopology::EdgeSortKind::kSortedByNodeType, "kSortedByNodeType"}})
+     {RDGTopology::EdgeSortKind::kSortedByNodeType, "kSortedByNodeType"},
+     {RDGTopology::EdgeSortKind::kSortedByEdgeProperty,
+      "kSortedByEdgeProperty"}})
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
     RDGTopology::NodeSortKind,
     {{RDGTopology::NodeSortKind::kInvalid, "kInvalid"},
      {RDGTopology::NodeSortKind::kAny, "kAny"},
      {RDGTopology::NodeSortKind::kSortedByDegree, "kSortedByDegree"},
-     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"}})
+     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"},
+     {RDGTopology::NodeSortKind::kReverseCuthillMcKee,
+      "kReverseCuthillMcKee"},
+     {RDGTopology::NodeSortKind::kHubSorted, "kHubSorted"},
+     {RDGTopology::NodeSortKind::kHubClustered, "kHubClustered"}})
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
     RDGTopology::TopologyKind,
@@ -719,7 +750,9 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
      {RDGTopology::TopologyKind::kEdgeShuffleTopology, "kEdgeShuffleTopology"},
      {RDGTopology::TopologyKind::kShuffleTopology, "kShuffleTopology"},
      {RDGTopology::TopologyKind::kEdgeTypeAwareTopology,
-      "kEdgeTypeAwareTopology"}})
+      "kEdgeTypeAwareTopology"},
+     {RDGTopology::TopologyKind::kCompressedTopology,
+      "kCompressedTopology"}})
 
 }  // namespace katana
 
@@ -1,5 +1,8 @@
 #include "katana/RDGSlice.h"
 
+#include <algorithm>
+#include <iomanip>
+
 #include "AddProperties.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
@@ -8,6 +11,7 @@
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/ParquetReader.h"
 #include "katana/RDGPrefix.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
@@ -65,6 +69,73 @@ unload_metadata_array(
   return katana::ResultSuccess();
 }
 
+std::vector<katana::ParquetReader::Slice>
+IntersectRanges(
+    const std::vector<katana::ParquetReader::Slice>& a,
+    const std::vector<katana::ParquetReader::Slice>& b) {
+  std::vector<katana::ParquetReader::Slice> out;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.size() && j < b.size()) {
+    int64_t a_end = a[i].offset + a[i].length;
+    int64_t b_end = b[j].offset + b[j].length;
+    int64_t begin = std::max(a[i].offset, b[j].offset);
+    int64_t end = std::min(a_end, b_end);
+    if (begin < end) {
+      out.emplace_back(katana::ParquetReader::Slice{begin, end - begin});
+    }
+    if (a_end < b_end) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return out;
+}
+
+/// The rows of range that may satisfy every filter on the node (edge)
+/// properties, or nothing if there are no filters
+katana::Result<std::optional<std::vector<katana::ParquetReader::Slice>>>
+find_matching_rows(
+    const std::vector<katana::ParquetReader::ColumnFilter>& filters,
+    std::pair<uint64_t, uint64_t> range, NodeEdge node_edge,
+    katana::RDGCore* core) {
+  std::optional<std::vector<katana::ParquetReader::Slice>> matches;
+  if (filters.empty()) {
+    return matches;
+  }
+
+  katana::ParquetReader::Slice slice{
+      .offset = static_cast<int64_t>(range.first),
+      .length = static_cast<int64_t>(
+          range.second > range.first ? range.second - range.first : 0)};
+  matches = std::vector<katana::ParquetReader::Slice>{slice};
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  for (const auto& filter : filters) {
+    katana::PropStorageInfo* prop_info =
+        node_edge == NodeEdge::kNode
+            ? core->part_header().find_node_prop_info(filter.column)
+            : core->part_header().find_edge_prop_info(filter.column);
+    if (!prop_info) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound,
+          "cannot filter on missing property {}", std::quoted(filter.column));
+    }
+    katana::Uri path = core->rdg_dir().Join(prop_info->path());
+    try {
+      auto filter_matches = KATANA_CHECKED_CONTEXT(
+          reader->FindMatchingRows(path, {filter}, slice),
+          "filtering on {}", std::quoted(filter.column));
+      matches = IntersectRanges(*matches, filter_matches);
+    } catch (const std::exception& exp) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+    }
+  }
+  return matches;
+}
+
 katana::Result<void>
 load_property(
     const std::string& name, const katana::RDGSlice::SliceArg& slice_arg,
@@ -83,12 +154,17 @@ load_property(
     return katana::ErrorCode::PropertyNotFound;
   }
 
+  std::pair<uint64_t, uint64_t> range = node_edge == NodeEdge::kNode
+                                            ? slice_arg.node_range
+                                            : slice_arg.edge_range;
+  auto matching_rows = KATANA_CHECKED(find_matching_rows(
+      node_edge == NodeEdge::kNode ? slice_arg.node_filters
+                                   : slice_arg.edge_filters,
+      range, node_edge, core));
+
   std::vector<katana::PropStorageInfo*> property{prop_info};
   KATANA_CHECKED(AddPropertySlice(
-      core->rdg_dir(), property,
-      node_edge == NodeEdge::kNode ? slice_arg.node_range
-                                   : slice_arg.edge_range,
-      nullptr,
+      core->rdg_dir(), property, range, matching_rows, nullptr,
       [&](const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
         std::shared_ptr<arrow::Table> prop_table =
             node_edge == NodeEdge::kNode ? core->node_properties()
@@ -222,9 +298,11 @@ katana::RDGSlice::DoMake(
   // all of the properties
   std::vector<PropStorageInfo*> node_properties =
       KATANA_CHECKED(core_->part_header().SelectNodeProperties(node_props));
+  auto node_matching_rows = KATANA_CHECKED(find_matching_rows(
+      slice.node_filters, slice.node_range, NodeEdge::kNode, core_.get()));
 
   KATANA_CHECKED(AddPropertySlice(
-      metadata_dir, node_properties, slice.node_range, &grp,
+      metadata_dir, node_properties, slice.node_range, node_matching_rows, &grp,
       [rdg = this](
           const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
         std::shared_ptr<arrow::Table> prop_table =
@@ -245,9 +323,11 @@ katana::RDGSlice::DoMake(
   // all of the properties
   std::vector<PropStorageInfo*> edge_properties =
       KATANA_CHECKED(core_->part_header().SelectEdgeProperties(edge_props));
+  auto edge_matching_rows = KATANA_CHECKED(find_matching_rows(
+      slice.edge_filters, slice.edge_range, NodeEdge::kEdge, core_.get()));
 
   KATANA_CHECKED(AddPropertySlice(
-      metadata_dir, edge_properties, slice.edge_range, &grp,
+      metadata_dir, edge_properties, slice.edge_range, edge_matching_rows, &grp,
       [rdg = this](
           const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
         std::shared_ptr<arrow::Table> prop_table =
@@ -0,0 +1,693 @@
+#include "katana/RDGStreamWriter.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <functional>
+#include <future>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include <arrow/compute/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/CSRTopology.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/ErrorCode.h"
+#include "katana/FileView.h"
+#include "katana/Logging.h"
+#include "katana/ParquetReader.h"
+#include "katana/RDG.h"
+#include "katana/RDGManifest.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const std::string kSrcName = "__katana_src";
+const std::string kDstName = "__katana_dst";
+
+static_assert(
+    katana::kUnknownEntityType == 0,
+    "entity type id files of unknown types are written as holes");
+
+katana::Result<void>
+PWriteAll(int fd, const void* data, uint64_t size, uint64_t offset) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    ssize_t written = pwrite(fd, bytes, size, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "pwrite");
+    }
+    bytes += written;
+    size -= written;
+    offset += written;
+  }
+  return katana::ResultSuccess();
+}
+
+/// Writes a CSR topology file front to back, buffering the out indexes and
+/// the destinations, which go to different parts of the file
+class CSRFileWriter {
+public:
+  static katana::Result<std::unique_ptr<CSRFileWriter>> Make(
+      const std::string& path, uint64_t num_nodes, uint64_t num_edges) {
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (fd < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+    }
+    katana::CSRTopologyHeader header{
+        .version = 1,
+        .edge_type_size = 0,
+        .num_nodes = num_nodes,
+        .num_edges = num_edges};
+    // new to access non-public constructor
+    std::unique_ptr<CSRFileWriter> writer(new CSRFileWriter(fd, header));
+    KATANA_CHECKED(PWriteAll(fd, &header, sizeof(header), 0));
+    return writer;
+  }
+
+  ~CSRFileWriter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  katana::Result<void> AddOutIndex(uint64_t out_index) {
+    out_indexes_.emplace_back(out_index);
+    if (out_indexes_.size() == kBufferEntries) {
+      KATANA_CHECKED(Flush(&out_indexes_, &out_index_offset_));
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> AddDest(uint32_t dest) {
+    dests_.emplace_back(dest);
+    if (dests_.size() == kBufferEntries) {
+      KATANA_CHECKED(Flush(&dests_, &dest_offset_));
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Finish() {
+    KATANA_CHECKED(Flush(&out_indexes_, &out_index_offset_));
+    KATANA_CHECKED(Flush(&dests_, &dest_offset_));
+    // the destinations are padded to a multiple of 8 bytes
+    if (ftruncate(fd_, katana::CSRTopologyFileSize(header_)) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "sizing topology file");
+    }
+    int fd = fd_;
+    fd_ = -1;
+    if (close(fd) != 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "closing topology file");
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  static constexpr size_t kBufferEntries = 1 << 16;
+
+  CSRFileWriter(int fd, const katana::CSRTopologyHeader& header)
+      : fd_(fd),
+        header_(header),
+        out_index_offset_(sizeof(header)),
+        dest_offset_(sizeof(header) + header.num_nodes * sizeof(uint64_t)) {
+    out_indexes_.reserve(kBufferEntries);
+    dests_.reserve(kBufferEntries);
+  }
+
+  template <typename T>
+  katana::Result<void> Flush(std::vector<T>* buf, uint64_t* offset) {
+    uint64_t size = buf->size() * sizeof(T);
+    KATANA_CHECKED(PWriteAll(fd_, buf->data(), size, *offset));
+    *offset += size;
+    buf->clear();
+    return katana::ResultSuccess();
+  }
+
+  int fd_;
+  katana::CSRTopologyHeader header_;
+  std::vector<uint64_t> out_indexes_;
+  uint64_t out_index_offset_;
+  std::vector<uint32_t> dests_;
+  uint64_t dest_offset_;
+};
+
+/// A table of num_rows rows of nulls
+katana::Result<std::shared_ptr<arrow::Table>>
+NullTable(const std::shared_ptr<arrow::Schema>& schema, int64_t num_rows) {
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (const auto& field : schema->fields()) {
+    columns.emplace_back(
+        KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), num_rows)));
+  }
+  return arrow::Table::Make(schema, columns, num_rows);
+}
+
+katana::Result<void>
+CheckBatch(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::shared_ptr<arrow::Table>& props) {
+  if (!props->schema()->Equals(*schema, /*check_metadata=*/false)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "batch properties {} do not match the properties of the first batch {}",
+        props->schema()->ToString(), schema->ToString());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Write each column of batch to the stream of its property
+katana::Result<void>
+AppendColumns(
+    const std::shared_ptr<arrow::Table>& batch,
+    const std::vector<katana::ParquetWriter::Stream*>& streams) {
+  for (int i = 0, n = batch->num_columns(); i < n; ++i) {
+    katana::ParquetWriter::Stream* stream = streams[i];
+    KATANA_CHECKED(stream->Append(
+        arrow::Table::Make(stream->schema(), {batch->column(i)})));
+  }
+  return katana::ResultSuccess();
+}
+
+/// The position of the merge in a sorted run
+struct RunCursor {
+  std::unique_ptr<katana::ParquetReader::RowGroupTable> run;
+  size_t next_row_group{0};
+  /// the edge properties of the current row group
+  std::shared_ptr<arrow::Table> props;
+  const uint32_t* srcs{nullptr};
+  const uint32_t* dsts{nullptr};
+  int64_t pos{0};
+  int64_t num_rows{0};
+  /// where props starts among the sources of the current batch
+  int64_t source_offset{0};
+  // keeps srcs and dsts alive
+  std::shared_ptr<arrow::Table> rows;
+
+  /// Read the next row group with rows, returning false if there is none
+  katana::Result<bool> Advance() {
+    for (; next_row_group < run->num_row_groups(); ++next_row_group) {
+      rows = KATANA_CHECKED(
+          KATANA_CHECKED(run->ReadRowGroup(next_row_group))->CombineChunks());
+      if (rows->num_rows() == 0) {
+        continue;
+      }
+      ++next_row_group;
+      srcs = std::static_pointer_cast<arrow::UInt32Array>(
+                 rows->column(0)->chunk(0))
+                 ->raw_values();
+      dsts = std::static_pointer_cast<arrow::UInt32Array>(
+                 rows->column(1)->chunk(0))
+                 ->raw_values();
+      std::vector<int> prop_columns;
+      for (int i = 2, n = rows->num_columns(); i < n; ++i) {
+        prop_columns.emplace_back(i);
+      }
+      props = KATANA_CHECKED(rows->SelectColumns(prop_columns));
+      pos = 0;
+      num_rows = rows->num_rows();
+      return true;
+    }
+    rows.reset();
+    props.reset();
+    return false;
+  }
+};
+
+/// The rows of the runs that make the next batch of merged edge properties
+class PropGather {
+public:
+  explicit PropGather(std::vector<RunCursor>* cursors) : cursors_(cursors) {}
+
+  void AddSource(RunCursor* cursor) {
+    cursor->source_offset = num_source_rows_;
+    num_source_rows_ += cursor->num_rows;
+    sources_.emplace_back(cursor->props);
+  }
+
+  katana::Result<void> Add(const RunCursor& cursor) {
+    KATANA_CHECKED(indexes_.Append(cursor.source_offset + cursor.pos));
+    return katana::ResultSuccess();
+  }
+
+  int64_t size() const { return indexes_.length(); }
+
+  /// Write the gathered rows and start the next batch with the row groups the
+  /// cursors are in
+  katana::Result<void> Flush(
+      const std::vector<katana::ParquetWriter::Stream*>& streams) {
+    if (indexes_.length() > 0) {
+      std::shared_ptr<arrow::Array> indexes =
+          KATANA_CHECKED(indexes_.Finish());
+      std::shared_ptr<arrow::Table> sources =
+          KATANA_CHECKED(arrow::ConcatenateTables(sources_));
+      arrow::Datum batch =
+          KATANA_CHECKED(arrow::compute::Take(sources, indexes));
+      KATANA_CHECKED(AppendColumns(batch.table(), streams));
+    }
+    sources_.clear();
+    num_source_rows_ = 0;
+    for (auto& cursor : *cursors_) {
+      if (cursor.props) {
+        AddSource(&cursor);
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  std::vector<RunCursor>* cursors_;
+  std::vector<std::shared_ptr<arrow::Table>> sources_;
+  int64_t num_source_rows_{0};
+  arrow::Int64Builder indexes_;
+};
+
+katana::Result<void>
+WriteZeros(const std::string& path, uint64_t size) {
+  int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+  int ret = ftruncate(fd, size);
+  auto err = katana::ResultErrno();
+  close(fd);
+  if (ret != 0) {
+    return KATANA_ERROR(err, "sizing {}", path);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Copy the local files to dir concurrently
+katana::Result<void>
+UploadFiles(const katana::Uri& dir, const std::vector<std::string>& paths) {
+  std::vector<katana::FileView> views(paths.size());
+  std::vector<std::future<katana::CopyableResult<void>>> stores;
+  for (size_t i = 0, n = paths.size(); i < n; ++i) {
+    KATANA_CHECKED(views[i].MapReadOnly(
+        paths[i], katana::FileView::MapAdvice::kSequential));
+    katana::Uri dest = dir.Join(fs::path(paths[i]).filename().string());
+    stores.emplace_back(katana::FileStoreAsync(
+        dest.string(), views[i].ptr<uint8_t>(), views[i].size()));
+  }
+
+  katana::Result<void> ret = katana::ResultSuccess();
+  for (size_t i = 0, n = stores.size(); i < n; ++i) {
+    // wait for every store, the views must outlive them
+    auto res = stores[i].get();
+    if (!res && ret) {
+      ret = katana::ErrorInfo(res.error()).WithContext("copying {}", paths[i]);
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
+katana::RDGStreamWriter::RDGStreamWriter(
+    std::string rdg_name, Options opts, katana::Uri rdg_dir,
+    std::string work_dir)
+    : rdg_name_(std::move(rdg_name)),
+      opts_(std::move(opts)),
+      rdg_dir_(std::move(rdg_dir)),
+      work_dir_(std::move(work_dir)) {}
+
+katana::RDGStreamWriter::~RDGStreamWriter() {
+  // close the streams before removing their files
+  node_props_.clear();
+  boost::system::error_code ec;
+  fs::remove_all(work_dir_, ec);
+  if (ec) {
+    KATANA_LOG_WARN("removing {}: {}", work_dir_, ec.message());
+  }
+}
+
+katana::Result<std::unique_ptr<katana::RDGStreamWriter>>
+katana::RDGStreamWriter::Make(const std::string& rdg_name, Options opts) {
+  if (opts.max_run_edges == 0 || opts.merge_batch_rows <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "max_run_edges and merge_batch_rows must be positive");
+  }
+
+  KATANA_CHECKED(katana::Create(rdg_name));
+  katana::RDGManifest manifest = KATANA_CHECKED(katana::FindManifest(rdg_name));
+
+  fs::path spill_dir = opts.spill_dir.empty() ? fs::temp_directory_path()
+                                              : fs::path(opts.spill_dir);
+  fs::path work_dir = spill_dir / fs::unique_path("rdg-stream-%%%%-%%%%-%%%%");
+  boost::system::error_code ec;
+  fs::create_directories(work_dir, ec);
+  if (ec) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "creating {}: {}", work_dir.string(),
+        ec.message());
+  }
+
+  // new to access non-public constructor
+  return std::unique_ptr<RDGStreamWriter>(new RDGStreamWriter(
+      rdg_name, std::move(opts), manifest.dir(), work_dir.string()));
+}
+
+std::string
+katana::RDGStreamWriter::WorkPath(const std::string& file_name) const {
+  return (fs::path(work_dir_) / file_name).string();
+}
+
+katana::Result<std::vector<katana::RDGStreamWriter::PropStream>>
+katana::RDGStreamWriter::MakePropStreams(const arrow::Schema& schema) {
+  std::vector<PropStream> streams;
+  for (const auto& field : schema.fields()) {
+    std::string file_name = rdg_dir_.RandFile(field->name()).BaseName();
+    streams.emplace_back(PropStream{
+        field->name(),
+        KATANA_CHECKED(ParquetWriter::Stream::Make(
+            WorkPath(file_name), arrow::schema({field}), opts_.write_opts))});
+  }
+  return streams;
+}
+
+katana::Result<void>
+katana::RDGStreamWriter::AddNodes(const std::shared_ptr<arrow::Table>& props) {
+  if (finished_) {
+    return KATANA_ERROR(ErrorCode::AssertionFailed, "writer is finished");
+  }
+  if (!node_schema_) {
+    node_schema_ = props->schema();
+    node_props_ = KATANA_CHECKED(MakePropStreams(*node_schema_));
+  }
+  KATANA_CHECKED(CheckBatch(node_schema_, props));
+
+  num_nodes_ += props->num_rows();
+  return BufferNodes(props);
+}
+
+katana::Result<void>
+katana::RDGStreamWriter::AddNodes(uint64_t num_nodes) {
+  if (finished_) {
+    return KATANA_ERROR(ErrorCode::AssertionFailed, "writer is finished");
+  }
+  if (!node_schema_) {
+    node_schema_ = arrow::schema({});
+  }
+  num_nodes_ += num_nodes;
+  if (node_schema_->num_fields() == 0) {
+    return katana::ResultSuccess();
+  }
+  while (num_nodes > 0) {
+    int64_t length = std::min<uint64_t>(num_nodes, opts_.merge_batch_rows);
+    std::shared_ptr<arrow::Table> nulls =
+        KATANA_CHECKED(NullTable(node_schema_, length));
+    KATANA_CHECKED(BufferNodes(std::move(nulls)));
+    num_nodes -= length;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGStreamWriter::BufferNodes(std::shared_ptr<arrow::Table> batch) {
+  if (node_props_.empty()) {
+    return katana::ResultSuccess();
+  }
+  node_batch_rows_ += batch->num_rows();
+  node_batches_.emplace_back(std::move(batch));
+  if (node_batch_rows_ >= opts_.merge_batch_rows) {
+    return FlushNodes();
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGStreamWriter::FlushNodes() {
+  if (node_batches_.empty()) {
+    return katana::ResultSuccess();
+  }
+  std::shared_ptr<arrow::Table> batch =
+      KATANA_CHECKED(arrow::ConcatenateTables(node_batches_));
+  node_batches_.clear();
+  node_batch_rows_ = 0;
+
+  std::vector<ParquetWriter::Stream*> streams;
+  for (auto& prop : node_props_) {
+    streams.emplace_back(prop.stream.get());
+  }
+  return AppendColumns(batch, streams);
+}
+
+katana::Result<void>
+katana::RDGStreamWriter::AddEdges(
+    const std::shared_ptr<arrow::UInt32Array>& srcs,
+    const std::shared_ptr<arrow::UInt32Array>& dsts,
+    const std::shared_ptr<arrow::Table>& props) {
+  if (finished_) {
+    return KATANA_ERROR(ErrorCode::AssertionFailed, "writer is finished");
+  }
+  int64_t num_edges = srcs->length();
+  if (dsts->length() != num_edges ||
+      (props && props->num_rows() != num_edges)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "sources, destinations and properties must have the same length");
+  }
+  if (srcs->null_count() != 0 || dsts->null_count() != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "sources and destinations cannot be null");
+  }
+
+  if (!edge_schema_) {
+    edge_schema_ = props ? props->schema() : arrow::schema({});
+  }
+  std::shared_ptr<arrow::Table> edge_props = props;
+  if (edge_props) {
+    KATANA_CHECKED(CheckBatch(edge_schema_, edge_props));
+  } else {
+    edge_props = KATANA_CHECKED(NullTable(edge_schema_, num_edges));
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields{
+      arrow::field(kSrcName, arrow::uint32(), /*nullable=*/false),
+      arrow::field(kDstName, arrow::uint32(), /*nullable=*/false)};
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns{
+      std::make_shared<arrow::ChunkedArray>(srcs),
+      std::make_shared<arrow::ChunkedArray>(dsts)};
+  for (int i = 0, n = edge_props->num_columns(); i < n; ++i) {
+    fields.emplace_back(edge_props->field(i));
+    columns.emplace_back(edge_props->column(i));
+  }
+  run_batches_.emplace_back(
+      arrow::Table::Make(arrow::schema(fields), columns, num_edges));
+
+  num_edges_ += num_edges;
+  run_edges_ += num_edges;
+  if (run_edges_ >= opts_.max_run_edges) {
+    return SpillRun();
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGStreamWriter::SpillRun() {
+  if (run_batches_.empty()) {
+    return katana::ResultSuccess();
+  }
+  std::shared_ptr<arrow::Table> run =
+      KATANA_CHECKED(arrow::ConcatenateTables(run_batches_));
+  run_batches_.clear();
+  run_edges_ = 0;
+
+  // sort_indices is stable, so edges with the same source stay in order
+  std::shared_ptr<arrow::Array> order =
+      KATANA_CHECKED(arrow::compute::SortIndices(*run->column(0)));
+  arrow::Datum sorted = KATANA_CHECKED(arrow::compute::Take(run, order));
+  run.reset();
+
+  // runs are read back once, so spend no time encoding them
+  ParquetWriter::WriteOpts run_opts;
+  run_opts.dictionary = false;
+  run_opts.max_row_group_length = opts_.merge_batch_rows;
+  auto stream = KATANA_CHECKED(ParquetWriter::Stream::Make(
+      WorkPath(fmt::format("run-{:06}.parquet", run_paths_.size())),
+      sorted.table()->schema(), run_opts));
+  KATANA_CHECKED(stream->Append(sorted.table()));
+  std::vector<std::string> files = KATANA_CHECKED(stream->Finish());
+  run_paths_.emplace_back(files[0]);
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<katana::RDGStreamWriter::PropStream>>
+katana::RDGStreamWriter::MergeRuns(const std::string& topology_path) {
+  auto csr = KATANA_CHECKED(
+      CSRFileWriter::Make(topology_path, num_nodes_, num_edges_));
+
+  ParquetReader::ReadOpts read_opts;
+  read_opts.make_canonical = false;
+  auto reader = KATANA_CHECKED(ParquetReader::Make(read_opts));
+
+  std::vector<RunCursor> cursors(run_paths_.size());
+  for (size_t i = 0, n = cursors.size(); i < n; ++i) {
+    cursors[i].run = KATANA_CHECKED(reader->OpenRowGroups(
+        KATANA_CHECKED(katana::Uri::Make(run_paths_[i]))));
+  }
+
+  // the properties are written with the types they read back from the runs
+  // with, which parquet need not preserve
+  std::shared_ptr<arrow::Schema> prop_schema =
+      edge_schema_ ? edge_schema_ : arrow::schema({});
+  if (!cursors.empty()) {
+    const auto& run_fields = cursors[0].run->schema()->fields();
+    prop_schema = arrow::schema(
+        std::vector<std::shared_ptr<arrow::Field>>(
+            run_fields.begin() + 2, run_fields.end()));
+  }
+  std::vector<PropStream> edge_props =
+      KATANA_CHECKED(MakePropStreams(*prop_schema));
+  std::vector<ParquetWriter::Stream*> streams;
+  for (auto& prop : edge_props) {
+    streams.emplace_back(prop.stream.get());
+  }
+  bool has_props = !edge_props.empty();
+  PropGather gather(&cursors);
+
+  // (source, run) so that ties go to the earlier run
+  using HeapEntry = std::pair<uint32_t, size_t>;
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<>> heap;
+  for (size_t i = 0, n = cursors.size(); i < n; ++i) {
+    if (KATANA_CHECKED(cursors[i].Advance())) {
+      if (has_props) {
+        gather.AddSource(&cursors[i]);
+      }
+      heap.emplace(cursors[i].srcs[0], i);
+    }
+  }
+
+  uint64_t num_merged = 0;
+  uint64_t next_node = 0;
+  while (!heap.empty()) {
+    auto [src, i] = heap.top();
+    heap.pop();
+    RunCursor& cursor = cursors[i];
+    uint32_t dst = cursor.dsts[cursor.pos];
+    if (src >= num_nodes_ || dst >= num_nodes_) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "edge from {} to {} but there are only {} nodes", src, dst,
+          num_nodes_);
+    }
+
+    for (; next_node < src; ++next_node) {
+      KATANA_CHECKED(csr->AddOutIndex(num_merged));
+    }
+    KATANA_CHECKED(csr->AddDest(dst));
+    ++num_merged;
+    if (has_props) {
+      KATANA_CHECKED(gather.Add(cursor));
+    }
+
+    if (++cursor.pos == cursor.num_rows) {
+      if (!KATANA_CHECKED(cursor.Advance())) {
+        continue;
+      }
+      if (has_props) {
+        gather.AddSource(&cursor);
+      }
+    }
+    heap.emplace(cursor.srcs[cursor.pos], i);
+
+    if (has_props && gather.size() >= opts_.merge_batch_rows) {
+      KATANA_CHECKED(gather.Flush(streams));
+    }
+  }
+  KATANA_LOG_ASSERT(num_merged == num_edges_);
+
+  for (; next_node < num_nodes_; ++next_node) {
+    KATANA_CHECKED(csr->AddOutIndex(num_merged));
+  }
+  if (has_props) {
+    KATANA_CHECKED(gather.Flush(streams));
+  }
+  KATANA_CHECKED(csr->Finish());
+  return edge_props;
+}
+
+katana::Result<void>
+katana::RDGStreamWriter::Finish(const std::string& command_line) {
+  if (finished_) {
+    return KATANA_ERROR(ErrorCode::AssertionFailed, "writer is finished");
+  }
+  finished_ = true;
+  if (num_nodes_ > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} nodes do not fit in a CSR topology",
+        num_nodes_);
+  }
+
+  katana::RDGManifest manifest =
+      KATANA_CHECKED(katana::FindManifest(rdg_name_));
+  katana::RDGFile handle{
+      KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadWrite))};
+
+  // the files of the RDG, written locally and then copied to it
+  std::vector<std::string> files;
+  std::vector<std::pair<std::string, std::string>> node_prop_files;
+  std::vector<std::pair<std::string, std::string>> edge_prop_files;
+
+  KATANA_CHECKED(FlushNodes());
+  for (auto& prop : node_props_) {
+    std::vector<std::string> prop_files = KATANA_CHECKED(prop.stream->Finish());
+    node_prop_files.emplace_back(prop.name, prop_files[0]);
+    files.insert(files.end(), prop_files.begin(), prop_files.end());
+  }
+  node_props_.clear();
+
+  KATANA_CHECKED(SpillRun());
+  katana::Uri topology_file = MakeTopologyFileName(handle);
+  std::string topology_path = WorkPath(topology_file.BaseName());
+  std::vector<PropStream> edge_props =
+      KATANA_CHECKED(MergeRuns(topology_path));
+  files.emplace_back(topology_path);
+  for (auto& prop : edge_props) {
+    std::vector<std::string> prop_files = KATANA_CHECKED(prop.stream->Finish());
+    edge_prop_files.emplace_back(prop.name, prop_files[0]);
+    files.insert(files.end(), prop_files.begin(), prop_files.end());
+  }
+  for (const auto& path : run_paths_) {
+    boost::system::error_code ec;
+    fs::remove(path, ec);
+  }
+
+  katana::Uri node_types_file = MakeNodeEntityTypeIDArrayFileName(handle);
+  std::string node_types_path = WorkPath(node_types_file.BaseName());
+  KATANA_CHECKED(WriteZeros(
+      node_types_path, num_nodes_ * sizeof(katana::EntityTypeID)));
+  files.emplace_back(node_types_path);
+  katana::Uri edge_types_file = MakeEdgeEntityTypeIDArrayFileName(handle);
+  std::string edge_types_path = WorkPath(edge_types_file.BaseName());
+  KATANA_CHECKED(WriteZeros(
+      edge_types_path, num_edges_ * sizeof(katana::EntityTypeID)));
+  files.emplace_back(edge_types_path);
+
+  KATANA_CHECKED(UploadFiles(rdg_dir_, files));
+
+  katana::RDG rdg;
+  rdg.set_rdg_dir(rdg_dir_);
+  KATANA_CHECKED(
+      rdg.AddCSRTopologyByFile(topology_file, num_nodes_, num_edges_));
+  KATANA_CHECKED(rdg.SetNodeEntityTypeIDArrayFile(node_types_file));
+  KATANA_CHECKED(rdg.SetEdgeEntityTypeIDArrayFile(edge_types_file));
+  for (const auto& [name, path] : node_prop_files) {
+    KATANA_CHECKED(rdg.AddNodePropertyByFile(
+        name, rdg_dir_.Join(fs::path(path).filename().string())));
+  }
+  for (const auto& [name, path] : edge_prop_files) {
+    KATANA_CHECKED(rdg.AddEdgePropertyByFile(
+        name, rdg_dir_.Join(fs::path(path).filename().string())));
+  }
+  return rdg.Store(handle, command_line);
+}
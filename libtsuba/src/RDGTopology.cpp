@@ -105,6 +105,29 @@ katana::RDGTopology::Bind(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDGTopology::BindInPlace(
+    const katana::Uri& metadata_dir, FileView::MapAdvice advice) {
+  if (file_store_bound_) {
+    KATANA_LOG_WARN("topology already bound, nothing to do");
+    return katana::ResultSuccess();
+  }
+  if (path().empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Cannot bind topology with empty path");
+  }
+
+  katana::Uri t_path = metadata_dir.Join(path());
+  KATANA_LOG_DEBUG(
+      "mapping topology file in place at path {}", t_path.string());
+  KATANA_CHECKED(file_storage_.MapReadOnly(t_path.string(), advice));
+
+  file_store_bound_ = true;
+  storage_valid_ = true;
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::RDGTopology::Map() {
   if (file_store_mapped_) {
@@ -163,9 +186,18 @@ katana::RDGTopology::Map() {
 
   cursor += adj_indices_size;
 
-  dests_ = reinterpret_cast<const uint32_t*>(cursor);
+  if (topology_state_ ==
+      katana::RDGTopology::TopologyKind::kCompressedTopology) {
+    compressed_dests_ = reinterpret_cast<const uint8_t*>(cursor);
+
+    // compressed dests are written padded to a uint64_t boundary
+    cursor +=
+        (compressed_dests_size_ + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  } else {
+    dests_ = reinterpret_cast<const uint32_t*>(cursor);
 
-  cursor += (num_edges_ / 2 + num_edges_ % 2);
+    cursor += (num_edges_ / 2 + num_edges_ % 2);
+  }
 
   if (metadata_entry_->edge_index_to_property_index_map_present_) {
     KATANA_LOG_VASSERT(
@@ -352,7 +384,26 @@ katana::RDGTopology::DoStore(
       }
     }
 
-    if (num_edges_) {
+    if (topology_state_ ==
+        katana::RDGTopology::TopologyKind::kCompressedTopology) {
+      if (compressed_dests_size_ > 0) {
+        KATANA_LOG_VASSERT(
+            compressed_dests_ != nullptr,
+            "Cannot store a compressed RDGTopology with null "
+            "compressed_dests_");
+        const auto* raw = compressed_dests_;
+        static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint8_t>);
+
+        KATANA_LOG_DEBUG(
+            "Storing RDGTopology to file. Writing compressed dests, size = {}",
+            compressed_dests_size_);
+
+        auto buf = arrow::Buffer::Wrap(raw, compressed_dests_size_);
+        KATANA_CHECKED_CONTEXT(
+            ff->PaddedWrite(buf, sizeof(uint64_t)),
+            "Failed to write compressed dests to file frame");
+      }
+    } else if (num_edges_) {
       KATANA_LOG_VASSERT(
           dests_ != nullptr, "Cannot store an RDGTopology with null dests_");
       const auto* raw = dests_;
@@ -485,11 +536,14 @@ katana::RDGTopology::DoStore(
         node_condensed_type_id_map_size_,
         (node_condensed_type_id_map_ != nullptr), topology_state_,
         transpose_state_, edge_sort_state_, node_sort_state_);
+    metadata_entry_->compressed_dests_size_ = compressed_dests_size_;
+
+    // storage now holds this topology, later stores need not write it again
+    storage_valid_ = true;
   }
 
   else if (path().empty()) {
     // we don't have an update, but we are persisting in a new location
-    // store our in memory state
 
     KATANA_LOG_DEBUG(
         "Storing RDGTopology to file in new location. TopologyKind={}, "
@@ -500,38 +554,33 @@ katana::RDGTopology::DoStore(
     //TODO: emcginnis need different naming schemes for the optional topologies
     katana::Uri path_uri = MakeTopologyFileName(handle);
 
-    // file store must be bound to make a copy of it in a new location
-    if (!file_store_bound_) {
-      // Can't just use RDGTopology::Bind() here since path() is empty
-      // Must bind to old_path since we are persisting in a new location
-      std::string old_path = metadata_entry_->old_path_;
-      if (old_path.empty()) {
-        return KATANA_ERROR(
-            ErrorCode::InvalidArgument, "Cannot bind topology with empty path");
-      }
+    // the file this topology was loaded from or stored to is unchanged, so
+    // have the storage copy it rather than uploading it again
+    std::string old_path = metadata_entry_->old_path_;
+    if (!old_path.empty()) {
       katana::Uri t_path = current_rdg_dir.Join(old_path);
-
       KATANA_LOG_DEBUG(
-          "binding to entire topology file at path {} for relocation",
-          t_path.string());
-      KATANA_CHECKED_CONTEXT(
-          file_storage_.Bind(t_path.string(), true),
-          "failed binding topology file for copying at path = {}, "
-          "TopologyKind={}, "
+          "copying topology file at path {} for relocation", t_path.string());
+      TSUBA_PTP(internal::FaultSensitivity::Normal);
+      write_group->StartCopy(t_path.string(), path_uri.string());
+      TSUBA_PTP(internal::FaultSensitivity::Normal);
+    } else if (file_store_bound_) {
+      TSUBA_PTP(internal::FaultSensitivity::Normal);
+      // depends on `topology file_storage_` outliving writes
+      // all topology file stores must remain bound until write_group->Finish() completes
+      write_group->StartStore(
+          path_uri.string(), file_storage_.ptr<uint8_t>(),
+          file_storage_.size());
+      TSUBA_PTP(internal::FaultSensitivity::Normal);
+    } else {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Cannot relocate topology with empty path, TopologyKind={}, "
           "TransposeKind={}, EdgeSortKind={}, NodeSortKind={}",
-          t_path.string(), topology_state_, transpose_state_, edge_sort_state_,
+          topology_state_, transpose_state_, edge_sort_state_,
           node_sort_state_);
-
-      file_store_bound_ = true;
     }
 
-    TSUBA_PTP(internal::FaultSensitivity::Normal);
-    // depends on `topology file_storage_` outliving writes
-    // all topology file stores must remain bound until write_group->Finish() completes
-    write_group->StartStore(
-        path_uri.string(), file_storage_.ptr<uint8_t>(), file_storage_.size());
-    TSUBA_PTP(internal::FaultSensitivity::Normal);
-
     // since nothing has changed besides the storage location, just have to update path
     metadata_entry_->path_ = path_uri.BaseName();
   }
@@ -675,6 +724,28 @@ katana::RDGTopology::Make(
       transpose_state, edge_sort_state, node_sort_state);
 }
 
+katana::Result<katana::RDGTopology>
+katana::RDGTopology::Make(
+    const uint64_t* adj_indices, uint64_t num_nodes,
+    const uint8_t* compressed_dests, uint64_t compressed_dests_size,
+    uint64_t num_edges, katana::RDGTopology::TransposeKind transpose_state,
+    katana::RDGTopology::EdgeSortKind edge_sort_state,
+    const uint64_t* edge_index_to_property_index_map,
+    const uint64_t* node_index_to_property_index_map) {
+  RDGTopology topo = RDGTopology();
+  topo.compressed_dests_ = compressed_dests;
+  topo.compressed_dests_size_ = compressed_dests_size;
+  topo.edge_index_to_property_index_map_ = edge_index_to_property_index_map;
+  topo.node_index_to_property_index_map_ = node_index_to_property_index_map;
+
+  // when we make from in memory objects, mark storage as invalid
+  topo.storage_valid_ = false;
+  return DoMake(
+      std::move(topo), adj_indices, num_nodes, nullptr, num_edges,
+      TopologyKind::kCompressedTopology, transpose_state, edge_sort_state,
+      NodeSortKind::kAny);
+}
+
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::Make(
     const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
@@ -719,6 +790,7 @@ katana::RDGTopology::Make(katana::PartitionTopologyMetadataEntry* entry) {
       topo.metadata_entry_->edge_condensed_type_id_map_size_;
   topo.node_condensed_type_id_map_size_ =
       topo.metadata_entry_->node_condensed_type_id_map_size_;
+  topo.compressed_dests_size_ = topo.metadata_entry_->compressed_dests_size_;
 
   // when we make from storage primitives, we can say the storage is up to date
   topo.storage_valid_ = true;
@@ -730,8 +802,13 @@ size_t
 katana::RDGTopology::GetGraphSize() const {
   /// version, sizeof_edge_data, num_nodes, num_edges
   constexpr int mandatory_fields = 4;
-  size_t graphsize = (mandatory_fields + num_nodes_) * sizeof(uint64_t) +
-                     (num_edges_ * sizeof(uint32_t));
+  size_t graphsize = (mandatory_fields + num_nodes_) * sizeof(uint64_t);
+  if (topology_state_ ==
+      katana::RDGTopology::TopologyKind::kCompressedTopology) {
+    graphsize += compressed_dests_size_;
+  } else {
+    graphsize += (num_edges_ * sizeof(uint32_t));
+  }
 
   KATANA_LOG_DEBUG("Base graph size = {}", graphsize);
 
@@ -90,6 +90,13 @@ public:
     return katana::ResultSuccess();
   }
 
+  /// mark every topology invalid, e.g., after the graph they describe changed
+  void InvalidateAll() {
+    for (size_t i = 0; i < num_topologies_; i++) {
+      topology_set_.at(i).set_invalid();
+    }
+  }
+
   katana::Result<void> UnbindAllTopologyFile() {
     for (size_t i = 0; i < num_topologies_; i++) {
       KATANA_CHECKED(topology_set_.at(i).unbind_file_storage());
@@ -0,0 +1,125 @@
+#include "katana/RDKSubstructureIndexPrimitive.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KATANA_SCREEN_X86 1
+#include <immintrin.h>
+#endif
+
+#include "katana/Loops.h"
+
+namespace {
+
+/// Entries screened per iteration of the parallel loop
+constexpr uint64_t kScreenBlock = 1024;
+
+/// Whether row has every bit of query, both of words words, a multiple of
+/// kFingerprintWordAlign
+using ContainsFn = bool (*)(const uint64_t*, const uint64_t*, uint64_t);
+
+bool
+ScalarContains(const uint64_t* row, const uint64_t* query, uint64_t words) {
+  for (uint64_t w = 0; w < words; ++w) {
+    if ((query[w] & ~row[w]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef KATANA_SCREEN_X86
+
+__attribute__((target("avx2"))) bool
+AVX2Contains(const uint64_t* row, const uint64_t* query, uint64_t words) {
+  for (uint64_t w = 0; w < words; w += 4) {
+    __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + w));
+    __m256i q =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(query + w));
+    // Whether the bits of q not in r are none
+    if (!_mm256_testc_si256(r, q)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+__attribute__((target("avx512f"))) bool
+AVX512Contains(const uint64_t* row, const uint64_t* query, uint64_t words) {
+  for (uint64_t w = 0; w < words; w += 8) {
+    __m512i q = _mm512_loadu_si512(query + w);
+    // Not _mm512_andnot_si512, whose gcc implementation trips
+    // -Wuninitialized
+    __m512i common = _mm512_and_si512(_mm512_loadu_si512(row + w), q);
+    if (_mm512_cmpneq_epi64_mask(common, q) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif
+
+ContainsFn
+DetectContains() {
+#ifdef KATANA_SCREEN_X86
+  if (__builtin_cpu_supports("avx512f")) {
+    return AVX512Contains;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return AVX2Contains;
+  }
+#endif
+  return ScalarContains;
+}
+
+ContainsFn
+SelectedContains() {
+  static const ContainsFn contains = DetectContains();
+  return contains;
+}
+
+}  // namespace
+
+static_assert(
+    katana::RDKSubstructureIndexPrimitive::kFingerprintWordAlign % 8 == 0,
+    "rows must be a whole number of 512 bit vectors");
+
+std::vector<uint64_t>
+katana::RDKSubstructureIndexPrimitive::Screen(
+    const katana::DynamicBitset& query) const {
+  uint64_t words = fingerprint_words();
+  const auto& query_vec = query.get_vec();
+  std::vector<uint64_t> query_words(words);
+  for (uint64_t w = 0; w < query_vec.size(); ++w) {
+    uint64_t word = query_vec[w];
+    if (w >= words) {
+      // No fingerprint has a bit past its size
+      if (word != 0) {
+        return {};
+      }
+      continue;
+    }
+    query_words[w] = word;
+  }
+
+  ContainsFn contains = SelectedContains();
+  uint64_t num_rows = num_fingerprints();
+  uint64_t num_blocks = (num_rows + kScreenBlock - 1) / kScreenBlock;
+  std::vector<std::vector<uint64_t>> block_matches(num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t end = std::min((block + 1) * kScreenBlock, num_rows);
+        for (uint64_t e = block * kScreenBlock; e < end; ++e) {
+          if (contains(Fingerprint(e), query_words.data(), words)) {
+            block_matches[block].emplace_back(e);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<uint64_t> matches;
+  for (const auto& block : block_matches) {
+    matches.insert(matches.end(), block.begin(), block.end());
+  }
+  return matches;
+}
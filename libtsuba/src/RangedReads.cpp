@@ -0,0 +1,71 @@
+#include "RangedReads.h"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <optional>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+/// The rounds of concurrent requests a read is split into before its parts
+/// grow past FileStorage::ReadPartSize
+constexpr uint64_t kReadRounds = 4;
+
+}  // namespace
+
+uint64_t
+katana::ReadPartSize(const FileStorage* fs, uint64_t size) {
+  uint64_t part_size = fs->ReadPartSize();
+  if (part_size == 0 || size <= part_size) {
+    return size;
+  }
+  uint64_t max_parts =
+      kReadRounds * std::max<uint64_t>(fs->MaxConcurrentReads(), 1);
+  return std::max(part_size, (size + max_parts - 1) / max_parts);
+}
+
+katana::Result<void>
+katana::GetInParts(
+    FileStorage* fs, const std::string& uri, uint64_t begin, uint64_t size,
+    uint8_t* result_buf) {
+  uint64_t part_size = ReadPartSize(fs, size);
+  if (part_size == size) {
+    return fs->GetMultiSync(uri, begin, size, result_buf);
+  }
+  uint64_t max_outstanding = std::max<uint32_t>(fs->MaxConcurrentReads(), 1);
+
+  struct Part {
+    uint64_t begin;
+    std::future<katana::CopyableResult<void>> read;
+  };
+  std::deque<Part> outstanding;
+  std::optional<katana::ErrorInfo> error;
+  auto finish_oldest = [&]() {
+    Part& part = outstanding.front();
+    if (auto res = part.read.get(); !res && !error) {
+      error = katana::ErrorInfo(res.error())
+                  .WithContext("reading {} at {}", uri, part.begin);
+    }
+    outstanding.pop_front();
+  };
+
+  // n.b., parts are read into result_buf, so drain outstanding even after a
+  // part fails
+  for (uint64_t off = 0; off < size && !error; off += part_size) {
+    if (outstanding.size() == max_outstanding) {
+      finish_oldest();
+    }
+    uint64_t len = std::min(part_size, size - off);
+    outstanding.emplace_back(Part{
+        begin + off, fs->GetAsync(uri, begin + off, len, result_buf + off)});
+  }
+  while (!outstanding.empty()) {
+    finish_oldest();
+  }
+  if (error) {
+    return std::move(error.value());
+  }
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,29 @@
+#ifndef KATANA_LIBTSUBA_RANGEDREADS_H_
+#define KATANA_LIBTSUBA_RANGEDREADS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/FileStorage.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The size of the parts a read of size bytes from fs is split into: size if
+/// fs reads ranges with one request, otherwise at least fs->ReadPartSize(),
+/// growing with size so that the read takes a few rounds of
+/// fs->MaxConcurrentReads() requests rather than many rounds of small ones.
+KATANA_EXPORT uint64_t ReadPartSize(const FileStorage* fs, uint64_t size);
+
+/// Read [begin, begin + size) of uri from fs into result_buf with GetAsync
+/// requests of parts of ReadPartSize(fs, size) bytes, keeping at most
+/// fs->MaxConcurrentReads() of them outstanding. Every request issued has
+/// completed on return, whether or not the read succeeded.
+KATANA_EXPORT Result<void> GetInParts(
+    FileStorage* fs, const std::string& uri, uint64_t begin, uint64_t size,
+    uint8_t* result_buf);
+
+}  // namespace katana
+
+#endif
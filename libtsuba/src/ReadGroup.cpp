@@ -5,6 +5,11 @@ katana::ReadGroup::AddOp(
     std::future<katana::CopyableResult<void>> future, std::string file,
     const std::function<katana::CopyableResult<void>()>& on_complete) {
   async_op_group_.AddOp(std::move(future), std::move(file), on_complete);
+  // errors are reported by Finish
+  while (max_outstanding_ != 0 &&
+         async_op_group_.num_pending() > max_outstanding_) {
+    async_op_group_.FinishOne();
+  }
 }
 
 katana::Result<void>
@@ -0,0 +1,59 @@
+#include "katana/TxnContext.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "katana/Logging.h"
+
+katana::TxnContext::~TxnContext() {
+  if (!pending_commits_.empty()) {
+    KATANA_LOG_WARN(
+        "{} graphs had deferred commits that were never committed",
+        pending_commits_.size());
+  }
+}
+
+void
+katana::TxnContext::DeferCommit(
+    const void* graph, const std::string& rdg_dir, std::string command_line,
+    DeferredCommit commit) {
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  auto it = std::find_if(
+      pending_commits_.begin(), pending_commits_.end(),
+      [&](const PendingCommit& pending) { return pending.graph == graph; });
+  if (it == pending_commits_.end()) {
+    pending_commits_.emplace_back(
+        PendingCommit{graph, rdg_dir, {}, std::move(commit)});
+    it = std::prev(pending_commits_.end());
+  }
+  it->command_lines.emplace_back(std::move(command_line));
+}
+
+katana::Result<void>
+katana::TxnContext::CommitBatch() {
+  std::vector<PendingCommit> pending_commits;
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    std::swap(pending_commits, pending_commits_);
+    batching_ = false;
+  }
+
+  katana::Result<void> ret = katana::ResultSuccess();
+  for (const PendingCommit& pending : pending_commits) {
+    auto res = pending.commit(pending.command_lines);
+    if (!res) {
+      KATANA_LOG_ERROR(
+          "group commit of {} returned {}", pending.rdg_dir, res.error());
+      ret = res.error().WithContext("group commit of {}", pending.rdg_dir);
+    }
+  }
+  return ret;
+}
+
+void
+katana::TxnContext::AbortBatch() {
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  pending_commits_.clear();
+  batching_ = false;
+}
@@ -29,10 +29,8 @@ katana::WriteGroup::Finish() {
   return async_op_group_.Finish();
 }
 
-void
-katana::WriteGroup::AddOp(
-    std::future<katana::CopyableResult<void>> future, std::string file,
-    uint64_t accounted_size) {
+uint64_t
+katana::WriteGroup::ReserveOutstanding(uint64_t accounted_size) {
   if (accounted_size > kMaxOutstandingSize) {
     accounted_size = kMaxOutstandingSize;
   }
@@ -45,14 +43,47 @@ katana::WriteGroup::AddOp(
       }
     }
   }
-  async_op_group_.AddOp(
-      std::move(future), std::move(file),
-      [wg = this, accounted_size]() -> katana::CopyableResult<void> {
+  outstanding_size_ += accounted_size;
+  return accounted_size;
+}
+
+void
+katana::WriteGroup::AddReservedOp(
+    std::future<katana::CopyableResult<void>> future, std::string file,
+    uint64_t accounted_size) {
+  // release the bytes when the op is waited for, whether it failed or not
+  auto released = std::async(
+      std::launch::deferred,
+      [wg = this, accounted_size, future = std::move(future)]() mutable {
+        katana::CopyableResult<void> res = future.get();
         wg->outstanding_size_ -= accounted_size;
+        return res;
+      });
+  async_op_group_.AddOp(
+      std::move(released), std::move(file),
+      []() -> katana::CopyableResult<void> {
         return katana::CopyableResultSuccess();
       });
 }
 
+void
+katana::WriteGroup::AddOp(
+    std::future<katana::CopyableResult<void>> future, std::string file,
+    uint64_t accounted_size) {
+  AddReservedOp(
+      std::move(future), std::move(file), ReserveOutstanding(accounted_size));
+}
+
+void
+katana::WriteGroup::StartOp(
+    std::function<katana::CopyableResult<void>()> fn, std::string file,
+    uint64_t accounted_size) {
+  accounted_size = ReserveOutstanding(accounted_size);
+  AddReservedOp(
+      std::async(std::launch::async, std::move(fn)), std::move(file),
+      accounted_size);
+}
+
 // shared pointer because FileFrames are often held that way due do the way
 // they're used with arrow
 void
@@ -66,3 +97,14 @@ katana::WriteGroup::StartStore(std::shared_ptr<katana::FileFrame> ff) {
   });
   AddOp(std::move(future), file, size);
 }
+
+void
+katana::WriteGroup::StartCopy(
+    const std::string& source_uri, const std::string& dest_uri) {
+  StartOp(
+      [source_uri, dest_uri]() -> katana::CopyableResult<void> {
+        KATANA_CHECKED(katana::FileCopy(source_uri, dest_uri));
+        return katana::CopyableResultSuccess();
+      },
+      dest_uri, 0);
+}
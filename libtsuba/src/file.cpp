@@ -13,38 +13,150 @@
 #include <iostream>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "GlobalState.h"
+#include "RangedReads.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/Metrics.h"
 #include "katana/Platform.h"
+#include "katana/ProgressTracer.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
+
+namespace {
+
+/// Drop what the cache has of uri, which is about to change
+void
+ForgetCached(katana::FileStorage* fs, const std::string& uri) {
+  if (katana::FileCache* cache = katana::GlobalState::Get().Cache(fs)) {
+    cache->Forget(uri);
+  }
+}
+
+/// The metrics of the bytes moved by transfers, by direction
+struct TransferMetrics {
+  katana::MetricCounter& bytes;
+  katana::MetricCounter& requests;
+  katana::MetricCounter& errors;
+
+  explicit TransferMetrics(const char* op)
+      : bytes(katana::GetMetrics().Counter(
+            "katana_storage_bytes_total", "Bytes moved to or from storage",
+            {{"op", op}})),
+        requests(katana::GetMetrics().Counter(
+            "katana_storage_requests_total", "Requests to storage",
+            {{"op", op}})),
+        errors(katana::GetMetrics().Counter(
+            "katana_storage_errors_total", "Requests to storage that failed",
+            {{"op", op}})) {}
+
+  void Record(uint64_t size, bool ok) {
+    requests.Add(1);
+    if (ok) {
+      bytes.Add(size);
+    } else {
+      errors.Add(1);
+    }
+  }
+};
+
+TransferMetrics&
+ReadMetrics() {
+  static TransferMetrics metrics("get");
+  return metrics;
+}
+
+TransferMetrics&
+WriteMetrics() {
+  static TransferMetrics metrics("store");
+  return metrics;
+}
+
+TransferMetrics&
+CopyMetrics() {
+  static TransferMetrics metrics("copy");
+  return metrics;
+}
+
+/// Finish the span of a synchronous transfer of size bytes
+katana::Result<void>
+FinishTransfer(
+    katana::OperationSpan* span, TransferMetrics* metrics, uint64_t size,
+    katana::Result<void>&& res) {
+  if (!res) {
+    span->SetError(fmt::format("{}", res.error()));
+  }
+  span->Finish(res ? size : 0);
+  metrics->Record(size, static_cast<bool>(res));
+  return std::move(res);
+}
+
+}  // namespace
 
 katana::Result<void>
 katana::FileStore(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
+  OperationSpan span("file store", {{"uri", uri}});
+  FileStorage* fs = FS(uri);
+  ForgetCached(fs, uri);
+  return FinishTransfer(
+      &span, &WriteMetrics(), size,
+      fs->PutMultiSync(uri, static_cast<const uint8_t*>(data), size));
 }
 
 std::future<katana::CopyableResult<void>>
 katana::FileStoreAsync(
     const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutAsync(uri, static_cast<const uint8_t*>(data), size);
+  FileStorage* fs = FS(uri);
+  ForgetCached(fs, uri);
+  // asynchronous transfers are counted when they are issued
+  WriteMetrics().Record(size, true);
+  return fs->PutAsync(uri, static_cast<const uint8_t*>(data), size);
 }
 
 katana::Result<void>
 katana::FileGet(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetMultiSync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  OperationSpan span("file get", {{"uri", uri}, {"offset", begin}});
+  FileStorage* fs = FS(uri);
+  if (FileCache* cache = GlobalState::Get().Cache(fs)) {
+    span.SetTags({{"file_cache", true}});
+    return FinishTransfer(
+        &span, &ReadMetrics(), size,
+        cache->Get(fs, uri, begin, size, static_cast<uint8_t*>(result_buffer)));
+  }
+  if (uint64_t part_size = ReadPartSize(fs, size); part_size < size) {
+    span.SetTags({{"part_size", part_size}});
+  }
+  return FinishTransfer(
+      &span, &ReadMetrics(), size,
+      GetInParts(fs, uri, begin, size, static_cast<uint8_t*>(result_buffer)));
 }
 
 std::future<katana::CopyableResult<void>>
 katana::FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetAsync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  FileStorage* fs = FS(uri);
+  ReadMetrics().Record(size, true);
+  if (FileCache* cache = GlobalState::Get().Cache(fs)) {
+    return cache->GetAsync(
+        fs, uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  }
+  auto* buf = static_cast<uint8_t*>(result_buffer);
+  if (ReadPartSize(fs, size) == size) {
+    return fs->GetAsync(uri, begin, size, buf);
+  }
+  return std::async(
+      std::launch::async,
+      [fs, uri, begin, size, buf]() -> katana::CopyableResult<void> {
+        if (auto res = GetInParts(fs, uri, begin, size, buf); !res) {
+          return res.error();
+        }
+        return katana::CopyableResultSuccess();
+      });
 }
 
 katana::Result<void>
@@ -59,9 +171,34 @@ katana::FileRemoteCopy(
     return ErrorCode::NotImplemented;
   }
 
+  ForgetCached(dest_fs, dest_uri);
   return dest_fs->RemoteCopy(source_uri, dest_uri, begin, size);
 }
 
+katana::Result<void>
+katana::FileCopy(const std::string& source_uri, const std::string& dest_uri) {
+  OperationSpan span("file copy", {{"uri", source_uri}, {"dest", dest_uri}});
+  StatBuf stat;
+  KATANA_CHECKED(FileStat(source_uri, &stat));
+
+  FileStorage* source_fs = FS(source_uri);
+  FileStorage* dest_fs = FS(dest_uri);
+  if (source_fs == dest_fs) {
+    ForgetCached(dest_fs, dest_uri);
+    return FinishTransfer(
+        &span, &CopyMetrics(), stat.size,
+        dest_fs->RemoteCopy(source_uri, dest_uri, 0, stat.size));
+  }
+
+  // the bytes have to go through this host to reach the other back-end
+  span.SetTags({{"remote", false}});
+  std::vector<uint8_t> buf(stat.size);
+  KATANA_CHECKED(FileGet(source_uri, buf.data(), 0, buf.size()));
+  return FinishTransfer(
+      &span, &CopyMetrics(), stat.size,
+      FileStore(dest_uri, buf.data(), buf.size()));
+}
+
 katana::Result<void>
 katana::FileStat(const std::string& uri, StatBuf* s_buf) {
   return FS(uri)->Stat(uri, s_buf);
@@ -78,5 +215,9 @@ katana::Result<void>
 katana::FileDelete(
     const std::string& directory,
     const std::unordered_set<std::string>& files) {
-  return FS(directory)->Delete(directory, files);
+  FileStorage* fs = FS(directory);
+  for (const std::string& file : files) {
+    ForgetCached(fs, katana::Uri::JoinPath(directory, file));
+  }
+  return fs->Delete(directory, files);
 }
@@ -0,0 +1,236 @@
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "FileCache.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Remote storage held in memory that counts the reads it serves
+class MemStorage : public katana::FileStorage {
+public:
+  MemStorage() : FileStorage("mem://") {}
+
+  std::map<std::string, std::vector<uint8_t>> files;
+  uint64_t num_gets{0};
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(
+      const std::string& uri, katana::StatBuf* s_buf) override {
+    auto it = files.find(uri);
+    if (it == files.end()) {
+      return katana::ErrorCode::NotFound;
+    }
+    s_buf->size = it->second.size();
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    auto it = files.find(uri);
+    if (it == files.end() || start + size > it->second.size()) {
+      return katana::ErrorCode::InvalidArgument;
+    }
+    ++num_gets;
+    std::memcpy(result_buf, it->second.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    files[uri].assign(data, data + size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return Ready(PutMultiSync(uri, data, size));
+  }
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return Ready(GetMultiSync(uri, start, size, result_buf));
+  }
+
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return Ready(katana::ErrorCode::NotImplemented);
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+private:
+  static std::future<katana::CopyableResult<void>> Ready(
+      katana::Result<void> res) {
+    std::promise<katana::CopyableResult<void>> promise;
+    if (res) {
+      promise.set_value(katana::CopyableResultSuccess());
+    } else {
+      promise.set_value(res.error());
+    }
+    return promise.get_future();
+  }
+};
+
+constexpr uint64_t kBlockSize = katana::FileCache::kBlockSize;
+const std::string kUri = "mem://bucket/rdg/topology-0";
+
+std::vector<uint8_t>
+MakeData(uint64_t size, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<uint8_t> data(size);
+  for (auto& byte : data) {
+    byte = gen();
+  }
+  return data;
+}
+
+katana::Result<void>
+CheckRead(
+    katana::FileCache* cache, MemStorage* storage, uint64_t start,
+    uint64_t size) {
+  std::vector<uint8_t> buf(size);
+  KATANA_CHECKED(cache->Get(storage, kUri, start, size, buf.data()));
+  KATANA_LOG_ASSERT(
+      std::memcmp(buf.data(), storage->files[kUri].data() + start, size) == 0);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestReadThrough(const std::string& dir) {
+  MemStorage storage;
+  storage.files[kUri] = MakeData(2 * kBlockSize + 12345, 1);
+
+  katana::FileCache::Options opts;
+  opts.dir = dir;
+  auto cache = KATANA_CHECKED(katana::FileCache::Make(opts));
+
+  // the first two blocks come from storage, then from the cache
+  KATANA_CHECKED(CheckRead(cache.get(), &storage, 100, kBlockSize + 100));
+  KATANA_LOG_ASSERT(storage.num_gets == 2);
+  KATANA_LOG_ASSERT(cache->misses() == 2 && cache->hits() == 0);
+  KATANA_CHECKED(CheckRead(cache.get(), &storage, 0, 2 * kBlockSize));
+  KATANA_LOG_ASSERT(storage.num_gets == 2);
+  KATANA_LOG_ASSERT(cache->hits() == 2);
+
+  // the last, short block
+  uint64_t file_size = storage.files[kUri].size();
+  KATANA_CHECKED(CheckRead(cache.get(), &storage, 0, file_size));
+  KATANA_LOG_ASSERT(storage.num_gets == 3);
+
+  std::vector<uint8_t> buf(2 * katana::kBlockSize);
+  auto read = cache->GetAsync(&storage, kUri, kBlockSize, 4096, buf.data());
+  KATANA_CHECKED(read.get());
+  KATANA_LOG_ASSERT(
+      std::memcmp(buf.data(), storage.files[kUri].data() + kBlockSize, 4096) ==
+      0);
+
+  // like LocalStorage, reads may end less than a block past the end
+  KATANA_CHECKED(
+      cache->Get(&storage, kUri, file_size - 10, 100, buf.data()));
+  KATANA_LOG_ASSERT(!cache->Get(
+      &storage, kUri, file_size + 2 * katana::kBlockSize, 100, buf.data()));
+  KATANA_LOG_ASSERT(storage.num_gets == 3);
+
+  // another cache in the same directory finds the blocks
+  cache.reset();
+  cache = KATANA_CHECKED(katana::FileCache::Make(opts));
+  KATANA_CHECKED(CheckRead(cache.get(), &storage, 0, file_size));
+  KATANA_LOG_ASSERT(storage.num_gets == 3);
+
+  // forgotten files are read again, and a new size is a new file
+  storage.files[kUri] = MakeData(kBlockSize + 1, 2);
+  cache->Forget(kUri);
+  KATANA_CHECKED(CheckRead(cache.get(), &storage, 0, kBlockSize + 1));
+  KATANA_LOG_ASSERT(storage.num_gets == 5);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestEviction(const std::string& dir) {
+  MemStorage storage;
+  storage.files[kUri] = MakeData(4 * kBlockSize, 3);
+
+  katana::FileCache::Options opts;
+  opts.dir = dir;
+  opts.capacity = 2 * kBlockSize + 4096;
+  auto cache = KATANA_CHECKED(katana::FileCache::Make(opts));
+
+  KATANA_CHECKED(CheckRead(cache.get(), &storage, 0, 4 * kBlockSize));
+  KATANA_LOG_ASSERT(storage.num_gets == 4);
+  KATANA_LOG_ASSERT(cache->size() <= opts.capacity);
+
+  // the last two blocks are the most recently used
+  KATANA_CHECKED(
+      CheckRead(cache.get(), &storage, 2 * kBlockSize, 2 * kBlockSize));
+  KATANA_LOG_ASSERT(storage.num_gets == 4);
+  KATANA_CHECKED(CheckRead(cache.get(), &storage, 0, 1));
+  KATANA_LOG_ASSERT(storage.num_gets == 5);
+
+  // a smaller cache in the same directory evicts on start
+  opts.capacity = kBlockSize + 4096;
+  cache = KATANA_CHECKED(katana::FileCache::Make(opts));
+  KATANA_LOG_ASSERT(cache->size() <= opts.capacity);
+  uint64_t num_files = 0;
+  for (fs::directory_iterator it(dir), end; it != end; ++it) {
+    ++num_files;
+  }
+  KATANA_LOG_ASSERT(num_files == 1);
+
+  opts.capacity = 0;
+  KATANA_LOG_ASSERT(!katana::FileCache::Make(opts));
+  opts.capacity = kBlockSize;
+  opts.dir.clear();
+  KATANA_LOG_ASSERT(!katana::FileCache::Make(opts));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& dir) {
+  KATANA_CHECKED(TestReadThrough((fs::path(dir) / "read-through").string()));
+  KATANA_CHECKED(TestEviction((fs::path(dir) / "eviction").string()));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  return 0;
+}
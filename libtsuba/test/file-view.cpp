@@ -1,3 +1,7 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "katana/FileView.h"
@@ -31,9 +35,54 @@ TestEmpty(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestReadAhead(const std::string& path) {
+  constexpr int64_t kPageSize = INT64_C(1) << 20;
+  constexpr int64_t kNumPages = 8;
+  constexpr int64_t kReadSize = 64 << 10;
+
+  auto uri = KATANA_CHECKED(katana::Uri::MakeFromFile(path));
+  auto file_uri = uri.Join("read_ahead_file");
+  std::vector<uint8_t> data(kNumPages * kPageSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + i / 4096);
+  }
+  KATANA_CHECKED(katana::FileStore(file_uri.string(), data));
+
+  std::vector<uint8_t> buf(kReadSize);
+  auto check_read = [&](katana::FileView* fv, int64_t off) {
+    auto res = fv->ReadAt(off, kReadSize, buf.data());
+    KATANA_LOG_ASSERT(res.ok() && *res == kReadSize);
+    KATANA_LOG_ASSERT(std::memcmp(buf.data(), &data[off], kReadSize) == 0);
+  };
+
+  // after the first read of a sequential scan everything has been fetched
+  // ahead of time
+  katana::FileView fv;
+  KATANA_CHECKED(fv.Bind(file_uri.string(), 0, 0, true));
+  for (int64_t off = 0; off < 3 * kPageSize; off += kReadSize) {
+    check_read(&fv, off);
+  }
+  KATANA_LOG_ASSERT(fv.read_misses() == 1);
+  KATANA_LOG_ASSERT(fv.read_hits() == 3 * kPageSize / kReadSize - 1);
+
+  // reads that skip backwards are not a scan
+  katana::FileView random;
+  KATANA_CHECKED(random.Bind(file_uri.string(), 0, 0, true));
+  random.set_read_ahead_max_pages(0);
+  for (int64_t page = kNumPages - 1; page > 0; page -= 2) {
+    check_read(&random, page * kPageSize);
+  }
+  KATANA_LOG_ASSERT(random.read_misses() == kNumPages / 2);
+  KATANA_LOG_ASSERT(random.read_hits() == 0);
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestEmpty(path), "TestEmpty");
+  KATANA_CHECKED_CONTEXT(TestReadAhead(path), "TestReadAhead");
 
   return katana::ResultSuccess();
 }
@@ -0,0 +1,142 @@
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "LocalAsyncIO.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct FreeDeleter {
+  void operator()(uint8_t* ptr) const { std::free(ptr); }
+};
+using AlignedBuffer = std::unique_ptr<uint8_t[], FreeDeleter>;
+
+AlignedBuffer
+MakeAlignedBuffer(uint64_t size) {
+  uint64_t alignment = katana::LocalAsyncIO::kDirectIOAlignment;
+  uint64_t rounded = (size + alignment - 1) / alignment * alignment;
+  return AlignedBuffer(
+      static_cast<uint8_t*>(std::aligned_alloc(alignment, rounded)));
+}
+
+std::vector<uint8_t>
+MakeData(uint64_t size) {
+  std::mt19937_64 gen(size);
+  std::vector<uint8_t> data(size);
+  for (auto& byte : data) {
+    byte = gen();
+  }
+  return data;
+}
+
+katana::Result<void>
+TestRoundTrip(
+    katana::LocalAsyncIO* io, const std::string& dir, uint64_t size,
+    const std::string& name) {
+  std::string path = dir + "/" + name;
+  std::vector<uint8_t> data = MakeData(size);
+  KATANA_CHECKED(io->Write(path, data.data(), data.size()).get());
+  KATANA_LOG_ASSERT(fs::file_size(path) == size);
+
+  // Whole file, into a buffer that allows direct I/O
+  AlignedBuffer whole = MakeAlignedBuffer(size);
+  KATANA_CHECKED(io->Read(path, 0, size, whole.get()).get());
+  KATANA_LOG_ASSERT(std::memcmp(whole.get(), data.data(), size) == 0);
+
+  // Unaligned pieces, all in flight at once
+  std::mt19937_64 gen(size + 1);
+  std::vector<std::vector<uint8_t>> pieces;
+  std::vector<uint64_t> starts;
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  for (int i = 0; i < 32; ++i) {
+    uint64_t start = gen() % size;
+    uint64_t length = gen() % (size - start) + 1;
+    starts.emplace_back(start);
+    pieces.emplace_back(length);
+    futures.emplace_back(
+        io->Read(path, start, length, pieces.back().data()));
+  }
+  for (size_t i = 0; i < futures.size(); ++i) {
+    KATANA_CHECKED(futures[i].get());
+    KATANA_LOG_ASSERT(
+        std::memcmp(
+            pieces[i].data(), data.data() + starts[i], pieces[i].size()) == 0);
+  }
+
+  // Reads may run a little past the end of a file, but not a lot
+  std::vector<uint8_t> past_end(katana::kBlockSize / 2);
+  KATANA_CHECKED(
+      io->Read(path, size - 1, past_end.size(), past_end.data()).get());
+  KATANA_LOG_ASSERT(past_end[0] == data[size - 1]);
+  std::vector<uint8_t> far_past_end(4 * katana::kBlockSize);
+  KATANA_LOG_ASSERT(
+      !io->Read(path, size, far_past_end.size(), far_past_end.data()).get());
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestBackend(const std::string& dir, katana::LocalAsyncIO::Options opts) {
+  auto io = KATANA_CHECKED(katana::LocalAsyncIO::Make(opts));
+  KATANA_LOG_DEBUG("testing with io_uring: {}", io->uses_io_uring());
+
+  KATANA_CHECKED(TestRoundTrip(io.get(), dir, 1, "one"));
+  KATANA_CHECKED(TestRoundTrip(io.get(), dir, 12345, "small"));
+  KATANA_CHECKED(TestRoundTrip(
+      io.get(), dir, 3 * katana::LocalAsyncIO::kChunkSize + 12345, "large"));
+
+  std::vector<uint8_t> buf(16);
+  KATANA_LOG_ASSERT(
+      !io->Read(dir + "/missing", 0, buf.size(), buf.data()).get());
+  KATANA_CHECKED(io->Write(dir + "/empty", buf.data(), 0).get());
+  KATANA_LOG_ASSERT(fs::file_size(dir + "/empty") == 0);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& dir) {
+  fs::create_directories(dir);
+
+  katana::LocalAsyncIO::Options opts;
+  // Exercise direct I/O even on small files
+  opts.direct_io_threshold = 1;
+  opts.queue_depth = 8;
+  KATANA_CHECKED_CONTEXT(TestBackend(dir, opts), "io_uring");
+
+  opts.use_io_uring = false;
+  opts.num_threads = 3;
+  KATANA_CHECKED_CONTEXT(TestBackend(dir, opts), "threads");
+
+  opts.direct_io_threshold = 0;
+  KATANA_CHECKED_CONTEXT(TestBackend(dir, opts), "buffered threads");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  return 0;
+}
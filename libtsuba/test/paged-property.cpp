@@ -0,0 +1,124 @@
+#include <arrow/chunked_array.h>
+#include <arrow/io/file.h>
+#include <arrow/type_fwd.h>
+#include <boost/filesystem.hpp>
+#include <parquet/arrow/writer.h>
+
+#include "katana/PagedProperty.h"
+#include "katana/ParquetReader.h"
+#include "katana/Result.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr int64_t kNumRows = 1000;
+constexpr int64_t kRowGroupSize = 64;
+
+katana::Result<katana::Uri>
+WriteProperty(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("paged.parquet");
+
+  arrow::LargeStringBuilder builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    if (i % 10 == 3) {
+      KATANA_CHECKED(builder.AppendNull());
+    } else {
+      KATANA_CHECKED(builder.Append(fmt::format("paged-row-{}", i)));
+    }
+  }
+  std::shared_ptr<arrow::Array> values;
+  KATANA_CHECKED(builder.Finish(&values));
+
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("values", arrow::large_utf8())}),
+      {std::make_shared<arrow::ChunkedArray>(values)});
+
+  auto out = KATANA_CHECKED(arrow::io::FileOutputStream::Open(uri.path()));
+  KATANA_CHECKED(parquet::arrow::WriteTable(
+      *table, arrow::default_memory_pool(), out, kRowGroupSize));
+  KATANA_CHECKED(out->Close());
+
+  return uri;
+}
+
+katana::Result<void>
+TestPagedReads(const katana::Uri& uri) {
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto full = KATANA_CHECKED(reader->ReadTable(uri))->column(0);
+
+  katana::PagedProperty::Options opts;
+  opts.max_active_pages = 3;
+  auto prop = KATANA_CHECKED(katana::PagedProperty::Make(uri, "values", opts));
+  KATANA_LOG_ASSERT(prop->num_rows() == kNumRows);
+  KATANA_LOG_ASSERT(
+      prop->num_pages() ==
+      static_cast<size_t>((kNumRows + kRowGroupSize - 1) / kRowGroupSize));
+  KATANA_LOG_ASSERT(prop->type()->Equals(arrow::large_utf8()));
+  KATANA_LOG_ASSERT(prop->num_active_pages() == 0);
+
+  // within a page, across pages and the whole property
+  for (auto [offset, length] : std::vector<std::pair<int64_t, int64_t>>{
+           {5, 10}, {60, 10}, {100, 300}, {0, kNumRows}, {kNumRows - 1, 1}}) {
+    auto rows = KATANA_CHECKED(prop->GetRows(offset, length));
+    KATANA_LOG_ASSERT(rows->length() == length);
+    KATANA_LOG_ASSERT(rows->Equals(full->Slice(offset, length)));
+    KATANA_LOG_ASSERT(prop->num_active_pages() <= opts.max_active_pages);
+  }
+
+  auto empty = KATANA_CHECKED(prop->GetRows(kNumRows, 0));
+  KATANA_LOG_ASSERT(empty->length() == 0);
+  KATANA_LOG_ASSERT(empty->type()->Equals(arrow::large_utf8()));
+
+  // pages come back after they were evicted
+  for (int64_t row : {3, 999, 500, 4, 130, 3}) {
+    auto value = KATANA_CHECKED(prop->GetScalar(row));
+    auto expected = KATANA_CHECKED(full->GetScalar(row));
+    KATANA_LOG_ASSERT(value->Equals(*expected));
+  }
+
+  KATANA_LOG_ASSERT(!prop->GetRows(-1, 2));
+  KATANA_LOG_ASSERT(!prop->GetRows(kNumRows - 1, 2));
+
+  prop->Release();
+  KATANA_LOG_ASSERT(prop->num_active_pages() == 0);
+
+  KATANA_LOG_ASSERT(!katana::PagedProperty::Make(uri, "other"));
+  opts.max_active_pages = 0;
+  KATANA_LOG_ASSERT(!katana::PagedProperty::Make(uri, "values", opts));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& dir) {
+  fs::create_directories(dir);
+  auto uri = KATANA_CHECKED(WriteProperty(dir));
+  KATANA_CHECKED(TestPagedReads(uri));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -0,0 +1,254 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/util/compression.h>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/ParquetReader.h"
+#include "katana/ParquetWriter.h"
+#include "katana/Result.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// Compares how long a property table takes to load with how large it is in
+// storage for several encodings. When storage bandwidth is the bottleneck,
+// the bytes_in_storage counter matters as much as the time. LoadColumn does
+// the same for tables of a single column of each common property type, since
+// decode cost depends as much on the type as on the encoding.
+
+struct Encoding {
+  const char* name;
+  arrow::Compression::type compression;
+  std::optional<int> compression_level;
+  bool dictionary;
+};
+
+const std::vector<Encoding> kEncodings{
+    {"plain", arrow::Compression::UNCOMPRESSED, std::nullopt, false},
+    {"dictionary", arrow::Compression::UNCOMPRESSED, std::nullopt, true},
+    {"snappy", arrow::Compression::SNAPPY, std::nullopt, true},
+    {"lz4", arrow::Compression::LZ4, std::nullopt, true},
+    {"zstd", arrow::Compression::ZSTD, std::nullopt, true},
+    {"zstd-9", arrow::Compression::ZSTD, 9, true},
+};
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long size : {64 * 1024, 1024 * 1024}) {
+    for (long encoding = 0; encoding < static_cast<long>(kEncodings.size());
+         ++encoding) {
+      b->Args({size, encoding});
+    }
+  }
+}
+
+/// The property types of LoadColumn, with random values of each
+struct ColumnType {
+  const char* name;
+  std::shared_ptr<arrow::DataType> type;
+};
+
+const std::vector<ColumnType> kColumnTypes{
+    {"bool", arrow::boolean()},    {"int32", arrow::int32()},
+    {"int64", arrow::int64()},     {"double", arrow::float64()},
+    {"string", arrow::large_utf8()},
+    {"timestamp", arrow::timestamp(arrow::TimeUnit::MILLI)},
+};
+
+void
+MakeColumnArguments(benchmark::internal::Benchmark* b) {
+  for (long type = 0; type < static_cast<long>(kColumnTypes.size()); ++type) {
+    for (long encoding = 0; encoding < static_cast<long>(kEncodings.size());
+         ++encoding) {
+      b->Args({1024 * 1024, type, encoding});
+    }
+  }
+}
+
+template <typename Builder, typename F>
+katana::Result<std::shared_ptr<arrow::Array>>
+BuildColumn(Builder builder, int64_t num_rows, F make_value) {
+  std::mt19937 gen(num_rows);
+  std::uniform_int_distribution<int64_t> value(0, 4095);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_CHECKED(builder.Append(make_value(value(gen))));
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  return array;
+}
+
+/// A column of the given type whose values repeat often enough for
+/// dictionaries and codecs to matter, as in most property columns
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeColumnTable(int64_t num_rows, const ColumnType& column_type) {
+  auto identity = [](int64_t v) { return v; };
+  std::shared_ptr<arrow::Array> array;
+  switch (column_type.type->id()) {
+  case arrow::Type::BOOL:
+    array = KATANA_CHECKED(BuildColumn(
+        arrow::BooleanBuilder(), num_rows,
+        [](int64_t v) { return v % 2 == 0; }));
+    break;
+  case arrow::Type::INT32:
+    array = KATANA_CHECKED(BuildColumn(
+        arrow::Int32Builder(), num_rows,
+        [](int64_t v) { return static_cast<int32_t>(v); }));
+    break;
+  case arrow::Type::INT64:
+    array = KATANA_CHECKED(
+        BuildColumn(arrow::Int64Builder(), num_rows, identity));
+    break;
+  case arrow::Type::DOUBLE:
+    array = KATANA_CHECKED(BuildColumn(
+        arrow::DoubleBuilder(), num_rows,
+        [](int64_t v) { return static_cast<double>(v) / 7; }));
+    break;
+  case arrow::Type::LARGE_STRING:
+    array = KATANA_CHECKED(BuildColumn(
+        arrow::LargeStringBuilder(), num_rows,
+        [](int64_t v) { return fmt::format("value-{}", v); }));
+    break;
+  case arrow::Type::TIMESTAMP:
+    array = KATANA_CHECKED(BuildColumn(
+        arrow::TimestampBuilder(
+            column_type.type, arrow::default_memory_pool()),
+        num_rows, identity));
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unsupported type {}",
+        column_type.type->ToString());
+  }
+
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(column_type.name, column_type.type)}),
+      {array});
+}
+
+/// A low cardinality string column, like an enum, and a high cardinality
+/// integer column
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeTable(int64_t num_rows) {
+  std::mt19937 gen(num_rows);
+  std::uniform_int_distribution<int> category(0, 31);
+
+  arrow::LargeStringBuilder strings;
+  arrow::Int64Builder ints;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_CHECKED(strings.Append(fmt::format("category-{}", category(gen))));
+    KATANA_CHECKED(ints.Append(static_cast<int64_t>(gen())));
+  }
+
+  std::shared_ptr<arrow::Array> string_array;
+  KATANA_CHECKED(strings.Finish(&string_array));
+  std::shared_ptr<arrow::Array> int_array;
+  KATANA_CHECKED(ints.Finish(&int_array));
+
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("category", arrow::large_utf8()),
+           arrow::field("id", arrow::int64())}),
+      {string_array, int_array});
+}
+
+katana::Result<uint64_t>
+WriteTable(
+    const std::shared_ptr<arrow::Table>& table, const Encoding& encoding,
+    const katana::Uri& uri) {
+  katana::ParquetWriter::WriteOpts opts;
+  opts.compression = encoding.compression;
+  opts.compression_level = encoding.compression_level;
+  opts.dictionary = encoding.dictionary;
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(table, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+  return fs::file_size(uri.path());
+}
+
+/// Writes table with encoding and times reading it back
+void
+RunLoad(
+    benchmark::State& state, const std::shared_ptr<arrow::Table>& table,
+    const Encoding& encoding) {
+  if (!arrow::util::Codec::IsAvailable(encoding.compression)) {
+    state.SkipWithError("codec is not available in this build");
+    return;
+  }
+
+  fs::path dir = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(dir);
+  auto uri_res = katana::Uri::MakeFromFile((dir / "table.parquet").string());
+  KATANA_LOG_VASSERT(uri_res, "making uri: {}", uri_res.error());
+  katana::Uri uri = uri_res.value();
+
+  auto size_res = WriteTable(table, encoding, uri);
+  KATANA_LOG_VASSERT(size_res, "writing table: {}", size_res.error());
+
+  auto reader_res = katana::ParquetReader::Make();
+  KATANA_LOG_VASSERT(reader_res, "making reader: {}", reader_res.error());
+  std::unique_ptr<katana::ParquetReader> reader = std::move(reader_res.value());
+
+  for (auto _ : state) {
+    auto res = reader->ReadTable(uri);
+    KATANA_LOG_VASSERT(res, "reading table: {}", res.error());
+    benchmark::DoNotOptimize(res.value());
+  }
+
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+  state.counters["bytes_in_storage"] = size_res.value();
+  state.counters["bytes_per_row"] =
+      static_cast<double>(size_res.value()) / table->num_rows();
+
+  fs::remove_all(dir);
+}
+
+void
+LoadTable(benchmark::State& state) {
+  const Encoding& encoding = kEncodings[state.range(1)];
+  state.SetLabel(encoding.name);
+
+  auto table_res = MakeTable(state.range(0));
+  KATANA_LOG_VASSERT(table_res, "making table: {}", table_res.error());
+  RunLoad(state, table_res.value(), encoding);
+}
+
+void
+LoadColumn(benchmark::State& state) {
+  const ColumnType& column_type = kColumnTypes[state.range(1)];
+  const Encoding& encoding = kEncodings[state.range(2)];
+  state.SetLabel(fmt::format("{}/{}", column_type.name, encoding.name));
+
+  auto table_res = MakeColumnTable(state.range(0), column_type);
+  KATANA_LOG_VASSERT(table_res, "making table: {}", table_res.error());
+  RunLoad(state, table_res.value(), encoding);
+}
+
+BENCHMARK(LoadTable)->Apply(MakeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(LoadColumn)
+    ->Apply(MakeColumnArguments)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+}
@@ -1,9 +1,15 @@
 #include <arrow/chunked_array.h>
+#include <arrow/compute/cast.h>
+#include <arrow/io/file.h>
 #include <arrow/type_fwd.h>
+#include <arrow/util/compression.h>
+#include <parquet/arrow/writer.h>
 
+#include "katana/ArrowInterchange.h"
 #include "katana/ParquetReader.h"
 #include "katana/ParquetWriter.h"
 #include "katana/Result.h"
+#include "katana/WriteGroup.h"
 #include "katana/tsuba.h"
 
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
@@ -38,10 +44,302 @@ TestLargeStringRoundTrip(const std::string& dir) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestDictionaryRoundTrip(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("dictionary.parquet");
+
+  arrow::LargeStringBuilder builder;
+  for (int i = 0; i < 100; ++i) {
+    KATANA_CHECKED(builder.Append(fmt::format("country-{}", (i * 7) % 5)));
+  }
+  std::shared_ptr<arrow::Array> strings;
+  KATANA_CHECKED(builder.Finish(&strings));
+  auto encoded = KATANA_CHECKED(katana::DictionaryEncodeStrings(
+      std::make_shared<arrow::ChunkedArray>(strings)));
+  KATANA_LOG_ASSERT(encoded->type()->Equals(katana::DictionaryStringType()));
+
+  // Row groups with dictionaries of their own in the file
+  katana::ParquetWriter::WriteOpts opts;
+  opts.max_row_group_length = 16;
+  auto writer =
+      KATANA_CHECKED(katana::ParquetWriter::Make(encoded, "country", opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(table->num_columns() == 1);
+  auto column = table->column(0);
+  KATANA_LOG_ASSERT(column->type()->Equals(katana::DictionaryStringType()));
+  KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  const auto& read =
+      static_cast<const arrow::DictionaryArray&>(*column->chunk(0));
+  KATANA_LOG_ASSERT(read.dictionary()->length() == 5);
+  auto decoded = KATANA_CHECKED(
+      arrow::compute::Cast(*column->chunk(0), arrow::large_utf8()));
+  KATANA_LOG_ASSERT(decoded->Equals(*strings));
+
+  return katana::ResultSuccess();
+}
+
+/// A two column table of 100 rows split into row groups of 7 rows
+katana::Result<katana::Uri>
+WriteRowGroups(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("row_groups.parquet");
+
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < 100; ++i) {
+    KATANA_CHECKED(builder.Append(i * i));
+  }
+  std::shared_ptr<arrow::Array> squares;
+  KATANA_CHECKED(builder.Finish(&squares));
+  auto strings = KATANA_CHECKED(MakeArrayOfStrings());
+
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("squares", arrow::int64()),
+           arrow::field("strings", arrow::large_utf8())}),
+      {std::make_shared<arrow::ChunkedArray>(squares), strings});
+
+  auto out = KATANA_CHECKED(arrow::io::FileOutputStream::Open(uri.path()));
+  KATANA_CHECKED(parquet::arrow::WriteTable(
+      *table, arrow::default_memory_pool(), out, /* chunk_size */ 7));
+  KATANA_CHECKED(out->Close());
+
+  return uri;
+}
+
+katana::Result<void>
+TestSlicedReads(const std::string& dir, katana::ParquetReader::ReadOpts opts) {
+  auto uri = KATANA_CHECKED(WriteRowGroups(dir));
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make(opts));
+
+  auto full = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(full->num_rows() == 100);
+  KATANA_LOG_ASSERT(full->num_columns() == 2);
+
+  // row groups [1, 7] hold rows [13, 53)
+  katana::ParquetReader::Slice slice{13, 40};
+  auto squares = KATANA_CHECKED(reader->ReadColumn(uri, 0, slice));
+  KATANA_LOG_ASSERT(squares->num_rows() == 40);
+  KATANA_LOG_ASSERT(squares->num_columns() == 1);
+  KATANA_LOG_ASSERT(squares->column(0)->Equals(full->column(0)->Slice(13, 40)));
+
+  auto strings = KATANA_CHECKED(reader->ReadColumn(uri, 1, slice));
+  KATANA_LOG_ASSERT(strings->column(0)->type()->Equals(arrow::large_utf8()));
+  KATANA_LOG_ASSERT(strings->column(0)->Equals(full->column(1)->Slice(13, 40)));
+
+  auto both = KATANA_CHECKED(reader->ReadTable(uri, {1, 0, 1}, slice));
+  KATANA_LOG_ASSERT(both->num_columns() == 3);
+  KATANA_LOG_ASSERT(both->column(1)->Equals(squares->column(0)));
+  KATANA_LOG_ASSERT(both->column(2)->Equals(strings->column(0)));
+
+  auto rows = KATANA_CHECKED(reader->ReadTable(uri, slice));
+  KATANA_LOG_ASSERT(rows->Equals(*full->Slice(13, 40)));
+
+  // slices are clamped to the end of the table
+  using Slice = katana::ParquetReader::Slice;
+  auto tail = KATANA_CHECKED(reader->ReadColumn(uri, 0, Slice{95, 10}));
+  KATANA_LOG_ASSERT(tail->num_rows() == 5);
+  auto empty = KATANA_CHECKED(reader->ReadColumn(uri, 0, Slice{100, 10}));
+  KATANA_LOG_ASSERT(empty->num_rows() == 0);
+  KATANA_LOG_ASSERT(empty->column(0)->num_chunks() == 1);
+
+  KATANA_LOG_ASSERT(!reader->ReadColumn(uri, 0, Slice{-1, 10}));
+  KATANA_LOG_ASSERT(!reader->ReadColumn(uri, 2, slice));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestFilteredReads(const std::string& dir) {
+  using ColumnFilter = katana::ParquetReader::ColumnFilter;
+  using Slice = katana::ParquetReader::Slice;
+
+  auto uri = KATANA_CHECKED(WriteRowGroups(dir));
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+
+  // squares in [400, 900] are in rows [20, 30], so in row groups [2, 4]
+  ColumnFilter squares{
+      .column = "squares",
+      .lower = arrow::MakeScalar(int32_t{400}),
+      .upper = arrow::MakeScalar(int64_t{900})};
+  auto rows = KATANA_CHECKED(reader->FindMatchingRows(uri, {squares}));
+  KATANA_LOG_ASSERT(rows.size() == 1);
+  KATANA_LOG_ASSERT(rows[0].offset == 14 && rows[0].length == 21);
+
+  rows =
+      KATANA_CHECKED(reader->FindMatchingRows(uri, {squares}, Slice{16, 50}));
+  KATANA_LOG_ASSERT(rows.size() == 1);
+  KATANA_LOG_ASSERT(rows[0].offset == 16 && rows[0].length == 19);
+
+  auto string_filter = ColumnFilter::Equal(
+      "strings", std::make_shared<arrow::LargeStringScalar>(
+                     "test-string-row-21"));
+  rows = KATANA_CHECKED(
+      reader->FindMatchingRows(uri, {squares, string_filter}));
+  KATANA_LOG_ASSERT(rows.size() == 1);
+  KATANA_LOG_ASSERT(rows[0].offset == 21 && rows[0].length == 7);
+
+  ColumnFilter none{
+      .column = "squares", .lower = arrow::MakeScalar(int64_t{100 * 100})};
+  rows = KATANA_CHECKED(reader->FindMatchingRows(uri, {none}));
+  KATANA_LOG_ASSERT(rows.empty());
+
+  ColumnFilter missing{.column = "missing", .lower = squares.lower};
+  KATANA_LOG_ASSERT(!reader->FindMatchingRows(uri, {missing}));
+
+  // rows outside of the ranges are null
+  auto table = KATANA_CHECKED(reader->ReadRows(uri, {{14, 21}}, {10, 30}));
+  KATANA_LOG_ASSERT(table->num_rows() == 30);
+  KATANA_LOG_ASSERT(table->num_columns() == 2);
+  auto column = table->column(0);
+  KATANA_LOG_ASSERT(column->null_count() == 9);
+  auto value = KATANA_CHECKED(column->GetScalar(4));
+  KATANA_LOG_ASSERT(value->Equals(*arrow::MakeScalar(int64_t{14 * 14})));
+  KATANA_LOG_ASSERT(table->column(1)->type()->Equals(arrow::large_utf8()));
+
+  auto nulls = KATANA_CHECKED(reader->ReadRows(uri, {}, {0, 10}));
+  KATANA_LOG_ASSERT(nulls->num_rows() == 10);
+  KATANA_LOG_ASSERT(nulls->column(0)->null_count() == 10);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestWriteOpts(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("encoded.parquet");
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto table = KATANA_CHECKED(
+      reader->ReadTable(KATANA_CHECKED(WriteRowGroups(dir))));
+
+  katana::ParquetWriter::WriteOpts opts;
+  if (arrow::util::Codec::IsAvailable(arrow::Compression::ZSTD)) {
+    opts.compression = arrow::Compression::ZSTD;
+    opts.compression_level = 3;
+  }
+  opts.max_row_group_length = 16;
+  opts.column_opts["strings"].dictionary = false;
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(table, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto encoded = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(encoded->Equals(*table));
+  auto row_groups = KATANA_CHECKED(reader->OpenRowGroups(uri));
+  KATANA_LOG_ASSERT(row_groups->num_row_groups() == 7);
+
+  katana::ParquetWriter::WriteOpts bad_opts;
+  bad_opts.max_row_group_length = 0;
+  KATANA_LOG_ASSERT(!katana::ParquetWriter::Make(table, bad_opts));
+  bad_opts = katana::ParquetWriter::WriteOpts{};
+  bad_opts.column_opts["squares"].compression = arrow::Compression::SNAPPY;
+  bad_opts.column_opts["squares"].compression_level = 1;
+  KATANA_LOG_ASSERT(!katana::ParquetWriter::Make(table, bad_opts));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestPartedWrites(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("parted.parquet");
+
+  // a few MB of strings, so they are split into parts of 1 MB
+  arrow::LargeStringBuilder builder;
+  for (int i = 0; i < 100000; ++i) {
+    KATANA_CHECKED(builder.Append(fmt::format("parted-string-row-{}", i)));
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  auto column = std::make_shared<arrow::ChunkedArray>(array);
+
+  katana::ParquetWriter::WriteOpts opts;
+  opts.mbs_per_part = 1;
+  auto write_group = KATANA_CHECKED(katana::WriteGroup::Make());
+  auto writer =
+      KATANA_CHECKED(katana::ParquetWriter::Make(column, "strings", opts));
+  KATANA_CHECKED(writer->WriteToUri(uri, write_group.get()));
+  KATANA_CHECKED(write_group->Finish());
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(table->column(0)->Equals(*column));
+  auto rows = KATANA_CHECKED(reader->ReadRows(uri, {}, {99990, 10}));
+  KATANA_LOG_ASSERT(rows->column(0)->Equals(*column->Slice(99990, 10)));
+
+  // and the same without a write group
+  auto sync_uri =
+      KATANA_CHECKED(katana::Uri::Make(dir)).Join("parted-sync.parquet");
+  KATANA_CHECKED(writer->WriteToUri(sync_uri));
+  table = KATANA_CHECKED(reader->ReadTable(sync_uri));
+  KATANA_LOG_ASSERT(table->column(0)->Equals(*column));
+
+  return katana::ResultSuccess();
+}
+
+/// Reads that do not combine chunks keep those of integer columns, here one
+/// per part
+katana::Result<void>
+TestKeptChunks(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("chunks.parquet");
+
+  arrow::Int64Builder ints_builder;
+  arrow::LargeStringBuilder strings_builder;
+  for (int64_t i = 0; i < 100000; ++i) {
+    KATANA_CHECKED(ints_builder.Append(i));
+    KATANA_CHECKED(strings_builder.Append(fmt::format("chunks-row-{}", i)));
+  }
+  std::shared_ptr<arrow::Array> ints;
+  KATANA_CHECKED(ints_builder.Finish(&ints));
+  std::shared_ptr<arrow::Array> strings;
+  KATANA_CHECKED(strings_builder.Finish(&strings));
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("ints", arrow::int64()),
+           arrow::field("strings", arrow::large_utf8())}),
+      {ints, strings});
+
+  katana::ParquetWriter::WriteOpts write_opts;
+  write_opts.mbs_per_part = 1;
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(table, write_opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  katana::ParquetReader::ReadOpts opts;
+  opts.combine_chunks = false;
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make(opts));
+  auto chunked = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(chunked->column(0)->num_chunks() > 1);
+  KATANA_LOG_ASSERT(chunked->column(1)->num_chunks() == 1);
+  KATANA_LOG_ASSERT(chunked->Equals(*table));
+
+  auto combining_reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto combined = KATANA_CHECKED(combining_reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(combined->column(0)->num_chunks() == 1);
+  KATANA_LOG_ASSERT(combined->Equals(*table));
+
+  auto column = KATANA_CHECKED(katana::ContiguousArray(*chunked->column(0)));
+  KATANA_LOG_ASSERT(column->Equals(*ints));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& dir) {
   KATANA_CHECKED_CONTEXT(
       TestLargeStringRoundTrip(dir), "TestLargeStringRoundTrip");
+  KATANA_CHECKED_CONTEXT(
+      TestDictionaryRoundTrip(dir), "TestDictionaryRoundTrip");
+
+  katana::ParquetReader::ReadOpts opts;
+  KATANA_CHECKED_CONTEXT(TestSlicedReads(dir, opts), "TestSlicedReads");
+  opts.parallel = true;
+  KATANA_CHECKED_CONTEXT(
+      TestSlicedReads(dir, opts), "TestSlicedReads parallel");
+  opts.io_threads = 2;
+  KATANA_CHECKED_CONTEXT(
+      TestSlicedReads(dir, opts), "TestSlicedReads parallel with io_threads");
+  KATANA_CHECKED_CONTEXT(TestFilteredReads(dir), "TestFilteredReads");
+  KATANA_CHECKED_CONTEXT(TestWriteOpts(dir), "TestWriteOpts");
+  KATANA_CHECKED_CONTEXT(TestPartedWrites(dir), "TestPartedWrites");
+  KATANA_CHECKED_CONTEXT(TestKeptChunks(dir), "TestKeptChunks");
 
   return katana::ResultSuccess();
 }
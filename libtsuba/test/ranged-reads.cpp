@@ -0,0 +1,202 @@
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RangedReads.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/ReadGroup.h"
+#include "katana/Result.h"
+
+namespace {
+
+/// Remote storage held in memory that reads concurrently in parts and
+/// counts the requests it serves
+class MemStorage : public katana::FileStorage {
+public:
+  MemStorage(uint64_t part_size, uint32_t max_reads)
+      : FileStorage("mem://"), part_size_(part_size), max_reads_(max_reads) {}
+
+  std::map<std::string, std::vector<uint8_t>> files;
+  std::atomic<uint64_t> num_gets{0};
+  std::atomic<uint32_t> in_flight{0};
+  std::atomic<uint32_t> max_in_flight{0};
+
+  uint64_t ReadPartSize() const override { return part_size_; }
+  uint32_t MaxConcurrentReads() const override { return max_reads_; }
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(const std::string&, katana::StatBuf*) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    auto it = files.find(uri);
+    if (it == files.end() || start + size > it->second.size()) {
+      return katana::ErrorCode::InvalidArgument;
+    }
+    ++num_gets;
+    std::memcpy(result_buf, it->second.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string&, const uint8_t*, uint64_t) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string&, const uint8_t*, uint64_t) override {
+    return std::async(std::launch::deferred, [] {
+      return katana::CopyableResult<void>(katana::ErrorCode::NotImplemented);
+    });
+  }
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return std::async(
+        std::launch::async,
+        [this, uri, start, size, result_buf]() -> katana::CopyableResult<void> {
+          uint32_t now = ++in_flight;
+          uint32_t max = max_in_flight.load();
+          while (now > max && !max_in_flight.compare_exchange_weak(max, now)) {
+          }
+          auto res = GetMultiSync(uri, start, size, result_buf);
+          --in_flight;
+          if (!res) {
+            return res.error();
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(std::launch::deferred, [] {
+      return katana::CopyableResult<void>(katana::ErrorCode::NotImplemented);
+    });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+private:
+  uint64_t part_size_;
+  uint32_t max_reads_;
+};
+
+constexpr uint64_t kPartSize = UINT64_C(64) << 10;
+const std::string kUri = "mem://bucket/rdg/topology-0";
+
+std::vector<uint8_t>
+MakeData(uint64_t size, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<uint8_t> data(size);
+  for (auto& byte : data) {
+    byte = gen();
+  }
+  return data;
+}
+
+void
+TestPartSize() {
+  MemStorage local(0, 4);
+  KATANA_LOG_ASSERT(katana::ReadPartSize(&local, UINT64_C(1) << 30) == 1 << 30);
+
+  MemStorage remote(kPartSize, 4);
+  KATANA_LOG_ASSERT(katana::ReadPartSize(&remote, 1000) == 1000);
+  KATANA_LOG_ASSERT(
+      katana::ReadPartSize(&remote, 3 * kPartSize) == kPartSize);
+  // parts grow so that a read takes a few rounds of 4 requests
+  uint64_t large = 1000 * kPartSize;
+  uint64_t part_size = katana::ReadPartSize(&remote, large);
+  KATANA_LOG_ASSERT(part_size > kPartSize);
+  KATANA_LOG_ASSERT((large + part_size - 1) / part_size <= 16);
+}
+
+void
+TestGetInParts() {
+  MemStorage storage(kPartSize, 4);
+  storage.files[kUri] = MakeData(20 * kPartSize + 123, 0);
+  const std::vector<uint8_t>& data = storage.files[kUri];
+
+  std::vector<uint8_t> buf(data.size());
+  auto res = katana::GetInParts(&storage, kUri, 0, data.size(), buf.data());
+  KATANA_LOG_VASSERT(res, "reading in parts: {}", res.error());
+  KATANA_LOG_ASSERT(buf == data);
+  KATANA_LOG_ASSERT(storage.num_gets == 21);
+  KATANA_LOG_ASSERT(storage.max_in_flight <= 4);
+
+  // a range that starts and ends within parts
+  uint64_t begin = kPartSize / 2 + 7;
+  uint64_t size = 5 * kPartSize + 11;
+  std::vector<uint8_t> range(size);
+  KATANA_LOG_ASSERT(
+      katana::GetInParts(&storage, kUri, begin, size, range.data()));
+  KATANA_LOG_ASSERT(std::memcmp(range.data(), data.data() + begin, size) == 0);
+
+  // small reads are a single request
+  storage.num_gets = 0;
+  KATANA_LOG_ASSERT(katana::GetInParts(&storage, kUri, 5, 100, range.data()));
+  KATANA_LOG_ASSERT(storage.num_gets == 1);
+
+  // reads past the end fail once every part issued has completed
+  storage.in_flight = 0;
+  KATANA_LOG_ASSERT(!katana::GetInParts(
+      &storage, kUri, 0, data.size() + kPartSize, buf.data()));
+  KATANA_LOG_ASSERT(storage.in_flight == 0);
+  KATANA_LOG_ASSERT(!katana::GetInParts(
+      &storage, "mem://bucket/missing", 0, 8 * kPartSize, buf.data()));
+}
+
+void
+TestReadGroupLimit() {
+  constexpr uint32_t kMaxOutstanding = 3;
+  katana::ReadGroup grp(kMaxOutstanding);
+  uint32_t completed = 0;
+  for (uint32_t i = 0; i < 10; ++i) {
+    grp.AddOp(
+        std::async(
+            std::launch::async,
+            []() -> katana::CopyableResult<void> {
+              return katana::CopyableResultSuccess();
+            }),
+        "op", [&completed, i]() -> katana::CopyableResult<void> {
+          // in FIFO order
+          KATANA_LOG_ASSERT(completed == i);
+          ++completed;
+          return katana::CopyableResultSuccess();
+        });
+    KATANA_LOG_ASSERT(i + 1 - completed <= kMaxOutstanding);
+  }
+  KATANA_LOG_ASSERT(grp.Finish());
+  KATANA_LOG_ASSERT(completed == 10);
+}
+
+}  // namespace
+
+int
+main() {
+  TestPartSize();
+  TestGetInParts();
+  TestReadGroupLimit();
+
+  return 0;
+}
@@ -57,6 +57,22 @@ TestPropInfoLists(const std::string& path_to_header) {
   under_test.find_edge_prop_info("value")->WasUnloaded();
   KATANA_LOG_ASSERT(under_test.find_edge_prop_info("value")->IsAbsent());
 
+  // content hashes stay with unchanged properties and are stored with them
+  katana::ContentHash hash;
+  hash.length = 3;
+  hash.chunks = {42};
+  under_test.find_edge_prop_info("value")->set_content_hash(hash);
+  under_test.find_edge_prop_info("value")->WasLoaded(arrow::date64());
+  KATANA_LOG_ASSERT(
+      under_test.find_edge_prop_info("value")->content_hash() == hash);
+  nlohmann::json j = *under_test.find_edge_prop_info("value");
+  auto round_trip = j.get<katana::PropStorageInfo>();
+  KATANA_LOG_ASSERT(round_trip.content_hash() == hash);
+  under_test.find_edge_prop_info("value")->WasModified(arrow::date64());
+  KATANA_LOG_ASSERT(!under_test.find_edge_prop_info("value")->content_hash());
+  under_test.find_edge_prop_info("value")->WasWritten("/tmp/did/not/write");
+  under_test.find_edge_prop_info("value")->WasUnloaded();
+
   under_test.find_edge_prop_info("not value")->WasModified(arrow::date32());
   KATANA_LOG_ASSERT(under_test.find_edge_prop_info("not value")->IsDirty());
   under_test.find_edge_prop_info("not value")->WasWritten("/tmp/did/not/write");
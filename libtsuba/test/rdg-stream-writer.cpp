@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/RDG.h"
+#include "katana/RDGManifest.h"
+#include "katana/RDGStreamWriter.h"
+#include "katana/RDGTopology.h"
+#include "katana/Result.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint32_t kNumNodes = 1000;
+constexpr uint32_t kNumNullNodes = 10;
+constexpr int64_t kNumEdges = 5000;
+constexpr int64_t kEdgeBatch = 333;
+
+struct Edge {
+  uint32_t src;
+  uint32_t dst;
+  // row in the order edges were added; null edges have no properties
+  std::optional<int64_t> order;
+};
+
+template <typename Builder, typename T>
+std::shared_ptr<arrow::Array>
+MakeArray(const std::vector<T>& values) {
+  Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(values).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::vector<std::optional<int64_t>>
+ToVector(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  std::vector<std::optional<int64_t>> values;
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<arrow::Int64Array>(chunk);
+    for (int64_t i = 0, n = array->length(); i < n; ++i) {
+      values.emplace_back(
+          array->IsNull(i) ? std::nullopt : std::optional(array->Value(i)));
+    }
+  }
+  return values;
+}
+
+katana::Result<void>
+AddNodes(katana::RDGStreamWriter* writer) {
+  // uneven batches, so that row groups do not line up with them
+  for (uint32_t begin = 0, size = 1; begin < kNumNodes;
+       begin += size, size = size * 3 + 1) {
+    uint32_t end = std::min(begin + size, kNumNodes);
+    std::vector<int64_t> ids(end - begin);
+    std::iota(ids.begin(), ids.end(), begin);
+    auto props = arrow::Table::Make(
+        arrow::schema({arrow::field("id", arrow::int64())}),
+        {MakeArray<arrow::Int64Builder>(ids)});
+    KATANA_CHECKED(writer->AddNodes(props));
+  }
+  return writer->AddNodes(kNumNullNodes);
+}
+
+katana::Result<std::vector<Edge>>
+AddEdges(katana::RDGStreamWriter* writer) {
+  std::mt19937 gen(18);
+  std::uniform_int_distribution<uint32_t> node(
+      0, kNumNodes + kNumNullNodes - 1);
+  // a narrow range of sources makes many edges share a source across runs
+  std::uniform_int_distribution<uint32_t> src(0, 99);
+
+  std::vector<Edge> edges;
+  for (int64_t begin = 0, batch = 0; begin < kNumEdges;
+       begin += kEdgeBatch, ++batch) {
+    int64_t end = std::min(begin + kEdgeBatch, kNumEdges);
+    std::vector<uint32_t> srcs;
+    std::vector<uint32_t> dsts;
+    std::vector<int64_t> orders;
+    bool with_props = batch % 4 != 1;
+    for (int64_t i = begin; i < end; ++i) {
+      srcs.emplace_back(batch % 2 == 0 ? src(gen) : node(gen));
+      dsts.emplace_back(node(gen));
+      orders.emplace_back(i);
+      edges.emplace_back(Edge{
+          srcs.back(), dsts.back(),
+          with_props ? std::optional<int64_t>(i) : std::nullopt});
+    }
+    std::shared_ptr<arrow::Table> props;
+    if (with_props) {
+      props = arrow::Table::Make(
+          arrow::schema({arrow::field("order", arrow::int64())}),
+          {MakeArray<arrow::Int64Builder>(orders)});
+    }
+    KATANA_CHECKED(writer->AddEdges(
+        std::static_pointer_cast<arrow::UInt32Array>(
+            MakeArray<arrow::UInt32Builder>(srcs)),
+        std::static_pointer_cast<arrow::UInt32Array>(
+            MakeArray<arrow::UInt32Builder>(dsts)),
+        props));
+  }
+  return edges;
+}
+
+katana::Result<void>
+CheckRDG(const std::string& rdg_name, std::vector<Edge> edges) {
+  katana::RDGManifest manifest = KATANA_CHECKED(katana::FindManifest(rdg_name));
+  katana::RDGFile rdg_file{
+      KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadOnly))};
+  katana::RDGLoadOptions opts;
+  opts.prefetch_topology = true;
+  katana::RDG rdg = KATANA_CHECKED(katana::RDG::Make(rdg_file, opts));
+
+  // edges with the same source stay in the order they were added
+  std::stable_sort(
+      edges.begin(), edges.end(),
+      [](const Edge& a, const Edge& b) { return a.src < b.src; });
+
+  KATANA_LOG_ASSERT(rdg.HasTopology(katana::RDGTopology::MakeShadowCSR()));
+  katana::RDGTopology* topo = KATANA_CHECKED(
+      rdg.GetTopology(katana::RDGTopology::MakeShadowCSR()));
+  KATANA_LOG_ASSERT(topo->bound());
+  uint32_t num_nodes = kNumNodes + kNumNullNodes;
+  KATANA_LOG_ASSERT(topo->num_nodes() == num_nodes);
+  KATANA_LOG_ASSERT(topo->num_edges() == edges.size());
+  for (uint32_t n = 0, e = 0; n < num_nodes; ++n) {
+    for (; e < edges.size() && edges[e].src == n; ++e) {
+      KATANA_LOG_ASSERT(topo->dests()[e] == edges[e].dst);
+    }
+    KATANA_LOG_ASSERT(topo->adj_indices()[n] == e);
+  }
+
+  auto ids = ToVector(rdg.node_properties()->GetColumnByName("id"));
+  KATANA_LOG_ASSERT(ids.size() == num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(
+        n < kNumNodes ? ids[n] == int64_t{n} : !ids[n].has_value());
+  }
+
+  auto orders = ToVector(rdg.edge_properties()->GetColumnByName("order"));
+  KATANA_LOG_ASSERT(orders.size() == edges.size());
+  for (size_t e = 0; e < edges.size(); ++e) {
+    KATANA_LOG_ASSERT(orders[e] == edges[e].order);
+  }
+
+  auto node_types = KATANA_CHECKED(rdg.node_entity_type_id_array());
+  KATANA_LOG_ASSERT(node_types.size() == num_nodes);
+  KATANA_LOG_ASSERT(std::all_of(
+      node_types.begin(), node_types.end(),
+      [](katana::EntityTypeID t) { return t == katana::kUnknownEntityType; }));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestStreamWriter(const std::string& dir) {
+  std::string rdg_name = (fs::path(dir) / "rdg").string();
+  katana::RDGStreamWriter::Options opts;
+  opts.spill_dir = (fs::path(dir) / "spill").string();
+  fs::create_directories(opts.spill_dir);
+  opts.max_run_edges = 700;
+  opts.merge_batch_rows = 64;
+
+  auto writer = KATANA_CHECKED(katana::RDGStreamWriter::Make(rdg_name, opts));
+  KATANA_CHECKED(AddNodes(writer.get()));
+  std::vector<Edge> edges = KATANA_CHECKED(AddEdges(writer.get()));
+  KATANA_LOG_ASSERT(writer->num_runs() == 5);
+
+  // properties must match those of the first batch
+  auto wrong = arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::int32())}),
+      {MakeArray<arrow::Int32Builder>(std::vector<int32_t>{1})});
+  KATANA_LOG_ASSERT(!writer->AddNodes(wrong));
+
+  KATANA_CHECKED(writer->Finish("rdg-stream-writer-test"));
+  KATANA_LOG_ASSERT(writer->num_nodes() == kNumNodes + kNumNullNodes);
+  KATANA_LOG_ASSERT(writer->num_edges() == kNumEdges);
+  KATANA_LOG_ASSERT(!writer->AddNodes(1));
+  writer.reset();
+
+  // the spilled runs are gone once the writer is
+  KATANA_LOG_ASSERT(fs::is_empty(opts.spill_dir));
+
+  return CheckRDG(rdg_name, std::move(edges));
+}
+
+katana::Result<void>
+TestEdgeOutOfRange(const std::string& dir) {
+  auto writer = KATANA_CHECKED(
+      katana::RDGStreamWriter::Make((fs::path(dir) / "bad-rdg").string()));
+  KATANA_CHECKED(writer->AddNodes(2));
+  KATANA_CHECKED(writer->AddEdges(
+      std::static_pointer_cast<arrow::UInt32Array>(
+          MakeArray<arrow::UInt32Builder>(std::vector<uint32_t>{0, 1})),
+      std::static_pointer_cast<arrow::UInt32Array>(
+          MakeArray<arrow::UInt32Builder>(std::vector<uint32_t>{1, 2}))));
+  KATANA_LOG_ASSERT(!writer->Finish("rdg-stream-writer-test"));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& dir) {
+  KATANA_CHECKED(TestStreamWriter(dir));
+  KATANA_CHECKED(TestEdgeOutOfRange(dir));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
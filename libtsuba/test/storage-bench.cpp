@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/AsyncOpGroup.h"
+#include "katana/Env.h"
+#include "katana/FileView.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// Throughput of the storage layer underneath RDG loads: reads of one large
+// file, sequential and random, reads of many small files, concurrent reads
+// through an AsyncOpGroup and FileView fills, whose pages are much larger
+// than the smallest reads.
+//
+// Files are written under the URI in KATANA_STORAGE_BENCH_URI, e.g., an s3://
+// or gs:// prefix, or under a local temporary directory if it is not set, so
+// the same benchmarks compare LocalStorage with the remote FileStorage
+// backends. Pass --benchmark_out=<file> --benchmark_out_format=json to keep
+// the results.
+
+constexpr uint64_t kLargeFileSize = UINT64_C(64) << 20;
+constexpr uint64_t kRandomReads = 256;
+
+/// Files under a fresh directory, which are deleted with this object
+class BenchFiles {
+public:
+  BenchFiles() {
+    std::string base;
+    if (!katana::GetEnv("KATANA_STORAGE_BENCH_URI", &base)) {
+      base = (fs::temp_directory_path() / "storage-bench").string();
+    }
+    auto uri_res = katana::Uri::Make(base);
+    KATANA_LOG_VASSERT(uri_res, "bad base uri {}: {}", base, uri_res.error());
+    dir_ = uri_res.value().RandFile("run");
+  }
+
+  BenchFiles(const BenchFiles&) = delete;
+  BenchFiles& operator=(const BenchFiles&) = delete;
+
+  ~BenchFiles() {
+    if (auto res = katana::FileDelete(dir_.string(), names_); !res) {
+      KATANA_LOG_WARN("deleting files under {}: {}", dir_, res.error());
+    }
+    if (dir_.scheme() == katana::Uri::kFileScheme) {
+      fs::remove_all(dir_.path());
+    }
+  }
+
+  /// Writes a file of size bytes and returns its URI
+  std::string Make(const std::string& name, uint64_t size) {
+    std::vector<uint8_t> data(size);
+    std::mt19937_64 gen(size);
+    std::generate(data.begin(), data.end(), [&gen] { return gen(); });
+
+    std::string uri = dir_.Join(name).string();
+    auto res = katana::FileStore(uri, data);
+    KATANA_LOG_VASSERT(res, "storing {}: {}", uri, res.error());
+    names_.emplace(name);
+    return uri;
+  }
+
+private:
+  katana::Uri dir_;
+  std::unordered_set<std::string> names_;
+};
+
+void
+MakeReadArguments(benchmark::internal::Benchmark* b) {
+  for (long read_size = 4 << 10; read_size <= 16 << 20; read_size *= 4) {
+    b->Args({read_size});
+  }
+}
+
+void
+MakeSmallFileArguments(benchmark::internal::Benchmark* b) {
+  for (long file_size : {1 << 10, 16 << 10, 256 << 10}) {
+    b->Args({256, file_size});
+  }
+}
+
+void
+MakeConcurrencyArguments(benchmark::internal::Benchmark* b) {
+  for (long in_flight : {1, 4, 16, 64}) {
+    b->Args({64, 1 << 20, in_flight});
+  }
+}
+
+void
+Check(const katana::Result<void>& res, const char* what) {
+  KATANA_LOG_VASSERT(res, "{}: {}", what, res.error());
+}
+
+void
+SequentialRead(benchmark::State& state) {
+  const uint64_t read_size = state.range(0);
+  BenchFiles files;
+  std::string uri = files.Make("large", kLargeFileSize);
+
+  std::vector<uint8_t> buf(read_size);
+  for (auto _ : state) {
+    for (uint64_t off = 0; off < kLargeFileSize; off += read_size) {
+      uint64_t size = std::min(read_size, kLargeFileSize - off);
+      Check(katana::FileGet(uri, buf.data(), off, size), "reading");
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * kLargeFileSize);
+}
+
+void
+RandomRead(benchmark::State& state) {
+  const uint64_t read_size = state.range(0);
+  BenchFiles files;
+  std::string uri = files.Make("large", kLargeFileSize);
+
+  std::mt19937_64 gen(read_size);
+  std::uniform_int_distribution<uint64_t> block(
+      0, (kLargeFileSize - read_size) / katana::kBlockSize);
+  std::vector<uint8_t> buf(read_size);
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < kRandomReads; ++i) {
+      uint64_t off = block(gen) * katana::kBlockSize;
+      Check(katana::FileGet(uri, buf.data(), off, read_size), "reading");
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kRandomReads);
+  state.SetBytesProcessed(state.iterations() * kRandomReads * read_size);
+}
+
+/// Reads many small files one after the other, which shows the fixed cost of
+/// a file, e.g., the round trip of a request to an object store
+void
+SmallFiles(benchmark::State& state) {
+  const uint64_t num_files = state.range(0);
+  const uint64_t file_size = state.range(1);
+  BenchFiles files;
+  std::vector<std::string> uris;
+  for (uint64_t i = 0; i < num_files; ++i) {
+    uris.emplace_back(files.Make(fmt::format("small-{}", i), file_size));
+  }
+
+  std::vector<uint8_t> buf(file_size);
+  for (auto _ : state) {
+    for (const std::string& uri : uris) {
+      katana::StatBuf stat;
+      Check(katana::FileStat(uri, &stat), "stat");
+      Check(katana::FileGet(uri, buf.data(), 0, stat.size), "reading");
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_files);
+  state.SetBytesProcessed(state.iterations() * num_files * file_size);
+}
+
+/// Reads files with FileGetAsync through an AsyncOpGroup, keeping at most
+/// in_flight of them outstanding, like the loads of the properties of an RDG
+void
+ConcurrentFiles(benchmark::State& state) {
+  const uint64_t num_files = state.range(0);
+  const uint64_t file_size = state.range(1);
+  const uint64_t in_flight = state.range(2);
+  BenchFiles files;
+  std::vector<std::string> uris;
+  for (uint64_t i = 0; i < num_files; ++i) {
+    uris.emplace_back(files.Make(fmt::format("file-{}", i), file_size));
+  }
+
+  std::vector<std::vector<uint8_t>> bufs(
+      num_files, std::vector<uint8_t>(file_size));
+  for (auto _ : state) {
+    katana::AsyncOpGroup group;
+    uint64_t pending = 0;
+    for (uint64_t i = 0; i < num_files; ++i) {
+      if (pending == in_flight) {
+        group.FinishOne();
+        --pending;
+      }
+      group.AddOp(
+          katana::FileGetAsync(uris[i], bufs[i].data(), 0, file_size),
+          uris[i], [] { return katana::CopyableResultSuccess(); });
+      ++pending;
+    }
+    Check(group.Finish(), "finishing reads");
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_files);
+  state.SetBytesProcessed(state.iterations() * num_files * file_size);
+}
+
+/// Fills random ranges of a FileView. Fills bring in whole pages, so for
+/// ranges smaller than a page the bytes fetched, and the time, are those of a
+/// page; bytes_requested is what was asked for.
+void
+FileViewFill(benchmark::State& state) {
+  const uint64_t fill_size = state.range(0);
+  BenchFiles files;
+  std::string uri = files.Make("large", kLargeFileSize);
+
+  std::mt19937_64 gen(fill_size);
+  std::uniform_int_distribution<uint64_t> block(
+      0, (kLargeFileSize - fill_size) / katana::kBlockSize);
+  for (auto _ : state) {
+    katana::FileView fv;
+    Check(fv.Bind(uri, 0, 0, true), "binding");
+    for (uint64_t i = 0; i < kRandomReads; ++i) {
+      uint64_t off = block(gen) * katana::kBlockSize;
+      Check(fv.Fill(off, off + fill_size, true), "filling");
+    }
+    Check(fv.Unbind(), "unbinding");
+  }
+
+  state.SetItemsProcessed(state.iterations() * kRandomReads);
+  state.counters["bytes_requested"] = benchmark::Counter(
+      state.iterations() * kRandomReads * fill_size,
+      benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(SequentialRead)
+    ->Apply(MakeReadArguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(RandomRead)
+    ->Apply(MakeReadArguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(SmallFiles)
+    ->Apply(MakeSmallFileArguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(ConcurrentFiles)
+    ->Apply(MakeConcurrencyArguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(FileViewFill)
+    ->Apply(MakeReadArguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../test-rdg.h"
+#include "katana/EntityIndexPrimitive.h"
+#include "katana/Experimental.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+#include "katana/RDG.h"
+#include "katana/Result.h"
+#include "katana/TextTracer.h"
+
+namespace {
+
+using Primitive = katana::EntityIndexPrimitive;
+
+// An index of the values {3, 1, null, 2} of four nodes, by id and then value
+const std::vector<uint32_t> kIDs = {1, 3, 0};
+const std::vector<int64_t> kKeys = {1, 2, 3};
+const std::string kPropertyPath = "part_vers00000000000000000001_rdg_node_x";
+
+template <typename T>
+Primitive::Array<uint8_t>
+Borrow(const std::vector<T>& values) {
+  return Primitive::Array<uint8_t>::Borrow(
+      reinterpret_cast<const uint8_t*>(values.data()),
+      values.size() * sizeof(T));
+}
+
+Primitive
+GenerateIndex(bool with_keys) {
+  Primitive index;
+  index.set_property_name("x");
+  index.set_property_path(kPropertyPath);
+  index.set_type("int64");
+  index.set_num_entities(4);
+  index.set_ids(Borrow(kIDs));
+  if (with_keys) {
+    index.set_keys(Borrow(kKeys));
+  }
+  return index;
+}
+
+template <typename T>
+bool
+Equal(const Primitive::Array<uint8_t>& array, const std::vector<T>& expected) {
+  return array.size() == expected.size() * sizeof(T) &&
+         std::equal(
+             expected.begin(), expected.end(),
+             reinterpret_cast<const T*>(array.data()));
+}
+
+void
+ValidateIndex(const Primitive& index, bool with_keys) {
+  KATANA_LOG_ASSERT(index.property_name() == "x");
+  KATANA_LOG_ASSERT(index.property_path() == kPropertyPath);
+  KATANA_LOG_ASSERT(index.type() == "int64");
+  KATANA_LOG_ASSERT(index.num_entities() == 4);
+  KATANA_LOG_ASSERT(Equal(index.ids(), kIDs));
+  if (with_keys) {
+    KATANA_LOG_ASSERT(Equal(index.keys(), kKeys));
+  } else {
+    KATANA_LOG_ASSERT(index.keys().size() == 0);
+  }
+}
+
+/*
+ * Tests: Optional Datastructure, EntityIndexPrimitive functionality
+ *
+ * 1) loading an RDG without the index and adding one to it
+ * 2) loading the index back, with its arrays mapped
+ * 3) replacing the index with one built again
+ * 4) storing the RDG elsewhere and loading the index from there
+ */
+katana::Result<void>
+TestRoundTripEntityIndex(const std::string& rdg_dir) {
+  KATANA_LOG_ASSERT(!rdg_dir.empty());
+  std::string name = Primitive::Name(true, "x");
+  Primitive index = GenerateIndex(true);
+  ValidateIndex(index, true);
+
+  katana::RDG rdg = KATANA_CHECKED(LoadRDG(rdg_dir));
+  std::optional<Primitive> missing =
+      KATANA_CHECKED(rdg.LoadEntityIndexPrimitive(name));
+  KATANA_LOG_ASSERT(!missing);
+
+  KATANA_CHECKED(rdg.WriteEntityIndexPrimitive(name, index));
+  std::optional<Primitive> index_2 =
+      KATANA_CHECKED(rdg.LoadEntityIndexPrimitive(name));
+  KATANA_LOG_ASSERT(index_2);
+  ValidateIndex(index_2.value(), true);
+  std::optional<Primitive> other =
+      KATANA_CHECKED(rdg.LoadEntityIndexPrimitive(Primitive::Name(false, "x")));
+  KATANA_LOG_ASSERT(!other);
+
+  Primitive rebuilt = GenerateIndex(false);
+  KATANA_CHECKED(rdg.WriteEntityIndexPrimitive(name, rebuilt));
+  std::optional<Primitive> index_3 =
+      KATANA_CHECKED(rdg.LoadEntityIndexPrimitive(name));
+  KATANA_LOG_ASSERT(index_3);
+  ValidateIndex(index_3.value(), false);
+
+  std::string rdg_dir2 = KATANA_CHECKED(WriteRDG(std::move(rdg)));
+  katana::RDG rdg2 = KATANA_CHECKED(LoadRDG(rdg_dir2));
+  std::optional<Primitive> index_4 =
+      KATANA_CHECKED(rdg2.LoadEntityIndexPrimitive(name));
+  KATANA_LOG_ASSERT(index_4);
+  ValidateIndex(index_4.value(), false);
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+  katana::GaloisRuntime Katana_runtime;
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("missing rdg file directory");
+  }
+  katana::ProgressTracer::Set(katana::TextTracer::Make());
+  katana::ProgressScope host_scope =
+      katana::GetTracer().StartActiveSpan("entity index test");
+
+  // Ensure the feature flag is actually set
+  KATANA_LOG_ASSERT(KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat));
+
+  if (auto res = TestRoundTripEntityIndex(argv[1]); !res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
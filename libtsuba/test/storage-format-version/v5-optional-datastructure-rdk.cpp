@@ -37,8 +37,8 @@ GenerateFingerprints() {
 
   for (size_t i = 0; i < 4; i++) {
     katana::DynamicBitset bset;
+    bset.resize(128);
     for (size_t j = 0; j < i; j++) {
-      bset.resize(j + 1);
       bset.set(j);
     }
     fingerprints.emplace_back(std::move(bset));
@@ -87,6 +87,15 @@ ValidateLSHIndex(katana::RDKLSHIndexPrimitive& index) {
   KATANA_LOG_ASSERT(index.fingerprint_length() == 42);
   KATANA_LOG_ASSERT(index.num_fingerprints() == 4);
   KATANA_LOG_ASSERT(index.hash_structure() == GenerateHashes());
+  KATANA_LOG_ASSERT(index.num_tables() == GenerateHashes().size());
+  auto [members, members_end] = index.Find(128 + 3 * 64 + 5, 5);
+  KATANA_LOG_ASSERT(
+      std::vector<uint64_t>(members, members_end) ==
+      std::vector<uint64_t>({3, 5, 8}));
+  auto [missing, missing_end] = index.Find(128 + 3 * 64 + 5, 6);
+  KATANA_LOG_ASSERT(missing == missing_end);
+  auto [empty, empty_end] = index.Find(0, 0);
+  KATANA_LOG_ASSERT(empty == empty_end);
   KATANA_LOG_ASSERT(index.fingerprints() == GenerateFingerprints());
   KATANA_LOG_ASSERT(index.smiles() == GenerateSmiles());
 }
@@ -117,6 +126,21 @@ ValidateSubstructIndex(katana::RDKSubstructureIndexPrimitive& index) {
   KATANA_LOG_ASSERT(index.index() == GenerateIndices());
   KATANA_LOG_ASSERT(index.fingerprints() == GenerateFingerprints());
   KATANA_LOG_ASSERT(index.smiles() == GenerateSmiles());
+
+  // Fingerprint i has bits 0 to i - 1
+  auto screen = [&](size_t query_size, const std::vector<size_t>& bits) {
+    katana::DynamicBitset query;
+    query.resize(query_size);
+    for (size_t bit : bits) {
+      query.set(bit);
+    }
+    return index.Screen(query);
+  };
+  KATANA_LOG_ASSERT(screen(128, {}) == std::vector<uint64_t>({0, 1, 2, 3}));
+  KATANA_LOG_ASSERT(screen(128, {0, 1}) == std::vector<uint64_t>({2, 3}));
+  KATANA_LOG_ASSERT(screen(2, {1}) == std::vector<uint64_t>({2, 3}));
+  KATANA_LOG_ASSERT(screen(128, {100}).empty());
+  KATANA_LOG_ASSERT(screen(1024, {1000}).empty());
 }
 
 /*
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../test-rdg.h"
+#include "katana/Experimental.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+#include "katana/RDG.h"
+#include "katana/ReachabilityIndexPrimitive.h"
+#include "katana/Result.h"
+#include "katana/TextTracer.h"
+
+namespace {
+
+using Primitive = katana::ReachabilityIndexPrimitive;
+
+// The labels of the path 0 -> 1 -> 2 with node 1 as the first hub and the
+// others as hubs of themselves; node 3 has no edges
+const std::vector<uint64_t> kOutOffsets = {0, 2, 3, 4, 5};
+const std::vector<uint32_t> kOutHubs = {0, 1, 0, 2, 3};
+const std::vector<uint32_t> kOutDistances = {1, 0, 0, 0, 0};
+const std::vector<uint64_t> kInOffsets = {0, 1, 2, 4, 5};
+const std::vector<uint32_t> kInHubs = {1, 0, 0, 2, 3};
+const std::vector<uint32_t> kInDistances = {0, 0, 1, 0, 0};
+
+template <typename T>
+Primitive::Array<T>
+MakeArray(const std::vector<T>& values) {
+  return Primitive::Array<T>(std::vector<T>(values));
+}
+
+Primitive
+GenerateIndex() {
+  Primitive index;
+  index.set_num_nodes(kOutOffsets.size() - 1);
+  Primitive::Labels out;
+  out.offsets = MakeArray(kOutOffsets);
+  out.hubs = MakeArray(kOutHubs);
+  out.distances = MakeArray(kOutDistances);
+  index.set_out_labels(std::move(out));
+  Primitive::Labels in;
+  in.offsets = MakeArray(kInOffsets);
+  in.hubs = MakeArray(kInHubs);
+  in.distances = MakeArray(kInDistances);
+  index.set_in_labels(std::move(in));
+  return index;
+}
+
+template <typename T>
+bool
+Equal(const Primitive::Array<T>& array, const std::vector<T>& expected) {
+  return array.size() == expected.size() &&
+         std::equal(expected.begin(), expected.end(), array.data());
+}
+
+void
+ValidateIndex(const Primitive& index) {
+  KATANA_LOG_ASSERT(index.num_nodes() == 4);
+  KATANA_LOG_ASSERT(Equal(index.out_labels().offsets, kOutOffsets));
+  KATANA_LOG_ASSERT(Equal(index.out_labels().hubs, kOutHubs));
+  KATANA_LOG_ASSERT(Equal(index.out_labels().distances, kOutDistances));
+  KATANA_LOG_ASSERT(Equal(index.in_labels().offsets, kInOffsets));
+  KATANA_LOG_ASSERT(Equal(index.in_labels().hubs, kInHubs));
+  KATANA_LOG_ASSERT(Equal(index.in_labels().distances, kInDistances));
+}
+
+/*
+ * Tests: Optional Datastructure, ReachabilityIndexPrimitive functionality
+ *
+ * 1) loading an RDG without the index and adding one to it
+ * 2) loading the index back, with its labels mapped
+ * 3) storing the RDG elsewhere and loading the index from there
+ */
+katana::Result<void>
+TestRoundTripReachabilityIndex(const std::string& rdg_dir) {
+  KATANA_LOG_ASSERT(!rdg_dir.empty());
+  Primitive index = GenerateIndex();
+  ValidateIndex(index);
+
+  katana::RDG rdg = KATANA_CHECKED(LoadRDG(rdg_dir));
+  std::optional<Primitive> missing =
+      KATANA_CHECKED(rdg.LoadReachabilityIndexPrimitive());
+  KATANA_LOG_ASSERT(!missing);
+
+  KATANA_CHECKED(rdg.WriteReachabilityIndexPrimitive(index));
+  std::optional<Primitive> index_2 =
+      KATANA_CHECKED(rdg.LoadReachabilityIndexPrimitive());
+  KATANA_LOG_ASSERT(index_2);
+  ValidateIndex(index_2.value());
+
+  std::string rdg_dir2 = KATANA_CHECKED(WriteRDG(std::move(rdg)));
+  katana::RDG rdg2 = KATANA_CHECKED(LoadRDG(rdg_dir2));
+  std::optional<Primitive> index_3 =
+      KATANA_CHECKED(rdg2.LoadReachabilityIndexPrimitive());
+  KATANA_LOG_ASSERT(index_3);
+  ValidateIndex(index_3.value());
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+  katana::GaloisRuntime Katana_runtime;
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("missing rdg file directory");
+  }
+  katana::ProgressTracer::Set(katana::TextTracer::Make());
+  katana::ProgressScope host_scope =
+      katana::GetTracer().StartActiveSpan("reachability index test");
+
+  // Ensure the feature flag is actually set
+  KATANA_LOG_ASSERT(KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat));
+
+  if (auto res = TestRoundTripReachabilityIndex(argv[1]); !res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -61,14 +61,30 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         clEnumValN(
             BetweennessCentralityPlan::kLevel, "Level",
             "Level parallel algorithm"),
-        // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
-        // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
-        ),
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAdaptive, "Adaptive",
+            "Outer parallel algorithm on adaptively sampled sources"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAutomatic, "Auto",
+            "Auto: choose among the algorithms automatically")),
     cll::init(BetweennessCentralityPlan::kLevel));
 
+static cll::opt<float> epsilon(
+    "epsilon",
+    cll::desc("Largest error of a centrality normalized by n(n - 2) for "
+              "-algo=Adaptive (default 0.01)"),
+    cll::init(BetweennessCentralityPlan::kDefaultEpsilon));
+static cll::opt<float> delta(
+    "delta",
+    cll::desc("Probability of exceeding -epsilon for -algo=Adaptive "
+              "(default 0.1)"),
+    cll::init(BetweennessCentralityPlan::kDefaultDelta));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for work rather than use "
@@ -143,8 +159,15 @@ main(int argc, char** argv) {
     sources = num_sources;
   }
 
-  std::cout << "Running betweenness-centrality on " << num_sources
-            << " sources\n";
+  if (algo == BetweennessCentralityPlan::kAdaptive) {
+    plan = BetweennessCentralityPlan::Adaptive(epsilon, delta);
+    sources = kBetweennessCentralityAllNodes;
+    std::cout << "Running betweenness-centrality on adaptively sampled "
+                 "sources\n";
+  } else {
+    std::cout << "Running betweenness-centrality on " << num_sources
+              << " sources\n";
+  }
   katana::TxnContext txn_ctx;
   if (auto r = BetweennessCentrality(
           pg.get(), "betweenness_centrality", &txn_ctx, sources, plan);
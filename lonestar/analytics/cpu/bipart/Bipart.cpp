@@ -22,6 +22,7 @@
 #include "Helper.h"
 #include "Lonestar/BoilerPlate.h"
 #include "katana/PageAlloc.h"
+#include "katana/analytics/partition/hypergraph_partition.h"
 
 namespace cll = llvm::cl;
 
@@ -79,6 +80,27 @@ static cll::opt<bool> skip_lone_hedges(
     cll::desc("Specify if degree 1 hyperedges should not be included"),
     cll::init(false));
 
+static cll::opt<bool> kway(
+    "kway",
+    cll::desc(
+        "Partition k ways directly with the multilevel k way hypergraph "
+        "partitioner of libgraph rather than by recursive bisection"),
+    cll::init(false));
+
+static cll::opt<katana::analytics::HypergraphPartitionPlan::Objective>
+    objective(
+        "objective", cll::desc("Objective of -kway:"),
+        cll::values(
+            clEnumValN(
+                katana::analytics::HypergraphPartitionPlan::kCut, "cut",
+                "Weight of the hyperedges cut"),
+            clEnumValN(
+                katana::analytics::HypergraphPartitionPlan::kConnectivity,
+                "connectivity",
+                "Weight of the hyperedges times the partitions they span, "
+                "less one (default)")),
+        cll::init(katana::analytics::HypergraphPartitionPlan::kConnectivity));
+
 /**
  * Main Partitioning function for creating bi-partitions for all
  * graphs at a given level of the k-way recursion tree
@@ -564,6 +586,48 @@ CreateKPartitions(MetisGraph* metis_graph) {
       "BiPart", "Partitions", static_cast<uint32_t>(num_partitions));
 }
 
+/**
+ * Create k partitions directly with katana::analytics::PartitionHypergraph
+ *
+ * @param graph Graph of which the first GetHedges() nodes are the hyperedges
+ */
+void
+CreateKPartitionsDirectly(HyperGraph* graph) {
+  uint32_t num_hedges = graph->GetHedges();
+  katana::analytics::Hypergraph hypergraph;
+  hypergraph.num_nodes = graph->size() - num_hedges;
+  for (GNode h = 0; h < num_hedges; h++) {
+    for (auto e : graph->edges(h)) {
+      hypergraph.pins.emplace_back(graph->getEdgeDst(e) - num_hedges);
+    }
+    hypergraph.offsets.emplace_back(hypergraph.pins.size());
+  }
+
+  auto plan =
+      katana::analytics::HypergraphPartitionPlan::MultilevelKWay(objective);
+  std::vector<uint32_t> parts;
+  if (auto r = katana::analytics::PartitionHypergraph(
+          hypergraph, num_partitions, &parts, plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+  for (uint32_t n = 0; n < hypergraph.num_nodes; n++) {
+    graph->getData(n + num_hedges).partition = parts[n];
+  }
+
+  auto stats = katana::analytics::HypergraphPartitionStatistics::Compute(
+      hypergraph, num_partitions, parts);
+  if (!stats) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats.error());
+  }
+  stats.value().Print();
+  katana::ReportStatSingle("BiPart", "Edge-Cut", ComputingCut(graph));
+  katana::ReportStatSingle(
+      "BiPart", "Connectivity", stats.value().connectivity);
+  katana::ReportStatSingle(
+      "BiPart", "Partitions", static_cast<uint32_t>(num_partitions));
+}
+
 /**
  * Main Function
  */
@@ -597,7 +661,11 @@ main(int argc, char** argv) {
   katana::ReportPageAllocGuard page_alloc;
 
   create_partition_time.start();
-  CreateKPartitions(&metis_graph);
+  if (kway) {
+    CreateKPartitionsDirectly(graph);
+  } else {
+    CreateKPartitions(&metis_graph);
+  }
   create_partition_time.stop();
 
   page_alloc.Report();
@@ -56,6 +56,12 @@ static cll::opt<CdlpPlan::Algorithm> algo(
             "Asynchronous algorithm")*/),
     cll::init(CdlpPlan::kSynchronous));
 
+static cll::opt<bool> weighted(
+    "weighted",
+    cll::desc("Weight the labels of neighbors by the edge property given by "
+              "-edgePropertyName (default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(CdlpPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -115,8 +121,11 @@ main(int argc, char** argv) {
   }
 
   katana::TxnContext txn_ctx;
-  auto pg_result = Cdlp(
-      pg.get(), property_name, maxIterations, &txn_ctx, symmetricGraph, plan);
+  auto pg_result =
+      weighted ? Cdlp(pg.get(), edge_property_name, property_name,
+                      maxIterations, &txn_ctx, symmetricGraph, plan)
+               : Cdlp(pg.get(), property_name, maxIterations, &txn_ctx,
+                      symmetricGraph, plan);
   if (!pg_result) {
     KATANA_LOG_FATAL("Failed to run Cdlp: {}", pg_result.error());
   }
@@ -0,0 +1,95 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Graph Coloring";
+const char* desc =
+    "Colors the nodes of a graph such that no two adjacent nodes have the same "
+    "color";
+const char* url = "graph_coloring";
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<GraphColoringPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(
+        clEnumValN(
+            GraphColoringPlan::kJonesPlassmann, "JonesPlassmann",
+            "Jones-Plassmann with random priorities"),
+        clEnumValN(
+            GraphColoringPlan::kLargestDegreeFirst, "LargestDegreeFirst",
+            "Jones-Plassmann with nodes of higher degree first (default)")),
+    cll::init(GraphColoringPlan::kLargestDegreeFirst));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_DIE(
+        "graph coloring requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  GraphColoringPlan plan = GraphColoringPlan::FromAlgorithm(algo);
+
+  katana::TxnContext txn_ctx;
+  if (auto r = GraphColoring(pg.get(), "color", &txn_ctx, plan); !r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+
+  auto stats_result = GraphColoringStatistics::Compute(pg.get(), "color");
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (auto r = GraphColoringAssertValid(pg.get(), "color"); r) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", r.error());
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint32_t>("color");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(uint64_t(results->length()) == pg->size());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -57,7 +57,7 @@ cll::opt<IndependentSetPlan::Algorithm> algo(
         //            "use deterministic worklist"),
         clEnumValN(
             IndependentSetPlan::kPriority, "Priority",
-            "prio algo based on Martin's GPU ECL-MIS algorithm (default)"),
+            "Luby's algorithm with nodes of lower degree first (default)"),
         clEnumValN(
             IndependentSetPlan::kEdgeTiledPriority, "EdgeTiledPriority",
             "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm")),
@@ -44,6 +44,11 @@ static cll::opt<unsigned int> report_node(
     "reportNode",
     cll::desc("Node to report the similarity of (default value 1)"),
     cll::init(1));
+static cll::opt<bool> hubBitmaps(
+    "hubBitmaps",
+    cll::desc("Intersect with adjacency bitmaps of high degree nodes "
+              "(default value of false)"),
+    cll::init(false));
 
 using NodeValue = katana::PODProperty<double>;
 
@@ -80,7 +85,8 @@ main(int argc, char** argv) {
   katana::TxnContext txn_ctx;
   if (auto r = katana::analytics::Jaccard(
           pg.get(), base_node, output_property_name, &txn_ctx,
-          katana::analytics::JaccardPlan());
+          hubBitmaps ? katana::analytics::JaccardPlan::HubBitmaps()
+                     : katana::analytics::JaccardPlan());
       !r) {
     KATANA_LOG_FATAL("Jaccard failed: {}", r.error());
   }
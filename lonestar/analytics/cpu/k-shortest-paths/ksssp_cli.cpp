@@ -58,7 +58,10 @@ static cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(SsspPlan::kDeltaStep, "DeltaStep", "Delta stepping"),
         clEnumValN(
             SsspPlan::kDeltaStepBarrier, "DeltaStepBarrier",
-            "Delta stepping with barrier")),
+            "Delta stepping with barrier"),
+        clEnumValN(
+            SsspPlan::kDeltaStepMultiQueue, "DeltaStepMultiQueue",
+            "Delta stepping with a MultiQueue worklist")),
     cll::init(SsspPlan::kDeltaTile));
 
 static cll::opt<AlgoReachability> algoReachability(
@@ -81,6 +84,8 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "DeltaStep";
   case SsspPlan::kDeltaStepBarrier:
     return "DeltaStepBarrier";
+  case SsspPlan::kDeltaStepMultiQueue:
+    return "DeltaStepMultiQueue";
   default:
     return "Unknown";
   }
@@ -140,6 +145,9 @@ main(int argc, char** argv) {
   case SsspPlan::kDeltaStepBarrier:
     plan = SsspPlan::DeltaStepBarrier(stepShift);
     break;
+  case SsspPlan::kDeltaStepMultiQueue:
+    plan = SsspPlan::DeltaStepMultiQueue(stepShift);
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm selected");
   }
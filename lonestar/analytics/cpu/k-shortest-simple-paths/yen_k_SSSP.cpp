@@ -25,6 +25,7 @@
 #include "katana/AtomicHelpers.h"
 #include "katana/Properties.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/k_shortest_paths/ksssp.h"
 
 namespace cll = llvm::cl;
 
@@ -52,16 +53,21 @@ static cll::opt<unsigned int> numPaths(
               "value 10)"),
     cll::init(10));
 
-enum Algo { deltaTile = 0, deltaStep, deltaStepBarrier };
+enum Algo { deltaTile = 0, deltaStep, deltaStepBarrier, spurTree };
 
-const char* const ALGO_NAMES[] = {"deltaTile", "deltaStep", "deltaStepBarrier"};
+const char* const ALGO_NAMES[] = {
+    "deltaTile", "deltaStep", "deltaStepBarrier", "spurTree"};
 
 static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm:"),
     cll::values(
         clEnumVal(deltaTile, "deltaTile"), clEnumVal(deltaStep, "deltaStep"),
-        clEnumVal(deltaStepBarrier, "deltaStepBarrier")),
-    cll::init(deltaTile));
+        clEnumVal(deltaStepBarrier, "deltaStepBarrier"),
+        clEnumVal(
+            spurTree,
+            "spurTree: katana::analytics::KShortestSimplePaths, with spur "
+            "searches guided by a shortest path tree to the report node")),
+    cll::init(spurTree));
 
 struct Path {
   uint32_t parent;
@@ -462,6 +468,19 @@ PrintKPaths(std::vector<std::vector<std::pair<GNode, uint32_t>>>& k_paths) {
   }
 }
 
+//print k paths found by the spurTree algorithm
+void
+PrintKPaths(const std::vector<katana::analytics::SimplePath>& k_paths) {
+  katana::gPrint("k paths: \n");
+
+  for (const katana::analytics::SimplePath& path : k_paths) {
+    for (uint32_t node : path.nodes) {
+      katana::gPrint(" ", node);
+    }
+    katana::gPrint(" weight: ", path.weight, "\n");
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -474,6 +493,40 @@ main(int argc, char** argv) {
   std::unique_ptr<katana::PropertyGraph> pg =
       MakeFileGraph(inputFile, edge_property_name);
 
+  if (startNode >= pg->topology().NumNodes() ||
+      reportNode >= pg->topology().NumNodes()) {
+    KATANA_LOG_ERROR(
+        "failed to set report: ", reportNode,
+        " or failed to set source: ", startNode, "\n");
+    abort();
+  }
+
+  if (algo == spurTree) {
+    katana::gPrint(
+        "Read ", pg->topology().NumNodes(), " nodes, ",
+        pg->topology().NumEdges(), " edges\n");
+    katana::gInfo("Running ", ALGO_NAMES[algo], " algorithm\n");
+
+    auto k_paths_result = katana::analytics::KShortestSimplePaths(
+        pg.get(), {{startNode.getValue(), reportNode.getValue()}}, numPaths,
+        edge_property_name);
+    if (!k_paths_result) {
+      KATANA_LOG_FATAL(
+          "failed to compute k shortest simple paths: {}",
+          k_paths_result.error());
+    }
+    const std::vector<katana::analytics::SimplePath>& k_paths =
+        k_paths_result.value()[0];
+
+    if (k_paths.empty()) {
+      katana::gPrint("no shortest path exists from source to sink \n");
+    }
+    PrintKPaths(k_paths);
+
+    totalTime.stop();
+    return 0;
+  }
+
   katana::TxnContext txn_ctx;
   auto result = pg->ConstructNodeProperties<NodeData>(&txn_ctx);
   if (!result) {
@@ -490,13 +543,6 @@ main(int argc, char** argv) {
   katana::gPrint(
       "Read ", graph.NumNodes(), " nodes, ", graph.NumEdges(), " edges\n");
 
-  if (startNode >= graph.size() || reportNode >= graph.size()) {
-    KATANA_LOG_ERROR(
-        "failed to set report: ", reportNode,
-        " or failed to set source: ", startNode, "\n");
-    abort();
-  }
-
   auto it = graph.begin();
   std::advance(it, startNode.getValue());
   GNode source = *it;
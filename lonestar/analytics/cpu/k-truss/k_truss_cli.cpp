@@ -53,6 +53,12 @@ static cll::opt<KTrussPlan::Algorithm> algo(
             "Compute k-1 core and then k-truss")),
     cll::init(KTrussPlan::kBsp));
 
+static cll::opt<bool> decompose(
+    "decompose",
+    cll::desc("Compute the trussness of every edge instead of one k-truss "
+              "(default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(KTrussPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -93,6 +99,30 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
             << pg->topology().NumEdges() << " edges\n";
 
+  if (decompose) {
+    katana::TxnContext txn_ctx;
+    auto max_trussness_result =
+        TrussDecomposition(&txn_ctx, pg.get(), "trussness");
+    if (!max_trussness_result) {
+      KATANA_LOG_FATAL(
+          "Failed to compute truss decomposition: {}",
+          max_trussness_result.error());
+    }
+    std::cout << "Maximum trussness = " << max_trussness_result.value()
+              << "\n";
+
+    if (!skipVerify) {
+      if (auto r = TrussDecompositionAssertValid(pg.get(), "trussness"); r) {
+        std::cout << "Verification successful.\n";
+      } else {
+        KATANA_LOG_FATAL("verification failed: {}", r.error());
+      }
+    }
+
+    total_timer.stop();
+    return 0;
+  }
+
   std::cout << "Running " << AlgorithmName(algo) << "\n";
 
   KTrussPlan plan = KTrussPlan();
@@ -40,6 +40,9 @@ static cll::opt<LocalClusteringCoefficientPlan::Algorithm> algo(
         LocalClusteringCoefficientPlan::kOrderedCountPerThread,
         "orderedCountPerThread",
         "Ordered Simple Count using PerThreadStorage (default)")),
+    cll::values(clEnumValN(
+        LocalClusteringCoefficientPlan::kDegreeOrdered, "degreeOrdered",
+        "Count ordered by degree, sampling nodes of high degree")),
     cll::init(LocalClusteringCoefficientPlan::kOrderedCountPerThread));
 
 static cll::opt<bool> relabel(
@@ -47,6 +50,25 @@ static cll::opt<bool> relabel(
     cll::desc("Relabel nodes of the graph (default value of false => "
               "choose automatically)"),
     cll::init(false));
+
+static cll::opt<bool> hubBitmaps(
+    "hubBitmaps",
+    cll::desc("Test membership in adjacency bitmaps of high degree nodes "
+              "(default value of false)"),
+    cll::init(false));
+
+static cll::opt<uint32_t> sampleMinDegree(
+    "sampleMinDegree",
+    cll::desc("Nodes of at least this degree have sampled coefficients, "
+              "for degreeOrdered (default value no node)"),
+    cll::init(LocalClusteringCoefficientPlan::kNoSampling));
+
+static cll::opt<double> maxError(
+    "maxError",
+    cll::desc("Bound of the error of sampled coefficients, for "
+              "degreeOrdered (default value 0.01)"),
+    cll::init(LocalClusteringCoefficientPlan::kDefaultMaxError));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -74,11 +96,18 @@ main(int argc, char** argv) {
 
   switch (algo) {
   case LocalClusteringCoefficientPlan::kOrderedCountAtomics:
-    plan = LocalClusteringCoefficientPlan::OrderedCountAtomics(relabeling_flag);
+    plan = LocalClusteringCoefficientPlan::OrderedCountAtomics(
+        LocalClusteringCoefficientPlan::kDefaultEdgesSorted, relabeling_flag,
+        hubBitmaps);
     break;
   case LocalClusteringCoefficientPlan::kOrderedCountPerThread:
-    plan =
-        LocalClusteringCoefficientPlan::OrderedCountPerThread(relabeling_flag);
+    plan = LocalClusteringCoefficientPlan::OrderedCountPerThread(
+        LocalClusteringCoefficientPlan::kDefaultEdgesSorted, relabeling_flag,
+        hubBitmaps);
+    break;
+  case LocalClusteringCoefficientPlan::kDegreeOrdered:
+    plan = LocalClusteringCoefficientPlan::DegreeOrdered(
+        sampleMinDegree, maxError, hubBitmaps);
     break;
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
@@ -102,9 +102,12 @@ static cll::opt<bool> useDetInit(
 
 static cll::opt<MatrixCompletionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
-    cll::values(clEnumValN(
-        MatrixCompletionPlan::kSGDByItems, "sgdByItems",
-        "Simple SGD on Items")),
+    cll::values(
+        clEnumValN(
+            MatrixCompletionPlan::kSGDByItems, "sgdByItems",
+            "Simple SGD on Items"),
+        clEnumValN(
+            MatrixCompletionPlan::kALS, "als", "Alternating least squares")),
     cll::init(MatrixCompletionPlan::kSGDByItems));
 /*
  * Commandline options for different learning functions
@@ -120,7 +123,7 @@ static cll::opt<MatrixCompletionPlan::Step> learningRateFunction(
     cll::init(MatrixCompletionPlan::kDefaultLearningRateFunction));
 
 const char* name = "Matrix Completion";
-const char* desc = "Matrix Completion by SGD";
+const char* desc = "Matrix Completion by SGD or ALS";
 const char* url = "matrix_completion";
 
 #define LATENT_VECTOR_SIZE 20
@@ -149,6 +152,11 @@ main(int argc, char** argv) {
         maxUpdates, updatesPerEdge, fixedRounds, useExactError, useDetInit,
         learningRateFunction);
     break;
+  case MatrixCompletionPlan::kALS:
+    plan = MatrixCompletionPlan::ALS(
+        lambda, tolerance, useSameLatentVector, maxUpdates, fixedRounds,
+        useDetInit);
+    break;
   default:
     KATANA_LOG_FATAL("invalid algorithm");
   }
@@ -0,0 +1,97 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/max_flow/max_flow.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Max Flow";
+const char* desc =
+    "Computes the value of a maximum flow from a source node to a sink node "
+    "and a minimum cut between them by push-relabel";
+const char* url = "max_flow";
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<uint32_t> sourceNode(
+    "sourceNode", cll::desc("Source node"), cll::Required);
+
+cll::opt<uint32_t> sinkNode("sinkNode", cll::desc("Sink node"), cll::Required);
+
+cll::opt<double> globalRelabelInterval(
+    "globalRelabelInterval",
+    cll::desc("Work between global relabelings as a multiple of the work of "
+              "one (default value 1)"),
+    cll::init(MaxFlowPlan::kDefaultGlobalRelabelInterval));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  MaxFlowPlan plan = MaxFlowPlan::SynchronousPushRelabel(globalRelabelInterval);
+
+  katana::TxnContext txn_ctx;
+  auto flow_result = MaxFlow(
+      pg.get(), sourceNode, sinkNode, edge_property_name, "source_side",
+      &txn_ctx, plan);
+  if (!flow_result) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", flow_result.error());
+  }
+  uint64_t flow = flow_result.value();
+  std::cout << "Maximum flow = " << flow << "\n";
+
+  auto stats_result =
+      MaxFlowStatistics::Compute(pg.get(), edge_property_name, "source_side");
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (auto r = MaxFlowAssertValid(
+            pg.get(), sourceNode, sinkNode, edge_property_name, "source_side",
+            flow);
+        r) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", r.error());
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint8_t>("source_side");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(uint64_t(results->length()) == pg->size());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Strings.h"
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+const char* name = "Neighbor Sampling";
+const char* desc =
+    "Samples the neighborhoods of minibatches of random seed nodes, as for "
+    "the training of a graph neural network";
+static const char* url = "neighbor_sampling";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<NeighborSamplingPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Fanout):"),
+    cll::values(
+        clEnumValN(
+            NeighborSamplingPlan::kFanout, "Fanout", "Node-wise sampling"),
+        clEnumValN(
+            NeighborSamplingPlan::kLayerWise, "LayerWise",
+            "Layer-wise sampling")),
+    cll::init(NeighborSamplingPlan::kFanout));
+
+static cll::opt<std::string> fanouts(
+    "fanouts",
+    cll::desc("Comma separated fanouts of the hops (default value 10,5)"),
+    cll::init("10,5"));
+static cll::opt<uint32_t> batchSize(
+    "batchSize", cll::desc("Seeds per minibatch (default value 512)"),
+    cll::init(512));
+static cll::opt<uint32_t> numBatches(
+    "numBatches", cll::desc("Number of minibatches (default value 16)"),
+    cll::init(16));
+static cll::opt<bool> weighted(
+    "weighted",
+    cll::desc("Draw the edges in proportion to the edge property "
+              "given by edgePropertyName (default false)"),
+    cll::init(false));
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed of the draws (default value 0)"), cll::init(0));
+
+std::string
+AlgorithmName(NeighborSamplingPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case NeighborSamplingPlan::kFanout:
+    return "Fanout";
+  case NeighborSamplingPlan::kLayerWise:
+    return "LayerWise";
+  default:
+    return "Unknown";
+  }
+}
+
+/// Checks the CSR of every block and that the hops chain up
+katana::Result<void>
+CheckMiniBatch(
+    const SampledMiniBatch& batch, const std::vector<uint32_t>& seeds) {
+  const std::vector<uint32_t>* dst_nodes = &seeds;
+  for (const SampledBlock& block : batch.blocks) {
+    if (block.dst_nodes != *dst_nodes ||
+        !std::equal(
+            dst_nodes->begin(), dst_nodes->end(), block.src_nodes.begin()) ||
+        block.offsets.size() != dst_nodes->size() + 1 ||
+        block.offsets.back() != block.indices.size() ||
+        block.indices.size() != block.edge_ids.size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed, "malformed block");
+    }
+    for (uint32_t index : block.indices) {
+      if (index >= block.src_nodes.size()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed, "index out of the block");
+      }
+    }
+    dst_nodes = &block.src_nodes;
+  }
+  return katana::ResultSuccess();
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
+            << pg->topology().NumEdges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
+
+  NeighborSamplingPlan plan = NeighborSamplingPlan();
+  switch (algo) {
+  case NeighborSamplingPlan::kFanout:
+    plan = NeighborSamplingPlan::Fanout();
+    break;
+  case NeighborSamplingPlan::kLayerWise:
+    plan = NeighborSamplingPlan::LayerWise();
+    break;
+  default:
+    KATANA_LOG_FATAL("Invalid algorithm");
+  }
+
+  NeighborSamplingOptions options;
+  for (std::string_view fanout : katana::SplitView(fanouts, ",")) {
+    options.fanouts.emplace_back(std::stoul(std::string(fanout)));
+  }
+  if (weighted) {
+    options.edge_weight_property_name = edge_property_name;
+  }
+  options.seed = seed;
+
+  auto sampler_result = NeighborSampler::Make(pg.get(), options, plan);
+  if (!sampler_result) {
+    KATANA_LOG_FATAL("Failed to build the sampler: {}", sampler_result.error());
+  }
+  NeighborSampler sampler = std::move(sampler_result.value());
+
+  std::mt19937_64 generator(seed);
+  std::vector<uint32_t> nodes(pg->topology().NumNodes());
+  std::iota(nodes.begin(), nodes.end(), 0);
+  std::vector<std::vector<uint32_t>> batches;
+  for (uint32_t i = 0; i < numBatches; ++i) {
+    size_t size = std::min<size_t>(batchSize, nodes.size());
+    for (size_t j = 0; j < size; ++j) {
+      std::swap(nodes[j], nodes[j + generator() % (nodes.size() - j)]);
+    }
+    batches.emplace_back(nodes.begin(), nodes.begin() + size);
+  }
+
+  uint64_t num_edges = 0;
+  uint64_t num_inputs = 0;
+  size_t index = 0;
+  if (auto r = sampler.Pipeline(
+          batches,
+          [&](SampledMiniBatch&& batch) -> katana::Result<void> {
+            if (!skipVerify) {
+              KATANA_CHECKED(CheckMiniBatch(batch, batches[index]));
+            }
+            ++index;
+            for (const SampledBlock& block : batch.blocks) {
+              num_edges += block.indices.size();
+            }
+            num_inputs += batch.input_nodes().size();
+            return katana::ResultSuccess();
+          });
+      !r) {
+    KATANA_LOG_FATAL("Failed to sample the minibatches: {}", r.error());
+  }
+  if (!skipVerify) {
+    std::cout << "Verification successful.\n";
+  }
+
+  std::cout << "Sampled " << sampler.num_batches() << " minibatches\n";
+  std::cout << "Sampled edges per minibatch: "
+            << num_edges / std::max<uint64_t>(sampler.num_batches(), 1)
+            << "\n";
+  std::cout << "Input nodes per minibatch: "
+            << num_inputs / std::max<uint64_t>(sampler.num_batches(), 1)
+            << "\n";
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -38,6 +38,15 @@ static cll::opt<unsigned int> maxIterations(
     "maxIterations",
     cll::desc("Maximum iterations, applies round-based versions only"),
     cll::init(1000));
+static cll::opt<std::string> checkpointDir(
+    "checkpointDir",
+    cll::desc(
+        "Directory to checkpoint the ranks to and to resume from, "
+        "PullTopological only"),
+    cll::init(""));
+static cll::opt<uint32_t> checkpointInterval(
+    "checkpointInterval", cll::desc("Iterations between two checkpoints"),
+    cll::init(10));
 
 static cll::opt<PagerankPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
@@ -47,7 +56,10 @@ static cll::opt<PagerankPlan::Algorithm> algo(
             "PullTopological"),
         clEnumValN(PagerankPlan::kPullResidual, "PullResidual", "PullResidual"),
         clEnumValN(PagerankPlan::kPushSynchronous, "PushSync", "PushSync"),
-        clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
+        clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync"),
+        clEnumValN(
+            PagerankPlan::kPropagationBlocking, "PropagationBlocking",
+            "PropagationBlocking")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
 int
@@ -73,7 +85,8 @@ main(int argc, char** argv) {
   PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
 
   katana::TxnContext txn_ctx;
-  if (auto r = Pagerank(pg.get(), "rank", &txn_ctx, plan); !r) {
+  CheckpointOptions checkpoint{checkpointDir, checkpointInterval};
+  if (auto r = Pagerank(pg.get(), "rank", &txn_ctx, plan, checkpoint); !r) {
     KATANA_LOG_FATAL("Failed to run Pagerank {}", r.error());
   }
 
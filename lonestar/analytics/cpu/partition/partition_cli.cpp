@@ -0,0 +1,102 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/partition/partition.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Partition";
+const char* desc =
+    "Partitions the nodes of a graph into balanced partitions with few edges "
+    "between them";
+const char* url = "partition";
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<uint32_t> numPartitions(
+    "numPartitions", cll::desc("Number of partitions (default value 2)"),
+    cll::init(2));
+
+cll::opt<double> imbalance(
+    "imbalance",
+    cll::desc("Fraction by which a partition may be larger than an even share "
+              "(default value 0.03)"),
+    cll::init(PartitionPlan::kDefaultImbalance));
+
+cll::opt<uint32_t> coarseningLimit(
+    "coarseningLimit",
+    cll::desc(
+        "Nodes per partition at which coarsening stops (default value 30)"),
+    cll::init(PartitionPlan::kDefaultCoarseningLimit));
+
+cll::opt<uint32_t> refinementRounds(
+    "refinementRounds",
+    cll::desc("Rounds of refinement at each level (default value 10)"),
+    cll::init(PartitionPlan::kDefaultRefinementRounds));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  PartitionPlan plan =
+      PartitionPlan::Multilevel(imbalance, coarseningLimit, refinementRounds);
+
+  katana::TxnContext txn_ctx;
+  if (auto r = Partition(pg.get(), numPartitions, "partition", &txn_ctx, plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+
+  auto stats_result =
+      PartitionStatistics::Compute(pg.get(), numPartitions, "partition");
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (auto r = PartitionAssertValid(pg.get(), numPartitions, "partition");
+        r) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", r.error());
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint32_t>("partition");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(uint64_t(results->length()) == pg->size());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
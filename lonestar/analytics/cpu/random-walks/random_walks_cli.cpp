@@ -65,6 +65,13 @@ static cll::opt<double> forwardProbability(
 static cll::opt<double> numberOfWalks(
     "numberOfWalks", cll::desc("Number of walks per node"), cll::init(1));
 
+static cll::opt<bool> weighted(
+    "weighted",
+    cll::desc(
+        "Walk by the weights of the edge property named by "
+        "-edgePropertyName (only for Node2Vec)"),
+    cll::init(false));
+
 static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
@@ -134,7 +141,9 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
-  auto walks_result = RandomWalks(pg.get(), plan);
+  auto walks_result = weighted
+                          ? RandomWalks(pg.get(), edge_property_name, plan)
+                          : RandomWalks(pg.get(), plan);
   if (!walks_result) {
     KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
   }
@@ -60,6 +60,16 @@ static cll::opt<unsigned int> reportNode(
 static cll::opt<unsigned int> stepShift(
     "delta", cll::desc("Shift value for the deltastep (default value 13)"),
     cll::init(13));
+static cll::opt<bool> autoDelta(
+    "autoDelta",
+    cll::desc("Choose the delta from the edge weights, ignoring -delta "
+              "(default value false)"),
+    cll::init(false));
+static cll::opt<unsigned int> radiusNeighbors(
+    "radiusNeighbors",
+    cll::desc("Number of nearest neighbors a node's radius covers in radius "
+              "stepping (default value 4)"),
+    cll::init(SsspPlan::kDefaultRadiusNeighbors));
 
 static cll::opt<SsspPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value auto):"),
@@ -75,6 +85,9 @@ static cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(
             SsspPlan::kDeltaStepFusion, "DeltaStepFusion",
             "Delta stepping with barrier and fused buckets"),
+        clEnumValN(
+            SsspPlan::kDeltaStepMultiQueue, "DeltaStepMultiQueue",
+            "Delta stepping with a MultiQueue worklist"),
         clEnumValN(
             SsspPlan::kSerialDelta, "SerialDelta", "Serial delta stepping"),
         clEnumValN(
@@ -83,6 +96,7 @@ static cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(SsspPlan::kDijkstra, "Dijkstra", "Dijkstra's algorithm"),
         clEnumValN(SsspPlan::kTopological, "Topo", "Topological"),
         clEnumValN(SsspPlan::kTopologicalTile, "TopoTile", "Topological tiled"),
+        clEnumValN(SsspPlan::kRadiusStep, "RadiusStep", "Radius stepping"),
         clEnumValN(
             SsspPlan::kAutomatic, "Automatic",
             "Automatic: choose among the algorithms automatically")),
@@ -109,6 +123,8 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "DeltaStepBarrier";
   case SsspPlan::kDeltaStepFusion:
     return "DeltaStepFusion";
+  case SsspPlan::kDeltaStepMultiQueue:
+    return "DeltaStepMultiQueue";
   case SsspPlan::kSerialDeltaTile:
     return "SerialDeltaTile";
   case SsspPlan::kSerialDelta:
@@ -121,6 +137,8 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "Topological";
   case SsspPlan::kTopologicalTile:
     return "TopologicalTile";
+  case SsspPlan::kRadiusStep:
+    return "RadiusStep";
   case SsspPlan::kAutomatic:
     return "Automatic";
   default:
@@ -189,8 +207,10 @@ main(int argc, char** argv) {
   uint32_t num_sources = startNodes.size();
   std::cout << "Running SSSP for " << num_sources << " sources\n";
 
-  if (algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
-      algo == SsspPlan::kSerialDelta || algo == SsspPlan::kSerialDeltaTile) {
+  unsigned delta = autoDelta ? SsspPlan::kAutomaticDelta : stepShift;
+  if (!autoDelta &&
+      (algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
+       algo == SsspPlan::kSerialDelta || algo == SsspPlan::kSerialDeltaTile)) {
     std::cout
         << "INFO: Using delta-step of " << (1 << stepShift) << "\n"
         << "WARNING: Performance varies considerably due to delta parameter.\n"
@@ -202,22 +222,25 @@ main(int argc, char** argv) {
   SsspPlan plan;
   switch (algo) {
   case SsspPlan::kDeltaTile:
-    plan = SsspPlan::DeltaTile(stepShift);
+    plan = SsspPlan::DeltaTile(delta);
     break;
   case SsspPlan::kDeltaStep:
-    plan = SsspPlan::DeltaStep(stepShift);
+    plan = SsspPlan::DeltaStep(delta);
     break;
   case SsspPlan::kDeltaStepBarrier:
-    plan = SsspPlan::DeltaStepBarrier(stepShift);
+    plan = SsspPlan::DeltaStepBarrier(delta);
     break;
   case SsspPlan::kDeltaStepFusion:
-    plan = SsspPlan::DeltaStepFusion(stepShift);
+    plan = SsspPlan::DeltaStepFusion(delta);
+    break;
+  case SsspPlan::kDeltaStepMultiQueue:
+    plan = SsspPlan::DeltaStepMultiQueue(delta);
     break;
   case SsspPlan::kSerialDeltaTile:
-    plan = SsspPlan::SerialDeltaTile(stepShift);
+    plan = SsspPlan::SerialDeltaTile(delta);
     break;
   case SsspPlan::kSerialDelta:
-    plan = SsspPlan::SerialDelta(stepShift);
+    plan = SsspPlan::SerialDelta(delta);
     break;
   case SsspPlan::kDijkstraTile:
     plan = SsspPlan::DijkstraTile();
@@ -231,6 +254,9 @@ main(int argc, char** argv) {
   case SsspPlan::kTopologicalTile:
     plan = SsspPlan::TopologicalTile();
     break;
+  case SsspPlan::kRadiusStep:
+    plan = SsspPlan::RadiusStep(radiusNeighbors);
+    break;
   case SsspPlan::kAutomatic:
     plan = SsspPlan();
     break;
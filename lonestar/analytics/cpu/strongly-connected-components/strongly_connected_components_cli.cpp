@@ -0,0 +1,131 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+const char* name = "Strongly Connected Components";
+const char* desc =
+    "Computes the strongly connected components of a directed graph";
+static const char* url = "strongly_connected_components";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<StronglyConnectedComponentsPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Coloring):"),
+    cll::values(
+        clEnumValN(
+            StronglyConnectedComponentsPlan::kTrimFWBW, "TrimFWBW",
+            "Forward-backward with trimming"),
+        clEnumValN(
+            StronglyConnectedComponentsPlan::kColoring, "Coloring",
+            "Trimming, one forward-backward step and coloring")),
+    cll::init(StronglyConnectedComponentsPlan::kColoring));
+
+std::string
+AlgorithmName(StronglyConnectedComponentsPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case StronglyConnectedComponentsPlan::kTrimFWBW:
+    return "TrimFWBW";
+  case StronglyConnectedComponentsPlan::kColoring:
+    return "Coloring";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
+            << pg->topology().NumEdges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
+
+  StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan();
+  switch (algo) {
+  case StronglyConnectedComponentsPlan::kTrimFWBW:
+    plan = StronglyConnectedComponentsPlan::TrimFWBW();
+    break;
+  case StronglyConnectedComponentsPlan::kColoring:
+    plan = StronglyConnectedComponentsPlan::Coloring();
+    break;
+  default:
+    KATANA_LOG_FATAL("Invalid algorithm");
+  }
+
+  katana::TxnContext txn_ctx;
+  if (auto r = StronglyConnectedComponents(
+          pg.get(), "component", &txn_ctx, plan);
+      !r) {
+    KATANA_LOG_FATAL(
+        "Failed to compute strongly connected components: {}", r.error());
+  }
+
+  auto stats_result =
+      StronglyConnectedComponentsStatistics::Compute(pg.get(), "component");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute StronglyConnectedComponents statistics: {}",
+        stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (auto r = StronglyConnectedComponentsAssertValid(pg.get(), "component");
+        r) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", r.error());
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint64_t>("component");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) == pg->topology().NumNodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
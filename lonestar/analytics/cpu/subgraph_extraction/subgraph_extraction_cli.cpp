@@ -43,6 +43,11 @@ static cll::opt<std::string> nodesString(
               "''); ignore if "
               "-nodesFile is used"),
     cll::init(""));
+static cll::opt<uint32_t> hops(
+    "hops",
+    cll::desc("If positive, extract the nodes at most this many hops from "
+              "the given nodes (default value 0)"),
+    cll::init(0));
 static cll::opt<SubGraphExtractionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
     cll::values(clEnumValN(
@@ -85,7 +90,11 @@ main(int argc, char** argv) {
   std::cout << "INFO: This is extracting the topology containing nodes from "
                "the user defined node set.\n";
 
-  auto subgraph_result = SubGraphExtraction(pg.get(), node_vec, plan);
+  katana::TxnContext txn_ctx;
+  auto subgraph_result =
+      hops > 0 ? SubGraphExtractionKHop(
+                     pg.get(), node_vec, hops, {}, &txn_ctx, plan)
+               : SubGraphExtraction(pg.get(), node_vec, plan);
   if (!subgraph_result) {
     KATANA_LOG_FATAL("Failed to run algorithm: {}", subgraph_result.error());
   }
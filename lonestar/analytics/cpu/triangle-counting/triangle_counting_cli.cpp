@@ -40,14 +40,30 @@ static cll::opt<TriangleCountPlan::Algorithm> algo(
             TriangleCountPlan::kEdgeIteration, "edgeiterator", "Edge Iterator"),
         clEnumValN(
             TriangleCountPlan::kOrderedCount, "orderedCount",
-            "Ordered Simple Count (default)")),
+            "Ordered Simple Count (default)"),
+        clEnumValN(
+            TriangleCountPlan::kApproximate, "approximate",
+            "Colorful sampling estimate")),
     cll::init(TriangleCountPlan::kOrderedCount));
 
+static cll::opt<double> relativeError(
+    "relativeError",
+    cll::desc("Target relative standard error of the approximate count "
+              "(default value 0.05; 0 for exact)"),
+    cll::init(TriangleCountPlan::kDefaultRelativeError));
+
 static cll::opt<bool> relabel(
     "relabel",
     cll::desc("Relabel nodes of the graph (default value of false => "
               "choose automatically)"),
     cll::init(false));
+
+static cll::opt<bool> hubBitmaps(
+    "hubBitmaps",
+    cll::desc("Intersect with adjacency bitmaps of high degree nodes "
+              "(default value of false)"),
+    cll::init(false));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -74,15 +90,22 @@ main(int argc, char** argv) {
 
   switch (algo) {
   case TriangleCountPlan::kNodeIteration:
-    plan = TriangleCountPlan::NodeIteration(relabeling_flag);
+    plan = TriangleCountPlan::NodeIteration(
+        TriangleCountPlan::kDefaultEdgeSorted, relabeling_flag, hubBitmaps);
     break;
 
   case TriangleCountPlan::kEdgeIteration:
-    plan = TriangleCountPlan::EdgeIteration(relabeling_flag);
+    plan = TriangleCountPlan::EdgeIteration(
+        TriangleCountPlan::kDefaultEdgeSorted, relabeling_flag, hubBitmaps);
     break;
 
   case TriangleCountPlan::kOrderedCount:
-    plan = TriangleCountPlan::OrderedCount(relabeling_flag);
+    plan = TriangleCountPlan::OrderedCount(
+        TriangleCountPlan::kDefaultEdgeSorted, relabeling_flag, hubBitmaps);
+    break;
+
+  case TriangleCountPlan::kApproximate:
+    plan = TriangleCountPlan::Approximate(relativeError);
     break;
 
   default:
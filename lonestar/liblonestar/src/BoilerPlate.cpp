@@ -21,6 +21,9 @@
 
 #include <sstream>
 
+#include "katana/Barrier.h"
+#include "katana/HWTopo.h"
+#include "katana/PageAlloc.h"
 #include "katana/SharedMemSys.h"
 
 //! standard global options to the benchmarks
@@ -108,6 +111,14 @@ LonestarStart(
 
   katana::ReportParam("(NULL)", "CommandLine", cmdout.str());
   katana::ReportParam("(NULL)", "Threads", numThreads);
+  katana::ReportParam(
+      "(NULL)", "ThreadPlacement",
+      katana::ThreadPlacementName(katana::GetThreadPlacement()));
+  katana::ReportParam(
+      "(NULL)", "Barrier", katana::BarrierKindName(katana::GetBarrierKind()));
+  katana::ReportParam(
+      "(NULL)", "LargePages",
+      katana::LargePageKindName(katana::GetLargePageKind()));
   katana::ReportParam("(NULL)", "Hosts", 1);
   if (input) {
     katana::ReportParam("(NULL)", "Input", input->getValue());
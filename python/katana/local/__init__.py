@@ -6,7 +6,7 @@ remote server and cannot load or process graphs that do not fit in memory.
 
 # Register numba overloads
 import katana.native_interfacing.pyarrow
-from katana.local import graph_adds
+from katana.local import graph_adds, property_frame
 from katana.local._shared_mem_sys import initialize
 from katana.local.barrier import Barrier, SimpleBarrier, get_fast_barrier
 from katana.local.datastructures import AllocationPolicy, InsertBag, NUMAArray
@@ -22,6 +22,8 @@ from katana.local_native import (
     ReduceOr,
     ReduceSum,
     TxnContext,
+    export_metrics,
+    push_metrics,
 )
 from katana.native_interfacing.numpy_atomic import atomic_add, atomic_max, atomic_min, atomic_sub
 
@@ -48,6 +50,12 @@ __all__ = [
     "EntityType",
     "AtomicEntityType",
     "EntityTypeManager",
+    "export_metrics",
+    "push_metrics",
 ]
 
 Graph.out_edges = graph_adds.out_edges
+Graph.node_property_array = graph_adds.node_property_array
+Graph.edge_property_array = graph_adds.edge_property_array
+Graph.node_frame = property_frame.node_frame
+Graph.edge_frame = property_frame.edge_frame
@@ -21,6 +21,8 @@ Statistics
 Algorithms
 ----------
 
+.. automodule:: katana.local.analytics._analytics_session
+
 .. automodule:: katana.local.analytics._betweenness_centrality
 
 .. automodule:: katana.local.analytics._bfs
@@ -29,6 +31,8 @@ Algorithms
 
 .. automodule:: katana.local.analytics._connected_components
 
+.. automodule:: katana.local.analytics._graph_coloring
+
 .. automodule:: katana.local.analytics._independent_set
 
 .. automodule:: katana.local.analytics._louvain_clustering
@@ -54,6 +58,7 @@ Algorithms
 """
 
 
+from katana.local.analytics._analytics_session import AnalyticsSession
 from katana.local.analytics._betweenness_centrality import (
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
@@ -67,6 +72,12 @@ from katana.local.analytics._connected_components import (
     connected_components,
     connected_components_assert_valid,
 )
+from katana.local.analytics._graph_coloring import (
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    graph_coloring,
+    graph_coloring_assert_valid,
+)
 from katana.local.analytics._independent_set import (
     IndependentSetPlan,
     IndependentSetStatistics,
@@ -0,0 +1,203 @@
+"""
+Analytics Sessions
+------------------
+
+.. autoclass:: katana.local.analytics.AnalyticsSession
+    :members:
+"""
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+
+from katana.local import TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from katana.local.analytics._bfs import BfsPlan
+from katana.local.analytics._connected_components import ConnectedComponentsPlan
+from katana.local.analytics._local_clustering_coefficient import LocalClusteringCoefficientPlan
+from katana.local.analytics._pagerank import PagerankPlan
+from katana.local.analytics._sssp import SsspPlan
+
+
+cdef extern from "katana/analytics/analytics_session/analytics_session.h" namespace "katana::analytics" nogil:
+    cppclass _BfsPlan "katana::analytics::BfsPlan" (_Plan):
+        pass
+
+    cppclass _SsspPlan "katana::analytics::SsspPlan" (_Plan):
+        pass
+
+    cppclass _PagerankPlan "katana::analytics::PagerankPlan" (_Plan):
+        pass
+
+    cppclass _ConnectedComponentsPlan "katana::analytics::ConnectedComponentsPlan" (_Plan):
+        pass
+
+    cppclass _LocalClusteringCoefficientPlan "katana::analytics::LocalClusteringCoefficientPlan" (_Plan):
+        pass
+
+    cppclass _AnalyticsSession "katana::analytics::AnalyticsSession":
+        _AnalyticsSession(_PropertyGraph* pg)
+
+        _AnalyticsSession& AddBfs(uint32_t start_node, const string& output_property_name, _BfsPlan plan)
+        _AnalyticsSession& AddBfsLevels(uint32_t start_node, const string& output_property_name, _BfsPlan plan)
+        _AnalyticsSession& AddSssp(
+            uint32_t start_node, const string& edge_weight_property_name, const string& output_property_name,
+            _SsspPlan plan)
+        _AnalyticsSession& AddPagerank(const string& output_property_name, _PagerankPlan plan)
+        _AnalyticsSession& AddConnectedComponents(
+            const string& output_property_name, bint is_symmetric, _ConnectedComponentsPlan plan)
+        _AnalyticsSession& AddLocalClusteringCoefficient(
+            const string& output_property_name, _LocalClusteringCoefficientPlan plan)
+
+        Result[void] Run(CTxnContext* txn_ctx)
+        Result[shared_ptr[CTable]] RunToTable(CTxnContext* txn_ctx)
+        void ReleaseViews()
+        size_t size() const
+
+
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef _Plan* plan_of_type(plan, plan_type) except NULL:
+    if not isinstance(plan, plan_type):
+        raise TypeError(f"expected a {plan_type.__name__}, got {type(plan).__name__}")
+    return (<Plan>plan).underlying()
+
+
+cdef class AnalyticsSession:
+    """
+    A batch of analytics over one graph that runs as a single native call.
+
+    The session loads the properties the analytics read and builds the views they need once for the whole batch, and
+    keeps the views between runs, so a loop that queues and runs a sweep of parameters prepares the graph only once.
+    :py:meth:`run_to_table` returns the outputs of a batch as the columns of a table instead of adding them to the
+    graph:
+
+    .. code-block:: python
+
+        session = AnalyticsSession(graph)
+        for alpha in (0.75, 0.8, 0.85, 0.9):
+            session.add_pagerank(f"rank_{alpha}", PagerankPlan.pull_topological(alpha=alpha))
+        ranks = session.run_to_table()
+
+    Queuing BFS levels from many sources fuses them into one multi-source BFS. The graph must not be modified while
+    analytics are queued.
+    """
+    cdef:
+        unique_ptr[_AnalyticsSession] underlying
+        readonly object graph
+
+    def __init__(self, graph):
+        """
+        :param graph: The graph to analyze.
+        :type graph: katana.local.Graph
+        """
+        self.graph = graph
+        self.underlying.reset(new _AnalyticsSession(underlying_property_graph(graph)))
+
+    def __len__(self):
+        """
+        The number of analytics queued.
+        """
+        return self.underlying.get().size()
+
+    def add_bfs(self, uint32_t start_node, str output_property_name, plan=None):
+        """
+        Queue :py:func:`~katana.local.analytics.bfs` from `start_node` into `output_property_name`.
+        """
+        cdef _BfsPlan c_plan
+        if plan is not None:
+            c_plan = (<_BfsPlan*>plan_of_type(plan, BfsPlan))[0]
+        self.underlying.get().AddBfs(start_node, bytes(output_property_name, "utf-8"), c_plan)
+        return self
+
+    def add_bfs_levels(self, uint32_t start_node, str output_property_name, plan=None):
+        """
+        Queue the BFS level of every node from `start_node` into the uint32 property `output_property_name`. All the
+        levels queued with the same plan, which must be synchronous, are computed together.
+        """
+        cdef _BfsPlan c_plan
+        if plan is not None:
+            c_plan = (<_BfsPlan*>plan_of_type(plan, BfsPlan))[0]
+        self.underlying.get().AddBfsLevels(start_node, bytes(output_property_name, "utf-8"), c_plan)
+        return self
+
+    def add_sssp(self, uint32_t start_node, str edge_weight_property_name, str output_property_name, plan=None):
+        """
+        Queue :py:func:`~katana.local.analytics.sssp` from `start_node` into `output_property_name`.
+        """
+        cdef _SsspPlan c_plan
+        if plan is not None:
+            c_plan = (<_SsspPlan*>plan_of_type(plan, SsspPlan))[0]
+        self.underlying.get().AddSssp(
+            start_node, bytes(edge_weight_property_name, "utf-8"), bytes(output_property_name, "utf-8"), c_plan)
+        return self
+
+    def add_pagerank(self, str output_property_name, plan=None):
+        """
+        Queue :py:func:`~katana.local.analytics.pagerank` into `output_property_name`.
+        """
+        cdef _PagerankPlan c_plan
+        if plan is not None:
+            c_plan = (<_PagerankPlan*>plan_of_type(plan, PagerankPlan))[0]
+        self.underlying.get().AddPagerank(bytes(output_property_name, "utf-8"), c_plan)
+        return self
+
+    def add_connected_components(self, str output_property_name, bint is_symmetric=False, plan=None):
+        """
+        Queue :py:func:`~katana.local.analytics.connected_components` into `output_property_name`.
+        """
+        cdef _ConnectedComponentsPlan c_plan
+        if plan is not None:
+            c_plan = (<_ConnectedComponentsPlan*>plan_of_type(plan, ConnectedComponentsPlan))[0]
+        self.underlying.get().AddConnectedComponents(bytes(output_property_name, "utf-8"), is_symmetric, c_plan)
+        return self
+
+    def add_local_clustering_coefficient(self, str output_property_name, plan=None):
+        """
+        Queue :py:func:`~katana.local.analytics.local_clustering_coefficient` into `output_property_name`.
+        """
+        cdef _LocalClusteringCoefficientPlan c_plan
+        if plan is not None:
+            c_plan = (<_LocalClusteringCoefficientPlan*>plan_of_type(plan, LocalClusteringCoefficientPlan))[0]
+        self.underlying.get().AddLocalClusteringCoefficient(bytes(output_property_name, "utf-8"), c_plan)
+        return self
+
+    def run(self, *, txn_ctx=None):
+        """
+        Run the queued analytics, adding their outputs to the graph, and clear the queue. If any analytic fails,
+        none of the outputs is added.
+        """
+        txn_ctx = txn_ctx or TxnContext()
+        cdef CTxnContext* c_txn_ctx = underlying_txn_context(txn_ctx)
+        with nogil:
+            handle_result_void(self.underlying.get().Run(c_txn_ctx))
+
+    def run_to_table(self, *, txn_ctx=None):
+        """
+        Run the queued analytics like :py:meth:`run`, but return their outputs, in the order they were queued, as
+        the columns of a `pyarrow.Table` instead of adding them to the graph.
+        """
+        txn_ctx = txn_ctx or TxnContext()
+        cdef CTxnContext* c_txn_ctx = underlying_txn_context(txn_ctx)
+        cdef shared_ptr[CTable] table
+        with nogil:
+            table = handle_result_table(self.underlying.get().RunToTable(c_txn_ctx))
+        return pyarrow_wrap_table(table)
+
+    def release_views(self):
+        """
+        Release the views kept since the last run so that their memory may be reclaimed.
+        """
+        self.underlying.get().ReleaseViews()
@@ -39,8 +39,13 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kAdaptive "katana::analytics::BetweennessCentralityPlan::kAdaptive"
+            kAsynchronous "katana::analytics::BetweennessCentralityPlan::kAsynchronous"
+            kAutomatic "katana::analytics::BetweennessCentralityPlan::kAutomatic"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        float epsilon() const
+        float delta() const
 
         BetweennessCentralityPlan()
 
@@ -49,10 +54,19 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Adaptive(float epsilon, float delta)
+        @staticmethod
+        _BetweennessCentralityPlan Asynchronous()
+        @staticmethod
+        _BetweennessCentralityPlan Automatic()
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
 
+    float kDefaultEpsilon "katana::analytics::BetweennessCentralityPlan::kDefaultEpsilon"
+    float kDefaultDelta "katana::analytics::BetweennessCentralityPlan::kDefaultDelta"
+
     Result[void] BetweennessCentrality(_PropertyGraph* pg, string output_property_name, CTxnContext* txn_ctx, const BetweennessCentralitySources& sources, _BetweennessCentralityPlan plan)
 
     # std_result[void] BetweennessCentralityAssertValid(Graph* pg, string output_property_name)
@@ -87,6 +101,9 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Adaptive = _BetweennessCentralityPlan.Algorithm.kAdaptive
+    Asynchronous = _BetweennessCentralityPlan.Algorithm.kAsynchronous
+    Automatic = _BetweennessCentralityPlan.Algorithm.kAutomatic
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -127,6 +144,31 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def asynchronous():
+        """
+        Build the shortest path DAG of each source without barriers between
+        levels. Suits graphs of high diameter.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Asynchronous())
+
+    @staticmethod
+    def automatic():
+        """
+        Choose the asynchronous algorithm for graphs of high estimated diameter
+        and the level algorithm otherwise.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Automatic())
+
+    @staticmethod
+    def adaptive(float epsilon = kDefaultEpsilon, float delta = kDefaultDelta):
+        """
+        Parallelize the outer-most iteration over sources sampled in batches
+        until, with probability 1 - delta, every centrality normalized by
+        n(n - 2) is within epsilon. Sources must not be given.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Adaptive(epsilon, delta))
+
 
 def betweenness_centrality(pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan(),
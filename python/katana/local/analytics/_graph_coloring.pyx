@@ -0,0 +1,201 @@
+"""
+Graph Coloring
+--------------
+
+.. autoclass:: katana.local.analytics.GraphColoringPlan
+
+
+.. autoclass:: katana.local.analytics._graph_coloring._GraphColoringPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.graph_coloring
+
+.. autoclass:: katana.local.analytics.GraphColoringStatistics
+
+
+.. autofunction:: katana.local.analytics.graph_coloring_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/graph_coloring/graph_coloring.h" namespace "katana::analytics" nogil:
+    cppclass _GraphColoringPlan "katana::analytics::GraphColoringPlan" (_Plan):
+        enum Algorithm:
+            kJonesPlassmann "katana::analytics::GraphColoringPlan::kJonesPlassmann"
+            kLargestDegreeFirst "katana::analytics::GraphColoringPlan::kLargestDegreeFirst"
+
+        _GraphColoringPlan.Algorithm algorithm() const
+
+        GraphColoringPlan()
+
+        @staticmethod
+        _GraphColoringPlan FromAlgorithm(_GraphColoringPlan.Algorithm algorithm);
+
+        @staticmethod
+        _GraphColoringPlan JonesPlassmann()
+        @staticmethod
+        _GraphColoringPlan LargestDegreeFirst()
+
+    Result[void] GraphColoring(_PropertyGraph* pg, string output_property_name, CTxnContext* txn_ctx, _GraphColoringPlan plan)
+
+    Result[void] GraphColoringAssertValid(_PropertyGraph* pg, string output_property_name)
+
+    cppclass _GraphColoringStatistics "katana::analytics::GraphColoringStatistics":
+        uint32_t num_colors
+        uint64_t largest_color_size
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_GraphColoringStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _GraphColoringPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.GraphColoringPlan` constructors for algorithm documentation.
+    """
+    JonesPlassmann = _GraphColoringPlan.Algorithm.kJonesPlassmann
+    LargestDegreeFirst = _GraphColoringPlan.Algorithm.kLargestDegreeFirst
+
+
+cdef class GraphColoringPlan(Plan):
+    """
+    A computational :ref:`Plan` for Graph Coloring.
+
+    Static methods construct GraphColoringPlans.
+    """
+    cdef:
+        _GraphColoringPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _GraphColoringPlanAlgorithm
+
+    @staticmethod
+    cdef GraphColoringPlan make(_GraphColoringPlan u):
+        f = <GraphColoringPlan>GraphColoringPlan.__new__(GraphColoringPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _GraphColoringPlanAlgorithm:
+        return _GraphColoringPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def jones_plassmann():
+        """
+        Jones-Plassmann coloring with random priorities: every round colors the nodes whose priority is higher than
+        that of their uncolored neighbors, each with the smallest color none of its neighbors has.
+        """
+        return GraphColoringPlan.make(_GraphColoringPlan.JonesPlassmann())
+
+    @staticmethod
+    def largest_degree_first():
+        """
+        Jones-Plassmann coloring with nodes of higher degree first, ties broken at random, which usually takes fewer
+        colors and more rounds.
+        """
+        return GraphColoringPlan.make(_GraphColoringPlan.LargestDegreeFirst())
+
+
+def graph_coloring(pg, str output_property_name,
+             GraphColoringPlan plan = GraphColoringPlan(), *, txn_ctx = None):
+    """
+    Color the nodes of the graph such that no two adjacent nodes have the same color. The graph must be symmetric. The
+    property named output_property_name is created by this function and may not exist before the call. The created
+    property has type uint32_t.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to write colors into. This property must not already exist.
+    :type plan: GraphColoringPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The tranaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("ldbc_003"))
+        from katana.analytics import graph_coloring, GraphColoringStatistics
+        graph_coloring(graph, "output")
+        stats = GraphColoringStatistics(graph, "output")
+        print(stats)
+
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(GraphColoring(underlying_property_graph(pg), output_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
+
+
+def graph_coloring_assert_valid(pg, str output_property_name):
+    """
+    Raise an exception if the Graph Coloring results in `pg` are invalid: a node is uncolored or has the color of one
+    of its neighbors.
+
+    :raises: AssertionError
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_assert(GraphColoringAssertValid(underlying_property_graph(pg), output_property_name_cstr))
+
+
+cdef _GraphColoringStatistics handle_result_GraphColoringStatistics(Result[_GraphColoringStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class GraphColoringStatistics:
+    """
+    Compute the :ref:`statistics` of a Graph Coloring.
+    """
+    cdef _GraphColoringStatistics underlying
+
+    def __init__(self, pg, str output_property_name):
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_GraphColoringStatistics(_GraphColoringStatistics.Compute(
+                underlying_property_graph(pg), output_property_name_cstr))
+
+    @property
+    def num_colors(self) -> int:
+        """
+        The number of colors used.
+        """
+        return self.underlying.num_colors
+
+    @property
+    def largest_color_size(self) -> int:
+        """
+        The number of nodes of the most common color.
+        """
+        return self.underlying.largest_color_size
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
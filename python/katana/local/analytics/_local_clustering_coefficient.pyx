@@ -10,6 +10,7 @@ Local Clustering Coefficient
 
 .. autofunction:: katana.local.analytics.local_clustering_coefficient
 """
+from libc.stdint cimport uint32_t
 from libcpp cimport bool
 from libcpp.string cimport string
 
@@ -32,6 +33,7 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
         enum Algorithm:
             kOrderedCountAtomics "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountAtomics"
             kOrderedCountPerThread "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountPerThread"
+            kDegreeOrdered "katana::analytics::LocalClusteringCoefficientPlan::kDegreeOrdered"
 
         enum Relabeling:
             kRelabel "katana::analytics::LocalClusteringCoefficientPlan::kRelabel"
@@ -41,6 +43,8 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
         _LocalClusteringCoefficientPlan.Algorithm algorithm() const
         _LocalClusteringCoefficientPlan.Relabeling relabeling() const
         bool edges_sorted() const
+        uint32_t sample_min_degree() const
+        double max_error() const
 
         # LocalClusteringCoefficientPlan()
 
@@ -54,9 +58,16 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
                 bool edges_sorted,
                 _LocalClusteringCoefficientPlan.Relabeling relabeling
             )
+        @staticmethod
+        _LocalClusteringCoefficientPlan DegreeOrdered(
+                uint32_t sample_min_degree,
+                double max_error
+            )
 
     _LocalClusteringCoefficientPlan.Relabeling kDefaultRelabeling "katana::analytics::LocalClusteringCoefficientPlan::kDefaultRelabeling"
     bool kDefaultEdgesSorted "katana::analytics::LocalClusteringCoefficientPlan::kDefaultEdgesSorted"
+    uint32_t kNoSampling "katana::analytics::LocalClusteringCoefficientPlan::kNoSampling"
+    double kDefaultMaxError "katana::analytics::LocalClusteringCoefficientPlan::kDefaultMaxError"
 
     Result[void] LocalClusteringCoefficient(_PropertyGraph* pfg, const string& output_property_name, CTxnContext* txn_ctx, _LocalClusteringCoefficientPlan plan)
 
@@ -67,6 +78,7 @@ class _LocalClusteringCoefficientPlanAlgorithm(Enum):
     """
     OrderedCountAtomics = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountAtomics
     OrderedCountPerThread = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountPerThread
+    DegreeOrdered = _LocalClusteringCoefficientPlan.Algorithm.kDegreeOrdered
 
 
 cdef _relabeling_to_python(v):
@@ -114,6 +126,14 @@ cdef class LocalClusteringCoefficientPlan(Plan):
     def edges_sorted(self) -> bool:
         return self.underlying_.edges_sorted()
 
+    @property
+    def sample_min_degree(self) -> int:
+        return self.underlying_.sample_min_degree()
+
+    @property
+    def max_error(self) -> float:
+        return self.underlying_.max_error()
+
     @staticmethod
     def ordered_count_atomics(
                 relabeling = _relabeling_to_python(kDefaultRelabeling),
@@ -152,6 +172,27 @@ cdef class LocalClusteringCoefficientPlan(Plan):
         return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.OrderedCountPerThread(
              edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def degree_ordered(
+                uint32_t sample_min_degree = kNoSampling,
+                double max_error = kDefaultMaxError
+            ):
+        """
+        Count the triangles on the view of the graph with its nodes sorted by
+        degree, which triangle counting shares, so that each triangle is found
+        from its node of least degree, as the ordered count of triangle
+        counting does.
+
+        The coefficients of the nodes of at least sample_min_degree are
+        estimated from a sample of their pairs of neighbors, large enough for
+        each to be within max_error of the coefficient with 95% confidence.
+
+        :param sample_min_degree: Sample the nodes with at least this degree; by default none are.
+        :param max_error: Bound of the absolute error of a sampled coefficient.
+        """
+        return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.DegreeOrdered(
+             sample_min_degree, max_error))
+
 
 def local_clustering_coefficient(pg, str output_property_name, LocalClusteringCoefficientPlan plan = LocalClusteringCoefficientPlan(), *, txn_ctx = None):
     cdef string output_property_name_str = bytes(output_property_name, "utf-8")
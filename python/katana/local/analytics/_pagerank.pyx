@@ -41,6 +41,7 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
+            kPropagationBlocking "katana::analytics::PagerankPlan::kPropagationBlocking"
 
         # unsigned int kChunkSize
 
@@ -60,6 +61,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
         @staticmethod
         _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
+        @staticmethod
+        _PagerankPlan PropagationBlocking(float tolerance, unsigned int max_iterations, float alpha)
 
     double kDefaultTolerance "katana::analytics::PagerankPlan::kDefaultTolerance"
     int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
@@ -85,6 +88,7 @@ class _PagerankPlanAlgorithm(Enum):
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PropagationBlocking = _PagerankPlan.Algorithm.kPropagationBlocking
 
 
 cdef class PagerankPlan(Plan):
@@ -166,6 +170,16 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PushSynchronous(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def propagation_blocking(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
+        """
+        Propagation blocking algorithm
+
+        Scatters contributions into bins by destination block and then sums
+        one cache sized block at a time. The graph need not be transposed.
+        """
+        return PagerankPlan.make(_PagerankPlan.PropagationBlocking(tolerance, max_iterations, alpha))
+
 
 def pagerank(pg, str output_property_name, PagerankPlan plan = PagerankPlan(), *, txn_ctx = None):
     """
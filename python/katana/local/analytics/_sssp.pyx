@@ -39,6 +39,7 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kDeltaStep "katana::analytics::SsspPlan::kDeltaStep"
             kDeltaStepBarrier "katana::analytics::SsspPlan::kDeltaStepBarrier"
             kDeltaStepFusion "katana::analytics::SsspPlan::kDeltaStepFusion"
+            kDeltaStepMultiQueue "katana::analytics::SsspPlan::kDeltaStepMultiQueue"
             kSerialDeltaTile "katana::analytics::SsspPlan::kSerialDeltaTile"
             kSerialDelta "katana::analytics::SsspPlan::kSerialDelta"
             kDijkstraTile "katana::analytics::SsspPlan::kDijkstraTile"
@@ -46,6 +47,7 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kTopological "katana::analytics::SsspPlan::kTopological"
             kTopologicalTile "katana::analytics::SsspPlan::kTopologicalTile"
             kAutomatic "katana::analytics::SsspPlan::kAutomatic"
+            kRadiusStep "katana::analytics::SsspPlan::kRadiusStep"
 
         _SsspPlan()
         _SsspPlan(const _PropertyGraph * pg)
@@ -53,6 +55,7 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         _SsspPlan.Algorithm algorithm() const
         unsigned delta() const
         ptrdiff_t edge_tile_size() const
+        unsigned radius_neighbors() const
 
         @staticmethod
         _SsspPlan DeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
@@ -63,6 +66,8 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         @staticmethod
         _SsspPlan DeltaStepFusion(unsigned delta)
         @staticmethod
+        _SsspPlan DeltaStepMultiQueue(unsigned delta)
+        @staticmethod
         _SsspPlan SerialDeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
         @staticmethod
         _SsspPlan SerialDelta(unsigned delta)
@@ -74,9 +79,13 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         _SsspPlan Topological()
         @staticmethod
         _SsspPlan TopologicalTile(ptrdiff_t edge_tile_size)
+        @staticmethod
+        _SsspPlan RadiusStep(unsigned radius_neighbors)
 
     unsigned kDefaultDelta "katana::analytics::SsspPlan::kDefaultDelta"
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::SsspPlan::kDefaultEdgeTileSize"
+    unsigned kDefaultRadiusNeighbors "katana::analytics::SsspPlan::kDefaultRadiusNeighbors"
+    unsigned kAutomaticDelta "katana::analytics::SsspPlan::kAutomaticDelta"
 
     Result[void] Sssp(_PropertyGraph* pg, size_t start_node,
         const string& edge_weight_property_name, const string& output_property_name, CTxnContext* txn_ctx, _SsspPlan plan)
@@ -105,6 +114,7 @@ class _SsspAlgorithm(Enum):
     DeltaStep = _SsspPlan.Algorithm.kDeltaStep
     DeltaStepBarrier = _SsspPlan.Algorithm.kDeltaStepBarrier
     DeltaStepFusion = _SsspPlan.Algorithm.kDeltaStepFusion
+    DeltaStepMultiQueue = _SsspPlan.Algorithm.kDeltaStepMultiQueue
     SerialDeltaTile = _SsspPlan.Algorithm.kSerialDeltaTile
     SerialDelta = _SsspPlan.Algorithm.kSerialDelta
     DijkstraTile = _SsspPlan.Algorithm.kDijkstraTile
@@ -112,6 +122,7 @@ class _SsspAlgorithm(Enum):
     Topological = _SsspPlan.Algorithm.kTopological
     TopologicalTile = _SsspPlan.Algorithm.kTopologicalTile
     Automatic = _SsspPlan.Algorithm.kAutomatic
+    RadiusStep = _SsspPlan.Algorithm.kRadiusStep
 
 
 cdef class SsspPlan(Plan):
@@ -155,6 +166,7 @@ cdef class SsspPlan(Plan):
     def delta(self) -> int:
         """
         The exponent of the delta step size (2 based). A delta of 4 will produce a real delta step size of 16.
+        :py:data:`SsspPlan.automatic_delta` if it is chosen from the edge weights at run time.
         """
         return self.underlying_.delta()
     @property
@@ -163,6 +175,17 @@ cdef class SsspPlan(Plan):
         The edge tile size.
         """
         return self.underlying_.edge_tile_size()
+    @property
+    def radius_neighbors(self) -> int:
+        """
+        The number of nearest neighbors of a node its radius covers in radius stepping.
+        """
+        return self.underlying_.radius_neighbors()
+
+    automatic_delta = kAutomaticDelta
+    """
+    Pass as the delta to have it chosen from a sample of the edge weights and the average degree.
+    """
 
     def __init__(self):
         """
@@ -198,6 +221,13 @@ cdef class SsspPlan(Plan):
         """
         return SsspPlan.make(_SsspPlan.DeltaStepFusion(delta))
 
+    @staticmethod
+    def delta_step_multi_queue(unsigned delta = kDefaultDelta) -> SsspPlan:
+        """
+        Delta stepping with a MultiQueue worklist
+        """
+        return SsspPlan.make(_SsspPlan.DeltaStepMultiQueue(delta))
+
     @staticmethod
     def serial_delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         """
@@ -240,6 +270,14 @@ cdef class SsspPlan(Plan):
         """
         return SsspPlan.make(_SsspPlan.TopologicalTile(edge_tile_size))
 
+    @staticmethod
+    def radius_step(unsigned radius_neighbors = kDefaultRadiusNeighbors) -> SsspPlan:
+        """
+        Radius stepping: each round settles all nodes up to the least distance plus radius of the nodes left, where the
+        radius of a node is the weight of its `radius_neighbors`-th lightest out edge.
+        """
+        return SsspPlan.make(_SsspPlan.RadiusStep(radius_neighbors))
+
 
 def sssp(pg, size_t start_node, str edge_weight_property_name, str output_property_name,
          SsspPlan plan = SsspPlan(), *, txn_ctx = None):
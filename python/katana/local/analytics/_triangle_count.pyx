@@ -8,6 +8,9 @@ Triangle Counting
 .. [Schank] Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
     Thesis. Universitat Karlsruhe. 2007.
 
+.. [Pagh] Rasmus Pagh and Charalampos E. Tsourakakis. Colorful Triangle Counting and a
+    MapReduce Implementation. Information Processing Letters 112(7). 2012.
+
 .. autoclass:: katana.local.analytics._triangle_count._TriangleCountPlanAlgorithm
 
 
@@ -31,6 +34,7 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
             kNodeIteration "katana::analytics::TriangleCountPlan::kNodeIteration"
             kEdgeIteration "katana::analytics::TriangleCountPlan::kEdgeIteration"
             kOrderedCount "katana::analytics::TriangleCountPlan::kOrderedCount"
+            kApproximate "katana::analytics::TriangleCountPlan::kApproximate"
 
         enum Relabeling:
             kRelabel "katana::analytics::TriangleCountPlan::kRelabel"
@@ -40,6 +44,7 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan.Algorithm algorithm() const
         _TriangleCountPlan.Relabeling relabeling() const
         bool edges_sorted() const
+        double relative_error() const
 
         TriangleCountPlan()
 
@@ -49,10 +54,13 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan EdgeIteration(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
         @staticmethod
         _TriangleCountPlan OrderedCount(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
+        @staticmethod
+        _TriangleCountPlan Approximate(double relative_error)
 
 
     _TriangleCountPlan.Relabeling kDefaultRelabeling "katana::analytics::TriangleCountPlan::kDefaultRelabeling"
     bool kDefaultEdgeSorted "katana::analytics::TriangleCountPlan::kDefaultEdgeSorted"
+    double kDefaultRelativeError "katana::analytics::TriangleCountPlan::kDefaultRelativeError"
 
     Result[uint64_t] TriangleCount(_PropertyGraph* pg, _TriangleCountPlan plan)
 
@@ -61,6 +69,7 @@ class _TriangleCountPlanAlgorithm(Enum):
     NodeIteration = _TriangleCountPlan.Algorithm.kNodeIteration
     EdgeIteration = _TriangleCountPlan.Algorithm.kEdgeIteration
     OrderedCount = _TriangleCountPlan.Algorithm.kOrderedCount
+    Approximate = _TriangleCountPlan.Algorithm.kApproximate
 
 
 cdef _relabeling_to_python(v):
@@ -123,6 +132,15 @@ cdef class TriangleCountPlan(Plan):
         """
         return _relabeling_to_python(self.underlying_.relabeling())
 
+    @property
+    def relative_error(self) -> float:
+        """
+        The target relative standard error of an approximate count.
+
+        :rtype: float
+        """
+        return self.underlying_.relative_error()
+
     @staticmethod
     def node_iteration(bool edges_sorted = kDefaultEdgeSorted,
                        relabeling = _relabeling_to_python(kDefaultRelabeling)):
@@ -167,6 +185,17 @@ cdef class TriangleCountPlan(Plan):
         return TriangleCountPlan.make(_TriangleCountPlan.OrderedCount(
             edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def approximate(double relative_error = kDefaultRelativeError):
+        """
+        Estimate the count from the triangles whose nodes all get the same random color [Pagh]_,
+        sampling the unsorted graph without copying it.
+
+        :type relative_error: float
+        :param relative_error: Target relative standard error of the estimate, or 0 for an exact count.
+        """
+        return TriangleCountPlan.make(_TriangleCountPlan.Approximate(relative_error))
+
     def __str__(self):
         return "TriangleCountPlan({}, {}, {})".format(self.algorithm.name, self.edges_sorted, self.relabeling)
 
@@ -1,6 +1,7 @@
 from typing import Optional, Sequence, Union
 
 import numpy
+import pyarrow
 
 import katana.local._graph_numba
 from katana.dataframe import DataFrame, LazyDataFrame
@@ -101,3 +102,45 @@ def _build_edge_arrays(self, nodes, output_len):
             dests[i] = self.get_edge_dst(e)
             i += 1
     return dict(id=ids, source=sources, dest=dests)
+
+
+def node_property_array(self: Graph, name: str) -> numpy.ndarray:
+    """
+    :returns: the node property `name` as a read only `numpy.ndarray` that shares the memory of the property.
+
+    Numba compiled operators index numpy arrays directly, where each access to an Arrow array is a call into native
+    code, so pass these, and the arrays from :py:meth:`Graph.topology_arrays`, to operators that read properties in
+    their inner loops:
+
+    .. code-block:: Python
+
+        out_indices, out_dests = graph.topology_arrays()
+        weights = graph.edge_property_array("weight")
+        do_all(graph, relax_operator(out_indices, out_dests, weights, dists))
+
+    The property must be of a numeric type and have no nulls. A property of several chunks is copied into one array.
+    """
+    return _property_array(self.get_node_property(name), name)
+
+
+def edge_property_array(self: Graph, name: str) -> numpy.ndarray:
+    """
+    :returns: the edge property `name` as a read only `numpy.ndarray`, indexed by edge id in the default topology.
+        See :py:meth:`node_property_array`.
+    """
+    return _property_array(self.get_edge_property(name), name)
+
+
+def _property_array(prop: pyarrow.ChunkedArray, name: str) -> numpy.ndarray:
+    if prop.null_count:
+        raise ValueError(f"property {name} has {prop.null_count} nulls")
+    if prop.num_chunks == 0:
+        return numpy.empty(0, dtype=prop.type.to_pandas_dtype())
+    if prop.num_chunks == 1:
+        array = prop.chunk(0)
+    else:
+        array = pyarrow.concat_arrays(prop.chunks)
+    try:
+        return array.to_numpy(zero_copy_only=True)
+    except pyarrow.ArrowInvalid as e:
+        raise TypeError(f"property {name} of type {prop.type} has no numpy view") from e
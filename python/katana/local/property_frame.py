@@ -0,0 +1,273 @@
+from typing import Any, Iterator, List, Optional, Sequence, Tuple, Union
+
+import numpy
+import pandas
+import pyarrow
+
+from katana.dataframe import DataFrame
+
+DEFAULT_BATCH_SIZE = 1 << 16
+
+_COMPARISONS = ("==", "!=", "<", "<=", ">", ">=")
+
+
+class PropertyFrame(DataFrame):
+    """
+    A lazy, chunked data frame over the node or edge properties of a graph, with a row per node or edge.
+
+    Selecting columns, filtering and slicing rows only record what to read. Nothing is read until the frame is
+    iterated with :py:meth:`batches` or converted with :py:meth:`to_arrow` or :py:meth:`to_pandas`. Filters on
+    properties and entity types are evaluated in native code by the vectorized kernels of
+    :py:meth:`~katana.local.Graph.filter_nodes` and :py:meth:`~katana.local.Graph.filter_edges`, and only the ids
+    they select come back to Python.
+
+    :py:meth:`batches` streams `pyarrow.RecordBatch` of at most `batch_size` rows. Batches of contiguous rows share
+    the memory of the graph, and others copy only their own rows, so Python holds one batch at a time however large
+    the properties are. Properties that are not loaded are loaded for the iteration, and, with `unload=True`, unloaded
+    again after it, so a frame can walk the properties of a graph one batch at a time without keeping them in memory.
+
+    .. code-block:: Python
+
+        adults = graph.node_frame(["name", "age"]).of_type(person).where("age", ">=", 18)
+        for batch in adults.batches(batch_size=1 << 20, with_ids=True, unload=True):
+            process(batch.to_pandas())
+
+    Filters apply to every node or edge of the graph, so they must come before slicing rows.
+    """
+
+    def __init__(
+        self,
+        graph,
+        kind: str,
+        columns: Optional[Sequence[str]] = None,
+        *,
+        conditions: Sequence[Tuple[str, str, Any]] = (),
+        entity_type=None,
+        rows: Optional[range] = None,
+        batch_size: int = DEFAULT_BATCH_SIZE,
+    ):
+        if kind not in ("node", "edge"):
+            raise ValueError(f"kind must be 'node' or 'edge', not {kind!r}")
+        if batch_size <= 0:
+            raise ValueError("batch_size must be positive")
+        self._graph = graph
+        self._kind = kind
+        schema = self._full_schema()
+        if columns is None:
+            columns = schema.names
+        for name in columns:
+            if schema.get_field_index(name) < 0:
+                raise ValueError(f"no {kind} property {name!r}")
+        self._columns = list(columns)
+        self._fields = [schema.field(name) for name in self._columns]
+        self._conditions = tuple(conditions)
+        self._entity_type = entity_type
+        self._rows = rows
+        self._batch_size = batch_size
+        # the ids selected by the filters, computed on first use
+        self._filtered_ids: Optional[numpy.ndarray] = None
+
+    def _num_entities(self) -> int:
+        return self._graph.num_nodes() if self._kind == "node" else self._graph.num_edges()
+
+    def _full_schema(self) -> pyarrow.Schema:
+        if self._kind == "node":
+            return self._graph.full_node_schema()
+        return self._graph.full_edge_schema()
+
+    def _loaded_names(self) -> List[str]:
+        if self._kind == "node":
+            return self._graph.loaded_node_schema().names
+        return self._graph.loaded_edge_schema().names
+
+    def _property(self, name: str) -> pyarrow.ChunkedArray:
+        if self._kind == "node":
+            return self._graph.get_node_property(name)
+        return self._graph.get_edge_property(name)
+
+    def _unload(self, name: str):
+        if self._kind == "node":
+            self._graph.unload_node_property(name)
+        else:
+            self._graph.unload_edge_property(name)
+
+    def _is_filtered(self) -> bool:
+        return bool(self._conditions) or self._entity_type is not None
+
+    def _filtered(self) -> Union[range, numpy.ndarray]:
+        """
+        :return: The ids of the entities that pass the filters, before slicing rows.
+        """
+        if not self._is_filtered():
+            return range(self._num_entities())
+        if self._filtered_ids is None:
+            filter_fn = self._graph.filter_nodes if self._kind == "node" else self._graph.filter_edges
+            self._filtered_ids = filter_fn(list(self._conditions), self._entity_type)
+        return self._filtered_ids
+
+    def _selected(self) -> Union[range, numpy.ndarray]:
+        """
+        :return: The ids of the entities of the rows of this frame, in order.
+        """
+        ids = self._filtered()
+        if self._rows is None:
+            return ids
+        if isinstance(ids, range):
+            return ids[self._rows.start : self._rows.stop : self._rows.step]
+        if self._rows.step == 1:
+            return ids[self._rows.start : self._rows.stop]
+        return ids[numpy.arange(self._rows.start, self._rows.stop, self._rows.step)]
+
+    def _derive(self, **kwargs) -> "PropertyFrame":
+        args = dict(
+            columns=self._columns,
+            conditions=self._conditions,
+            entity_type=self._entity_type,
+            rows=self._rows,
+            batch_size=self._batch_size,
+        )
+        args.update(kwargs)
+        frame = PropertyFrame(self._graph, self._kind, **args)
+        if frame._conditions == self._conditions and frame._entity_type is self._entity_type:
+            frame._filtered_ids = self._filtered_ids
+        return frame
+
+    def select(self, columns: Sequence[str]) -> "PropertyFrame":
+        """
+        :return: A frame of the properties `columns` of the rows of this one.
+        """
+        return self._derive(columns=list(columns))
+
+    def where(self, prop: str, op: str, value) -> "PropertyFrame":
+        """
+        :return: A frame of the rows of this one whose property `prop` compares to `value` with `op`, one of "==",
+            "!=", "<", "<=", ">" and ">=". A null property never satisfies a condition on it.
+        """
+        if op not in _COMPARISONS:
+            raise ValueError(f"unknown comparison {op!r}")
+        if self._rows is not None:
+            raise ValueError("filters must come before slicing rows")
+        return self._derive(conditions=(*self._conditions, (prop, op, value)))
+
+    def of_type(self, entity_type) -> "PropertyFrame":
+        """
+        :return: A frame of the rows of this one whose node or edge has type `entity_type`, or a subtype of it.
+        """
+        if self._rows is not None:
+            raise ValueError("filters must come before slicing rows")
+        if self._entity_type is not None and self._entity_type != entity_type:
+            raise ValueError("a frame is filtered by at most one entity type")
+        return self._derive(entity_type=entity_type)
+
+    def ids(self) -> numpy.ndarray:
+        """
+        :return: The node or edge ids of the rows of this frame.
+        """
+        selected = self._selected()
+        if isinstance(selected, range):
+            return numpy.arange(selected.start, selected.stop, selected.step, dtype=numpy.uint64)
+        return selected
+
+    def batches(
+        self, batch_size: Optional[int] = None, *, with_ids: bool = False, unload: bool = False
+    ) -> Iterator[pyarrow.RecordBatch]:
+        """
+        Iterate over the rows of this frame as `pyarrow.RecordBatch`.
+
+        :param batch_size: The most rows of a batch; by default that of the frame.
+        :param with_ids: If true, the first column of each batch, "id", is the node or edge id of each row.
+        :param unload: If true, unload the properties that this iteration loaded once it is done.
+        """
+        batch_size = batch_size or self._batch_size
+        selected = self._selected()
+        loaded = set(self._loaded_names())
+        try:
+            arrays = [self._property(name) for name in self._columns]
+            names = ["id", *self._columns] if with_ids else self._columns
+            for begin in range(0, len(selected), batch_size):
+                part = selected[begin : begin + batch_size]
+                if isinstance(part, range) and part.step == 1:
+                    # contiguous rows are slices of the properties
+                    columns = [_contiguous(a.slice(part.start, len(part))) for a in arrays]
+                else:
+                    indices = pyarrow.array(numpy.asarray(part, dtype=numpy.uint64))
+                    columns = [_contiguous(a.take(indices)) for a in arrays]
+                if with_ids:
+                    columns.insert(0, pyarrow.array(numpy.asarray(part, dtype=numpy.uint64)))
+                yield pyarrow.RecordBatch.from_arrays(columns, names=names)
+        finally:
+            if unload:
+                for name in self._columns:
+                    if name not in loaded:
+                        self._unload(name)
+
+    def to_arrow(self, *, with_ids: bool = False) -> pyarrow.Table:
+        """
+        :return: A `pyarrow.Table` of the rows of this frame.
+        """
+        fields = [pyarrow.field("id", pyarrow.uint64())] if with_ids else []
+        schema = pyarrow.schema(fields + self._fields)
+        return pyarrow.Table.from_batches(list(self.batches(with_ids=with_ids)), schema=schema)
+
+    def to_pandas(self) -> pandas.DataFrame:
+        return self.to_arrow().to_pandas()
+
+    def __len__(self) -> int:
+        return len(self._selected())
+
+    def _get_rows(self, item: slice) -> "PropertyFrame":
+        rows = self._rows if self._rows is not None else range(len(self._filtered()))
+        return self._derive(rows=rows[item])
+
+    def _get_columns(self, item: Sequence[str]) -> "PropertyFrame":
+        return self.select(item)
+
+    def _get_column(self, item: str):
+        return self.select([item]).to_arrow().column(0).to_pandas()
+
+    def _get_cell(self, row: int, col):
+        entity = self._selected()[row]
+        return self._property(col)[int(entity)].as_py()
+
+    @property
+    def dtypes(self) -> dict:
+        return {f.name: f.type.to_pandas_dtype() for f in self._fields}
+
+    @property
+    def columns(self):
+        return list(self._columns)
+
+    @property
+    def kind(self) -> str:
+        """
+        :return: "node" or "edge"
+        """
+        return self._kind
+
+
+def _contiguous(array: pyarrow.ChunkedArray) -> pyarrow.Array:
+    if array.num_chunks == 1:
+        return array.chunk(0)
+    if array.num_chunks == 0:
+        return pyarrow.array([], type=array.type)
+    return pyarrow.concat_arrays(array.chunks)
+
+
+def node_frame(self, columns: Optional[Sequence[str]] = None, *, batch_size: int = DEFAULT_BATCH_SIZE):
+    """
+    :param columns: The node properties to include, by default every property of the graph, loaded or not.
+    :param batch_size: The most rows of the batches of the frame.
+    :returns: a lazy :py:class:`~katana.local.property_frame.PropertyFrame` of the node properties, which reads
+        nothing until it is iterated or converted.
+    """
+    return PropertyFrame(self, "node", columns, batch_size=batch_size)
+
+
+def edge_frame(self, columns: Optional[Sequence[str]] = None, *, batch_size: int = DEFAULT_BATCH_SIZE):
+    """
+    :param columns: The edge properties to include, by default every property of the graph, loaded or not.
+    :param batch_size: The most rows of the batches of the frame.
+    :returns: a lazy :py:class:`~katana.local.property_frame.PropertyFrame` of the edge properties, with a row per
+        edge id of the default topology.
+    """
+    return PropertyFrame(self, "edge", columns, batch_size=batch_size)
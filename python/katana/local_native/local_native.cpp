@@ -6,4 +6,5 @@ PYBIND11_MODULE(local_native, m) {
   katana::python::InitEntityTypeManager(m);
   katana::python::InitImportData(m);
   katana::python::InitPropertyGraph(m);
+  katana::python::InitMetrics(m);
 }
@@ -51,12 +51,29 @@ def sssp_operator(g: Graph, dists: np.ndarray, edge_weights, item, ctx: UserCont
             ctx.push((dst, new_distance))
 
 
+@for_each_operator()
+def sssp_array_operator(
+    out_indices: np.ndarray, out_dests: np.ndarray, dists: np.ndarray, edge_weights: np.ndarray, item, ctx: UserContext
+):
+    if dists[item.src] < item.dist:
+        return
+    # numpy arrays, unlike the graph, are indexed without calls into native code
+    begin = out_indices[item.src - 1] if item.src > 0 else np.uint64(0)
+    for ii in range(begin, out_indices[item.src]):
+        dst = out_dests[ii]
+        edge_length = edge_weights[ii]
+        new_distance = edge_length + dists[item.src]
+        old_distance = atomic_min(dists, dst, new_distance)
+        if new_distance < old_distance:
+            ctx.push((dst, new_distance))
+
+
 @obim_metric()
 def obim_indexer(shift, item):
     return item.dist >> shift
 
 
-def sssp(graph: Graph, source, length_property, shift, property_name):
+def sssp(graph: Graph, source, length_property, shift, property_name, use_arrays=False):
     dists = create_distance_array(graph, source, length_property)
 
     # Define the struct type here so it can depend on the type of the weight property
@@ -67,9 +84,14 @@ def sssp(graph: Graph, source, length_property, shift, property_name):
 
     t = StatTimer("Total SSSP")
     t.start()
+    if use_arrays:
+        out_indices, out_dests = graph.topology_arrays()
+        operator = sssp_array_operator(out_indices, out_dests, dists, graph.edge_property_array(length_property))
+    else:
+        operator = sssp_operator(graph, dists, graph.get_edge_property(length_property))
     for_each(
         init_bag,
-        sssp_operator(graph, dists, graph.get_edge_property(length_property)),
+        operator,
         worklist=OrderedByIntegerMetric(obim_indexer(shift)),
         disable_conflict_detection=True,
         loop_name="SSSP",
@@ -134,6 +156,7 @@ def main():
     parser.add_argument("--shift", type=int, default=6)
     parser.add_argument("--reportNode", type=int, default=1)
     parser.add_argument("--noverify", action="store_true", default=False)
+    parser.add_argument("--useArrays", action="store_true", default=False)
     parser.add_argument("--threads", "-t", type=int, default=1)
     parser.add_argument("input", type=str)
     args = parser.parse_args()
@@ -142,7 +165,7 @@ def main():
 
     graph = Graph(args.input)
 
-    sssp(graph, args.startNode, args.edgeWeightProperty, args.shift, args.propertyName)
+    sssp(graph, args.startNode, args.edgeWeightProperty, args.shift, args.propertyName, args.useArrays)
 
     print("Node {}: {}".format(args.reportNode, graph.get_node_property(args.propertyName)[args.reportNode]))
 
@@ -9,11 +9,14 @@ from katana import GaloisError, set_busy_wait
 from katana.example_data import get_rdg_dataset
 from katana.local import Graph
 from katana.local.analytics import (
+    AnalyticsSession,
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
     BfsStatistics,
     CdlpStatistics,
     ConnectedComponentsStatistics,
+    GraphColoringPlan,
+    GraphColoringStatistics,
     IndependentSetPlan,
     IndependentSetStatistics,
     JaccardPlan,
@@ -21,7 +24,9 @@ from katana.local.analytics import (
     KCoreStatistics,
     KTrussStatistics,
     LeidenClusteringStatistics,
+    LocalClusteringCoefficientPlan,
     LouvainClusteringStatistics,
+    PagerankPlan,
     PagerankStatistics,
     SsspStatistics,
     TriangleCountPlan,
@@ -32,6 +37,8 @@ from katana.local.analytics import (
     connected_components,
     connected_components_assert_valid,
     find_edge_sorted_by_dest,
+    graph_coloring,
+    graph_coloring_assert_valid,
     independent_set,
     independent_set_assert_valid,
     jaccard,
@@ -213,6 +220,32 @@ def test_pagerank(graph: Graph):
     assert stats.average_rank == approx(0.5215466022491455, abs=0.001)
 
 
+def test_analytics_session(graph: Graph):
+    num_node_properties = len(graph.loaded_node_schema())
+    alphas = (0.8, 0.85)
+
+    session = AnalyticsSession(graph)
+    for alpha in alphas:
+        session.add_pagerank(f"rank_{alpha}", PagerankPlan.pull_topological(alpha=alpha))
+    session.add_bfs_levels(0, "level_0").add_bfs_levels(1, "level_1")
+    assert len(session) == 4
+
+    ranks = session.run_to_table()
+    assert len(session) == 0
+    assert ranks.column_names == ["rank_0.8", "rank_0.85", "level_0", "level_1"]
+    assert ranks.num_rows == graph.num_nodes()
+    assert len(graph.loaded_node_schema()) == num_node_properties
+
+    session.add_pagerank("NewProp", PagerankPlan.pull_topological(alpha=0.85))
+    session.run()
+    pagerank_assert_valid(graph, "NewProp")
+    assert graph.get_node_property("NewProp").to_numpy() == approx(ranks.column("rank_0.85").to_numpy())
+
+    session.release_views()
+    with raises(TypeError):
+        session.add_sssp(0, "value", "dist", plan=PagerankPlan.pull_topological())
+
+
 def test_betweenness_centrality_outer(graph: Graph):
     property_name = "NewProp"
 
@@ -247,6 +280,33 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_asynchronous(graph: Graph):
+    betweenness_centrality(graph, "level", 16, BetweennessCentralityPlan.level())
+    betweenness_centrality(graph, "async", 16, BetweennessCentralityPlan.asynchronous())
+    betweenness_centrality(graph, "auto", 16, BetweennessCentralityPlan.automatic())
+
+    level = graph.get_node_property("level").to_numpy()
+    assert graph.get_node_property("async").to_numpy() == approx(level)
+    assert graph.get_node_property("auto").to_numpy() == approx(level)
+
+    stats = BetweennessCentralityStatistics(graph, "async")
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(7.0)
+    assert stats.average_centrality == approx(0.000534295046236366)
+
+
+def test_betweenness_centrality_asynchronous_sources(graph: Graph):
+    sources = [0, 3, 16, 100, 1000]
+
+    betweenness_centrality(graph, "level", sources, BetweennessCentralityPlan.level())
+    betweenness_centrality(graph, "async", sources, BetweennessCentralityPlan.asynchronous())
+    betweenness_centrality(graph, "auto", sources, BetweennessCentralityPlan.automatic())
+
+    level = graph.get_node_property("level").to_numpy()
+    assert graph.get_node_property("async").to_numpy() == approx(level)
+    assert graph.get_node_property("auto").to_numpy() == approx(level)
+
+
 def test_triangle_count():
     graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dst(e) for e in graph.out_edge_ids(0)]
@@ -290,6 +350,22 @@ def test_independent_set():
     independent_set_assert_valid(graph, "output2")
 
 
+def test_graph_coloring():
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+
+    graph_coloring(graph, "output")
+    stats = GraphColoringStatistics(graph, "output")
+    graph_coloring_assert_valid(graph, "output")
+
+    graph_coloring(graph, "output2", GraphColoringPlan.jones_plassmann())
+    stats2 = GraphColoringStatistics(graph, "output2")
+    graph_coloring_assert_valid(graph, "output2")
+
+    max_degree = max(len(graph.edge_ids(n)) for n in graph)
+    assert 0 < stats.num_colors <= max_degree + 1
+    assert 0 < stats2.num_colors <= max_degree + 1
+
+
 def test_cdlp():
     graph = Graph(get_rdg_dataset("rmat10"))
     cdlp(graph, "output", 10, False)
@@ -447,6 +523,23 @@ def test_local_clustering_coefficient():
     assert not np.any(np.isnan(out))
 
 
+def test_local_clustering_coefficient_degree_ordered():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+
+    local_clustering_coefficient(graph, "exact")
+    local_clustering_coefficient(graph, "degree_ordered", LocalClusteringCoefficientPlan.degree_ordered())
+    local_clustering_coefficient(
+        graph, "sampled", LocalClusteringCoefficientPlan.degree_ordered(sample_min_degree=64, max_error=0.05)
+    )
+    exact = graph.get_node_property("exact").to_numpy()
+    degree_ordered = graph.get_node_property("degree_ordered").to_numpy()
+    sampled = graph.get_node_property("sampled").to_numpy()
+
+    assert np.allclose(exact, degree_ordered)
+    # Each estimate is within the bound with 95% confidence
+    assert np.mean(np.abs(exact - sampled) <= 0.05) >= 0.9
+
+
 def test_subgraph_extraction():
     graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
     sort_all_edges_by_dest(graph)
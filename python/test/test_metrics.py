@@ -0,0 +1,10 @@
+from katana.local import export_metrics
+
+
+def test_export_metrics(graph):
+    assert graph.num_nodes() > 0
+    text = export_metrics()
+    lines = text.splitlines()
+    assert "# TYPE katana_storage_bytes_total counter" in lines
+    assert any(line.startswith('katana_storage_bytes_total{op="get"} ') for line in lines)
+    assert any(line.startswith("katana_memory_active_bytes{") for line in lines)
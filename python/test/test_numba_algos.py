@@ -34,6 +34,22 @@ def test_sssp(graph):
     assert stats.max_distance == 0.0
 
 
+def test_sssp_arrays(graph):
+    property_name = "NewProp"
+    weight_name = "workFrom"
+    start_node = 0
+
+    sssp(graph, start_node, weight_name, 6, property_name, use_arrays=True)
+
+    verify_sssp(graph, start_node, property_name)
+
+    sssp_assert_valid(graph, start_node, weight_name, property_name)
+
+    stats = SsspStatistics(graph, property_name)
+
+    assert stats.max_distance == 0.0
+
+
 def test_jaccard(graph):
     start_node = 0
     property_name = "NewProp"
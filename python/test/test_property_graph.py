@@ -238,6 +238,49 @@ def test_from_csr_k3():
     assert pg.get_edge_dst(5) == 1
 
 
+def test_topology_arrays():
+    pg = from_csr(np.array([2, 3, 3]), np.array([2, 1, 0]))
+    out_indices, out_dests = pg.topology_arrays()
+    assert list(out_indices) == [2, 3, 3]
+    assert list(out_dests) == [2, 1, 0]
+    assert not out_dests.flags.writeable
+
+    out_indices, out_dests = pg.topology_arrays("transposed")
+    assert list(out_indices) == [1, 2, 3]
+    assert list(out_dests) == [1, 0, 0]
+
+    out_indices, out_dests = pg.topology_arrays("edges_sorted_by_dest_id")
+    assert list(out_dests) == [1, 2, 0]
+
+    with pytest.raises(ValueError):
+        pg.topology_arrays("no_such_view")
+
+
+def test_topology_arrays_outlive_graph(graph):
+    num_edges = graph.num_edges()
+    first_dst = graph.get_edge_dst(0)
+    _, out_dests = graph.topology_arrays()
+    graph.unload_topologies()
+    del graph
+    assert len(out_dests) == num_edges
+    assert out_dests[0] == first_dst
+
+
+def test_property_arrays(graph):
+    graph.add_node_property(node_values=np.arange(graph.num_nodes(), dtype=np.int64))
+    values = graph.node_property_array("node_values")
+    assert values.dtype == np.int64
+    assert np.array_equal(values, np.arange(graph.num_nodes()))
+    assert not values.flags.writeable
+
+    graph.add_edge_property(edge_values=np.ones(graph.num_edges(), dtype=np.float32))
+    assert graph.edge_property_array("edge_values").sum() == graph.num_edges()
+
+    graph.add_node_property(with_nulls=pyarrow.array([None] * graph.num_nodes(), type=pyarrow.int64()))
+    with pytest.raises(ValueError):
+        graph.node_property_array("with_nulls")
+
+
 def test_load_invalid_path():
     with pytest.raises(ValueError):
         Graph("non-existent")
@@ -351,3 +394,40 @@ def test_types(graph):
         "IS_PART_OF": 9,
     }
     assert graph.edge_types.is_subtype_of(0, 1) is True
+
+
+def test_node_frame_batches(graph):
+    frame = graph.node_frame(["length"], batch_size=1000)
+    assert len(frame) == graph.num_nodes()
+    batches = list(frame.batches(with_ids=True))
+    assert all(b.num_rows <= 1000 for b in batches)
+    assert sum(b.num_rows for b in batches) == graph.num_nodes()
+    assert batches[0].schema.names == ["id", "length"]
+    assert batches[1].column(0)[5].as_py() == 1005
+    assert frame.to_arrow().column("length").equals(graph.get_node_property("length"))
+
+
+def test_node_frame_where(graph):
+    expected = graph.get_node_property("length").to_pandas()
+    frame = graph.node_frame(["length"]).where("length", ">", 100)
+    ids = frame.ids()
+    assert list(ids) == list(expected.index[expected > 100])
+    assert frame.to_pandas()["length"].equals(expected[expected > 100].reset_index(drop=True))
+
+
+def test_node_frame_of_type(graph):
+    person = graph.node_types.atomic_types["Person"]
+    frame = graph.node_frame([]).of_type(person)
+    ids = frame.ids()
+    assert len(ids) > 0
+    assert all(graph.does_node_have_type(int(n), person) for n in ids)
+    with pytest.raises(ValueError):
+        frame[0:10].where("length", ">", 0)
+
+
+def test_edge_frame_slice(graph):
+    frame = graph.edge_frame(["classYear"])[100:2000:3]
+    assert len(frame) == len(range(100, 2000, 3))
+    assert list(frame.ids())[:2] == [100, 103]
+    expected = graph.get_edge_property("classYear").to_pandas()[100:2000:3]
+    assert frame.to_pandas()["classYear"].equals(expected.reset_index(drop=True))
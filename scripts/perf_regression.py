@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+#
+# Performance regression harness for the lonestar CLIs.
+#
+# "run" runs each benchmark of a suite (perf_regression_suite.json by default)
+# several times with a fixed number of threads, which the thread pool binds to
+# cores, and collects the stats the CLIs print with -statFile. "compare"
+# compares the medians of a run against those of a stored baseline, which is
+# just the output of an earlier run, and reports the metrics that got slower
+# by more than a noise threshold.
+#
+#   perf_regression.py run --bin-dir build --threads 16 --out baseline.json
+#   perf_regression.py run --bin-dir build --threads 16 --out current.json
+#   perf_regression.py compare baseline.json current.json --threshold 0.05
+
+import argparse
+import datetime
+import json
+import os
+import re
+import shutil
+import socket
+import statistics
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+DEFAULT_SUITE = SCRIPT_DIR / "perf_regression_suite.json"
+DEFAULT_DATASETS = SCRIPT_DIR.parent / "external" / "test-datasets"
+# Keep in sync with KATANA_RDG_STORAGE_FORMAT_VERSION in TestDatasets.cmake
+DEFAULT_STORAGE_FORMAT_VERSION = 5
+DEFAULT_METRICS = ["(NULL)/TimerTotal"]
+
+
+def parse_stats(text):
+    """Returns the totals of a stats file by REGION/CATEGORY.
+
+    Stats files are what katana::PrintStats writes: a header line, then lines
+    of STAT_TYPE, REGION, CATEGORY, TOTAL_TYPE, TOTAL, each possibly followed
+    by a line of its per-thread values, which are skipped.
+    """
+    stats = {}
+    for line in text.splitlines():
+        tokens = [t.strip() for t in line.split(", ")]
+        if len(tokens) < 5 or tokens[0] == "STAT_TYPE" or tokens[3] == "ThreadValues":
+            continue
+        try:
+            value = float(tokens[4])
+        except ValueError:
+            continue
+        stats[tokens[1] + "/" + tokens[2]] = value
+    return stats
+
+
+def find_executable(bin_dir, app):
+    for root, _, files in os.walk(bin_dir):
+        if app in files:
+            path = Path(root) / app
+            if os.access(path, os.X_OK):
+                return path
+    return None
+
+
+def resolve_input(benchmark, datasets, storage_format_version):
+    if "input_path" in benchmark:
+        return Path(benchmark["input_path"])
+    return datasets / "rdg_datasets" / benchmark["input"] / f"storage_format_version_{storage_format_version}"
+
+
+def run_once(command, env):
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        stat_file = Path(tmp_dir) / "stats.csv"
+        completed = subprocess.run(
+            command + [f"-statFile={stat_file}"],
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            env=env,
+            check=False,
+            encoding="UTF-8",
+        )
+        if completed.returncode != 0:
+            return None, completed.stdout
+        return parse_stats(stat_file.read_text() if stat_file.exists() else ""), completed.stdout
+
+
+def run_suite(args):
+    suite = json.loads(Path(args.suite).read_text())
+    env = dict(os.environ)
+    # the thread pool binds its threads to cores unless told not to
+    env.pop("KATANA_DO_NOT_BIND_THREADS", None)
+    prefix = []
+    if args.cpus:
+        if not shutil.which("taskset"):
+            sys.exit("--cpus needs taskset")
+        prefix = ["taskset", "-c", args.cpus]
+
+    results = {
+        "host": socket.gethostname(),
+        "date": datetime.datetime.now().isoformat(timespec="seconds"),
+        "threads": args.threads,
+        "repeat": args.repeat,
+        "benchmarks": {},
+    }
+    failed = False
+    for benchmark in suite["benchmarks"]:
+        name = benchmark["name"]
+        if args.filter and not re.search(args.filter, name):
+            continue
+        app = find_executable(Path(args.bin_dir), benchmark["app"])
+        if app is None:
+            print(f"SKIP {name}: no {benchmark['app']} under {args.bin_dir}", file=sys.stderr)
+            continue
+        graph = resolve_input(benchmark, Path(args.datasets), args.storage_format_version)
+        command = prefix + [str(app), str(graph)] + benchmark.get("args", []) + ["-noverify", f"-t={args.threads}"]
+
+        metrics = benchmark.get("metrics", DEFAULT_METRICS)
+        runs = {metric: [] for metric in metrics}
+        for i in range(args.repeat):
+            if args.verbose:
+                print(f"Running: {' '.join(command)}", file=sys.stderr)
+            stats, output = run_once(command, env)
+            if stats is None:
+                print(f"FAIL {name} (run {i}):\n{output}", file=sys.stderr)
+                failed = True
+                break
+            for metric in metrics:
+                if metric in stats:
+                    runs[metric].append(stats[metric])
+        results["benchmarks"][name] = {"command": command, "metrics": runs}
+        print(f"DONE {name}", file=sys.stderr)
+
+    Path(args.out).write_text(json.dumps(results, indent=2) + "\n")
+    return 1 if failed else 0
+
+
+def spread(values):
+    """The range of values relative to their median, a measure of noise"""
+    median = statistics.median(values)
+    return (max(values) - min(values)) / median if median else 0.0
+
+
+def compare(args):
+    baseline = json.loads(Path(args.baseline).read_text())
+    current = json.loads(Path(args.current).read_text())
+
+    lines = [
+        f"# Performance comparison (threshold {args.threshold:.1%})",
+        "",
+        f"Baseline: {baseline['host']}, {baseline['date']}, {baseline['threads']} threads",
+        f"Current: {current['host']}, {current['date']}, {current['threads']} threads",
+        "",
+        "| Benchmark | Metric | Baseline | Current | Change | Status |",
+        "|---|---|---|---|---|---|",
+    ]
+    if baseline["threads"] != current["threads"]:
+        lines.insert(4, "**Warning: the runs used different numbers of threads.**")
+
+    regressions = 0
+    for name, bench in sorted(current["benchmarks"].items()):
+        base_bench = baseline["benchmarks"].get(name)
+        for metric, values in sorted(bench["metrics"].items()):
+            base_values = base_bench["metrics"].get(metric, []) if base_bench else []
+            if not values or not base_values:
+                lines.append(f"| {name} | {metric} | | | | missing |")
+                continue
+            base = statistics.median(base_values)
+            cur = statistics.median(values)
+            change = (cur - base) / base if base else 0.0
+            if change > args.threshold:
+                status = "REGRESSION"
+                regressions += 1
+            elif change < -args.threshold:
+                status = "improvement"
+            else:
+                status = "ok"
+            # a change within the noise of either run is no evidence either way
+            noise = max(spread(base_values), spread(values))
+            if status != "ok" and noise > abs(change):
+                status += " (noisy)"
+            lines.append(f"| {name} | {metric} | {base:g} | {cur:g} | {change:+.1%} | {status} |")
+
+    lines += ["", f"{regressions} regression(s)"]
+    report = "\n".join(lines) + "\n"
+    if args.report:
+        Path(args.report).write_text(report)
+    print(report, end="")
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Performance regression harness for the lonestar CLIs.")
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = subparsers.add_parser("run", help="Run the benchmarks of a suite and collect their stats.")
+    run_parser.add_argument("--bin-dir", required=True, help="Build directory containing the CLIs.")
+    run_parser.add_argument("--threads", type=int, required=True, help="Threads of every run.")
+    run_parser.add_argument("--out", required=True, help="File to write the results to, as JSON.")
+    run_parser.add_argument("--suite", default=str(DEFAULT_SUITE), help="Benchmark suite (default: %(default)s).")
+    run_parser.add_argument(
+        "--datasets", default=str(DEFAULT_DATASETS), help="Test datasets directory (default: %(default)s)."
+    )
+    run_parser.add_argument("--storage-format-version", type=int, default=DEFAULT_STORAGE_FORMAT_VERSION)
+    run_parser.add_argument("--repeat", type=int, default=5, help="Runs of each benchmark (default: %(default)s).")
+    run_parser.add_argument("--cpus", help="Restrict the runs to a CPU list with taskset, e.g., 0-15.")
+    run_parser.add_argument("--filter", help="Only run benchmarks whose name matches this regex.")
+    run_parser.add_argument("--verbose", "-v", action="store_true")
+
+    compare_parser = subparsers.add_parser("compare", help="Compare a run against a baseline.")
+    compare_parser.add_argument("baseline", help="Results of the baseline run.")
+    compare_parser.add_argument("current", help="Results of the run to check.")
+    compare_parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.05,
+        help="Relative slowdown of a median that counts as a regression (default: %(default)s).",
+    )
+    compare_parser.add_argument("--report", help="Also write the report, in Markdown, to this file.")
+
+    args = parser.parse_args()
+    if args.command == "run":
+        return run_suite(args)
+    return compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,190 @@
+import argparse
+import importlib.util
+import json
+import os
+import stat
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).parent.parent.resolve()
+
+spec = importlib.util.spec_from_file_location("perf_regression", REPO_ROOT / "scripts" / "perf_regression.py")
+perf_regression = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(perf_regression)
+
+# A stand-in for a lonestar CLI: records how it was run and writes a stats
+# file with a TimerTotal of its --time argument; --fail makes it exit 1.
+FAKE_APP = """#!/usr/bin/env python3
+import os, sys
+args = sys.argv[1:]
+with open(os.environ["FAKE_APP_LOG"], "a") as log:
+    log.write(" ".join(args) + "|" + os.environ.get("KATANA_DO_NOT_BIND_THREADS", "unset") + "\\n")
+if "--fail" in args:
+    sys.exit(1)
+time = next(a.split("=")[1] for a in args if a.startswith("--time="))
+stat_file = next(a.split("=", 1)[1] for a in args if a.startswith("-statFile="))
+with open(stat_file, "w") as out:
+    out.write("STAT_TYPE, REGION, CATEGORY, TOTAL_TYPE, TOTAL\\n")
+    out.write(f"STAT, (NULL), TimerTotal, TMAX, {time}\\n")
+    out.write("STAT, (NULL), TimerTotal, ThreadValues, 1; 2\\n")
+    out.write("STAT, Loop, Time, TMAX, 7\\n")
+"""
+
+
+def write_fake_app(bin_dir, name):
+    app = bin_dir / "nested" / name
+    app.parent.mkdir(parents=True, exist_ok=True)
+    app.write_text(FAKE_APP)
+    app.chmod(app.stat().st_mode | stat.S_IXUSR)
+
+
+def results(threads, benchmarks):
+    return {"host": "h", "date": "d", "threads": threads, "repeat": 3, "benchmarks": benchmarks}
+
+
+def compare(tmp_path, baseline, current, threshold=0.05):
+    (tmp_path / "baseline.json").write_text(json.dumps(baseline))
+    (tmp_path / "current.json").write_text(json.dumps(current))
+    report = tmp_path / "report.md"
+    args = argparse.Namespace(
+        baseline=str(tmp_path / "baseline.json"),
+        current=str(tmp_path / "current.json"),
+        threshold=threshold,
+        report=str(report),
+    )
+    status = perf_regression.compare(args)
+    rows = {}
+    for line in report.read_text().splitlines():
+        cells = [c.strip() for c in line.strip("|").split("|")]
+        if len(cells) == 6 and cells[0] not in ("Benchmark", "---"):
+            rows[(cells[0], cells[1])] = cells[5]
+    return status, rows, report.read_text()
+
+
+def test_parse_stats():
+    text = (
+        "STAT_TYPE, REGION, CATEGORY, TOTAL_TYPE, TOTAL\n"
+        "STAT, (NULL), TimerTotal, TMAX, 1500\n"
+        "STAT, (NULL), TimerTotal, ThreadValues, 1500; 1400\n"
+        "STAT, BFS, Iterations, TSUM, 12\n"
+        "PARAM, (NULL), Threads, SINGLE, many\n"
+        "\n"
+    )
+    assert perf_regression.parse_stats(text) == {"(NULL)/TimerTotal": 1500.0, "BFS/Iterations": 12.0}
+
+
+def test_run_suite(tmp_path):
+    bin_dir = tmp_path / "bin"
+    write_fake_app(bin_dir, "fast-cli")
+    write_fake_app(bin_dir, "broken-cli")
+    suite = {
+        "benchmarks": [
+            {"name": "fast", "app": "fast-cli", "input_path": "/graphs/g", "args": ["--time=40"]},
+            {
+                "name": "fast-loop",
+                "app": "fast-cli",
+                "input": "rmat15",
+                "args": ["--time=50"],
+                "metrics": ["Loop/Time", "Loop/Missing"],
+            },
+            {"name": "absent", "app": "no-such-cli", "input_path": "/graphs/g"},
+            {"name": "broken", "app": "broken-cli", "input_path": "/graphs/g", "args": ["--fail"]},
+        ]
+    }
+    (tmp_path / "suite.json").write_text(json.dumps(suite))
+    log = tmp_path / "log"
+    os.environ["FAKE_APP_LOG"] = str(log)
+    os.environ["KATANA_DO_NOT_BIND_THREADS"] = "1"
+    args = argparse.Namespace(
+        suite=str(tmp_path / "suite.json"),
+        bin_dir=str(bin_dir),
+        datasets=str(tmp_path / "datasets"),
+        storage_format_version=5,
+        threads=3,
+        repeat=2,
+        cpus=None,
+        filter=None,
+        verbose=False,
+        out=str(tmp_path / "out.json"),
+    )
+    try:
+        # the broken benchmark fails the run, but the others are kept
+        assert perf_regression.run_suite(args) == 1
+    finally:
+        del os.environ["KATANA_DO_NOT_BIND_THREADS"]
+
+    out = json.loads((tmp_path / "out.json").read_text())
+    assert out["threads"] == 3
+    benchmarks = out["benchmarks"]
+    assert set(benchmarks) == {"fast", "fast-loop", "broken"}
+    assert benchmarks["fast"]["metrics"] == {"(NULL)/TimerTotal": [40.0, 40.0]}
+    assert benchmarks["fast-loop"]["metrics"] == {"Loop/Time": [7.0, 7.0], "Loop/Missing": []}
+    assert benchmarks["broken"]["metrics"] == {"(NULL)/TimerTotal": []}
+    assert benchmarks["fast-loop"]["command"][1] == str(
+        tmp_path / "datasets" / "rdg_datasets" / "rmat15" / "storage_format_version_5"
+    )
+
+    # two runs of each, and one of the broken benchmark, which stops there;
+    # every run has a fixed thread count and bound threads
+    runs = log.read_text().splitlines()
+    assert len(runs) == 5
+    for run in runs:
+        command, bind = run.split("|")
+        assert "-noverify" in command.split()
+        assert "-t=3" in command.split()
+        assert bind == "unset"
+
+    # only benchmarks matching the filter run
+    args.filter = "^fast$"
+    log.unlink()
+    assert perf_regression.run_suite(args) == 0
+    assert set(json.loads((tmp_path / "out.json").read_text())["benchmarks"]) == {"fast"}
+    assert len(log.read_text().splitlines()) == 2
+
+
+def test_compare(tmp_path):
+    metric = "(NULL)/TimerTotal"
+    baseline = results(
+        4,
+        {
+            "slower": {"metrics": {metric: [100, 101, 99]}},
+            "faster": {"metrics": {metric: [100, 101, 99]}},
+            "same": {"metrics": {metric: [100, 101, 99]}},
+            "noisy": {"metrics": {metric: [50, 100, 150]}},
+            "new-metric": {"metrics": {}},
+        },
+    )
+    current = results(
+        4,
+        {
+            "slower": {"metrics": {metric: [120, 121, 119]}},
+            "faster": {"metrics": {metric: [80, 81, 79]}},
+            "same": {"metrics": {metric: [102, 103, 101]}},
+            "noisy": {"metrics": {metric: [120, 121, 119]}},
+            "new-metric": {"metrics": {metric: [10]}},
+            "new-benchmark": {"metrics": {metric: [10]}},
+        },
+    )
+    status, rows, report = compare(tmp_path, baseline, current)
+    assert status == 1
+    assert rows[("slower", metric)] == "REGRESSION"
+    assert rows[("faster", metric)] == "improvement"
+    assert rows[("same", metric)] == "ok"
+    # a 20% change within a spread of 100% is flagged as noise
+    assert rows[("noisy", metric)] == "REGRESSION (noisy)"
+    assert rows[("new-metric", metric)] == "missing"
+    assert rows[("new-benchmark", metric)] == "missing"
+    assert "2 regression(s)" in report
+    assert "different numbers of threads" not in report
+
+    # a higher threshold lets the slowdowns through
+    status, rows, _ = compare(tmp_path, baseline, current, threshold=0.25)
+    assert status == 0
+    assert rows[("slower", metric)] == "ok"
+
+
+def test_compare_warns_of_thread_mismatch(tmp_path):
+    metric = "(NULL)/TimerTotal"
+    benchmarks = {"same": {"metrics": {metric: [100]}}}
+    status, _, report = compare(tmp_path, results(4, benchmarks), results(8, benchmarks))
+    assert status == 0
+    assert "different numbers of threads" in report
@@ -0,0 +1,107 @@
+#ifndef KATANA_TOOLS_GRAPHCONVERT_IMPORTPIPELINE_H_
+#define KATANA_TOOLS_GRAPHCONVERT_IMPORTPIPELINE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace katana {
+
+/// An ImportPipeline overlaps fetching the records of a database with
+/// building a graph of them. Fetcher threads each take the next source, e.g.,
+/// a range of a table, and fetch it in batches while the calling thread
+/// consumes the batches of the sources in order, so the builder sees the
+/// records in the same order as it would from a single cursor.
+///
+/// At most num_fetchers sources are fetched at once and each holds at most
+/// max_batches batches that have not been consumed, so memory is bounded
+/// whatever the size of the database.
+///
+/// \tparam Batch a movable batch of records, owning their data
+template <typename Batch>
+class ImportPipeline {
+public:
+  ImportPipeline(size_t num_sources, size_t num_fetchers, size_t max_batches)
+      : sources_(num_sources),
+        num_fetchers_(std::max<size_t>(std::min(num_fetchers, num_sources), 1)),
+        max_batches_(std::max<size_t>(max_batches, 1)) {}
+
+  /// Fetch every source and consume its batches.
+  ///
+  /// \param fetch called as fetch(source, fetcher, emit) on a fetcher thread,
+  ///     where fetcher identifies the thread, e.g., to pick a connection of
+  ///     its own, and emit(Batch&&) hands a batch to the consumer, waiting
+  ///     while the source holds max_batches of them
+  /// \param consume called as consume(source, Batch&&) on the calling
+  ///     thread for each batch, by source and then in the order emitted
+  template <typename Fetch, typename Consume>
+  void Run(const Fetch& fetch, const Consume& consume) {
+    std::vector<std::thread> fetchers;
+    fetchers.reserve(num_fetchers_);
+    for (size_t f = 0; f < num_fetchers_; ++f) {
+      fetchers.emplace_back([this, &fetch, f] {
+        // sources are taken in order, so the one being consumed is always
+        // taken and consuming it frees the fetchers of the later ones
+        for (size_t s; (s = next_source_++) < sources_.size();) {
+          Source& source = sources_[s];
+          fetch(s, f, [&](Batch&& batch) {
+            std::unique_lock<std::mutex> lock(source.mutex);
+            source.not_full.wait(lock, [&] {
+              return source.batches.size() < max_batches_;
+            });
+            source.batches.emplace_back(std::move(batch));
+            source.not_empty.notify_one();
+          });
+          std::lock_guard<std::mutex> lock(source.mutex);
+          source.done = true;
+          source.not_empty.notify_one();
+        }
+      });
+    }
+
+    for (size_t s = 0; s < sources_.size(); ++s) {
+      Source& source = sources_[s];
+      while (true) {
+        std::unique_lock<std::mutex> lock(source.mutex);
+        source.not_empty.wait(
+            lock, [&] { return !source.batches.empty() || source.done; });
+        if (source.batches.empty()) {
+          break;
+        }
+        Batch batch = std::move(source.batches.front());
+        source.batches.pop_front();
+        source.not_full.notify_one();
+        lock.unlock();
+        consume(s, std::move(batch));
+      }
+    }
+
+    for (auto& fetcher : fetchers) {
+      fetcher.join();
+    }
+  }
+
+private:
+  struct Source {
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    std::deque<Batch> batches;
+    bool done{false};
+  };
+
+  std::vector<Source> sources_;
+  std::atomic<size_t> next_source_{0};
+  size_t num_fetchers_;
+  size_t max_batches_;
+};
+
+}  // namespace katana
+
+#endif
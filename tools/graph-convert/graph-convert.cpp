@@ -18,14 +18,22 @@
  */
 
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <numeric>
+#include <optional>
 #include <random>
 #include <string>
 #include <vector>
@@ -36,6 +44,7 @@
 #include "katana/CSRTopology.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileGraph.h"
+#include "katana/FileView.h"
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
 #include "katana/RDGManifest.h"
@@ -86,6 +95,8 @@ enum ConvertMode {
   gr2totem,
   gr2neo4j,
   gr2kg,
+  edgelist2kg,
+  csv2kg,
   mtx2gr,
   nodelist2gr,
   pbbs2gr,
@@ -203,6 +214,14 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2neo4j, "Convert binary gr to a vertex/edge csv for neo4j"),
         clEnumVal(
             gr2kg, "Convert binary gr to a property graph for katana graph"),
+        clEnumVal(
+            edgelist2kg,
+            "Convert edge list to a property graph for katana graph, in "
+            "parallel and out of core"),
+        clEnumVal(
+            csv2kg,
+            "Convert csv to a property graph for katana graph, in parallel "
+            "and out of core"),
         clEnumVal(mtx2gr, "Convert matrix market format to binary gr"),
         clEnumVal(nodelist2gr, "Convert node list to binary gr"),
         clEnumVal(pbbs2gr, "Convert pbbs graph to binary gr"),
@@ -228,6 +247,13 @@ static cll::opt<int> minValue(
     cll::init(1));
 static cll::opt<size_t> maxDegree(
     "maxDegree", cll::desc("maximum degree to keep"), cll::init(2 * 1024));
+static cll::opt<std::string> spillDir(
+    "spillDir",
+    cll::desc("directory for the edges spilled by edgelist2kg and csv2kg "
+              "(default: the temporary directory)"),
+    cll::init(""));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -2868,6 +2894,46 @@ AppendEdgeData<void>(
   return katana::ResultSuccess();
 }
 
+/**
+ * Store an RDG whose topology is top_file_name, a CSR topology file in its
+ * directory, with every node of type vertex and every edge of type edge.
+ */
+katana::Result<void>
+StoreCSRTopology(
+    katana::RDGHandle handle, const katana::Uri& top_file_name,
+    uint64_t num_nodes, uint64_t num_edges) {
+  katana::RDG rdg;
+  rdg.set_rdg_dir(katana::GetRDGDir(handle));
+  if (auto res =
+          rdg.AddCSRTopologyByFile(top_file_name, num_nodes, num_edges);
+      !res) {
+    return res.error();
+  }
+  auto node_types = std::make_unique<katana::FileFrame>();
+  size_t node_type_buffer_size = num_nodes * sizeof(katana::EntityTypeID);
+  KATANA_CHECKED(node_types->Init(node_type_buffer_size));
+  KATANA_CHECKED(node_types->SetCursor(node_type_buffer_size));
+
+  katana::EntityTypeManager node_type_manager;
+  std::fill_n(
+      KATANA_CHECKED(node_types->ptr<katana::EntityTypeID>()), num_nodes,
+      KATANA_CHECKED(node_type_manager.AddAtomicEntityType("vertex")));
+
+  auto edge_types = std::make_unique<katana::FileFrame>();
+  size_t edge_type_buffer_size = num_edges * sizeof(katana::EntityTypeID);
+  KATANA_CHECKED(edge_types->Init(edge_type_buffer_size));
+  KATANA_CHECKED(edge_types->SetCursor(edge_type_buffer_size));
+
+  katana::EntityTypeManager edge_type_manager;
+  std::fill_n(
+      KATANA_CHECKED(edge_types->ptr<katana::EntityTypeID>()), num_edges,
+      KATANA_CHECKED(edge_type_manager.AddAtomicEntityType("edge")));
+
+  return rdg.Store(
+      handle, kCommandLine, std::move(node_types), std::move(edge_types),
+      node_type_manager, edge_type_manager);
+}
+
 /**
  * Gr2Kg reads in the binary csr (.gr) files and produces
  * katana graph property graphs.
@@ -2920,40 +2986,8 @@ struct Gr2Kg : public Conversion {
       return res.error();
     }
 
-    katana::RDG rdg;
-    rdg.set_rdg_dir(katana::GetRDGDir(handle));
-    if (auto res = rdg.AddCSRTopologyByFile(
-            top_file_name, header.num_nodes, header.num_edges);
-        !res) {
-      return res.error();
-    }
-    auto node_types = std::make_unique<katana::FileFrame>();
-    size_t node_type_buffer_size =
-        header.num_nodes * sizeof(katana::EntityTypeID);
-    KATANA_CHECKED(node_types->Init(node_type_buffer_size));
-    KATANA_CHECKED(node_types->SetCursor(node_type_buffer_size));
-
-    katana::EntityTypeManager node_type_manager;
-    std::fill_n(
-        KATANA_CHECKED(node_types->ptr<katana::EntityTypeID>()),
-        header.num_nodes,
-        KATANA_CHECKED(node_type_manager.AddAtomicEntityType("vertex")));
-
-    auto edge_types = std::make_unique<katana::FileFrame>();
-    size_t edge_type_buffer_size =
-        header.num_edges * sizeof(katana::EntityTypeID);
-    KATANA_CHECKED(edge_types->Init(edge_type_buffer_size));
-    KATANA_CHECKED(edge_types->SetCursor(edge_type_buffer_size));
-
-    katana::EntityTypeManager edge_type_manager;
-    std::fill_n(
-        KATANA_CHECKED(edge_types->ptr<katana::EntityTypeID>()),
-        header.num_edges,
-        KATANA_CHECKED(edge_type_manager.AddAtomicEntityType("edge")));
-
-    return rdg.Store(
-        handle, kCommandLine, std::move(node_types), std::move(edge_types),
-        node_type_manager, edge_type_manager);
+    return StoreCSRTopology(
+        handle, top_file_name, header.num_nodes, header.num_edges);
   }
 
   template <typename EdgeTy>
@@ -3036,6 +3070,539 @@ struct Gr2Kg : public Conversion {
   }
 };
 
+/**
+ * Parallel, out-of-core conversion of edgelist style text files, parsed as
+ * convertEdgelist parses them, straight to an RDG.
+ *
+ * The input is mapped and cut into one lane of whole lines per thread. A
+ * first pass counts the edges and nodes. A second pass spills the edges of
+ * each lane into a file per partition, a range of source nodes, so that a
+ * partition holds the edges of its sources in the order of the input. Each
+ * partition is then counting sorted by source on its own and written into
+ * the topology of the RDG.
+ */
+namespace edgelist {
+
+/// Edges read into memory at once by one partition
+constexpr uint64_t kPartitionBytes = uint64_t{256} << 20;
+/// Edges buffered per partition by a lane before they are spilled
+constexpr size_t kSpillBufferEdges = 8192;
+
+template <typename EdgeTy>
+struct SpilledEdge {
+  uint32_t src;
+  uint32_t dst;
+  EdgeTy data;
+};
+
+template <>
+struct SpilledEdge<void> {
+  uint32_t src;
+  uint32_t dst;
+};
+
+bool
+IsBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+const char*
+SkipBlanks(const char* pos, const char* end) {
+  while (pos != end && IsBlank(*pos)) {
+    ++pos;
+  }
+  return pos;
+}
+
+/// The value of the 8 ASCII digits at pos, the first one the most
+/// significant, or nullopt if they are not all digits. The digits are
+/// checked and converted 8 at a time in a register, with 3 multiplies rather
+/// than 8.
+std::optional<uint64_t>
+ParseEightDigits(const char* pos) {
+  uint64_t chunk;
+  std::memcpy(&chunk, pos, sizeof(chunk));
+  constexpr uint64_t kHighNibbles = 0xF0F0F0F0F0F0F0F0ULL;
+  constexpr uint64_t kZeros = 0x3030303030303030ULL;
+  // every high nibble is 3 and no low nibble is above 9, so adding 6 to it
+  // does not carry
+  if ((chunk & kHighNibbles) != kZeros ||
+      ((chunk + 0x0606060606060606ULL) & kHighNibbles) != kZeros) {
+    return std::nullopt;
+  }
+  // the first digit is in the low byte
+  chunk -= kZeros;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+          (((chunk >> 16) & 0x000000FF000000FFULL) *
+           (1 + (10000ULL << 32)))) >>
+         32;
+}
+
+/// Parse the unsigned decimal after the blanks at *pos, advancing *pos past
+/// it; returns false if there is none or it does not fit in 64 bits.
+bool
+ParseUnsigned(const char** pos, const char* end, uint64_t* value) {
+  const char* p = SkipBlanks(*pos, end);
+  const char* begin = p;
+  uint64_t v = 0;
+  while (end - p >= 8) {
+    std::optional<uint64_t> digits = ParseEightDigits(p);
+    if (!digits) {
+      break;
+    }
+    v = v * 100000000 + *digits;
+    p += 8;
+  }
+  while (p != end && *p >= '0' && *p <= '9') {
+    v = v * 10 + (*p - '0');
+    ++p;
+  }
+  // more digits than the 19 that always fit could have overflowed
+  if (p == begin || p - begin > 19) {
+    return false;
+  }
+  *pos = p;
+  *value = v;
+  return true;
+}
+
+/// Parse the edge value after the blanks at *pos, advancing *pos past it
+template <typename T>
+bool
+ParseValue(const char** pos, const char* end, T* value) {
+  const char* p = SkipBlanks(*pos, end);
+  char token[64];
+  size_t length = 0;
+  while (p + length != end && length + 1 < sizeof(token) &&
+         std::strchr("+-.0123456789eE", p[length]) != nullptr &&
+         p[length] != '\0') {
+    token[length] = p[length];
+    ++length;
+  }
+  token[length] = '\0';
+  char* parsed = nullptr;
+  errno = 0;
+  if constexpr (std::is_floating_point_v<T>) {
+    *value = static_cast<T>(std::strtod(token, &parsed));
+  } else if constexpr (std::is_signed_v<T>) {
+    *value = static_cast<T>(std::strtoll(token, &parsed, 10));
+  } else {
+    *value = static_cast<T>(std::strtoull(token, &parsed, 10));
+  }
+  if (parsed == token || errno != 0) {
+    return false;
+  }
+  *pos = p + (parsed - token);
+  return true;
+}
+
+bool
+ParseDelim(const char** pos, const char* end, std::optional<char> delim) {
+  if (!delim) {
+    return true;
+  }
+  const char* p = SkipBlanks(*pos, end);
+  if (p == end || *p != *delim) {
+    return false;
+  }
+  *pos = p + 1;
+  return true;
+}
+
+/// Call fn(src, dst, data) for each edge in the lines of [begin, end);
+/// returns the number of lines that are not edges.
+template <typename EdgeTy, typename Fn>
+size_t
+ForEachEdge(
+    const char* begin, const char* end, std::optional<char> delim,
+    const Fn& fn) {
+  using EdgeData = katana::NUMAArray<EdgeTy>;
+  using edge_value_type = typename EdgeData::value_type;
+
+  size_t skipped = 0;
+  for (const char* line = begin; line != end;) {
+    const char* line_end =
+        static_cast<const char*>(std::memchr(line, '\n', end - line));
+    line_end = line_end == nullptr ? end : line_end;
+    const char* pos = line;
+
+    uint64_t src;
+    uint64_t dst;
+    edge_value_type data{};
+    bool valid = ParseUnsigned(&pos, line_end, &src) &&
+                 ParseDelim(&pos, line_end, delim) &&
+                 ParseUnsigned(&pos, line_end, &dst);
+    if constexpr (EdgeData::has_value) {
+      valid = valid && ParseDelim(&pos, line_end, delim) &&
+              ParseValue(&pos, line_end, &data);
+    }
+    if (valid) {
+      fn(src, dst, data);
+    } else if (SkipBlanks(line, line_end) != line_end) {
+      ++skipped;
+    }
+    line = line_end == end ? end : line_end + 1;
+  }
+  return skipped;
+}
+
+/// The start of the first line that starts at or after offset in text
+uint64_t
+LineBoundary(const char* text, uint64_t size, uint64_t offset) {
+  if (offset == 0 || offset >= size) {
+    return std::min(offset, size);
+  }
+  const void* newline = std::memchr(text + offset - 1, '\n', size - offset + 1);
+  return newline == nullptr
+             ? size
+             : static_cast<const char*>(newline) - text + uint64_t{1};
+}
+
+katana::Result<void>
+PWriteAll(int fd, const void* buf, uint64_t size, uint64_t offset) {
+  const char* data = static_cast<const char*>(buf);
+  while (size > 0) {
+    ssize_t written = pwrite(fd, data, size, offset);
+    if (written < 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "writing topology: {}", std::strerror(errno));
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename EdgeTy>
+struct Converter {
+  using Edge = SpilledEdge<EdgeTy>;
+  using EdgeData = katana::NUMAArray<EdgeTy>;
+  using edge_value_type = typename EdgeData::value_type;
+
+  std::string spill_dir;
+  size_t num_lanes;
+  std::vector<uint64_t> lane_bounds;
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  size_t num_partitions{0};
+  uint64_t nodes_per_partition{0};
+  // the edges spilled by lane l into partition p are
+  // spilled[l * num_partitions + p]
+  std::vector<uint64_t> spilled;
+
+  std::string SpillFile(size_t lane, size_t partition) const {
+    return spill_dir + "/lane-" + std::to_string(lane) + "-part-" +
+           std::to_string(partition);
+  }
+
+  void Scan(const char* text, std::optional<char> delim) {
+    std::vector<uint64_t> lane_edges(num_lanes);
+    std::vector<uint64_t> lane_max(num_lanes);
+    std::vector<size_t> lane_skipped(num_lanes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_lanes),
+        [&](size_t lane) {
+          uint64_t edges = 0;
+          uint64_t max_node = 0;
+          lane_skipped[lane] = ForEachEdge<EdgeTy>(
+              text + lane_bounds[lane], text + lane_bounds[lane + 1], delim,
+              [&](uint64_t src, uint64_t dst, const edge_value_type&) {
+                ++edges;
+                max_node = std::max({max_node, src, dst});
+              });
+          lane_edges[lane] = edges;
+          lane_max[lane] = max_node;
+        },
+        katana::no_stats());
+
+    num_edges = std::accumulate(lane_edges.begin(), lane_edges.end(), 0UL);
+    num_nodes = *std::max_element(lane_max.begin(), lane_max.end()) + 1;
+    size_t skipped =
+        std::accumulate(lane_skipped.begin(), lane_skipped.end(), size_t{0});
+    if (skipped > 0) {
+      katana::gWarn(
+          "ignored ", skipped,
+          " lines because they did not match the expected format\n");
+    }
+    if (num_nodes > std::numeric_limits<uint32_t>::max()) {
+      KATANA_LOG_FATAL(
+          "{} nodes do not fit in the 32 bit node ids of the topology",
+          num_nodes);
+    }
+
+    uint64_t bytes = num_edges * sizeof(Edge);
+    num_partitions = std::max<uint64_t>(
+        num_lanes, (bytes + kPartitionBytes - 1) / kPartitionBytes);
+    num_partitions = std::min<uint64_t>(num_partitions, num_nodes);
+    nodes_per_partition = (num_nodes + num_partitions - 1) / num_partitions;
+    num_partitions =
+        (num_nodes + nodes_per_partition - 1) / nodes_per_partition;
+  }
+
+  void Spill(const char* text, std::optional<char> delim) {
+    spilled.assign(num_lanes * num_partitions, 0);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_lanes),
+        [&](size_t lane) {
+          std::vector<std::vector<Edge>> buffers(num_partitions);
+          // files are opened per flush rather than held open, since there
+          // are as many of them as lanes times partitions
+          auto flush = [&](size_t p) {
+            std::ofstream file(
+                SpillFile(lane, p), std::ios::binary | std::ios::app);
+            file.write(
+                reinterpret_cast<const char*>(buffers[p].data()),
+                buffers[p].size() * sizeof(Edge));
+            if (!file) {
+              KATANA_LOG_FATAL("could not spill to {}", SpillFile(lane, p));
+            }
+            spilled[lane * num_partitions + p] += buffers[p].size();
+            buffers[p].clear();
+          };
+          ForEachEdge<EdgeTy>(
+              text + lane_bounds[lane], text + lane_bounds[lane + 1], delim,
+              [&](uint64_t src, uint64_t dst, const edge_value_type& data) {
+                size_t p = src / nodes_per_partition;
+                Edge edge;
+                edge.src = src;
+                edge.dst = dst;
+                if constexpr (EdgeData::has_value) {
+                  edge.data = data;
+                }
+                buffers[p].emplace_back(edge);
+                if (buffers[p].size() == kSpillBufferEdges) {
+                  flush(p);
+                }
+              });
+          for (size_t p = 0; p < num_partitions; ++p) {
+            if (!buffers[p].empty()) {
+              flush(p);
+            }
+          }
+        },
+        katana::no_stats());
+  }
+
+  /// Counting sort each partition by source and pass the out indexes of its
+  /// nodes, the destinations and the values of its edges, and the first
+  /// node and edge of the partition to write(first_node, first_edge,
+  /// out_indexes, dests, data)
+  template <typename Write>
+  void Sort(const Write& write) {
+    std::vector<uint64_t> partition_edges(num_partitions);
+    for (size_t p = 0; p < num_partitions; ++p) {
+      for (size_t lane = 0; lane < num_lanes; ++lane) {
+        partition_edges[p] += spilled[lane * num_partitions + p];
+      }
+    }
+    std::vector<uint64_t> first_edges(num_partitions);
+    std::exclusive_scan(
+        partition_edges.begin(), partition_edges.end(), first_edges.begin(),
+        uint64_t{0});
+
+    katana::do_all(
+        katana::iterate(size_t{0}, num_partitions),
+        [&](size_t p) {
+          uint64_t first_node = p * nodes_per_partition;
+          uint64_t end_node =
+              std::min<uint64_t>(first_node + nodes_per_partition, num_nodes);
+          // the edges of the partition in the order of the input
+          std::vector<Edge> edges(partition_edges[p]);
+          uint64_t read = 0;
+          for (size_t lane = 0; lane < num_lanes; ++lane) {
+            uint64_t count = spilled[lane * num_partitions + p];
+            if (count == 0) {
+              continue;
+            }
+            std::ifstream file(SpillFile(lane, p), std::ios::binary);
+            file.read(
+                reinterpret_cast<char*>(edges.data() + read),
+                count * sizeof(Edge));
+            if (!file) {
+              KATANA_LOG_FATAL("could not read {}", SpillFile(lane, p));
+            }
+            file.close();
+            std::remove(SpillFile(lane, p).c_str());
+            read += count;
+          }
+
+          std::vector<uint64_t> out_indexes(end_node - first_node);
+          for (const Edge& edge : edges) {
+            ++out_indexes[edge.src - first_node];
+          }
+          std::vector<uint64_t> offsets(out_indexes.size());
+          std::exclusive_scan(
+              out_indexes.begin(), out_indexes.end(), offsets.begin(),
+              uint64_t{0});
+          std::vector<uint32_t> dests(edges.size());
+          std::vector<edge_value_type> data(
+              EdgeData::has_value ? edges.size() : 0);
+          for (const Edge& edge : edges) {
+            uint64_t pos = offsets[edge.src - first_node]++;
+            dests[pos] = edge.dst;
+            if constexpr (EdgeData::has_value) {
+              data[pos] = edge.data;
+            }
+          }
+          // after the sort, offsets are the ends of the edges of each node
+          for (auto& offset : offsets) {
+            offset += first_edges[p];
+          }
+          write(first_node, first_edges[p], offsets, dests, data);
+        },
+        katana::steal(), katana::no_stats());
+  }
+};
+
+}  // namespace edgelist
+
+/**
+ * Edgelist2Kg converts an edge list or csv, src dst [weight] per line, into
+ * an RDG in parallel and out of core, without an intermediate gr. Without
+ * edge values the topology is written into the RDG as partitions are
+ * sorted; edge values are collected in memory to be added as the "value"
+ * edge property.
+ */
+template <bool IsCSV>
+struct Edgelist2Kg : public Conversion {
+  template <typename EdgeTy>
+  void convert(
+      const std::string& in_file_name, const std::string& out_file_name) {
+    if (auto res = Convert<EdgeTy>(in_file_name, out_file_name); !res) {
+      KATANA_LOG_FATAL("Failed to convert {}: {}", in_file_name, res.error());
+    }
+  }
+
+  template <typename EdgeTy>
+  katana::Result<void> Convert(
+      const std::string& in_file_name, const std::string& out_file_name) {
+    using EdgeData = katana::NUMAArray<EdgeTy>;
+    using edge_value_type = typename EdgeData::value_type;
+    std::optional<char> delim = IsCSV ? std::optional<char>(',') : std::nullopt;
+
+    katana::FileView input;
+    KATANA_CHECKED(input.MapReadOnly(
+        in_file_name, katana::FileView::MapAdvice::kSequential));
+    const char* text = input.ptr<char>();
+    uint64_t size = input.size();
+
+    edgelist::Converter<EdgeTy> converter;
+    converter.spill_dir = spillDir.empty()
+                              ? std::filesystem::temp_directory_path().string()
+                              : std::string(spillDir);
+    converter.spill_dir += "/edgelist2kg-" + std::to_string(getpid());
+    std::filesystem::remove_all(converter.spill_dir);
+    std::filesystem::create_directories(converter.spill_dir);
+    converter.num_lanes = katana::getActiveThreads();
+
+    uint64_t begin = 0;
+    if (IsCSV) {
+      katana::gWarn(
+          "first line is assumed to contain labels and will be ignored\n");
+      begin = edgelist::LineBoundary(text, size, 1);
+    }
+    for (size_t lane = 0; lane <= converter.num_lanes; ++lane) {
+      converter.lane_bounds.emplace_back(edgelist::LineBoundary(
+          text, size, begin + (size - begin) * lane / converter.num_lanes));
+    }
+
+    converter.Scan(text, delim);
+    converter.Spill(text, delim);
+
+    KATANA_CHECKED(katana::Create(out_file_name));
+    katana::RDGManifest manifest =
+        KATANA_CHECKED(katana::FindManifest(out_file_name));
+    katana::RDGHandle rdg_handle =
+        KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadWrite));
+    katana::RDGFile handle(std::move(rdg_handle));
+
+    uint64_t num_nodes = converter.num_nodes;
+    uint64_t num_edges = converter.num_edges;
+    if constexpr (!EdgeData::has_value) {
+      katana::Uri top_file_name = katana::MakeTopologyFileName(handle);
+      // write the topology in place if it is local, or next to the spilled
+      // edges to be copied to it
+      bool is_local = top_file_name.scheme() == katana::Uri::kFileScheme;
+      std::string local_name = is_local ? top_file_name.path()
+                                        : converter.spill_dir + "/topology";
+
+      katana::CSRTopologyHeader header;
+      header.version = 1;
+      header.num_nodes = num_nodes;
+      header.num_edges = num_edges;
+      uint64_t file_size = katana::CSRTopologyFileSize(header);
+      uint64_t dests_offset = sizeof(header) + num_nodes * sizeof(uint64_t);
+
+      int fd = open(local_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        return KATANA_ERROR(
+            katana::ResultErrno(), "opening {}: {}", local_name,
+            std::strerror(errno));
+      }
+      std::atomic<bool> failed{false};
+      if (ftruncate(fd, file_size) != 0 ||
+          !edgelist::PWriteAll(fd, &header, sizeof(header), 0)) {
+        failed = true;
+      }
+      converter.Sort([&](uint64_t first_node, uint64_t first_edge,
+                         const std::vector<uint64_t>& out_indexes,
+                         const std::vector<uint32_t>& dests,
+                         const std::vector<edge_value_type>&) {
+        if (!edgelist::PWriteAll(
+                fd, out_indexes.data(), out_indexes.size() * sizeof(uint64_t),
+                sizeof(header) + first_node * sizeof(uint64_t)) ||
+            !edgelist::PWriteAll(
+                fd, dests.data(), dests.size() * sizeof(uint32_t),
+                dests_offset + first_edge * sizeof(uint32_t))) {
+          failed = true;
+        }
+      });
+      if (close(fd) != 0 || failed) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "could not write {}",
+            local_name);
+      }
+      if (!is_local) {
+        KATANA_CHECKED(katana::FileRemoteCopy(
+            local_name, top_file_name.string(), 0, file_size));
+      }
+      KATANA_CHECKED(
+          StoreCSRTopology(handle, top_file_name, num_nodes, num_edges));
+    } else {
+      katana::NUMAArray<uint64_t> out_indices;
+      out_indices.allocateBlocked(num_nodes);
+      katana::NUMAArray<uint32_t> out_dests;
+      out_dests.allocateBlocked(num_edges);
+      katana::NUMAArray<EdgeTy> out_dests_data;
+      out_dests_data.allocateBlocked(num_edges);
+      converter.Sort([&](uint64_t first_node, uint64_t first_edge,
+                         const std::vector<uint64_t>& out_indexes,
+                         const std::vector<uint32_t>& dests,
+                         const std::vector<edge_value_type>& data) {
+        std::copy(
+            out_indexes.begin(), out_indexes.end(),
+            out_indices.begin() + first_node);
+        std::copy(dests.begin(), dests.end(), out_dests.begin() + first_edge);
+        std::copy(
+            data.begin(), data.end(), out_dests_data.begin() + first_edge);
+      });
+
+      katana::GraphTopology topo{std::move(out_indices), std::move(out_dests)};
+      std::unique_ptr<katana::PropertyGraph> pg =
+          KATANA_CHECKED(katana::PropertyGraph::Make(std::move(topo)));
+      katana::TxnContext txn_ctx;
+      KATANA_CHECKED(
+          AppendEdgeData<EdgeTy>(pg.get(), out_dests_data, &txn_ctx));
+      KATANA_CHECKED(pg->Write(out_file_name, kCommandLine));
+    }
+    std::filesystem::remove_all(converter.spill_dir);
+    printStatus(num_nodes, num_edges);
+    return katana::ResultSuccess();
+  }
+};
+
 /**
  * METIS format (1-indexed). See METIS 4.10 manual, section 4.5.
  *  % comment prefix
@@ -3295,6 +3862,7 @@ main(int argc, char** argv) {
       argc, argv,
       "Converter for old graphs to gr formats for galois\n\n"
       "  For converting property graphs use graph-properties-convert\n");
+  katana::setActiveThreads(numThreads);
   std::ios_base::sync_with_stdio(false);
   switch (convertMode) {
   case bipartitegr2bigpetsc:
@@ -3417,6 +3985,12 @@ main(int argc, char** argv) {
   case gr2kg:
     convert<Gr2Kg>();
     break;
+  case edgelist2kg:
+    convert<Edgelist2Kg<false>>();
+    break;
+  case csv2kg:
+    convert<Edgelist2Kg<true>>();
+    break;
   case mtx2gr:
     convert<Mtx2Gr>();
     break;
@@ -3,6 +3,7 @@
 #include <llvm/Support/CommandLine.h>
 
 #include "Transforms.h"
+#include "graph-properties-convert-neo4j-csv.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphML.h"
@@ -37,7 +38,10 @@ cll::opt<katana::SourceType> type(
             "source file is of type GraphML"),
         clEnumValN(
             katana::SourceType::kKatana, "katana",
-            "source file is of type Katana")),
+            "source file is of type Katana"),
+        clEnumValN(
+            katana::SourceType::kCsv, "csv",
+            "source is a directory of Neo4j bulk import CSV files")),
     cll::init(katana::SourceType::kGraphml));
 cll::opt<katana::SourceDatabase> database(
     cll::desc("Database the data is from:"),
@@ -57,6 +61,14 @@ cll::opt<int> chunk_size(
               "it can be decreased to improve memory usage when "
               "converting large inputs"),
     cll::init(25000));
+cll::opt<int> chunk_budget(
+    "chunk-budget",
+    cll::desc("Bytes of a GraphML graph that each thread parses at a time\n"
+              "It can be decreased to improve memory usage when converting "
+              "large inputs"),
+    cll::init(64 << 20));
+cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
 cll::opt<std::string> mapping(
     "mapping",
     cll::desc("File in graphml format with a schema mapping for the database"),
@@ -85,6 +97,32 @@ cll::opt<std::string> user(
     cll::desc("Username for the target database if needed, default is root"),
     cll::init("root"));
 
+cll::list<std::string> csv_nodes(
+    "nodes",
+    cll::desc("A group of Neo4j node files, [Label1:Label2=]file1,file2,...\n"
+              "Files are relative to the input directory; the header is the "
+              "first line of the first file. By default each .csv file of "
+              "the input directory is a group"));
+cll::list<std::string> csv_relationships(
+    "relationships",
+    cll::desc("A group of Neo4j relationship files, [TYPE=]file1,file2,..."));
+cll::opt<char> csv_delimiter(
+    "delimiter", cll::desc("Delimiter of the fields of CSV files"),
+    cll::init(','));
+cll::opt<char> csv_array_delimiter(
+    "array-delimiter",
+    cll::desc("Delimiter of the elements of arrays and labels in CSV files"),
+    cll::init(';'));
+cll::opt<bool> csv_infer_types(
+    "infer-types",
+    cll::desc("Infer the types of untyped CSV columns, rather than read them "
+              "as strings"),
+    cll::init(false));
+cll::opt<bool> csv_skip_bad_relationships(
+    "skip-bad-relationships",
+    cll::desc("Skip CSV relationships to nodes that are not imported"),
+    cll::init(false));
+
 cll::opt<bool> export_graphml(
     "export",
     cll::desc("Exports a Katana graph to graphml format\n"
@@ -141,7 +179,7 @@ ParseWild(katana::TxnContext* txn_ctx) {
   switch (type) {
   case katana::SourceType::kGraphml: {
     auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+        katana::ConvertGraphML(input_filename, chunk_size, true, chunk_budget);
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -164,12 +202,39 @@ ParseWild(katana::TxnContext* txn_ctx) {
   }
 }
 
+katana::Result<void>
+ConvertNeo4jCSV(katana::TxnContext* txn_ctx) {
+  std::vector<katana::Neo4jCSVGroup> node_groups;
+  std::vector<katana::Neo4jCSVGroup> relationship_groups;
+  if (csv_nodes.empty() && csv_relationships.empty()) {
+    KATANA_CHECKED(katana::FindNeo4jCSVGroups(
+        input_filename, &node_groups, &relationship_groups));
+  }
+  for (const std::string& spec : csv_nodes) {
+    node_groups.emplace_back(
+        KATANA_CHECKED(katana::Neo4jCSVGroup::Parse(spec, input_filename)));
+  }
+  for (const std::string& spec : csv_relationships) {
+    relationship_groups.emplace_back(
+        KATANA_CHECKED(katana::Neo4jCSVGroup::Parse(spec, input_filename)));
+  }
+
+  katana::Neo4jCSVOptions opts;
+  opts.delimiter = csv_delimiter;
+  opts.array_delimiter = csv_array_delimiter;
+  opts.infer_types = csv_infer_types;
+  opts.skip_bad_relationships = csv_skip_bad_relationships;
+  auto graph = KATANA_CHECKED(katana::ImportNeo4jCSV(
+      node_groups, relationship_groups, opts, txn_ctx));
+  return katana::WritePropertyGraph(*graph, output_directory);
+}
+
 void
 ParseNeo4j(katana::TxnContext* txn_ctx) {
   switch (type) {
   case katana::SourceType::kGraphml: {
     auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+        katana::ConvertGraphML(input_filename, chunk_size, true, chunk_budget);
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -180,6 +245,11 @@ ParseNeo4j(katana::TxnContext* txn_ctx) {
     }
     return;
   }
+  case katana::SourceType::kCsv:
+    if (auto r = ConvertNeo4jCSV(txn_ctx); !r) {
+      KATANA_LOG_FATAL("Failed to convert Neo4j CSV files: {}", r.error());
+    }
+    return;
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
@@ -234,6 +304,10 @@ main(int argc, char** argv) {
   if (chunk_size <= 0) {
     chunk_size = 25000;
   }
+  if (chunk_budget <= 0) {
+    chunk_budget = 64 << 20;
+  }
+  num_threads = katana::setActiveThreads(num_threads);
 
   katana::TxnContext txn_ctx;
   if (export_graphml) {
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -18,6 +19,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "ImportPipeline.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
@@ -33,6 +35,11 @@ using katana::PropertyKey;
 
 namespace {
 
+// documents per batch fetched from a collection, and batches of a collection
+// fetched ahead of the builder
+constexpr size_t kDocumentsPerBatch = 1024;
+constexpr size_t kMaxBatches = 4;
+
 struct CollectionFields {
   std::map<std::string, PropertyKey> property_fields;
   std::set<std::string> embedded_nodes;
@@ -544,20 +551,53 @@ GetCollectionNames(mongoc_database_t* database) {
   return coll_names;
 }
 
-template <typename T>
+// Documents of a collection copied out of their cursor, so that it can fetch
+// the next documents while the builder adds these
+class DocumentBatch {
+public:
+  void Add(const bson_t* document) {
+    documents_.emplace_back(bson_copy(document));
+  }
+
+  size_t size() const { return documents_.size(); }
+
+  const bson_t* operator[](size_t i) const { return documents_[i].get(); }
+
+private:
+  struct Destroy {
+    void operator()(bson_t* document) const { bson_destroy(document); }
+  };
+
+  std::vector<std::unique_ptr<bson_t, Destroy>> documents_;
+};
+
+// Fetch the documents of a collection with client in batches, passing each
+// to emit
+template <typename Emit>
 void
 QueryEntireCollection(
-    mongoc_database_t* database, const bson_t** document,
-    const std::string& coll_name, T document_op) {
+    mongoc_client_t* client, const std::string& db_name,
+    const std::string& coll_name, const Emit& emit) {
   bson_error_t error;
+  mongoc_database_t* database =
+      mongoc_client_get_database(client, db_name.c_str());
   auto collection = mongoc_database_get_collection(database, coll_name.c_str());
   bson_t filter;
   bson_init(&filter);
   auto cursor =
       mongoc_collection_find_with_opts(collection, &filter, nullptr, nullptr);
 
-  while (mongoc_cursor_next(cursor, document)) {
-    document_op();
+  const bson_t* document = nullptr;
+  DocumentBatch batch;
+  while (mongoc_cursor_next(cursor, &document)) {
+    batch.Add(document);
+    if (batch.size() == kDocumentsPerBatch) {
+      emit(std::move(batch));
+      batch = DocumentBatch{};
+    }
+  }
+  if (batch.size() > 0) {
+    emit(std::move(batch));
   }
   if (mongoc_cursor_error(cursor, &error)) {
     KATANA_LOG_ERROR(
@@ -567,6 +607,7 @@ QueryEntireCollection(
   bson_destroy(&filter);
   mongoc_cursor_destroy(cursor);
   mongoc_collection_destroy(collection);
+  mongoc_database_destroy(database);
 }
 
 /***************************************/
@@ -1113,7 +1154,6 @@ katana::GraphComponents
 katana::ConvertMongoDB(
     const std::string& db_name, const std::string& mapping, size_t chunk_size) {
   const char* uri_string = "mongodb://localhost:27017";
-  const bson_t* document = nullptr;
 
   katana::PropertyGraphBuilder builder{chunk_size};
   katana::setActiveThreads(1000);
@@ -1139,18 +1179,36 @@ katana::ConvertMongoDB(
     edges = res.second;
   }
 
-  // add all edges first
-  for (auto coll_name : edges) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
-    });
-  }
-  // then add all nodes
-  for (auto coll_name : nodes) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
-    });
+  // add all edges first, then all nodes, fetching the collections on
+  // clients of their own while the builder adds the documents fetched so far
+  std::vector<std::string> collections = edges;
+  collections.insert(collections.end(), nodes.begin(), nodes.end());
+  size_t num_fetchers = std::max<size_t>(
+      std::min<size_t>(katana::getActiveThreads(), collections.size()), 1);
+  std::deque<MongoClient> clients;
+  for (size_t i = 0; i < num_fetchers; i++) {
+    clients.emplace_back(GetMongoClient(uri_string));
   }
+  katana::ImportPipeline<DocumentBatch> pipeline{
+      collections.size(), num_fetchers, kMaxBatches};
+  pipeline.Run(
+      [&](size_t coll, size_t fetcher, const auto& emit) {
+        QueryEntireCollection(
+            clients[fetcher].client, db_name, collections[coll], emit);
+      },
+      [&](size_t coll, DocumentBatch&& documents) {
+        const std::string& coll_name = collections[coll];
+        for (size_t i = 0; i < documents.size(); i++) {
+          if (coll < edges.size()) {
+            katana::HandleEdgeDocumentMongoDB(
+                &builder, documents[i], coll_name);
+          } else {
+            katana::HandleNodeDocumentMongoDB(
+                &builder, documents[i], coll_name);
+          }
+        }
+      });
+  clients.clear();
 
   mongoc_cleanup();
   if (auto r = builder.Finish(); !r) {
@@ -21,6 +21,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "ImportPipeline.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
@@ -37,6 +38,11 @@ using katana::PropertyKey;
 
 namespace {
 
+// rows per batch fetched from a table, and batches of a range of a table
+// fetched ahead of the builder
+constexpr size_t kRowsPerBatch = 4096;
+constexpr size_t kMaxBatches = 4;
+
 struct MysqlRes {
   MYSQL_RES* res;
 
@@ -67,6 +73,10 @@ struct TableData {
   std::string name;
   bool is_node;
   int64_t primary_key_index;
+  // the primary key field, and whether it is a single integer field whose
+  // range the table can be fetched by
+  std::string primary_key_name;
+  bool integer_primary_key;
   std::vector<Relationship> out_references;
   std::vector<Relationship> in_references;
   std::vector<std::string> field_names;
@@ -77,12 +87,24 @@ struct TableData {
       : name(std::move(name_)),
         is_node(true),
         primary_key_index(-1),
+        integer_primary_key(false),
         out_references(std::vector<Relationship>{}),
         in_references(std::vector<Relationship>{}),
         field_names(std::vector<std::string>{}),
         field_indexes(std::vector<size_t>{}),
         ignore_list(std::unordered_set<std::string>{}) {}
 
+  void SetPrimaryKey(MYSQL_FIELD* field, size_t field_index) {
+    primary_key_index = static_cast<int64_t>(field_index);
+    integer_primary_key = primary_key_name.empty() &&
+                          (field->flags & UNSIGNED_FLAG) == 0 &&
+                          (field->type == MYSQL_TYPE_SHORT ||
+                           field->type == MYSQL_TYPE_INT24 ||
+                           field->type == MYSQL_TYPE_LONG ||
+                           field->type == MYSQL_TYPE_LONGLONG);
+    primary_key_name = std::string(field->name, field->name_length);
+  }
+
   void ResolveOutgoingKeys(const std::string& field, size_t field_index) {
     for (auto& relation : this->out_references) {
       if (relation.source_field == field) {
@@ -220,6 +242,21 @@ GenerateFetchTableQuery(const std::string& table) {
   return std::string{"SELECT * FROM " + table + ";"};
 }
 
+std::string
+GenerateFetchKeyRangeQuery(const std::string& table, const std::string& key) {
+  return std::string{
+      "SELECT MIN(" + key + "), MAX(" + key + ") FROM " + table + ";"};
+}
+
+std::string
+GenerateFetchRangeQuery(
+    const std::string& table, const std::string& key, int64_t first,
+    int64_t last) {
+  return std::string{
+      "SELECT * FROM " + table + " WHERE " + key + " BETWEEN " +
+      std::to_string(first) + " AND " + std::to_string(last) + ";"};
+}
+
 std::vector<std::string>
 FetchTableNames(MYSQL* con) {
   std::vector<std::string> table_names;
@@ -257,22 +294,137 @@ RunQuery(MYSQL* con, const std::string& query) {
 }
 
 void
-AddNodeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
-  MYSQL_ROW row;
+ExhaustResultSet(MysqlRes* res) {
+  while (mysql_fetch_row(res->res))
+    ;
+}
+
+// Rows of a table copied out of the result of their query, so that its
+// connection can fetch the next rows while the builder adds these
+class RowBatch {
+public:
+  explicit RowBatch(size_t num_fields) : num_fields_(num_fields) {}
+
+  void AddRow(MYSQL_ROW row, const unsigned long* lengths) {
+    for (size_t i = 0; i < num_fields_; i++) {
+      nulls_.emplace_back(row[i] == NULL);
+      if (row[i] != NULL) {
+        data_.append(row[i], lengths[i]);
+      }
+      ends_.emplace_back(data_.size());
+    }
+    num_rows_++;
+  }
+
+  size_t num_rows() const { return num_rows_; }
+
+  bool IsNull(size_t row, size_t field) const {
+    return nulls_[row * num_fields_ + field];
+  }
+
+  // the value of field in row, empty if it is null
+  std::string Field(size_t row, size_t field) const {
+    size_t cell = row * num_fields_ + field;
+    size_t begin = cell == 0 ? 0 : ends_[cell - 1];
+    return data_.substr(begin, ends_[cell] - begin);
+  }
+
+private:
+  size_t num_fields_;
+  size_t num_rows_{0};
+  std::string data_;
+  std::vector<size_t> ends_;
+  std::vector<uint8_t> nulls_;
+};
+
+// A query for the rows of a table, or of a range of its primary key
+struct TableRange {
+  const TableData* table;
+  std::string query;
+};
+
+// Split each table with an integer primary key into up to num_ranges ranges
+// of it, so that several connections can fetch one table
+std::vector<TableRange>
+PartitionTables(
+    MYSQL* con, const std::unordered_map<std::string, TableData>& table_data,
+    size_t num_ranges) {
+  std::vector<TableRange> ranges;
+  for (const auto& [name, table] : table_data) {
+    std::optional<std::pair<int64_t, int64_t>> bounds;
+    if (table.integer_primary_key && num_ranges > 1) {
+      MysqlRes res = RunQuery(
+          con, GenerateFetchKeyRangeQuery(name, table.primary_key_name));
+      MYSQL_ROW row = mysql_fetch_row(res.res);
+      // an empty table has no bounds
+      if (row != NULL && row[0] != NULL && row[1] != NULL) {
+        bounds = std::make_pair(
+            boost::lexical_cast<int64_t>(row[0]),
+            boost::lexical_cast<int64_t>(row[1]));
+      }
+      ExhaustResultSet(&res);
+    }
+    if (!bounds) {
+      ranges.emplace_back(TableRange{&table, GenerateFetchTableQuery(name)});
+      continue;
+    }
+    auto [min, max] = bounds.value();
+    uint64_t span = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+    uint64_t step = span / num_ranges + 1;
+    for (uint64_t first = 0; first <= span; first += step) {
+      uint64_t last = std::min(first + step - 1, span);
+      ranges.emplace_back(TableRange{
+          &table,
+          GenerateFetchRangeQuery(
+              name, table.primary_key_name,
+              static_cast<int64_t>(static_cast<uint64_t>(min) + first),
+              static_cast<int64_t>(static_cast<uint64_t>(min) + last))});
+      if (last == span) {
+        break;
+      }
+    }
+  }
+  return ranges;
+}
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
+// Fetch the rows of query on con in batches, passing each to emit
+template <typename Emit>
+void
+FetchRows(MYSQL* con, const std::string& query, const Emit& emit) {
+  // con may be used by another thread between queries
+  mysql_thread_init();
+  {
+    MysqlRes table = RunQuery(con, query);
+    size_t num_fields = mysql_num_fields(table.res);
+    RowBatch batch{num_fields};
+    MYSQL_ROW row;
+
+    while ((row = mysql_fetch_row(table.res))) {
+      batch.AddRow(row, mysql_fetch_lengths(table.res));
+      if (batch.num_rows() == kRowsPerBatch) {
+        emit(std::move(batch));
+        batch = RowBatch{num_fields};
+      }
+    }
+    if (batch.num_rows() > 0) {
+      emit(std::move(batch));
+    }
+  }
+  mysql_thread_end();
+}
 
+void
+AddNodeRows(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const RowBatch& rows) {
+  for (size_t row = 0; row < rows.num_rows(); row++) {
     builder->StartNode();
     builder->AddLabel(table_data.name);
 
     // if table has a primary key, add it as node's ID
     auto primary_index = table_data.primary_key_index;
     if (primary_index >= 0) {
-      std::string primary_key{row[primary_index], lengths[primary_index]};
+      std::string primary_key = rows.Field(row, primary_index);
       builder->AddNodeID(table_data.name + primary_key);
     }
 
@@ -280,8 +432,8 @@ AddNodeTable(
     for (size_t i = 0; i < table_data.field_names.size(); i++) {
       auto index = table_data.field_indexes[i];
       // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
+      if (!rows.IsNull(row, index)) {
+        std::string value = rows.Field(row, index);
 
         builder->AddValue(
             table_data.field_names[i],
@@ -299,8 +451,8 @@ AddNodeTable(
     for (auto relation : table_data.out_references) {
       auto foreign_index = relation.source_index;
       // if the target is null then do not add an edge
-      if (row[foreign_index] != NULL) {
-        std::string foreign_key{row[foreign_index], lengths[foreign_index]};
+      if (!rows.IsNull(row, foreign_index)) {
+        std::string foreign_key = rows.Field(row, foreign_index);
         std::string edge_id = relation.target_table + foreign_key;
         builder->AddOutgoingEdge(edge_id, relation.label);
       }
@@ -310,15 +462,10 @@ AddNodeTable(
 }
 
 void
-AddEdgeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
-  MYSQL_ROW row;
-
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
-
+AddEdgeRows(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const RowBatch& rows) {
+  for (size_t row = 0; row < rows.num_rows(); row++) {
     builder->StartEdge();
     builder->AddLabel(table_data.name);
 
@@ -326,7 +473,7 @@ AddEdgeTable(
     // if the source or target is null then add a placeholder node
     for (auto relation : table_data.out_references) {
       auto foreign_index = relation.source_index;
-      std::string foreign_key{row[foreign_index], lengths[foreign_index]};
+      std::string foreign_key = rows.Field(row, foreign_index);
       std::string edge_id = relation.target_table + foreign_key;
       if (adding_source) {
         builder->AddEdgeSource(edge_id);
@@ -340,8 +487,8 @@ AddEdgeTable(
     for (size_t i = 0; i < table_data.field_names.size(); i++) {
       auto index = table_data.field_indexes[i];
       // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
+      if (!rows.IsNull(row, index)) {
+        std::string value = rows.Field(row, index);
 
         builder->AddValue(
             table_data.field_names[i],
@@ -500,12 +647,6 @@ GetUserInputForFields(
 /* Functions for preprocessing MySQL databases */
 /***********************************************/
 
-void
-ExhaustResultSet(MysqlRes* res) {
-  while (mysql_fetch_row(res->res))
-    ;
-}
-
 bool
 ContainsRelation(
     const std::vector<LabelRule>& rules, const std::string& label) {
@@ -641,7 +782,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) ==
         table_iter->second.ignore_list.end()) {
@@ -674,7 +815,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) !=
         table_iter->second.ignore_list.end()) {
@@ -854,15 +995,10 @@ GetMappingInput(
   katana::graphml::FinishGraphmlFile(writer);
 }
 
-}  // end of unnamed namespace
-
-GraphComponents
-katana::ConvertMysql(
-    const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user) {
-  katana::PropertyGraphBuilder builder{chunk_size};
-  std::string password{getpass("MySQL Password: ")};
-
+MYSQL*
+Connect(
+    const std::string& db_name, const std::string& host,
+    const std::string& user, const std::string& password) {
   MYSQL* con = mysql_init(NULL);
   if (con == nullptr) {
     KATANA_LOG_FATAL("mysql_init() failed");
@@ -873,6 +1009,19 @@ katana::ConvertMysql(
     KATANA_LOG_FATAL(
         "Could not establish mysql connection: {}", mysql_error(con));
   }
+  return con;
+}
+
+}  // end of unnamed namespace
+
+GraphComponents
+katana::ConvertMysql(
+    const std::string& db_name, const std::string& mapping,
+    const size_t chunk_size, const std::string& host, const std::string& user) {
+  katana::PropertyGraphBuilder builder{chunk_size};
+  std::string password{getpass("MySQL Password: ")};
+
+  MYSQL* con = Connect(db_name, host, user, password);
   std::vector<std::string> table_names = FetchTableNames(con);
   std::unordered_map<std::string, TableData> table_data;
   if (!mapping.empty()) {
@@ -884,12 +1033,32 @@ katana::ConvertMysql(
     table_data = PreprocessTables(con, &builder, table_names);
   }
 
-  for (auto table : table_data) {
-    if (table.second.is_node) {
-      AddNodeTable(&builder, con, table.second);
-    } else {
-      AddEdgeTable(&builder, con, table.second);
-    }
+  // fetch the tables, a range of a table at a time, on connections of their
+  // own while the builder adds the rows fetched so far
+  std::vector<TableRange> ranges =
+      PartitionTables(con, table_data, katana::getActiveThreads());
+  size_t num_fetchers = std::max<size_t>(
+      std::min<size_t>(katana::getActiveThreads(), ranges.size()), 1);
+  std::vector<MYSQL*> connections;
+  for (size_t i = 0; i < num_fetchers; i++) {
+    connections.emplace_back(Connect(db_name, host, user, password));
+  }
+  katana::ImportPipeline<RowBatch> pipeline{
+      ranges.size(), num_fetchers, kMaxBatches};
+  pipeline.Run(
+      [&](size_t range, size_t fetcher, const auto& emit) {
+        FetchRows(connections[fetcher], ranges[range].query, emit);
+      },
+      [&](size_t range, RowBatch&& rows) {
+        const TableData& table = *ranges[range].table;
+        if (table.is_node) {
+          AddNodeRows(&builder, table, rows);
+        } else {
+          AddEdgeRows(&builder, table, rows);
+        }
+      });
+  for (MYSQL* connection : connections) {
+    mysql_close(connection);
   }
   mysql_close(con);
   auto out_result = builder.Finish();
@@ -907,16 +1076,7 @@ katana::GenerateMappingMysql(
     const std::string& host, const std::string& user) {
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(db_name, host, user, password);
   std::vector<std::string> table_names = FetchTableNames(con);
 
   // get user input on node/edge mappings, label names, property names and
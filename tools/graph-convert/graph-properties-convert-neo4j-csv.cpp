@@ -0,0 +1,1026 @@
+#include "graph-properties-convert-neo4j-csv.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <arrow/csv/api.h>
+#include <arrow/io/api.h>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Strings.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using EntityTypeIDArray = katana::PropertyGraph::EntityTypeIDArray;
+
+/// Files read at once; each is parsed by the threads of the Arrow CSV
+/// reader too, so this only needs to keep them busy between files
+constexpr size_t kMaxConcurrentFiles = 4;
+
+constexpr Node kMissingNode = std::numeric_limits<Node>::max();
+
+enum class ColumnKind {
+  kID,
+  kStartID,
+  kEndID,
+  kLabel,
+  kType,
+  kIgnore,
+  kProperty
+};
+
+struct Column {
+  ColumnKind kind;
+  /// The property of the column; the ID of a node is a property when the
+  /// column is named
+  std::string name;
+  std::string id_space;
+  /// The type of the values, or of their elements for arrays; nullptr if
+  /// it is inferred
+  std::shared_ptr<arrow::DataType> type;
+  bool is_array{false};
+};
+
+struct Header {
+  std::vector<Column> columns;
+  int id{-1};
+  int start_id{-1};
+  int end_id{-1};
+  /// The :LABEL column of nodes or the :TYPE column of relationships
+  int types{-1};
+};
+
+/// A group read into memory, a column per column of its header
+struct GroupTable {
+  Header header;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  int64_t num_rows{0};
+};
+
+std::string
+ToLower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
+    return std::tolower(c);
+  });
+  return s;
+}
+
+/// The name of column i for the CSV reader, since the names in a header
+/// may be empty or repeated
+std::string
+ColumnName(size_t i) {
+  return fmt::format("c{}", i);
+}
+
+katana::Result<std::shared_ptr<arrow::DataType>>
+ParseType(const std::string& name) {
+  std::string type = ToLower(name);
+  if (type == "int") {
+    return arrow::int32();
+  }
+  if (type == "long") {
+    return arrow::int64();
+  }
+  if (type == "short") {
+    return arrow::int16();
+  }
+  if (type == "byte") {
+    return arrow::int8();
+  }
+  if (type == "float") {
+    return arrow::float32();
+  }
+  if (type == "double") {
+    return arrow::float64();
+  }
+  if (type == "boolean") {
+    return arrow::boolean();
+  }
+  if (type == "date") {
+    return arrow::date32();
+  }
+  if (type == "localdatetime") {
+    return arrow::timestamp(arrow::TimeUnit::MILLI);
+  }
+  if (type == "datetime") {
+    return arrow::timestamp(arrow::TimeUnit::MILLI, "UTC");
+  }
+  // Neo4j's temporal and spatial types with no Arrow equivalent are kept as
+  // their text
+  if (type == "string" || type == "char" || type == "time" ||
+      type == "localtime" || type == "duration" || type == "point") {
+    return arrow::utf8();
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument, "unknown Neo4j type {}", name);
+}
+
+/// Parse a field of a header like name:type, :ID(space) or :LABEL
+katana::Result<Column>
+ParseColumn(std::string field, const katana::Neo4jCSVOptions& opts) {
+  // options, like datetime{timezone:+01:00}, are not supported and the
+  // colons in them are not the separator of the type
+  if (!field.empty() && field.back() == '}') {
+    if (size_t brace = field.rfind('{'); brace != std::string::npos) {
+      field.resize(brace);
+    }
+  }
+
+  Column column;
+  column.kind = ColumnKind::kProperty;
+  size_t colon = field.rfind(':');
+  if (colon == std::string::npos) {
+    column.name = field;
+    column.type = opts.infer_types ? nullptr : arrow::utf8();
+    return column;
+  }
+  column.name = field.substr(0, colon);
+  std::string spec = field.substr(colon + 1);
+  if (size_t paren = spec.find('('); paren != std::string::npos) {
+    if (spec.back() != ')') {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "malformed ID space in {}",
+          field);
+    }
+    column.id_space = spec.substr(paren + 1, spec.size() - paren - 2);
+    spec.resize(paren);
+  }
+
+  std::string kind = ToLower(spec);
+  column.type = arrow::utf8();
+  if (kind == "id") {
+    column.kind = ColumnKind::kID;
+  } else if (kind == "start_id") {
+    column.kind = ColumnKind::kStartID;
+  } else if (kind == "end_id") {
+    column.kind = ColumnKind::kEndID;
+  } else if (kind == "label") {
+    column.kind = ColumnKind::kLabel;
+  } else if (kind == "type") {
+    column.kind = ColumnKind::kType;
+  } else if (kind == "ignore") {
+    column.kind = ColumnKind::kIgnore;
+  } else {
+    if (katana::HasSuffix(spec, "[]")) {
+      column.is_array = true;
+      spec.resize(spec.size() - 2);
+    }
+    column.type = KATANA_CHECKED(ParseType(spec));
+  }
+  return column;
+}
+
+/// Split a line of CSV into its fields, removing quotes
+std::vector<std::string>
+SplitFields(const std::string& line, char delimiter) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (c == '"') {
+      if (quoted && i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back() += '"';
+        ++i;
+      } else {
+        quoted = !quoted;
+      }
+    } else if (c == delimiter && !quoted) {
+      fields.emplace_back();
+    } else {
+      fields.back() += c;
+    }
+  }
+  return fields;
+}
+
+katana::Result<std::string>
+ReadFirstLine(const std::string& filename) {
+  std::ifstream in(filename);
+  if (!in) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", filename);
+  }
+  std::string line;
+  std::getline(in, line);
+  if (!line.empty() && line.back() == '\r') {
+    line.pop_back();
+  }
+  return line;
+}
+
+katana::Result<Header>
+ReadHeader(
+    const katana::Neo4jCSVGroup& group, bool for_nodes,
+    const katana::Neo4jCSVOptions& opts) {
+  if (group.files.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "group without files");
+  }
+  const std::string& filename = group.files.front();
+  std::string line = KATANA_CHECKED(ReadFirstLine(filename));
+
+  Header header;
+  for (const std::string& field : SplitFields(line, opts.delimiter)) {
+    header.columns.emplace_back(KATANA_CHECKED(ParseColumn(field, opts)));
+  }
+
+  std::unordered_set<std::string> names;
+  for (size_t i = 0; i < header.columns.size(); ++i) {
+    const Column& column = header.columns[i];
+    int* index = nullptr;
+    switch (column.kind) {
+    case ColumnKind::kID:
+      index = for_nodes ? &header.id : nullptr;
+      break;
+    case ColumnKind::kStartID:
+      index = for_nodes ? nullptr : &header.start_id;
+      break;
+    case ColumnKind::kEndID:
+      index = for_nodes ? nullptr : &header.end_id;
+      break;
+    case ColumnKind::kLabel:
+      index = for_nodes ? &header.types : nullptr;
+      break;
+    case ColumnKind::kType:
+      index = for_nodes ? nullptr : &header.types;
+      break;
+    case ColumnKind::kIgnore:
+      continue;
+    case ColumnKind::kProperty:
+      if (!names.emplace(column.name).second) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "{}: repeated column {}",
+            filename, column.name);
+      }
+      continue;
+    }
+    if (index == nullptr || *index >= 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "{}: unexpected column {}",
+          filename, line);
+    }
+    *index = i;
+    if (column.kind == ColumnKind::kID && !column.name.empty() &&
+        !names.emplace(column.name).second) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "{}: repeated column {}",
+          filename, column.name);
+    }
+  }
+
+  if (!for_nodes && (header.start_id < 0 || header.end_id < 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{}: relationships need :START_ID and :END_ID columns", filename);
+  }
+  return header;
+}
+
+/// Read a file of a group, skipping its first line if it is the header;
+/// nullptr if there are no rows
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadFile(
+    const std::string& filename, const Header& header, bool skip_header,
+    const katana::Neo4jCSVOptions& opts) {
+  {
+    // the Arrow reader fails on files without data, like the header files
+    // of many imports
+    std::ifstream in(filename);
+    if (!in) {
+      return KATANA_ERROR(katana::ResultErrno(), "opening {}", filename);
+    }
+    std::string line;
+    if (skip_header) {
+      std::getline(in, line);
+    }
+    if (in.peek() == std::ifstream::traits_type::eof()) {
+      return std::shared_ptr<arrow::Table>();
+    }
+  }
+
+  auto read_opts = arrow::csv::ReadOptions::Defaults();
+  read_opts.use_threads = true;
+  read_opts.skip_rows = skip_header ? 1 : 0;
+
+  auto parse_opts = arrow::csv::ParseOptions::Defaults();
+  parse_opts.delimiter = opts.delimiter;
+
+  // fields left empty are missing, as in neo4j-admin, but quoted empty
+  // strings are not
+  auto convert_opts = arrow::csv::ConvertOptions::Defaults();
+  convert_opts.null_values = {""};
+  convert_opts.strings_can_be_null = true;
+  convert_opts.quoted_strings_can_be_null = false;
+
+  for (size_t i = 0; i < header.columns.size(); ++i) {
+    const Column& column = header.columns[i];
+    read_opts.column_names.emplace_back(ColumnName(i));
+    if (column.kind == ColumnKind::kIgnore) {
+      continue;
+    }
+    convert_opts.include_columns.emplace_back(ColumnName(i));
+    if (column.is_array) {
+      convert_opts.column_types[ColumnName(i)] = arrow::utf8();
+    } else if (column.type) {
+      convert_opts.column_types[ColumnName(i)] = column.type;
+    }
+  }
+
+  auto input = KATANA_CHECKED_CONTEXT(
+      arrow::io::ReadableFile::Open(filename), "opening {}", filename);
+  auto reader = KATANA_CHECKED_CONTEXT(
+      arrow::csv::TableReader::Make(
+          arrow::io::default_io_context(), input, read_opts, parse_opts,
+          convert_opts),
+      "reading {}", filename);
+  return KATANA_CHECKED_CONTEXT(reader->Read(), "reading {}", filename);
+}
+
+/// The type the columns of types can all be cast to: numbers are widened
+/// and anything else that differs is a string
+std::shared_ptr<arrow::DataType>
+MergeTypes(const std::vector<std::shared_ptr<arrow::DataType>>& types) {
+  std::shared_ptr<arrow::DataType> merged;
+  for (const auto& type : types) {
+    if (type->id() == arrow::Type::NA) {
+      continue;
+    }
+    if (!merged || merged->Equals(*type)) {
+      merged = type;
+    } else if (
+        arrow::is_integer(merged->id()) && arrow::is_integer(type->id())) {
+      merged = arrow::int64();
+    } else if (
+        arrow::is_numeric(merged->id()) && arrow::is_numeric(type->id())) {
+      merged = arrow::float64();
+    } else {
+      merged = arrow::utf8();
+    }
+  }
+  return merged ? merged : arrow::utf8();
+}
+
+/// Concatenate chunked arrays, casting them to their merged type
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+ConcatenateColumns(
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& columns) {
+  std::vector<std::shared_ptr<arrow::DataType>> types;
+  for (const auto& column : columns) {
+    types.emplace_back(column->type());
+  }
+  std::shared_ptr<arrow::DataType> type = MergeTypes(types);
+
+  arrow::ArrayVector chunks;
+  for (const auto& column : columns) {
+    for (const auto& chunk : column->chunks()) {
+      if (chunk->type()->Equals(*type)) {
+        chunks.emplace_back(chunk);
+      } else {
+        chunks.emplace_back(
+            KATANA_CHECKED(arrow::compute::Cast(*chunk, type)));
+      }
+    }
+  }
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, type));
+}
+
+/// Split the strings of an array column into lists of their type
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+SplitArrays(
+    const std::shared_ptr<arrow::ChunkedArray>& strings, const Column& column,
+    char array_delimiter) {
+  arrow::compute::SplitPatternOptions split_opts(
+      std::string(1, array_delimiter));
+  arrow::Datum lists = KATANA_CHECKED(arrow::compute::CallFunction(
+      "split_pattern", {strings}, &split_opts));
+  if (column.type->id() == arrow::Type::STRING) {
+    return lists.chunked_array();
+  }
+  arrow::Datum cast = KATANA_CHECKED(
+      arrow::compute::Cast(lists, arrow::list(column.type)));
+  return cast.chunked_array();
+}
+
+/// Read every file of every group, kMaxConcurrentFiles at a time
+katana::Result<std::vector<GroupTable>>
+ReadGroups(
+    const std::vector<katana::Neo4jCSVGroup>& groups, bool for_nodes,
+    const katana::Neo4jCSVOptions& opts) {
+  std::vector<GroupTable> tables(groups.size());
+  std::vector<std::pair<size_t, size_t>> files;
+  for (size_t g = 0; g < groups.size(); ++g) {
+    tables[g].header = KATANA_CHECKED(ReadHeader(groups[g], for_nodes, opts));
+    for (size_t f = 0; f < groups[g].files.size(); ++f) {
+      files.emplace_back(g, f);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Table>> read(files.size());
+  std::atomic<size_t> next_file{0};
+  std::vector<std::future<katana::CopyableResult<void>>> readers;
+  for (size_t r = 0; r < std::min(kMaxConcurrentFiles, files.size()); ++r) {
+    readers.emplace_back(
+        std::async(std::launch::async, [&]() -> katana::CopyableResult<void> {
+          for (size_t i; (i = next_file++) < files.size();) {
+            auto [g, f] = files[i];
+            read[i] = KATANA_CHECKED(ReadFile(
+                groups[g].files[f], tables[g].header, f == 0, opts));
+          }
+          return katana::CopyableResultSuccess();
+        }));
+  }
+  katana::CopyableResult<void> res = katana::CopyableResultSuccess();
+  for (auto& reader : readers) {
+    if (auto r = reader.get(); !r && res) {
+      res = r;
+    }
+  }
+  if (!res) {
+    return res.error();
+  }
+
+  for (size_t g = 0; g < groups.size(); ++g) {
+    GroupTable& table = tables[g];
+    const std::vector<Column>& columns = table.header.columns;
+    table.columns.resize(columns.size());
+    for (size_t c = 0; c < columns.size(); ++c) {
+      if (columns[c].kind == ColumnKind::kIgnore) {
+        continue;
+      }
+      std::vector<std::shared_ptr<arrow::ChunkedArray>> parts;
+      for (size_t i = 0; i < files.size(); ++i) {
+        if (files[i].first == g && read[i]) {
+          parts.emplace_back(read[i]->GetColumnByName(ColumnName(c)));
+        }
+      }
+      if (parts.empty()) {
+        auto type = columns[c].type ? columns[c].type : arrow::utf8();
+        parts.emplace_back(KATANA_CHECKED(arrow::ChunkedArray::Make(
+            {}, columns[c].is_array ? arrow::utf8() : type)));
+      }
+      table.columns[c] = KATANA_CHECKED(ConcatenateColumns(parts));
+      if (columns[c].is_array) {
+        table.columns[c] = KATANA_CHECKED(
+            SplitArrays(table.columns[c], columns[c], opts.array_delimiter));
+      }
+    }
+    for (const auto& column : table.columns) {
+      if (column) {
+        table.num_rows = column->length();
+        break;
+      }
+    }
+  }
+  return tables;
+}
+
+/// Call fn(row, value) for the values of a string column that are not
+/// null, in parallel a chunk at a time
+template <typename Fn>
+void
+ForEachString(const arrow::ChunkedArray& column, const Fn& fn) {
+  std::vector<int64_t> offsets{0};
+  for (const auto& chunk : column.chunks()) {
+    offsets.emplace_back(offsets.back() + chunk->length());
+  }
+  katana::do_all(
+      katana::iterate(0, column.num_chunks()),
+      [&](int c) {
+        const auto& strings =
+            static_cast<const arrow::StringArray&>(*column.chunk(c));
+        for (int64_t i = 0; i < strings.length(); ++i) {
+          if (strings.IsValid(i)) {
+            auto value = strings.GetView(i);
+            fn(offsets[c] + i, std::string_view(value.data(), value.size()));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// The nodes of the IDs of an ID space, in shards by hash of ID so that
+/// the threads build the shards in parallel without locks
+class IDMap {
+public:
+  struct Entry {
+    std::string_view id;
+    Node node;
+  };
+
+  /// Add the entries with a node, which must not be added already
+  katana::Result<void> Build(const std::vector<Entry>& entries) {
+    // the entries, by thread, by shard
+    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>> buckets;
+    katana::do_all(
+        katana::iterate(size_t{0}, entries.size()),
+        [&](size_t i) {
+          if (entries[i].node == kMissingNode) {
+            return;
+          }
+          auto& local = *buckets.getLocal();
+          if (local.empty()) {
+            local.resize(kNumShards);
+          }
+          local[ShardOf(entries[i].id)].emplace_back(i);
+        },
+        katana::steal(), katana::no_stats());
+
+    std::vector<int64_t> duplicates(kNumShards, -1);
+    katana::do_all(
+        katana::iterate(size_t{0}, kNumShards),
+        [&](size_t s) {
+          size_t count = 0;
+          for (unsigned t = 0; t < buckets.size(); ++t) {
+            const auto& local = *buckets.getRemote(t);
+            count += local.empty() ? 0 : local[s].size();
+          }
+          shards_[s].reserve(shards_[s].size() + count);
+          for (unsigned t = 0; t < buckets.size(); ++t) {
+            const auto& local = *buckets.getRemote(t);
+            if (local.empty()) {
+              continue;
+            }
+            for (uint32_t i : local[s]) {
+              if (!shards_[s].emplace(entries[i].id, entries[i].node).second) {
+                duplicates[s] = i;
+              }
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    for (int64_t i : duplicates) {
+      if (i >= 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "repeated ID {}",
+            entries[i].id);
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// The node of id, or kMissingNode
+  Node Find(std::string_view id) const {
+    const auto& shard = shards_[ShardOf(id)];
+    auto it = shard.find(id);
+    return it == shard.end() ? kMissingNode : it->second;
+  }
+
+private:
+  static constexpr size_t kNumShards = 1024;
+
+  static size_t ShardOf(std::string_view id) {
+    // the high bits, so that the buckets of a shard see the low bits of the
+    // hashes of its IDs vary
+    uint64_t hash = std::hash<std::string_view>{}(id);
+    return (hash >> 32) % kNumShards;
+  }
+
+  std::vector<std::unordered_map<std::string_view, Node>> shards_{kNumShards};
+};
+
+using IDMaps = std::unordered_map<std::string, IDMap>;
+
+katana::Result<IDMaps>
+BuildIDMaps(const std::vector<GroupTable>& node_tables) {
+  std::unordered_map<std::string, std::vector<IDMap::Entry>> entries;
+  Node first_node = 0;
+  for (const GroupTable& table : node_tables) {
+    if (table.header.id >= 0) {
+      const auto& column = table.columns[table.header.id];
+      auto& space = entries[table.header.columns[table.header.id].id_space];
+      size_t first_entry = space.size();
+      // nodes without an ID cannot be referred to
+      space.resize(
+          first_entry + column->length(), IDMap::Entry{{}, kMissingNode});
+      ForEachString(*column, [&](int64_t row, std::string_view id) {
+        space[first_entry + row] = IDMap::Entry{id, Node(first_node + row)};
+      });
+    }
+    first_node += table.num_rows;
+  }
+
+  IDMaps maps;
+  for (const auto& [space, space_entries] : entries) {
+    KATANA_CHECKED_CONTEXT(
+        maps[space].Build(space_entries), "in ID space {}",
+        space.empty() ? "(global)" : space);
+  }
+  return maps;
+}
+
+/// Set the types of the rows [first, first + table.num_rows) of types from
+/// the :LABEL or :TYPE column of table and the labels of its group: a node
+/// has the labels of its group as well as its own, while a relationship
+/// has the type of its group only if it has none of its own
+katana::Result<void>
+AssignTypes(
+    const GroupTable& table, const std::vector<std::string>& group_labels,
+    std::optional<char> label_delimiter, uint64_t first,
+    katana::EntityTypeManager* manager, EntityTypeIDArray* types) {
+  auto type_of =
+      [&](std::string_view value) -> katana::Result<katana::EntityTypeID> {
+    std::vector<std::string> names;
+    if (label_delimiter) {
+      names.assign(group_labels.begin(), group_labels.end());
+      for (std::string_view label : katana::SplitView(
+               value, std::string_view(&label_delimiter.value(), 1))) {
+        names.emplace_back(label);
+      }
+    } else if (!value.empty()) {
+      names.emplace_back(value);
+    } else {
+      names.assign(group_labels.begin(), group_labels.end());
+    }
+    names.erase(
+        std::remove(names.begin(), names.end(), std::string()), names.end());
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    if (names.empty()) {
+      return katana::kUnknownEntityType;
+    }
+    return manager->GetOrAddNonAtomicEntityTypeFromStrings(names);
+  };
+
+  katana::EntityTypeID default_type = KATANA_CHECKED(type_of(""));
+  katana::do_all(
+      katana::iterate(first, first + table.num_rows),
+      [&](uint64_t i) { (*types)[i] = default_type; }, katana::no_stats());
+  if (table.header.types < 0) {
+    return katana::ResultSuccess();
+  }
+  const arrow::ChunkedArray& column = *table.columns[table.header.types];
+
+  katana::PerThreadStorage<std::unordered_set<std::string_view>> local_values;
+  ForEachString(column, [&](int64_t, std::string_view value) {
+    local_values.getLocal()->emplace(value);
+  });
+  // each distinct value is a type, added in sorted order so that the types
+  // do not depend on the order the threads see them in
+  std::vector<std::string_view> values;
+  for (unsigned t = 0; t < local_values.size(); ++t) {
+    const auto& local = *local_values.getRemote(t);
+    values.insert(values.end(), local.begin(), local.end());
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+
+  std::unordered_map<std::string_view, katana::EntityTypeID> ids;
+  for (std::string_view value : values) {
+    ids.emplace(value, KATANA_CHECKED(type_of(value)));
+  }
+  ForEachString(column, [&](int64_t row, std::string_view value) {
+    (*types)[first + row] = ids.at(value);
+  });
+  return katana::ResultSuccess();
+}
+
+/// The properties of the groups, a column per property of any of them, with
+/// the rows of the groups that lack it null
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildProperties(const std::vector<GroupTable>& tables) {
+  std::vector<std::string> names;
+  std::unordered_map<
+      std::string, std::vector<std::shared_ptr<arrow::ChunkedArray>>>
+      columns;
+  int64_t num_rows = 0;
+  for (size_t g = 0; g < tables.size(); ++g) {
+    const std::vector<Column>& header = tables[g].header.columns;
+    for (size_t c = 0; c < header.size(); ++c) {
+      bool is_property = header[c].kind == ColumnKind::kProperty ||
+                         (header[c].kind == ColumnKind::kID &&
+                          !header[c].name.empty());
+      if (!is_property) {
+        continue;
+      }
+      auto& by_group = columns[header[c].name];
+      if (by_group.empty()) {
+        names.emplace_back(header[c].name);
+        by_group.resize(tables.size());
+      }
+      by_group[g] = tables[g].columns[c];
+    }
+    num_rows += tables[g].num_rows;
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields(names.size());
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> properties(names.size());
+  std::vector<katana::CopyableResult<void>> results(
+      names.size(), katana::CopyableResultSuccess());
+  katana::do_all(
+      katana::iterate(size_t{0}, names.size()),
+      [&](size_t p) {
+        results[p] = [&]() -> katana::CopyableResult<void> {
+          const auto& by_group = columns.at(names[p]);
+          std::vector<std::shared_ptr<arrow::DataType>> types;
+          for (const auto& column : by_group) {
+            if (column) {
+              types.emplace_back(column->type());
+            }
+          }
+          std::shared_ptr<arrow::DataType> type = MergeTypes(types);
+
+          std::vector<std::shared_ptr<arrow::ChunkedArray>> parts;
+          for (size_t g = 0; g < tables.size(); ++g) {
+            if (by_group[g]) {
+              parts.emplace_back(by_group[g]);
+            } else if (tables[g].num_rows > 0) {
+              parts.emplace_back(std::make_shared<arrow::ChunkedArray>(
+                  KATANA_CHECKED(
+                      arrow::MakeArrayOfNull(type, tables[g].num_rows))));
+            }
+          }
+          if (parts.empty()) {
+            parts.emplace_back(
+                KATANA_CHECKED(arrow::ChunkedArray::Make({}, type)));
+          }
+          properties[p] = KATANA_CHECKED(ConcatenateColumns(parts));
+          fields[p] = arrow::field(names[p], properties[p]->type());
+          return katana::CopyableResultSuccess();
+        }();
+      },
+      katana::steal(), katana::no_stats());
+  for (size_t p = 0; p < names.size(); ++p) {
+    if (!results[p]) {
+      return results[p].error().WithContext("property {}", names[p]);
+    }
+  }
+  return arrow::Table::Make(arrow::schema(fields), properties, num_rows);
+}
+
+/// The rows of table, in parallel a column at a time
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const katana::NUMAArray<uint64_t>& rows) {
+  auto indices = std::make_shared<arrow::UInt64Array>(
+      rows.size(), arrow::Buffer::Wrap(rows.data(), rows.size()));
+  std::vector<arrow::Result<arrow::Datum>> taken(table->num_columns());
+  katana::do_all(
+      katana::iterate(0, table->num_columns()),
+      [&](int i) {
+        taken[i] = arrow::compute::Take(
+            arrow::Datum(table->column(i)), arrow::Datum(indices));
+      },
+      katana::steal(), katana::no_stats());
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (auto& column : taken) {
+    columns.emplace_back(KATANA_CHECKED(std::move(column)).chunked_array());
+  }
+  return arrow::Table::Make(table->schema(), columns, rows.size());
+}
+
+}  // namespace
+
+katana::Result<katana::Neo4jCSVGroup>
+katana::Neo4jCSVGroup::Parse(const std::string& spec, const std::string& dir) {
+  Neo4jCSVGroup group;
+  std::string files = spec;
+  if (size_t equals = spec.find('='); equals != std::string::npos) {
+    for (std::string_view label :
+         katana::SplitView(std::string_view(spec).substr(0, equals), ":")) {
+      if (!label.empty()) {
+        group.labels.emplace_back(label);
+      }
+    }
+    files = spec.substr(equals + 1);
+  }
+  for (std::string_view file : katana::SplitView(files, ",")) {
+    if (file.empty()) {
+      continue;
+    }
+    std::filesystem::path path(file);
+    group.files.emplace_back(
+        path.is_absolute() ? path.string()
+                           : (std::filesystem::path(dir) / path).string());
+  }
+  if (group.files.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no files in {}", spec);
+  }
+  return group;
+}
+
+katana::Result<void>
+katana::FindNeo4jCSVGroups(
+    const std::string& dir, std::vector<Neo4jCSVGroup>* node_groups,
+    std::vector<Neo4jCSVGroup>* relationship_groups) {
+  std::vector<std::string> files;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+      files.emplace_back(entry.path().string());
+    }
+  }
+  if (ec) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "listing {}: {}", dir,
+        ec.message());
+  }
+  std::sort(files.begin(), files.end());
+
+  for (const std::string& file : files) {
+    std::string header = KATANA_CHECKED(ReadFirstLine(file));
+    Neo4jCSVGroup group;
+    group.files.emplace_back(file);
+    if (header.find(":START_ID") == std::string::npos) {
+      node_groups->emplace_back(std::move(group));
+    } else {
+      relationship_groups->emplace_back(std::move(group));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::ImportNeo4jCSV(
+    const std::vector<Neo4jCSVGroup>& node_groups,
+    const std::vector<Neo4jCSVGroup>& relationship_groups,
+    const Neo4jCSVOptions& opts, katana::TxnContext* txn_ctx) {
+  std::vector<GroupTable> node_tables =
+      KATANA_CHECKED(ReadGroups(node_groups, true, opts));
+  std::vector<GroupTable> relationship_tables =
+      KATANA_CHECKED(ReadGroups(relationship_groups, false, opts));
+
+  uint64_t num_nodes = 0;
+  for (const GroupTable& table : node_tables) {
+    num_nodes += table.num_rows;
+  }
+  if (num_nodes >= kMissingNode) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "too many nodes: {}", num_nodes);
+  }
+  uint64_t num_relationships = 0;
+  for (const GroupTable& table : relationship_tables) {
+    num_relationships += table.num_rows;
+  }
+
+  IDMaps id_maps = KATANA_CHECKED(BuildIDMaps(node_tables));
+
+  katana::EntityTypeManager node_type_manager;
+  EntityTypeIDArray node_types;
+  node_types.allocateBlocked(num_nodes);
+  uint64_t first = 0;
+  for (size_t g = 0; g < node_tables.size(); ++g) {
+    KATANA_CHECKED(AssignTypes(
+        node_tables[g], node_groups[g].labels, opts.array_delimiter, first,
+        &node_type_manager, &node_types));
+    first += node_tables[g].num_rows;
+  }
+
+  // the ends and types of the relationships in the order of the files
+  katana::EntityTypeManager edge_type_manager;
+  EntityTypeIDArray relationship_types;
+  relationship_types.allocateBlocked(num_relationships);
+  katana::NUMAArray<Node> sources;
+  katana::NUMAArray<Node> destinations;
+  sources.allocateBlocked(num_relationships);
+  destinations.allocateBlocked(num_relationships);
+  katana::ParallelSTL::fill(sources.begin(), sources.end(), kMissingNode);
+  katana::ParallelSTL::fill(
+      destinations.begin(), destinations.end(), kMissingNode);
+  first = 0;
+  for (size_t g = 0; g < relationship_tables.size(); ++g) {
+    const GroupTable& table = relationship_tables[g];
+    KATANA_CHECKED(AssignTypes(
+        table, relationship_groups[g].labels, std::nullopt, first,
+        &edge_type_manager, &relationship_types));
+    for (auto [column, ends] :
+         {std::make_pair(table.header.start_id, &sources),
+          std::make_pair(table.header.end_id, &destinations)}) {
+      auto it = id_maps.find(table.header.columns[column].id_space);
+      if (it == id_maps.end()) {
+        continue;
+      }
+      const IDMap& map = it->second;
+      ForEachString(
+          *table.columns[column], [&](int64_t row, std::string_view id) {
+            (*ends)[first + row] = map.Find(id);
+          });
+    }
+    first += table.num_rows;
+  }
+
+  katana::GAccumulator<uint64_t> bad_relationships;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_relationships),
+      [&](uint64_t r) {
+        if (sources[r] == kMissingNode || destinations[r] == kMissingNode) {
+          sources[r] = kMissingNode;
+          bad_relationships += 1;
+        }
+      },
+      katana::no_stats());
+  if (bad_relationships.reduce() > 0) {
+    if (!opts.skip_bad_relationships) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "{} relationships refer to nodes that are not imported",
+          bad_relationships.reduce());
+    }
+    KATANA_LOG_WARN(
+        "skipping {} relationships that refer to nodes that are not "
+        "imported",
+        bad_relationships.reduce());
+  }
+
+  // a counting sort of the relationships by source, keeping the order of
+  // the files among the relationships of a node
+  katana::NUMAArray<std::atomic<uint64_t>> cursors;
+  cursors.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_relationships),
+      [&](uint64_t r) {
+        if (sources[r] != kMissingNode) {
+          cursors[sources[r]].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
+  katana::GraphTopology::AdjIndexVec out_indices;
+  out_indices.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { out_indices[n] = cursors[n].load(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  uint64_t num_edges = num_nodes == 0 ? 0 : out_indices[num_nodes - 1];
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        cursors[n].store(out_indices[n] - cursors[n].load());
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<uint64_t> relationship_of_edge;
+  relationship_of_edge.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_relationships),
+      [&](uint64_t r) {
+        if (sources[r] != kMissingNode) {
+          relationship_of_edge[cursors[sources[r]].fetch_add(1)] = r;
+        }
+      },
+      katana::no_stats());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateBlocked(num_edges);
+  EntityTypeIDArray edge_types;
+  edge_types.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n == 0 ? 0 : out_indices[n - 1];
+        uint64_t end = out_indices[n];
+        std::sort(
+            relationship_of_edge.begin() + begin,
+            relationship_of_edge.begin() + end);
+        for (uint64_t e = begin; e < end; ++e) {
+          dests[e] = destinations[relationship_of_edge[e]];
+          edge_types[e] = relationship_types[relationship_of_edge[e]];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::shared_ptr<arrow::Table> node_properties =
+      KATANA_CHECKED(BuildProperties(node_tables));
+  std::shared_ptr<arrow::Table> edge_properties = KATANA_CHECKED(TakeRows(
+      KATANA_CHECKED(BuildProperties(relationship_tables)),
+      relationship_of_edge));
+
+  auto graph = KATANA_CHECKED(katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(out_indices), std::move(dests)),
+      std::move(node_types), std::move(edge_types),
+      std::move(node_type_manager), std::move(edge_type_manager)));
+  if (node_properties->num_columns() > 0) {
+    KATANA_CHECKED_CONTEXT(
+        graph->AddNodeProperties(node_properties, txn_ctx),
+        "adding node properties");
+  }
+  if (edge_properties->num_columns() > 0) {
+    KATANA_CHECKED_CONTEXT(
+        graph->AddEdgeProperties(edge_properties, txn_ctx),
+        "adding edge properties");
+  }
+  return std::unique_ptr<katana::PropertyGraph>(std::move(graph));
+}
@@ -0,0 +1,63 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_NEO4J_CSV_H_
+#define KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_NEO4J_CSV_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+
+namespace katana {
+
+/// A group of files in the format of neo4j-admin import: the first line of
+/// the first file is the header of the group, e.g.,
+/// `personId:ID(Person),name,born:int,:LABEL` for nodes or
+/// `:START_ID(Person),roles:string[],:END_ID(Movie),:TYPE` for
+/// relationships, and the other files continue the first without a header.
+struct Neo4jCSVGroup {
+  /// Labels of every node of the group, or the type of every relationship
+  /// of it that has none of its own
+  std::vector<std::string> labels;
+  std::vector<std::string> files;
+
+  /// Parse a group like the arguments of neo4j-admin import --nodes and
+  /// --relationships, `[Label1:Label2=]file1,file2,...`, with relative
+  /// files relative to dir
+  static Result<Neo4jCSVGroup> Parse(
+      const std::string& spec, const std::string& dir);
+};
+
+struct Neo4jCSVOptions {
+  char delimiter{','};
+  /// Separates the elements of array properties and the labels of a node
+  char array_delimiter{';'};
+  /// Infer the types of untyped columns from their values, rather than
+  /// read them as strings like neo4j-admin does
+  bool infer_types{false};
+  /// Drop relationships with an end that is not a node of the import,
+  /// rather than fail
+  bool skip_bad_relationships{false};
+};
+
+/// Make the groups of the .csv files of dir, each a group by itself, with
+/// the files of which the header has a :START_ID column relationships
+Result<void> FindNeo4jCSVGroups(
+    const std::string& dir, std::vector<Neo4jCSVGroup>* node_groups,
+    std::vector<Neo4jCSVGroup>* relationship_groups);
+
+/// Import a graph from Neo4j bulk import files. The nodes are numbered in
+/// the order of node_groups and their rows, node labels and relationship
+/// types become entity types, and the other columns properties of the type
+/// in their header. The files are read concurrently, each by the threaded
+/// Arrow CSV reader, and the IDs that relationships refer to nodes by are
+/// resolved in parallel through a hash map per ID space, sharded so that
+/// it is built without locks.
+Result<std::unique_ptr<PropertyGraph>> ImportNeo4jCSV(
+    const std::vector<Neo4jCSVGroup>& node_groups,
+    const std::vector<Neo4jCSVGroup>& relationship_groups,
+    const Neo4jCSVOptions& opts, katana::TxnContext* txn_ctx);
+
+}  // end namespace katana
+
+#endif
@@ -0,0 +1,52 @@
+#include <memory>
+#include <string>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> expected_filename(
+    cll::Positional, cll::desc("<expected graph>"), cll::Required);
+static cll::opt<std::string> found_filename(
+    cll::Positional, cll::desc("<found graph>"), cll::Required);
+
+namespace {
+
+std::unique_ptr<katana::PropertyGraph>
+Load(const std::string& rdg_dir) {
+  katana::TxnContext txn_ctx;
+  auto pg_res =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!pg_res) {
+    KATANA_LOG_FATAL("loading {}: {}", rdg_dir, pg_res.error());
+  }
+  return std::move(pg_res.value());
+}
+
+}  // namespace
+
+/// Checks that two graphs, e.g., the same edge list converted by two
+/// routes, have the same topology and properties
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  auto expected = Load(expected_filename);
+  auto found = Load(found_filename);
+  KATANA_LOG_VASSERT(
+      found->NumNodes() == expected->NumNodes(), "{} nodes, expected {}",
+      found->NumNodes(), expected->NumNodes());
+  KATANA_LOG_VASSERT(
+      found->NumEdges() == expected->NumEdges(), "{} edges, expected {}",
+      found->NumEdges(), expected->NumEdges());
+  KATANA_LOG_VASSERT(
+      found->Equals(expected.get()), "{} differs from {}",
+      std::string(found_filename), std::string(expected_filename));
+
+  return 0;
+}
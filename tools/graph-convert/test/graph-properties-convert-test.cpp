@@ -1,8 +1,10 @@
 #include <iostream>
 #include <memory>
 
+#include <libxml/xmlreader.h>
 #include <llvm/Support/CommandLine.h>
 
+#include "katana/Galois.h"
 #include "katana/GraphML.h"
 #include "katana/Logging.h"
 #include "katana/SharedMemSys.h"
@@ -43,6 +45,11 @@ static cll::opt<ConvertTest> test_type(
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<size_t> chunk_budget(
+    "chunkBudget", cll::desc("Bytes of the graph each thread parses at a time"),
+    cll::init(64 << 20));
+static cll::opt<int> num_threads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
 
 namespace {
 
@@ -67,6 +74,31 @@ CheckTopology(
   KATANA_LOG_ASSERT(dests->ToString() == dests_expected);
 }
 
+/// Checks that the parallel conversion of the input file is what the
+/// sequential conversion with a reader gives
+void
+CheckSameAsSequential(const katana::GraphComponents& graph) {
+  xmlTextReaderPtr reader = xmlNewTextReaderFilename(input_filename.c_str());
+  KATANA_LOG_ASSERT(reader != nullptr);
+  auto res = katana::ConvertGraphML(reader, chunk_size);
+  xmlFreeTextReader(reader);
+  KATANA_LOG_VASSERT(res, "sequential conversion: {}", res.error());
+  const katana::GraphComponents& expected = res.value();
+
+  KATANA_LOG_ASSERT(graph.nodes.properties->Equals(*expected.nodes.properties));
+  KATANA_LOG_ASSERT(graph.nodes.labels->Equals(*expected.nodes.labels));
+  KATANA_LOG_ASSERT(graph.edges.properties->Equals(*expected.edges.properties));
+  KATANA_LOG_ASSERT(graph.edges.labels->Equals(*expected.edges.labels));
+  CheckTopology(
+      graph,
+      katana::ProjectAsArrowArray(
+          expected.topology.AdjData(), expected.topology.NumNodes())
+          ->ToString(),
+      katana::ProjectAsArrowArray(
+          expected.topology.DestData(), expected.topology.NumEdges())
+          ->ToString());
+}
+
 void
 VerifyMovieSet(const katana::GraphComponents& graph) {
   KATANA_LOG_ASSERT(graph.nodes.properties->num_columns() == 5);
@@ -1267,16 +1299,20 @@ int
 main(int argc, char** argv) {
   katana::SharedMemSys sys;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(num_threads);
 
   katana::GraphComponents graph;
 
   switch (fileType) {
   case katana::SourceDatabase::kNeo4j:
-    if (auto r = katana::ConvertGraphML(input_filename, chunk_size, true); !r) {
+    if (auto r = katana::ConvertGraphML(
+            input_filename, chunk_size, true, chunk_budget);
+        !r) {
       KATANA_LOG_FATAL(": {}", r.error());
     } else {
       graph = std::move(r.value());
     }
+    CheckSameAsSequential(graph);
     break;
 #if defined(KATANA_MONGOC_FOUND)
   case katana::SourceDatabase::kMongodb:
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ImportPipeline.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// A record, the source and the index of its batch in the source
+using Record = std::pair<size_t, size_t>;
+using Batch = std::vector<Record>;
+
+size_t
+NumBatches(size_t source) {
+  // source 3, and every seventh after it, has nothing
+  return (source % 7 == 3) ? 0 : source % 5 + 1;
+}
+
+void
+CheckPipeline(size_t num_sources, size_t num_fetchers, size_t max_batches) {
+  katana::ImportPipeline<Batch> pipeline(
+      num_sources, num_fetchers, max_batches);
+  // the pipeline starts at least one fetcher and at most one per source
+  size_t expected_fetchers =
+      std::max<size_t>(std::min(num_fetchers, num_sources), 1);
+
+  auto emitted = std::make_unique<std::atomic<size_t>[]>(num_sources);
+  auto consumed = std::make_unique<std::atomic<size_t>[]>(num_sources);
+  std::atomic<size_t> fetching{0};
+  std::atomic<size_t> max_fetching{0};
+  std::atomic<bool> valid_fetcher{true};
+  std::atomic<bool> bounded{true};
+
+  std::thread::id caller = std::this_thread::get_id();
+  std::vector<Record> records;
+  pipeline.Run(
+      [&](size_t source, size_t fetcher, const auto& emit) {
+        if (fetcher >= expected_fetchers) {
+          valid_fetcher = false;
+        }
+        size_t now = ++fetching;
+        size_t seen = max_fetching.load();
+        while (now > seen && !max_fetching.compare_exchange_weak(seen, now)) {
+        }
+        for (size_t b = 0; b < NumBatches(source); ++b) {
+          emit(Batch{{source, b}, {source, b}});
+          // emitted batches are queued, except the one being consumed
+          size_t queued = ++emitted[source] - consumed[source].load();
+          if (queued > max_batches + 1) {
+            bounded = false;
+          }
+        }
+        --fetching;
+      },
+      [&](size_t source, Batch&& batch) {
+        ++consumed[source];
+        KATANA_LOG_ASSERT(std::this_thread::get_id() == caller);
+        // slower than fetching, so that fetchers wait for room
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        KATANA_LOG_ASSERT(batch.size() == 2);
+        KATANA_LOG_ASSERT(batch[0].first == source);
+        records.emplace_back(batch[0]);
+      });
+
+  std::vector<Record> expected;
+  for (size_t s = 0; s < num_sources; ++s) {
+    for (size_t b = 0; b < NumBatches(s); ++b) {
+      expected.emplace_back(s, b);
+    }
+  }
+  KATANA_LOG_ASSERT(records == expected);
+  KATANA_LOG_ASSERT(valid_fetcher);
+  KATANA_LOG_ASSERT(bounded);
+  KATANA_LOG_VASSERT(
+      max_fetching <= expected_fetchers,
+      "{} sources fetched at once by {} fetchers", max_fetching.load(),
+      num_fetchers);
+}
+
+}  // namespace
+
+int
+main() {
+  CheckPipeline(40, 4, 2);
+  // one batch at a time
+  CheckPipeline(11, 3, 1);
+  // more fetchers than sources, and none at all
+  CheckPipeline(3, 8, 4);
+  CheckPipeline(5, 0, 2);
+  CheckPipeline(0, 4, 2);
+
+  return 0;
+}
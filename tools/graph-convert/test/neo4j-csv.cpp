@@ -0,0 +1,195 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "graph-properties-convert-neo4j-csv.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+void
+WriteFile(const std::string& filename, const std::string& contents) {
+  std::ofstream out(filename);
+  out << contents;
+  KATANA_LOG_ASSERT(out);
+}
+
+/// The movies and people of the Matrix, with the header of the movies in a
+/// file by itself like neo4j-admin exports write them, and a relationship
+/// to a movie that is not imported
+std::string
+WriteImport() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/neo4jcsv");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir = uri_res.value().path();
+  std::filesystem::create_directories(dir);
+
+  WriteFile(
+      dir + "/movies-header.csv", "movieId:ID(Movie),title,year:int,:LABEL\n");
+  WriteFile(
+      dir + "/movies.csv",
+      "tt0133093,\"The Matrix\",1999,Movie\n"
+      "tt0234215,\"The Matrix Reloaded\",2003,Movie;Sequel\n");
+  WriteFile(
+      dir + "/people.csv",
+      "personId:ID(Person),name,born:long\n"
+      "keanu,Keanu Reeves,1964\n"
+      "laurence,Laurence Fishburne,\n"
+      "\"carrie\",\"Carrie-Anne Moss\",1967\n");
+  WriteFile(
+      dir + "/roles.csv",
+      ":START_ID(Person),roles:string[],:END_ID(Movie),:TYPE\n"
+      "keanu,Neo,tt0234215,ACTED_IN\n"
+      "keanu,Neo,tt0133093,ACTED_IN\n"
+      "laurence,Morpheus,tt0133093,ACTED_IN\n"
+      "carrie,Trinity;The One,tt0234215,\n"
+      "laurence,Morpheus,tt9999999,ACTED_IN\n");
+  WriteFile(
+      dir + "/sequels.csv",
+      ":START_ID(Movie),:END_ID(Movie)\n"
+      "tt0234215,tt0133093\n");
+  return dir;
+}
+
+std::vector<katana::Neo4jCSVGroup>
+ParseGroups(const std::vector<std::string>& specs, const std::string& dir) {
+  std::vector<katana::Neo4jCSVGroup> groups;
+  for (const std::string& spec : specs) {
+    auto res = katana::Neo4jCSVGroup::Parse(spec, dir);
+    KATANA_LOG_VASSERT(res, "parsing {}: {}", spec, res.error());
+    groups.emplace_back(std::move(res.value()));
+  }
+  return groups;
+}
+
+std::string
+ValueOf(const std::shared_ptr<arrow::ChunkedArray>& column, int64_t i) {
+  auto res = column->GetScalar(i);
+  KATANA_LOG_ASSERT(res.ok());
+  return res.ValueOrDie()->is_valid ? res.ValueOrDie()->ToString() : "null";
+}
+
+void
+TestImport(const std::string& dir) {
+  auto nodes =
+      ParseGroups({"movies-header.csv,movies.csv", "Actor=people.csv"}, dir);
+  auto relationships =
+      ParseGroups({"ACTED_IN=roles.csv", "SEQUEL_OF=sequels.csv"}, dir);
+
+  katana::Neo4jCSVOptions opts;
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      !katana::ImportNeo4jCSV(nodes, relationships, opts, &txn_ctx));
+
+  opts.skip_bad_relationships = true;
+  auto res = katana::ImportNeo4jCSV(nodes, relationships, opts, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "importing: {}", res.error());
+  std::unique_ptr<katana::PropertyGraph> graph = std::move(res.value());
+
+  // the movies, then keanu, laurence and carrie
+  KATANA_LOG_ASSERT(graph->NumNodes() == 5);
+  KATANA_LOG_ASSERT(graph->NumEdges() == 5);
+  const katana::GraphTopology& topo = graph->topology();
+  std::vector<std::vector<uint32_t>> expected{{}, {0}, {1, 0}, {0}, {1}};
+  for (uint32_t n = 0; n < expected.size(); ++n) {
+    std::vector<uint32_t> dests;
+    for (auto e : topo.OutEdges(n)) {
+      dests.emplace_back(topo.OutEdgeDst(e));
+    }
+    KATANA_LOG_VASSERT(dests == expected[n], "edges of node {}", n);
+  }
+
+  auto movie = graph->GetNodeEntityTypeID("Movie");
+  auto sequel = graph->GetNodeEntityTypeID("Sequel");
+  auto actor = graph->GetNodeEntityTypeID("Actor");
+  KATANA_LOG_ASSERT(graph->DoesNodeHaveType(0, movie));
+  KATANA_LOG_ASSERT(!graph->DoesNodeHaveType(0, sequel));
+  KATANA_LOG_ASSERT(graph->DoesNodeHaveType(1, movie));
+  KATANA_LOG_ASSERT(graph->DoesNodeHaveType(1, sequel));
+  for (uint32_t n = 2; n < 5; ++n) {
+    KATANA_LOG_ASSERT(graph->GetTypeOfNode(n) == actor);
+  }
+
+  auto acted_in = graph->GetEdgeEntityTypeID("ACTED_IN");
+  auto sequel_of = graph->GetEdgeEntityTypeID("SEQUEL_OF");
+  KATANA_LOG_ASSERT(graph->GetTypeOfEdgeFromTopoIndex(0) == sequel_of);
+  for (uint64_t e = 1; e < 5; ++e) {
+    KATANA_LOG_ASSERT(graph->GetTypeOfEdgeFromTopoIndex(e) == acted_in);
+  }
+
+  auto year = graph->GetNodeProperty("year");
+  KATANA_LOG_ASSERT(year);
+  KATANA_LOG_ASSERT(year.value()->type()->Equals(arrow::int32()));
+  KATANA_LOG_ASSERT(ValueOf(year.value(), 1) == "2003");
+  KATANA_LOG_ASSERT(ValueOf(year.value(), 2) == "null");
+
+  auto born = graph->GetNodeProperty("born");
+  KATANA_LOG_ASSERT(born);
+  KATANA_LOG_ASSERT(born.value()->type()->Equals(arrow::int64()));
+  KATANA_LOG_ASSERT(ValueOf(born.value(), 0) == "null");
+  KATANA_LOG_ASSERT(ValueOf(born.value(), 3) == "null");
+  KATANA_LOG_ASSERT(ValueOf(born.value(), 4) == "1967");
+
+  auto title = graph->GetNodeProperty("title");
+  KATANA_LOG_ASSERT(title);
+  KATANA_LOG_ASSERT(ValueOf(title.value(), 0) == "The Matrix");
+  auto person_id = graph->GetNodeProperty("personId");
+  KATANA_LOG_ASSERT(person_id);
+  KATANA_LOG_ASSERT(ValueOf(person_id.value(), 4) == "carrie");
+
+  // the roles are in the order of the edges, which is by source
+  auto roles = graph->GetEdgeProperty("roles");
+  KATANA_LOG_ASSERT(roles);
+  KATANA_LOG_ASSERT(
+      roles.value()->type()->Equals(arrow::list(arrow::utf8())));
+  KATANA_LOG_ASSERT(ValueOf(roles.value(), 0) == "null");
+  auto trinity = roles.value()->GetScalar(4);
+  KATANA_LOG_ASSERT(trinity.ok());
+  KATANA_LOG_ASSERT(
+      static_cast<const arrow::ListScalar&>(*trinity.ValueOrDie())
+          .value->length() == 2);
+}
+
+void
+TestInferTypes(const std::string& dir) {
+  WriteFile(
+      dir + "/inferred.csv",
+      ":ID,count,ratio,name\n"
+      "a,1,0.5,x\n"
+      "b,2,1,y\n");
+  std::vector<katana::Neo4jCSVGroup> nodes = ParseGroups({"inferred.csv"}, dir);
+  std::vector<katana::Neo4jCSVGroup> relationships;
+
+  katana::Neo4jCSVOptions opts;
+  opts.infer_types = true;
+  katana::TxnContext txn_ctx;
+  auto res = katana::ImportNeo4jCSV(nodes, relationships, opts, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "importing: {}", res.error());
+  std::unique_ptr<katana::PropertyGraph> graph = std::move(res.value());
+  KATANA_LOG_ASSERT(graph->NumNodes() == 2);
+  KATANA_LOG_ASSERT(graph->GetNodeProperty("count").value()->type()->Equals(
+      arrow::int64()));
+  KATANA_LOG_ASSERT(graph->GetNodeProperty("ratio").value()->type()->Equals(
+      arrow::float64()));
+  KATANA_LOG_ASSERT(graph->GetNodeProperty("name").value()->type()->Equals(
+      arrow::utf8()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  std::string dir = WriteImport();
+  TestImport(dir);
+  TestInferTypes(dir);
+  std::filesystem::remove_all(dir);
+
+  return 0;
+}
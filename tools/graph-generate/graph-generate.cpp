@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/TopologyGeneration.h"
+#include "llvm/Support/CommandLine.h"
+
+/* usage: ./graph-generate -model=<model> [options] <output rdg>
+ *
+ * generates a synthetic graph in parallel, for capacity planning and
+ * benchmarks, and stores it as an RDG. Nodes get an "id" and a "score"
+ * property and edges a "weight" property. A seed always generates the same
+ * graph whatever the number of threads.
+ */
+
+namespace cll = llvm::cl;
+
+enum Model { rmat, ba, typed };
+
+static cll::opt<std::string> outputFile(
+    cll::Positional, cll::desc("<output rdg>"), cll::Required);
+static cll::opt<Model> model(
+    "model", cll::desc("Graph model:"),
+    cll::values(
+        clEnumVal(rmat, "R-MAT (Graph500 Kronecker) graph"),
+        clEnumVal(ba, "Barabasi-Albert preferential attachment graph"),
+        clEnumVal(typed, "R-MAT graph with skewed node and edge types")),
+    cll::Required);
+static cll::opt<uint32_t> scale(
+    "scale", cll::desc("R-MAT graphs have 2^scale nodes"), cll::init(16));
+static cll::opt<uint64_t> edgeFactor(
+    "edgeFactor", cll::desc("Edges per node of R-MAT graphs"), cll::init(16));
+static cll::opt<double> a(
+    "a", cll::desc("R-MAT top left quadrant probability"), cll::init(0.57));
+static cll::opt<double> b(
+    "b", cll::desc("R-MAT top right quadrant probability"), cll::init(0.19));
+static cll::opt<double> c(
+    "c", cll::desc("R-MAT bottom left quadrant probability"), cll::init(0.19));
+static cll::opt<bool> noScramble(
+    "noScramble", cll::desc("Do not scramble the node ids of R-MAT graphs"),
+    cll::init(false));
+static cll::opt<uint64_t> numNodes(
+    "numNodes", cll::desc("Nodes of Barabasi-Albert graphs"),
+    cll::init(1 << 16));
+static cll::opt<uint64_t> edgesPerNode(
+    "edgesPerNode", cll::desc("Edges per node of Barabasi-Albert graphs"),
+    cll::init(16));
+static cll::opt<uint32_t> numNodeTypes(
+    "numNodeTypes", cll::desc("Node types of typed graphs"), cll::init(8));
+static cll::opt<uint32_t> numEdgeTypes(
+    "numEdgeTypes", cll::desc("Edge types of typed graphs"), cll::init(16));
+static cll::opt<double> typeSkew(
+    "typeSkew",
+    cll::desc("Zipf exponent of the mix of types of typed graphs; 0 is "
+              "uniform"),
+    cll::init(1.0));
+static cll::opt<uint32_t> maxWeight(
+    "maxWeight", cll::desc("Edge weights are between 1 and maxWeight"),
+    cll::init(100));
+static cll::opt<uint64_t> seed("seed", cll::desc("Seed"), cll::init(0));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Generate() {
+  katana::RMATParameters rmat_params;
+  rmat_params.scale = scale;
+  rmat_params.edge_factor = edgeFactor;
+  rmat_params.a = a;
+  rmat_params.b = b;
+  rmat_params.c = c;
+  rmat_params.scramble_ids = !noScramble;
+  rmat_params.seed = seed;
+
+  switch (model) {
+  case rmat:
+    return katana::MakeRMAT(rmat_params);
+  case ba:
+    return katana::MakeBarabasiAlbert(numNodes, edgesPerNode, seed);
+  case typed: {
+    katana::TypedGraphParameters typed_params;
+    typed_params.topology = rmat_params;
+    typed_params.num_node_types = numNodeTypes;
+    typed_params.num_edge_types = numEdgeTypes;
+    typed_params.type_skew = typeSkew;
+    return katana::MakeTypedGraph(typed_params);
+  }
+  default:
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "unknown model");
+  }
+}
+
+katana::Result<void>
+AddProperties(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  using Node = katana::PropertyGraph::Node;
+  using Edge = katana::PropertyGraph::Edge;
+  // properties draw from seeds of their own so that they are independent
+  uint64_t score_seed = katana::StatelessRandom(seed, 0);
+  uint64_t weight_seed = katana::StatelessRandom(seed, 1);
+  uint32_t max_weight = std::max<uint32_t>(maxWeight, 1);
+
+  KATANA_CHECKED(katana::AddNodeProperties(
+      pg, txn_ctx,
+      katana::PropertyGenerator(
+          "id", [](Node n) { return static_cast<uint64_t>(n); }),
+      katana::PropertyGenerator("score", [score_seed](Node n) {
+        return static_cast<double>(
+                   katana::StatelessRandom(score_seed, n) >> 11) *
+               0x1.0p-53;
+      })));
+  return katana::AddEdgeProperties(
+      pg, txn_ctx,
+      katana::PropertyGenerator("weight", [weight_seed, max_weight](Edge e) {
+        return static_cast<uint32_t>(
+            katana::StatelessRandom(weight_seed, e) % max_weight + 1);
+      }));
+}
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+  std::string command_line = katana::Join(argv, argv + argc, " ");
+  if (numThreads > 0) {
+    katana::setActiveThreads(numThreads);
+  }
+
+  auto pg_res = Generate();
+  if (!pg_res) {
+    KATANA_LOG_FATAL("generating graph: {}", pg_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  if (auto res = AddProperties(pg.get(), &txn_ctx); !res) {
+    KATANA_LOG_FATAL("adding properties: {}", res.error());
+  }
+  if (auto res = pg->Write(outputFile, command_line); !res) {
+    KATANA_LOG_FATAL("writing {}: {}", outputFile, res.error());
+  }
+  std::cout << "Generated " << pg->NumNodes() << " nodes and "
+            << pg->NumEdges() << " edges\n";
+  return 0;
+}
@@ -0,0 +1,90 @@
+/// Partitions an RDG over the hosts of a TcpCommBackend, each of which
+/// writes its partition of the output RDG. Start one task per host with
+/// KATANA_COMM_ADDRESSES and KATANA_COMM_RANK set, e.g.,
+///
+///   KATANA_COMM_ADDRESSES=h0:7000,h1:7000 KATANA_COMM_RANK=0 \
+///     graph-partition -policy=cvc in out
+
+#include <memory>
+#include <string>
+
+#include "katana/Logging.h"
+#include "katana/RDGPartitioner.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/TcpCommBackend.h"
+#include "katana/TxnContext.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFilename(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+static cll::opt<std::string> outputFilename(
+    cll::Positional, cll::desc("<output rdg>"), cll::Required);
+static cll::opt<katana::PartitionPolicy> policy(
+    "policy", cll::desc("How edges are assigned to hosts"),
+    cll::values(
+        clEnumValN(
+            katana::PartitionPolicy::kEdgeCut, "oec",
+            "Outgoing edge cut (default)"),
+        clEnumValN(
+            katana::PartitionPolicy::kCartesianVertexCut, "cvc",
+            "Cartesian vertex cut"),
+        clEnumValN(
+            katana::PartitionPolicy::kHybridVertexCut, "hvc",
+            "Hybrid vertex cut")),
+    cll::init(katana::PartitionPolicy::kEdgeCut));
+static cll::opt<uint64_t> hybridDegreeThreshold(
+    "hybrid-degree-threshold",
+    cll::desc("Out degree above which hvc splits the edges of a node"),
+    cll::init(katana::RDGPartitionOptions().hybrid_degree_threshold));
+static cll::opt<uint64_t> sliceMiB(
+    "slice-mib", cll::desc("MiB of topology each host reads at a time"),
+    cll::init(256));
+static cll::opt<bool> skipNodeProperties(
+    "skip-node-properties", cll::desc("Do not copy node properties"),
+    cll::init(false));
+
+namespace {
+
+katana::Result<void>
+PartitionGraph(katana::CommBackend* comm, const std::string& command_line) {
+  katana::RDGPartitionOptions opts;
+  opts.policy = policy;
+  opts.hybrid_degree_threshold = hybridDegreeThreshold;
+  opts.slice_bytes = sliceMiB << 20;
+  opts.load_node_properties = !skipNodeProperties;
+
+  katana::RDGPartition partition =
+      KATANA_CHECKED(katana::PartitionRDG(inputFilename, comm, opts));
+  KATANA_LOG_DEBUG(
+      "host {}: {} nodes, {} owned, {} edges", comm->Rank,
+      partition.metadata.num_nodes_, partition.metadata.num_owned_,
+      partition.metadata.num_edges_);
+
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> pg = KATANA_CHECKED(
+      katana::MakePartitionedGraph(std::move(partition), &txn_ctx));
+  KATANA_CHECKED(pg->Write(outputFilename, command_line));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  auto comm_res = katana::TcpCommBackend::MakeFromEnv();
+  if (!comm_res) {
+    KATANA_LOG_FATAL("connecting to the other hosts: {}", comm_res.error());
+  }
+  std::unique_ptr<katana::TcpCommBackend> comm = std::move(comm_res.value());
+  katana::SharedMemSys G(comm.get());
+
+  std::string command_line = katana::Join(argv, argv + argc, " ");
+  if (auto res = PartitionGraph(comm.get(), command_line); !res) {
+    KATANA_LOG_FATAL("partitioning {}: {}", inputFilename, res.error());
+  }
+  return 0;
+}
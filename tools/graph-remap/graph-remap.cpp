@@ -17,9 +17,35 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include "katana/BufferedGraph.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/CSRTopology.h"
+#include "katana/ErrorCode.h"
 #include "katana/FileGraph.h"
+#include "katana/FileView.h"
+#include "katana/Galois.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
 #include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/TxnContext.h"
+#include "katana/file.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -30,110 +56,376 @@ static cll::opt<std::string> mappingFilename(
     cll::Positional, cll::desc("<mapping file>"), cll::Required);
 static cll::opt<std::string> outputFilename(
     cll::Positional, cll::desc("<output file>"), cll::Required);
+static cll::opt<bool> rdgInput(
+    "rdg",
+    cll::desc("Input and output are RDGs rather than .gr files; properties "
+              "and types are permuted with the nodes and edges"),
+    cll::init(false));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default value 1)"), cll::init(1));
 
-using Writer = katana::FileGraphWriter;
+namespace {
 
-/**
- * Create node map from file
- */
-std::map<uint32_t, uint32_t>
-createNodeMap() {
+using Node = uint32_t;
+
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+/// Bytes of the mapping file parsed per iteration of the parallel loop
+constexpr uint64_t kParseBlock = uint64_t{1} << 24;
+
+/// The node listed n-th in the mapping file, old_of_new[n], becomes node n;
+/// new_of_old is its inverse, and kNoNode for the nodes that are not listed,
+/// which are dropped
+struct NodeMap {
+  katana::NUMAArray<Node> old_of_new;
+  katana::NUMAArray<Node> new_of_old;
+};
+
+/// The remapped topology and, for each of its edges, the old edge it comes
+/// from, by which edge data is permuted
+struct RemappedTopology {
+  katana::NUMAArray<uint64_t> out_indexes;
+  katana::NUMAArray<Node> dests;
+  katana::NUMAArray<uint64_t> old_edges;
+};
+
+bool
+IsSpace(char c) {
+  return std::isspace(static_cast<unsigned char>(c));
+}
+
+/// Read the whitespace separated node ids of the mapping file in parallel
+/// blocks: one pass counts the ids that start in each block, so that a
+/// second knows where to put them
+katana::Result<NodeMap>
+ReadNodeMap(const std::string& filename, uint64_t num_old_nodes) {
   katana::gInfo("Creating node map");
-  // read new mapping
-  std::ifstream mapFile(mappingFilename);
-  mapFile.seekg(0, std::ios_base::end);
+  katana::StatBuf stat_buf;
+  KATANA_CHECKED_CONTEXT(
+      katana::FileStat(filename, &stat_buf), "mapping {}", filename);
+  uint64_t size = stat_buf.size;
+  katana::FileView view;
+  if (size > 0) {
+    KATANA_CHECKED(view.Bind(filename, size, true));
+  }
+  const char* text = view.ptr<char>();
+
+  auto starts_id = [&](uint64_t i) {
+    return !IsSpace(text[i]) && (i == 0 || IsSpace(text[i - 1]));
+  };
+  uint64_t num_blocks = (size + kParseBlock - 1) / kParseBlock;
+  std::vector<uint64_t> block_offsets(num_blocks + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        uint64_t end = std::min((b + 1) * kParseBlock, size);
+        uint64_t count = 0;
+        for (uint64_t i = b * kParseBlock; i < end; ++i) {
+          count += starts_id(i);
+        }
+        block_offsets[b + 1] = count;
+      },
+      katana::no_stats());
+  std::partial_sum(
+      block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+  uint64_t num_new_nodes = block_offsets[num_blocks];
 
-  int64_t endOfFile = mapFile.tellg();
-  if (!mapFile) {
-    KATANA_DIE("failed to read file");
+  NodeMap map;
+  map.old_of_new.allocateInterleaved(num_new_nodes);
+  map.new_of_old.allocateInterleaved(num_old_nodes);
+  katana::ParallelSTL::fill(
+      map.new_of_old.begin(), map.new_of_old.end(), kNoNode);
+
+  // the first entry that is not a node of the graph or repeats one
+  katana::GReduceMin<uint64_t> first_invalid;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        uint64_t end = std::min((b + 1) * kParseBlock, size);
+        uint64_t entry = block_offsets[b];
+        for (uint64_t i = b * kParseBlock; i < end; ++i) {
+          if (!starts_id(i)) {
+            continue;
+          }
+          // an id that starts in this block may end in the next one
+          uint64_t id = 0;
+          bool valid = true;
+          for (uint64_t j = i; j < size && !IsSpace(text[j]); ++j) {
+            valid = valid && text[j] >= '0' && text[j] <= '9' &&
+                    id < num_old_nodes;
+            id = id * 10 + (text[j] - '0');
+          }
+          if (valid && id < num_old_nodes &&
+              __sync_bool_compare_and_swap(
+                  &map.new_of_old[id], kNoNode, Node(entry))) {
+            map.old_of_new[entry] = id;
+          } else {
+            first_invalid.update(entry);
+          }
+          entry++;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (num_new_nodes > 0 && first_invalid.reduce() < num_new_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "entry {} of {} is not a node of a graph of {} nodes or is listed "
+        "more than once",
+        first_invalid.reduce(), filename, num_old_nodes);
   }
+  katana::gInfo("Remapping ", num_new_nodes, " nodes");
+  return map;
+}
 
-  mapFile.seekg(0, std::ios_base::beg);
-  if (!mapFile) {
-    KATANA_DIE("failed to read file");
+/// Remap the graph whose node n has the edges [edge_begin(n), edge_end(n))
+/// to dest(e); the edges of a node are sorted by destination and then by
+/// their old order
+template <typename EdgeBegin, typename EdgeEnd, typename Dest>
+katana::Result<RemappedTopology>
+Remap(
+    const NodeMap& map, const EdgeBegin& edge_begin, const EdgeEnd& edge_end,
+    const Dest& dest) {
+  katana::gInfo("Starting degree counting");
+  uint64_t num_nodes = map.old_of_new.size();
+  RemappedTopology topo;
+  topo.out_indexes.allocateInterleaved(num_nodes);
+  katana::GAccumulator<uint64_t> dangling;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Node old = map.old_of_new[n];
+        uint64_t local_dangling = 0;
+        for (uint64_t e = edge_begin(old); e < edge_end(old); ++e) {
+          local_dangling += map.new_of_old[dest(e)] == kNoNode;
+        }
+        topo.out_indexes[n] = edge_end(old) - edge_begin(old);
+        dangling += local_dangling;
+      },
+      katana::steal(), katana::no_stats());
+  if (dangling.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} edges of remapped nodes are to nodes that are not remapped",
+        dangling.reduce());
   }
+  katana::ParallelSTL::partial_sum(
+      topo.out_indexes.begin(), topo.out_indexes.end(),
+      topo.out_indexes.begin());
+  uint64_t num_edges = num_nodes == 0 ? 0 : topo.out_indexes[num_nodes - 1];
 
-  // remap node listed on line n in the mapping to node n
-  std::map<uint32_t, uint32_t> remapper;
-  uint64_t counter = 0;
-  while (((int64_t)mapFile.tellg() + 1) != endOfFile) {
-    uint64_t nodeID;
-    mapFile >> nodeID;
-    if (!mapFile) {
-      KATANA_DIE("failed to read file");
-    }
-    remapper[nodeID] = counter++;
+  katana::gInfo("Starting edge construction");
+  topo.dests.allocateInterleaved(num_edges);
+  topo.old_edges.allocateInterleaved(num_edges);
+  katana::PerThreadStorage<std::vector<std::pair<Node, uint64_t>>> buffers;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Node old = map.old_of_new[n];
+        auto& edges = *buffers.getLocal();
+        edges.clear();
+        for (uint64_t e = edge_begin(old); e < edge_end(old); ++e) {
+          edges.emplace_back(map.new_of_old[dest(e)], e);
+        }
+        std::sort(edges.begin(), edges.end());
+        uint64_t offset = n == 0 ? 0 : topo.out_indexes[n - 1];
+        for (const auto& [dst, old_edge] : edges) {
+          topo.dests[offset] = dst;
+          topo.old_edges[offset] = old_edge;
+          offset++;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return topo;
+}
+
+/// Write a version 1 .gr file of topo, whose edges have edge_size bytes of
+/// data each, those of its old edges in old_edge_data
+katana::Result<void>
+WriteGr(
+    const std::string& filename, const RemappedTopology& topo,
+    uint64_t edge_size, const char* old_edge_data) {
+  uint64_t num_edges = topo.dests.size();
+  katana::NUMAArray<char> edge_data;
+  edge_data.allocateInterleaved(num_edges * edge_size);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        std::memcpy(
+            &edge_data[e * edge_size],
+            old_edge_data + topo.old_edges[e] * edge_size, edge_size);
+      },
+      katana::no_stats());
+
+  katana::CSRTopologyHeader header{
+      .version = 1,
+      .edge_type_size = edge_size,
+      .num_nodes = topo.out_indexes.size(),
+      .num_edges = num_edges};
+  // edge data is aligned to 8 bytes
+  uint64_t padding = edge_size > 0 && num_edges % 2 == 1 ? sizeof(Node) : 0;
+  const uint64_t zero = 0;
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(
+      reinterpret_cast<const char*>(topo.out_indexes.data()),
+      topo.out_indexes.size() * sizeof(uint64_t));
+  out.write(
+      reinterpret_cast<const char*>(topo.dests.data()),
+      num_edges * sizeof(Node));
+  out.write(reinterpret_cast<const char*>(&zero), padding);
+  out.write(edge_data.data(), edge_data.size());
+  out.close();
+  if (!out) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "writing {}", filename);
   }
+  return katana::ResultSuccess();
+}
 
-  KATANA_LOG_ASSERT(remapper.size() == counter);
-  katana::gInfo("Remapping ", counter, " nodes");
+katana::Result<void>
+RemapGr() {
+  katana::gInfo("Loading graph to remap");
+  katana::FileGraph graph;
+  graph.fromFile(inputFilename);
+  katana::gInfo("Graph loaded");
 
-  katana::gInfo("Node map created");
+  NodeMap map = KATANA_CHECKED(ReadNodeMap(mappingFilename, graph.size()));
+  auto out_indexes = graph.edge_id_begin();
+  auto dests = graph.node_id_begin();
+  RemappedTopology topo = KATANA_CHECKED(Remap(
+      map, [&](Node n) { return n == 0 ? 0 : out_indexes[n - 1]; },
+      [&](Node n) { return out_indexes[n]; },
+      [&](uint64_t e) { return dests[e]; }));
 
-  return remapper;
+  katana::gInfo("Finishing up: outputting graph shortly");
+  uint64_t edge_size = graph.edgeSize();
+  KATANA_CHECKED(WriteGr(
+      outputFilename, topo, edge_size,
+      edge_size == 0 ? nullptr : graph.edge_data_begin<char>()));
+  katana::gInfo(
+      "new size is ", topo.out_indexes.size(), " num edges ",
+      topo.dests.size());
+  return katana::ResultSuccess();
 }
 
-int
-main(int argc, char** argv) {
-  katana::SharedMemSys G;
-  llvm::cl::ParseCommandLineOptions(argc, argv);
+/// The table of the columns of a property table, each permuted by a Take
+/// of rows, the kernels running in parallel
+template <typename GetProperty, typename GetName>
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    int32_t num_properties, const GetProperty& get_property,
+    const GetName& get_name, const katana::NUMAArray<uint64_t>& rows) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (int32_t i = 0; i < num_properties; ++i) {
+    columns.emplace_back(get_property(i));
+    fields.emplace_back(arrow::field(get_name(i), columns.back()->type()));
+  }
 
-  std::map<uint32_t, uint32_t> remapper = createNodeMap();
+  auto indices = std::make_shared<arrow::UInt64Array>(
+      rows.size(), arrow::Buffer::Wrap(rows.data(), rows.size()));
+  std::vector<arrow::Result<arrow::Datum>> taken(columns.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, columns.size()),
+      [&](size_t i) {
+        taken[i] = arrow::compute::Take(
+            arrow::Datum(columns[i]), arrow::Datum(indices));
+      },
+      katana::steal(), katana::no_stats());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    columns[i] = KATANA_CHECKED(std::move(taken[i])).chunked_array();
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, rows.size());
+}
 
+katana::Result<void>
+RemapRDG(const std::string& command_line) {
   katana::gInfo("Loading graph to remap");
-  katana::BufferedGraph<void> graphToRemap;
-  graphToRemap.loadGraph(inputFilename);
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> pg =
+      KATANA_CHECKED(katana::PropertyGraph::Make(inputFilename, &txn_ctx));
+  const katana::GraphTopology& old_topo = pg->topology();
   katana::gInfo("Graph loaded");
 
-  Writer graphWriter;
-  graphWriter.setNumNodes(remapper.size());
-  graphWriter.setNumEdges(graphToRemap.sizeEdges());
+  NodeMap map = KATANA_CHECKED(ReadNodeMap(mappingFilename, pg->NumNodes()));
+  RemappedTopology topo = KATANA_CHECKED(Remap(
+      map, [&](Node n) { return *old_topo.OutEdges(n).begin(); },
+      [&](Node n) { return *old_topo.OutEdges(n).end(); },
+      [&](uint64_t e) { return old_topo.OutEdgeDst(e); }));
 
-  // phase 1: count degrees
-  graphWriter.phase1();
-  katana::gInfo("Starting degree counting");
-  size_t prevNumNodes = graphToRemap.size();
-  size_t nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        graphWriter.incrementDegree(nodeIDCounter);
-      }
-      nodeIDCounter++;
-    }
-  }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
+  uint64_t num_nodes = topo.out_indexes.size();
+  uint64_t num_edges = topo.dests.size();
+  katana::NUMAArray<uint64_t> node_rows;
+  katana::NUMAArray<uint64_t> edge_rows;
+  katana::EntityTypeIDArray node_type_ids;
+  katana::EntityTypeIDArray edge_type_ids;
+  node_rows.allocateInterleaved(num_nodes);
+  edge_rows.allocateInterleaved(num_edges);
+  node_type_ids.allocateInterleaved(num_nodes);
+  edge_type_ids.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        node_rows[n] = map.old_of_new[n];
+        node_type_ids[n] = pg->GetTypeOfNode(map.old_of_new[n]);
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        edge_rows[e] =
+            old_topo.GetEdgePropertyIndexFromOutEdge(topo.old_edges[e]);
+        edge_type_ids[e] = pg->GetTypeOfEdgeFromPropertyIndex(edge_rows[e]);
+      },
+      katana::no_stats());
 
-  // phase 2: edge construction
-  graphWriter.phase2();
-  katana::gInfo("Starting edge construction");
-  nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        uint32_t dst = graphToRemap.edgeDestination(*e);
-        KATANA_LOG_ASSERT(remapper.find(dst) != remapper.end());
-        graphWriter.addNeighbor(nodeIDCounter, remapper[dst]);
-      }
-      nodeIDCounter++;
-    }
+  katana::gInfo("Permuting properties");
+  katana::GraphTopology new_topo{
+      std::move(topo.out_indexes), std::move(topo.dests)};
+  std::unique_ptr<katana::PropertyGraph> remapped =
+      KATANA_CHECKED(katana::PropertyGraph::Make(
+          std::move(new_topo), std::move(node_type_ids),
+          std::move(edge_type_ids),
+          katana::EntityTypeManager{pg->GetNodeTypeManager()},
+          katana::EntityTypeManager{pg->GetEdgeTypeManager()}));
+  if (pg->GetNumNodeProperties() > 0) {
+    auto table = KATANA_CHECKED(TakeRows(
+        pg->GetNumNodeProperties(),
+        [&](int32_t i) { return pg->GetNodeProperty(i); },
+        [&](int32_t i) { return pg->GetNodePropertyName(i); }, node_rows));
+    KATANA_CHECKED(remapped->AddNodeProperties(table, &txn_ctx));
+  }
+  if (pg->GetNumEdgeProperties() > 0) {
+    auto table = KATANA_CHECKED(TakeRows(
+        pg->GetNumEdgeProperties(),
+        [&](int32_t i) { return pg->GetEdgeProperty(i); },
+        [&](int32_t i) { return pg->GetEdgePropertyName(i); }, edge_rows));
+    KATANA_CHECKED(remapped->AddEdgeProperties(table, &txn_ctx));
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
 
   katana::gInfo("Finishing up: outputting graph shortly");
+  KATANA_CHECKED(remapped->Write(outputFilename, command_line));
+  katana::gInfo(
+      "new size is ", remapped->NumNodes(), " num edges ",
+      remapped->NumEdges());
+  return katana::ResultSuccess();
+}
 
-  graphWriter.finish<void>();
-  graphWriter.toFile(outputFilename);
+}  // namespace
 
-  katana::gInfo(
-      "new size is ", graphWriter.size(), " num edges ",
-      graphWriter.sizeEdges());
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(numThreads);
 
+  auto res = rdgInput ? RemapRDG(katana::Join(argv, argv + argc, " "))
+                      : RemapGr();
+  if (!res) {
+    // a bad mapping is an error of the input, so exit rather than abort
+    KATANA_LOG_ERROR("remapping {}: {}", inputFilename, res.error());
+    return 1;
+  }
   return 0;
 }
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace cll = llvm::cl;
+
+static cll::list<std::string> filenames(
+    cll::Positional,
+    cll::desc("<graph> <mapping> to generate, or <graph> <mapping> "
+              "<remapped graph> to check"),
+    cll::OneOrMore);
+static cll::opt<bool> generate(
+    "generate",
+    cll::desc("Write a graph to remap and mappings of it: <mapping> is "
+              "valid and <mapping>-repeated, <mapping>-outside and "
+              "<mapping>-dangling are not"),
+    cll::init(false));
+
+namespace {
+
+constexpr uint32_t kNumNodes = 2000;
+/// The last kNumIsolated nodes have no edges, and the mapping drops half
+/// of them
+constexpr uint32_t kNumIsolated = 100;
+
+/// Writes ids with assorted whitespace between them
+void
+WriteMapping(const std::string& filename, const std::vector<uint32_t>& ids) {
+  static const char* kSeparators[] = {" ", "\n", "\t ", "  \r\n"};
+  std::ofstream out(filename);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    out << ids[i] << kSeparators[i % 4];
+  }
+  KATANA_LOG_ASSERT(out);
+}
+
+/// A random graph with an int64 "value" of each node and "weight" of each
+/// edge, the node type Even and the edge type Heavy
+void
+Generate(const std::string& graph_name, const std::string& mapping_name) {
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<uint32_t> node(
+      0, kNumNodes - kNumIsolated - 1);
+  std::vector<std::vector<uint32_t>> out(kNumNodes);
+  out[0].emplace_back(1);
+  for (uint32_t e = 0; e < 5 * kNumNodes; ++e) {
+    out[node(gen)].emplace_back(node(gen));
+  }
+  std::vector<katana::GraphTopology::Edge> adj_indices;
+  std::vector<katana::GraphTopology::Node> dests;
+  for (const auto& edges : out) {
+    dests.insert(dests.end(), edges.begin(), edges.end());
+    adj_indices.emplace_back(dests.size());
+  }
+  katana::GraphTopology topo(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto node_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "value", [](uint64_t n) { return static_cast<int64_t>(3 * n); }),
+      katana::PropertyGenerator("Even", [](uint64_t n) {
+        return static_cast<uint8_t>(n % 2 == 0);
+      }));
+  KATANA_LOG_VASSERT(node_res, "adding node properties: {}", node_res.error());
+  auto edge_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "weight", [](uint64_t e) { return static_cast<int64_t>(e); }),
+      katana::PropertyGenerator("Heavy", [](uint64_t e) {
+        return static_cast<uint8_t>(e % 3 == 0);
+      }));
+  KATANA_LOG_VASSERT(edge_res, "adding edge properties: {}", edge_res.error());
+  auto types_res = pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+  auto write_res = pg->Write(graph_name, "graph-remap-test");
+  KATANA_LOG_VASSERT(write_res, "writing graph: {}", write_res.error());
+
+  std::vector<uint32_t> ids(kNumNodes - kNumIsolated / 2);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), gen);
+  WriteMapping(mapping_name, ids);
+
+  std::vector<uint32_t> repeated = ids;
+  repeated[ids.size() / 2] = repeated[ids.size() / 3];
+  WriteMapping(mapping_name + "-repeated", repeated);
+  std::vector<uint32_t> outside = ids;
+  outside.emplace_back(kNumNodes);
+  WriteMapping(mapping_name + "-outside", outside);
+  // node 0 without the nodes it has edges to
+  std::vector<uint32_t> dangling{0};
+  WriteMapping(mapping_name + "-dangling", dangling);
+}
+
+std::unique_ptr<katana::PropertyGraph>
+Load(const std::string& rdg_name) {
+  katana::TxnContext txn_ctx;
+  auto pg_res =
+      katana::PropertyGraph::Make(rdg_name, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "loading {}: {}", rdg_name, pg_res.error());
+  return std::move(pg_res.value());
+}
+
+template <typename T, typename GetArray>
+std::shared_ptr<typename arrow::CTypeTraits<T>::ArrayType>
+Property(const GetArray& get_array, const std::string& name) {
+  auto res = get_array(name);
+  KATANA_LOG_VASSERT(res, "property {}: {}", name, res.error());
+  return res.value();
+}
+
+/// Checks that remapped is graph with node n of remapped the n-th node of
+/// the mapping, its edges sorted by destination and then by their order in
+/// graph, and properties and types carried along
+void
+Check(
+    const std::string& graph_name, const std::string& mapping_name,
+    const std::string& remapped_name) {
+  auto pg = Load(graph_name);
+  auto remapped = Load(remapped_name);
+
+  std::vector<uint32_t> old_of_new;
+  std::ifstream mapping(mapping_name);
+  for (uint32_t id; mapping >> id;) {
+    old_of_new.emplace_back(id);
+  }
+  std::vector<uint32_t> new_of_old(pg->NumNodes(), kNumNodes);
+  for (uint32_t n = 0; n < old_of_new.size(); ++n) {
+    new_of_old[old_of_new[n]] = n;
+  }
+  KATANA_LOG_ASSERT(remapped->NumNodes() == old_of_new.size());
+
+  auto get_node = [](katana::PropertyGraph* g) {
+    return [g](const std::string& name) {
+      return g->GetNodePropertyTyped<int64_t>(name);
+    };
+  };
+  auto get_edge = [](katana::PropertyGraph* g) {
+    return [g](const std::string& name) {
+      return g->GetEdgePropertyTyped<int64_t>(name);
+    };
+  };
+  auto values = Property<int64_t>(get_node(pg.get()), "value");
+  auto new_values = Property<int64_t>(get_node(remapped.get()), "value");
+  auto weights = Property<int64_t>(get_edge(pg.get()), "weight");
+  auto new_weights = Property<int64_t>(get_edge(remapped.get()), "weight");
+
+  const katana::GraphTopology& topo = pg->topology();
+  const katana::GraphTopology& new_topo = remapped->topology();
+  uint64_t num_edges = 0;
+  for (uint32_t n = 0; n < old_of_new.size(); ++n) {
+    uint32_t old = old_of_new[n];
+    KATANA_LOG_ASSERT(
+        new_values->Value(remapped->GetNodePropertyIndex(n)) ==
+        values->Value(pg->GetNodePropertyIndex(old)));
+    KATANA_LOG_ASSERT(remapped->GetTypeOfNode(n) == pg->GetTypeOfNode(old));
+
+    // by new destination and old edge, the weight and type of the edge
+    std::vector<std::tuple<uint32_t, uint64_t, int64_t, katana::EntityTypeID>>
+        expected;
+    for (auto e : topo.OutEdges(old)) {
+      uint64_t index = topo.GetEdgePropertyIndexFromOutEdge(e);
+      expected.emplace_back(
+          new_of_old[topo.OutEdgeDst(e)], e, weights->Value(index),
+          pg->GetTypeOfEdgeFromPropertyIndex(index));
+    }
+    std::sort(expected.begin(), expected.end());
+    auto edges = new_topo.OutEdges(n);
+    KATANA_LOG_VASSERT(
+        *edges.end() - *edges.begin() == expected.size(),
+        "node {} has the wrong number of edges", n);
+    auto next = expected.begin();
+    for (auto e : edges) {
+      const auto& [dst, old_edge, weight, type] = *next++;
+      uint64_t index = new_topo.GetEdgePropertyIndexFromOutEdge(e);
+      KATANA_LOG_ASSERT(new_topo.OutEdgeDst(e) == dst);
+      KATANA_LOG_VASSERT(
+          new_weights->Value(index) == weight,
+          "edge {} of node {} is not old edge {}", e, n, old_edge);
+      KATANA_LOG_ASSERT(
+          remapped->GetTypeOfEdgeFromPropertyIndex(index) == type);
+    }
+    num_edges += expected.size();
+  }
+  KATANA_LOG_ASSERT(remapped->NumEdges() == num_edges);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  if (generate && filenames.size() == 2) {
+    Generate(filenames[0], filenames[1]);
+  } else if (!generate && filenames.size() == 3) {
+    Check(filenames[0], filenames[1], filenames[2]);
+  } else {
+    KATANA_LOG_FATAL("unexpected number of files: {}", filenames.size());
+  }
+
+  return 0;
+}
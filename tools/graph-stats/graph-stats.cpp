@@ -23,8 +23,11 @@
 
 #include "katana/Galois.h"
 #include "katana/LCGraph.h"
+#include "katana/Logging.h"
 #include "katana/OfflineGraph.h"
+#include "katana/SharedMemSys.h"
 #include "llvm/Support/CommandLine.h"
+#include "rdg-stats.h"
 
 namespace cll = llvm::cl;
 
@@ -61,6 +64,27 @@ static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<bool> rdgInput(
+    "rdg",
+    cll::desc("Input is an RDG; print its statistics as JSON, computed a "
+              "slice at a time and cached in its directory"),
+    cll::init(false));
+static cll::opt<uint64_t> sliceBytes(
+    "sliceBytes", cll::desc("Bytes of an RDG loaded at once"),
+    cll::init(katana::RDGStatsOptions().slice_bytes));
+static cll::opt<uint32_t> diameterSweeps(
+    "diameterSweeps",
+    cll::desc("Breadth first searches to bound the diameter of an RDG"),
+    cll::init(katana::RDGStatsOptions().diameter_sweeps));
+static cll::opt<uint64_t> clusteringSamples(
+    "clusteringSamples",
+    cll::desc("Wedges sampled for the clustering coefficient of an RDG"),
+    cll::init(katana::RDGStatsOptions().clustering_samples));
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed of the samples of an RDG"), cll::init(0));
+static cll::opt<bool> recompute(
+    "recompute", cll::desc("Ignore the cached statistics of an RDG"),
+    cll::init(false));
 
 typedef katana::OfflineGraph Graph;
 typedef Graph::GraphNode GNode;
@@ -251,9 +275,28 @@ doDestinationHistogram(Graph& graph) {
   printHistogram("DestinationBin", hist);
 }
 
+int
+doRDGStats() {
+  katana::SharedMemSys sys;
+  katana::RDGStatsOptions opts;
+  opts.slice_bytes = sliceBytes;
+  opts.diameter_sweeps = diameterSweeps;
+  opts.clustering_samples = clusteringSamples;
+  opts.seed = seed;
+  auto stats_res = katana::CachedRDGStats(inputfilename, opts, recompute);
+  if (!stats_res) {
+    KATANA_LOG_FATAL("computing statistics: {}", stats_res.error());
+  }
+  std::cout << stats_res.value().dump(2) << "\n";
+  return 0;
+}
+
 int
 main(int argc, char** argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  if (rdgInput) {
+    return doRDGStats();
+  }
   try {
     Graph graph(inputfilename);
     for (unsigned i = 0; i != statModeList.size(); ++i) {
@@ -0,0 +1,601 @@
+#include "rdg-stats.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "katana/CSRTopology.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/RDGManifest.h"
+#include "katana/RDGSlice.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace {
+
+constexpr const char* kCacheFileName = "graph-stats.json";
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+constexpr size_t kHistogramBuckets = 66;
+
+size_t
+Log2Bucket(uint64_t degree) {
+  return degree == 0 ? 0 : 64 - __builtin_clzll(degree);
+}
+
+/// A contiguous range of the nodes of a partition, with their out edges
+/// and their types
+struct Slice {
+  /// The first node of the partition among those of every partition
+  uint64_t base;
+  uint64_t first_node;
+  uint64_t end_node;
+  uint64_t first_edge;
+  /// out_indexes[n - first_node] is the end of the edges of node n
+  const uint64_t* out_indexes;
+  /// dests[e - first_edge] is the destination of edge e
+  const uint32_t* dests;
+  /// Empty if types are not loaded
+  katana::NUMAArray<katana::EntityTypeID> node_types;
+  katana::NUMAArray<katana::EntityTypeID> edge_types;
+
+  uint64_t EdgeBegin(uint64_t n) const {
+    return n == first_node ? first_edge : out_indexes[n - first_node - 1];
+  }
+  uint64_t EdgeEnd(uint64_t n) const { return out_indexes[n - first_node]; }
+  uint32_t Dest(uint64_t e) const { return dests[e - first_edge]; }
+};
+
+/// SliceScanner visits an RDG a slice of a partition at a time. A slice is
+/// an RDGSlice of the out indexes and types of a range of nodes, and a view
+/// of the destinations of their edges, which are not contiguous with the
+/// out indexes in the topology file.
+class SliceScanner {
+public:
+  static katana::Result<SliceScanner> Make(
+      const std::string& rdg_name, uint64_t slice_bytes) {
+    SliceScanner scanner;
+    scanner.slice_bytes_ = slice_bytes;
+    katana::RDGManifest manifest =
+        KATANA_CHECKED(katana::FindManifest(rdg_name));
+    scanner.version_ = manifest.version();
+    uint32_t num_partitions = manifest.num_hosts();
+    katana::RDGHandle handle =
+        KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadOnly));
+    scanner.file_ = std::make_unique<katana::RDGFile>(handle);
+
+    std::vector<std::string> no_props;
+    uint64_t base = 0;
+    for (uint32_t p = 0; p < num_partitions; ++p) {
+      // a slice of just the header, to find the topology file and the size
+      // of the partition
+      katana::RDGSlice::SliceArg header_arg{
+          .node_range = {0, 0},
+          .edge_range = {0, 0},
+          .topo_off = 0,
+          .topo_size = sizeof(katana::CSRTopologyHeader)};
+      katana::RDGSlice meta = KATANA_CHECKED(katana::RDGSlice::Make(
+          *scanner.file_, header_arg, p, no_props, no_props));
+      const katana::FileView& storage = meta.topology_file_storage();
+      const auto* header = storage.ptr<katana::CSRTopologyHeader>();
+
+      Partition partition;
+      partition.topology_path = storage.filename();
+      partition.num_nodes = header->num_nodes;
+      partition.num_edges = header->num_edges;
+      partition.base = base;
+      base += header->num_nodes;
+      scanner.num_edges_ += header->num_edges;
+      scanner.partitions_.emplace_back(std::move(partition));
+
+      if (p == 0) {
+        scanner.has_types_ = meta.IsEntityTypeIDsOutsideProperties();
+        if (scanner.has_types_) {
+          scanner.node_type_manager_ =
+              KATANA_CHECKED(meta.node_entity_type_manager());
+          scanner.edge_type_manager_ =
+              KATANA_CHECKED(meta.edge_entity_type_manager());
+        }
+      }
+    }
+    scanner.num_nodes_ = base;
+    return scanner;
+  }
+
+  uint64_t version() const { return version_; }
+  uint32_t num_partitions() const { return partitions_.size(); }
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+  bool has_types() const { return has_types_; }
+  const katana::EntityTypeManager& node_type_manager() const {
+    return node_type_manager_;
+  }
+  const katana::EntityTypeManager& edge_type_manager() const {
+    return edge_type_manager_;
+  }
+
+  /// Call fn(const Slice&) for each slice of each partition, in order;
+  /// types are loaded only if load_types.
+  template <typename Fn>
+  katana::Result<void> Scan(bool load_types, const Fn& fn) {
+    load_types = load_types && has_types_;
+    std::vector<std::string> no_props;
+    for (uint32_t p = 0; p < partitions_.size(); ++p) {
+      const Partition& partition = partitions_[p];
+      uint64_t num_nodes = partition.num_nodes;
+      if (num_nodes == 0) {
+        continue;
+      }
+      uint64_t bytes_per_node =
+          sizeof(uint64_t) + sizeof(katana::EntityTypeID) +
+          (sizeof(uint32_t) + sizeof(katana::EntityTypeID)) *
+              partition.num_edges / num_nodes;
+      uint64_t nodes_per_slice = std::max<uint64_t>(
+          1, slice_bytes_ / std::max<uint64_t>(bytes_per_node, 1));
+      uint64_t dests_offset =
+          sizeof(katana::CSRTopologyHeader) + num_nodes * sizeof(uint64_t);
+
+      for (uint64_t first = 0; first < num_nodes; first += nodes_per_slice) {
+        uint64_t end = std::min(first + nodes_per_slice, num_nodes);
+        uint64_t first_edge = first == 0 ? 0
+                                         : KATANA_CHECKED(ReadOutIndex(
+                                               partition, first - 1));
+        uint64_t end_edge = KATANA_CHECKED(ReadOutIndex(partition, end - 1));
+
+        katana::RDGSlice::SliceArg arg{
+            .node_range = {first, end},
+            .edge_range = {first_edge, end_edge},
+            .topo_off = OutIndexOffset(first),
+            .topo_size = (end - first) * sizeof(uint64_t)};
+        katana::RDGSlice rdg_slice = KATANA_CHECKED(
+            katana::RDGSlice::Make(*file_, arg, p, no_props, no_props));
+
+        katana::FileView dests;
+        if (end_edge > first_edge) {
+          KATANA_CHECKED(dests.Bind(
+              partition.topology_path,
+              dests_offset + first_edge * sizeof(uint32_t),
+              dests_offset + end_edge * sizeof(uint32_t), true));
+        }
+
+        Slice slice{
+            .base = partition.base,
+            .first_node = first,
+            .end_node = end,
+            .first_edge = first_edge,
+            .out_indexes = rdg_slice.topology_file_storage().ptr<uint64_t>(
+                OutIndexOffset(first)),
+            .dests = end_edge > first_edge
+                         ? dests.ptr<uint32_t>(
+                               dests_offset + first_edge * sizeof(uint32_t))
+                         : nullptr,
+            .node_types = {},
+            .edge_types = {}};
+        if (load_types) {
+          slice.node_types =
+              KATANA_CHECKED(rdg_slice.node_entity_type_id_array());
+          slice.edge_types =
+              KATANA_CHECKED(rdg_slice.edge_entity_type_id_array());
+        }
+        fn(slice);
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  struct Partition {
+    std::string topology_path;
+    uint64_t num_nodes;
+    uint64_t num_edges;
+    uint64_t base;
+  };
+
+  SliceScanner() = default;
+
+  static uint64_t OutIndexOffset(uint64_t n) {
+    return sizeof(katana::CSRTopologyHeader) + n * sizeof(uint64_t);
+  }
+
+  static katana::Result<uint64_t> ReadOutIndex(
+      const Partition& partition, uint64_t n) {
+    uint64_t index;
+    KATANA_CHECKED(katana::FileGet(
+        partition.topology_path, &index, OutIndexOffset(n), sizeof(index)));
+    return index;
+  }
+
+  std::unique_ptr<katana::RDGFile> file_;
+  std::vector<Partition> partitions_;
+  uint64_t slice_bytes_{0};
+  uint64_t version_{0};
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+  bool has_types_{false};
+  katana::EntityTypeManager node_type_manager_;
+  katana::EntityTypeManager edge_type_manager_;
+};
+
+std::string
+TypeName(const katana::EntityTypeManager& manager, katana::EntityTypeID id) {
+  if (std::optional<std::string> name = manager.GetAtomicTypeName(id)) {
+    return *name;
+  }
+  // a non-atomic type is named by its atomic types
+  std::string name;
+  const katana::SetOfEntityTypeIDs& atomic = manager.GetAtomicSubtypes(id);
+  for (size_t a = 0; a < atomic.size(); ++a) {
+    if (atomic.test(a)) {
+      name += (name.empty() ? "" : "&") +
+              manager.GetAtomicTypeName(a).value_or(std::to_string(a));
+    }
+  }
+  return name.empty() ? std::to_string(id) : name;
+}
+
+std::map<std::string, uint64_t>
+NameTypeCounts(
+    const katana::EntityTypeManager& manager,
+    const std::vector<uint64_t>& counts) {
+  std::map<std::string, uint64_t> named;
+  for (size_t id = 0; id < counts.size(); ++id) {
+    if (counts[id] > 0) {
+      named[TypeName(manager, id)] += counts[id];
+    }
+  }
+  return named;
+}
+
+std::vector<uint64_t>
+TrimHistogram(std::vector<uint64_t> histogram) {
+  while (!histogram.empty() && histogram.back() == 0) {
+    histogram.pop_back();
+  }
+  return histogram;
+}
+
+/// A wedge v -> (u, w) sampled for the clustering coefficient is closed if
+/// w is a destination of u or u one of w; a query asks one of these.
+struct WedgeQuery {
+  uint64_t node;
+  uint64_t dest;
+  uint64_t wedge;
+};
+
+/// Counters of the main pass, accumulated per thread
+enum Counter : size_t {
+  kSortedNodes,
+  kSelfLoops,
+  kMultiEdges,
+  kEdgeHashes,
+  kReverseHashes,
+  kNumCounters,
+};
+
+/// Breadth first search from source over out edges by a pass over the
+/// graph per level; returns the eccentricity of source and a node that
+/// distance away.
+katana::Result<std::pair<uint64_t, uint64_t>>
+Sweep(SliceScanner* scanner, uint64_t source) {
+  katana::NUMAArray<uint32_t> dist;
+  dist.allocateInterleaved(scanner->num_nodes());
+  katana::ParallelSTL::fill(dist.begin(), dist.end(), kUnreached);
+  dist[source] = 0;
+
+  uint64_t last = source;
+  for (uint32_t level = 0;; ++level) {
+    katana::GAccumulator<uint64_t> reached;
+    katana::GReduceMax<uint64_t> some_reached;
+    KATANA_CHECKED(scanner->Scan(false, [&](const Slice& slice) {
+      katana::do_all(
+          katana::iterate(slice.first_node, slice.end_node),
+          [&](uint64_t n) {
+            if (dist[slice.base + n] != level) {
+              return;
+            }
+            for (uint64_t e = slice.EdgeBegin(n); e < slice.EdgeEnd(n); ++e) {
+              uint64_t dst = slice.base + slice.Dest(e);
+              if (dist[dst] == kUnreached &&
+                  __sync_bool_compare_and_swap(
+                      &dist[dst], kUnreached, level + 1)) {
+                reached += 1;
+                some_reached.update(dst);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+    }));
+    if (reached.reduce() == 0) {
+      return std::make_pair(uint64_t{level}, last);
+    }
+    last = some_reached.reduce();
+  }
+}
+
+}  // namespace
+
+void
+katana::to_json(nlohmann::json& j, const RDGStats& stats) {
+  j = nlohmann::json{
+      {"rdg_version", stats.rdg_version},
+      {"num_partitions", stats.num_partitions},
+      {"num_nodes", stats.num_nodes},
+      {"num_edges", stats.num_edges},
+      {"out_degree_log2_histogram", stats.out_degree_histogram},
+      {"in_degree_log2_histogram", stats.in_degree_histogram},
+      {"max_out_degree", stats.max_out_degree},
+      {"max_in_degree", stats.max_in_degree},
+      {"node_type_counts", stats.node_type_counts},
+      {"edge_type_counts", stats.edge_type_counts},
+      {"sorted_nodes", stats.sorted_nodes},
+      {"self_loops", stats.self_loops},
+      {"multi_edges", stats.multi_edges},
+      {"symmetric", stats.symmetric},
+      {"diameter_lower_bound", stats.diameter_lower_bound},
+      {"clustering_coefficient", stats.clustering_coefficient},
+      {"clustering_wedges", stats.clustering_wedges},
+  };
+}
+
+void
+katana::to_json(nlohmann::json& j, const RDGStatsOptions& opts) {
+  // slice_bytes only changes how the statistics are computed
+  j = nlohmann::json{
+      {"diameter_sweeps", opts.diameter_sweeps},
+      {"clustering_samples", opts.clustering_samples},
+      {"seed", opts.seed},
+  };
+}
+
+katana::Result<katana::RDGStats>
+katana::ComputeRDGStats(
+    const std::string& rdg_name, const RDGStatsOptions& opts) {
+  SliceScanner scanner =
+      KATANA_CHECKED(SliceScanner::Make(rdg_name, opts.slice_bytes));
+  uint64_t num_nodes = scanner.num_nodes();
+
+  RDGStats stats;
+  stats.rdg_version = scanner.version();
+  stats.num_partitions = scanner.num_partitions();
+  stats.num_nodes = num_nodes;
+  stats.num_edges = scanner.num_edges();
+
+  katana::NUMAArray<uint32_t> in_degrees;
+  in_degrees.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(in_degrees.begin(), in_degrees.end(), 0U);
+
+  katana::GArrayAccumulator<uint64_t, kNumCounters> counters;
+  katana::GVectorAccumulator<uint64_t> out_histogram(kHistogramBuckets);
+  katana::GVectorAccumulator<uint64_t> node_types(
+      scanner.node_type_manager().GetNumEntityTypes());
+  katana::GVectorAccumulator<uint64_t> edge_types(
+      scanner.edge_type_manager().GetNumEntityTypes());
+  // the highest degree node, as degree and then node, starts the sweeps
+  katana::PerThreadStorage<std::pair<uint64_t, uint64_t>> max_degree_nodes;
+  katana::PerThreadStorage<std::vector<uint32_t>> sort_buffers;
+  katana::PerThreadStorage<std::vector<WedgeQuery>> wedge_queries;
+
+  // a node samples a wedge with probability clustering_samples / num_nodes,
+  // when it is below sample_threshold out of 2^64
+  double sample_rate =
+      num_nodes == 0
+          ? 0
+          : std::min(1.0, static_cast<double>(opts.clustering_samples) /
+                              static_cast<double>(num_nodes));
+  uint64_t sample_threshold =
+      sample_rate >= 1.0 ? std::numeric_limits<uint64_t>::max()
+                         : static_cast<uint64_t>(sample_rate * 0x1.0p64);
+  uint64_t sample_seed = katana::StatelessRandom(opts.seed, 0);
+  uint64_t hash_seed = katana::StatelessRandom(opts.seed, 1);
+  auto edge_hash = [hash_seed](uint64_t src, uint64_t dst) {
+    return katana::StatelessRandom(
+        katana::StatelessRandom(hash_seed, src), dst);
+  };
+
+  KATANA_CHECKED(scanner.Scan(true, [&](const Slice& slice) {
+    katana::do_all(
+        katana::iterate(slice.first_node, slice.end_node),
+        [&](uint64_t n) {
+          uint64_t node = slice.base + n;
+          uint64_t begin = slice.EdgeBegin(n);
+          uint64_t end = slice.EdgeEnd(n);
+          uint64_t degree = end - begin;
+          out_histogram.update(Log2Bucket(degree), 1);
+          auto& max_node = *max_degree_nodes.getLocal();
+          max_node = std::max(max_node, std::make_pair(degree, node));
+          if (!slice.node_types.empty()) {
+            node_types.update(slice.node_types[n - slice.first_node], 1);
+          }
+
+          bool sorted = true;
+          uint64_t hashes = 0;
+          uint64_t reverse_hashes = 0;
+          for (uint64_t e = begin; e < end; ++e) {
+            uint32_t dst = slice.Dest(e);
+            if (e > begin && dst < slice.Dest(e - 1)) {
+              sorted = false;
+            }
+            if (dst == n) {
+              counters.update(kSelfLoops, 1);
+            }
+            __sync_fetch_and_add(&in_degrees[slice.base + dst], 1);
+            if (!slice.edge_types.empty()) {
+              edge_types.update(slice.edge_types[e - slice.first_edge], 1);
+            }
+            hashes += edge_hash(node, slice.base + dst);
+            reverse_hashes += edge_hash(slice.base + dst, node);
+          }
+          counters.update(kEdgeHashes, hashes);
+          counters.update(kReverseHashes, reverse_hashes);
+
+          // multi edges are adjacent once the edges are sorted
+          const uint32_t* dests = slice.dests + (begin - slice.first_edge);
+          if (sorted) {
+            counters.update(kSortedNodes, 1);
+          } else {
+            auto& buffer = *sort_buffers.getLocal();
+            buffer.assign(dests, dests + degree);
+            std::sort(buffer.begin(), buffer.end());
+            dests = buffer.data();
+          }
+          uint64_t multi_edges = 0;
+          for (uint64_t i = 1; i < degree; ++i) {
+            multi_edges += dests[i] == dests[i - 1];
+          }
+          counters.update(kMultiEdges, multi_edges);
+
+          if (degree >= 2 &&
+              katana::StatelessRandom(sample_seed, node) <= sample_threshold) {
+            uint64_t i =
+                katana::StatelessRandom(sample_seed + 1, node) % degree;
+            uint64_t j =
+                katana::StatelessRandom(sample_seed + 2, node) % (degree - 1);
+            j += j >= i;
+            uint64_t u = slice.base + slice.Dest(begin + i);
+            uint64_t w = slice.base + slice.Dest(begin + j);
+            // a wedge of a multi edge has no third node to close it
+            if (u != w) {
+              uint64_t wedge =
+                  __sync_fetch_and_add(&stats.clustering_wedges, 1);
+              auto& queries = *wedge_queries.getLocal();
+              queries.emplace_back(WedgeQuery{u, w, wedge});
+              queries.emplace_back(WedgeQuery{w, u, wedge});
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }));
+
+  std::array<uint64_t, kNumCounters> counts = counters.reduce();
+  stats.sorted_nodes = counts[kSortedNodes];
+  stats.self_loops = counts[kSelfLoops];
+  stats.multi_edges = counts[kMultiEdges];
+  stats.symmetric = counts[kEdgeHashes] == counts[kReverseHashes];
+  stats.out_degree_histogram = TrimHistogram(out_histogram.reduce());
+  stats.node_type_counts =
+      NameTypeCounts(scanner.node_type_manager(), node_types.reduce());
+  stats.edge_type_counts =
+      NameTypeCounts(scanner.edge_type_manager(), edge_types.reduce());
+
+  std::pair<uint64_t, uint64_t> max_degree_node{0, 0};
+  for (unsigned t = 0; t < max_degree_nodes.size(); ++t) {
+    max_degree_node =
+        std::max(max_degree_node, *max_degree_nodes.getRemote(t));
+  }
+  stats.max_out_degree = max_degree_node.first;
+
+  katana::GVectorAccumulator<uint64_t> in_histogram(kHistogramBuckets);
+  katana::GReduceMax<uint64_t> max_in_degree;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        in_histogram.update(Log2Bucket(in_degrees[n]), 1);
+        max_in_degree.update(in_degrees[n]);
+      },
+      katana::no_stats());
+  stats.in_degree_histogram = TrimHistogram(in_histogram.reduce());
+  stats.max_in_degree = num_nodes == 0 ? 0 : max_in_degree.reduce();
+  in_degrees.destroy();
+
+  // answer the queries of the sampled wedges by the slices of their nodes
+  std::vector<WedgeQuery> queries;
+  for (unsigned t = 0; t < wedge_queries.size(); ++t) {
+    auto& local = *wedge_queries.getRemote(t);
+    queries.insert(queries.end(), local.begin(), local.end());
+  }
+  if (!queries.empty()) {
+    katana::ParallelSTL::sort(
+        queries.begin(), queries.end(),
+        [](const WedgeQuery& a, const WedgeQuery& b) {
+          return a.node < b.node;
+        });
+    std::vector<uint8_t> closed(stats.clustering_wedges);
+    KATANA_CHECKED(scanner.Scan(false, [&](const Slice& slice) {
+      auto by_node = [](const WedgeQuery& q, uint64_t node) {
+        return q.node < node;
+      };
+      size_t begin = std::lower_bound(
+                         queries.begin(), queries.end(),
+                         slice.base + slice.first_node, by_node) -
+                     queries.begin();
+      size_t end = std::lower_bound(
+                       queries.begin(), queries.end(),
+                       slice.base + slice.end_node, by_node) -
+                   queries.begin();
+      katana::do_all(
+          katana::iterate(begin, end),
+          [&](size_t q) {
+            const WedgeQuery& query = queries[q];
+            uint64_t n = query.node - slice.base;
+            for (uint64_t e = slice.EdgeBegin(n); e < slice.EdgeEnd(n); ++e) {
+              if (slice.base + slice.Dest(e) == query.dest) {
+                closed[query.wedge] = 1;
+                break;
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+    }));
+    uint64_t num_closed = std::count(closed.begin(), closed.end(), 1);
+    stats.clustering_coefficient = static_cast<double>(num_closed) /
+                                   static_cast<double>(closed.size());
+  }
+
+  // the double sweep: the eccentricity of the highest degree node, and
+  // then of the farthest node from it, and so on
+  uint64_t source = max_degree_node.second;
+  for (uint32_t sweep = 0; sweep < opts.diameter_sweeps && num_nodes > 0;
+       ++sweep) {
+    auto [eccentricity, farthest] = KATANA_CHECKED(Sweep(&scanner, source));
+    stats.diameter_lower_bound =
+        std::max(stats.diameter_lower_bound, eccentricity);
+    source = farthest;
+  }
+
+  return stats;
+}
+
+katana::Result<nlohmann::json>
+katana::CachedRDGStats(
+    const std::string& rdg_name, const RDGStatsOptions& opts, bool recompute) {
+  katana::RDGManifest manifest =
+      KATANA_CHECKED(katana::FindManifest(rdg_name));
+  std::string cache_name = manifest.dir().Join(kCacheFileName).string();
+  nlohmann::json options = opts;
+
+  katana::StatBuf stat_buf;
+  if (!recompute && katana::FileStat(cache_name, &stat_buf)) {
+    std::string cached(stat_buf.size, '\0');
+    KATANA_CHECKED(
+        katana::FileGet(cache_name, cached.data(), 0, cached.size()));
+    auto parsed = katana::JsonParse<nlohmann::json>(cached);
+    if (parsed && parsed.value().value("options", nlohmann::json()) ==
+                      options &&
+        parsed.value().value("stats", nlohmann::json())
+                .value("rdg_version", uint64_t{0}) == manifest.version()) {
+      return parsed.value()["stats"];
+    }
+  }
+
+  RDGStats stats = KATANA_CHECKED(ComputeRDGStats(rdg_name, opts));
+  nlohmann::json cache{{"options", options}, {"stats", stats}};
+  std::string dumped = KATANA_CHECKED(katana::JsonDump(cache));
+  if (auto res = katana::FileStore(cache_name, dumped.data(), dumped.size());
+      !res) {
+    // the statistics are still good without the cache
+    KATANA_LOG_WARN(
+        "could not cache statistics in {}: {}", cache_name, res.error());
+  }
+  return cache["stats"];
+}
@@ -0,0 +1,82 @@
+#ifndef KATANA_TOOLS_GRAPHSTATS_RDGSTATS_H_
+#define KATANA_TOOLS_GRAPHSTATS_RDGSTATS_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Result.h"
+
+namespace katana {
+
+struct RDGStatsOptions {
+  /// Bytes of topology and types loaded at once, per slice of a partition
+  uint64_t slice_bytes{uint64_t{256} << 20};
+  /// Breadth first searches of the double sweep lower bound of the
+  /// diameter; each takes a pass over the graph per level. 0 skips it.
+  uint32_t diameter_sweeps{2};
+  /// Wedges, pairs of out edges of a node, sampled to estimate the average
+  /// clustering coefficient. 0 skips it.
+  uint64_t clustering_samples{10000};
+  uint64_t seed{0};
+};
+
+/// Statistics of an RDG, computed a slice of a partition at a time, so
+/// that only per node counters, not the topology, need to fit in memory.
+/// The nodes of partition p are numbered after those of the partitions
+/// before it, and edges are by their partition local destinations.
+struct RDGStats {
+  uint64_t rdg_version{0};
+  uint32_t num_partitions{0};
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+
+  /// Bucket 0 counts the nodes of degree 0 and bucket b > 0 those of degree
+  /// in [2^(b - 1), 2^b)
+  std::vector<uint64_t> out_degree_histogram;
+  std::vector<uint64_t> in_degree_histogram;
+  uint64_t max_out_degree{0};
+  uint64_t max_in_degree{0};
+
+  /// Counts of the nodes and edges of each entity type, by name; empty if
+  /// the RDG stores its types as properties
+  std::map<std::string, uint64_t> node_type_counts;
+  std::map<std::string, uint64_t> edge_type_counts;
+
+  /// Nodes whose out edges are sorted by destination
+  uint64_t sorted_nodes{0};
+  uint64_t self_loops{0};
+  /// Edges to the same destination as an earlier edge of their source
+  uint64_t multi_edges{0};
+  /// Whether every edge has a reverse edge, up to multiplicity. This is
+  /// decided by comparing sums of hashes of the edges and of their
+  /// reverses, so a false positive is possible, though very unlikely.
+  bool symmetric{false};
+
+  /// The longest shortest path found by the sweeps, a lower bound of the
+  /// diameter of the reachable part of the graph
+  uint64_t diameter_lower_bound{0};
+  /// The share of sampled wedges that are closed by an edge either way
+  double clustering_coefficient{0};
+  uint64_t clustering_wedges{0};
+};
+
+void to_json(nlohmann::json& j, const RDGStats& stats);
+void to_json(nlohmann::json& j, const RDGStatsOptions& opts);
+
+/// Compute the statistics of the RDG rdg_name
+Result<RDGStats> ComputeRDGStats(
+    const std::string& rdg_name, const RDGStatsOptions& opts);
+
+/// The statistics of the RDG rdg_name as JSON, from graph-stats.json in its
+/// directory if that has them for this version of the RDG and these
+/// options; otherwise they are computed and stored there.
+Result<nlohmann::json> CachedRDGStats(
+    const std::string& rdg_name, const RDGStatsOptions& opts, bool recompute);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <nlohmann/json.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "rdg-stats.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using Adjacency = std::vector<std::vector<uint32_t>>;
+
+constexpr uint32_t kNumNodes = 3000;
+constexpr uint32_t kPathNodes = 40;
+
+/// Random out edges, with the self loops and multi edges that come with
+/// them, and a path of kPathNodes nodes off them; if symmetric, the reverse
+/// of every edge too
+Adjacency
+RandomGraph(bool symmetric) {
+  std::mt19937 gen(23);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - kPathNodes - 1);
+  Adjacency out(kNumNodes);
+  auto add_edge = [&](uint32_t src, uint32_t dst) {
+    out[src].emplace_back(dst);
+    if (symmetric) {
+      out[dst].emplace_back(src);
+    }
+  };
+  for (uint32_t e = 0; e < 4 * kNumNodes; ++e) {
+    add_edge(node(gen), node(gen));
+  }
+  // so that the diameter is not only logarithmic
+  for (uint32_t n = kNumNodes - kPathNodes - 1; n + 1 < kNumNodes; ++n) {
+    add_edge(n, n + 1);
+  }
+  return out;
+}
+
+/// Writes the graph of out, with the node type "Even" on even nodes, and
+/// returns where
+std::string
+WriteGraph(const Adjacency& out) {
+  std::vector<katana::GraphTopology::Edge> adj_indices;
+  std::vector<katana::GraphTopology::Node> dests;
+  for (const auto& edges : out) {
+    dests.insert(dests.end(), edges.begin(), edges.end());
+    adj_indices.emplace_back(dests.size());
+  }
+  katana::GraphTopology topo(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto node_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("Even", [](uint64_t n) {
+        return static_cast<uint8_t>(n % 2 == 0);
+      }));
+  KATANA_LOG_VASSERT(node_res, "adding node types: {}", node_res.error());
+  auto types_res = pg->ConstructEntityTypeIDs(&txn_ctx);
+  KATANA_LOG_VASSERT(types_res, "making types: {}", types_res.error());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/rdgstats");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_res = pg->Write(rdg_dir, "rdg-stats");
+  if (!write_res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing graph: {}", write_res.error());
+  }
+  return rdg_dir;
+}
+
+size_t
+Log2Bucket(uint64_t degree) {
+  size_t bucket = 0;
+  for (; degree > 0; degree >>= 1) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+void
+AddToHistogram(std::vector<uint64_t>* histogram, uint64_t degree) {
+  size_t bucket = Log2Bucket(degree);
+  if (histogram->size() <= bucket) {
+    histogram->resize(bucket + 1);
+  }
+  ++(*histogram)[bucket];
+}
+
+bool
+HasEdge(const Adjacency& out, uint32_t src, uint32_t dst) {
+  return std::find(out[src].begin(), out[src].end(), dst) != out[src].end();
+}
+
+/// The eccentricity of source and the highest numbered node that far away
+std::pair<uint64_t, uint64_t>
+Sweep(const Adjacency& out, uint32_t source) {
+  std::vector<uint64_t> dist(out.size(), UINT64_MAX);
+  std::queue<uint32_t> frontier;
+  dist[source] = 0;
+  frontier.push(source);
+  std::pair<uint64_t, uint64_t> farthest{0, source};
+  while (!frontier.empty()) {
+    uint32_t n = frontier.front();
+    frontier.pop();
+    farthest = std::max(farthest, std::make_pair(dist[n], uint64_t{n}));
+    for (uint32_t dst : out[n]) {
+      if (dist[dst] == UINT64_MAX) {
+        dist[dst] = dist[n] + 1;
+        frontier.push(dst);
+      }
+    }
+  }
+  return farthest;
+}
+
+/// The statistics of out, computed one node at a time
+katana::RDGStats
+ExpectedStats(const Adjacency& out, const katana::RDGStatsOptions& opts) {
+  katana::RDGStats stats;
+  stats.num_partitions = 1;
+  stats.num_nodes = out.size();
+  std::vector<uint64_t> in_degrees(out.size());
+  std::pair<uint64_t, uint32_t> max_degree_node{0, 0};
+  uint64_t closed = 0;
+  uint64_t sample_seed = katana::StatelessRandom(opts.seed, 0);
+  for (uint32_t n = 0; n < out.size(); ++n) {
+    const std::vector<uint32_t>& edges = out[n];
+    uint64_t degree = edges.size();
+    stats.num_edges += degree;
+    AddToHistogram(&stats.out_degree_histogram, degree);
+    max_degree_node = std::max(max_degree_node, std::make_pair(degree, n));
+    stats.sorted_nodes += std::is_sorted(edges.begin(), edges.end());
+    stats.self_loops += std::count(edges.begin(), edges.end(), n);
+    std::vector<uint32_t> sorted = edges;
+    std::sort(sorted.begin(), sorted.end());
+    stats.multi_edges +=
+        sorted.size() -
+        (std::unique(sorted.begin(), sorted.end()) - sorted.begin());
+    for (uint32_t dst : edges) {
+      ++in_degrees[dst];
+    }
+
+    // every node samples a wedge when there are as many samples as nodes
+    if (degree >= 2) {
+      uint64_t i = katana::StatelessRandom(sample_seed + 1, n) % degree;
+      uint64_t j = katana::StatelessRandom(sample_seed + 2, n) % (degree - 1);
+      j += j >= i;
+      uint32_t u = edges[i];
+      uint32_t w = edges[j];
+      if (u != w) {
+        ++stats.clustering_wedges;
+        closed += HasEdge(out, u, w) || HasEdge(out, w, u);
+      }
+    }
+  }
+  for (uint64_t in_degree : in_degrees) {
+    AddToHistogram(&stats.in_degree_histogram, in_degree);
+    stats.max_in_degree = std::max(stats.max_in_degree, in_degree);
+  }
+  stats.max_out_degree = max_degree_node.first;
+
+  // the reverse of each edge is an edge as often as the edge itself
+  stats.symmetric = true;
+  for (uint32_t n = 0; n < out.size(); ++n) {
+    for (uint32_t dst : out[n]) {
+      stats.symmetric =
+          stats.symmetric &&
+          std::count(out[n].begin(), out[n].end(), dst) ==
+              std::count(out[dst].begin(), out[dst].end(), n);
+    }
+  }
+
+  stats.node_type_counts["Even"] = (out.size() + 1) / 2;
+  if (stats.clustering_wedges > 0) {
+    stats.clustering_coefficient = static_cast<double>(closed) /
+                                   static_cast<double>(stats.clustering_wedges);
+  }
+  uint64_t source = max_degree_node.second;
+  for (uint32_t sweep = 0; sweep < opts.diameter_sweeps; ++sweep) {
+    auto [eccentricity, farthest] = Sweep(out, source);
+    stats.diameter_lower_bound =
+        std::max(stats.diameter_lower_bound, eccentricity);
+    source = farthest;
+  }
+  return stats;
+}
+
+/// Checks found against expected, but for the counts of the types that
+/// are not "Even", which depend on how unknown types are named
+void
+CheckStats(const katana::RDGStats& expected, katana::RDGStats found) {
+  uint64_t typed = 0;
+  for (const auto& [name, count] : found.node_type_counts) {
+    typed += count;
+  }
+  KATANA_LOG_ASSERT(typed == found.num_nodes);
+  uint64_t even = found.node_type_counts["Even"];
+  found.node_type_counts.clear();
+  found.node_type_counts["Even"] = even;
+  // there are no edge types to count
+  found.edge_type_counts.clear();
+  found.rdg_version = expected.rdg_version;
+
+  nlohmann::json expected_json = expected;
+  nlohmann::json found_json = found;
+  KATANA_LOG_VASSERT(
+      found_json == expected_json, "found {}, expected {}", found_json.dump(),
+      expected_json.dump());
+}
+
+void
+TestStats(bool symmetric) {
+  Adjacency out = RandomGraph(symmetric);
+  std::string rdg_dir = WriteGraph(out);
+
+  katana::RDGStatsOptions opts;
+  opts.diameter_sweeps = 3;
+  opts.clustering_samples = kNumNodes;
+  opts.seed = 5;
+  katana::RDGStats expected = ExpectedStats(out, opts);
+  KATANA_LOG_ASSERT(expected.symmetric == symmetric);
+
+  // a slice of the whole graph, and slices of a few dozen nodes
+  for (uint64_t slice_bytes : {uint64_t{256} << 20, uint64_t{1024}}) {
+    for (int threads : {1, 4}) {
+      katana::setActiveThreads(threads);
+      opts.slice_bytes = slice_bytes;
+      auto stats_res = katana::ComputeRDGStats(rdg_dir, opts);
+      KATANA_LOG_VASSERT(stats_res, "computing stats: {}", stats_res.error());
+      CheckStats(expected, stats_res.value());
+    }
+  }
+  fs::remove_all(rdg_dir);
+}
+
+void
+TestCache() {
+  Adjacency out = RandomGraph(false);
+  std::string rdg_dir = WriteGraph(out);
+  std::string cache_name = rdg_dir + "/graph-stats.json";
+
+  katana::RDGStatsOptions opts;
+  auto computed_res = katana::CachedRDGStats(rdg_dir, opts, false);
+  KATANA_LOG_VASSERT(computed_res, "caching: {}", computed_res.error());
+  nlohmann::json computed = computed_res.value();
+  KATANA_LOG_ASSERT(fs::exists(cache_name));
+  KATANA_LOG_ASSERT(computed["num_nodes"] == kNumNodes);
+
+  // what is cached is returned as is, which a doctored cache shows
+  std::ifstream cached_in(cache_name);
+  nlohmann::json cache = nlohmann::json::parse(cached_in);
+  cached_in.close();
+  cache["stats"]["num_nodes"] = 1;
+  std::ofstream(cache_name) << cache.dump();
+
+  auto cached_res = katana::CachedRDGStats(rdg_dir, opts, false);
+  KATANA_LOG_VASSERT(cached_res, "reading cache: {}", cached_res.error());
+  KATANA_LOG_ASSERT(cached_res.value()["num_nodes"] == 1);
+
+  // but not for other options, or when asked to recompute
+  katana::RDGStatsOptions other_opts;
+  other_opts.seed = opts.seed + 1;
+  auto other_res = katana::CachedRDGStats(rdg_dir, other_opts, false);
+  KATANA_LOG_VASSERT(other_res, "recomputing: {}", other_res.error());
+  KATANA_LOG_ASSERT(other_res.value()["num_nodes"] == kNumNodes);
+
+  std::ofstream(cache_name) << cache.dump();
+  auto recomputed_res = katana::CachedRDGStats(rdg_dir, opts, true);
+  KATANA_LOG_VASSERT(recomputed_res, "recomputing: {}", recomputed_res.error());
+  KATANA_LOG_ASSERT(recomputed_res.value() == computed);
+
+  // slice_bytes does not change the statistics, so it shares the cache
+  opts.slice_bytes = 1024;
+  auto sliced_res = katana::CachedRDGStats(rdg_dir, opts, false);
+  KATANA_LOG_VASSERT(sliced_res, "reading cache: {}", sliced_res.error());
+  KATANA_LOG_ASSERT(sliced_res.value() == computed);
+
+  fs::remove_all(rdg_dir);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestStats(false);
+  TestStats(true);
+  TestCache();
+
+  return 0;
+}
@@ -0,0 +1,548 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/JSONTracer.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/ProgressTracer.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/Timer.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/cdlp/cdlp.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+#include "katana/analytics/independent_set/independent_set.h"
+#include "katana/analytics/jaccard/jaccard.h"
+#include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/k_truss/k_truss.h"
+#include "katana/analytics/leiden_clustering/leiden_clustering.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/louvain_clustering/louvain_clustering.h"
+#include "katana/analytics/max_flow/max_flow.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/partition/partition.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+/* usage: ./katana-bench [--scales=10,14] [--graphs=rmat,road,web]
+ *                       [--threads=<n>] [--trace_out=<file>]
+ *                       [Google Benchmark options]
+ *
+ * runs every supported katana::analytics entry point with each of its plans
+ * over a corpus of synthetic graphs. Each graph class is generated at each
+ * scale (2^scale nodes) from a fixed seed, so the corpus is the same from
+ * run to run and machine to machine whatever the number of threads, then
+ * made symmetric with its edges sorted by destination and given a uint32
+ * "weight" edge property between 1 and 100.
+ *
+ * Benchmarks are named <algorithm>/<plan>/<graph>/<scale> and can be selected
+ * with --benchmark_filter. Results are written by Google Benchmark
+ * (--benchmark_out=<file> --benchmark_out_format=json for a machine readable
+ * report), and every benchmark is also a span of the JSON tracer, tagged
+ * with its algorithm, plan, graph and peak memory by kind (see
+ * katana::MemoryPhase) and logging its mean time, written to --trace_out or
+ * to stderr.
+ */
+
+namespace {
+
+using namespace katana::analytics;
+
+const std::string kWeight = "weight";
+const std::string kOutput = "output";
+constexpr uint64_t kSeed = 0;
+
+/// The classes of graphs of the corpus
+enum class GraphClass {
+  /// R-MAT with the Graph500 parameters: skewed degrees, small diameter
+  kRMAT,
+  /// A 2D grid: low uniform degree and large diameter, like road networks
+  kRoad,
+  /// Barabasi-Albert preferential attachment: power-law in-degrees, like
+  /// web and social graphs
+  kWeb,
+};
+
+std::string
+GraphClassName(GraphClass graph_class) {
+  switch (graph_class) {
+  case GraphClass::kRMAT:
+    return "rmat";
+  case GraphClass::kRoad:
+    return "road";
+  case GraphClass::kWeb:
+    return "web";
+  default:
+    return "unknown";
+  }
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+GenerateTopology(GraphClass graph_class, uint32_t scale) {
+  switch (graph_class) {
+  case GraphClass::kRMAT: {
+    katana::RMATParameters params;
+    params.scale = scale;
+    params.seed = kSeed;
+    auto pg = KATANA_CHECKED(katana::MakeRMAT(params));
+    return katana::CreateSymmetricGraph(pg.get());
+  }
+  case GraphClass::kRoad:
+    // already symmetric
+    return katana::MakeGrid(
+        size_t{1} << ((scale + 1) / 2), size_t{1} << (scale / 2), false);
+  case GraphClass::kWeb: {
+    auto pg = KATANA_CHECKED(
+        katana::MakeBarabasiAlbert(uint64_t{1} << scale, 8, kSeed));
+    return katana::CreateSymmetricGraph(pg.get());
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown graph class");
+  }
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+GenerateGraph(GraphClass graph_class, uint32_t scale) {
+  auto pg = KATANA_CHECKED(GenerateTopology(graph_class, scale));
+  KATANA_CHECKED(katana::SortAllEdgesByDest(pg.get()));
+
+  katana::TxnContext txn_ctx;
+  uint64_t weight_seed = katana::StatelessRandom(kSeed, 1);
+  KATANA_CHECKED(katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          kWeight, [weight_seed](katana::PropertyGraph::Edge e) {
+            return static_cast<uint32_t>(
+                katana::StatelessRandom(weight_seed, e) % 100 + 1);
+          })));
+  return std::move(pg);
+}
+
+/// The graph of the corpus of the class and scale, generated on first use so
+/// that a filtered run generates only the graphs that it needs
+katana::PropertyGraph*
+CorpusGraph(GraphClass graph_class, uint32_t scale) {
+  static std::map<
+      std::pair<GraphClass, uint32_t>, std::unique_ptr<katana::PropertyGraph>>
+      corpus;
+  static std::mutex mutex;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& pg = corpus[{graph_class, scale}];
+  if (!pg) {
+    auto res = GenerateGraph(graph_class, scale);
+    if (!res) {
+      KATANA_LOG_FATAL(
+          "generating the {} graph of scale {}: {}",
+          GraphClassName(graph_class), scale, res.error());
+    }
+    pg = std::move(res.value());
+  }
+  return pg.get();
+}
+
+/// Where an algorithm leaves its result, which is removed after every run
+enum class Output { kNone, kNode, kEdge };
+
+using RunFn = std::function<katana::Result<void>(
+    katana::PropertyGraph* pg, katana::TxnContext* txn_ctx)>;
+
+struct Variant {
+  std::string algorithm;
+  std::string plan;
+  Output output;
+  RunFn run;
+};
+
+/// Add a variant for each plan, named by the plan
+template <typename Plan, typename F>
+void
+AddVariants(
+    std::vector<Variant>* variants, const std::string& algorithm,
+    Output output, const std::vector<std::pair<std::string, Plan>>& plans,
+    F run) {
+  for (const auto& [name, plan] : plans) {
+    variants->emplace_back(Variant{
+        algorithm, name, output,
+        [run, plan = plan](
+            katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+          return run(pg, txn_ctx, plan);
+        }});
+  }
+}
+
+std::vector<Variant>
+AllVariants() {
+  std::vector<Variant> variants;
+
+  AddVariants<BfsPlan>(
+      &variants, "Bfs", Output::kNode,
+      {{"AsynchronousTile", BfsPlan::AsynchronousTile()},
+       {"Asynchronous", BfsPlan::Asynchronous()},
+       {"SynchronousTile", BfsPlan::SynchronousTile()},
+       {"Synchronous", BfsPlan::Synchronous()},
+       {"SynchronousDirectOpt", BfsPlan::SynchronousDirectOpt()}},
+      [](auto* pg, auto* txn_ctx, const BfsPlan& plan) {
+        return Bfs(pg, 0, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<SsspPlan>(
+      &variants, "Sssp", Output::kNode,
+      {{"DeltaTile", SsspPlan::DeltaTile()},
+       {"DeltaStep", SsspPlan::DeltaStep()},
+       {"DeltaStepBarrier", SsspPlan::DeltaStepBarrier()},
+       {"DeltaStepFusion", SsspPlan::DeltaStepFusion()},
+       {"DeltaStepMultiQueue", SsspPlan::DeltaStepMultiQueue()},
+       {"SerialDeltaTile", SsspPlan::SerialDeltaTile()},
+       {"SerialDelta", SsspPlan::SerialDelta()},
+       {"DijkstraTile", SsspPlan::DijkstraTile()},
+       {"Dijkstra", SsspPlan::Dijkstra()},
+       {"Topological", SsspPlan::Topological()},
+       {"TopologicalTile", SsspPlan::TopologicalTile()},
+       {"RadiusStep", SsspPlan::RadiusStep()}},
+      [](auto* pg, auto* txn_ctx, const SsspPlan& plan) {
+        return Sssp(pg, 0, kWeight, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<ConnectedComponentsPlan>(
+      &variants, "ConnectedComponents", Output::kNode,
+      {{"Serial", ConnectedComponentsPlan::Serial()},
+       {"LabelProp", ConnectedComponentsPlan::LabelProp()},
+       {"Synchronous", ConnectedComponentsPlan::Synchronous()},
+       {"Asynchronous", ConnectedComponentsPlan::Asynchronous()},
+       {"EdgeAsynchronous", ConnectedComponentsPlan::EdgeAsynchronous()},
+       {"EdgeTiledAsynchronous",
+        ConnectedComponentsPlan::EdgeTiledAsynchronous()},
+       {"BlockedAsynchronous", ConnectedComponentsPlan::BlockedAsynchronous()},
+       {"Afforest", ConnectedComponentsPlan::Afforest()},
+       {"EdgeAfforest", ConnectedComponentsPlan::EdgeAfforest()},
+       {"EdgeTiledAfforest", ConnectedComponentsPlan::EdgeTiledAfforest()}},
+      [](auto* pg, auto* txn_ctx, const ConnectedComponentsPlan& plan) {
+        return ConnectedComponents(pg, kOutput, txn_ctx, true, plan);
+      });
+
+  AddVariants<StronglyConnectedComponentsPlan>(
+      &variants, "StronglyConnectedComponents", Output::kNode,
+      {{"TrimFWBW", StronglyConnectedComponentsPlan::TrimFWBW()},
+       {"Coloring", StronglyConnectedComponentsPlan::Coloring()}},
+      [](auto* pg, auto* txn_ctx, const StronglyConnectedComponentsPlan& plan) {
+        return StronglyConnectedComponents(pg, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<PagerankPlan>(
+      &variants, "Pagerank", Output::kNode,
+      {{"PullTopological", PagerankPlan::PullTopological()},
+       {"PullResidual", PagerankPlan::PullResidual()},
+       {"PushAsynchronous", PagerankPlan::PushAsynchronous()},
+       {"PushSynchronous", PagerankPlan::PushSynchronous()},
+       {"PropagationBlocking", PagerankPlan::PropagationBlocking()}},
+      [](auto* pg, auto* txn_ctx, const PagerankPlan& plan) {
+        return Pagerank(pg, kOutput, txn_ctx, plan);
+      });
+
+  // a fixed sample of sources keeps the all pairs algorithms tractable
+  AddVariants<BetweennessCentralityPlan>(
+      &variants, "BetweennessCentrality", Output::kNode,
+      {{"Level", BetweennessCentralityPlan::Level()},
+       {"Outer", BetweennessCentralityPlan::Outer()},
+       {"Asynchronous", BetweennessCentralityPlan::Asynchronous()},
+       {"Adaptive", BetweennessCentralityPlan::Adaptive()}},
+      [](auto* pg, auto* txn_ctx, const BetweennessCentralityPlan& plan) {
+        return BetweennessCentrality(
+            pg, kOutput, txn_ctx, BetweennessCentralitySources{uint32_t{16}},
+            plan);
+      });
+
+  AddVariants<TriangleCountPlan>(
+      &variants, "TriangleCount", Output::kNone,
+      {{"NodeIteration", TriangleCountPlan::NodeIteration(true)},
+       {"EdgeIteration", TriangleCountPlan::EdgeIteration(true)},
+       {"OrderedCount", TriangleCountPlan::OrderedCount(true)},
+       {"Approximate", TriangleCountPlan::Approximate()}},
+      [](auto* pg, auto*, const TriangleCountPlan& plan)
+          -> katana::Result<void> {
+        KATANA_CHECKED(TriangleCount(pg, plan));
+        return katana::ResultSuccess();
+      });
+
+  AddVariants<LocalClusteringCoefficientPlan>(
+      &variants, "LocalClusteringCoefficient", Output::kNode,
+      {{"OrderedCountAtomics",
+        LocalClusteringCoefficientPlan::OrderedCountAtomics(true)},
+       {"OrderedCountPerThread",
+        LocalClusteringCoefficientPlan::OrderedCountPerThread(true)},
+       {"DegreeOrdered", LocalClusteringCoefficientPlan::DegreeOrdered()}},
+      [](auto* pg, auto* txn_ctx, const LocalClusteringCoefficientPlan& plan) {
+        return LocalClusteringCoefficient(pg, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<KCorePlan>(
+      &variants, "KCore", Output::kNode,
+      {{"Synchronous", KCorePlan::Synchronous()},
+       {"Asynchronous", KCorePlan::Asynchronous()}},
+      [](auto* pg, auto* txn_ctx, const KCorePlan& plan) {
+        return KCore(pg, 10, kOutput, txn_ctx, true, plan);
+      });
+
+  AddVariants<KTrussPlan>(
+      &variants, "KTruss", Output::kEdge,
+      {{"Bsp", KTrussPlan::Bsp()},
+       {"BspJacobi", KTrussPlan::BspJacobi()},
+       {"BspCoreThenTruss", KTrussPlan::BspCoreThenTruss()}},
+      [](auto* pg, auto* txn_ctx, const KTrussPlan& plan) {
+        return KTruss(txn_ctx, pg, 5, kOutput, plan);
+      });
+
+  AddVariants<CdlpPlan>(
+      &variants, "Cdlp", Output::kNode,
+      {{"Synchronous", CdlpPlan::Synchronous()}},
+      [](auto* pg, auto* txn_ctx, const CdlpPlan& plan) {
+        return Cdlp(pg, kOutput, 10, txn_ctx, true, plan);
+      });
+
+  AddVariants<JaccardPlan>(
+      &variants, "Jaccard", Output::kNode,
+      {{"Unsorted", JaccardPlan::Unsorted()},
+       {"Sorted", JaccardPlan::Sorted()},
+       {"HubBitmaps", JaccardPlan::HubBitmaps()}},
+      [](auto* pg, auto* txn_ctx, const JaccardPlan& plan) {
+        return Jaccard(pg, 0, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<GraphColoringPlan>(
+      &variants, "GraphColoring", Output::kNode,
+      {{"JonesPlassmann", GraphColoringPlan::JonesPlassmann()},
+       {"LargestDegreeFirst", GraphColoringPlan::LargestDegreeFirst()}},
+      [](auto* pg, auto* txn_ctx, const GraphColoringPlan& plan) {
+        return GraphColoring(pg, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<IndependentSetPlan>(
+      &variants, "IndependentSet", Output::kNode,
+      {{"Serial", IndependentSetPlan::Serial()},
+       {"Pull", IndependentSetPlan::Pull()},
+       {"Priority", IndependentSetPlan::Priority()},
+       {"EdgeTiledPriority", IndependentSetPlan::EdgeTiledPriority()}},
+      [](auto* pg, auto* txn_ctx, const IndependentSetPlan& plan) {
+        return IndependentSet(pg, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<LouvainClusteringPlan>(
+      &variants, "LouvainClustering", Output::kNode,
+      {{"DoAll", LouvainClusteringPlan::DoAll()},
+       {"Deterministic", LouvainClusteringPlan::Deterministic()}},
+      [](auto* pg, auto* txn_ctx, const LouvainClusteringPlan& plan) {
+        return LouvainClustering(pg, kWeight, kOutput, txn_ctx, true, plan);
+      });
+
+  AddVariants<LeidenClusteringPlan>(
+      &variants, "LeidenClustering", Output::kNode,
+      {{"DoAll", LeidenClusteringPlan::DoAll()},
+       {"Deterministic", LeidenClusteringPlan::Deterministic()}},
+      [](auto* pg, auto* txn_ctx, const LeidenClusteringPlan& plan) {
+        return LeidenClustering(pg, kWeight, kOutput, txn_ctx, true, plan);
+      });
+
+  AddVariants<MinimumSpanningForestPlan>(
+      &variants, "MinimumSpanningForest", Output::kEdge,
+      {{"Boruvka", MinimumSpanningForestPlan::Boruvka()}},
+      [](auto* pg, auto* txn_ctx, const MinimumSpanningForestPlan& plan) {
+        return MinimumSpanningForest(pg, kWeight, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<PartitionPlan>(
+      &variants, "Partition", Output::kNode,
+      {{"Multilevel", PartitionPlan::Multilevel()}},
+      [](auto* pg, auto* txn_ctx, const PartitionPlan& plan) {
+        return Partition(pg, 16, kOutput, txn_ctx, plan);
+      });
+
+  AddVariants<MaxFlowPlan>(
+      &variants, "MaxFlow", Output::kNode,
+      {{"SynchronousPushRelabel", MaxFlowPlan::SynchronousPushRelabel()}},
+      [](auto* pg, auto* txn_ctx, const MaxFlowPlan& plan)
+          -> katana::Result<void> {
+        KATANA_CHECKED(MaxFlow(
+            pg, 0, pg->NumNodes() - 1, kWeight, kOutput, txn_ctx, plan));
+        return katana::ResultSuccess();
+      });
+
+  return variants;
+}
+
+katana::Result<void>
+RemoveOutput(
+    katana::PropertyGraph* pg, Output output, katana::TxnContext* txn_ctx) {
+  switch (output) {
+  case Output::kNone:
+    return katana::ResultSuccess();
+  case Output::kNode:
+    return pg->RemoveNodeProperty(kOutput, txn_ctx);
+  case Output::kEdge:
+    return pg->RemoveEdgeProperty(kOutput, txn_ctx);
+  default:
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "unknown output");
+  }
+}
+
+void
+RunVariant(
+    benchmark::State& state, const Variant& variant, GraphClass graph_class,
+    uint32_t scale) {
+  katana::PropertyGraph* pg = CorpusGraph(graph_class, scale);
+
+  katana::ProgressScope scope =
+      katana::GetTracer().StartActiveSpan("katana-bench");
+  scope.span().SetTags({
+      {"algorithm", variant.algorithm},
+      {"plan", variant.plan},
+      {"graph", GraphClassName(graph_class)},
+      {"scale", scale},
+      {"nodes", pg->NumNodes()},
+      {"edges", pg->NumEdges()},
+      {"threads", katana::getActiveThreads()},
+  });
+  katana::MemoryPhase memory_phase;
+
+  double total_seconds = 0;
+  for (auto _ : state) {
+    katana::TxnContext txn_ctx;
+    katana::Timer timer;
+    timer.start();
+    auto res = variant.run(pg, &txn_ctx);
+    timer.stop();
+    total_seconds += timer.get_usec() / 1e6;
+
+    state.PauseTiming();
+    if (!res) {
+      scope.span().SetError();
+      state.SkipWithError(fmt::format("{}", res.error()).c_str());
+      break;
+    }
+    if (auto remove_res = RemoveOutput(pg, variant.output, &txn_ctx);
+        !remove_res) {
+      KATANA_LOG_FATAL("removing the output: {}", remove_res.error());
+    }
+    state.ResumeTiming();
+  }
+
+  state.counters["nodes"] = pg->NumNodes();
+  state.counters["edges"] = pg->NumEdges();
+  state.counters["edges_per_second"] = benchmark::Counter(
+      pg->NumEdges(), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["peak_used_gb"] =
+      memory_phase.Peaks().used / 1024.0 / 1024.0 / 1024.0;
+  if (state.iterations() > 0) {
+    scope.span().Log(
+        "result", {{"iterations", static_cast<uint64_t>(state.iterations())},
+                   {"mean_seconds", total_seconds / state.iterations()}});
+  }
+}
+
+/// Parse the options of katana-bench that Google Benchmark left in argv
+struct Options {
+  std::vector<uint32_t> scales{10, 14};
+  std::vector<GraphClass> graphs{
+      GraphClass::kRMAT, GraphClass::kRoad, GraphClass::kWeb};
+  int threads{0};
+  std::string trace_out;
+};
+
+Options
+ParseOptions(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (katana::HasPrefix(arg, "--scales=")) {
+      options.scales.clear();
+      std::string scales = katana::TrimPrefix(arg, "--scales=");
+      for (auto word : katana::SplitView(scales, ",")) {
+        options.scales.emplace_back(std::stoul(std::string(word)));
+      }
+    } else if (katana::HasPrefix(arg, "--graphs=")) {
+      options.graphs.clear();
+      std::string graphs = katana::TrimPrefix(arg, "--graphs=");
+      for (auto word : katana::SplitView(graphs, ",")) {
+        if (word == "rmat") {
+          options.graphs.emplace_back(GraphClass::kRMAT);
+        } else if (word == "road") {
+          options.graphs.emplace_back(GraphClass::kRoad);
+        } else if (word == "web") {
+          options.graphs.emplace_back(GraphClass::kWeb);
+        } else {
+          KATANA_LOG_FATAL("unknown graph class: {}", word);
+        }
+      }
+    } else if (katana::HasPrefix(arg, "--threads=")) {
+      options.threads = std::stoi(katana::TrimPrefix(arg, "--threads="));
+    } else if (katana::HasPrefix(arg, "--trace_out=")) {
+      options.trace_out = katana::TrimPrefix(arg, "--trace_out=");
+    } else {
+      KATANA_LOG_FATAL("unknown option: {}", arg);
+    }
+  }
+  return options;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  Options options = ParseOptions(argc, argv);
+
+  std::ofstream trace_file;
+  if (!options.trace_out.empty()) {
+    trace_file.open(options.trace_out);
+    if (!trace_file) {
+      KATANA_LOG_FATAL("could not open {}", options.trace_out);
+    }
+  }
+  std::ostream& trace = options.trace_out.empty() ? std::cerr : trace_file;
+  katana::SharedMemSys sys(katana::JSONTracer::Make(
+      0, 1, [&trace](const std::string& output) { trace << output; }));
+  if (options.threads > 0) {
+    katana::setActiveThreads(options.threads);
+  }
+
+  // kept alive for the benchmarks, which refer to them
+  static std::vector<Variant> variants = AllVariants();
+  for (const Variant& variant : variants) {
+    for (GraphClass graph_class : options.graphs) {
+      for (uint32_t scale : options.scales) {
+        std::string name = fmt::format(
+            "{}/{}/{}/{}", variant.algorithm, variant.plan,
+            GraphClassName(graph_class), scale);
+        benchmark::RegisterBenchmark(
+            name.c_str(),
+            [&variant, graph_class, scale](benchmark::State& state) {
+              RunVariant(state, variant, graph_class, scale);
+            })
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+      }
+    }
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+  katana::GetTracer().Finish();
+  return 0;
+}